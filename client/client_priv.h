@@ -64,6 +64,9 @@ enum options_client
   OPT_MYSQLDUMP_SLAVE_DATA,
   OPT_MYSQLDUMP_INCLUDE_MASTER_HOST_PORT,
   OPT_MYSQLDUMP_IGNORE_ERROR,
+  OPT_MYSQLDUMP_PARALLEL,
+  OPT_MYSQLIMPORT_CHUNK_SIZE, OPT_MYSQLIMPORT_UNIQUE_CHECKS,
+  OPT_MYSQLCHECK_PARALLEL_WORKERS,
   OPT_SLAP_CSV, OPT_SLAP_CREATE_STRING,
   OPT_SLAP_AUTO_GENERATE_SQL_LOAD_TYPE, OPT_SLAP_AUTO_GENERATE_WRITE_NUM,
   OPT_SLAP_AUTO_GENERATE_ADD_AUTO,
@@ -79,6 +82,7 @@ enum options_client
   OPT_SLAP_COMMIT,
   OPT_SLAP_DETACH,
   OPT_SLAP_NO_DROP,
+  OPT_SLAP_LATENCY, OPT_SLAP_PREPARED, OPT_SLAP_RATE, OPT_SLAP_TIME_SERIES,
   OPT_MYSQL_REPLACE_INTO, OPT_BASE64_OUTPUT_MODE, OPT_SERVER_ID,
   OPT_FIX_TABLE_NAMES, OPT_FIX_DB_NAMES, OPT_SSL_VERIFY_SERVER_CERT,
   OPT_AUTO_VERTICAL_OUTPUT,
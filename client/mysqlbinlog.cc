@@ -56,6 +56,7 @@ static void warning(const char *format, ...) ATTRIBUTE_FORMAT(printf, 1, 2);
 #include "rpl_constants.h"
 
 #include <algorithm>
+#include <deque>
 
 using std::min;
 using std::max;
@@ -130,6 +131,7 @@ static my_bool debug_info_flag, debug_check_flag;
 static my_bool force_if_open_opt= 1, raw_mode= 0;
 static my_bool to_last_remote_log= 0, stop_never= 0;
 static my_bool opt_verify_binlog_checksum= 1;
+static ulong opt_read_ahead_size= 0;
 static ulonglong offset = 0;
 static uint stop_never_server_id= 1;
 static char* host = 0;
@@ -1480,6 +1482,12 @@ static struct my_option my_long_options[] =
   {"protocol", OPT_MYSQL_PROTOCOL,
    "The protocol to use for connection (tcp, socket, pipe, memory).",
    0, 0, 0, GET_STR,  REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"read-ahead-size", 0,
+   "Read the events of local binary logs in a separate thread, keeping up "
+   "to this many bytes of events ahead of the one being printed. 0 reads "
+   "and prints the events in the same thread.",
+   &opt_read_ahead_size, &opt_read_ahead_size, 0, GET_ULONG, REQUIRED_ARG,
+   0, 0, ULONG_MAX, 0, 0, 0},
   {"read-from-remote-server", 'R', "Read binary logs from a MySQL server. "
    "This is an alias for read-from-remote-master=BINLOG-DUMP-NON-GTIDS.",
    &opt_remote_alias, &opt_remote_alias, 0, GET_BOOL, NO_ARG,
@@ -2619,6 +2627,238 @@ static Exit_status check_header(IO_CACHE* file,
   @retval OK_STOP No error, but the end of the specified range of
   events to process has been reached and the program should terminate.
 */
+/* Defined in log_event.cc. */
+int rewrite_buffer(char **buf, int event_len,
+                   const Format_description_log_event *description_event);
+
+/**
+  Reads the events of a local binary log in a separate thread, see
+  --read-ahead-size.
+
+  The reader thread only splits the file into raw events, so that reading
+  overlaps with printing. The events are decoded by read_event() in the
+  printing thread, with the Format_description_log_event in effect at
+  that point of the log.
+*/
+class Event_prefetcher
+{
+public:
+  Event_prefetcher(IO_CACHE *file, ulong max_size)
+    : m_file(file), m_max_size(max_size), m_size(0), m_end_pos(0),
+      m_done(false), m_abort(false), m_running(false)
+  {
+    m_header_size= min<uint>(glob_description_event->common_header_len,
+                             LOG_EVENT_MINIMAL_HEADER_LEN);
+    m_max_event_len= std::max<ulong>(max_allowed_packet,
+                                     opt_binlog_rows_event_max_size +
+                                     MAX_LOG_EVENT_HEADER);
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_cond, NULL);
+  }
+
+  ~Event_prefetcher()
+  {
+    stop();
+    pthread_mutex_destroy(&m_lock);
+    pthread_cond_destroy(&m_cond);
+  }
+
+  /* Start the reader thread. Returns true on error. */
+  bool start();
+
+  /**
+    Return the next event, or NULL at the end of the log or on error. On
+    return the reader thread has stopped and m_file->error tells which.
+
+    @param[out] pos  Offset of the event, or of the failed read.
+  */
+  Log_event *read_event(my_off_t *pos);
+
+  /* Stop the reader thread and drop the events it has read ahead. */
+  void stop();
+
+  /* The body of the reader thread. */
+  void run();
+
+private:
+  struct Entry
+  {
+    char *buf;
+    ulong len;
+    my_off_t pos;
+  };
+
+  IO_CACHE *m_file;
+  uint m_header_size;
+  ulong m_max_event_len;
+  ulong m_max_size;
+  /* Bytes in m_queue. */
+  ulong m_size;
+  /* Offset of the failed read, valid when m_done is set. */
+  my_off_t m_end_pos;
+  std::deque<Entry> m_queue;
+  bool m_done, m_abort, m_running;
+  pthread_t m_thread;
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_cond;
+};
+
+pthread_handler_t prefetch_events(void *arg)
+{
+  my_thread_init();
+  ((Event_prefetcher *) arg)->run();
+  my_thread_end();
+  return 0;
+}
+
+bool Event_prefetcher::start()
+{
+  if (pthread_create(&m_thread, NULL, prefetch_events, this))
+  {
+    error("Could not create the thread reading ahead events (errno: %d).",
+          errno);
+    return true;
+  }
+  m_running= true;
+  return false;
+}
+
+void Event_prefetcher::run()
+{
+  my_off_t pos;
+
+  for (;;)
+  {
+    Entry entry;
+    char head[LOG_EVENT_MINIMAL_HEADER_LEN];
+    const char *error_msg= 0;
+
+    entry.pos= pos= my_b_tell(m_file);
+    entry.buf= 0;
+    /* EOF if nothing could be read, see Log_event::read_log_event(). */
+    if (my_b_read(m_file, (uchar *) head, m_header_size))
+      break;
+    entry.len= uint4korr(head + EVENT_LEN_OFFSET);
+    if (entry.len > m_max_event_len)
+      error_msg= "Event too big";
+    else if (entry.len < m_header_size)
+      error_msg= "Event too small";
+    else if (!(entry.buf= (char *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                             entry.len + 1, MYF(MY_WME))))
+      error_msg= "Out of memory";
+    else
+    {
+      // some events use the extra byte to null-terminate strings
+      entry.buf[entry.len]= 0;
+      memcpy(entry.buf, head, m_header_size);
+      if (my_b_read(m_file, (uchar *) entry.buf + m_header_size,
+                    entry.len - m_header_size))
+        error_msg= "read error";
+    }
+    if (error_msg)
+    {
+      sql_print_error("Error in Log_event::read_log_event(): "
+                      "'%s', data_len: %lu, event_type: %d",
+                      error_msg, entry.len, head[EVENT_TYPE_OFFSET]);
+      my_free(entry.buf);
+      m_file->error= -1;
+      break;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    while (!m_abort && !m_queue.empty() && m_size + entry.len > m_max_size)
+      pthread_cond_wait(&m_cond, &m_lock);
+    if (m_abort)
+    {
+      pthread_mutex_unlock(&m_lock);
+      my_free(entry.buf);
+      return;
+    }
+    m_queue.push_back(entry);
+    m_size+= entry.len;
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+  }
+
+  pthread_mutex_lock(&m_lock);
+  m_end_pos= pos;
+  m_done= true;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+}
+
+Log_event *Event_prefetcher::read_event(my_off_t *pos)
+{
+  Entry entry;
+  const char *error_msg= 0;
+  Log_event *ev;
+
+  pthread_mutex_lock(&m_lock);
+  while (m_queue.empty() && !m_done)
+    pthread_cond_wait(&m_cond, &m_lock);
+  if (m_queue.empty())
+  {
+    *pos= m_end_pos;
+    pthread_mutex_unlock(&m_lock);
+    stop();
+    return 0;
+  }
+  entry= m_queue.front();
+  m_queue.pop_front();
+  m_size-= entry.len;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+
+  *pos= entry.pos;
+  if (option_rewrite_set && entry.buf[EVENT_TYPE_OFFSET] == TABLE_MAP_EVENT)
+  {
+    int rewrite= rewrite_buffer(&entry.buf, entry.len, glob_description_event);
+    if (rewrite == -1)
+      error_msg= "Out of memory";
+    else if (rewrite > 0)
+    {
+      *(entry.buf + EVENT_LEN_OFFSET)= rewrite;
+      entry.len= uint4korr(entry.buf + EVENT_LEN_OFFSET);
+    }
+  }
+  if (!error_msg &&
+      (ev= Log_event::read_log_event(entry.buf, entry.len, &error_msg,
+                                     glob_description_event,
+                                     opt_verify_binlog_checksum)))
+  {
+    ev->register_temp_buf(entry.buf);
+    return ev;
+  }
+
+  sql_print_error("Error in Log_event::read_log_event(): "
+                  "'%s', data_len: %lu, event_type: %d",
+                  error_msg, entry.len, entry.buf[EVENT_TYPE_OFFSET]);
+  my_free(entry.buf);
+  stop();
+  m_file->error= -1;
+  return 0;
+}
+
+void Event_prefetcher::stop()
+{
+  if (!m_running)
+    return;
+
+  pthread_mutex_lock(&m_lock);
+  m_abort= true;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+  pthread_join(m_thread, NULL);
+  m_running= false;
+
+  while (!m_queue.empty())
+  {
+    my_free(m_queue.front().buf);
+    m_queue.pop_front();
+  }
+  m_size= 0;
+}
+
 static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
                                           const char* logname)
 {
@@ -2626,6 +2866,7 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
   IO_CACHE cache,*file= &cache;
   uchar tmp_buff[BIN_LOG_HEADER_SIZE];
   Exit_status retval= OK_CONTINUE;
+  Event_prefetcher *prefetcher= NULL;
 
   if (logname && strcmp(logname, "-") != 0)
   {
@@ -2695,13 +2936,26 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     error("Failed reading from file.");
     goto err;
   }
+  if (opt_read_ahead_size)
+  {
+    prefetcher= new Event_prefetcher(file, opt_read_ahead_size);
+    if (prefetcher->start())
+      goto err;
+  }
   for (;;)
   {
     char llbuff[21];
-    my_off_t old_off = my_b_tell(file);
+    my_off_t old_off;
+    Log_event* ev;
 
-    Log_event* ev = Log_event::read_log_event(file, glob_description_event,
-                                              opt_verify_binlog_checksum);
+    if (prefetcher)
+      ev= prefetcher->read_event(&old_off);
+    else
+    {
+      old_off= my_b_tell(file);
+      ev= Log_event::read_log_event(file, glob_description_event,
+                                    opt_verify_binlog_checksum);
+    }
     if (!ev)
     {
       /*
@@ -2731,6 +2985,8 @@ err:
   retval= ERROR_STOP;
 
 end:
+  /* The reader thread must be done with the file before it is closed. */
+  delete prefetcher;
   if (fd >= 0)
     my_close(fd, MYF(MY_WME));
   /*
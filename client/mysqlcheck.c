@@ -19,6 +19,7 @@
 
 #include "client_priv.h"
 #include "my_default.h"
+#include <my_pthread.h>
 #include <m_ctype.h>
 #include <mysql_version.h>
 #include <mysqld_error.h>
@@ -42,7 +43,7 @@ static my_bool opt_alldbs = 0, opt_check_only_changed = 0, opt_extended = 0,
                tty_password= 0, opt_frm= 0, debug_info_flag= 0, debug_check_flag= 0,
                opt_fix_table_names= 0, opt_fix_db_names= 0, opt_upgrade= 0,
                opt_write_binlog= 1;
-static uint verbose = 0, opt_mysql_port=0;
+static uint verbose = 0, opt_mysql_port=0, opt_parallel_workers= 1;
 static int my_end_arg;
 static char * opt_mysql_unix_port = 0;
 static char *opt_password = 0, *current_user = 0, 
@@ -51,6 +52,20 @@ static char *opt_plugin_dir= 0, *opt_default_auth= 0;
 static int first_error = 0;
 static char *opt_skip_database;
 DYNAMIC_ARRAY tables4repair, tables4rebuild, alter_table_cmds;
+
+/* A table to be processed by one of the --parallel-workers. */
+typedef struct st_table_job
+{
+  char *db;
+  char *table;
+  ulonglong size;                               /* Data and index length */
+} TABLE_JOB;
+
+static DYNAMIC_ARRAY table_jobs;
+static uint next_table_job;
+static MYSQL *worker_connections;
+static my_bool workers_running= 0;
+static pthread_mutex_t table_jobs_mutex, output_mutex;
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
 static char *shared_memory_base_name=0;
 #endif
@@ -146,6 +161,12 @@ static struct my_option my_long_options[] =
    1, 0, 0, 0, 0, 0},
   {"optimize", 'o', "Optimize table.", 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0,
    0, 0},
+  {"parallel-workers", OPT_MYSQLCHECK_PARALLEL_WORKERS,
+   "Process the tables over this many connections in parallel, largest "
+   "tables first. Can't be used with --all-in-1, --fix-db-names or "
+   "--fix-table-names.",
+   &opt_parallel_workers, &opt_parallel_workers, 0, GET_UINT, REQUIRED_ARG,
+   1, 1, 256, 0, 0, 0},
   {"password", 'p',
    "Password to use when connecting to server. If password is not given, it's solicited on the tty.",
    0, 0, 0, GET_PASSWORD, OPT_ARG, 0, 0, 0, 0, 0, 0},
@@ -214,12 +235,14 @@ static int process_selected_tables(char *db, char **table_names, int tables);
 static int process_all_tables_in_db(char *database);
 static int process_one_db(char *database);
 static int use_db(char *database);
-static int handle_request_for_tables(char *tables, uint length);
+static int handle_request_for_tables(MYSQL *mysql, char *tables, uint length);
+static MYSQL *connect_to_server(MYSQL *mysql, char *host, char *user,
+                                char *passwd);
 static int dbConnect(char *host, char *user,char *passwd);
 static void dbDisconnect(char *host);
 static void DBerror(MYSQL *mysql, const char *when);
 static void safe_exit(int error);
-static void print_result();
+static void print_result(MYSQL *mysql);
 static uint fixed_name_length(const char *name);
 static char *fix_table_name(char *dest, char *src);
 int what_to_do = 0;
@@ -407,6 +430,13 @@ static int get_options(int *argc, char ***argv)
     return 1;
   }
 
+  if (opt_parallel_workers > 1 && (opt_all_in_1 || what_to_do == DO_UPGRADE))
+  {
+    printf("--parallel-workers can't be used with --all-in-1, "
+           "--fix-db-names or --fix-table-names.\n");
+    return 1;
+  }
+
   if (*argc < 1 && !opt_alldbs)
   {
     printf("You forgot to give the arguments! Please see %s --help\n",
@@ -459,6 +489,63 @@ static int process_databases(char **db_names)
 } /* process_databases */
 
 
+/*
+  Add a table to the tables to be processed by the --parallel-workers.
+*/
+
+static int queue_table_job(const char *db, const char *table, ulonglong size)
+{
+  size_t db_length= strlen(db) + 1, table_length= strlen(table) + 1;
+  TABLE_JOB job;
+
+  if (!(job.db= (char*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                  db_length + table_length, MYF(MY_WME))))
+    return 1;
+  job.table= job.db + db_length;
+  job.size= size;
+  memcpy(job.db, db, db_length);
+  memcpy(job.table, table, table_length);
+  if (insert_dynamic(&table_jobs, &job))
+  {
+    my_free(job.db);
+    return 1;
+  }
+  return 0;
+}
+
+
+/*
+  The size estimate of a table of the current database,
+  or 0 if the server doesn't know the table.
+*/
+
+static ulonglong get_table_size(const char *table)
+{
+  char query[160 + NAME_LEN * 2], *end;
+  size_t length= strlen(table);
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  ulonglong size= 0;
+  int error;
+
+  if (length > NAME_LEN)
+    return 0;
+  end= strmov(query, "SELECT DATA_LENGTH + INDEX_LENGTH"
+                     " FROM INFORMATION_SCHEMA.TABLES"
+                     " WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = '");
+  end+= mysql_real_escape_string(sock, end, table, (ulong) length);
+  end= strmov(end, "'");
+  if (!mysql_real_query(sock, query, (ulong) (end - query)) &&
+      (res= mysql_store_result(sock)))
+  {
+    if ((row= mysql_fetch_row(res)) && row[0])
+      size= (ulonglong) my_strtoll10(row[0], NULL, &error);
+    mysql_free_result(res);
+  }
+  return size;
+}
+
+
 static int process_selected_tables(char *db, char **table_names, int tables)
 {
   if (use_db(db))
@@ -489,12 +576,20 @@ static int process_selected_tables(char *db, char **table_names, int tables)
       *end++= ',';
     }
     *--end = 0;
-    handle_request_for_tables(table_names_comma_sep + 1, (uint) (tot_length - 1));
+    handle_request_for_tables(sock, table_names_comma_sep + 1,
+                              (uint) (tot_length - 1));
     my_free(table_names_comma_sep);
   }
+  else if (opt_parallel_workers > 1)
+  {
+    for (; tables > 0; tables--, table_names++)
+      if (queue_table_job(db, *table_names, get_table_size(*table_names)))
+        return 1;
+  }
   else
     for (; tables > 0; tables--, table_names++)
-      handle_request_for_tables(*table_names, fixed_name_length(*table_names));
+      handle_request_for_tables(sock, *table_names,
+                                fixed_name_length(*table_names));
   return 0;
 } /* process_selected_tables */
 
@@ -538,6 +633,36 @@ static char *fix_table_name(char *dest, char *src)
 }
 
 
+/*
+  Add the tables of the current database to the tables to be processed
+  by the --parallel-workers, with their size estimates.
+*/
+
+static int queue_tables_in_db(char *database)
+{
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  int rc= 0, error;
+
+  if (mysql_query(sock, "SELECT TABLE_NAME, DATA_LENGTH + INDEX_LENGTH"
+                        " FROM INFORMATION_SCHEMA.TABLES"
+                        " WHERE TABLE_SCHEMA = DATABASE()"
+                        " AND TABLE_TYPE = 'BASE TABLE'") ||
+      !(res= mysql_store_result(sock)))
+  {
+    my_printf_error(0, "Error: Couldn't get table list for database %s: %s",
+		    MYF(0), database, mysql_error(sock));
+    return 1;
+  }
+  while (!rc && (row= mysql_fetch_row(res)))
+    rc= queue_table_job(database, row[0],
+                        row[1] ? (ulonglong) my_strtoll10(row[1], NULL, &error)
+                               : 0);
+  mysql_free_result(res);
+  return rc;
+}
+
+
 static int process_all_tables_in_db(char *database)
 {
   MYSQL_RES *res;
@@ -547,6 +672,8 @@ static int process_all_tables_in_db(char *database)
   LINT_INIT(res);
   if (use_db(database))
     return 1;
+  if (opt_parallel_workers > 1)
+    return queue_tables_in_db(database);
   if ((mysql_query(sock, "SHOW /*!50002 FULL*/ TABLES") &&
        mysql_query(sock, "SHOW TABLES")) ||
       !(res= mysql_store_result(sock)))
@@ -589,7 +716,7 @@ static int process_all_tables_in_db(char *database)
     }
     *--end = 0;
     if (tot_length)
-      handle_request_for_tables(tables + 1, tot_length - 1);
+      handle_request_for_tables(sock, tables + 1, tot_length - 1);
     my_free(tables);
   }
   else
@@ -600,7 +727,7 @@ static int process_all_tables_in_db(char *database)
       if ((what_to_do != DO_UPGRADE) && (num_columns == 2) && (strcmp(row[1], "VIEW") == 0))
         continue;
 
-      handle_request_for_tables(row[0], fixed_name_length(row[0]));
+      handle_request_for_tables(sock, row[0], fixed_name_length(row[0]));
     }
   }
   mysql_free_result(res);
@@ -608,12 +735,12 @@ static int process_all_tables_in_db(char *database)
 } /* process_all_tables_in_db */
 
 
-static int run_query(const char *query)
+static int run_query(MYSQL *mysql, const char *query)
 {
-  if (mysql_query(sock, query))
+  if (mysql_query(mysql, query))
   {
     fprintf(stderr, "Failed to %s\n", query);
-    fprintf(stderr, "Error: %s\n", mysql_error(sock));
+    fprintf(stderr, "Error: %s\n", mysql_error(mysql));
     return 1;
   }
   return 0;
@@ -627,7 +754,7 @@ static int fix_table_storage_name(const char *name)
   if (strncmp(name, "#mysql50#", 9))
     return 1;
   sprintf(qbuf, "RENAME TABLE `%s` TO `%s`", name, name + 9);
-  rc= run_query(qbuf);
+  rc= run_query(sock, qbuf);
   if (verbose)
     printf("%-50s %s\n", name, rc ? "FAILED" : "OK");
   return rc;
@@ -640,7 +767,7 @@ static int fix_database_storage_name(const char *name)
   if (strncmp(name, "#mysql50#", 9))
     return 1;
   sprintf(qbuf, "ALTER DATABASE `%s` UPGRADE DATA DIRECTORY NAME", name);
-  rc= run_query(qbuf);
+  rc= run_query(sock, qbuf);
   if (verbose)
     printf("%-50s %s\n", name, rc ? "FAILED" : "OK");
   return rc;
@@ -705,13 +832,29 @@ static int use_db(char *database)
   return 0;
 } /* use_db */
 
-static int disable_binlog()
+static int disable_binlog(MYSQL *mysql)
 {
   const char *stmt= "SET SQL_LOG_BIN=0";
-  return run_query(stmt);
+  return run_query(mysql, stmt);
 }
 
-static int handle_request_for_tables(char *tables, uint length)
+/* Keep the output of the --parallel-workers from interleaving. */
+
+static void lock_output()
+{
+  if (workers_running)
+    pthread_mutex_lock(&output_mutex);
+}
+
+
+static void unlock_output()
+{
+  if (workers_running)
+    pthread_mutex_unlock(&output_mutex);
+}
+
+
+static int handle_request_for_tables(MYSQL *mysql, char *tables, uint length)
 {
   char *query, *end, options[100], message[100];
   uint query_length= 0;
@@ -762,19 +905,170 @@ static int handle_request_for_tables(char *tables, uint length)
     ptr= strxmov(ptr, " ", options, NullS);
     query_length= (uint) (ptr - query);
   }
-  if (mysql_real_query(sock, query, query_length))
+  if (mysql_real_query(mysql, query, query_length))
   {
     sprintf(message, "when executing '%s TABLE ... %s'", op, options);
-    DBerror(sock, message);
+    lock_output();
+    DBerror(mysql, message);
+    unlock_output();
     return 1;
   }
-  print_result();
+  lock_output();
+  print_result(mysql);
+  unlock_output();
   my_free(query);
   return 0;
 }
 
 
-static void print_result()
+static int compare_table_jobs(const void *a, const void *b)
+{
+  ulonglong size_a= ((const TABLE_JOB*) a)->size;
+  ulonglong size_b= ((const TABLE_JOB*) b)->size;
+  /* Largest first */
+  return size_a < size_b ? 1 : size_a > size_b ? -1 : 0;
+}
+
+
+pthread_handler_t table_worker_thread(void *arg)
+{
+  MYSQL *mysql= (MYSQL*) arg;
+  uint worker= (uint) (mysql - worker_connections) + 1;
+  const char *current_db= 0;
+  TABLE_JOB *job;
+  ulonglong start;
+
+  if (mysql_thread_init())
+    return 0;
+  for (;;)
+  {
+    pthread_mutex_lock(&table_jobs_mutex);
+    job= (next_table_job < table_jobs.elements ?
+          dynamic_element(&table_jobs, next_table_job++, TABLE_JOB*) : 0);
+    pthread_mutex_unlock(&table_jobs_mutex);
+    if (!job)
+      break;
+
+    if (!current_db || strcmp(current_db, job->db))
+    {
+      if (mysql_select_db(mysql, job->db))
+      {
+        lock_output();
+        DBerror(mysql, "when selecting the database");
+        unlock_output();
+        current_db= 0;
+        continue;
+      }
+      current_db= job->db;
+    }
+    if (verbose)
+      fprintf(stderr, "# Worker %u: Starting %s.%s\n",
+              worker, job->db, job->table);
+    start= my_micro_time();
+    handle_request_for_tables(mysql, job->table,
+                              fixed_name_length(job->table));
+    if (verbose)
+      fprintf(stderr, "# Worker %u: Finished %s.%s in %.3f seconds\n",
+              worker, job->db, job->table,
+              (double) (my_micro_time() - start) / 1000000.0);
+  }
+  mysql_thread_end();
+  return 0;
+}
+
+
+/*
+  Process the queued tables over --parallel-workers connections,
+  the largest tables first, so that the workers don't end up
+  waiting for one big table after all others are done.
+*/
+
+static int run_table_jobs()
+{
+  uint workers= MY_MIN(opt_parallel_workers, table_jobs.elements);
+  uint opened, started, i;
+  pthread_t *threads;
+  int rc= 0;
+  DBUG_ENTER("run_table_jobs");
+
+  if (!workers)
+    DBUG_RETURN(0);
+  my_qsort(table_jobs.buffer, table_jobs.elements, sizeof(TABLE_JOB),
+           compare_table_jobs);
+
+  if (!(worker_connections=
+        (MYSQL*) my_malloc(PSI_NOT_INSTRUMENTED, workers * sizeof(MYSQL),
+                           MYF(MY_WME | MY_ZEROFILL))) ||
+      !(threads=
+        (pthread_t*) my_malloc(PSI_NOT_INSTRUMENTED,
+                               workers * sizeof(pthread_t), MYF(MY_WME))))
+  {
+    my_free(worker_connections);
+    DBUG_RETURN(1);
+  }
+
+  /* With --force, go on with the connections which could be opened. */
+  for (opened= 0; opened < workers; opened++)
+  {
+    MYSQL *mysql= &worker_connections[opened];
+    if (!connect_to_server(mysql, current_host, current_user, opt_password))
+    {
+      rc= 1;
+      break;
+    }
+    if (!opt_write_binlog && disable_binlog(mysql))
+    {
+      mysql_close(mysql);
+      rc= 1;
+      break;
+    }
+  }
+  if (verbose)
+    fprintf(stderr, "# Processing %u tables with %u workers\n",
+            table_jobs.elements, opened);
+
+  pthread_mutex_init(&table_jobs_mutex, NULL);
+  pthread_mutex_init(&output_mutex, NULL);
+  next_table_job= 0;
+  workers_running= 1;
+  for (started= 0; started < opened; started++)
+  {
+    if (pthread_create(&threads[started], NULL, table_worker_thread,
+                       &worker_connections[started]))
+    {
+      fprintf(stderr, "%s: Could not create thread\n", my_progname);
+      rc= 1;
+      break;
+    }
+  }
+  /* Nothing was processed without a worker. */
+  if (!started)
+    rc= 1;
+  for (i= 0; i < started; i++)
+    pthread_join(threads[i], NULL);
+  workers_running= 0;
+  pthread_mutex_destroy(&table_jobs_mutex);
+  pthread_mutex_destroy(&output_mutex);
+
+  for (i= 0; i < opened; i++)
+    mysql_close(&worker_connections[i]);
+  my_free(threads);
+  my_free(worker_connections);
+  worker_connections= 0;
+  DBUG_RETURN(rc);
+}
+
+
+static void free_table_jobs()
+{
+  uint i;
+  for (i= 0; i < table_jobs.elements; i++)
+    my_free(dynamic_element(&table_jobs, i, TABLE_JOB*)->db);
+  delete_dynamic(&table_jobs);
+}
+
+
+static void print_result(MYSQL *mysql)
 {
   MYSQL_RES *res;
   MYSQL_ROW row;
@@ -783,7 +1077,7 @@ static void print_result()
   uint i;
   my_bool found_error=0, table_rebuild=0;
 
-  res = mysql_use_result(sock);
+  res = mysql_use_result(mysql);
 
   prev[0] = '\0';
   prev_alter[0]= 0;
@@ -871,51 +1165,61 @@ static void print_result()
 }
 
 
-static int dbConnect(char *host, char *user, char *passwd)
+static MYSQL *connect_to_server(MYSQL *mysql, char *host, char *user,
+                                char *passwd)
 {
-  DBUG_ENTER("dbConnect");
-  if (verbose)
-  {
-    fprintf(stderr, "# Connecting to %s...\n", host ? host : "localhost");
-  }
-  mysql_init(&mysql_connection);
+  DBUG_ENTER("connect_to_server");
+  mysql_init(mysql);
   if (opt_compress)
-    mysql_options(&mysql_connection, MYSQL_OPT_COMPRESS, NullS);
+    mysql_options(mysql, MYSQL_OPT_COMPRESS, NullS);
 #ifdef HAVE_OPENSSL
   if (opt_use_ssl)
   {
-    mysql_ssl_set(&mysql_connection, opt_ssl_key, opt_ssl_cert, opt_ssl_ca,
+    mysql_ssl_set(mysql, opt_ssl_key, opt_ssl_cert, opt_ssl_ca,
 		  opt_ssl_capath, opt_ssl_cipher);
-    mysql_options(&mysql_connection, MYSQL_OPT_SSL_CRL, opt_ssl_crl);
-    mysql_options(&mysql_connection, MYSQL_OPT_SSL_CRLPATH, opt_ssl_crlpath);
+    mysql_options(mysql, MYSQL_OPT_SSL_CRL, opt_ssl_crl);
+    mysql_options(mysql, MYSQL_OPT_SSL_CRLPATH, opt_ssl_crlpath);
   }
 #endif
   if (opt_protocol)
-    mysql_options(&mysql_connection,MYSQL_OPT_PROTOCOL,(char*)&opt_protocol);
+    mysql_options(mysql,MYSQL_OPT_PROTOCOL,(char*)&opt_protocol);
   if (opt_bind_addr)
-    mysql_options(&mysql_connection, MYSQL_OPT_BIND, opt_bind_addr);
+    mysql_options(mysql, MYSQL_OPT_BIND, opt_bind_addr);
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
   if (shared_memory_base_name)
-    mysql_options(&mysql_connection,MYSQL_SHARED_MEMORY_BASE_NAME,shared_memory_base_name);
+    mysql_options(mysql,MYSQL_SHARED_MEMORY_BASE_NAME,shared_memory_base_name);
 #endif
 
   if (opt_plugin_dir && *opt_plugin_dir)
-    mysql_options(&mysql_connection, MYSQL_PLUGIN_DIR, opt_plugin_dir);
+    mysql_options(mysql, MYSQL_PLUGIN_DIR, opt_plugin_dir);
 
   if (opt_default_auth && *opt_default_auth)
-    mysql_options(&mysql_connection, MYSQL_DEFAULT_AUTH, opt_default_auth);
+    mysql_options(mysql, MYSQL_DEFAULT_AUTH, opt_default_auth);
 
-  mysql_options(&mysql_connection, MYSQL_SET_CHARSET_NAME, default_charset);
-  mysql_options(&mysql_connection, MYSQL_OPT_CONNECT_ATTR_RESET, 0);
-  mysql_options4(&mysql_connection, MYSQL_OPT_CONNECT_ATTR_ADD,
+  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, default_charset);
+  mysql_options(mysql, MYSQL_OPT_CONNECT_ATTR_RESET, 0);
+  mysql_options4(mysql, MYSQL_OPT_CONNECT_ATTR_ADD,
                  "program_name", "mysqlcheck");
-  if (!(sock = mysql_real_connect(&mysql_connection, host, user, passwd,
-         NULL, opt_mysql_port, opt_mysql_unix_port, 0)))
+  if (!mysql_real_connect(mysql, host, user, passwd,
+                          NULL, opt_mysql_port, opt_mysql_unix_port, 0))
   {
-    DBerror(&mysql_connection, "when trying to connect");
-    DBUG_RETURN(1);
+    DBerror(mysql, "when trying to connect");
+    DBUG_RETURN(0);
   }
-  mysql_connection.reconnect= 1;
+  mysql->reconnect= 1;
+  DBUG_RETURN(mysql);
+} /* connect_to_server */
+
+
+static int dbConnect(char *host, char *user, char *passwd)
+{
+  DBUG_ENTER("dbConnect");
+  if (verbose)
+  {
+    fprintf(stderr, "# Connecting to %s...\n", host ? host : "localhost");
+  }
+  if (!(sock= connect_to_server(&mysql_connection, host, user, passwd)))
+    DBUG_RETURN(1);
   DBUG_RETURN(0);
 } /* dbConnect */
 
@@ -966,12 +1270,19 @@ int main(int argc, char **argv)
 
   if (!opt_write_binlog)
   {
-    if (disable_binlog()) {
+    if (disable_binlog(sock)) {
       first_error= 1;
       goto end;
     }
   }
 
+  if (opt_parallel_workers > 1 &&
+      my_init_dynamic_array(&table_jobs, sizeof(TABLE_JOB), 1024, 1024))
+  {
+    first_error = 1;
+    goto end;
+  }
+
   if (opt_auto_repair &&
       (my_init_dynamic_array(&tables4repair, sizeof(char)*(NAME_LEN*2+2),16,64) ||
        my_init_dynamic_array(&tables4rebuild, sizeof(char)*(NAME_LEN*2+2),16,64) ||
@@ -989,6 +1300,8 @@ int main(int argc, char **argv)
   /* One or more databases, all tables */
   else
     process_databases(argv);
+  if (opt_parallel_workers > 1 && run_table_jobs() && !first_error)
+    first_error= EX_MYSQLERR;
   if (opt_auto_repair)
   {
     uint i;
@@ -999,15 +1312,17 @@ int main(int argc, char **argv)
     for (i = 0; i < tables4repair.elements ; i++)
     {
       char *name= (char*) dynamic_array_ptr(&tables4repair, i);
-      handle_request_for_tables(name, fixed_name_length(name));
+      handle_request_for_tables(sock, name, fixed_name_length(name));
     }
     for (i = 0; i < tables4rebuild.elements ; i++)
       rebuild_table((char*) dynamic_array_ptr(&tables4rebuild, i));
     for (i = 0; i < alter_table_cmds.elements ; i++)
-      run_query((char*) dynamic_array_ptr(&alter_table_cmds, i));
+      run_query(sock, (char*) dynamic_array_ptr(&alter_table_cmds, i));
   }
  end:
   dbDisconnect(current_host);
+  if (opt_parallel_workers > 1)
+    free_table_jobs();
   if (opt_auto_repair)
   {
     delete_dynamic(&tables4repair);
@@ -42,6 +42,7 @@
 
 #include <my_global.h>
 #include <my_sys.h>
+#include <my_pthread.h>
 #include <my_user.h>
 #include <m_string.h>
 #include <m_ctype.h>
@@ -158,6 +159,27 @@ static char *shared_memory_base_name=0;
 static uint opt_protocol= 0;
 static char *opt_plugin_dir= 0, *opt_default_auth= 0;
 
+/*
+  With --parallel, the SELECT ... INTO OUTFILE of each table is queued
+  here and run by one of opt_parallel worker connections, which all
+  read from the same snapshot as the main connection.
+*/
+typedef struct st_dump_job
+{
+  struct st_dump_job *next;
+  char *db;
+  char *query;
+} DUMP_JOB;
+
+static uint opt_parallel= 0;
+static MYSQL *dump_worker_connections= 0;
+static pthread_t *dump_workers= 0;
+static uint dump_worker_connections_opened= 0, dump_workers_started= 0;
+static DUMP_JOB *dump_jobs_head= 0, **dump_jobs_tail= &dump_jobs_head;
+static my_bool dump_jobs_end= 0, dump_jobs_abort= 0;
+static pthread_mutex_t dump_jobs_mutex;
+static pthread_cond_t dump_jobs_cond;
+
 DYNAMIC_ARRAY ignore_error;
 static int parse_ignore_error();
 
@@ -438,6 +460,14 @@ static struct my_option my_long_options[] =
   {"order-by-primary", OPT_ORDER_BY_PRIMARY,
    "Sorts each table's rows by primary key, or first unique key, if such a key exists.  Useful when dumping a MyISAM table to be loaded into an InnoDB table, but will make the dump itself take considerably longer.",
    &opt_order_by_primary, &opt_order_by_primary, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"parallel", OPT_MYSQLDUMP_PARALLEL,
+   "Number of additional connections which dump table data concurrently. "
+   "Requires --tab, and --single-transaction or --lock-all-tables, so that "
+   "all connections read the same data. With --single-transaction, the "
+   "connections start their transactions while FLUSH TABLES WITH READ LOCK "
+   "is held.",
+   &opt_parallel, &opt_parallel, 0, GET_UINT, REQUIRED_ARG, 0, 0, 256,
+   0, 0, 0},
   {"password", 'p',
    "Password to use when connecting to server. If password is not given it's solicited on the tty.",
    0, 0, 0, GET_PASSWORD, OPT_ARG, 0, 0, 0, 0, 0, 0},
@@ -571,6 +601,7 @@ static int dump_all_tablespaces();
 static int dump_tablespaces_for_tables(char *db, char **table_names, int tables);
 static int dump_tablespaces_for_databases(char** databases);
 static int dump_tablespaces(char* ts_where);
+static my_bool queue_dump_job(const char *db, const char *query);
 static void print_comment(FILE *sql_file, my_bool is_error, const char *format,
                           ...);
 
@@ -1016,6 +1047,18 @@ static int get_options(int *argc, char ***argv)
     fprintf(stderr, "%s: You can't use ..enclosed.. and ..optionally-enclosed.. at the same time.\n", my_progname);
     return(EX_USAGE);
   }
+  if (opt_parallel && !path)
+  {
+    fprintf(stderr, "%s: --parallel can only be used with --tab.\n",
+            my_progname);
+    return(EX_USAGE);
+  }
+  if (opt_parallel && !opt_single_transaction && !opt_lock_all_tables)
+  {
+    fprintf(stderr, "%s: --parallel requires --single-transaction or "
+            "--lock-all-tables.\n", my_progname);
+    return(EX_USAGE);
+  }
   if ((opt_databases || opt_alldbs) && path)
   {
     fprintf(stderr,
@@ -1583,73 +1626,65 @@ static void maybe_exit(int error)
 
 
 /*
-  db_connect -- connects to the host and selects DB.
+  connect_to_server -- connects a handle to the host and sets the
+  session variables every connection of the dump uses.
 */
 
-static int connect_to_db(char *host, char *user,char *passwd)
+static MYSQL *connect_to_server(MYSQL *con, char *host, char *user,
+                                char *passwd)
 {
   char buff[20+FN_REFLEN];
-  DBUG_ENTER("connect_to_db");
+  DBUG_ENTER("connect_to_server");
 
-  verbose_msg("-- Connecting to %s...\n", host ? host : "localhost");
-  mysql_init(&mysql_connection);
+  mysql_init(con);
   if (opt_compress)
-    mysql_options(&mysql_connection,MYSQL_OPT_COMPRESS,NullS);
+    mysql_options(con,MYSQL_OPT_COMPRESS,NullS);
 #ifdef HAVE_OPENSSL
   if (opt_use_ssl)
   {
-    mysql_ssl_set(&mysql_connection, opt_ssl_key, opt_ssl_cert, opt_ssl_ca,
+    mysql_ssl_set(con, opt_ssl_key, opt_ssl_cert, opt_ssl_ca,
                   opt_ssl_capath, opt_ssl_cipher);
-    mysql_options(&mysql_connection, MYSQL_OPT_SSL_CRL, opt_ssl_crl);
-    mysql_options(&mysql_connection, MYSQL_OPT_SSL_CRLPATH, opt_ssl_crlpath);
+    mysql_options(con, MYSQL_OPT_SSL_CRL, opt_ssl_crl);
+    mysql_options(con, MYSQL_OPT_SSL_CRLPATH, opt_ssl_crlpath);
   }
-  mysql_options(&mysql_connection,MYSQL_OPT_SSL_VERIFY_SERVER_CERT,
+  mysql_options(con,MYSQL_OPT_SSL_VERIFY_SERVER_CERT,
                 (char*)&opt_ssl_verify_server_cert);
 #endif
   if (opt_protocol)
-    mysql_options(&mysql_connection,MYSQL_OPT_PROTOCOL,(char*)&opt_protocol);
+    mysql_options(con,MYSQL_OPT_PROTOCOL,(char*)&opt_protocol);
   if (opt_bind_addr)
-    mysql_options(&mysql_connection,MYSQL_OPT_BIND,opt_bind_addr);
+    mysql_options(con,MYSQL_OPT_BIND,opt_bind_addr);
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
   if (shared_memory_base_name)
-    mysql_options(&mysql_connection,MYSQL_SHARED_MEMORY_BASE_NAME,shared_memory_base_name);
+    mysql_options(con,MYSQL_SHARED_MEMORY_BASE_NAME,shared_memory_base_name);
 #endif
-  mysql_options(&mysql_connection, MYSQL_SET_CHARSET_NAME, default_charset);
+  mysql_options(con, MYSQL_SET_CHARSET_NAME, default_charset);
 
   if (opt_plugin_dir && *opt_plugin_dir)
-    mysql_options(&mysql_connection, MYSQL_PLUGIN_DIR, opt_plugin_dir);
+    mysql_options(con, MYSQL_PLUGIN_DIR, opt_plugin_dir);
 
   if (opt_default_auth && *opt_default_auth)
-    mysql_options(&mysql_connection, MYSQL_DEFAULT_AUTH, opt_default_auth);
+    mysql_options(con, MYSQL_DEFAULT_AUTH, opt_default_auth);
 
-  mysql_options(&mysql_connection, MYSQL_OPT_CONNECT_ATTR_RESET, 0);
-  mysql_options4(&mysql_connection, MYSQL_OPT_CONNECT_ATTR_ADD,
+  mysql_options(con, MYSQL_OPT_CONNECT_ATTR_RESET, 0);
+  mysql_options4(con, MYSQL_OPT_CONNECT_ATTR_ADD,
                  "program_name", "mysqldump");
-  if (!(mysql= mysql_real_connect(&mysql_connection,host,user,passwd,
-                                  NULL,opt_mysql_port,opt_mysql_unix_port,
-                                  0)))
+  if (!mysql_real_connect(con,host,user,passwd,
+                          NULL,opt_mysql_port,opt_mysql_unix_port,
+                          0))
   {
-    DB_error(&mysql_connection, "when trying to connect");
-    DBUG_RETURN(1);
+    DB_error(con, "when trying to connect");
+    DBUG_RETURN(0);
   }
-  if ((mysql_get_server_version(&mysql_connection) < 40100) ||
-      (opt_compatible_mode & 3))
-  {
-    /* Don't dump SET NAMES with a pre-4.1 server (bug#7997).  */
-    opt_set_charset= 0;
-
-    /* Don't switch charsets for 4.1 and earlier.  (bug#34192). */
-    server_supports_switching_charsets= FALSE;
-  } 
   /*
     As we're going to set SQL_MODE, it would be lost on reconnect, so we
     cannot reconnect.
   */
-  mysql->reconnect= 0;
+  con->reconnect= 0;
   my_snprintf(buff, sizeof(buff), "/*!40100 SET @@SQL_MODE='%s' */",
               compatible_mode_normal_str);
-  if (mysql_query_with_error_report(mysql, 0, buff))
-    DBUG_RETURN(1);
+  if (mysql_query_with_error_report(con, 0, buff))
+    DBUG_RETURN(0);
   /*
     set time_zone to UTC to allow dumping date types between servers with
     different time zone settings
@@ -1657,9 +1692,33 @@ static int connect_to_db(char *host, char *user,char *passwd)
   if (opt_tz_utc)
   {
     my_snprintf(buff, sizeof(buff), "/*!40103 SET TIME_ZONE='+00:00' */");
-    if (mysql_query_with_error_report(mysql, 0, buff))
-      DBUG_RETURN(1);
+    if (mysql_query_with_error_report(con, 0, buff))
+      DBUG_RETURN(0);
   }
+  DBUG_RETURN(con);
+} /* connect_to_server */
+
+
+/*
+  db_connect -- connects to the host and selects DB.
+*/
+
+static int connect_to_db(char *host, char *user,char *passwd)
+{
+  DBUG_ENTER("connect_to_db");
+
+  verbose_msg("-- Connecting to %s...\n", host ? host : "localhost");
+  if (!(mysql= connect_to_server(&mysql_connection, host, user, passwd)))
+    DBUG_RETURN(1);
+  if ((mysql_get_server_version(&mysql_connection) < 40100) ||
+      (opt_compatible_mode & 3))
+  {
+    /* Don't dump SET NAMES with a pre-4.1 server (bug#7997).  */
+    opt_set_charset= 0;
+
+    /* Don't switch charsets for 4.1 and earlier.  (bug#34192). */
+    server_supports_switching_charsets= FALSE;
+  } 
   DBUG_RETURN(0);
 } /* connect_to_db */
 
@@ -3583,7 +3642,15 @@ static void dump_table(char *table, char *db)
       dynstr_append_checked(&query_string, order_by);
     }
 
-    if (mysql_real_query(mysql, query_string.str, query_string.length))
+    if (opt_parallel)
+    {
+      if (queue_dump_job(db, query_string.str))
+      {
+        error= EX_MYSQLERR;
+        goto err;
+      }
+    }
+    else if (mysql_real_query(mysql, query_string.str, query_string.length))
     {
       DB_error(mysql, "when executing 'SELECT INTO OUTFILE'");
       dynstr_free(&query_string);
@@ -5091,6 +5158,204 @@ static int start_transaction(MYSQL *mysql_con)
 }
 
 
+/*
+  Take the next table to dump for a --parallel worker, or NULL when
+  all tables are done or a worker failed.
+*/
+
+static DUMP_JOB *get_dump_job()
+{
+  DUMP_JOB *job;
+  pthread_mutex_lock(&dump_jobs_mutex);
+  while (!dump_jobs_head && !dump_jobs_end && !dump_jobs_abort)
+    pthread_cond_wait(&dump_jobs_cond, &dump_jobs_mutex);
+  if ((job= dump_jobs_abort ? 0 : dump_jobs_head))
+  {
+    if (!(dump_jobs_head= job->next))
+      dump_jobs_tail= &dump_jobs_head;
+  }
+  pthread_mutex_unlock(&dump_jobs_mutex);
+  return job;
+}
+
+
+static my_bool queue_dump_job(const char *db, const char *query)
+{
+  size_t db_length= strlen(db) + 1, query_length= strlen(query) + 1;
+  DUMP_JOB *job;
+  my_bool aborted;
+
+  if (!(job= (DUMP_JOB*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                   sizeof(DUMP_JOB) + db_length +
+                                   query_length, MYF(MY_WME))))
+    return 1;
+  job->next= 0;
+  job->db= (char*) (job + 1);
+  job->query= job->db + db_length;
+  memcpy(job->db, db, db_length);
+  memcpy(job->query, query, query_length);
+
+  pthread_mutex_lock(&dump_jobs_mutex);
+  if (!(aborted= dump_jobs_abort))
+  {
+    *dump_jobs_tail= job;
+    dump_jobs_tail= &job->next;
+    pthread_cond_signal(&dump_jobs_cond);
+  }
+  pthread_mutex_unlock(&dump_jobs_mutex);
+  if (aborted)
+    my_free(job);
+  return aborted;
+}
+
+
+/*
+  Report a failed query of a --parallel worker. Unless --force is used,
+  the other workers stop taking new tables and the dump fails.
+*/
+
+static void dump_worker_error(MYSQL *con, const char *query)
+{
+  pthread_mutex_lock(&dump_jobs_mutex);
+  fprintf(stderr, "%s: Couldn't execute '%s': %s (%d)\n",
+          my_progname, query, mysql_error(con), mysql_errno(con));
+  fflush(stderr);
+  if (!first_error)
+    first_error= EX_MYSQLERR;
+  if (!opt_force)
+  {
+    dump_jobs_abort= 1;
+    pthread_cond_broadcast(&dump_jobs_cond);
+  }
+  pthread_mutex_unlock(&dump_jobs_mutex);
+}
+
+
+pthread_handler_t dump_worker_thread(void *arg)
+{
+  MYSQL *con= (MYSQL*) arg;
+  char current_db[NAME_LEN + 1];
+  DUMP_JOB *job;
+
+  if (mysql_thread_init())
+  {
+    dump_worker_error(con, "mysql_thread_init()");
+    return 0;
+  }
+  current_db[0]= 0;
+  while ((job= get_dump_job()))
+  {
+    if (strcmp(current_db, job->db))
+    {
+      if (mysql_select_db(con, job->db))
+      {
+        dump_worker_error(con, "USE");
+        my_free(job);
+        continue;
+      }
+      strmake(current_db, job->db, sizeof(current_db) - 1);
+    }
+    if (mysql_real_query(con, job->query, (ulong) strlen(job->query)))
+      dump_worker_error(con, job->query);
+    my_free(job);
+  }
+  mysql_thread_end();
+  return 0;
+}
+
+
+/*
+  Open the --parallel worker connections and start their threads.
+
+  Called while the main connection holds FLUSH TABLES WITH READ LOCK,
+  so that with --single-transaction all workers see the snapshot of
+  the main connection.
+*/
+
+static int start_dump_workers()
+{
+  uint i;
+  DBUG_ENTER("start_dump_workers");
+
+  pthread_mutex_init(&dump_jobs_mutex, NULL);
+  pthread_cond_init(&dump_jobs_cond, NULL);
+  if (!(dump_worker_connections=
+        (MYSQL*) my_malloc(PSI_NOT_INSTRUMENTED, opt_parallel * sizeof(MYSQL),
+                           MYF(MY_WME | MY_ZEROFILL))) ||
+      !(dump_workers=
+        (pthread_t*) my_malloc(PSI_NOT_INSTRUMENTED,
+                               opt_parallel * sizeof(pthread_t),
+                               MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+
+  for (i= 0; i < opt_parallel; i++)
+  {
+    MYSQL *con= &dump_worker_connections[i];
+    if (!connect_to_server(con, current_host, current_user, opt_password))
+    {
+      mysql_close(con);
+      DBUG_RETURN(1);
+    }
+    dump_worker_connections_opened++;
+    if (opt_single_transaction && start_transaction(con))
+      DBUG_RETURN(1);
+  }
+  verbose_msg("-- Started %u worker connections\n", opt_parallel);
+
+  for (i= 0; i < opt_parallel; i++)
+  {
+    if (pthread_create(&dump_workers[i], NULL, dump_worker_thread,
+                       &dump_worker_connections[i]))
+    {
+      fprintf(stderr, "%s: Could not create thread\n", my_progname);
+      DBUG_RETURN(1);
+    }
+    dump_workers_started++;
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Wait until the --parallel workers have dumped all queued tables,
+  and close their connections.
+*/
+
+static void stop_dump_workers()
+{
+  uint i;
+  DUMP_JOB *job;
+
+  if (!dump_workers)
+    return;
+
+  pthread_mutex_lock(&dump_jobs_mutex);
+  dump_jobs_end= 1;
+  pthread_cond_broadcast(&dump_jobs_cond);
+  pthread_mutex_unlock(&dump_jobs_mutex);
+  for (i= 0; i < dump_workers_started; i++)
+    pthread_join(dump_workers[i], NULL);
+  for (i= 0; i < dump_worker_connections_opened; i++)
+    mysql_close(&dump_worker_connections[i]);
+
+  /* Tables left behind by an aborted dump */
+  while ((job= dump_jobs_head))
+  {
+    dump_jobs_head= job->next;
+    my_free(job);
+  }
+  dump_jobs_tail= &dump_jobs_head;
+
+  my_free(dump_workers);
+  my_free(dump_worker_connections);
+  dump_workers= 0;
+  dump_worker_connections= 0;
+  dump_workers_started= dump_worker_connections_opened= 0;
+  pthread_mutex_destroy(&dump_jobs_mutex);
+  pthread_cond_destroy(&dump_jobs_cond);
+}
+
+
 static ulong find_set(TYPELIB *lib, const char *x, uint length,
                       char **err_pos, uint *err_len)
 {
@@ -5800,7 +6065,7 @@ int main(int argc, char **argv)
     goto err;
 
   if ((opt_lock_all_tables || opt_master_data ||
-       (opt_single_transaction && flush_logs)) &&
+       (opt_single_transaction && (flush_logs || opt_parallel))) &&
       do_flush_tables_read_lock(mysql))
     goto err;
 
@@ -5832,6 +6097,13 @@ int main(int argc, char **argv)
   if (opt_single_transaction && start_transaction(mysql))
     goto err;
 
+  if (opt_parallel && start_dump_workers())
+  {
+    if (!first_error)
+      first_error= EX_MYSQLERR;
+    goto err;
+  }
+
   /* Add 'STOP SLAVE to beginning of dump */
   if (opt_slave_apply && add_stop_slave())
     goto err;
@@ -5873,6 +6145,9 @@ int main(int argc, char **argv)
     dump_databases(argv);
   }
 
+  /* the table data must be dumped before the slave is restarted */
+  stop_dump_workers();
+
   /* if --dump-slave , start the slave sql thread */
   if (opt_slave_data && do_start_slave_sql(mysql))
     goto err;
@@ -5908,6 +6183,7 @@ int main(int argc, char **argv)
     server.
   */
 err:
+  stop_dump_workers();
   dbDisconnect(current_host);
   if (!path)
     write_footer(md_result_file);
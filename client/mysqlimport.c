@@ -39,6 +39,20 @@ pthread_mutex_t counter_mutex;
 pthread_cond_t count_threshhold;
 #endif
 
+/*
+  A byte range of an input file, loaded by one connection with
+  --chunk-size. The chunk is sent with LOAD DATA LOCAL, through the
+  local infile handler below.
+*/
+typedef struct st_import_chunk
+{
+  char *filename;
+  my_off_t start, end, pos;
+  File file;
+  int error;
+  char error_msg[FN_REFLEN + 64];
+} IMPORT_CHUNK;
+
 static void db_error_with_table(MYSQL *mysql, char *table);
 static void db_error(MYSQL *mysql);
 static char *field_escape(char *to,const char *from,uint length);
@@ -47,7 +61,7 @@ static char *add_load_option(char *ptr,const char *object,
 
 static my_bool	verbose=0,lock_tables=0,ignore_errors=0,opt_delete=0,
 		replace=0,silent=0,ignore=0,opt_compress=0,
-                opt_low_priority= 0, tty_password= 0;
+                opt_low_priority= 0, tty_password= 0, opt_unique_checks= 1;
 static my_bool debug_info_flag= 0, debug_check_flag= 0;
 static uint opt_use_threads=0, opt_local_file=0, my_end_arg= 0;
 static char	*opt_password=0, *current_user=0,
@@ -60,6 +74,7 @@ static char *opt_bind_addr = NULL;
 static char * opt_mysql_unix_port=0;
 static char *opt_plugin_dir= 0, *opt_default_auth= 0;
 static longlong opt_ignore_lines= -1;
+static ulonglong opt_chunk_size= 0;
 #include <sslopt-vars.h>
 
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
@@ -77,6 +92,15 @@ static struct my_option my_long_options[] =
   {"default-character-set", OPT_DEFAULT_CHARSET,
    "Set the default character set.", &default_charset,
    &default_charset, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"chunk-size", OPT_MYSQLIMPORT_CHUNK_SIZE,
+   "Split each file at line boundaries into chunks of about this many "
+   "bytes, which the --use-threads connections load concurrently. The "
+   "chunks are read through the client, as with --local. Only files in "
+   "the default format of mysqldump --tab can be split: "
+   "--fields-enclosed-by, --fields-optionally-enclosed-by, "
+   "--fields-escaped-by and --lines-terminated-by cannot be used.",
+   &opt_chunk_size, &opt_chunk_size, 0, GET_ULL, REQUIRED_ARG, 0, 0, 0,
+   0, 0, 0},
   {"columns", 'c',
    "Use only these columns to import the data to. Give the column names in a comma separated list. This is same as giving columns to LOAD DATA INFILE.",
    &opt_columns, &opt_columns, 0, GET_STR, REQUIRED_ARG, 0, 0, 0,
@@ -172,6 +196,12 @@ static struct my_option my_long_options[] =
    &opt_mysql_unix_port, &opt_mysql_unix_port, 0, GET_STR,
    REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
 #include <sslopt-longopts.h>
+  {"unique-checks", OPT_MYSQLIMPORT_UNIQUE_CHECKS,
+   "Check unique secondary indexes while loading. Use --skip-unique-checks "
+   "to let InnoDB buffer the changes to them instead, when the data is "
+   "known to have no duplicates.",
+   &opt_unique_checks, &opt_unique_checks, 0, GET_BOOL, NO_ARG, 1, 0, 0,
+   0, 0, 0},
   {"use-threads", OPT_USE_THREADS,
    "Load files in parallel. The argument is the number "
    "of threads to use for loading data.",
@@ -283,6 +313,20 @@ static int get_options(int *argc, char ***argv)
     fprintf(stderr, "You can't use --ignore (-i) and --replace (-r) at the same time.\n");
     return(1);
   }
+  if (opt_chunk_size)
+  {
+    if (!opt_use_threads || lock_tables)
+    {
+      fprintf(stderr, "You can't use --chunk-size without --use-threads, or with --lock-tables.\n");
+      return(1);
+    }
+    if (enclosed || opt_enclosed || escaped || lines_terminated)
+    {
+      fprintf(stderr, "You can't use --chunk-size with --fields-enclosed-by, --fields-optionally-enclosed-by, --fields-escaped-by or --lines-terminated-by.\n");
+      return(1);
+    }
+    opt_local_file= 1;
+  }
   if (*argc < 2)
   {
     usage();
@@ -297,7 +341,30 @@ static int get_options(int *argc, char ***argv)
 
 
 
-static int write_to_table(char *filename, MYSQL *mysql)
+static int delete_from_table(char *tablename, MYSQL *mysql)
+{
+  char sql_statement[FN_REFLEN*16+256];
+  DBUG_ENTER("delete_from_table");
+
+  if (verbose)
+    fprintf(stdout, "Deleting the old data from table %s\n", tablename);
+  snprintf(sql_statement, FN_REFLEN*16+256, "DELETE FROM %s", tablename);
+  if (mysql_query(mysql, sql_statement))
+  {
+    db_error_with_table(mysql, tablename);
+    DBUG_RETURN(1);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Load a file, or with --chunk-size only the chunk of it, into the
+  table named after the file. The table of a chunk is emptied by
+  the caller, before any chunk of the file is loaded.
+*/
+
+static int write_to_table(char *filename, MYSQL *mysql, IMPORT_CHUNK *chunk)
 {
   char tablename[FN_REFLEN], hard_path[FN_REFLEN],
        escaped_name[FN_REFLEN * 2 + 1],
@@ -311,21 +378,15 @@ static int write_to_table(char *filename, MYSQL *mysql)
   else
     my_load_path(hard_path, filename, NULL); /* filename includes the path */
 
-  if (opt_delete)
-  {
-    if (verbose)
-      fprintf(stdout, "Deleting the old data from table %s\n", tablename);
-    snprintf(sql_statement, FN_REFLEN*16+256, "DELETE FROM %s", tablename);
-    if (mysql_query(mysql, sql_statement))
-    {
-      db_error_with_table(mysql, tablename);
-      DBUG_RETURN(1);
-    }
-  }
+  if (opt_delete && !chunk && delete_from_table(tablename, mysql))
+    DBUG_RETURN(1);
   to_unix_path(hard_path);
   if (verbose)
   {
-    if (opt_local_file)
+    if (chunk)
+      fprintf(stdout, "Loading bytes %lu to %lu of LOCAL file: %s into %s\n",
+              (ulong) chunk->start, (ulong) chunk->end, hard_path, tablename);
+    else if (opt_local_file)
       fprintf(stdout, "Loading data from LOCAL file: %s into %s\n",
 	      hard_path, tablename);
     else
@@ -360,7 +421,7 @@ static int write_to_table(char *filename, MYSQL *mysql)
 		       " OPTIONALLY ENCLOSED BY");
   end= add_load_option(end, escaped, " ESCAPED BY");
   end= add_load_option(end, lines_terminated, " LINES TERMINATED BY");
-  if (opt_ignore_lines >= 0)
+  if (opt_ignore_lines >= 0 && (!chunk || chunk->start == 0))
     end= strmov(longlong10_to_str(opt_ignore_lines, 
 				  strmov(end, " IGNORE "),10), " LINES");
   if (opt_columns)
@@ -465,6 +526,12 @@ static MYSQL *db_connect(char *host, char *database,
     ignore_errors=0;
     db_error(mysql);
   }
+  if (!opt_unique_checks &&
+      mysql_query(mysql, "/*!40014 SET UNIQUE_CHECKS=0 */"))
+  {
+    ignore_errors=0;
+    db_error(mysql);
+  }
   return mysql;
 }
 
@@ -558,10 +625,105 @@ static char *field_escape(char *to,const char *from,uint length)
 int exitcode= 0;
 
 #ifdef HAVE_LIBPTHREAD
-pthread_handler_t worker_thread(void *arg)
+static int chunk_infile_init(void **ptr, const char *filename
+                             __attribute__((unused)), void *userdata)
+{
+  IMPORT_CHUNK *chunk= (IMPORT_CHUNK*) userdata;
+  *ptr= chunk;
+  chunk->pos= chunk->start;
+  if ((chunk->file= my_open(chunk->filename, O_RDONLY | O_BINARY,
+                            MYF(0))) < 0)
+  {
+    chunk->error= my_errno;
+    my_snprintf(chunk->error_msg, sizeof(chunk->error_msg),
+                "File '%s' not found (Errcode: %d)",
+                chunk->filename, chunk->error);
+    return 1;
+  }
+  return 0;
+}
+
+
+static int chunk_infile_read(void *ptr, char *buf, uint buf_len)
+{
+  IMPORT_CHUNK *chunk= (IMPORT_CHUNK*) ptr;
+  size_t length= (size_t) MY_MIN(buf_len, chunk->end - chunk->pos);
+
+  if (length == 0)
+    return 0;
+  if (my_pread(chunk->file, (uchar*) buf, length, chunk->pos,
+               MYF(MY_NABP)))
+  {
+    chunk->error= my_errno ? my_errno : EE_READ;
+    my_snprintf(chunk->error_msg, sizeof(chunk->error_msg),
+                "Error reading file '%s' (Errcode: %d)",
+                chunk->filename, chunk->error);
+    return -1;
+  }
+  chunk->pos+= length;
+  return (int) length;
+}
+
+
+static void chunk_infile_end(void *ptr)
+{
+  IMPORT_CHUNK *chunk= (IMPORT_CHUNK*) ptr;
+  if (chunk && chunk->file >= 0)
+  {
+    my_close(chunk->file, MYF(0));
+    chunk->file= -1;
+  }
+}
+
+
+static int chunk_infile_error(void *ptr, char *error_msg, uint error_msg_len)
+{
+  IMPORT_CHUNK *chunk= (IMPORT_CHUNK*) ptr;
+  strmake(error_msg, chunk->error_msg, error_msg_len - 1);
+  return chunk->error ? CR_UNKNOWN_ERROR : 0;
+}
+
+
+/*
+  The offset of the first line of the file which starts after pos,
+  or size if there is none. A newline escaped with a backslash is
+  part of a field and does not end the line.
+*/
+
+static my_off_t next_line_start(File file, my_off_t pos, my_off_t size)
+{
+  uchar buf[IO_SIZE];
+  my_bool escape= 0;
+  my_off_t back;
+
+  /* Backslashes just before pos may escape the first newline */
+  for (back= pos; back > 0; back--)
+  {
+    if (my_pread(file, buf, 1, back - 1, MYF(MY_NABP)) || buf[0] != '\\')
+      break;
+    escape= !escape;
+  }
+
+  while (pos < size)
+  {
+    size_t i, length= (size_t) MY_MIN(sizeof(buf), size - pos);
+    if (my_pread(file, buf, length, pos, MYF(MY_NABP)))
+      return size;
+    for (i= 0; i < length; i++)
+    {
+      if (buf[i] == '\n' && !escape)
+        return pos + i + 1;
+      escape= (buf[i] == '\\') ? !escape : 0;
+    }
+    pos+= length;
+  }
+  return size;
+}
+
+
+static void load_in_thread(char *filename, IMPORT_CHUNK *chunk)
 {
   int error;
-  char *raw_table_name= (char *)arg;
   MYSQL *mysql= 0;
 
   if (mysql_thread_init())
@@ -578,10 +740,15 @@ pthread_handler_t worker_thread(void *arg)
     goto error;
   }
 
+  if (chunk)
+    mysql_set_local_infile_handler(mysql, chunk_infile_init,
+                                   chunk_infile_read, chunk_infile_end,
+                                   chunk_infile_error, chunk);
+
   /*
     We are not currently catching the error here.
   */
-  if((error= write_to_table(raw_table_name, mysql)))
+  if((error= write_to_table(filename, mysql, chunk)))
     if (exitcode == 0)
       exitcode= error;
 
@@ -594,9 +761,130 @@ error:
   pthread_cond_signal(&count_threshhold);
   pthread_mutex_unlock(&counter_mutex);
   mysql_thread_end();
+}
+
+
+pthread_handler_t worker_thread(void *arg)
+{
+  load_in_thread((char *)arg, 0);
+  return 0;
+}
+
 
+pthread_handler_t chunk_worker_thread(void *arg)
+{
+  IMPORT_CHUNK *chunk= (IMPORT_CHUNK*) arg;
+  load_in_thread(chunk->filename, chunk);
+  my_free(chunk);
   return 0;
 }
+
+
+/*
+  Start a thread once fewer than --use-threads are running.
+*/
+
+static void start_worker(pthread_attr_t *attr, void *(*func)(void *),
+                         void *arg)
+{
+  pthread_t mainthread;            /* Thread descriptor */
+
+  pthread_mutex_lock(&counter_mutex);
+  while (counter == opt_use_threads)
+  {
+    struct timespec abstime;
+
+    set_timespec(abstime, 3);
+    pthread_cond_timedwait(&count_threshhold, &counter_mutex, &abstime);
+  }
+  /* Before exiting the lock we set ourselves up for the next thread */
+  counter++;
+  pthread_mutex_unlock(&counter_mutex);
+  /* now create the thread */
+  if (pthread_create(&mainthread, attr, func, arg) != 0)
+  {
+    pthread_mutex_lock(&counter_mutex);
+    counter--;
+    pthread_mutex_unlock(&counter_mutex);
+    fprintf(stderr,"%s: Could not create thread\n",
+            my_progname);
+    if (func == chunk_worker_thread)
+      my_free(arg);
+    if (exitcode == 0)
+      exitcode= 1;
+  }
+}
+
+
+/*
+  Split a file into chunks of about --chunk-size bytes at line
+  boundaries, and start a thread loading each chunk.
+*/
+
+static void load_in_chunks(pthread_attr_t *attr, char *filename)
+{
+  MY_STAT stat_info;
+  File file;
+  my_off_t start, end, size;
+
+  if (!my_stat(filename, &stat_info, MYF(MY_WME)))
+  {
+    if (exitcode == 0)
+      exitcode= 1;
+    return;
+  }
+  size= (my_off_t) stat_info.st_size;
+  if (size <= opt_chunk_size)
+  {
+    start_worker(attr, worker_thread, filename);
+    return;
+  }
+
+  if ((file= my_open(filename, O_RDONLY | O_BINARY, MYF(MY_WME))) < 0)
+  {
+    if (exitcode == 0)
+      exitcode= 1;
+    return;
+  }
+  if (opt_delete)
+  {
+    char tablename[FN_REFLEN];
+    MYSQL *mysql;
+    fn_format(tablename, filename, "", "", 1 | 2);
+    if (!(mysql= db_connect(current_host,current_db,current_user,
+                            opt_password)))
+    {
+      my_close(file, MYF(0));
+      return;
+    }
+    if (delete_from_table(tablename, mysql) && exitcode == 0)
+      exitcode= 1;
+    db_disconnect(current_host, mysql);
+  }
+
+  for (start= 0; start < size; start= end)
+  {
+    IMPORT_CHUNK *chunk;
+    if (size - start <= opt_chunk_size)
+      end= size;
+    else
+      end= next_line_start(file, start + opt_chunk_size, size);
+    if (!(chunk= (IMPORT_CHUNK*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                           sizeof(IMPORT_CHUNK),
+                                           MYF(MY_WME | MY_ZEROFILL))))
+    {
+      if (exitcode == 0)
+        exitcode= 1;
+      break;
+    }
+    chunk->filename= filename;
+    chunk->start= start;
+    chunk->end= end;
+    chunk->file= -1;
+    start_worker(attr, chunk_worker_thread, chunk);
+  }
+  my_close(file, MYF(0));
+}
 #endif
 
 
@@ -622,7 +910,6 @@ int main(int argc, char **argv)
 #ifdef HAVE_LIBPTHREAD
   if (opt_use_threads && !lock_tables)
   {
-    pthread_t mainthread;            /* Thread descriptor */
     pthread_attr_t attr;          /* Thread attributes */
     pthread_attr_init(&attr);
     pthread_attr_setdetachstate(&attr,
@@ -633,27 +920,10 @@ int main(int argc, char **argv)
 
     for (counter= 0; *argv != NULL; argv++) /* Loop through tables */
     {
-      pthread_mutex_lock(&counter_mutex);
-      while (counter == opt_use_threads)
-      {
-        struct timespec abstime;
-
-        set_timespec(abstime, 3);
-        pthread_cond_timedwait(&count_threshhold, &counter_mutex, &abstime);
-      }
-      /* Before exiting the lock we set ourselves up for the next thread */
-      counter++;
-      pthread_mutex_unlock(&counter_mutex);
-      /* now create the thread */
-      if (pthread_create(&mainthread, &attr, worker_thread, 
-                         (void *)*argv) != 0)
-      {
-        pthread_mutex_lock(&counter_mutex);
-        counter--;
-        pthread_mutex_unlock(&counter_mutex);
-        fprintf(stderr,"%s: Could not create thread\n",
-                my_progname);
-      }
+      if (opt_chunk_size)
+        load_in_chunks(&attr, *argv);
+      else
+        start_worker(&attr, worker_thread, (void *)*argv);
     }
 
     /*
@@ -691,7 +961,7 @@ int main(int argc, char **argv)
     if (lock_tables)
       lock_table(mysql, argc, argv);
     for (; *argv != NULL; argv++)
-      if ((error= write_to_table(*argv, mysql)))
+      if ((error= write_to_table(*argv, mysql, 0)))
         if (exitcode == 0)
           exitcode= error;
     db_disconnect(current_host, mysql);
@@ -92,6 +92,7 @@ TODO:
 #include <sys/wait.h>
 #endif
 #include <ctype.h>
+#include <math.h>
 #include <welcome_copyright_notice.h>   /* ORACLE_WELCOME_COPYRIGHT_NOTICE */
 
 #ifdef _WIN32
@@ -144,8 +145,8 @@ static my_bool opt_compress= FALSE, tty_password= FALSE,
 const char *auto_generate_sql_type= "mixed";
 
 static unsigned long connect_flags= CLIENT_MULTI_RESULTS |
-                                    CLIENT_MULTI_STATEMENTS |
-                                    CLIENT_REMEMBER_OPTIONS;
+                                    CLIENT_MULTI_STATEMENTS |
+                                    CLIENT_REMEMBER_OPTIONS;
 
 
 static int verbose, delimiter_length;
@@ -177,6 +178,26 @@ const char *default_dbug_option="d:t:o,/tmp/mysqlslap.trace";
 const char *opt_csv_str;
 File csv_file;
 
+static my_bool opt_latency= FALSE, opt_prepared= FALSE;
+static ulonglong opt_rate= 0;
+static char *opt_time_series= NULL;
+static File time_series_file= -1;
+
+/*
+  Latency histograms, in microseconds. Values below 64 have a bucket
+  each, larger values have 32 buckets for every power of two, so the
+  value of a bucket is within about 3% of the values counted in it.
+*/
+#define LATENCY_SUB_BITS 5
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_BITS 40
+#define LATENCY_BUCKETS \
+  ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+/* Histograms of each query of the test, summed over all clients */
+static ulonglong *latency_totals= NULL;
+static uint latency_statements= 0;
+
 static uint opt_protocol= 0;
 
 static int get_options(int *argc,char ***argv);
@@ -218,12 +239,20 @@ typedef struct thread_context thread_context;
 struct thread_context {
   statement *stmt;
   ulonglong limit;
+  /* Queries per second of this client with --rate, 0 for no limit */
+  double rate;
+  /* Histogram of each query of stmt, with --latency */
+  ulonglong *latency;
+  /* Histogram since the last --time-series sample, under mutex */
+  ulonglong *interval;
+  pthread_mutex_t mutex;
 };
 
 typedef struct conclusions conclusions;
 
 struct conclusions {
   char *engine;
+  ulonglong *latency;
   long int avg_timing;
   long int max_timing;
   long int min_timing;
@@ -284,6 +313,80 @@ static long int timedif(struct timeval a, struct timeval b)
     return s + us;
 }
 
+static uint latency_bucket(ulonglong usecs)
+{
+  uint bits;
+
+  if (usecs < LATENCY_SUB_BUCKETS)
+    return (uint) usecs;
+  if (usecs >= (1ULL << LATENCY_MAX_BITS))
+    usecs= (1ULL << LATENCY_MAX_BITS) - 1;
+  for (bits= LATENCY_SUB_BITS; usecs >> (bits + 1); bits++)
+  {}
+  return (bits - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS +
+         (uint) (usecs >> (bits - LATENCY_SUB_BITS)) - LATENCY_SUB_BUCKETS;
+}
+
+
+/* The largest latency counted in a bucket */
+static ulonglong latency_bucket_value(uint bucket)
+{
+  uint shift;
+
+  if (bucket < 2 * LATENCY_SUB_BUCKETS)
+    return bucket;
+  shift= bucket / LATENCY_SUB_BUCKETS - 1;
+  return (((ulonglong) (bucket % LATENCY_SUB_BUCKETS +
+                        LATENCY_SUB_BUCKETS + 1)) << shift) - 1;
+}
+
+
+static ulonglong latency_count(const ulonglong *hist)
+{
+  ulonglong count= 0;
+  uint x;
+  for (x= 0; x < LATENCY_BUCKETS; x++)
+    count+= hist[x];
+  return count;
+}
+
+
+/* The latency below which percent of the queries completed */
+static ulonglong latency_percentile(const ulonglong *hist, ulonglong count,
+                                    double percent)
+{
+  ulonglong rank= (ulonglong) ceil(count * percent / 100.0), seen= 0;
+  uint x;
+
+  if (rank == 0)
+    rank= 1;
+  for (x= 0; x < LATENCY_BUCKETS; x++)
+  {
+    seen+= hist[x];
+    if (seen >= rank)
+      return latency_bucket_value(x);
+  }
+  return 0;
+}
+
+
+static void latency_add(ulonglong *to, const ulonglong *from)
+{
+  uint x;
+  for (x= 0; x < LATENCY_BUCKETS; x++)
+    to[x]+= from[x];
+}
+
+
+static uint count_statements(statement *stmt)
+{
+  uint count= 0;
+  for (; stmt && stmt->length; stmt= stmt->next)
+    count++;
+  return count;
+}
+
+
 #ifdef _WIN32
 static int gettimeofday(struct timeval *tp, void *tzp)
 {
@@ -420,6 +523,9 @@ int main(int argc, char **argv)
   if (!opt_only_print) 
     mysql_close(&mysql); /* Close & free connection */
 
+  if (time_series_file >= 0)
+    my_close(time_series_file, MYF(0));
+
   /* now free all the strings we created */
   my_free(opt_password);
   my_free(concurrency);
@@ -454,6 +560,15 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr)
 
   memset(&conclusion, 0, sizeof(conclusions));
 
+  if (opt_latency)
+  {
+    latency_statements= count_statements(query_statements);
+    latency_totals= (ulonglong *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                           sizeof(ulonglong) * LATENCY_BUCKETS *
+                                           MY_MAX(latency_statements, 1),
+                                           MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+  }
+
   if (auto_actual_queries)
     client_limit= auto_actual_queries;
   else if (num_of_query)
@@ -518,6 +633,7 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr)
     printf("Generating stats\n");
 
   generate_stats(&conclusion, eptr, head_sptr);
+  conclusion.latency= latency_totals;
 
   if (!opt_silent)
     print_conclusions(&conclusion);
@@ -525,6 +641,8 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr)
     print_conclusions_csv(&conclusion);
 
   my_free(head_sptr);
+  my_free(latency_totals);
+  latency_totals= NULL;
 
 }
 
@@ -631,6 +749,10 @@ static struct my_option my_long_options[] =
     REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"iterations", 'i', "Number of times to run the tests.", &iterations,
     &iterations, 0, GET_UINT, REQUIRED_ARG, 1, 0, 0, 0, 0, 0},
+  {"latency", OPT_SLAP_LATENCY,
+    "Report the 50th, 99th and 99.9th percentile and the maximum of the "
+    "query latencies, of each query and of all queries together.",
+    &opt_latency, &opt_latency, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"no-drop", OPT_SLAP_NO_DROP, "Do not drop the schema after the test.",
    &opt_no_drop, &opt_no_drop, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"number-char-cols", 'x', 
@@ -679,12 +801,23 @@ static struct my_option my_long_options[] =
     "system() string to execute before running tests.",
     &pre_system, &pre_system,
     0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"prepared", OPT_SLAP_PREPARED,
+    "Run the queries as prepared statements, prepared once by each "
+    "client. A query can hold one statement only.",
+    &opt_prepared, &opt_prepared, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"protocol", OPT_MYSQL_PROTOCOL,
     "The protocol to use for connection (tcp, socket, pipe, memory).",
     0, 0, 0, GET_STR,  REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"query", 'q', "Query to run or file containing query to run.",
     &user_supplied_query, &user_supplied_query,
     0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"rate", OPT_SLAP_RATE,
+    "Send this many queries per second, from all clients together, at "
+    "random (Poisson) intervals, instead of sending the next query when "
+    "the previous one is done. The latency of a query is counted from "
+    "the time it was due, so that queries held up by a slow one are "
+    "reported as slow too. Implies --latency.",
+    &opt_rate, &opt_rate, 0, GET_ULL, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
   {"shared-memory-base-name", OPT_SHARED_MEMORY_BASE_NAME,
     "Base name of shared memory.", &shared_memory_base_name,
@@ -698,6 +831,13 @@ static struct my_option my_long_options[] =
     &opt_mysql_unix_port, &opt_mysql_unix_port, 0, GET_STR,
     REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
 #include <sslopt-longopts.h>
+  {"time-series", OPT_SLAP_TIME_SERIES,
+    "Append a line for every second of the test to the named CSV file, "
+    "with the number of clients, the second, the number of queries "
+    "completed and the 50th, 99th and 99.9th percentile and the maximum "
+    "of their latencies in microseconds. Implies --latency.",
+    &opt_time_series, &opt_time_series, 0, GET_STR, REQUIRED_ARG,
+    0, 0, 0, 0, 0, 0},
   {"user", 'u', "User for login if not current user.", &user,
     &user, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"verbose", 'v',
@@ -1255,6 +1395,21 @@ get_options(int *argc,char ***argv)
     }
   }
 
+  if (opt_time_series)
+  {
+    if ((time_series_file= my_open(opt_time_series,
+                                   O_CREAT|O_WRONLY|O_APPEND, MYF(0))) == -1)
+    {
+      fprintf(stderr,"%s: Could not open time series file: %s\n",
+              my_progname, opt_time_series);
+      exit(1);
+    }
+    opt_latency= TRUE;
+  }
+
+  if (opt_rate)
+    opt_latency= TRUE;
+
   if (opt_only_print)
     opt_silent= TRUE;
 
@@ -1753,18 +1908,77 @@ run_statements(MYSQL *mysql, statement *stmt)
   DBUG_RETURN(0);
 }
 
+/*
+  Write the queries completed by all clients since the previous sample
+  to the --time-series file.
+*/
+
+static void
+write_time_series(thread_context *con, uint concur, ulonglong *hist,
+                  ulonglong elapsed)
+{
+  char buffer[HUGE_STRING_LENGTH];
+  ulonglong count;
+  uint x;
+
+  memset(hist, 0, sizeof(ulonglong) * LATENCY_BUCKETS);
+  for (x= 0; x < concur; x++)
+  {
+    pthread_mutex_lock(&con[x].mutex);
+    latency_add(hist, con[x].interval);
+    memset(con[x].interval, 0, sizeof(ulonglong) * LATENCY_BUCKETS);
+    pthread_mutex_unlock(&con[x].mutex);
+  }
+  count= latency_count(hist);
+  snprintf(buffer, HUGE_STRING_LENGTH,
+           "%u,%llu.%03llu,%llu,%llu,%llu,%llu,%llu\n",
+           concur, elapsed / 1000000, elapsed / 1000 % 1000, count,
+           count ? latency_percentile(hist, count, 50.0) : 0,
+           count ? latency_percentile(hist, count, 99.0) : 0,
+           count ? latency_percentile(hist, count, 99.9) : 0,
+           count ? latency_percentile(hist, count, 100.0) : 0);
+  my_write(time_series_file, (uchar*) buffer, (uint)strlen(buffer), MYF(0));
+}
+
+
 static int
 run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
 {
   uint x;
   struct timeval start_time, end_time;
-  thread_context con;
+  thread_context *con;
+  ulonglong *sample= NULL;
+  ulonglong start_micro, next_sample;
+  uint statements= count_statements(stmts);
   pthread_t mainthread;            /* Thread descriptor */
   pthread_attr_t attr;          /* Thread attributes */
   DBUG_ENTER("run_scheduler");
 
-  con.stmt= stmts;
-  con.limit= limit;
+  con= (thread_context *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                   sizeof(thread_context) * concur,
+                                   MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+  for (x= 0; x < concur; x++)
+  {
+    con[x].stmt= stmts;
+    con[x].limit= limit;
+    con[x].rate= (double) opt_rate / concur;
+    if (opt_latency)
+      con[x].latency= (ulonglong *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                             sizeof(ulonglong) *
+                                             LATENCY_BUCKETS *
+                                             MY_MAX(statements, 1),
+                                             MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+    if (time_series_file >= 0)
+      con[x].interval= (ulonglong *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                              sizeof(ulonglong) *
+                                              LATENCY_BUCKETS,
+                                              MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+    pthread_mutex_init(&con[x].mutex, NULL);
+  }
+  if (time_series_file >= 0)
+    sample= (ulonglong *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                   sizeof(ulonglong) * LATENCY_BUCKETS,
+                                   MYF(MY_FAE|MY_WME));
 
   pthread_attr_init(&attr);
   pthread_attr_setdetachstate(&attr,
@@ -1780,7 +1994,7 @@ run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
   {
     /* now you create the thread */
     if (pthread_create(&mainthread, &attr, run_task, 
-                       (void *)&con) != 0)
+                       (void *)&con[x]) != 0)
     {
       fprintf(stderr,"%s: Could not create thread\n",
               my_progname);
@@ -1797,6 +2011,8 @@ run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
   pthread_cond_broadcast(&sleep_threshhold);
 
   gettimeofday(&start_time, NULL);
+  start_micro= my_micro_time();
+  next_sample= start_micro + 1000000;
 
   /*
     We loop until we know that all children have cleaned up.
@@ -1806,30 +2022,174 @@ run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
   {
     struct timespec abstime;
 
-    set_timespec(abstime, 3);
+    set_timespec(abstime, sample ? 1 : 3);
     pthread_cond_timedwait(&count_threshhold, &counter_mutex, &abstime);
+    if (sample && my_micro_time() >= next_sample)
+    {
+      write_time_series(con, concur, sample, next_sample - start_micro);
+      next_sample+= 1000000;
+    }
   }
   pthread_mutex_unlock(&counter_mutex);
 
   gettimeofday(&end_time, NULL);
+  if (sample)
+    write_time_series(con, concur, sample, my_micro_time() - start_micro);
 
 
   sptr->timing= timedif(end_time, start_time);
   sptr->users= concur;
   sptr->rows= limit;
 
+  for (x= 0; x < concur; x++)
+  {
+    my_free(con[x].latency);
+    my_free(con[x].interval);
+    pthread_mutex_destroy(&con[x].mutex);
+  }
+  my_free(con);
+  my_free(sample);
+
   DBUG_RETURN(0);
 }
 
 
+/*
+  Run a query of the test, as a prepared statement when prepared is
+  not NULL, and read its results.
+*/
+
+static void
+run_task_query(MYSQL *mysql, statement *ptr, MYSQL_STMT **prepared)
+{
+  MYSQL_RES *result;
+  MYSQL_BIND bind;
+  char *key= NULL;
+  char buffer[HUGE_STRING_LENGTH];
+  int length;
+
+  /* 
+    We have to execute differently based on query type.
+  */
+  if ((ptr->type == UPDATE_TYPE_REQUIRES_PREFIX) ||
+      (ptr->type == SELECT_TYPE_REQUIRES_PREFIX))
+  {
+    unsigned int key_val;
+
+    /* 
+      This should only happen if some sort of new engine was
+      implemented that didn't properly handle UPDATEs.
+
+      Just in case someone runs this under an experimental engine we don't
+      want a crash so the if() is placed here.
+    */
+    DBUG_ASSERT(primary_keys_number_of);
+    if (!primary_keys_number_of)
+      return;
+    key_val= (unsigned int)(random() % primary_keys_number_of);
+    key= primary_keys[key_val];
+
+    DBUG_ASSERT(key);
+  }
+
+  if (prepared && !opt_only_print)
+  {
+    if (!*prepared)
+    {
+      const char *query= ptr->string;
+      length= (int) ptr->length;
+      if (key)
+      {
+        length= snprintf(buffer, HUGE_STRING_LENGTH, "%.*s ?", 
+                         (int)ptr->length, ptr->string);
+        query= buffer;
+      }
+      if (!(*prepared= mysql_stmt_init(mysql)) ||
+          mysql_stmt_prepare(*prepared, query, length))
+      {
+        fprintf(stderr,"%s: Cannot prepare query %.*s ERROR : %s\n",
+                my_progname, length, query,
+                *prepared ? mysql_stmt_error(*prepared) : mysql_error(mysql));
+        exit(0);
+      }
+    }
+    if (key)
+    {
+      memset(&bind, 0, sizeof(bind));
+      bind.buffer_type= MYSQL_TYPE_STRING;
+      bind.buffer= key;
+      bind.buffer_length= (ulong) strlen(key);
+      mysql_stmt_bind_param(*prepared, &bind);
+    }
+    if (mysql_stmt_execute(*prepared) || mysql_stmt_store_result(*prepared))
+    {
+      fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
+              my_progname, (uint)ptr->length, ptr->string,
+              mysql_stmt_error(*prepared));
+      exit(0);
+    }
+    mysql_stmt_free_result(*prepared);
+    return;
+  }
+
+  if (key)
+  {
+    length= snprintf(buffer, HUGE_STRING_LENGTH, "%.*s '%s'", 
+                     (int)ptr->length, ptr->string, key);
+
+    if (run_query(mysql, buffer, length))
+    {
+      fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
+              my_progname, (uint)length, buffer, mysql_error(mysql));
+      exit(0);
+    }
+  }
+  else
+  {
+    if (run_query(mysql, ptr->string, ptr->length))
+    {
+      fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
+              my_progname, (uint)ptr->length, ptr->string, mysql_error(mysql));
+      exit(0);
+    }
+  }
+
+  do
+  {
+    if (mysql_field_count(mysql))
+    {
+      if (!(result= mysql_store_result(mysql)))
+        fprintf(stderr, "%s: Error when storing result: %d %s\n",
+                my_progname, mysql_errno(mysql), mysql_error(mysql));
+      else
+        mysql_free_result(result);
+    }
+  } while(mysql_next_result(mysql) == 0);
+}
+
+
+static void
+close_prepared(MYSQL_STMT **prepared, uint count)
+{
+  uint x;
+  for (x= 0; prepared && x < count; x++)
+  {
+    if (prepared[x])
+      mysql_stmt_close(prepared[x]);
+    prepared[x]= NULL;
+  }
+}
+
+
 pthread_handler_t run_task(void *p)
 {
-  ulonglong counter= 0, queries;
+  ulonglong queries;
   ulonglong detach_counter;
   unsigned int commit_counter;
+  uint statements= 0, stmt_no;
+  ulonglong due= 0, start_time;
   MYSQL *mysql;
-  MYSQL_RES *result;
-  MYSQL_ROW row;
+  MYSQL_STMT **prepared= NULL;
   statement *ptr;
   thread_context *con= (thread_context *)p;
 
@@ -1870,17 +2230,27 @@ pthread_handler_t run_task(void *p)
     printf("connected!\n");
   queries= 0;
 
+  statements= count_statements(con->stmt);
+  if (opt_prepared)
+    prepared= (MYSQL_STMT **)my_malloc(PSI_NOT_INSTRUMENTED,
+                                       sizeof(MYSQL_STMT *) *
+                                       MY_MAX(statements, 1),
+                                       MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+
   commit_counter= 0;
   if (commit_rate)
     run_query(mysql, "SET AUTOCOMMIT=0", strlen("SET AUTOCOMMIT=0"));
 
+  due= my_micro_time();
+
 limit_not_met:
-    for (ptr= con->stmt, detach_counter= 0; 
+    for (ptr= con->stmt, detach_counter= 0, stmt_no= 0; 
          ptr && ptr->length; 
-         ptr= ptr->next, detach_counter++)
+         ptr= ptr->next, detach_counter++, stmt_no++)
     {
       if (!opt_only_print && detach_rate && !(detach_counter % detach_rate))
       {
+        close_prepared(prepared, statements);
         mysql_close(mysql);
 
         if (!(mysql= mysql_init(NULL)))
@@ -1894,68 +2264,37 @@ limit_not_met:
           goto end;
       }
 
-      /* 
-        We have to execute differently based on query type. This should become a function.
+      /*
+        With --rate, the queries are due at random intervals, with
+        exponentially distributed lengths, and a late query is not
+        made up for by waiting less for the next one.
       */
-      if ((ptr->type == UPDATE_TYPE_REQUIRES_PREFIX) ||
-          (ptr->type == SELECT_TYPE_REQUIRES_PREFIX))
+      if (con->rate > 0)
       {
-        int length;
-        unsigned int key_val;
-        char *key;
-        char buffer[HUGE_STRING_LENGTH];
-
-        /* 
-          This should only happen if some sort of new engine was
-          implemented that didn't properly handle UPDATEs.
-
-          Just in case someone runs this under an experimental engine we don't
-          want a crash so the if() is placed here.
-        */
-        DBUG_ASSERT(primary_keys_number_of);
-        if (primary_keys_number_of)
-        {
-          key_val= (unsigned int)(random() % primary_keys_number_of);
-          key= primary_keys[key_val];
-
-          DBUG_ASSERT(key);
-
-          length= snprintf(buffer, HUGE_STRING_LENGTH, "%.*s '%s'", 
-                           (int)ptr->length, ptr->string, key);
+        ulonglong now= my_micro_time();
+        double uniform= (random() + 1.0) / (RAND_MAX + 2.0);
 
-          if (run_query(mysql, buffer, length))
-          {
-            fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
-                    my_progname, (uint)length, buffer, mysql_error(mysql));
-            exit(0);
-          }
-        }
+        if (now < due)
+          my_sleep((ulong) (due - now));
+        start_time= due;
+        due+= (ulonglong) (-log(uniform) * 1000000.0 / con->rate);
       }
       else
-      {
-        if (run_query(mysql, ptr->string, ptr->length))
-        {
-          fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
-                  my_progname, (uint)ptr->length, ptr->string, mysql_error(mysql));
-          exit(0);
-        }
-      }
+        start_time= my_micro_time();
 
-      do
+      run_task_query(mysql, ptr, prepared ? &prepared[stmt_no] : NULL);
+
+      if (con->latency)
       {
-        if (mysql_field_count(mysql))
+        uint bucket= latency_bucket(my_micro_time() - start_time);
+        con->latency[stmt_no * LATENCY_BUCKETS + bucket]++;
+        if (con->interval)
         {
-          if (!(result= mysql_store_result(mysql)))
-            fprintf(stderr, "%s: Error when storing result: %d %s\n",
-                    my_progname, mysql_errno(mysql), mysql_error(mysql));
-          else
-          {
-            while ((row= mysql_fetch_row(result)))
-              counter++;
-            mysql_free_result(result);
-          }
+          pthread_mutex_lock(&con->mutex);
+          con->interval[bucket]++;
+          pthread_mutex_unlock(&con->mutex);
         }
-      } while(mysql_next_result(mysql) == 0);
+      }
       queries++;
 
       if (commit_rate && (++commit_counter == commit_rate))
@@ -1975,12 +2314,21 @@ end:
   if (commit_rate)
     run_query(mysql, "COMMIT", strlen("COMMIT"));
 
+  close_prepared(prepared, statements);
+  my_free(prepared);
+
   if (!opt_only_print) 
     mysql_close(mysql);
 
   mysql_thread_end();
 
   pthread_mutex_lock(&counter_mutex);
+  if (con->latency && latency_totals)
+  {
+    for (stmt_no= 0; stmt_no < statements; stmt_no++)
+      latency_add(latency_totals + stmt_no * LATENCY_BUCKETS,
+                  con->latency + stmt_no * LATENCY_BUCKETS);
+  }
   thread_counter--;
   pthread_cond_signal(&count_threshhold);
   pthread_mutex_unlock(&counter_mutex);
@@ -2144,6 +2492,20 @@ parse_comma(const char *string, uint **range)
   return count;
 }
 
+static void
+print_latency(const char *name, const ulonglong *hist)
+{
+  ulonglong count= latency_count(hist);
+  if (!count)
+    return;
+  printf("\tLatency of %s in microseconds: "
+         "50%%: %llu, 99%%: %llu, 99.9%%: %llu, max: %llu\n", name,
+         latency_percentile(hist, count, 50.0),
+         latency_percentile(hist, count, 99.0),
+         latency_percentile(hist, count, 99.9),
+         latency_percentile(hist, count, 100.0));
+}
+
 void
 print_conclusions(conclusions *con)
 {
@@ -2158,6 +2520,27 @@ print_conclusions(conclusions *con)
                     con->max_timing / 1000, con->max_timing % 1000);
   printf("\tNumber of clients running queries: %d\n", con->users);
   printf("\tAverage number of queries per client: %llu\n", con->avg_rows); 
+  if (con->latency && latency_statements)
+  {
+    ulonglong *all= (ulonglong *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                           sizeof(ulonglong) * LATENCY_BUCKETS,
+                                           MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+    uint x;
+
+    for (x= 0; x < latency_statements; x++)
+      latency_add(all, con->latency + x * LATENCY_BUCKETS);
+    print_latency("all queries", all);
+    if (latency_statements > 1)
+    {
+      for (x= 0; x < latency_statements; x++)
+      {
+        char name[32];
+        my_snprintf(name, sizeof(name), "query %u", x + 1);
+        print_latency(name, con->latency + x * LATENCY_BUCKETS);
+      }
+    }
+    my_free(all);
+  }
   printf("\n");
 }
 
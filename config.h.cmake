@@ -227,6 +227,7 @@
 #cmakedefine HAVE_SIGNAL_H 1
 #cmakedefine HAVE_SYS_DEVPOLL_H 1
 #cmakedefine HAVE_SYS_EPOLL_H 1
+#cmakedefine HAVE_LINUX_PERF_EVENT_H 1
 #cmakedefine HAVE_TAILQFOREACH 1
 
 #cmakedefine HAVE_VALGRIND
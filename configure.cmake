@@ -311,6 +311,7 @@ IF(HAVE_DEVPOLL)
   SET(HAVE_SYS_DEVPOLL_H 1)
 ENDIF()
 CHECK_INCLUDE_FILES(sys/epoll.h HAVE_SYS_EPOLL_H)
+CHECK_INCLUDE_FILES(linux/perf_event.h HAVE_LINUX_PERF_EVENT_H)
 CHECK_SYMBOL_EXISTS (TAILQ_FOREACH "sys/queue.h" HAVE_TAILQFOREACH)
 
 # Figure out threading library
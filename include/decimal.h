@@ -45,11 +45,14 @@ int decimal2ulonglong(decimal_t *from, ulonglong *to);
 int ulonglong2decimal(ulonglong from, decimal_t *to);
 int decimal2longlong(decimal_t *from, longlong *to);
 int longlong2decimal(longlong from, decimal_t *to);
+int decimal2scaled_longlong(const decimal_t *from, longlong *to, int scale);
 int decimal2double(const decimal_t *from, double *to);
 int double2decimal(double from, decimal_t *to);
 int decimal_actual_fraction(decimal_t *from);
 int decimal2bin(decimal_t *from, uchar *to, int precision, int scale);
 int bin2decimal(const uchar *from, decimal_t *to, int precision, int scale);
+int bin2scaled_longlong(const uchar *from, longlong *to,
+                        int precision, int scale);
 
 /**
   Convert decimal to lldiv_t.
@@ -89,6 +92,7 @@ int decimal_mod(const decimal_t *from1, const decimal_t *from2, decimal_t *to);
 int decimal_round(const decimal_t *from, decimal_t *to, int new_scale,
                   decimal_round_mode mode);
 int decimal_is_zero(const decimal_t *from);
+int decimal_shift(decimal_t *dec, int shift);
 void max_decimal(int precision, int frac, decimal_t *to);
 
 #define string2decimal(A,B,C) internal_str2dec((A), (B), (C), 0)
@@ -110,6 +110,19 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+/*
+  A BLOB column of a heap table. In the stored record the pointer to the
+  value is replaced by the pointer to the first chunk of a chain in
+  HP_SHARE::blob_block, and the value is copied back to a buffer of the
+  HP_INFO when the record is read.
+*/
+
+typedef struct st_hp_blob_desc
+{
+  uint offset;				/* Offset of the column in record */
+  uint packlength;			/* Bytes of the length of a value */
+} HP_BLOB_DESC;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -156,6 +169,12 @@ typedef struct st_heap_share
   uint auto_key;
   uint auto_key_type;			/* real type of the auto key segment */
   ulonglong auto_increment;
+  HP_BLOB_DESC *blob_descs;		/* BLOB columns */
+  uint blobs;				/* Number of BLOB columns */
+  HP_BLOCK blob_block;			/* Chunks of the BLOB values */
+  uchar *blob_del_link;			/* Link to next free chunk */
+  ulong blob_chunks;			/* Chunks allocated in blob_block */
+  ulong blob_deleted;			/* Free chunks */
 } HP_SHARE;
 
 struct st_hp_hash_info;
@@ -178,6 +197,9 @@ typedef struct st_heap_info
   my_bool implicit_emptied;
   THR_LOCK_DATA lock;
   LIST open_list;
+  uchar **blob_heads;			/* Chains written by hp_write_blobs */
+  uchar *blob_buffer;			/* BLOB values of the last record read */
+  size_t blob_buffer_length;
 } HP_INFO;
 
 
@@ -190,6 +212,8 @@ typedef struct st_heap_create_info
   uint auto_key_type;
   uint keys;
   uint reclength;
+  uint blobs;                           /* Number of BLOB columns */
+  HP_BLOB_DESC *blob_descs;
   ulonglong max_table_size;
   ulonglong auto_increment;
   my_bool with_auto_increment;
@@ -71,6 +71,7 @@ typedef struct st_key_cache
   BLOCK_LINK *free_block_list;   /* list of free blocks */
   BLOCK_LINK *block_root;        /* memory for block links                   */
   uchar *block_mem;              /* memory for block buffers                 */
+  size_t block_mem_size;         /* size of block_mem, for my_large_free()   */
   BLOCK_LINK *used_last;         /* ptr to the last block of the LRU chain   */
   BLOCK_LINK *used_ins;          /* ptr to the insertion block in LRU chain  */
   mysql_mutex_t cache_lock;      /* to lock access to the cache structure    */
@@ -104,6 +105,14 @@ typedef struct st_key_cache
 
   int blocks;                   /* max number of blocks in the cache        */
   my_bool in_init;		/* Set to 1 in MySQL during init/resize     */
+
+  /*
+    A big key cache is split into 'partitions' simple key caches, each
+    with its own cache_lock. 'partition' is NULL if it is not split.
+    The statistics above are then summed up by update_key_cache_stats().
+  */
+  uint partitions;
+  struct st_key_cache *partition;
 } KEY_CACHE;
 
 /* The default key cache */
@@ -131,6 +140,7 @@ extern int key_cache_write(KEY_CACHE *keycache,
 extern int flush_key_blocks(KEY_CACHE *keycache,
                             int file, enum flush_type type);
 extern void end_key_cache(KEY_CACHE *keycache, my_bool cleanup);
+extern void update_key_cache_stats(KEY_CACHE *keycache);
 
 /* Functions to handle multiple key caches */
 extern my_bool multi_keycache_init(void);
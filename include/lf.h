@@ -244,6 +244,10 @@ void lf_hash_destroy(LF_HASH *hash);
 int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data);
 void *lf_hash_search(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen);
 int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen);
+/* called with an element and the user argument, non-0 stops the walk */
+typedef int lf_hash_walk_func(void *, void *);
+int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins,
+                    lf_hash_walk_func *action, void *argument);
 /*
   shortcut macros to access underlying pinbox functions from an LF_HASH
   see _lf_pinbox_get_pins() and _lf_pinbox_put_pins()
@@ -74,6 +74,8 @@ extern	void bchange(uchar *dst,size_t old_len,const uchar *src,
 extern	void strappend(char *s,size_t len,pchar fill);
 extern	char *strend(const char *s);
 extern  char *strcend(const char *, pchar);
+extern const char *my_memchr2(const char *s, const char *end,
+                              uchar c1, uchar c2);
 extern	char *strfill(char * s,size_t len,pchar fill);
 extern	char *strmake(char *dst,const char *src,size_t length);
 
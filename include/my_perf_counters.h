@@ -0,0 +1,79 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef MY_PERF_COUNTERS_INCLUDED
+#define MY_PERF_COUNTERS_INCLUDED
+
+/**
+  @file
+  Hardware performance counters of the current thread.
+
+  On Linux the counters are read from a group of perf events, opened with
+  perf_event_open() the first time a thread reads them. Only the events
+  of the thread in user space are counted. On other platforms, or when
+  the kernel does not allow the events to be opened (see
+  /proc/sys/kernel/perf_event_paranoid), the counters are unavailable.
+*/
+
+/** Values of the hardware counters of a thread. */
+struct my_perf_counters
+{
+  /** CPU cycles. */
+  ulonglong cycles;
+  /** Retired instructions. */
+  ulonglong instructions;
+  /** Misses of the last level cache. */
+  ulonglong llc_misses;
+  /** Mispredicted branches. */
+  ulonglong branch_misses;
+  /**
+    Id of the thread (st_my_thread_var::id) the values were read in.
+    Values read in different threads can not be subtracted.
+  */
+  ulong thread_id;
+};
+
+typedef struct my_perf_counters MY_PERF_COUNTERS;
+
+C_MODE_START
+
+/**
+  Whether the counters are read, the --hardware-counters option.
+  my_perf_counters_read() does nothing when FALSE.
+*/
+extern my_bool my_perf_counters_enabled;
+
+/**
+  Read the hardware counters of the current thread.
+  @param[out] values  the counter values
+  @return FALSE on success, TRUE if the counters are disabled or
+    unavailable
+*/
+my_bool my_perf_counters_read(MY_PERF_COUNTERS *values);
+
+/**
+  Subtract the values read at the start of an interval from the values
+  read at its end.
+  @param[in,out] end  the values at the end, replaced by the differences
+  @param start        the values at the start
+  @return FALSE on success, TRUE if the values were read in different
+    threads
+*/
+my_bool my_perf_counters_diff(MY_PERF_COUNTERS *end,
+                              const MY_PERF_COUNTERS *start);
+
+C_MODE_END
+
+#endif /* MY_PERF_COUNTERS_INCLUDED */
@@ -627,6 +627,8 @@ struct st_my_thread_var
   struct st_my_thread_var *next,**prev;
   void *opt_info;
   void  *stack_ends_here;
+  /** Hardware counters of the thread, see my_perf_counters_read() */
+  void *perf_counters;
 #ifndef DBUG_OFF
   void *dbug;
   char name[THREAD_NAME_SIZE+1];
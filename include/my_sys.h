@@ -208,11 +208,11 @@ extern void (*debug_sync_C_callback_ptr)(const char *, size_t);
 #ifdef HAVE_LARGE_PAGES
 extern uint my_get_large_page_size(void);
 extern uchar * my_large_malloc(PSI_memory_key key, size_t size, myf my_flags);
-extern void my_large_free(uchar *ptr);
+extern void my_large_free(uchar *ptr, size_t size);
 #else
 #define my_get_large_page_size() (0)
 #define my_large_malloc(A,B,C) my_malloc((A),(B),(C))
-#define my_large_free(A) my_free((A))
+#define my_large_free(A,B) my_free((A))
 #endif /* HAVE_LARGE_PAGES */
 
 #if defined(__GNUC__) && !defined(HAVE_ALLOCA_H) && ! defined(alloca)
@@ -469,6 +469,12 @@ typedef struct st_io_cache		/* Used when cacheing files */
   size_t	buffer_length;
   /* read_length is the same as buffer_length except when we use async io */
   size_t  read_length;
+  /*
+    A WRITE_CACHE of open_cached_file() which has not created its file yet
+    grows its buffer up to max_buffer_length bytes before spilling to the
+    file. 0 (the default) spills as soon as the initial buffer is full.
+  */
+  size_t  max_buffer_length;
   myf	myflags;			/* Flags used to my_read/my_write */
   /*
     alloced_buffer is 1 if the buffer was allocated by init_io_cache() and
@@ -477,6 +483,12 @@ typedef struct st_io_cache		/* Used when cacheing files */
     somewhere else
   */
   my_bool alloced_buffer;
+  /*
+    os_cache_advice is 1 for temporary files (see open_cached_file()):
+    _my_b_read() then asks the OS to read the next buffer ahead and to
+    drop the pages it has already copied into the cache.
+  */
+  my_bool os_cache_advice;
   /* Store the transaction's commit sequence number when the IO cache is used
      to store transaction to be flushed to binary log. */
   int64 commit_seq_no;
@@ -744,6 +756,7 @@ extern my_bool reinit_io_cache(IO_CACHE *info,enum cache_type type,
 			       my_off_t seek_offset,pbool use_async_io,
 			       pbool clear_cache);
 extern void setup_io_cache(IO_CACHE* info);
+extern void shrink_io_cache(IO_CACHE *info, size_t cachesize);
 extern int _my_b_read(IO_CACHE *info,uchar *Buffer,size_t Count);
 extern int _my_b_read_r(IO_CACHE *info,uchar *Buffer,size_t Count);
 extern void init_io_cache_share(IO_CACHE *read_cache, IO_CACHE_SHARE *cshare,
@@ -824,6 +837,7 @@ extern void init_alloc_root(PSI_memory_key key,
 extern void *alloc_root(MEM_ROOT *mem_root, size_t Size);
 extern void *multi_alloc_root(MEM_ROOT *mem_root, ...);
 extern void free_root(MEM_ROOT *root, myf MyFLAGS);
+extern void recycle_root(MEM_ROOT *root, size_t *peak, size_t max_keep);
 extern void set_prealloc_root(MEM_ROOT *root, char *ptr);
 extern void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
                                 size_t prealloc_size);
@@ -838,6 +852,16 @@ extern my_bool my_compress(uchar *, size_t *, size_t *);
 extern my_bool my_uncompress(uchar *, size_t , size_t *);
 extern uchar *my_compress_alloc(const uchar *packet, size_t *len,
                                 size_t *complen);
+typedef struct st_my_compress_stream MY_COMPRESS_STREAM;
+extern MY_COMPRESS_STREAM *my_compress_stream_init(uint level);
+extern void my_compress_stream_end(MY_COMPRESS_STREAM *stream);
+extern size_t my_compress_stream_bound(size_t len);
+extern my_bool my_compress_stream(MY_COMPRESS_STREAM *stream,
+                                  const uchar *packet, size_t len,
+                                  uchar *to, size_t *complen);
+extern my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream,
+                                    uchar *packet, size_t len,
+                                    size_t *complen);
 extern int packfrm(uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
@@ -155,7 +155,10 @@ enum mysql_option
   MYSQL_OPT_CONNECT_ATTR_DELETE,
   MYSQL_SERVER_PUBLIC_KEY,
   MYSQL_ENABLE_CLEARTEXT_PLUGIN,
-  MYSQL_OPT_CAN_HANDLE_EXPIRED_PASSWORDS
+  MYSQL_OPT_CAN_HANDLE_EXPIRED_PASSWORDS,
+  MYSQL_OPT_COMPRESSION_LEVEL,
+  MYSQL_OPT_SSL_SESSION,
+  MYSQL_OPT_COMPACT_RESULT
 };
 
 /**
@@ -219,6 +222,16 @@ enum mysql_status
   MYSQL_STATUS_STATEMENT_GET_RESULT
 };
 
+/* Return codes of the non-blocking functions */
+enum net_async_status
+{
+  NET_ASYNC_COMPLETE,                   /* The call is done */
+  NET_ASYNC_NOT_READY_READ,             /* Call again when readable */
+  NET_ASYNC_NOT_READY_WRITE,            /* Call again when writable */
+  NET_ASYNC_ERROR,                      /* The call failed */
+  NET_ASYNC_COMPLETE_NO_MORE_RESULTS    /* mysql_next_result() returned -1 */
+};
+
 enum mysql_protocol_type 
 {
   MYSQL_PROTOCOL_DEFAULT, MYSQL_PROTOCOL_TCP, MYSQL_PROTOCOL_SOCKET,
@@ -383,6 +396,8 @@ my_bool		STDCALL mysql_ssl_set(MYSQL *mysql, const char *key,
 				      const char *cert, const char *ca,
 				      const char *capath, const char *cipher);
 const char *    STDCALL mysql_get_ssl_cipher(MYSQL *mysql);
+void *          STDCALL mysql_get_ssl_session(MYSQL *mysql);
+void            STDCALL mysql_free_ssl_session(void *session);
 my_bool		STDCALL mysql_change_user(MYSQL *mysql, const char *user, 
 					  const char *passwd, const char *db);
 MYSQL *		STDCALL mysql_real_connect(MYSQL *mysql, const char *host,
@@ -456,6 +471,9 @@ MYSQL_FIELD_OFFSET STDCALL mysql_field_seek(MYSQL_RES *result,
 					   MYSQL_FIELD_OFFSET offset);
 MYSQL_ROW	STDCALL mysql_fetch_row(MYSQL_RES *result);
 unsigned long * STDCALL mysql_fetch_lengths(MYSQL_RES *result);
+my_bool         STDCALL mysql_fetch_row_view(MYSQL_RES *result,
+                                             const char **values,
+                                             unsigned long *lengths);
 MYSQL_FIELD *	STDCALL mysql_fetch_field(MYSQL_RES *result);
 MYSQL_RES *     STDCALL mysql_list_fields(MYSQL *mysql, const char *table,
 					  const char *wild);
@@ -697,6 +715,39 @@ int STDCALL mysql_next_result(MYSQL *mysql);
 int STDCALL mysql_stmt_next_result(MYSQL_STMT *stmt);
 void STDCALL mysql_close(MYSQL *sock);
 
+/*
+  Non-blocking variants of mysql_real_query(), mysql_next_result() and
+  mysql_fetch_row(). When one of them would have to wait for the server,
+  it returns NET_ASYNC_NOT_READY_READ or NET_ASYNC_NOT_READY_WRITE, and it
+  is to be called again, with the same arguments and no other call on the
+  connection in between, once the socket of mysql_get_socket_descriptor()
+  is readable or writable. Connections using compression, named pipes or
+  shared memory block like the usual functions do.
+*/
+enum net_async_status STDCALL
+mysql_real_query_nonblocking(MYSQL *mysql, const char *query,
+                             unsigned long length);
+enum net_async_status STDCALL mysql_next_result_nonblocking(MYSQL *mysql);
+enum net_async_status STDCALL mysql_fetch_row_nonblocking(MYSQL_RES *res,
+                                                          MYSQL_ROW *row);
+my_socket STDCALL mysql_get_socket_descriptor(MYSQL *mysql);
+
+/*
+  Pipelined queries. mysql_pipeline_query() queues a query without
+  waiting for the results of the queries queued before it, and
+  mysql_pipeline_read_result() sends the queued queries and reads the
+  result of the oldest one, to be fetched like after mysql_real_query().
+  No other command can be sent until all the results are read. The
+  server does not read the next query until the result of the previous
+  one is sent, so queueing many queries with large results can fill up
+  the socket buffers in both directions and make the connection hang.
+*/
+int STDCALL mysql_pipeline_query(MYSQL *mysql, const char *query,
+                                 unsigned long length);
+int STDCALL mysql_pipeline_flush(MYSQL *mysql);
+my_bool STDCALL mysql_pipeline_read_result(MYSQL *mysql);
+unsigned int STDCALL mysql_pipeline_pending(MYSQL *mysql);
+
 
 /* status return codes */
 #define MYSQL_NO_DATA        100
@@ -32,7 +32,7 @@ typedef struct st_net {
   my_bool unused2;
   my_bool compress;
   my_bool unused3;
-  unsigned char *unused;
+  void *compress_stream;
   unsigned int last_errno;
   unsigned char error;
   my_bool unused4;
@@ -89,6 +89,7 @@ enum enum_mysql_set_option
 my_bool my_net_init(NET *net, Vio* vio);
 void my_net_local_init(NET *net);
 void net_end(NET *net);
+my_bool net_compress_stream_init(NET *net, unsigned int level);
 void net_clear(NET *net, my_bool check_buffer);
 my_bool net_realloc(NET *net, size_t length);
 my_bool net_flush(NET *net);
@@ -96,6 +97,9 @@ my_bool my_net_write(NET *net,const unsigned char *packet, size_t len);
 my_bool net_write_command(NET *net,unsigned char command,
      const unsigned char *header, size_t head_len,
      const unsigned char *packet, size_t len);
+my_bool net_queue_command(NET *net, unsigned char command,
+                          const unsigned char *header, size_t head_len,
+                          const unsigned char *packet, size_t len);
 my_bool net_write_packet(NET *net, const unsigned char *packet, size_t length);
 unsigned long my_net_read(NET *net);
 struct rand_struct {
@@ -276,7 +280,10 @@ enum mysql_option
   MYSQL_OPT_CONNECT_ATTR_DELETE,
   MYSQL_SERVER_PUBLIC_KEY,
   MYSQL_ENABLE_CLEARTEXT_PLUGIN,
-  MYSQL_OPT_CAN_HANDLE_EXPIRED_PASSWORDS
+  MYSQL_OPT_CAN_HANDLE_EXPIRED_PASSWORDS,
+  MYSQL_OPT_COMPRESSION_LEVEL,
+  MYSQL_OPT_SSL_SESSION,
+  MYSQL_OPT_COMPACT_RESULT
 };
 struct st_mysql_options_extention;
 struct st_mysql_options {
@@ -318,6 +325,14 @@ enum mysql_status
   MYSQL_STATUS_READY, MYSQL_STATUS_GET_RESULT, MYSQL_STATUS_USE_RESULT,
   MYSQL_STATUS_STATEMENT_GET_RESULT
 };
+enum net_async_status
+{
+  NET_ASYNC_COMPLETE,
+  NET_ASYNC_NOT_READY_READ,
+  NET_ASYNC_NOT_READY_WRITE,
+  NET_ASYNC_ERROR,
+  NET_ASYNC_COMPLETE_NO_MORE_RESULTS
+};
 enum mysql_protocol_type
 {
   MYSQL_PROTOCOL_DEFAULT, MYSQL_PROTOCOL_TCP, MYSQL_PROTOCOL_SOCKET,
@@ -422,6 +437,8 @@ my_bool mysql_ssl_set(MYSQL *mysql, const char *key,
           const char *cert, const char *ca,
           const char *capath, const char *cipher);
 const char * mysql_get_ssl_cipher(MYSQL *mysql);
+void * mysql_get_ssl_session(MYSQL *mysql);
+void mysql_free_ssl_session(void *session);
 my_bool mysql_change_user(MYSQL *mysql, const char *user,
        const char *passwd, const char *db);
 MYSQL * mysql_real_connect(MYSQL *mysql, const char *host,
@@ -487,6 +504,9 @@ MYSQL_FIELD_OFFSET mysql_field_seek(MYSQL_RES *result,
         MYSQL_FIELD_OFFSET offset);
 MYSQL_ROW mysql_fetch_row(MYSQL_RES *result);
 unsigned long * mysql_fetch_lengths(MYSQL_RES *result);
+my_bool mysql_fetch_row_view(MYSQL_RES *result,
+                                             const char **values,
+                                             unsigned long *lengths);
 MYSQL_FIELD * mysql_fetch_field(MYSQL_RES *result);
 MYSQL_RES * mysql_list_fields(MYSQL *mysql, const char *table,
        const char *wild);
@@ -614,3 +634,15 @@ my_bool mysql_more_results(MYSQL *mysql);
 int mysql_next_result(MYSQL *mysql);
 int mysql_stmt_next_result(MYSQL_STMT *stmt);
 void mysql_close(MYSQL *sock);
+enum net_async_status
+mysql_real_query_nonblocking(MYSQL *mysql, const char *query,
+                             unsigned long length);
+enum net_async_status mysql_next_result_nonblocking(MYSQL *mysql);
+enum net_async_status mysql_fetch_row_nonblocking(MYSQL_RES *res,
+                                                          MYSQL_ROW *row);
+my_socket mysql_get_socket_descriptor(MYSQL *mysql);
+int mysql_pipeline_query(MYSQL *mysql, const char *query,
+                                 unsigned long length);
+int mysql_pipeline_flush(MYSQL *mysql);
+my_bool mysql_pipeline_read_result(MYSQL *mysql);
+unsigned int mysql_pipeline_pending(MYSQL *mysql);
@@ -1070,6 +1070,8 @@ struct PSI_statement_locker_state_v1
   ulong m_sort_rows;
   /** Metric, number of sort scans. */
   ulong m_sort_scan;
+  /** CPU samples of the thread, when the statement started. */
+  ulong m_cpu_samples_start;
   /** Statement digest. */
   PSI_digest_locker_state m_digest_state;
   /** Current schema name. */
@@ -318,6 +318,7 @@ struct PSI_statement_locker_state_v1
   ulong m_sort_range;
   ulong m_sort_rows;
   ulong m_sort_scan;
+  ulong m_cpu_samples_start;
   PSI_digest_locker_state m_digest_state;
   char m_schema_name[(64 * 3)];
   uint m_schema_name_length;
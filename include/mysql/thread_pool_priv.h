@@ -36,9 +36,7 @@
 #include <debug_sync.h>
 #include <sql_profile.h>
 #include <table.h>
-#include <set>
-
-typedef std::set<THD*>::iterator Thread_iterator;
+#include <global_threads.h>
 
 /* create thd from channel_info object */
 THD* create_thd(Channel_info* channel_info);
@@ -71,9 +69,10 @@ ulong  thd_get_net_wait_timeout(THD *thd);
 my_socket thd_get_fd(THD *thd);
 int thd_store_globals(THD* thd);
 
-/* Interface to global thread list iterator functions */
-Thread_iterator thd_get_global_thread_list_begin();
-Thread_iterator thd_get_global_thread_list_end();
+/*
+  The global thread list is visited with do_for_all_thd() and find_thd()
+  of global_threads.h
+*/
 
 /* Print to the MySQL error log */
 void sql_print_error(const char *format, ...);
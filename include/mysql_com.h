@@ -183,11 +183,17 @@ enum enum_server_command
 /* Don't close the connection for a connection with expired password. */
 #define CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS (1UL << 22)
 
+/*
+  Compress with one stream per connection, at a level requested by the
+  client in the authentication response packet.
+*/
+#define CLIENT_COMPRESS_STREAM (1UL << 23)
+
 #define CLIENT_SSL_VERIFY_SERVER_CERT (1UL << 30)
 #define CLIENT_REMEMBER_OPTIONS (1UL << 31)
 
 #ifdef HAVE_COMPRESS
-#define CAN_CLIENT_COMPRESS CLIENT_COMPRESS
+#define CAN_CLIENT_COMPRESS (CLIENT_COMPRESS | CLIENT_COMPRESS_STREAM)
 #else
 #define CAN_CLIENT_COMPRESS 0
 #endif
@@ -218,6 +224,7 @@ enum enum_server_command
                            | CLIENT_CONNECT_ATTRS \
                            | CLIENT_PLUGIN_AUTH_LENENC_CLIENT_DATA \
                            | CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS \
+                           | CLIENT_COMPRESS_STREAM \
 )
 
 /*
@@ -225,8 +232,9 @@ enum enum_server_command
   If any of the optional flags is supported by the build it will be switched
   on before sending to the client during the connection handshake.
 */
-#define CLIENT_BASIC_FLAGS (((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
+#define CLIENT_BASIC_FLAGS ((((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
                                                & ~CLIENT_COMPRESS) \
+                                               & ~CLIENT_COMPRESS_STREAM) \
                                                & ~CLIENT_SSL_VERIFY_SERVER_CERT)
 
 /**
@@ -339,9 +347,9 @@ typedef struct st_net {
     queries in cache that have not stored its results yet
   */
   /*
-    Unused, please remove with the next incompatible ABI change.
+    Compression stream of the connection, see net_compress_stream_init().
   */
-  unsigned char *unused;
+  void *compress_stream;
   unsigned int last_errno;
   unsigned char error; 
   my_bool unused4; /* Please remove with the next incompatible ABI change. */
@@ -479,6 +487,7 @@ extern "C" {
 my_bool	my_net_init(NET *net, Vio* vio);
 void my_net_local_init(NET *net);
 void net_end(NET *net);
+my_bool net_compress_stream_init(NET *net, unsigned int level);
 void net_clear(NET *net, my_bool check_buffer);
 my_bool net_realloc(NET *net, size_t length);
 my_bool	net_flush(NET *net);
@@ -486,6 +495,9 @@ my_bool	my_net_write(NET *net,const unsigned char *packet, size_t len);
 my_bool	net_write_command(NET *net,unsigned char command,
 			  const unsigned char *header, size_t head_len,
 			  const unsigned char *packet, size_t len);
+my_bool net_queue_command(NET *net, unsigned char command,
+                          const unsigned char *header, size_t head_len,
+                          const unsigned char *packet, size_t len);
 my_bool net_write_packet(NET *net, const unsigned char *packet, size_t length);
 unsigned long my_net_read(NET *net);
 
@@ -37,9 +37,14 @@ extern const char	*not_error_sqlstate;
 */
 
 struct st_mysql_trace_info;
+struct st_mysql_async;
+struct st_mysql_pipeline;
 
 struct st_mysql_extension {
   struct st_mysql_trace_info *trace_data;
+  struct st_mysql_async *async_data;  /* State of non-blocking calls */
+  struct st_mysql_pipeline *pipeline_data;  /* Results of pipelined queries */
+  void *ssl_session;           /* SSL_SESSION of the lost connection */
 };
 
 /* "Constructor/destructor" for MYSQL extension structure. */
@@ -67,6 +72,26 @@ struct st_mysql_options_extention {
   char *server_public_key_path;
   size_t connection_attributes_length;
   my_bool enable_cleartext_plugin;
+  uint compression_level;        /* 0 for the default level of the server */
+  void *ssl_session;             /* SSL_SESSION to resume, not owned */
+  my_bool compact_result;        /* mysql_store_result() keeps packets */
+};
+
+/*
+  Rows of a result stored with MYSQL_OPT_COMPACT_RESULT, kept in
+  MYSQL_DATA::extension instead of the MYSQL_DATA::data list.
+  The row packets are copied one after the other into large blocks of
+  MYSQL_DATA::alloc, and rows[] is where each of them starts.
+  A MYSQL_ROW is built only for the row mysql_fetch_row() returns.
+*/
+struct st_mysql_compact_rows {
+  uchar **rows;                 /* Start of each row packet */
+  my_ulonglong capacity;        /* Room of rows[] */
+  my_ulonglong cursor;          /* Next row to fetch */
+  uchar *block_pos, *block_end; /* Free space of the current block */
+  size_t block_size;            /* Size of the next block */
+  ulong max_row_length;         /* Longest row packet */
+  char *row_buffer;             /* Values of the current MYSQL_ROW */
 };
 
 typedef struct st_mysql_methods
@@ -123,6 +148,7 @@ cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
 		     const unsigned char *arg, ulong arg_length,
                      my_bool skip_check, MYSQL_STMT *stmt);
 unsigned long cli_safe_read(MYSQL *mysql);
+enum net_async_status cli_read_query_result_nonblocking(MYSQL *mysql);
 void net_clear_error(NET *net);
 void set_stmt_errmsg(MYSQL_STMT *stmt, NET *net);
 void set_stmt_error(MYSQL_STMT *stmt, int errcode, const char *sqlstate,
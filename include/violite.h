@@ -61,6 +61,14 @@ enum enum_vio_io_event
 #define VIO_BUFFERED_READ 2                     /* use buffered read */
 #define VIO_READ_BUFFER_SIZE 16384              /* size of read buffer */
 #define VIO_DESCRIPTION_SIZE 30                 /* size of description */
+#define VIO_IOVEC_MAX 16                        /* max parts of vio_writev */
+
+/* A part of the data written with vio_writev() */
+struct st_vio_iovec
+{
+  const uchar *base;
+  size_t length;
+};
 
 Vio* vio_new(my_socket sd, enum enum_vio_type type, uint flags);
 Vio*  mysql_socket_vio_new(MYSQL_SOCKET mysql_socket, enum enum_vio_type type, uint flags);
@@ -84,6 +92,8 @@ my_bool vio_reset(Vio* vio, enum enum_vio_type type,
 size_t  vio_read(Vio *vio, uchar *	buf, size_t size);
 size_t  vio_read_buff(Vio *vio, uchar * buf, size_t size);
 size_t  vio_write(Vio *vio, const uchar * buf, size_t size);
+/* Write the parts of a scatter list, in order, with one operation */
+size_t  vio_writev(Vio *vio, const struct st_vio_iovec *iov, uint count);
 /* setsockopt TCP_NODELAY at IPPROTO_TCP level, when possible */
 int vio_fastsend(Vio *vio);
 /* setsockopt SO_KEEPALIVE at SOL_SOCKET level, when possible */
@@ -163,7 +173,8 @@ struct st_VioSSLFd
 };
 
 int sslaccept(struct st_VioSSLFd*, Vio *, long timeout, unsigned long *errptr);
-int sslconnect(struct st_VioSSLFd*, Vio *, long timeout, unsigned long *errptr);
+int sslconnect(struct st_VioSSLFd*, Vio *, long timeout, SSL_SESSION *session,
+               unsigned long *errptr);
 
 struct st_VioSSLFd
 *new_VioSSLConnectorFd(const char *key_file, const char *cert_file,
@@ -174,7 +185,9 @@ struct st_VioSSLFd
 *new_VioSSLAcceptorFd(const char *key_file, const char *cert_file,
                       const char *ca_file,const char *ca_path,
                       const char *cipher, enum enum_ssl_init_error *error,
-                      const char *crl_file, const char *crl_path);
+                      const char *crl_file, const char *crl_path,
+                      long session_cache_size, long session_timeout,
+                      my_bool session_tickets);
 void free_vio_ssl_acceptor_fd(struct st_VioSSLFd *fd);
 #endif /* ! EMBEDDED_LIBRARY */
 #endif /* HAVE_OPENSSL */
@@ -191,6 +204,7 @@ void vio_end(void);
 #define vio_errno(vio)                          (vio)->vioerrno(vio)
 #define vio_read(vio, buf, size)                ((vio)->read)(vio,buf,size)
 #define vio_write(vio, buf, size)               ((vio)->write)(vio, buf, size)
+#define vio_writev(vio, iov, count)             ((vio)->writev)(vio, iov, count)
 #define vio_fastsend(vio)                       (vio)->fastsend(vio)
 #define vio_keepalive(vio, set_keep_alive)  (vio)->viokeepalive(vio, set_keep_alive)
 #define vio_should_retry(vio)                   (vio)->should_retry(vio)
@@ -248,6 +262,7 @@ struct st_vio
   int     (*vioerrno)(Vio*);
   size_t  (*read)(Vio*, uchar *, size_t);
   size_t  (*write)(Vio*, const uchar *, size_t);
+  size_t  (*writev)(Vio*, const struct st_vio_iovec *, uint);
   int     (*timeout)(Vio*, uint, my_bool);
   int     (*viokeepalive)(Vio*, my_bool);
   int     (*fastsend)(Vio*);
@@ -711,6 +711,13 @@ mysql_data_seek(MYSQL_RES *result, my_ulonglong row)
 {
   MYSQL_ROWS	*tmp=0;
   DBUG_PRINT("info",("mysql_data_seek(%ld)",(long) row));
+  if (result->data && result->data->extension)
+  {
+    struct st_mysql_compact_rows *compact= result->data->extension;
+    compact->cursor= MY_MIN(row, result->data->rows);
+    result->current_row=0;
+    return;
+  }
   if (result->data)
     for (tmp=result->data->data; row-- && tmp ; tmp = tmp->next) ;
   result->current_row=0;
@@ -722,6 +729,8 @@ mysql_data_seek(MYSQL_RES *result, my_ulonglong row)
   put the row or field cursor one a position one got from mysql_row_tell()
   This doesn't restore any data. The next mysql_fetch_row or
   mysql_fetch_field will return the next row or field after the last used
+  For MYSQL_OPT_COMPACT_RESULT results the offset points to the entry of
+  the row in st_mysql_compact_rows::rows.
 *************************************************************************/
 
 MYSQL_ROW_OFFSET STDCALL
@@ -729,6 +738,13 @@ mysql_row_seek(MYSQL_RES *result, MYSQL_ROW_OFFSET row)
 {
   MYSQL_ROW_OFFSET return_value=result->data_cursor;
   result->current_row= 0;
+  if (result->data && result->data->extension)
+  {
+    struct st_mysql_compact_rows *compact= result->data->extension;
+    return_value= mysql_row_tell(result);
+    compact->cursor= (uchar**) row - compact->rows;
+    return return_value;
+  }
   result->data_cursor= row;
   return return_value;
 }
@@ -1006,6 +1022,11 @@ MYSQL_FIELD * STDCALL mysql_fetch_fields(MYSQL_RES *res)
 
 MYSQL_ROW_OFFSET STDCALL mysql_row_tell(MYSQL_RES *res)
 {
+  if (res->data && res->data->extension)
+  {
+    struct st_mysql_compact_rows *compact= res->data->extension;
+    return (MYSQL_ROW_OFFSET) (compact->rows + compact->cursor);
+  }
   return res->data_cursor;
 }
 
@@ -4874,6 +4895,32 @@ int STDCALL mysql_next_result(MYSQL *mysql)
 }
 
 
+enum net_async_status STDCALL mysql_next_result_nonblocking(MYSQL *mysql)
+{
+  DBUG_ENTER("mysql_next_result_nonblocking");
+
+  MYSQL_TRACE_STAGE(mysql, WAIT_FOR_RESULT);
+
+  if (mysql->status != MYSQL_STATUS_READY)
+  {
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    DBUG_RETURN(NET_ASYNC_ERROR);
+  }
+
+  net_clear_error(&mysql->net);
+  mysql->affected_rows= ~(my_ulonglong) 0;
+
+  if (mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+    DBUG_RETURN(cli_read_query_result_nonblocking(mysql));
+  else
+  {
+    MYSQL_TRACE_STAGE(mysql, READY_FOR_COMMAND);
+  }
+
+  DBUG_RETURN(NET_ASYNC_COMPLETE_NO_MORE_RESULTS);
+}
+
+
 int STDCALL mysql_stmt_next_result(MYSQL_STMT *stmt)
 {
   MYSQL *mysql= stmt->mysql;
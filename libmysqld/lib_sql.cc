@@ -425,9 +425,7 @@ static void emb_free_embedded_thd(MYSQL *mysql)
   thd->store_globals();
   thd->release_resources();
 
-  mysql_mutex_lock(&LOCK_thread_count);
   remove_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   delete thd;
   my_pthread_setspecific_ptr(THR_THD,  0);
@@ -738,9 +736,7 @@ void *create_embedded_thd(int client_flag)
   thd->data_tail= &thd->first_data;
   memset(&thd->net, 0, sizeof(thd->net));
 
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
   thd->mysys_var= 0;
   return thd;
 err:
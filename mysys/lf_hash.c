@@ -65,16 +65,23 @@ typedef struct {
     Search for hashnr/key/keylen in the list starting from 'head' and
     position the cursor. The list is ORDER BY hashnr, key
 
+    If 'callback' is not NULL, the search key is ignored: the callback is
+    called for every live normal element of the list (with the element
+    and 'callback_arg'), until it returns non-zero or the list ends.
+
   RETURN
-    0 - not found
-    1 - found
+    0 - not found (or callback never returned non-zero)
+    1 - found (or callback returned non-zero)
 
   NOTE
     cursor is positioned in either case
     pins[0..2] are used, they are NOT removed on return
+    callback can see the same element more than once, if the list is
+    modified concurrently and the scan has to restart
 */
 static int lfind(LF_SLIST * volatile *head, CHARSET_INFO *cs, uint32 hashnr,
-                 const uchar *key, uint keylen, CURSOR *cursor, LF_PINS *pins)
+                 const uchar *key, uint keylen, CURSOR *cursor, LF_PINS *pins,
+                 lf_hash_walk_func *callback, void *callback_arg)
 {
   uint32       cur_hashnr;
   const uchar  *cur_key;
@@ -107,7 +114,13 @@ retry:
     }
     if (!DELETED(link))
     {
-      if (cur_hashnr >= hashnr)
+      if (unlikely(callback))
+      {
+        /* normal nodes have the lowest bit set, dummy nodes don't */
+        if ((cur_hashnr & 1) && callback(cursor->curr + 1, callback_arg))
+          return 1;
+      }
+      else if (cur_hashnr >= hashnr)
       {
         int r= 1;
         if (cur_hashnr > hashnr ||
@@ -160,7 +173,7 @@ static LF_SLIST *linsert(LF_SLIST * volatile *head, CHARSET_INFO *cs,
   for (;;)
   {
     if (lfind(head, cs, node->hashnr, node->key, node->keylen,
-              &cursor, pins) &&
+              &cursor, pins, NULL, NULL) &&
         (flags & LF_HASH_UNIQUE))
     {
       res= 0; /* duplicate found */
@@ -210,7 +223,7 @@ static int ldelete(LF_SLIST * volatile *head, CHARSET_INFO *cs, uint32 hashnr,
 
   for (;;)
   {
-    if (!lfind(head, cs, hashnr, key, keylen, &cursor, pins))
+    if (!lfind(head, cs, hashnr, key, keylen, &cursor, pins, NULL, NULL))
     {
       res= 1; /* not found */
       break;
@@ -234,7 +247,7 @@ static int ldelete(LF_SLIST * volatile *head, CHARSET_INFO *cs, uint32 hashnr,
             (to ensure the number of "set DELETED flag" actions
             is equal to the number of "remove from the list" actions)
           */
-          lfind(head, cs, hashnr, key, keylen, &cursor, pins);
+          lfind(head, cs, hashnr, key, keylen, &cursor, pins, NULL, NULL);
         }
         res= 0;
         break;
@@ -265,7 +278,7 @@ static LF_SLIST *lsearch(LF_SLIST * volatile *head, CHARSET_INFO *cs,
                          LF_PINS *pins)
 {
   CURSOR cursor;
-  int res= lfind(head, cs, hashnr, key, keylen, &cursor, pins);
+  int res= lfind(head, cs, hashnr, key, keylen, &cursor, pins, NULL, NULL);
   if (res)
     _lf_pin(pins, 2, cursor.curr);
   _lf_unpin(pins, 0);
@@ -466,6 +479,45 @@ void *lf_hash_search(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
   return found ? found+1 : 0;
 }
 
+/*
+  DESCRIPTION
+    calls 'action' for every element of the hash, until it returns non-zero
+
+  RETURN
+    0 - all elements were visited
+    1 - action returned non-zero
+   -1 - out of memory
+
+  NOTE
+    The element passed to 'action' is pinned for the duration of the call,
+    so it is safe to read even if another thread deletes it concurrently.
+    The walk is not a snapshot: elements inserted or deleted meanwhile may
+    or may not be seen, and an element may be seen twice if the walk has to
+    restart after a concurrent modification.
+    All pins are removed on return.
+*/
+int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins,
+                    lf_hash_walk_func *action, void *argument)
+{
+  CURSOR cursor;
+  int res;
+  LF_SLIST * volatile *el;
+
+  lf_rwlock_by_pins(pins);
+  el= _lf_dynarray_lvalue(&hash->array, 0);
+  if (unlikely(!el))
+    return -1;
+  /* bucket 0 is the head of the whole list, sorted by reversed hashnr */
+  if (*el == NULL && unlikely(initialize_bucket(hash, el, 0, pins)))
+    return -1;
+  res= lfind(el, 0, 0, 0, 0, &cursor, pins, action, argument);
+  _lf_unpin(pins, 2);
+  _lf_unpin(pins, 1);
+  _lf_unpin(pins, 0);
+  lf_rwunlock_by_pins(pins);
+  return res;
+}
+
 static const uchar *dummy_key= (uchar*)"";
 
 /*
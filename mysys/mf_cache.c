@@ -57,6 +57,7 @@ my_bool open_cached_file(IO_CACHE *cache, const char* dir, const char *prefix,
   if (!init_io_cache(cache,-1,cache_size,WRITE_CACHE,0L,0,
 		     MYF(cache_myflags | MY_NABP)))
   {
+    cache->os_cache_advice= 1;
     DBUG_RETURN(0);
   }
   my_free(cache->dir);
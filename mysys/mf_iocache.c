@@ -155,6 +155,8 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
   info->pre_close = info->pre_read = info->post_read = 0;
   info->arg = 0;
   info->alloced_buffer = 0;
+  info->os_cache_advice= 0;
+  info->max_buffer_length= 0;
   info->buffer=0;
   info->seek_not_done= 0;
 
@@ -362,6 +364,106 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
 } /* reinit_io_cache */
 
 
+/*
+  Give back the memory a temporary write cache has grown into
+
+  SYNOPSIS
+    shrink_io_cache()
+    info		IO_CACHE handle
+    cachesize		Buffer size to return to, as given to init_io_cache()
+
+  NOTES
+    The cache must be an empty WRITE_CACHE positioned at the start of the
+    file, e.g. right after reinit_io_cache(info, WRITE_CACHE, 0, 0, 0).
+    Nothing is done if the buffer has not grown beyond cachesize or if
+    the smaller buffer cannot be allocated.
+*/
+
+void shrink_io_cache(IO_CACHE *info, size_t cachesize)
+{
+  uchar *buffer;
+  DBUG_ENTER("shrink_io_cache");
+  DBUG_ASSERT(info->type == WRITE_CACHE && my_b_tell(info) == 0);
+
+  cachesize= (cachesize + IO_SIZE*2-1) & ~(IO_SIZE*2-1);
+  if (!info->alloced_buffer || info->pos_in_file != 0 ||
+      info->buffer_length <= cachesize)
+    DBUG_VOID_RETURN;
+  if (!(buffer= (uchar*) my_realloc(key_memory_IO_CACHE, info->buffer,
+                                    cachesize, MYF(0))))
+    DBUG_VOID_RETURN;
+
+  info->read_length= info->buffer_length= cachesize;
+  info->buffer= info->write_buffer= info->request_pos= buffer;
+  info->read_pos= info->read_end= info->write_pos= buffer;
+  info->write_end= buffer + cachesize;
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Grow the buffer of a temporary write cache so that the data written so
+  far and Count more bytes stay in memory.
+
+  RETURN
+    0  The buffer has room for Count more bytes
+    1  The cache has a file already, may not grow that much or the bigger
+       buffer cannot be allocated; the caller spills to the file
+*/
+
+static int grow_write_buffer(IO_CACHE *info, size_t Count)
+{
+  size_t used= (size_t) (info->write_pos - info->write_buffer);
+  size_t max_length= info->max_buffer_length;
+  size_t length= info->buffer_length;
+  uchar *buffer;
+
+  if (info->file != -1 || info->type != WRITE_CACHE ||
+      !info->alloced_buffer || info->pos_in_file != 0)
+    return 1;
+  if (info->end_of_file < (my_off_t) max_length)
+    max_length= (size_t) info->end_of_file;
+  if (used > max_length || Count > max_length - used)
+    return 1;
+
+  while (length < used + Count)
+    length= length > max_length / 2 ? max_length : length * 2;
+  if (!(buffer= (uchar*) my_realloc(key_memory_IO_CACHE, info->buffer,
+                                    length, MYF(0))))
+    return 1;
+
+  info->read_length= info->buffer_length= length;
+  info->buffer= info->write_buffer= info->request_pos= buffer;
+  info->read_pos= info->read_end= buffer;
+  info->write_pos= buffer + used;
+  info->write_end= buffer + length;
+  return 0;
+}
+
+
+
+/*
+  Tell the OS about the sequential read pattern of a temporary file.
+
+  The range [pos, pos+length) has just been copied to the caller or the
+  cache, and temporary files are read once per pass, so those pages only
+  evict more useful data from the OS cache. The next read_length bytes
+  will be wanted next, so start reading them while the caller works on
+  this buffer.
+*/
+
+static void advise_read(IO_CACHE *info, my_off_t pos, size_t length)
+{
+#if defined(POSIX_FADV_WILLNEED) && !defined(_WIN32)
+  if (!info->os_cache_advice || !length)
+    return;
+  (void) posix_fadvise(info->file, pos, length, POSIX_FADV_DONTNEED);
+  if (pos + length < info->end_of_file)
+    (void) posix_fadvise(info->file, pos + length, info->read_length,
+                         POSIX_FADV_WILLNEED);
+#endif
+}
+
 
 /*
   Read buffered.
@@ -474,6 +576,7 @@ int _my_b_read(IO_CACHE *info, uchar *Buffer, size_t Count)
 		    (int) (read_length+left_length));
       DBUG_RETURN(1);
     }
+    advise_read(info, pos_in_file, length);
     Count-=length;
     Buffer+=length;
     pos_in_file+=length;
@@ -527,6 +630,7 @@ int _my_b_read(IO_CACHE *info, uchar *Buffer, size_t Count)
     length is the amount of data in the cache.
     Read Count bytes from the cache.
   */
+  advise_read(info, pos_in_file, length);
   info->read_pos=info->buffer+Count;
   info->read_end=info->buffer+length;
   info->pos_in_file=pos_in_file;
@@ -1294,6 +1398,13 @@ int _my_b_write(IO_CACHE *info, const uchar *Buffer, size_t Count)
     return info->error = -1;
   }
 
+  if (info->max_buffer_length && !grow_write_buffer(info, Count))
+  {
+    memcpy(info->write_pos, Buffer, Count);
+    info->write_pos+= Count;
+    return 0;
+  }
+
   rest_length= (size_t) (info->write_end - info->write_pos);
   memcpy(info->write_pos,Buffer,(size_t) rest_length);
   Buffer+=rest_length;
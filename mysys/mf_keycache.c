@@ -226,6 +226,12 @@ KEY_CACHE *dflt_key_cache= &dflt_key_cache_var;
 
 static int flush_all_key_blocks(KEY_CACHE *keycache);
 
+static void simple_change_key_cache_param(KEY_CACHE *keycache,
+                                          uint division_limit,
+                                          uint age_threshold);
+
+static void simple_end_key_cache(KEY_CACHE *keycache, my_bool cleanup);
+
 static void wait_on_queue(KEYCACHE_WQUEUE *wqueue,
                           mysql_mutex_t *mutex);
 static void release_whole_queue(KEYCACHE_WQUEUE *wqueue);
@@ -342,7 +348,7 @@ static inline uint next_power(uint value)
   Initialize a key cache
 
   SYNOPSIS
-    init_key_cache()
+    simple_init_key_cache()
     keycache			pointer to a key cache data structure
     key_cache_block_size	size of blocks to keep cached data
     use_mem                 	total memory to use for the key cache
@@ -363,14 +369,14 @@ static inline uint next_power(uint value)
 
 */
 
-int init_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
-                   size_t use_mem, uint division_limit,
+static int simple_init_key_cache(KEY_CACHE *keycache,
+                                 uint key_cache_block_size, size_t use_mem, uint division_limit,
                    uint age_threshold)
 {
   ulong blocks, hash_links;
   size_t length;
   int error;
-  DBUG_ENTER("init_key_cache");
+  DBUG_ENTER("simple_init_key_cache");
   DBUG_ASSERT(key_cache_block_size >= 512);
 
   KEYCACHE_DEBUG_OPEN;
@@ -427,9 +433,10 @@ int init_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
 	     ((size_t) blocks * keycache->key_cache_block_size) > use_mem)
         blocks--;
       /* Allocate memory for cache page buffers */
+      keycache->block_mem_size= (size_t) blocks *
+                                keycache->key_cache_block_size;
       if ((keycache->block_mem=
-	   my_large_malloc(key_memory_KEY_CACHE,
-                           (size_t) blocks * keycache->key_cache_block_size,
+	   my_large_malloc(key_memory_KEY_CACHE, keycache->block_mem_size,
 			  MYF(0))))
       {
         /*
@@ -440,7 +447,7 @@ int init_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
                                                            length,
                                                            MYF(0))))
           break;
-        my_large_free(keycache->block_mem);
+        my_large_free(keycache->block_mem, keycache->block_mem_size);
         keycache->block_mem= 0;
       }
       if (blocks < 8)
@@ -516,7 +523,7 @@ err:
   keycache->blocks=  0;
   if (keycache->block_mem)
   {
-    my_large_free((uchar*) keycache->block_mem);
+    my_large_free((uchar*) keycache->block_mem, keycache->block_mem_size);
     keycache->block_mem= NULL;
   }
   if (keycache->block_root)
@@ -534,7 +541,7 @@ err:
   Resize a key cache
 
   SYNOPSIS
-    resize_key_cache()
+    simple_resize_key_cache()
     keycache     	        pointer to a key cache data structure
     key_cache_block_size        size of blocks to keep cached data
     use_mem			total memory to use for the new key cache
@@ -550,21 +557,21 @@ err:
     with the key cache values.
 
     If they differ the function free the the memory allocated for the
-    old key cache blocks by calling the end_key_cache function and
-    then rebuilds the key cache with new blocks by calling
-    init_key_cache.
+    old key cache blocks by calling the simple_end_key_cache function
+    and then rebuilds the key cache with new blocks by calling
+    simple_init_key_cache.
 
     The function starts the operation only when all other threads
     performing operations with the key cache let her to proceed
     (when cnt_for_resize=0).
 */
 
-int resize_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
-                     size_t use_mem, uint division_limit,
+static int simple_resize_key_cache(KEY_CACHE *keycache,
+                                   uint key_cache_block_size, size_t use_mem, uint division_limit,
                      uint age_threshold)
 {
   int blocks;
-  DBUG_ENTER("resize_key_cache");
+  DBUG_ENTER("simple_resize_key_cache");
 
   if (!keycache->key_cache_inited)
     DBUG_RETURN(keycache->disk_blocks);
@@ -572,7 +579,7 @@ int resize_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
   if(key_cache_block_size == keycache->key_cache_block_size &&
      use_mem == keycache->key_cache_mem_size)
   {
-    change_key_cache_param(keycache, division_limit, age_threshold);
+    simple_change_key_cache_param(keycache, division_limit, age_threshold);
     DBUG_RETURN(keycache->disk_blocks);
   }
 
@@ -638,10 +645,10 @@ int resize_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
     untouched. We do not lose the cache_lock and will release it only at
     the end of this function.
   */
-  end_key_cache(keycache, 0);			/* Don't free mutex */
+  simple_end_key_cache(keycache, 0);		/* Don't free mutex */
   /* The following will work even if use_mem is 0 */
-  blocks= init_key_cache(keycache, key_cache_block_size, use_mem,
-			 division_limit, age_threshold);
+  blocks= simple_init_key_cache(keycache, key_cache_block_size, use_mem,
+				division_limit, age_threshold);
 
 finish:
   /*
@@ -681,7 +688,7 @@ static inline void dec_counter_for_resize_op(KEY_CACHE *keycache)
   Change the key cache parameters
 
   SYNOPSIS
-    change_key_cache_param()
+    simple_change_key_cache_param()
     keycache			pointer to a key cache data structure
     division_limit		new division limit (if not zero)
     age_threshold		new age threshold (if not zero)
@@ -695,10 +702,11 @@ static inline void dec_counter_for_resize_op(KEY_CACHE *keycache)
     age_threshold.
 */
 
-void change_key_cache_param(KEY_CACHE *keycache, uint division_limit,
-			    uint age_threshold)
+static void simple_change_key_cache_param(KEY_CACHE *keycache,
+                                          uint division_limit,
+                                          uint age_threshold)
 {
-  DBUG_ENTER("change_key_cache_param");
+  DBUG_ENTER("simple_change_key_cache_param");
 
   keycache_pthread_mutex_lock(&keycache->cache_lock);
   if (division_limit)
@@ -716,7 +724,7 @@ void change_key_cache_param(KEY_CACHE *keycache, uint division_limit,
   Remove key_cache from memory
 
   SYNOPSIS
-    end_key_cache()
+    simple_end_key_cache()
     keycache		key cache handle
     cleanup		Complete free (Free also mutex for key cache)
 
@@ -724,9 +732,9 @@ void change_key_cache_param(KEY_CACHE *keycache, uint division_limit,
     none
 */
 
-void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
+static void simple_end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
 {
-  DBUG_ENTER("end_key_cache");
+  DBUG_ENTER("simple_end_key_cache");
   DBUG_PRINT("enter", ("key_cache: 0x%lx", (long) keycache));
 
   if (!keycache->key_cache_inited)
@@ -736,7 +744,7 @@ void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
   {
     if (keycache->block_mem)
     {
-      my_large_free((uchar*) keycache->block_mem);
+      my_large_free((uchar*) keycache->block_mem, keycache->block_mem_size);
       keycache->block_mem= NULL;
       my_free(keycache->block_root);
       keycache->block_root= NULL;
@@ -768,7 +776,7 @@ void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
     KEYCACHE_DEBUG_CLOSE;
   }
   DBUG_VOID_RETURN;
-} /* end_key_cache */
+} /* simple_end_key_cache */
 
 
 /*
@@ -2474,7 +2482,7 @@ static void read_block(KEY_CACHE *keycache,
 
   SYNOPSIS
 
-    key_cache_read()
+    simple_key_cache_read()
       keycache            pointer to a key cache data structure
       file                handler for the file for the block of data to be read
       filepos             position of the block of data in the file
@@ -2497,16 +2505,16 @@ static void read_block(KEY_CACHE *keycache,
     have to be a multiple of key_cache_block_size;
 */
 
-uchar *key_cache_read(KEY_CACHE *keycache,
-                      File file, my_off_t filepos, int level,
-                      uchar *buff, uint length,
-                      uint block_length __attribute__((unused)),
-                      int return_buffer __attribute__((unused)))
+static uchar *simple_key_cache_read(KEY_CACHE *keycache,
+                                    File file, my_off_t filepos, int level,
+                                    uchar *buff, uint length,
+                                    uint block_length __attribute__((unused)),
+                                    int return_buffer __attribute__((unused)))
 {
   my_bool locked_and_incremented= FALSE;
   int error=0;
   uchar *start= buff;
-  DBUG_ENTER("key_cache_read");
+  DBUG_ENTER("simple_key_cache_read");
   DBUG_PRINT("enter", ("fd: %u  pos: %lu  length: %u",
                (uint) file, (ulong) filepos, length));
 
@@ -2715,7 +2723,7 @@ end:
   Insert a block of file data from a buffer into key cache
 
   SYNOPSIS
-    key_cache_insert()
+    simple_key_cache_insert()
     keycache            pointer to a key cache data structure
     file                handler for the file to insert data from
     filepos             position of the block of data in the file to insert
@@ -2731,12 +2739,12 @@ end:
     0 if a success, 1 - otherwise.
 */
 
-int key_cache_insert(KEY_CACHE *keycache,
-                     File file, my_off_t filepos, int level,
-                     uchar *buff, uint length)
+static int simple_key_cache_insert(KEY_CACHE *keycache,
+                                   File file, my_off_t filepos, int level,
+                                   uchar *buff, uint length)
 {
   int error= 0;
-  DBUG_ENTER("key_cache_insert");
+  DBUG_ENTER("simple_key_cache_insert");
   DBUG_PRINT("enter", ("fd: %u  pos: %lu  length: %u",
                (uint) file,(ulong) filepos, length));
 
@@ -2954,7 +2962,7 @@ int key_cache_insert(KEY_CACHE *keycache,
 
   SYNOPSIS
 
-    key_cache_write()
+    simple_key_cache_write()
       keycache            pointer to a key cache data structure
       file                handler for the file to write data to
       filepos             position in the file to write data to
@@ -2978,15 +2986,15 @@ int key_cache_insert(KEY_CACHE *keycache,
     dont_write is always TRUE in the server (info->lock_type is never F_UNLCK).
 */
 
-int key_cache_write(KEY_CACHE *keycache,
-                    File file, my_off_t filepos, int level,
-                    uchar *buff, uint length,
-                    uint block_length  __attribute__((unused)),
-                    int dont_write)
+static int simple_key_cache_write(KEY_CACHE *keycache,
+                                  File file, my_off_t filepos, int level,
+                                  uchar *buff, uint length,
+                                  uint block_length  __attribute__((unused)),
+                                  int dont_write)
 {
   my_bool locked_and_incremented= FALSE;
   int error=0;
-  DBUG_ENTER("key_cache_write");
+  DBUG_ENTER("simple_key_cache_write");
   DBUG_PRINT("enter",
              ("fd: %u  pos: %lu  length: %u  block_length: %u"
               "  key_block_length: %u",
@@ -4026,7 +4034,7 @@ err:
 
   SYNOPSIS
 
-    flush_key_blocks()
+    simple_flush_key_blocks()
       keycache            pointer to a key cache data structure
       file                handler for the file to flush to
       flush_type          type of the flush
@@ -4036,11 +4044,11 @@ err:
     1  error
 */
 
-int flush_key_blocks(KEY_CACHE *keycache,
-                     File file, enum flush_type type)
+static int simple_flush_key_blocks(KEY_CACHE *keycache,
+                                   File file, enum flush_type type)
 {
   int res= 0;
-  DBUG_ENTER("flush_key_blocks");
+  DBUG_ENTER("simple_flush_key_blocks");
   DBUG_PRINT("enter", ("keycache: 0x%lx", (long) keycache));
 
   if (!keycache->key_cache_inited)
@@ -4193,6 +4201,437 @@ static int flush_all_key_blocks(KEY_CACHE *keycache)
 }
 
 
+/*
+  Partitioned key caches
+
+  A single cache_lock serializes every access to a key cache, cache hits
+  included. A big key cache is therefore split into up to
+  KEY_CACHE_MAX_PARTITIONS partitions of at least
+  KEY_CACHE_MIN_PARTITION_SIZE each. Every partition is a complete simple
+  key cache with its own lock, hash, LRU chains and statistics.
+
+  A page goes to the partition selected by its file and its position in
+  units of KEY_CACHE_PARTITION_GRANULE, so requests for one page always
+  meet in the same partition. The granule is the largest allowed block
+  size and partitions use power-of-two block sizes only, so a cache
+  block never straddles two partitions, even while a resize changes the
+  block size one partition at a time.
+
+  The number of partitions is chosen when the key cache is initialized
+  and kept until it is ended with cleanup. Resizing resizes every
+  partition to an equal share of the memory.
+*/
+
+#define KEY_CACHE_MAX_PARTITIONS      16
+#define KEY_CACHE_MIN_PARTITION_SIZE  (32*1024*1024)
+#define KEY_CACHE_PARTITION_GRANULE   16384   /* max key_cache_block_size */
+
+static inline KEY_CACHE *key_cache_partition(KEY_CACHE *keycache,
+                                             File file, my_off_t filepos)
+{
+  ulonglong nr= (ulonglong) file * 31 + filepos / KEY_CACHE_PARTITION_GRANULE;
+  return keycache->partition + (uint) (nr & (keycache->partitions - 1));
+}
+
+
+/*
+  Number of partitions for a new key cache of size use_mem
+*/
+
+static uint key_cache_partitions_for(size_t use_mem)
+{
+  uint partitions= 1;
+  while (partitions < KEY_CACHE_MAX_PARTITIONS &&
+         use_mem / (partitions * 2) >= KEY_CACHE_MIN_PARTITION_SIZE)
+    partitions*= 2;
+  return partitions;
+}
+
+
+/*
+  Block size of the partitions of a key cache: the biggest power of two
+  not bigger than the requested size
+*/
+
+static inline uint partition_block_size(uint key_cache_block_size)
+{
+  return my_round_up_to_next_power(key_cache_block_size + 1) / 2;
+}
+
+
+/*
+  Initialize or resize all partitions of a key cache
+
+  RETURN VALUE
+    number of blocks in all partitions, if successful,
+    -1 if the partitions are disabled (too small),
+    0 if some partition failed.
+*/
+
+static int setup_partitions(KEY_CACHE *keycache, my_bool resize,
+                            uint key_cache_block_size, size_t use_mem,
+                            uint division_limit, uint age_threshold)
+{
+  uint block_size= partition_block_size(key_cache_block_size);
+  size_t part_mem= use_mem / keycache->partitions;
+  int blocks= 0, failed= 0;
+  uint i;
+  for (i= 0; i < keycache->partitions; i++)
+  {
+    KEY_CACHE *part= keycache->partition + i;
+    int part_blocks= (resize ?
+                      simple_resize_key_cache(part, block_size, part_mem,
+                                              division_limit, age_threshold) :
+                      simple_init_key_cache(part, block_size, part_mem,
+                                            division_limit, age_threshold));
+    if (!part_blocks)
+      failed= 1;
+    else if (part_blocks > 0)
+      blocks+= part_blocks;
+  }
+  keycache->key_cache_mem_size= use_mem;
+  keycache->key_cache_block_size= key_cache_block_size;
+  keycache->disk_blocks= blocks ? blocks : -1;
+  keycache->blocks= blocks;
+  keycache->can_be_used= !failed && blocks > 0;
+  return failed ? 0 : keycache->disk_blocks;
+}
+
+
+/*
+  Initialize a key cache
+
+  SYNOPSIS
+    init_key_cache()
+    keycache			pointer to a key cache data structure
+    key_cache_block_size	size of blocks to keep cached data
+    use_mem                 	total memory to use for the key cache
+    division_limit		division limit (may be zero)
+    age_threshold		age threshold (may be zero)
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    0 - otherwise.
+
+  NOTES.
+    A new key cache of at least twice KEY_CACHE_MIN_PARTITION_SIZE is
+    split into partitions. If that fails, an unpartitioned key cache is
+    tried. See simple_init_key_cache() for the other notes.
+*/
+
+int init_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
+                   size_t use_mem, uint division_limit,
+                   uint age_threshold)
+{
+  uint partitions;
+  int blocks;
+  DBUG_ENTER("init_key_cache");
+
+  if (keycache->partition)
+  {
+    /* Re-initialization after end_key_cache(keycache, 0) */
+    if (keycache->disk_blocks > 0)
+      DBUG_RETURN(0);
+    DBUG_RETURN(setup_partitions(keycache, 0, key_cache_block_size, use_mem,
+                                 division_limit, age_threshold));
+  }
+
+  if (keycache->key_cache_inited ||
+      (partitions= key_cache_partitions_for(use_mem)) == 1 ||
+      !(keycache->partition= (KEY_CACHE*)
+        my_malloc(key_memory_KEY_CACHE, sizeof(KEY_CACHE) * partitions,
+                  MYF(MY_ZEROFILL))))
+    DBUG_RETURN(simple_init_key_cache(keycache, key_cache_block_size, use_mem,
+                                      division_limit, age_threshold));
+
+  keycache->partitions= partitions;
+  if (!(blocks= setup_partitions(keycache, 0, key_cache_block_size, use_mem,
+                                 division_limit, age_threshold)))
+  {
+    end_key_cache(keycache, 1);
+    DBUG_RETURN(simple_init_key_cache(keycache, key_cache_block_size, use_mem,
+                                      division_limit, age_threshold));
+  }
+  keycache->global_cache_w_requests= keycache->global_cache_r_requests= 0;
+  keycache->global_cache_read= keycache->global_cache_write= 0;
+  keycache->in_init= 0;
+  keycache->key_cache_inited= 1;
+  DBUG_PRINT("exit", ("partitions: %u  disk_blocks: %d",
+                      partitions, keycache->disk_blocks));
+  DBUG_RETURN(blocks);
+}
+
+
+/*
+  Resize a key cache
+
+  SYNOPSIS
+    resize_key_cache()
+    keycache     	        pointer to a key cache data structure
+    key_cache_block_size        size of blocks to keep cached data
+    use_mem			total memory to use for the new key cache
+    division_limit		new division limit (if not zero)
+    age_threshold		new age threshold (if not zero)
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    0 - otherwise.
+
+  NOTES.
+    A partitioned key cache is resized partition by partition, each to
+    an equal share of use_mem. See simple_resize_key_cache().
+*/
+
+int resize_key_cache(KEY_CACHE *keycache, uint key_cache_block_size,
+                     size_t use_mem, uint division_limit,
+                     uint age_threshold)
+{
+  DBUG_ENTER("resize_key_cache");
+  if (!keycache->partition)
+    DBUG_RETURN(simple_resize_key_cache(keycache, key_cache_block_size,
+                                        use_mem, division_limit,
+                                        age_threshold));
+  DBUG_RETURN(setup_partitions(keycache, 1, key_cache_block_size, use_mem,
+                               division_limit, age_threshold));
+}
+
+
+/*
+  Change the key cache parameters
+
+  SYNOPSIS
+    change_key_cache_param()
+    keycache			pointer to a key cache data structure
+    division_limit		new division limit (if not zero)
+    age_threshold		new age threshold (if not zero)
+
+  RETURN VALUE
+    none
+*/
+
+void change_key_cache_param(KEY_CACHE *keycache, uint division_limit,
+			    uint age_threshold)
+{
+  uint i;
+  if (!keycache->partition)
+  {
+    simple_change_key_cache_param(keycache, division_limit, age_threshold);
+    return;
+  }
+  for (i= 0; i < keycache->partitions; i++)
+    simple_change_key_cache_param(keycache->partition + i,
+                                  division_limit, age_threshold);
+}
+
+
+/*
+  Remove key_cache from memory
+
+  SYNOPSIS
+    end_key_cache()
+    keycache		key cache handle
+    cleanup		Complete free (Free also mutex for key cache)
+
+  RETURN VALUE
+    none
+*/
+
+void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
+{
+  uint i;
+  DBUG_ENTER("end_key_cache");
+
+  if (!keycache->partition)
+  {
+    simple_end_key_cache(keycache, cleanup);
+    DBUG_VOID_RETURN;
+  }
+  for (i= 0; i < keycache->partitions; i++)
+    simple_end_key_cache(keycache->partition + i, cleanup);
+  keycache->disk_blocks= -1;
+  keycache->blocks_used= keycache->blocks_unused= 0;
+  if (cleanup)
+  {
+    my_free(keycache->partition);
+    keycache->partition= NULL;
+    keycache->partitions= 0;
+    keycache->key_cache_inited= keycache->can_be_used= 0;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Read a block of data from a key cache into a buffer
+
+  SYNOPSIS
+    key_cache_read()
+    (see simple_key_cache_read())
+
+  NOTES.
+    For a partitioned key cache the request is split at partition
+    granule boundaries, and every piece is read from its partition.
+*/
+
+uchar *key_cache_read(KEY_CACHE *keycache,
+                      File file, my_off_t filepos, int level,
+                      uchar *buff, uint length,
+                      uint block_length, int return_buffer)
+{
+  uchar *start= buff;
+  if (!keycache->partition)
+    return simple_key_cache_read(keycache, file, filepos, level, buff, length,
+                                 block_length, return_buffer);
+  do
+  {
+    uint offset= (uint) (filepos % KEY_CACHE_PARTITION_GRANULE);
+    uint read_length= MY_MIN(length, KEY_CACHE_PARTITION_GRANULE - offset);
+    if (!simple_key_cache_read(key_cache_partition(keycache, file, filepos),
+                               file, filepos, level, buff, read_length,
+                               block_length, 0))
+      return 0;
+    filepos+= read_length;
+    buff+= read_length;
+    length-= read_length;
+  } while (length);
+  return start;
+}
+
+
+/*
+  Insert a block of file data from a buffer into a key cache
+
+  SYNOPSIS
+    key_cache_insert()
+    (see simple_key_cache_insert())
+*/
+
+int key_cache_insert(KEY_CACHE *keycache,
+                     File file, my_off_t filepos, int level,
+                     uchar *buff, uint length)
+{
+  if (!keycache->partition)
+    return simple_key_cache_insert(keycache, file, filepos, level,
+                                   buff, length);
+  do
+  {
+    uint offset= (uint) (filepos % KEY_CACHE_PARTITION_GRANULE);
+    uint read_length= MY_MIN(length, KEY_CACHE_PARTITION_GRANULE - offset);
+    if (simple_key_cache_insert(key_cache_partition(keycache, file, filepos),
+                                file, filepos, level, buff, read_length))
+      return 1;
+    filepos+= read_length;
+    buff+= read_length;
+    length-= read_length;
+  } while (length);
+  return 0;
+}
+
+
+/*
+  Write a buffer into a key cache
+
+  SYNOPSIS
+    key_cache_write()
+    (see simple_key_cache_write())
+*/
+
+int key_cache_write(KEY_CACHE *keycache,
+                    File file, my_off_t filepos, int level,
+                    uchar *buff, uint length,
+                    uint block_length, int dont_write)
+{
+  if (!keycache->partition)
+    return simple_key_cache_write(keycache, file, filepos, level, buff, length,
+                                  block_length, dont_write);
+  do
+  {
+    uint offset= (uint) (filepos % KEY_CACHE_PARTITION_GRANULE);
+    uint write_length= MY_MIN(length, KEY_CACHE_PARTITION_GRANULE - offset);
+    if (simple_key_cache_write(key_cache_partition(keycache, file, filepos),
+                               file, filepos, level, buff, write_length,
+                               block_length, dont_write))
+      return 1;
+    filepos+= write_length;
+    buff+= write_length;
+    length-= write_length;
+  } while (length);
+  return 0;
+}
+
+
+/*
+  Flush all blocks for a file to disk
+
+  SYNOPSIS
+    flush_key_blocks()
+      keycache            pointer to a key cache data structure
+      file                handler for the file to flush to
+      flush_type          type of the flush
+
+  RETURN
+    0   ok
+    1  error
+*/
+
+int flush_key_blocks(KEY_CACHE *keycache,
+                     File file, enum flush_type type)
+{
+  int res= 0;
+  uint i;
+  if (!keycache->partition)
+    return simple_flush_key_blocks(keycache, file, type);
+  for (i= 0; i < keycache->partitions; i++)
+    res|= simple_flush_key_blocks(keycache->partition + i, file, type);
+  return res;
+}
+
+
+/*
+  Update the statistics of a partitioned key cache
+
+  SYNOPSIS
+    update_key_cache_stats()
+    keycache            pointer to a key cache data structure
+
+  DESCRIPTION
+    The partitions of a key cache count their blocks and requests
+    separately. This sums them up into the key cache itself, where
+    SHOW STATUS reads them. It does nothing for an unpartitioned
+    key cache. The partitions are not locked; the sums are as exact
+    as the counters of an unpartitioned cache read without a lock.
+*/
+
+void update_key_cache_stats(KEY_CACHE *keycache)
+{
+  KEY_CACHE *part, *end;
+  ulong used= 0, unused= 0, changed= 0, global_changed= 0;
+  ulonglong r_requests= 0, reads= 0, w_requests= 0, writes= 0;
+  if (!keycache->partition)
+    return;
+  for (part= keycache->partition, end= part + keycache->partitions;
+       part < end; part++)
+  {
+    used+= part->blocks_used;
+    unused+= part->blocks_unused;
+    changed+= part->blocks_changed;
+    global_changed+= part->global_blocks_changed;
+    r_requests+= part->global_cache_r_requests;
+    reads+= part->global_cache_read;
+    w_requests+= part->global_cache_w_requests;
+    writes+= part->global_cache_write;
+  }
+  keycache->blocks_used= used;
+  keycache->blocks_unused= unused;
+  keycache->blocks_changed= changed;
+  keycache->global_blocks_changed= global_changed;
+  keycache->global_cache_r_requests= r_requests;
+  keycache->global_cache_read= reads;
+  keycache->global_cache_w_requests= w_requests;
+  keycache->global_cache_write= writes;
+}
+
+
 /*
   Reset the counters of a key cache.
 
@@ -4225,6 +4664,12 @@ int reset_key_cache_counters(const char *name __attribute__((unused)),
   key_cache->global_cache_read= 0;       /* Key_reads */
   key_cache->global_cache_w_requests= 0; /* Key_write_requests */
   key_cache->global_cache_write= 0;      /* Key_writes */
+  if (key_cache->partition)
+  {
+    uint i;
+    for (i= 0; i < key_cache->partitions; i++)
+      reset_key_cache_counters(name, key_cache->partition + i);
+  }
   DBUG_RETURN(0);
 }
 
@@ -336,6 +336,69 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 }
 
 
+/*
+  Free all blocks except pre_alloc and, if keep_size is non-0, as many
+  other blocks as fit in keep_size bytes. The blocks left are marked free.
+*/
+
+static void free_blocks(MEM_ROOT *root, size_t keep_size)
+{
+  USED_MEM *next,*old;
+  USED_MEM *recycled= 0;
+
+  for (next=root->used; next ;)
+  {
+    old=next; next= next->next ;
+    if (old != root->pre_alloc)
+    {
+      if (old->size <= keep_size)
+      {
+        keep_size-= old->size;
+        old->next= recycled;
+        recycled= old;
+        continue;
+      }
+      old->left= old->size;
+      TRASH_MEM(old);
+      my_free(old);
+    }
+  }
+  for (next=root->free ; next ;)
+  {
+    old=next; next= next->next;
+    if (old != root->pre_alloc)
+    {
+      if (old->size <= keep_size)
+      {
+        keep_size-= old->size;
+        old->next= recycled;
+        recycled= old;
+        continue;
+      }
+      old->left= old->size;
+      TRASH_MEM(old);
+      my_free(old);
+    }
+  }
+  for (next= recycled; next; next= next->next)
+  {
+    next->left= next->size - ALIGN_SIZE(sizeof(USED_MEM));
+    TRASH_MEM(next);
+  }
+  root->used= 0;
+  root->free= recycled;
+  if (root->pre_alloc)
+  {
+    root->pre_alloc->left=root->pre_alloc->size-ALIGN_SIZE(sizeof(USED_MEM));
+    TRASH_MEM(root->pre_alloc);
+    root->pre_alloc->next= recycled;
+    root->free=root->pre_alloc;
+  }
+  root->block_num= 4;
+  root->first_block_usage= 0;
+}
+
+
 /*
   Deallocate everything used by alloc_root or just move
   used blocks to free list if called with MY_USED_TO_FREE
@@ -357,7 +420,6 @@ static inline void mark_blocks_free(MEM_ROOT* root)
 
 void free_root(MEM_ROOT *root, myf MyFlags)
 {
-  USED_MEM *next,*old;
   DBUG_ENTER("free_root");
   DBUG_PRINT("enter",("root: 0x%lx  flags: %u", (long) root, (uint) MyFlags));
 
@@ -369,36 +431,57 @@ void free_root(MEM_ROOT *root, myf MyFlags)
   if (!(MyFlags & MY_KEEP_PREALLOC))
     root->pre_alloc=0;
 
-  for (next=root->used; next ;)
-  {
-    old=next; next= next->next ;
-    if (old != root->pre_alloc)
-    {
-      old->left= old->size;
-      TRASH_MEM(old);
-      my_free(old);
-    }
-  }
-  for (next=root->free ; next ;)
+  free_blocks(root, 0);
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Like free_root(root, MYF(MY_KEEP_PREALLOC)), but keep some of the other
+  blocks for reuse too
+
+  SYNOPSIS
+    recycle_root()
+      root		Memory root
+      peak		Peak of the size of the blocks used, kept by the
+                        caller between the calls
+      max_keep		Upper limit for the size of the blocks kept besides
+                        the preallocated block
+
+  DESCRIPTION
+    The size of the blocks kept follows the peak of the size of the blocks
+    used between the calls. The peak decays by 1/8 per call, so the memory
+    of a single big statement is given back after a while.
+*/
+
+void recycle_root(MEM_ROOT *root, size_t *peak, size_t max_keep)
+{
+  size_t keep_size= 0;
+  DBUG_ENTER("recycle_root");
+
+#if !(defined(HAVE_purify) && defined(EXTRA_DEBUG))
+  if (max_keep)
   {
-    old=next; next= next->next;
-    if (old != root->pre_alloc)
+    USED_MEM *next;
+    size_t used= 0;
+
+    for (next= root->used; next; next= next->next)
+      used+= next->size;
+    for (next= root->free; next; next= next->next)
     {
-      old->left= old->size;
-      TRASH_MEM(old);
-      my_free(old);
+      if (next->left + ALIGN_SIZE(sizeof(USED_MEM)) != next->size)
+        used+= next->size;
     }
+    *peak-= *peak / 8;
+    set_if_bigger(*peak, used);
+
+    keep_size= MY_MIN(*peak, max_keep);
+    if (root->pre_alloc)
+      keep_size-= MY_MIN(keep_size, root->pre_alloc->size);
   }
-  root->used=root->free=0;
-  if (root->pre_alloc)
-  {
-    root->free=root->pre_alloc;
-    root->free->left=root->pre_alloc->size-ALIGN_SIZE(sizeof(USED_MEM));
-    TRASH_MEM(root->pre_alloc);
-    root->free->next=0;
-  }
-  root->block_num= 4;
-  root->first_block_usage= 0;
+#endif
+
+  free_blocks(root, keep_size);
   DBUG_VOID_RETURN;
 }
 
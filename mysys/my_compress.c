@@ -137,6 +137,199 @@ my_bool my_uncompress(uchar *packet, size_t len, size_t *complen)
   DBUG_RETURN(0);
 }
 
+
+/*
+  Streaming compression
+
+  A stream compresses a sequence of packets with one deflate context and
+  uncompresses the packets of the peer with one inflate context. Each
+  packet is flushed to a byte boundary, so that it can be uncompressed as
+  soon as it is received, but later packets are still compressed with
+  references to the earlier ones. This is how small packets compress well.
+
+  Both peers must pass the same packets to the stream, in order: a packet
+  that is sent uncompressed must not have been compressed with it first.
+*/
+
+struct st_my_compress_stream
+{
+  z_stream deflater;
+  z_stream inflater;
+};
+
+
+static voidpf my_zalloc(voidpf opaque __attribute__((unused)),
+                        uInt items, uInt size)
+{
+  return my_malloc(key_memory_my_compress_alloc, (size_t) items * size,
+                   MYF(0));
+}
+
+
+static void my_zfree(voidpf opaque __attribute__((unused)), voidpf address)
+{
+  my_free(address);
+}
+
+
+/*
+  Create a compression stream
+
+   SYNOPSIS
+     my_compress_stream_init()
+     level	Compression level from 1 (fastest) to 9 (best), or 0 for
+                the default level of zlib
+
+   RETURN
+     The stream, or NULL if out of memory
+*/
+
+MY_COMPRESS_STREAM *my_compress_stream_init(uint level)
+{
+  MY_COMPRESS_STREAM *stream;
+  DBUG_ENTER("my_compress_stream_init");
+
+  if (!(stream= (MY_COMPRESS_STREAM *)
+        my_malloc(key_memory_my_compress_alloc, sizeof(*stream),
+                  MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(NULL);
+
+  stream->deflater.zalloc= stream->inflater.zalloc= my_zalloc;
+  stream->deflater.zfree= stream->inflater.zfree= my_zfree;
+  if (deflateInit(&stream->deflater,
+                  level ? (int) MY_MIN(level, 9) : Z_DEFAULT_COMPRESSION) !=
+      Z_OK)
+  {
+    my_free(stream);
+    DBUG_RETURN(NULL);
+  }
+  if (inflateInit(&stream->inflater) != Z_OK)
+  {
+    deflateEnd(&stream->deflater);
+    my_free(stream);
+    DBUG_RETURN(NULL);
+  }
+  DBUG_RETURN(stream);
+}
+
+
+void my_compress_stream_end(MY_COMPRESS_STREAM *stream)
+{
+  deflateEnd(&stream->deflater);
+  inflateEnd(&stream->inflater);
+  my_free(stream);
+}
+
+
+/*
+  Size of a buffer that is large enough for any packet of len bytes
+  compressed with my_compress_stream(): data that does not compress is
+  stored in blocks of up to 16K with 5 bytes of header each, and the
+  flush of each packet adds up to 10 bytes.
+*/
+
+size_t my_compress_stream_bound(size_t len)
+{
+  return len + (len >> 8) + 64;
+}
+
+
+/*
+  Compress a packet with a stream
+
+   SYNOPSIS
+     my_compress_stream()
+     stream	Compression stream
+     packet	Data to compress
+     len	Length of data to compress at 'packet'
+     to		Buffer for the compressed data
+     complen	in:  size of the buffer, at least
+                     my_compress_stream_bound(len)
+		out: length of the compressed data
+
+   RETURN
+     1   error. The stream can not be used any more.
+     0   ok
+*/
+
+my_bool my_compress_stream(MY_COMPRESS_STREAM *stream,
+                           const uchar *packet, size_t len,
+                           uchar *to, size_t *complen)
+{
+  z_stream *strm= &stream->deflater;
+  int error;
+  DBUG_ENTER("my_compress_stream");
+
+  strm->next_in= (Bytef*) packet;
+  strm->avail_in= (uInt) len;
+  strm->next_out= (Bytef*) to;
+  strm->avail_out= (uInt) *complen;
+  error= deflate(strm, Z_SYNC_FLUSH);
+  if (error != Z_OK || strm->avail_in || !strm->avail_out)
+  {
+    DBUG_PRINT("error",("Can't compress packet, error: %d",error));
+    DBUG_RETURN(1);
+  }
+  *complen-= strm->avail_out;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Uncompress a packet with a stream
+
+   SYNOPSIS
+     my_uncompress_stream()
+     packet	Compressed data. This is is replaced with the orignal data.
+     len	Length of compressed data
+     complen	Length of the original data, 0 if the packet was sent
+                uncompressed. The packet buffer must be large enough for
+                the original data.
+		out: Length of the data in the packet
+
+   RETURN
+     1   error. The stream can not be used any more.
+     0   ok
+*/
+
+my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream,
+                             uchar *packet, size_t len, size_t *complen)
+{
+  z_stream *strm= &stream->inflater;
+  uchar *compbuf;
+  int error;
+  DBUG_ENTER("my_uncompress_stream");
+
+  if (!*complen)
+  {
+    *complen= len;
+    DBUG_RETURN(0);
+  }
+  if (!(compbuf= (uchar *) my_malloc(key_memory_my_compress_alloc,
+                                     *complen, MYF(MY_WME))))
+    DBUG_RETURN(1);				/* Not enough memory */
+
+  strm->next_in= (Bytef*) packet;
+  strm->avail_in= (uInt) len;
+  strm->next_out= (Bytef*) compbuf;
+  strm->avail_out= (uInt) *complen;
+  /* The end of the flush has no output, and may need another call */
+  do
+    error= inflate(strm, Z_SYNC_FLUSH);
+  while (error == Z_OK && strm->avail_in);
+
+  if ((error != Z_OK && error != Z_BUF_ERROR) ||
+      strm->avail_in || strm->avail_out)
+  {						/* Probably wrong packet */
+    DBUG_PRINT("error",("Can't uncompress packet, error: %d",error));
+    my_free(compbuf);
+    DBUG_RETURN(1);
+  }
+  memcpy(packet, compbuf, *complen);
+  my_free(compbuf);
+  DBUG_RETURN(0);
+}
+
 /*
   Internal representation of the frm blob is:
 
@@ -25,9 +25,23 @@
 #include <sys/shm.h>
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+/*
+  Use mmap() rather than SysV shared memory where the system supports
+  huge pages for anonymous mappings. my_large_malloc() then never falls
+  back to my_malloc(), because my_large_free() could not tell the two
+  kinds of memory apart.
+*/
+#if defined(MAP_HUGETLB) && defined(HAVE_MMAP)
+#define MY_LARGE_PAGES_MMAP
+#endif
+
 static uint my_get_large_page_size_int(void);
 static uchar* my_large_malloc_int(size_t size, myf my_flags);
-static my_bool my_large_free_int(uchar* ptr);
+static my_bool my_large_free_int(uchar* ptr, size_t size);
 
 /* Gets the size of large pages from the OS */
 
@@ -57,6 +71,9 @@ uchar* my_large_malloc(PSI_memory_key key, size_t size, myf my_flags)
   {
     if ((ptr = my_large_malloc_int(size, my_flags)) != NULL)
         DBUG_RETURN(ptr);
+#ifdef MY_LARGE_PAGES_MMAP
+    DBUG_RETURN(NULL);
+#endif
     if (my_flags & MY_WME)
       my_message_local(WARNING_LEVEL, "Using conventional memory pool"); /* purecov: inspected */
   }
@@ -70,7 +87,7 @@ uchar* my_large_malloc(PSI_memory_key key, size_t size, myf my_flags)
   to my_free() in case of failure
  */
 
-void my_large_free(uchar* ptr)
+void my_large_free(uchar* ptr, size_t size)
 {
   DBUG_ENTER("my_large_free");
   
@@ -79,7 +96,8 @@ void my_large_free(uchar* ptr)
     my_large_malloc_int(), i.e. my_malloc() was used so we should free it
     with my_free()
   */
-  if (!my_use_large_pages || !my_large_page_size || !my_large_free_int(ptr))
+  if (!my_use_large_pages || !my_large_page_size ||
+      !my_large_free_int(ptr, size))
     my_free(ptr);
 
   DBUG_VOID_RETURN;
@@ -110,7 +128,72 @@ finish:
 }
 #endif /* HUGETLB_USE_PROC_MEMINFO */
 
-#if HAVE_DECL_SHM_HUGETLB
+#if defined(MY_LARGE_PAGES_MMAP)
+/*
+  Linux-specific large pages allocator. Explicit huge pages of
+  my_large_page_size, which can be 2MB or 1GB on x86-64, are preferred.
+  Without them the memory is mapped with ordinary pages and the kernel
+  is advised to back it with transparent huge pages.
+*/
+
+uchar* my_large_malloc_int(size_t size, myf my_flags)
+{
+  void* ptr;
+  int flags= MAP_PRIVATE | MAP_ANONYMOUS;
+  DBUG_ENTER("my_large_malloc_int");
+
+  /* Align block size to my_large_page_size */
+  size= MY_ALIGN(size, (size_t) my_large_page_size);
+
+#ifdef MAP_HUGE_SHIFT
+  {
+    uint shift= 0;
+    while ((1UL << shift) < my_large_page_size)
+      shift++;
+    /* Ask for the huge page size explicitly, the default may differ */
+    ptr= mmap(NULL, size, PROT_READ | PROT_WRITE,
+              flags | MAP_HUGETLB | (int) (shift << MAP_HUGE_SHIFT), -1, 0);
+  }
+#else
+  ptr= mmap(NULL, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+#endif
+
+  if (ptr != MAP_FAILED)
+    DBUG_RETURN((uchar*) ptr);
+
+  if (my_flags & MY_WME)
+    /* purecov: begin inspected */
+    my_message_local(WARNING_LEVEL,
+                     "Failed to allocate %lu bytes from HugeTLB memory."
+                     " errno %d", (ulong) size, errno);
+    /* purecov: end */
+
+  ptr= mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (ptr == MAP_FAILED)
+  {
+    if (my_flags & MY_WME)
+      /* purecov: begin inspected */
+      my_message_local(ERROR_LEVEL, "Failed to map %lu bytes of memory."
+                       " errno %d", (ulong) size, errno);
+      /* purecov: end */
+    DBUG_RETURN(NULL);
+  }
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+  madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+
+  DBUG_RETURN((uchar*) ptr);
+}
+
+/* Linux-specific large pages deallocator */
+
+my_bool my_large_free_int(uchar *ptr, size_t size)
+{
+  DBUG_ENTER("my_large_free_int");
+  DBUG_RETURN(munmap(ptr, MY_ALIGN(size, (size_t) my_large_page_size)) == 0);
+}
+#elif HAVE_DECL_SHM_HUGETLB
 /* Linux-specific large pages allocator  */
     
 uchar* my_large_malloc_int(size_t size, myf my_flags)
@@ -159,11 +242,12 @@ uchar* my_large_malloc_int(size_t size, myf my_flags)
 
 /* Linux-specific large pages deallocator */
 
-my_bool my_large_free_int(uchar *ptr)
+my_bool my_large_free_int(uchar *ptr,
+                          size_t size __attribute__((unused)))
 {
   DBUG_ENTER("my_large_free_int");
   DBUG_RETURN(shmdt(ptr) == 0);
 }
-#endif /* HAVE_DECL_SHM_HUGETLB */
+#endif /* MY_LARGE_PAGES_MMAP */
 
 #endif /* HAVE_LARGE_PAGES */
@@ -0,0 +1,184 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* Hardware performance counters of threads, see my_perf_counters.h */
+
+#include "mysys_priv.h"
+#include <my_perf_counters.h>
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+my_bool my_perf_counters_enabled= FALSE;
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+
+/* The events of the group, in the order of the MY_PERF_COUNTERS members */
+static const struct
+{
+  uint32 type;
+  uint64 config;
+} perf_events[]=
+{
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+};
+
+#define PERF_EVENTS array_elements(perf_events)
+
+/* The events opened for a thread, st_my_thread_var::perf_counters */
+struct st_perf_group
+{
+  int fd[PERF_EVENTS];
+};
+
+/*
+  Marks the threads where the events could not be opened, so that
+  opening them is not tried again on every read.
+*/
+static struct st_perf_group perf_group_unavailable;
+
+
+static void close_perf_group(struct st_perf_group *group, uint count)
+{
+  uint i;
+  for (i= 0; i < count; i++)
+    close(group->fd[i]);
+}
+
+
+/*
+  Open the events of the current thread
+
+  NOTES
+    The first event leads the group, so that all the events are scheduled
+    on the CPU together and are read with one read() of the leader. The
+    leader is pinned, a read then fails rather than returning values that
+    were not counted all the time.
+
+  RETURN
+    The group, or &perf_group_unavailable
+*/
+
+static struct st_perf_group *open_perf_group(void)
+{
+  struct st_perf_group *group;
+  struct perf_event_attr attr;
+  uint i;
+
+  if (!(group= (struct st_perf_group *) malloc(sizeof(*group))))
+    return &perf_group_unavailable;
+
+  for (i= 0; i < PERF_EVENTS; i++)
+  {
+    int leader= i ? group->fd[0] : -1;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size= sizeof(attr);
+    attr.type= perf_events[i].type;
+    attr.config= perf_events[i].config;
+    attr.read_format= PERF_FORMAT_GROUP;
+    attr.pinned= (i == 0);
+    attr.exclude_kernel= 1;
+    attr.exclude_hv= 1;
+
+    group->fd[i]= (int) syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+    if (group->fd[i] < 0)
+    {
+      close_perf_group(group, i);
+      free(group);
+      return &perf_group_unavailable;
+    }
+  }
+  return group;
+}
+
+
+my_bool my_perf_counters_read(MY_PERF_COUNTERS *values)
+{
+  struct st_my_thread_var *thread_var;
+  struct st_perf_group *group;
+  uint64 buf[1 + PERF_EVENTS];
+
+  if (!my_perf_counters_enabled)
+    return TRUE;
+  if (!(thread_var= my_thread_var))
+    return TRUE;
+
+  if (!(group= (struct st_perf_group *) thread_var->perf_counters))
+    thread_var->perf_counters= group= open_perf_group();
+  if (group == &perf_group_unavailable)
+    return TRUE;
+
+  /* The number of events, followed by their values */
+  if (read(group->fd[0], buf, sizeof(buf)) != (ssize_t) sizeof(buf) ||
+      buf[0] != PERF_EVENTS)
+    return TRUE;
+
+  values->cycles= buf[1];
+  values->instructions= buf[2];
+  values->llc_misses= buf[3];
+  values->branch_misses= buf[4];
+  values->thread_id= thread_var->id;
+  return FALSE;
+}
+
+
+void my_perf_counters_thread_end(struct st_my_thread_var *thread_var)
+{
+  struct st_perf_group *group=
+    (struct st_perf_group *) thread_var->perf_counters;
+
+  if (group && group != &perf_group_unavailable)
+  {
+    close_perf_group(group, PERF_EVENTS);
+    free(group);
+  }
+  thread_var->perf_counters= NULL;
+}
+
+#else /* HAVE_LINUX_PERF_EVENT_H */
+
+my_bool my_perf_counters_read(MY_PERF_COUNTERS *values
+                              __attribute__((unused)))
+{
+  return TRUE;
+}
+
+
+void my_perf_counters_thread_end(struct st_my_thread_var *thread_var
+                                 __attribute__((unused)))
+{
+}
+
+#endif /* HAVE_LINUX_PERF_EVENT_H */
+
+
+my_bool my_perf_counters_diff(MY_PERF_COUNTERS *end,
+                              const MY_PERF_COUNTERS *start)
+{
+  if (end->thread_id != start->thread_id)
+    return TRUE;
+  end->cycles-= start->cycles;
+  end->instructions-= start->instructions;
+  end->llc_misses-= start->llc_misses;
+  end->branch_misses-= start->branch_misses;
+  return FALSE;
+}
@@ -350,6 +350,7 @@ void my_thread_end(void)
       tmp->dbug=0;
     }
 #endif
+    my_perf_counters_thread_end(tmp);
     mysql_cond_destroy(&tmp->suspend);
     mysql_mutex_destroy(&tmp->mutex);
     free(tmp);
@@ -109,6 +109,9 @@ C_MODE_END
 
 void my_error_unregister_all(void);
 
+/* my_perf_counters.c, closes the counters of a thread */
+void my_perf_counters_thread_end(struct st_my_thread_var *thread_var);
+
 #ifdef _WIN32
 #include <sys/stat.h>
 /* my_winfile.c exports, should not be used outside mysys */
@@ -4004,6 +4004,54 @@ static char *get_suffix_buffer(conn *c) {
     return suffix;
 }
 
+/*
+ * Look up all the keys of a get command that are in the current set of
+ * tokens with one call, if the engine supports it.
+ *
+ * Returns the number of items stored in items, or 0 if the keys are to be
+ * looked up one by one.
+ */
+static int prefetch_get_items(conn *c, token_t *key_token, item **items) {
+    const void *keys[MAX_TOKENS];
+    int nkeys[MAX_TOKENS];
+    int count = 0;
+
+    if (settings.engine.v1->get_multi == NULL ||
+        c->aiostat != ENGINE_SUCCESS) {
+        return 0;
+    }
+
+    while (key_token[count].length != 0) {
+        if (key_token[count].length > KEY_MAX_LENGTH) {
+            return 0;
+        }
+        keys[count] = key_token[count].value;
+        nkeys[count] = key_token[count].length;
+        count++;
+    }
+
+    if (count < 2 ||
+        settings.engine.v1->get_multi(settings.engine.v0, c, items, keys,
+                                      nkeys, count, 0) != ENGINE_SUCCESS) {
+        return 0;
+    }
+
+    return count;
+}
+
+/*
+ * Release the items looked up by prefetch_get_items() that were not used.
+ */
+static void release_prefetched_items(conn *c, item **items, int count) {
+    int ii;
+    for (ii = 0; ii < count; ii++) {
+        if (items[ii] != NULL) {
+            settings.engine.v1->release(settings.engine.v0, c, items[ii]);
+            items[ii] = NULL;
+        }
+    }
+}
+
 /* ntokens is overwritten here... shrug.. */
 static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens, bool return_cas) {
     char *key;
@@ -4011,9 +4059,15 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
     int i = c->ileft;
     item *it;
     token_t *key_token = &tokens[KEY_TOKEN];
+    item *prefetched[MAX_TOKENS];
+    int n_prefetched;
+    int next_prefetched;
     assert(c != NULL);
 
     do {
+        n_prefetched = prefetch_get_items(c, key_token, prefetched);
+        next_prefetched = 0;
+
         while(key_token->length != 0) {
 
             key = key_token->value;
@@ -4027,7 +4081,11 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
             ENGINE_ERROR_CODE ret = c->aiostat;
             c->aiostat = ENGINE_SUCCESS;
 
-            if (ret == ENGINE_SUCCESS) {
+            if (next_prefetched < n_prefetched) {
+                it = prefetched[next_prefetched];
+                prefetched[next_prefetched++] = NULL;
+                ret = it != NULL ? ENGINE_SUCCESS : ENGINE_KEY_ENOENT;
+            } else if (ret == ENGINE_SUCCESS) {
                 ret = settings.engine.v1->get(settings.engine.v0, c, &it, key, nkey, 0);
             }
 
@@ -4074,6 +4132,7 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
                 if (suffix == NULL) {
                     out_string(c, "SERVER_ERROR out of memory rebuilding suffix");
                     settings.engine.v1->release(settings.engine.v0, c, it);
+                    release_prefetched_items(c, prefetched, n_prefetched);
                     return NULL;
                 }
                 int suffix_len = snprintf(suffix, SUFFIX_SIZE,
@@ -4097,6 +4156,7 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
                   if (cas == NULL) {
                     out_string(c, "SERVER_ERROR out of memory making CAS suffix");
                     settings.engine.v1->release(settings.engine.v0, c, it);
+                    release_prefetched_items(c, prefetched, n_prefetched);
                     return NULL;
                   }
                   int cas_len = snprintf(cas, SUFFIX_SIZE, " %"PRIu64"\r\n",
@@ -4145,6 +4205,8 @@ static inline char* process_get_command(conn *c, token_t *tokens, size_t ntokens
             key_token++;
         }
 
+        release_prefetched_items(c, prefetched, n_prefetched);
+
         /*
          * If the command string hasn't been fully processed, get the next set
          * of tokens.
@@ -551,7 +551,32 @@ extern "C" {
         size_t (*errinfo)(ENGINE_HANDLE *handle, const void* cookie,
                           char *buffer, size_t buffsz);
 
-
+        /**
+         * Retrieve several items at once (optional).
+         *
+         * Engines that can look up a set of keys more cheaply than one
+         * key at a time implement this for multi-key "get" commands.
+         * If the engine returns anything but ENGINE_SUCCESS, the keys
+         * are looked up one by one with get().
+         *
+         * @param handle the engine handle
+         * @param cookie The cookie provided by the frontend
+         * @param items output array that will receive the located items,
+         *              NULL for the keys that were not found
+         * @param keys the keys to look up
+         * @param nkeys the lengths of the keys
+         * @param count the number of keys
+         * @param vbucket the virtual bucket id
+         *
+         * @return ENGINE_SUCCESS if all goes well
+         */
+        ENGINE_ERROR_CODE (*get_multi)(ENGINE_HANDLE* handle,
+                                       const void* cookie,
+                                       item** items,
+                                       const void** keys,
+                                       const int* nkeys,
+                                       const int count,
+                                       uint16_t vbucket);
 
     } ENGINE_HANDLE_V1;
 
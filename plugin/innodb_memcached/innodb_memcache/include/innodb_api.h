@@ -137,6 +137,22 @@ innodb_api_search(
 	ib_tpl_t*		r_tpl,	/*!< in: tpl for other DML operations */
 	bool			sel_only); /*!< in: for select only */
 
+/*************************************************************//**
+Fetch the values of several keys with one cursor, for a multi-get. The
+keys are searched for in index order, so that keys that are close to
+each other in the index are found without descending the index again.
+@return DB_SUCCESS if successful otherwise, error code */
+ib_err_t
+innodb_api_search_batch(
+/*====================*/
+	innodb_conn_data_t*	cursor_data,/*!< in/out: cursor info */
+	const char**		keys,	/*!< in: keys to search */
+	const int*		lens,	/*!< in: key lengths */
+	int			n_keys,	/*!< in: number of keys */
+	mci_item_t*		items,	/*!< out: results, n_keys items */
+	bool*			found);	/*!< out: whether each key was
+					found, n_keys elements */
+
 /*************************************************************//**
 Insert a row
 @return DB_SUCCESS if successful otherwise, error code */
@@ -385,6 +385,16 @@ const char*
 /*============*/
 	ib_err_t	num);
 
+typedef
+ib_err_t
+(*cb_cursor_moveto_batch_t)(
+/*========================*/
+	ib_crsr_t	ib_crsr,
+	ib_tpl_t*	ib_tpls,
+	ib_ulint_t	n_keys,
+	ib_key_cb_t	key_cb,
+	void*		arg);
+
 cb_open_table_t			ib_cb_open_table;
 cb_read_row_t			ib_cb_read_row;
 cb_insert_row_t			ib_cb_insert_row;
@@ -437,5 +447,6 @@ cb_cursor_clear_trx_t		ib_cb_cursor_clear_trx;
 cb_trx_get_start_time		ib_cb_trx_get_start_time;
 cb_bk_commit_interval		ib_cb_cfg_bk_commit_interval;
 cb_ut_strerr			ib_cb_ut_strerr;
+cb_cursor_moveto_batch_t	ib_cb_moveto_batch;
 
 #endif /* innodb_cb_api_h */
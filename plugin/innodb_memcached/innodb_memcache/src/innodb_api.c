@@ -91,7 +91,8 @@ static ib_cb_t* innodb_memcached_api[] = {
 	(ib_cb_t*) &ib_cb_get_idx_field_name,
 	(ib_cb_t*) &ib_cb_trx_get_start_time,
 	(ib_cb_t*) &ib_cb_cfg_bk_commit_interval,
-	(ib_cb_t*) &ib_cb_ut_strerr
+	(ib_cb_t*) &ib_cb_ut_strerr,
+	(ib_cb_t*) &ib_cb_moveto_batch
 };
 
 /** Set expiration time. If the exp sent by client is larger than
@@ -490,6 +491,133 @@ innodb_api_fill_value(
 	return(err);
 }
 
+/*************************************************************//**
+Fetch the values of the row that a search has positioned the cursor on.
+@return DB_SUCCESS if successful otherwise, error code */
+static
+ib_err_t
+innodb_api_read_item(
+/*=================*/
+	innodb_conn_data_t*	cursor_data,/*!< in/out: cursor info */
+	ib_crsr_t		srch_crsr,/*!< in: cursor used to search */
+	mci_item_t*		item,	/*!< out: result */
+	ib_tpl_t*		r_tpl,	/*!< out: tpl for other DML
+					operations, or NULL */
+	bool			sel_only) /*!< in: for select only */
+{
+	ib_err_t	err;
+	meta_cfg_info_t* meta_info = cursor_data->conn_meta;
+	meta_column_t*	col_info = meta_info->col_info;
+	ib_tpl_t	read_tpl;
+	int		n_cols;
+	int		i;
+
+	read_tpl = ib_cb_read_tuple_create(
+			sel_only ? cursor_data->read_crsr
+				 : cursor_data->crsr);
+
+	err = ib_cb_read_row(srch_crsr, read_tpl);
+
+	if (err != DB_SUCCESS) {
+		ib_cb_tuple_delete(read_tpl);
+
+		if (r_tpl) {
+			*r_tpl = NULL;
+		}
+		return(err);
+	}
+
+	n_cols = ib_cb_tuple_get_n_cols(read_tpl);
+
+	if (meta_info->n_extra_col > 0) {
+		/* If there are multiple values to read,allocate
+		memory */
+		item->extra_col_value = malloc(
+			meta_info->n_extra_col
+			* sizeof(*item->extra_col_value));
+		item->n_extra_col = meta_info->n_extra_col;
+	} else {
+		item->extra_col_value = NULL;
+		item->n_extra_col = 0;
+	}
+
+	/* The table must have at least MCI_COL_TO_GET(5) columns
+	for memcached key, value, flag, cas and time expiration info */
+	assert(n_cols >= MCI_COL_TO_GET);
+
+	for (i = 0; i < n_cols; ++i) {
+		ib_ulint_t      data_len;
+		ib_col_meta_t   col_meta;
+
+		data_len = ib_cb_col_get_meta(read_tpl, i, &col_meta);
+
+		if (i == col_info[CONTAINER_KEY].field_id) {
+			assert(data_len != IB_SQL_NULL);
+			item->col_value[MCI_COL_KEY].value_str =
+				(char*)ib_cb_col_get_value(read_tpl, i);
+			item->col_value[MCI_COL_KEY].value_len = data_len;
+			item->col_value[MCI_COL_KEY].is_str = true;
+			item->col_value[MCI_COL_KEY].is_valid = true;
+		} else if (meta_info->flag_enabled
+			   && i == col_info[CONTAINER_FLAG].field_id) {
+
+			if (data_len == IB_SQL_NULL) {
+				item->col_value[MCI_COL_FLAG].is_null
+					= true;
+			} else {
+				item->col_value[MCI_COL_FLAG].value_int =
+					innodb_api_read_int(
+					&col_info[CONTAINER_FLAG].col_meta,
+					read_tpl, i);
+				item->col_value[MCI_COL_FLAG].is_str
+					 = false;
+				item->col_value[MCI_COL_FLAG].value_len
+					 = data_len;
+				item->col_value[MCI_COL_FLAG].is_valid
+					 = true;
+			}
+		} else if (meta_info->cas_enabled
+			   && i == col_info[CONTAINER_CAS].field_id) {
+			if (data_len == IB_SQL_NULL) {
+				item->col_value[MCI_COL_CAS].is_null
+					= true;
+			}
+			item->col_value[MCI_COL_CAS].value_int =
+				 innodb_api_read_int(
+					&col_info[CONTAINER_CAS].col_meta,
+					read_tpl, i);
+			item->col_value[MCI_COL_CAS].is_str = false;
+			item->col_value[MCI_COL_CAS].value_len = data_len;
+			item->col_value[MCI_COL_CAS].is_valid = true;
+		} else if (meta_info->exp_enabled
+			   && i == col_info[CONTAINER_EXP].field_id) {
+			if (data_len == IB_SQL_NULL) {
+				item->col_value[MCI_COL_EXP].is_null
+					= true;
+			}
+
+			item->col_value[MCI_COL_EXP].value_int =
+				 innodb_api_read_int(
+					&col_info[CONTAINER_EXP].col_meta,
+					read_tpl, i);
+			item->col_value[MCI_COL_EXP].is_str = false;
+			item->col_value[MCI_COL_EXP].value_len = data_len;
+			item->col_value[MCI_COL_EXP].is_valid = true;
+		} else {
+			innodb_api_fill_value(meta_info, item,
+					      read_tpl, i, sel_only);
+		}
+	}
+
+	if (r_tpl) {
+		*r_tpl = read_tpl;
+	} else {
+		ib_cb_tuple_delete(read_tpl);
+	}
+
+	return(DB_SUCCESS);
+}
+
 /*************************************************************//**
 Position a row according to the search key, and fetch value if needed
 @return DB_SUCCESS if successful otherwise, error code */
@@ -507,7 +635,6 @@ innodb_api_search(
 {
 	ib_err_t	err = DB_SUCCESS;
 	meta_cfg_info_t* meta_info = cursor_data->conn_meta;
-	meta_column_t*	col_info = meta_info->col_info;
 	meta_index_t*	meta_index = &meta_info->index_info;
 	ib_tpl_t	key_tpl;
 	ib_crsr_t	srch_crsr;
@@ -562,118 +689,116 @@ innodb_api_search(
 	/* If item is NULL, this function is used just to position the cursor.
 	Otherwise, fetch the data from the read tuple */
 	if (item) {
-		ib_tpl_t	read_tpl;
-		int		n_cols;
-		int		i;
+		err = innodb_api_read_item(cursor_data, srch_crsr, item,
+					   r_tpl, sel_only);
+	}
+
+func_exit:
+	*crsr = srch_crsr;
 
-		read_tpl = ib_cb_read_tuple_create(
-				sel_only ? cursor_data->read_crsr
-					 : cursor_data->crsr);
+	ib_cb_tuple_delete(key_tpl);
 
-		err = ib_cb_read_row(srch_crsr, read_tpl);
+	return(err);
+}
 
-		if (err != DB_SUCCESS) {
-			ib_cb_tuple_delete(read_tpl);
+/** State of a search started by innodb_api_search_batch() */
+typedef struct innodb_batch_search_struct {
+	innodb_conn_data_t*	cursor_data;	/*!< cursor info */
+	mci_item_t*		items;		/*!< results */
+	bool*			found;		/*!< whether a key was found */
+} innodb_batch_search_t;
 
-			if (r_tpl) {
-				*r_tpl = NULL;
-			}
-			goto func_exit;
-		}
+/*************************************************************//**
+Fetch the value of the row found for a key of innodb_api_search_batch()
+@return DB_SUCCESS to continue with the next key, otherwise error code */
+static
+ib_err_t
+innodb_api_search_batch_cb(
+/*=======================*/
+	ib_crsr_t	srch_crsr,	/*!< in: cursor, positioned on the
+					row if the key was found */
+	ib_ulint_t	key_no,		/*!< in: key number */
+	ib_err_t	err,		/*!< in: result of the search */
+	void*		arg)		/*!< in/out: innodb_batch_search_t */
+{
+	innodb_batch_search_t*	search = arg;
+	mci_item_t*		item = &search->items[key_no];
 
-		n_cols = ib_cb_tuple_get_n_cols(read_tpl);
+	memset(item, 0, sizeof(*item));
 
-		if (meta_info->n_extra_col > 0) {
-			/* If there are multiple values to read,allocate
-			memory */
-			item->extra_col_value = malloc(
-				meta_info->n_extra_col
-				* sizeof(*item->extra_col_value));
-			item->n_extra_col = meta_info->n_extra_col;
-		} else {
-			item->extra_col_value = NULL;
-			item->n_extra_col = 0;
-		}
+	if (err == DB_SUCCESS) {
+		err = innodb_api_read_item(search->cursor_data, srch_crsr,
+					   item, NULL, true);
 
-		/* The table must have at least MCI_COL_TO_GET(5) columns
-		for memcached key, value, flag, cas and time expiration info */
-		assert(n_cols >= MCI_COL_TO_GET);
-
-		for (i = 0; i < n_cols; ++i) {
-			ib_ulint_t      data_len;
-			ib_col_meta_t   col_meta;
-
-			data_len = ib_cb_col_get_meta(read_tpl, i, &col_meta);
-
-			if (i == col_info[CONTAINER_KEY].field_id) {
-				assert(data_len != IB_SQL_NULL);
-				item->col_value[MCI_COL_KEY].value_str =
-					(char*)ib_cb_col_get_value(read_tpl, i);
-				item->col_value[MCI_COL_KEY].value_len = data_len;
-				item->col_value[MCI_COL_KEY].is_str = true;
-				item->col_value[MCI_COL_KEY].is_valid = true;
-			} else if (meta_info->flag_enabled
-				   && i == col_info[CONTAINER_FLAG].field_id) {
-
-				if (data_len == IB_SQL_NULL) {
-					item->col_value[MCI_COL_FLAG].is_null
-						= true;
-				} else {
-					item->col_value[MCI_COL_FLAG].value_int =
-						innodb_api_read_int(
-						&col_info[CONTAINER_FLAG].col_meta,
-						read_tpl, i);
-					item->col_value[MCI_COL_FLAG].is_str
-						 = false;
-					item->col_value[MCI_COL_FLAG].value_len
-						 = data_len;
-					item->col_value[MCI_COL_FLAG].is_valid
-						 = true;
-				}
-			} else if (meta_info->cas_enabled
-				   && i == col_info[CONTAINER_CAS].field_id) {
-				if (data_len == IB_SQL_NULL) {
-					item->col_value[MCI_COL_CAS].is_null
-						= true;
-				}
-				item->col_value[MCI_COL_CAS].value_int =
-					 innodb_api_read_int(
-						&col_info[CONTAINER_CAS].col_meta,
-						read_tpl, i);
-				item->col_value[MCI_COL_CAS].is_str = false;
-				item->col_value[MCI_COL_CAS].value_len = data_len;
-				item->col_value[MCI_COL_CAS].is_valid = true;
-			} else if (meta_info->exp_enabled
-				   && i == col_info[CONTAINER_EXP].field_id) {
-				if (data_len == IB_SQL_NULL) {
-					item->col_value[MCI_COL_EXP].is_null
-						= true;
-				}
+		search->found[key_no] = (err == DB_SUCCESS);
+	}
 
-				item->col_value[MCI_COL_EXP].value_int =
-					 innodb_api_read_int(
-						&col_info[CONTAINER_EXP].col_meta,
-						read_tpl, i);
-				item->col_value[MCI_COL_EXP].is_str = false;
-				item->col_value[MCI_COL_EXP].value_len = data_len;
-				item->col_value[MCI_COL_EXP].is_valid = true;
-			} else {
-				innodb_api_fill_value(meta_info, item,
-						      read_tpl, i, sel_only);
-			}
-		}
+	/* A key that is not found does not stop the search, but any
+	other error, such as a lock wait timeout, does */
+	if (err == DB_RECORD_NOT_FOUND || err == DB_END_OF_INDEX) {
+		err = DB_SUCCESS;
+	}
 
-		if (r_tpl) {
-			*r_tpl = read_tpl;
-		} else if (key_tpl) {
-			ib_cb_tuple_delete(read_tpl);
-		}
+	return(err);
+}
+
+/*************************************************************//**
+Fetch the values of several keys with one cursor, for a multi-get. The
+keys are searched for in index order, so that keys that are close to
+each other in the index are found without descending the index again.
+@return DB_SUCCESS if successful otherwise, error code */
+ib_err_t
+innodb_api_search_batch(
+/*====================*/
+	innodb_conn_data_t*	cursor_data,/*!< in/out: cursor info */
+	const char**		keys,	/*!< in: keys to search */
+	const int*		lens,	/*!< in: key lengths */
+	int			n_keys,	/*!< in: number of keys */
+	mci_item_t*		items,	/*!< out: results, n_keys items */
+	bool*			found)	/*!< out: whether each key was
+					found, n_keys elements */
+{
+	ib_err_t		err;
+	meta_index_t*		meta_index = &cursor_data->conn_meta->index_info;
+	ib_crsr_t		srch_crsr;
+	ib_tpl_t*		key_tpls;
+	innodb_batch_search_t	search;
+	int			i;
+
+	key_tpls = malloc(n_keys * sizeof(*key_tpls));
+
+	if (!key_tpls) {
+		return(DB_OUT_OF_MEMORY);
 	}
 
-func_exit:
-	*crsr = srch_crsr;
+	if (meta_index->srch_use_idx == META_USE_SECONDARY) {
+		srch_crsr = cursor_data->idx_read_crsr;
+		ib_cb_cursor_set_cluster_access(srch_crsr);
+	} else {
+		srch_crsr = cursor_data->read_crsr;
+	}
 
-	ib_cb_tuple_delete(key_tpl);
+	for (i = 0; i < n_keys; i++) {
+		key_tpls[i] = ib_cb_search_tuple_create(srch_crsr);
+		ib_cb_col_set_value(key_tpls[i], 0, (char*) keys[i], lens[i],
+				    true);
+		found[i] = false;
+	}
+
+	ib_cb_cursor_set_match_mode(srch_crsr, IB_EXACT_MATCH);
+
+	search.cursor_data = cursor_data;
+	search.items = items;
+	search.found = found;
+
+	err = ib_cb_moveto_batch(srch_crsr, key_tpls, n_keys,
+				 innodb_api_search_batch_cb, &search);
+
+	for (i = 0; i < n_keys; i++) {
+		ib_cb_tuple_delete(key_tpls[i]);
+	}
+
+	free(key_tpls);
 
 	return(err);
 }
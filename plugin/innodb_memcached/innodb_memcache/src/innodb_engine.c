@@ -176,6 +176,7 @@ create_instance(
 	innodb_eng->engine.release = innodb_release;
 	innodb_eng->engine.clean_engine= innodb_clean_engine;
 	innodb_eng->engine.get = innodb_get;
+	innodb_eng->engine.get_multi = innodb_get_multi;
 	innodb_eng->engine.get_stats = innodb_get_stats;
 	innodb_eng->engine.reset_stats = innodb_reset_stats;
 	innodb_eng->engine.store = innodb_store;
@@ -1225,6 +1226,138 @@ innodb_release(
 	return;
 }
 
+/*******************************************************************//**
+Allocate the item for a row fetched by a GET, and copy the value of the
+row into it. The memory allocated for the values of the row is freed.
+@return ENGINE_SUCCESS, or ENGINE_KEY_ENOENT if the row has expired */
+static
+ENGINE_ERROR_CODE
+innodb_fill_item(
+/*=============*/
+	ENGINE_HANDLE*		handle,		/*!< in: Engine Handle */
+	const void*		cookie,		/*!< in: connection cookie */
+	item**			item,		/*!< out: item to fill */
+	const void*		key,		/*!< in: search key */
+	const int		nkey,		/*!< in: key length */
+	mci_item_t*		result)		/*!< in/out: the row */
+{
+	struct innodb_engine*	innodb_eng = innodb_handle(handle);
+	hash_item*		it = NULL;
+	uint64_t		cas = 0;
+	uint64_t		exp = 0;
+	uint64_t		flags = 0;
+	int			total_len = 0;
+	meta_cfg_info_t*	meta_info = innodb_eng->meta_info;
+	int			option_length;
+	const char*		option_delimiter;
+
+	/* Only if expiration field is enabled, and the value is not zero,
+	we will check whether the item is expired */
+	if (result->col_value[MCI_COL_EXP].is_valid
+	    && result->col_value[MCI_COL_EXP].value_int) {
+		uint64_t		time;
+		time = mci_get_time();
+
+		if (time > result->col_value[MCI_COL_EXP].value_int) {
+			/* Free allocated memory. */
+			if (result->extra_col_value) {
+				for (int i = 0; i < result->n_extra_col; i++) {
+					free(result->extra_col_value[i].value_str);
+				}
+
+				free(result->extra_col_value);
+			}
+			if (result->col_value[MCI_COL_VALUE].allocated) {
+				free(result->col_value[MCI_COL_VALUE].value_str);
+				result->col_value[MCI_COL_VALUE].allocated =
+					false;
+			}
+
+			return(ENGINE_KEY_ENOENT);
+		}
+	}
+
+	if (result->col_value[MCI_COL_FLAG].is_valid) {
+		flags = ntohl(result->col_value[MCI_COL_FLAG].value_int);
+	}
+
+	if (result->col_value[MCI_COL_CAS].is_valid) {
+		cas = result->col_value[MCI_COL_CAS].value_int;
+	}
+
+	if (result->col_value[MCI_COL_EXP].is_valid) {
+		exp = result->col_value[MCI_COL_EXP].value_int;
+	}
+
+	if (result->extra_col_value) {
+		int	i;
+
+		GET_OPTION(meta_info, OPTION_ID_COL_SEP, option_delimiter,
+			   option_length);
+
+		for (i = 0; i < result->n_extra_col; i++) {
+
+			total_len += (result->extra_col_value[i].value_len
+				      + option_length);
+		}
+
+		/* No need to add the last separator */
+		total_len -= option_length;
+	} else {
+		total_len = result->col_value[MCI_COL_VALUE].value_len;
+	}
+
+	innodb_allocate(handle, cookie, item, key, nkey, total_len, flags, exp);
+
+	it = *item;
+
+	if (it->iflag & ITEM_WITH_CAS) {
+		hash_item_set_cas(it, cas);
+	}
+
+	if (result->extra_col_value) {
+		int		i;
+		char*		c_value = hash_item_get_data(it);
+		char*		value_end = c_value + total_len;
+
+		assert(option_length > 0 && option_delimiter);
+
+		for (i = 0; i < result->n_extra_col; i++) {
+
+			if (result->extra_col_value[i].value_len != 0) {
+				memcpy(c_value,
+				       result->extra_col_value[i].value_str,
+				       result->extra_col_value[i].value_len);
+
+				c_value += result->extra_col_value[i].value_len;
+			}
+
+			if (i < result->n_extra_col - 1 ) {
+				memcpy(c_value, option_delimiter, option_length);
+				c_value += option_length;
+			}
+
+			assert(c_value <= value_end);
+			free(result->extra_col_value[i].value_str);
+		}
+
+		free(result->extra_col_value);
+	} else {
+		assert(result->col_value[MCI_COL_VALUE].value_len
+		       >= (int) it->nbytes);
+
+		memcpy(hash_item_get_data(it),
+		       result->col_value[MCI_COL_VALUE].value_str, it->nbytes);
+
+		if (result->col_value[MCI_COL_VALUE].allocated) {
+			free(result->col_value[MCI_COL_VALUE].value_str);
+			result->col_value[MCI_COL_VALUE].allocated = false;
+		}
+	}
+
+	return(ENGINE_SUCCESS);
+}
+
 /*******************************************************************//**
 Support memcached "GET" command, fetch the value according to key
 @return ENGINE_SUCCESS if successfully, otherwise error code */
@@ -1242,19 +1375,12 @@ innodb_get(
 						engine only */
 {
 	struct innodb_engine*	innodb_eng = innodb_handle(handle);
-	hash_item*		it = NULL;
 	ib_crsr_t		crsr;
 	ib_err_t		err = DB_SUCCESS;
 	mci_item_t		result;
 	ENGINE_ERROR_CODE	err_ret = ENGINE_SUCCESS;
-	uint64_t		cas = 0;
-	uint64_t		exp = 0;
-	uint64_t		flags = 0;
 	innodb_conn_data_t*	conn_data;
-	int			total_len = 0;
 	meta_cfg_info_t*	meta_info = innodb_eng->meta_info;
-	int			option_length;
-	const char*		option_delimiter;
 	size_t			key_len = nkey;
 	int			lock_mode;
 	char			table_name[MAX_TABLE_NAME_LEN
@@ -1340,120 +1466,108 @@ innodb_get(
 
 search_done:
 
-	/* Only if expiration field is enabled, and the value is not zero,
-	we will check whether the item is expired */
-	if (result.col_value[MCI_COL_EXP].is_valid
-	    && result.col_value[MCI_COL_EXP].value_int) {
-		uint64_t		time;
-		time = mci_get_time();
-
-		if (time > result.col_value[MCI_COL_EXP].value_int) {
-			/* Free allocated memory. */
-			if (result.extra_col_value) {
-				for (int i = 0; i < result.n_extra_col; i++) {
-					free(result.extra_col_value[i].value_str);
-				}
+	err_ret = innodb_fill_item(handle, cookie, item, key, nkey, &result);
 
-				free(result.extra_col_value);
-			}
-			if (result.col_value[MCI_COL_VALUE].allocated) {
-				free(result.col_value[MCI_COL_VALUE].value_str);
-				result.col_value[MCI_COL_VALUE].allocated =
-					false;
-			}
+func_exit:
 
-			err_ret = ENGINE_KEY_ENOENT;
-			goto func_exit;
-		}
+	if (!report_table_switch) {
+		innodb_api_cursor_reset(innodb_eng, conn_data,
+					CONN_OP_READ, true);
 	}
 
-	if (result.col_value[MCI_COL_FLAG].is_valid) {
-		flags = ntohl(result.col_value[MCI_COL_FLAG].value_int);
-	}
+err_exit:
+	return(err_ret);
+}
 
-	if (result.col_value[MCI_COL_CAS].is_valid) {
-		cas = result.col_value[MCI_COL_CAS].value_int;
-	}
+/*******************************************************************//**
+Support memcached "GET" command with several keys, fetch the values of
+all the keys with one search that visits them in index order
+@return ENGINE_SUCCESS if successfully, otherwise error code, in which
+case the keys are fetched one by one with innodb_get() */
+static
+ENGINE_ERROR_CODE
+innodb_get_multi(
+/*=============*/
+	ENGINE_HANDLE*		handle,		/*!< in: Engine Handle */
+	const void*		cookie,		/*!< in: connection cookie */
+	item**			items,		/*!< out: items to fill, NULL
+						for keys not found */
+	const void**		keys,		/*!< in: search keys */
+	const int*		nkeys,		/*!< in: key lengths */
+	const int		count,		/*!< in: number of keys */
+	uint16_t		vbucket __attribute__((unused)))
+						/*!< in: bucket, used by default
+						engine only */
+{
+	struct innodb_engine*	innodb_eng = innodb_handle(handle);
+	meta_cfg_info_t*	meta_info = innodb_eng->meta_info;
+	innodb_conn_data_t*	conn_data;
+	mci_item_t*		results;
+	bool*			found;
+	int			lock_mode;
+	int			i;
 
-	if (result.col_value[MCI_COL_EXP].is_valid) {
-		exp = result.col_value[MCI_COL_EXP].value_int;
+	/* Keys that may be in the default engine, and keys that switch
+	the table mapping, are left to innodb_get() */
+	if (meta_info->get_option != META_CACHE_OPT_INNODB) {
+		return(ENGINE_ENOTSUP);
 	}
 
-	if (result.extra_col_value) {
-		int	i;
-
-		GET_OPTION(meta_info, OPTION_ID_COL_SEP, option_delimiter,
-			   option_length);
-
-		for (i = 0; i < result.n_extra_col; i++) {
-
-			total_len += (result.extra_col_value[i].value_len
-				      + option_length);
+	for (i = 0; i < count; i++) {
+		if (nkeys[i] > 3 && ((const char*) keys[i])[0] == '@'
+		    && ((const char*) keys[i])[1] == '@') {
+			return(ENGINE_ENOTSUP);
 		}
-
-		/* No need to add the last separator */
-		total_len -= option_length;
-	} else {
-		total_len = result.col_value[MCI_COL_VALUE].value_len;
 	}
 
-	innodb_allocate(handle, cookie, item, key, nkey, total_len, flags, exp);
-
-        it = *item;
+	results = malloc(count * sizeof(*results));
+	found = malloc(count * sizeof(*found));
 
-	if (it->iflag & ITEM_WITH_CAS) {
-		hash_item_set_cas(it, cas);
+	if (!results || !found) {
+		free(results);
+		free(found);
+		return(ENGINE_ENOMEM);
 	}
 
-	if (result.extra_col_value) {
-		int		i;
-		char*		c_value = hash_item_get_data(it);
-		char*		value_end = c_value + total_len;
-
-		assert(option_length > 0 && option_delimiter);
-
-		for (i = 0; i < result.n_extra_col; i++) {
-
-			if (result.extra_col_value[i].value_len != 0) {
-				memcpy(c_value,
-				       result.extra_col_value[i].value_str,
-				       result.extra_col_value[i].value_len);
-
-				c_value += result.extra_col_value[i].value_len;
-			}
+	lock_mode = (innodb_eng->trx_level == IB_TRX_SERIALIZABLE
+		     && innodb_eng->read_batch_size == 1)
+			? IB_LOCK_S
+			: IB_LOCK_NONE;
 
-			if (i < result.n_extra_col - 1 ) {
-				memcpy(c_value, option_delimiter, option_length);
-				c_value += option_length;
-			}
+	conn_data = innodb_conn_init(innodb_eng, cookie, CONN_MODE_READ,
+				     lock_mode, false);
 
-			assert(c_value <= value_end);
-			free(result.extra_col_value[i].value_str);
-		}
+	if (!conn_data) {
+		free(results);
+		free(found);
+		return(ENGINE_TMPFAIL);
+	}
 
-		free(result.extra_col_value);
-	} else {
-		assert(result.col_value[MCI_COL_VALUE].value_len
-		       >= (int) it->nbytes);
+	/* A failed search leaves the keys after the failure not found,
+	as innodb_get() would report them */
+	innodb_api_search_batch(conn_data, (const char**) keys, nkeys, count,
+				results, found);
 
-		memcpy(hash_item_get_data(it),
-		       result.col_value[MCI_COL_VALUE].value_str, it->nbytes);
+	for (i = 0; i < count; i++) {
+		items[i] = NULL;
 
-		if (result.col_value[MCI_COL_VALUE].allocated) {
-			free(result.col_value[MCI_COL_VALUE].value_str);
-			result.col_value[MCI_COL_VALUE].allocated = false;
+		if (found[i]) {
+			innodb_fill_item(handle, cookie, &items[i],
+					 keys[i], nkeys[i], &results[i]);
 		}
 	}
 
-func_exit:
+	free(results);
+	free(found);
 
-	if (!report_table_switch) {
-		innodb_api_cursor_reset(innodb_eng, conn_data,
-					CONN_OP_READ, true);
-	}
+	/* Count each key as one read against the read batch size, as if
+	the keys had been fetched one by one */
+	conn_data->n_total_reads += count - 1;
+	conn_data->n_reads_since_commit += count - 1;
 
-err_exit:
-	return(err_ret);
+	innodb_api_cursor_reset(innodb_eng, conn_data, CONN_OP_READ, true);
+
+	return(ENGINE_SUCCESS);
 }
 
 /*******************************************************************//**
@@ -141,6 +141,23 @@ innodb_get(
 	uint16_t	vbucket);	/*!< in: bucket, used by default
 					engine only */
 
+/*******************************************************************//**
+Support memcached "GET" command with several keys, fetch the values of
+all the keys with one search
+@return ENGINE_SUCCESS if successfully, otherwise error code */
+static
+ENGINE_ERROR_CODE
+innodb_get_multi(
+/*=============*/
+	ENGINE_HANDLE*	handle,		/*!< in: Engine Handle */
+	const void*	cookie,		/*!< in: connection cookie */
+	item**		items,		/*!< out: items to fill */
+	const void**	keys,		/*!< in: search keys */
+	const int*	nkeys,		/*!< in: key lengths */
+	const int	count,		/*!< in: number of keys */
+	uint16_t	vbucket);	/*!< in: bucket, used by default
+					engine only */
+
 /*******************************************************************//**
 Get statistics info
 @return ENGINE_SUCCESS if successfully, otherwise error code */
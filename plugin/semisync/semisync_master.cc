@@ -1185,6 +1185,40 @@ int ReplSemiSyncMaster::readSlaveReply(NET *net, uint32 server_id,
   return function_exit(kWho, result);
 }
 
+int ReplSemiSyncMaster::flushSlaveEvent(NET *net, const char *event_buf)
+{
+  const char *kWho = "ReplSemiSyncMaster::flushSlaveEvent";
+  int result = 0;
+
+  function_enter(kWho);
+
+  assert((unsigned char)event_buf[1] == kPacketMagicNum);
+  if ((unsigned char)event_buf[2] != kPacketFlagSync)
+  {
+    /* current event does not require reply */
+    goto l_end;
+  }
+
+  /* We flush to make sure that the current event is sent to the network,
+   * instead of being buffered in the TCP/IP stack.
+   */
+  if (net_flush(net))
+  {
+    sql_print_error("Semi-sync master failed on net_flush() "
+                    "before waiting for slave reply");
+    result = -1;
+    goto l_end;
+  }
+
+  /* The slave restarts the packet sequence for its reply, which the ACK
+   * receiver consumes: continue the sequence as readSlaveReply() would.
+   */
+  net_clear(net, 0);
+  net->pkt_nr++;
+
+ l_end:
+  return function_exit(kWho, result);
+}
 
 int ReplSemiSyncMaster::resetMaster()
 {
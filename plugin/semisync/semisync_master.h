@@ -589,6 +589,19 @@ class ReplSemiSyncMaster
    */
   int readSlaveReply(NET *net, uint32 server_id, const char *event_buf);
 
+  /* In semi-sync replication, flushes an event requiring a reply to the
+   * slave when the reply is read by the ACK receiver thread instead of by
+   * the binlog dump thread.
+   *
+   * Input:
+   *  net          - (IN)  the connection to the slave
+   *  event_buf    - (IN)  pointer to the event packet
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  int flushSlaveEvent(NET *net, const char *event_buf);
+
   /* In semi-sync replication, this method simulates the reception of
    * an reply and executes reportReplyBinlog directly when a transaction
    * is skipped in the master.
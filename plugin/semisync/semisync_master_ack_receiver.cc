@@ -0,0 +1,359 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "semisync_master_ack_receiver.h"
+#include "sql_class.h"                          // THD
+
+#ifdef HAVE_POLL
+#include <poll.h>
+#include <fcntl.h>
+#endif
+
+extern ReplSemiSyncMaster repl_semisync;
+
+AckReceiver ack_receiver;
+
+#ifdef HAVE_POLL
+/* Pipe used to wake the receiver up when it sleeps in poll(). */
+static int wakeup_pipe[2]= { -1, -1 };
+
+static void wakeup_receiver()
+{
+  char c= 0;
+  /* The pipe is non-blocking: if it is full, a wakeup is already pending. */
+  if (write(wakeup_pipe[1], &c, 1) < 0) {}
+}
+#endif
+
+extern "C" {
+static void *ack_receive_handler(void *arg)
+{
+  my_thread_init();
+  reinterpret_cast<AckReceiver *>(arg)->run();
+  my_thread_end();
+  pthread_exit(0);
+  return NULL;
+}
+}
+
+AckReceiver::AckReceiver()
+  : init_done_(false), status_(ST_DOWN), slaves_changed_(false)
+{
+}
+
+AckReceiver::~AckReceiver()
+{
+  if (init_done_)
+  {
+    mysql_mutex_destroy(&LOCK_ack_receiver_);
+    mysql_cond_destroy(&COND_ack_receiver_);
+  }
+}
+
+bool AckReceiver::start()
+{
+  const char *kWho = "AckReceiver::start";
+
+  function_enter(kWho);
+  trace_level_= rpl_semi_sync_master_trace_level;
+
+  /* Mutex initialization can only be done after MY_INIT(). */
+  if (!init_done_)
+  {
+    mysql_mutex_init(key_ss_mutex_LOCK_ack_receiver_,
+                     &LOCK_ack_receiver_, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_ss_cond_COND_ack_receiver_,
+                    &COND_ack_receiver_, NULL);
+    init_done_= true;
+  }
+
+#ifdef HAVE_POLL
+  if (status_ == ST_DOWN)
+  {
+    pthread_attr_t attr;
+
+    if (pipe(wakeup_pipe) ||
+        fcntl(wakeup_pipe[0], F_SETFL, O_NONBLOCK) ||
+        fcntl(wakeup_pipe[1], F_SETFL, O_NONBLOCK))
+    {
+      sql_print_error("Failed to create the pipe of the semi-sync ACK "
+                      "receiver thread (errno: %d)", errno);
+      return function_exit(kWho, true);
+    }
+
+    status_= ST_UP;
+    if (pthread_attr_init(&attr) ||
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE) ||
+        mysql_thread_create(key_ss_thread_ack_receiver_thread, &pid_,
+                            &attr, ack_receive_handler, this))
+    {
+      sql_print_error("Failed to start semi-sync ACK receiver thread, "
+                      "could not create thread(errno:%d)", errno);
+      status_= ST_DOWN;
+      close(wakeup_pipe[0]);
+      close(wakeup_pipe[1]);
+      return function_exit(kWho, true);
+    }
+    (void) pthread_attr_destroy(&attr);
+  }
+#endif
+  return function_exit(kWho, false);
+}
+
+void AckReceiver::stop()
+{
+  const char *kWho = "AckReceiver::stop";
+
+  function_enter(kWho);
+
+#ifdef HAVE_POLL
+  if (status_ != ST_DOWN)
+  {
+    mysql_mutex_lock(&LOCK_ack_receiver_);
+    status_= ST_STOPPING;
+    mysql_cond_broadcast(&COND_ack_receiver_);
+    wakeup_receiver();
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+    if (pthread_join(pid_, NULL))
+      sql_print_error("Failed to stop semi-sync ACK receiver thread on "
+                      "pthread_join, errno(%d)", errno);
+
+    status_= ST_DOWN;
+    slaves_.clear();
+    close(wakeup_pipe[0]);
+    close(wakeup_pipe[1]);
+  }
+#endif
+  function_exit(kWho, 0);
+}
+
+bool AckReceiver::addSlave(THD *thd)
+{
+  bool added= false;
+
+#ifdef HAVE_POLL
+  Vio *net_vio= thd->net.vio;
+
+  /* The replies of SSL and compressed connections can only be read
+   * through the dump thread's NET.
+   */
+  if (net_vio == NULL || net_vio->type == VIO_TYPE_SSL || thd->net.compress)
+    return false;
+
+  Slave slave;
+  slave.net_vio= net_vio;
+  slave.vio= *net_vio;
+  slave.vio.mysql_socket.m_psi= NULL;
+  slave.vio.read_timeout= 0;
+  slave.server_id= thd->server_id;
+  slave.eof= false;
+  slave.buf_len= 0;
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  if (status_ == ST_UP)
+  {
+    slaves_.push_back(slave);
+    slaves_changed_= true;
+    mysql_cond_broadcast(&COND_ack_receiver_);
+    wakeup_receiver();
+    added= true;
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+#endif
+  return added;
+}
+
+void AckReceiver::removeSlave(THD *thd)
+{
+  if (!init_done_)
+    return;
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  for (std::vector<Slave>::iterator it= slaves_.begin();
+       it != slaves_.end(); ++it)
+  {
+    if (it->net_vio == thd->net.vio)
+    {
+      slaves_.erase(it);
+      slaves_changed_= true;
+#ifdef HAVE_POLL
+      wakeup_receiver();
+#endif
+      break;
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+}
+
+bool AckReceiver::hasSlave(THD *thd)
+{
+  bool found= false;
+
+  if (!init_done_)
+    return false;
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  for (std::vector<Slave>::iterator it= slaves_.begin();
+       it != slaves_.end(); ++it)
+  {
+    if (it->net_vio == thd->net.vio)
+    {
+      found= true;
+      break;
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+  return found;
+}
+
+void AckReceiver::readReplies(Slave *slave, char *log_file_name,
+                              my_off_t *log_file_pos, uint32 *server_id)
+{
+  const char *kWho = "AckReceiver::readReplies";
+  size_t len;
+
+  len= vio_read(&slave->vio, slave->buf + slave->buf_len,
+                sizeof(slave->buf) - slave->buf_len);
+  if (len == (size_t) -1 && vio_was_timeout(&slave->vio))
+    return;
+  if (len == 0 || len == (size_t) -1)
+  {
+    /* The dump thread notices the broken connection on its next write. */
+    slave->eof= true;
+    return;
+  }
+  slave->buf_len+= len;
+
+  while (slave->buf_len >= NET_HEADER_SIZE)
+  {
+    size_t packet_len= uint3korr(slave->buf);
+    const unsigned char *packet= slave->buf + NET_HEADER_SIZE;
+
+    if (packet_len < REPLY_BINLOG_NAME_OFFSET ||
+        packet_len - REPLY_BINLOG_NAME_OFFSET >= FN_REFLEN)
+    {
+      sql_print_error("Read semi-sync reply length error "
+                      "(server_id: %u)", slave->server_id);
+      slave->eof= true;
+      return;
+    }
+    if (slave->buf_len < NET_HEADER_SIZE + packet_len)
+      break;
+
+    if (packet[REPLY_MAGIC_NUM_OFFSET] != ReplSemiSyncMaster::kPacketMagicNum)
+    {
+      sql_print_error("Read semi-sync reply magic number error "
+                      "(server_id: %u)", slave->server_id);
+      slave->eof= true;
+      return;
+    }
+
+    char name[FN_REFLEN];
+    size_t name_len= packet_len - REPLY_BINLOG_NAME_OFFSET;
+    my_off_t pos= uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
+    memcpy(name, packet + REPLY_BINLOG_NAME_OFFSET, name_len);
+    name[name_len]= 0;
+
+    if (trace_level_ & kTraceDetail)
+      sql_print_information("%s: Got reply (%s, %lu) from server %u",
+                            kWho, name, (ulong) pos, slave->server_id);
+
+    if (!log_file_name[0] ||
+        ActiveTranx::compare(name, pos, log_file_name, *log_file_pos) > 0)
+    {
+      strcpy(log_file_name, name);
+      *log_file_pos= pos;
+      *server_id= slave->server_id;
+    }
+
+    slave->buf_len-= NET_HEADER_SIZE + packet_len;
+    memmove(slave->buf, packet + packet_len, slave->buf_len);
+  }
+}
+
+void AckReceiver::run()
+{
+#ifdef HAVE_POLL
+  std::vector<struct pollfd> fds;
+  char log_file_name[FN_REFLEN];
+  my_off_t log_file_pos= 0;
+  uint32 server_id= 0;
+
+  sql_print_information("Starting ack receiver thread");
+
+  mysql_mutex_lock(&LOCK_ack_receiver_);
+  slaves_changed_= true;
+  while (status_ == ST_UP)
+  {
+    if (slaves_changed_)
+    {
+      if (slaves_.empty())
+      {
+        mysql_cond_wait(&COND_ack_receiver_, &LOCK_ack_receiver_);
+        continue;
+      }
+
+      /* Slot 0 is the wakeup pipe, slot i + 1 is slaves_[i]. */
+      fds.resize(slaves_.size() + 1);
+      fds[0].fd= wakeup_pipe[0];
+      fds[0].events= POLLIN;
+      for (size_t i= 0; i < slaves_.size(); i++)
+      {
+        fds[i + 1].fd= slaves_[i].eof ? -1 : vio_fd(&slaves_[i].vio);
+        fds[i + 1].events= POLLIN;
+      }
+      slaves_changed_= false;
+    }
+    mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+    int ret= poll(&fds[0], fds.size(), -1);
+
+    mysql_mutex_lock(&LOCK_ack_receiver_);
+    if (ret <= 0)
+      continue;
+
+    if (fds[0].revents)
+    {
+      char buf[64];
+      while (read(wakeup_pipe[0], buf, sizeof(buf)) > 0) {}
+    }
+
+    /* The slots no longer match slaves_, poll again with the new list. */
+    if (slaves_changed_)
+      continue;
+
+    log_file_name[0]= 0;
+    for (size_t i= 0; i < slaves_.size(); i++)
+    {
+      if (!fds[i + 1].revents)
+        continue;
+      readReplies(&slaves_[i], log_file_name, &log_file_pos, &server_id);
+      if (slaves_[i].eof)
+        slaves_changed_= true;
+    }
+
+    if (log_file_name[0])
+    {
+      mysql_mutex_unlock(&LOCK_ack_receiver_);
+      repl_semisync.reportReplyBinlog(server_id, log_file_name, log_file_pos);
+      mysql_mutex_lock(&LOCK_ack_receiver_);
+    }
+  }
+  mysql_mutex_unlock(&LOCK_ack_receiver_);
+
+  sql_print_information("Stopping ack receiver thread");
+#endif
+}
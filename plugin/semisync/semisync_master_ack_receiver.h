@@ -0,0 +1,104 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef SEMISYNC_MASTER_ACK_RECEIVER_H
+#define SEMISYNC_MASTER_ACK_RECEIVER_H
+
+#include "semisync_master.h"
+#include <violite.h>
+#include <vector>
+
+#ifdef HAVE_PSI_INTERFACE
+extern PSI_mutex_key key_ss_mutex_LOCK_ack_receiver_;
+extern PSI_cond_key key_ss_cond_COND_ack_receiver_;
+extern PSI_thread_key key_ss_thread_ack_receiver_thread;
+#endif
+
+/**
+  @class AckReceiver
+
+  A single thread which polls the sockets of all semi-sync slaves and reads
+  their replies, so that binlog dump threads only have to send events.
+
+  A dump thread registers its slave with addSlave() when the dump starts and
+  unregisters it with removeSlave() before the connection goes away.  Slaves
+  which cannot be handled here (SSL or compressed connections, or platforms
+  without poll()) are not registered, and their dump threads keep reading
+  the replies themselves through ReplSemiSyncMaster::readSlaveReply().
+
+  All replies read in one poll round are folded into the largest position
+  and reported with a single ReplSemiSyncMaster::reportReplyBinlog() call,
+  so committers waiting in commitTrx() up to that position are woken
+  together by one broadcast.
+*/
+class AckReceiver : public ReplSemiSyncBase
+{
+public:
+  AckReceiver();
+  ~AckReceiver();
+
+  /* Start the receiver thread. Returns true on error. */
+  bool start();
+
+  /* Stop the receiver thread and wait for it to exit. */
+  void stop();
+
+  /* Start listening to the slave served by thd.  Returns true if the
+   * receiver reads the replies of this slave from now on.
+   */
+  bool addSlave(THD *thd);
+
+  /* Stop listening to the slave served by thd. */
+  void removeSlave(THD *thd);
+
+  /* Whether the replies of the slave served by thd are read here. */
+  bool hasSlave(THD *thd);
+
+  /* The body of the receiver thread. */
+  void run();
+
+private:
+  enum status {ST_UP, ST_DOWN, ST_STOPPING};
+
+  struct Slave
+  {
+    /* The dump thread's Vio, used as the key of the slave. */
+    Vio *net_vio;
+    /* A private copy which never blocks on reads. */
+    Vio vio;
+    uint32 server_id;
+    bool eof;
+    size_t buf_len;
+    unsigned char buf[NET_HEADER_SIZE + REPLY_BINLOG_NAME_OFFSET + FN_REFLEN];
+  };
+
+  /* Read what is available from a slave and parse the complete replies. */
+  void readReplies(Slave *slave, char *log_file_name, my_off_t *log_file_pos,
+                   uint32 *server_id);
+
+  bool init_done_;
+  mysql_mutex_t LOCK_ack_receiver_;
+  mysql_cond_t COND_ack_receiver_;
+
+  status status_;
+  /* Set whenever a slave is added or removed, under LOCK_ack_receiver_. */
+  bool slaves_changed_;
+  std::vector<Slave> slaves_;
+  pthread_t pid_;
+};
+
+extern AckReceiver ack_receiver;
+
+#endif /* SEMISYNC_MASTER_ACK_RECEIVER_H */
@@ -17,6 +17,7 @@
 
 
 #include "semisync_master.h"
+#include "semisync_master_ack_receiver.h"
 #include "sql_class.h"                          // THD
 
 ReplSemiSyncMaster repl_semisync;
@@ -94,6 +95,9 @@ int repl_semi_binlog_dump_start(Binlog_transmit_param *param,
   {
     /* One more semi-sync slave */
     repl_semisync.add_slave();
+
+    /* Let the ACK receiver read the replies of this slave if it can. */
+    ack_receiver.addSlave(current_thd);
     
     /*
       Let's assume this semi-sync slave has already received all
@@ -118,6 +122,7 @@ int repl_semi_binlog_dump_end(Binlog_transmit_param *param)
   if (semi_sync_slave)
   {
     /* One less semi-sync slave */
+    ack_receiver.removeSlave(current_thd);
     repl_semisync.remove_slave();
   }
   return 0;
@@ -151,6 +156,12 @@ int repl_semi_after_send_event(Binlog_transmit_param *param,
     if(skipped_log_pos>0)
       repl_semisync.skipSlaveReply(event_buf, param->server_id,
                                    skipped_log_file, skipped_log_pos);
+    else if ((unsigned char)event_buf[2] == ReplSemiSyncMaster::kPacketFlagSync &&
+             ack_receiver.hasSlave(current_thd))
+    {
+      /* The reply is read by the ACK receiver thread. */
+      (void) repl_semisync.flushSlaveEvent(&current_thd->net, event_buf);
+    }
     else
     {
       THD *thd= current_thd;
@@ -273,6 +284,7 @@ static void fix_rpl_semi_sync_master_trace_level(MYSQL_THD thd,
 {
   *(unsigned long *)ptr= *(unsigned long *)val;
   repl_semisync.setTraceLevel(rpl_semi_sync_master_trace_level);
+  ack_receiver.trace_level_= rpl_semi_sync_master_trace_level;
   return;
 }
 
@@ -394,17 +406,28 @@ static SHOW_VAR semi_sync_master_status_vars[]= {
 
 #ifdef HAVE_PSI_INTERFACE
 PSI_mutex_key key_ss_mutex_LOCK_binlog_;
+PSI_mutex_key key_ss_mutex_LOCK_ack_receiver_;
 
 static PSI_mutex_info all_semisync_mutexes[]=
 {
-  { &key_ss_mutex_LOCK_binlog_, "LOCK_binlog_", 0}
+  { &key_ss_mutex_LOCK_binlog_, "LOCK_binlog_", 0},
+  { &key_ss_mutex_LOCK_ack_receiver_, "LOCK_ack_receiver_", 0}
 };
 
 PSI_cond_key key_ss_cond_COND_binlog_send_;
+PSI_cond_key key_ss_cond_COND_ack_receiver_;
 
 static PSI_cond_info all_semisync_conds[]=
 {
-  { &key_ss_cond_COND_binlog_send_, "COND_binlog_send_", 0}
+  { &key_ss_cond_COND_binlog_send_, "COND_binlog_send_", 0},
+  { &key_ss_cond_COND_ack_receiver_, "COND_ack_receiver_", 0}
+};
+
+PSI_thread_key key_ss_thread_ack_receiver_thread;
+
+static PSI_thread_info all_semisync_threads[]=
+{
+  { &key_ss_thread_ack_receiver_thread, "Ack_receiver", PSI_FLAG_GLOBAL}
 };
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -435,6 +458,9 @@ static void init_semisync_psi_keys(void)
   count= array_elements(all_semisync_conds);
   mysql_cond_register(category, all_semisync_conds, count);
 
+  count= array_elements(all_semisync_threads);
+  mysql_thread_register(category, all_semisync_threads, count);
+
   count= array_elements(all_semisync_stages);
   mysql_stage_register(category, all_semisync_stages, count);
 
@@ -451,6 +477,8 @@ static int semi_sync_master_plugin_init(void *p)
 
   if (repl_semisync.initObject())
     return 1;
+  if (ack_receiver.start())
+    return 1;
   if (register_trans_observer(&trans_observer, p))
     return 1;
   if (register_binlog_storage_observer(&storage_observer, p))
@@ -477,6 +505,7 @@ static int semi_sync_master_plugin_deinit(void *p)
     sql_print_error("unregister_binlog_transmit_observer failed");
     return 1;
   }
+  ack_receiver.stop();
   sql_print_information("unregister_replicator OK");
   return 0;
 }
@@ -116,6 +116,21 @@ SET @create_innodb_index_stats="CREATE TABLE IF NOT EXISTS innodb_index_stats (
 	PRIMARY KEY (database_name, table_name, index_name, stat_name)
 ) ENGINE=INNODB DEFAULT CHARSET=utf8 COLLATE=utf8_bin STATS_PERSISTENT=0";
 
+SET @create_innodb_column_stats="CREATE TABLE IF NOT EXISTS innodb_column_stats (
+	database_name			VARCHAR(64) NOT NULL,
+	table_name			VARCHAR(64) NOT NULL,
+	column_name			VARCHAR(64) NOT NULL,
+	bucket_no			BIGINT UNSIGNED NOT NULL,
+	last_update			TIMESTAMP NOT NULL NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+	/* the largest value of the bucket */
+	endpoint			VARBINARY(767) NOT NULL,
+	n_rows				BIGINT UNSIGNED NOT NULL,
+	n_endpoint_rows			BIGINT UNSIGNED NOT NULL,
+	n_distinct			BIGINT UNSIGNED NOT NULL,
+	sample_size			BIGINT UNSIGNED NOT NULL,
+	PRIMARY KEY (database_name, table_name, column_name, bucket_no)
+) ENGINE=INNODB DEFAULT CHARSET=utf8 COLLATE=utf8_bin STATS_PERSISTENT=0";
+
 set @have_innodb= (select count(engine) from information_schema.engines where engine='INNODB' and support != 'NO');
 
 SET @str=IF(@have_innodb <> 0, @create_innodb_table_stats, "SET @dummy = 0");
@@ -128,6 +143,11 @@ PREPARE stmt FROM @str;
 EXECUTE stmt;
 DROP PREPARE stmt;
 
+SET @str=IF(@have_innodb <> 0, @create_innodb_column_stats, "SET @dummy = 0");
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
 SET SESSION sql_mode=@sql_mode_orig;
 
 SET @cmd="CREATE TABLE IF NOT EXISTS slave_relay_log_info (
@@ -805,7 +825,8 @@ DROP PREPARE stmt;
 SET @cmd="CREATE TABLE performance_schema.setup_instruments("
   "NAME VARCHAR(128) not null,"
   "ENABLED ENUM ('YES', 'NO') not null,"
-  "TIMED ENUM ('YES', 'NO') not null"
+  "TIMED ENUM ('YES', 'NO') not null,"
+  "SAMPLE_RATE INTEGER unsigned not null default 1"
   ")ENGINE=PERFORMANCE_SCHEMA;";
 
 SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
@@ -1065,7 +1086,11 @@ SET @cmd="CREATE TABLE performance_schema.events_stages_current("
   "TIMER_END BIGINT unsigned,"
   "TIMER_WAIT BIGINT unsigned,"
   "NESTING_EVENT_ID BIGINT unsigned,"
-  "NESTING_EVENT_TYPE ENUM('STATEMENT', 'STAGE', 'WAIT')"
+  "NESTING_EVENT_TYPE ENUM('STATEMENT', 'STAGE', 'WAIT'),"
+  "CYCLES BIGINT unsigned,"
+  "INSTRUCTIONS BIGINT unsigned,"
+  "LLC_MISSES BIGINT unsigned,"
+  "BRANCH_MISSES BIGINT unsigned"
   ")ENGINE=PERFORMANCE_SCHEMA;";
 
 SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
@@ -1087,7 +1112,11 @@ SET @cmd="CREATE TABLE performance_schema.events_stages_history("
   "TIMER_END BIGINT unsigned,"
   "TIMER_WAIT BIGINT unsigned,"
   "NESTING_EVENT_ID BIGINT unsigned,"
-  "NESTING_EVENT_TYPE ENUM('STATEMENT', 'STAGE', 'WAIT')"
+  "NESTING_EVENT_TYPE ENUM('STATEMENT', 'STAGE', 'WAIT'),"
+  "CYCLES BIGINT unsigned,"
+  "INSTRUCTIONS BIGINT unsigned,"
+  "LLC_MISSES BIGINT unsigned,"
+  "BRANCH_MISSES BIGINT unsigned"
   ")ENGINE=PERFORMANCE_SCHEMA;";
 
 SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
@@ -1109,7 +1138,11 @@ SET @cmd="CREATE TABLE performance_schema.events_stages_history_long("
   "TIMER_END BIGINT unsigned,"
   "TIMER_WAIT BIGINT unsigned,"
   "NESTING_EVENT_ID BIGINT unsigned,"
-  "NESTING_EVENT_TYPE ENUM('STATEMENT', 'STAGE', 'WAIT')"
+  "NESTING_EVENT_TYPE ENUM('STATEMENT', 'STAGE', 'WAIT'),"
+  "CYCLES BIGINT unsigned,"
+  "INSTRUCTIONS BIGINT unsigned,"
+  "LLC_MISSES BIGINT unsigned,"
+  "BRANCH_MISSES BIGINT unsigned"
   ")ENGINE=PERFORMANCE_SCHEMA;";
 
 SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
@@ -1951,6 +1984,72 @@ PREPARE stmt FROM @str;
 EXECUTE stmt;
 DROP PREPARE stmt;
 
+--
+-- TABLE EVENTS_STATEMENTS_QUANTILES_BY_DIGEST
+--
+
+SET @cmd="CREATE TABLE performance_schema.events_statements_quantiles_by_digest("
+  "SCHEMA_NAME VARCHAR(64),"
+  "DIGEST VARCHAR(32),"
+  "COUNT_STAR BIGINT unsigned not null,"
+  "QUANTILE_50 BIGINT unsigned not null,"
+  "QUANTILE_95 BIGINT unsigned not null,"
+  "QUANTILE_99 BIGINT unsigned not null,"
+  "QUANTILE_999 BIGINT unsigned not null"
+  ")ENGINE=PERFORMANCE_SCHEMA;";
+
+SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
+--
+-- TABLE EVENTS_STATEMENTS_QUANTILES_GLOBAL_BY_EVENT_NAME
+--
+
+SET @cmd="CREATE TABLE performance_schema.events_statements_quantiles_global_by_event_name("
+  "EVENT_NAME VARCHAR(128) not null,"
+  "COUNT_STAR BIGINT unsigned not null,"
+  "QUANTILE_50 BIGINT unsigned not null,"
+  "QUANTILE_95 BIGINT unsigned not null,"
+  "QUANTILE_99 BIGINT unsigned not null,"
+  "QUANTILE_999 BIGINT unsigned not null"
+  ")ENGINE=PERFORMANCE_SCHEMA;";
+
+SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
+--
+-- TABLE EVENTS_CPU_SAMPLES_SUMMARY_BY_DIGEST
+--
+
+SET @cmd="CREATE TABLE performance_schema.events_cpu_samples_summary_by_digest("
+  "SCHEMA_NAME VARCHAR(64),"
+  "DIGEST VARCHAR(32),"
+  "COUNT_SAMPLES BIGINT unsigned not null"
+  ")ENGINE=PERFORMANCE_SCHEMA;";
+
+SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
+--
+-- TABLE EVENTS_CPU_SAMPLES_SUMMARY_GLOBAL_BY_EVENT_NAME
+--
+
+SET @cmd="CREATE TABLE performance_schema.events_cpu_samples_summary_global_by_event_name("
+  "EVENT_NAME VARCHAR(128) not null,"
+  "COUNT_SAMPLES BIGINT unsigned not null"
+  ")ENGINE=PERFORMANCE_SCHEMA;";
+
+SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
 CREATE TABLE IF NOT EXISTS proxies_priv (Host char(60) binary DEFAULT '' NOT NULL, User char(16) binary DEFAULT '' NOT NULL, Proxied_host char(60) binary DEFAULT '' NOT NULL, Proxied_user char(16) binary DEFAULT '' NOT NULL, With_grant BOOL DEFAULT 0 NOT NULL, Grantor char(77) DEFAULT '' NOT NULL, Timestamp timestamp NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP, PRIMARY KEY Host (Host,User,Proxied_host,Proxied_user), KEY Grantor (Grantor) ) engine=MyISAM CHARACTER SET utf8 COLLATE utf8_bin comment='User proxy privileges';
 
 -- Remember for later if proxies_priv table already existed
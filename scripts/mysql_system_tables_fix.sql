@@ -663,6 +663,7 @@ ALTER TABLE slave_worker_info STATS_PERSISTENT=0;
 ALTER TABLE slave_relay_log_info STATS_PERSISTENT=0;
 ALTER TABLE innodb_table_stats STATS_PERSISTENT=0;
 ALTER TABLE innodb_index_stats STATS_PERSISTENT=0;
+ALTER TABLE innodb_column_stats STATS_PERSISTENT=0;
 
 --
 -- Check for accounts with old pre-4.1 passwords and issue a warning
@@ -72,7 +72,9 @@ Usage: $0 [OPTIONS]
   --open-files-limit=LIMIT   Limit the number of open files
   --core-file-size=LIMIT     Limit core files to the specified size
   --timezone=TZ              Set the system timezone
-  --malloc-lib=LIB           Preload shared library LIB if available
+  --malloc-lib=LIB           Preload shared library LIB if available,
+                             LIB may be 'tcmalloc' or 'jemalloc' to search
+                             the system library directories
   --mysqld=FILE              Use the specified file as mysqld
   --mysqld-version=VERSION   Use "mysqld-VERSION" as mysqld
   --nice=NICE                Set the scheduling priority of mysqld
@@ -315,8 +317,10 @@ get_mysql_config() {
 
 # set_malloc_lib LIB
 # - If LIB is empty, do nothing and return
-# - If LIB is 'tcmalloc', look for tcmalloc shared library in /usr/lib
-#   then pkglibdir.  tcmalloc is part of the Google perftools project.
+# - If LIB is 'tcmalloc', look for tcmalloc shared library in the system
+#   library directories then pkglibdir.  tcmalloc is part of the Google
+#   perftools project.
+# - If LIB is 'jemalloc', look for jemalloc shared library the same way
 # - If LIB is an absolute path, assume it is a malloc shared library
 #
 # Put LIB in mysqld_ld_preload, which will be added to LD_PRELOAD when
@@ -324,23 +328,31 @@ get_mysql_config() {
 set_malloc_lib() {
   malloc_lib="$1"
 
-  if [ "$malloc_lib" = tcmalloc ]; then
+  if [ "$malloc_lib" = tcmalloc -o "$malloc_lib" = jemalloc ]; then
+    malloc_name="$malloc_lib"
     pkglibdir=`get_mysql_config --variable=pkglibdir`
     malloc_lib=
     # This list is kept intentionally simple.  Simply set --malloc-lib
     # to a full path if another location is desired.
-    for libdir in /usr/lib "$pkglibdir" "$pkglibdir/mysql"; do
+    for libdir in /usr/lib64 /usr/lib /usr/lib/`uname -m`-linux-gnu \
+                  "$pkglibdir" "$pkglibdir/mysql"; do
       for flavor in _minimal '' _and_profiler _debug; do
-        tmp="$libdir/libtcmalloc$flavor.so"
-        #log_notice "DEBUG: Checking for malloc lib '$tmp'"
-        [ -r "$tmp" ] || continue
-        malloc_lib="$tmp"
-        break 2
+        # Only tcmalloc comes in flavors
+        [ "$malloc_name" = tcmalloc -o -z "$flavor" ] || continue
+        for tmp in "$libdir/lib$malloc_name$flavor.so" \
+                   "$libdir/lib$malloc_name$flavor.so.1" \
+                   "$libdir/lib$malloc_name$flavor.so.2" \
+                   "$libdir/lib$malloc_name$flavor.so.4"; do
+          #log_notice "DEBUG: Checking for malloc lib '$tmp'"
+          [ -r "$tmp" ] || continue
+          malloc_lib="$tmp"
+          break 3
+        done
       done
     done
 
     if [ -z "$malloc_lib" ]; then
-      log_error "no shared library for --malloc-lib=tcmalloc found in /usr/lib or $pkglibdir"
+      log_error "no shared library for --malloc-lib=$malloc_name found in /usr/lib or $pkglibdir"
       exit 1
     fi
   fi
@@ -356,7 +368,8 @@ set_malloc_lib() {
       fi
       ;;
     *)
-      log_error "--malloc-lib must be an absolute path or 'tcmalloc'; " \
+      log_error "--malloc-lib must be an absolute path, 'tcmalloc' or" \
+        "'jemalloc'; " \
         "ignoring value '$malloc_lib'"
       exit 1
       ;;
@@ -158,6 +158,11 @@ const char 	*def_shared_memory_base_name= default_shared_memory_base_name;
 static void mysql_close_free_options(MYSQL *mysql);
 static void mysql_close_free(MYSQL *mysql);
 static void mysql_prune_stmt_list(MYSQL *mysql);
+static ulong cli_safe_read_complete(MYSQL *mysql, ulong len);
+static void async_free(struct st_mysql_async *async);
+static void pipeline_free(struct st_mysql_pipeline *pipeline);
+static void pipeline_reset(MYSQL *mysql);
+static my_bool pipeline_busy(MYSQL *mysql);
 
 CHARSET_INFO *default_client_charset_info = &my_charset_latin1;
 
@@ -666,6 +671,26 @@ cli_safe_read(MYSQL *mysql)
   if (net->vio != 0)
     len=my_net_read(net);
 
+  return cli_safe_read_complete(mysql, len);
+}
+
+
+/**
+  Check a packet read from the server, the second half of cli_safe_read()
+  for readers of packets other than my_net_read().
+
+  @param  mysql  connection handle
+  @param  len    length of the packet in net->read_pos, or packet_error
+
+  @return  len, or packet_error if the read failed or the packet is an
+           error message
+*/
+
+static ulong
+cli_safe_read_complete(MYSQL *mysql, ulong len)
+{
+  NET *net= &mysql->net;
+
   if (len == packet_error || len == 0)
   {
     DBUG_PRINT("error",("Wrong connection or packet. fd: %s  len: %lu",
@@ -742,6 +767,12 @@ void free_rows(MYSQL_DATA *cur)
 {
   if (cur)
   {
+    struct st_mysql_compact_rows *compact= cur->extension;
+    if (compact)
+    {
+      my_free(compact->rows);
+      my_free(compact->row_buffer);
+    }
     free_root(&cur->alloc,MYF(0));
     my_free(cur);
   }
@@ -764,7 +795,8 @@ cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
       DBUG_RETURN(1);
   }
   if (mysql->status != MYSQL_STATUS_READY ||
-      mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS ||
+      (command != COM_QUIT && pipeline_busy(mysql)))
   {
     DBUG_PRINT("error",("state: %d", mysql->status));
     set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
@@ -1117,6 +1149,18 @@ void end_server(MYSQL *mysql)
     DBUG_PRINT("info",("Net: %s", vio_description(mysql->net.vio)));
 #ifdef MYSQL_SERVER
     slave_io_thread_detach_vio();
+#endif
+#if defined(HAVE_OPENSSL) && !defined(HAVE_YASSL) && !defined(EMBEDDED_LIBRARY)
+    /* Keep the SSL session, for mysql_reconnect() to resume it. */
+    if (mysql->reconnect && mysql->net.vio->ssl_arg)
+    {
+      struct st_mysql_extension *ext= MYSQL_EXTENSION(mysql);
+      if (ext)
+      {
+        mysql_free_ssl_session(ext->ssl_session);
+        ext->ssl_session= mysql_get_ssl_session(mysql);
+      }
+    }
 #endif
     vio_delete(mysql->net.vio);
     mysql->net.vio= 0;          /* Marker */
@@ -1124,6 +1168,7 @@ void end_server(MYSQL *mysql)
   }
   net_end(&mysql->net);
   free_old_query(mysql);
+  pipeline_reset(mysql);
   errno= save_errno;
   MYSQL_TRACE(DISCONNECTED, mysql, ());
   DBUG_VOID_RETURN;
@@ -1174,6 +1219,7 @@ static const char *default_options[]=
   "multi-results", "multi-statements", "multi-queries", "secure-auth",
   "report-data-truncation", "plugin-dir", "default-auth",
   "bind-address", "ssl-crl", "ssl-crlpath", "enable-cleartext-plugin",
+  "compression-level",
   NullS
 };
 enum option_id {
@@ -1186,6 +1232,7 @@ enum option_id {
   OPT_multi_results, OPT_multi_statements, OPT_multi_queries, OPT_secure_auth, 
   OPT_report_data_truncation, OPT_plugin_dir, OPT_default_auth,
   OPT_bind_address, OPT_ssl_crl, OPT_ssl_crlpath, OPT_enable_cleartext_plugin,
+  OPT_compression_level,
   OPT_keep_this_one_last
 };
 
@@ -1497,6 +1544,13 @@ void mysql_read_default_options(struct st_mysql_options *options,
           options->extension->enable_cleartext_plugin= 
             (!opt_arg || atoi(opt_arg) != 0) ? TRUE : FALSE;
           break;
+        case OPT_compression_level:
+          if (opt_arg)
+          {
+            ENSURE_EXTENSIONS_PRESENT(options);
+            options->extension->compression_level= atoi(opt_arg);
+          }
+          break;
 
 	default:
 	  DBUG_PRINT("warning",("unknown option: %s",option[0]));
@@ -1656,95 +1710,104 @@ unpack_fields(MYSQL *mysql, MYSQL_DATA *data,MEM_ROOT *alloc,uint fields,
   DBUG_RETURN(result);
 }
 
-/* Read all rows (fields or data) from server */
+/*
+  The last EOF packet is either a single 254 character or (in MySQL 4.1)
+  254 followed by 1-7 status bytes.
 
-MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
-			  unsigned int fields)
+  This doesn't conflict with normal usage of 254 which stands for a
+  string where the length of the string is 8 bytes. (see net_field_length())
+*/
+
+#define is_rows_eof_packet(pos, pkt_len) ((pos)[0] == 254 && (pkt_len) < 8)
+
+
+static MYSQL_DATA *alloc_rows(MYSQL *mysql, unsigned int fields)
 {
-  uint	field;
-  ulong pkt_len;
-  ulong len;
-  uchar *cp;
-  char	*to, *end_to;
   MYSQL_DATA *result;
-  MYSQL_ROWS **prev_ptr,*cur;
-  NET *net = &mysql->net;
-  DBUG_ENTER("cli_read_rows");
 
-  if ((pkt_len= cli_safe_read(mysql)) == packet_error)
-    DBUG_RETURN(0);
   if (!(result=(MYSQL_DATA*) my_malloc(key_memory_MYSQL_DATA,
                                        sizeof(MYSQL_DATA),
 				       MYF(MY_WME | MY_ZEROFILL))))
   {
     set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
-    DBUG_RETURN(0);
+    return 0;
   }
   init_alloc_root(PSI_NOT_INSTRUMENTED,
                   &result->alloc, 8192, 0); /* Assume rowlength < 8192 */
   result->alloc.min_malloc=sizeof(MYSQL_ROWS);
-  prev_ptr= &result->data;
   result->rows=0;
   result->fields=fields;
+  return result;
+}
 
-  /*
-    The last EOF packet is either a single 254 character or (in MySQL 4.1)
-    254 followed by 1-7 status bytes.
 
-    This doesn't conflict with normal usage of 254 which stands for a
-    string where the length of the string is 8 bytes. (see net_field_length())
-  */
+/*
+  Append the row in the packet of net->read_pos to rows read by
+  cli_read_rows(). *prev_ptr is the link to set to the new row.
+
+  Returns 1, with the error set, if the row cannot be stored.
+*/
+
+static my_bool add_row(MYSQL *mysql, MYSQL_DATA *result,
+                       MYSQL_ROWS ***prev_ptr, MYSQL_FIELD *mysql_fields,
+                       ulong pkt_len)
+{
+  uint	field;
+  uint  fields= result->fields;
+  ulong len;
+  uchar *cp= mysql->net.read_pos;
+  char	*to, *end_to;
+  MYSQL_ROWS *cur;
 
-  while (*(cp=net->read_pos) != 254 || pkt_len >= 8)
+  result->rows++;
+  if (!(cur= (MYSQL_ROWS*) alloc_root(&result->alloc,
+                                      sizeof(MYSQL_ROWS))) ||
+      !(cur->data= ((MYSQL_ROW)
+                    alloc_root(&result->alloc,
+                               (fields+1)*sizeof(char *)+pkt_len))))
   {
-    result->rows++;
-    if (!(cur= (MYSQL_ROWS*) alloc_root(&result->alloc,
-					sizeof(MYSQL_ROWS))) ||
-	!(cur->data= ((MYSQL_ROW)
-		      alloc_root(&result->alloc,
-				 (fields+1)*sizeof(char *)+pkt_len))))
-    {
-      free_rows(result);
-      set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
-      DBUG_RETURN(0);
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    return 1;
+  }
+  **prev_ptr=cur;
+  *prev_ptr= &cur->next;
+  to= (char*) (cur->data+fields+1);
+  end_to=to+pkt_len-1;
+  for (field=0 ; field < fields ; field++)
+  {
+    if ((len=(ulong) net_field_length(&cp)) == NULL_LENGTH)
+    {						/* null field */
+      cur->data[field] = 0;
     }
-    *prev_ptr=cur;
-    prev_ptr= &cur->next;
-    to= (char*) (cur->data+fields+1);
-    end_to=to+pkt_len-1;
-    for (field=0 ; field < fields ; field++)
+    else
     {
-      if ((len=(ulong) net_field_length(&cp)) == NULL_LENGTH)
-      {						/* null field */
-	cur->data[field] = 0;
+      cur->data[field] = to;
+      if (len > (ulong) (end_to - to))
+      {
+        set_mysql_error(mysql, CR_MALFORMED_PACKET, unknown_sqlstate);
+        return 1;
       }
-      else
+      memcpy(to,(char*) cp,len); to[len]=0;
+      to+=len+1;
+      cp+=len;
+      if (mysql_fields)
       {
-	cur->data[field] = to;
-        if (len > (ulong) (end_to - to))
-        {
-          free_rows(result);
-          set_mysql_error(mysql, CR_MALFORMED_PACKET, unknown_sqlstate);
-          DBUG_RETURN(0);
-        }
-	memcpy(to,(char*) cp,len); to[len]=0;
-	to+=len+1;
-	cp+=len;
-	if (mysql_fields)
-	{
-	  if (mysql_fields[field].max_length < len)
-	    mysql_fields[field].max_length=len;
-	}
+        if (mysql_fields[field].max_length < len)
+          mysql_fields[field].max_length=len;
       }
     }
-    cur->data[field]=to;			/* End of last field */
-    if ((pkt_len=cli_safe_read(mysql)) == packet_error)
-    {
-      free_rows(result);
-      DBUG_RETURN(0);
-    }
   }
-  *prev_ptr=0;					/* last pointer is null */
+  cur->data[field]=to;			/* End of last field */
+  return 0;
+}
+
+
+/* Read the status of the EOF packet in net->read_pos that ends rows */
+
+static void read_rows_eof(MYSQL *mysql, ulong pkt_len)
+{
+  uchar *cp= mysql->net.read_pos;
+
   if (pkt_len > 1)				/* MySQL 4.1 protocol */
   {
     mysql->warning_count= uint2korr(cp+1);
@@ -1758,39 +1821,216 @@ MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
   else
     MYSQL_TRACE_STAGE(mysql, READY_FOR_COMMAND);
 #endif
+}
+
+
+/* Read all rows (fields or data) from server */
+
+MYSQL_DATA *cli_read_rows(MYSQL *mysql,MYSQL_FIELD *mysql_fields,
+			  unsigned int fields)
+{
+  ulong pkt_len;
+  MYSQL_DATA *result;
+  MYSQL_ROWS **prev_ptr;
+  NET *net = &mysql->net;
+  DBUG_ENTER("cli_read_rows");
+
+  if ((pkt_len= cli_safe_read(mysql)) == packet_error)
+    DBUG_RETURN(0);
+  if (!(result= alloc_rows(mysql, fields)))
+    DBUG_RETURN(0);
+  prev_ptr= &result->data;
+
+  while (!is_rows_eof_packet(net->read_pos, pkt_len))
+  {
+    if (add_row(mysql, result, &prev_ptr, mysql_fields, pkt_len) ||
+        (pkt_len=cli_safe_read(mysql)) == packet_error)
+    {
+      free_rows(result);
+      DBUG_RETURN(0);
+    }
+  }
+  *prev_ptr=0;					/* last pointer is null */
+  read_rows_eof(mysql, pkt_len);
   DBUG_PRINT("exit", ("Got %lu rows", (ulong) result->rows));
   DBUG_RETURN(result);
 }
 
+
+#define COMPACT_ROWS_MIN_BLOCK (8*1024)
+#define COMPACT_ROWS_MAX_BLOCK (1024*1024)
+
 /*
-  Read one row. Uses packet buffer as storage for fields.
-  When next packet is read, the previous field values are destroyed
+  Append the row in the packet of net->read_pos to rows read by
+  read_compact_rows(). The packet is checked here, so that the row
+  can later be unpacked without checks.
+
+  Returns 1, with the error set, if the row cannot be stored.
+*/
+
+static my_bool add_compact_row(MYSQL *mysql, MYSQL_DATA *result,
+                               MYSQL_FIELD *mysql_fields, ulong pkt_len)
+{
+  struct st_mysql_compact_rows *compact= result->extension;
+  uchar *cp= mysql->net.read_pos, *end= cp + pkt_len;
+  uint field;
+  ulong len;
+
+  for (field= 0; field < result->fields; field++)
+  {
+    if (cp >= end)
+      goto malformed;
+    if ((len= (ulong) net_field_length(&cp)) == NULL_LENGTH)
+      continue;
+    if (len > (ulong) (end - cp))
+      goto malformed;
+    cp+= len;
+    if (mysql_fields && mysql_fields[field].max_length < len)
+      mysql_fields[field].max_length= len;
+  }
+
+  if (result->rows == compact->capacity)
+  {
+    my_ulonglong capacity= compact->capacity ? compact->capacity * 2 : 1024;
+    uchar **rows= (uchar**) my_realloc(key_memory_MYSQL_DATA, compact->rows,
+                                       (size_t) capacity * sizeof(uchar*),
+                                       MYF(MY_ALLOW_ZERO_PTR));
+    if (!rows)
+      goto oom;
+    compact->rows= rows;
+    compact->capacity= capacity;
+  }
+  if (pkt_len > (ulong) (compact->block_end - compact->block_pos))
+  {
+    size_t size= MY_MAX(compact->block_size, pkt_len);
+    if (!(compact->block_pos= (uchar*) alloc_root(&result->alloc, size)))
+      goto oom;
+    compact->block_end= compact->block_pos + size;
+    compact->block_size= MY_MIN(compact->block_size * 2,
+                                COMPACT_ROWS_MAX_BLOCK);
+  }
+  memcpy(compact->block_pos, mysql->net.read_pos, pkt_len);
+  compact->rows[result->rows++]= compact->block_pos;
+  compact->block_pos+= pkt_len;
+  set_if_bigger(compact->max_row_length, pkt_len);
+  return 0;
+
+malformed:
+  set_mysql_error(mysql, CR_MALFORMED_PACKET, unknown_sqlstate);
+  return 1;
+oom:
+  set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+  return 1;
+}
+
+
+/*
+  Read all rows of a result as cli_read_rows() does, but for
+  MYSQL_OPT_COMPACT_RESULT: the row packets are kept as they are,
+  see st_mysql_compact_rows.
+*/
+
+static MYSQL_DATA *read_compact_rows(MYSQL *mysql, MYSQL_FIELD *mysql_fields,
+                                     unsigned int fields)
+{
+  ulong pkt_len;
+  MYSQL_DATA *result;
+  struct st_mysql_compact_rows *compact;
+  NET *net = &mysql->net;
+  DBUG_ENTER("read_compact_rows");
+
+  if ((pkt_len= cli_safe_read(mysql)) == packet_error)
+    DBUG_RETURN(0);
+  if (!(result= alloc_rows(mysql, fields)))
+    DBUG_RETURN(0);
+  if (!(compact= (struct st_mysql_compact_rows*)
+        alloc_root(&result->alloc, sizeof(*compact))))
+  {
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    free_rows(result);
+    DBUG_RETURN(0);
+  }
+  memset(compact, 0, sizeof(*compact));
+  compact->block_size= COMPACT_ROWS_MIN_BLOCK;
+  result->extension= compact;
+
+  while (!is_rows_eof_packet(net->read_pos, pkt_len))
+  {
+    if (add_compact_row(mysql, result, mysql_fields, pkt_len) ||
+        (pkt_len=cli_safe_read(mysql)) == packet_error)
+    {
+      free_rows(result);
+      DBUG_RETURN(0);
+    }
+  }
+  read_rows_eof(mysql, pkt_len);
+  DBUG_PRINT("exit", ("Got %lu rows", (ulong) result->rows));
+  DBUG_RETURN(result);
+}
+
+
+/*
+  Return the next row of a MYSQL_OPT_COMPACT_RESULT result. The values
+  are copied, null terminated, to row_buffer as add_row() would lay
+  them out, so that mysql_fetch_lengths() works unchanged. The row is
+  valid until the next row is fetched.
 */
 
+static MYSQL_ROW fetch_compact_row(MYSQL_RES *res)
+{
+  MYSQL_DATA *data= res->data;
+  struct st_mysql_compact_rows *compact= data->extension;
+  uint field;
+  ulong len;
+  uchar *cp;
+  char *to;
+
+  if (compact->cursor >= data->rows)
+    return res->current_row= NULL;
+  if ((!res->row &&
+       !(res->row= (MYSQL_ROW) my_malloc(key_memory_MYSQL_ROW,
+                                         sizeof(res->row[0]) *
+                                         (res->field_count + 1),
+                                         MYF(MY_WME)))) ||
+      (!compact->row_buffer &&
+       !(compact->row_buffer= (char*) my_malloc(key_memory_MYSQL_ROW,
+                                                compact->max_row_length + 1,
+                                                MYF(MY_WME)))))
+    return res->current_row= NULL;
+
+  cp= compact->rows[compact->cursor++];
+  to= compact->row_buffer;
+  for (field= 0; field < res->field_count; field++)
+  {
+    if ((len= (ulong) net_field_length(&cp)) == NULL_LENGTH)
+      res->row[field]= 0;
+    else
+    {
+      res->row[field]= to;
+      memcpy(to, cp, len);
+      to[len]= 0;
+      to+= len + 1;
+      cp+= len;
+    }
+  }
+  res->row[field]= to;                          /* End of last field */
+  return res->current_row= res->row;
+}
+
+/* Unpack a row read by read_one_row() or mysql_fetch_row_nonblocking() */
 
 static int
-read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths)
+read_one_row_complete(MYSQL *mysql, ulong pkt_len, uint fields,
+                      MYSQL_ROW row, ulong *lengths)
 {
   uint field;
-  ulong pkt_len,len;
+  ulong len;
   uchar *pos, *prev_pos, *end_pos;
   NET *net= &mysql->net;
 
-  if ((pkt_len=cli_safe_read(mysql)) == packet_error)
-    return -1;
   if (pkt_len <= 8 && net->read_pos[0] == 254)
   {
-    if (pkt_len > 1)				/* MySQL 4.1 protocol */
-    {
-      mysql->warning_count= uint2korr(net->read_pos+1);
-      mysql->server_status= uint2korr(net->read_pos+3);
-    }
-#if defined(CLIENT_PROTOCOL_TRACING)
-    if (mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
-      MYSQL_TRACE_STAGE(mysql, WAIT_FOR_RESULT);
-    else
-      MYSQL_TRACE_STAGE(mysql, READY_FOR_COMMAND);
-#endif
+    read_rows_eof(mysql, pkt_len);
     return 1;				/* End of data */
   }
   prev_pos= 0;				/* allowed to write at packet[-1] */
@@ -1824,6 +2064,22 @@ read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths)
 }
 
 
+/*
+  Read one row. Uses packet buffer as storage for fields.
+  When next packet is read, the previous field values are destroyed
+*/
+
+static int
+read_one_row(MYSQL *mysql,uint fields,MYSQL_ROW row, ulong *lengths)
+{
+  ulong pkt_len;
+
+  if ((pkt_len=cli_safe_read(mysql)) == packet_error)
+    return -1;
+  return read_one_row_complete(mysql, pkt_len, fields, row, lengths);
+}
+
+
 /****************************************************************************
   Init MySQL structure or allocate one
 ****************************************************************************/
@@ -1909,6 +2165,11 @@ void mysql_extension_free(struct st_mysql_extension *ext)
     return;
   if (ext->trace_data)
     my_free(ext->trace_data);
+  if (ext->async_data)
+    async_free(ext->async_data);
+  if (ext->pipeline_data)
+    pipeline_free(ext->pipeline_data);
+  mysql_free_ssl_session(ext->ssl_session);
   my_free(ext);
 }
 
@@ -2006,6 +2267,44 @@ mysql_get_ssl_cipher(MYSQL *mysql __attribute__((unused)))
 }
 
 
+/*
+  Get the SSL session of the connection, to resume it when connecting
+  to the same server again with mysql_options(MYSQL_OPT_SSL_SESSION).
+
+  SYNOPSYS
+    mysql_get_ssl_session()
+      mysql pointer to the mysql connection
+
+  RETURN VALUES
+    The session, to be freed with mysql_free_ssl_session(), or NULL if
+    the connection doesn't use SSL or the SSL library can't resume
+    sessions on the client side (yaSSL).
+*/
+
+void * STDCALL
+mysql_get_ssl_session(MYSQL *mysql __attribute__((unused)))
+{
+  DBUG_ENTER("mysql_get_ssl_session");
+#if defined(HAVE_OPENSSL) && !defined(HAVE_YASSL) && !defined(EMBEDDED_LIBRARY)
+  if (mysql->net.vio && mysql->net.vio->ssl_arg)
+    DBUG_RETURN(SSL_get1_session((SSL*)mysql->net.vio->ssl_arg));
+#endif /* HAVE_OPENSSL && !HAVE_YASSL && !EMBEDDED_LIBRARY */
+  DBUG_RETURN(NULL);
+}
+
+
+void STDCALL
+mysql_free_ssl_session(void *session __attribute__((unused)))
+{
+  DBUG_ENTER("mysql_free_ssl_session");
+#if defined(HAVE_OPENSSL) && !defined(HAVE_YASSL) && !defined(EMBEDDED_LIBRARY)
+  if (session)
+    SSL_SESSION_free((SSL_SESSION*) session);
+#endif /* HAVE_OPENSSL && !HAVE_YASSL && !EMBEDDED_LIBRARY */
+  DBUG_VOID_RETURN;
+}
+
+
 /*
   Check the server's (subject) Common Name against the
   hostname we connected to
@@ -2771,6 +3070,10 @@ error:
                 (if CLIENT_CONNECT_WITH_DB is set in the capabilities)
     n           client auth plugin name - \0-terminated string,
                 (if CLIENT_PLUGIN_AUTH is set in the capabilities)
+    n           connection attributes, length encoded
+                (if CLIENT_CONNECT_ATTRS is set in the capabilities)
+    1           compression level, 0 for the default of the server
+                (if CLIENT_COMPRESS_STREAM is set in the capabilities)
 
   @retval 0 ok
   @retval 1 error
@@ -2794,7 +3097,7 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
     see end= buff+32 below, fixed size of the packet is 32 bytes.
      +9 because data is a length encoded binary where meta data size is max 9.
   */
-  buff_size= 33 + USERNAME_LENGTH + data_len + 9 + NAME_LEN + NAME_LEN + connect_attrs_len + 9;
+  buff_size= 33 + USERNAME_LENGTH + data_len + 9 + NAME_LEN + NAME_LEN + connect_attrs_len + 9 + 1;
   buff= my_alloca(buff_size);
 
   mysql->client_flag|= mysql->options.client_flag;
@@ -2815,15 +3118,20 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
 #endif /* HAVE_OPENSSL && !EMBEDDED_LIBRARY*/
   if (mpvio->db)
     mysql->client_flag|= CLIENT_CONNECT_WITH_DB;
+  if (mysql->client_flag & CLIENT_COMPRESS)
+    mysql->client_flag|= CLIENT_COMPRESS_STREAM;
 
   /* Remove options that server doesn't support */
   mysql->client_flag= mysql->client_flag &
-                       (~(CLIENT_COMPRESS | CLIENT_SSL | CLIENT_PROTOCOL_41) 
+                       (~(CLIENT_COMPRESS | CLIENT_COMPRESS_STREAM |
+                          CLIENT_SSL | CLIENT_PROTOCOL_41) 
                        | mysql->server_capabilities);
 
 #ifndef HAVE_COMPRESS
   mysql->client_flag&= ~CLIENT_COMPRESS;
 #endif
+  if (!(mysql->client_flag & CLIENT_COMPRESS))
+    mysql->client_flag&= ~CLIENT_COMPRESS_STREAM;
 
   if (mysql->client_flag & CLIENT_PROTOCOL_41)
   {
@@ -2888,7 +3196,10 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
     DBUG_PRINT("info", ("IO layer change in progress..."));
     MYSQL_TRACE(SSL_CONNECT, mysql, ());
     if (sslconnect(ssl_fd, net->vio,
-                   (long) (mysql->options.connect_timeout), &ssl_error))
+                   (long) (mysql->options.connect_timeout),
+                   options->extension ?
+                   (SSL_SESSION*) options->extension->ssl_session : NULL,
+                   &ssl_error))
     {    
       char buf[512];
       ERR_error_string_n(ssl_error, buf, 512);
@@ -2975,6 +3286,11 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
 
   end= (char *) send_client_connect_attrs(mysql, (uchar *) end);
 
+  if (mysql->client_flag & CLIENT_COMPRESS_STREAM)
+    *end++= (char) (mysql->options.extension ?
+                    MY_MIN(mysql->options.extension->compression_level, 9) :
+                    0);
+
   /* Write authentication package */
   MYSQL_TRACE(SEND_AUTH_RESPONSE, mysql, (end-buff, (const unsigned char*)buff));
   if (my_net_write(net, (uchar*) buff, (size_t) (end-buff)) || net_flush(net))
@@ -3992,7 +4308,17 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
   */
 
   if (mysql->client_flag & CLIENT_COMPRESS)      /* We will use compression */
+  {
+    if ((mysql->client_flag & CLIENT_COMPRESS_STREAM) &&
+        net_compress_stream_init(net, mysql->options.extension ?
+                                 mysql->options.extension->compression_level :
+                                 0))
+    {
+      set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+      goto error;
+    }
     net->compress=1;
+  }
 
 #ifdef CHECK_LICENSE 
   if (check_license(mysql))
@@ -4068,6 +4394,9 @@ error:
 my_bool mysql_reconnect(MYSQL *mysql)
 {
   MYSQL tmp_mysql;
+  struct st_mysql_options_extention *ext;
+  void *ssl_session, *user_ssl_session= NULL;
+  my_bool error= 1;
   DBUG_ENTER("mysql_reconnect");
   DBUG_ASSERT(mysql);
   DBUG_PRINT("enter", ("mysql->reconnect: %d", mysql->reconnect));
@@ -4080,6 +4409,30 @@ my_bool mysql_reconnect(MYSQL *mysql)
     set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
     DBUG_RETURN(1);
   }
+
+  /*
+    Resume the SSL session of the lost connection, the server most likely
+    still has it. The options are shared with tmp_mysql, so the session
+    given by the user is put back when done.
+  */
+  if (!(ssl_session= mysql_get_ssl_session(mysql)) && mysql->extension)
+  {
+    struct st_mysql_extension *mysql_ext= mysql->extension;
+    ssl_session= mysql_ext->ssl_session;
+    mysql_ext->ssl_session= NULL;
+  }
+  if (ssl_session)
+  {
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if ((ext= mysql->options.extension))
+    {
+      user_ssl_session= ext->ssl_session;
+      ext->ssl_session= ssl_session;
+    }
+  }
+  else
+    ext= NULL;
+
   mysql_init(&tmp_mysql);
   tmp_mysql.options= mysql->options;
   tmp_mysql.options.my_cnf_file= tmp_mysql.options.my_cnf_group= 0;
@@ -4093,7 +4446,7 @@ my_bool mysql_reconnect(MYSQL *mysql)
     mysql->net.last_errno= tmp_mysql.net.last_errno;
     strmov(mysql->net.last_error, tmp_mysql.net.last_error);
     strmov(mysql->net.sqlstate, tmp_mysql.net.sqlstate);
-    DBUG_RETURN(1);
+    goto end;
   }
   if (mysql_set_character_set(&tmp_mysql, mysql->charset->csname))
   {
@@ -4103,7 +4456,7 @@ my_bool mysql_reconnect(MYSQL *mysql)
     mysql->net.last_errno= tmp_mysql.net.last_errno;
     strmov(mysql->net.last_error, tmp_mysql.net.last_error);
     strmov(mysql->net.sqlstate, tmp_mysql.net.sqlstate);
-    DBUG_RETURN(1);
+    goto end;
   }
 
   DBUG_PRINT("info", ("reconnect succeded"));
@@ -4121,7 +4474,13 @@ my_bool mysql_reconnect(MYSQL *mysql)
   *mysql=tmp_mysql;
   net_clear(&mysql->net, 1);
   mysql->affected_rows= ~(my_ulonglong) 0;
-  DBUG_RETURN(0);
+  error= 0;
+
+end:
+  if (ext)
+    ext->ssl_session= user_ssl_session;
+  mysql_free_ssl_session(ssl_session);
+  DBUG_RETURN(error);
 }
 
 
@@ -4319,16 +4678,21 @@ void STDCALL mysql_close(MYSQL *mysql)
 }
 
 
-static my_bool cli_read_query_result(MYSQL *mysql)
+/*
+  Handle the first packet of the result of a query: an OK packet, a
+  request for a LOAD DATA LOCAL INFILE file, or the number of fields of a
+  result set, stored in *field_count. *field_count is 0 when the result
+  is complete.
+*/
+
+static my_bool read_query_result_header(MYSQL *mysql, ulong length,
+                                        ulong *field_count_ptr)
 {
   uchar *pos;
   ulong field_count;
-  MYSQL_DATA *fields;
-  ulong length;
-  DBUG_ENTER("cli_read_query_result");
+  DBUG_ENTER("read_query_result_header");
 
-  if ((length = cli_safe_read(mysql)) == packet_error)
-    DBUG_RETURN(1);
+  *field_count_ptr= 0;
   free_old_query(mysql);		/* Free old result */
 #ifdef MYSQL_CLIENT			/* Avoid warn of unused labels*/
 get_info:
@@ -4391,16 +4755,49 @@ get_info:
 
   MYSQL_TRACE_STAGE(mysql, WAIT_FOR_FIELD_DEF);
 
-  if (!(fields=cli_read_rows(mysql,(MYSQL_FIELD*)0, protocol_41(mysql) ? 7:5)))
-    DBUG_RETURN(1);
+  *field_count_ptr= field_count;
+  DBUG_RETURN(0);
+}
+
+
+/* Number of fields of the rows that describe the fields of a result */
+
+#define field_def_fields(mysql) (protocol_41(mysql) ? 7 : 5)
+
+
+/* Set up the result set of a query from its field definitions */
+
+static my_bool read_query_result_fields(MYSQL *mysql, MYSQL_DATA *fields,
+                                        ulong field_count)
+{
   if (!(mysql->fields=unpack_fields(mysql, fields,&mysql->field_alloc,
 				    (uint) field_count,0,
 				    mysql->server_capabilities)))
-    DBUG_RETURN(1);
+    return 1;
   mysql->status= MYSQL_STATUS_GET_RESULT;
   mysql->field_count= (uint) field_count;
 
   MYSQL_TRACE_STAGE(mysql, WAIT_FOR_ROW);
+  return 0;
+}
+
+
+static my_bool cli_read_query_result(MYSQL *mysql)
+{
+  ulong field_count;
+  MYSQL_DATA *fields;
+  ulong length;
+  DBUG_ENTER("cli_read_query_result");
+
+  if ((length = cli_safe_read(mysql)) == packet_error ||
+      read_query_result_header(mysql, length, &field_count))
+    DBUG_RETURN(1);
+  if (!field_count)
+    DBUG_RETURN(0);
+
+  if (!(fields=cli_read_rows(mysql,(MYSQL_FIELD*)0, field_def_fields(mysql))) ||
+      read_query_result_fields(mysql, fields, field_count))
+    DBUG_RETURN(1);
 
   DBUG_PRINT("exit",("ok"));
   DBUG_RETURN(0);
@@ -4436,6 +4833,645 @@ mysql_real_query(MYSQL *mysql, const char *query, ulong length)
 }
 
 
+/**************************************************************************
+  Non-blocking queries
+
+  The non-blocking calls read and write the socket with zero timeouts,
+  and return NET_ASYNC_NOT_READY_READ or NET_ASYNC_NOT_READY_WRITE when
+  the socket has no more data or room. The state of the call is kept in
+  MYSQL::extension until the call is repeated and completes. Packets are
+  read piece by piece to net->buff as my_net_read() reads them, and then
+  processed by the same functions as those of the blocking calls.
+**************************************************************************/
+
+#define MAX_PACKET_LENGTH (256L*256L*256L-1)
+
+enum enum_async_stage
+{
+  ASYNC_STAGE_IDLE= 0,
+  ASYNC_STAGE_WRITE_QUERY,              /* Sending COM_QUERY */
+  ASYNC_STAGE_READ_RESULT,              /* Reading the first packet */
+  ASYNC_STAGE_READ_FIELDS               /* Reading the field definitions */
+};
+
+struct st_mysql_async
+{
+  enum enum_async_stage stage;
+  /* The packets of the query, and how many of their bytes are sent */
+  uchar *write_buff;
+  size_t write_length, write_pos;
+  /*
+    The packet being read: the length of its previous pieces if it is a
+    multi-packet, the length of the piece being read, and the number of
+    bytes of the piece, header included, read so far.
+  */
+  ulong read_length;
+  ulong piece_length;
+  size_t piece_pos;
+  /* Field definitions of a result set */
+  ulong field_count;
+  MYSQL_DATA *fields;
+  MYSQL_ROWS **prev_ptr;
+  /* Timeouts (ms) of the Vio outside of the non-blocking calls */
+  int read_timeout, write_timeout;
+};
+
+
+/*
+  Whether the non-blocking calls can do non-blocking I/O on a connection.
+  Zero timeouts are not supported by the Vio on Windows, and compressed
+  packets are not read piece by piece.
+*/
+
+static my_bool async_supported(MYSQL *mysql)
+{
+#ifdef _WIN32
+  return FALSE;
+#else
+  Vio *vio= mysql->net.vio;
+
+  if (!vio || mysql->net.compress)
+    return FALSE;
+  switch (vio_type(vio)) {
+  case VIO_TYPE_TCPIP:
+  case VIO_TYPE_SOCKET:
+  case VIO_TYPE_SSL:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+#endif
+}
+
+
+static void async_free(struct st_mysql_async *async)
+{
+  my_free(async->write_buff);
+  free_rows(async->fields);
+  my_free(async);
+}
+
+
+/* Switch the socket to non-blocking I/O for the time of a call */
+
+static struct st_mysql_async *async_begin(MYSQL *mysql)
+{
+  struct st_mysql_extension *ext= MYSQL_EXTENSION(mysql);
+  struct st_mysql_async *async;
+  Vio *vio= mysql->net.vio;
+
+  if (!ext ||
+      (!(async= ext->async_data) &&
+       !(async= ext->async_data= (struct st_mysql_async *)
+         my_malloc(PSI_NOT_INSTRUMENTED, sizeof(struct st_mysql_async),
+                   MYF(MY_WME | MY_ZEROFILL)))))
+  {
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    return NULL;
+  }
+  async->read_timeout= vio->read_timeout;
+  async->write_timeout= vio->write_timeout;
+  vio_timeout(vio, 0, 0);
+  vio_timeout(vio, 1, 0);
+  return async;
+}
+
+
+static void async_restore_timeouts(MYSQL *mysql, struct st_mysql_async *async)
+{
+  Vio *vio= mysql->net.vio;
+
+  /* The Vio is gone if the call has failed with a network error */
+  if (!vio)
+    return;
+  vio_timeout(vio, 0, async->read_timeout < 0 ? -1 :
+                      async->read_timeout / 1000);
+  vio_timeout(vio, 1, async->write_timeout < 0 ? -1 :
+                      async->write_timeout / 1000);
+}
+
+
+/*
+  Restore the blocking I/O of the socket when a call returns, and drop
+  the state of the call unless it is to be called again.
+*/
+
+static enum net_async_status async_end(MYSQL *mysql,
+                                       struct st_mysql_async *async,
+                                       enum net_async_status status)
+{
+  async_restore_timeouts(mysql, async);
+  if (status == NET_ASYNC_NOT_READY_READ ||
+      status == NET_ASYNC_NOT_READY_WRITE)
+    return status;
+
+  my_free(async->write_buff);
+  async->write_buff= NULL;
+  free_rows(async->fields);
+  async->fields= NULL;
+  async->read_length= 0;
+  async->piece_pos= 0;
+  async->stage= ASYNC_STAGE_IDLE;
+  return status;
+}
+
+
+/*
+  Read a packet without waiting, like cli_safe_read(). When the packet is
+  complete, *len is set to its length, or to packet_error with the error
+  set.
+*/
+
+static enum net_async_status
+cli_safe_read_nonblocking(MYSQL *mysql, struct st_mysql_async *async,
+                          ulong *len)
+{
+  NET *net= &mysql->net;
+
+  if (!async->piece_pos && !async->read_length)
+    MYSQL_TRACE(READ_PACKET, mysql, ());
+
+  for (;;)
+  {
+    uchar *pos= net->buff + net->where_b + async->read_length;
+    size_t length;
+
+    if (async->piece_pos < NET_HEADER_SIZE)
+      length= vio_read(net->vio, pos + async->piece_pos,
+                       NET_HEADER_SIZE - async->piece_pos);
+    else if (async->piece_pos < NET_HEADER_SIZE + async->piece_length)
+      length= vio_read(net->vio, pos + async->piece_pos - NET_HEADER_SIZE,
+                       NET_HEADER_SIZE + async->piece_length -
+                       async->piece_pos);
+    else
+    {
+      /* The piece is complete */
+      async->read_length+= async->piece_length;
+      async->piece_pos= 0;
+      if (async->piece_length == MAX_PACKET_LENGTH)
+        continue;                               /* Read the next piece */
+      net->read_pos= net->buff + net->where_b;
+      net->read_pos[async->read_length]= 0;   /* Safeguard for use_result */
+      *len= cli_safe_read_complete(mysql, async->read_length);
+      async->read_length= 0;
+      return NET_ASYNC_COMPLETE;
+    }
+
+    if (length == (size_t) -1 && vio_was_timeout(net->vio))
+      return NET_ASYNC_NOT_READY_READ;
+    if (length == (size_t) -1 && vio_should_retry(net->vio))
+      continue;
+    if (length == 0 || length == (size_t) -1)
+    {
+      net->error= 2;
+      net->last_errno= ER_NET_READ_ERROR;
+      goto err;
+    }
+
+    if ((async->piece_pos+= length) == NET_HEADER_SIZE)
+    {
+      /* The header of the piece is read */
+      if (pos[3] != (uchar) net->pkt_nr)
+      {
+        net->error= 2;
+        net->last_errno= ER_NET_PACKETS_OUT_OF_ORDER;
+        goto err;
+      }
+      net->pkt_nr++;
+      async->piece_length= uint3korr(pos);
+      if (net->where_b + async->read_length + async->piece_length >=
+          net->max_packet &&
+          net_realloc(net, net->where_b + async->read_length +
+                      async->piece_length))
+        goto err;
+    }
+  }
+
+err:
+  *len= cli_safe_read_complete(mysql, packet_error);
+  async->read_length= 0;
+  return NET_ASYNC_COMPLETE;
+}
+
+
+/* Send the packets of async->write_buff without waiting */
+
+static enum net_async_status
+cli_write_nonblocking(MYSQL *mysql, struct st_mysql_async *async)
+{
+  NET *net= &mysql->net;
+
+  while (async->write_pos < async->write_length)
+  {
+    size_t length= vio_write(net->vio, async->write_buff + async->write_pos,
+                             async->write_length - async->write_pos);
+    if (length == (size_t) -1)
+    {
+      if (vio_was_timeout(net->vio))
+        return NET_ASYNC_NOT_READY_WRITE;
+      if (vio_should_retry(net->vio))
+        continue;
+      DBUG_PRINT("error",("Can't send command to server. Error: %d",
+                          socket_errno));
+      end_server(mysql);
+      set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+      return NET_ASYNC_ERROR;
+    }
+    async->write_pos+= length;
+  }
+  my_free(async->write_buff);
+  async->write_buff= NULL;
+  return NET_ASYNC_COMPLETE;
+}
+
+
+/*
+  Start a non-blocking COM_QUERY: the checks of cli_advanced_command(),
+  and the packets of net_write_command() put in async->write_buff.
+*/
+
+static my_bool async_start_query(MYSQL *mysql, struct st_mysql_async *async,
+                                 const char *query, ulong length)
+{
+  NET *net= &mysql->net;
+  size_t left= (size_t) length + 1;             /* 1 extra byte for command */
+  size_t pieces= left / MAX_PACKET_LENGTH + 1;
+  const uchar *from= (const uchar *) query;
+  uchar *to;
+
+  if (mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+  {
+    DBUG_PRINT("error",("state: %d", mysql->status));
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    return 1;
+  }
+
+  net_clear_error(net);
+  mysql->info=0;
+  mysql->affected_rows= ~(my_ulonglong) 0;
+  net_clear(net, 1);
+
+  MYSQL_TRACE_STAGE(mysql, READY_FOR_COMMAND);
+  MYSQL_TRACE(SEND_COMMAND, mysql, (COM_QUERY, 0, length, NULL,
+                                    (const uchar *) query));
+
+  async->write_length= left + pieces * NET_HEADER_SIZE;
+  async->write_pos= 0;
+  if (!(async->write_buff= (uchar *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                               async->write_length,
+                                               MYF(MY_WME))))
+  {
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    return 1;
+  }
+
+  to= async->write_buff;
+  do
+  {
+    size_t piece= MY_MIN(left, (size_t) MAX_PACKET_LENGTH);
+    size_t data= piece;
+
+    int3store(to, piece);
+    to[3]= (uchar) net->pkt_nr++;
+    to+= NET_HEADER_SIZE;
+    if (left == (size_t) length + 1)
+    {
+      *to++= (uchar) COM_QUERY;                 /* For first packet */
+      data--;
+    }
+    memcpy(to, from, data);
+    to+= data;
+    from+= data;
+    left-= piece;
+  } while (--pieces);
+
+  async->stage= ASYNC_STAGE_WRITE_QUERY;
+  return 0;
+}
+
+
+/* Read the result of a query without waiting, like cli_read_query_result() */
+
+static enum net_async_status
+cli_read_query_result_async(MYSQL *mysql, struct st_mysql_async *async)
+{
+  enum net_async_status status;
+  MYSQL_DATA *fields;
+  ulong length;
+
+  if (async->stage != ASYNC_STAGE_READ_FIELDS)
+  {
+    async->stage= ASYNC_STAGE_READ_RESULT;
+    if ((status= cli_safe_read_nonblocking(mysql, async, &length)) !=
+        NET_ASYNC_COMPLETE)
+      return status;
+    if (length == packet_error)
+      return NET_ASYNC_ERROR;
+    /* LOAD DATA LOCAL INFILE is handled with blocking I/O */
+    if (mysql->net.read_pos[0] == 251)
+      async_restore_timeouts(mysql, async);
+    if (read_query_result_header(mysql, length, &async->field_count))
+      return NET_ASYNC_ERROR;
+    if (!async->field_count)
+      return NET_ASYNC_COMPLETE;
+    if (!(async->fields= alloc_rows(mysql, field_def_fields(mysql))))
+      return NET_ASYNC_ERROR;
+    async->prev_ptr= &async->fields->data;
+    async->stage= ASYNC_STAGE_READ_FIELDS;
+  }
+
+  for (;;)
+  {
+    if ((status= cli_safe_read_nonblocking(mysql, async, &length)) !=
+        NET_ASYNC_COMPLETE)
+      return status;
+    if (length == packet_error)
+      return NET_ASYNC_ERROR;
+    if (is_rows_eof_packet(mysql->net.read_pos, length))
+      break;
+    if (add_row(mysql, async->fields, &async->prev_ptr, NULL, length))
+      return NET_ASYNC_ERROR;
+  }
+  *async->prev_ptr= 0;
+  read_rows_eof(mysql, length);
+
+  fields= async->fields;
+  async->fields= NULL;                  /* Freed by unpack_fields() */
+  if (read_query_result_fields(mysql, fields, async->field_count))
+    return NET_ASYNC_ERROR;
+  return NET_ASYNC_COMPLETE;
+}
+
+
+/**
+  Read the result of a query, or the next result of a multi-statement,
+  without waiting. The calls of mysql_next_result_nonblocking() end here.
+*/
+
+enum net_async_status cli_read_query_result_nonblocking(MYSQL *mysql)
+{
+  struct st_mysql_async *async;
+
+  if (!async_supported(mysql))
+    return (*mysql->methods->read_query_result)(mysql) ?
+      NET_ASYNC_ERROR : NET_ASYNC_COMPLETE;
+  if (!(async= async_begin(mysql)))
+    return NET_ASYNC_ERROR;
+  return async_end(mysql, async, cli_read_query_result_async(mysql, async));
+}
+
+
+enum net_async_status STDCALL
+mysql_real_query_nonblocking(MYSQL *mysql, const char *query, ulong length)
+{
+  struct st_mysql_async *async;
+  enum net_async_status status;
+  DBUG_ENTER("mysql_real_query_nonblocking");
+
+  if (!async_supported(mysql))
+    DBUG_RETURN(mysql_real_query(mysql, query, length) ?
+                NET_ASYNC_ERROR : NET_ASYNC_COMPLETE);
+  if (!(async= async_begin(mysql)))
+    DBUG_RETURN(NET_ASYNC_ERROR);
+
+  if (async->stage == ASYNC_STAGE_IDLE)
+  {
+    DBUG_PRINT("query",("Query = '%-.*s'", (int) length, query));
+    if (async_start_query(mysql, async, query, length))
+      DBUG_RETURN(async_end(mysql, async, NET_ASYNC_ERROR));
+  }
+  if (async->stage == ASYNC_STAGE_WRITE_QUERY)
+  {
+    if ((status= cli_write_nonblocking(mysql, async)) != NET_ASYNC_COMPLETE)
+      DBUG_RETURN(async_end(mysql, async, status));
+    MYSQL_TRACE(PACKET_SENT, mysql, (length));
+    MYSQL_TRACE_STAGE(mysql, WAIT_FOR_RESULT);
+    async->stage= ASYNC_STAGE_READ_RESULT;
+  }
+  DBUG_RETURN(async_end(mysql, async,
+                        cli_read_query_result_async(mysql, async)));
+}
+
+
+/* The socket to wait on when a non-blocking call is not ready */
+
+my_socket STDCALL mysql_get_socket_descriptor(MYSQL *mysql)
+{
+  if (!mysql->net.vio)
+    return INVALID_SOCKET;
+  return vio_fd(mysql->net.vio);
+}
+
+
+/**************************************************************************
+  Pipelined queries
+
+  mysql_pipeline_query() puts a COM_QUERY in the write buffer of the
+  connection without waiting for the results of the queries before it,
+  and mysql_pipeline_read_result() reads the results in the order of the
+  queries, flushing the queries that are not sent yet. The server runs the
+  queries one after the other, so an error in one of them does not affect
+  the others. The packet numbers that the result of each query starts
+  with are kept in MYSQL::extension until the result is read.
+**************************************************************************/
+
+struct st_mysql_pipeline_entry
+{
+  uint pkt_nr, compress_pkt_nr;
+};
+
+struct st_mysql_pipeline
+{
+  DYNAMIC_ARRAY entries;                /* Queries whose results are unread */
+  uint next;                            /* Entry of the next result */
+  my_bool unsent;                       /* Queries are not flushed yet */
+};
+
+
+static uint pipeline_pending(struct st_mysql_pipeline *pipeline)
+{
+  return pipeline ? pipeline->entries.elements - pipeline->next : 0;
+}
+
+
+static void pipeline_free(struct st_mysql_pipeline *pipeline)
+{
+  delete_dynamic(&pipeline->entries);
+  my_free(pipeline);
+}
+
+
+/* Forget the queries of the pipeline, when the connection is closed */
+
+static void pipeline_reset(MYSQL *mysql)
+{
+  struct st_mysql_pipeline *pipeline;
+
+  if (mysql->extension &&
+      (pipeline= ((struct st_mysql_extension *)
+                  mysql->extension)->pipeline_data))
+  {
+    reset_dynamic(&pipeline->entries);
+    pipeline->next= 0;
+    pipeline->unsent= FALSE;
+  }
+}
+
+
+/* Whether results of pipelined queries are to be read before a command */
+
+static my_bool pipeline_busy(MYSQL *mysql)
+{
+  return mysql->extension &&
+    pipeline_pending(((struct st_mysql_extension *)
+                      mysql->extension)->pipeline_data) > 0;
+}
+
+
+int STDCALL
+mysql_pipeline_query(MYSQL *mysql, const char *query, ulong length)
+{
+  NET *net= &mysql->net;
+  struct st_mysql_extension *ext;
+  struct st_mysql_pipeline *pipeline;
+  struct st_mysql_pipeline_entry entry;
+  DBUG_ENTER("mysql_pipeline_query");
+  DBUG_PRINT("query",("Query = '%-.*s'", (int) length, query));
+
+  if (mysql->methods != &client_methods)
+  {
+    set_mysql_error(mysql, CR_NOT_IMPLEMENTED, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  if (!net->vio)
+  {
+    set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  /* The write buffer is also the read buffer of a result being read */
+  if (mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+  {
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+
+  if (!(ext= MYSQL_EXTENSION(mysql)) ||
+      (!(pipeline= ext->pipeline_data) &&
+       (!(pipeline= ext->pipeline_data= (struct st_mysql_pipeline *)
+          my_malloc(PSI_NOT_INSTRUMENTED, sizeof(struct st_mysql_pipeline),
+                    MYF(MY_WME | MY_ZEROFILL))) ||
+        my_init_dynamic_array(&pipeline->entries,
+                              sizeof(struct st_mysql_pipeline_entry),
+                              16, 16))))
+  {
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  if (allocate_dynamic(&pipeline->entries, pipeline->entries.elements))
+  {
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+
+  net_clear_error(net);
+  if (!pipeline->unsent)
+    net->write_pos= net->buff;
+
+  /* Every command starts a new sequence of packets */
+  net->pkt_nr= net->compress_pkt_nr= 0;
+  if (net_queue_command(net, (uchar) COM_QUERY, 0, 0,
+                        (const uchar *) query, length) ||
+      /* The compressed packets of a command are not shared with others */
+      (net->compress && net_flush(net)))
+  {
+    if (net->last_errno == ER_NET_PACKET_TOO_LARGE)
+    {
+      set_mysql_error(mysql, CR_NET_PACKET_TOO_LARGE, unknown_sqlstate);
+      DBUG_RETURN(1);
+    }
+    end_server(mysql);
+    set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  if (!net->compress)
+    pipeline->unsent= TRUE;
+
+  entry.pkt_nr= net->pkt_nr;
+  entry.compress_pkt_nr= net->compress_pkt_nr;
+  (void) insert_dynamic(&pipeline->entries, &entry);    /* Preallocated */
+  DBUG_RETURN(0);
+}
+
+
+int STDCALL mysql_pipeline_flush(MYSQL *mysql)
+{
+  struct st_mysql_pipeline *pipeline;
+  DBUG_ENTER("mysql_pipeline_flush");
+
+  if (!mysql->extension ||
+      !(pipeline= ((struct st_mysql_extension *)
+                   mysql->extension)->pipeline_data) ||
+      !pipeline->unsent)
+    DBUG_RETURN(0);
+
+  pipeline->unsent= FALSE;
+  if (net_flush(&mysql->net))
+  {
+    end_server(mysql);
+    set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  DBUG_RETURN(0);
+}
+
+
+my_bool STDCALL mysql_pipeline_read_result(MYSQL *mysql)
+{
+  NET *net= &mysql->net;
+  struct st_mysql_pipeline *pipeline;
+  struct st_mysql_pipeline_entry *entry;
+  DBUG_ENTER("mysql_pipeline_read_result");
+
+  pipeline= mysql->extension ?
+    ((struct st_mysql_extension *) mysql->extension)->pipeline_data : NULL;
+  if (!pipeline_pending(pipeline) ||
+      mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+  {
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  if (mysql_pipeline_flush(mysql))
+    DBUG_RETURN(1);
+
+  entry= dynamic_element(&pipeline->entries, pipeline->next,
+                         struct st_mysql_pipeline_entry *);
+  net->pkt_nr= entry->pkt_nr;
+  net->compress_pkt_nr= entry->compress_pkt_nr;
+  if (++pipeline->next == pipeline->entries.elements)
+  {
+    reset_dynamic(&pipeline->entries);
+    pipeline->next= 0;
+  }
+
+  net_clear_error(net);
+  mysql->info= 0;
+  mysql->affected_rows= ~(my_ulonglong) 0;
+  MYSQL_TRACE_STAGE(mysql, WAIT_FOR_RESULT);
+  DBUG_RETURN((*mysql->methods->read_query_result)(mysql));
+}
+
+
+unsigned int STDCALL mysql_pipeline_pending(MYSQL *mysql)
+{
+  return mysql->extension ?
+    pipeline_pending(((struct st_mysql_extension *)
+                      mysql->extension)->pipeline_data) : 0;
+}
+
+
 /**************************************************************************
   Alloc result struct for buffered results. All rows are read to buffer.
   mysql_data_seek may be used.
@@ -4466,8 +5502,14 @@ MYSQL_RES * STDCALL mysql_store_result(MYSQL *mysql)
   result->methods= mysql->methods;
   result->eof=1;				/* Marker for buffered */
   result->lengths=(ulong*) (result+1);
-  if (!(result->data=
-	(*mysql->methods->read_rows)(mysql,mysql->fields,mysql->field_count)))
+  if (mysql->options.extension &&
+      mysql->options.extension->compact_result &&
+      mysql->methods->read_rows == cli_read_rows)
+    result->data= read_compact_rows(mysql, mysql->fields, mysql->field_count);
+  else
+    result->data=
+      (*mysql->methods->read_rows)(mysql, mysql->fields, mysql->field_count);
+  if (!result->data)
   {
     my_free(result);
     DBUG_RETURN(0);
@@ -4536,6 +5578,26 @@ static MYSQL_RES * cli_use_result(MYSQL *mysql)
 }
 
 
+/* End the rows of a mysql_use_result() result */
+
+static void end_unbuffered_fetch(MYSQL_RES *res)
+{
+  MYSQL *mysql= res->handle;
+
+  DBUG_PRINT("info",("end of data"));
+  res->eof=1;
+  mysql->status=MYSQL_STATUS_READY;
+  /*
+    Reset only if owner points to us: there is a chance that somebody
+    started new query after mysql_stmt_close():
+  */
+  if (mysql->unbuffered_fetch_owner == &res->unbuffered_fetch_cancelled)
+    mysql->unbuffered_fetch_owner= 0;
+  /* Don't clear handle in mysql_free_result */
+  res->handle=0;
+}
+
+
 /**************************************************************************
   Return next row of the query results
 **************************************************************************/
@@ -4561,20 +5623,12 @@ mysql_fetch_row(MYSQL_RES *res)
 	res->row_count++;
 	DBUG_RETURN(res->current_row=res->row);
       }
-      DBUG_PRINT("info",("end of data"));
-      res->eof=1;
-      mysql->status=MYSQL_STATUS_READY;
-      /*
-        Reset only if owner points to us: there is a chance that somebody
-        started new query after mysql_stmt_close():
-      */
-      if (mysql->unbuffered_fetch_owner == &res->unbuffered_fetch_cancelled)
-        mysql->unbuffered_fetch_owner= 0;
-      /* Don't clear handle in mysql_free_result */
-      res->handle=0;
+      end_unbuffered_fetch(res);
     }
     DBUG_RETURN((MYSQL_ROW) NULL);
   }
+  if (res->data->extension)
+    DBUG_RETURN(fetch_compact_row(res));
   {
     MYSQL_ROW tmp;
     if (!res->data_cursor)
@@ -4589,6 +5643,56 @@ mysql_fetch_row(MYSQL_RES *res)
 }
 
 
+/*
+  Return the next row of the query results without waiting. *row is set
+  to NULL at the end of the rows, as mysql_fetch_row() returns it.
+*/
+
+enum net_async_status STDCALL
+mysql_fetch_row_nonblocking(MYSQL_RES *res, MYSQL_ROW *row)
+{
+  MYSQL *mysql= res->handle;
+  struct st_mysql_async *async;
+  enum net_async_status status;
+  ulong pkt_len;
+  int rc;
+  DBUG_ENTER("mysql_fetch_row_nonblocking");
+
+  if (res->data || res->eof)
+  {
+    *row= mysql_fetch_row(res);
+    DBUG_RETURN(NET_ASYNC_COMPLETE);
+  }
+  if (!async_supported(mysql) || mysql->status != MYSQL_STATUS_USE_RESULT)
+  {
+    /* A blocking fetch, or the error of mysql_fetch_row() */
+    if (!(*row= mysql_fetch_row(res)) && mysql->net.last_errno)
+      DBUG_RETURN(NET_ASYNC_ERROR);
+    DBUG_RETURN(NET_ASYNC_COMPLETE);
+  }
+
+  if (!(async= async_begin(mysql)))
+    DBUG_RETURN(NET_ASYNC_ERROR);
+  if ((status= cli_safe_read_nonblocking(mysql, async, &pkt_len)) !=
+      NET_ASYNC_COMPLETE)
+    DBUG_RETURN(async_end(mysql, async, status));
+  async_end(mysql, async, NET_ASYNC_COMPLETE);
+
+  rc= pkt_len == packet_error ? -1 :
+    read_one_row_complete(mysql, pkt_len, res->field_count, res->row,
+                          res->lengths);
+  if (!rc)
+  {
+    res->row_count++;
+    *row= res->current_row= res->row;
+    DBUG_RETURN(NET_ASYNC_COMPLETE);
+  }
+  end_unbuffered_fetch(res);
+  *row= NULL;
+  DBUG_RETURN(rc < 0 ? NET_ASYNC_ERROR : NET_ASYNC_COMPLETE);
+}
+
+
 /**************************************************************************
   Get column lengths of the current row
   If one uses mysql_use_result, res->lengths contains the length information,
@@ -4607,6 +5711,68 @@ mysql_fetch_lengths(MYSQL_RES *res)
   return res->lengths;
 }
 
+
+/*
+  Return the values of the next row, without building a MYSQL_ROW:
+  values[i] is the value of field i, not null terminated, or NULL for
+  SQL NULL, and lengths[i] its length. Both arrays must have room for
+  mysql_num_fields() elements.
+
+  For a result stored with MYSQL_OPT_COMPACT_RESULT the values point
+  into the stored row packet, valid until mysql_free_result(), and
+  mysql_fetch_lengths() returns NULL afterwards. Other results are read
+  with mysql_fetch_row().
+
+  Returns 0 if a row was read, 1 at the end of the rows or on error.
+*/
+
+my_bool STDCALL
+mysql_fetch_row_view(MYSQL_RES *res, const char **values, ulong *lengths)
+{
+  uint field;
+
+  if (res->data && res->data->extension)
+  {
+    struct st_mysql_compact_rows *compact= res->data->extension;
+    uchar *cp;
+    ulong len;
+
+    res->current_row= NULL;
+    if (compact->cursor >= res->data->rows)
+      return 1;
+    cp= compact->rows[compact->cursor++];
+    for (field= 0; field < res->field_count; field++)
+    {
+      if ((len= (ulong) net_field_length(&cp)) == NULL_LENGTH)
+      {
+        values[field]= NULL;
+        lengths[field]= 0;
+      }
+      else
+      {
+        values[field]= (const char*) cp;
+        lengths[field]= len;
+        cp+= len;
+      }
+    }
+  }
+  else
+  {
+    MYSQL_ROW row;
+    ulong *row_lengths;
+
+    if (!(row= mysql_fetch_row(res)))
+      return 1;
+    row_lengths= mysql_fetch_lengths(res);
+    for (field= 0; field < res->field_count; field++)
+    {
+      values[field]= row[field];
+      lengths[field]= row_lengths[field];
+    }
+  }
+  return 0;
+}
+
 int STDCALL
 mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
 {
@@ -4767,6 +5933,19 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
     else
       mysql->options.client_flag&= ~CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS;
     break;
+  case MYSQL_OPT_COMPRESSION_LEVEL:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    mysql->options.extension->compression_level= *(uint*) arg;
+    break;
+  case MYSQL_OPT_SSL_SESSION:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    mysql->options.extension->ssl_session= (void*) arg;
+    break;
+  case MYSQL_OPT_COMPACT_RESULT:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    mysql->options.extension->compact_result=
+      (*(my_bool*) arg) ? TRUE : FALSE;
+    break;
 
   default:
     DBUG_RETURN(1);
@@ -54,14 +54,13 @@ HASH acl_check_hosts;
 bool initialized=0;
 bool allow_all_hosts=1;
 uint grant_version=0; /* Version of priv tables */
+/* Incremented whenever acl_cache is cleared, @sa clear_acl_cache() */
+volatile int32 acl_cache_version= 0;
+my_atomic_rwlock_t acl_cache_version_lock;
 my_bool validate_user_plugins= TRUE;
 
 #define FIRST_NON_YN_FIELD 26
 
-#define IP_ADDR_STRLEN (3 + 1 + 3 + 1 + 3 + 1 + 3)
-#define ACL_KEY_LENGTH (IP_ADDR_STRLEN + 1 + NAME_LEN + \
-                        1 + USERNAME_LENGTH + 1)
-
 #endif /* NO_EMBEDDED_ACCESS_CHECKS */
 
 /**
@@ -744,9 +743,10 @@ find_acl_user(const char *host, const char *user, my_bool exact)
 
   mysql_mutex_assert_owner(&acl_cache->lock);
 
-  for (uint i=0 ; i < acl_users.elements ; i++)
+  Acl_user_iterator it(user, false);
+  ACL_USER *acl_user;
+  while ((acl_user= it.next()))
   {
-    ACL_USER *acl_user=dynamic_element(&acl_users,i,ACL_USER*);
     DBUG_PRINT("info",("strcmp('%s','%s'), compare_hostname('%s','%s'),",
                        user, acl_user->user ? acl_user->user : "",
                        host,
@@ -853,6 +853,230 @@ static uchar* check_get_key(ACL_USER *buff, size_t *length,
 }
 
 
+/*
+  Index of acl_users by user name
+
+  NOTES
+    Maps a user name ("" for anonymous users) to the positions of its
+    entries in acl_users, in the order of the array. As the array is
+    sorted so that the first matching entry is the one to use, lookups
+    can examine just the entries for the user name (and the anonymous
+    ones) instead of all of them.
+    The index is rebuilt together with acl_check_hosts. While entries
+    are dropped or renamed before that, the index is invalidated and
+    lookups fall back to scanning acl_users.
+*/
+
+struct ACL_USER_BUCKET
+{
+  const char *user;
+  size_t length;
+  uint *positions;
+  uint elements;
+};
+
+static HASH acl_users_index;
+static MEM_ROOT acl_users_index_memory;
+static bool acl_users_index_valid= false;
+
+
+static uchar* acl_users_index_get_key(ACL_USER_BUCKET *buff, size_t *length,
+                                      my_bool not_used __attribute__((unused)))
+{
+  *length= buff->length;
+  return (uchar*) buff->user;
+}
+
+
+static ACL_USER_BUCKET *find_acl_user_bucket(const char *user)
+{
+  return (ACL_USER_BUCKET*) my_hash_search(&acl_users_index, (uchar*) user,
+                                           strlen(user));
+}
+
+
+static void init_acl_users_index(void)
+{
+  ACL_USER_BUCKET *bucket;
+  uint i;
+  DBUG_ENTER("init_acl_users_index");
+
+  init_sql_alloc(key_memory_acl_mem,
+                 &acl_users_index_memory, ACL_ALLOC_BLOCK_SIZE, 0);
+  (void) my_hash_init(&acl_users_index, &my_charset_bin,
+                      acl_users.elements, 0, 0,
+                      (my_hash_get_key) acl_users_index_get_key, 0, 0);
+
+  /* Count the entries for each user name */
+  for (i=0 ; i < acl_users.elements ; i++)
+  {
+    ACL_USER *acl_user=dynamic_element(&acl_users,i,ACL_USER*);
+    const char *user= acl_user->user ? acl_user->user : "";
+
+    if (!(bucket= find_acl_user_bucket(user)))
+    {
+      if (!(bucket= (ACL_USER_BUCKET*) alloc_root(&acl_users_index_memory,
+                                                  sizeof(ACL_USER_BUCKET))))
+        DBUG_VOID_RETURN;                       // Lookups scan acl_users
+      bucket->user= user;
+      bucket->length= strlen(user);
+      bucket->elements= 0;
+      if (my_hash_insert(&acl_users_index, (uchar*) bucket))
+        DBUG_VOID_RETURN;
+    }
+    bucket->elements++;
+  }
+
+  for (i=0 ; i < acl_users_index.records ; i++)
+  {
+    bucket= (ACL_USER_BUCKET*) my_hash_element(&acl_users_index, i);
+    if (!(bucket->positions= (uint*) alloc_root(&acl_users_index_memory,
+                                                bucket->elements *
+                                                sizeof(uint))))
+      DBUG_VOID_RETURN;
+    bucket->elements= 0;
+  }
+
+  for (i=0 ; i < acl_users.elements ; i++)
+  {
+    ACL_USER *acl_user=dynamic_element(&acl_users,i,ACL_USER*);
+    bucket= find_acl_user_bucket(acl_user->user ? acl_user->user : "");
+    bucket->positions[bucket->elements++]= i;
+  }
+
+  acl_users_index_valid= true;
+  DBUG_VOID_RETURN;
+}
+
+
+static void free_acl_users_index(void)
+{
+  acl_users_index_valid= false;
+  my_hash_free(&acl_users_index);
+  free_root(&acl_users_index_memory, MYF(0));
+}
+
+
+/**
+  Stop using the index of acl_users until it is rebuilt.
+  To be called before entries of acl_users are dropped or renamed.
+*/
+
+void invalidate_acl_users_index(void)
+{
+  mysql_mutex_assert_owner(&acl_cache->lock);
+  acl_users_index_valid= false;
+}
+
+
+Acl_user_iterator::Acl_user_iterator(const char *user, bool with_anonymous)
+  : m_user_pos(NULL), m_user_end(NULL), m_anon_pos(NULL), m_anon_end(NULL),
+    m_scan(0), m_scan_all(!acl_users_index_valid)
+{
+  ACL_USER_BUCKET *bucket;
+
+  mysql_mutex_assert_owner(&acl_cache->lock);
+  if (m_scan_all)
+    return;
+
+  if ((bucket= find_acl_user_bucket(user)))
+  {
+    m_user_pos= bucket->positions;
+    m_user_end= bucket->positions + bucket->elements;
+  }
+  if (with_anonymous && user[0] && (bucket= find_acl_user_bucket("")))
+  {
+    m_anon_pos= bucket->positions;
+    m_anon_end= bucket->positions + bucket->elements;
+  }
+}
+
+
+ACL_USER *Acl_user_iterator::next()
+{
+  uint pos;
+
+  if (m_scan_all)
+  {
+    if (m_scan >= acl_users.elements)
+      return NULL;
+    pos= m_scan++;
+  }
+  else if (m_user_pos < m_user_end &&
+           (m_anon_pos == m_anon_end || *m_user_pos < *m_anon_pos))
+    pos= *m_user_pos++;
+  else if (m_anon_pos < m_anon_end)
+    pos= *m_anon_pos++;
+  else
+    return NULL;
+  return dynamic_element(&acl_users, pos, ACL_USER*);
+}
+
+
+/**
+  Clear acl_cache and the per-connection caches of its entries
+  (@sa Acl_db_access_cache).
+
+  @note Must be called with acl_cache->lock held, unless the privileges
+        are being loaded at server start.
+*/
+
+void clear_acl_cache(void)
+{
+  acl_cache->clear(1);
+  my_atomic_rwlock_wrlock(&acl_cache_version_lock);
+  my_atomic_add32(&acl_cache_version, 1);
+  my_atomic_rwlock_wrunlock(&acl_cache_version_lock);
+}
+
+
+/* Find the privileges for a db in the cache of the connection */
+
+static bool get_cached_db_access(THD *thd, const char *key, size_t key_length,
+                                 ulong *access)
+{
+  Acl_db_access_cache *cache= &thd->acl_db_access_cache;
+  int32 version;
+
+  my_atomic_rwlock_rdlock(&acl_cache_version_lock);
+  version= my_atomic_load32(&acl_cache_version);
+  my_atomic_rwlock_rdunlock(&acl_cache_version_lock);
+
+  for (uint i= 0; i < ACL_DB_ACCESS_CACHE_SIZE; i++)
+  {
+    Acl_db_access_cache::Entry *entry= &cache->entries[i];
+    if (entry->key_length == key_length && entry->version == version &&
+        !memcmp(entry->key, key, key_length))
+    {
+      *access= entry->access;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/*
+  Remember the privileges for a db in the cache of the connection.
+  Called with acl_cache->lock held, so that the version matches the
+  privileges.
+*/
+
+static void cache_db_access(THD *thd, const char *key, size_t key_length,
+                            ulong access)
+{
+  Acl_db_access_cache *cache= &thd->acl_db_access_cache;
+  Acl_db_access_cache::Entry *entry= &cache->entries[cache->next_victim];
+
+  mysql_mutex_assert_owner(&acl_cache->lock);
+  cache->next_victim= (cache->next_victim + 1) % ACL_DB_ACCESS_CACHE_SIZE;
+  entry->version= acl_cache_version;
+  entry->access= access;
+  entry->key_length= key_length;
+  memcpy(entry->key, key, key_length);
+}
+
+
 /*
   Get privilege for a host, user and db combination
 
@@ -868,6 +1092,7 @@ ulong acl_get(const char *host, const char *ip,
   size_t key_length, copy_length;
   char key[ACL_KEY_LENGTH],*tmp_db,*end;
   acl_entry *entry;
+  THD *thd= current_thd;
   DBUG_ENTER("acl_get");
 
   copy_length= (size_t) (strlen(ip ? ip : "") +
@@ -879,7 +1104,6 @@ ulong acl_get(const char *host, const char *ip,
   if (copy_length >= ACL_KEY_LENGTH)
     DBUG_RETURN(0);
 
-  mysql_mutex_lock(&acl_cache->lock);
   end=strmov((tmp_db=strmov(strmov(key, ip ? ip : "")+1,user)+1),db);
   if (lower_case_table_names)
   {
@@ -887,10 +1111,20 @@ ulong acl_get(const char *host, const char *ip,
     db=tmp_db;
   }
   key_length= (size_t) (end-key);
+  if (!db_is_pattern && thd &&
+      get_cached_db_access(thd, key, key_length, &db_access))
+  {
+    DBUG_PRINT("exit", ("access: 0x%lx", db_access));
+    DBUG_RETURN(db_access);
+  }
+
+  mysql_mutex_lock(&acl_cache->lock);
   if (!db_is_pattern && (entry=(acl_entry*) acl_cache->search((uchar*) key,
                                                               key_length)))
   {
     db_access=entry->access;
+    if (thd)
+      cache_db_access(thd, key, key_length, db_access);
     mysql_mutex_unlock(&acl_cache->lock);
     DBUG_PRINT("exit", ("access: 0x%lx", db_access));
     DBUG_RETURN(db_access);
@@ -929,6 +1163,8 @@ exit:
     memcpy((uchar*) entry->key,key,key_length);
     acl_cache->add(entry);
   }
+  if (!db_is_pattern && thd)
+    cache_db_access(thd, key, key_length, db_access & host_access);
   mysql_mutex_unlock(&acl_cache->lock);
   DBUG_PRINT("exit", ("access: 0x%lx", db_access & host_access));
   DBUG_RETURN(db_access & host_access);
@@ -999,6 +1235,7 @@ static void init_check_host(void)
   }
   freeze_size(&acl_wild_hosts);
   freeze_size(&acl_check_hosts.array);
+  init_acl_users_index();
   DBUG_VOID_RETURN;
 }
 
@@ -1015,6 +1252,7 @@ void rebuild_check_host(void)
 {
   delete_dynamic(&acl_wild_hosts);
   my_hash_free(&acl_check_hosts);
+  free_acl_users_index();
   init_check_host();
 }
 
@@ -1073,9 +1311,10 @@ bool acl_getroot(Security_context *sctx, char *user, char *host,
      a stored procedure; user is set to what is actually a
      priv_user, which can be ''.
   */
-  for (i=0 ; i < acl_users.elements ; i++)
+  Acl_user_iterator it(user, false);
+  ACL_USER *acl_user_tmp;
+  while ((acl_user_tmp= it.next()))
   {
-    ACL_USER *acl_user_tmp= dynamic_element(&acl_users,i,ACL_USER*);
     if ((!acl_user_tmp->user && !user[0]) ||
         (acl_user_tmp->user && strcmp(user, acl_user_tmp->user) == 0))
     {
@@ -1282,6 +1521,7 @@ my_bool acl_init(bool dont_read_acl_tables)
                            (my_hash_get_key) acl_entry_get_key,
                            (my_hash_free_key) free,
                            &my_charset_utf8_bin);
+  my_atomic_rwlock_init(&acl_cache_version_lock);
 
   /*
     cache built-in native authentication plugins,
@@ -1354,7 +1594,7 @@ static my_bool acl_load(THD *thd, TABLE_LIST *tables)
   grant_version++; /* Privileges updated */
 
   
-  acl_cache->clear(1);                          // Clear locked hostname cache
+  clear_acl_cache();                            // Clear locked hostname cache
 
   init_sql_alloc(key_memory_acl_mem,
                  &global_acl_memory, ACL_ALLOC_BLOCK_SIZE, 0);
@@ -1783,14 +2023,16 @@ void acl_free(bool end)
   delete_dynamic(&acl_wild_hosts);
   delete_dynamic(&acl_proxy_users);
   my_hash_free(&acl_check_hosts);
+  free_acl_users_index();
   plugin_unlock(0, native_password_plugin);
   plugin_unlock(0, old_password_plugin);
   if (!end)
-    acl_cache->clear(1); /* purecov: inspected */
+    clear_acl_cache(); /* purecov: inspected */
   else
   {
     delete acl_cache;
     acl_cache=0;
+    my_atomic_rwlock_destroy(&acl_cache_version_lock);
   }
 }
 
@@ -1862,6 +2104,7 @@ my_bool acl_reload(THD *thd)
   old_mem= global_acl_memory;
   delete_dynamic(&acl_wild_hosts);
   my_hash_free(&acl_check_hosts);
+  free_acl_users_index();
 
   if ((return_val= acl_load(thd, tables)))
   {                                     // Error. Revert to old list
@@ -2323,9 +2566,10 @@ void acl_update_user(const char *user, const char *host,
 {
   DBUG_ENTER("acl_update_user");
   mysql_mutex_assert_owner(&acl_cache->lock);
-  for (uint i=0 ; i < acl_users.elements ; i++)
+  Acl_user_iterator it(user, false);
+  ACL_USER *acl_user;
+  while ((acl_user= it.next()))
   {
-    ACL_USER *acl_user=dynamic_element(&acl_users,i,ACL_USER*);
     if ((!acl_user->user && !user[0]) ||
         (acl_user->user && !strcmp(user,acl_user->user)))
     {
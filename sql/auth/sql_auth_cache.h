@@ -257,6 +257,32 @@ extern hash_filo *acl_cache;
 extern HASH acl_check_hosts;
 extern bool allow_all_hosts;
 extern uint grant_version; /* Version of priv tables */
+extern volatile int32 acl_cache_version;
+
+void clear_acl_cache(void);
+void invalidate_acl_users_index(void);
+
+
+/**
+  Iterator over the entries of acl_users which can match a user name, in
+  the order of acl_users: the entries for the user name and optionally
+  the anonymous ones. While the index of acl_users is being rebuilt all
+  entries are returned, so the caller must still check the user name.
+
+  @note acl_cache->lock must be held while the iterator is used.
+*/
+
+class Acl_user_iterator
+{
+public:
+  Acl_user_iterator(const char *user, bool with_anonymous);
+  ACL_USER *next();
+private:
+  const uint *m_user_pos, *m_user_end;
+  const uint *m_anon_pos, *m_anon_end;
+  uint m_scan;
+  bool m_scan_all;
+};
 
 GRANT_NAME *name_hash_search(HASH *name_hash,
                              const char *host,const char* ip,
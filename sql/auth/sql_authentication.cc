@@ -877,9 +877,10 @@ static bool find_mpvio_user(MPVIO_EXT *mpvio)
   DBUG_PRINT("info", ("entry: %s", mpvio->auth_info.user_name));
   DBUG_ASSERT(mpvio->acl_user == 0);
   mysql_mutex_lock(&acl_cache->lock);
-  for (uint i=0; i < acl_users.elements; i++)
+  Acl_user_iterator it(mpvio->auth_info.user_name, true);
+  ACL_USER *acl_user_tmp;
+  while ((acl_user_tmp= it.next()))
   {
-    ACL_USER *acl_user_tmp= dynamic_element(&acl_users, i, ACL_USER*);
     if ((!acl_user_tmp->user || 
          !strcmp(mpvio->auth_info.user_name, acl_user_tmp->user)) &&
         acl_user_tmp->host.compare_hostname(mpvio->host, mpvio->ip))
@@ -1723,6 +1724,15 @@ skip_to_ssl:
                                 mpvio->charset_adapter->charset()))
     return packet_error;
 
+  /* The compression level requested for the packets of the connection */
+  if ((mpvio->client_capabilities & CLIENT_COMPRESS_STREAM) &&
+      bytes_remaining_in_packet > 0)
+  {
+    mpvio->compression_level= MY_MIN((uint) (uchar) *end, 9);
+    end++;
+    bytes_remaining_in_packet--;
+  }
+
   char db_buff[NAME_LEN + 1];           // buffer to store db in utf8
   char user_buff[USERNAME_LENGTH + 1];  // buffer to store user in utf8
   uint dummy_errors;
@@ -2098,6 +2108,7 @@ server_mpvio_initialize(THD *thd, MPVIO_EXT *mpvio,
   mpvio->status= MPVIO_EXT::FAILURE;
 
   mpvio->client_capabilities= thd->client_capabilities;
+  mpvio->compression_level= 0;
   mpvio->mem_root= thd->mem_root;
   mpvio->scramble= thd->scramble;
   mpvio->rand= &thd->rand;
@@ -2457,6 +2468,21 @@ acl_authenticate(THD *thd, uint com_change_user_pkt_len)
                                       mpvio.auth_info.external_user, MYF(0)));
 
 
+  /*
+    The packets after the OK are compressed, with one stream per
+    connection if the client asked for it.
+  */
+  if ((thd->client_capabilities & CLIENT_COMPRESS) &&
+      (thd->client_capabilities & CLIENT_COMPRESS_STREAM) &&
+      net_compress_stream_init(&thd->net, mpvio.compression_level ?
+                               mpvio.compression_level :
+                               opt_protocol_compression_level))
+  {
+    release_user_connection(thd);
+    my_error(ER_OUT_OF_RESOURCES, MYF(0));
+    DBUG_RETURN(1);
+  }
+
   if (res == CR_OK_HANDSHAKE_COMPLETE)
     thd->get_stmt_da()->disable_status();
   else
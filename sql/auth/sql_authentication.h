@@ -72,6 +72,7 @@ struct MPVIO_EXT : public MYSQL_PLUGIN_VIO
   uint      *server_status;
   NET *net;
   ulong max_client_packet_length;
+  uint compression_level;       ///< requested by the client, 0 if none
   char *ip;
   char *host;
   Thd_charset_adapter *charset_adapter;
@@ -393,7 +393,7 @@ bool change_password(THD *thd, const char *host, const char *user,
     goto end;
   }
 
-  acl_cache->clear(1);                          // Clear locked hostname cache
+  clear_acl_cache();                            // Clear locked hostname cache
   mysql_mutex_unlock(&acl_cache->lock);
   result= 0;
   query_length= sprintf(buff, "SET PASSWORD FOR '%-.120s'@'%-.120s'='%-.120s'",
@@ -630,6 +630,7 @@ static int handle_grant_struct(enum enum_acl_lists struct_no, bool drop,
     {
       switch ( struct_no ) {
       case USER_ACL:
+        invalidate_acl_users_index();
         delete_dynamic_element(&acl_users, idx);
         elements--;
         /*
@@ -670,6 +671,7 @@ static int handle_grant_struct(enum enum_acl_lists struct_no, bool drop,
     {
       switch ( struct_no ) {
       case USER_ACL:
+        invalidate_acl_users_index();
         acl_user->user= strdup_root(&global_acl_memory, user_to->user.str);
         acl_user->host.update_hostname(strdup_root(&global_acl_memory, user_to->host.str));
         break;
@@ -1371,7 +1373,7 @@ bool mysql_user_password_expire(THD *thd, List <LEX_USER> &list)
     some_passwords_expired= true;
   }
 
-  acl_cache->clear(1);                          // Clear locked hostname cache
+  clear_acl_cache();                            // Clear locked hostname cache
   mysql_mutex_unlock(&acl_cache->lock);
 
   if (result)
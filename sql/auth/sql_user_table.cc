@@ -1015,7 +1015,7 @@ int replace_user_table(THD *thd, TABLE *table, LEX_USER *combo,
 end:
   if (!error)
   {
-    acl_cache->clear(1);			// Clear privilege cache
+    clear_acl_cache();			// Clear privilege cache
     if (old_row_exists)
       acl_update_user(combo->user.str, combo->host.str,
                       combo->password.str, password_len,
@@ -1134,7 +1134,7 @@ int replace_db_table(TABLE *table, const char *db,
       goto table_error; /* purecov: deadcode */
   }
 
-  acl_cache->clear(1);                          // Clear privilege cache
+  clear_acl_cache();                            // Clear privilege cache
   if (old_row_exists)
     acl_update_db(combo.user.str,combo.host.str,db,rights);
   else
@@ -1240,7 +1240,7 @@ int replace_proxies_priv_table(THD *thd, TABLE *table, const LEX_USER *user,
       goto table_error; /* purecov: inspected */
   }
 
-  acl_cache->clear(1);                          // Clear privilege cache
+  clear_acl_cache();                            // Clear privilege cache
   if (old_row_exists)
   {
     new_grant.init(user->host.str, user->user.str,
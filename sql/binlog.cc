@@ -64,6 +64,33 @@ static int limit_unsafe_warning_count= 0;
 
 static handlerton *binlog_hton;
 bool opt_binlog_order_commits= true;
+ulong binlog_transaction_dependency_tracking= DEPENDENCY_TRACKING_COMMIT_ORDER;
+ulong binlog_transaction_dependency_history_size= 25000;
+ulong opt_binlog_group_commit_sync_delay= 0;
+ulong opt_binlog_group_commit_sync_no_delay_count= 0;
+
+/*
+  Group commit statistics, updated by the sync stage leader under
+  LOCK_sync. binlog_group_commit_sizes[i] counts the groups of 2^i to
+  2^(i+1)-1 transactions, the last bucket counts all larger groups.
+*/
+static ulong binlog_group_commits= 0;
+static ulong binlog_group_commit_trx= 0;
+static ulong binlog_group_commit_sizes[8];
+
+SHOW_VAR binlog_group_commit_status_vars[]= {
+  {"groups",        (char*) &binlog_group_commits,           SHOW_LONG},
+  {"transactions",  (char*) &binlog_group_commit_trx,        SHOW_LONG},
+  {"size_1",        (char*) &binlog_group_commit_sizes[0],   SHOW_LONG},
+  {"size_2_3",      (char*) &binlog_group_commit_sizes[1],   SHOW_LONG},
+  {"size_4_7",      (char*) &binlog_group_commit_sizes[2],   SHOW_LONG},
+  {"size_8_15",     (char*) &binlog_group_commit_sizes[3],   SHOW_LONG},
+  {"size_16_31",    (char*) &binlog_group_commit_sizes[4],   SHOW_LONG},
+  {"size_32_63",    (char*) &binlog_group_commit_sizes[5],   SHOW_LONG},
+  {"size_64_127",   (char*) &binlog_group_commit_sizes[6],   SHOW_LONG},
+  {"size_128_more", (char*) &binlog_group_commit_sizes[7],   SHOW_LONG},
+  {NullS, NullS, SHOW_LONG}
+};
 
 const char *log_bin_index= 0;
 const char *log_bin_basename= 0;
@@ -317,8 +344,8 @@ public:
     ptr_binlog_cache_use(ptr_binlog_cache_use_arg),
     ptr_binlog_cache_disk_use(ptr_binlog_cache_disk_use_arg)
   {
-    reset();
     flags.transactional= trx_cache_arg;
+    reset();
     cache_log.end_of_file= saved_max_binlog_cache_size;
   }
 
@@ -378,6 +405,31 @@ public:
     return flags.with_xid;
   }
 
+  bool is_writeset_unsafe() const
+  {
+    return flags.writeset_unsafe;
+  }
+
+  /**
+    Marks the writeset as not describing the changes in the cache, for
+    instance because a statement was logged in statement format.
+  */
+  void set_writeset_unsafe()
+  {
+    flags.writeset_unsafe= true;
+    writeset.clear();
+  }
+
+  void add_to_writeset(ulonglong hash)
+  {
+    if (flags.writeset_unsafe)
+      return;
+    if (writeset.size() >= binlog_transaction_dependency_history_size)
+      set_writeset_unsafe();
+    else
+      writeset.insert(hash);
+  }
+
   bool is_trx_cache() const
   {
     return flags.transactional;
@@ -411,10 +463,20 @@ public:
         DBUG_ASSERT( error == 0 );
     }
 
+    /*
+      A large transaction may have grown the buffer in memory, give that
+      back instead of keeping it for the lifetime of the session.
+    */
+    shrink_io_cache(&cache_log, flags.transactional ? binlog_cache_size :
+                                                      binlog_stmt_cache_size);
+    cache_log.max_buffer_length= binlog_cache_max_memory_size;
+
     flags.incident= false;
     flags.with_xid= false;
     flags.immediate= false;
     flags.finalized= false;
+    flags.writeset_unsafe= false;
+    writeset.clear();
     /*
       The truncate function calls reinit_io_cache that calls my_b_flush_io_cache
       which may increase disk_writes. This breaks the disk_writes use by the
@@ -470,6 +532,12 @@ public:
   */
   Group_cache group_cache;
 
+  /**
+    Hashes of the primary and unique key values changed by the rows
+    written to this cache, see Writeset_history.
+  */
+  std::set<ulonglong> writeset;
+
 protected:
   /*
     It truncates the cache to a certain position. This includes deleting the
@@ -533,6 +601,12 @@ protected:
       This indicates that the cache contain an XID event.
      */
     bool with_xid:1;
+
+    /*
+      This indicates that the writeset does not describe all the
+      changes in the cache and cannot be used to find its dependencies.
+     */
+    bool writeset_unsafe:1;
   } flags;
 
 private:
@@ -923,6 +997,32 @@ static int binlog_close_connection(handlerton *hton, THD *thd)
   DBUG_RETURN(0);
 }
 
+/**
+  Checks if the changes done by an event are described by the writeset
+  of the cache, that is, if it is a row event or one of the events
+  framing the rows.
+*/
+static bool is_writeset_event(Log_event *ev)
+{
+  switch (ev->get_type_code())
+  {
+  case WRITE_ROWS_EVENT:
+  case UPDATE_ROWS_EVENT:
+  case DELETE_ROWS_EVENT:
+  case WRITE_ROWS_EVENT_V1:
+  case UPDATE_ROWS_EVENT_V1:
+  case DELETE_ROWS_EVENT_V1:
+  case TABLE_MAP_EVENT:
+  case ROWS_QUERY_LOG_EVENT:
+  case XID_EVENT:
+    return true;
+  case QUERY_EVENT:
+    return static_cast<Query_log_event*>(ev)->is_trans_keyword();
+  default:
+    return false;
+  }
+}
+
 int binlog_cache_data::write_event(THD *thd, Log_event *ev)
 {
   DBUG_ENTER("binlog_cache_data::write_event");
@@ -964,6 +1064,8 @@ int binlog_cache_data::write_event(THD *thd, Log_event *ev)
     }
     if (ev->get_type_code() == XID_EVENT)
       flags.with_xid= true;
+    if (!flags.writeset_unsafe && !is_writeset_event(ev))
+      set_writeset_unsafe();
     if (ev->is_using_immediate_logging())
       flags.immediate= true;
   }
@@ -1230,6 +1332,10 @@ binlog_cache_data::flush(THD *thd, my_off_t *bytes_written, bool *wrote_xid)
       transactions might trigger attempts to write to the binary log
       if the cache is not reset.
      */
+    cache_log.commit_seq_no=
+      mysql_bin_log.writeset_history.get_commit_parent(
+        cache_log.commit_seq_no,
+        is_trx_cache() && !flags.writeset_unsafe ? &writeset : NULL);
     if (!(error= gtid_before_write_cache(thd, this)))
       error= mysql_bin_log.write_cache(thd, this);
 
@@ -1402,6 +1508,7 @@ Stage_manager::Mutex_queue::append(THD *first)
                        (ulonglong) m_last));
   bool empty= (m_first == NULL);
   *m_last= first;
+  m_size++;
   DBUG_PRINT("info", ("m_first: 0x%llx, &m_first: 0x%llx, m_last: 0x%llx",
                        (ulonglong) m_first, (ulonglong) &m_first,
                        (ulonglong) m_last));
@@ -1411,7 +1518,10 @@ Stage_manager::Mutex_queue::append(THD *first)
     the queue as well.
   */
   while (first->next_to_commit)
+  {
     first= first->next_to_commit;
+    m_size++;
+  }
   m_last= &first->next_to_commit;
   DBUG_PRINT("info", ("m_first: 0x%llx, &m_first: 0x%llx, m_last: 0x%llx",
                         (ulonglong) m_first, (ulonglong) &m_first,
@@ -1437,11 +1547,15 @@ Stage_manager::Mutex_queue::pop_front()
     queue to NULL.
   */
   if (result)
+  {
     m_first= result->next_to_commit;
+    m_size--;
+  }
   if (m_first == NULL)
   {
     more= false;
     m_last = &m_first;
+    m_size= 0;
   }
   DBUG_ASSERT(m_first || m_last == &m_first);
   unlock();
@@ -1502,6 +1616,7 @@ THD *Stage_manager::Mutex_queue::fetch_and_empty()
   THD *result= m_first;
   m_first= NULL;
   m_last= &m_first;
+  m_size= 0;
   DBUG_PRINT("info", ("m_first: 0x%llx, &m_first: 0x%llx, m_last: 0x%llx",
                        (ulonglong) m_first, (ulonglong) &m_first,
                        (ulonglong) m_last));
@@ -1511,6 +1626,21 @@ THD *Stage_manager::Mutex_queue::fetch_and_empty()
   DBUG_RETURN(result);
 }
 
+void Stage_manager::wait_count_or_timeout(ulong count, ulonglong usec,
+                                          StageID stage)
+{
+  DBUG_ENTER("Stage_manager::wait_count_or_timeout");
+  const ulonglong start= my_micro_time();
+  /* Sleep in slices so that a full queue ends the wait early. */
+  const ulong slice= (ulong) max<ulonglong>(1, usec / 10);
+
+  while (my_micro_time() < start + usec &&
+         (count == 0 || m_queue[stage].get_size() < count))
+    my_sleep(slice);
+  DBUG_VOID_RETURN;
+}
+
+
 #ifndef DBUG_OFF
 void Stage_manager::clear_preempt_status(THD *head)
 {
@@ -1833,6 +1963,35 @@ static uint purge_log_get_error_code(int res)
 
 #ifdef HAVE_REPLICATION
 
+class Adjust_offset : public Do_THD_Impl
+{
+public:
+  Adjust_offset(my_off_t value) : m_purge_offset(value) {}
+  virtual void operator()(THD *thd)
+  {
+    LOG_INFO* linfo;
+    mysql_mutex_lock(&thd->LOCK_thd_data);
+    if ((linfo = thd->current_linfo))
+    {
+      mysql_mutex_lock(&linfo->lock);
+      /*
+	Index file offset can be less that purge offset only if
+	we just started reading the index file. In that case
+	we have nothing to adjust
+      */
+      if (linfo->index_file_offset < m_purge_offset)
+	linfo->fatal = (linfo->index_file_offset != 0);
+      else
+	linfo->index_file_offset -= m_purge_offset;
+      mysql_mutex_unlock(&linfo->lock);
+    }
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
+  }
+private:
+  my_off_t m_purge_offset;
+};
+
+
 /*
   Adjust the position pointer in the binary log file for all running slaves
 
@@ -1856,60 +2015,48 @@ static uint purge_log_get_error_code(int res)
 
 static void adjust_linfo_offsets(my_off_t purge_offset)
 {
-  mysql_mutex_lock(&LOCK_thread_count);
-
-  Thread_iterator it= global_thread_list_begin();
-  Thread_iterator end= global_thread_list_end();
-  for (; it != end; ++it)
-  {
-    LOG_INFO* linfo;
-    if ((linfo = (*it)->current_linfo))
-    {
-      mysql_mutex_lock(&linfo->lock);
-      /*
-	Index file offset can be less that purge offset only if
-	we just started reading the index file. In that case
-	we have nothing to adjust
-      */
-      if (linfo->index_file_offset < purge_offset)
-	linfo->fatal = (linfo->index_file_offset != 0);
-      else
-	linfo->index_file_offset -= purge_offset;
-      mysql_mutex_unlock(&linfo->lock);
-    }
-  }
-  mysql_mutex_unlock(&LOCK_thread_count);
+  Adjust_offset adjust_offset(purge_offset);
+  do_for_all_thd(&adjust_offset);
 }
 
 
-static int log_in_use(const char* log_name)
+class Log_in_use : public Do_THD_Impl
 {
-  size_t log_name_len = strlen(log_name) + 1;
-  int thread_count=0;
-
-  mysql_mutex_lock(&LOCK_thread_count);
-
-  Thread_iterator it= global_thread_list_begin();
-  Thread_iterator end= global_thread_list_end();
-  for (; it != end; ++it)
+public:
+  Log_in_use(const char* value) : m_log_name(value), m_count(0)
+  {
+    m_log_name_len = strlen(m_log_name) + 1;
+  }
+  virtual void operator()(THD *thd)
   {
     LOG_INFO* linfo;
-    if ((linfo = (*it)->current_linfo))
+    mysql_mutex_lock(&thd->LOCK_thd_data);
+    if ((linfo = thd->current_linfo))
     {
       mysql_mutex_lock(&linfo->lock);
-      if(!memcmp(log_name, linfo->log_file_name, log_name_len))
+      if(!memcmp(m_log_name, linfo->log_file_name, m_log_name_len))
       {
-        thread_count++;
+        m_count++;
         sql_print_warning("file %s was not purged because it was being read"
-                          "by thread number %llu", log_name,
-                          (ulonglong)(*it)->thread_id);
+                          "by thread number %llu", m_log_name,
+                          (ulonglong)thd->thread_id);
       }
       mysql_mutex_unlock(&linfo->lock);
     }
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
   }
+  int get_count() { return m_count; }
+private:
+  const char* m_log_name;
+  size_t m_log_name_len;
+  int m_count;
+};
 
-  mysql_mutex_unlock(&LOCK_thread_count);
-  return thread_count;
+static int log_in_use(const char* log_name)
+{
+  Log_in_use log_in_use(log_name);
+  do_for_all_thd(&log_in_use);
+  return log_in_use.get_count();
 }
 
 static bool purge_error_message(THD* thd, int res)
@@ -1948,7 +2095,8 @@ int check_binlog_magic(IO_CACHE* log, const char** errmsg)
 }
 
 
-File open_binlog_file(IO_CACHE *log, const char *log_file_name, const char **errmsg)
+File open_binlog_file(IO_CACHE *log, const char *log_file_name, const char **errmsg,
+                      size_t cache_size)
 {
   File file;
   DBUG_ENTER("open_binlog_file");
@@ -1962,7 +2110,7 @@ File open_binlog_file(IO_CACHE *log, const char *log_file_name, const char **err
     *errmsg = "Could not open log file";
     goto err;
   }
-  if (init_io_cache(log, file, IO_SIZE*2, READ_CACHE, 0, 0,
+  if (init_io_cache(log, file, cache_size, READ_CACHE, 0, 0,
                     MYF(MY_WME|MY_DONT_CHECK_FILESIZE)))
   {
     sql_print_error("Failed to create a cache on log (file '%s')",
@@ -2305,9 +2453,9 @@ bool show_binlog_events(THD *thd, MYSQL_BIN_LOG *binary_log)
       goto err;
     }
 
-    mysql_mutex_lock(&LOCK_thread_count);
+    mysql_mutex_lock(&thd->LOCK_thd_data);
     thd->current_linfo = &linfo;
-    mysql_mutex_unlock(&LOCK_thread_count);
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
 
     if ((file=open_binlog_file(&log, linfo.log_file_name, &errmsg)) < 0)
       goto err;
@@ -2408,9 +2556,9 @@ err:
   else
     my_eof(thd);
 
-  mysql_mutex_lock(&LOCK_thread_count);
+  mysql_mutex_lock(&thd->LOCK_thd_data);
   thd->current_linfo = 0;
-  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_mutex_unlock(&thd->LOCK_thd_data);
   thd->variables.max_allowed_packet= old_max_allowed_packet;
   DBUG_RETURN(ret);
 }
@@ -2463,7 +2611,8 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period,
    is_relay_log(0), signal_cnt(0),
    checksum_alg_reset(BINLOG_CHECKSUM_ALG_UNDEF),
    relay_log_checksum_alg(BINLOG_CHECKSUM_ALG_UNDEF),
-   previous_gtid_set(0)
+   previous_gtid_set(0), m_avg_sync_usec(0), m_avg_arrival_usec(0),
+   m_last_group_usec(0)
 {
   /*
     We don't want to initialize locks here as such initialization depends on
@@ -2487,6 +2636,8 @@ void MYSQL_BIN_LOG::cleanup()
   if (inited)
   {
     inited= 0;
+    if (log_state == LOG_OPENED && gtid_index.is_active())
+      gtid_index.write(log_file_name, my_b_tell(&log_file));
     close(LOG_CLOSE_INDEX|LOG_CLOSE_STOP_EVENT);
     mysql_mutex_destroy(&LOCK_log);
     mysql_mutex_destroy(&LOCK_index);
@@ -2909,6 +3060,328 @@ bool MYSQL_BIN_LOG::open_index_file(const char *index_file_name_arg,
 }
 
 
+/*
+  Format of a GTID index file, all integers little-endian:
+
+    4 bytes  GTID_INDEX_MAGIC
+    8 bytes  size of the binary log when the index was written
+    4 bytes  length of the encoded GTIDs of the Previous_gtids_log_event
+    n bytes  the encoded GTIDs (Gtid_set::encode)
+    4 bytes  length of the encoded GTIDs written to the binary log
+    n bytes  the encoded GTIDs
+    4 bytes  number of checkpoints, each one:
+               8 bytes  position at the end of a transaction
+               4 bytes  length of the encoded GTIDs before the position
+               n bytes  the encoded GTIDs
+    4 bytes  checksum of everything above
+*/
+#define GTID_INDEX_EXT ".gtid_index"
+#define GTID_INDEX_MAGIC 0x58444947
+/* Minimum distance between two checkpoints in the binary log. */
+#define GTID_INDEX_CHECKPOINT_BYTES (4 * 1024 * 1024)
+
+static bool make_gtid_index_name(char *buf, const char *log_name)
+{
+  if (strlen(log_name) + sizeof(GTID_INDEX_EXT) > FN_REFLEN)
+    return true;
+  strxmov(buf, log_name, GTID_INDEX_EXT, NullS);
+  return false;
+}
+
+static void append_uint4(String *buf, uint32 n)
+{
+  char tmp[4];
+  int4store(tmp, n);
+  buf->append(tmp, 4);
+}
+
+static bool append_gtid_set(String *buf, const Gtid_set *set)
+{
+  size_t length= set->get_encoded_length();
+  if (buf->reserve(4 + length))
+    return true;
+  append_uint4(buf, (uint32) length);
+  set->encode((uchar *) buf->ptr() + buf->length());
+  buf->length(buf->length() + length);
+  return false;
+}
+
+/**
+  The parts of a GTID index file, pointing into the buffer it was read
+  into.
+*/
+struct Gtid_index_parts
+{
+  my_off_t file_size;
+  const uchar *prev_gtids;
+  size_t prev_gtids_length;
+  const uchar *gtids;
+  size_t gtids_length;
+  uint n_checkpoints;
+  const uchar *checkpoints;
+  size_t checkpoints_length;
+};
+
+/**
+  Read the GTID index of the binary log log_name into buf and split it
+  into its parts. The index must be intact and no longer than the binary
+  log.
+
+  @return false on success, true if there is no valid index.
+*/
+static bool read_gtid_index(const char *log_name, String *buf,
+                            Gtid_index_parts *parts)
+{
+  char index_name[FN_REFLEN];
+  MY_STAT log_stat, index_stat;
+  File file;
+
+  if (make_gtid_index_name(index_name, log_name) ||
+      !mysql_file_stat(key_file_binlog, log_name, &log_stat, MYF(0)) ||
+      !mysql_file_stat(key_file_binlog, index_name, &index_stat, MYF(0)) ||
+      index_stat.st_size < 32 || buf->reserve(index_stat.st_size))
+    return true;
+
+  if ((file= mysql_file_open(key_file_binlog, index_name,
+                             O_RDONLY | O_BINARY, MYF(0))) < 0)
+    return true;
+  bool error= mysql_file_read(file, (uchar *) buf->ptr(), index_stat.st_size,
+                              MYF(MY_NABP)) != 0;
+  mysql_file_close(file, MYF(0));
+  if (error)
+    return true;
+  buf->length(index_stat.st_size);
+
+  const uchar *p= (const uchar *) buf->ptr();
+  const uchar *end= p + buf->length() - 4;
+  if (uint4korr(p) != GTID_INDEX_MAGIC ||
+      uint4korr(end) != my_checksum(0L, p, end - p))
+    return true;
+  p+= 4;
+  parts->file_size= uint8korr(p);
+  p+= 8;
+  if (parts->file_size > (my_off_t) log_stat.st_size)
+    return true;
+
+  parts->prev_gtids_length= uint4korr(p);
+  p+= 4;
+  if (parts->prev_gtids_length > (size_t) (end - p))
+    return true;
+  parts->prev_gtids= p;
+  p+= parts->prev_gtids_length;
+
+  if (end - p < 4)
+    return true;
+  parts->gtids_length= uint4korr(p);
+  p+= 4;
+  if (parts->gtids_length > (size_t) (end - p))
+    return true;
+  parts->gtids= p;
+  p+= parts->gtids_length;
+
+  if (end - p < 4)
+    return true;
+  parts->n_checkpoints= uint4korr(p);
+  p+= 4;
+  parts->checkpoints= p;
+  parts->checkpoints_length= end - p;
+  return false;
+}
+
+bool Binlog_gtid_index::start(const char *log_name,
+                              const Gtid_set *prev_gtids)
+{
+  DBUG_ENTER("Binlog_gtid_index::start");
+  global_sid_lock->assert_some_lock();
+  stop();
+  remove(log_name);
+
+  m_gtids= new Gtid_set(global_sid_map);
+  if (m_gtids == NULL)
+    DBUG_RETURN(true);
+  m_prev_gtids.length(0);
+  m_checkpoints.length(0);
+  m_n_checkpoints= 0;
+  m_last_checkpoint_pos= 0;
+  if (append_gtid_set(&m_prev_gtids, prev_gtids))
+  {
+    stop();
+    DBUG_RETURN(true);
+  }
+  DBUG_RETURN(false);
+}
+
+void Binlog_gtid_index::stop()
+{
+  delete m_gtids;
+  m_gtids= NULL;
+  m_prev_gtids.free();
+  m_checkpoints.free();
+}
+
+bool Binlog_gtid_index::add_gtid(const Gtid &gtid, my_off_t end_pos)
+{
+  global_sid_lock->assert_some_lock();
+  DBUG_ASSERT(is_active());
+
+  if (m_gtids->ensure_sidno(gtid.sidno) != RETURN_STATUS_OK ||
+      m_gtids->_add_gtid(gtid) != RETURN_STATUS_OK)
+    return true;
+
+  if (end_pos >= m_last_checkpoint_pos + GTID_INDEX_CHECKPOINT_BYTES)
+  {
+    char tmp[8];
+    int8store(tmp, end_pos);
+    if (m_checkpoints.append(tmp, 8) ||
+        append_gtid_set(&m_checkpoints, m_gtids))
+      return true;
+    m_n_checkpoints++;
+    m_last_checkpoint_pos= end_pos;
+  }
+  return false;
+}
+
+bool Binlog_gtid_index::write(const char *log_name, my_off_t file_size)
+{
+  DBUG_ENTER("Binlog_gtid_index::write");
+  char index_name[FN_REFLEN];
+  String buf;
+  File file;
+  bool error;
+
+  if (!is_active() || make_gtid_index_name(index_name, log_name))
+  {
+    stop();
+    DBUG_RETURN(true);
+  }
+
+  char tmp[8];
+  append_uint4(&buf, GTID_INDEX_MAGIC);
+  int8store(tmp, file_size);
+  buf.append(tmp, 8);
+  buf.append(m_prev_gtids);
+  global_sid_lock->rdlock();
+  error= append_gtid_set(&buf, m_gtids);
+  global_sid_lock->unlock();
+  append_uint4(&buf, m_n_checkpoints);
+  buf.append(m_checkpoints);
+  append_uint4(&buf, my_checksum(0L, (const uchar *) buf.ptr(), buf.length()));
+  stop();
+
+  if (error ||
+      (file= mysql_file_create(key_file_binlog, index_name, 0,
+                               O_WRONLY | O_TRUNC | O_BINARY, MYF(0))) < 0)
+    error= true;
+  else
+  {
+    error= mysql_file_write(file, (const uchar *) buf.ptr(), buf.length(),
+                            MYF(MY_NABP)) != 0;
+    if (mysql_file_close(file, MYF(0)))
+      error= true;
+  }
+  if (error)
+  {
+    char errbuf[MYSYS_STRERROR_SIZE];
+    sql_print_warning("Could not write the GTID index '%s' (errno: %d - %s); "
+                      "the GTIDs of the binary log will be read from the "
+                      "binary log itself.", index_name, my_errno,
+                      my_strerror(errbuf, sizeof(errbuf), my_errno));
+    my_delete(index_name, MYF(0));
+  }
+  DBUG_RETURN(error);
+}
+
+bool Binlog_gtid_index::find_pos(const uchar *checkpoints, size_t length,
+                                 uint count, const Gtid_set *gtid_set,
+                                 my_off_t max_pos, my_off_t *pos)
+{
+  DBUG_ENTER("Binlog_gtid_index::find_pos");
+  Gtid_set checkpoint_gtids(gtid_set->get_sid_map());
+  const uchar *p= checkpoints;
+  const uchar *end= checkpoints + length;
+  bool found= false;
+
+  /*
+    The GTIDs of a checkpoint include those of the previous ones, so
+    the first checkpoint the slave misses GTIDs of ends the search.
+  */
+  for (uint i= 0; i < count && end - p >= 12; i++)
+  {
+    my_off_t checkpoint_pos= uint8korr(p);
+    size_t gtids_length= uint4korr(p + 8);
+    p+= 12;
+    if (checkpoint_pos > max_pos || gtids_length > (size_t) (end - p))
+      break;
+    checkpoint_gtids.clear();
+    if (checkpoint_gtids.add_gtid_encoding(p, gtids_length) !=
+        RETURN_STATUS_OK ||
+        !checkpoint_gtids.is_subset(gtid_set))
+      break;
+    *pos= checkpoint_pos;
+    found= true;
+    p+= gtids_length;
+  }
+  DBUG_PRINT("info", ("found=%d pos=%llu", found, found ? *pos : 0));
+  DBUG_RETURN(!found);
+}
+
+bool Binlog_gtid_index::find_pos(const Gtid_set *gtid_set, my_off_t max_pos,
+                                 my_off_t *pos) const
+{
+  if (!is_active())
+    return true;
+  return find_pos((const uchar *) m_checkpoints.ptr(), m_checkpoints.length(),
+                  m_n_checkpoints, gtid_set, max_pos, pos);
+}
+
+bool Binlog_gtid_index::read_gtids(const char *log_name, Gtid_set *all_gtids,
+                                   Gtid_set *prev_gtids, bool *has_gtids)
+{
+  DBUG_ENTER("Binlog_gtid_index::read_gtids");
+  String buf;
+  Gtid_index_parts parts;
+
+  if (read_gtid_index(log_name, &buf, &parts))
+    DBUG_RETURN(true);
+  if (all_gtids != NULL &&
+      (all_gtids->add_gtid_encoding(parts.prev_gtids,
+                                    parts.prev_gtids_length) !=
+       RETURN_STATUS_OK ||
+       all_gtids->add_gtid_encoding(parts.gtids, parts.gtids_length) !=
+       RETURN_STATUS_OK))
+    DBUG_RETURN(true);
+  if (prev_gtids != NULL &&
+      prev_gtids->add_gtid_encoding(parts.prev_gtids,
+                                    parts.prev_gtids_length) !=
+      RETURN_STATUS_OK)
+    DBUG_RETURN(true);
+  /* An empty encoded Gtid_set is just its number of SIDs. */
+  *has_gtids= parts.gtids_length > 8;
+  DBUG_PRINT("info", ("Got GTIDs from the GTID index of '%s'", log_name));
+  DBUG_RETURN(false);
+}
+
+bool Binlog_gtid_index::find_pos_in_file(const char *log_name,
+                                         const Gtid_set *gtid_set,
+                                         my_off_t *pos)
+{
+  String buf;
+  Gtid_index_parts parts;
+
+  if (read_gtid_index(log_name, &buf, &parts))
+    return true;
+  return find_pos(parts.checkpoints, parts.checkpoints_length,
+                  parts.n_checkpoints, gtid_set, parts.file_size, pos);
+}
+
+void Binlog_gtid_index::remove(const char *log_name)
+{
+  char index_name[FN_REFLEN];
+  if (!make_gtid_index_name(index_name, log_name))
+    my_delete(index_name, MYF(0));
+}
+
+
 /**
   Reads GTIDs from the given binlog file.
 
@@ -2939,6 +3412,13 @@ read_gtids_from_binlog(const char *filename, Gtid_set *all_gtids,
                        Gtid_set *prev_gtids, bool verify_checksum)
 {
   DBUG_ENTER("read_gtids_from_binlog");
+
+  bool has_gtids;
+  if (gtid_mode > 0 &&
+      !Binlog_gtid_index::read_gtids(filename, all_gtids, prev_gtids,
+                                     &has_gtids))
+    DBUG_RETURN(has_gtids ? GOT_GTIDS : GOT_PREVIOUS_GTIDS);
+
   DBUG_PRINT("info", ("Opening file %s", filename));
 
   /*
@@ -3474,6 +3954,10 @@ bool MYSQL_BIN_LOG::open_binlog(const char *log_name,
     else
       global_sid_lock->assert_some_wrlock();
     Previous_gtids_log_event prev_gtids_ev(previous_gtid_set);
+    if (!is_relay_log && gtid_index.start(log_file_name, previous_gtid_set))
+      sql_print_warning("Out of memory while starting the GTID index of "
+                        "'%s'; the binary log will not be indexed.",
+                        log_file_name);
     if (need_sid_lock)
       global_sid_lock->unlock();
     prev_gtids_ev.checksum_alg= s.checksum_alg;
@@ -3957,14 +4441,6 @@ bool MYSQL_BIN_LOG::reset_logs(THD* thd)
 
   ha_reset_logs(thd);
 
-  /*
-    The following mutex is needed to ensure that no threads call
-    'delete thd' as we would then risk missing a 'rollback' from this
-    thread. If the transaction involved MyISAM tables, it should go
-    into binlog even on rollback.
-  */
-  mysql_mutex_lock(&LOCK_thread_count);
-
   /*
     We need to get both locks to be sure that no one is trying to
     write to the index log file.
@@ -4000,6 +4476,7 @@ bool MYSQL_BIN_LOG::reset_logs(THD* thd)
 
   for (;;)
   {
+    Binlog_gtid_index::remove(linfo.log_file_name);
     if ((error= my_delete_allow_opened(linfo.log_file_name, MYF(0))) != 0)
     {
       if (my_errno == ENOENT) 
@@ -4086,7 +4563,6 @@ err:
   if (error == 1)
     name= const_cast<char*>(save_name);
   global_sid_lock->unlock();
-  mysql_mutex_unlock(&LOCK_thread_count);
   mysql_mutex_unlock(&LOCK_index);
   mysql_mutex_unlock(&LOCK_log);
   DBUG_RETURN(error);
@@ -4759,6 +5235,7 @@ int MYSQL_BIN_LOG::purge_index_entry(THD *thd, ulonglong *decrease_log_space,
         }
 
         DBUG_PRINT("info",("purging %s",log_info.log_file_name));
+        Binlog_gtid_index::remove(log_info.log_file_name);
         if (!my_delete(log_info.log_file_name, MYF(0)))
         {
           if (decrease_log_space)
@@ -4993,6 +5470,35 @@ bool MYSQL_BIN_LOG::is_active(const char *log_file_name_arg)
 }
 
 
+bool MYSQL_BIN_LOG::find_gtid_index_pos(const char *log_name,
+                                        const Gtid_set *gtid_set,
+                                        my_off_t *pos)
+{
+  DBUG_ENTER("MYSQL_BIN_LOG::find_gtid_index_pos");
+  bool error;
+
+  mysql_mutex_lock(&LOCK_log);
+  if (is_active(log_name))
+  {
+    /*
+      Only positions a dump thread may already read, the rest of the
+      file may not be synced yet.
+    */
+    lock_binlog_end_pos();
+    my_off_t end_pos= binlog_end_pos;
+    unlock_binlog_end_pos();
+    error= gtid_index.find_pos(gtid_set, end_pos, pos);
+    mysql_mutex_unlock(&LOCK_log);
+  }
+  else
+  {
+    mysql_mutex_unlock(&LOCK_log);
+    error= Binlog_gtid_index::find_pos_in_file(log_name, gtid_set, pos);
+  }
+  DBUG_RETURN(error);
+}
+
+
 /*
   Wrappers around new_file_impl to avoid using argument
   to control locking. The argument 1) less readable 2) breaks
@@ -5113,6 +5619,9 @@ int MYSQL_BIN_LOG::new_file_impl(bool need_lock_log, Format_description_log_even
   flush_io_cache(&log_file);
   DEBUG_SYNC(current_thd, "after_rotate_event_appended");
 
+  if (gtid_index.is_active())
+    gtid_index.write(log_file_name, my_b_tell(&log_file));
+
   old_name=name;
   name=0;				// Don't free name
   close(LOG_CLOSE_TO_BE_OPENED | LOG_CLOSE_INDEX);
@@ -5211,7 +5720,36 @@ end:
   @retval false success
   @retval true error
 */
-bool MYSQL_BIN_LOG::after_append_to_relay_log(Master_info *mi)
+/**
+  Check if a relay log event can only appear in the middle of a
+  transaction, i.e., it can neither end a group nor be a group on
+  its own.
+*/
+static bool is_relay_log_mid_group_event(Log_event_type type)
+{
+  switch (type)
+  {
+  case GTID_LOG_EVENT:
+  case ANONYMOUS_GTID_LOG_EVENT:
+  case TABLE_MAP_EVENT:
+  case ROWS_QUERY_LOG_EVENT:
+  case INTVAR_EVENT:
+  case RAND_EVENT:
+  case USER_VAR_EVENT:
+  case WRITE_ROWS_EVENT_V1:
+  case UPDATE_ROWS_EVENT_V1:
+  case DELETE_ROWS_EVENT_V1:
+  case WRITE_ROWS_EVENT:
+  case UPDATE_ROWS_EVENT:
+  case DELETE_ROWS_EVENT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool MYSQL_BIN_LOG::after_append_to_relay_log(Master_info *mi,
+                                              Log_event_type type)
 {
   DBUG_ENTER("MYSQL_BIN_LOG::after_append_to_relay_log");
   DBUG_PRINT("info",("max_size: %lu",max_size));
@@ -5222,9 +5760,25 @@ bool MYSQL_BIN_LOG::after_append_to_relay_log(Master_info *mi)
   DBUG_ASSERT(is_relay_log);
   DBUG_ASSERT(current_thd->system_thread == SYSTEM_THREAD_SLAVE_IO);
 
-  // Flush and sync
+  /*
+    Events in the middle of a transaction are left in the append buffer,
+    where the SQL thread reads them from memory. They reach the file
+    together with the event that ends the transaction, or earlier if the
+    buffer fills up or a sync is due, so the SQL thread never records a
+    group position that has not been written to the file.
+  */
   bool error= false;
-  if (flush_and_sync(0) == 0)
+  uint sync_period= get_sync_period();
+  if (is_relay_log_mid_group_event(type) &&
+      !(sync_period && sync_counter + 1 >= sync_period))
+  {
+    if (sync_period)
+      sync_counter++;
+  }
+  else if (flush_and_sync(0) != 0)
+    error= true;
+
+  if (!error)
   {
     // If relay log is too big, rotate
     if ((uint) my_b_append_tell(&log_file) >
@@ -5256,7 +5810,7 @@ bool MYSQL_BIN_LOG::append_event(Log_event* ev, Master_info *mi)
   if (ev->write(&log_file) == 0)
   {
     bytes_written+= ev->data_written;
-    error= after_append_to_relay_log(mi);
+    error= after_append_to_relay_log(mi, ev->get_type_code());
   }
   else
     error= true;
@@ -5280,7 +5834,8 @@ bool MYSQL_BIN_LOG::append_buffer(const char* buf, uint len, Master_info *mi)
   if (my_b_append(&log_file,(uchar*) buf,len) == 0)
   {
     bytes_written += len;
-    error= after_append_to_relay_log(mi);
+    error= after_append_to_relay_log(mi,
+                                     (Log_event_type) buf[EVENT_TYPE_OFFSET]);
   }
   else
     error= true;
@@ -6156,13 +6711,8 @@ bool MYSQL_BIN_LOG::write_cache(THD *thd, binlog_cache_data *cache_data)
         goto err;
       }
 
-      global_sid_lock->rdlock();
-      if (gtid_state->update_on_flush(thd) != RETURN_STATUS_OK)
-      {
-        global_sid_lock->unlock();
-        goto err;
-      }
-      global_sid_lock->unlock();
+      /* The GTID is logged by process_flush_stage_queue(). */
+      thd->transaction.flags.gtid_written= true;
     }
     update_thd_next_event_pos(thd);
   }
@@ -6266,6 +6816,8 @@ void MYSQL_BIN_LOG::close(uint exiting)
 {					// One can't set log_type here!
   DBUG_ENTER("MYSQL_BIN_LOG::close");
   DBUG_PRINT("enter",("exiting: %d", (int) exiting));
+  /* A file that is not indexed by now gets no index. */
+  gtid_index.stop();
   if (log_state == LOG_OPENED)
   {
 #ifdef HAVE_REPLICATION
@@ -6835,6 +7387,46 @@ MYSQL_BIN_LOG::process_flush_stage_queue(my_off_t *total_bytes_var,
       first_seen= queue;
   }
 
+  /*
+    Add the GTIDs of the whole group to the logged GTIDs, taking
+    global_sid_lock once for the group instead of once per session.
+  */
+  if (gtid_state->update_on_flush_group(first_seen) != RETURN_STATUS_OK)
+  {
+    char errbuf[MYSYS_STRERROR_SIZE];
+    sql_print_error(ER(ER_ERROR_ON_WRITE), name,
+                    errno, my_strerror(errbuf, sizeof(errbuf), errno));
+    flush_error= 1;
+  }
+
+  if (gtid_index.is_active())
+  {
+    bool locked= false;
+    for (THD *head= first_seen; head; head= head->next_to_commit)
+    {
+      if (head->commit_error != THD::CE_NONE ||
+          !head->transaction.flags.gtid_written ||
+          head->owned_gtid.sidno == 0)
+        continue;
+      if (!locked)
+      {
+        global_sid_lock->rdlock();
+        locked= true;
+      }
+      my_off_t end_pos;
+      head->get_trans_pos(NULL, &end_pos);
+      /* A GTID_NEXT_LIST session writes several GTIDs, do not index it. */
+      if (head->owned_gtid.sidno < 0 ||
+          gtid_index.add_gtid(head->owned_gtid, end_pos))
+      {
+        gtid_index.stop();
+        break;
+      }
+    }
+    if (locked)
+      global_sid_lock->unlock();
+  }
+
   *out_queue_var= first_seen;
   *total_bytes_var= total_bytes;
   if (total_bytes > 0 && my_b_tell(&log_file) >= (my_off_t) max_size)
@@ -6912,6 +7504,12 @@ MYSQL_BIN_LOG::process_commit_stage_queue(THD *thd, THD *first)
     if (head->transaction.flags.xid_written)
       dec_prep_xids(head);
   }
+
+  /*
+    Remove the committed GTIDs of the group from owned_gtids, they
+    were already logged by process_flush_stage_queue().
+  */
+  gtid_state->update_on_commit_group(first);
 }
 
 /**
@@ -7044,6 +7642,67 @@ MYSQL_BIN_LOG::sync_binlog_file(bool force)
 }
 
 
+/**
+  Time the sync stage leader waits for more sessions to join the group
+  before syncing the binary log.
+
+  The wait is bounded by binlog_group_commit_sync_delay and by the
+  average fsync time: waiting longer than an fsync takes delays the
+  group more than splitting it would. There is no wait when no sync is
+  due, or when transactions arrive too seldom for one to be expected
+  within the wait.
+
+  @return The time to wait in microseconds, 0 for no wait.
+*/
+ulonglong MYSQL_BIN_LOG::sync_stage_delay()
+{
+  mysql_mutex_assert_owner(&LOCK_sync);
+  const ulonglong max_delay= opt_binlog_group_commit_sync_delay;
+  const uint sync_period= get_sync_period();
+
+  if (max_delay == 0 || sync_period == 0 || sync_counter + 1 < sync_period)
+    return 0;
+  const ulonglong delay= min(max_delay, m_avg_sync_usec);
+  if (m_avg_arrival_usec > delay)
+    return 0;
+  return delay;
+}
+
+
+/**
+  Account a group in the group commit statistics, and in the average
+  time between transactions used by sync_stage_delay().
+
+  @param first First session of the group.
+*/
+void MYSQL_BIN_LOG::update_group_commit_stats(THD *first)
+{
+  mysql_mutex_assert_owner(&LOCK_sync);
+  ulong size= 0;
+  for (THD *head= first; head; head= head->next_to_commit)
+    size++;
+  if (size == 0)
+    return;
+
+  uint bucket= 0;
+  for (ulong n= size; n > 1 && bucket < array_elements(binlog_group_commit_sizes) - 1;
+       n>>= 1)
+    bucket++;
+  binlog_group_commits++;
+  binlog_group_commit_trx+= size;
+  binlog_group_commit_sizes[bucket]++;
+
+  /* An idle period counts as one second at most. */
+  const ulonglong now= my_micro_time();
+  if (m_last_group_usec != 0)
+  {
+    ulonglong gap= min<ulonglong>(now - m_last_group_usec, 1000000) / size;
+    m_avg_arrival_usec= (7 * m_avg_arrival_usec + gap) / 8;
+  }
+  m_last_group_usec= now;
+}
+
+
 /**
    Helper function executed when leaving @c ordered_commit.
 
@@ -7095,11 +7754,18 @@ MYSQL_BIN_LOG::finish_commit(THD *thd)
 
   /*
     Remove committed GTID from owned_gtids, it was already logged on
-    MYSQL_BIN_LOG::write_cache().
+    MYSQL_BIN_LOG::process_flush_stage_queue(). Sessions that own no
+    GTID, or whose GTID was already released with the rest of the
+    commit group, do not need global_sid_lock.
   */
-  global_sid_lock->rdlock();
-  gtid_state->update_on_commit(thd);
-  global_sid_lock->unlock();
+  if (thd->owned_gtid.sidno != 0)
+  {
+    global_sid_lock->rdlock();
+    gtid_state->update_on_commit(thd);
+    global_sid_lock->unlock();
+  }
+  else
+    thd->variables.gtid_next.set_undefined();
 
   DBUG_ASSERT(thd->commit_error || !thd->transaction.flags.run_hooks);
   DBUG_ASSERT(!thd_get_cache_mngr(thd)->dbug_any_finalized());
@@ -7208,6 +7874,7 @@ int MYSQL_BIN_LOG::ordered_commit(THD *thd, bool all, bool skip_commit)
   thd->durability_property= HA_IGNORE_DURABILITY;
   thd->transaction.flags.real_commit= all;
   thd->transaction.flags.xid_written= false;
+  thd->transaction.flags.gtid_written= false;
   thd->transaction.flags.commit_low= !skip_commit;
   thd->transaction.flags.run_hooks= !skip_commit;
 #ifndef DBUG_OFF
@@ -7278,11 +7945,26 @@ int MYSQL_BIN_LOG::ordered_commit(THD *thd, bool all, bool skip_commit)
                           thd->thread_id, thd->commit_error));
     DBUG_RETURN(finish_commit(thd));
   }
+  if (flush_error == 0 && total_bytes > 0)
+  {
+    ulonglong delay= sync_stage_delay();
+    if (delay > 0)
+      stage_manager.wait_count_or_timeout(
+        opt_binlog_group_commit_sync_no_delay_count, delay,
+        Stage_manager::SYNC_STAGE);
+  }
   THD *final_queue= stage_manager.fetch_queue_for(Stage_manager::SYNC_STAGE);
+  update_group_commit_stats(final_queue);
   if (flush_error == 0 && total_bytes > 0)
   {
+    ulonglong start_usec= my_micro_time();
     std::pair<bool, bool> result= sync_binlog_file(false);
     flush_error= result.first;
+    if (result.second)
+    {
+      ulonglong sync_usec= my_micro_time() - start_usec;
+      m_avg_sync_usec= (7 * m_avg_sync_usec + sync_usec) / 8;
+    }
   }
 
   /*
@@ -8705,6 +9387,84 @@ CPP_UNNAMED_NS_START
 
 CPP_UNNAMED_NS_END
 
+/**
+  Adds the hashes of the primary and unique key values of a row to the
+  writeset of the cache the row is logged to.
+
+  The writeset is marked unsafe when the row cannot be described by its
+  key values: the table has no primary key, is referenced by a foreign
+  key, is not transactional, or one of the key columns was not read.
+
+  @param thd      The thread logging the row
+  @param table    The table the row belongs to
+  @param is_trans If the row is logged to the transactional cache
+  @param record   The row, in the format of table->record[0]
+  @param cols     The columns that are valid in the record
+  @param cols2    More columns that are valid in the record, or NULL
+*/
+static void add_row_to_writeset(THD *thd, TABLE *table, bool is_trans,
+                                const uchar *record, const MY_BITMAP *cols,
+                                const MY_BITMAP *cols2)
+{
+  if (binlog_transaction_dependency_tracking != DEPENDENCY_TRACKING_WRITESET)
+    return;
+
+  binlog_cache_data *cache_data=
+    thd_get_cache_mngr(thd)->get_binlog_cache_data(is_trans);
+  if (cache_data->is_writeset_unsafe())
+    return;
+
+  if (!is_trans || table->s->primary_key == MAX_KEY ||
+      table->file->referenced_by_foreign_key())
+  {
+    cache_data->set_writeset_unsafe();
+    return;
+  }
+
+  my_ptrdiff_t offset= record - table->record[0];
+  for (uint key= 0; key < table->s->keys; key++)
+  {
+    KEY *key_info= table->key_info + key;
+    if (!(key_info->flags & HA_NOSAME))
+      continue;
+
+    ulong nr1= 1, nr2= 4;
+    my_charset_bin.coll->hash_sort(&my_charset_bin,
+                                   (const uchar*) table->s->db.str,
+                                   table->s->db.length, &nr1, &nr2);
+    my_charset_bin.coll->hash_sort(&my_charset_bin,
+                                   (const uchar*) table->s->table_name.str,
+                                   table->s->table_name.length, &nr1, &nr2);
+    my_charset_bin.coll->hash_sort(&my_charset_bin,
+                                   (const uchar*) key_info->name,
+                                   strlen(key_info->name), &nr1, &nr2);
+
+    bool has_null= false;
+    KEY_PART_INFO *key_part= key_info->key_part;
+    KEY_PART_INFO *key_part_end= key_part + key_info->user_defined_key_parts;
+    for (; key_part != key_part_end; key_part++)
+    {
+      Field *field= key_part->field;
+      if ((key_part->key_part_flag & HA_PART_KEY_SEG) ||
+          !(bitmap_is_set(cols, field->field_index) ||
+            (cols2 && bitmap_is_set(cols2, field->field_index))))
+      {
+        cache_data->set_writeset_unsafe();
+        return;
+      }
+      field->move_field_offset(offset);
+      /* NULL values never conflict in a unique key. */
+      if (field->is_null())
+        has_null= true;
+      else
+        field->hash(&nr1, &nr2);
+      field->move_field_offset(-offset);
+    }
+    if (!has_null)
+      cache_data->add_to_writeset(nr1);
+  }
+}
+
 int THD::binlog_write_row(TABLE* table, bool is_trans, 
                           uchar const *record,
                           const uchar* extra_row_info)
@@ -8731,6 +9491,8 @@ int THD::binlog_write_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  add_row_to_writeset(this, table, is_trans, record, table->write_set, NULL);
+
   return ev->add_row_data(row_data, len);
 }
 
@@ -8791,6 +9553,10 @@ int THD::binlog_update_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  add_row_to_writeset(this, table, is_trans, before_record, old_read_set, NULL);
+  add_row_to_writeset(this, table, is_trans, after_record,
+                      old_read_set, old_write_set);
+
   error= ev->add_row_data(before_row, before_size) ||
          ev->add_row_data(after_row, after_size);
 
@@ -8843,6 +9609,8 @@ int THD::binlog_delete_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  add_row_to_writeset(this, table, is_trans, record, old_read_set, NULL);
+
   error= ev->add_row_data(row_data, len);
 
   /* restore read/write set for the rest of execution */
@@ -9200,6 +9968,71 @@ int64
   DBUG_RETURN(retval);
 }
 
+/**
+  Computes the commit parent of a transaction being flushed to the
+  binary log, widening the commit group when the writeset allows it.
+
+  @param clock_parent  The commit parent given by the logical clock
+  @param writeset      The writeset of the transaction, or NULL if the
+                       transaction cannot be described by a writeset
+
+  @return The commit parent to write to the binary log.
+*/
+int64
+Writeset_history::get_commit_parent(int64 clock_parent,
+                                    const std::set<ulonglong> *writeset)
+{
+  DBUG_ENTER("Writeset_history::get_commit_parent");
+  if (binlog_transaction_dependency_tracking != DEPENDENCY_TRACKING_WRITESET)
+  {
+    m_open= false;
+    m_writesets.clear();
+    DBUG_RETURN(m_last_parent= clock_parent);
+  }
+
+  bool fits= writeset != NULL &&
+    m_writesets.size() + writeset->size() <=
+    binlog_transaction_dependency_history_size;
+
+  if (clock_parent == m_last_parent)
+  {
+    /*
+      Committed in the same group as the previous transaction, so it
+      does not conflict with any of the transactions in the group.
+    */
+    if (!fits)
+    {
+      m_open= false;
+      m_writesets.clear();
+    }
+    else if (m_open)
+      m_writesets.insert(writeset->begin(), writeset->end());
+    DBUG_RETURN(clock_parent);
+  }
+
+  if (fits && m_open)
+  {
+    std::set<ulonglong>::const_iterator it;
+    for (it= writeset->begin(); it != writeset->end(); ++it)
+      if (m_writesets.count(*it))
+        break;
+    if (it == writeset->end())
+    {
+      m_writesets.insert(writeset->begin(), writeset->end());
+      DBUG_PRINT("info", ("MTS:: commit parent %lld widened to %lld",
+                          clock_parent, m_last_parent));
+      DBUG_RETURN(m_last_parent);
+    }
+  }
+
+  /* Start a new group. */
+  m_writesets.clear();
+  m_open= fits;
+  if (fits)
+    m_writesets.insert(writeset->begin(), writeset->end());
+  DBUG_RETURN(m_last_parent= clock_parent);
+}
+
 /**
   Destructor for Logical clock.
 */
@@ -19,6 +19,7 @@
 #include "mysqld.h"                             /* opt_relay_logname */
 #include "log_event.h"
 #include "log.h"
+#include <set>
 
 class Relay_log_info;
 class Master_info;
@@ -42,6 +43,43 @@ public:
   ~Logical_clock();
 };
 
+/**
+  How the commit parent written in the Gtid and Query log events is
+  computed, see binlog_transaction_dependency_tracking.
+ */
+enum enum_binlog_dependency_tracking
+{
+  DEPENDENCY_TRACKING_COMMIT_ORDER= 0,
+  DEPENDENCY_TRACKING_WRITESET
+};
+
+/**
+  History of the writesets flushed in the current commit group.
+
+  The logical clock only lets the slave apply transactions in parallel
+  when they were committed in the same group on the master. A
+  transaction that does not touch any primary or unique key value
+  written by the transactions already flushed in the current group
+  cannot conflict with them, so it is given the commit parent of that
+  group and joins it, even when it was committed in a later group.
+
+  The history is bounded by binlog_transaction_dependency_history_size
+  hashes. A transaction without a usable writeset closes the group, so
+  that no later transaction can join it. Only accessed from the flush
+  stage, so it is protected by LOCK_log.
+ */
+class Writeset_history
+{
+public:
+  Writeset_history() : m_last_parent(SEQ_UNINIT), m_open(false) {}
+  int64 get_commit_parent(int64 clock_parent,
+                          const std::set<ulonglong> *writeset);
+private:
+  std::set<ulonglong> m_writesets;
+  int64 m_last_parent;
+  bool m_open;
+};
+
 /**
   Class for maintaining the commit stages for binary log group commit.
  */
@@ -51,7 +89,7 @@ public:
     friend class Stage_manager;
   public:
     Mutex_queue()
-      : m_first(NULL), m_last(&m_first)
+      : m_first(NULL), m_last(&m_first), m_size(0)
     {
     }
 
@@ -83,6 +121,15 @@ public:
 
     std::pair<bool,THD*> pop_front();
 
+    /** Number of sessions in the queue. */
+    uint get_size()
+    {
+      lock();
+      uint size= m_size;
+      unlock();
+      return size;
+    }
+
   private:
     void lock() { mysql_mutex_lock(&m_lock); }
     void unlock() { mysql_mutex_unlock(&m_lock); }
@@ -101,6 +148,9 @@ public:
     */
     THD **m_last;
 
+    /** Number of sessions in the queue. */
+    uint m_size;
+
     /** Lock for protecting the queue. */
     mysql_mutex_t m_lock;
   } __attribute__((aligned(CPU_LEVEL1_DCACHE_LINESIZE)));
@@ -189,6 +239,16 @@ public:
    */
   bool enroll_for(StageID stage, THD *first, mysql_mutex_t *stage_mutex);
 
+  /**
+    Wait until the queue for a stage holds count sessions, or until
+    usec microseconds have passed, whichever comes first.
+
+    @param count Number of sessions that ends the wait, 0 for no limit.
+    @param usec  Longest time to wait, in microseconds.
+    @param stage Stage whose queue is watched.
+   */
+  void wait_count_or_timeout(ulong count, ulonglong usec, StageID stage);
+
   std::pair<bool,THD*> pop_front(StageID stage)
   {
     return m_queue[stage].pop_front();
@@ -290,6 +350,104 @@ typedef struct st_log_info
   ~st_log_info() { mysql_mutex_destroy(&lock);}
 } LOG_INFO;
 
+/**
+  The GTIDs of a binary log file, saved next to it in a small index file
+  (the name of the binary log followed by GTID_INDEX_EXT) when the file
+  is rotated or closed.
+
+  The index holds the GTIDs of the Previous_gtids_log_event of the file,
+  the GTIDs written to the file, and sparse checkpoints: positions at the
+  end of a transaction, each with the GTIDs of the file written before
+  it. The server reads the GTIDs of a binary log from its index rather
+  than scanning the file, and a dump thread serving a slave with
+  auto-positioning seeks past the checkpoints the slave has already
+  executed.
+
+  The index of the active binary log is built in memory while groups are
+  flushed. Files without a valid index, such as the active binary log
+  after a crash, are scanned as before.
+*/
+class Binlog_gtid_index
+{
+public:
+  Binlog_gtid_index()
+    : m_gtids(NULL), m_n_checkpoints(0), m_last_checkpoint_pos(0)
+  {}
+  ~Binlog_gtid_index() { stop(); }
+
+  /**
+    Start indexing the binary log log_name, removing any stale index
+    file with the same name. Caller must hold global_sid_lock.
+
+    @param log_name Name of the new binary log.
+    @param prev_gtids GTIDs of its Previous_gtids_log_event.
+    @return false on success, true on out of memory.
+  */
+  bool start(const char *log_name, const Gtid_set *prev_gtids);
+  /// Stop indexing and forget what was collected.
+  void stop();
+  bool is_active() const { return m_gtids != NULL; }
+  /**
+    Add a GTID written to the indexed file by a transaction that ends at
+    end_pos. Caller must hold global_sid_lock.
+
+    @return false on success, true on out of memory.
+  */
+  bool add_gtid(const Gtid &gtid, my_off_t end_pos);
+  /**
+    Write the index of the binary log log_name, which is file_size bytes
+    long, and stop indexing. Caller must not hold global_sid_lock.
+
+    @return false on success, true if the index could not be written.
+  */
+  bool write(const char *log_name, my_off_t file_size);
+  /**
+    Find the last checkpoint of the file indexed in memory whose GTIDs
+    are all in gtid_set and whose position is at most max_pos.
+
+    @return false if a checkpoint was found and stored in *pos.
+  */
+  bool find_pos(const Gtid_set *gtid_set, my_off_t max_pos,
+                my_off_t *pos) const;
+
+  /**
+    Read the GTIDs of the binary log log_name from its index file.
+
+    @param all_gtids If not NULL, the GTIDs of the
+    Previous_gtids_log_event and of the file are added to it.
+    @param prev_gtids If not NULL, the GTIDs of the
+    Previous_gtids_log_event are added to it.
+    @param[out] has_gtids Set if the file contains GTIDs.
+    @return false on success, true if the file has no valid index.
+  */
+  static bool read_gtids(const char *log_name, Gtid_set *all_gtids,
+                         Gtid_set *prev_gtids, bool *has_gtids);
+  /**
+    Find the last checkpoint in the index file of log_name whose GTIDs
+    are all in gtid_set.
+
+    @return false if a checkpoint was found and stored in *pos.
+  */
+  static bool find_pos_in_file(const char *log_name, const Gtid_set *gtid_set,
+                               my_off_t *pos);
+  /// Remove the index file of the binary log log_name, if any.
+  static void remove(const char *log_name);
+
+private:
+  static bool find_pos(const uchar *checkpoints, size_t length, uint count,
+                       const Gtid_set *gtid_set, my_off_t max_pos,
+                       my_off_t *pos);
+
+  /// GTIDs written to the indexed file so far.
+  Gtid_set *m_gtids;
+  /// Encoded GTIDs of the Previous_gtids_log_event of the indexed file.
+  String m_prev_gtids;
+  /// Encoded checkpoints, see write() for the format.
+  String m_checkpoints;
+  uint m_n_checkpoints;
+  my_off_t m_last_checkpoint_pos;
+};
+
 /*
   TODO use mmap instead of IO_CACHE for binlog
   (mmap+fsync is two times faster than write+fsync)
@@ -559,6 +717,7 @@ public:
 public:
   /* Clock to timestamp the commits */
    Logical_clock commit_clock;
+   Writeset_history writeset_history;
 
   /**
     Find the oldest binary log that contains any GTID that
@@ -596,8 +755,32 @@ public:
   {
     previous_gtid_set= previous_gtid_set_param;
   }
+  /**
+    Find the position in the binary log log_name after which the slave
+    that has executed gtid_set needs events, according to the GTID
+    index of the file.
+
+    @param[out] pos The position of a transaction boundary.
+    @return false if a position was found, true if the file must be
+    read from its beginning.
+  */
+  bool find_gtid_index_pos(const char *log_name, const Gtid_set *gtid_set,
+                           my_off_t *pos);
 private:
   Gtid_set* previous_gtid_set;
+  /// GTID index of the active binary log, see Binlog_gtid_index.
+  Binlog_gtid_index gtid_index;
+  /*
+    Running averages of the fsync time and of the time between two
+    transactions reaching the sync stage, and when the last group
+    reached it, in microseconds. Used by sync_stage_delay() and
+    protected by LOCK_sync.
+  */
+  ulonglong m_avg_sync_usec;
+  ulonglong m_avg_arrival_usec;
+  ulonglong m_last_group_usec;
+  ulonglong sync_stage_delay();
+  void update_group_commit_stats(THD *first);
 
   int open(const char *opt_name) { return open_binlog(opt_name); }
   bool change_stage(THD *thd, Stage_manager::StageID stage,
@@ -725,7 +908,7 @@ public:
   bool append_buffer(const char* buf, uint len, Master_info *mi);
   bool append_event(Log_event* ev, Master_info *mi);
 private:
-  bool after_append_to_relay_log(Master_info *mi);
+  bool after_append_to_relay_log(Master_info *mi, Log_event_type type);
 #endif // ifdef HAVE_REPLICATION
 public:
 
@@ -827,10 +1010,11 @@ bool stmt_cannot_safely_rollback(const THD* thd);
 int log_loaded_block(IO_CACHE* file);
 
 /**
-  Open a single binary log file for reading.
+  Open a single binary log file for reading, through a read cache of
+  cache_size bytes.
 */
 File open_binlog_file(IO_CACHE *log, const char *log_file_name,
-                      const char **errmsg);
+                      const char **errmsg, size_t cache_size= IO_SIZE*2);
 int check_binlog_magic(IO_CACHE* log, const char** errmsg);
 bool purge_master_logs(THD* thd, const char* to_log);
 bool purge_master_logs_before_date(THD* thd, time_t purge_time);
@@ -846,6 +1030,11 @@ int query_error_code(THD *thd, bool not_killed);
 extern const char *log_bin_index;
 extern const char *log_bin_basename;
 extern bool opt_binlog_order_commits;
+extern ulong binlog_transaction_dependency_tracking;
+extern ulong binlog_transaction_dependency_history_size;
+extern ulong opt_binlog_group_commit_sync_delay;
+extern ulong opt_binlog_group_commit_sync_no_delay_count;
+extern SHOW_VAR binlog_group_commit_status_vars[];
 
 /**
   Turns a relative log binary log path into a full path, based on the
@@ -116,4 +116,68 @@ protected:
   virtual uint get_max_threads() const { return 1; }
 };
 
+
+struct Thread_group;
+
+/**
+  This class represents the connection handling functionality of a
+  pool of threads. The connections are divided between thread groups.
+  In each group one worker thread at a time waits with epoll for input
+  on the idle connections of the group, and the statements are executed
+  by a bounded number of active worker threads of the group. Connections
+  in a transaction are queued before the others, and a timer thread
+  creates more workers for the groups that make no progress.
+*/
+class Thread_pool_connection_handler : public Connection_handler
+{
+  Thread_pool_connection_handler(const Thread_pool_connection_handler&);
+  Thread_pool_connection_handler&
+    operator=(const Thread_pool_connection_handler&);
+
+  /// The thread groups, group_count of them
+  Thread_group *m_groups;
+  /// Number of thread groups that were initialized
+  uint m_group_count;
+  /// Group of the next connection
+  uint m_next_group;
+  pthread_t m_timer_thread;
+  bool m_timer_started;
+
+public:
+  // System variables
+  static uint group_count;
+  static uint stall_limit;
+  static uint oversubscribe;
+  static uint max_threads;
+  static uint idle_timeout;
+
+  Thread_pool_connection_handler()
+    : m_groups(NULL), m_group_count(0), m_next_group(0),
+      m_timer_started(false)
+  {}
+  virtual ~Thread_pool_connection_handler();
+
+  /**
+    Create the thread groups and start the timer thread.
+
+    @retval false Success
+    @retval true  Failure, the pool cannot be used
+  */
+  bool init();
+
+  /**
+    Body of the timer thread: detect the stalled groups, make sure that
+    each group has a listener and close the connections that have been
+    idle for longer than their wait_timeout.
+  */
+  void timer_loop();
+
+protected:
+  virtual bool add_connection(Channel_info* channel_info);
+
+  virtual void remove_connection(THD* thd);
+
+  virtual uint get_max_threads() const { return max_threads; }
+};
+
 #endif // CONNECTION_HANDLER_IMPL_INCLUDED
@@ -20,6 +20,7 @@
 #include "mysqld_error.h"            // ER_*
 #include "channel_info.h"            // Channel_info
 #include "connection_handler_impl.h" // Per_thread_connection_handler
+#include "log.h"                     // sql_print_warning
 #include "sql_callback.h"            // MYSQL_CALLBACK
 #include "sql_class.h"               // THD
 
@@ -98,6 +99,27 @@ bool Connection_handler_manager::init()
   case SCHEDULER_NO_THREADS:
     connection_handler= new (std::nothrow) One_thread_connection_handler();
     break;
+  case SCHEDULER_POOL_OF_THREADS:
+#ifdef HAVE_EPOLL
+  {
+    Thread_pool_connection_handler *pool=
+      new (std::nothrow) Thread_pool_connection_handler();
+    if (pool != NULL && pool->init())
+    {
+      delete pool;
+      pool= NULL;
+    }
+    connection_handler= pool;
+    break;
+  }
+#else
+    sql_print_warning("The thread pool needs epoll, which is not available "
+                      "on this platform. Using one-thread-per-connection.");
+    Connection_handler_manager::thread_handling=
+      SCHEDULER_ONE_THREAD_PER_CONNECTION;
+    connection_handler= new (std::nothrow) Per_thread_connection_handler();
+    break;
+#endif
   default:
     DBUG_ASSERT(false);
   }
@@ -101,6 +101,7 @@ public:
   {
     SCHEDULER_ONE_THREAD_PER_CONNECTION=0,
     SCHEDULER_NO_THREADS,
+    SCHEDULER_POOL_OF_THREADS,
     SCHEDULER_TYPES_COUNT
   };
 
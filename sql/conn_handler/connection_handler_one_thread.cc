@@ -30,9 +30,7 @@
 static inline void remove_and_destroy_thd(THD *thd)
 {
   thd->release_resources();
-  mysql_mutex_lock(&LOCK_thread_count);
   remove_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
   delete thd;
 }
 
@@ -79,9 +77,7 @@ bool One_thread_connection_handler::add_connection(Channel_info* channel_info)
   mysql_thread_set_psi_id(thd->thread_id);
   mysql_socket_set_thread_owner(thd->net.vio->mysql_socket);
 
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   if (thd_prepare_connection(thd))
   {
@@ -213,9 +213,7 @@ pthread_handler_t handle_connection(void *arg)
     mysql_thread_set_psi_id(thd->thread_id);
     mysql_socket_set_thread_owner(thd->net.vio->mysql_socket);
 
-    mysql_mutex_lock(&LOCK_thread_count);
     add_global_thread(thd);
-    mysql_mutex_unlock(&LOCK_thread_count);
 
     if (thd_prepare_connection(thd))
       inc_aborted_connects();
@@ -356,7 +354,6 @@ void Per_thread_connection_handler::remove_connection(THD* thd)
 {
   thd->get_stmt_da()->reset_diagnostics_area();
   thd->release_resources();
-  mysql_mutex_lock(&LOCK_thread_count);
 
   /*
     Used by binlog_reset_master.  It would be cleaner to use
@@ -369,7 +366,6 @@ void Per_thread_connection_handler::remove_connection(THD* thd)
   // Clean up errors now, before possibly waiting for a new connection.
   ERR_remove_state(0);
 
-  mysql_mutex_unlock(&LOCK_thread_count);
   delete thd;
 }
 
@@ -0,0 +1,895 @@
+/*
+   Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "connection_handler_impl.h"
+
+#include "my_pthread.h"                  // pthread_handler_t
+#include "channel_info.h"                // Channel_info
+#include "connection_handler_manager.h"  // Connection_handler_manager
+#include "global_threads.h"              // LOCK_thread_count
+#include "log.h"                         // sql_print_error
+#include "mysqld.h"                      // connection_attrib
+#include "mysqld_error.h"                // ER_*
+#include "sql_audit.h"                   // mysql_audit_release
+#include "sql_class.h"                   // THD
+#include "sql_connect.h"                 // thd_prepare_connection
+#include "sql_parse.h"                   // do_command
+#include "mysql/thread_pool_priv.h"      // thd_new_connection_setup
+
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+
+// Initialize static members
+uint Thread_pool_connection_handler::group_count= 16;
+uint Thread_pool_connection_handler::stall_limit= 500;
+uint Thread_pool_connection_handler::oversubscribe= 3;
+uint Thread_pool_connection_handler::max_threads= 500;
+uint Thread_pool_connection_handler::idle_timeout= 60;
+
+#ifdef HAVE_EPOLL
+
+/// Number of events a listener reads with one epoll_wait()
+static const int MAX_EVENTS= 16;
+/// How long a listener waits before it checks for shutdown, in milliseconds
+static const int LISTENER_TIMEOUT= 1000;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_thread_group, key_LOCK_thread_pool_timer;
+static PSI_cond_key key_COND_thread_group, key_COND_thread_pool_timer;
+static PSI_thread_key key_thread_pool_worker, key_thread_pool_timer;
+
+static PSI_mutex_info pool_mutexes[]=
+{
+  { &key_LOCK_thread_group, "LOCK_thread_group", 0},
+  { &key_LOCK_thread_pool_timer, "LOCK_thread_pool_timer", PSI_FLAG_GLOBAL}
+};
+
+static PSI_cond_info pool_conds[]=
+{
+  { &key_COND_thread_group, "COND_thread_group", 0},
+  { &key_COND_thread_pool_timer, "COND_thread_pool_timer", PSI_FLAG_GLOBAL}
+};
+
+static PSI_thread_info pool_threads[]=
+{
+  { &key_thread_pool_worker, "thread_pool_worker", 0},
+  { &key_thread_pool_timer, "thread_pool_timer", PSI_FLAG_GLOBAL}
+};
+
+static void init_thread_pool_psi_keys()
+{
+  const char *category= "sql";
+  int count;
+
+  count= array_elements(pool_mutexes);
+  mysql_mutex_register(category, pool_mutexes, count);
+
+  count= array_elements(pool_conds);
+  mysql_cond_register(category, pool_conds, count);
+
+  count= array_elements(pool_threads);
+  mysql_thread_register(category, pool_threads, count);
+}
+#endif /* HAVE_PSI_INTERFACE */
+
+/* Wakes up the timer thread, protected by LOCK_thread_pool_timer */
+static mysql_mutex_t LOCK_thread_pool_timer;
+static mysql_cond_t COND_thread_pool_timer;
+static bool timer_shutdown= false;
+
+
+/**
+  A connection of the pool. It belongs to one thread group, and it is
+  either waiting for input in the epoll set of the group, queued, or
+  handled by a worker of the group.
+*/
+struct Pool_connection
+{
+  Thread_group *group;
+  /// The channel of the connection until its first event, then NULL
+  Channel_info *channel_info;
+  THD *thd;
+  Pool_connection *next_in_queue;
+  /// List of the connections of the group
+  Pool_connection *prev, *next;
+  /// When wait_timeout expires, in microseconds (my_micro_time())
+  ulonglong wait_deadline;
+  /// The socket is armed in the epoll set, nobody handles the connection
+  bool waiting;
+  /// The socket has been added to the epoll set of the group
+  bool in_epoll;
+  /// The worker of the connection is between thd_wait_begin() and _end()
+  bool in_wait;
+
+  Pool_connection(Thread_group *group_arg, Channel_info *channel_info_arg)
+    : group(group_arg), channel_info(channel_info_arg), thd(NULL),
+      next_in_queue(NULL), prev(NULL), next(NULL),
+      wait_deadline(ULONGLONG_MAX), waiting(false), in_epoll(false), in_wait(false)
+  {}
+};
+
+
+/// FIFO of connections, linked through Pool_connection::next_in_queue
+struct Connection_queue
+{
+  Pool_connection *head;
+  Pool_connection *tail;
+
+  void init() { head= tail= NULL; }
+  bool is_empty() const { return head == NULL; }
+
+  void push_back(Pool_connection *conn)
+  {
+    conn->next_in_queue= NULL;
+    if (tail)
+      tail->next_in_queue= conn;
+    else
+      head= conn;
+    tail= conn;
+  }
+
+  Pool_connection *pop_front()
+  {
+    Pool_connection *conn= head;
+    if (conn && !(head= conn->next_in_queue))
+      tail= NULL;
+    return conn;
+  }
+};
+
+
+/**
+  A thread group. All members are protected by the mutex, except
+  epoll_fd which is set at initialization.
+*/
+struct Thread_group
+{
+  mysql_mutex_t mutex;
+  /// Signalled to wake up the idle workers of the group
+  mysql_cond_t cond;
+  int epoll_fd;
+  /// Connections with a transaction in progress, dequeued first
+  Connection_queue high_prio_queue;
+  Connection_queue queue;
+  Pool_connection *connections;
+  uint thread_count;
+  /// Workers that handle connections and are not in thd_wait_begin()
+  uint active_thread_count;
+  /// Workers waiting for cond
+  uint idle_thread_count;
+  /// Signals of cond that have not been received by a worker yet
+  uint pending_wakeups;
+  /// A worker waits for events in epoll_wait()
+  bool has_listener;
+  /// No connection was dequeued between the last two checks of the timer
+  bool stalled;
+  ulonglong dequeue_count;
+  /// dequeue_count at the last check of the timer
+  ulonglong last_dequeue_count;
+  bool shutdown;
+
+  bool init()
+  {
+    if ((epoll_fd= epoll_create(MAX_EVENTS)) < 0)
+      return true;
+    mysql_mutex_init(key_LOCK_thread_group, &mutex, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_COND_thread_group, &cond, NULL);
+    high_prio_queue.init();
+    queue.init();
+    connections= NULL;
+    thread_count= active_thread_count= idle_thread_count= 0;
+    pending_wakeups= 0;
+    has_listener= stalled= shutdown= false;
+    dequeue_count= last_dequeue_count= 0;
+    return false;
+  }
+
+  void destroy()
+  {
+    close(epoll_fd);
+    mysql_mutex_destroy(&mutex);
+    mysql_cond_destroy(&cond);
+  }
+
+  bool queues_empty() const
+  { return queue.is_empty() && high_prio_queue.is_empty(); }
+};
+
+
+/// Number of workers of a group that may handle connections at a time
+static inline uint max_active_threads()
+{
+  return 1 + Thread_pool_connection_handler::oversubscribe;
+}
+
+/// Number of workers a group may have
+static inline uint max_group_threads()
+{
+  return MY_MAX(Thread_pool_connection_handler::max_threads /
+                Thread_pool_connection_handler::group_count, 1U);
+}
+
+
+pthread_handler_t pool_worker(void *arg);
+
+/**
+  Start a new worker in a group.
+
+  @retval false  Success
+  @retval true   The group has the maximum number of workers, or the
+                 thread could not be created
+*/
+
+static bool create_worker(Thread_group *group)
+{
+  pthread_t id;
+
+  mysql_mutex_assert_owner(&group->mutex);
+  if (group->thread_count >= max_group_threads())
+    return true;
+
+  group->thread_count++;
+  if (mysql_thread_create(key_thread_pool_worker, &id, &connection_attrib,
+                          pool_worker, (void*) group))
+  {
+    group->thread_count--;
+    connection_errors_internal++;
+    return true;
+  }
+  inc_thread_created();
+  return false;
+}
+
+
+/* Wake up an idle worker of a group, or create one if there is none */
+
+static void wake_or_create_worker(Thread_group *group)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+  if (group->idle_thread_count > group->pending_wakeups)
+  {
+    group->pending_wakeups++;
+    mysql_cond_signal(&group->cond);
+  }
+  else
+    create_worker(group);
+}
+
+
+static void enqueue_connection(Thread_group *group, Pool_connection *conn)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+  if (conn->thd && conn->thd->in_active_multi_stmt_transaction())
+    group->high_prio_queue.push_back(conn);
+  else
+    group->queue.push_back(conn);
+}
+
+
+/**
+  Wait for events on the epoll set of a group and queue the connections
+  that have input. Called with the mutex of the group locked, which is
+  released while waiting.
+*/
+
+static void listen_for_events(Thread_group *group)
+{
+  struct epoll_event events[MAX_EVENTS];
+  int count;
+
+  group->has_listener= true;
+  mysql_mutex_unlock(&group->mutex);
+  count= epoll_wait(group->epoll_fd, events, MAX_EVENTS, LISTENER_TIMEOUT);
+  mysql_mutex_lock(&group->mutex);
+  group->has_listener= false;
+
+  for (int i= 0; i < count; i++)
+  {
+    Pool_connection *conn= static_cast<Pool_connection*>(events[i].data.ptr);
+    DBUG_ASSERT(conn->waiting);
+    conn->waiting= false;
+    enqueue_connection(group, conn);
+  }
+}
+
+
+/**
+  Get the next connection for a worker to handle. Called with the mutex
+  of the group locked. While no connection can be dequeued, the worker
+  is the listener of the group if the group has none, or it waits idle.
+
+  @return The connection, or NULL if the worker should end
+*/
+
+static Pool_connection *get_connection(Thread_group *group)
+{
+  mysql_mutex_assert_owner(&group->mutex);
+  while (!group->shutdown)
+  {
+    if (group->active_thread_count < max_active_threads() || group->stalled)
+    {
+      Pool_connection *conn= group->high_prio_queue.pop_front();
+      if (conn == NULL)
+        conn= group->queue.pop_front();
+      if (conn)
+      {
+        group->active_thread_count++;
+        group->dequeue_count++;
+        if (!group->queues_empty() &&
+            group->active_thread_count < max_active_threads())
+          wake_or_create_worker(group);
+        return conn;
+      }
+    }
+
+    if (!group->has_listener)
+    {
+      listen_for_events(group);
+      continue;
+    }
+
+    struct timespec abstime;
+    int error;
+    set_timespec(abstime, Thread_pool_connection_handler::idle_timeout);
+    group->idle_thread_count++;
+    error= mysql_cond_timedwait(&group->cond, &group->mutex, &abstime);
+    group->idle_thread_count--;
+    if (group->pending_wakeups)
+      group->pending_wakeups--;
+
+    // Keep one worker in the group to be the listener
+    if ((error == ETIMEDOUT || error == ETIME) && group->queues_empty() &&
+        group->thread_count > 1)
+      break;
+  }
+  return NULL;
+}
+
+
+static void release_connection(Pool_connection *conn)
+{
+  Thread_group *group= conn->group;
+
+  mysql_mutex_lock(&group->mutex);
+  if (conn->prev)
+    conn->prev->next= conn->next;
+  else
+    group->connections= conn->next;
+  if (conn->next)
+    conn->next->prev= conn->prev;
+  mysql_mutex_unlock(&group->mutex);
+  delete conn;
+}
+
+
+/**
+  Make the current thread execute for a THD.
+
+  @retval false  Success
+  @retval true   store_globals() failed
+*/
+
+static bool attach_connection(THD *thd, char *stack_start)
+{
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(set_thread)(thd_get_psi(thd));
+#endif
+  thd_set_thread_stack(thd, stack_start);
+  if (thd->store_globals())
+    return true;
+  mysql_socket_set_thread_owner(thd->net.vio->mysql_socket);
+  /*
+    THD::mysys_var::abort is associated with the physical thread, which
+    may have served a killed connection before.
+  */
+  thd->mysys_var->abort= 0;
+  thd->set_active_vio(thd->net.vio);
+  return false;
+}
+
+
+static void detach_connection(THD *thd)
+{
+  /* The killer threads use mysys_var under LOCK_thd_data */
+  mysql_mutex_lock(&thd->LOCK_thd_data);
+  thd->mysys_var= NULL;
+  mysql_mutex_unlock(&thd->LOCK_thd_data);
+  thd->restore_globals();
+}
+
+
+/* Take down a connection whose THD is attached to the current thread */
+
+static void end_pool_connection(THD *thd)
+{
+  Connection_handler_manager::get_instance()->remove_connection(thd);
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(delete_current_thread)();
+#endif
+}
+
+
+/**
+  Create the THD of a new connection and log it in.
+
+  @return The THD attached to the current thread, or NULL if the
+          connection failed and has been taken down
+*/
+
+static THD *login_connection(Pool_connection *conn, char *stack_start)
+{
+  Channel_info *channel_info= conn->channel_info;
+  THD *thd= channel_info->create_thd();
+
+  conn->channel_info= NULL;
+  if (thd == NULL)
+  {
+    connection_errors_internal++;
+    channel_info->send_error_and_close_channel(ER_OUT_OF_RESOURCES, 0, false);
+    delete channel_info;
+    inc_aborted_connects();
+    dec_connection_count();
+    release_connection(conn);
+    return NULL;
+  }
+  delete channel_info;
+  thd_set_scheduler_data(thd, conn);
+  conn->thd= thd;
+
+  mysql_mutex_lock(&LOCK_thread_count);
+  thd_new_connection_setup(thd, stack_start);
+
+  if (attach_connection(thd, stack_start))
+  {
+    close_connection(thd, ER_OUT_OF_RESOURCES);
+    inc_aborted_connects();
+    end_pool_connection(thd);
+    return NULL;
+  }
+
+  if (thd_prepare_connection(thd))
+  {
+    inc_aborted_connects();
+    close_connection(thd);
+    end_pool_connection(thd);
+    return NULL;
+  }
+  return thd;
+}
+
+
+/**
+  Put a connection back in the epoll set of its group until it has
+  input. The THD must be detached: once the socket is armed, another
+  worker may handle the connection.
+
+  @retval false  The connection waits for input
+  @retval true   The connection was killed, or the socket could not be
+                 armed
+*/
+
+static bool wait_for_input(Pool_connection *conn)
+{
+  Thread_group *group= conn->group;
+  THD *thd= conn->thd;
+  struct epoll_event event;
+  int op= conn->in_epoll ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+
+  mysql_mutex_lock(&group->mutex);
+  /*
+    A KILL that came after the THD was detached did not see the
+    connection waiting, and found no active vio to close.
+  */
+  if (thd->killed == THD::KILL_CONNECTION)
+  {
+    mysql_mutex_unlock(&group->mutex);
+    return true;
+  }
+  conn->waiting= true;
+  conn->wait_deadline= my_micro_time() +
+    (ulonglong) thd->variables.net_wait_timeout * 1000000ULL;
+  mysql_mutex_unlock(&group->mutex);
+
+  conn->in_epoll= true;
+  event.events= EPOLLIN | EPOLLONESHOT;
+  event.data.ptr= conn;
+  if (epoll_ctl(group->epoll_fd, op,
+                mysql_socket_getfd(thd->net.vio->mysql_socket), &event))
+  {
+    mysql_mutex_lock(&group->mutex);
+    conn->waiting= false;
+    mysql_mutex_unlock(&group->mutex);
+    return true;
+  }
+  return false;
+}
+
+
+/**
+  Handle a connection that has input: execute its commands until no more
+  input is pending, then make it wait for input again, or take it down.
+*/
+
+static void handle_connection_event(Pool_connection *conn, char *stack_start)
+{
+  THD *thd= conn->thd;
+
+  if (thd == NULL)
+  {
+    if (!(thd= login_connection(conn, stack_start)))
+      return;
+  }
+  else if (attach_connection(thd, stack_start))
+  {
+    close_connection(thd, ER_OUT_OF_RESOURCES);
+    end_pool_connection(thd);
+    return;
+  }
+
+  while (thd_is_connection_alive(thd))
+  {
+    mysql_audit_release(thd);
+    if (do_command(thd))
+      break;
+    // Input read ahead into the buffers of the vio gives no epoll event
+    if (thd->net.vio->has_data(thd->net.vio))
+      continue;
+
+    /*
+      A KILL that finds the connection waiting for input shuts down its
+      socket, see pool_post_kill_notification(), instead of closing it:
+      the socket stays valid for the epoll set until we close it.
+    */
+    thd->m_server_idle= true;
+    thd->clear_active_vio();
+    if (thd->killed == THD::KILL_CONNECTION)
+      break;
+    detach_connection(thd);
+    if (!wait_for_input(conn))
+      return;
+    if (attach_connection(thd, stack_start))
+    {
+      close_connection(thd, ER_OUT_OF_RESOURCES);
+      end_pool_connection(thd);
+      return;
+    }
+    break;
+  }
+
+  end_connection(thd);
+  close_connection(thd);
+  end_pool_connection(thd);
+}
+
+
+/**
+  Worker thread of a group
+
+  @param arg   The group (Thread_group)
+*/
+
+pthread_handler_t pool_worker(void *arg)
+{
+  Thread_group *group= static_cast<Thread_group*>(arg);
+  /*
+    The workers are the only threads the connections of the pool are
+    executed by, and this function is on the very high end of their stack.
+  */
+  char *stack_start= (char*) &group;
+
+  if (my_thread_init())
+  {
+    connection_errors_internal++;
+    mysql_mutex_lock(&group->mutex);
+  }
+  else
+  {
+#ifdef HAVE_PSI_THREAD_INTERFACE
+    PSI_thread *psi= PSI_THREAD_CALL(get_thread)();
+#endif
+    Pool_connection *conn;
+
+    mysql_mutex_lock(&group->mutex);
+    while ((conn= get_connection(group)))
+    {
+      mysql_mutex_unlock(&group->mutex);
+      handle_connection_event(conn, stack_start);
+#ifdef HAVE_PSI_THREAD_INTERFACE
+      PSI_THREAD_CALL(set_thread)(psi);
+#endif
+      mysql_mutex_lock(&group->mutex);
+      group->active_thread_count--;
+    }
+  }
+
+  group->thread_count--;
+  if (group->shutdown)
+    mysql_cond_broadcast(&group->cond);
+  mysql_mutex_unlock(&group->mutex);
+  my_thread_end();
+  pthread_exit(0);
+  return NULL;
+}
+
+
+/**
+  Check a group for the timer thread.
+
+  The group is stalled if connections are queued and none of them was
+  dequeued since the last check, which happens when all of its active
+  workers execute long statements. A stalled group may then handle one
+  connection more, which keeps short statements from waiting behind
+  long ones. A group whose workers are all busy also gets a worker to
+  listen for input.
+
+  The connections that have been waiting for input for longer than their
+  wait_timeout are shut down, which makes them have an event that closes
+  them.
+*/
+
+static void check_group(Thread_group *group, ulonglong now)
+{
+  mysql_mutex_lock(&group->mutex);
+  group->stalled= !group->queues_empty() &&
+                  group->dequeue_count == group->last_dequeue_count;
+  group->last_dequeue_count= group->dequeue_count;
+  if (group->stalled || !group->has_listener)
+    wake_or_create_worker(group);
+
+  for (Pool_connection *conn= group->connections; conn; conn= conn->next)
+  {
+    if (conn->waiting && conn->wait_deadline <= now)
+    {
+      conn->wait_deadline= ULONGLONG_MAX;
+      mysql_socket_shutdown(conn->thd->net.vio->mysql_socket, SHUT_RDWR);
+    }
+  }
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+void Thread_pool_connection_handler::timer_loop()
+{
+  mysql_mutex_lock(&LOCK_thread_pool_timer);
+  while (!timer_shutdown)
+  {
+    struct timespec abstime;
+    set_timespec_nsec(abstime, stall_limit * 1000000ULL);
+    mysql_cond_timedwait(&COND_thread_pool_timer, &LOCK_thread_pool_timer,
+                         &abstime);
+    if (timer_shutdown)
+      break;
+
+    ulonglong now= my_micro_time();
+    for (uint i= 0; i < m_group_count; i++)
+      check_group(m_groups + i, now);
+  }
+  mysql_mutex_unlock(&LOCK_thread_pool_timer);
+}
+
+
+pthread_handler_t pool_timer(void *arg)
+{
+  Thread_pool_connection_handler *pool=
+    static_cast<Thread_pool_connection_handler*>(arg);
+
+  my_thread_init();
+  pool->timer_loop();
+  my_thread_end();
+  return NULL;
+}
+
+
+/*
+  Callbacks of the pool, see Connection_handler_callback. A worker that
+  waits in a connection is not active, and other workers may handle the
+  connections of its group meanwhile.
+*/
+
+static void pool_wait_begin(THD *thd, int wait_type)
+{
+  Pool_connection *conn;
+
+  if (thd == NULL ||
+      !(conn= static_cast<Pool_connection*>(thd_get_scheduler_data(thd))) ||
+      conn->in_wait)
+    return;
+
+  Thread_group *group= conn->group;
+  conn->in_wait= true;
+  mysql_mutex_lock(&group->mutex);
+  group->active_thread_count--;
+  if (!group->queues_empty() &&
+      group->active_thread_count < max_active_threads())
+    wake_or_create_worker(group);
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+static void pool_wait_end(THD *thd)
+{
+  Pool_connection *conn;
+
+  if (thd == NULL ||
+      !(conn= static_cast<Pool_connection*>(thd_get_scheduler_data(thd))) ||
+      !conn->in_wait)
+    return;
+
+  Thread_group *group= conn->group;
+  conn->in_wait= false;
+  mysql_mutex_lock(&group->mutex);
+  group->active_thread_count++;
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+static void pool_post_kill_notification(THD *thd)
+{
+  Pool_connection *conn=
+    static_cast<Pool_connection*>(thd_get_scheduler_data(thd));
+
+  if (conn == NULL)
+    return;
+
+  Thread_group *group= conn->group;
+  mysql_mutex_lock(&group->mutex);
+  if (conn->waiting)
+    mysql_socket_shutdown(thd->net.vio->mysql_socket, SHUT_RDWR);
+  mysql_mutex_unlock(&group->mutex);
+}
+
+
+static Connection_handler_callback pool_callback=
+{
+  pool_wait_begin,
+  pool_wait_end,
+  pool_post_kill_notification
+};
+
+
+bool Thread_pool_connection_handler::init()
+{
+#ifdef HAVE_PSI_INTERFACE
+  init_thread_pool_psi_keys();
+#endif
+  mysql_mutex_init(key_LOCK_thread_pool_timer, &LOCK_thread_pool_timer,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_thread_pool_timer, &COND_thread_pool_timer, NULL);
+  timer_shutdown= false;
+
+  if (!(m_groups= new (std::nothrow) Thread_group[group_count]))
+    return true;
+  for (m_group_count= 0; m_group_count < group_count; m_group_count++)
+  {
+    if (m_groups[m_group_count].init())
+    {
+      sql_print_error("Could not create the epoll set of a thread group "
+                      "(errno: %d)", errno);
+      return true;
+    }
+  }
+
+  if (mysql_thread_create(key_thread_pool_timer, &m_timer_thread, NULL,
+                          pool_timer, (void*) this))
+  {
+    sql_print_error("Could not create the timer thread of the thread pool");
+    return true;
+  }
+  m_timer_started= true;
+
+  Connection_handler_manager::callback= &pool_callback;
+  return false;
+}
+
+
+Thread_pool_connection_handler::~Thread_pool_connection_handler()
+{
+  if (Connection_handler_manager::callback == &pool_callback)
+    Connection_handler_manager::callback= NULL;
+
+  if (m_timer_started)
+  {
+    mysql_mutex_lock(&LOCK_thread_pool_timer);
+    timer_shutdown= true;
+    mysql_cond_signal(&COND_thread_pool_timer);
+    mysql_mutex_unlock(&LOCK_thread_pool_timer);
+    pthread_join(m_timer_thread, NULL);
+  }
+
+  // Stop all the groups before waiting for the listeners to see it
+  for (uint i= 0; i < m_group_count; i++)
+  {
+    Thread_group *group= m_groups + i;
+    mysql_mutex_lock(&group->mutex);
+    group->shutdown= true;
+    mysql_cond_broadcast(&group->cond);
+    mysql_mutex_unlock(&group->mutex);
+  }
+
+  for (uint i= 0; i < m_group_count; i++)
+  {
+    Thread_group *group= m_groups + i;
+    mysql_mutex_lock(&group->mutex);
+    while (group->thread_count)
+      mysql_cond_wait(&group->cond, &group->mutex);
+    mysql_mutex_unlock(&group->mutex);
+
+    // Close the new connections that no worker has logged in
+    while (Pool_connection *conn= group->connections)
+    {
+      group->connections= conn->next;
+      if (conn->channel_info)
+      {
+        conn->channel_info->send_error_and_close_channel(ER_SERVER_SHUTDOWN,
+                                                         0, false);
+        delete conn->channel_info;
+      }
+      delete conn;
+    }
+    group->destroy();
+  }
+  delete [] m_groups;
+
+  mysql_mutex_destroy(&LOCK_thread_pool_timer);
+  mysql_cond_destroy(&COND_thread_pool_timer);
+}
+
+
+bool Thread_pool_connection_handler::add_connection(Channel_info* channel_info)
+{
+  DBUG_ENTER("Thread_pool_connection_handler::add_connection");
+  Pool_connection *conn;
+  Thread_group *group= m_groups + m_next_group++ % m_group_count;
+
+  if (!(conn= new (std::nothrow) Pool_connection(group, channel_info)))
+  {
+    connection_errors_internal++;
+    channel_info->send_error_and_close_channel(ER_OUT_OF_RESOURCES, 0, false);
+    DBUG_RETURN(true);
+  }
+
+  mysql_mutex_lock(&group->mutex);
+  if ((conn->next= group->connections))
+    conn->next->prev= conn;
+  group->connections= conn;
+  group->queue.push_back(conn);
+  if (group->active_thread_count < max_active_threads())
+    wake_or_create_worker(group);
+  mysql_mutex_unlock(&group->mutex);
+  DBUG_RETURN(false);
+}
+
+
+void Thread_pool_connection_handler::remove_connection(THD* thd)
+{
+  Pool_connection *conn=
+    static_cast<Pool_connection*>(thd_get_scheduler_data(thd));
+
+  thd->get_stmt_da()->reset_diagnostics_area();
+  thd->release_resources();
+  remove_global_thread(thd);
+  // Clean up errors now, before the worker handles another connection.
+  ERR_remove_state(0);
+  delete thd;
+  my_pthread_set_THR_THD(NULL);
+  my_pthread_set_THR_MALLOC(NULL);
+  release_connection(conn);
+}
+
+#endif /* HAVE_EPOLL */
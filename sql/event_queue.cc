@@ -92,6 +92,9 @@ int event_queue_element_compare_q(void *vptr, uchar* a, uchar *b)
 
 Event_queue::Event_queue()
   :next_activation_at(0),
+   executions_dispatched(0),
+   total_lateness(0),
+   max_lateness(0),
    mutex_last_locked_at_line(0),
    mutex_last_unlocked_at_line(0),
    mutex_last_attempted_lock_at_line(0),
@@ -638,6 +641,16 @@ Event_queue::get_top_for_execution_if_time(THD *thd,
     }
 
     DBUG_PRINT("info", ("Ready for execution"));
+    /*
+      The scheduler is late when it could not dispatch the event at
+      execute_at, e.g. because many events were due at the same second.
+    */
+    {
+      my_time_t lateness= thd->query_start() - top->execute_at;
+      executions_dispatched++;
+      total_lateness+= lateness;
+      set_if_bigger(max_lateness, lateness);
+    }
     top->mark_last_executed(thd);
     if (top->compute_next_execution_time())
       top->status= Event_parse_data::DISABLED;
@@ -822,6 +835,11 @@ Event_queue::dump_internal_status()
     printf("Last lock attempt at: %s:%u\n", mutex_last_attempted_lock_in_func,
                                             mutex_last_attempted_lock_at_line);
   printf("WOC             : %s\n", waiting_on_cond? "YES":"NO");
+  printf("Dispatched      : %lu\n", executions_dispatched);
+  printf("Lateness (sec)  : avg %.2f  max %ld\n",
+         executions_dispatched ?
+         (double) total_lateness / executions_dispatched : 0.0,
+         (long) max_lateness);
 
   MYSQL_TIME time;
   my_tz_OFFSET0->gmt_sec_to_TIME(&time, next_activation_at);
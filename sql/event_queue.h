@@ -118,6 +118,11 @@ private:
 
   my_time_t next_activation_at;
 
+  /* Statistics of how late the events were dispatched */
+  ulong executions_dispatched;
+  ulonglong total_lateness;
+  my_time_t max_lateness;
+
   uint mutex_last_locked_at_line;
   uint mutex_last_unlocked_at_line;
   uint mutex_last_attempted_lock_at_line;
@@ -146,9 +146,7 @@ post_init_event_thread(THD *thd)
   }
 
   inc_thread_running();
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
   return FALSE;
 }
 
@@ -171,9 +169,7 @@ deinit_event_thread(THD *thd)
 
   dec_thread_running();
   thd->release_resources();
-  mysql_mutex_lock(&LOCK_thread_count);
   remove_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
   delete thd;
 }
 
@@ -719,6 +715,20 @@ end:
 }
 
 
+/** Counts the event worker threads, for Event_scheduler::workers_count() */
+class Count_event_workers : public Do_THD_Impl
+{
+public:
+  Count_event_workers() : count(0) {}
+  virtual void operator()(THD *thd)
+  {
+    if (thd->system_thread == SYSTEM_THREAD_EVENT_WORKER)
+      ++count;
+  }
+  uint count;
+};
+
+
 /*
   Returns the number of living event worker threads.
 
@@ -729,18 +739,12 @@ end:
 uint
 Event_scheduler::workers_count()
 {
-  uint count= 0;
+  Count_event_workers count_event_workers;
 
   DBUG_ENTER("Event_scheduler::workers_count");
-  mysql_mutex_lock(&LOCK_thread_count);
-  Thread_iterator it= global_thread_list_begin();
-  Thread_iterator end= global_thread_list_end();
-  for (; it != end; ++it)
-    if ((*it)->system_thread == SYSTEM_THREAD_EVENT_WORKER)
-      ++count;
-  mysql_mutex_unlock(&LOCK_thread_count);
-  DBUG_PRINT("exit", ("%d", count));
-  DBUG_RETURN(count);
+  do_for_all_thd(&count_event_workers);
+  DBUG_PRINT("exit", ("%d", count_event_workers.count));
+  DBUG_RETURN(count_event_workers.count);
 }
 
 
@@ -6294,8 +6294,10 @@ longlong Field_newdate::val_int()
 longlong Field_newdate::val_date_temporal()
 {
   ASSERT_COLUMN_MARKED_FOR_READ;
-  MYSQL_TIME ltime;
-  return get_date_internal(&ltime) ? 0 : TIME_to_longlong_date_packed(&ltime);
+  /* get_date_internal() and TIME_to_longlong_date_packed() in one go */
+  uint32 tmp= (uint32) uint3korr(ptr);
+  longlong ymd= (((tmp >> 9) * 13 + ((tmp >> 5) & 15)) << 5) | (tmp & 31);
+  return MY_PACKED_TIME_MAKE_INT(ymd << 17);
 }
 
 
@@ -6447,6 +6449,20 @@ bool Field_datetime::get_date_internal(MYSQL_TIME *ltime)
 }
 
 
+longlong Field_datetime::val_date_temporal()
+{
+  ASSERT_COLUMN_MARKED_FOR_READ;
+  /* get_date_internal() and TIME_to_longlong_datetime_packed() in one go */
+  longlong tmp= datetime_get_internal(table, ptr);
+  uint yymmdd= (uint) (tmp / 1000000LL), hhmmss= (uint) (tmp % 1000000LL);
+  longlong ymd= ((yymmdd / 10000 * 13 + yymmdd / 100 % 100) << 5) |
+                (yymmdd % 100);
+  longlong hms= ((hhmmss / 10000) << 12) | ((hhmmss / 100 % 100) << 6) |
+                (hhmmss % 100);
+  return MY_PACKED_TIME_MAKE_INT((ymd << 17) | hms);
+}
+
+
 type_conversion_status
 Field_datetime::store_internal(const MYSQL_TIME *ltime, int *warnings)
 {
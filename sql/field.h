@@ -1813,6 +1813,13 @@ public:
   double val_real(void);
   longlong val_int(void);
   my_decimal *val_decimal(my_decimal *);
+  /**
+    The value as an integer scaled by 10^dec, without a my_decimal.
+    @return 0 on success, non-zero if precision is above 18 or the
+    record holds an invalid value
+  */
+  int val_scaled_int(longlong *to) const
+  { return bin2scaled_longlong(ptr, to, precision, dec); }
   bool get_date(MYSQL_TIME *ltime, uint fuzzydate);
   bool get_time(MYSQL_TIME *ltime);
   String *val_str(String*, String *);
@@ -3184,6 +3191,7 @@ public:
     return TYPE_OK;
   }
   longlong val_int(void);
+  longlong val_date_temporal();
   String *val_str(String*,String *);
   int cmp(const uchar *,const uchar *);
   void make_sort_key(uchar *buff, uint length);
@@ -4117,6 +4125,8 @@ public:
   void (*do_copy2)(Copy_field *);		// Used to handle null values
 };
 
+Copy_field *merge_copy_fields(Copy_field *begin, Copy_field *end);
+
 
 Field *make_field(TABLE_SHARE *share, uchar *ptr, uint32 field_length,
 		  uchar *null_pos, uchar null_bit,
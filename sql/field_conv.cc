@@ -659,6 +659,22 @@ void Copy_field::set(Field *to,Field *from,bool save)
 }
 
 
+/** @return the function that copies length bytes of a field unchanged */
+
+static void (*get_eq_copy_func(uint length))(Copy_field *)
+{
+  switch (length) {
+  case 1: return do_field_1;
+  case 2: return do_field_2;
+  case 3: return do_field_3;
+  case 4: return do_field_4;
+  case 6: return do_field_6;
+  case 8: return do_field_8;
+  }
+  return do_field_eq;
+}
+
+
 Copy_field::Copy_func *
 Copy_field::get_copy_func(Field *to,Field *from)
 {
@@ -787,15 +803,64 @@ Copy_field::get_copy_func(Field *to,Field *from)
     }
   }
     /* Eq fields */
-  switch (to_length) {
-  case 1: return do_field_1;
-  case 2: return do_field_2;
-  case 3: return do_field_3;
-  case 4: return do_field_4;
-  case 6: return do_field_6;
-  case 8: return do_field_8;
+  return get_eq_copy_func(to_length);
+}
+
+
+/**
+  Check if a copy is a plain copy of the bytes of a NOT NULL field to a
+  NOT NULL field of the same type and length.
+*/
+
+static bool is_eq_copy(const Copy_field *copy)
+{
+  return (copy->do_copy == copy->do_copy2 &&
+          copy->from_length == copy->to_length &&
+          (copy->do_copy == do_field_eq ||
+           copy->do_copy == do_field_1 || copy->do_copy == do_field_2 ||
+           copy->do_copy == do_field_3 || copy->do_copy == do_field_4 ||
+           copy->do_copy == do_field_6 || copy->do_copy == do_field_8));
+}
+
+
+/**
+  Merge the copies of adjacent fields into bulk copies.
+
+  A run of plain copies (see is_eq_copy()) where the fields follow each
+  other in both the source and the destination record is done with one
+  memcpy() of the whole run. This happens when the columns of a table
+  are copied in table order to a temporary table.
+
+  Copies with NULL handling are not merged, because a NULL value must
+  reset the destination field instead of copying the bytes.
+
+  @param begin  The first copy, as set up by Copy_field::set()
+  @param end    The end of the array
+
+  @return The new end of the array, the merged copies are moved down
+*/
+
+Copy_field *merge_copy_fields(Copy_field *begin, Copy_field *end)
+{
+  Copy_field *to= begin;
+  for (Copy_field *copy= begin; copy < end; copy++)
+  {
+    if (to > begin && is_eq_copy(to - 1) && is_eq_copy(copy) &&
+        (to - 1)->from_ptr + (to - 1)->from_length == copy->from_ptr &&
+        (to - 1)->to_ptr + (to - 1)->to_length == copy->to_ptr &&
+        (to - 1)->null_row == copy->null_row)
+    {
+      Copy_field *run= to - 1;
+      run->from_length+= copy->from_length;
+      run->to_length+= copy->to_length;
+      run->do_copy= run->do_copy2= get_eq_copy_func(run->to_length);
+      continue;
+    }
+    if (to != copy)
+      *to= *copy;
+    to++;
   }
-  return do_field_eq;
+  return to;
 }
 
 
@@ -53,19 +53,27 @@ static ha_rows find_all_keys(Sort_param *param,SQL_SELECT *select,
                              ha_rows *found_rows);
 static int write_keys(Sort_param *param, Filesort_info *fs_info,
                       uint count, IO_CACHE *buffer_file, IO_CACHE *tempfile);
+static void sort_in_buffer(Sort_param *param, Filesort_info *fs_info,
+                           uint count);
 static void register_used_fields(Sort_param *param);
 static int merge_index(Sort_param *param,uchar *sort_buffer,
                        BUFFPEK *buffpek,
                        uint maxbuffer,IO_CACHE *tempfile,
                        IO_CACHE *outfile);
-static bool save_index(Sort_param *param, uint count,
+static bool save_index(Sort_param *param, uint count, uint skip,
                        Filesort_info *table_sort);
+static uint get_covering_key(TABLE *table, Filesort *filesort,
+                             uint s_length, SQL_SELECT *select);
 static uint suffix_length(ulong string_length);
 static SORT_ADDON_FIELD *get_addon_fields(ulong max_length_for_sort_data,
                                           Field **ptabfield,
                                           uint sortlength, uint *plength);
 static void unpack_addon_fields(struct st_sort_addon_field *addon_field,
                                 uchar *buff);
+static void unpack_packed_addon_fields(struct st_sort_addon_field *addon_field,
+                                       uchar *buff);
+static bool addon_fields_packable(const SORT_ADDON_FIELD *addon_field,
+                                  uint addon_length);
 static bool check_if_pq_applicable(Opt_trace_context *trace,
                                    Sort_param *param, Filesort_info *info,
                                    TABLE *table,
@@ -88,8 +96,12 @@ void Sort_param::init_for_filesort(uint sortlen, TABLE *table,
     addon_field= get_addon_fields(max_length_for_sort_data,
                                   table->field, sort_length, &addon_length);
   }
+  using_packed_addons= false;
   if (addon_field)
+  {
     res_length= addon_length;
+    using_packed_addons= addon_fields_packable(addon_field, addon_length);
+  }
   else
   {
     res_length= ref_length;
@@ -144,6 +156,12 @@ static void trace_filesort_information(Opt_trace_context *trace,
   The result set is stored in table->io_cache or
   table->record_pointers.
 
+  If filesort->offset is set, and the row positions are sorted, the
+  first filesort->offset rows of the result are skipped, and
+  filesort->skipped is set to their number: they need not be read
+  in full. The row positions are then read from the shortest covering
+  index, if any, instead of from the rows.
+
   @param      thd            Current thread
   @param      table          Table to sort
   @param      filesort       How to sort the table
@@ -185,9 +203,11 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
   SQL_SELECT *const select= filesort->select;
   ha_rows max_rows= filesort->limit;
   uint s_length= 0;
+  uint keyread_key= MAX_KEY;
 
   DBUG_ENTER("filesort");
 
+  filesort->skipped= 0;
   if (!(s_length= filesort->make_sortorder()))
     DBUG_RETURN(HA_POS_ERROR);  /* purecov: inspected */
 
@@ -219,6 +239,7 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
   Filesort_info table_sort= table->sort;
   table->sort.io_cache= NULL;
   DBUG_ASSERT(table_sort.record_pointers == NULL);
+  table_sort.io_cache_start= 0;
   
   outfile= table_sort.io_cache;
   my_b_clear(&tempfile);
@@ -226,21 +247,39 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
   buffpek=0;
   error= 1;
 
+  /*
+    The rows skipped by OFFSET are only read in full if they are read
+    from the table: sort the row positions if they can be read from an
+    index instead.
+  */
+  if (filesort->offset && !(select && select->quick))
+    keyread_key= get_covering_key(table, filesort, s_length, select);
+
   param.init_for_filesort(sortlength(thd, filesort->sortorder, s_length,
                                      &multi_byte_charset),
                           table,
                           thd->variables.max_length_for_sort_data,
-                          max_rows, sort_positions);
+                          max_rows, sort_positions || keyread_key != MAX_KEY);
+  param.sort_threads= static_cast<uint>(thd->variables.sort_threads);
+  param.keyread_key= keyread_key;
 
   table_sort.addon_buf= 0;
   table_sort.addon_length= param.addon_length;
   table_sort.addon_field= param.addon_field;
   table_sort.unpack= unpack_addon_fields;
+  table_sort.using_packed_addons= false;
   if (param.addon_field &&
       !(table_sort.addon_buf=
         (uchar *) my_malloc(key_memory_SORT_ADDON_FIELD,
-                            param.addon_length, MYF(MY_WME))))
+                            param.addon_length +
+                            Sort_param::size_of_addon_length, MYF(MY_WME))))
       goto err;
+  if (param.using_packed_addons &&
+      !(param.packed_rec=
+        (uchar *) my_malloc(key_memory_Sort_param_tmp_buffer,
+                            param.rec_length +
+                            Sort_param::size_of_addon_length, MYF(MY_WME))))
+    goto err;
 
   if (select && select->quick)
     thd->inc_status_sort_range();
@@ -337,6 +376,13 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
       goto err;
   }
 
+  /*
+    Only row positions can be skipped: additional fields may be packed,
+    and have no fixed length in outfile.
+  */
+  if (!param.addon_field)
+    filesort->skipped= min(filesort->offset, min(num_rows, param.max_rows));
+
   maxbuffer= (uint) (my_b_tell(&buffpek_pointers)/sizeof(*buffpek));
 
   Opt_trace_object(trace, "filesort_summary")
@@ -350,7 +396,8 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
 
   if (maxbuffer == 0)			// The whole set is in memory
   {
-    if (save_index(&param, (uint) num_rows, &table_sort))
+    if (save_index(&param, (uint) num_rows, (uint) filesort->skipped,
+                   &table_sort))
       goto err;
   }
   else
@@ -399,6 +446,12 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
                     &tempfile,
 		    outfile))
       goto err;
+    table_sort.io_cache_start= filesort->skipped * param.res_length;
+    if (param.using_packed_addons)
+    {
+      table_sort.unpack= unpack_packed_addon_fields;
+      table_sort.using_packed_addons= true;
+    }
   }
 
   if (num_rows > param.max_rows)
@@ -406,10 +459,12 @@ ha_rows filesort(THD *thd, TABLE *table, Filesort *filesort,
     // If find_all_keys() produced more results than the query LIMIT.
     num_rows= param.max_rows;
   }
+  num_rows-= filesort->skipped;
   error= 0;
 
  err:
   my_free(param.tmp_buffer);
+  my_free(param.packed_rec);
   if (!subselect || !subselect->is_uncacheable())
   {
     table_sort.free_sort_buffer();
@@ -692,6 +747,7 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
   handler *file;
   MY_BITMAP *save_read_set, *save_write_set;
   bool skip_record;
+  bool keyread;
 
   DBUG_ENTER("find_all_keys");
   DBUG_PRINT("info",("using: %s",
@@ -705,13 +761,15 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
   ref_length=param->ref_length;
   ref_pos= ref_buff;
   quick_select=select && select->quick;
+  keyread= !quick_select && param->keyread_key != MAX_KEY;
   record=0;
   *found_rows= 0;
-  flag= ((file->ha_table_flags() & HA_REC_NOT_IN_SEQ) || quick_select);
+  flag= ((file->ha_table_flags() & HA_REC_NOT_IN_SEQ) || quick_select ||
+         keyread);
   if (flag)
     ref_pos= &file->ref[0];
   next_pos=ref_pos;
-  if (!quick_select)
+  if (!quick_select && !keyread)
   {
     next_pos=(uchar*) 0;			/* Find records in sequence */
     DBUG_EXECUTE_IF("bug14365043_1",
@@ -756,6 +814,23 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
 
   sort_form->column_bitmaps_set(&sort_form->tmp_set, &sort_form->tmp_set);
 
+  if (keyread)
+  {
+    /*
+      Read the sort keys and the row positions from a covering index:
+      the rows are read in full only once sorted, see filesort().
+      The index is initialized once the columns to read are known.
+    */
+    sort_form->set_keyread(TRUE);
+    if ((error= file->ha_index_init(param->keyread_key, false)))
+    {
+      sort_form->set_keyread(FALSE);
+      sort_form->column_bitmaps_set(save_read_set, save_write_set);
+      file->print_error(error, MYF(0));
+      DBUG_RETURN(HA_POS_ERROR);
+    }
+  }
+
   for (;;)
   {
     if (quick_select)
@@ -765,6 +840,14 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
       file->position(sort_form->record[0]);
       DBUG_EXECUTE_IF("debug_filesort", dbug_print_record(sort_form, TRUE););
     }
+    else if (keyread)
+    {
+      if (!(error= (record++ ? file->ha_index_next(sort_form->record[0]) :
+                    file->ha_index_first(sort_form->record[0]))))
+        file->position(sort_form->record[0]);
+      else if (error != HA_ERR_RECORD_DELETED)
+        break;
+    }
     else					/* Not quick-select */
     {
       {
@@ -784,7 +867,12 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
     if (*killed)
     {
       DBUG_PRINT("info",("Sort killed by user"));
-      if (!quick_select)
+      if (keyread)
+      {
+        file->ha_index_end();
+        sort_form->set_keyread(FALSE);
+      }
+      else if (!quick_select)
       {
         (void) file->extra(HA_EXTRA_NO_CACHE);
         file->ha_rnd_end();
@@ -824,7 +912,12 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
     if (thd->is_error())
       break;
   }
-  if (!quick_select)
+  if (keyread)
+  {
+    file->ha_index_end();
+    sort_form->set_keyread(FALSE);
+  }
+  else if (!quick_select)
   {
     (void) file->extra(HA_EXTRA_NO_CACHE);	/* End cacheing of records */
     if (!next_pos)
@@ -846,14 +939,154 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
   if (indexpos && idx &&
       write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
     DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
+  /*
+    Every buffer written by write_keys() holds at most max_rows keys.
+    The size of tempfile cannot be used instead, as packed records have
+    different lengths.
+  */
   const ha_rows retval= 
     my_b_inited(tempfile) ?
-    (ha_rows) (my_b_tell(tempfile)/param->rec_length) : idx;
+    (ha_rows) indexpos * min((ha_rows) param->max_keys_per_buffer,
+                             param->max_rows) +
+    min((ha_rows) idx, param->max_rows) : idx;
   DBUG_PRINT("info", ("find_all_keys return %u", (uint) retval));
   DBUG_RETURN(retval);
 } /* find_all_keys */
 
 
+/**
+  Sort the keys in the sort buffer, and count the sorts that used more
+  than one thread.
+
+  @param param             Sort parameters
+  @param fs_info           The sort buffer
+  @param count             Number of keys in the sort buffer
+*/
+
+static void sort_in_buffer(Sort_param *param, Filesort_info *fs_info,
+                           uint count)
+{
+  const uint threads= fs_info->sort_buffer(param, count);
+  if (threads > 1)
+    current_thd->inc_status_sort_parallel(threads);
+}
+
+
+/**
+  Length of the value of an addon field in the fixed layout of the
+  sort buffer, without the bytes after its actual length.
+
+  @param addonf  Descriptor of the field
+  @param ptr     The value, as stored by Field::pack()
+*/
+
+static inline uint addon_value_length(const SORT_ADDON_FIELD *addonf,
+                                      const uchar *ptr)
+{
+  Field *field= addonf->field;
+  if (field->real_type() == MYSQL_TYPE_VARCHAR ||
+      field->real_type() == MYSQL_TYPE_STRING)
+    return field->packed_col_length(ptr, field->field_length);
+  return addonf->length;
+}
+
+
+/**
+  Pack the addon fields of a record of the sort buffer: store the null
+  bits and the values of the fields that are not null, each with its
+  actual length, after the length of the packed addon fields.
+
+  @param param   Sort parameters
+  @param from    Addon fields in the fixed layout
+  @param to      Where to store the packed addon fields
+
+  @return length of the packed addon fields
+*/
+
+static uint pack_addon_fields(const Sort_param *param, const uchar *from,
+                              uchar *to)
+{
+  const SORT_ADDON_FIELD *addonf= param->addon_field;
+  uchar *start= to;
+  to+= Sort_param::size_of_addon_length;
+  memcpy(to, from, addonf->offset);
+  to+= addonf->offset;
+  for (; addonf->field; addonf++)
+  {
+    if (addonf->null_bit && (addonf->null_bit & from[addonf->null_offset]))
+      continue;
+    const uint length= addon_value_length(addonf, from + addonf->offset);
+    memcpy(to, from + addonf->offset, length);
+    to+= length;
+  }
+  int2store(start, (uint) (to - start));
+  return (uint) (to - start);
+}
+
+
+/**
+  Expand a record packed by write_packed_record() to the fixed layout of
+  the sort buffer.
+
+  @param param   Sort parameters
+  @param from    The packed record
+  @param to      Where to store the record
+
+  @return length of the packed record
+*/
+
+static uint unpack_sort_record(const Sort_param *param, const uchar *from,
+                               uchar *to)
+{
+  const SORT_ADDON_FIELD *addonf= param->addon_field;
+  memcpy(to, from, param->sort_length);
+  from+= param->sort_length;
+  to+= param->sort_length;
+  const uint addon_length= uint2korr(from);
+  const uchar *pos= from + Sort_param::size_of_addon_length;
+  memcpy(to, pos, addonf->offset);
+  pos+= addonf->offset;
+  for (; addonf->field; addonf++)
+  {
+    if (addonf->null_bit && (addonf->null_bit & to[addonf->null_offset]))
+      continue;
+    const uint length= addon_value_length(addonf, pos);
+    memcpy(to + addonf->offset, pos, length);
+    pos+= length;
+  }
+  DBUG_ASSERT(pos == from + addon_length);
+  return param->sort_length + addon_length;
+}
+
+
+/**
+  Write a record of the sort buffer to a file with packed addon fields.
+
+  @param param     Sort parameters
+  @param to_file   File to write to
+  @param record    The record, in the fixed layout
+  @param flag      0: write the sort key and the addon fields,
+                   1: write only the addon fields, as the result
+
+  @retval 0 OK
+  @retval 1 Error
+*/
+
+static int write_packed_record(Sort_param *param, IO_CACHE *to_file,
+                               const uchar *record, int flag)
+{
+  uchar *to= param->packed_rec;
+  uint length= 0;
+  if (flag == 0)
+  {
+    memcpy(to, record, param->sort_length);
+    length= param->sort_length;
+  }
+  length+= pack_addon_fields(param, record + param->sort_length, to + length);
+  return my_b_write(to_file, to, length);
+}
+
+
 /**
   @details
   Sort the buffer and write:
@@ -888,7 +1121,7 @@ write_keys(Sort_param *param, Filesort_info *fs_info, uint count,
   rec_length= param->rec_length;
   uchar **sort_keys= fs_info->get_sort_keys();
 
-  fs_info->sort_buffer(param, count);
+  sort_in_buffer(param, fs_info, count);
 
   if (!my_b_inited(tempfile) &&
       open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
@@ -902,8 +1135,12 @@ write_keys(Sort_param *param, Filesort_info *fs_info, uint count,
     count=(uint) param->max_rows;               /* purecov: inspected */
   buffpek.count=(ha_rows) count;
   for (end=sort_keys+count ; sort_keys != end ; sort_keys++)
-    if (my_b_write(tempfile, (uchar*) *sort_keys, (uint) rec_length))
+  {
+    if (param->using_packed_addons ?
+        write_packed_record(param, tempfile, *sort_keys, 0) :
+        my_b_write(tempfile, (uchar*) *sort_keys, (uint) rec_length))
       goto err;
+  }
   if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
     goto err;
   DBUG_RETURN(0);
@@ -1235,21 +1472,63 @@ static void register_used_fields(Sort_param *param)
   }
 }
 
-static bool save_index(Sort_param *param, uint count, Filesort_info *table_sort)
+
+/**
+  Find the shortest index from which the row positions can be sorted,
+  without reading the rows: an index which contains the columns of the
+  sort key, of the condition and of the row position.
+
+  @param table     Table to sort
+  @param filesort  How to sort the table
+  @param s_length  Number of elements in filesort->sortorder
+  @param select    Condition on the rows to sort, or NULL
+
+  @return the index number, or MAX_KEY if there is none
+*/
+
+static uint get_covering_key(TABLE *table, Filesort *filesort,
+                             uint s_length, SQL_SELECT *select)
+{
+  Sort_param param;
+  MY_BITMAP *save_read_set= table->read_set;
+
+  /* Same columns as read by find_all_keys() in <sort_key, rowid> mode */
+  bitmap_clear_all(&table->tmp_set);
+  table->read_set= &table->tmp_set;
+  param.sort_form= table;
+  param.end= (param.local_sortorder= filesort->sortorder) + s_length;
+  register_used_fields(&param);
+  if (select && select->cond)
+    select->cond->walk(&Item::register_field_in_read_map, 1,
+                       (uchar*) table);
+  table->read_set= save_read_set;
+
+  return find_covering_key(table, &table->tmp_set);
+}
+
+/**
+  Sort the keys in the sort buffer, and save the result,
+  without the first skip records, in table_sort->record_pointers.
+*/
+
+static bool save_index(Sort_param *param, uint count, uint skip,
+                       Filesort_info *table_sort)
 {
   uint offset,res_length;
   uchar *to;
   DBUG_ENTER("save_index");
+  DBUG_ASSERT(skip <= count);
 
-  table_sort->sort_buffer(param, count);
+  sort_in_buffer(param, table_sort, count);
   res_length= param->res_length;
   offset= param->rec_length-res_length;
   if (!(to= table_sort->record_pointers= 
         (uchar*) my_malloc(key_memory_Filesort_info_record_pointers,
-                           res_length*count, MYF(MY_WME))))
+                           res_length*(count-skip), MYF(MY_WME))))
     DBUG_RETURN(1);                 /* purecov: inspected */
   uchar **sort_keys= table_sort->get_sort_keys();
-  for (uchar **end= sort_keys+count ; sort_keys != end ; sort_keys++)
+  uchar **end= sort_keys+count;
+  for (sort_keys+= skip ; sort_keys != end ; sort_keys++)
   {
     memcpy(to, *sort_keys+offset, res_length);
     to+= res_length;
@@ -1414,6 +1693,7 @@ bool check_if_pq_applicable(Opt_trace_context *trace,
         filesort_info->addon_field= NULL;
         param->addon_field= NULL;
         param->addon_length= 0;
+        param->using_packed_addons= false;
 
         param->res_length= param->ref_length;
         param->sort_length+= param->ref_length;
@@ -1427,7 +1707,12 @@ bool check_if_pq_applicable(Opt_trace_context *trace,
 }
 
 
-/** Merge buffers to make < MERGEBUFF2 buffers. */
+/**
+  Merge buffers to make at most merge_fanin() buffers, which the final
+  merge then merges in one pass.
+  Every pass merges groups of about the same number of buffers, at most
+  merge_fanin() each.
+*/
 
 int merge_many_buff(Sort_param *param, uchar *sort_buffer,
                     BUFFPEK *buffpek, uint *maxbuffer, IO_CACHE *t_file)
@@ -1435,9 +1720,11 @@ int merge_many_buff(Sort_param *param, uchar *sort_buffer,
   uint i;
   IO_CACHE t_file2,*from_file,*to_file,*temp;
   BUFFPEK *lastbuff;
+  const uint fanin= merge_fanin(param->max_keys_per_buffer,
+                                param->rec_length);
   DBUG_ENTER("merge_many_buff");
 
-  if (*maxbuffer < MERGEBUFF2)
+  if (*maxbuffer < fanin)
     DBUG_RETURN(0);				/* purecov: inspected */
   if (flush_io_cache(t_file) ||
       open_cached_file(&t_file2,mysql_tmpdir,TEMP_PREFIX,DISK_BUFFER_SIZE,
@@ -1445,17 +1732,20 @@ int merge_many_buff(Sort_param *param, uchar *sort_buffer,
     DBUG_RETURN(1);				/* purecov: inspected */
 
   from_file= t_file ; to_file= &t_file2;
-  while (*maxbuffer >= MERGEBUFF2)
+  while (*maxbuffer >= fanin)
   {
+    const uint n_buffers= *maxbuffer + 1;
+    const uint n_merges= (n_buffers + fanin - 1) / fanin;
+    const uint merge_size= (n_buffers + n_merges - 1) / n_merges;
     if (reinit_io_cache(from_file,READ_CACHE,0L,0,0))
       goto cleanup;
     if (reinit_io_cache(to_file,WRITE_CACHE,0L,0,0))
       goto cleanup;
     lastbuff=buffpek;
-    for (i=0 ; i <= *maxbuffer-MERGEBUFF*3/2 ; i+=MERGEBUFF)
+    for (i=0 ; i + merge_size < n_buffers ; i+=merge_size)
     {
       if (merge_buffers(param,from_file,to_file,sort_buffer,lastbuff++,
-			buffpek+i,buffpek+i+MERGEBUFF-1,0))
+			buffpek+i,buffpek+i+merge_size-1,0))
       goto cleanup;
     }
     if (merge_buffers(param,from_file,to_file,sort_buffer,lastbuff++,
@@ -1476,13 +1766,17 @@ cleanup:
     setup_io_cache(t_file);
   }
 
-  DBUG_RETURN(*maxbuffer >= MERGEBUFF2);	/* Return 1 if interrupted */
+  DBUG_RETURN(*maxbuffer >= fanin);		/* Return 1 if interrupted */
 } /* merge_many_buff */
 
 
 /**
   Read data to buffer.
 
+  When the buffer is not the last of its sequence, the operating system
+  is asked to read the next one ahead, so that it is usually in the file
+  system cache by the time the keys read now have been merged.
+
   @retval
     (uint)-1 if something goes wrong
 */
@@ -1503,11 +1797,71 @@ uint read_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
     buffpek->file_pos+= length;			/* New filepos */
     buffpek->count-=	count;
     buffpek->mem_count= count;
+#if defined(POSIX_FADV_WILLNEED) && !defined(_WIN32)
+    if (buffpek->count)
+    {
+      const ha_rows next_count= min((ha_rows) buffpek->max_keys,
+                                    buffpek->count);
+      (void) posix_fadvise(fromfile->file, buffpek->file_pos,
+                           (off_t) (next_count * rec_length),
+                           POSIX_FADV_WILLNEED);
+    }
+#endif
   }
   return (count*rec_length);
 } /* read_to_buffer */
 
 
+/**
+  Read data to buffer, expanding packed records to the fixed layout.
+
+  The packed records are read in chunks of read_buff_size bytes, which
+  must be room for at least one record.
+
+  @retval
+    (uint)-1 if something goes wrong
+*/
+
+static uint read_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
+                           Sort_param *param, uchar *read_buff,
+                           uint read_buff_size)
+{
+  if (!param->using_packed_addons)
+    return read_to_buffer(fromfile, buffpek, param->rec_length);
+
+  const uint rec_length= param->rec_length;
+  const uint count= (uint) min((ha_rows) buffpek->max_keys, buffpek->count);
+  uchar *to= buffpek->base;
+  uint n_read= 0;
+  while (n_read < count)
+  {
+    const size_t length= mysql_file_pread(fromfile->file, read_buff,
+                                          read_buff_size,
+                                          buffpek->file_pos, MYF(MY_WME));
+    if (length == MY_FILE_ERROR)
+      return((uint) -1);                        /* purecov: inspected */
+    const uchar *from= read_buff;
+    const uchar *end= read_buff + length;
+    while (n_read < count &&
+           from + param->sort_length + Sort_param::size_of_addon_length <= end &&
+           from + param->sort_length +
+           uint2korr(from + param->sort_length) <= end)
+    {
+      from+= unpack_sort_record(param, from, to);
+      to+= rec_length;
+      n_read++;
+    }
+    if (from == read_buff)
+      return((uint) -1);                        /* purecov: inspected */
+    buffpek->file_pos+= from - read_buff;
+  }
+  buffpek->key= buffpek->base;
+  buffpek->count-= count;
+  buffpek->mem_count= count;
+  return (count*rec_length);
+} /* read_to_buffer */
+
+
 /**
   Put all room used by freed buffer to use in adjacent buffer.
 
@@ -1541,6 +1895,146 @@ void reuse_freed_buff(QUEUE *queue, BUFFPEK *reuse, uint key_length)
 }
 
 
+/**
+  Put all room used by a freed buffer of merge_buffers() to use in an
+  adjacent buffer, like reuse_freed_buff() above. The buffers that are
+  still merged are the ones that have keys in memory.
+
+  @param first       first buffer of the merge
+  @param last        last buffer of the merge
+  @param reuse       empty buffer
+  @param key_length  key length
+*/
+
+static void reuse_freed_buff(BUFFPEK *first, BUFFPEK *last, BUFFPEK *reuse,
+                             uint key_length)
+{
+  uchar *reuse_end= reuse->base + reuse->max_keys * key_length;
+  for (BUFFPEK *bp= first; bp <= last; bp++)
+  {
+    if (bp == reuse || bp->mem_count == 0)
+      continue;
+    if (bp->base + bp->max_keys * key_length == reuse->base)
+    {
+      bp->max_keys+= reuse->max_keys;
+      return;
+    }
+    else if (bp->base == reuse_end)
+    {
+      bp->base= reuse->base;
+      bp->max_keys+= reuse->max_keys;
+      return;
+    }
+  }
+  DBUG_ASSERT(0);
+}
+
+
+/**
+  A tree of losers over the buffers of merge_buffers().
+
+  The buffers are the leaves of a binary tree with one internal node
+  less than there are buffers. Each internal node holds the buffer that
+  lost the comparison of keys there, and m_tree[0] the buffer with the
+  smallest key. When that key has been consumed, the next key of the
+  buffer is compared only with the losers on the path to its leaf: one
+  comparison per level, where the QUEUE binary heap needs two.
+
+  A buffer without keys in memory (mem_count == 0) is exhausted, and
+  loses against all the others. Of equal keys the key of the first
+  buffer wins, which makes the merge stable.
+*/
+
+class Merge_tree
+{
+public:
+  Merge_tree() : m_tree(NULL), m_buffs(NULL), m_n_buffs(0), m_elements(0)
+  {}
+
+  ~Merge_tree() { my_free(m_tree); }
+
+  /**
+    Build the tree over buffers whose first keys have been read.
+
+    @return true if out of memory
+  */
+  bool init(BUFFPEK *buffs, uint n_buffs, qsort2_cmp cmp, void *cmp_arg)
+  {
+    m_buffs= buffs;
+    m_n_buffs= n_buffs;
+    m_cmp= cmp;
+    m_cmp_arg= cmp_arg;
+    if (!(m_tree= (uint*) my_malloc(key_memory_Filesort_info_buffpek,
+                                    n_buffs * sizeof(uint), MYF(MY_WME))))
+      return true;
+
+    // m_n_buffs marks a node that no buffer has reached yet.
+    for (uint node= 0; node < n_buffs; node++)
+      m_tree[node]= n_buffs;
+    m_elements= 0;
+    for (uint ix= 0; ix < n_buffs; ix++)
+    {
+      if (m_buffs[ix].mem_count)
+        m_elements++;
+      uint winner= ix;
+      uint node= (ix + n_buffs) / 2;
+      for (; node > 0 && m_tree[node] != n_buffs; node/= 2)
+      {
+        if (wins(m_tree[node], winner))
+          std::swap(m_tree[node], winner);
+      }
+      m_tree[node]= winner;
+    }
+    return false;
+  }
+
+  /// The buffer with the smallest key.
+  BUFFPEK *top() const { return m_buffs + m_tree[0]; }
+
+  /// Number of buffers that are not exhausted.
+  uint elements() const { return m_elements; }
+
+  /// Key of the top buffer has been replaced.
+  void replaced()
+  {
+    uint winner= m_tree[0];
+    for (uint node= (winner + m_n_buffs) / 2; node > 0; node/= 2)
+    {
+      if (wins(m_tree[node], winner))
+        std::swap(m_tree[node], winner);
+    }
+    m_tree[0]= winner;
+  }
+
+  /// The top buffer has been exhausted.
+  void remove_top()
+  {
+    DBUG_ASSERT(top()->mem_count == 0);
+    m_elements--;
+    replaced();
+  }
+
+private:
+  /// Whether the key of buffer a is merged before the key of buffer b.
+  bool wins(uint a, uint b) const
+  {
+    if (m_buffs[a].mem_count == 0)
+      return false;
+    if (m_buffs[b].mem_count == 0)
+      return true;
+    const int res= m_cmp(m_cmp_arg, &m_buffs[a].key, &m_buffs[b].key);
+    return res < 0 || (res == 0 && a < b);
+  }
+
+  uint *m_tree;
+  BUFFPEK *m_buffs;
+  uint m_n_buffs;
+  uint m_elements;
+  qsort2_cmp m_cmp;
+  void *m_cmp_arg;
+};
+
+
 /**
   Merge buffers to one buffer.
 
@@ -1572,9 +2066,11 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
   my_off_t to_start_filepos;
   uchar *strpos;
   BUFFPEK *buffpek;
-  QUEUE queue;
+  Merge_tree tree;
   qsort2_cmp cmp;
   void *first_cmp_arg;
+  uchar *read_buff= NULL;
+  uint read_buff_size= 0;
   volatile THD::killed_state *killed= &current_thd->killed;
   THD::killed_state not_killable;
   DBUG_ENTER("merge_buffers");
@@ -1598,6 +2094,15 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
 
   /* The following will fire if there is not enough space in sort_buffer */
   DBUG_ASSERT(maxcount!=0);
+
+  if (param->using_packed_addons)
+  {
+    read_buff_size= max(MERGE_RUN_BUFFER_SIZE,
+                        rec_length + Sort_param::size_of_addon_length);
+    if (!(read_buff= (uchar*) my_malloc(key_memory_Sort_param_tmp_buffer,
+                                        read_buff_size, MYF(MY_WME))))
+      DBUG_RETURN(1);                           /* purecov: inspected */
+  }
   
   if (param->unique_buff)
   {
@@ -1609,19 +2114,21 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
     cmp= get_ptr_compare(sort_length);
     first_cmp_arg= (void*) &sort_length;
   }
-  if (init_queue(&queue, (uint) (Tb-Fb)+1, offsetof(BUFFPEK,key), 0,
-                 (queue_compare) cmp, first_cmp_arg))
-    DBUG_RETURN(1);                                /* purecov: inspected */
   for (buffpek= Fb ; buffpek <= Tb ; buffpek++)
   {
     buffpek->base= strpos;
     buffpek->max_keys= maxcount;
+    buffpek->mem_count= 0;
     strpos+=
-      (uint) (error= (int)read_to_buffer(from_file, buffpek, rec_length));
+      (uint) (error= (int)read_to_buffer(from_file, buffpek, param,
+                                         read_buff, read_buff_size));
     if (error == -1)
       goto err;					/* purecov: inspected */
     buffpek->max_keys= buffpek->mem_count;	// If less data in buffers than expected
-    queue_insert(&queue, (uchar*) buffpek);
+  }
+  if (tree.init(Fb, (uint) (Tb-Fb)+1, cmp, first_cmp_arg))
+  {
+    error= 1; goto err;                         /* purecov: inspected */
   }
 
   if (param->unique_buff)
@@ -1634,7 +2141,7 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
        This is safe as we know that there is always more than one element
        in each block to merge (This is guaranteed by the Unique:: algorithm
     */
-    buffpek= (BUFFPEK*) queue_top(&queue);
+    buffpek= tree.top();
     memcpy(param->unique_buff, buffpek->key, rec_length);
     if (my_b_write(to_file, (uchar*) buffpek->key, rec_length))
     {
@@ -1647,12 +2154,12 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       error= 0;                                       /* purecov: inspected */
       goto end;                                       /* purecov: inspected */
     }
-    queue_replaced(&queue);                        // Top element has been used
+    tree.replaced();                               // Top element has been used
   }
   else
     cmp= 0;                                        // Not unique
 
-  while (queue.elements > 1)
+  while (tree.elements() > 1)
   {
     if (*killed)
     {
@@ -1660,7 +2167,7 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
     }
     for (;;)
     {
-      buffpek= (BUFFPEK*) queue_top(&queue);
+      buffpek= tree.top();
       if (cmp)                                        // Remove duplicates
       {
         if (!(*cmp)(first_cmp_arg, &(param->unique_buff),
@@ -1668,7 +2175,14 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
               goto skip_duplicate;
             memcpy(param->unique_buff, (uchar*) buffpek->key, rec_length);
       }
-      if (flag == 0)
+      if (param->using_packed_addons)
+      {
+        if (write_packed_record(param, to_file, buffpek->key, flag))
+        {
+          error=1; goto err;                        /* purecov: inspected */
+        }
+      }
+      else if (flag == 0)
       {
         if (my_b_write(to_file,(uchar*) buffpek->key, rec_length))
         {
@@ -1692,20 +2206,20 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       buffpek->key+= rec_length;
       if (! --buffpek->mem_count)
       {
-        if (!(error= (int) read_to_buffer(from_file,buffpek,
-                                          rec_length)))
+        if (!(error= (int) read_to_buffer(from_file, buffpek, param,
+                                          read_buff, read_buff_size)))
         {
-          (void) queue_remove(&queue,0);
-          reuse_freed_buff(&queue, buffpek, rec_length);
+          reuse_freed_buff(Fb, Tb, buffpek, rec_length);
+          tree.remove_top();
           break;                        /* One buffer have been removed */
         }
         else if (error == -1)
           goto err;                        /* purecov: inspected */
       }
-      queue_replaced(&queue);              /* Top element has been replaced */
+      tree.replaced();                     /* Top element has been replaced */
     }
   }
-  buffpek= (BUFFPEK*) queue_top(&queue);
+  buffpek= tree.top();
   buffpek->base= sort_buffer;
   buffpek->max_keys= param->max_keys_per_buffer;
 
@@ -1730,7 +2244,18 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       buffpek->count= 0;                        /* Don't read more */
     }
     max_rows-= buffpek->mem_count;
-    if (flag == 0)
+    if (param->using_packed_addons)
+    {
+      uchar *end= buffpek->key + buffpek->mem_count*rec_length;
+      for (strpos= buffpek->key ; strpos != end ; strpos+= rec_length)
+      {
+        if (write_packed_record(param, to_file, strpos, flag))
+        {
+          error=1; goto err;                        /* purecov: inspected */
+        }
+      }
+    }
+    else if (flag == 0)
     {
       if (my_b_write(to_file,(uchar*) buffpek->key,
                      (rec_length*buffpek->mem_count)))
@@ -1753,14 +2278,15 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       }
     }
   }
-  while ((error=(int) read_to_buffer(from_file,buffpek, rec_length))
+  while ((error=(int) read_to_buffer(from_file, buffpek, param,
+                                     read_buff, read_buff_size))
          != -1 && error != 0);
 
 end:
   lastbuff->count= min(org_max_rows-max_rows, param->max_rows);
   lastbuff->file_pos= to_start_filepos;
 err:
-  delete_queue(&queue);
+  my_free(read_buff);
   DBUG_RETURN(error);
 } /* merge_buffers */
 
@@ -2032,6 +2558,63 @@ unpack_addon_fields(struct st_sort_addon_field *addon_field, uchar *buff)
   }
 }
 
+
+/**
+  Whether the addon fields are worth packing in the temporary files,
+  that is whether some of them are CHAR or VARCHAR values, and whether
+  the packed length fits in Sort_param::size_of_addon_length bytes.
+
+  @param addon_field     Array of descriptors for appended fields
+  @param addon_length    Total length of the appended fields
+*/
+
+static bool addon_fields_packable(const SORT_ADDON_FIELD *addon_field,
+                                  uint addon_length)
+{
+  if (addon_length + Sort_param::size_of_addon_length > 0xFFFF)
+    return false;
+  for (const SORT_ADDON_FIELD *addonf= addon_field; addonf->field; addonf++)
+  {
+    if (addonf->field->real_type() == MYSQL_TYPE_VARCHAR ||
+        addonf->field->real_type() == MYSQL_TYPE_STRING)
+      return true;
+  }
+  return false;
+}
+
+
+/**
+  Copy (unpack) values appended to sorted fields from a packed record of
+  the result file back to their regular positions, like
+  unpack_addon_fields().
+
+  @param addon_field     Array of descriptors for appended fields
+  @param buff            Buffer which to unpack the value from, starting
+                         with the length of the packed addon fields
+*/
+
+static void
+unpack_packed_addon_fields(struct st_sort_addon_field *addon_field,
+                           uchar *buff)
+{
+  Field *field;
+  SORT_ADDON_FIELD *addonf= addon_field;
+  const uchar *nulls= buff + Sort_param::size_of_addon_length;
+  const uchar *pos= nulls + addonf->offset;
+
+  for ( ; (field= addonf->field) ; addonf++)
+  {
+    if (addonf->null_bit && (addonf->null_bit & nulls[addonf->null_offset]))
+    {
+      field->set_null();
+      continue;
+    }
+    field->set_notnull();
+    pos= field->unpack(field->ptr, pos);
+  }
+  DBUG_ASSERT(pos == buff + uint2korr(buff));
+}
+
 /*
 ** functions to change a double or float to a sortable string
 ** The following should work for IEEE
@@ -38,6 +38,13 @@ public:
   ORDER *order;
   /** Number of records to return */
   ha_rows limit;
+  /**
+    Number of records to skip at the start of the result, for OFFSET.
+    Only skipped when sorting row positions, see filesort().
+  */
+  ha_rows offset;
+  /** Number of records skipped by the last filesort(), at most offset */
+  ha_rows skipped;
   /** ORDER BY list with some precalculated info for filesort */
   SORT_FIELD *sortorder;
   /** select to use for getting records */
@@ -50,6 +57,8 @@ public:
   Filesort(ORDER *order_arg, ha_rows limit_arg, SQL_SELECT *select_arg):
     order(order_arg),
     limit(limit_arg),
+    offset(0),
+    skipped(0),
     sortorder(NULL),
     select(select_arg),
     own_select(false), 
@@ -17,6 +17,7 @@
 #include "sql_const.h"
 #include "sql_sort.h"
 #include "table.h"
+#include "mysql/psi/mysql_thread.h"
 
 #include <algorithm>
 #include <functional>
@@ -57,28 +58,22 @@ double get_merge_many_buffs_cost_fast(ha_rows num_rows,
       last_n_elems * log(1.0 + last_n_elems) ) * ROWID_COMPARE_COST;
   
   // Simulate behavior of merge_many_buff().
-  while (num_buffers >= MERGEBUFF2)
+  const ha_rows fanin= merge_fanin(num_keys_per_buffer, elem_size);
+  while (num_buffers + 1 > fanin)
   {
-    // Calculate # of calls to merge_buffers().
-    const ha_rows loop_limit= num_buffers - MERGEBUFF*3/2;
-    const ha_rows num_merge_calls= 1 + loop_limit/MERGEBUFF;
-    const ha_rows num_remaining_buffs=
-      num_buffers - num_merge_calls * MERGEBUFF;
+    // Calculate # of calls to merge_buffers(), and buffers per call.
+    const ha_rows num_merge_calls= (num_buffers + fanin - 1) / fanin;
+    const ha_rows num_buffs_per_call=
+      (num_buffers + num_merge_calls - 1) / num_merge_calls;
 
     // Cost of merge sort 'num_merge_calls'.
     total_cost+=
       num_merge_calls *
-      get_merge_cost(num_keys_per_buffer * MERGEBUFF, MERGEBUFF, elem_size);
-
-    // # of records in remaining buffers.
-    last_n_elems+= num_remaining_buffs * num_keys_per_buffer;
-
-    // Cost of merge sort of remaining buffers.
-    total_cost+=
-      get_merge_cost(last_n_elems, 1 + num_remaining_buffs, elem_size);
+      get_merge_cost(num_keys_per_buffer * num_buffs_per_call,
+                     num_buffs_per_call, elem_size);
 
     num_buffers= num_merge_calls;
-    num_keys_per_buffer*= MERGEBUFF;
+    num_keys_per_buffer*= num_buffs_per_call;
   }
 
   // Simulate final merge_buff call.
@@ -124,6 +119,17 @@ void Filesort_buffer::free_sort_buffer()
 }
 
 
+uint merge_fanin(ha_rows num_keys_per_buffer, uint elem_size)
+{
+  const ha_rows by_size=
+    num_keys_per_buffer * elem_size / MERGE_RUN_BUFFER_SIZE;
+  const ha_rows by_keys= num_keys_per_buffer / MERGEBUFF;
+  const ha_rows fanin= std::min<ha_rows>(std::min(by_size, by_keys),
+                                         MERGEBUFF_MAX);
+  return static_cast<uint>(std::max<ha_rows>(fanin, MERGEBUFF2));
+}
+
+
 namespace {
 
 /*
@@ -174,21 +180,19 @@ size_t try_reserve(std::pair<type*, ptrdiff_t> *buf, ptrdiff_t size)
   return buf->second;
 }
 
-} // namespace
+/*
+  The smallest number of keys that each thread of a parallel sort gets.
+  Below this, starting a thread costs more than it saves.
+*/
+const uint MIN_KEYS_PER_SORT_THREAD= 10000;
 
-void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+void sort_keys(uchar **keys, uint count, uint sort_length)
 {
-  if (count <= 1)
-    return;
-  if (param->sort_length == 0)
-    return;
-
-  uchar **keys= get_sort_keys();
   std::pair<uchar**, ptrdiff_t> buffer;
-  if (radixsort_is_appliccable(count, param->sort_length) &&
+  if (radixsort_is_appliccable(count, sort_length) &&
       try_reserve(&buffer, count))
   {
-    radixsort_for_str_ptr(keys, count, param->sort_length, buffer.first);
+    radixsort_for_str_ptr(keys, count, sort_length, buffer.first);
     std::return_temporary_buffer(buffer.first);
     return;
   }
@@ -200,9 +204,152 @@ void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
   */
   if (count < 100)
   {
-    size_t size= param->sort_length;
+    size_t size= sort_length;
     my_qsort2(keys, count, sizeof(uchar*), get_ptr_compare(size), &size);
     return;
   }
-  std::stable_sort(keys, keys + count, Mem_compare(param->sort_length));
+  std::stable_sort(keys, keys + count, Mem_compare(sort_length));
+}
+
+/**
+  A piece of work of a parallel sort: sorting the keys [begin, end) of
+  'from', or merging the sorted chunks [begin, mid) and [mid, end) of
+  'from' into the same positions of 'to'.
+  All the sorts are stable, and merging takes equal keys from the first
+  chunk, so the result is in the same order as of a serial sort.
+*/
+struct Sort_task
+{
+  uchar **from;
+  uchar **to;                                   // NULL when sorting
+  uint begin;
+  uint mid;
+  uint end;
+  uint sort_length;
+  pthread_t thread;
+  bool started;
+
+  void run()
+  {
+    if (to == NULL)
+      sort_keys(from + begin, end - begin, sort_length);
+    else
+      std::merge(from + begin, from + mid, from + mid, from + end,
+                 to + begin, Mem_compare(sort_length));
+  }
+};
+
+} // namespace
+
+extern "C" void *sort_task_thread(void *arg)
+{
+  my_thread_init();
+  static_cast<Sort_task*>(arg)->run();
+  my_thread_end();
+  return NULL;
+}
+
+namespace {
+
+/**
+  Runs the tasks concurrently: the first one on the calling thread and
+  the others on threads of their own. A task whose thread cannot be
+  created is run on the calling thread afterwards.
+*/
+void run_sort_tasks(Sort_task *tasks, uint n_tasks)
+{
+  for (uint i= 1; i < n_tasks; i++)
+    tasks[i].started= !mysql_thread_create(0, /* Not instrumented */
+                                           &tasks[i].thread, NULL,
+                                           sort_task_thread, &tasks[i]);
+  tasks[0].run();
+  for (uint i= 1; i < n_tasks; i++)
+  {
+    if (tasks[i].started)
+      pthread_join(tasks[i].thread, NULL);
+    else
+      tasks[i].run();
+  }
+}
+
+/**
+  Sorts the keys on n_threads threads: each thread sorts a chunk of the
+  keys, and then pairs of adjacent chunks are merged concurrently, back
+  and forth between 'keys' and 'buffer', until one chunk is left.
+
+  @param keys         the keys to sort
+  @param count        number of keys
+  @param sort_length  length of the keys
+  @param n_threads    number of threads, 1 < n_threads <= MAX_SORT_THREADS
+  @param buffer       space for 'count' key pointers
+*/
+void parallel_sort(uchar **keys, uint count, uint sort_length,
+                   uint n_threads, uchar **buffer)
+{
+  Sort_task tasks[MAX_SORT_THREADS];
+  // Chunk i is [bounds[i], bounds[i + 1])
+  uint bounds[MAX_SORT_THREADS + 1];
+
+  for (uint i= 0; i <= n_threads; i++)
+    bounds[i]= static_cast<uint>((ulonglong) count * i / n_threads);
+
+  for (uint i= 0; i < n_threads; i++)
+  {
+    Sort_task *task= &tasks[i];
+    task->from= keys;
+    task->to= NULL;
+    task->begin= bounds[i];
+    task->end= bounds[i + 1];
+    task->sort_length= sort_length;
+  }
+  run_sort_tasks(tasks, n_threads);
+
+  uchar **from= keys;
+  uchar **to= buffer;
+  for (uint n_chunks= n_threads; n_chunks > 1; )
+  {
+    const uint n_tasks= (n_chunks + 1) / 2;
+    for (uint i= 0; i < n_tasks; i++)
+    {
+      // The last chunk has nothing to merge with if n_chunks is odd.
+      Sort_task *task= &tasks[i];
+      task->from= from;
+      task->to= to;
+      task->begin= bounds[2 * i];
+      task->mid= bounds[std::min(2 * i + 1, n_chunks)];
+      task->end= bounds[std::min(2 * i + 2, n_chunks)];
+      task->sort_length= sort_length;
+    }
+    run_sort_tasks(tasks, n_tasks);
+
+    for (uint i= 0; i <= n_tasks; i++)
+      bounds[i]= bounds[std::min(2 * i, n_chunks)];
+    n_chunks= n_tasks;
+    std::swap(from, to);
+  }
+  if (from != keys)
+    std::copy(from, from + count, keys);
+}
+
+} // namespace
+
+uint Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+{
+  if (count <= 1)
+    return 1;
+  if (param->sort_length == 0)
+    return 1;
+
+  uchar **keys= get_sort_keys();
+  const uint n_threads=
+    std::min(param->sort_threads, count / MIN_KEYS_PER_SORT_THREAD);
+  std::pair<uchar**, ptrdiff_t> buffer;
+  if (n_threads > 1 && try_reserve(&buffer, count))
+  {
+    parallel_sort(keys, count, param->sort_length, n_threads, buffer.first);
+    std::return_temporary_buffer(buffer.first);
+    return n_threads;
+  }
+  sort_keys(keys, count, param->sort_length);
+  return 1;
 }
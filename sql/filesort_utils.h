@@ -46,6 +46,18 @@ double get_merge_many_buffs_cost_fast(ha_rows num_rows,
                                       ha_rows num_keys_per_buffer,
                                       uint    elem_size);
 
+/**
+  The number of runs that merge_many_buff() merges at a time, and the
+  number of runs that it leaves for the final merge.
+
+    @param num_keys_per_buffer Number of keys that fit in the sort buffer.
+    @param elem_size           Size of each element.
+
+  Each run gets at least MERGE_RUN_BUFFER_SIZE bytes and MERGEBUFF keys
+  of the sort buffer. The result is between MERGEBUFF2 and MERGEBUFF_MAX.
+*/
+uint merge_fanin(ha_rows num_keys_per_buffer, uint elem_size);
+
 
 /**
   A wrapper class around the buffer used by filesort().
@@ -66,8 +78,14 @@ public:
     m_idx_array(), m_record_length(0), m_start_of_data(NULL)
   {}
 
-  /** Sort me... */
-  void sort_buffer(const Sort_param *param, uint count);
+  /**
+    Sort me...
+    With Sort_param::sort_threads > 1, large buffers are split into chunks
+    that are sorted on separate threads and then merged.
+
+    @return the number of threads that sorted the keys
+  */
+  uint sort_buffer(const Sort_param *param, uint count);
 
   /// Initializes a record pointer.
   uchar *get_record_buffer(uint idx)
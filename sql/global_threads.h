@@ -23,31 +23,53 @@
 class THD;
 
 extern mysql_mutex_t LOCK_thread_count;
-extern mysql_mutex_t LOCK_thread_remove;
 extern mysql_cond_t COND_thread_count;
 
 /**
-  We maintail a set of all registered threads.
-  We provide acccessors to iterate over all threads.
-  There is no guarantee on the order of THDs when iterating.
+  We maintain a set of all registered threads, split into
+  THD_LIST_PARTITIONS partitions by the address of the THD.
+  Each partition has its own mutex, so that threads of different
+  partitions are added and removed concurrently, and iterating over the
+  set blocks only one partition at a time. None of the functions below
+  needs LOCK_thread_count.
 
-  We also provide mutators for inserting, and removing an element:
   add_global_thread() inserts a THD into the set, and increments the counter.
   remove_global_thread() removes a THD from the set, and decrements the counter.
-  remove_global_thread() also broadcasts COND_thread_count.
+  wait_till_no_thd() waits until the set is empty.
 
-  All functions must be called with LOCK_thread_count.
+  do_for_all_thd() and find_thd() visit the registered threads, in no
+  particular order. The functor is called with the mutex of the partition
+  of the THD locked, which keeps the THD from being removed and deleted.
+  The functor must not add or remove threads, nor wait for anything that
+  might need to do so. Once find_thd() has returned the THD, it may go
+  away at any moment, unless the functor has locked THD::LOCK_thd_data
+  before returning true, like it is done for "lock from delete".
  */
-typedef std::set<THD*>::iterator Thread_iterator;
-Thread_iterator global_thread_list_begin();
-Thread_iterator global_thread_list_end();
-void copy_global_thread_list(std::set<THD*> *new_copy);
+#define THD_LIST_PARTITIONS 8
+
+class Do_THD_Impl
+{
+public:
+  virtual ~Do_THD_Impl() {}
+  virtual void operator()(THD*)= 0;
+};
+
+class Find_THD_Impl
+{
+public:
+  virtual ~Find_THD_Impl() {}
+  virtual bool operator()(THD*)= 0;
+};
+
+void do_for_all_thd(Do_THD_Impl *func);
+THD *find_thd(Find_THD_Impl *func);
 void add_global_thread(THD *);
 void remove_global_thread(THD *);
+void wait_till_no_thd();
 
 /*
   We maintain a separate counter for the number of threads,
-  which can be accessed without LOCK_thread_count.
+  which can be accessed without any lock.
   An un-locked read, means that the result is fuzzy of course.
   This accessor is used by DBUG printing, by signal handlers,
   and by the 'mysqladmin status' command.
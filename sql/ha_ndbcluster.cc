@@ -17585,6 +17585,24 @@ static MYSQL_SYSVAR_ULONG(
 );
 
 
+ulong opt_ndb_eventbuffer_max_alloc;
+static MYSQL_SYSVAR_ULONG(
+  eventbuffer_max_alloc,             /* name */
+  opt_ndb_eventbuffer_max_alloc,     /* var */
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum memory in bytes which can be used by the binlog injector "
+  "for buffering events received from the storage nodes. When the "
+  "limit is reached, events are discarded and a GAP event is written "
+  "to the binlog. 0 means no limit.",
+  NULL,                              /* check func. */
+  NULL,                              /* update func. */
+  0,                                 /* default */
+  0,                                 /* min */
+  UINT_MAX32,                        /* max */
+  0                                  /* block */
+);
+
+
 my_bool opt_ndb_log_update_as_write;
 static MYSQL_SYSVAR_BOOL(
   log_update_as_write,               /* name */
@@ -17801,6 +17819,7 @@ static struct st_mysql_sys_var* system_variables[]= {
   MYSQL_SYSVAR(cluster_connection_pool),
   MYSQL_SYSVAR(report_thresh_binlog_mem_usage),
   MYSQL_SYSVAR(report_thresh_binlog_epoch_slip),
+  MYSQL_SYSVAR(eventbuffer_max_alloc),
   MYSQL_SYSVAR(log_update_as_write),
   MYSQL_SYSVAR(log_updated_only),
   MYSQL_SYSVAR(log_orig),
@@ -6700,6 +6700,7 @@ injectApplyStatusWriteRow(injector::transaction& trans,
 
 extern ulong opt_ndb_report_thresh_binlog_epoch_slip;
 extern ulong opt_ndb_report_thresh_binlog_mem_usage;
+extern ulong opt_ndb_eventbuffer_max_alloc;
 
 pthread_handler_t
 ndb_binlog_thread_func(void *arg)
@@ -6719,6 +6720,8 @@ ndb_binlog_thread_func(void *arg)
    *   in that case, don't report incident again
    */
   bool do_incident = true;
+  /* Epoch with missing data which has been reported with an incident */
+  Uint64 reported_gap_gci= 0;
 
   pthread_mutex_lock(&injector_mutex);
   /*
@@ -6771,9 +6774,7 @@ ndb_binlog_thread_func(void *arg)
 
   pthread_detach_this_thread();
   thd->real_id= pthread_self();
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
   thd->lex->start_transaction_opt= 0;
 
 
@@ -6810,6 +6811,7 @@ restart_cluster_failure:
     pthread_cond_signal(&injector_cond);
     goto err;
   }
+  i_ndb->setEventBufferMaxAlloc(opt_ndb_eventbuffer_max_alloc);
 
   /*
     Expose global reference to our ndb object.
@@ -7179,15 +7181,29 @@ restart_cluster_failure:
       if (!pOp)
       {
         /*
-          Must be an empty epoch since the condition
+          Either an empty epoch, since the condition
           (ndb_log_empty_epochs() &&
            gci > ndb_latest_handled_binlog_epoch)
           must be true we write empty epoch into
-          ndb_binlog_index
+          ndb_binlog_index, or an epoch where events were
+          discarded, e.g. since the event buffer was full
         */
+        Uint64 gap_gci;
         DBUG_PRINT("info", ("Writing empty epoch for gci %llu", gci));
         DBUG_PRINT("info", ("Initializing transaction"));
         inj->new_trans(thd, &trans);
+        if (!i_ndb->isConsistent(gap_gci) && gap_gci != reported_gap_gci)
+        {
+          char errmsg[64];
+          uint end= sprintf(&errmsg[0],
+                            "Detected missing data in GCI %llu, "
+                            "inserting GAP event", gap_gci);
+          errmsg[end]= '\0';
+          sql_print_warning("NDB Binlog: %s", errmsg);
+          LEX_STRING const msg= { C_STRING_WITH_LEN(errmsg) };
+          inj->record_incident(thd, INCIDENT_LOST_EVENTS, msg);
+          reported_gap_gci= gap_gci;
+        }
         rows= &_row;
         memset(&_row, 0, sizeof(_row));
         thd->variables.character_set_client= &my_charset_latin1;
@@ -7210,6 +7226,7 @@ restart_cluster_failure:
         i_ndb->
           setReportThreshEventGCISlip(opt_ndb_report_thresh_binlog_epoch_slip);
         i_ndb->setReportThreshEventFreeMem(opt_ndb_report_thresh_binlog_mem_usage);
+        i_ndb->setEventBufferMaxAlloc(opt_ndb_eventbuffer_max_alloc);
 
         memset(&_row, 0, sizeof(_row));
         thd->variables.character_set_client= &my_charset_latin1;
@@ -25,6 +25,9 @@
 #ifdef WITH_NDBCLUSTER_STORAGE_ENGINE
 #include <ndbapi/NdbApi.hpp>
 #include "ha_ndbcluster_cond.h"
+#include <ndb_version.h>
+
+extern Ndb_cluster_connection* g_ndb_cluster_connection;
 
 // Typedefs for long names 
 typedef NdbDictionary::Column NDBCOL;
@@ -261,7 +264,42 @@ ndb_serialize_cond(const Item *item, void *arg)
             Check that the field is part of the table of the handler
             instance and that we expect a field with of this result type.
           */
-          if (context->table->s == field->table->s)
+          if (context->table->s == field->table->s &&
+              context->col_cmp_field != NULL &&
+              context->expecting(Item::FIELD_ITEM))
+          {
+            /*
+              Second argument of a comparison whose first argument
+              was a column, both columns must be NOT NULL and of
+              the same type for the comparison to be pushed
+            */
+            Field *first= context->col_cmp_field;
+            context->col_cmp_field= NULL;
+            if (!field->maybe_null() &&
+                field->eq_def(first) &&
+                type != MYSQL_TYPE_BIT &&
+                type != MYSQL_TYPE_TINY_BLOB &&
+                type != MYSQL_TYPE_MEDIUM_BLOB &&
+                type != MYSQL_TYPE_LONG_BLOB &&
+                type != MYSQL_TYPE_BLOB)
+            {
+              const NDBCOL *col= context->ndb_table->getColumn(field->field_name);
+              DBUG_ASSERT(col);
+              DBUG_PRINT("info", ("column %s compared with column %s",
+                                  field->field_name, first->field_name));
+              curr_cond->ndb_item= new Ndb_item(field, col->getColumnNo());
+              // Expect another logical expression
+              context->expect_only(Item::FUNC_ITEM);
+              context->expect(Item::COND_ITEM);
+            }
+            else
+            {
+              DBUG_PRINT("info", ("Can not compare column %s with column %s",
+                                  field->field_name, first->field_name));
+              context->supported= FALSE;
+            }
+          }
+          else if (context->table->s == field->table->s)
           {       
             const NDBTAB *tab= context->ndb_table;
             DBUG_PRINT("info", ("FIELD_ITEM"));
@@ -304,6 +342,8 @@ ndb_serialize_cond(const Item *item, void *arg)
               if (! context->expecting_nothing())
               {
                 // We have not seen second argument yet
+                const bool col_cmp= context->col_cmp_allowed &&
+                                    !field->maybe_null();
                 if (type == MYSQL_TYPE_TIME ||
                     type == MYSQL_TYPE_TIME2 ||
                     type == MYSQL_TYPE_DATE || 
@@ -341,6 +381,12 @@ ndb_serialize_cond(const Item *item, void *arg)
                   default:
                     break;
                   }    
+                if (col_cmp)
+                {
+                  // Second argument may be another column of this table
+                  context->col_cmp_field= field;
+                  context->expect(Item::FIELD_ITEM);
+                }
               }
               else
               {
@@ -396,6 +442,17 @@ ndb_serialize_cond(const Item *item, void *arg)
             break;
           }
           context->expect_no_length();
+          context->col_cmp_field= NULL;
+          context->col_cmp_allowed=
+            !context->rewrite_stack &&
+            (func_item->functype() == Item_func::EQ_FUNC ||
+             func_item->functype() == Item_func::NE_FUNC ||
+             func_item->functype() == Item_func::LT_FUNC ||
+             func_item->functype() == Item_func::LE_FUNC ||
+             func_item->functype() == Item_func::GE_FUNC ||
+             func_item->functype() == Item_func::GT_FUNC) &&
+            ndbd_interpreter_branch_col_col(
+              g_ndb_cluster_connection->get_min_db_version());
           switch (func_item->functype()) {
           case Item_func::EQ_FUNC:
           {
@@ -1222,6 +1279,34 @@ ha_ndbcluster_cond::build_scan_filter_predicate(Ndb_cond * &cond,
       DBUG_ASSERT(0);
       break;
     }
+    if (cond->ndb_item->argument_count() == 2 && cond->next->next &&
+        a->type == NDB_FIELD && b->type == NDB_FIELD)
+    {
+      /*
+        Comparison of two columns of the same row, only accepted by
+        traverse_cond_comp for NOT NULL columns of the same type
+      */
+      NdbScanFilter::BinaryCondition col_cond;
+      switch ((negated) ?
+              Ndb_item::negate(cond->ndb_item->qualification.function_type)
+              : cond->ndb_item->qualification.function_type) {
+      case NDB_EQ_FUNC: col_cond= NdbScanFilter::COND_EQ; break;
+      case NDB_NE_FUNC: col_cond= NdbScanFilter::COND_NE; break;
+      case NDB_LT_FUNC: col_cond= NdbScanFilter::COND_LT; break;
+      case NDB_LE_FUNC: col_cond= NdbScanFilter::COND_LE; break;
+      case NDB_GE_FUNC: col_cond= NdbScanFilter::COND_GE; break;
+      case NDB_GT_FUNC: col_cond= NdbScanFilter::COND_GT; break;
+      default:
+        DBUG_RETURN(1);
+      }
+      DBUG_PRINT("info", ("Generating column compare filter"));
+      if (filter->cmp_cols(col_cond,
+                           a->get_field_no(),
+                           b->get_field_no()) == -1)
+        DBUG_RETURN(1);
+      cond= cond->next->next->next;
+      DBUG_RETURN(0);
+    }
     switch ((negated) ? 
             Ndb_item::negate(cond->ndb_item->qualification.function_type)
             : cond->ndb_item->qualification.function_type) {
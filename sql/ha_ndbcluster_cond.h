@@ -575,7 +575,8 @@ class Ndb_cond_traverse_context : public Sql_alloc
 			     Ndb_cond_stack* stack)
     : table(tab), ndb_table(ndb_tab), 
     supported(TRUE), cond_stack(stack), cond_ptr(NULL),
-    skip(0), rewrite_stack(NULL)
+    skip(0), rewrite_stack(NULL),
+    col_cmp_allowed(FALSE), col_cmp_field(NULL)
   { 
    if (stack)
       cond_ptr= stack->ndb_cond;
@@ -692,6 +693,11 @@ class Ndb_cond_traverse_context : public Sql_alloc
   Ndb_expect_stack expect_stack;
   uint skip;
   Ndb_rewrite_context *rewrite_stack;
+  /* Current comparison may have a column as second argument */
+  bool col_cmp_allowed;
+  /* First argument of the current comparison, if it may be compared
+     with another column */
+  Field *col_cmp_field;
 };
 
 class ha_ndbcluster;
@@ -82,7 +82,8 @@ using std::max;
 #define PARTITION_DISABLED_TABLE_FLAGS (HA_CAN_GEOMETRY | \
                                         HA_CAN_FULLTEXT | \
                                         HA_DUPLICATE_POS | \
-                                        HA_READ_BEFORE_WRITE_REMOVAL)
+                                        HA_READ_BEFORE_WRITE_REMOVAL | \
+                                        HA_CAN_READ_BATCH)
 static const char *ha_par_ext= ".par";
 
 /****************************************************************************
@@ -604,6 +604,9 @@ int ha_finalize_handlerton(st_plugin_int *plugin)
     break;
   };
 
+  if (hton == innodb_hton)
+    innodb_hton= NULL;
+
   if (hton->panic)
     hton->panic(hton, HA_PANIC_CLOSE);
 
@@ -751,6 +754,9 @@ int ha_initialize_handlerton(st_plugin_int *plugin)
   case DB_TYPE_MYISAM:
     myisam_hton= hton;
     break;
+  case DB_TYPE_INNODB:
+    innodb_hton= hton;
+    break;
   case DB_TYPE_PARTITION_DB:
     partition_hton= hton;
     break;
@@ -2709,6 +2715,44 @@ int handler::ha_rnd_next(uchar *buf)
 }
 
 
+/**
+  Read a batch of rows via random scan.
+
+  @param[out] buf        Buffer for max_rows records
+  @param      max_rows   Maximum number of rows to read
+  @param[out] rows_read  Number of rows stored in buf
+
+  @return Operation status
+    @retval 0     Success
+    @retval != 0  Error that ended the batch; the rows read are still valid
+*/
+
+int handler::ha_rnd_next_batch(uchar *buf, uint max_rows, uint *rows_read)
+{
+  int result;
+  DBUG_ENTER("handler::ha_rnd_next_batch");
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
+              m_lock_type != F_UNLCK);
+  DBUG_ASSERT(inited == RND);
+  DBUG_ASSERT(max_rows > 0);
+
+  MYSQL_TABLE_IO_WAIT(m_psi, PSI_TABLE_FETCH_ROW, MAX_KEY, 0,
+    { result= rnd_next_batch(buf, max_rows, rows_read); })
+#ifdef HAVE_PSI_TABLE_INTERFACE
+  /*
+    The wait above is charged with the whole batch. Count one fetch for
+    each of the other rows, so that the per-row statistics stay exact.
+  */
+  if (m_psi != NULL)
+  {
+    for (uint i= 1; i < *rows_read; i++)
+      MYSQL_TABLE_IO_WAIT(m_psi, PSI_TABLE_FETCH_ROW, MAX_KEY, 0, {})
+  }
+#endif
+  DBUG_RETURN(result);
+}
+
+
 /**
   Read row via random scan from position.
 
@@ -5626,7 +5670,33 @@ double handler::index_only_read_time(uint keynr, double records)
                         1);
   read_time=((double) (records + keys_per_block-1) /
              (double) keys_per_block);
-  return read_time;
+  return page_read_cost(read_time);
+}
+
+
+/**
+  Estimate the fraction of the table that is in the memory buffer of the
+  storage engine.
+
+  The buffer is shared by all tables, so a table is assumed to be cached
+  only if it takes up to a fifth of the buffer, and in proportion to the
+  buffer size otherwise. Engines that can tell what they have in memory
+  may override this.
+
+  @return 0.0 if the engine reports no memory buffer, else the estimate
+*/
+
+double handler::table_in_memory_estimate() const
+{
+  const longlong buffer_size= get_memory_buffer_size();
+  if (buffer_size <= 0)
+    return 0.0;
+  const double table_size= ulonglong2double(stats.data_file_length +
+                                            stats.index_file_length);
+  const double cached_size= 0.2 * (double) buffer_size;
+  if (table_size <= cached_size)
+    return 1.0;
+  return cached_size / table_size;
 }
 
 
@@ -241,6 +241,12 @@ enum enum_alter_inplace_result {
 */
 #define HA_BLOCK_CONST_TABLE          (LL(1) << 42)
 
+/*
+  The handler implements rnd_next_batch() and may return several rows of a
+  table scan per call. Used by full table scans in records.cc.
+*/
+#define HA_CAN_READ_BATCH             (LL(1) << 43)
+
 /* bits in index_flags(index_number) for what you can do with index */
 #define HA_READ_NEXT            1       /* TODO really use this flag */
 #define HA_READ_PREV            2       /* supports ::index_prev */
@@ -334,6 +340,7 @@ enum enum_alter_inplace_result {
 #define HA_LEX_CREATE_TMP_TABLE	1
 #define HA_LEX_CREATE_IF_NOT_EXISTS 2
 #define HA_LEX_CREATE_TABLE_LIKE 4
+#define HA_LEX_CREATE_INTERNAL_TMP_TABLE 8
 #define HA_OPTION_NO_CHECKSUM	(1L << 17)
 #define HA_OPTION_NO_DELAY_KEY_WRITE (1L << 18)
 #define HA_MAX_REC_LENGTH	65535U
@@ -1613,7 +1620,7 @@ private:
 public:
 
   /// The cost of one I/O operation
-  static double IO_BLOCK_READ_COST() { return  1.0; } 
+  static double IO_BLOCK_READ_COST() { return opt_io_block_read_cost; }
 
   Cost_estimate() :
     io_cost(0),
@@ -2032,6 +2039,7 @@ public:
   int ha_rnd_init(bool scan);
   int ha_rnd_end();
   int ha_rnd_next(uchar *buf);
+  int ha_rnd_next_batch(uchar *buf, uint max_rows, uint *rows_read);
   int ha_rnd_pos(uchar * buf, uchar *pos);
   int ha_index_read_map(uchar *buf, const uchar *key,
                         key_part_map keypart_map,
@@ -2142,7 +2150,10 @@ public:
   }
   /* Estimates calculation */
   virtual double scan_time()
-  { return ulonglong2double(stats.data_file_length) / IO_SIZE + 2; }
+  {
+    return page_read_cost(ulonglong2double(stats.data_file_length) / IO_SIZE) +
+           2;
+  }
 
 
 /**
@@ -2157,7 +2168,7 @@ public:
    using an index by calling it using read_time(index, 1, table_size).
 */
   virtual double read_time(uint index, uint ranges, ha_rows rows)
-  { return rows2double(ranges+rows); }
+  { return page_read_cost(rows2double(ranges+rows)); }
 
   virtual double index_only_read_time(uint keynr, double records);
   
@@ -2168,6 +2179,34 @@ public:
   */
   virtual longlong get_memory_buffer_size() const { return -1; }
 
+  /**
+    Return an estimate of the fraction of the table that is in the memory
+    buffer of the storage engine, from 0.0 to 1.0.
+  */
+  virtual double table_in_memory_estimate() const;
+
+  /**
+    The cost of reading a number of blocks of the table, each block being
+    read from the memory buffer or from disk in proportion to
+    table_in_memory_estimate().
+  */
+  double page_read_cost(double blocks) const
+  {
+    if (opt_memory_block_read_cost == opt_io_block_read_cost)
+      return blocks * opt_io_block_read_cost;
+    const double in_memory= table_in_memory_estimate();
+    return blocks * (in_memory * opt_memory_block_read_cost +
+                     (1.0 - in_memory) * opt_io_block_read_cost);
+  }
+
+  /**
+    Return an estimate of the fraction of the rows of the table whose
+    column is equal to the value currently stored in the field, e.g. from
+    a column histogram kept by the storage engine. If the engine has no
+    such estimate, a negative value is returned.
+  */
+  virtual double column_eq_selectivity(const Field *field) { return -1.0; }
+
   virtual ha_rows multi_range_read_info_const(uint keyno, RANGE_SEQ_IF *seq,
                                               void *seq_init_param, 
                                               uint n_ranges, uint *bufsz,
@@ -2354,6 +2393,16 @@ protected:
     return index_read_last(buf, key, key_len);
   }
 public:
+  /**
+    Hint that the row with the given key of the active index will be read
+    soon. The engine may start reading the pages that hold it in the
+    background and return without waiting for them. The default does
+    nothing.
+
+    @param key          Key value, as for index_read_map()
+    @param keypart_map  Which parts of the key are present in key
+  */
+  virtual void prefetch_key(const uchar *key, key_part_map keypart_map) {}
   virtual int read_range_first(const key_range *start_key,
                                const key_range *end_key,
                                bool eq_range, bool sorted);
@@ -2379,6 +2428,28 @@ public:
 protected:
   /// @returns @see index_read_map().
   virtual int rnd_next(uchar *buf)=0;
+  /**
+    Read the next rows of a table scan into consecutive record buffers.
+
+    Row i is stored at buf + i * table->s->rec_buff_length. The rows must
+    stay valid after the call returns, so an engine copies only rows that do
+    not point into its own buffers (e.g. no BLOBs), and it may return fewer
+    rows than asked for at any time. The default implementation reads one
+    row with rnd_next().
+
+    @param[out] buf        Buffer for max_rows records
+    @param      max_rows   Maximum number of rows to read, at least 1
+    @param[out] rows_read  Number of rows stored in buf
+
+    @return The error that ended the batch, or 0 if no error happened.
+      The rows_read rows are valid even if an error is returned.
+  */
+  virtual int rnd_next_batch(uchar *buf, uint max_rows, uint *rows_read)
+  {
+    int error= rnd_next(buf);
+    *rows_read= error ? 0 : 1;
+    return error;
+  }
   /// @returns @see index_read_map().
   virtual int rnd_pos(uchar * buf, uchar *pos)=0;
 public:
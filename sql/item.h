@@ -31,6 +31,7 @@ struct TABLE_LIST;
 void item_init(void);			/* Init item functions */
 class Item_field;
 class user_var_entry;
+class Cond_kernel;
 
 typedef Bounds_checked_array<Item*> Ref_ptr_array;
 
@@ -1677,6 +1678,16 @@ public:
     return test(is_expensive_cache);
   }
   virtual bool can_be_evaluated_now() const;
+  /**
+    Add this condition to a kernel that evaluates it directly on the rows
+    of a table, see Cond_kernel. Only items that the kernel evaluates like
+    val_int() does, or that give FALSE where val_int() gives NULL, add
+    themselves.
+
+    @retval false  the condition was added
+    @retval true   the condition cannot be evaluated by a kernel
+  */
+  virtual bool add_to_cond_kernel(Cond_kernel *kernel) { return true; }
   uint32 max_char_length() const
   { return max_length / collation.collation->mbmaxlen; }
   void fix_length_and_charset(uint32 max_char_length_arg,
@@ -27,6 +27,7 @@
 #include "sql_optimizer.h"             // JOIN_TAB
 #include "sql_parse.h"                          // check_stack_overrun
 #include "sql_time.h"                  // make_truncated_value_warning
+#include "sql_cond_kernel.h"            // Cond_kernel
 
 #include <algorithm>
 using std::min;
@@ -992,6 +993,7 @@ int Arg_comparator::set_cmp_func(Item_result_field *owner_arg,
   set_null= set_null && owner_arg;
   a= a1;
   b= a2;
+  is_int_field_cmp= false;
 
   if (can_compare_as_dates(*a, *b, &const_value))
   {
@@ -1058,7 +1060,125 @@ int Arg_comparator::set_cmp_func(Item_result_field *owner_arg,
 
   a= cache_converted_constant(thd, a, &a_cache, type);
   b= cache_converted_constant(thd, b, &b_cache, type);
-  return set_compare_func(owner_arg, type);
+  if (set_compare_func(owner_arg, type))
+    return 1;
+  set_int_field_cmp_func();
+  return 0;
+}
+
+
+/**
+  @returns the field of an integer column item whose value can be read by
+  int_field_value(), or NULL
+*/
+
+static Field *int_column_field(Item *item, bool is_unsigned)
+{
+  if (item->type() != Item::FIELD_ITEM)
+    return NULL;
+  Field *field= static_cast<Item_field*>(item)->field;
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    break;
+  default:
+    return NULL;
+  }
+  if (test(field->flags & UNSIGNED_FLAG) != is_unsigned)
+    return NULL;
+#ifdef WORDS_BIGENDIAN
+  /* The column is stored in the native byte order. */
+  if (!field->table->s->db_low_byte_first)
+    return NULL;
+#endif
+  return field;
+}
+
+
+/**
+  Select a comparison function that reads the values of integer columns
+  directly from the record buffer instead of calling val_int().
+
+  It is used when *a is a TINYINT, SMALLINT, INT or BIGINT column and *b
+  is an integer constant or a column of the same type, and both are
+  compared as signed or both as unsigned integers.
+*/
+
+void Arg_comparator::set_int_field_cmp_func()
+{
+  static const arg_cmp_func field_const_funcs[2][4]=
+  {
+    { &Arg_comparator::compare_int_field_const<int8>,
+      &Arg_comparator::compare_int_field_const<int16>,
+      &Arg_comparator::compare_int_field_const<int32>,
+      &Arg_comparator::compare_int_field_const<longlong> },
+    { &Arg_comparator::compare_int_field_const<uint8>,
+      &Arg_comparator::compare_int_field_const<uint16>,
+      &Arg_comparator::compare_int_field_const<uint32>,
+      &Arg_comparator::compare_int_field_const<ulonglong> }
+  };
+  static const arg_cmp_func fields_funcs[2][4]=
+  {
+    { &Arg_comparator::compare_int_fields<int8>,
+      &Arg_comparator::compare_int_fields<int16>,
+      &Arg_comparator::compare_int_fields<int32>,
+      &Arg_comparator::compare_int_fields<longlong> },
+    { &Arg_comparator::compare_int_fields<uint8>,
+      &Arg_comparator::compare_int_fields<uint16>,
+      &Arg_comparator::compare_int_fields<uint32>,
+      &Arg_comparator::compare_int_fields<ulonglong> }
+  };
+
+  const bool is_unsigned= func == &Arg_comparator::compare_int_unsigned;
+  if (!is_unsigned && func != &Arg_comparator::compare_int_signed)
+    return;
+  Field *field_a= int_column_field(*a, is_unsigned);
+  if (!field_a)
+    return;
+
+  Field *field_b= NULL;
+  if ((*b)->type() == Item::INT_ITEM)
+  {
+    int_field_const= (*b)->val_int();
+    if ((*b)->null_value)
+      return;
+  }
+  else if (!(field_b= int_column_field(*b, is_unsigned)) ||
+           field_b->real_type() != field_a->real_type())
+    return;
+
+  uint index;
+  switch (field_a->pack_length()) {
+  case 1: index= 0; break;
+  case 2: index= 1; break;
+  case 4: index= 2; break;
+  default: index= 3; break;
+  }
+  is_int_field_cmp= true;
+  int_field_fallback= func;
+  int_field_item_a= *a;
+  int_field_item_b= *b;
+  int_field_a= field_a;
+  int_field_b= field_b;
+  func= field_b ? fields_funcs[is_unsigned][index] :
+                  field_const_funcs[is_unsigned][index];
+}
+
+
+/**
+  Check if the arguments are still the items and fields that the
+  compare_int_field_* function was selected for. Items may be substituted
+  after set_cmp_func(), e.g. by equality propagation, and an Item_field
+  may be bound to another field.
+*/
+
+bool Arg_comparator::int_field_args_changed(bool b_is_field) const
+{
+  return *a != int_field_item_a || *b != int_field_item_b ||
+         static_cast<Item_field*>(*a)->field != int_field_a ||
+         (b_is_field && static_cast<Item_field*>(*b)->field != int_field_b);
 }
 
 
@@ -1304,6 +1424,15 @@ get_year_value(THD *thd, Item ***item_arg, Item **cache_arg,
 }
 
 
+/// @returns true if both arguments are compared as packed DATETIME values
+bool Arg_comparator::compares_as_datetime() const
+{
+  return func == &Arg_comparator::compare_datetime &&
+         get_value_a_func == &get_datetime_value &&
+         get_value_b_func == &get_datetime_value;
+}
+
+
 /*
   Compare items values as dates.
 
@@ -1567,6 +1696,91 @@ int Arg_comparator::compare_int_signed()
 }
 
 
+/// @returns the value of an integer column as stored by Field_num
+template <typename T> static inline T int_field_value(const uchar *ptr);
+
+template <> inline int8 int_field_value<int8>(const uchar *ptr)
+{ return (int8) *ptr; }
+template <> inline uint8 int_field_value<uint8>(const uchar *ptr)
+{ return *ptr; }
+template <> inline int16 int_field_value<int16>(const uchar *ptr)
+{ return sint2korr(ptr); }
+template <> inline uint16 int_field_value<uint16>(const uchar *ptr)
+{ return uint2korr(ptr); }
+template <> inline int32 int_field_value<int32>(const uchar *ptr)
+{ return sint4korr(ptr); }
+template <> inline uint32 int_field_value<uint32>(const uchar *ptr)
+{ return uint4korr(ptr); }
+template <> inline longlong int_field_value<longlong>(const uchar *ptr)
+{ return sint8korr(ptr); }
+template <> inline ulonglong int_field_value<ulonglong>(const uchar *ptr)
+{ return uint8korr(ptr); }
+
+
+template <typename T>
+static inline int cmp_int_values(T val1, T val2)
+{
+  if (val1 < val2)  return -1;
+  if (val1 == val2) return 0;
+  return 1;
+}
+
+
+/**
+  Compare an integer column of type T with an integer constant, like
+  compare_int_signed() and compare_int_unsigned() do.
+*/
+
+template <typename T>
+int Arg_comparator::compare_int_field_const()
+{
+  if (unlikely(int_field_args_changed(false)))
+  {
+    is_int_field_cmp= false;
+    func= int_field_fallback;
+    return (this->*func)();
+  }
+  const Field *field= int_field_a;
+  if (((*a)->null_value= field->is_null()))
+  {
+    if (set_null)
+      owner->null_value= 1;
+    return -1;
+  }
+  if (set_null)
+    owner->null_value= 0;
+  const T val1= int_field_value<T>(field->ptr);
+  if (T(-1) < T(0))
+    return cmp_int_values((longlong) val1, int_field_const);
+  return cmp_int_values((ulonglong) val1, (ulonglong) int_field_const);
+}
+
+
+/// Compare two integer columns of type T
+template <typename T>
+int Arg_comparator::compare_int_fields()
+{
+  if (unlikely(int_field_args_changed(true)))
+  {
+    is_int_field_cmp= false;
+    func= int_field_fallback;
+    return (this->*func)();
+  }
+  const Field *field1= int_field_a, *field2= int_field_b;
+  if (!((*a)->null_value= field1->is_null()) &&
+      !((*b)->null_value= field2->is_null()))
+  {
+    if (set_null)
+      owner->null_value= 0;
+    return cmp_int_values(int_field_value<T>(field1->ptr),
+                          int_field_value<T>(field2->ptr));
+  }
+  if (set_null)
+    owner->null_value= 1;
+  return -1;
+}
+
+
 /**
   Compare arguments using numeric packed temporal representation.
 */
@@ -2759,6 +2973,21 @@ longlong Item_func_between::val_int()
 }
 
 
+bool Item_func_between::add_to_cond_kernel(Cond_kernel *kernel)
+{
+  if (negated || compare_as_dates_with_strings || compare_as_temporal_times)
+    return true;
+  if (cmp_type == INT_RESULT)
+    return compare_as_temporal_dates ?
+      kernel->add_date_cmp(Cond_kernel::CMP_BETWEEN, args[0], args[1], args[2]) :
+      kernel->add_int_cmp(Cond_kernel::CMP_BETWEEN, args[0], args[1], args[2]);
+  if (cmp_type == DECIMAL_RESULT)
+    return kernel->add_decimal_cmp(Cond_kernel::CMP_BETWEEN,
+                                   args[0], args[1], args[2]);
+  return true;
+}
+
+
 void Item_func_between::print(String *str, enum_query_type query_type)
 {
   str->append('(');
@@ -3873,12 +4102,80 @@ static int cmp_decimal(void *cmp_arg, my_decimal *a, my_decimal *b)
 }
 
 
+/* Add a longlong in machine independent byte order to the hash nr1/nr2 */
+
+static void hash_longlong(longlong value, ulong *nr1, ulong *nr2)
+{
+  uchar buff[8];
+  int8store(buff, value);
+  my_charset_bin.coll->hash_sort(&my_charset_bin, buff, sizeof(buff),
+                                 nr1, nr2);
+}
+
+
+static void hash_double(double value, ulong *nr1, ulong *nr2)
+{
+  uchar buff[8];
+  if (value == 0.0)
+    value= 0.0;                                 // -0.0 equals 0.0
+  float8store(buff, value);
+  my_charset_bin.coll->hash_sort(&my_charset_bin, buff, sizeof(buff),
+                                 nr1, nr2);
+}
+
+
+/*
+  Hash the sorted values with linear probing. Equal values are adjacent
+  after sort(), so only the first of them is entered.
+*/
+
+void in_vector::build_hash_table()
+{
+  uint slots= 1;
+  uint *table;
+  ulong hash;
+
+  if (hash_value((uchar*) base, &hash))
+    return;                                     // Values can't be hashed
+  while (slots < used_count * 2)
+    slots<<= 1;
+  if (!(table= (uint*) sql_calloc(slots * sizeof(uint))))
+    return;
+  hash_mask= slots - 1;
+  for (uint i= 0; i < used_count; i++)
+  {
+    if (i && !compare_elems(i, i - 1))
+      continue;
+    if (hash_value((uchar*) base + i * size, &hash))
+      return;
+    uint slot= hash & hash_mask;
+    while (table[slot])
+      slot= (slot + 1) & hash_mask;
+    table[slot]= i + 1;
+  }
+  hash_table= table;
+}
+
+
 int in_vector::find(Item *item)
 {
   uchar *result=get_value(item);
   if (!result || !used_count)
     return 0;				// Null value
 
+  ulong hash;
+  if (hash_table && !hash_value(result, &hash))
+  {
+    for (uint slot= hash & hash_mask; hash_table[slot];
+         slot= (slot + 1) & hash_mask)
+    {
+      if ((*compare)(collation, base + (hash_table[slot] - 1) * size,
+                     result) == 0)
+        return 1;
+    }
+    return 0;
+  }
+
   uint start,end;
   start=0; end=used_count-1;
   while (start != end)
@@ -3939,6 +4236,17 @@ uchar *in_string::get_value(Item *item)
   return (uchar*) item->val_str(&tmp);
 }
 
+
+bool in_string::hash_value(const uchar *value, ulong *hash)
+{
+  const String *str= (const String*) value;
+  ulong nr2= 4;
+  *hash= 1;
+  collation->coll->hash_sort(collation, (const uchar*) str->ptr(),
+                             str->length(), hash, &nr2);
+  return false;
+}
+
 in_row::in_row(uint elements, Item * item)
 {
   base= (char*) new cmp_item_row[count= elements];
@@ -3966,6 +4274,13 @@ uchar *in_row::get_value(Item *item)
   return (uchar *)&tmp;
 }
 
+bool in_row::hash_value(const uchar *value, ulong *hash)
+{
+  ulong nr2= 4;
+  *hash= 1;
+  return ((cmp_item_row*) value)->hash_value(hash, &nr2);
+}
+
 void in_row::set(uint pos, Item *item)
 {
   DBUG_ENTER("in_row::set");
@@ -3996,6 +4311,20 @@ uchar *in_longlong::get_value(Item *item)
 }
 
 
+/*
+  cmp_longlong() only finds values with the same bits equal, whatever
+  their signedness, so unsigned_flag is left out of the hash.
+*/
+
+bool in_longlong::hash_value(const uchar *value, ulong *hash)
+{
+  ulong nr2= 4;
+  *hash= 1;
+  hash_longlong(((const packed_longlong*) value)->val, hash, &nr2);
+  return false;
+}
+
+
 void in_time_as_longlong::set(uint pos,Item *item)
 {
   struct packed_longlong *buff= &((packed_longlong*) base)[pos];
@@ -4073,6 +4402,15 @@ uchar *in_double::get_value(Item *item)
 }
 
 
+bool in_double::hash_value(const uchar *value, ulong *hash)
+{
+  ulong nr2= 4;
+  *hash= 1;
+  hash_double(*(const double*) value, hash, &nr2);
+  return false;
+}
+
+
 in_decimal::in_decimal(uint elements)
   :in_vector(elements, sizeof(my_decimal),(qsort2_cmp) cmp_decimal, 0)
 {}
@@ -4143,6 +4481,40 @@ cmp_item* cmp_item_row::make_same()
 }
 
 
+bool cmp_item_string::hash_value(ulong *nr1, ulong *nr2)
+{
+  if (!value_res)
+    *nr1^= (*nr1 << 1) | 1;                     // Same as for SQL NULL
+  else
+    cmp_charset->coll->hash_sort(cmp_charset,
+                                 (const uchar*) value_res->ptr(),
+                                 value_res->length(), nr1, nr2);
+  return false;
+}
+
+bool cmp_item_int::hash_value(ulong *nr1, ulong *nr2)
+{
+  hash_longlong(value, nr1, nr2);
+  return false;
+}
+
+bool cmp_item_real::hash_value(ulong *nr1, ulong *nr2)
+{
+  hash_double(value, nr1, nr2);
+  return false;
+}
+
+bool cmp_item_row::hash_value(ulong *nr1, ulong *nr2)
+{
+  for (uint i= 0; i < n; i++)
+  {
+    if (comparators[i]->hash_value(nr1, nr2))
+      return true;
+  }
+  return false;
+}
+
+
 cmp_item_row::~cmp_item_row()
 {
   DBUG_ENTER("~cmp_item_row");
@@ -4312,6 +4684,13 @@ cmp_item *cmp_item_datetime::make_same()
 }
 
 
+bool cmp_item_datetime::hash_value(ulong *nr1, ulong *nr2)
+{
+  hash_longlong(value, nr1, nr2);
+  return false;
+}
+
+
 bool Item_func_in::nulls_in_row()
 {
   Item **arg,**arg_end;
@@ -5072,6 +5451,25 @@ void Item_cond::neg_arguments(THD *thd)
 }
 
 
+bool Item_cond::add_to_cond_kernel(Cond_kernel *kernel)
+{
+  if (functype() != COND_AND_FUNC && functype() != COND_OR_FUNC)
+    return true;
+  uint group;
+  if (kernel->begin_group(functype() == COND_AND_FUNC, &group))
+    return true;
+  List_iterator_fast<Item> li(list);
+  Item *item;
+  while ((item= li++))
+  {
+    if (item->add_to_cond_kernel(kernel))
+      return true;
+  }
+  kernel->end_group(group);
+  return false;
+}
+
+
 /**
   Evaluation of AND(expr, expr, expr ...).
 
@@ -5184,6 +5582,16 @@ longlong Item_func_isnull::val_int()
   return args[0]->is_null() ? 1: 0;
 }
 
+
+bool Item_func_isnull::add_to_cond_kernel(Cond_kernel *kernel)
+{
+  /* Item_is_not_null_test::val_int() also updates its owner */
+  if (functype() != ISNULL_FUNC || const_item_cache)
+    return true;
+  return kernel->add_null_test(args[0], true);
+}
+
+
 longlong Item_is_not_null_test::val_int()
 {
   DBUG_ASSERT(fixed == 1);
@@ -5239,6 +5647,12 @@ longlong Item_func_isnotnull::val_int()
 }
 
 
+bool Item_func_isnotnull::add_to_cond_kernel(Cond_kernel *kernel)
+{
+  return kernel->add_null_test(args[0], false);
+}
+
+
 void Item_func_isnotnull::print(String *str, enum_query_type query_type)
 {
   str->append('(');
@@ -5265,6 +5679,8 @@ longlong Item_func_like::val_int()
   null_value=0;
   if (can_do_bm)
     return bm_matches(res->ptr(), res->length()) ? 1 : 0;
+  if (can_do_segments)
+    return segments_match(res->ptr(), res->length()) ? 1 : 0;
   return my_wildcmp(cmp.cmp_collation.collation,
 		    res->ptr(),res->ptr()+res->length(),
 		    res2->ptr(),res2->ptr()+res2->length(),
@@ -5405,6 +5821,9 @@ bool Item_func_like::fix_fields(THD *thd, Item **ref)
         bm_compute_bad_character_shifts();
         DBUG_PRINT("info",("done"));
       }
+      else if (len > 1 && *first == wild_many && *last == wild_many &&
+               !use_mb(args[0]->collation.collation))
+        can_do_segments= compile_segments(thd, first, len);
     }
   }
   return false;
@@ -5413,6 +5832,7 @@ bool Item_func_like::fix_fields(THD *thd, Item **ref)
 void Item_func_like::cleanup()
 {
   can_do_bm= false;
+  can_do_segments= false;
   Item_bool_func2::cleanup();
 }
 
@@ -5761,6 +6181,174 @@ bool Item_func_like::bm_matches(const char* text, int text_len) const
   }
 }
 
+/**
+  Split a '%abc%def%' pattern into its segments.
+
+  For each segment, choose the byte that the search looks for first.
+  In a case insensitive collation this is the byte that matches the
+  fewest other bytes, e.g. a letter with only two cases rather than
+  one with accented variants.
+
+  @param thd    Thread handle, the segments are allocated in its mem_root
+  @param first  The pattern, starting and ending with wild_many
+  @param len    Length of the pattern
+
+  @return
+    true if the pattern can be matched with segments_match()
+*/
+
+bool Item_func_like::compile_segments(THD *thd, const char *first, size_t len)
+{
+  const CHARSET_INFO *cs= cmp.cmp_collation.collation;
+  const char *end= first + len;
+  const char *p;
+  uint count= 0;
+
+  for (p= first + 1; p < end; p++)
+  {
+    if (*p == wild_one || *p == escape)
+      return false;
+    if (*p != wild_many && p[-1] == wild_many)
+      count++;
+  }
+  if (!(segments= (Like_segment*) thd->alloc(sizeof(Like_segment) *
+                                             max(count, 1U))))
+    return false;
+
+  segment_count= 0;
+  for (p= first; p < end; )
+  {
+    while (p < end && *p == wild_many)
+      p++;
+    const char *start= p;
+    while (p < end && *p != wild_many)
+      p++;
+    if (p == start)
+      break;
+
+    Like_segment *seg= &segments[segment_count++];
+    seg->length= (uint) (p - start);
+    if (!(seg->str= thd->strmake(start, seg->length)))
+      return false;
+    seg->anchor= 0;
+    seg->anchor_search= true;
+    seg->anchor_byte[0]= seg->anchor_byte[1]= (uchar) seg->str[0];
+    if (!cs->sort_order)
+      continue;
+
+    uint best_matches= alphabet_size + 1;
+    for (uint i= 0; i < seg->length; i++)
+    {
+      uchar weight= likeconv(cs, seg->str[i]);
+      uchar bytes[2];
+      uint matches= 0;
+      for (uint c= 0; c < alphabet_size; c++)
+      {
+        if (likeconv(cs, c) == weight)
+        {
+          if (matches < 2)
+            bytes[matches]= (uchar) c;
+          matches++;
+        }
+      }
+      if (matches < best_matches)
+      {
+        best_matches= matches;
+        seg->anchor= i;
+        seg->anchor_byte[0]= bytes[0];
+        seg->anchor_byte[1]= matches > 1 ? bytes[1] : bytes[0];
+      }
+    }
+    seg->anchor_search= best_matches <= 2;
+  }
+  return true;
+}
+
+
+/**
+  Check if a segment matches the text at the given position.
+*/
+
+bool Item_func_like::segment_equal(const Like_segment *seg,
+                                   const char *text) const
+{
+  const CHARSET_INFO *cs= cmp.cmp_collation.collation;
+  if (!cs->sort_order)
+    return !memcmp(seg->str, text, seg->length);
+  for (uint i= 0; i < seg->length; i++)
+  {
+    if (likeconv(cs, seg->str[i]) != likeconv(cs, text[i]))
+      return false;
+  }
+  return true;
+}
+
+
+/**
+  Find the first match of a segment in a text.
+
+  Candidate positions are found with memchr()/my_memchr2() on the
+  anchor byte of the segment, which scan many bytes at a time.
+
+  @return
+    The start of the match, or NULL if there is none
+*/
+
+const char *Item_func_like::find_segment(const Like_segment *seg,
+                                         const char *text,
+                                         const char *end) const
+{
+  if ((size_t) (end - text) < seg->length)
+    return NULL;
+  const char *last= end - seg->length;          // Last possible start
+
+  if (!seg->anchor_search)
+  {
+    for (; text <= last; text++)
+    {
+      if (segment_equal(seg, text))
+        return text;
+    }
+    return NULL;
+  }
+
+  const char *p= text + seg->anchor;
+  const char *p_end= last + seg->anchor + 1;
+  while ((p= my_memchr2(p, p_end, seg->anchor_byte[0], seg->anchor_byte[1])))
+  {
+    if (segment_equal(seg, p - seg->anchor))
+      return p - seg->anchor;
+    p++;
+  }
+  return NULL;
+}
+
+
+/**
+  Match a text against a '%abc%def%' pattern.
+
+  Each segment is searched after the end of the first match of the
+  previous one. Taking the first match is always right, as it leaves
+  the most text for the segments after it.
+
+  @return
+    returns true/false for match/no match
+*/
+
+bool Item_func_like::segments_match(const char *text, size_t text_len) const
+{
+  const char *end= text + text_len;
+  for (uint i= 0; i < segment_count; i++)
+  {
+    const char *found= find_segment(&segments[i], text, end);
+    if (!found)
+      return false;
+    text= found + segments[i].length;
+  }
+  return true;
+}
+
+
 /**
   Make a logical XOR of the arguments.
 
@@ -5832,6 +6420,35 @@ Item *Item_bool_rowready_func2::neg_transformer(THD *thd)
   return item;
 }
 
+
+bool Item_bool_rowready_func2::add_to_cond_kernel(Cond_kernel *kernel)
+{
+  Cond_kernel::enum_cmp_op op;
+  switch (functype()) {
+  case EQ_FUNC: op= Cond_kernel::CMP_EQ; break;
+  case NE_FUNC: op= Cond_kernel::CMP_NE; break;
+  case LT_FUNC: op= Cond_kernel::CMP_LT; break;
+  case LE_FUNC: op= Cond_kernel::CMP_LE; break;
+  case GT_FUNC: op= Cond_kernel::CMP_GT; break;
+  case GE_FUNC: op= Cond_kernel::CMP_GE; break;
+  default:      return true;                  // <=> is true for NULLs
+  }
+  Item *column= args[0], *value= args[1];
+  if (column->type() != FIELD_ITEM)
+  {
+    column= args[1];
+    value= args[0];
+    op= Cond_kernel::swap_op(op);
+  }
+  if (cmp.compares_as_int())
+    return kernel->add_int_cmp(op, column, value, NULL);
+  if (cmp.compares_as_decimal())
+    return kernel->add_decimal_cmp(op, column, value, NULL);
+  if (cmp.compares_as_datetime())
+    return kernel->add_date_cmp(op, column, value, NULL);
+  return true;
+}
+
 /**
   XOR can be negated by negating one of the operands:
 
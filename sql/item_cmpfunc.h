@@ -49,7 +49,20 @@ class Arg_comparator: public Sql_alloc
                                Item *warn_item, bool *is_null);
   longlong (*get_value_b_func)(THD *thd, Item ***item_arg, Item **cache_arg,
                                Item *warn_item, bool *is_null);
+  /*
+    Integer comparisons reading the values from the Field storage, see
+    set_int_field_cmp_func(). The function is used only while *a and *b
+    are the items, and the fields, it was selected for; otherwise the
+    comparator goes back to int_field_fallback.
+  */
+  bool is_int_field_cmp;           // TRUE <=> func is compare_int_field_*
+  arg_cmp_func int_field_fallback;
+  Item *int_field_item_a, *int_field_item_b;
+  Field *int_field_a, *int_field_b;
+  longlong int_field_const;        // Value of the constant *b
   bool try_year_cmp_func(Item_result type);
+  void set_int_field_cmp_func();
+  bool int_field_args_changed(bool b_is_field) const;
   static bool get_date_from_const(Item *date_arg, Item *str_arg,
                                   ulonglong *value);
 public:
@@ -58,10 +71,10 @@ public:
   String value1, value2;
 
   Arg_comparator(): comparators(0), thd(0), a_cache(0), b_cache(0), set_null(TRUE),
-    get_value_a_func(0), get_value_b_func(0) {};
+    get_value_a_func(0), get_value_b_func(0), is_int_field_cmp(false) {};
   Arg_comparator(Item **a1, Item **a2): a(a1), b(a2), comparators(0), thd(0),
     a_cache(0), b_cache(0), set_null(TRUE),
-    get_value_a_func(0), get_value_b_func(0) {};
+    get_value_a_func(0), get_value_b_func(0), is_int_field_cmp(false) {};
 
   int set_compare_func(Item_result_field *owner, Item_result type);
   inline int set_compare_func(Item_result_field *owner_arg)
@@ -83,6 +96,28 @@ public:
   }
   inline int compare() { return (this->*func)(); }
 
+  /// @returns true if the arguments are compared as integers
+  bool compares_as_int() const
+  {
+    const arg_cmp_func cmp_func= is_int_field_cmp ? int_field_fallback : func;
+    return cmp_func == &Arg_comparator::compare_int_signed ||
+           cmp_func == &Arg_comparator::compare_int_signed_unsigned ||
+           cmp_func == &Arg_comparator::compare_int_unsigned_signed ||
+           cmp_func == &Arg_comparator::compare_int_unsigned;
+  }
+  /// @returns true if the arguments are compared as strings
+  bool compares_as_string() const
+  {
+    return func == &Arg_comparator::compare_string ||
+           func == &Arg_comparator::compare_binary_string;
+  }
+  /// @returns true if the arguments are compared as decimals
+  bool compares_as_decimal() const
+  {
+    return func == &Arg_comparator::compare_decimal;
+  }
+  bool compares_as_datetime() const;
+
   int compare_string();		 // compare args[0] & args[1]
   int compare_binary_string();	 // compare args[0] & args[1]
   int compare_real();            // compare args[0] & args[1]
@@ -104,6 +139,8 @@ public:
   int compare_real_fixed();
   int compare_e_real_fixed();
   int compare_datetime();        // compare args[0] & args[1] as DATETIMEs
+  template <typename T> int compare_int_field_const();
+  template <typename T> int compare_int_fields();
 
   static bool can_compare_as_dates(Item *a, Item *b, ulonglong *const_val_arg);
 
@@ -403,6 +440,7 @@ public:
   bool is_null() { return test(args[0]->is_null() || args[1]->is_null()); }
   const CHARSET_INFO *compare_collation()
   { return cmp.cmp_collation.collation; }
+  const Arg_comparator *get_comparator() const { return &cmp; }
   void top_level_item() { abort_on_null= TRUE; }
   void cleanup()
   {
@@ -423,6 +461,7 @@ public:
   Item *neg_transformer(THD *thd);
   virtual Item *negated_item();
   bool subst_argument_checker(uchar **arg) { return TRUE; }
+  bool add_to_cond_kernel(Cond_kernel *kernel);
 };
 
 /**
@@ -758,6 +797,7 @@ public:
   bool is_bool_func() { return 1; }
   const CHARSET_INFO *compare_collation() { return cmp_collation.collation; }
   uint decimal_precision() const { return 1; }
+  bool add_to_cond_kernel(Cond_kernel *kernel);
 };
 
 
@@ -904,8 +944,22 @@ public:
 
 /* A vector of values of some type  */
 
+/*
+  Vectors with at least this many values are also hashed by
+  in_vector::sort(), so that find() probes a hash table instead of doing a
+  binary search.
+*/
+#define IN_VECTOR_HASH_MIN_ELEMENTS 32
+
 class in_vector :public Sql_alloc
 {
+  /*
+    Open addressing hash table over the sorted values, or 0 if there is
+    none. A slot holds the value number + 1, or 0 if the slot is free.
+  */
+  uint *hash_table;
+  uint hash_mask;
+  void build_hash_table();
 public:
   char *base;
   uint size;
@@ -913,18 +967,28 @@ public:
   const CHARSET_INFO *collation;
   uint count;
   uint used_count;
-  in_vector() {}
+  in_vector() :hash_table(0), hash_mask(0) {}
   in_vector(uint elements,uint element_length,qsort2_cmp cmp_func, 
   	    const CHARSET_INFO *cmp_coll)
-    :base((char*) sql_calloc(elements*element_length)),
+    :hash_table(0), hash_mask(0),
+     base((char*) sql_calloc(elements*element_length)),
      size(element_length), compare(cmp_func), collation(cmp_coll),
      count(elements), used_count(elements) {}
   virtual ~in_vector() {}
   virtual void set(uint pos,Item *item)=0;
   virtual uchar *get_value(Item *item)=0;
+  /*
+    Hash a value of the vector, or the one returned by get_value(), so
+    that values for which compare() returns 0 get the same hash.
+
+    @return true if values of this vector cannot be hashed
+  */
+  virtual bool hash_value(const uchar *value, ulong *hash) { return true; }
   void sort()
   {
     my_qsort2(base,used_count,size,compare,collation);
+    if (used_count >= IN_VECTOR_HASH_MIN_ELEMENTS)
+      build_hash_table();
   }
   int find(Item *item);
   
@@ -976,6 +1040,7 @@ public:
     to->str_value= *str;
   }
   Item_result result_type() { return STRING_RESULT; }
+  bool hash_value(const uchar *value, ulong *hash);
 };
 
 class in_longlong :public in_vector
@@ -1011,6 +1076,7 @@ public:
       ((packed_longlong*) base)[pos].unsigned_flag;
   }
   Item_result result_type() { return INT_RESULT; }
+  bool hash_value(const uchar *value, ulong *hash);
 
   friend int cmp_longlong(void *cmp_arg, packed_longlong *a,packed_longlong *b);
 };
@@ -1088,6 +1154,7 @@ public:
     ((Item_float*)item)->value= ((double*) base)[pos];
   }
   Item_result result_type() { return REAL_RESULT; }
+  bool hash_value(const uchar *value, ulong *hash);
 };
 
 
@@ -1129,6 +1196,12 @@ public:
   virtual int compare(cmp_item *item)= 0;
   static cmp_item* get_comparator(Item_result type, const CHARSET_INFO *cs);
   virtual cmp_item *make_same()= 0;
+  /*
+    Add the stored value to the hash nr1/nr2 so that values for which
+    compare() returns 0 hash alike. Returns true if the values of this
+    comparator cannot be hashed.
+  */
+  virtual bool hash_value(ulong *nr1, ulong *nr2) { return true; }
   virtual void store_value_by_template(cmp_item *tmpl, Item *item)
   {
     store_value(item);
@@ -1143,6 +1216,7 @@ public:
   cmp_item_string () {}
   cmp_item_string (const CHARSET_INFO *cs) { cmp_charset= cs; }
   void set_charset(const CHARSET_INFO *cs) { cmp_charset= cs; }
+  bool hash_value(ulong *nr1, ulong *nr2);
   friend class cmp_item_sort_string;
   friend class cmp_item_sort_string_in_static;
 };
@@ -1208,6 +1282,7 @@ public:
     return (value < l_cmp->value) ? -1 : ((value == l_cmp->value) ? 0 : 1);
   }
   cmp_item *make_same();
+  bool hash_value(ulong *nr1, ulong *nr2);
 };
 
 /*
@@ -1232,6 +1307,7 @@ public:
   int cmp(Item *arg);
   int compare(cmp_item *ci);
   cmp_item *make_same();
+  bool hash_value(ulong *nr1, ulong *nr2);
 };
 
 class cmp_item_real :public cmp_item
@@ -1253,6 +1329,7 @@ public:
     return (value < l_cmp->value)? -1 : ((value == l_cmp->value) ? 0 : 1);
   }
   cmp_item *make_same();
+  bool hash_value(ulong *nr1, ulong *nr2);
 };
 
 
@@ -1450,6 +1527,7 @@ public:
   int compare(cmp_item *arg);
   cmp_item *make_same();
   void store_value_by_template(cmp_item *tmpl, Item *);
+  bool hash_value(ulong *nr1, ulong *nr2);
   friend void Item_func_in::fix_length_and_dec();
 };
 
@@ -1462,6 +1540,7 @@ public:
   ~in_row();
   void set(uint pos,Item *item);
   uchar *get_value(Item *item);
+  bool hash_value(const uchar *value, ulong *hash);
   friend void Item_func_in::fix_length_and_dec();
   Item_result result_type() { return ROW_RESULT; }
 };
@@ -1508,6 +1587,7 @@ public:
   table_map not_null_tables() const { return 0; }
   optimize_type select_optimize() const { return OPTIMIZE_NULL; }
   Item *neg_transformer(THD *thd);
+  bool add_to_cond_kernel(Cond_kernel *kernel);
   const CHARSET_INFO *compare_collation()
   { return args[0]->collation.collation; }
 };
@@ -1561,6 +1641,7 @@ public:
   const CHARSET_INFO *compare_collation()
   { return args[0]->collation.collation; }
   void top_level_item() { abort_on_null=1; }
+  bool add_to_cond_kernel(Cond_kernel *kernel);
 };
 
 
@@ -1581,6 +1662,28 @@ class Item_func_like :public Item_bool_func2
   bool bm_matches(const char* text, int text_len) const;
   enum { alphabet_size = 256 };
 
+  /*
+    A '%abc%def%' pattern, as the list of its segments. The segments are
+    searched one after the other in the text.
+  */
+  struct Like_segment
+  {
+    const char *str;            // The segment, without wildcards
+    uint length;
+    uint anchor;                // Offset of the byte that is searched for
+    bool anchor_search;         // false if the anchor has too many matches
+    uchar anchor_byte[2];       // The bytes that match the anchor
+  };
+  bool          can_do_segments;
+  Like_segment* segments;
+  uint          segment_count;
+
+  bool compile_segments(THD *thd, const char *first, size_t len);
+  bool segment_equal(const Like_segment *seg, const char *text) const;
+  const char *find_segment(const Like_segment *seg,
+                           const char *text, const char *end) const;
+  bool segments_match(const char *text, size_t text_len) const;
+
   Item *escape_item;
   
   bool escape_used_in_parsing;
@@ -1590,7 +1693,8 @@ public:
 
   Item_func_like(Item *a,Item *b, Item *escape_arg, bool escape_used)
     :Item_bool_func2(a,b), can_do_bm(false), pattern(0), pattern_len(0), 
-     bmGs(0), bmBc(0), escape_item(escape_arg),
+     bmGs(0), bmBc(0), can_do_segments(false), segments(0), segment_count(0),
+     escape_item(escape_arg),
      escape_used_in_parsing(escape_used) {}
   longlong val_int();
   enum Functype functype() const { return LIKE_FUNC; }
@@ -1688,6 +1792,7 @@ public:
   Item *transform(Item_transformer transformer, uchar *arg);
   void traverse_cond(Cond_traverser, void *arg, traverse_order order);
   void neg_arguments(THD *thd);
+  bool add_to_cond_kernel(Cond_kernel *kernel);
   enum_field_types field_type() const { return MYSQL_TYPE_LONGLONG; }
   bool subst_argument_checker(uchar **arg) { return TRUE; }
   Item *compile(Item_analyzer analyzer, uchar **arg_p,
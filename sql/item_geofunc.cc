@@ -611,6 +611,7 @@ Item_func_spatial_rel::Item_func_spatial_rel(Item *a,Item *b,
     Item_bool_func2(a,b), collector()
 {
   spatial_rel = sp_rel;
+  const_mbr_cached[0]= const_mbr_cached[1]= false;
 }
 
 
@@ -930,6 +931,99 @@ int Item_func_spatial_rel::func_equals()
 }
 
 
+/**
+  Get the MBR of an argument, only once for a constant argument.
+
+  @param      arg_no  Argument number
+  @param      g       The value of the argument
+  @param[out] mbr     The MBR
+
+  @return true if the MBR could not be calculated
+*/
+
+bool Item_func_spatial_rel::get_arg_mbr(uint arg_no, Geometry *g, MBR *mbr)
+{
+  Item *arg= args[arg_no];
+  /* The value of a user variable may change during the execution */
+  if (!arg->const_item() ||
+      (arg->type() == FUNC_ITEM &&
+       ((Item_func *) arg)->functype() == GUSERVAR_FUNC))
+    return g->get_mbr(mbr);
+  if (!const_mbr_cached[arg_no])
+  {
+    if (g->get_mbr(&const_mbr[arg_no]))
+      return true;
+    const_mbr_cached[arg_no]= true;
+  }
+  *mbr= const_mbr[arg_no];
+  return false;
+}
+
+
+/**
+  Decide the relation from the MBRs of the arguments, if they suffice.
+
+  Comparing two MBRs is much cheaper than the Gcalc_function evaluation,
+  and for a spatial filter on a column most rows are outside the MBR of
+  the constant region. func_equals() accepts points up to GIS_ZERO apart
+  as equal, so the MBRs must differ by more than that.
+
+  @param      g1      The first argument
+  @param      g2      The second argument
+  @param[out] result  The result of the function, if decided
+
+  @return true if *result was decided from the MBRs
+*/
+
+bool Item_func_spatial_rel::mbr_filter(Geometry *g1, Geometry *g2,
+                                       int *result)
+{
+  MBR mbr1, mbr2;
+  bool apart;
+
+  if (spatial_rel == SP_EQUALS_FUNC || spatial_rel == SP_OVERLAPS_FUNC ||
+      get_arg_mbr(0, g1, &mbr1) || get_arg_mbr(1, g2, &mbr2) ||
+      mbr1.dimension() < 0 || mbr2.dimension() < 0)
+    return false;
+
+  apart= mbr2.xmin - mbr1.xmax > GIS_ZERO || mbr1.xmin - mbr2.xmax > GIS_ZERO ||
+         mbr2.ymin - mbr1.ymax > GIS_ZERO || mbr1.ymin - mbr2.ymax > GIS_ZERO;
+
+  switch (spatial_rel) {
+    case SP_CONTAINS_FUNC:
+      swap_variables(MBR, mbr1, mbr2);
+      /* Fall through */
+    case SP_WITHIN_FUNC:
+      /* g1 is not within g2 if its MBR sticks out of that of g2 */
+      if (mbr2.xmin - mbr1.xmin > GIS_ZERO || mbr1.xmax - mbr2.xmax > GIS_ZERO ||
+          mbr2.ymin - mbr1.ymin > GIS_ZERO || mbr1.ymax - mbr2.ymax > GIS_ZERO)
+      {
+        *result= 0;
+        return true;
+      }
+      break;
+    case SP_DISJOINT_FUNC:
+      if (apart)
+      {
+        *result= 1;
+        return true;
+      }
+      break;
+    case SP_INTERSECTS_FUNC:
+    case SP_CROSSES_FUNC:
+      if (apart)
+      {
+        *result= 0;
+        return true;
+      }
+      break;
+    default:
+      break;
+  }
+  return false;
+}
+
+
 longlong Item_func_spatial_rel::val_int()
 {
   DBUG_ENTER("Item_func_spatial_rel::val_int");
@@ -984,8 +1078,13 @@ longlong Item_func_spatial_rel::val_int()
   if ((null_value=
        (args[0]->null_value || args[1]->null_value ||
 	!(g1= Geometry::construct(&buffer1, res1)) ||
-	!(g2= Geometry::construct(&buffer2, res2)) ||
-	g1->store_shapes(&trn) || g2->store_shapes(&trn))))
+	!(g2= Geometry::construct(&buffer2, res2)))))
+    goto exit;
+
+  if (mbr_filter(g1, g2, &result))
+    goto exit;
+
+  if ((null_value= (g1->store_shapes(&trn) || g2->store_shapes(&trn))))
     goto exit;
 
 #ifndef DBUG_OFF
@@ -241,10 +241,18 @@ class Item_func_spatial_rel: public Item_bool_func2
   Gcalc_scan_iterator scan_it;
   Gcalc_function func;
   String tmp_value1,tmp_value2;
+  /* MBRs of constant arguments, computed for the first row */
+  MBR const_mbr[2];
+  bool const_mbr_cached[2];
 public:
   Item_func_spatial_rel(Item *a,Item *b, enum Functype sp_rel);
   virtual ~Item_func_spatial_rel();
   longlong val_int();
+  void cleanup()
+  {
+    const_mbr_cached[0]= const_mbr_cached[1]= false;
+    Item_bool_func2::cleanup();
+  }
   enum Functype functype() const 
   { 
     return spatial_rel;
@@ -273,6 +281,8 @@ public:
 protected:
   int func_touches();
   int func_equals();
+  bool get_arg_mbr(uint arg_no, Geometry *g, MBR *mbr);
+  bool mbr_filter(Geometry *g1, Geometry *g2, int *result);
 };
 
 
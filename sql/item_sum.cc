@@ -888,8 +888,12 @@ bool Aggregator_distinct::setup(THD *thd)
         }
       }
       DBUG_ASSERT(tree == 0);
+      /*
+        The distinct keys are only counted, so binary keys can be kept in
+        a hash set instead of the tree.
+      */
       tree= new Unique(compare_key, cmp_arg, tree_key_length,
-                       item_sum->ram_limitation(thd));
+                       item_sum->ram_limitation(thd), all_binary);
       /*
         The only time tree_key_length could be 0 is if someone does
         count(distinct) on a char(0) field - stupid thing to do,
@@ -955,10 +959,11 @@ bool Aggregator_distinct::setup(THD *thd)
       Unique handles all unique elements in a tree until they can't fit
       in.  Then the tree is dumped to the temporary file. We can use
       simple_raw_key_cmp because the table contains numbers only; decimals
-      are converted to binary representation as well.
+      are converted to binary representation as well. The order in which
+      the values are aggregated does not matter, so a hash set is used.
     */
     tree= new Unique(simple_raw_key_cmp, &tree_key_length, tree_key_length,
-                     item_sum->ram_limitation(thd));
+                     item_sum->ram_limitation(thd), true);
 
     DBUG_RETURN(tree == 0);
   }
@@ -1306,7 +1311,8 @@ Field *Item_sum_hybrid::create_tmp_field(bool group, TABLE *table)
 */
 Item_sum_sum::Item_sum_sum(THD *thd, Item_sum_sum *item) 
   :Item_sum_num(thd, item), hybrid_type(item->hybrid_type),
-   curr_dec_buff(item->curr_dec_buff)
+   curr_dec_buff(item->curr_dec_buff), int_sum(item->int_sum),
+   int_sum_frac(item->int_sum_frac)
 {
   /* TODO: check if the following assignments are really needed */
   if (hybrid_type == DECIMAL_RESULT)
@@ -1332,6 +1338,8 @@ void Item_sum_sum::clear()
   {
     curr_dec_buff= 0;
     my_decimal_set_zero(dec_buffs);
+    int_sum= 0;
+    int_sum_frac= -1;
   }
   else
     sum= 0.0;
@@ -1360,6 +1368,8 @@ void Item_sum_sum::fix_length_and_dec()
     curr_dec_buff= 0;
     hybrid_type= DECIMAL_RESULT;
     my_decimal_set_zero(dec_buffs);
+    int_sum= 0;
+    int_sum_frac= -1;
     break;
   }
   case STRING_RESULT:
@@ -1378,18 +1388,83 @@ void Item_sum_sum::fix_length_and_dec()
 }
 
 
+/**
+  Add a DECIMAL value scaled by 10^decimals to int_sum.
+
+  @param value  The value, from decimal2scaled_longlong()
+  @param frac   Number of fractional digits of the original value
+*/
+
+void Item_sum_sum::add_int_sum(longlong value, int frac)
+{
+  if (value > 0 ? int_sum > LONGLONG_MAX - value :
+                  int_sum < LONGLONG_MIN - value)
+    flush_int_sum();
+  int_sum+= value;
+  set_if_bigger(int_sum_frac, frac);
+}
+
+
+/**
+  Move int_sum to dec_buffs.
+
+  The value keeps int_sum_frac fractional digits rather than decimals,
+  like the sum my_decimal_add() would have produced.
+*/
+
+void Item_sum_sum::flush_int_sum()
+{
+  if (int_sum_frac < 0)
+    return;
+  my_decimal value;
+  int2my_decimal(E_DEC_FATAL_ERROR, int_sum, FALSE, &value);
+  decimal_shift(&value, -(int) decimals);
+  my_decimal_round(E_DEC_FATAL_ERROR, &value, int_sum_frac, TRUE, &value);
+  my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff^1),
+                 &value, dec_buffs + curr_dec_buff);
+  curr_dec_buff^= 1;
+  int_sum= 0;
+  int_sum_frac= -1;
+}
+
+
 bool Item_sum_sum::add()
 {
   DBUG_ENTER("Item_sum_sum::add");
   if (hybrid_type == DECIMAL_RESULT)
   {
     my_decimal value;
-    const my_decimal *val= aggr->arg_val_decimal(&value);
+    const my_decimal *val;
+    longlong scaled;
+    Field *field;
+
+    /* Read small DECIMAL columns directly from the record */
+    if (aggr->Aggrtype() == Aggregator::SIMPLE_AGGREGATOR &&
+        args[0]->type() == FIELD_ITEM &&
+        (field= ((Item_field *) args[0])->field)->type() ==
+          MYSQL_TYPE_NEWDECIMAL &&
+        field->decimals() == decimals &&
+        !((Field_new_decimal *) field)->val_scaled_int(&scaled))
+    {
+      if (!(args[0]->null_value= field->is_null()))
+      {
+        add_int_sum(scaled, decimals);
+        null_value= 0;
+      }
+      DBUG_RETURN(0);
+    }
+
+    val= aggr->arg_val_decimal(&value);
     if (!aggr->arg_is_null())
     {
-      my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff^1),
-                     val, dec_buffs + curr_dec_buff);
-      curr_dec_buff^= 1;
+      if (!decimal2scaled_longlong(val, &scaled, decimals))
+        add_int_sum(scaled, val->frac);
+      else
+      {
+        my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff^1),
+                       val, dec_buffs + curr_dec_buff);
+        curr_dec_buff^= 1;
+      }
       null_value= 0;
     }
   }
@@ -1411,6 +1486,7 @@ longlong Item_sum_sum::val_int()
   if (hybrid_type == DECIMAL_RESULT)
   {
     longlong result;
+    flush_int_sum();
     my_decimal2int(E_DEC_FATAL_ERROR, dec_buffs + curr_dec_buff, unsigned_flag,
                    &result);
     return result;
@@ -1425,7 +1501,10 @@ double Item_sum_sum::val_real()
   if (aggr)
     aggr->endup();
   if (hybrid_type == DECIMAL_RESULT)
+  {
+    flush_int_sum();
     my_decimal2double(E_DEC_FATAL_ERROR, dec_buffs + curr_dec_buff, &sum);
+  }
   return sum;
 }
 
@@ -1445,7 +1524,10 @@ my_decimal *Item_sum_sum::val_decimal(my_decimal *val)
   if (aggr)
     aggr->endup();
   if (hybrid_type == DECIMAL_RESULT)
+  {
+    flush_int_sum();
     return (dec_buffs + curr_dec_buff);
+  }
   return val_decimal_from_real(val);
 }
 
@@ -1676,6 +1758,7 @@ my_decimal *Item_sum_avg::val_decimal(my_decimal *val)
   if (hybrid_type != DECIMAL_RESULT)
     return val_decimal_from_real(val);
 
+  flush_int_sum();
   sum_dec= dec_buffs + curr_dec_buff;
   int2my_decimal(E_DEC_FATAL_ERROR, count, 0, &cnt);
   my_decimal_div(E_DEC_FATAL_ERROR, val, sum_dec, &cnt, prec_increment);
@@ -2973,6 +3056,10 @@ int group_concat_key_cmp_with_distinct(const void* arg, const void* key1,
 
 /**
   function of sort for syntax: GROUP_CONCAT(expr,... ORDER BY col,... )
+
+  The keys are those of Item_func_group_concat::sort_keys: rows which
+  sort equal are ordered by their sequence number, so that they keep
+  the order in which they were added.
 */
 
 extern "C"
@@ -3009,12 +3096,10 @@ int group_concat_key_cmp_with_order(const void* arg, const void* key1,
     if (res)
       return ((*order_item)->direction == ORDER::ORDER_ASC) ? res : -res;
   }
-  /*
-    We can't return 0 because in that case the tree class would remove this
-    item as double value. This would cause problems for case-changes and
-    if the returned values are not the same we do the sort on.
-  */
-  return 1;
+  ulong seq1, seq2;
+  memcpy(&seq1, (uchar*)key1 + grp_item->key_length, sizeof(seq1));
+  memcpy(&seq2, (uchar*)key2 + grp_item->key_length, sizeof(seq2));
+  return seq1 < seq2 ? -1 : 1;
 }
 
 
@@ -3122,7 +3207,9 @@ Item_func_group_concat(Name_resolution_context *context_arg,
                        bool distinct_arg, List<Item> *select_list,
                        const SQL_I_List<ORDER> &order_list,
                        String *separator_arg)
-  :tmp_table_param(0), separator(separator_arg), tree(0),
+  :tmp_table_param(0), separator(separator_arg),
+   sort_keys(NULL), sort_key_count(0), sort_key_capacity(0),
+   sort_key_seq(0), sort_key_limit(0), key_length(0),
    unique_filter(NULL), table(0),
    order(0), context(context_arg),
    arg_count_order(order_list.elements),
@@ -3183,7 +3270,10 @@ Item_func_group_concat::Item_func_group_concat(THD *thd,
   :Item_sum(thd, item),
   tmp_table_param(item->tmp_table_param),
   separator(item->separator),
-  tree(item->tree),
+  sort_keys(NULL), sort_key_count(0), sort_key_capacity(0),
+  sort_key_seq(0),
+  sort_key_limit(item->sort_key_limit),
+  key_length(item->key_length),
   unique_filter(item->unique_filter),
   table(item->table),
   context(item->context),
@@ -3232,9 +3322,15 @@ void Item_func_group_concat::cleanup()
   DBUG_ENTER("Item_func_group_concat::cleanup");
   Item_sum::cleanup();
 
+  /* The sort keys always belong to this item. */
+  my_free(sort_keys);
+  sort_keys= NULL;
+  sort_key_count= sort_key_capacity= 0;
+
   /*
-    Free table and tree if they belong to this item (if item have not pointer
-    to original item from which was made copy => it own its objects )
+    Free table and unique filter if they belong to this item (if item have
+    not pointer to original item from which was made copy => it own its
+    objects )
   */
   if (!original)
   {
@@ -3247,18 +3343,12 @@ void Item_func_group_concat::cleanup()
         delete table->blob_storage;
       free_tmp_table(thd, table);
       table= 0;
-      if (tree)
-      {
-        delete_tree(tree);
-        tree= 0;
-      }
       if (unique_filter)
       {
         delete unique_filter;
         unique_filter= NULL;
       }
     }
-    DBUG_ASSERT(tree == 0);
   }
   DBUG_VOID_RETURN;
 }
@@ -3302,8 +3392,8 @@ void Item_func_group_concat::clear()
   null_value= TRUE;
   warning_for_row= FALSE;
   no_appended= TRUE;
-  if (tree)
-    reset_tree(tree);
+  sort_key_count= 0;
+  sort_key_seq= 0;
   if (unique_filter)
     unique_filter->reset();
   if (table && table->blob_storage)
@@ -3343,32 +3433,76 @@ bool Item_func_group_concat::add()
       row_eligible= FALSE;
   }
 
-  TREE_ELEMENT *el= 0;                          // Only for safety
-  if (row_eligible && tree)
+  if (row_eligible && arg_count_order)
   {
     DBUG_EXECUTE_IF("trigger_OOM_in_gconcat_add",
                      DBUG_SET("+d,simulate_persistent_out_of_memory"););
-    el= tree_insert(tree, table->record[0] + table->s->null_bytes, 0,
-                    tree->custom_arg);
+    bool error= add_sort_key(table->record[0] + table->s->null_bytes);
     DBUG_EXECUTE_IF("trigger_OOM_in_gconcat_add",
                     DBUG_SET("-d,simulate_persistent_out_of_memory"););
     /* check if there was enough memory to insert the row */
-    if (!el)
+    if (error)
       return 1;
   }
   /*
-    If the row is not a duplicate (el->count == 1)
-    we can dump the row here in case of GROUP_CONCAT(DISTINCT...)
-    instead of doing tree traverse later.
+    Without ORDER BY, the row is appended here: there is nothing to
+    sort, and duplicates have already been filtered out.
   */
-  if (row_eligible && !warning_for_row &&
-      (!tree || (el->count == 1 && distinct && !arg_count_order)))
+  if (row_eligible && !warning_for_row && !arg_count_order)
     dump_leaf_key(table->record[0] + table->s->null_bytes, 1, this);
 
   return 0;
 }
 
 
+/**
+  Append a key to sort_keys.
+
+  When the buffer holds twice as many keys as val_str() can append,
+  it is sorted and only the smallest keys are kept, instead of
+  growing the buffer: the others would be cut from the result anyway.
+
+  @return true if out of memory
+*/
+
+bool Item_func_group_concat::add_sort_key(const uchar *key)
+{
+  if (sort_key_count == sort_key_capacity)
+  {
+    if (sort_key_limit && sort_key_count >= 2 * sort_key_limit)
+    {
+      sort_sort_keys();
+      sort_key_count= sort_key_limit;
+    }
+    else
+    {
+      ulong capacity= sort_key_capacity ? sort_key_capacity * 2 : 64;
+      if (sort_key_limit)
+        set_if_smaller(capacity, 2 * sort_key_limit);
+      uchar *keys= (uchar*) my_realloc(key_memory_Item_func_group_concat_sort_keys,
+                                       sort_keys, capacity * sort_key_size(),
+                                       MYF(MY_ALLOW_ZERO_PTR | MY_WME));
+      if (!keys)
+        return true;
+      sort_keys= keys;
+      sort_key_capacity= capacity;
+    }
+  }
+  uchar *pos= sort_keys + sort_key_count++ * sort_key_size();
+  memcpy(pos, key, key_length);
+  memcpy(pos + key_length, &sort_key_seq, sizeof(sort_key_seq));
+  sort_key_seq++;
+  return false;
+}
+
+
+void Item_func_group_concat::sort_sort_keys()
+{
+  my_qsort2(sort_keys, sort_key_count, sort_key_size(),
+            group_concat_key_cmp_with_order, this);
+}
+
+
 bool
 Item_func_group_concat::fix_fields(THD *thd, Item **ref)
 {
@@ -3442,7 +3576,7 @@ bool Item_func_group_concat::setup(THD *thd)
     Currently setup() can be called twice. Please add
     assertion here when this is fixed.
   */
-  if (table || tree)
+  if (table)
     DBUG_RETURN(FALSE);
 
   if (!(tmp_table_param= new TMP_TABLE_PARAM))
@@ -3522,32 +3656,59 @@ bool Item_func_group_concat::setup(THD *thd)
     table->blob_storage= new Blob_mem_storage();
 
   /*
-     Need sorting or uniqueness: init tree and choose a function to sort.
-     Don't reserve space for NULLs: if any of gconcat arguments is NULL,
-     the row is not added to the result.
+     Need sorting or uniqueness: the keys are the records without the
+     null bytes. Don't reserve space for NULLs: if any of gconcat
+     arguments is NULL, the row is not added to the result.
   */
-  uint tree_key_length= table->s->reclength - table->s->null_bytes;
+  key_length= table->s->reclength - table->s->null_bytes;
 
-  if (arg_count_order)
+  /*
+    With ORDER BY, the rows are sorted by val_str(). Each row appends
+    at least the separator to the result, so no more than
+    max_length / separator length + 2 rows fit in it.
+  */
+  sort_key_limit= 0;
+  if (arg_count_order && separator->length())
+    sort_key_limit= max_length / separator->length() + 2;
+
+  if (distinct)
   {
-    tree= &tree_base;
     /*
-      Create a tree for sorting. The tree is used to sort (according to the
-      syntax of this function). If there is no ORDER BY clause, we don't
-      create this tree.
+      Without ORDER BY the key is made of the selected fields only.
+      If they all compare as bytes, duplicates can be found in a hash
+      set instead of a tree: the order of the keys in the Unique does
+      not matter, as rows are appended to the result by add().
     */
-    init_tree(tree,  min<uint>(thd->variables.max_heap_table_size,
-                               thd->variables.sortbuff_size/16), 0,
-              tree_key_length, 
-              group_concat_key_cmp_with_order , 0, NULL, (void*) this);
-  }
-
-  if (distinct)
+    bool use_hash= !arg_count_order;
+    uint fields_length= 0;
+    for (Field **field= table->field; use_hash && *field; field++)
+    {
+      fields_length+= (*field)->pack_length();
+      switch ((*field)->real_type()) {
+      case MYSQL_TYPE_TINY:
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_INT24:
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_LONGLONG:
+      case MYSQL_TYPE_YEAR:
+      case MYSQL_TYPE_NEWDECIMAL:
+      case MYSQL_TYPE_DATE:
+      case MYSQL_TYPE_NEWDATE:
+      case MYSQL_TYPE_TIME2:
+      case MYSQL_TYPE_DATETIME2:
+      case MYSQL_TYPE_TIMESTAMP2:
+        break;
+      default:
+        use_hash= false;
+      }
+    }
+    use_hash= use_hash && fields_length == key_length;
     unique_filter= new Unique(group_concat_key_cmp_with_distinct,
                               (void*)this,
-                              tree_key_length,
-                              ram_limitation(thd));
-  
+                              key_length,
+                              ram_limitation(thd), use_hash);
+  }
+
   DBUG_RETURN(FALSE);
 }
 
@@ -3560,7 +3721,6 @@ void Item_func_group_concat::make_unique()
   table=0;
   original= 0;
   force_copy_fields= 1;
-  tree= 0;
 }
 
 
@@ -3569,9 +3729,14 @@ String* Item_func_group_concat::val_str(String* str)
   DBUG_ASSERT(fixed == 1);
   if (null_value)
     return 0;
-  if (no_appended && tree)
-    /* Tree is used for sorting as in ORDER BY */
-    tree_walk(tree, &dump_leaf_key, this, left_root_right);
+  if (no_appended && sort_key_count)
+  {
+    /* Sort the rows as in ORDER BY, and stop once the result is cut */
+    sort_sort_keys();
+    for (ulong i= 0; i < sort_key_count; i++)
+      if (dump_leaf_key(sort_keys + i * sort_key_size(), 1, this))
+        break;
+  }
 
   if (table && table->blob_storage && 
       table->blob_storage->is_truncated_value())
@@ -3636,6 +3801,7 @@ void Item_func_group_concat::print(String *str, enum_query_type query_type)
 
 Item_func_group_concat::~Item_func_group_concat()
 {
+  my_free(sort_keys);
   if (!original && unique_filter)
     delete unique_filter;    
 }
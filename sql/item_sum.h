@@ -715,6 +715,17 @@ protected:
   double sum;
   my_decimal dec_buffs[2];
   uint curr_dec_buff;
+  /*
+    DECIMAL values with at most 18 digits are added up as integers scaled
+    by 10^decimals, and moved to dec_buffs by flush_int_sum() when int_sum
+    would overflow or the result is needed. int_sum_frac is the biggest
+    number of fractional digits in the values in int_sum, or -1 if there
+    are none.
+  */
+  longlong int_sum;
+  int int_sum_frac;
+  void add_int_sum(longlong value, int frac);
+  void flush_int_sum();
   void fix_length_and_dec();
 
 public:
@@ -1418,8 +1429,26 @@ class Item_func_group_concat : public Item_sum
   TMP_TABLE_PARAM *tmp_table_param;
   String result;
   String *separator;
-  TREE tree_base;
-  TREE *tree;
+
+  /**
+    With ORDER BY, the keys of the rows of the group, one after the
+    other, each followed by its sequence number in the group so that
+    rows which sort equal keep their order. They are sorted only once,
+    by val_str().
+    @see Item_func_group_concat::add_sort_key
+  */
+  uchar *sort_keys;
+  ulong sort_key_count;                 ///< Number of keys in sort_keys
+  ulong sort_key_capacity;              ///< Room of sort_keys, in keys
+  ulong sort_key_seq;                   ///< Next sequence number
+  /**
+    Most keys val_str() can append before the result is longer than
+    max_length, 0 if there is no such limit (empty separator).
+    Only as many of the smallest keys are kept.
+  */
+  ulong sort_key_limit;
+  /** Length of the keys, without the sequence number. */
+  uint key_length;
 
   /**
      If DISTINCT is used with this GROUP_CONCAT, this member is used to filter
@@ -1458,6 +1487,10 @@ class Item_func_group_concat : public Item_sum
                            element_count count __attribute__((unused)),
 			   void* item_arg);
 
+  size_t sort_key_size() const { return key_length + sizeof(ulong); }
+  bool add_sort_key(const uchar *key);
+  void sort_sort_keys();
+
 public:
   Item_func_group_concat(Name_resolution_context *context_arg,
                          bool is_distinct, List<Item> *is_select,
@@ -198,6 +198,8 @@ protected:
 /** In case of an error, a message is printed to the error log. */
 static Query_log_table_intact log_table_intact;
 
+ulong slow_log_entries_dropped= 0, general_log_entries_dropped= 0;
+
 
 /**
   Silence all errors and warnings reported when performing a write
@@ -374,6 +376,7 @@ bool File_query_log::open()
   }
 
   log_open= true;
+  start_writer();
   DBUG_RETURN(false);
 
 err:
@@ -412,6 +415,7 @@ void File_query_log::close()
   if (!is_open())
     DBUG_VOID_RETURN;
 
+  stop_writer();
   end_io_cache(&log_file);
 
   if (mysql_file_sync(log_file.file, MYF(MY_WME)))
@@ -439,6 +443,193 @@ void File_query_log::check_and_print_write_error()
 }
 
 
+bool File_query_log::write_to_file(const char *head, size_t head_len,
+                                   const char *entry_db,
+                                   const char *tail, size_t tail_len)
+{
+  mysql_mutex_assert_owner(&LOCK_log);
+
+  if (my_b_write(&log_file, (uchar*) head, head_len))
+    goto err;
+  if (entry_db && strcmp(entry_db, db))
+  {						// Database changed
+    if (my_b_printf(&log_file, "use %s;\n", entry_db) == (uint) -1)
+      goto err;
+    strmov(db, entry_db);
+  }
+  if (my_b_write(&log_file, (uchar*) tail, tail_len) ||
+      flush_io_cache(&log_file))
+    goto err;
+  return false;
+
+err:
+  check_and_print_write_error();
+  return true;
+}
+
+
+bool File_query_log::write_entry(const char *head, size_t head_len,
+                                 const char *entry_db,
+                                 const char *tail, size_t tail_len)
+{
+  bool error= false;
+
+  if (m_buffer == NULL)
+  {
+    mysql_mutex_lock(&LOCK_log);
+    DBUG_ASSERT(is_open());
+    error= write_to_file(head, head_len, entry_db, tail, tail_len);
+    mysql_mutex_unlock(&LOCK_log);
+    return error;
+  }
+
+  mysql_mutex_lock(&LOCK_buffer);
+  for (;;)
+  {
+    bool db_changed= entry_db && strcmp(entry_db, db);
+    size_t length= head_len + tail_len +
+                   (db_changed ? strlen(entry_db) + 6 : 0);   // "use x;\n"
+
+    if (length > m_buffer_size)
+    {
+      /*
+        The entry never fits in the buffer. Write it once the writer thread
+        has taken the entries before it, keeping LOCK_buffer so that no
+        entry is appended meanwhile. LOCK_log is held by the writer while
+        it writes these entries.
+      */
+      while (m_buffer_used != 0)
+        mysql_cond_wait(&COND_buffer_space, &LOCK_buffer);
+      mysql_mutex_lock(&LOCK_log);
+      error= write_to_file(head, head_len, entry_db, tail, tail_len);
+      mysql_mutex_unlock(&LOCK_log);
+      break;
+    }
+
+    if (m_buffer_used + length <= m_buffer_size)
+    {
+      char *pos= m_buffer + m_buffer_used;
+
+      memcpy(pos, head, head_len);
+      pos+= head_len;
+      if (db_changed)
+      {
+        pos= strxmov(pos, "use ", entry_db, ";\n", NullS);
+        strmov(db, entry_db);
+      }
+      memcpy(pos, tail, tail_len);
+      if (m_buffer_used == 0)
+        mysql_cond_signal(&COND_buffer_data);
+      m_buffer_used+= length;
+      break;
+    }
+
+    if (opt_query_log_buffer_full == QUERY_LOG_BUFFER_DROP)
+    {
+      if (m_log_type == QUERY_LOG_SLOW)
+        slow_log_entries_dropped++;
+      else
+        general_log_entries_dropped++;
+      break;
+    }
+    mysql_cond_wait(&COND_buffer_space, &LOCK_buffer);
+  }
+  mysql_mutex_unlock(&LOCK_buffer);
+  return error;
+}
+
+
+pthread_handler_t query_log_writer(void *arg)
+{
+  File_query_log *log= static_cast<File_query_log*>(arg);
+
+  my_thread_init();
+  log->run_writer();
+  my_thread_end();
+  return NULL;
+}
+
+
+void File_query_log::run_writer()
+{
+  mysql_mutex_lock(&LOCK_buffer);
+  for (;;)
+  {
+    while (m_buffer_used == 0 && !m_writer_stop)
+      mysql_cond_wait(&COND_buffer_data, &LOCK_buffer);
+    if (m_buffer_used == 0)
+      break;
+
+    /*
+      Take the entries, and let the sessions append to the other buffer
+      while they are written.
+    */
+    char *entries= m_buffer;
+    size_t length= m_buffer_used;
+    m_buffer= m_spare_buffer;
+    m_spare_buffer= entries;
+    m_buffer_used= 0;
+    mysql_cond_broadcast(&COND_buffer_space);
+
+    mysql_mutex_lock(&LOCK_log);
+    mysql_mutex_unlock(&LOCK_buffer);
+    if (my_b_write(&log_file, (uchar*) entries, length) ||
+        flush_io_cache(&log_file))
+      check_and_print_write_error();
+    mysql_mutex_unlock(&LOCK_log);
+    mysql_mutex_lock(&LOCK_buffer);
+  }
+  mysql_mutex_unlock(&LOCK_buffer);
+}
+
+
+void File_query_log::start_writer()
+{
+  DBUG_ENTER("File_query_log::start_writer");
+
+  if (opt_query_log_buffer_size == 0)
+    DBUG_VOID_RETURN;
+
+  m_buffer_size= opt_query_log_buffer_size;
+  m_buffer_used= 0;
+  m_writer_stop= false;
+  if (!(m_buffer= (char*) my_malloc(key_memory_File_query_log_buffer,
+                                    m_buffer_size, MYF(MY_WME))) ||
+      !(m_spare_buffer= (char*) my_malloc(key_memory_File_query_log_buffer,
+                                          m_buffer_size, MYF(MY_WME))) ||
+      mysql_thread_create(key_thread_query_log_writer, &m_writer_thread,
+                          NULL, query_log_writer, (void*) this))
+  {
+    sql_print_warning("Could not start the writer thread of %s, "
+                      "writing it synchronously", name);
+    my_free(m_buffer);
+    my_free(m_spare_buffer);
+    m_buffer= m_spare_buffer= NULL;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void File_query_log::stop_writer()
+{
+  DBUG_ENTER("File_query_log::stop_writer");
+
+  if (m_buffer == NULL)
+    DBUG_VOID_RETURN;
+
+  mysql_mutex_lock(&LOCK_buffer);
+  m_writer_stop= true;
+  mysql_cond_signal(&COND_buffer_data);
+  mysql_mutex_unlock(&LOCK_buffer);
+  pthread_join(m_writer_thread, NULL);
+
+  my_free(m_buffer);
+  my_free(m_spare_buffer);
+  m_buffer= m_spare_buffer= NULL;
+  DBUG_VOID_RETURN;
+}
+
+
 bool File_query_log::write_general(ulonglong event_utime,
                                    const char *user_host,
                                    size_t user_host_len,
@@ -450,43 +641,24 @@ bool File_query_log::write_general(ulonglong event_utime,
 {
   char buff[32];
   uint length= 0;
+  StringBuffer<1024> entry;
 
-  mysql_mutex_lock(&LOCK_log);
-  DBUG_ASSERT(is_open());
-
-  /* Note that my_b_write() assumes it knows the length for this */
   char local_time_buff[iso8601_size];
   int  time_buff_len= make_iso8601_timestamp(local_time_buff, event_utime);
 
-  if (my_b_write(&log_file, (uchar*) local_time_buff, time_buff_len))
-    goto err;
-
   length= my_snprintf(buff, 32, "%5lu ", thread_id);
 
-  if (my_b_write(&log_file, (uchar*) buff, length))
-    goto err;
-
-  if (my_b_write(&log_file, (uchar*) command_type, command_type_len))
-    goto err;
-
-  if (my_b_write(&log_file, (uchar*) "\t", 1))
-    goto err;
-
-  /* sql_text */
-  if (my_b_write(&log_file, (uchar*) sql_text, sql_text_len))
-    goto err;
-
-  if (my_b_write(&log_file, (uchar*) "\n", 1) ||
-      flush_io_cache(&log_file))
-    goto err;
-
-  mysql_mutex_unlock(&LOCK_log);
-  return false;
+  if (entry.reserve(time_buff_len + length + command_type_len +
+                    sql_text_len + 2) ||
+      entry.append(local_time_buff, time_buff_len) ||
+      entry.append(buff, length) ||
+      entry.append(command_type, command_type_len) ||
+      entry.append('\t') ||
+      entry.append(sql_text, sql_text_len) ||     /* sql_text */
+      entry.append('\n'))
+    return true;
 
-err:
-  check_and_print_write_error();
-  mysql_mutex_unlock(&LOCK_log);
-  return true;
+  return write_entry(entry.ptr(), entry.length(), NULL, "", 0);
 }
 
 
@@ -500,11 +672,10 @@ bool File_query_log::write_slow(THD *thd, ulonglong current_utime,
   char buff[80], *end;
   char query_time_buff[22+7], lock_time_buff[22+7];
   uint buff_len;
+  StringBuffer<512> head;
+  StringBuffer<1024> tail;
   end= buff;
 
-  mysql_mutex_lock(&LOCK_log);
-  DBUG_ASSERT(is_open());
-
   if (!(specialflag & SPECIAL_SHORT_LOG_FORMAT))
   {
     char my_timestamp[iso8601_size];
@@ -513,33 +684,35 @@ bool File_query_log::write_slow(THD *thd, ulonglong current_utime,
 
     buff_len= my_snprintf(buff, sizeof buff,
                           "# Time: %s\n", my_timestamp);
-
-    /* Note that my_b_write() assumes it knows the length for this */
-    if (my_b_write(&log_file, (uchar*) buff, buff_len))
-      goto err;
+    if (head.append(buff, buff_len))
+      return true;
 
     buff_len= my_snprintf(buff, 32, "%5lu", thd->thread_id);
-    if (my_b_printf(&log_file, "# User@Host: %s  Id: %s\n", user_host, buff)
-        == (uint) -1)
-      goto err;
+    if (head.append(STRING_WITH_LEN("# User@Host: ")) ||
+        head.append(user_host, user_host_len) ||
+        head.append(STRING_WITH_LEN("  Id: ")) ||
+        head.append(buff, buff_len) ||
+        head.append('\n'))
+      return true;
   }
 
   /* For slow query log */
   sprintf(query_time_buff, "%.6f", ulonglong2double(query_utime)/1000000.0);
   sprintf(lock_time_buff,  "%.6f", ulonglong2double(lock_utime)/1000000.0);
-  if (my_b_printf(&log_file,
-                  "# Query_time: %s  Lock_time: %s"
-                  " Rows_sent: %lu  Rows_examined: %lu\n",
-                  query_time_buff, lock_time_buff,
-                  (ulong) thd->get_sent_row_count(),
-                  (ulong) thd->get_examined_row_count()) == (uint) -1)
-    goto err;
-  if (thd->db && strcmp(thd->db, db))
-  {						// Database changed
-    if (my_b_printf(&log_file,"use %s;\n",thd->db) == (uint) -1)
-      goto err;
-    strmov(db,thd->db);
-  }
+  buff_len= my_snprintf(buff, sizeof buff, "%lu  Rows_examined: %lu\n",
+                        (ulong) thd->get_sent_row_count(),
+                        (ulong) thd->get_examined_row_count());
+  if (head.append(STRING_WITH_LEN("# Query_time: ")) ||
+      head.append(query_time_buff, strlen(query_time_buff)) ||
+      head.append(STRING_WITH_LEN("  Lock_time: ")) ||
+      head.append(lock_time_buff, strlen(lock_time_buff)) ||
+      head.append(STRING_WITH_LEN(" Rows_sent: ")) ||
+      head.append(buff, buff_len))
+    return true;
+
+  /* The "use db;" line, if the database changed, goes here */
+
+  end= buff;
   if (thd->stmt_depends_on_first_successful_insert_id_in_prev_stmt)
   {
     end=strmov(end, ",last_insert_id=");
@@ -571,31 +744,23 @@ bool File_query_log::write_slow(THD *thd, ulonglong current_utime,
   {
     *end++=';';
     *end='\n';
-    if (my_b_write(&log_file, (uchar*) "SET ", 4) ||
-        my_b_write(&log_file, (uchar*) buff + 1, (uint) (end-buff)))
-      goto err;
+    if (tail.append(STRING_WITH_LEN("SET ")) ||
+        tail.append(buff + 1, (uint) (end-buff)))
+      return true;
   }
   if (is_command)
   {
-    end= strxmov(buff, "# administrator command: ", NullS);
-    buff_len= (ulong) (end - buff);
     DBUG_EXECUTE_IF("simulate_slow_log_write_error",
                     {DBUG_SET("+d,simulate_file_write_error");});
-    if (my_b_write(&log_file, (uchar*) buff, buff_len))
-      goto err;
+    if (tail.append(STRING_WITH_LEN("# administrator command: ")))
+      return true;
   }
-  if (my_b_write(&log_file, (uchar*) sql_text, sql_text_len) ||
-      my_b_write(&log_file, (uchar*) ";\n",2) ||
-      flush_io_cache(&log_file))
-    goto err;
-
-  mysql_mutex_unlock(&LOCK_log);
-  return false;
+  if (tail.append(sql_text, sql_text_len) ||
+      tail.append(STRING_WITH_LEN(";\n")))
+    return true;
 
-err:
-  check_and_print_write_error();
-  mysql_mutex_unlock(&LOCK_log);
-  return true;
+  return write_entry(head.ptr(), head.length(), thd->db,
+                     tail.ptr(), tail.length());
 }
 
 
@@ -310,13 +310,28 @@ enum enum_log_table_type
   QUERY_LOG_GENERAL = 2
 };
 
+/** What a session does when the buffer of a query log file is full */
+enum enum_query_log_buffer_full
+{
+  QUERY_LOG_BUFFER_BLOCK= 0,
+  QUERY_LOG_BUFFER_DROP= 1
+};
+
+/** Number of entries not written to the slow and general log files */
+extern ulong slow_log_entries_dropped, general_log_entries_dropped;
+
 class File_query_log
 {
   File_query_log(enum_log_table_type log_type)
-  : m_log_type(log_type), name(NULL), write_error(false), log_open(false)
+  : m_log_type(log_type), name(NULL), write_error(false), log_open(false),
+    m_buffer(NULL), m_spare_buffer(NULL), m_buffer_size(0), m_buffer_used(0),
+    m_writer_stop(false)
   {
     memset(&log_file, 0, sizeof(log_file));
     mysql_mutex_init(key_LOG_LOCK_log, &LOCK_log, MY_MUTEX_INIT_SLOW);
+    mysql_mutex_init(key_LOG_LOCK_buffer, &LOCK_buffer, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_LOG_COND_buffer_data, &COND_buffer_data, NULL);
+    mysql_cond_init(key_LOG_COND_buffer_space, &COND_buffer_space, NULL);
 #ifdef HAVE_PSI_INTERFACE
     if (log_type == QUERY_LOG_GENERAL)
       m_log_file_key= key_file_general_log;
@@ -329,6 +344,9 @@ class File_query_log
   {
     DBUG_ASSERT(!is_open());
     mysql_mutex_destroy(&LOCK_log);
+    mysql_mutex_destroy(&LOCK_buffer);
+    mysql_cond_destroy(&COND_buffer_data);
+    mysql_cond_destroy(&COND_buffer_space);
   }
 
   /** @return true if the file log is open, false otherwise. */
@@ -402,13 +420,64 @@ class File_query_log
                   ulonglong query_utime, ulonglong lock_utime, bool is_command,
                   const char *sql_text, size_t sql_text_len);
 
+public:
+  /**
+     Write the entries of the buffer to the file until the log is closed.
+     Run by the writer thread of the log.
+  */
+  void run_writer();
+
 private:
+  /**
+     Write a formatted entry to the file, or append it to the buffer
+     of the writer thread if the log has one.
+
+     @param head       The entry, or the part before the "use db;" line
+                       of a slow log entry
+     @param head_len   The length of head
+     @param entry_db   The current database of a slow log entry, written
+                       as "use db;" between head and tail if it is not the
+                       last one written, or NULL
+     @param tail       The rest of the entry
+     @param tail_len   The length of tail
+
+     @return true if error, false otherwise. An entry that is dropped
+     because the buffer is full is not an error.
+  */
+  bool write_entry(const char *head, size_t head_len, const char *entry_db,
+                   const char *tail, size_t tail_len);
+
+  /**
+     Write an entry to the file. LOCK_log must be owned by the caller.
+     @see write_entry()
+  */
+  bool write_to_file(const char *head, size_t head_len, const char *entry_db,
+                     const char *tail, size_t tail_len);
+
+  /** Start the writer thread if query_log_buffer_size is not 0. */
+  void start_writer();
+
+  /** Write the entries that are left in the buffer, and stop the writer. */
+  void stop_writer();
+
   /** Type of log file. */
   const enum_log_table_type m_log_type;
 
   /** Makes sure we only have one write at a time. */
   mysql_mutex_t LOCK_log;
 
+  /**
+     Protects the buffer, and the last seen database when the log has
+     a writer thread. Acquired before LOCK_log.
+  */
+  mysql_mutex_t LOCK_buffer;
+
+  /** Signaled when entries are appended to the empty buffer. */
+  mysql_cond_t COND_buffer_data;
+
+  /** Signaled when the writer thread has taken the entries of the buffer. */
+  mysql_cond_t COND_buffer_space;
+
   /** Log filename. */
   char *name;
 
@@ -426,6 +495,26 @@ private:
   /** True if the file log is open, false otherwise. */
   volatile bool log_open;
 
+  /**
+     Entries that sessions have formatted and appended for the writer
+     thread, or NULL if the log is written by the sessions themselves.
+  */
+  char *m_buffer;
+
+  /** The buffer whose entries the writer thread is writing. */
+  char *m_spare_buffer;
+
+  /** Size of each of the buffers. */
+  size_t m_buffer_size;
+
+  /** Length of the entries in m_buffer. */
+  size_t m_buffer_used;
+
+  /** Tells the writer thread to stop once the buffer is empty. */
+  bool m_writer_stop;
+
+  pthread_t m_writer_thread;
+
 #ifdef HAVE_PSI_INTERFACE
   /** Instrumentation key to use for file io in @c log_file */
   PSI_file_key m_log_file_key;
@@ -3368,7 +3368,7 @@ int Log_event::apply_event(Relay_log_info *rli)
           DBUG_ASSERT(!(*(Slave_worker **)
                         dynamic_array_ptr(&rli->workers, k))->usage_partition);
           DBUG_ASSERT(!(*(Slave_worker **)
-                        dynamic_array_ptr(&rli->workers, k))->jobs.len);
+                        dynamic_array_ptr(&rli->workers, k))->jobs.length());
         }
 #endif
       }
@@ -9411,7 +9411,8 @@ Rows_log_event::Rows_log_event(THD *thd_arg, TABLE *tbl_arg, const Table_id& tid
     m_rows_buf(0), m_rows_cur(0), m_rows_end(0), m_flags(0),
     m_type(event_type), m_extra_row_data(0)
 #ifdef HAVE_REPLICATION
-    , m_curr_row(NULL), m_curr_row_end(NULL), m_key(NULL), last_hashed_key(NULL)
+    , m_curr_row(NULL), m_curr_row_end(NULL), m_key(NULL), last_hashed_key(NULL),
+    m_sort_distinct_keys(true)
 #endif
 {
   DBUG_ASSERT(tbl_arg && tbl_arg->s && tid.is_valid());
@@ -9474,7 +9475,8 @@ Rows_log_event::Rows_log_event(const char *buf, uint event_len,
     m_table_id(0), m_rows_buf(0), m_rows_cur(0), m_rows_end(0),
     m_extra_row_data(0)
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
-    , m_curr_row(NULL), m_curr_row_end(NULL), m_key(NULL), last_hashed_key(NULL)
+    , m_curr_row(NULL), m_curr_row_end(NULL), m_key(NULL), last_hashed_key(NULL),
+    m_sort_distinct_keys(true)
 #endif
 {
   DBUG_ENTER("Rows_log_event::Rows_log_event(const char*,...)");
@@ -10489,6 +10491,9 @@ Rows_log_event::open_record_scan()
     KEY *keyinfo= m_table->key_info + m_key_index;
     if(m_rows_lookup_algorithm == ROW_LOOKUP_HASH_SCAN)
     {
+      if (m_sort_distinct_keys)
+        sort_distinct_keyset();
+
       /* initialize the iterator over the list of distinct keys that we have */
       m_itr.init(m_distinct_key_list);
 
@@ -10518,6 +10523,14 @@ Rows_log_event::open_record_scan()
       goto end;
     }
 
+    if (opt_slave_rows_prefetch &&
+        m_rows_lookup_algorithm == ROW_LOOKUP_HASH_SCAN)
+    {
+      List_iterator_fast<uchar> it(m_distinct_key_list);
+      while (const uchar *key= it++)
+        table->file->prefetch_key(key, HA_WHOLE_KEY);
+    }
+
     /*
       Don't print debug messages when running valgrind since they can
       trigger false warnings.
@@ -10578,6 +10591,121 @@ err:
   DBUG_RETURN(error);
 }
 
+/**
+  Compares two key images of the same index, in index order.
+*/
+static int key_image_cmp(const void *arg, const void *a_ptr, const void *b_ptr)
+{
+  const KEY *key_info= static_cast<const KEY*>(arg);
+  const uchar *a= *static_cast<uchar* const*>(a_ptr);
+  const uchar *b= *static_cast<uchar* const*>(b_ptr);
+  KEY_PART_INFO *key_part= key_info->key_part;
+  KEY_PART_INFO *key_part_end= key_part + key_info->user_defined_key_parts;
+
+  for (; key_part != key_part_end; key_part++)
+  {
+    uint store_length= key_part->store_length;
+    if (key_part->null_bit)
+    {
+      /* NULL sorts first */
+      if (*a != *b)
+        return *a ? -1 : 1;
+      if (*a)
+      {
+        a+= store_length;
+        b+= store_length;
+        continue;
+      }
+      a++;
+      b++;
+      store_length--;
+    }
+    if (int res= key_part->field->key_cmp(a, b))
+      return res;
+    a+= store_length;
+    b+= store_length;
+  }
+  return 0;
+}
+
+void
+Rows_log_event::sort_distinct_keyset()
+{
+  DBUG_ENTER("Rows_log_event::sort_distinct_keyset");
+  DBUG_ASSERT(m_key_index < MAX_KEY);
+  KEY *key_info= m_table->key_info + m_key_index;
+  uint count= m_distinct_key_list.elements;
+  uint distinct= 0;
+  uchar **keys;
+
+  if (count < 2 ||
+      !(keys= (uchar **) my_malloc(key_memory_log_event,
+                                   count * sizeof(uchar *), MYF(0))))
+    DBUG_VOID_RETURN;
+
+  List_iterator<uchar> it(m_distinct_key_list);
+  for (uint i= 0; i < count; i++)
+    keys[i]= it++;
+
+  my_qsort2(keys, count, sizeof(uchar *), key_image_cmp, key_info);
+
+  for (uint i= 0; i < count; i++)
+  {
+    if (distinct && !key_image_cmp(key_info, &keys[distinct - 1], &keys[i]))
+      my_free(keys[i]);
+    else
+      keys[distinct++]= keys[i];
+  }
+
+  it.rewind();
+  for (uint i= 0; i < count; i++)
+  {
+    it++;
+    if (i < distinct)
+      it.replace(keys[i]);
+    else
+      it.remove();
+  }
+  last_hashed_key= NULL;
+  my_free(keys);
+
+  DBUG_PRINT("info", ("sorted %u keys, %u distinct", count, distinct));
+  DBUG_VOID_RETURN;
+}
+
+/**
+  Checks if the row being updated changes the value of a unique key,
+  comparing the after image in record[0] with the before image in
+  record[1]. Rows changing unique keys must be applied in the order
+  they were logged, or they could collide with each other.
+*/
+static bool unique_key_changed(TABLE *table, MY_BITMAP *bi_cols,
+                               MY_BITMAP *ai_cols)
+{
+  my_ptrdiff_t offset= table->record[1] - table->record[0];
+
+  for (uint key= 0; key < table->s->keys; key++)
+  {
+    KEY *key_info= table->key_info + key;
+    if (!(key_info->flags & HA_NOSAME))
+      continue;
+
+    KEY_PART_INFO *key_part= key_info->key_part;
+    KEY_PART_INFO *key_part_end= key_part + key_info->user_defined_key_parts;
+    for (; key_part != key_part_end; key_part++)
+    {
+      Field *field= key_part->field;
+      if (!bitmap_is_set(ai_cols, field->field_index))
+        continue;
+      if (!bitmap_is_set(bi_cols, field->field_index) ||
+          field->is_null() != field->is_null(offset) ||
+          (!field->is_null() && field->cmp_binary_offset(offset)))
+        return true;
+    }
+  }
+  return false;
+}
+
 
 int Rows_log_event::do_index_scan_and_update(Relay_log_info const *rli)
 {
@@ -10802,6 +10930,46 @@ end:
 
 }
 
+void Rows_log_event::prefetch_rows(Relay_log_info const *rli)
+{
+  DBUG_ENTER("Rows_log_event::prefetch_rows");
+  DBUG_ASSERT(m_rows_lookup_algorithm == ROW_LOOKUP_INDEX_SCAN);
+  KEY *keyinfo= m_table->key_info + m_key_index;
+  const uchar *saved_m_curr_row= m_curr_row;
+  const uchar *saved_m_curr_row_end= m_curr_row_end;
+
+  if (m_table->file->ha_index_init(m_key_index, FALSE))
+    DBUG_VOID_RETURN;
+
+  /* key_copy() reads the key fields, as in do_index_scan_and_update() */
+  memcpy(m_table->read_set->bitmap, m_cols.bitmap,
+         (m_table->read_set->n_bits + 7) / 8);
+
+  while (m_curr_row < m_rows_end)
+  {
+    prepare_record(m_table, &m_cols, FALSE);
+    if (unpack_current_row(rli, &m_cols))
+      break;
+    key_copy(m_key, m_table->record[0], keyinfo, 0);
+    m_table->file->prefetch_key(m_key, HA_WHOLE_KEY);
+
+    /* Skip the AI to get to the next BI. */
+    m_curr_row= m_curr_row_end;
+    if (get_general_type_code() == UPDATE_ROWS_EVENT)
+    {
+      if (unpack_current_row(rli, &m_cols_ai))
+        break;
+      m_curr_row= m_curr_row_end;
+    }
+  }
+
+  m_table->file->ha_index_end();
+  m_table->default_column_bitmaps();
+  m_curr_row= saved_m_curr_row;
+  m_curr_row_end= saved_m_curr_row_end;
+  DBUG_VOID_RETURN;
+}
+
 int Rows_log_event::do_hash_row(Relay_log_info const *rli)
 {
   DBUG_ENTER("Rows_log_event::do_hash_row");
@@ -10853,6 +11021,10 @@ int Rows_log_event::do_hash_row(Relay_log_info const *rli)
     prepare_record(m_table, &m_cols, false);
     error= unpack_current_row(rli, &m_cols_ai);
 
+    if (!error && m_sort_distinct_keys && m_key_index < MAX_KEY &&
+        unique_key_changed(m_table, &m_cols, &m_cols_ai))
+      m_sort_distinct_keys= false;
+
     /*
       This is the situation after unpacking the AI:
 
@@ -11461,6 +11633,10 @@ int Rows_log_event::do_apply_event(Relay_log_info const *rli)
         break;
     }
 
+    if (opt_slave_rows_prefetch &&
+        m_rows_lookup_algorithm == ROW_LOOKUP_INDEX_SCAN)
+      prefetch_rows(rli);
+
     do {
 
       error= (this->*do_apply_row_ptr)(rli);
@@ -4264,6 +4264,11 @@ protected:
   uchar    *last_hashed_key;
   uint     m_key_index;
   List<uchar> m_distinct_key_list;
+  /*
+    The rows of the event can be applied in any order, so the distinct
+    keys are visited in index order.
+  */
+  bool     m_sort_distinct_keys;
   List_iterator_fast<uchar> m_itr;
 
   // Unpack the current row into m_table->record[0]
@@ -4393,6 +4398,13 @@ private:
      found it updates it.
    */
   int do_index_scan_and_update(Relay_log_info const *rli);
+
+  /**
+     Passes the keys of all the rows of an INDEX_SCAN to
+     handler::prefetch_key(), before the rows are looked up one by
+     one. Used when slave_rows_prefetch is set.
+   */
+  void prefetch_rows(Relay_log_info const *rli);
   
   /**
      Implementation of the hash_scan and update algorithm. It collects
@@ -4448,6 +4460,13 @@ private:
   */
   int add_key_to_distinct_keyset();
 
+  /**
+    Sorts the m_distinct_key_list in index order and drops the
+    duplicate keys, so that the HASH_SCAN over keys reads the index
+    sequentially.
+  */
+  void sort_distinct_keyset();
+
   /**
     Populates the m_hash when using HASH_SCAN. Thence, it:
     - unpacks the before image (BI)
@@ -18,6 +18,7 @@
 #include "debug_sync.h"
 #include "sql_array.h"
 #include <hash.h>
+#include <my_atomic.h>
 #include <mysqld_error.h>
 #include <mysql/plugin.h>
 #include <mysql/service_thd_wait.h>
@@ -135,7 +136,9 @@ public:
   MDL_map_partition();
   ~MDL_map_partition();
   inline MDL_lock *find_or_insert(const MDL_key *mdl_key,
-                                  my_hash_value_type hash_value);
+                                  my_hash_value_type hash_value,
+                                  enum_mdl_type fast_path_type,
+                                  bool *fast_path);
   inline void remove(MDL_lock *lock);
   my_hash_value_type get_key_hash(const MDL_key *mdl_key) const
   {
@@ -185,7 +188,8 @@ class MDL_map
 public:
   void init();
   void destroy();
-  MDL_lock *find_or_insert(const MDL_key *key);
+  MDL_lock *find_or_insert(const MDL_key *key, enum_mdl_type fast_path_type,
+                           bool *fast_path);
   void remove(MDL_lock *lock);
 private:
   /** Array of partitions where the locks are actually stored. */
@@ -353,6 +357,22 @@ Deadlock_detection_visitor::opt_change_victim_to(MDL_context *new_victim)
   in its descendants.
 */
 
+/**
+  Flag in MDL_lock::m_fast_path_state which is set while there are
+  obtrusive locks granted or pending for the lock.
+*/
+static const int64 MDL_FAST_PATH_HAS_OBTRUSIVE= ((int64) 1) << 62;
+
+/** Maximum value of each counter in MDL_lock::m_fast_path_state. */
+static const int64 MDL_FAST_PATH_COUNTER_MAX= (((int64) 1) << 20) - 1;
+
+/**
+  Protects MDL_lock::m_fast_path_state on platforms without native
+  atomic operations.
+*/
+my_atomic_rwlock_t mdl_fast_path_lock;
+
+
 class MDL_lock
 {
 public:
@@ -426,11 +446,31 @@ public:
 
   bool is_empty() const
   {
-    return (m_granted.is_empty() && m_waiting.is_empty());
+    return (m_granted.is_empty() && m_waiting.is_empty() &&
+            !(fast_path_state() & ~MDL_FAST_PATH_HAS_OBTRUSIVE));
   }
 
   virtual const bitmap_t *incompatible_granted_types_bitmap() const = 0;
   virtual const bitmap_t *incompatible_waiting_types_bitmap() const = 0;
+  /**
+    @return Array with the increment of m_fast_path_state for each type
+            of "unobtrusive" lock, which can be acquired on the fast
+            path, and 0 for "obtrusive" types.
+  */
+  virtual const int64 *unobtrusive_lock_increment() const = 0;
+
+  bool is_obtrusive(enum_mdl_type type) const
+  {
+    return unobtrusive_lock_increment()[type] == 0;
+  }
+
+  int64 fast_path_state() const;
+  bitmap_t fast_path_granted_bitmap() const;
+  bool fast_path_acquire(enum_mdl_type type);
+  void fast_path_remove(enum_mdl_type type);
+  void release_fast_path_lock(enum_mdl_type type);
+  void mark_obtrusive();
+  void update_obtrusive_flag();
 
   bool has_pending_conflicting_lock(enum_mdl_type type);
 
@@ -463,11 +503,27 @@ public:
   */
   ulong m_hog_lock_count;
 
+  /**
+    Counters of granted unobtrusive locks which were acquired on the fast
+    path (and so are not present in m_granted) packed in 20-bit fields,
+    one per increment in unobtrusive_lock_increment(), and the
+    MDL_FAST_PATH_HAS_OBTRUSIVE flag.
+
+    Counters are changed with atomic operations. While the flag is clear
+    unobtrusive locks are acquired by incrementing the counter, without
+    taking m_rwlock. The flag is only changed under m_rwlock. Requests
+    for obtrusive locks set it before checking if they can be granted,
+    so from then on the counters can only decrease and unobtrusive
+    requests take the slow path which respects pending requests.
+  */
+  volatile int64 m_fast_path_state;
+
 public:
 
   MDL_lock(const MDL_key *key_arg, MDL_map_partition *map_part)
   : key(key_arg),
     m_hog_lock_count(0),
+    m_fast_path_state(0),
     m_ref_usage(0),
     m_ref_release(0),
     m_is_destroyed(FALSE),
@@ -551,6 +607,10 @@ public:
   {
     return m_waiting_incompatible;
   }
+  virtual const int64 *unobtrusive_lock_increment() const
+  {
+    return m_unobtrusive_lock_increment;
+  }
   virtual bool needs_notification(const MDL_ticket *ticket) const
   {
     return (ticket->get_type() == MDL_SHARED);
@@ -569,6 +629,7 @@ public:
 private:
   static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
   static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
+  static const int64 m_unobtrusive_lock_increment[MDL_TYPE_END];
 };
 
 
@@ -612,6 +673,10 @@ public:
   {
     return m_waiting_incompatible;
   }
+  virtual const int64 *unobtrusive_lock_increment() const
+  {
+    return m_unobtrusive_lock_increment;
+  }
   virtual bool needs_notification(const MDL_ticket *ticket) const
   {
     return (ticket->get_type() >= MDL_SHARED_NO_WRITE);
@@ -633,6 +698,7 @@ public:
 private:
   static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
   static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
+  static const int64 m_unobtrusive_lock_increment[MDL_TYPE_END];
 
 public:
   /** Members for linking the object into the list of unused objects. */
@@ -690,6 +756,7 @@ void mdl_init()
   init_mdl_psi_keys();
 #endif
 
+  my_atomic_rwlock_init(&mdl_fast_path_lock);
   mdl_locks.init();
 }
 
@@ -707,6 +774,7 @@ void mdl_destroy()
   {
     mdl_initialized= FALSE;
     mdl_locks.destroy();
+    my_atomic_rwlock_destroy(&mdl_fast_path_lock);
   }
 }
 
@@ -778,12 +846,22 @@ MDL_map_partition::~MDL_map_partition()
   Find MDL_lock object corresponding to the key, create it
   if it does not exist.
 
+  @param mdl_key         Key of the lock.
+  @param fast_path_type  Type of the lock to try to acquire on the fast
+                         path, or MDL_TYPE_END if the fast path should
+                         not be used.
+  @param[out] fast_path  Set to TRUE if the lock of fast_path_type was
+                         acquired on the fast path.
+
   @retval non-NULL - Success. MDL_lock instance for the key with
-                     locked MDL_lock::m_rwlock.
+                     locked MDL_lock::m_rwlock, or unlocked if the
+                     lock was acquired on the fast path.
   @retval NULL     - Failure (OOM).
 */
 
-MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
+MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key,
+                                  enum_mdl_type fast_path_type,
+                                  bool *fast_path)
 {
   MDL_lock *lock;
 
@@ -804,8 +882,17 @@ MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
     lock= (mdl_key->mdl_namespace() == MDL_key::GLOBAL) ? m_global_lock :
                                                           m_commit_lock;
 
+    /* Pre-allocated objects are never destroyed, no pinning is needed. */
+    if (fast_path_type != MDL_TYPE_END &&
+        lock->fast_path_acquire(fast_path_type))
+    {
+      *fast_path= TRUE;
+      return lock;
+    }
+
     mysql_prlock_wrlock(&lock->m_rwlock);
 
+    *fast_path= FALSE;
     return lock;
   }
 
@@ -813,7 +900,7 @@ MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
   uint part_id= hash_value % mdl_locks_hash_partitions;
   MDL_map_partition *part= m_partitions.at(part_id);
 
-  return part->find_or_insert(mdl_key, hash_value);
+  return part->find_or_insert(mdl_key, hash_value, fast_path_type, fast_path);
 }
 
 
@@ -821,16 +908,22 @@ MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
   Find MDL_lock object corresponding to the key and hash value in
   MDL_map partition, create it if it does not exist.
 
+  @sa MDL_map::find_or_insert() for the description of parameters.
+
   @retval non-NULL - Success. MDL_lock instance for the key with
-                     locked MDL_lock::m_rwlock.
+                     locked MDL_lock::m_rwlock, or unlocked if the
+                     lock was acquired on the fast path.
   @retval NULL     - Failure (OOM).
 */
 
 MDL_lock* MDL_map_partition::find_or_insert(const MDL_key *mdl_key,
-                                            my_hash_value_type hash_value)
+                                            my_hash_value_type hash_value,
+                                            enum_mdl_type fast_path_type,
+                                            bool *fast_path)
 {
   MDL_lock *lock;
 
+  *fast_path= FALSE;
 retry:
   mysql_mutex_lock(&m_mutex);
   if (!(lock= (MDL_lock*) my_hash_search_using_hash_value(&m_locks,
@@ -885,6 +978,20 @@ retry:
     }
   }
 
+  /*
+    While the object is in the hash and we hold m_mutex it can't be
+    removed from the hash, and once the fast path counter is incremented
+    MDL_map_partition::remove() won't remove it until the lock is
+    released. So we don't need m_rwlock or a reference to the object.
+  */
+  if (fast_path_type != MDL_TYPE_END &&
+      lock->fast_path_acquire(fast_path_type))
+  {
+    mysql_mutex_unlock(&m_mutex);
+    *fast_path= TRUE;
+    return lock;
+  }
+
   if (move_from_hash_to_lock_mutex(lock))
     goto retry;
 
@@ -997,6 +1104,17 @@ void MDL_map::remove(MDL_lock *lock)
 void MDL_map_partition::remove(MDL_lock *lock)
 {
   mysql_mutex_lock(&m_mutex);
+  if (lock->fast_path_state() & ~MDL_FAST_PATH_HAS_OBTRUSIVE)
+  {
+    /*
+      Some thread has acquired a lock on the fast path after our caller
+      has found the object empty. The object will be removed when the
+      last lock acquired on the fast path is released.
+    */
+    mysql_mutex_unlock(&m_mutex);
+    mysql_prlock_unlock(&lock->m_rwlock);
+    return;
+  }
   my_hash_delete(&m_locks, (uchar*) lock);
   /*
     To let threads holding references to the MDL_lock object know that it was
@@ -1606,6 +1724,18 @@ const MDL_lock::bitmap_t MDL_scoped_lock::m_waiting_incompatible[MDL_TYPE_END] =
 };
 
 
+/**
+  Increments of MDL_lock::m_fast_path_state for scoped locks.
+  Only IX locks, which are taken by every statement changing data,
+  are unobtrusive.
+*/
+
+const int64 MDL_scoped_lock::m_unobtrusive_lock_increment[MDL_TYPE_END] =
+{
+  1, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+
 /**
   Compatibility (or rather "incompatibility") matrices for per-object
   metadata lock. Arrays of bitmaps which elements specify which granted/
@@ -1700,6 +1830,192 @@ MDL_object_lock::m_waiting_incompatible[MDL_TYPE_END] =
 };
 
 
+/**
+  Increments of MDL_lock::m_fast_path_state for per-object locks.
+
+  S, SH, SR and SW locks, which are used by DML and are compatible with
+  each other, are unobtrusive. S and SH locks share a counter, as they
+  are incompatible with the same (obtrusive) types of granted locks.
+*/
+
+const int64 MDL_object_lock::m_unobtrusive_lock_increment[MDL_TYPE_END] =
+{
+  0, 1, 1, ((int64) 1) << 20, ((int64) 1) << 40, 0, 0, 0, 0
+};
+
+
+/** @return The current value of m_fast_path_state. */
+
+int64 MDL_lock::fast_path_state() const
+{
+  int64 state;
+  my_atomic_rwlock_rdlock(&mdl_fast_path_lock);
+  state= my_atomic_load64(const_cast<volatile int64*>(&m_fast_path_state));
+  my_atomic_rwlock_rdunlock(&mdl_fast_path_lock);
+  return state;
+}
+
+
+/**
+  @return Bitmap of types of granted locks which were acquired on the
+          fast path.
+*/
+
+MDL_lock::bitmap_t MDL_lock::fast_path_granted_bitmap() const
+{
+  const int64 *increment= unobtrusive_lock_increment();
+  int64 state= fast_path_state();
+  bitmap_t result= 0;
+
+  for (uint type= 0; type < MDL_TYPE_END; type++)
+  {
+    if (increment[type] &&
+        (state & (increment[type] * MDL_FAST_PATH_COUNTER_MAX)))
+      result|= MDL_BIT(type);
+  }
+  return result;
+}
+
+
+/**
+  Try to acquire an unobtrusive lock on the fast path.
+
+  @retval TRUE   The counter of the lock type is incremented.
+  @retval FALSE  The type is obtrusive, there are obtrusive locks granted
+                 or pending, or the counter is full. The lock must be
+                 acquired on the slow path.
+*/
+
+bool MDL_lock::fast_path_acquire(enum_mdl_type type)
+{
+  int64 increment= unobtrusive_lock_increment()[type];
+  int64 old_state;
+  bool success= FALSE;
+
+  if (increment == 0)
+    return FALSE;
+
+  my_atomic_rwlock_wrlock(&mdl_fast_path_lock);
+  old_state= my_atomic_load64(&m_fast_path_state);
+  while (!(old_state & MDL_FAST_PATH_HAS_OBTRUSIVE) &&
+         ((old_state / increment) & MDL_FAST_PATH_COUNTER_MAX) !=
+           MDL_FAST_PATH_COUNTER_MAX)
+  {
+    if (my_atomic_cas64(&m_fast_path_state, &old_state,
+                        old_state + increment))
+    {
+      success= TRUE;
+      break;
+    }
+  }
+  my_atomic_rwlock_wrunlock(&mdl_fast_path_lock);
+  return success;
+}
+
+
+/** Decrement the counter of a lock type acquired on the fast path. */
+
+void MDL_lock::fast_path_remove(enum_mdl_type type)
+{
+  DBUG_ASSERT(unobtrusive_lock_increment()[type]);
+  my_atomic_rwlock_wrlock(&mdl_fast_path_lock);
+  my_atomic_add64(&m_fast_path_state, -unobtrusive_lock_increment()[type]);
+  my_atomic_rwlock_wrunlock(&mdl_fast_path_lock);
+}
+
+
+/**
+  Release a lock acquired on the fast path.
+
+  The counter is simply decremented unless there are obtrusive locks
+  waiting, which might be granted now, or this is the last lock acquired
+  on the fast path, in which case the object might have to be removed.
+  Both are handled under m_rwlock like the release of other locks.
+*/
+
+void MDL_lock::release_fast_path_lock(enum_mdl_type type)
+{
+  int64 increment= unobtrusive_lock_increment()[type];
+  int64 old_state;
+  bool success= FALSE;
+
+  my_atomic_rwlock_wrlock(&mdl_fast_path_lock);
+  old_state= my_atomic_load64(&m_fast_path_state);
+  while (!(old_state & MDL_FAST_PATH_HAS_OBTRUSIVE) &&
+         old_state != increment)
+  {
+    if (my_atomic_cas64(&m_fast_path_state, &old_state,
+                        old_state - increment))
+    {
+      success= TRUE;
+      break;
+    }
+  }
+  my_atomic_rwlock_wrunlock(&mdl_fast_path_lock);
+
+  if (success)
+    return;
+
+  mysql_prlock_wrlock(&m_rwlock);
+  fast_path_remove(type);
+  if (is_empty())
+    mdl_locks.remove(this);
+  else
+  {
+    reschedule_waiters();
+    mysql_prlock_unlock(&m_rwlock);
+  }
+}
+
+
+/**
+  Set MDL_FAST_PATH_HAS_OBTRUSIVE before an obtrusive lock is requested,
+  so that no more unobtrusive locks are acquired on the fast path.
+
+  @pre m_rwlock is write-locked.
+*/
+
+void MDL_lock::mark_obtrusive()
+{
+  int64 old_state;
+
+  my_atomic_rwlock_wrlock(&mdl_fast_path_lock);
+  old_state= my_atomic_load64(&m_fast_path_state);
+  while (!(old_state & MDL_FAST_PATH_HAS_OBTRUSIVE) &&
+         !my_atomic_cas64(&m_fast_path_state, &old_state,
+                          old_state | MDL_FAST_PATH_HAS_OBTRUSIVE))
+  {}
+  my_atomic_rwlock_wrunlock(&mdl_fast_path_lock);
+}
+
+
+/**
+  Clear MDL_FAST_PATH_HAS_OBTRUSIVE if there are no obtrusive locks
+  granted or pending anymore.
+
+  @pre m_rwlock is write-locked.
+*/
+
+void MDL_lock::update_obtrusive_flag()
+{
+  const int64 *increment= unobtrusive_lock_increment();
+  bitmap_t types= m_granted.bitmap() | m_waiting.bitmap();
+
+  if (!(fast_path_state() & MDL_FAST_PATH_HAS_OBTRUSIVE))
+    return;
+
+  for (uint type= 0; type < MDL_TYPE_END; type++)
+  {
+    if ((types & MDL_BIT(type)) && increment[type] == 0)
+      return;
+  }
+
+  my_atomic_rwlock_wrlock(&mdl_fast_path_lock);
+  my_atomic_add64(&m_fast_path_state, -MDL_FAST_PATH_HAS_OBTRUSIVE);
+  my_atomic_rwlock_wrunlock(&mdl_fast_path_lock);
+}
+
+
 /**
   Check if request for the metadata lock can be satisfied given its
   current state.
@@ -1734,7 +2050,14 @@ MDL_lock::can_grant_lock(enum_mdl_type type_arg,
   */
   if (ignore_lock_priority || !(m_waiting.bitmap() & waiting_incompat_map))
   {
-    if (! (m_granted.bitmap() & granted_incompat_map))
+    /*
+      Locks acquired on the fast path belong to other contexts, since
+      the requestor materializes its own ones before requesting an
+      obtrusive lock (only obtrusive locks can conflict with them).
+    */
+    if (fast_path_granted_bitmap() & granted_incompat_map)
+      can_grant= FALSE;
+    else if (! (m_granted.bitmap() & granted_incompat_map))
       can_grant= TRUE;
     else
     {
@@ -1762,6 +2085,7 @@ void MDL_lock::remove_ticket(Ticket_list MDL_lock::*list, MDL_ticket *ticket)
 {
   mysql_prlock_wrlock(&m_rwlock);
   (this->*list).remove_ticket(ticket);
+  update_obtrusive_flag();
   if (is_empty())
     mdl_locks.remove(this);
   else
@@ -1934,6 +2258,7 @@ MDL_context::try_acquire_lock(MDL_request *mdl_request)
       is no need to release it.
     */
     DBUG_ASSERT(! ticket->m_lock->is_empty());
+    ticket->m_lock->update_obtrusive_flag();
     mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
     MDL_ticket::destroy(ticket);
   }
@@ -1966,6 +2291,7 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
   MDL_key *key= &mdl_request->key;
   MDL_ticket *ticket;
   enum_mdl_duration found_duration;
+  bool fast_path;
 
   DBUG_ASSERT(mdl_request->type != MDL_EXCLUSIVE ||
               is_lock_owner(MDL_key::GLOBAL, "", "", MDL_INTENTION_EXCLUSIVE));
@@ -2019,8 +2345,17 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
                                    )))
     return TRUE;
 
-  /* The below call implicitly locks MDL_lock::m_rwlock on success. */
-  if (!(lock= mdl_locks.find_or_insert(key)))
+  /*
+    The below call implicitly locks MDL_lock::m_rwlock on success, unless
+    the lock is acquired on the fast path. The fast path is not used by
+    contexts which need their waits for table-level locks to be aborted,
+    since MDL_lock::notify_conflicting_locks() only sees granted locks
+    in MDL_lock::m_granted.
+  */
+  if (!(lock= mdl_locks.find_or_insert(key,
+                                       m_needs_thr_lock_abort ?
+                                       MDL_TYPE_END : mdl_request->type,
+                                       &fast_path)))
   {
     MDL_ticket::destroy(ticket);
     return TRUE;
@@ -2028,6 +2363,25 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
 
   ticket->m_lock= lock;
 
+  if (fast_path)
+  {
+    ticket->m_is_fast_path= TRUE;
+    m_tickets[mdl_request->duration].push_front(ticket);
+    mdl_request->ticket= ticket;
+    return FALSE;
+  }
+
+  if (lock->is_obtrusive(mdl_request->type))
+  {
+    /*
+      Stop acquisition of locks on the fast path and make our own such
+      locks visible, so that can_grant_lock() can tell them apart from
+      the conflicting locks of other contexts.
+    */
+    lock->mark_obtrusive();
+    materialize_fast_path_locks(lock);
+  }
+
   if (lock->can_grant_lock(mdl_request->type, this, false))
   {
     lock->m_granted.add_ticket(ticket);
@@ -2419,6 +2773,9 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
   if (acquire_lock(&mdl_xlock_request, lock_wait_timeout))
     DBUG_RETURN(TRUE);
 
+  /* Acquisition of the obtrusive lock has materialized mdl_ticket. */
+  DBUG_ASSERT(! mdl_ticket->m_is_fast_path);
+
   is_new_ticket= ! has_lock(mdl_svp, mdl_xlock_request.ticket);
 
   /* Merge the acquired and the original lock. @todo: move to a method. */
@@ -2650,6 +3007,13 @@ bool MDL_context::visit_subgraph(MDL_wait_for_graph_visitor *gvisitor)
 
 void MDL_context::find_deadlock()
 {
+  /*
+    Our locks acquired on the fast path must be visible to the searches
+    performed by this and other contexts from now on. A deadlock which
+    involves them is then found by the last context to start waiting.
+  */
+  materialize_fast_path_locks();
+
   while (1)
   {
     /*
@@ -2696,6 +3060,74 @@ void MDL_context::find_deadlock()
 }
 
 
+/**
+  Move a ticket acquired on the fast path to MDL_lock::m_granted.
+
+  @pre MDL_lock::m_rwlock of the ticket's lock is write-locked.
+*/
+
+static void materialize_fast_path_ticket(MDL_ticket *ticket)
+{
+  MDL_lock *lock= ticket->get_lock();
+
+  lock->m_granted.add_ticket(ticket);
+  lock->fast_path_remove(ticket->get_type());
+}
+
+
+/**
+  Make all locks of the context which were acquired on the fast path
+  visible to other contexts, i.e. to the deadlock detector and to
+  MDL_lock::notify_conflicting_locks().
+*/
+
+void MDL_context::materialize_fast_path_locks()
+{
+  for (int i= 0; i < MDL_DURATION_END; i++)
+  {
+    Ticket_iterator it(m_tickets[i]);
+    MDL_ticket *ticket;
+
+    while ((ticket= it++))
+    {
+      if (ticket->m_is_fast_path)
+      {
+        mysql_prlock_wrlock(&ticket->m_lock->m_rwlock);
+        materialize_fast_path_ticket(ticket);
+        ticket->m_is_fast_path= FALSE;
+        mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
+      }
+    }
+  }
+}
+
+
+/**
+  Materialize the locks of the context on one object which were
+  acquired on the fast path.
+
+  @pre MDL_lock::m_rwlock is write-locked.
+*/
+
+void MDL_context::materialize_fast_path_locks(MDL_lock *lock)
+{
+  for (int i= 0; i < MDL_DURATION_END; i++)
+  {
+    Ticket_iterator it(m_tickets[i]);
+    MDL_ticket *ticket;
+
+    while ((ticket= it++))
+    {
+      if (ticket->m_is_fast_path && ticket->m_lock == lock)
+      {
+        materialize_fast_path_ticket(ticket);
+        ticket->m_is_fast_path= FALSE;
+      }
+    }
+  }
+}
+
+
 /**
   Release lock.
 
@@ -2714,7 +3146,10 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
   DBUG_ASSERT(this == ticket->get_ctx());
   mysql_mutex_assert_not_owner(&LOCK_open);
 
-  lock->remove_ticket(&MDL_lock::m_granted, ticket);
+  if (ticket->m_is_fast_path)
+    lock->release_fast_path_lock(ticket->get_type());
+  else
+    lock->remove_ticket(&MDL_lock::m_granted, ticket);
 
   m_tickets[duration].remove(ticket);
   MDL_ticket::destroy(ticket);
@@ -2829,6 +3264,7 @@ void MDL_ticket::downgrade_lock(enum_mdl_type type)
   m_lock->m_granted.remove_ticket(this);
   m_type= type;
   m_lock->m_granted.add_ticket(this);
+  m_lock->update_obtrusive_flag();
   m_lock->reschedule_waiters();
   mysql_prlock_unlock(&m_lock->m_rwlock);
 }
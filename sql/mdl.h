@@ -603,7 +603,8 @@ private:
      m_duration(duration_arg),
 #endif
      m_ctx(ctx_arg),
-     m_lock(NULL)
+     m_lock(NULL),
+     m_is_fast_path(FALSE)
   {}
 
   static MDL_ticket *create(MDL_context *ctx_arg, enum_mdl_type type_arg
@@ -632,6 +633,13 @@ private:
   */
   MDL_lock *m_lock;
 
+  /**
+    TRUE if the lock was acquired on the fast path, i.e. the ticket is
+    only counted in MDL_lock::m_fast_path_state and is not present in
+    MDL_lock::m_granted. Context private.
+  */
+  bool m_is_fast_path;
+
 private:
   MDL_ticket(const MDL_ticket &);               /* not implemented */
   MDL_ticket &operator=(const MDL_ticket &);    /* not implemented */
@@ -794,6 +802,12 @@ public:
             will see the new value eventually.
     */
     m_needs_thr_lock_abort= needs_thr_lock_abort;
+    /*
+      Locks acquired on the fast path are invisible to the code which
+      aborts waits for table-level locks. Make them visible.
+    */
+    if (needs_thr_lock_abort)
+      materialize_fast_path_locks();
   }
   bool get_needs_thr_lock_abort() const
   {
@@ -897,6 +911,8 @@ private:
   void release_lock(enum_mdl_duration duration, MDL_ticket *ticket);
   bool try_acquire_lock_impl(MDL_request *mdl_request,
                              MDL_ticket **out_ticket);
+  void materialize_fast_path_locks();
+  void materialize_fast_path_locks(MDL_lock *lock);
 
 public:
   void find_deadlock();
@@ -110,6 +110,7 @@
 #include <errmsg.h>
 #include "sp_rcontext.h"
 #include "sp_cache.h"
+#include "sp.h"       // sp_definition_cache_init
 #include "sql_reload.h"  // reload_acl_and_cache
 #include "sp_head.h"  // init_sp_psi_keys
 #include "event_data_objects.h" //init_scheduler_psi_keys
@@ -429,6 +430,8 @@ my_bool old_mode;
 */
 handlerton *heap_hton;
 handlerton *myisam_hton;
+handlerton *innodb_hton;
+ulong internal_tmp_disk_storage_engine;
 handlerton *partition_hton;
 
 uint opt_server_id_bits= 0;
@@ -440,6 +443,10 @@ my_bool opt_sync_frm, opt_allow_suspicious_udfs;
 my_bool opt_secure_auth= 0;
 char* opt_secure_file_priv;
 my_bool opt_log_slow_admin_statements= 0;
+/* Cost constants of the optimizer, see sql_const.h */
+double opt_row_evaluate_cost= ROW_EVALUATE_COST_DEFAULT;
+double opt_io_block_read_cost= IO_BLOCK_READ_COST_DEFAULT;
+double opt_memory_block_read_cost= MEMORY_BLOCK_READ_COST_DEFAULT;
 my_bool opt_log_slow_slave_statements= 0;
 my_bool lower_case_file_system= 0;
 my_bool opt_large_pages= 0;
@@ -477,6 +484,7 @@ volatile sig_atomic_t calling_initgroups= 0; /**< Used in SIGSEGV handler. */
 #endif
 const char *timestamp_type_names[]= {"UTC", "SYSTEM", NullS};
 ulong opt_log_timestamps;
+ulong opt_query_log_buffer_size, opt_query_log_buffer_full;
 uint mysqld_port, test_flags, select_errors, dropping_tables, ha_open_options;
 uint mysqld_port_timeout;
 ulong delay_key_write_options;
@@ -499,6 +507,7 @@ ulonglong slave_type_conversions_options;
 ulong opt_mts_slave_parallel_workers;
 ulonglong opt_mts_pending_jobs_size_max;
 ulonglong slave_rows_search_algorithms_options;
+my_bool opt_slave_rows_prefetch= 0;
 #ifndef DBUG_OFF
 uint slave_rows_last_search_algorithm_used;
 #endif
@@ -507,6 +516,7 @@ ulong binlog_cache_size=0;
 ulonglong  max_binlog_cache_size=0;
 ulong slave_max_allowed_packet= 0;
 ulong binlog_stmt_cache_size=0;
+ulong binlog_cache_max_memory_size= 0;
 my_atomic_rwlock_t opt_binlog_max_flush_queue_time_lock;
 int32 opt_binlog_max_flush_queue_time= 0;
 ulonglong  max_binlog_stmt_cache_size=0;
@@ -689,7 +699,7 @@ bool THR_MALLOC_initialized= false;
 pthread_key(THD*, THR_THD);
 bool THR_THD_initialized= false;
 mysql_mutex_t LOCK_thread_created;
-mysql_mutex_t LOCK_thread_count, LOCK_thread_remove;
+mysql_mutex_t LOCK_thread_count;
 mysql_mutex_t
   LOCK_status, LOCK_error_log, LOCK_uuid_generator,
   LOCK_crypt,
@@ -778,8 +788,22 @@ void deinit_rsa_keys(void);
 int show_rsa_public_key(THD *thd, SHOW_VAR *var, char *buff);
 #endif
 
-static volatile sig_atomic_t global_thread_count= 0;
-static std::set<THD*> *global_thread_list= NULL;
+static volatile int32 global_thread_count= 0;
+static my_atomic_rwlock_t global_thread_count_lock;
+
+/**
+  A partition of the set of registered threads, see global_threads.h.
+  The mutex protects the set, and the THDs in it from being deleted.
+  The condition is broadcast when a THD is removed.
+*/
+struct Thd_list_partition
+{
+  mysql_mutex_t lock;
+  mysql_cond_t cond;
+  std::set<THD*> *threads;
+};
+
+static Thd_list_partition thd_list_partitions[THD_LIST_PARTITIONS];
 
 
 Connection_acceptor<Mysqld_socket_listener> *mysqld_socket_acceptor= NULL;
@@ -792,49 +816,95 @@ Checkable_rwlock *global_sid_lock= NULL;
 Sid_map *global_sid_map= NULL;
 Gtid_state *gtid_state= NULL;
 
-/*
-  global_thread_list is a pointer to an object
-  on the heap, to avoid potential problems with running destructors atexit().
- */
-static void delete_global_thread_list()
+/**
+  The partition of a THD: the top bits of the Fibonacci hash of its
+  address, which spread THDs allocated at regular strides.
+*/
+static inline Thd_list_partition *thd_list_partition(const THD *thd)
 {
-  delete global_thread_list;
-  global_thread_list= NULL;
+  const ulonglong hash= (ulonglong) (intptr) thd * 0x9E3779B97F4A7C15ULL;
+  return &thd_list_partitions[(hash >> 32) % THD_LIST_PARTITIONS];
 }
 
-Thread_iterator global_thread_list_begin()
+static void init_global_thread_list()
 {
-  mysql_mutex_assert_owner(&LOCK_thread_count);
-  return global_thread_list->begin();
+  for (uint i= 0; i < THD_LIST_PARTITIONS; i++)
+  {
+    Thd_list_partition *part= &thd_list_partitions[i];
+    mysql_mutex_init(key_LOCK_thd_list, &part->lock, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_COND_thd_list, &part->cond, NULL);
+    part->threads= new std::set<THD*>;
+  }
+  my_atomic_rwlock_init(&global_thread_count_lock);
 }
 
-Thread_iterator global_thread_list_end()
+/*
+  The sets are objects on the heap, to avoid potential problems with
+  running destructors atexit().
+ */
+static void delete_global_thread_list()
 {
-  mysql_mutex_assert_owner(&LOCK_thread_count);
-  return global_thread_list->end();
+  for (uint i= 0; i < THD_LIST_PARTITIONS; i++)
+  {
+    Thd_list_partition *part= &thd_list_partitions[i];
+    if (part->threads == NULL)
+      continue;
+    delete part->threads;
+    part->threads= NULL;
+    mysql_cond_destroy(&part->cond);
+    mysql_mutex_destroy(&part->lock);
+  }
+  my_atomic_rwlock_destroy(&global_thread_count_lock);
 }
 
-void copy_global_thread_list(std::set<THD*> *new_copy)
+void do_for_all_thd(Do_THD_Impl *func)
 {
-  mysql_mutex_assert_owner(&LOCK_thread_count);
-  try {
-    *new_copy= *global_thread_list;
+  for (uint i= 0; i < THD_LIST_PARTITIONS; i++)
+  {
+    Thd_list_partition *part= &thd_list_partitions[i];
+    mysql_mutex_lock(&part->lock);
+    std::set<THD*>::iterator it= part->threads->begin();
+    std::set<THD*>::iterator end= part->threads->end();
+    for (; it != end; ++it)
+      (*func)(*it);
+    mysql_mutex_unlock(&part->lock);
   }
-  catch (std::bad_alloc &ba)
+}
+
+THD *find_thd(Find_THD_Impl *func)
+{
+  for (uint i= 0; i < THD_LIST_PARTITIONS; i++)
   {
-  } 
+    Thd_list_partition *part= &thd_list_partitions[i];
+    mysql_mutex_lock(&part->lock);
+    std::set<THD*>::iterator it= part->threads->begin();
+    std::set<THD*>::iterator end= part->threads->end();
+    for (; it != end; ++it)
+    {
+      if ((*func)(*it))
+      {
+        THD *thd= *it;
+        mysql_mutex_unlock(&part->lock);
+        return thd;
+      }
+    }
+    mysql_mutex_unlock(&part->lock);
+  }
+  return NULL;
 }
 
 void add_global_thread(THD *thd)
 {
   DBUG_PRINT("info", ("add_global_thread %p", thd));
-  mysql_mutex_assert_owner(&LOCK_thread_count);
-  const bool have_thread=
-    global_thread_list->find(thd) != global_thread_list->end();
+  Thd_list_partition *part= thd_list_partition(thd);
+  mysql_mutex_lock(&part->lock);
+  const bool have_thread= !part->threads->insert(thd).second;
+  mysql_mutex_unlock(&part->lock);
   if (!have_thread)
   {
-    ++global_thread_count;
-    global_thread_list->insert(thd);
+    my_atomic_rwlock_wrlock(&global_thread_count_lock);
+    my_atomic_add32(&global_thread_count, 1);
+    my_atomic_rwlock_wrunlock(&global_thread_count_lock);
   }
   // Adding the same THD twice is an error.
   DBUG_ASSERT(!have_thread);
@@ -844,18 +914,36 @@ void remove_global_thread(THD *thd)
 {
   DBUG_PRINT("info", ("remove_global_thread %p current_linfo %p",
                       thd, thd->current_linfo));
-  mysql_mutex_assert_owner(&LOCK_thread_count);
   DBUG_ASSERT(thd->release_resources_done());
 
-  mysql_mutex_lock(&LOCK_thread_remove);
-  const size_t num_erased= global_thread_list->erase(thd);
-  mysql_mutex_unlock(&LOCK_thread_remove);
+  Thd_list_partition *part= thd_list_partition(thd);
+  mysql_mutex_lock(&part->lock);
+  const size_t num_erased= part->threads->erase(thd);
   if (num_erased == 1)
-    --global_thread_count;
+  {
+    my_atomic_rwlock_wrlock(&global_thread_count_lock);
+    my_atomic_add32(&global_thread_count, -1);
+    my_atomic_rwlock_wrunlock(&global_thread_count_lock);
+  }
+  mysql_cond_broadcast(&part->cond);
+  mysql_mutex_unlock(&part->lock);
   // Removing a THD that was never added is an error.
   DBUG_ASSERT(1 == num_erased);
+}
 
-  mysql_cond_broadcast(&COND_thread_count);
+void wait_till_no_thd()
+{
+  for (uint i= 0; i < THD_LIST_PARTITIONS; i++)
+  {
+    Thd_list_partition *part= &thd_list_partitions[i];
+    mysql_mutex_lock(&part->lock);
+    while (!part->threads->empty())
+    {
+      mysql_cond_wait(&part->cond, &part->lock);
+      DBUG_PRINT("quit", ("One thread died (count=%u)", get_thread_count()));
+    }
+    mysql_mutex_unlock(&part->lock);
+  }
 }
 
 uint get_thread_count()
@@ -1106,6 +1194,8 @@ int allow_severity = LOG_INFO;
 int deny_severity = LOG_WARNING;
 #endif /* HAVE_LIBWRAP */
 ulong query_cache_min_res_unit= QUERY_CACHE_MIN_RESULT_DATA_SIZE;
+uint query_cache_partitions= 1;
+uint opt_protocol_compression_level= 6;
 Query_cache query_cache;
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
 char *shared_memory_base_name= default_shared_memory_base_name;
@@ -1116,6 +1206,8 @@ my_bool opt_use_ssl  = 0;
 char *opt_ssl_ca= NULL, *opt_ssl_capath= NULL, *opt_ssl_cert= NULL,
      *opt_ssl_cipher= NULL, *opt_ssl_key= NULL, *opt_ssl_crl= NULL,
      *opt_ssl_crlpath= NULL;
+ulong opt_ssl_session_cache_size= 128, opt_ssl_session_cache_timeout= 300;
+my_bool opt_ssl_session_tickets= TRUE;
 
 #ifdef HAVE_OPENSSL
 #include <openssl/crypto.h>
@@ -1174,6 +1266,63 @@ static void end_ssl();
 ** Code to end mysqld
 ****************************************************************************/
 
+/**
+  Tell a thread that it's time to die, in the first pass of
+  close_connections(). Slave threads are skipped, they are stopped by
+  end_slave().
+*/
+class Set_kill_conn : public Do_THD_Impl
+{
+public:
+  virtual void operator()(THD *tmp)
+  {
+    DBUG_PRINT("quit",("Informing thread %ld that it's time to die",
+                       tmp->thread_id));
+    if (tmp->slave_thread)
+      return;
+
+    tmp->killed= THD::KILL_CONNECTION;
+    MYSQL_CALLBACK(Connection_handler_manager::callback,
+                   post_kill_notification, (tmp));
+    mysql_mutex_lock(&tmp->LOCK_thd_data);
+    if (tmp->mysys_var)
+    {
+      tmp->mysys_var->abort=1;
+      mysql_mutex_lock(&tmp->mysys_var->mutex);
+      if (tmp->mysys_var->current_cond)
+      {
+        mysql_mutex_lock(tmp->mysys_var->current_mutex);
+        mysql_cond_broadcast(tmp->mysys_var->current_cond);
+        mysql_mutex_unlock(tmp->mysys_var->current_mutex);
+      }
+      mysql_mutex_unlock(&tmp->mysys_var->mutex);
+    }
+    mysql_mutex_unlock(&tmp->LOCK_thd_data);
+  }
+};
+
+
+/**
+  Close the connection of a thread that is still alive, in the second
+  pass of close_connections().
+*/
+class Close_conn : public Do_THD_Impl
+{
+public:
+  virtual void operator()(THD *tmp)
+  {
+    if (tmp->vio_ok())
+    {
+      sql_print_warning(ER_DEFAULT(ER_FORCING_CLOSE),my_progname,
+                        tmp->thread_id,
+                        (tmp->main_security_ctx.user ?
+                         tmp->main_security_ctx.user : ""));
+      close_connection(tmp);
+    }
+  }
+};
+
+
 static void close_connections(void)
 {
 #ifdef EXTRA_DEBUG
@@ -1247,37 +1396,8 @@ static void close_connections(void)
   sql_print_information("Giving %d client threads a chance to die gracefully",
                         static_cast<int>(get_thread_count()));
 
-  mysql_mutex_lock(&LOCK_thread_count);
-
-  Thread_iterator it= global_thread_list->begin();
-  for (; it != global_thread_list->end(); ++it)
-  {
-    THD *tmp= *it;
-    DBUG_PRINT("quit",("Informing thread %ld that it's time to die",
-                       tmp->thread_id));
-    /* We skip slave threads & scheduler on this first loop through. */
-    if (tmp->slave_thread)
-      continue;
-
-    tmp->killed= THD::KILL_CONNECTION;
-    MYSQL_CALLBACK(Connection_handler_manager::callback,
-                   post_kill_notification, (tmp));
-    mysql_mutex_lock(&tmp->LOCK_thd_data);
-    if (tmp->mysys_var)
-    {
-      tmp->mysys_var->abort=1;
-      mysql_mutex_lock(&tmp->mysys_var->mutex);
-      if (tmp->mysys_var->current_cond)
-      {
-        mysql_mutex_lock(tmp->mysys_var->current_mutex);
-        mysql_cond_broadcast(tmp->mysys_var->current_cond);
-        mysql_mutex_unlock(tmp->mysys_var->current_mutex);
-      }
-      mysql_mutex_unlock(&tmp->mysys_var->mutex);
-    }
-    mysql_mutex_unlock(&tmp->LOCK_thd_data);
-  }
-  mysql_mutex_unlock(&LOCK_thread_count);
+  Set_kill_conn set_kill_conn;
+  do_for_all_thd(&set_kill_conn);
 
   sql_print_information("Shutting down slave threads");
   end_slave();
@@ -1294,22 +1414,8 @@ static void close_connections(void)
   sql_print_information("Forcefully disconnecting %d remaining clients",
                         static_cast<int>(get_thread_count()));
 
-  DBUG_PRINT("quit", ("Locking LOCK_thread_count"));
-  mysql_mutex_lock(&LOCK_thread_count);
-  for (it= global_thread_list->begin(); it != global_thread_list->end(); ++it)
-  {
-    THD *tmp= *it;
-    if (tmp->vio_ok())
-    {
-      sql_print_warning(ER_DEFAULT(ER_FORCING_CLOSE),my_progname,
-                        tmp->thread_id,
-                        (tmp->main_security_ctx.user ?
-                         tmp->main_security_ctx.user : ""));
-      close_connection(tmp);
-    }
-  }
-  DBUG_PRINT("quit",("Unlocking LOCK_thread_count"));
-  mysql_mutex_unlock(&LOCK_thread_count);
+  Close_conn close_conn;
+  do_for_all_thd(&close_conn);
 
   /* 
     All threads have now been aborted. Stop event scheduler thread 
@@ -1320,13 +1426,7 @@ static void close_connections(void)
   Events::deinit();
   DBUG_PRINT("quit",("Waiting for threads to die (count=%u)",
                      get_thread_count()));
-  mysql_mutex_lock(&LOCK_thread_count);
-  while (get_thread_count() > 0)
-  {
-    mysql_cond_wait(&COND_thread_count, &LOCK_thread_count);
-    DBUG_PRINT("quit", ("One thread died (count=%u)", get_thread_count()));
-  }
-  mysql_mutex_unlock(&LOCK_thread_count);
+  wait_till_no_thd();
 
   close_active_mi();
   DBUG_PRINT("quit",("close_connections thread"));
@@ -1575,6 +1675,7 @@ void clean_up(bool print_message)
 #endif
   my_tz_free();
   my_dboptions_cache_free();
+  sp_definition_cache_free();
   ignore_db_dirs_free();
 #ifndef NO_EMBEDDED_ACCESS_CHECKS
   servers_free(1);
@@ -1612,6 +1713,7 @@ void clean_up(bool print_message)
   my_free(opt_bin_logname);
   bitmap_free(&temp_pool);
   free_max_user_conn();
+  THD::free_cache();
 #ifdef HAVE_REPLICATION
   end_slave_list();
 #endif
@@ -1735,7 +1837,6 @@ static void clean_up_mutexes()
   mysql_mutex_destroy(&LOCK_slave_net_timeout);
   mysql_mutex_destroy(&LOCK_error_messages);
   mysql_cond_destroy(&COND_thread_count);
-  mysql_mutex_destroy(&LOCK_thread_remove);
   mysql_cond_destroy(&COND_thread_cache);
   mysql_cond_destroy(&COND_flush_thread_cache);
   mysql_cond_destroy(&COND_manager);
@@ -3529,8 +3630,6 @@ static int init_thread_environment()
   mysql_mutex_init(key_LOCK_thread_created,
                    &LOCK_thread_created, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_thread_count, &LOCK_thread_count, MY_MUTEX_INIT_FAST);
-  mysql_mutex_init(key_LOCK_thread_remove, 
-                   &LOCK_thread_remove, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_status, &LOCK_status, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_manager,
                    &LOCK_manager, MY_MUTEX_INIT_FAST);
@@ -3583,6 +3682,7 @@ static int init_thread_environment()
                    &LOCK_server_started, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_COND_server_started, &COND_server_started, NULL);
   sp_cache_init();
+  sp_definition_cache_init();
 #ifndef EMBEDDED_LIBRARY
   Events::init_mutexes();
 #endif
@@ -3691,7 +3791,10 @@ static int init_ssl()
     ssl_acceptor_fd= new_VioSSLAcceptorFd(opt_ssl_key, opt_ssl_cert,
 					  opt_ssl_ca, opt_ssl_capath,
 					  opt_ssl_cipher, &error,
-                                          opt_ssl_crl, opt_ssl_crlpath);
+                                          opt_ssl_crl, opt_ssl_crlpath,
+                                          (long) opt_ssl_session_cache_size,
+                                          (long) opt_ssl_session_cache_timeout,
+                                          opt_ssl_session_tickets);
     DBUG_PRINT("info",("ssl_acceptor_fd: 0x%lx", (long) ssl_acceptor_fd));
     ERR_remove_state(0);
     if (!ssl_acceptor_fd)
@@ -3938,8 +4041,8 @@ static void init_server_query_cache()
 {
   ulong set_cache_size;
 
+  query_cache.init(query_cache_partitions);
   query_cache.set_min_res_unit(query_cache_min_res_unit);
-  query_cache.init();
 	
   set_cache_size= query_cache.resize(query_cache_size);
   if (set_cache_size != query_cache_size)
@@ -5869,6 +5972,17 @@ static int show_queries(THD *thd, SHOW_VAR *var, char *buff)
 }
 
 
+/* A query cache counter, summed over the partitions */
+template <ulong Query_cache_partition::*counter>
+static int show_qcache(THD *thd, SHOW_VAR *var, char *buff)
+{
+  var->type= SHOW_LONG;
+  var->value= buff;
+  *((long *) buff)= (long) query_cache.sum(counter);
+  return 0;
+}
+
+
 static int show_net_compression(THD *thd, SHOW_VAR *var, char *buff)
 {
   var->type= SHOW_MY_BOOL;
@@ -6387,6 +6501,7 @@ SHOW_VAR status_vars[]= {
    SHOW_LONG},
   {"Binlog_cache_disk_use",    (char*) &binlog_cache_disk_use,  SHOW_LONG},
   {"Binlog_cache_use",         (char*) &binlog_cache_use,       SHOW_LONG},
+  {"Binlog_group_commit",      (char*) binlog_group_commit_status_vars, SHOW_ARRAY},
   {"Binlog_stmt_cache_disk_use",(char*) &binlog_stmt_cache_disk_use,  SHOW_LONG},
   {"Binlog_stmt_cache_use",    (char*) &binlog_stmt_cache_use,       SHOW_LONG},
   {"Bytes_received",           (char*) offsetof(STATUS_VAR, bytes_received), SHOW_LONGLONG_STATUS},
@@ -6407,6 +6522,7 @@ SHOW_VAR status_vars[]= {
   {"Delayed_insert_threads",   (char*) &delayed_insert_threads, SHOW_LONG_NOFLUSH},
   {"Delayed_writes",           (char*) &delayed_insert_writes,  SHOW_LONG},
   {"Flush_commands",           (char*) &refresh_version,        SHOW_LONG_NOFLUSH},
+  {"General_log_entries_dropped", (char*) &general_log_entries_dropped, SHOW_LONG},
   {"Handler_commit",           (char*) offsetof(STATUS_VAR, ha_commit_count), SHOW_LONGLONG_STATUS},
   {"Handler_delete",           (char*) offsetof(STATUS_VAR, ha_delete_count), SHOW_LONGLONG_STATUS},
   {"Handler_discover",         (char*) offsetof(STATUS_VAR, ha_discover_count), SHOW_LONGLONG_STATUS},
@@ -6425,6 +6541,8 @@ SHOW_VAR status_vars[]= {
   {"Handler_savepoint_rollback",(char*) offsetof(STATUS_VAR, ha_savepoint_rollback_count), SHOW_LONGLONG_STATUS},
   {"Handler_update",           (char*) offsetof(STATUS_VAR, ha_update_count), SHOW_LONGLONG_STATUS},
   {"Handler_write",            (char*) offsetof(STATUS_VAR, ha_write_count), SHOW_LONGLONG_STATUS},
+  {"Join_order_cache_hits",    (char*) offsetof(STATUS_VAR, join_order_cache_hits), SHOW_LONGLONG_STATUS},
+  {"Join_order_cache_misses",  (char*) offsetof(STATUS_VAR, join_order_cache_misses), SHOW_LONGLONG_STATUS},
   {"Key_blocks_not_flushed",   (char*) offsetof(KEY_CACHE, global_blocks_changed), SHOW_KEY_CACHE_LONG},
   {"Key_blocks_unused",        (char*) offsetof(KEY_CACHE, blocks_unused), SHOW_KEY_CACHE_LONG},
   {"Key_blocks_used",          (char*) offsetof(KEY_CACHE, blocks_used), SHOW_KEY_CACHE_LONG},
@@ -6444,14 +6562,14 @@ SHOW_VAR status_vars[]= {
   {"Opened_tables",            (char*) offsetof(STATUS_VAR, opened_tables), SHOW_LONGLONG_STATUS},
   {"Opened_table_definitions", (char*) offsetof(STATUS_VAR, opened_shares), SHOW_LONGLONG_STATUS},
   {"Prepared_stmt_count",      (char*) &show_prepared_stmt_count, SHOW_FUNC},
-  {"Qcache_free_blocks",       (char*) &query_cache.free_memory_blocks, SHOW_LONG_NOFLUSH},
-  {"Qcache_free_memory",       (char*) &query_cache.free_memory, SHOW_LONG_NOFLUSH},
-  {"Qcache_hits",              (char*) &query_cache.hits,       SHOW_LONG},
-  {"Qcache_inserts",           (char*) &query_cache.inserts,    SHOW_LONG},
-  {"Qcache_lowmem_prunes",     (char*) &query_cache.lowmem_prunes, SHOW_LONG},
-  {"Qcache_not_cached",        (char*) &query_cache.refused,    SHOW_LONG},
-  {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache, SHOW_LONG_NOFLUSH},
-  {"Qcache_total_blocks",      (char*) &query_cache.total_blocks, SHOW_LONG_NOFLUSH},
+  {"Qcache_free_blocks",       (char*) &show_qcache<&Query_cache_partition::free_memory_blocks>, SHOW_FUNC},
+  {"Qcache_free_memory",       (char*) &show_qcache<&Query_cache_partition::free_memory>, SHOW_FUNC},
+  {"Qcache_hits",              (char*) &show_qcache<&Query_cache_partition::hits>, SHOW_FUNC},
+  {"Qcache_inserts",           (char*) &show_qcache<&Query_cache_partition::inserts>, SHOW_FUNC},
+  {"Qcache_lowmem_prunes",     (char*) &show_qcache<&Query_cache_partition::lowmem_prunes>, SHOW_FUNC},
+  {"Qcache_not_cached",        (char*) &show_qcache<&Query_cache_partition::refused>, SHOW_FUNC},
+  {"Qcache_queries_in_cache",  (char*) &show_qcache<&Query_cache_partition::queries_in_cache>, SHOW_FUNC},
+  {"Qcache_total_blocks",      (char*) &show_qcache<&Query_cache_partition::total_blocks>, SHOW_FUNC},
   {"Queries",                  (char*) &show_queries,            SHOW_FUNC},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions), SHOW_LONGLONG_STATUS},
   {"Select_full_join",         (char*) offsetof(STATUS_VAR, select_full_join_count), SHOW_LONGLONG_STATUS},
@@ -6472,9 +6590,12 @@ SHOW_VAR status_vars[]= {
 #endif
 #ifndef EMBEDDED_LIBRARY
   {"Slow_launch_threads",      (char*) &Per_thread_connection_handler::slow_launch_threads, SHOW_LONG},
+  {"Slow_log_entries_dropped", (char*) &slow_log_entries_dropped, SHOW_LONG},
 #endif
   {"Slow_queries",             (char*) offsetof(STATUS_VAR, long_query_count), SHOW_LONGLONG_STATUS},
   {"Sort_merge_passes",        (char*) offsetof(STATUS_VAR, filesort_merge_passes), SHOW_LONGLONG_STATUS},
+  {"Sort_parallel",            (char*) offsetof(STATUS_VAR, filesort_parallel_count), SHOW_LONGLONG_STATUS},
+  {"Sort_parallel_threads",    (char*) offsetof(STATUS_VAR, filesort_parallel_threads), SHOW_LONGLONG_STATUS},
   {"Sort_range",               (char*) offsetof(STATUS_VAR, filesort_range_count), SHOW_LONGLONG_STATUS},
   {"Sort_rows",                (char*) offsetof(STATUS_VAR, filesort_rows), SHOW_LONGLONG_STATUS},
   {"Sort_scan",                (char*) offsetof(STATUS_VAR, filesort_scan_count), SHOW_LONGLONG_STATUS},
@@ -6734,7 +6855,7 @@ static int mysql_init_variables(void)
   my_atomic_rwlock_init(&global_query_id_lock);
   my_atomic_rwlock_init(&thread_running_lock);
   strmov(server_version, MYSQL_SERVER_VERSION);
-  global_thread_list= new std::set<THD*>;
+  init_global_thread_list();
   key_caches.empty();
   if (!(dflt_key_cache= get_or_create_key_cache(default_key_cache_base.str,
                                                 default_key_cache_base.length)))
@@ -7797,6 +7918,7 @@ void refresh_status(THD *thd)
 
   /* Reset the counters of all key caches (default and named). */
   process_key_caches(reset_key_cache_counters);
+  query_cache.reset_counters();
   flush_status_time= time((time_t*) 0);
   mysql_mutex_unlock(&LOCK_status);
 
@@ -7847,6 +7969,7 @@ PSI_mutex_key
   key_LOCK_slave_net_timeout,
   key_LOCK_system_variables_hash, key_LOCK_table_share, key_LOCK_thd_data,
   key_LOCK_user_conn, key_LOCK_uuid_generator, key_LOG_LOCK_log,
+  key_LOG_LOCK_buffer,
   key_master_info_data_lock, key_master_info_run_lock,
   key_master_info_sleep_lock, key_master_info_thd_lock,
   key_mutex_slave_reporting_capability_err_lock, key_relay_log_info_data_lock,
@@ -7857,7 +7980,7 @@ PSI_mutex_key
   key_structure_guard_mutex, key_TABLE_SHARE_LOCK_ha_data,
   key_LOCK_error_messages, key_LOG_INFO_lock, key_LOCK_thread_count,
   key_LOCK_log_throttle_qni, key_LOCK_query_plan;
-PSI_mutex_key key_LOCK_thread_remove;
+PSI_mutex_key key_LOCK_thd_list;
 PSI_mutex_key key_RELAYLOG_LOCK_commit;
 PSI_mutex_key key_RELAYLOG_LOCK_commit_queue;
 PSI_mutex_key key_RELAYLOG_LOCK_done;
@@ -7921,6 +8044,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_uuid_generator, "LOCK_uuid_generator", PSI_FLAG_GLOBAL},
   { &key_LOCK_sql_rand, "LOCK_sql_rand", PSI_FLAG_GLOBAL},
   { &key_LOG_LOCK_log, "LOG::LOCK_log", 0},
+  { &key_LOG_LOCK_buffer, "File_query_log::LOCK_buffer", 0},
   { &key_master_info_data_lock, "Master_info::data_lock", 0},
   { &key_master_info_run_lock, "Master_info::run_lock", 0},
   { &key_master_info_sleep_lock, "Master_info::sleep_lock", 0},
@@ -7939,7 +8063,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_error_messages, "LOCK_error_messages", PSI_FLAG_GLOBAL},
   { &key_LOG_INFO_lock, "LOG_INFO::lock", 0},
   { &key_LOCK_thread_count, "LOCK_thread_count", PSI_FLAG_GLOBAL},
-  { &key_LOCK_thread_remove, "LOCK_thread_remove", PSI_FLAG_GLOBAL},
+  { &key_LOCK_thd_list, "LOCK_thd_list", 0},
   { &key_LOCK_log_throttle_qni, "LOCK_log_throttle_qni", PSI_FLAG_GLOBAL},
   { &key_gtid_ensure_index_mutex, "Gtid_state", PSI_FLAG_GLOBAL},
   { &key_LOCK_thread_created, "LOCK_thread_created", PSI_FLAG_GLOBAL },
@@ -7981,7 +8105,8 @@ PSI_cond_key key_BINLOG_update_cond,
   key_relay_log_info_sleep_cond, key_cond_slave_parallel_pend_jobs,
   key_cond_slave_parallel_worker,
   key_TABLE_SHARE_cond, key_user_level_lock_cond,
-  key_COND_thread_count, key_COND_thread_cache, key_COND_flush_thread_cache;
+  key_COND_thread_count, key_COND_thread_cache, key_COND_flush_thread_cache,
+  key_COND_thd_list, key_LOG_COND_buffer_data, key_LOG_COND_buffer_space;
 PSI_cond_key key_RELAYLOG_update_cond;
 PSI_cond_key key_BINLOG_COND_done;
 PSI_cond_key key_RELAYLOG_COND_done;
@@ -8023,13 +8148,17 @@ static PSI_cond_info all_server_conds[]=
   { &key_TABLE_SHARE_cond, "TABLE_SHARE::cond", 0},
   { &key_user_level_lock_cond, "User_level_lock::cond", 0},
   { &key_COND_thread_count, "COND_thread_count", PSI_FLAG_GLOBAL},
+  { &key_COND_thd_list, "COND_thd_list", 0},
   { &key_COND_thread_cache, "COND_thread_cache", PSI_FLAG_GLOBAL},
   { &key_COND_flush_thread_cache, "COND_flush_thread_cache", PSI_FLAG_GLOBAL},
+  { &key_LOG_COND_buffer_data, "File_query_log::COND_buffer_data", 0},
+  { &key_LOG_COND_buffer_space, "File_query_log::COND_buffer_space", 0},
   { &key_gtid_ensure_index_cond, "Gtid_state", PSI_FLAG_GLOBAL}
 };
 
 PSI_thread_key key_thread_bootstrap, key_thread_handle_manager, key_thread_main,
-  key_thread_one_connection, key_thread_signal_hand;
+  key_thread_one_connection, key_thread_signal_hand,
+  key_thread_query_log_writer;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -8047,7 +8176,8 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_handle_manager, "manager", PSI_FLAG_GLOBAL},
   { &key_thread_main, "main", PSI_FLAG_GLOBAL},
   { &key_thread_one_connection, "one_connection", 0},
-  { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL}
+  { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
+  { &key_thread_query_log_writer, "query_log_writer", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -8341,6 +8471,7 @@ PSI_memory_key key_memory_sql_select_test_quick_select_exec;
 PSI_memory_key key_memory_prune_partitions_exec;
 PSI_memory_key key_memory_binlog_recover_exec;
 PSI_memory_key key_memory_blob_mem_storage;
+PSI_memory_key key_memory_sj_tmp_table_rowid_root;
 PSI_memory_key key_memory_NAMED_ILINK_name;
 PSI_memory_key key_memory_Sys_var_charptr_value;
 PSI_memory_key key_memory_queue_item;
@@ -8403,6 +8534,9 @@ PSI_memory_key key_memory_TABLE_sort_io_cache;
 PSI_memory_key key_memory_frm;
 PSI_memory_key key_memory_Unique_sort_buffer;
 PSI_memory_key key_memory_Unique_merge_buffer;
+PSI_memory_key key_memory_Unique_hash;
+PSI_memory_key key_memory_Item_func_group_concat_sort_keys;
+PSI_memory_key key_memory_QEP_tmp_table_group_root;
 PSI_memory_key key_memory_TABLE;
 PSI_memory_key key_memory_frm_extra_segment_buff;
 PSI_memory_key key_memory_frm_form_pos;
@@ -8433,6 +8567,7 @@ PSI_memory_key key_memory_Query_cache;
 PSI_memory_key key_memory_READ_RECORD_cache;
 PSI_memory_key key_memory_Quick_ranges;
 PSI_memory_key key_memory_File_query_log_name;
+PSI_memory_key key_memory_File_query_log_buffer;
 PSI_memory_key key_memory_Table_trigger_dispatcher;
 
 #ifdef HAVE_PSI_INTERFACE
@@ -8467,6 +8602,7 @@ static PSI_memory_info all_server_memory[]=
   { &key_memory_prune_partitions_exec, "prune_partitions::exec", 0},
   { &key_memory_binlog_recover_exec, "MYSQL_BIN_LOG::recover", 0},
   { &key_memory_blob_mem_storage, "Blob_mem_storage::storage", 0},
+  { &key_memory_sj_tmp_table_rowid_root, "SJ_TMP_TABLE::rowid_root", PSI_FLAG_THREAD},
 
   { &key_memory_NAMED_ILINK_name, "NAMED_ILINK::name", 0},
   { &key_memory_String_value, "String::value", 0},
@@ -8543,6 +8679,9 @@ static PSI_memory_info all_server_memory[]=
   { &key_memory_frm, "frm", 0},
   { &key_memory_Unique_sort_buffer, "Unique::sort_buffer", 0},
   { &key_memory_Unique_merge_buffer, "Unique::merge_buffer", 0},
+  { &key_memory_Unique_hash, "Unique::hash", 0},
+  { &key_memory_Item_func_group_concat_sort_keys, "Item_func_group_concat::sort_keys", 0},
+  { &key_memory_QEP_tmp_table_group_root, "QEP_tmp_table::group_root", PSI_FLAG_THREAD},
   { &key_memory_TABLE, "TABLE", 0},
   { &key_memory_frm_extra_segment_buff, "frm::extra_segment_buff", 0},
   { &key_memory_frm_form_pos, "frm::form_pos", 0},
@@ -8571,6 +8710,7 @@ static PSI_memory_info all_server_memory[]=
   { &key_memory_READ_RECORD_cache, "READ_RECORD_cache", 0},
   { &key_memory_Quick_ranges, "Quick_ranges", 0},
   { &key_memory_File_query_log_name, "File_query_log::name", 0},
+  { &key_memory_File_query_log_buffer, "File_query_log::buffer", 0},
   { &key_memory_Table_trigger_dispatcher, "Table_trigger_dispatcher::m_mem_root", 0}
 };
 
@@ -92,8 +92,14 @@ extern void query_cache_insert(const char *packet, ulong length,
 
 #define VIO_SOCKET_ERROR  ((size_t) -1)
 #define MAX_PACKET_LENGTH (256L*256L*256L-1)
+/*
+  Longest packet compressed with a stream: the compressed packet is always
+  sent, and its length must fit in 3 bytes (see my_compress_stream_bound())
+*/
+#define MAX_STREAM_PACKET_LENGTH (MAX_PACKET_LENGTH / 257 * 256 - 128)
 
 static my_bool net_write_buff(NET *, const uchar *, ulong);
+static my_bool net_write_direct(NET *, const uchar *, size_t);
 
 /** Init with packet info. */
 
@@ -115,7 +121,7 @@ my_bool my_net_init(NET *net, Vio* vio)
   net->compress=0; net->reading_or_writing=0;
   net->where_b = net->remain_in_buf=0;
   net->last_errno=0;
-  net->unused= 0;
+  net->compress_stream= 0;
 #ifdef MYSQL_SERVER
   net->extension= NULL;
 #endif
@@ -135,10 +141,44 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff);
   net->buff=0;
+#ifdef HAVE_COMPRESS
+  if (net->compress_stream)
+    my_compress_stream_end((MY_COMPRESS_STREAM *) net->compress_stream);
+#endif
+  net->compress_stream= 0;
   DBUG_VOID_RETURN;
 }
 
 
+/**
+  Compress the packets of the connection with one stream in each
+  direction, instead of each packet on its own.
+
+  Compression itself starts when net->compress is set. Both peers must
+  switch to streams at the same packet, which is why this is negotiated
+  at connect time with CLIENT_COMPRESS_STREAM.
+
+  @param  net     NET handler.
+  @param  level   Compression level of the packets written, 0 for the
+                  default level.
+
+  @return TRUE on error (out of memory), FALSE on success.
+*/
+
+my_bool net_compress_stream_init(NET *net, uint level)
+{
+  DBUG_ENTER("net_compress_stream_init");
+#ifdef HAVE_COMPRESS
+  if (net->compress_stream)
+    DBUG_RETURN(FALSE);
+  net->compress_stream= (void *) my_compress_stream_init(level);
+  DBUG_RETURN(net->compress_stream == NULL);
+#else
+  DBUG_RETURN(TRUE);
+#endif
+}
+
+
 /** Realloc the packet buffer. */
 
 my_bool net_realloc(NET *net, size_t length)
@@ -281,6 +321,19 @@ my_bool my_net_write(NET *net, const uchar *packet, size_t len)
 
   MYSQL_NET_WRITE_START(len);
 
+  /*
+    A packet that does not fit in the buffer is sent from where it is,
+    after the data already buffered, instead of being copied through the
+    buffer. The buffer is only used to coalesce small packets.
+  */
+  if (!net->compress &&
+      len + NET_HEADER_SIZE > (size_t) (net->buff_end - net->write_pos))
+  {
+    rc= test(net_write_direct(net, packet, len));
+    MYSQL_NET_WRITE_DONE(rc);
+    return rc;
+  }
+
   /*
     Big packets are handled by splitting them in packets of MAX_PACKET_LENGTH
     length. The last packet is always a packet that is < MAX_PACKET_LENGTH.
@@ -348,16 +401,40 @@ my_bool
 net_write_command(NET *net,uchar command,
       const uchar *header, size_t head_len,
       const uchar *packet, size_t len)
+{
+  int rc;
+  DBUG_ENTER("net_write_command");
+
+  MYSQL_NET_WRITE_START(len+1+head_len);
+  rc= test(net_queue_command(net, command, header, head_len, packet, len) ||
+           net_flush(net));
+  MYSQL_NET_WRITE_DONE(rc);
+  DBUG_RETURN(rc);
+}
+
+
+/**
+  Put a command in the write buffer like net_write_command(), without
+  flushing the buffer. The command is sent with the next net_flush(), or
+  when the buffer is full.
+
+  @retval
+    0	ok
+  @retval
+    1	error
+*/
+
+my_bool
+net_queue_command(NET *net, uchar command,
+                  const uchar *header, size_t head_len,
+                  const uchar *packet, size_t len)
 {
   size_t length=len+1+head_len;			/* 1 extra byte for command */
   uchar buff[NET_HEADER_SIZE+1];
   uint header_size=NET_HEADER_SIZE+1;
-  int rc;
-  DBUG_ENTER("net_write_command");
+  DBUG_ENTER("net_queue_command");
   DBUG_PRINT("enter",("length: %lu", (ulong) len));
 
-  MYSQL_NET_WRITE_START(length);
-
   buff[4]=command;				/* For first packet */
 
   if (length >= MAX_PACKET_LENGTH)
@@ -371,10 +448,7 @@ net_write_command(NET *net,uchar command,
       if (net_write_buff(net, buff, header_size) ||
           net_write_buff(net, header, head_len) ||
           net_write_buff(net, packet, len))
-      {
-        MYSQL_NET_WRITE_DONE(1);
         DBUG_RETURN(1);
-      }
       packet+= len;
       length-= MAX_PACKET_LENGTH;
       len= MAX_PACKET_LENGTH;
@@ -385,11 +459,9 @@ net_write_command(NET *net,uchar command,
   }
   int3store(buff,length);
   buff[3]= (uchar) net->pkt_nr++;
-  rc= test(net_write_buff(net, buff, header_size) ||
-           (head_len && net_write_buff(net, header, head_len)) ||
-           net_write_buff(net, packet, len) || net_flush(net));
-  MYSQL_NET_WRITE_DONE(rc);
-  DBUG_RETURN(rc);
+  DBUG_RETURN(test(net_write_buff(net, buff, header_size) ||
+                   (head_len && net_write_buff(net, header, head_len)) ||
+                   net_write_buff(net, packet, len)));
 }
 
 
@@ -423,8 +495,10 @@ static my_bool
 net_write_buff(NET *net, const uchar *packet, ulong len)
 {
   ulong left_length;
-  if (net->compress && net->max_packet > MAX_PACKET_LENGTH)
-    left_length= (ulong) (MAX_PACKET_LENGTH - (net->write_pos - net->buff));
+  const ulong max_length= net->compress_stream ? MAX_STREAM_PACKET_LENGTH :
+                                                 MAX_PACKET_LENGTH;
+  if (net->compress && net->max_packet > max_length)
+    left_length= (ulong) (max_length - (net->write_pos - net->buff));
   else
     left_length= (ulong) (net->buff_end - net->write_pos);
 
@@ -450,7 +524,7 @@ net_write_buff(NET *net, const uchar *packet, ulong len)
         We can't have bigger packets than 16M with compression
         Because the uncompressed length is stored in 3 bytes
       */
-      left_length= MAX_PACKET_LENGTH;
+      left_length= max_length;
       while (len > left_length)
       {
         if (net_write_packet(net, packet, left_length))
@@ -524,6 +598,132 @@ net_write_raw_loop(NET *net, const uchar *buf, size_t count)
 }
 
 
+/**
+  Write a scatter list of data to a network handler.
+
+  @param  net     NET handler.
+  @param  iov     The parts of the data, modified to skip what is written.
+  @param  count   Number of parts.
+
+  @return TRUE on error, FALSE on success.
+*/
+
+static my_bool
+net_write_raw_loop_iov(NET *net, struct st_vio_iovec *iov, uint count)
+{
+  unsigned int retry_count= 0;
+
+  while (count)
+  {
+    size_t sentcnt= vio_writev(net->vio, iov, count);
+
+    /* VIO_SOCKET_ERROR (-1) indicates an error. */
+    if (sentcnt == VIO_SOCKET_ERROR)
+    {
+      /* A recoverable I/O error occurred? */
+      if (net_should_retry(net, &retry_count))
+        continue;
+      else
+        break;
+    }
+
+    update_statistics(thd_increment_bytes_sent(sentcnt));
+
+    /* Skip the parts that were written entirely */
+    while (count && sentcnt >= iov->length)
+    {
+      sentcnt-= iov->length;
+      iov++;
+      count--;
+    }
+    if (count)
+    {
+      iov->base+= sentcnt;
+      iov->length-= sentcnt;
+    }
+  }
+
+  /* On failure, propagate the error code. */
+  if (count)
+  {
+    /* Socket should be closed. */
+    net->error= 2;
+
+    /* Interrupted by a timeout? */
+    if (vio_was_timeout(net->vio))
+      net->last_errno= ER_NET_WRITE_INTERRUPTED;
+    else
+      net->last_errno= ER_NET_ERROR_ON_WRITE;
+
+#ifdef MYSQL_SERVER
+    my_error(net->last_errno, MYF(0));
+#endif
+  }
+
+  return test(count);
+}
+
+
+/**
+  Compress a packet with the compression stream of the connection, and
+  encapsulate it into a compressed packet.
+
+  Unlike with compress_packet(), packets are sent compressed even if they
+  got longer, as the peer must uncompress everything that went through the
+  stream. Only packets shorter than MIN_COMPRESS_LENGTH are sent as they
+  are, without going through it.
+
+  @param          net      NET handler.
+  @param          packet   The packet to compress.
+  @param[in,out]  length   Length of the packet.
+
+  @return Pointer to the (new) compressed packet.
+*/
+
+static uchar *
+compress_packet_stream(NET *net, const uchar *packet, size_t *length)
+{
+  uchar *compr_packet;
+  size_t compr_length= 0;
+  const uint header_length= NET_HEADER_SIZE + COMP_HEADER_SIZE;
+  const bool do_compress= *length >= MIN_COMPRESS_LENGTH;
+  size_t buff_length= do_compress ? my_compress_stream_bound(*length) :
+                                    *length;
+
+  compr_packet= (uchar *) my_malloc(key_memory_NET_compress_packet,
+                                    buff_length + header_length, MYF(MY_WME));
+
+  if (compr_packet == NULL)
+    return NULL;
+
+  if (do_compress)
+  {
+    if (my_compress_stream((MY_COMPRESS_STREAM *) net->compress_stream,
+                           packet, *length, compr_packet + header_length,
+                           &buff_length))
+    {
+      my_free(compr_packet);
+      return NULL;
+    }
+    compr_length= *length;
+    *length= buff_length;
+  }
+  else
+    memcpy(compr_packet + header_length, packet, *length);
+
+  /* Length of the compressed (original) packet. */
+  int3store(&compr_packet[NET_HEADER_SIZE], compr_length);
+  /* Length of this packet. */
+  int3store(compr_packet, *length);
+  /* Packet number. */
+  compr_packet[3]= (uchar) (net->compress_pkt_nr++);
+
+  *length+= header_length;
+
+  return compr_packet;
+}
+
+
 /**
   Compress and encapsulate a packet into a compressed packet.
 
@@ -545,6 +745,9 @@ compress_packet(NET *net, const uchar *packet, size_t *length)
   size_t compr_length;
   const uint header_length= NET_HEADER_SIZE + COMP_HEADER_SIZE;
 
+  if (net->compress_stream)
+    return compress_packet_stream(net, packet, length);
+
   compr_packet= (uchar *) my_malloc(key_memory_NET_compress_packet,
                                     *length + header_length, MYF(MY_WME));
 
@@ -635,6 +838,108 @@ net_write_packet(NET *net, const uchar *packet, size_t length)
   DBUG_RETURN(res);
 }
 
+
+/**
+  Write data already framed in MySQL protocol packets, given as a scatter
+  list, to the network handler.
+
+  @param  net     NET handler.
+  @param  iov     The parts of the data.
+  @param  count   Number of parts.
+
+  @remark Only used without compression.
+
+  @return TRUE on error, FALSE on success.
+*/
+
+static my_bool
+net_write_packet_iov(NET *net, struct st_vio_iovec *iov, uint count)
+{
+  my_bool res;
+  DBUG_ENTER("net_write_packet_iov");
+  DBUG_ASSERT(!net->compress);
+
+#if defined(MYSQL_SERVER)
+  for (uint i= 0; i < count; i++)
+    query_cache_insert((char*) iov[i].base, iov[i].length, net->pkt_nr);
+#endif
+
+  /* Socket can't be used */
+  if (net->error == 2)
+    DBUG_RETURN(TRUE);
+
+  net->reading_or_writing= 2;
+
+#ifdef DEBUG_DATA_PACKETS
+  for (uint i= 0; i < count; i++)
+    DBUG_DUMP("data", iov[i].base, iov[i].length);
+#endif
+
+  res= net_write_raw_loop_iov(net, iov, count);
+
+  net->reading_or_writing= 0;
+
+  DBUG_RETURN(res);
+}
+
+
+/**
+  Write a logical packet, and the data buffered before it, without copying
+  the packet to the buffer.
+
+  The packet headers are framed separately and handed to the network
+  handler in a scatter list with the parts of the packet.
+
+  @param  net     NET handler.
+  @param  packet  The packet to write.
+  @param  len     Length of the packet.
+
+  @return TRUE on error, FALSE on success.
+*/
+
+static my_bool
+net_write_direct(NET *net, const uchar *packet, size_t len)
+{
+  struct st_vio_iovec iov[VIO_IOVEC_MAX];
+  uchar headers[VIO_IOVEC_MAX / 2][NET_HEADER_SIZE];
+  uint count= 0, header_count= 0;
+  my_bool done;
+
+  if (net->write_pos != net->buff)
+  {
+    iov[0].base= net->buff;
+    iov[0].length= (size_t) (net->write_pos - net->buff);
+    count= 1;
+    net->write_pos= net->buff;
+  }
+
+  do
+  {
+    /* The last packet is always shorter than MAX_PACKET_LENGTH */
+    const size_t z_size= MY_MIN(len, (size_t) MAX_PACKET_LENGTH);
+    uchar *header= headers[header_count++];
+
+    int3store(header, z_size);
+    header[3]= (uchar) net->pkt_nr++;
+    iov[count].base= header;
+    iov[count++].length= NET_HEADER_SIZE;
+    iov[count].base= packet;
+    iov[count++].length= z_size;
+    packet+= z_size;
+    len-= z_size;
+    done= z_size < MAX_PACKET_LENGTH;
+
+    if (done || count + 2 > VIO_IOVEC_MAX)
+    {
+      if (net_write_packet_iov(net, iov, count))
+        return TRUE;
+      count= header_count= 0;
+    }
+  } while (!done);
+
+  return FALSE;
+}
+
 /*****************************************************************************
 ** Read something from server/clinet
 *****************************************************************************/
@@ -989,8 +1294,11 @@ my_net_read(NET *net)
         MYSQL_NET_READ_DONE(1, 0);
         return packet_error;
       }
-      if (my_uncompress(net->buff + net->where_b, packet_len,
-                        &complen))
+      if (net->compress_stream ?
+          my_uncompress_stream((MY_COMPRESS_STREAM *) net->compress_stream,
+                               net->buff + net->where_b, packet_len,
+                               &complen) :
+          my_uncompress(net->buff + net->where_b, packet_len, &complen))
       {
         net->error= 2;			/* caller will close socket */
         net->last_errno= ER_NET_UNCOMPRESS_ERROR;
@@ -25,7 +25,7 @@
 #include "sql_base.h"      // lock_tables
 #include "sql_union.h"     // mysql_union_prepare_and_optimize
 #include "sql_acl.h"       // check_global_access, PROCESS_ACL
-#include "global_threads.h"  // LOCK_thread_count
+#include "global_threads.h"  // find_thd
 #include "debug_sync.h"    // DEBUG_SYNC
 #include "opt_trace.h"     // Opt_trace_*
 #include "sql_parse.h"     // is_explainable_query
@@ -393,6 +393,7 @@ private:
   bool end_simple_sort_context(Explain_sort_clause clause,
                                enum_parsing_context ctx);
   bool explain_join_tab(size_t tab_num);
+  bool explain_analyzed_tmp_tables_and_sorts();
 
 protected:
   virtual bool shallow_explain();
@@ -827,12 +828,15 @@ bool Explain_union_result::explain_join_type()
 
 bool Explain_union_result::explain_extra()
 {
-  if (!fmt->is_hierarchical())
+  /*
+    The temporary table is always used, unless the rows are streamed
+  */
+  const bool using_temporary= !select_lex->master_unit()->is_union_streamed();
+  if (fmt->is_hierarchical())
+    fmt->entry()->using_temporary= using_temporary;
+  else
   {
-    /*
-     Currently we always use temporary table for UNION result
-    */
-    if (push_extra(ET_USING_TEMPORARY))
+    if (using_temporary && push_extra(ET_USING_TEMPORARY))
       return true;
     /*
       here we assume that the query will return at least two rows, so we
@@ -1462,13 +1466,28 @@ bool Explain_join::explain_rows_and_filtered()
   fmt->entry()->col_rows.set(static_cast<ulonglong>(examined_rows));
 
   /* Add "filtered" field */
-  if (describe(DESCRIBE_EXTENDED))
+  if (describe(DESCRIBE_EXTENDED | DESCRIBE_ANALYZE))
   {
     float f= 0.0;
     if (examined_rows)
       f= 100.0 * tab->position->records_read / examined_rows;
     fmt->entry()->col_filtered.set(f);
   }
+
+  /* Add what EXPLAIN ANALYZE measured, const tables were read before */
+  if (join->analyzing && tabnum >= join->const_tables)
+  {
+    const Join_tab_stats *stats= &tab->analyze_stats;
+    fmt->entry()->col_r_loops.set(stats->loops);
+    if (stats->loops)
+      fmt->entry()->col_r_rows.set(ulonglong2double(stats->rows_read) /
+                                   stats->loops);
+    if (stats->rows_read)
+      fmt->entry()->col_r_filtered.set(100.0 * stats->rows_matched /
+                                       stats->rows_read);
+    fmt->entry()->col_r_engine_time.set(stats->read_time / 1000000.0);
+    fmt->entry()->col_r_cond_time.set(stats->cond_time / 1000000.0);
+  }
   // Print cost-related info
   double prefix_rows= tab->position->prefix_record_count;
   fmt->entry()->col_prefix_rows.set(static_cast<ulonglong>(prefix_rows));
@@ -1590,6 +1609,11 @@ bool Explain_join::explain_extra()
         if (push_extra(ET_USING_INDEX_FOR_GROUP_BY, buff))
           return true;
       }
+      else if (quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
+      {
+        if (push_extra(ET_USING_INDEX_FOR_SKIP_SCAN))
+          return true;
+      }
       else
       {
         if (push_extra(ET_USING_INDEX))
@@ -1656,6 +1680,8 @@ bool Explain_join::explain_extra()
       StringBuffer<64> buff(cs);
       if ((tab->use_join_cache & JOIN_CACHE::ALG_BNL))
         buff.append("Block Nested Loop");
+      else if ((tab->use_join_cache & JOIN_CACHE::ALG_HASH))
+        buff.append("Hash Join");
       else if ((tab->use_join_cache & JOIN_CACHE::ALG_BKA))
         buff.append("Batched Key Access");
       else if ((tab->use_join_cache & JOIN_CACHE::ALG_BKA_UNIQUE))
@@ -1666,6 +1692,9 @@ bool Explain_join::explain_extra()
         return true;
     }
   }
+  if (join->analyzing && tabnum == join->const_tables &&
+      explain_analyzed_tmp_tables_and_sorts())
+    return true;
   if (fmt->is_hierarchical() &&
       (!bitmap_is_clear_all(table->read_set) ||
        !bitmap_is_clear_all(table->write_set)))
@@ -1683,6 +1712,39 @@ bool Explain_join::explain_extra()
 }
 
 
+/**
+  Add the temporary tables of the join which ended on disk and the merge
+  passes of its filesorts to "extra", for EXPLAIN ANALYZE
+
+  They are shown with the first non-const table, like "Using temporary"
+  and "Using filesort".
+*/
+
+bool Explain_join::explain_analyzed_tmp_tables_and_sorts()
+{
+  bool tmp_table_on_disk= false;
+  ulonglong merge_passes= 0;
+  for (uint i= 0; i < join->tables; i++)
+  {
+    const JOIN_TAB *t= join->join_tab + i;
+    merge_passes+= t->analyze_stats.sort_merge_passes;
+    if (i >= join->primary_tables && t->table && t->table->is_created() &&
+        t->table->s->db_type() != heap_hton)
+      tmp_table_on_disk= true;
+  }
+  if (tmp_table_on_disk && push_extra(ET_TMP_TABLE_ON_DISK))
+    return true;
+  if (merge_passes)
+  {
+    StringBuffer<32> buff(cs);
+    if (buff.append_ulonglong(merge_passes) ||
+        push_extra(ET_FILESORT_MERGE_PASSES, buff))
+      return true;
+  }
+  return false;
+}
+
+
 /* Explain_table class functions **********************************************/
 
 bool Explain_table::explain_modify_flags()
@@ -2088,6 +2150,35 @@ explain_query_specification(THD *ethd, SELECT_LEX *select_lex,
 }
 
 
+/**
+  Execute the query of EXPLAIN ANALYZE
+
+  The query is prepared, optimized and executed like a SELECT, with its
+  rows going to a select_discard result. The joins measure their execution
+  in JOIN_TAB::analyze_stats (see JOIN::analyzing), and they keep their
+  plans after the execution since lex->describe is set (see
+  JOIN::join_free()), so they can be explained next.
+
+  @param thd   THD of the query
+  @param unit  query to execute
+
+  @return false if success, true if error
+*/
+
+static bool explain_analyze_execute(THD *thd, SELECT_LEX_UNIT *unit)
+{
+  select_discard *result= new select_discard;
+  if (result == NULL)
+    return true;                                /* purecov: inspected */
+  if (mysql_union_prepare_and_optimize(thd, thd->lex, result, unit, 0))
+    return true;
+  if (unit->is_union() || unit->fake_select_lex)
+    return unit->exec();
+  unit->first_select()->join->exec();
+  return thd->is_error();
+}
+
+
 /**
   EXPLAIN handling for SELECT, INSERT/REPLACE SELECT, and multi-table
   UPDATE/DELETE queries
@@ -2136,7 +2227,12 @@ bool explain_query(THD *ethd, SELECT_LEX_UNIT *unit, select_result *result)
   const THD *query_thd= unit->thd; // THD of query to be explained
   bool res= false;
   bool const other= (ethd != query_thd);
-  if (!other)
+  if (!other && (ethd->lex->describe & DESCRIBE_ANALYZE))
+  {
+    res= explain_analyze_execute(ethd, unit);
+    mysql_mutex_lock(&ethd->LOCK_query_plan);
+  }
+  else if (!other)
   {
     res= mysql_union_prepare_and_optimize(ethd, ethd->lex, result, unit,
                                           SELECT_DESCRIBE);
@@ -2212,6 +2308,27 @@ bool mysql_explain_unit(THD *ethd, SELECT_LEX_UNIT *unit, select_result *result)
 }
 
 
+/**
+  Find the thread with a given id, and lock its THD::LOCK_thd_data and
+  THD::LOCK_query_plan.
+*/
+class Find_thd_query_plan : public Find_THD_Impl
+{
+public:
+  Find_thd_query_plan(my_thread_id id) : m_id(id) {}
+  virtual bool operator()(THD *thd)
+  {
+    if (thd->thread_id != m_id)
+      return false;
+    mysql_mutex_lock(&thd->LOCK_thd_data);
+    mysql_mutex_lock(&thd->LOCK_query_plan);
+    return true;
+  }
+private:
+  my_thread_id m_id;
+};
+
+
 /**
    Entry point for EXPLAIN CONNECTION: locates the connection by its ID, takes
    proper locks, explains its current statement, releases locks.
@@ -2252,21 +2369,9 @@ void mysql_explain_other(THD *thd)
   // Pick thread
   if (!thd->killed)
   {
-    mysql_mutex_lock(&LOCK_thread_count);
-    Thread_iterator it= global_thread_list_begin();
-    Thread_iterator end= global_thread_list_end();
-    for (; it != end; ++it)
-    {
-      THD *tmp= *it;
-      if (tmp->thread_id != thd->lex->query_id)
-        continue;
-      query_thd= tmp;
-      unlock_thd_data= true;
-      mysql_mutex_lock(&tmp->LOCK_thd_data);
-      mysql_mutex_lock(&tmp->LOCK_query_plan);
-      break;
-    }
-    mysql_mutex_unlock(&LOCK_thread_count);
+    Find_thd_query_plan find_thd_query_plan(thd->lex->query_id);
+    query_thd= find_thd(&find_thd_query_plan);
+    unlock_thd_data= query_thd != NULL;
   }
 
   if (!query_thd)
@@ -50,6 +50,7 @@ enum Extra_tag
   ET_OPEN_FULL_TABLE,
   ET_SCANNED_DATABASES,
   ET_USING_INDEX_FOR_GROUP_BY,
+  ET_USING_INDEX_FOR_SKIP_SCAN,
   ET_DISTINCT,
   ET_LOOSESCAN,
   ET_START_TEMPORARY,
@@ -64,6 +65,8 @@ enum Extra_tag
   ET_UNIQUE_ROW_NOT_FOUND,
   ET_IMPOSSIBLE_ON_CONDITION,
   ET_PUSHED_JOIN,
+  ET_TMP_TABLE_ON_DISK,
+  ET_FILESORT_MERGE_PASSES,
   //------------------------------------
   ET_total
 };
@@ -324,6 +327,13 @@ public:
   /// List of used columns
   List<const char> col_used_columns;
 
+  /* EXPLAIN ANALYZE: the measured execution, see Join_tab_stats */
+  column<ulonglong> col_r_loops; ///< "r_loops": number of scans of the table
+  column<double> col_r_rows; ///< "r_rows": rows read per scan
+  column<float> col_r_filtered; ///< "r_filtered": % of rows read that matched
+  column<double> col_r_engine_time; ///< Milliseconds of reading the rows
+  column<double> col_r_cond_time; ///< Milliseconds of evaluating conditions
+
   /* For structured EXPLAIN in CTX_JOIN_TAB context: */
   uint query_block_id; ///< query block id for materialized subqueries
 
@@ -376,6 +386,12 @@ public:
 
     col_data_size_query.cleanup();
 
+    col_r_loops.cleanup();
+    col_r_rows.cleanup();
+    col_r_filtered.cleanup();
+    col_r_engine_time.cleanup();
+    col_r_cond_time.cleanup();
+
     /*
       Not needed (we call cleanup() for structured EXPLAIN only,
       just for the consistency).
@@ -40,6 +40,7 @@ static const char *json_extra_tags[ET_total]=
   "open_full_table",                    // ET_OPEN_FULL_TABLE
   "scanned_databases",                  // ET_SCANNED_DATABASES
   "using_index_for_group_by",           // ET_USING_INDEX_FOR_GROUP_BY
+  "using_index_for_skip_scan",          // ET_USING_INDEX_FOR_SKIP_SCAN
   "distinct",                           // ET_DISTINCT
   "loosescan",                          // ET_LOOSESCAN
   NULL,                                 // ET_START_TEMPORARY
@@ -53,7 +54,9 @@ static const char *json_extra_tags[ET_total]=
   "const_row_not_found",                // ET_CONST_ROW_NOT_FOUND
   "unique_row_not_found",               // ET_UNIQUE_ROW_NOT_FOUND
   "impossible_on_condition",            // ET_IMPOSSIBLE_ON_CONDITION
-  "pushed_join"                         // ET_PUSHED_JOIN
+  "pushed_join",                        // ET_PUSHED_JOIN
+  "r_temporary_table_on_disk",          // ET_TMP_TABLE_ON_DISK
+  "r_filesort_merge_passes"             // ET_FILESORT_MERGE_PASSES
 };
 
 
@@ -104,6 +107,12 @@ static const char K_QUERY_COST[]=                   "query_cost";
 static const char K_DATA_SIZE_QUERY[]=              "data_read_per_join";
 static const char K_USED_COLUMNS[]=                 "used_columns";
 
+static const char K_R_LOOPS[]=                      "r_loops";
+static const char K_R_ROWS[]=                       "r_rows_examined_per_scan";
+static const char K_R_FILTERED[]=                   "r_filtered";
+static const char K_R_ENGINE_TIME[]=                "r_engine_time_ms";
+static const char K_R_COND_TIME[]=                  "r_condition_time_ms";
+
 static const char *mod_type_name[]=
 {
   "", "insert", "update", "delete", "replace"
@@ -624,6 +633,30 @@ bool table_base_ctx::format_body(Opt_trace_context *json, Opt_trace_object *obj)
   if (!col_filtered.is_empty())
     obj->add(K_FILTERED, col_filtered.value);
 
+  if (!col_r_loops.is_empty())
+  {
+    char buf[32];                         // 32 is enough for digits of a double
+
+    obj->add(K_R_LOOPS, col_r_loops.value);
+    if (!col_r_rows.is_empty())
+    {
+      print_cost(buf, sizeof(buf), col_r_rows.value);
+      obj->add_utf8(K_R_ROWS, buf);
+    }
+    if (!col_r_filtered.is_empty())
+      obj->add(K_R_FILTERED, col_r_filtered.value);
+    if (!col_r_engine_time.is_empty())
+    {
+      print_cost(buf, sizeof(buf), col_r_engine_time.value);
+      obj->add_utf8(K_R_ENGINE_TIME, buf);
+    }
+    if (!col_r_cond_time.is_empty())
+    {
+      print_cost(buf, sizeof(buf), col_r_cond_time.value);
+      obj->add_utf8(K_R_COND_TIME, buf);
+    }
+  }
+
   if (!col_extra.is_empty())
   {
     List_iterator<qep_row::extra> it(col_extra);
@@ -1335,7 +1368,7 @@ bool join_ctx::format_nested_loop(Opt_trace_context *json)
 bool union_result_ctx::format_body(Opt_trace_context *json,
                                    Opt_trace_object *obj)
 {
-  obj->add(K_USING_TMP_TABLE, true);
+  obj->add(K_USING_TMP_TABLE, using_temporary);
 
   if (table_base_ctx::format_body(json, obj))
     return true; /* purecov: inspected */
@@ -39,6 +39,7 @@ static const char *traditional_extra_tags[ET_total]=
   "Open_full_table",                   // ET_OPEN_FULL_TABLE
   "Scanned",                           // ET_SCANNED_DATABASES
   "Using index for group-by",          // ET_USING_INDEX_FOR_GROUP_BY
+  "Using index for skip scan",         // ET_USING_INDEX_FOR_SKIP_SCAN
   "Distinct",                          // ET_DISTINCT
   "LooseScan",                         // ET_LOOSESCAN
   "Start temporary",                   // ET_START_TEMPORARY
@@ -52,7 +53,9 @@ static const char *traditional_extra_tags[ET_total]=
   "const row not found",               // ET_CONST_ROW_NOT_FOUND
   "unique row not found",              // ET_UNIQUE_ROW_NOT_FOUND
   "Impossible ON condition",           // ET_IMPOSSIBLE_ON_CONDITION
-  ""                                   // ET_PUSHED_JOIN
+  "",                                  // ET_PUSHED_JOIN
+  "Temporary table on disk",           // ET_TMP_TABLE_ON_DISK
+  "Filesort merge passes:"             // ET_FILESORT_MERGE_PASSES
 };
 
 static const char *mod_type_name[]=
@@ -134,6 +137,16 @@ static bool push(List<Item> *items, const qep_row::column<float> &c,
 }
 
 
+static bool push(List<Item> *items, const qep_row::column<double> &c,
+                 uint decimals, Item_null *nil)
+{
+  if (c.is_empty())
+    return items->push_back(nil);
+  Item_float *item= new Item_float(c.get(), decimals);
+  return item == NULL || items->push_back(item);
+}
+
+
 bool Explain_format_traditional::push_select_type(List<Item> *items)
 {
   DBUG_ASSERT(!column_buffer.col_select_type.is_empty());
@@ -178,10 +191,18 @@ bool Explain_format_traditional::flush_entry()
       push(&items, column_buffer.col_key_len, nil) ||
       push(&items, column_buffer.col_ref, nil) ||
       push(&items, column_buffer.col_rows, nil) ||
-      (current_thd->lex->describe & DESCRIBE_EXTENDED &&
+      (current_thd->lex->describe & (DESCRIBE_EXTENDED | DESCRIBE_ANALYZE) &&
        push(&items, column_buffer.col_filtered, nil)))
     return true;
 
+  if ((current_thd->lex->describe & DESCRIBE_ANALYZE) &&
+      (push(&items, column_buffer.col_r_loops, nil) ||
+       push(&items, column_buffer.col_r_rows, 2, nil) ||
+       push(&items, column_buffer.col_r_filtered, nil) ||
+       push(&items, column_buffer.col_r_engine_time, 3, nil) ||
+       push(&items, column_buffer.col_r_cond_time, 3, nil)))
+    return true;
+
   if (column_buffer.col_message.is_empty() &&
       column_buffer.col_extra.is_empty())
   {
@@ -839,6 +839,25 @@ public:
   */
   bool use_index_statistics;
 
+  /**
+    Number of bytes that range analysis may allocate on mem_root, from
+    range_optimizer_max_mem_size. 0 means no limit.
+  */
+  ulonglong mem_limit;
+  /* mem_root->block_num when the memory use was last computed */
+  uint mem_checked_blocks;
+  /* TRUE if mem_limit has been exceeded; the warning is given once */
+  bool mem_limit_exceeded;
+
+  void init_mem_limit()
+  {
+    mem_limit= thd->variables.range_optimizer_max_mem_size;
+    mem_checked_blocks= 0;
+    mem_limit_exceeded= false;
+  }
+
+  bool has_exceeded_mem_limit();
+
   bool statement_should_be_aborted() const
   {
     return
@@ -881,6 +900,47 @@ public:
   ORDER::enum_order order_direction;
 };
 
+
+/**
+  Check whether range analysis has allocated more memory than allowed by
+  range_optimizer_max_mem_size, warning about it the first time.
+
+  When the limit is exceeded, get_mm_tree() stops adding conditions to
+  the trees: the conjuncts of an AND that are not analyzed yet are left
+  out, which gives bigger ranges than necessary, and an OR whose
+  disjuncts are not all analyzed gives no ranges. The conditions are
+  still evaluated on the rows that are read.
+
+  The memory use is only recomputed when mem_root has allocated a new
+  block since the last call.
+
+  @retval true   The limit is exceeded
+  @retval false  Otherwise
+*/
+
+bool RANGE_OPT_PARAM::has_exceeded_mem_limit()
+{
+  if (mem_limit_exceeded)
+    return true;
+  if (mem_limit == 0 || mem_root->block_num == mem_checked_blocks)
+    return false;
+  mem_checked_blocks= mem_root->block_num;
+
+  ulonglong used= 0;
+  for (USED_MEM *block= mem_root->free; block; block= block->next)
+    used+= block->size;
+  for (USED_MEM *block= mem_root->used; block; block= block->next)
+    used+= block->size;
+  if (used <= mem_limit)
+    return false;
+
+  mem_limit_exceeded= true;
+  push_warning_printf(thd, Sql_condition::SL_WARNING,
+                      ER_CAPACITY_EXCEEDED, ER(ER_CAPACITY_EXCEEDED),
+                      mem_limit);
+  return true;
+}
+
 class TABLE_READ_PLAN;
   class TRP_RANGE;
   class TRP_ROR_INTERSECT;
@@ -920,6 +980,10 @@ TABLE_READ_PLAN *get_best_disjunct_quick(PARAM *param, SEL_IMERGE *imerge,
 static
 TRP_GROUP_MIN_MAX *get_best_group_min_max(PARAM *param, SEL_TREE *tree,
                                           double read_time);
+class TRP_SKIP_SCAN;
+static
+TRP_SKIP_SCAN *get_best_skip_scan(PARAM *param, SEL_TREE *tree,
+                                  double read_time);
 #ifndef DBUG_OFF
 static void print_sel_tree(PARAM *param, SEL_TREE *tree, key_map *tree_map,
                            const char *msg);
@@ -2501,6 +2565,63 @@ void TRP_GROUP_MIN_MAX::trace_basic_info(const PARAM *param,
 #endif
 }
 
+
+/*
+  Plan for QUICK_SKIP_SCAN_SELECT scan.
+*/
+
+class TRP_SKIP_SCAN : public TABLE_READ_PLAN
+{
+private:
+  KEY *index_info;          ///< The index chosen for data access
+  uint index;               ///< The id of the chosen index
+  uint prefix_key_parts;    ///< Number of key parts skipped over
+  uint prefix_len;          ///< Length of the key parts skipped over
+  SEL_ARG *range;           ///< The range of the next key part
+  ha_rows prefixes;         ///< Estimate of the number of distinct prefixes
+public:
+  TRP_SKIP_SCAN(KEY *index_info_arg, uint index_arg,
+                uint prefix_key_parts_arg, uint prefix_len_arg,
+                SEL_ARG *range_arg, ha_rows prefixes_arg)
+  : index_info(index_info_arg), index(index_arg),
+    prefix_key_parts(prefix_key_parts_arg), prefix_len(prefix_len_arg),
+    range(range_arg), prefixes(prefixes_arg)
+  {}
+  virtual ~TRP_SKIP_SCAN() {}                 /* Remove gcc warning */
+
+  QUICK_SELECT_I *make_quick(PARAM *param, bool retrieve_full_rows,
+                             MEM_ROOT *parent_alloc);
+  void trace_basic_info(const PARAM *param,
+                        Opt_trace_object *trace_object) const;
+};
+
+void TRP_SKIP_SCAN::trace_basic_info(const PARAM *param,
+                                     Opt_trace_object *trace_object) const
+{
+#ifdef OPTIMIZER_TRACE
+  trace_object->add_alnum("type", "skip_scan").
+    add_utf8("index", index_info->name).
+    add("distinct_prefixes", prefixes).
+    add("rows", records).
+    add("cost", read_cost);
+
+  const KEY_PART_INFO *key_part= index_info->key_part;
+  Opt_trace_context * const trace= &param->thd->opt_trace;
+  {
+    Opt_trace_array trace_keyparts(trace, "skipped_key_parts");
+    for (uint partno= 0; partno < prefix_key_parts; partno++)
+      trace_keyparts.add_utf8(key_part[partno].field->field_name);
+  }
+  Opt_trace_array trace_range(trace, "ranges");
+  String range_info;
+  range_info.set_charset(system_charset_info);
+  append_range(&range_info, key_part + range->part,
+               range->min_value, range->max_value,
+               range->min_flag | range->max_flag);
+  trace_range.add_utf8(range_info.ptr(), range_info.length());
+#endif
+}
+
 /*
   Fill param->needed_fields with bitmap of fields used in the query.
   SYNOPSIS
@@ -2750,6 +2871,7 @@ int SQL_SELECT::test_quick_select(THD *thd, key_map keys_to_use,
     }
     param.key_parts_end=key_parts;
     param.alloced_sel_args= 0;
+    param.init_mem_limit();
 
     /* Calculate cost of full index read for the shortest covering index */
     if (!head->covering_keys.is_clear_all())
@@ -2881,6 +3003,16 @@ int SQL_SELECT::test_quick_select(THD *thd, key_map keys_to_use,
             best_read_time= best_trp->read_cost;
           }
         }
+
+        /* Skip scan cannot return rows in descending order */
+        TRP_SKIP_SCAN *skip_trp;
+        if (thd->optimizer_switch_flag(OPTIMIZER_SWITCH_SKIP_SCAN) &&
+            interesting_order != ORDER::ORDER_DESC &&
+            (skip_trp= get_best_skip_scan(&param, tree, best_read_time)))
+        {
+          best_trp= skip_trp;
+          best_read_time= best_trp->read_cost;
+        }
       }
 
       // Here we calculate cost of union index merge
@@ -3225,6 +3357,7 @@ bool prune_partitions(THD *thd, TABLE *table, Item *pprune_cond)
   range_par->remove_jump_scans= FALSE;
   range_par->real_keynr[0]= 0;
   range_par->alloced_sel_args= 0;
+  range_par->init_mem_limit();
 
   thd->no_errors=1;				// Don't warn about NULL
   thd->mem_root=&alloc;
@@ -3328,9 +3461,8 @@ end:
     If not yet locked, also prune partitions to lock if not UPDATEing
     partition key fields. This will also prune lock_partitions if we are under
     LOCK TABLES, so prune away calls to start_stmt().
-    TODO: enhance this prune locking to also allow pruning of
-    'UPDATE t SET part_key = const WHERE cond_is_prunable' so it adds
-    a lock for part_key partition.
+    'UPDATE t SET part_key = const WHERE cond_is_prunable' is lock pruned
+    by partition_info::prune_update_lock_partitions() in mysql_update().
   */
   if (!thd->lex->is_query_tables_locked() &&
       !partition_key_modified(table, table->write_set))
@@ -5801,7 +5933,81 @@ static SEL_TREE *get_ne_mm_tree(RANGE_OPT_PARAM *param, Item_func *cond_func,
   }
   return tree;
 }
-   
+
+
+/**
+  Build a SEL_TREE for "field IN (c1, c2, ...)" from the sorted values of
+  the IN array.
+
+  Instead of OR'ing one get_mm_parts() tree per value, the SEL_ARG tree
+  of each index is built directly: a value costs one SEL_ARG per index
+  rather than a SEL_TREE as well, and since the values come in key order,
+  key_or() always adds the point after the last one of the tree.
+
+  @param param       PARAM from SQL_SELECT::test_quick_select
+  @param func        The IN predicate
+  @param field       Field in the predicate
+  @param value_item  Item of func->array to convert the values with
+
+  @return The tree, or NULL if no index can be used
+*/
+
+static SEL_TREE *get_in_points_mm_tree(RANGE_OPT_PARAM *param,
+                                       Item_func_in *func, Field *field,
+                                       Item *value_item)
+{
+  in_vector *const array= func->array;
+  SEL_TREE *tree= NULL;
+  DBUG_ENTER("get_in_points_mm_tree");
+  if (field->table != param->table)
+    DBUG_RETURN(NULL);
+
+  for (KEY_PART *key_part= param->key_parts;
+       key_part != param->key_parts_end; key_part++)
+  {
+    if (!field->eq(key_part->field) || (tree && tree->keys[key_part->key]))
+      continue;
+
+    SEL_ARG *points= NULL;
+    bool usable= true;
+    for (uint i= 0; usable && i < array->used_count; i++)
+    {
+      if (i > 0 && !array->compare_elems(i, i - 1))
+        continue;                               // Same value as before
+      /* All values are needed, a part of them would lose rows */
+      if (param->has_exceeded_mem_limit())
+        DBUG_RETURN(NULL);
+      array->value_to_item(i, value_item);
+      SEL_ARG *point= get_mm_leaf(param, func, key_part->field, key_part,
+                                  Item_func::EQ_FUNC, value_item);
+      if (!point)
+        usable= false;                          // Index can't be used
+      else if (point->type != SEL_ARG::IMPOSSIBLE)
+      {
+        point->part= (uchar) key_part->part;
+        points= points ? key_or(param, points, point) : point;
+        usable= (points != NULL);
+      }
+    }
+    if (!usable)
+      continue;
+    if (!tree && !(tree= new SEL_TREE()))
+      DBUG_RETURN(NULL);                        // OOM
+    if (!points)
+    {
+      /* No value can be stored in the field */
+      tree->type= SEL_TREE::IMPOSSIBLE;
+      DBUG_RETURN(tree);
+    }
+    tree->keys[key_part->key]= points;
+    tree->keys_map.set_bit(key_part->key);
+  }
+
+  if (tree && tree->keys_map.is_clear_all())
+    tree= NULL;
+  DBUG_RETURN(tree);
+}
+
 
 /*
   Build a SEL_TREE for a simple predicate
@@ -6038,6 +6244,25 @@ static SEL_TREE *get_func_mm_tree(RANGE_OPT_PARAM *param, Item_func *cond_func,
         }
       }
     }
+    else if (func->array && func->array->result_type() != ROW_RESULT &&
+             func->array->used_count >= IN_VECTOR_HASH_MIN_ELEMENTS)
+    {
+      /*
+        "t.key IN (c1, c2, ...)" with a long list of constants: walk the
+        sorted values of the IN array, so that each distinct value is
+        turned into an interval once, in key order, without evaluating the
+        arguments again. See the NOT IN case above for how value_item is
+        created.
+      */
+      MEM_ROOT *tmp_root= param->mem_root;
+      param->thd->mem_root= param->old_root;
+      Item *value_item= func->array->create_item();
+      param->thd->mem_root= tmp_root;
+      if (!value_item)
+        break;
+
+      tree= get_in_points_mm_tree(param, func, field, value_item);
+    }
     else
     {    
       tree= get_mm_parts(param, cond_func, field, Item_func::EQ_FUNC,
@@ -6241,6 +6466,9 @@ static SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param,Item *cond)
       Item *item;
       while ((item=li++))
       {
+        /* Keep the ranges of the conjuncts analyzed so far */
+        if (param->has_exceeded_mem_limit())
+          break;
         SEL_TREE *new_tree= get_mm_tree(param,item);
         if (param->statement_should_be_aborted())
           DBUG_RETURN(NULL);
@@ -6260,6 +6488,8 @@ static SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param,Item *cond)
         Item *item;
         while ((item=li++))
         {
+          if (param->has_exceeded_mem_limit())
+            DBUG_RETURN(NULL);
           SEL_TREE *new_tree=get_mm_tree(param,item);
           if (new_tree == NULL || param->statement_should_be_aborted())
             DBUG_RETURN(NULL);
@@ -13623,6 +13853,350 @@ void QUICK_GROUP_MIN_MAX_SELECT::add_keys_and_lengths(String *key_names,
 
 
 
+/*
+  Find the best skip scan of the table.
+
+  SYNOPSIS
+    get_best_skip_scan()
+    param      Parameter from test_quick_select
+    tree       Range tree of the conditions of the table
+    read_time  Best read time so far
+
+  DESCRIPTION
+    A skip scan (see QUICK_SKIP_SCAN_SELECT) is considered for each index
+    where tree->keys[] has a range for a key part other than the first
+    one, if:
+    - the index covers all fields of the table used by the query,
+    - the index can be read in order,
+    - the range of the key part is a single interval, and
+    - the index has statistics of the distinct values of the key parts
+      before it, and none of these key parts is a part of a field.
+    Ranges over the key parts after the one of the interval are not used.
+
+    Each distinct prefix costs two index seeks; the number of prefixes is
+    estimated from rec_per_key.
+
+  RETURN
+    The plan of the cheapest skip scan that is cheaper than read_time,
+    or NULL if there is none.
+*/
+
+static TRP_SKIP_SCAN *
+get_best_skip_scan(PARAM *param, SEL_TREE *tree, double read_time)
+{
+  TABLE *const table= param->table;
+  handler *const file= table->file;
+  const ha_rows table_records= file->stats.records;
+  TRP_SKIP_SCAN *best_trp= NULL;
+  DBUG_ENTER("get_best_skip_scan");
+
+  if (!param->using_real_indexes || table_records == 0)
+    DBUG_RETURN(NULL);
+
+  Opt_trace_context * const trace= &param->thd->opt_trace;
+  Opt_trace_array trace_indexes(trace, "skip_scan_alternatives",
+                                Opt_trace_context::RANGE_OPTIMIZER);
+
+  for (uint idx= 0; idx < param->keys; idx++)
+  {
+    SEL_ARG *const range= tree->keys[idx];
+    /* Ranges starting at the first key part are range scans */
+    if (!range || range->type != SEL_ARG::KEY_RANGE || range->part == 0)
+      continue;
+
+    const uint keynr= param->real_keynr[idx];
+    KEY *const index_info= table->key_info + keynr;
+    const KEY_PART_INFO *const key_part= index_info->key_part;
+    const uint prefix_key_parts= range->part;
+    Opt_trace_object trace_idx(trace);
+    trace_idx.add_utf8("index", index_info->name);
+
+    const char *cause= NULL;
+    if (!table->covering_keys.is_set(keynr))
+      cause= "not_covering";
+    else if ((file->index_flags(keynr, prefix_key_parts, true) &
+              (HA_READ_NEXT | HA_READ_ORDER)) != (HA_READ_NEXT | HA_READ_ORDER))
+      cause= "not_ordered_index";
+    else if (range->elements != 1 ||
+             ((range->min_flag | range->max_flag) & GEOM_FLAG))
+      cause= "not_single_range";
+    else if (!index_info->rec_per_key[prefix_key_parts - 1])
+      cause= "no_prefix_statistics";
+    else
+    {
+      for (uint partno= 0; partno <= prefix_key_parts; partno++)
+        if (key_part[partno].key_part_flag & (HA_PART_KEY_SEG | HA_BLOB_PART))
+          cause= "prefix_key_part";
+    }
+    if (cause)
+    {
+      trace_idx.add("usable", false).add_alnum("cause", cause);
+      continue;
+    }
+
+    uint prefix_len= 0;
+    for (uint partno= 0; partno < prefix_key_parts; partno++)
+      prefix_len+= key_part[partno].store_length;
+
+    const ha_rows prefixes=
+      max<ha_rows>(1, table_records /
+                      index_info->rec_per_key[prefix_key_parts - 1]);
+    ha_rows rows;
+    if (range->is_singlepoint() && index_info->rec_per_key[prefix_key_parts])
+      rows= prefixes * index_info->rec_per_key[prefix_key_parts];
+    else
+      rows= table_records / 3;               // Same guess as for ranges
+    set_if_smaller(rows, table_records);
+    set_if_bigger(rows, 1);
+
+    const double cost=
+      file->index_only_read_time(keynr, rows2double(rows)) +
+      file->page_read_cost(2.0 * rows2double(prefixes)) +
+      rows2double(rows) * ROW_EVALUATE_COST;
+    trace_idx.add("distinct_prefixes", prefixes).
+      add("rows", rows).add("cost", cost);
+    if (cost >= read_time)
+    {
+      trace_idx.add("chosen", false).add_alnum("cause", "cost");
+      continue;
+    }
+
+    TRP_SKIP_SCAN *trp;
+    if (!(trp= new (param->mem_root) TRP_SKIP_SCAN(index_info, keynr,
+                                                   prefix_key_parts,
+                                                   prefix_len, range,
+                                                   prefixes)))
+      break;                                    // OOM
+    trace_idx.add("chosen", true);
+    trp->records= rows;
+    trp->read_cost= cost;
+    best_trp= trp;
+    read_time= cost;
+  }
+  DBUG_RETURN(best_trp);
+}
+
+
+QUICK_SELECT_I *
+TRP_SKIP_SCAN::make_quick(PARAM *param, bool retrieve_full_rows,
+                          MEM_ROOT *parent_alloc)
+{
+  QUICK_SKIP_SCAN_SELECT *quick;
+  DBUG_ENTER("TRP_SKIP_SCAN::make_quick");
+
+  quick= new QUICK_SKIP_SCAN_SELECT(param->table, index_info, index,
+                                    prefix_key_parts, prefix_len,
+                                    index_info->key_part[range->part].
+                                    store_length,
+                                    range->min_value, range->min_flag,
+                                    range->max_value, range->max_flag,
+                                    read_cost, records);
+  if (quick && quick->init())
+  {
+    delete quick;
+    quick= NULL;
+  }
+  DBUG_RETURN(quick);
+}
+
+
+/*
+  Construct a new quick select for skip scans.
+
+  SYNOPSIS
+    QUICK_SKIP_SCAN_SELECT::QUICK_SKIP_SCAN_SELECT()
+    table             The table being accessed
+    index_info        The index chosen for data access
+    use_index         The id of index_info
+    prefix_key_parts  Number of key parts skipped over
+    prefix_len        Length of the key parts skipped over
+    range_len         Length of the key part of the range
+    min_value         Start of the range, unless NO_MIN_RANGE is in min_flag
+    min_flag          Flags of the start of the range
+    max_value         End of the range, unless NO_MAX_RANGE is in max_flag
+    max_flag          Flags of the end of the range
+    read_cost         Cost of this access method
+    records           Number of records returned
+
+  NOTES
+    The range values are only read by init(), which must be called before
+    they are freed.
+*/
+
+QUICK_SKIP_SCAN_SELECT::
+QUICK_SKIP_SCAN_SELECT(TABLE *table, KEY *index_info_arg, uint use_index,
+                       uint prefix_key_parts_arg, uint prefix_len_arg,
+                       uint range_len_arg, const uchar *min_value,
+                       uint min_flag_arg, const uchar *max_value,
+                       uint max_flag_arg, double read_cost, ha_rows records_arg)
+  :index_info(index_info_arg), prefix_key_parts(prefix_key_parts_arg),
+   prefix_len(prefix_len_arg), range_len(range_len_arg),
+   range_key(NULL), max_key(NULL),
+   min_value_arg(min_value), max_value_arg(max_value),
+   min_flag(min_flag_arg), max_flag(max_flag_arg),
+   seen_first_key(false), in_prefix(false)
+{
+  head=       table;
+  index=      use_index;
+  record=     head->record[0];
+  read_time=  read_cost;
+  records=    records_arg;
+  used_key_parts= prefix_key_parts + 1;
+  max_used_key_length= prefix_len + range_len;
+}
+
+
+/*
+  Allocate the key buffers and copy the range to them.
+
+  RETURN
+    0      OK
+    other  Error code
+*/
+
+int QUICK_SKIP_SCAN_SELECT::init()
+{
+  if (!(range_key= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                      prefix_len + 2 * range_len, MYF(0))))
+    return 1;
+  max_key= range_key + prefix_len + range_len;
+  if (!(min_flag & NO_MIN_RANGE))
+    memcpy(range_key + prefix_len, min_value_arg, range_len);
+  if (!(max_flag & NO_MAX_RANGE))
+    memcpy(max_key, max_value_arg, range_len);
+  min_value_arg= max_value_arg= NULL;
+  return 0;
+}
+
+
+QUICK_SKIP_SCAN_SELECT::~QUICK_SKIP_SCAN_SELECT()
+{
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::~QUICK_SKIP_SCAN_SELECT");
+  if (head->file->inited)
+    head->file->ha_index_or_rnd_end();
+  my_free(range_key);
+  DBUG_VOID_RETURN;
+}
+
+
+int QUICK_SKIP_SCAN_SELECT::reset(void)
+{
+  int result;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::reset");
+
+  seen_first_key= false;
+  in_prefix= false;
+  if (head->file->inited == handler::NONE &&
+      (result= head->file->ha_index_init(index, true)))
+  {
+    head->file->print_error(result, MYF(0));
+    DBUG_RETURN(result);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Position the index on the first row of the range in the next prefix.
+
+  RETURN
+    0                  on success; the prefix is in range_key
+    HA_ERR_END_OF_FILE if there are no more rows in the range
+    other              if some error occurred
+*/
+
+int QUICK_SKIP_SCAN_SELECT::next_prefix()
+{
+  handler *const file= head->file;
+  int result;
+
+  for (;;)
+  {
+    if (!seen_first_key)
+      result= file->ha_index_first(record);
+    else
+      result= file->ha_index_read_map(record, range_key,
+                                      make_prev_keypart_map(prefix_key_parts),
+                                      HA_READ_AFTER_KEY);
+    if (result)
+      return result == HA_ERR_KEY_NOT_FOUND ? HA_ERR_END_OF_FILE : result;
+    seen_first_key= true;
+    key_copy(range_key, record, index_info, prefix_len);
+    if (min_flag & NO_MIN_RANGE)
+      return 0;
+
+    result= file->ha_index_read_map(record, range_key,
+                                    make_prev_keypart_map(prefix_key_parts + 1),
+                                    (min_flag & NEAR_MIN) ?
+                                    HA_READ_AFTER_KEY : HA_READ_KEY_OR_NEXT);
+    if (result)
+      return result == HA_ERR_KEY_NOT_FOUND ? HA_ERR_END_OF_FILE : result;
+    /* If no row of the prefix is in the range, this is a later prefix */
+    if (!key_cmp(index_info->key_part, range_key, prefix_len))
+      return 0;
+  }
+}
+
+
+/*
+  Get the next row of the range in any prefix.
+
+  RETURN
+    0                  on success
+    HA_ERR_END_OF_FILE if returned all rows
+    other              if some error occurred
+*/
+
+int QUICK_SKIP_SCAN_SELECT::get_next()
+{
+  int result;
+  DBUG_ENTER("QUICK_SKIP_SCAN_SELECT::get_next");
+
+  for (;;)
+  {
+    if (!in_prefix)
+    {
+      if ((result= next_prefix()))
+        DBUG_RETURN(result);
+      in_prefix= true;
+    }
+    else
+    {
+      if ((result= head->file->ha_index_next(record)))
+        DBUG_RETURN(result);
+      if (key_cmp(index_info->key_part, range_key, prefix_len))
+      {
+        in_prefix= false;                       // The prefix has changed
+        continue;
+      }
+    }
+
+    if (!(max_flag & NO_MAX_RANGE))
+    {
+      int cmp= key_cmp(index_info->key_part + prefix_key_parts,
+                       max_key, range_len);
+      if (cmp > 0 || (cmp == 0 && (max_flag & NEAR_MAX)))
+      {
+        in_prefix= false;                       // Past the range
+        continue;
+      }
+    }
+    DBUG_RETURN(0);
+  }
+}
+
+
+void QUICK_SKIP_SCAN_SELECT::add_keys_and_lengths(String *key_names,
+                                                  String *used_lengths)
+{
+  char buf[64];
+  uint length;
+  key_names->append(index_info->name);
+  length= longlong2str(max_used_key_length, buf, 10) - buf;
+  used_lengths->append(buf, length);
+}
+
+
 /**
   Traverse the R-B range tree for this and later keyparts to see if
   there are at least as many equality ranges as defined by the limit.
@@ -14305,4 +14879,12 @@ void QUICK_GROUP_MIN_MAX_SELECT::dbug_dump(int indent, bool verbose)
 }
 
 
+void QUICK_SKIP_SCAN_SELECT::dbug_dump(int indent, bool verbose)
+{
+  fprintf(DBUG_FILE,
+          "%*squick_skip_scan_select: index %s (%d), prefix key parts: %d\n",
+          indent, "", index_info->name, index, prefix_key_parts);
+}
+
+
 #endif /* !DBUG_OFF */
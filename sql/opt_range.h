@@ -295,7 +295,8 @@ public:
     QS_TYPE_FULLTEXT   = 3,
     QS_TYPE_ROR_INTERSECT = 4,
     QS_TYPE_ROR_UNION = 5,
-    QS_TYPE_GROUP_MIN_MAX = 6
+    QS_TYPE_GROUP_MIN_MAX = 6,
+    QS_TYPE_SKIP_SCAN = 7
   };
 
   /* Get type of this quick select - one of the QS_TYPE_* values */
@@ -885,6 +886,65 @@ public:
 };
 
 
+/*
+  Index scan that skips over the values of the first key parts.
+
+  This class provides an index access method for conditions of the form
+
+       SELECT ... FROM T WHERE RNG(B) [AND ...]
+
+  over an index (A_1,...,A_k, B, ...) when there are no conditions on
+  A_1,...,A_k, and all fields used by the query are in the index. For
+  each distinct prefix A_1,...,A_k found in the index, the scan seeks to
+  the start of the range of B after the prefix and reads the index until
+  the end of the range, then seeks past the prefix to the next one.
+
+  The other conditions of the query are checked on the returned rows.
+  The conditions under which this quick select is used are described in
+  get_best_skip_scan() in opt_range.cc.
+*/
+
+class QUICK_SKIP_SCAN_SELECT : public QUICK_SELECT_I
+{
+private:
+  KEY  *index_info;              /* The index chosen for data access */
+  const uint prefix_key_parts;   /* Key parts skipped over */
+  const uint prefix_len;         /* Length of the skipped key parts */
+  const uint range_len;          /* Length of the key part of the range */
+  /*
+    The current prefix followed by the start of the range, and the end of
+    the range. The range values are copied there by init().
+  */
+  uchar *range_key;
+  uchar *max_key;
+  const uchar *min_value_arg;
+  const uchar *max_value_arg;
+  uint min_flag;                 /* Flags of the range, as in SEL_ARG */
+  uint max_flag;
+  bool seen_first_key;           /* A prefix has been read */
+  bool in_prefix;                /* Rows are read within range_key's prefix */
+  int  next_prefix();
+public:
+  QUICK_SKIP_SCAN_SELECT(TABLE *table, KEY *index_info, uint use_index,
+                         uint prefix_key_parts, uint prefix_len,
+                         uint range_len, const uchar *min_value,
+                         uint min_flag, const uchar *max_value,
+                         uint max_flag, double read_cost, ha_rows records);
+  ~QUICK_SKIP_SCAN_SELECT();
+  int init();
+  void need_sorted_output() { /* always do it */ }
+  int reset();
+  int get_next();
+  bool reverse_sorted() const { return false; }
+  bool reverse_sort_possible() const { return false; }
+  int get_type() { return QS_TYPE_SKIP_SCAN; }
+  void add_keys_and_lengths(String *key_names, String *used_lengths);
+#ifndef DBUG_OFF
+  void dbug_dump(int indent, bool verbose);
+#endif
+};
+
+
 class QUICK_SELECT_DESC: public QUICK_RANGE_SELECT
 {
 public:
@@ -343,7 +343,7 @@ int opt_sum_query(THD *thd,
               done in this function from showing in EXPLAIN, that's ok as
               real query will be executed faster than one shown by EXPLAIN.
             */
-            if (!thd->lex->describe &&
+            if (!thd->lex->is_explain_without_execution() &&
                 (count= get_exact_record_count(tables)) == ULONGLONG_MAX)
             {
               /* Error from handler in counting rows. Don't optimize count() */
@@ -381,7 +381,7 @@ int opt_sum_query(THD *thd,
           const_result= 0;
 
         // See comment above for get_exact_record_count()
-        if (!thd->lex->describe && const_result == 1) {
+        if (!thd->lex->is_explain_without_execution() && const_result == 1) {
           ((Item_sum_count*) item)->make_const((longlong) count);
           recalc_const_item= true;
         }
@@ -503,6 +503,89 @@ err:
 }
 
 
+/**
+  Prune the partitions to lock for an UPDATE of the partitioning fields.
+
+  prune_partitions() cannot prune locks when the partitioning fields are
+  updated, since an updated row may move to any partition. But if all
+  partitioning fields are set to constant values, every updated row moves
+  to the same partition, so only the read partitions and that partition
+  need to be locked.
+
+  @param fields  Fields to update
+  @param values  Values to use
+  @param update  COPY_INFO used for function defaults handling
+
+  @note lock_partitions is left untouched if pruning is not possible.
+*/
+
+void partition_info::prune_update_lock_partitions(List<Item> &fields,
+                                                  List<Item> &values,
+                                                  COPY_INFO &update)
+{
+  THD *thd= table->in_use;
+  MY_BITMAP used_partitions;
+  uint32 *bitmap_buf;
+  uint32 part_id;
+  DBUG_ENTER("partition_info::prune_update_lock_partitions");
+
+  if (table->s->db_type()->partition_flags() & HA_USE_AUTO_PARTITION)
+    DBUG_VOID_RETURN;
+
+  /* Nothing to gain if all locked partitions are read anyway. */
+  if (bitmap_cmp(&read_partitions, &lock_partitions))
+    DBUG_VOID_RETURN;
+
+  /*
+    Cannot prune if there are BEFORE UPDATE triggers that changes any
+    partitioning column, since they may change the row to be in another
+    partition.
+  */
+  if (table->triggers)
+  {
+    Trigger_chain *trigger_chain=
+        table->triggers->get_triggers(TRG_EVENT_UPDATE, TRG_ACTION_BEFORE);
+
+    if (trigger_chain &&
+        trigger_chain->has_updated_trigger_fields(&full_part_field_set))
+      DBUG_VOID_RETURN;
+  }
+
+  if (!is_full_part_expr_in_fields(fields))
+    DBUG_VOID_RETURN;
+
+  /*
+    The tables are not locked yet, so values depending on subqueries or
+    stored programs cannot be evaluated.
+  */
+  List_iterator_fast<Item> v(values);
+  Item *item;
+  while ((item= v++))
+  {
+    if (!item->const_item() || !item->can_be_evaluated_now())
+      DBUG_VOID_RETURN;
+  }
+
+  if (!(bitmap_buf= (uint32*) thd->alloc(bitmap_buffer_size(
+                                           lock_partitions.n_bits))) ||
+      bitmap_init(&used_partitions, bitmap_buf, lock_partitions.n_bits, false))
+    DBUG_VOID_RETURN; /* purecov: inspected */
+
+  /* Not possible to prune if the new values does not match any partition. */
+  if (set_used_partition(fields, values, update, false, &used_partitions))
+    DBUG_VOID_RETURN;
+
+  part_id= bitmap_get_first_set(&used_partitions);
+  if (!bitmap_is_set(&lock_partitions, part_id))
+    DBUG_VOID_RETURN;
+
+  DBUG_PRINT("info", ("Update moves rows to partition %u", part_id));
+  bitmap_copy(&lock_partitions, &read_partitions);
+  bitmap_set_bit(&lock_partitions, part_id);
+  DBUG_VOID_RETURN;
+}
+
+
 /*
   Create a memory area where default partition names are stored and fill it
   up with the names.
@@ -343,6 +343,9 @@ public:
                           COPY_INFO &info,
                           bool copy_default_values,
                           MY_BITMAP *used_partitions);
+  void prune_update_lock_partitions(List<Item> &fields,
+                                    List<Item> &values,
+                                    COPY_INFO &update);
   /**
     PRUNE_NO - Unable to prune.
     PRUNE_DEFAULTS - Partitioning field is only set to
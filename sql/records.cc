@@ -25,9 +25,11 @@
 #include "records.h"
 #include "sql_list.h"
 #include "filesort.h"            // filesort_free_buffers
+#include "sql_sort.h"            // Sort_param
 #include "opt_range.h"                          // SQL_SELECT
 #include "sql_class.h"                          // THD
 #include "sql_select.h"          // JOIN_TAB
+#include "sql_cond_kernel.h"     // Cond_kernel
 
 
 static int rr_quick(READ_RECORD *info);
@@ -38,6 +40,8 @@ static int rr_unpack_from_buffer(READ_RECORD *info);
 static int rr_from_pointers(READ_RECORD *info);
 static int rr_from_cache(READ_RECORD *info);
 static int init_rr_cache(THD *thd, READ_RECORD *info);
+static int rr_sequential_batch(READ_RECORD *info);
+static bool init_rr_batch(THD *thd, READ_RECORD *info);
 static int rr_index_first(READ_RECORD *info);
 static int rr_index_last(READ_RECORD *info);
 static int rr_index(READ_RECORD *info);
@@ -176,6 +180,14 @@ bool init_read_record_idx(READ_RECORD *info, THD *thd, TABLE *table,
     This is the most basic access method of a table using rnd_init,
     ha_rnd_next and rnd_end. No indexes are used.
 
+  rr_sequential_batch:
+  --------------------
+    A full table scan like rr_sequential, but the rows are fetched with
+    ha_rnd_next_batch into a buffer of read_buffer_size bytes. It is
+    used when the handler has HA_CAN_READ_BATCH and the table is not
+    updated through the scan. set_read_record_filter() makes it skip
+    the rows of a batch that do not satisfy a condition.
+
   @retval true   error
   @retval false  success
 */
@@ -233,7 +245,10 @@ bool init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
     info->read_record= (table->sort.addon_field ?
                         rr_unpack_from_tempfile : rr_from_tempfile);
     info->io_cache=tempfile;
-    reinit_io_cache(info->io_cache,READ_CACHE,0L,0,0);
+    /* filesort() may skip the first records, for OFFSET */
+    reinit_io_cache(info->io_cache,READ_CACHE,
+                    tempfile == table->sort.io_cache ?
+                    table->sort.io_cache_start : 0L,0,0);
     info->ref_pos=table->file->ref;
     if (!table->file->inited &&
         (error= table->file->ha_rnd_init(0)))
@@ -286,6 +301,15 @@ bool init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
     info->read_record=rr_sequential;
     if ((error= table->file->ha_rnd_init(1)))
       goto err;
+    if ((table->file->ha_table_flags() & HA_CAN_READ_BATCH) &&
+        !table->sort.addon_field &&
+        (table->db_stat & HA_READ_ONLY ||
+         table->reginfo.lock_type <= TL_READ_NO_INSERT) &&
+        !init_rr_batch(thd, info))
+    {
+      DBUG_PRINT("info",("using rr_sequential_batch"));
+      info->read_record=rr_sequential_batch;
+    }
     /* We can use record cache if we don't update dynamic length tables */
     if (!table->no_cache &&
 	(use_record_cache > 0 ||
@@ -319,11 +343,7 @@ err:
 
 void end_read_record(READ_RECORD *info)
 {                   /* free cache if used */
-  if (info->cache)
-  {
-    my_free(info->cache);
-    info->cache=0;
-  }
+  free_read_record_buffers(info);
   if (info->table && info->table->key_read)
   {
     info->table->set_keyread(FALSE);
@@ -338,6 +358,54 @@ void end_read_record(READ_RECORD *info)
   }
 }
 
+/**
+  Free the buffers allocated for reading the rows.
+
+  init_read_record() does not free them, as the READ_RECORD it is given
+  need not have been set up before. A caller that restarts reading with
+  the same READ_RECORD without end_read_record() calls this first.
+*/
+
+void free_read_record_buffers(READ_RECORD *info)
+{
+  my_free(info->cache);
+  info->cache= NULL;
+  my_free(info->cache_matches);
+  info->cache_matches= NULL;
+  info->cond_kernel= NULL;
+}
+
+
+/**
+  Skip the rows that do not satisfy a condition in the batches of a full
+  table scan.
+
+  The kernel is evaluated over each batch read by rr_sequential_batch(),
+  which then returns only the rows that satisfy the condition, and counts
+  the others in READ_RECORD::filtered_rows.
+
+  @retval false  success, only rows that satisfy the condition are read
+  @retval true   the rows are not read in batches, or out of memory; all
+                 rows of the scan are read
+*/
+
+bool set_read_record_filter(READ_RECORD *info, Cond_kernel *kernel)
+{
+  if (info->read_record != rr_sequential_batch)
+    return true;
+  DBUG_ASSERT(info->cache_matches == NULL);
+  if (!(info->cache_matches=
+        (uchar*) my_malloc(key_memory_READ_RECORD_cache,
+                           info->cache_records *
+                           (1 + kernel->scratch_per_row()),
+                           MYF(0))))
+    return true;
+  info->cond_kernel= kernel;
+  info->filtered_rows= 0;
+  return false;
+}
+
+
 static int rr_handle_error(READ_RECORD *info, int error)
 {
   if (info->thd->killed)
@@ -491,6 +559,65 @@ int rr_sequential(READ_RECORD *info)
 }
 
 
+/**
+  Read a record of a full table scan, fetching the rows from the handler
+  in batches.
+*/
+
+static int rr_sequential_batch(READ_RECORD *info)
+{
+  int tmp;
+  for (;;)
+  {
+    if (info->cache_pos != info->cache_end)
+    {
+      if (info->cond_kernel &&
+          !info->cache_matches[(info->cache_pos - info->cache) /
+                               info->reclength])
+      {
+        info->cache_pos+= info->reclength;
+        info->filtered_rows++;
+        continue;
+      }
+      memcpy(info->record, info->cache_pos,
+             (size_t) info->table->s->reclength);
+      info->cache_pos+= info->reclength;
+      info->table->status= 0;
+      return 0;
+    }
+    if (info->batch_error)
+    {
+      /* Report the error that ended the last batch. */
+      tmp= info->batch_error;
+      info->batch_error= 0;
+    }
+    else
+    {
+      uint rows_read;
+      tmp= info->table->file->ha_rnd_next_batch(info->cache,
+                                                info->cache_records,
+                                                &rows_read);
+      info->cache_pos= info->cache;
+      info->cache_end= info->cache + rows_read * info->reclength;
+      if (rows_read)
+      {
+        if (info->cond_kernel)
+          info->cond_kernel->evaluate(info->cache, info->reclength, rows_read,
+                                      info->cache_matches,
+                                      info->cache_matches +
+                                      info->cache_records);
+        info->batch_error= tmp;
+        continue;
+      }
+      DBUG_ASSERT(tmp);
+    }
+    /* See rr_sequential() for HA_ERR_RECORD_DELETED */
+    if (info->thd->killed || (tmp != HA_ERR_RECORD_DELETED))
+      return rr_handle_error(info, tmp);
+  }
+}
+
+
 static int rr_from_tempfile(READ_RECORD *info)
 {
   int tmp;
@@ -529,9 +656,21 @@ static int rr_from_tempfile(READ_RECORD *info)
 
 static int rr_unpack_from_tempfile(READ_RECORD *info)
 {
-  if (my_b_read(info->io_cache, info->rec_buf, info->ref_length))
-    return -1;
   TABLE *table= info->table;
+  if (table->sort.using_packed_addons)
+  {
+    /* Read the length of the packed addon fields, then the rest. */
+    const uint length_size= Sort_param::size_of_addon_length;
+    if (my_b_read(info->io_cache, info->rec_buf, length_size))
+      return -1;
+    const uint length= uint2korr(info->rec_buf);
+    if (length < length_size ||
+        my_b_read(info->io_cache, info->rec_buf + length_size,
+                  length - length_size))
+      return -1;
+  }
+  else if (my_b_read(info->io_cache, info->rec_buf, info->ref_length))
+    return -1;
   (*table->sort.unpack)(table->sort.addon_field, info->rec_buf);
 
   return 0;
@@ -621,6 +760,42 @@ static int init_rr_cache(THD *thd, READ_RECORD *info)
 } /* init_rr_cache */
 
 
+/**
+  Allocate the row buffer for rr_sequential_batch().
+
+  @retval true   batching is not worthwhile or memory could not be allocated
+  @retval false  success
+*/
+
+static bool init_rr_batch(THD *thd, READ_RECORD *info)
+{
+  TABLE *table= info->table;
+  DBUG_ENTER("init_rr_batch");
+
+  info->reclength= table->s->rec_buff_length;
+  info->cache_records= thd->variables.read_buff_size / info->reclength;
+  /* Do not allocate more than the table is expected to need. */
+  if ((ha_rows) info->cache_records > table->file->stats.records)
+    info->cache_records= (uint) table->file->stats.records;
+
+  if (info->cache_records < 2 ||
+      !(info->cache= (uchar*) my_malloc(key_memory_READ_RECORD_cache,
+                                        info->cache_records *
+                                        info->reclength,
+                                        MYF(0))))
+    DBUG_RETURN(true);
+
+  /* Columns that are not read keep their default values, as in record[0] */
+  for (uint i= 0; i < info->cache_records; i++)
+    memcpy(info->cache + i * info->reclength, table->s->default_values,
+           (size_t) table->s->reclength);
+
+  DBUG_PRINT("info",("Allocated buffer for %d records",info->cache_records));
+  info->cache_pos= info->cache_end= info->cache;
+  DBUG_RETURN(false);
+}
+
+
 static int rr_cmp(const void *p_ref_length, const void *a, const void *b)
 {
   size_t ref_length= *(static_cast<size_t*>(const_cast<void*>(p_ref_length)));
@@ -16,12 +16,14 @@
    51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
 
 #include <my_global.h>                /* for uint typedefs */
+#include <my_base.h>                  /* ha_rows */
 
 typedef struct st_join_table JOIN_TAB;
 class handler;
 struct TABLE;
 class THD;
 class SQL_SELECT;
+class Cond_kernel;
 
 /**
   A context for reading through a single table using a chosen access method:
@@ -61,6 +63,10 @@ struct READ_RECORD
   uchar	*cache,*cache_pos,*cache_end,*read_positions;
   struct st_io_cache *io_cache;
   bool print_error, ignore_not_found_rows;
+  int batch_error;               /* error that ended the cached batch */
+  Cond_kernel *cond_kernel;      /* filter of the rows of a batch */
+  uchar *cache_matches;          /* results of cond_kernel for the batch */
+  ha_rows filtered_rows;         /* rows skipped because of cond_kernel */
 
 public:
   READ_RECORD() {}
@@ -72,6 +78,8 @@ bool init_read_record(READ_RECORD *info, THD *thd, TABLE *reg_form,
 bool init_read_record_idx(READ_RECORD *info, THD *thd, TABLE *table,
                           bool print_error, uint idx, bool reverse);
 void end_read_record(READ_RECORD *info);
+void free_read_record_buffers(READ_RECORD *info);
+bool set_read_record_filter(READ_RECORD *info, Cond_kernel *kernel);
 
 void rr_unlock_row(st_join_table *tab);
 int rr_sequential(READ_RECORD *info);
@@ -34,9 +34,9 @@ void Binlog_sender::init()
   thd->push_diagnostics_area(&m_diag_area);
   init_heartbeat_period();
 
-  mysql_mutex_lock(&LOCK_thread_count);
+  mysql_mutex_lock(&thd->LOCK_thd_data);
   thd->current_linfo= &m_linfo;
-  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_mutex_unlock(&thd->LOCK_thd_data);
 
   sql_print_information("Start binlog_dump to master_thread_id(%lu) "
                         "slave_server(%u), pos(%s, %llu)",
@@ -94,9 +94,9 @@ void Binlog_sender::cleanup()
 
   (void) RUN_HOOK(binlog_transmit, transmit_stop, (thd, 0/*flags*/));
 
-  mysql_mutex_lock(&LOCK_thread_count);
+  mysql_mutex_lock(&thd->LOCK_thd_data);
   thd->current_linfo= NULL;
-  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_mutex_unlock(&thd->LOCK_thd_data);
 
   thd->variables.max_allowed_packet= global_system_variables.max_allowed_packet;
 
@@ -134,7 +134,8 @@ void Binlog_sender::run()
     if (unlikely(fake_rotate_event(&m_thd->packet, log_file, start_pos)))
       break;
 
-    file= open_binlog_file(&log_cache, log_file, &m_errmsg);
+    file= open_binlog_file(&log_cache, log_file, &m_errmsg,
+                           BINLOG_SENDER_READ_SIZE);
     if (unlikely(file < 0))
     {
       set_fatal_error(m_errmsg);
@@ -190,6 +191,8 @@ void Binlog_sender::run()
 
 int Binlog_sender::send_binlog(IO_CACHE *log_cache, my_off_t start_pos)
 {
+  const bool at_file_start= (start_pos == BIN_LOG_HEADER_SIZE);
+
   if (unlikely(send_format_description_event(&m_thd->packet, log_cache,
                                              start_pos > BIN_LOG_HEADER_SIZE)))
     return 1;
@@ -207,6 +210,24 @@ int Binlog_sender::send_binlog(IO_CACHE *log_cache, my_off_t start_pos)
       return 0;
   }
 
+  /*
+    Skip the part of the file the slave has already executed, as far as
+    the GTID index of the file tells. The heartbeat moves the slave's
+    master position past it, like for transactions skipped one by one.
+  */
+  my_off_t index_pos;
+  if (m_using_gtid_protocol && at_file_start &&
+      !mysql_bin_log.find_gtid_index_pos(m_linfo.log_file_name,
+                                         m_exclude_gtid, &index_pos) &&
+      index_pos > start_pos)
+  {
+    DBUG_PRINT("info", ("Skipping to position %llu using the GTID index",
+                        index_pos));
+    start_pos= index_pos;
+    if (send_heartbeat_event(NULL, start_pos))
+      return 1;
+  }
+
   /*
     Slave is requesting a position which is in the middle of a file,
     so seek to the correct position.
@@ -26,6 +26,15 @@
 #include "binlog.h"
 #include "log_event.h"
 
+/**
+  Size of the read cache of a dump thread. The binary log is read through
+  the OS page cache, which all dump threads tailing the same file already
+  share, so what a dump thread pays for on its own is the number of
+  reads: a slave catching up reads the file in large chunks rather than
+  a system call per few events.
+*/
+#define BINLOG_SENDER_READ_SIZE (128 * 1024)
+
 /**
   The major logic of dump thread is implemented in this class. It sends
   required binlog events to clients according to their requests.
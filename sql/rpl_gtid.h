@@ -386,7 +386,12 @@ public:
       DBUG_ASSERT(0);
     my_atomic_rwlock_wrunlock(&atomic_lock);
 #else
-    is_write_lock= false;
+    /*
+      Readers do not write the flag, so that concurrent readers do not
+      bounce its cache line between them.
+    */
+    if (is_write_lock)
+      is_write_lock= false;
 #endif
     mysql_rwlock_unlock(&rwlock);
   }
@@ -903,7 +908,36 @@ public:
     DBUG_ENTER("Gtid_set::_add_gtid(sidno, gno)");
     Interval_iterator ivit(this, sidno);
     Free_intervals_lock lock(this);
+    /*
+      GTIDs are mostly added right after the previously added one, so
+      start from the interval that took the last GTID rather than from
+      the head of the list.
+    */
+    Interval *hint= get_interval_hint(sidno);
+    if (hint != NULL && gno >= hint->start)
+    {
+      if (gno < hint->end)
+        RETURN_OK;
+      if (gno == hint->end)
+      {
+        cached_string_length= -1;
+        hint->end= gno + 1;
+        Interval *next= hint->next;
+        if (next != NULL && next->start == hint->end)
+        {
+          // the gap to the next interval is filled: merge the two
+          hint->end= next->end;
+          lock.lock_if_not_locked();
+          ivit.start_after(hint);
+          ivit.remove(this);
+        }
+        RETURN_OK;
+      }
+      ivit.start_after(hint);
+    }
     enum_return_status ret= add_gno_interval(&ivit, gno, gno + 1, &lock);
+    if (ret == RETURN_STATUS_OK)
+      set_interval_hint(sidno, ivit.get());
     DBUG_RETURN(ret);
   }
   /**
@@ -1242,10 +1276,16 @@ public:
     }
     /// Construct a new iterator over the free intervals of a Gtid_set.
     Interval_iterator_base(Gtid_set_p gtid_set)
-    { p= const_cast<Interval_p *>(&gtid_set->free_intervals); }
+    {
+      sidno= 0;
+      p= const_cast<Interval_p *>(&gtid_set->free_intervals);
+    }
     /// Reset this iterator.
-    inline void init(Gtid_set_p gtid_set, rpl_sidno sidno)
-    { p= dynamic_element(&gtid_set->intervals, sidno - 1, Interval_p *); }
+    inline void init(Gtid_set_p gtid_set, rpl_sidno sidno_arg)
+    {
+      sidno= sidno_arg;
+      p= dynamic_element(&gtid_set->intervals, sidno - 1, Interval_p *);
+    }
     /// Advance current_elem one step.
     inline void next()
     {
@@ -1261,6 +1301,8 @@ public:
       current element is the first element.
     */
     Interval_p *p;
+    /// The SIDNO whose intervals are iterated, or 0 for free intervals.
+    rpl_sidno sidno;
   };
 
   /**
@@ -1300,11 +1342,15 @@ public:
     inline void set(Interval *iv) { *p= iv; }
     /// Insert the given element before current_elem.
     inline void insert(Interval *iv) { iv->next= *p; set(iv); }
+    /// Move to the element after the given element of the same list.
+    inline void start_after(Interval *iv) { p= &iv->next; }
     /// Remove current_elem.
     inline void remove(Gtid_set *gtid_set)
     {
       DBUG_ASSERT(get() != NULL);
       Interval *next= (*p)->next;
+      if (sidno > 0 && gtid_set->get_interval_hint(sidno) == *p)
+        gtid_set->set_interval_hint(sidno, NULL);
       gtid_set->put_free_interval(*p);
       set(next);
     }
@@ -1657,6 +1703,19 @@ private:
     intervals of SIDNO N+1.
   */
   DYNAMIC_ARRAY intervals;
+  /**
+    Array where the N'th element points to the interval of SIDNO N+1
+    that received the last GTID added by _add_gtid, or is NULL.
+    Lookups of GNOs at or after that interval start there instead of
+    at the head of the list.
+  */
+  DYNAMIC_ARRAY interval_hints;
+  /// Return the interval hint of the given SIDNO.
+  Interval *get_interval_hint(rpl_sidno sidno) const
+  { return *dynamic_element(&interval_hints, sidno - 1, Interval **); }
+  /// Set the interval hint of the given SIDNO.
+  void set_interval_hint(rpl_sidno sidno, Interval *iv)
+  { *dynamic_element(&interval_hints, sidno - 1, Interval **)= iv; }
   /// Linked list of free intervals.
   Interval *free_intervals;
   /// Linked list of chunks.
@@ -2163,6 +2222,24 @@ public:
     @param thd Thread for which owned groups are updated.
   */
   void update_on_commit(THD *thd);
+  /**
+    Call update_on_flush() for every session of a binary log group
+    that wrote its transaction to the binary log without error.
+
+    global_sid_lock is taken once for the whole group, and not at all
+    if no session in the group owns a GTID. Sessions for which the
+    update fails get THD::CE_FLUSH_ERROR.
+
+    @param first First session of the group, linked by next_to_commit.
+  */
+  enum_return_status update_on_flush_group(THD *first);
+  /**
+    Call update_on_commit() for every session of a binary log group
+    that owns a GTID, taking global_sid_lock once for the whole group.
+
+    @param first First session of the group, linked by next_to_commit.
+  */
+  void update_on_commit_group(THD *first);
   /**
     Update the state after the given thread has rollbacked.
 
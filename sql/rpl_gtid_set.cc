@@ -75,6 +75,7 @@ void Gtid_set::init()
   chunks= NULL;
   free_intervals= NULL;
   my_init_dynamic_array(&intervals, sizeof(Interval *), 0, 8);
+  my_init_dynamic_array(&interval_hints, sizeof(Interval *), 0, 8);
   if (sid_lock)
     mysql_mutex_init(0, &free_intervals_mutex, NULL);
 #ifndef DBUG_OFF
@@ -99,6 +100,7 @@ Gtid_set::~Gtid_set()
   }
   DBUG_ASSERT(n_chunks == 0);
   delete_dynamic(&intervals);
+  delete_dynamic(&interval_hints);
   if (sid_lock)
     mysql_mutex_destroy(&free_intervals_mutex);
   DBUG_VOID_RETURN;
@@ -144,11 +146,14 @@ enum_return_status Gtid_set::ensure_sidno(rpl_sidno sidno)
       }
     }
     if (allocate_dynamic(&intervals,
+                         sid_map == NULL ? sidno : sid_map->get_max_sidno()) ||
+        allocate_dynamic(&interval_hints,
                          sid_map == NULL ? sidno : sid_map->get_max_sidno()))
       goto error;
     Interval *null_p= NULL;
     for (rpl_sidno i= max_sidno; i < sidno; i++)
-      if (insert_dynamic(&intervals, &null_p))
+      if (insert_dynamic(&intervals, &null_p) ||
+          insert_dynamic(&interval_hints, &null_p))
         goto error;
     if (sid_lock != NULL)
     {
@@ -245,6 +250,7 @@ void Gtid_set::clear()
     */
     Interval_iterator ivit(this, sidno);
     Interval *iv= ivit.get();
+    set_interval_hint(sidno, NULL);
     if (iv != NULL)
     {
       // find the end of the list of free intervals
@@ -746,15 +752,16 @@ bool Gtid_set::contains_gtid(rpl_sidno sidno, rpl_gno gno) const
     sid_lock->assert_some_lock();
   if (sidno > get_max_sidno())
     DBUG_RETURN(false);
-  Const_interval_iterator ivit(this, sidno);
-  const Interval *iv;
-  while ((iv= ivit.get()) != NULL)
+  // no interval before the hint can contain a GNO at or after its start
+  const Interval *iv= get_interval_hint(sidno);
+  if (iv == NULL || gno < iv->start)
+    iv= Const_interval_iterator(this, sidno).get();
+  for (; iv != NULL; iv= iv->next)
   {
     if (gno < iv->start)
       DBUG_RETURN(false);
     else if (gno < iv->end)
       DBUG_RETURN(true);
-    ivit.next();
   }
   DBUG_RETURN(false);
 }
@@ -183,6 +183,63 @@ void Gtid_state::update_on_commit(THD *thd)
 }
 
 
+enum_return_status Gtid_state::update_on_flush_group(THD *first)
+{
+  DBUG_ENTER("Gtid_state::update_on_flush_group");
+  enum_return_status ret= RETURN_STATUS_OK;
+  bool locked= false;
+
+  for (THD *head= first; head; head= head->next_to_commit)
+  {
+    if (head->commit_error != THD::CE_NONE ||
+        !head->transaction.flags.gtid_written)
+      continue;
+    if (head->owned_gtid.sidno == 0)
+    {
+      head->variables.gtid_next.set_undefined();
+      continue;
+    }
+    if (!locked)
+    {
+      global_sid_lock->rdlock();
+      locked= true;
+    }
+    if (update_on_flush(head) != RETURN_STATUS_OK)
+    {
+      head->commit_error= THD::CE_FLUSH_ERROR;
+      ret= RETURN_STATUS_REPORTED_ERROR;
+    }
+  }
+  if (locked)
+    global_sid_lock->unlock();
+
+  DBUG_RETURN(ret);
+}
+
+
+void Gtid_state::update_on_commit_group(THD *first)
+{
+  DBUG_ENTER("Gtid_state::update_on_commit_group");
+  bool locked= false;
+
+  for (THD *head= first; head; head= head->next_to_commit)
+  {
+    if (head->owned_gtid.sidno == 0)
+      continue;
+    if (!locked)
+    {
+      global_sid_lock->rdlock();
+      locked= true;
+    }
+    update_owned_gtids_impl(head, true);
+  }
+  if (locked)
+    global_sid_lock->unlock();
+
+  DBUG_VOID_RETURN;
+}
+
+
 void Gtid_state::update_on_rollback(THD *thd)
 {
   DBUG_ENTER("Gtid_state::update_on_rollback");
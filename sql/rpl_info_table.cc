@@ -16,6 +16,7 @@
 #include "rpl_info_table.h"
 #include "rpl_utility.h"
 #include "log.h"
+#include "sql_update.h"                     // compare_records
 
 Rpl_info_table::Rpl_info_table(uint nparam,
                                const char* param_schema,
@@ -206,10 +207,16 @@ int Rpl_info_table::do_flush_info(const bool force)
       goto end;
  
     /*
-      Updates a row in the rpl_info table.
+      Updates a row in the rpl_info table, unless it already holds the
+      same values, e.g. when a forced flush follows one that stored the
+      same positions. This spares the engine the undo record of an
+      update that changes nothing.
     */
-    if ((error= table->file->ha_update_row(table->record[1], table->record[0])) &&
-        error != HA_ERR_RECORD_IS_THE_SAME)
+    if (records_are_comparable(table) && !compare_records(table))
+      error= 0;
+    else if ((error= table->file->ha_update_row(table->record[1],
+                                                table->record[0])) &&
+             error != HA_ERR_RECORD_IS_THE_SAME)
     {
       table->file->print_error(error, MYF(0));
       /*
@@ -624,7 +624,7 @@ Mts_submode_logical_clock::get_free_worker(Relay_log_info *rli)
   for (uint i= 0; i < rli->workers.elements; i++)
   {
     get_dynamic(&rli->workers, (uchar *) &w_i, i);
-    if (w_i->jobs.len == 0)
+    if (w_i->jobs.length() == 0)
       return w_i;
   }
   return 0;
@@ -643,6 +643,7 @@ public:
   */
   ulong mts_wq_no_underrun_cnt;
   ulong mts_wq_overfill_cnt;  // counter of C waited due to a WQ queue was full
+  ulonglong mts_wq_overfill_time; // usecs C waited due to a WQ queue was full
   /* 
      A sorted array of the Workers' current assignement numbers to provide
      approximate view on Workers loading.
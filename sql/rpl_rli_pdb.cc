@@ -158,11 +158,11 @@ int Slave_worker::init_worker(Relay_log_info * rli, ulong i)
   gaq_index= last_group_done_index= c_rli->gaq->size; // out of range
 
   DBUG_ASSERT(!jobs.inited_queue);
-  jobs.avail= 0;
-  jobs.len= 0;
-  jobs.overfill= FALSE;    //  todo: move into Slave_jobs_queue constructor
+  jobs.head= jobs.tail= 0;
+  jobs.overfill= jobs.waiting= 0; //  todo: move into Slave_jobs_queue constructor
+  jobs.purged= false;
   jobs.waited_overfill= 0;
-  jobs.entry= jobs.size= c_rli->mts_slave_worker_queue_len_max;
+  jobs.size= c_rli->mts_slave_worker_queue_len_max;
   jobs.inited_queue= true;
   curr_group_seen_begin= curr_group_seen_gtid= false;
 
@@ -1524,33 +1524,25 @@ void Slave_worker::do_report(loglevel level, int err_code, const char *msg,
 }
 
 
-// returns the next available! (TODO: incompatible to circurla_buff method!!!)
+/**
+   Appends an item to the tail of a Worker queue. Only the Coordinator
+   calls it, see Slave_jobs_queue.
+
+   @return the new length of the queue, or -1 when the queue is full.
+*/
 static int en_queue(Slave_jobs_queue *jobs, Slave_job_item *item)
 {
-  if (jobs->avail == jobs->size)
-  {
-    DBUG_ASSERT(jobs->avail == jobs->Q.elements);
+  int64 tail= my_atomic_load64(&jobs->tail);
+  if (tail - my_atomic_load64(&jobs->head) == (int64) jobs->size)
     return -1;
-  }
 
   // store
+  memcpy(dynamic_array_ptr(&jobs->Q, (uint) (tail % jobs->size)), item,
+         sizeof(Slave_job_item));
 
-  set_dynamic(&jobs->Q, (uchar*) item, jobs->avail);
-
-  // pre-boundary cond
-  if (jobs->entry == jobs->size)
-    jobs->entry= jobs->avail;
-
-  jobs->avail= (jobs->avail + 1) % jobs->size;
-  jobs->len++;
-
-  // post-boundary cond
-  if (jobs->avail == jobs->entry)
-    jobs->avail= jobs->size;
-  DBUG_ASSERT(jobs->avail == jobs->entry ||
-              jobs->len == (jobs->avail >= jobs->entry) ?
-              (jobs->avail - jobs->entry) : (jobs->size + jobs->avail - jobs->entry));
-  return jobs->avail;
+  // publish, the full barrier orders the store above before the Worker reads
+  my_atomic_add64(&jobs->tail, 1);
+  return (int) (tail + 1 - my_atomic_load64(&jobs->head));
 }
 
 /**
@@ -1558,13 +1550,14 @@ static int en_queue(Slave_jobs_queue *jobs, Slave_job_item *item)
 */
 static void * head_queue(Slave_jobs_queue *jobs, Slave_job_item *ret)
 {
-  if (jobs->entry == jobs->size)
+  int64 head= my_atomic_load64(&jobs->head);
+  if (head == my_atomic_load64(&jobs->tail))
   {
-    DBUG_ASSERT(jobs->len == 0);
     ret->data= NULL;               // todo: move to caller
     return NULL;
   }
-  get_dynamic(&jobs->Q, (uchar*) ret, jobs->entry);
+  memcpy(ret, dynamic_array_ptr(&jobs->Q, (uint) (head % jobs->size)),
+         sizeof(Slave_job_item));
 
   DBUG_ASSERT(ret->data);         // todo: move to caller
 
@@ -1574,31 +1567,14 @@ static void * head_queue(Slave_jobs_queue *jobs, Slave_job_item *ret)
 
 /**
    return a job item through a struct which point is supplied via argument.
+   Only the Worker calls it, or the Worker's thread once the Worker stopped.
 */
 Slave_job_item * de_queue(Slave_jobs_queue *jobs, Slave_job_item *ret)
 {
-  if (jobs->entry == jobs->size)
-  {
-    DBUG_ASSERT(jobs->len == 0);
+  if (head_queue(jobs, ret) == NULL)
     return NULL;
-  }
-  get_dynamic(&jobs->Q, (uchar*) ret, jobs->entry);
-  jobs->len--;
-
-  // pre boundary cond
-  if (jobs->avail == jobs->size)
-    jobs->avail= jobs->entry;
-  jobs->entry= (jobs->entry + 1) % jobs->size;
-
-  // post boundary cond
-  if (jobs->avail == jobs->entry)
-    jobs->entry= jobs->size;
-
-  DBUG_ASSERT(jobs->entry == jobs->size ||
-              (jobs->len == (jobs->avail >= jobs->entry) ?
-               (jobs->avail - jobs->entry) :
-               (jobs->size + jobs->avail - jobs->entry)));
 
+  my_atomic_add64(&jobs->head, 1);
   return ret;
 }
 
@@ -1671,7 +1647,7 @@ bool append_item_to_jobs(slave_job_item *job_item,
     queue is empty or filled lightly (not more than underrun level).
   */
   if (rli->mts_wq_underrun_w_id == MTS_WORKER_UNDEF &&
-      worker->jobs.len > worker->underrun_level)
+      worker->jobs.length() > worker->underrun_level)
   {
     /*
       todo: experiment with weight to get a good approximation formula.
@@ -1696,34 +1672,64 @@ bool append_item_to_jobs(slave_job_item *job_item,
     rli->mts_wq_no_underrun_cnt++;
   }
 
-  mysql_mutex_lock(&worker->jobs_lock);
+  if (worker->running_status == Slave_worker::RUNNING && !thd->killed)
+    ret= en_queue(&worker->jobs, job_item);
 
   // possible WQ overfill
-  while (worker->running_status == Slave_worker::RUNNING && !thd->killed &&
-         (ret= en_queue(&worker->jobs, job_item)) == -1)
+  if (ret == -1)
   {
-    thd->ENTER_COND(&worker->jobs_cond, &worker->jobs_lock,
-                    &stage_slave_waiting_worker_queue, &old_stage);
-    worker->jobs.overfill= TRUE;
-    worker->jobs.waited_overfill++;
-    rli->mts_wq_overfill_cnt++;
-    mysql_cond_wait(&worker->jobs_cond, &worker->jobs_lock);
-    thd->EXIT_COND(&old_stage);
+    ulonglong stall_start= my_micro_time();
+
+    mysql_mutex_lock(&worker->jobs_lock);
+    while (worker->running_status == Slave_worker::RUNNING && !thd->killed)
+    {
+      // ask the Worker for a signal, then look again before sleeping
+      my_atomic_fas32(&worker->jobs.overfill, 1);
+      if ((ret= en_queue(&worker->jobs, job_item)) != -1)
+        break;
+      thd->ENTER_COND(&worker->jobs_cond, &worker->jobs_lock,
+                      &stage_slave_waiting_worker_queue, &old_stage);
+      worker->jobs.waited_overfill++;
+      rli->mts_wq_overfill_cnt++;
+      mysql_cond_wait(&worker->jobs_cond, &worker->jobs_lock);
+      thd->EXIT_COND(&old_stage);
+
+      mysql_mutex_lock(&worker->jobs_lock);
+    }
+    my_atomic_store32(&worker->jobs.overfill, 0);
+    mysql_mutex_unlock(&worker->jobs_lock);
+
+    rli->mts_wq_overfill_time+= my_micro_time() - stall_start;
+  }
 
+  if (ret != -1 && worker->running_status != Slave_worker::RUNNING)
+  {
+    /*
+      The Worker may have stopped and emptied its queue before the item
+      was published. Take the item back then, nobody else would.
+    */
     mysql_mutex_lock(&worker->jobs_lock);
+    if (worker->jobs.purged)
+    {
+      my_atomic_add64(&worker->jobs.tail, -1);
+      ret= -1;
+    }
+    mysql_mutex_unlock(&worker->jobs_lock);
   }
+
   if (ret != -1)
   {
-    worker->curr_jobs++;
-    if (worker->jobs.len == 1)
+    my_atomic_add32(&worker->curr_jobs, 1);
+    // the Worker sleeps only after marking, see pop_jobs_item()
+    if (my_atomic_load32(&worker->jobs.waiting))
+    {
+      mysql_mutex_lock(&worker->jobs_lock);
       mysql_cond_signal(&worker->jobs_cond);
-
-    mysql_mutex_unlock(&worker->jobs_lock);
+      mysql_mutex_unlock(&worker->jobs_lock);
+    }
   }
   else
   {
-    mysql_mutex_unlock(&worker->jobs_lock);
-
     mysql_mutex_lock(&rli->pending_jobs_lock);
     rli->pending_jobs--;                  // roll back of the prev incr
     rli->mts_pending_jobs_size -= ev_size;
@@ -1748,29 +1754,38 @@ struct slave_job_item* pop_jobs_item(Slave_worker *worker, Slave_job_item *job_i
 {
   THD *thd= worker->info_thd;
 
-  mysql_mutex_lock(&worker->jobs_lock);
+  if (!thd->killed && worker->running_status == Slave_worker::RUNNING)
+    head_queue(&worker->jobs, job_item);
 
-  while (!job_item->data && !thd->killed &&
-         worker->running_status == Slave_worker::RUNNING)
+  if (!job_item->data)
   {
-    PSI_stage_info old_stage;
+    mysql_mutex_lock(&worker->jobs_lock);
 
-    head_queue(&worker->jobs, job_item);
-    if (job_item->data == NULL)
+    while (!job_item->data && !thd->killed &&
+           worker->running_status == Slave_worker::RUNNING)
     {
-      worker->wq_empty_waits++;
-      thd->ENTER_COND(&worker->jobs_cond, &worker->jobs_lock,
-                               &stage_slave_waiting_event_from_coordinator,
-                               &old_stage);
-      mysql_cond_wait(&worker->jobs_cond, &worker->jobs_lock);
-      thd->EXIT_COND(&old_stage);
-      mysql_mutex_lock(&worker->jobs_lock);
+      PSI_stage_info old_stage;
+
+      // ask the Coordinator for a signal, then look again before sleeping
+      my_atomic_fas32(&worker->jobs.waiting, 1);
+      head_queue(&worker->jobs, job_item);
+      if (job_item->data == NULL)
+      {
+        worker->wq_empty_waits++;
+        thd->ENTER_COND(&worker->jobs_cond, &worker->jobs_lock,
+                                 &stage_slave_waiting_event_from_coordinator,
+                                 &old_stage);
+        mysql_cond_wait(&worker->jobs_cond, &worker->jobs_lock);
+        thd->EXIT_COND(&old_stage);
+        mysql_mutex_lock(&worker->jobs_lock);
+      }
     }
+    my_atomic_store32(&worker->jobs.waiting, 0);
+
+    mysql_mutex_unlock(&worker->jobs_lock);
   }
   if (job_item->data)
-    worker->curr_jobs--;
-
-  mysql_mutex_unlock(&worker->jobs_lock);
+    my_atomic_add32(&worker->curr_jobs, -1);
 
   thd_proc_info(worker->info_thd, "Executing event");
   return job_item;
@@ -1799,6 +1814,7 @@ int slave_worker_exec_job(Slave_worker *worker, Relay_log_info *rli)
   THD *thd= worker->info_thd;
   Log_event *ev= NULL;
   bool part_event= false;
+  ulong jobs_len;
 
   DBUG_ENTER("slave_worker_exec_job");
 
@@ -1895,17 +1911,16 @@ int slave_worker_exec_job(Slave_worker *worker, Relay_log_info *rli)
 #endif
   }
 
-  mysql_mutex_lock(&worker->jobs_lock);
   de_queue(&worker->jobs, job_item);
 
-  /* possible overfill */
-  if (worker->jobs.len == worker->jobs.size - 1 && worker->jobs.overfill == TRUE)
+  /* possible overfill, the Coordinator sleeps only after marking */
+  if (my_atomic_load32(&worker->jobs.overfill))
   {
-    worker->jobs.overfill= FALSE;
+    mysql_mutex_lock(&worker->jobs_lock);
     // todo: worker->hungry_cnt++;
     mysql_cond_signal(&worker->jobs_cond);
+    mysql_mutex_unlock(&worker->jobs_lock);
   }
-  mysql_mutex_unlock(&worker->jobs_lock);
 
   /* statistics */
 
@@ -1922,7 +1937,8 @@ int slave_worker_exec_job(Slave_worker *worker, Relay_log_info *rli)
     Zero of jobs.len has to reset underrun w_id as the worker may get
     the next piece of assignement in a long time.
   */
-  if (worker->underrun_level > worker->jobs.len && worker->jobs.len != 0)
+  jobs_len= worker->jobs.length();
+  if (worker->underrun_level > jobs_len && jobs_len != 0)
   {
     rli->mts_wq_underrun_w_id= worker->id;
   } else if (rli->mts_wq_underrun_w_id == worker->id)
@@ -1940,13 +1956,13 @@ int slave_worker_exec_job(Slave_worker *worker, Relay_log_info *rli)
     When the current queue length drops below overrun_level the global
     counter is decremented, the local is reset.
   */
-  if (worker->overrun_level < worker->jobs.len)
+  if (worker->overrun_level < jobs_len)
   {
     ulong last_overrun= worker->wq_overrun_cnt;
     ulong excess_delta;
 
     /* current overrun */
-    worker->wq_overrun_cnt= worker->jobs.len - worker->overrun_level;
+    worker->wq_overrun_cnt= jobs_len - worker->overrun_level;
     excess_delta= worker->wq_overrun_cnt - last_overrun;
     worker->excess_cnt+= excess_delta;
     rli->mts_wq_excess_cnt+= excess_delta;
@@ -275,16 +275,37 @@ public:
 
 };
 
+/**
+  Worker private queue of jobs.
+
+  The queue is a single producer single consumer ring over the
+  preallocated @c Q array: only the Coordinator advances @c tail and only
+  the Worker advances @c head, so appending and removing items needs no
+  lock. @c jobs_lock and @c jobs_cond of the Worker are only used to
+  sleep, when the Worker finds the queue empty or the Coordinator finds
+  it full; the other side signals only when the matching flag is set.
+*/
 class Slave_jobs_queue : public circular_buffer_queue
 {
 public:
 
+  volatile int64 head;   // number of items ever removed by the Worker
+  volatile int64 tail;   // number of items ever appended by the Coordinator
   /* 
-     Coordinator marks with true, Worker signals back at queue back to
-     available
+     Coordinator marks with 1 when it sleeps on a full queue, Worker
+     signals back at queue back to available
   */
-  bool overfill;
+  volatile int32 overfill;
+  /* Worker marks with 1 when it sleeps on an empty queue */
+  volatile int32 waiting;
+  /* Worker has emptied the queue on exit, guarded by jobs_lock */
+  bool purged;
   ulonglong waited_overfill;
+
+  ulong length()
+  {
+    return (ulong) (my_atomic_load64(&tail) - my_atomic_load64(&head));
+  }
 };
 
 class Slave_worker : public Relay_log_info
@@ -322,7 +343,7 @@ public:
   ulong wq_empty_waits;  // how many times got idle
   ulong events_done;     // how many events (statements) processed
   ulong groups_done;     // how many groups (transactions) processed
-  volatile int curr_jobs; // number of active  assignments
+  volatile int32 curr_jobs; // number of active  assignments
   // number of partitions allocated to the worker at point in time
   long usage_partition;
   // symmetric to rli->mts_end_group_sets_max_dbs
@@ -3584,6 +3584,7 @@ apply_event_and_update_pos(Log_event** ptr_ev, THD* thd, Relay_log_info* rli)
                                 "events assigned = %llu; "
                                 "worker queues filled over overrun level = %lu; "
                                 "waited due a Worker queue full = %lu; "
+                                "usecs waited due a Worker queue full = %llu; "
                                 "waited due the total size = %lu; "
                                 "slept when Workers occupied = %lu ",
                                 static_cast<unsigned long>
@@ -3591,6 +3592,7 @@ apply_event_and_update_pos(Log_event** ptr_ev, THD* thd, Relay_log_info* rli)
                                 rli->mts_events_assigned,
                                 rli->mts_wq_overrun_cnt,
                                 rli->mts_wq_overfill_cnt,
+                                rli->mts_wq_overfill_time,
                                 rli->wq_size_waits_cnt,
                                 rli->mts_wq_no_underrun_cnt);
           rli->mts_last_online_stat= my_now;
@@ -4137,10 +4139,8 @@ pthread_handler_t handle_slave_io(void *arg)
     goto err;
   }
 
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
   thd_added= true;
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   mi->slave_running = 1;
   mi->abort_slave = 0;
@@ -4464,11 +4464,9 @@ err:
   net_end(&thd->net); // destructor will not free it, because net.vio is 0
 
   thd->release_resources();
-  mysql_mutex_lock(&LOCK_thread_count);
   THD_CHECK_SENTRY(thd);
   if (thd_added)
     remove_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   mi->abort_slave= 0;
   mi->slave_running= 0;
@@ -4588,10 +4586,8 @@ pthread_handler_t handle_slave_worker(void *arg)
   }
   thd->init_for_queries(w);
 
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
   thd_added= true;
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   if (w->update_is_transactional())
   {
@@ -4630,7 +4626,8 @@ pthread_handler_t handle_slave_worker(void *arg)
     delete static_cast<Log_event*>(job_item->data);
   }
 
-  DBUG_ASSERT(w->jobs.len == 0);
+  DBUG_ASSERT(w->jobs.length() == 0);
+  w->jobs.purged= true;
 
   mysql_mutex_unlock(&w->jobs_lock);
 
@@ -4684,11 +4681,9 @@ err:
     thd->system_thread= NON_SYSTEM_THREAD;
     thd->release_resources();
 
-    mysql_mutex_lock(&LOCK_thread_count);
     THD_CHECK_SENTRY(thd);
     if (thd_added)
       remove_global_thread(thd);
-    mysql_mutex_unlock(&LOCK_thread_count);
     delete thd;
   }
 
@@ -5089,7 +5084,8 @@ bool mts_checkpoint_routine(Relay_log_info *rli, ulonglong period,
   {
     Slave_worker *w_i;
     get_dynamic(&rli->workers, (uchar *) &w_i, i);
-    set_dynamic(&rli->least_occupied_workers, (uchar*) &w_i->jobs.len, w_i->id);
+    ulong jobs_len= w_i->jobs.length();
+    set_dynamic(&rli->least_occupied_workers, (uchar*) &jobs_len, w_i->id);
   };
   sort_dynamic(&rli->least_occupied_workers, (qsort_cmp) ulong_cmp);
 
@@ -5198,7 +5194,10 @@ int slave_start_single_worker(Relay_log_info *rli, ulong i)
     mysql_cond_wait(&w->jobs_cond, &w->jobs_lock);
   mysql_mutex_unlock(&w->jobs_lock);
   // Least occupied inited with zero
-  insert_dynamic(&rli->least_occupied_workers, (uchar*) &w->jobs.len);
+  {
+    ulong jobs_len= w->jobs.length();
+    insert_dynamic(&rli->least_occupied_workers, (uchar*) &jobs_len);
+  }
 
 err:
   if (error && w)
@@ -5457,10 +5456,12 @@ void slave_stop_workers(Relay_log_info *rli, bool *mts_inited)
                         "events processed = %llu; "
                         "worker queues filled over overrun level = %lu; "
                         "waited due a Worker queue full = %lu; "
+                        "usecs waited due a Worker queue full = %llu; "
                         "waited due the total size = %lu; "
                         "slept when Workers occupied = %lu ",
                         rli->mts_events_assigned, rli->mts_wq_overrun_cnt,
-                        rli->mts_wq_overfill_cnt, rli->wq_size_waits_cnt,
+                        rli->mts_wq_overfill_cnt, rli->mts_wq_overfill_time,
+                        rli->wq_size_waits_cnt,
                         rli->mts_wq_no_underrun_cnt);
 
   DBUG_ASSERT(rli->pending_jobs == 0);
@@ -5564,10 +5565,8 @@ pthread_handler_t handle_slave_sql(void *arg)
   thd->temporary_tables = rli->save_temporary_tables; // restore temp tables
   set_thd_in_use_temporary_tables(rli);   // (re)set sql_thd in use for saved temp tables
 
-  mysql_mutex_lock(&LOCK_thread_count);
   add_global_thread(thd);
   thd_added= true;
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   /* MTS: starting the worker pool */
   if (slave_start_workers(rli, rli->opt_slave_parallel_workers, &mts_inited) != 0)
@@ -5892,11 +5891,9 @@ llstr(rli->get_group_master_log_pos(), llbuff));
   set_thd_in_use_temporary_tables(rli);  // (re)set info_thd in use for saved temp tables
 
   thd->release_resources();
-  mysql_mutex_lock(&LOCK_thread_count);
   THD_CHECK_SENTRY(thd);
   if (thd_added)
     remove_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   /*
     The thd can only be destructed after indirect references
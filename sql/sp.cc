@@ -540,6 +540,230 @@ db_find_routine_aux(THD *thd, enum_sp_type type, sp_name *name, TABLE *table)
 }
 
 
+/*************************************************************************
+  Server-wide cache of routine definitions
+
+  The definitions read from mysql.proc by db_find_routine() are kept in a
+  cache shared by all connections, so that a connection that does not
+  have a routine in its own sp_cache yet does not have to read mysql.proc
+  again. It still has to parse the definition: an sp_head carries state
+  of its executions, and it can't be shared between connections.
+
+  The entries are versioned like the sp_head objects in the caches of the
+  connections: an entry is used only as long as sp_cache_version() is
+  the one read before its row was read, so sp_cache_invalidate() also
+  invalidates all entries.
+*************************************************************************/
+
+/** Routine attributes stored in mysql.proc */
+struct Sp_definition
+{
+  sql_mode_t sql_mode;
+  const char *params;
+  const char *returns;
+  const char *body;
+  const char *definer;
+  longlong created;
+  longlong modified;
+  st_sp_chistics chistics;
+  Stored_program_creation_ctx *creation_ctx;
+};
+
+struct Sp_definition_entry
+{
+  MEM_ROOT mem_root;
+  /* Routine type, followed by the qualified name */
+  uchar key[1 + NAME_LEN + 1 + NAME_LEN];
+  size_t key_length;
+  ulong version;
+  Sp_definition def;
+};
+
+static HASH sp_definitions;
+static mysql_mutex_t LOCK_sp_definitions;
+static bool sp_definitions_inited= false;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_sp_definitions;
+
+static PSI_mutex_info all_sp_definitions_mutexes[]=
+{
+  { &key_LOCK_sp_definitions, "LOCK_sp_definitions", PSI_FLAG_GLOBAL}
+};
+#endif
+
+extern "C" uchar *sp_definition_get_key(const uchar *ptr, size_t *length,
+                                        my_bool first);
+extern "C" void sp_definition_free(void *ptr);
+
+uchar *sp_definition_get_key(const uchar *ptr, size_t *length, my_bool first)
+{
+  Sp_definition_entry *entry= (Sp_definition_entry *) ptr;
+  *length= entry->key_length;
+  return entry->key;
+}
+
+
+void sp_definition_free(void *ptr)
+{
+  Sp_definition_entry *entry= (Sp_definition_entry *) ptr;
+  MEM_ROOT mem_root= entry->mem_root;
+  free_root(&mem_root, MYF(0));                 // entry is in its mem_root
+}
+
+
+void sp_definition_cache_init()
+{
+#ifdef HAVE_PSI_INTERFACE
+  mysql_mutex_register("sql", all_sp_definitions_mutexes,
+                       array_elements(all_sp_definitions_mutexes));
+#endif
+  mysql_mutex_init(key_LOCK_sp_definitions, &LOCK_sp_definitions,
+                   MY_MUTEX_INIT_FAST);
+  /* Like the key of mysql.proc, the names are compared case sensitively */
+  (void) my_hash_init(&sp_definitions, &my_charset_bin, 64, 0, 0,
+                      sp_definition_get_key, sp_definition_free, 0);
+  sp_definitions_inited= true;
+}
+
+
+void sp_definition_cache_flush()
+{
+  mysql_mutex_lock(&LOCK_sp_definitions);
+  my_hash_reset(&sp_definitions);
+  mysql_mutex_unlock(&LOCK_sp_definitions);
+}
+
+
+void sp_definition_cache_free()
+{
+  if (!sp_definitions_inited)
+    return;
+  sp_definitions_inited= false;
+  my_hash_free(&sp_definitions);
+  mysql_mutex_destroy(&LOCK_sp_definitions);
+}
+
+
+/**
+  Create the key of a routine in the server-wide cache.
+
+  @return Length of the key, or 0 if the name is too long
+*/
+
+static size_t sp_definition_key(uchar *key, enum_sp_type type,
+                                const sp_name *name)
+{
+  if (name->m_qname.length > 1 + NAME_LEN + NAME_LEN)
+    return 0;
+  key[0]= (uchar) type;
+  memcpy(key + 1, name->m_qname.str, name->m_qname.length);
+  return name->m_qname.length + 1;
+}
+
+
+/**
+  Copy a routine definition with the strings it refers to.
+
+  @retval false  Success
+  @retval true   Out of memory
+*/
+
+static bool copy_definition(MEM_ROOT *mem_root, const Sp_definition *from,
+                            Sp_definition *to)
+{
+  *to= *from;
+  return (!(to->params= strdup_root(mem_root, from->params)) ||
+          !(to->returns= strdup_root(mem_root, from->returns)) ||
+          !(to->body= strdup_root(mem_root, from->body)) ||
+          !(to->definer= strdup_root(mem_root, from->definer)) ||
+          (from->chistics.comment.length &&
+           !(to->chistics.comment.str=
+             strmake_root(mem_root, from->chistics.comment.str,
+                          from->chistics.comment.length))) ||
+          !(to->creation_ctx= from->creation_ctx->clone(mem_root)));
+}
+
+
+/**
+  Look up the definition of a routine in the server-wide cache.
+
+  @param thd        Thread context, the definition is copied to its mem_root
+  @param type       Type of the routine
+  @param name       Name of the routine
+  @param[out] def   The definition
+
+  @retval true   An up-to-date definition was found
+  @retval false  The definition is to be read from mysql.proc
+*/
+
+static bool sp_definition_cache_get(THD *thd, enum_sp_type type,
+                                    const sp_name *name, Sp_definition *def)
+{
+  uchar key[1 + NAME_LEN + 1 + NAME_LEN];
+  size_t key_length= sp_definition_key(key, type, name);
+  Sp_definition_entry *entry;
+  bool found= false;
+
+  if (!key_length)
+    return false;
+
+  mysql_mutex_lock(&LOCK_sp_definitions);
+  if ((entry= (Sp_definition_entry *) my_hash_search(&sp_definitions, key,
+                                                     key_length)))
+  {
+    if (entry->version != sp_cache_version())
+      my_hash_delete(&sp_definitions, (uchar *) entry);
+    else
+      found= !copy_definition(thd->mem_root, &entry->def, def);
+  }
+  mysql_mutex_unlock(&LOCK_sp_definitions);
+  return found;
+}
+
+
+/**
+  Put the definition of a routine read from mysql.proc in the server-wide
+  cache.
+
+  @param type     Type of the routine
+  @param name     Name of the routine
+  @param version  sp_cache_version() before mysql.proc was read
+  @param def      The definition
+*/
+
+static void sp_definition_cache_put(enum_sp_type type, const sp_name *name,
+                                    ulong version, const Sp_definition *def)
+{
+  MEM_ROOT mem_root;
+  Sp_definition_entry *entry, *old_entry;
+
+  init_sql_alloc(key_memory_sp_head_main_root, &mem_root, 1024, 0);
+  if (!(entry= (Sp_definition_entry *)
+        alloc_root(&mem_root, sizeof(Sp_definition_entry))) ||
+      !(entry->key_length= sp_definition_key(entry->key, type, name)) ||
+      copy_definition(&mem_root, def, &entry->def))
+  {
+    free_root(&mem_root, MYF(0));
+    return;
+  }
+  entry->version= version;
+
+  entry->mem_root= mem_root;
+
+  mysql_mutex_lock(&LOCK_sp_definitions);
+  if ((old_entry= (Sp_definition_entry *)
+       my_hash_search(&sp_definitions, entry->key, entry->key_length)))
+    my_hash_delete(&sp_definitions, (uchar *) old_entry);
+  /* The same soft limit as for the routines cached by a connection */
+  if (sp_definitions.records >= stored_program_cache_size)
+    my_hash_reset(&sp_definitions);
+  if (my_hash_insert(&sp_definitions, (uchar *) entry))
+    sp_definition_free(entry);
+  mysql_mutex_unlock(&LOCK_sp_definitions);
+}
+
+
 /**
   Find routine definition in mysql.proc table and create corresponding
   sp_head object for it.
@@ -554,6 +778,10 @@ db_find_routine_aux(THD *thd, enum_sp_type type, sp_name *name, TABLE *table)
     This function may damage current LEX during execution, so it is good
     idea to create temporary LEX and make it active before calling it.
 
+  @note
+    The definition is taken from the server-wide cache of definitions if
+    it is there, and put there otherwise.
+
   @retval
     0       Success
   @retval
@@ -578,12 +806,27 @@ db_find_routine(THD *thd, enum_sp_type type, sp_name *name, sp_head **sphp)
   sql_mode_t sql_mode, saved_mode= thd->variables.sql_mode;
   Open_tables_backup open_tables_state_backup;
   Stored_program_creation_ctx *creation_ctx;
+  Sp_definition def;
+  /* Read before mysql.proc, so that a concurrent change invalidates def */
+  ulong version= sp_cache_version();
 
   DBUG_ENTER("db_find_routine");
   DBUG_PRINT("enter", ("type: %d name: %.*s",
 		       type, (int) name->m_name.length, name->m_name.str));
 
   *sphp= 0;                                     // In case of errors
+  if (sp_definition_cache_get(thd, type, name, &def))
+  {
+    DBUG_PRINT("info", ("definition found in the server-wide cache"));
+    thd->variables.sql_mode= 0;
+    ret= db_load_routine(thd, type, name, sphp,
+                         def.sql_mode, def.params, def.returns, def.body,
+                         def.chistics, def.definer, def.created,
+                         def.modified, def.creation_ctx);
+    thd->variables.sql_mode= saved_mode;
+    DBUG_RETURN(ret);
+  }
+
   if (!(table= open_proc_table_for_read(thd, &open_tables_state_backup)))
     DBUG_RETURN(SP_OPEN_TABLE_FAILED);
 
@@ -687,6 +930,17 @@ db_find_routine(THD *thd, enum_sp_type type, sp_name *name, sp_head **sphp)
   close_system_tables(thd, &open_tables_state_backup);
   table= 0;
 
+  def.sql_mode= sql_mode;
+  def.params= params;
+  def.returns= returns;
+  def.body= body;
+  def.definer= definer;
+  def.created= created;
+  def.modified= modified;
+  def.chistics= chistics;
+  def.creation_ctx= creation_ctx;
+  sp_definition_cache_put(type, name, version, &def);
+
   ret= db_load_routine(thd, type, name, sphp,
                        sql_mode, params, returns, body, chistics,
                        definer, created, modified, creation_ctx);
@@ -79,6 +79,11 @@ enum
   MYSQL_PROC_FIELD_COUNT
 };
 
+/* Server-wide cache of the routine definitions read from mysql.proc */
+void sp_definition_cache_init();
+void sp_definition_cache_free();
+void sp_definition_cache_flush();
+
 /* Drop all routines in database 'db' */
 int sp_drop_db_routines(THD *thd, char *db);
 
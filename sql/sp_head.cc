@@ -264,7 +264,12 @@ sp_head::sp_head(enum_sp_type type)
   m_root_parsing_ctx(NULL),
   m_sp_cache_version(0),
   m_creation_ctx(NULL),
-  unsafe_flags(0)
+  unsafe_flags(0),
+  m_trigger_call_arena(&m_trigger_call_mem_root, STMT_INITIALIZED_FOR_SP),
+  m_trigger_runtime_ctx(NULL),
+  m_trigger_query_id(0),
+  m_trigger_invoker_ctx(NULL),
+  m_trigger_security_ctx_changed(false)
 {
   m_first_instance= this;
   m_first_free_instance= this;
@@ -295,6 +300,9 @@ sp_head::sp_head(enum_sp_type type)
   m_trg_chistics.ordering_clause= TRG_ORDER_NONE;
   m_trg_chistics.anchor_trigger_name.str= NULL;
   m_trg_chistics.anchor_trigger_name.length= 0;
+
+  init_sql_alloc(key_memory_sp_head_call_root,
+                 &m_trigger_call_mem_root, MEM_ROOT_BLOCK_SIZE, 0);
 }
 
 
@@ -454,6 +462,8 @@ sp_head::~sp_head()
   // Parsing of SP-body must have been already finished.
   DBUG_ASSERT(!m_parser_data.is_parsing_sp_body());
 
+  free_trigger_runtime_ctx();
+
   for (uint ip = 0 ; (i = get_instr(ip)) ; ip++)
     delete i;
 
@@ -748,7 +758,15 @@ bool sp_head::execute(THD *thd, bool merge_da_on_success)
                                                 this->m_sp_share);
 #endif
 
-    err_status= i->execute(thd, &ip);
+    /*
+      Assignments which use no table and no stored routine, such as
+      SET NEW.a= NEW.b * 2, are evaluated without setting up a statement
+      once they have been executed.
+    */
+    if (i->is_simple())
+      err_status= i->execute_simple(thd, &ip);
+    else
+      err_status= i->execute(thd, &ip);
 
 #ifdef HAVE_PSI_STATEMENT_INTERFACE
     MYSQL_END_STATEMENT(thd->m_statement_psi, thd->get_stmt_da());
@@ -927,65 +945,104 @@ bool sp_head::execute(THD *thd, bool merge_da_on_success)
 }
 
 
+void sp_head::free_trigger_runtime_ctx()
+{
+  delete m_trigger_runtime_ctx;
+  m_trigger_runtime_ctx= NULL;
+  m_trigger_call_arena.free_items();
+  free_root(&m_trigger_call_mem_root, MYF(0));
+  init_sql_alloc(key_memory_sp_head_call_root,
+                 &m_trigger_call_mem_root, MEM_ROOT_BLOCK_SIZE, 0);
+}
+
+
 bool sp_head::execute_trigger(THD *thd,
                               const LEX_STRING *db_name,
                               const LEX_STRING *table_name,
                               GRANT_INFO *grant_info)
 {
   sp_rcontext *parent_sp_runtime_ctx = thd->sp_runtime_ctx;
+  Security_context *invoker_ctx= thd->security_ctx;
   bool err_status= FALSE;
-  MEM_ROOT call_mem_root;
-  Query_arena call_arena(&call_mem_root, Query_arena::STMT_INITIALIZED_FOR_SP);
   Query_arena backup_arena;
 
   DBUG_ENTER("sp_head::execute_trigger");
   DBUG_PRINT("info", ("trigger %s", m_name.str));
 
+  /*
+    A multi-row statement calls the trigger once per row, with the same
+    query id and the same invoker. The runtime context created for the
+    first row, and the result of the privilege checks, are reused for the
+    following ones. The query id is unique, so that the context is never
+    reused by another statement or another thread.
+  */
+  bool reuse_ctx= m_trigger_runtime_ctx != NULL &&
+                  m_trigger_query_id == thd->query_id &&
+                  m_trigger_invoker_ctx == invoker_ctx;
+
 #ifndef NO_EMBEDDED_ACCESS_CHECKS
   Security_context *save_ctx= NULL;
 
+  if (reuse_ctx)
+  {
+    if (m_trigger_security_ctx_changed)
+    {
+      save_ctx= thd->security_ctx;
+      thd->security_ctx= &m_security_ctx;
+    }
+  }
+  else
+  {
+    free_trigger_runtime_ctx();
+
+    if (m_chistics->suid != SP_IS_NOT_SUID &&
+        m_security_ctx.change_security_context(thd,
+                                               &m_definer_user,
+                                               &m_definer_host,
+                                               &m_db,
+                                               &save_ctx))
+      DBUG_RETURN(true);
 
-  if (m_chistics->suid != SP_IS_NOT_SUID &&
-      m_security_ctx.change_security_context(thd,
-                                             &m_definer_user,
-                                             &m_definer_host,
-                                             &m_db,
-                                             &save_ctx))
-    DBUG_RETURN(true);
+    /*
+      Fetch information about table-level privileges for subject table into
+      GRANT_INFO instance. The access check itself will happen in
+      Item_trigger_field, where this information will be used along with
+      information about column-level privileges.
+    */
 
-  /*
-    Fetch information about table-level privileges for subject table into
-    GRANT_INFO instance. The access check itself will happen in
-    Item_trigger_field, where this information will be used along with
-    information about column-level privileges.
-  */
+    fill_effective_table_privileges(thd,
+                                    grant_info,
+                                    db_name->str,
+                                    table_name->str);
 
-  fill_effective_table_privileges(thd,
-                                  grant_info,
-                                  db_name->str,
-                                  table_name->str);
+    /* Check that the definer has TRIGGER privilege on the subject table. */
 
-  /* Check that the definer has TRIGGER privilege on the subject table. */
+    if (!(grant_info->privilege & TRIGGER_ACL))
+    {
+      char priv_desc[128];
+      get_privilege_desc(priv_desc, sizeof(priv_desc), TRIGGER_ACL);
 
-  if (!(grant_info->privilege & TRIGGER_ACL))
-  {
-    char priv_desc[128];
-    get_privilege_desc(priv_desc, sizeof(priv_desc), TRIGGER_ACL);
+      my_error(ER_TABLEACCESS_DENIED_ERROR, MYF(0), priv_desc,
+               thd->security_ctx->priv_user, thd->security_ctx->host_or_ip,
+               table_name->str);
 
-    my_error(ER_TABLEACCESS_DENIED_ERROR, MYF(0), priv_desc,
-             thd->security_ctx->priv_user, thd->security_ctx->host_or_ip,
-             table_name->str);
+      m_security_ctx.restore_security_context(thd, save_ctx);
+      DBUG_RETURN(true);
+    }
+    /*
+      Optimizer trace note: we needn't explicitly test here that the
+      connected user has TRIGGER privilege: assume he doesn't have it; two
+      possibilities:
+      - connected user == definer: then we threw an error just above;
+      - connected user != definer: then in sp_head::execute(), when checking
+      the security context we will disable tracing.
+    */
 
-    m_security_ctx.restore_security_context(thd, save_ctx);
-    DBUG_RETURN(true);
+    m_trigger_security_ctx_changed= (save_ctx != NULL);
   }
-  /*
-    Optimizer trace note: we needn't explicitly test here that the connected
-    user has TRIGGER privilege: assume he doesn't have it; two possibilities:
-    - connected user == definer: then we threw an error just above;
-    - connected user != definer: then in sp_head::execute(), when checking the
-    security context we will disable tracing.
-  */
+#else
+  if (!reuse_ctx)
+    free_trigger_runtime_ctx();
 #endif // NO_EMBEDDED_ACCESS_CHECKS
 
   /*
@@ -996,25 +1053,25 @@ bool sp_head::execute_trigger(THD *thd,
     some fixed amount of memory will be consumed for each trigger
     invocation and so statements which involve lot of them will hog
     memory.
-
-    TODO: we should create sp_rcontext once per command and reuse it
-    on subsequent executions of a trigger.
   */
-  init_sql_alloc(key_memory_sp_head_call_root,
-                 &call_mem_root, MEM_ROOT_BLOCK_SIZE, 0);
-  thd->set_n_backup_active_arena(&call_arena, &backup_arena);
-
-  sp_rcontext *trigger_runtime_ctx=
-    sp_rcontext::create(thd, m_root_parsing_ctx, NULL);
+  thd->set_n_backup_active_arena(&m_trigger_call_arena, &backup_arena);
 
-  if (!trigger_runtime_ctx)
+  if (!reuse_ctx)
   {
-    err_status= TRUE;
-    goto err_with_cleanup;
+    m_trigger_runtime_ctx= sp_rcontext::create(thd, m_root_parsing_ctx, NULL);
+
+    if (!m_trigger_runtime_ctx)
+    {
+      err_status= TRUE;
+      goto err_with_cleanup;
+    }
+
+    m_trigger_runtime_ctx->sp= this;
+    m_trigger_query_id= thd->query_id;
+    m_trigger_invoker_ctx= invoker_ctx;
   }
 
-  trigger_runtime_ctx->sp= this;
-  thd->sp_runtime_ctx= trigger_runtime_ctx;
+  thd->sp_runtime_ctx= m_trigger_runtime_ctx;
 
 #ifdef HAVE_PSI_SP_INTERFACE
   PSI_sp_locker_state state;
@@ -1028,15 +1085,20 @@ bool sp_head::execute_trigger(THD *thd,
 #endif
 
 err_with_cleanup:
-  thd->restore_active_arena(&call_arena, &backup_arena);
+  thd->restore_active_arena(&m_trigger_call_arena, &backup_arena);
 
 #ifndef NO_EMBEDDED_ACCESS_CHECKS
   m_security_ctx.restore_security_context(thd, save_ctx);
 #endif // NO_EMBEDDED_ACCESS_CHECKS
 
-  delete trigger_runtime_ctx;
-  call_arena.free_items();
-  free_root(&call_mem_root, MYF(0));
+  /*
+    Do not keep a context which an error, a handler or a cursor may have
+    left in an unknown state.
+  */
+  if (err_status || thd->killed ||
+      (m_trigger_runtime_ctx && !m_trigger_runtime_ctx->is_reusable()))
+    free_trigger_runtime_ctx();
+
   thd->sp_runtime_ctx= parent_sp_runtime_ctx;
 
   if (thd->killed)
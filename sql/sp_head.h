@@ -656,9 +656,10 @@ public:
                              information about definer's privileges
                              on subject table
 
-    @todo
-      - TODO: we should create sp_rcontext once per command and reuse it
-      on subsequent executions of a trigger.
+    The runtime context, and the result of the definer privilege checks,
+    are created for the first row of a statement and kept until the trigger
+    is called for another statement: the following rows only re-run the
+    trigger body.
 
     @return Error status.
   */
@@ -1008,6 +1009,25 @@ private:
   /// Flags of LEX::enum_binlog_stmt_unsafe.
   uint32 unsafe_flags;
 
+  /**
+    Memory root and arena of the cached trigger runtime context.
+    They live as long as the context, rather than for one trigger call.
+  */
+  MEM_ROOT m_trigger_call_mem_root;
+  Query_arena m_trigger_call_arena;
+
+  /// Trigger runtime context, reused for all rows of the same statement.
+  sp_rcontext *m_trigger_runtime_ctx;
+
+  /// Id of the statement m_trigger_runtime_ctx was created for.
+  query_id_t m_trigger_query_id;
+
+  /// Security context of the invoker of that statement.
+  Security_context *m_trigger_invoker_ctx;
+
+  /// true if the trigger runs with m_security_ctx, not the invoker's one.
+  bool m_trigger_security_ctx_changed;
+
 private:
   /// Copy sp name from parser.
   void init_sp_name(THD *thd, sp_name *spname);
@@ -1029,6 +1049,9 @@ private:
   */
   bool execute(THD *thd, bool merge_da_on_success);
 
+  /// Free the cached trigger runtime context, if any.
+  void free_trigger_runtime_ctx();
+
   /**
     Perform a forward flow analysis in the generated code.
     Mark reachable instructions, for the optimizer.
@@ -443,6 +443,41 @@ bool sp_lex_instr::reset_lex_and_exec_core(THD *thd,
 }
 
 
+bool sp_lex_instr::is_simple_expr() const
+{
+  return !is_invalid() &&
+         !m_first_execution &&
+         !m_lex->query_tables &&
+         !m_lex->uses_stored_routines() &&
+         !m_lex->select_lex->first_inner_unit();
+}
+
+
+bool sp_lex_instr::execute_simple_expr(THD *thd, uint *nextp)
+{
+  DBUG_ASSERT(is_simple_expr());
+
+  clear_da(thd);
+
+  /*
+    There is no table to open, lock or re-validate, and no subquery to
+    re-initialize, so that reset_lex_and_exec_core() can be skipped.
+    The LEX-object may still have been used last by another thread.
+  */
+
+  LEX *lex_saved= thd->lex;
+  thd->lex= m_lex;
+  m_lex->thd= thd;
+
+  bool rc= exec_core(thd, nextp);
+
+  thd->rollback_item_tree_changes();
+  thd->lex= lex_saved;
+
+  return rc || thd->is_error();
+}
+
+
 LEX *sp_lex_instr::parse_expr(THD *thd, sp_head *sp)
 {
   String sql_query;
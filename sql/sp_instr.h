@@ -104,6 +104,30 @@ public:
   sp_pcontext *get_parsing_ctx() const
   { return m_parsing_ctx; }
 
+  /**
+    Check if this instruction can be executed by execute_simple(), without
+    the statement set up done by execute().
+
+    @return true if execute_simple() can be used.
+  */
+  virtual bool is_simple() const
+  { return false; }
+
+  /**
+    Execute this instruction without setting up a statement: no table is
+    opened, and no query id is assigned. Only valid if is_simple().
+
+    @param thd         Thread context.
+    @param[out] nextp  index of the next instruction to execute.
+
+    @return Error status.
+  */
+  virtual bool execute_simple(THD *thd, uint *nextp)
+  {
+    DBUG_ASSERT(false);
+    return true;
+  }
+
 protected:
   /**
     Clear diagnostics area.
@@ -229,6 +253,26 @@ public:
   */
   bool validate_lex_and_execute_core(THD *thd, uint *nextp, bool open_tables);
 
+protected:
+  /**
+    Check if the expression of this instruction can be evaluated without
+    setting up a statement: the LEX-object has already been executed, and
+    uses no table, subquery or stored routine.
+
+    @return true if the expression can be evaluated by execute_simple_expr().
+  */
+  bool is_simple_expr() const;
+
+  /**
+    Call exec_core() without setting up a statement, if is_simple_expr().
+
+    @param thd         Thread context.
+    @param[out] nextp  index of the next instruction to execute.
+
+    @return Error status.
+  */
+  bool execute_simple_expr(THD *thd, uint *nextp);
+
 private:
   /**
     Prepare LEX and thread for execution of instruction, if requested open
@@ -595,6 +639,16 @@ public:
 
   virtual void cleanup_before_parsing(THD *thd);
 
+  /////////////////////////////////////////////////////////////////////////
+  // sp_instr implementation.
+  /////////////////////////////////////////////////////////////////////////
+
+  virtual bool is_simple() const
+  { return is_simple_expr(); }
+
+  virtual bool execute_simple(THD *thd, uint *nextp)
+  { return execute_simple_expr(thd, nextp); }
+
   virtual LEX_STRING get_expr_query() const
   { return m_value_query; }
 
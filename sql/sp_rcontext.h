@@ -143,6 +143,15 @@ public:
   /// of the client/server protocol.
   bool end_partial_result_set;
 
+  /// @return true if no handler and no cursor is left on the context,
+  /// so that it can be reused for the next call of the same routine.
+  bool is_reusable() const
+  {
+    return !m_visible_handlers.elements() &&
+           !m_activated_handlers.elements() &&
+           !m_ccount;
+  }
+
   /// The stored program for which this runtime context is created.
   sp_head *sp;
 
@@ -173,7 +173,12 @@ Repair_mrg_table_error_handler::handle_condition(THD *,
      .frm file from where the table share is initialised.
   4) In particular the share->ref_count is updated each time
      a new table object is created that refers to a table share.
-     This update is protected by LOCK_open.
+     This update is protected by LOCK_open, with one exception: a
+     thread that finds the share through the Table_cache_element of
+     its table cache can add a reference while holding only the lock
+     of that cache, as the TABLE objects of the cache keep the share
+     referenced. Because of this ref_count is always changed with
+     atomic operations, see pin_table_share().
   5) oldest_unused_share, end_of_unused_share and share->next
      and share->prev are variables to handle the lists of table
      share objects, these can only be read and manipulated while
@@ -232,6 +237,44 @@ HASH table_def_cache;
 static TABLE_SHARE *oldest_unused_share, end_of_unused_share;
 static bool table_def_inited= false;
 static bool table_def_shutdown_in_progress= false;
+my_atomic_rwlock_t table_share_ref_count_lock;
+
+
+/**
+  Add a reference to a table share.
+
+  @note Caller must hold LOCK_open, or the lock of a table cache that
+        has TABLE objects for the share (see the comment for LOCK_open).
+
+  @return The number of references before this one
+*/
+
+static inline int32 pin_table_share(TABLE_SHARE *share)
+{
+  int32 old_count;
+  my_atomic_rwlock_wrlock(&table_share_ref_count_lock);
+  old_count= my_atomic_add32(&share->ref_count, 1);
+  my_atomic_rwlock_wrunlock(&table_share_ref_count_lock);
+  return old_count;
+}
+
+
+/**
+  Remove a reference to a table share.
+
+  @note Caller must hold LOCK_open.
+
+  @return The number of references left
+*/
+
+static inline int32 unpin_table_share(TABLE_SHARE *share)
+{
+  int32 old_count;
+  my_atomic_rwlock_wrlock(&table_share_ref_count_lock);
+  old_count= my_atomic_add32(&share->ref_count, -1);
+  my_atomic_rwlock_wrunlock(&table_share_ref_count_lock);
+  return old_count - 1;
+}
 
 static bool check_and_update_table_version(THD *thd, TABLE_LIST *tables,
                                            TABLE_SHARE *table_share);
@@ -364,11 +407,13 @@ bool table_def_init(void)
   init_tdc_psi_keys();
 #endif
   mysql_mutex_init(key_LOCK_open, &LOCK_open, MY_MUTEX_INIT_FAST);
+  my_atomic_rwlock_init(&table_share_ref_count_lock);
   oldest_unused_share= &end_of_unused_share;
   end_of_unused_share.prev= &oldest_unused_share;
 
   if (table_cache_manager.init())
   {
+    my_atomic_rwlock_destroy(&table_share_ref_count_lock);
     mysql_mutex_destroy(&LOCK_open);
     return true;
   }
@@ -419,6 +464,7 @@ void table_def_free(void)
     /* Free table definitions. */
     my_hash_free(&table_def_cache);
     table_cache_manager.destroy();
+    my_atomic_rwlock_destroy(&table_share_ref_count_lock);
     mysql_mutex_destroy(&LOCK_open);
   }
   DBUG_VOID_RETURN;
@@ -511,7 +557,7 @@ TABLE_SHARE *get_table_share(THD *thd, TABLE_LIST *table_list,
     (void) my_hash_delete(&table_def_cache, (uchar*) share);
     DBUG_RETURN(0);
   }
-  share->ref_count++;				// Mark in use
+  pin_table_share(share);			// Mark in use
 
 #ifdef HAVE_PSI_TABLE_INTERFACE
   share->m_psi= PSI_TABLE_CALL(get_table_share)(false, share);
@@ -540,9 +586,7 @@ found:
     DBUG_RETURN(0);
   }
 
-  ++share->ref_count;
-
-  if (share->ref_count == 1 && share->prev)
+  if (pin_table_share(share) == 0 && share->prev)
   {
     /*
       Share was not used before and it was in the old_unused_share list
@@ -680,7 +724,7 @@ void release_table_share(TABLE_SHARE *share)
   mysql_mutex_assert_owner(&LOCK_open);
 
   DBUG_ASSERT(share->ref_count);
-  if (!--share->ref_count)
+  if (!unpin_table_share(share))
   {
     if (share->has_old_version() || table_def_shutdown_in_progress)
       my_hash_delete(&table_def_cache, (uchar*) share);
@@ -834,6 +878,7 @@ void free_io_cache(TABLE *table)
     close_cached_file(table->sort.io_cache);
     my_free(table->sort.io_cache);
     table->sort.io_cache=0;
+    table->sort.io_cache_start= 0;
   }
   DBUG_VOID_RETURN;
 }
@@ -2819,10 +2864,25 @@ retry_share:
         found TABLE_SHARE for it. So let us try to create new TABLE
         for it. We start by incrementing share's reference count and
         checking its version.
+
+        The TABLE objects of this cache keep the share referenced and
+        its version can't change while we hold the lock on the cache,
+        so if the version is good the reference can be added without
+        LOCK_open (see the comment for LOCK_open). Only if the share has
+        to be released again we go through LOCK_open.
       */
+      if ((flags & MYSQL_OPEN_IGNORE_FLUSH) ||
+          (!share->has_old_version() &&
+           !(thd->open_tables &&
+             thd->open_tables->s->version != share->version)))
+      {
+        pin_table_share(share);
+        tc->unlock();
+        goto share_pinned;
+      }
       mysql_mutex_lock(&LOCK_open);
       tc->unlock();
-      share->ref_count++;
+      pin_table_share(share);
       goto share_found;
     }
     else
@@ -2968,6 +3028,7 @@ share_found:
 
   mysql_mutex_unlock(&LOCK_open);
 
+share_pinned:
   /* make a new table */
   if (!(table= (TABLE*) my_malloc(key_memory_TABLE,
                                   sizeof(*table), MYF(MY_WME))))
@@ -456,7 +456,7 @@ struct Query_cache_wait_state
    @retval TRUE The locking attempt failed
 */
 
-bool Query_cache::try_lock(bool use_timeout)
+bool Query_cache_partition::try_lock(bool use_timeout)
 {
   bool interrupt= FALSE;
   THD *thd= current_thd;
@@ -466,16 +466,16 @@ bool Query_cache::try_lock(bool use_timeout)
   mysql_mutex_lock(&structure_guard_mutex);
   while (1)
   {
-    if (m_cache_lock_status == Query_cache::UNLOCKED)
+    if (m_cache_lock_status == Query_cache_partition::UNLOCKED)
     {
-      m_cache_lock_status= Query_cache::LOCKED;
+      m_cache_lock_status= Query_cache_partition::LOCKED;
 #ifndef DBUG_OFF
       if (thd)
         m_cache_lock_thread_id= thd->thread_id;
 #endif
       break;
     }
-    else if (m_cache_lock_status == Query_cache::LOCKED_NO_WAIT)
+    else if (m_cache_lock_status == Query_cache_partition::LOCKED_NO_WAIT)
     {
       /*
         If query cache is protected by a LOCKED_NO_WAIT lock this thread
@@ -486,7 +486,7 @@ bool Query_cache::try_lock(bool use_timeout)
     }
     else
     {
-      DBUG_ASSERT(m_cache_lock_status == Query_cache::LOCKED);
+      DBUG_ASSERT(m_cache_lock_status == Query_cache_partition::LOCKED);
       /*
         To prevent send_result_to_client() and query_cache_insert() from
         blocking execution for too long a timeout is put on the lock.
@@ -526,16 +526,16 @@ bool Query_cache::try_lock(bool use_timeout)
   It is used by all methods which flushes or destroys the whole cache.
  */
 
-void Query_cache::lock_and_suspend(void)
+void Query_cache_partition::lock_and_suspend(void)
 {
   THD *thd= current_thd;
   Query_cache_wait_state wait_state(thd, __func__, __FILE__, __LINE__);
   DBUG_ENTER("Query_cache::lock_and_suspend");
 
   mysql_mutex_lock(&structure_guard_mutex);
-  while (m_cache_lock_status != Query_cache::UNLOCKED)
+  while (m_cache_lock_status != Query_cache_partition::UNLOCKED)
     mysql_cond_wait(&COND_cache_status_changed, &structure_guard_mutex);
-  m_cache_lock_status= Query_cache::LOCKED_NO_WAIT;
+  m_cache_lock_status= Query_cache_partition::LOCKED_NO_WAIT;
 #ifndef DBUG_OFF
   if (thd)
     m_cache_lock_thread_id= thd->thread_id;
@@ -555,16 +555,16 @@ void Query_cache::lock_and_suspend(void)
   It is used by all methods which invalidates one or more tables.
  */
 
-void Query_cache::lock(void)
+void Query_cache_partition::lock(void)
 {
   THD *thd= current_thd;
   Query_cache_wait_state wait_state(thd, __func__, __FILE__, __LINE__);
   DBUG_ENTER("Query_cache::lock");
 
   mysql_mutex_lock(&structure_guard_mutex);
-  while (m_cache_lock_status != Query_cache::UNLOCKED)
+  while (m_cache_lock_status != Query_cache_partition::UNLOCKED)
     mysql_cond_wait(&COND_cache_status_changed, &structure_guard_mutex);
-  m_cache_lock_status= Query_cache::LOCKED;
+  m_cache_lock_status= Query_cache_partition::LOCKED;
 #ifndef DBUG_OFF
   if (thd)
     m_cache_lock_thread_id= thd->thread_id;
@@ -579,7 +579,7 @@ void Query_cache::lock(void)
   Set the query cache to UNLOCKED and signal waiting threads.
 */
 
-void Query_cache::unlock(void)
+void Query_cache_partition::unlock(void)
 {
   DBUG_ENTER("Query_cache::unlock");
   mysql_mutex_lock(&structure_guard_mutex);
@@ -588,9 +588,9 @@ void Query_cache::unlock(void)
   if (thd)
     DBUG_ASSERT(m_cache_lock_thread_id == thd->thread_id);
 #endif
-  DBUG_ASSERT(m_cache_lock_status == Query_cache::LOCKED ||
-              m_cache_lock_status == Query_cache::LOCKED_NO_WAIT);
-  m_cache_lock_status= Query_cache::UNLOCKED;
+  DBUG_ASSERT(m_cache_lock_status == Query_cache_partition::LOCKED ||
+              m_cache_lock_status == Query_cache_partition::LOCKED_NO_WAIT);
+  m_cache_lock_status= Query_cache_partition::UNLOCKED;
   DBUG_PRINT("Query_cache",("Sending signal"));
   mysql_cond_signal(&COND_cache_status_changed);
   mysql_mutex_unlock(&structure_guard_mutex);
@@ -909,9 +909,8 @@ void query_cache_insert(const char *packet, ulong length,
 */
 
 void
-Query_cache::insert(Query_cache_tls *query_cache_tls,
-                    const char *packet, ulong length,
-                    unsigned pkt_nr)
+Query_cache_partition::insert(Query_cache_tls *query_cache_tls,
+                              const char *packet, ulong length, unsigned pkt_nr)
 {
   DBUG_ENTER("Query_cache::insert");
 
@@ -953,8 +952,8 @@ Query_cache::insert(Query_cache_tls *query_cache_tls,
     header->result(result);
     DBUG_PRINT("qcache", ("free query 0x%lx", (ulong) query_block));
     // The following call will remove the lock on query_block
-    query_cache.free_query(query_block);
-    query_cache.refused++;
+    free_query(query_block);
+    refused++;
     // append_result_data no success => we need unlock
     unlock();
     DBUG_VOID_RETURN;
@@ -971,7 +970,7 @@ Query_cache::insert(Query_cache_tls *query_cache_tls,
 
 
 void
-Query_cache::abort(Query_cache_tls *query_cache_tls)
+Query_cache_partition::abort(Query_cache_tls *query_cache_tls)
 {
   DBUG_ENTER("query_cache_abort");
   THD *thd= current_thd;
@@ -1005,7 +1004,7 @@ Query_cache::abort(Query_cache_tls *query_cache_tls)
 }
 
 
-void Query_cache::end_of_result(THD *thd)
+void Query_cache_partition::end_of_result(THD *thd)
 {
   Query_cache_block *query_block;
   Query_cache_tls *query_cache_tls= &thd->query_cache_tls;
@@ -1065,9 +1064,9 @@ void Query_cache::end_of_result(THD *thd)
     }
     last_result_block= header->result()->prev;
     allign_size= ALIGN_SIZE(last_result_block->used);
-    len= max(query_cache.min_allocation_unit, allign_size);
-    if (last_result_block->length >= query_cache.min_allocation_unit + len)
-      query_cache.split_block(last_result_block,len);
+    len= max(min_allocation_unit, allign_size);
+    if (last_result_block->length >= min_allocation_unit + len)
+      split_block(last_result_block,len);
 
     header->found_rows(limit_found_rows);
     header->result()->type= Query_cache_block::RESULT;
@@ -1105,13 +1104,244 @@ void mysql_query_cache_invalidate4(THD *thd,
    Query_cache methods
 *****************************************************************************/
 
-Query_cache::Query_cache(ulong query_cache_limit_arg,
-			 ulong min_allocation_unit_arg,
-			 ulong min_result_data_size_arg,
-			 uint def_query_hash_size_arg,
-			 uint def_table_hash_size_arg)
+/*
+  Version counters of the tables, see Query_cache. The tables share the
+  QUERY_CACHE_TABLE_VERSIONS counters by the hash of their keys: tables
+  with the same counter only make each other's queries stale too early.
+*/
+static volatile int64 table_versions[QUERY_CACHE_TABLE_VERSIONS];
+static my_atomic_rwlock_t table_versions_lock;
+
+static uint table_version_index(const uchar *key, uint32 key_length)
+{
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, key, key_length,
+                                 &nr1, &nr2);
+  return (uint) (nr1 % QUERY_CACHE_TABLE_VERSIONS);
+}
+
+
+Query_cache::Query_cache()
+  :query_cache_size(0), query_cache_limit(ULONG_MAX),
+   m_partitions(NULL), m_partition_count(0),
+   m_query_cache_is_disabled(FALSE)
+{}
+
+
+void Query_cache::init(uint partitions)
+{
+  DBUG_ENTER("Query_cache::init");
+  my_atomic_rwlock_init(&table_versions_lock);
+  m_partition_count= max(partitions, 1U);
+  m_partitions= new Query_cache_partition[m_partition_count];
+  for (uint i= 0; i < m_partition_count; i++)
+    m_partitions[i].init();
+  m_query_cache_is_disabled= m_partitions[0].is_disabled();
+  DBUG_VOID_RETURN;
+}
+
+
+void Query_cache::destroy()
+{
+  DBUG_ENTER("Query_cache::destroy");
+  if (m_partitions)
+  {
+    for (uint i= 0; i < m_partition_count; i++)
+      m_partitions[i].destroy();
+    delete [] m_partitions;
+    m_partitions= NULL;
+    m_partition_count= 0;
+    my_atomic_rwlock_destroy(&table_versions_lock);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Resize the query cache: each partition gets an equal share of the size.
+  The cache is disabled if any partition cannot be set up.
+*/
+
+ulong Query_cache::resize(ulong query_cache_size_arg)
+{
+  ulong partition_size= query_cache_size_arg / m_partition_count;
+  ulong new_query_cache_size= 0;
+  bool failed= FALSE;
+  DBUG_ENTER("Query_cache::resize");
+
+  for (uint i= 0; i < m_partition_count; i++)
+  {
+    /* The last partition also gets the remainder of the division */
+    if (i == m_partition_count - 1)
+      partition_size= query_cache_size_arg - partition_size * i;
+    ulong size= m_partitions[i].resize(partition_size);
+    failed|= (size == 0);
+    new_query_cache_size+= size;
+  }
+  if (failed && new_query_cache_size)
+  {
+    for (uint i= 0; i < m_partition_count; i++)
+      m_partitions[i].resize(0);
+    new_query_cache_size= 0;
+  }
+  query_cache_size= new_query_cache_size;
+  DBUG_RETURN(new_query_cache_size);
+}
+
+
+ulong Query_cache::set_min_res_unit(ulong size)
+{
+  ulong res= size;
+  for (uint i= 0; i < m_partition_count; i++)
+    res= m_partitions[i].set_min_res_unit(size);
+  return res;
+}
+
+
+/**
+  The partition of a query: the same text always goes to the same one.
+*/
+
+Query_cache_partition *Query_cache::partition(const char *query,
+                                              size_t length)
+{
+  if (m_partition_count == 1)
+    return m_partitions;
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, (const uchar*) query,
+                                 length, &nr1, &nr2);
+  return m_partitions + nr1 % m_partition_count;
+}
+
+
+void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
+{
+  /* See the comment in Query_cache_partition::store_query() */
+  if (query_cache_size == 0)
+    return;
+  partition(thd->query(), thd->query_length())->store_query(thd, tables_used);
+}
+
+
+int Query_cache::send_result_to_client(THD *thd, char *sql,
+                                       uint query_length)
+{
+  return partition(sql, query_length)->send_result_to_client(thd, sql,
+                                                             query_length);
+}
+
+
+void Query_cache::insert(Query_cache_tls *query_cache_tls,
+                         const char *packet, ulong length,
+                         unsigned pkt_nr)
+{
+  /* See the comment on double-check locking usage above. */
+  if (query_cache_tls->first_query_block == NULL)
+    return;
+  query_cache_tls->partition->insert(query_cache_tls, packet, length, pkt_nr);
+}
+
+
+void Query_cache::end_of_result(THD *thd)
+{
+  if (thd->query_cache_tls.first_query_block == NULL)
+    return;
+  thd->query_cache_tls.partition->end_of_result(thd);
+}
+
+
+void Query_cache::abort(Query_cache_tls *query_cache_tls)
+{
+  if (query_cache_tls->first_query_block == NULL)
+    return;
+  query_cache_tls->partition->abort(query_cache_tls);
+}
+
+
+void Query_cache::invalidate(char *db)
+{
+  for (uint i= 0; i < m_partition_count; i++)
+    m_partitions[i].invalidate(db);
+}
+
+
+void Query_cache::flush()
+{
+  for (uint i= 0; i < m_partition_count; i++)
+    m_partitions[i].flush();
+}
+
+
+void Query_cache::pack(ulong join_limit, uint iteration_limit)
+{
+  for (uint i= 0; i < m_partition_count; i++)
+    m_partitions[i].pack(join_limit, iteration_limit);
+}
+
+
+ulonglong Query_cache::table_version(const uchar *key, uint32 key_length)
+{
+  volatile int64 *version= table_versions +
+                           table_version_index(key, key_length);
+  int64 res;
+  my_atomic_rwlock_rdlock(&table_versions_lock);
+  res= my_atomic_load64(version);
+  my_atomic_rwlock_rdunlock(&table_versions_lock);
+  return (ulonglong) res;
+}
+
+
+void Query_cache::new_table_version(const uchar *key, uint32 key_length)
+{
+  volatile int64 *version= table_versions +
+                           table_version_index(key, key_length);
+  my_atomic_rwlock_wrlock(&table_versions_lock);
+  my_atomic_add64(version, 1);
+  my_atomic_rwlock_wrunlock(&table_versions_lock);
+}
+
+
+/**
+  Sum of a statistics counter of the partitions. Each counter is read
+  without the lock of its partition, like the status variables always
+  have been.
+*/
+
+ulong Query_cache::sum(ulong Query_cache_partition::*counter)
+{
+  ulong res= 0;
+  for (uint i= 0; i < m_partition_count; i++)
+    res+= m_partitions[i].*counter;
+  return res;
+}
+
+
+void Query_cache::reset_counters()
+{
+  for (uint i= 0; i < m_partition_count; i++)
+  {
+    Query_cache_partition *part= m_partitions + i;
+    part->hits= part->inserts= part->refused= part->lowmem_prunes= 0;
+  }
+}
+
+
+void Query_cache::wreck(uint line, const char *message)
+{
+  for (uint i= 0; i < m_partition_count; i++)
+    m_partitions[i].wreck(line, message);
+}
+
+
+/*****************************************************************************
+   Query_cache_partition methods
+*****************************************************************************/
+
+Query_cache_partition::Query_cache_partition(ulong min_allocation_unit_arg,
+                                             ulong min_result_data_size_arg,
+                                             uint def_query_hash_size_arg,
+                                             uint def_table_hash_size_arg)
   :query_cache_size(0),
-   query_cache_limit(query_cache_limit_arg),
    queries_in_cache(0), hits(0), inserts(0), refused(0),
    total_blocks(0), lowmem_prunes(0), m_query_cache_is_disabled(FALSE),
    min_allocation_unit(ALIGN_SIZE(min_allocation_unit_arg)),
@@ -1129,7 +1359,7 @@ Query_cache::Query_cache(ulong query_cache_limit_arg,
 }
 
 
-ulong Query_cache::resize(ulong query_cache_size_arg)
+ulong Query_cache_partition::resize(ulong query_cache_size_arg)
 {
   ulong new_query_cache_size;
   DBUG_ENTER("Query_cache::resize");
@@ -1177,7 +1407,7 @@ ulong Query_cache::resize(ulong query_cache_size_arg)
 }
 
 
-ulong Query_cache::set_min_res_unit(ulong size)
+ulong Query_cache_partition::set_min_res_unit(ulong size)
 {
   if (size < min_allocation_unit)
     size= min_allocation_unit;
@@ -1185,7 +1415,7 @@ ulong Query_cache::set_min_res_unit(ulong size)
 }
 
 
-void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
+void Query_cache_partition::store_query(THD *thd, TABLE_LIST *tables_used)
 {
   TABLE_COUNTER_TYPE local_tables;
   ulong tot_length;
@@ -1335,6 +1565,15 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
     Query_cache_block *competitor = (Query_cache_block *)
       my_hash_search(&queries, (uchar*) thd->query(), tot_length);
     DBUG_PRINT("qcache", ("competitor 0x%lx", (ulong) competitor));
+    if (competitor != 0 && competitor->query()->writer() == 0 &&
+        is_stale(competitor))
+    {
+      /* The competitor is a stale result; replace it */
+      BLOCK_LOCK_WR(competitor);
+      // The following call will remove the lock on competitor
+      free_query(competitor);
+      competitor= 0;
+    }
     if (competitor == 0)
     {
       /* Query is not in cache and no one is working with it; Store it */
@@ -1372,6 +1611,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
 	inserts++;
 	queries_in_cache++;
 	thd->query_cache_tls.first_query_block= query_block;
+	thd->query_cache_tls.partition= this;
 	header->writer(&thd->query_cache_tls);
 	header->tables_type(tables_type);
 
@@ -1475,7 +1715,8 @@ send_data_in_chunks(NET *net, const uchar *packet, ulong len)
 */
 
 int
-Query_cache::send_result_to_client(THD *thd, char *sql, uint query_length)
+Query_cache_partition::send_result_to_client(THD *thd, char *sql,
+                                             uint query_length)
 {
   ulonglong engine_data;
   Query_cache_query *query;
@@ -1709,6 +1950,16 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
     BLOCK_UNLOCK_RD(query_block);
     goto err_unlock;
   }
+
+  if (is_stale(query_block))
+  {
+    DBUG_PRINT("qcache", ("query found, but a table has changed"));
+    BLOCK_UNLOCK_RD(query_block);
+    BLOCK_LOCK_WR(query_block);
+    // The following call will remove the lock on query_block
+    free_query(query_block);
+    goto err_unlock;
+  }
   DBUG_PRINT("qcache", ("Query have result 0x%lx", (ulong) query));
 
   if (thd->in_multi_stmt_transaction_mode() &&
@@ -1805,6 +2056,8 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
                      ("Handler require invalidation queries of %s.%s %lu-%lu",
                       table_list.db, table_list.alias,
                       (ulong) engine_data, (ulong) table->engine_data()));
+          query_cache.new_table_version((uchar *) table->db(),
+                                        table->key_length());
           invalidate_table_internal(thd, (uchar *) table->db(),
                                     table->key_length());
         }
@@ -2037,7 +2290,7 @@ void Query_cache::invalidate(THD *thd, const char *key, uint32  key_length,
    Remove all cached queries that uses the given database.
 */
 
-void Query_cache::invalidate(char *db)
+void Query_cache_partition::invalidate(char *db)
 {
   
   DBUG_ENTER("Query_cache::invalidate (db)");
@@ -2118,16 +2371,16 @@ void Query_cache::invalidate_by_MyISAM_filename(const char *filename)
   /* Calculate the key outside the lock to make the lock shorter */
   char key[MAX_DBKEY_LENGTH];
   uint32 db_length;
-  uint key_length= filename_2_table_key(key, filename, &db_length);
+  uint key_length= Query_cache_partition::filename_2_table_key(key, filename,
+                                                               &db_length);
   THD *thd= current_thd;
   invalidate_table(thd,(uchar *)key, key_length);
-  DBUG_EXECUTE("check_querycache", check_integrity(LOCK_WHILE_CHECKING););
   DBUG_VOID_RETURN;
 }
 
   /* Remove all queries from cache */
 
-void Query_cache::flush()
+void Query_cache_partition::flush()
 {
   DBUG_ENTER("Query_cache::flush");
   if (is_disabled())
@@ -2159,7 +2412,7 @@ void Query_cache::flush()
 
 */
 
-void Query_cache::pack(ulong join_limit, uint iteration_limit)
+void Query_cache_partition::pack(ulong join_limit, uint iteration_limit)
 {
   DBUG_ENTER("Query_cache::pack");
 
@@ -2190,7 +2443,7 @@ void Query_cache::pack(ulong join_limit, uint iteration_limit)
 }
 
 
-void Query_cache::destroy()
+void Query_cache_partition::destroy()
 {
   DBUG_ENTER("Query_cache::destroy");
   if (!initialized)
@@ -2216,14 +2469,14 @@ void Query_cache::destroy()
   init/destroy
 *****************************************************************************/
 
-void Query_cache::init()
+void Query_cache_partition::init()
 {
   DBUG_ENTER("Query_cache::init");
   mysql_mutex_init(key_structure_guard_mutex,
                    &structure_guard_mutex, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_COND_cache_status_changed,
                   &COND_cache_status_changed, NULL);
-  m_cache_lock_status= Query_cache::UNLOCKED;
+  m_cache_lock_status= Query_cache_partition::UNLOCKED;
   initialized = 1;
   /*
     If we explicitly turn off query cache from the command line query cache will
@@ -2232,13 +2485,13 @@ void Query_cache::init()
     be used.
   */
   if (global_system_variables.query_cache_type == 0)
-    query_cache.disable_query_cache();
+    disable_query_cache();
 
   DBUG_VOID_RETURN;
 }
 
 
-ulong Query_cache::init_cache()
+ulong Query_cache_partition::init_cache()
 {
   uint mem_bin_count, num, step;
   ulong mem_bin_size, prev_size, inc;
@@ -2415,7 +2668,7 @@ err:
 
 /* Disable the use of the query cache */
 
-void Query_cache::make_disabled()
+void Query_cache_partition::make_disabled()
 {
   DBUG_ENTER("Query_cache::make_disabled");
   query_cache_size= 0;
@@ -2443,7 +2696,7 @@ void Query_cache::make_disabled()
   requires the structure_guard_mutex to be locked.
 */
 
-void Query_cache::free_cache()
+void Query_cache_partition::free_cache()
 {
   DBUG_ENTER("Query_cache::free_cache");
 
@@ -2472,7 +2725,7 @@ void Query_cache::free_cache()
   state could have been changed, and should not be relied on.
 */
 
-void Query_cache::flush_cache()
+void Query_cache_partition::flush_cache()
 {
   QC_DEBUG_SYNC("wait_in_query_cache_flush2");
 
@@ -2489,7 +2742,7 @@ void Query_cache::flush_cache()
   Returns 1 if we couldn't remove anything
 */
 
-my_bool Query_cache::free_old_query()
+my_bool Query_cache_partition::free_old_query()
 {
   DBUG_ENTER("Query_cache::free_old_query");
   if (queries_blocks)
@@ -2546,7 +2799,7 @@ my_bool Query_cache::free_old_query()
     calling this method, as the lock will be destroyed here.
 */
 
-void Query_cache::free_query_internal(Query_cache_block *query_block)
+void Query_cache_partition::free_query_internal(Query_cache_block *query_block)
 {
   DBUG_ENTER("Query_cache::free_query_internal");
   DBUG_PRINT("qcache", ("free query 0x%lx %lu bytes result",
@@ -2616,7 +2869,7 @@ void Query_cache::free_query_internal(Query_cache_block *query_block)
     then call free_query_internal(), which see.
 */
 
-void Query_cache::free_query(Query_cache_block *query_block)
+void Query_cache_partition::free_query(Query_cache_block *query_block)
 {
   DBUG_ENTER("Query_cache::free_query");
   DBUG_PRINT("qcache", ("free query 0x%lx %lu bytes result",
@@ -2634,10 +2887,10 @@ void Query_cache::free_query(Query_cache_block *query_block)
 *****************************************************************************/
 
 Query_cache_block *
-Query_cache::write_block_data(ulong data_len, uchar* data,
-			      ulong header_len,
-			      Query_cache_block::block_type type,
-			      TABLE_COUNTER_TYPE ntab)
+Query_cache_partition::write_block_data(ulong data_len, uchar* data,
+                                        ulong header_len,
+                                        Query_cache_block::block_type type,
+                                        TABLE_COUNTER_TYPE ntab)
 {
   ulong all_headers_len = (ALIGN_SIZE(sizeof(Query_cache_block)) +
 			   ALIGN_SIZE(ntab*sizeof(Query_cache_block_table)) +
@@ -2662,19 +2915,19 @@ Query_cache::write_block_data(ulong data_len, uchar* data,
 
 
 my_bool
-Query_cache::append_result_data(Query_cache_block **current_block,
-				ulong data_len, uchar* data,
-				Query_cache_block *query_block)
+Query_cache_partition::append_result_data(Query_cache_block **current_block,
+                                          ulong data_len, uchar* data,
+                                          Query_cache_block *query_block)
 {
   DBUG_ENTER("Query_cache::append_result_data");
   DBUG_PRINT("qcache", ("append %lu bytes to 0x%lx query",
 		      data_len, (long) query_block));
 
-  if (query_block->query()->add(data_len) > query_cache_limit)
+  if (query_block->query()->add(data_len) > query_cache.query_cache_limit)
   {
     DBUG_PRINT("qcache", ("size limit reached %lu > %lu",
 			query_block->query()->length(),
-			query_cache_limit));
+			query_cache.query_cache_limit));
     DBUG_RETURN(0);
   }
   if (*current_block == 0)
@@ -2740,10 +2993,11 @@ Query_cache::append_result_data(Query_cache_block **current_block,
 }
 
 
-my_bool Query_cache::write_result_data(Query_cache_block **result_block,
-				       ulong data_len, uchar* data,
-				       Query_cache_block *query_block,
-				       Query_cache_block::block_type type)
+my_bool
+Query_cache_partition::write_result_data(Query_cache_block **result_block,
+                                         ulong data_len, uchar* data,
+                                         Query_cache_block *query_block,
+                                         Query_cache_block::block_type type)
 {
   DBUG_ENTER("Query_cache::write_result_data");
   DBUG_PRINT("qcache", ("data_len %lu",data_len));
@@ -2813,16 +3067,16 @@ my_bool Query_cache::write_result_data(Query_cache_block **result_block,
   DBUG_RETURN(success);
 }
 
-inline ulong Query_cache::get_min_first_result_data_size()
+inline ulong Query_cache_partition::get_min_first_result_data_size()
 {
   if (queries_in_cache < QUERY_CACHE_MIN_ESTIMATED_QUERIES_NUMBER)
     return min_result_data_size;
   ulong avg_result = (query_cache_size - free_memory) / queries_in_cache;
-  avg_result = min(avg_result, query_cache_limit);
+  avg_result = min(avg_result, query_cache.query_cache_limit);
   return max(min_result_data_size, avg_result);
 }
 
-inline ulong Query_cache::get_min_append_result_data_size()
+inline ulong Query_cache_partition::get_min_append_result_data_size()
 {
   return min_result_data_size;
 }
@@ -2830,10 +3084,11 @@ inline ulong Query_cache::get_min_append_result_data_size()
 /*
   Allocate one or more blocks to hold data
 */
-my_bool Query_cache::allocate_data_chain(Query_cache_block **result_block,
-					 ulong data_len,
-					 Query_cache_block *query_block,
-					 my_bool first_block_arg)
+my_bool
+Query_cache_partition::allocate_data_chain(Query_cache_block **result_block,
+                                           ulong data_len,
+                                           Query_cache_block *query_block,
+                                           my_bool first_block_arg)
 {
   ulong all_headers_len = (ALIGN_SIZE(sizeof(Query_cache_block)) +
 			   ALIGN_SIZE(sizeof(Query_cache_result)));
@@ -2917,6 +3172,19 @@ void Query_cache::invalidate_table(THD *thd, TABLE *table)
 }
 
 void Query_cache::invalidate_table(THD *thd, uchar * key, uint32  key_length)
+{
+  new_table_version(key, key_length);
+  /*
+    With several partitions the queries are freed when they are found to
+    be stale, rather than searched in every partition now.
+  */
+  if (m_partition_count == 1)
+    m_partitions[0].invalidate_table(thd, key, key_length);
+}
+
+
+void Query_cache_partition::invalidate_table(THD *thd, uchar * key,
+                                             uint32 key_length)
 {
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
@@ -2944,7 +3212,8 @@ void Query_cache::invalidate_table(THD *thd, uchar * key, uint32  key_length)
 */
 
 void
-Query_cache::invalidate_table_internal(THD *thd, uchar *key, uint32 key_length)
+Query_cache_partition::invalidate_table_internal(THD *thd, uchar *key,
+                                                 uint32 key_length)
 {
   Query_cache_block *table_block=
     (Query_cache_block*)my_hash_search(&tables, key, key_length);
@@ -2968,8 +3237,8 @@ Query_cache::invalidate_table_internal(THD *thd, uchar *key, uint32 key_length)
 */
 
 void
-Query_cache::invalidate_query_block_list(THD *thd,
-                                         Query_cache_block_table *list_root)
+Query_cache_partition::invalidate_query_block_list(
+  THD *thd, Query_cache_block_table *list_root)
 {
   while (list_root->next != list_root)
   {
@@ -2995,9 +3264,9 @@ Query_cache::invalidate_query_block_list(THD *thd,
 */
 
 TABLE_COUNTER_TYPE
-Query_cache::register_tables_from_list(TABLE_LIST *tables_used,
-                                       TABLE_COUNTER_TYPE counter,
-                                       Query_cache_block_table *block_table)
+Query_cache_partition::register_tables_from_list(
+  TABLE_LIST *tables_used, TABLE_COUNTER_TYPE counter,
+  Query_cache_block_table *block_table)
 {
   TABLE_COUNTER_TYPE n;
   DBUG_ENTER("Query_cache::register_tables_from_list");
@@ -3094,9 +3363,10 @@ Query_cache::register_tables_from_list(TABLE_LIST *tables_used,
     tables_arg		Not used ?
 */
 
-my_bool Query_cache::register_all_tables(Query_cache_block *block,
-					 TABLE_LIST *tables_used,
-					 TABLE_COUNTER_TYPE tables_arg)
+my_bool
+Query_cache_partition::register_all_tables(Query_cache_block *block,
+                                           TABLE_LIST *tables_used,
+                                           TABLE_COUNTER_TYPE tables_arg)
 {
   TABLE_COUNTER_TYPE n;
   DBUG_PRINT("qcache", ("register tables block 0x%lx, n %d, header %x",
@@ -3119,6 +3389,31 @@ my_bool Query_cache::register_all_tables(Query_cache_block *block,
 }
 
 
+/**
+  Check if a table of a stored query has been changed since the query
+  was stored.
+
+  @param query_block  The query
+
+  @return TRUE if the query is stale, FALSE otherwise
+*/
+
+bool Query_cache_partition::is_stale(Query_cache_block *query_block)
+{
+  Query_cache_block_table *block_table= query_block->table(0);
+  Query_cache_block_table *block_table_end= block_table +
+                                            query_block->n_tables;
+  for (; block_table != block_table_end; block_table++)
+  {
+    Query_cache_table *table= block_table->parent;
+    if (block_table->version !=
+        query_cache.table_version(table->data(), table->key_length()))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+
 /**
   Insert used table name into the cache.
 
@@ -3128,11 +3423,11 @@ my_bool Query_cache::register_all_tables(Query_cache_block *block,
 */
 
 my_bool
-Query_cache::insert_table(uint key_len, const char *key,
-			  Query_cache_block_table *node,
-			  uint32 db_length, uint8 cache_type,
-                          qc_engine_callback callback,
-                          ulonglong engine_data)
+Query_cache_partition::insert_table(uint key_len, const char *key,
+                                    Query_cache_block_table *node,
+                                    uint32 db_length, uint8 cache_type,
+                                    qc_engine_callback callback,
+                                    ulonglong engine_data)
 {
   DBUG_ENTER("Query_cache::insert_table");
   DBUG_PRINT("qcache", ("insert table node 0x%lx, len %d",
@@ -3223,6 +3518,7 @@ Query_cache::insert_table(uint key_len, const char *key,
   node->next->prev= node;
   node->prev= list_root;
   node->parent= table_block->table();
+  node->version= query_cache.table_version((uchar*) key, key_len);
   /*
     Increase the counter to keep track on how long this chain
     of queries is.
@@ -3233,7 +3529,7 @@ Query_cache::insert_table(uint key_len, const char *key,
 }
 
 
-void Query_cache::unlink_table(Query_cache_block_table *node)
+void Query_cache_partition::unlink_table(Query_cache_block_table *node)
 {
   DBUG_ENTER("Query_cache::unlink_table");
   node->prev->next= node->next;
@@ -3268,16 +3564,17 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
 *****************************************************************************/
 
 Query_cache_block *
-Query_cache::allocate_block(ulong len, my_bool not_less, ulong minimum)
+Query_cache_partition::allocate_block(ulong len, my_bool not_less,
+                                      ulong minimum)
 {
   DBUG_ENTER("Query_cache::allocate_block");
   DBUG_PRINT("qcache", ("len %lu, not less %d, min %lu",
              len, not_less, minimum));
 
-  if (len >= min(query_cache_size, query_cache_limit))
+  if (len >= min(query_cache_size, query_cache.query_cache_limit))
   {
     DBUG_PRINT("qcache", ("Query cache hase only %lu memory and limit %lu",
-			query_cache_size, query_cache_limit));
+			query_cache_size, query_cache.query_cache_limit));
     DBUG_RETURN(0); // in any case we don't have such piece of memory
   }
 
@@ -3300,7 +3597,7 @@ Query_cache::allocate_block(ulong len, my_bool not_less, ulong minimum)
 
 
 Query_cache_block *
-Query_cache::get_free_block(ulong len, my_bool not_less, ulong min)
+Query_cache_partition::get_free_block(ulong len, my_bool not_less, ulong min)
 {
   Query_cache_block *block = 0, *first = 0;
   DBUG_ENTER("Query_cache::get_free_block");
@@ -3376,7 +3673,7 @@ Query_cache::get_free_block(ulong len, my_bool not_less, ulong min)
 }
 
 
-void Query_cache::free_memory_block(Query_cache_block *block)
+void Query_cache_partition::free_memory_block(Query_cache_block *block)
 {
   DBUG_ENTER("Query_cache::free_memory_block");
   block->used=0;
@@ -3395,7 +3692,7 @@ void Query_cache::free_memory_block(Query_cache_block *block)
 }
 
 
-void Query_cache::split_block(Query_cache_block *block, ulong len)
+void Query_cache_partition::split_block(Query_cache_block *block, ulong len)
 {
   DBUG_ENTER("Query_cache::split_block");
   Query_cache_block *new_block = (Query_cache_block*)(((uchar*) block)+len);
@@ -3423,8 +3720,8 @@ void Query_cache::split_block(Query_cache_block *block, ulong len)
 
 
 Query_cache_block *
-Query_cache::join_free_blocks(Query_cache_block *first_block_arg,
-			      Query_cache_block *block_in_list)
+Query_cache_partition::join_free_blocks(Query_cache_block *first_block_arg,
+                                        Query_cache_block *block_in_list)
 {
   Query_cache_block *second_block;
   DBUG_ENTER("Query_cache::join_free_blocks");
@@ -3448,8 +3745,8 @@ Query_cache::join_free_blocks(Query_cache_block *first_block_arg,
 }
 
 
-my_bool Query_cache::append_next_free_block(Query_cache_block *block,
-					    ulong add_size)
+my_bool Query_cache_partition::append_next_free_block(Query_cache_block *block,
+                                                      ulong add_size)
 {
   Query_cache_block *next_block = block->pnext;
   DBUG_ENTER("Query_cache::append_next_free_block");
@@ -3476,7 +3773,9 @@ my_bool Query_cache::append_next_free_block(Query_cache_block *block,
 }
 
 
-void Query_cache::exclude_from_free_memory_list(Query_cache_block *free_block)
+void
+Query_cache_partition::exclude_from_free_memory_list(
+  Query_cache_block *free_block)
 {
   DBUG_ENTER("Query_cache::exclude_from_free_memory_list");
   Query_cache_memory_bin *bin = *((Query_cache_memory_bin **)
@@ -3490,7 +3789,9 @@ void Query_cache::exclude_from_free_memory_list(Query_cache_block *free_block)
   DBUG_VOID_RETURN;
 }
 
-void Query_cache::insert_into_free_memory_list(Query_cache_block *free_block)
+void
+Query_cache_partition::insert_into_free_memory_list(
+  Query_cache_block *free_block)
 {
   DBUG_ENTER("Query_cache::insert_into_free_memory_list");
   uint idx = find_bin(free_block->length);
@@ -3508,7 +3809,7 @@ void Query_cache::insert_into_free_memory_list(Query_cache_block *free_block)
   DBUG_VOID_RETURN;
 }
 
-uint Query_cache::find_bin(ulong size)
+uint Query_cache_partition::find_bin(ulong size)
 {
   DBUG_ENTER("Query_cache::find_bin");
   // Binary search
@@ -3540,7 +3841,8 @@ uint Query_cache::find_bin(ulong size)
  Lists management
 *****************************************************************************/
 
-void Query_cache::move_to_query_list_end(Query_cache_block *query_block)
+void
+Query_cache_partition::move_to_query_list_end(Query_cache_block *query_block)
 {
   DBUG_ENTER("Query_cache::move_to_query_list_end");
   double_linked_list_exclude(query_block, &queries_blocks);
@@ -3549,10 +3851,9 @@ void Query_cache::move_to_query_list_end(Query_cache_block *query_block)
 }
 
 
-void Query_cache::insert_into_free_memory_sorted_list(Query_cache_block *
-						      new_block,
-						      Query_cache_block **
-						      list)
+void
+Query_cache_partition::insert_into_free_memory_sorted_list(
+  Query_cache_block *new_block, Query_cache_block **list)
 {
   DBUG_ENTER("Query_cache::insert_into_free_memory_sorted_list");
   /*
@@ -3596,9 +3897,8 @@ void Query_cache::insert_into_free_memory_sorted_list(Query_cache_block *
 
 
 void
-Query_cache::double_linked_list_simple_include(Query_cache_block *point,
-						Query_cache_block **
-						list_pointer)
+Query_cache_partition::double_linked_list_simple_include(
+  Query_cache_block *point, Query_cache_block **list_pointer)
 {
   DBUG_ENTER("Query_cache::double_linked_list_simple_include");
   DBUG_PRINT("qcache", ("including block 0x%lx", (ulong) point));
@@ -3616,8 +3916,8 @@ Query_cache::double_linked_list_simple_include(Query_cache_block *point,
 }
 
 void
-Query_cache::double_linked_list_exclude(Query_cache_block *point,
-					Query_cache_block **list_pointer)
+Query_cache_partition::double_linked_list_exclude(
+  Query_cache_block *point, Query_cache_block **list_pointer)
 {
   DBUG_ENTER("Query_cache::double_linked_list_exclude");
   DBUG_PRINT("qcache", ("excluding block 0x%lx, list 0x%lx",
@@ -3638,8 +3938,9 @@ Query_cache::double_linked_list_exclude(Query_cache_block *point,
 }
 
 
-void Query_cache::double_linked_list_join(Query_cache_block *head_tail,
-					  Query_cache_block *tail_head)
+void
+Query_cache_partition::double_linked_list_join(Query_cache_block *head_tail,
+                                               Query_cache_block *tail_head)
 {
   Query_cache_block *head_head = head_tail->next,
 		    *tail_tail	= tail_head->prev;
@@ -3668,8 +3969,9 @@ void Query_cache::double_linked_list_join(Query_cache_block *head_tail,
 */
 
 TABLE_COUNTER_TYPE
-Query_cache::process_and_count_tables(THD *thd, TABLE_LIST *tables_used,
-                                      uint8 *tables_type)
+Query_cache_partition::process_and_count_tables(THD *thd,
+                                                TABLE_LIST *tables_used,
+                                                uint8 *tables_type)
 {
   DBUG_ENTER("process_and_count_tables");
   TABLE_COUNTER_TYPE table_count = 0;
@@ -3762,9 +4064,9 @@ Query_cache::process_and_count_tables(THD *thd, TABLE_LIST *tables_used,
 */
 
 TABLE_COUNTER_TYPE
-Query_cache::is_cacheable(THD *thd, size_t query_len, const char *query,
-                          LEX *lex,
-                          TABLE_LIST *tables_used, uint8 *tables_type)
+Query_cache_partition::is_cacheable(THD *thd, size_t query_len,
+                                    const char *query, LEX *lex,
+                                    TABLE_LIST *tables_used, uint8 *tables_type)
 {
   TABLE_COUNTER_TYPE table_count;
   DBUG_ENTER("Query_cache::is_cacheable");
@@ -3816,8 +4118,8 @@ Query_cache::is_cacheable(THD *thd, size_t query_len, const char *query,
     0 - caching allowed
     1 - caching disallowed
 */
-my_bool Query_cache::ask_handler_allowance(THD *thd,
-					   TABLE_LIST *tables_used)
+my_bool Query_cache_partition::ask_handler_allowance(THD *thd,
+                                                     TABLE_LIST *tables_used)
 {
   DBUG_ENTER("Query_cache::ask_handler_allowance");
 
@@ -3882,7 +4184,7 @@ my_bool Query_cache::ask_handler_allowance(THD *thd,
   @see Query_cache::pack(ulong join_limit, uint iteration_limit)
 */
 
-void Query_cache::pack_cache()
+void Query_cache_partition::pack_cache()
 {
   DBUG_ENTER("Query_cache::pack_cache");
 
@@ -3923,9 +4225,10 @@ void Query_cache::pack_cache()
 }
 
 
-my_bool Query_cache::move_by_type(uchar **border,
-				  Query_cache_block **before, ulong *gap,
-				  Query_cache_block *block)
+my_bool Query_cache_partition::move_by_type(uchar **border,
+                                            Query_cache_block **before,
+                                            ulong *gap,
+                                            Query_cache_block *block)
 {
   DBUG_ENTER("Query_cache::move_by_type");
 
@@ -4107,13 +4410,13 @@ my_bool Query_cache::move_by_type(uchar **border,
   case Query_cache_block::RES_CONT:
   case Query_cache_block::RESULT:
   {
-    DBUG_PRINT("qcache", ("block 0x%lx RES* (%d)", (ulong) block,
-               (int) block->type));
-    if (*border == 0)
-      break;
-    Query_cache_block *query_block= block->result()->parent();
-    BLOCK_LOCK_WR(query_block);
-    Query_cache_block *next= block->next, *prev= block->prev;
+    DBUG_PRINT("qcache", ("block 0x%lx RES* (%d)", (ulong) block,
+               (int) block->type));
+    if (*border == 0)
+      break;
+    Query_cache_block *query_block= block->result()->parent();
+    BLOCK_LOCK_WR(query_block);
+    Query_cache_block *next= block->next, *prev= block->prev;
     Query_cache_block::block_type type= block->type;
     ulong len = block->length, used = block->used;
     Query_cache_block *pprev = block->pprev,
@@ -4160,10 +4463,12 @@ my_bool Query_cache::move_by_type(uchar **border,
 }
 
 
-void Query_cache::relink(Query_cache_block *oblock,
-			 Query_cache_block *nblock,
-			 Query_cache_block *next, Query_cache_block *prev,
-			 Query_cache_block *pnext, Query_cache_block *pprev)
+void Query_cache_partition::relink(Query_cache_block *oblock,
+                                   Query_cache_block *nblock,
+                                   Query_cache_block *next,
+                                   Query_cache_block *prev,
+                                   Query_cache_block *pnext,
+                                   Query_cache_block *pprev)
 {
   if (prev == oblock) //check pointer to himself
   {
@@ -4187,7 +4492,7 @@ void Query_cache::relink(Query_cache_block *oblock,
 }
 
 
-my_bool Query_cache::join_results(ulong join_limit)
+my_bool Query_cache_partition::join_results(ulong join_limit)
 {
   my_bool has_moving = 0;
   DBUG_ENTER("Query_cache::join_results");
@@ -4259,8 +4564,8 @@ my_bool Query_cache::join_results(ulong join_limit)
 }
 
 
-uint Query_cache::filename_2_table_key (char *key, const char *path,
-					uint32 *db_length)
+uint Query_cache_partition::filename_2_table_key (char *key, const char *path,
+                                                  uint32 *db_length)
 {
   char tablename[FN_REFLEN+2], *filename, *dbname;
   DBUG_ENTER("Query_cache::filename_2_table_key");
@@ -4288,15 +4593,19 @@ uint Query_cache::filename_2_table_key (char *key, const char *path,
 
 #if defined(DBUG_OFF) || !defined(EXTRA_DEBUG)
 
-void Query_cache::wreck(uint line, const char *message) { query_cache_size = 0; }
-void Query_cache::bins_dump() {}
-void Query_cache::cache_dump() {}
-void Query_cache::queries_dump() {}
-void Query_cache::tables_dump() {}
-bool Query_cache::check_integrity(enum_qcci_lock_mode locking) { return false; }
-my_bool Query_cache::in_list(Query_cache_block *root, Query_cache_block *point,
-                             const char *name) { return 0;}
-my_bool Query_cache::in_blocks(Query_cache_block * point) { return 0; }
+void Query_cache_partition::wreck(uint line, const char *message)
+{ query_cache_size = 0; }
+void Query_cache_partition::bins_dump() {}
+void Query_cache_partition::cache_dump() {}
+void Query_cache_partition::queries_dump() {}
+void Query_cache_partition::tables_dump() {}
+bool Query_cache_partition::check_integrity(enum_qcci_lock_mode locking)
+{ return false; }
+my_bool Query_cache_partition::in_list(Query_cache_block *root,
+                                       Query_cache_block *point,
+                                       const char *name) { return 0;}
+my_bool Query_cache_partition::in_blocks(Query_cache_block * point)
+{ return 0; }
 
 #else
 
@@ -4311,7 +4620,7 @@ my_bool Query_cache::in_blocks(Query_cache_block * point) { return 0; }
     message              message for logging
 */
 
-void Query_cache::wreck(uint line, const char *message)
+void Query_cache_partition::wreck(uint line, const char *message)
 {
   THD *thd=current_thd;
   DBUG_ENTER("Query_cache::wreck");
@@ -4329,7 +4638,7 @@ void Query_cache::wreck(uint line, const char *message)
 }
 
 
-void Query_cache::bins_dump()
+void Query_cache_partition::bins_dump()
 {
   uint i;
   
@@ -4372,7 +4681,7 @@ void Query_cache::bins_dump()
 }
 
 
-void Query_cache::cache_dump()
+void Query_cache_partition::cache_dump()
 {
   if (!initialized || query_cache_size == 0)
   {
@@ -4398,7 +4707,7 @@ void Query_cache::cache_dump()
 }
 
 
-void Query_cache::queries_dump()
+void Query_cache_partition::queries_dump()
 {
 
   if (!initialized)
@@ -4464,7 +4773,7 @@ void Query_cache::queries_dump()
 }
 
 
-void Query_cache::tables_dump()
+void Query_cache_partition::tables_dump()
 {
   if (!initialized || query_cache_size == 0)
   {
@@ -4501,7 +4810,7 @@ void Query_cache::tables_dump()
     @retval true  Query cache is broken.
 */
 
-bool Query_cache::check_integrity(enum_qcci_lock_mode locking)
+bool Query_cache_partition::check_integrity(enum_qcci_lock_mode locking)
 {
   bool result= false;
   uint i;
@@ -4769,7 +5078,7 @@ bool Query_cache::check_integrity(enum_qcci_lock_mode locking)
 }
 
 
-my_bool Query_cache::in_blocks(Query_cache_block * point)
+my_bool Query_cache_partition::in_blocks(Query_cache_block * point)
 {
   my_bool result = 0;
   Query_cache_block *block = point;
@@ -4824,9 +5133,9 @@ err2:
 }
 
 
-my_bool Query_cache::in_list(Query_cache_block * root,
-			     Query_cache_block * point,
-			     const char *name)
+my_bool Query_cache_partition::in_list(Query_cache_block * root,
+                                       Query_cache_block * point,
+                                       const char *name)
 {
   my_bool result = 0;
   Query_cache_block *block = point;
@@ -4893,9 +5202,9 @@ void dump_node(Query_cache_block_table * node,
 			(ulong) node->prev));
 }
 
-my_bool Query_cache::in_table_list(Query_cache_block_table * root,
-				   Query_cache_block_table * point,
-				   const char *name)
+my_bool Query_cache_partition::in_table_list(Query_cache_block_table * root,
+                                             Query_cache_block_table * point,
+                                             const char *name)
 {
   my_bool result = 0;
   Query_cache_block_table *table = point;
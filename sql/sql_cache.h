@@ -69,11 +69,15 @@ typedef ulonglong sql_mode_t;
 
 #define TABLE_COUNTER_TYPE uint
 
+/* number of table version counters (see Query_cache) */
+#define QUERY_CACHE_TABLE_VERSIONS		4096
+
 struct Query_cache_block;
 struct Query_cache_block_table;
 struct Query_cache_table;
 struct Query_cache_query;
 struct Query_cache_result;
+class Query_cache_partition;
 class Query_cache;
 struct Query_cache_tls;
 struct LEX;
@@ -112,6 +116,12 @@ struct Query_cache_block_table
   */
   Query_cache_table *parent;
 
+  /**
+    The version of the table when the query was stored; the query is
+    stale once the version has changed (see Query_cache::table_version()).
+  */
+  ulonglong version;
+
   /**
     A method to calculate the address of the query cache block
     owning this node. The purpose of this calculation is to 
@@ -279,11 +289,16 @@ struct Query_cache_memory_bin_step
   }
 };
 
-class Query_cache
+/**
+  One partition of the query cache, with its own memory, hashes and lock.
+*/
+
+class Query_cache_partition
 {
+  friend class Query_cache;
 public:
   /* Info */
-  ulong query_cache_size, query_cache_limit;
+  ulong query_cache_size;
   /* statistics */
   ulong free_memory, queries_in_cache, hits, inserts, refused,
     free_memory_blocks, total_blocks, lowmem_prunes;
@@ -356,9 +371,6 @@ protected:
 			      ulong data_len,
 			      Query_cache_block *query_block,
 			      my_bool first_block);
-  void invalidate_table(THD *thd, TABLE_LIST *table);
-  void invalidate_table(THD *thd, TABLE *table);
-  void invalidate_table(THD *thd, uchar *key, uint32  key_length);
   void invalidate_table(THD *thd, Query_cache_block *table_block);
   void invalidate_query_block_list(THD *thd, 
                                    Query_cache_block_table *list_root);
@@ -367,6 +379,7 @@ protected:
     register_tables_from_list(TABLE_LIST *tables_used,
                               TABLE_COUNTER_TYPE counter,
                               Query_cache_block_table *block_table);
+  bool is_stale(Query_cache_block *query_block);
   my_bool register_all_tables(Query_cache_block *block,
 			      TABLE_LIST *tables_used,
 			      TABLE_COUNTER_TYPE tables);
@@ -439,11 +452,11 @@ protected:
   static my_bool ask_handler_allowance(THD *thd, TABLE_LIST *tables_used);
  public:
 
-  Query_cache(ulong query_cache_limit = ULONG_MAX,
-	      ulong min_allocation_unit = QUERY_CACHE_MIN_ALLOCATION_UNIT,
-	      ulong min_result_data_size = QUERY_CACHE_MIN_RESULT_DATA_SIZE,
-	      uint def_query_hash_size = QUERY_CACHE_DEF_QUERY_HASH_SIZE,
-	      uint def_table_hash_size = QUERY_CACHE_DEF_TABLE_HASH_SIZE);
+  Query_cache_partition(
+    ulong min_allocation_unit = QUERY_CACHE_MIN_ALLOCATION_UNIT,
+    ulong min_result_data_size = QUERY_CACHE_MIN_RESULT_DATA_SIZE,
+    uint def_query_hash_size = QUERY_CACHE_DEF_QUERY_HASH_SIZE,
+    uint def_table_hash_size = QUERY_CACHE_DEF_TABLE_HASH_SIZE);
 
   bool is_disabled(void) { return m_query_cache_is_disabled; }
 
@@ -451,8 +464,6 @@ protected:
   void init();
   /* resize query cache (return real query size, 0 if disabled) */
   ulong resize(ulong query_cache_size);
-  /* set limit on result size */
-  inline void result_size_limit(ulong limit){query_cache_limit=limit;}
   /* set minimal result data allocation unit size */
   ulong set_min_res_unit(ulong size);
 
@@ -465,24 +476,12 @@ protected:
   */
   int send_result_to_client(THD *thd, char *query, uint query_length);
 
-  /* Remove all queries that use the given table */
-  void invalidate_single(THD* thd, TABLE_LIST *table_used,
-                         my_bool using_transactions);
-  /* Remove all queries that uses any of the listed following tables */
-  void invalidate(THD* thd, TABLE_LIST *tables_used,
-		  my_bool using_transactions);
-  void invalidate(CHANGED_TABLE_LIST *tables_used);
-  void invalidate_locked_for_write(TABLE_LIST *tables_used);
-  void invalidate(THD* thd, TABLE *table, my_bool using_transactions);
-  void invalidate(THD *thd, const char *key, uint32  key_length,
-		  my_bool using_transactions);
+  /* Remove all queries that use the table with the given key */
+  void invalidate_table(THD *thd, uchar *key, uint32  key_length);
 
   /* Remove all queries that uses any of the tables in following database */
   void invalidate(char *db);
 
-  /* Remove all queries that uses any of the listed following table */
-  void invalidate_by_MyISAM_filename(const char *filename);
-
   void flush();
   void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
 	    uint iteration_limit = QUERY_CACHE_PACK_ITERATION);
@@ -522,6 +521,108 @@ protected:
   void unlock(void);
 };
 
+
+/**
+  The query cache.
+
+  The cache is split in query_cache_partitions partitions, each with its
+  own memory and lock, and a query is cached in the partition chosen by
+  the hash of its text. Lookups and stores of different queries thus
+  rarely wait for each other.
+
+  Invalidation does not have to visit every partition: each table has a
+  version, incremented without lock when the table is changed, and the
+  cached queries record the version of their tables when they are
+  stored. A lookup that finds a query with a table of an older version
+  frees the query and misses. With a single partition the queries are
+  also freed at invalidation, as they have always been, which keeps the
+  statistics exact.
+*/
+
+class Query_cache
+{
+public:
+  /* Info */
+  ulong query_cache_size, query_cache_limit;
+
+  Query_cache();
+
+  bool is_disabled(void) { return m_query_cache_is_disabled; }
+
+  /* initialize cache with the given number of partitions */
+  void init(uint partitions);
+  /* resize query cache (return real query size, 0 if disabled) */
+  ulong resize(ulong query_cache_size);
+  /* set limit on result size */
+  inline void result_size_limit(ulong limit){query_cache_limit=limit;}
+  /* set minimal result data allocation unit size */
+  ulong set_min_res_unit(ulong size);
+
+  /* register query in cache */
+  void store_query(THD *thd, TABLE_LIST *used_tables);
+
+  /*
+    Check if the query is in the cache and if this is true send the
+    data to client.
+  */
+  int send_result_to_client(THD *thd, char *query, uint query_length);
+
+  /* Remove all queries that use the given table */
+  void invalidate_single(THD* thd, TABLE_LIST *table_used,
+                         my_bool using_transactions);
+  /* Remove all queries that uses any of the listed following tables */
+  void invalidate(THD* thd, TABLE_LIST *tables_used,
+		  my_bool using_transactions);
+  void invalidate(CHANGED_TABLE_LIST *tables_used);
+  void invalidate_locked_for_write(TABLE_LIST *tables_used);
+  void invalidate(THD* thd, TABLE *table, my_bool using_transactions);
+  void invalidate(THD *thd, const char *key, uint32  key_length,
+		  my_bool using_transactions);
+
+  /* Remove all queries that uses any of the tables in following database */
+  void invalidate(char *db);
+
+  /* Remove all queries that uses any of the listed following table */
+  void invalidate_by_MyISAM_filename(const char *filename);
+
+  void flush();
+  void pack(ulong join_limit = QUERY_CACHE_PACK_LIMIT,
+	    uint iteration_limit = QUERY_CACHE_PACK_ITERATION);
+
+  void destroy();
+
+  void insert(Query_cache_tls *query_cache_tls,
+              const char *packet,
+              ulong length,
+              unsigned pkt_nr);
+
+  void end_of_result(THD *thd);
+  void abort(Query_cache_tls *query_cache_tls);
+
+  /* Current version of the table with the given key */
+  ulonglong table_version(const uchar *key, uint32 key_length);
+  /* Make the cached queries that use the table stale */
+  void new_table_version(const uchar *key, uint32 key_length);
+
+  /* Sum of a statistics counter over all partitions */
+  ulong sum(ulong Query_cache_partition::*counter);
+  /* Reset the counters that FLUSH STATUS resets */
+  void reset_counters();
+
+  void wreck(uint line, const char *message);
+
+private:
+  void invalidate_table(THD *thd, TABLE_LIST *table);
+  void invalidate_table(THD *thd, TABLE *table);
+  void invalidate_table(THD *thd, uchar *key, uint32  key_length);
+
+  Query_cache_partition *partition(const char *query, size_t length);
+
+  Query_cache_partition *m_partitions;
+  uint m_partition_count;
+  bool m_query_cache_is_disabled;
+};
+
 struct Query_cache_query_flags
 {
   unsigned int client_long_flag:1;
@@ -344,24 +344,6 @@ THD *thd_get_current_thd()
   return current_thd;
 }
 
-/**
-  Get iterator begin of global thread list
-
-  @retval Iterator begin of global thread list
-*/
-Thread_iterator thd_get_global_thread_list_begin()
-{
-  return global_thread_list_begin();
-}
-/**
-  Get iterator end of global thread list
-
-  @retval Iterator end of global thread list
-*/
-Thread_iterator thd_get_global_thread_list_end()
-{
-  return global_thread_list_end();
-}
 
 extern "C"
 void thd_binlog_pos(const THD *thd,
@@ -376,7 +358,8 @@ void thd_binlog_pos(const THD *thd,
 
   thd_new_connection_setup
 
-  @note Must be called with LOCK_thread_count locked.
+  @note Must be called with LOCK_thread_count locked, which is needed
+  for the new thread id only, and is released here.
 
   @param              thd            THD object
   @param              stack_start    Start of stack for connection
@@ -386,6 +369,7 @@ void thd_new_connection_setup(THD *thd, char *stack_start)
   DBUG_ENTER("thd_new_connection_setup");
   mysql_mutex_assert_owner(&LOCK_thread_count);
   thd->thread_id= thd->variables.pseudo_thread_id= thread_id++;
+  mysql_mutex_unlock(&LOCK_thread_count);
 #ifdef HAVE_PSI_INTERFACE
   thd_set_psi(thd,
               PSI_THREAD_CALL(new_thread)
@@ -395,7 +379,6 @@ void thd_new_connection_setup(THD *thd, char *stack_start)
   thd->thr_create_utime= thd->start_utime= my_micro_time();
 
   add_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   DBUG_PRINT("info", ("init new connection. thd: 0x%lx fd: %d",
           (ulong)thd, mysql_socket_getfd(thd->net.vio->mysql_socket)));
@@ -935,6 +918,7 @@ THD::THD(bool enable_plugins)
   */
   init_sql_alloc(key_memory_thd_main_mem_root,
                  &main_mem_root, ALLOC_ROOT_MIN_BLOCK_SIZE, 0);
+  m_mem_root_peak= 0;
   stmt_arena= this;
   thread_stack= 0;
   catalog= (char*)"std"; // the only catalog we have for now
@@ -1585,6 +1569,71 @@ void THD::release_resources()
 }
 
 
+/*
+  The cache of the memory of deleted THD objects, see THD::operator new().
+  A block is linked to the next one through its first bytes.
+*/
+ulong thd_cache_size;
+static pthread_mutex_t LOCK_thd_cache= PTHREAD_MUTEX_INITIALIZER;
+static void *thd_cache= NULL;
+static ulong thd_cache_count= 0;
+
+
+void *THD::operator new(size_t size) throw ()
+{
+  void *ptr= NULL;
+
+  /* Blocks of the size of THD only, for the classes derived from it */
+  if (size == sizeof(THD) && thd_cache_count)
+  {
+    pthread_mutex_lock(&LOCK_thd_cache);
+    if ((ptr= thd_cache))
+    {
+      thd_cache= *static_cast<void**>(ptr);
+      thd_cache_count--;
+    }
+    pthread_mutex_unlock(&LOCK_thd_cache);
+  }
+  if (ptr == NULL)
+    ptr= ::operator new(size, std::nothrow);
+  return ptr;
+}
+
+
+void THD::operator delete(void *ptr, size_t size)
+{
+  if (ptr == NULL)
+    return;
+  if (size == sizeof(THD) && thd_cache_count < thd_cache_size)
+  {
+    pthread_mutex_lock(&LOCK_thd_cache);
+    if (thd_cache_count < thd_cache_size)
+    {
+      *static_cast<void**>(ptr)= thd_cache;
+      thd_cache= ptr;
+      thd_cache_count++;
+      ptr= NULL;
+    }
+    pthread_mutex_unlock(&LOCK_thd_cache);
+  }
+  if (ptr)
+    ::operator delete(ptr);
+}
+
+
+void THD::free_cache()
+{
+  pthread_mutex_lock(&LOCK_thd_cache);
+  while (void *ptr= thd_cache)
+  {
+    thd_cache= *static_cast<void**>(ptr);
+    ::operator delete(ptr);
+  }
+  thd_cache_count= 0;
+  pthread_mutex_unlock(&LOCK_thd_cache);
+}
+
+
 THD::~THD()
 {
   mysql_mutex_assert_not_owner(&LOCK_thread_count);
@@ -2286,12 +2335,30 @@ int THD::send_explain_fields(select_result *result)
   field_list.push_back(item= new Item_return_int("rows", 10,
                                                  MYSQL_TYPE_LONGLONG));
   item->maybe_null= 1;
-  if (lex->describe & DESCRIBE_EXTENDED)
+  if (lex->describe & (DESCRIBE_EXTENDED | DESCRIBE_ANALYZE))
   {
     field_list.push_back(item= new Item_float(NAME_STRING("filtered"),
                                               0.1234, 2, 4));
     item->maybe_null=1;
   }
+  if (lex->describe & DESCRIBE_ANALYZE)
+  {
+    field_list.push_back(item= new Item_return_int("r_loops", 10,
+                                                   MYSQL_TYPE_LONGLONG));
+    item->maybe_null= 1;
+    field_list.push_back(item= new Item_float(NAME_STRING("r_rows"),
+                                              0.1234, 2, 10));
+    item->maybe_null= 1;
+    field_list.push_back(item= new Item_float(NAME_STRING("r_filtered"),
+                                              0.1234, 2, 4));
+    item->maybe_null= 1;
+    field_list.push_back(item= new Item_float(NAME_STRING("r_engine_ms"),
+                                              0.1234, 3, 10));
+    item->maybe_null= 1;
+    field_list.push_back(item= new Item_float(NAME_STRING("r_condition_ms"),
+                                              0.1234, 3, 10));
+    item->maybe_null= 1;
+  }
   field_list.push_back(new Item_empty_string("Extra", 255, cs));
   item->maybe_null= 1;
   return (result->send_result_set_metadata(field_list,
@@ -3541,6 +3608,16 @@ void Statement_map::erase(Statement *statement)
 }
 
 
+void Statement_map::close_transient_cursors()
+{
+  for (uint i= 0; i < st_hash.records; i++)
+  {
+    Statement *statement= (Statement *) my_hash_element(&st_hash, i);
+    statement->close_transient_cursor();
+  }
+}
+
+
 void Statement_map::reset()
 {
   /* Must be first, hash_free will reset st_hash.records */
@@ -4370,6 +4447,12 @@ void THD::inc_status_sort_scan()
 #endif
 }
 
+void THD::inc_status_sort_parallel(uint threads)
+{
+  status_var.filesort_parallel_count++;
+  status_var.filesort_parallel_threads+= threads;
+}
+
 void THD::set_status_no_index_used()
 {
   server_status|= SERVER_QUERY_NO_INDEX_USED;
@@ -384,6 +384,7 @@ class MY_LOCALE;
 */
 
 struct Query_cache_block;
+class Query_cache_partition;
 
 struct Query_cache_tls
 {
@@ -392,12 +393,14 @@ struct Query_cache_tls
     functions and methods to maintain proper locking.
   */
   Query_cache_block *first_query_block;
+  /* The partition of first_query_block */
+  Query_cache_partition *partition;
   void set_first_query_block(Query_cache_block *first_query_block_arg)
   {
     first_query_block= first_query_block_arg;
   }
 
-  Query_cache_tls() :first_query_block(NULL) {}
+  Query_cache_tls() :first_query_block(NULL), partition(NULL) {}
 };
 
 #include "sql_lex.h"				/* Must be here */
@@ -405,6 +408,9 @@ struct Query_cache_tls
 class select_result;
 class Time_zone;
 
+/// Size of the cache of the memory of deleted THD objects
+extern ulong thd_cache_size;
+
 #define THD_SENTRY_MAGIC 0xfeedd1ff
 #define THD_SENTRY_GONE  0xdeadbeef
 
@@ -474,12 +480,15 @@ typedef struct system_variables
   ulong read_rnd_buff_size;
   ulong div_precincrement;
   ulong sortbuff_size;
+  ulong sort_threads;
   ulong max_sp_recursion_depth;
   ulong default_week_format;
   ulong max_seeks_for_key;
   ulong range_alloc_block_size;
+  ulong range_optimizer_max_mem_size;
   ulong query_alloc_block_size;
   ulong query_prealloc_size;
+  ulong query_alloc_keep_size;
   ulong trans_alloc_block_size;
   ulong trans_prealloc_size;
   ulong group_concat_max_len;
@@ -601,6 +610,10 @@ typedef struct system_status_var
   ulonglong filesort_range_count;
   ulonglong filesort_rows;
   ulonglong filesort_scan_count;
+  ulonglong filesort_parallel_count;
+  ulonglong filesort_parallel_threads;
+  ulonglong join_order_cache_hits;
+  ulonglong join_order_cache_misses;
   /* Prepared statements and binary protocol */
   ulonglong com_stmt_prepare;
   ulonglong com_stmt_reprepare;
@@ -891,6 +904,8 @@ public:
   void restore_backup_statement(Statement *stmt, Statement *backup);
   /* return class type */
   virtual Type type() const;
+  /* Close the cursor of the statement, if it can not survive COMMIT */
+  virtual void close_transient_cursor() {}
 };
 
 
@@ -935,10 +950,11 @@ public:
   /*
     Close all cursors of this connection that use tables of a storage
     engine that has transaction-specific state and therefore can not
-    survive COMMIT or ROLLBACK. Currently all but MyISAM cursors are closed.
-    CURRENTLY NOT IMPLEMENTED!
+    survive COMMIT or ROLLBACK. These are the streaming cursors, which
+    read the tables of the transaction on each fetch: materialized
+    cursors only read their own temporary table.
   */
-  void close_transient_cursors() { }
+  void close_transient_cursors();
   void erase(Statement *statement);
   /* Erase all statements (calls Statement destructor) */
   void reset();
@@ -1229,6 +1245,33 @@ bool xid_cache_insert(XID *xid, enum xa_states xa_state);
 bool xid_cache_insert(XID_STATE *xid_state);
 void xid_cache_delete(XID_STATE *xid_state);
 
+/**
+  Per-connection cache of db-level privileges computed by acl_get(), to
+  avoid taking acl_cache->lock for every check of privileges on a
+  database other than the current one. The entries are keyed like
+  acl_cache entries and are valid while acl_cache_version is unchanged.
+*/
+
+struct Acl_db_access_cache
+{
+  struct Entry
+  {
+    int32 version;
+    ulong access;
+    size_t key_length;                  ///< 0 if the entry is unused
+    char key[ACL_KEY_LENGTH];
+  };
+  Entry entries[ACL_DB_ACCESS_CACHE_SIZE];
+  uint next_victim;                     ///< Entry to be replaced next
+
+  Acl_db_access_cache() : next_victim(0)
+  {
+    for (uint i= 0; i < ACL_DB_ACCESS_CACHE_SIZE; i++)
+      entries[i].key_length= 0;
+  }
+};
+
+
 /**
   @class Security_context
   @brief A set of THD members describing the current authenticated user.
@@ -1932,6 +1975,7 @@ public:
 
   Security_context main_security_ctx;
   Security_context *security_ctx;
+  Acl_db_access_cache acl_db_access_cache;
 
   /*
     Points to info-string that we show in SHOW PROCESSLIST
@@ -2323,6 +2367,7 @@ public:
       bool enabled;                   // see ha_enable_transaction()
       bool pending;                   // Is the transaction commit pending?
       bool xid_written;               // The session wrote an XID
+      bool gtid_written;              // The session wrote its GTID
       bool real_commit;               // Is this a "real" commit?
       bool commit_low;                // see MYSQL_BIN_LOG::ordered_commit
       bool run_hooks;                 // Call the after_commit hook
@@ -2669,6 +2714,7 @@ public:
   void inc_status_sort_range();
   void inc_status_sort_rows(ha_rows count);
   void inc_status_sort_scan();
+  void inc_status_sort_parallel(uint threads);
   void set_status_no_index_used();
   void set_status_no_good_index_used();
 
@@ -2921,7 +2967,8 @@ public:
   /*
     If we do a purge of binary logs, log index info of the threads
     that are currently reading it needs to be adjusted. To do that
-    each thread that is using LOG_INFO needs to adjust the pointer to it
+    each thread that is using LOG_INFO needs to adjust the pointer to it.
+    Protected by LOCK_thd_data.
   */
   LOG_INFO*  current_linfo;
   NET*       slave_net;			// network connection from slave -> m.
@@ -3013,6 +3060,21 @@ public:
    */
   ~THD();
 
+  /*
+    The memory of deleted THD objects is kept in a cache of at most
+    thd_cache_size blocks, and new THD objects are constructed in it.
+    With many short connections this saves allocating and freeing the
+    large THD object for each of them.
+  */
+  static void *operator new(size_t size) throw ();
+  static void *operator new(size_t size, const std::nothrow_t&) throw ()
+  { return operator new(size); }
+  static void operator delete(void *ptr, size_t size);
+  static void operator delete(void *ptr, const std::nothrow_t&) throw ()
+  { operator delete(ptr, sizeof(THD)); }
+  /// Free the memory kept in the cache, at shutdown
+  static void free_cache();
+
   void release_resources();
   bool release_resources_done() const { return m_release_resources_done; }
 
@@ -3033,6 +3095,15 @@ public:
     alloc_root. 
   */
   void init_for_queries(Relay_log_info *rli= NULL);
+  /**
+    Free the memory of the finished statement in mem_root, but keep the
+    blocks the next statements are likely to need (up to
+    query_alloc_keep_size bytes) to not malloc them again.
+  */
+  void free_mem_root_for_next_query()
+  {
+    recycle_root(mem_root, &m_mem_root_peak, variables.query_alloc_keep_size);
+  }
   void change_user(void);
   void cleanup_after_query();
   bool store_globals();
@@ -3956,6 +4027,8 @@ private:
     tree itself is reused between executions and thus is stored elsewhere.
   */
   MEM_ROOT main_mem_root;
+  /** Peak of the memory used in mem_root, see recycle_root() */
+  size_t m_mem_root_peak;
   Diagnostics_area main_da;
   Diagnostics_area m_parser_da;              /**< cf. get_parser_da() */
   Diagnostics_area *m_stmt_da;
@@ -4138,6 +4211,15 @@ public:
   virtual bool send_result_set_metadata(List<Item> &list, uint flags)=0;
   virtual bool send_data(List<Item> &items)=0;
   virtual bool initialize_tables (JOIN *join=0) { return 0; }
+  /**
+    Give the result a chance to read the rows of a join itself, instead
+    of JOIN::exec() sending them all at once. Used by streaming server
+    side cursors, which read the rows on each fetch.
+
+    @retval false  the join is to be executed as usual
+    @retval true   the result took over the join, or reported an error
+  */
+  virtual bool take_over_join(JOIN *join) { return false; }
   virtual void send_error(uint errcode,const char *err);
   virtual bool send_eof()=0;
   /**
@@ -4204,6 +4286,25 @@ public:
 };
 
 
+/**
+  Result of the query of EXPLAIN ANALYZE: the rows are produced like for
+  select_send, but they are not sent.
+*/
+
+class select_discard :public select_result_interceptor
+{
+public:
+  select_discard() {}
+  bool send_data(List<Item> &items)
+  {
+    if (unit->offset_limit_cnt)
+      unit->offset_limit_cnt--;                 // using limit offset,count
+    return false;
+  }
+  bool send_eof() { return false; }
+};
+
+
 class select_to_file :public select_result_interceptor {
 protected:
   sql_exchange *exchange;
@@ -4567,6 +4668,25 @@ public:
   friend bool mysql_derived_create(THD *thd, LEX *lex, TABLE_LIST *derived);
 };
 
+
+/**
+  Result of the query blocks of a UNION ALL whose rows are sent straight
+  to the result of the union, see st_select_lex_unit::prepare(). The
+  temporary table of the union is not filled: its record is only used
+  to convert the rows to the types of the columns of the union.
+*/
+class select_union_direct :public select_union
+{
+  select_result *result;                ///< The result of the union
+public:
+  ha_rows sent_rows;                    ///< Rows sent to 'result'
+
+  select_union_direct(select_result *result_arg)
+    :result(result_arg), sent_rows(0)
+  {}
+  bool send_data(List<Item> &items);
+};
+
 /* Base subselect interface class */
 class select_subselect :public select_result_interceptor
 {
@@ -4890,15 +5010,47 @@ class Unique :public Sql_alloc
   bool flush();
   uint size;
 
+  /*
+    With use_hash the keys are not kept in 'tree' but one after the
+    other in hash_keys, and are found by hashing through hash_index,
+    an open addressing table of (position in hash_keys + 1). The keys
+    are sorted only when they are written to the file, or by get().
+  */
+  bool use_hash;
+  uchar *hash_keys;
+  uint32 *hash_index;
+  ulong hash_count;                     ///< Number of keys in hash_keys
+  ulong hash_capacity;                  ///< Room of hash_keys, in keys
+  ulong hash_index_mask;                ///< Size of hash_index - 1
+  bool hash_insert(const uchar *key);
+  bool hash_grow();
+  uint32 *hash_find(const uchar *key);
+  void hash_clear();
+  void hash_sort()
+  {
+    my_qsort2(hash_keys, hash_count, size, tree.compare, tree.custom_arg);
+  }
+
 public:
   ulong elements;
+  /**
+    @param use_hash_arg  Keep the keys in a hash set instead of a tree.
+                         Allowed only if comp_func finds two keys equal
+                         only when they are the same bytes. walk() then
+                         returns the keys in no particular order if they
+                         all fit in memory.
+  */
   Unique(qsort_cmp2 comp_func, void *comp_func_fixed_arg,
-	 uint size_arg, ulonglong max_in_memory_size_arg);
+	 uint size_arg, ulonglong max_in_memory_size_arg,
+         bool use_hash_arg= false);
   ~Unique();
-  ulong elements_in_tree() { return tree.elements_in_tree; }
+  ulong elements_in_tree()
+  { return use_hash ? hash_count : tree.elements_in_tree; }
   inline bool unique_add(void *ptr)
   {
     DBUG_ENTER("unique_add");
+    if (use_hash)
+      DBUG_RETURN(hash_insert(static_cast<uchar*>(ptr)));
     DBUG_PRINT("info", ("tree %u - %lu", tree.elements_in_tree, max_elements));
     if (tree.elements_in_tree > max_elements && flush())
       DBUG_RETURN(1);
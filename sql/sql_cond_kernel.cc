@@ -0,0 +1,430 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Evaluation of simple table conditions over batches of rows, see
+  sql_cond_kernel.h.
+*/
+
+#include "sql_priv.h"
+#include "sql_class.h"
+#include "item.h"
+#include "my_decimal.h"
+#include "sql_cond_kernel.h"
+
+
+Cond_kernel *Cond_kernel::create(THD *thd, Item *cond, TABLE *table)
+{
+  Cond_kernel *kernel= new (thd->mem_root) Cond_kernel(thd->mem_root, table);
+  if (kernel == NULL || cond->add_to_cond_kernel(kernel))
+    return NULL;
+  DBUG_ASSERT(kernel->m_depth == 0);
+  return kernel;
+}
+
+
+Cond_kernel::enum_cmp_op Cond_kernel::swap_op(enum_cmp_op op)
+{
+  switch (op) {
+  case CMP_LT: return CMP_GT;
+  case CMP_LE: return CMP_GE;
+  case CMP_GT: return CMP_LT;
+  case CMP_GE: return CMP_LE;
+  default:     return op;
+  }
+}
+
+
+/**
+  Start an AND or OR group. The nodes of its arguments follow until
+  end_group() is called.
+
+  @param      is_and  true for AND, false for OR
+  @param[out] group   The position of the group, for end_group()
+
+  @retval false  success
+  @retval true   out of memory
+*/
+
+bool Cond_kernel::begin_group(bool is_and, uint *group)
+{
+  Node node;
+  memset(&node, 0, sizeof(node));
+  node.type= is_and ? NODE_AND : NODE_OR;
+  *group= m_nodes.size();
+  if (add_node(node))
+    return true;
+  if (++m_depth > m_max_depth)
+    m_max_depth= m_depth;
+  return false;
+}
+
+
+void Cond_kernel::end_group(uint group)
+{
+  m_nodes.at(group).end= m_nodes.size();
+  m_depth--;
+}
+
+
+/**
+  Set up the column of a comparison.
+
+  @retval false  the column is a column of the table
+  @retval true   the argument cannot be read from the rows of the table
+*/
+
+bool Cond_kernel::init_column(Node *node, Item *column, Field **field)
+{
+  if (column->type() != Item::FIELD_ITEM)
+    return true;
+  Field *f= static_cast<Item_field*>(column)->field;
+  if (f->table != m_table ||
+      f->ptr < m_table->record[0] ||
+      f->ptr >= m_table->record[0] + m_table->s->reclength)
+    return true;
+
+  memset(node, 0, sizeof(*node));
+  node->offset= (uint) (f->ptr - m_table->record[0]);
+  node->length= f->pack_length();
+  if (f->real_maybe_null())
+  {
+    node->null_offset= f->null_offset();
+    node->null_bit= f->null_bit;
+  }
+  node->is_unsigned= test(f->flags & UNSIGNED_FLAG);
+  *field= f;
+  return false;
+}
+
+
+/// @returns true if the item is a constant whose value can be put in a node
+static bool is_kernel_const(Item *value)
+{
+  return value->basic_const_item() && value->type() != Item::NULL_ITEM;
+}
+
+
+/**
+  Add a comparison of an integer column with integer constants, like
+  Arg_comparator::compare_int_signed() and its variants do it. BETWEEN
+  compares the values as signed integers, like Item_func_between.
+*/
+
+bool Cond_kernel::add_int_cmp(enum_cmp_op op, Item *column,
+                              Item *value1, Item *value2)
+{
+  Node node;
+  Field *field;
+  if (init_column(&node, column, &field))
+    return true;
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    break;
+  default:
+    return true;
+  }
+#ifdef WORDS_BIGENDIAN
+  /* The columns are stored in the native byte order. */
+  if (!m_table->s->db_low_byte_first)
+    return true;
+#endif
+  if (!is_kernel_const(value1) || (value2 && !is_kernel_const(value2)))
+    return true;
+
+  node.type= NODE_INT;
+  node.op= op;
+  node.value[0]= value1->val_int();
+  if (op == CMP_BETWEEN)
+    node.value[1]= value2->val_int();
+  else if (node.is_unsigned != test(value1->unsigned_flag) &&
+           node.value[0] < 0)
+  {
+    /*
+      A negative constant with an UNSIGNED column, or a constant above
+      LONGLONG_MAX with a signed column: the order of the values is the
+      same for all rows.
+    */
+    const int order= node.is_unsigned ? 1 : -1;
+    bool result;
+    switch (op) {
+    case CMP_EQ: result= false; break;
+    case CMP_NE: result= true; break;
+    case CMP_LT:
+    case CMP_LE: result= order < 0; break;
+    default:     result= order > 0; break;
+    }
+    node.type= result ? NODE_IS_NOT_NULL : NODE_FALSE;
+  }
+  else
+    node.unsigned_cmp= node.is_unsigned;
+  return add_node(node);
+}
+
+
+/**
+  Add a comparison of a DECIMAL column with constants. The constants are
+  converted to the binary format of the column, in which values compare
+  with memcmp() like with my_decimal_cmp(), so only constants that the
+  column represents exactly are supported.
+*/
+
+bool Cond_kernel::add_decimal_cmp(enum_cmp_op op, Item *column,
+                                  Item *value1, Item *value2)
+{
+  Node node;
+  Field *field;
+  if (init_column(&node, column, &field) ||
+      field->real_type() != MYSQL_TYPE_NEWDECIMAL)
+    return true;
+  Field_new_decimal *dec_field= static_cast<Field_new_decimal*>(field);
+  Item *values[2]= { value1, value2 };
+
+  node.type= NODE_DECIMAL;
+  node.op= op;
+  for (uint i= 0; i < (op == CMP_BETWEEN ? 2U : 1U); i++)
+  {
+    my_decimal buf;
+    my_decimal *dec;
+    uchar *bin;
+    if (!is_kernel_const(values[i]) ||
+        !(dec= values[i]->val_decimal(&buf)) ||
+        !(bin= (uchar*) alloc_root(m_mem_root, dec_field->bin_size)) ||
+        my_decimal2binary(0, dec, bin, dec_field->precision,
+                          dec_field->dec) != E_DEC_OK)
+      return true;
+    node.bin[i]= bin;
+  }
+  return add_node(node);
+}
+
+
+/**
+  Add a comparison of a DATE column with constant dates or datetimes,
+  compared as packed datetime values like in
+  Arg_comparator::compare_datetime().
+*/
+
+bool Cond_kernel::add_date_cmp(enum_cmp_op op, Item *column,
+                               Item *value1, Item *value2)
+{
+  Node node;
+  Field *field;
+  if (init_column(&node, column, &field) ||
+      field->real_type() != MYSQL_TYPE_NEWDATE)
+    return true;
+  /* Other constants are converted with warnings, see get_datetime_value() */
+  if (!is_kernel_const(value1) || !value1->is_temporal_with_date() ||
+      (value2 && (!is_kernel_const(value2) ||
+                  !value2->is_temporal_with_date())))
+    return true;
+
+  node.type= NODE_DATE;
+  node.op= op;
+  node.value[0]= value1->val_date_temporal();
+  if (value2)
+    node.value[1]= value2->val_date_temporal();
+  return add_node(node);
+}
+
+
+bool Cond_kernel::add_null_test(Item *column, bool is_null)
+{
+  Node node;
+  Field *field;
+  if (init_column(&node, column, &field))
+    return true;
+  node.type= is_null ? NODE_IS_NULL : NODE_IS_NOT_NULL;
+  return add_node(node);
+}
+
+
+static inline bool column_is_null(const uchar *row, uint null_offset,
+                                  uchar null_bit)
+{
+  return row[null_offset] & null_bit;
+}
+
+
+/// @returns the value of an integer column as stored by Field_num
+static inline longlong int_column_value(const uchar *ptr, uint length,
+                                        bool is_unsigned)
+{
+  switch (length) {
+  case 1:
+    return is_unsigned ? (longlong) *ptr : (longlong) (signed char) *ptr;
+  case 2:
+    return is_unsigned ? (longlong) uint2korr(ptr) : (longlong) sint2korr(ptr);
+  case 3:
+    return is_unsigned ? (longlong) uint3korr(ptr) : (longlong) sint3korr(ptr);
+  case 4:
+    return is_unsigned ? (longlong) uint4korr(ptr) : (longlong) sint4korr(ptr);
+  default:
+    return sint8korr(ptr);
+  }
+}
+
+
+template <typename T>
+static inline bool cmp_matches(Cond_kernel::enum_cmp_op op, T value,
+                               T value1, T value2)
+{
+  switch (op) {
+  case Cond_kernel::CMP_EQ: return value == value1;
+  case Cond_kernel::CMP_NE: return value != value1;
+  case Cond_kernel::CMP_LT: return value < value1;
+  case Cond_kernel::CMP_LE: return value <= value1;
+  case Cond_kernel::CMP_GT: return value > value1;
+  case Cond_kernel::CMP_GE: return value >= value1;
+  case Cond_kernel::CMP_BETWEEN: return value >= value1 && value <= value2;
+  }
+  return false;
+}
+
+
+template <typename T>
+void Cond_kernel::eval_int(const Node *node, const uchar *rows,
+                           size_t stride, uint count, uchar *res) const
+{
+  const T value1= (T) node->value[0];
+  const T value2= (T) node->value[1];
+  const uchar *row= rows;
+  for (uint i= 0; i < count; i++, row+= stride)
+  {
+    if (column_is_null(row, node->null_offset, node->null_bit))
+      res[i]= 0;
+    else
+    {
+      const T value= (T) int_column_value(row + node->offset, node->length,
+                                          node->is_unsigned);
+      res[i]= cmp_matches(node->op, value, value1, value2);
+    }
+  }
+}
+
+
+void Cond_kernel::eval_decimal(const Node *node, const uchar *rows,
+                               size_t stride, uint count, uchar *res) const
+{
+  const uchar *row= rows;
+  for (uint i= 0; i < count; i++, row+= stride)
+  {
+    if (column_is_null(row, node->null_offset, node->null_bit))
+      res[i]= 0;
+    else if (node->op == CMP_BETWEEN)
+      res[i]= memcmp(row + node->offset, node->bin[0], node->length) >= 0 &&
+              memcmp(row + node->offset, node->bin[1], node->length) <= 0;
+    else
+      res[i]= cmp_matches(node->op,
+                          memcmp(row + node->offset, node->bin[0],
+                                 node->length), 0, 0);
+  }
+}
+
+
+void Cond_kernel::eval_date(const Node *node, const uchar *rows,
+                            size_t stride, uint count, uchar *res) const
+{
+  const uchar *row= rows;
+  for (uint i= 0; i < count; i++, row+= stride)
+  {
+    if (column_is_null(row, node->null_offset, node->null_bit))
+      res[i]= 0;
+    else
+    {
+      /* See Field_newdate::val_date_temporal() */
+      const uint32 tmp= uint3korr(row + node->offset);
+      const longlong ymd= (((tmp >> 9) * 13 + ((tmp >> 5) & 15)) << 5) |
+                          (tmp & 31);
+      res[i]= cmp_matches(node->op, MY_PACKED_TIME_MAKE_INT(ymd << 17),
+                          node->value[0], node->value[1]);
+    }
+  }
+}
+
+
+/**
+  Evaluate a node for a batch of rows.
+
+  The arguments of AND and OR are evaluated one after another over the
+  whole batch: the first one into the result, the next ones into the
+  scratch buffer of the group, with the deeper part of the buffer left
+  to nested groups.
+
+  @returns the position of the node after the evaluated node and its
+    arguments
+*/
+
+uint Cond_kernel::eval_node(uint pos, const uchar *rows, size_t stride,
+                            uint count, uchar *res, uchar *scratch) const
+{
+  const Node *node= &m_nodes.at(pos);
+  const uchar *row= rows;
+
+  switch (node->type) {
+  case NODE_AND:
+  case NODE_OR:
+  {
+    const bool is_and= node->type == NODE_AND;
+    uint next= eval_node(pos + 1, rows, stride, count, res, scratch);
+    while (next < node->end)
+    {
+      /* Stop when the result of every row is known */
+      if (!memchr(res, is_and ? 1 : 0, count))
+        break;
+      next= eval_node(next, rows, stride, count, scratch, scratch + count);
+      if (is_and)
+        for (uint i= 0; i < count; i++)
+          res[i]&= scratch[i];
+      else
+        for (uint i= 0; i < count; i++)
+          res[i]|= scratch[i];
+    }
+    return node->end;
+  }
+  case NODE_INT:
+    if (node->unsigned_cmp)
+      eval_int<ulonglong>(node, rows, stride, count, res);
+    else
+      eval_int<longlong>(node, rows, stride, count, res);
+    break;
+  case NODE_DECIMAL:
+    eval_decimal(node, rows, stride, count, res);
+    break;
+  case NODE_DATE:
+    eval_date(node, rows, stride, count, res);
+    break;
+  case NODE_IS_NULL:
+  case NODE_IS_NOT_NULL:
+  {
+    const bool is_null= node->type == NODE_IS_NULL;
+    for (uint i= 0; i < count; i++, row+= stride)
+      res[i]= column_is_null(row, node->null_offset, node->null_bit) ==
+              is_null;
+    break;
+  }
+  case NODE_FALSE:
+    memset(res, 0, count);
+    break;
+  }
+  return pos + 1;
+}
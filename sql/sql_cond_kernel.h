@@ -0,0 +1,148 @@
+#ifndef SQL_COND_KERNEL_INCLUDED
+#define SQL_COND_KERNEL_INCLUDED
+
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file
+
+  @brief
+  Evaluation of simple table conditions over batches of rows.
+
+  A Cond_kernel is built from the condition attached to a table when the
+  condition is an AND/OR tree of comparisons of integer, DECIMAL and DATE
+  columns of the table with constants. It reads the column values
+  directly from row buffers in the format of table->record[0], and it
+  evaluates the condition for a whole batch of rows at a time, one
+  predicate over all rows before the next one.
+
+  A NULL (unknown) result is treated like FALSE, which makes the kernel
+  usable only where rows are rejected unless the condition is TRUE, as
+  in WHERE and ON. This is why NOT is not supported.
+*/
+
+#include "my_global.h"
+#include "sql_alloc.h"
+#include "mem_root_array.h"
+
+class Item;
+class THD;
+class Field;
+struct TABLE;
+
+class Cond_kernel :public Sql_alloc
+{
+public:
+  /// Comparison of a column with one or two constants
+  enum enum_cmp_op
+  {
+    CMP_EQ, CMP_NE, CMP_LT, CMP_LE, CMP_GT, CMP_GE,
+    CMP_BETWEEN                                 ///< value1 <= col <= value2
+  };
+
+  /**
+    Build the kernel of a condition on a table.
+
+    @param thd    Thread handle, the kernel is allocated on its mem_root
+    @param cond   The condition
+    @param table  The table whose rows the kernel is evaluated on
+
+    @return The kernel, or NULL if the condition has parts that are not
+      supported by kernels (see Item::add_to_cond_kernel())
+  */
+  static Cond_kernel *create(THD *thd, Item *cond, TABLE *table);
+
+  /**
+    Evaluate the condition for a batch of rows.
+
+    @param rows     The first row
+    @param stride   Distance in bytes between two rows
+    @param count    Number of rows
+    @param[out] matches  matches[i] is set to 1 if row i satisfies the
+                         condition and to 0 otherwise
+    @param scratch  Buffer of scratch_per_row() * count bytes
+  */
+  void evaluate(const uchar *rows, size_t stride, uint count,
+                uchar *matches, uchar *scratch) const
+  {
+    eval_node(0, rows, stride, count, matches, scratch);
+  }
+
+  /// Number of bytes of scratch space that evaluate() needs per row
+  uint scratch_per_row() const { return m_max_depth; }
+
+  /* Building of the kernel, used by Item::add_to_cond_kernel() */
+
+  bool begin_group(bool is_and, uint *group);
+  void end_group(uint group);
+  bool add_int_cmp(enum_cmp_op op, Item *column, Item *value1, Item *value2);
+  bool add_decimal_cmp(enum_cmp_op op, Item *column,
+                       Item *value1, Item *value2);
+  bool add_date_cmp(enum_cmp_op op, Item *column, Item *value1, Item *value2);
+  bool add_null_test(Item *column, bool is_null);
+
+  /// @returns the operator of (b op a) that is equivalent to (a op b)
+  static enum_cmp_op swap_op(enum_cmp_op op);
+
+private:
+  enum enum_node_type
+  {
+    NODE_AND, NODE_OR,
+    NODE_INT, NODE_DECIMAL, NODE_DATE,
+    NODE_IS_NULL, NODE_IS_NOT_NULL, NODE_FALSE
+  };
+
+  struct Node
+  {
+    enum_node_type type;
+    enum_cmp_op op;
+    uint end;                         ///< AND/OR: end of the group's nodes
+    uint offset;                      ///< column offset in the row
+    uint length;                      ///< column length
+    uint null_offset;
+    uchar null_bit;                   ///< 0 if the column is NOT NULL
+    bool is_unsigned;                 ///< the column is UNSIGNED
+    bool unsigned_cmp;                ///< the values are compared unsigned
+    longlong value[2];                ///< INT/DATE: the constants
+    const uchar *bin[2];              ///< DECIMAL: the constants, binary
+  };
+
+  Cond_kernel(MEM_ROOT *mem_root, TABLE *table)
+    :m_nodes(mem_root), m_mem_root(mem_root), m_table(table),
+     m_depth(0), m_max_depth(0)
+  {}
+
+  bool init_column(Node *node, Item *column, Field **field);
+  bool add_node(const Node &node) { return m_nodes.push_back(node); }
+
+  uint eval_node(uint pos, const uchar *rows, size_t stride, uint count,
+                 uchar *res, uchar *scratch) const;
+  template <typename T>
+  void eval_int(const Node *node, const uchar *rows, size_t stride,
+                uint count, uchar *res) const;
+  void eval_decimal(const Node *node, const uchar *rows, size_t stride,
+                    uint count, uchar *res) const;
+  void eval_date(const Node *node, const uchar *rows, size_t stride,
+                 uint count, uchar *res) const;
+
+  Mem_root_array<Node, true> m_nodes;
+  MEM_ROOT *m_mem_root;
+  TABLE *m_table;
+  uint m_depth;                       ///< nesting of the group being built
+  uint m_max_depth;
+};
+
+#endif /* SQL_COND_KERNEL_INCLUDED */
@@ -74,6 +74,8 @@
 
 #define DEFAULT_SORT_MEMORY (256U* 1024U)
 #define MIN_SORT_MEMORY     (32U * 1024U)
+/* Max value of sort_threads */
+#define MAX_SORT_THREADS    64U
 
 /* Some portable defines */
 
@@ -105,6 +107,12 @@
 ****************************************************************************/
 
 #define ACL_CACHE_SIZE		256
+/* Per-connection cache of db-level privileges, @sa Acl_db_access_cache */
+#define ACL_DB_ACCESS_CACHE_SIZE 4
+#define IP_ADDR_STRLEN (3 + 1 + 3 + 1 + 3 + 1 + 3)
+/* Length of the keys of acl_cache: ip, user and db */
+#define ACL_KEY_LENGTH (IP_ADDR_STRLEN + 1 + NAME_LEN + \
+                        1 + USERNAME_LENGTH + 1)
 #define MAX_PASSWORD_LENGTH	32
 #define HOST_CACHE_SIZE		128
 #define MAX_ACCEPT_RETRY	10	// Test accept this many times
@@ -149,6 +157,7 @@
 
 #define QUERY_ALLOC_BLOCK_SIZE		8192
 #define QUERY_ALLOC_PREALLOC_SIZE   	8192
+#define QUERY_ALLOC_KEEP_SIZE		(256*1024)
 #define TRANS_ALLOC_BLOCK_SIZE		4096
 #define TRANS_ALLOC_PREALLOC_SIZE	4096
 #define RANGE_ALLOC_BLOCK_SIZE		4096
@@ -170,8 +179,19 @@
   The following is used to decide if MySQL should use table scanning
   instead of reading with keys.  The number says how costly evaluation of the
   filter condition for a row is compared to reading one extra row from a table.
+  It is set with the optimizer_row_evaluate_cost system variable.
 */
-#define ROW_EVALUATE_COST  0.20
+#define ROW_EVALUATE_COST_DEFAULT  0.20
+#define ROW_EVALUATE_COST  opt_row_evaluate_cost
+
+/**
+  Cost of reading a block of a table from disk, and from the memory buffer
+  of the storage engine, see handler::page_read_cost(). They are set with
+  the optimizer_io_block_read_cost and optimizer_memory_block_read_cost
+  system variables.
+*/
+#define IO_BLOCK_READ_COST_DEFAULT      1.0
+#define MEMORY_BLOCK_READ_COST_DEFAULT  1.0
 
 /**
   Cost of comparing a rowid compared to reading one row from a table.
@@ -19,6 +19,12 @@
 #include "probes_mysql.h"
 #include "sql_parse.h"                        // mysql_execute_command
 #include "sql_tmp_table.h"                   // tmp tables
+#include "sql_select.h"
+#include "sql_optimizer.h"                   // JOIN
+#include "sql_executor.h"                    // sub_select
+#include "sql_base.h"                        // close_thread_table
+#include "lock.h"                            // mysql_lock_tables
+#include "transaction.h"                     // trans_commit_stmt
 
 /****************************************************************************
   Declarations.
@@ -53,13 +59,55 @@ public:
 };
 
 
+/**
+  Streaming_cursor -- a sensitive server-side cursor, which reads
+  the rows from the tables on each fetch, instead of saving the
+  result set at open. The nested loop join is suspended when the
+  rows of a fetch have been sent, and resumed by the next fetch.
+
+  Only plans without blocking operations (sorting, grouping,
+  temporary tables, join buffering) over tables of transactional
+  engines are streamed, and only inside a multi-statement transaction:
+  the cursor keeps the tables open, and their metadata locks taken,
+  until it is closed, at the latest at COMMIT or ROLLBACK. Like a
+  HANDLER, the cursor locks the tables for the duration of a fetch.
+*/
+
+class Streaming_cursor: public Server_side_cursor
+{
+  /** The memory of the execution, including the join and the cursor */
+  MEM_ROOT main_mem_root;
+  JOIN *join;
+  /** The arena of the statement, whose items are cleaned up at close */
+  Query_arena *stmt_arena;
+  /** The tables of the join, taken over from THD::open_tables */
+  TABLE *open_tables;
+  /** The same tables, as an array for mysql_lock_tables() */
+  TABLE **tables;
+  uint table_count;
+  /** Changes of the item tree, rolled back at close */
+  Item_change_list change_list;
+public:
+  Streaming_cursor(select_result *result);
+
+  static bool can_stream(JOIN *join);
+  virtual bool is_open() const { return join != 0; }
+  virtual bool is_transient() const { return true; }
+  virtual int open(JOIN *join);
+  void post_open(THD *thd);
+  virtual void fetch(ulong num_rows);
+  virtual void close();
+  virtual ~Streaming_cursor();
+};
+
+
 /**
   Select_materialize -- a mediator between a cursor query and the
-  protocol. In case we were not able to open a non-materialzed
-  cursor, it creates an internal temporary HEAP table, and insert
-  all rows into it. When the table reaches max_heap_table_size,
-  it's converted to a MyISAM table. Later this table is used to
-  create a Materialized_cursor.
+  protocol. If the join of the query can be streamed, it opens a
+  Streaming_cursor. Otherwise it creates an internal temporary HEAP
+  table, and insert all rows into it. When the table reaches
+  max_heap_table_size, it's converted to a MyISAM table. Later this
+  table is used to create a Materialized_cursor.
 */
 
 class Select_materialize: public select_union
@@ -67,16 +115,18 @@ class Select_materialize: public select_union
   select_result *result; /**< the result object of the caller (PS or SP) */
 public:
   Materialized_cursor *materialized_cursor;
+  Streaming_cursor *streaming_cursor;
   Select_materialize(select_result *result_arg)
-    :result(result_arg), materialized_cursor(0) {}
+    :result(result_arg), materialized_cursor(0), streaming_cursor(0) {}
   virtual bool send_result_set_metadata(List<Item> &list, uint flags);
+  virtual bool take_over_join(JOIN *join);
 };
 
 
 /**************************************************************************/
 
 /**
-  Attempt to open a materialized cursor.
+  Attempt to open a streaming or a materialized cursor.
 
   @param      thd           thread handle
   @param[in]  result        result class of the caller used as a destination
@@ -121,6 +171,8 @@ bool mysql_open_cursor(THD *thd, select_result *result,
   lex->result= save_result;
   /*
     Possible options here:
+    - a streaming cursor is open. In this case rc is 0 and
+      result_materialize->streaming_cursor is not NULL
     - a materialized cursor is open. In this case rc is 0 and
       result_materialize->materialized is not NULL
     - an error occurred during materialization.
@@ -140,10 +192,25 @@ bool mysql_open_cursor(THD *thd, select_result *result,
 
       delete result_materialize->materialized_cursor;
     }
+    if (result_materialize->streaming_cursor)
+    {
+      result->abort_result_set();
+      delete result_materialize->streaming_cursor;
+    }
 
     goto end;
   }
 
+  if (result_materialize->streaming_cursor)
+  {
+    /*
+      The cursor keeps the tables, the items and the memory of the
+      execution: the statement is cleaned up when the cursor is closed.
+    */
+    result_materialize->streaming_cursor->post_open(thd);
+    *pcursor= result_materialize->streaming_cursor;
+  }
+
   if (result_materialize->materialized_cursor)
   {
     Materialized_cursor *materialized_cursor=
@@ -377,10 +444,282 @@ Materialized_cursor::~Materialized_cursor()
 }
 
 
+/***************************************************************************
+ Streaming_cursor
+****************************************************************************/
+
+Streaming_cursor::Streaming_cursor(select_result *result_arg)
+  :Server_side_cursor(&main_mem_root, result_arg),
+  join(0),
+  stmt_arena(0),
+  open_tables(0),
+  tables(0),
+  table_count(0)
+{
+  /* Stays empty until post_open(), see Server_side_cursor::operator delete */
+  init_sql_alloc(key_memory_thd_main_mem_root,
+                 &main_mem_root, ALLOC_ROOT_MIN_BLOCK_SIZE, 0);
+}
+
+
+/**
+  Check if the rows of a join can be read on demand, by suspending
+  and resuming the nested loop join, without changing the result.
+
+  @param join  the optimized join of the cursor query
+
+  @return true if a Streaming_cursor can be opened for the join
+*/
+
+bool Streaming_cursor::can_stream(JOIN *join)
+{
+  THD *thd= join->thd;
+  LEX *lex= thd->lex;
+  SELECT_LEX *select_lex= join->select_lex;
+
+  /*
+    The tables must stay consistent, and locked by metadata locks,
+    between the fetches: only a transaction does that.
+  */
+  if (!thd->in_multi_stmt_transaction_mode() ||
+      thd->locked_tables_mode || thd->in_sub_stmt || thd->sp_runtime_ctx ||
+      lex->requires_prelocking() || lex->uses_stored_routines() ||
+      lex->describe || lex->proc_analyse)
+    return false;
+
+  /* A single query block, without subqueries or derived tables. */
+  if (select_lex != lex->select_lex || select_lex->master_unit()->is_union() ||
+      select_lex->first_inner_unit() != NULL)
+    return false;
+
+  /* No operation that needs all rows before sending the first one. */
+  if (join->plan_is_const() || join->need_tmp ||
+      join->tables != join->primary_tables ||
+      join->group_list || join->select_distinct ||
+      select_lex->with_sum_func || join->having ||
+      (join->select_options & OPTION_FOUND_ROWS))
+    return false;
+
+  for (uint i= 0; i < join->tables; i++)
+  {
+    JOIN_TAB *tab= join->join_tab + i;
+    TABLE *table= tab->table;
+
+    if (table->s->tmp_table != NO_TMP_TABLE ||
+        !table->file->has_transactions() ||
+        tab->filesort || tab->op || tab->first_inner || tab->last_inner ||
+        tab->get_sj_strategy() != SJ_OPT_NONE)
+      return false;
+    /* The resumed join only knows of plain nested loops. */
+    if (i >= join->const_tables && i < join->tables - 1 &&
+        tab->next_select != sub_select)
+      return false;
+  }
+
+  /* The cursor takes over all open tables of the statement. */
+  uint count= 0;
+  for (TABLE *table= thd->open_tables; table; table= table->next)
+    count++;
+  return count == join->tables;
+}
+
+
+/**
+  Open the cursor: send the metadata of the result set, and take over
+  the join and the open tables of the statement. No rows are read.
+
+  @param join_arg  the optimized join, which has not read any row yet
+
+  @return 0 on success, an error is reported otherwise
+*/
+
+int Streaming_cursor::open(JOIN *join_arg)
+{
+  THD *thd= join_arg->thd;
+  TABLE *table;
+
+  if (!(tables= (TABLE **) thd->alloc(join_arg->tables * sizeof(TABLE *))))
+    return 1;
+  for (table= thd->open_tables; table; table= table->next)
+    tables[table_count++]= table;
+
+  if (join_arg->change_result(result) ||
+      result->send_result_set_metadata(*join_arg->fields,
+                                       Protocol::SEND_NUM_ROWS))
+  {
+    result->abort_result_set();
+    return 1;
+  }
+  thd->server_status|= SERVER_STATUS_CURSOR_EXISTS;
+  result->send_eof();
+
+  join= join_arg;
+  join->send_records= 0;
+  /* The rows skipped by OFFSET are counted as sent, see end_send(). */
+  join->fetch_limit= join->unit->offset_limit_cnt;
+  /* Keep the join from being destroyed at the end of the statement. */
+  join->select_lex->join= NULL;
+
+  /*
+    Keep the tables from being closed at the end of the statement. They
+    are unlocked then, and locked again for each fetch, while scans are
+    in progress, like tables opened by HANDLER.
+  */
+  open_tables= thd->open_tables;
+  thd->set_open_tables(NULL);
+  for (table= open_tables; table; table= table->next)
+    table->open_by_handler= 1;
+  return 0;
+}
+
+
+/**
+  Take over the state of the statement which opened the cursor:
+  the memory and the items of the execution, which the join uses,
+  and the changes of the item tree, rolled back at close.
+  Called after mysql_execute_command(), which releases the
+  statement state otherwise.
+*/
+
+void Streaming_cursor::post_open(THD *thd)
+{
+  main_mem_root= *thd->mem_root;
+  init_sql_alloc(key_memory_thd_main_mem_root, thd->mem_root,
+                 thd->variables.query_alloc_block_size,
+                 thd->variables.query_prealloc_size);
+  free_list= thd->free_list;
+  thd->free_list= NULL;
+  thd->change_list.move_elements_to(&change_list);
+  stmt_arena= thd->stmt_arena;
+}
+
+
+/**
+  Send up to the given number of rows, resuming the join where the
+  previous fetch left it. Like a statement, the fetch locks the tables,
+  and ends with the end of the statement transaction.
+
+  When the join is complete the cursor is closed, and the EOF packet
+  is sent with SERVER_STATUS_LAST_ROW_SENT.
+*/
+
+void Streaming_cursor::fetch(ulong num_rows)
+{
+  THD *thd= join->thd;
+  JOIN_TAB *join_tab= join->join_tab + join->const_tables;
+  enum_nested_loop_state error;
+  Query_arena backup_arena;
+  MYSQL_LOCK *lock;
+
+  if (!(lock= mysql_lock_tables(thd, tables, table_count, 0)))
+  {
+    close();
+    trans_rollback_stmt(thd);
+    return;
+  }
+
+  change_list.move_elements_to(&thd->change_list);
+  /* Items created by the fetch live as long as the join. */
+  thd->set_n_backup_active_arena(this, &backup_arena);
+
+  result->begin_dataset();
+  join->fetch_limit+= num_rows;
+  error= sub_select(join, join_tab, false);
+  if (error == NESTED_LOOP_OK || error == NESTED_LOOP_QUERY_LIMIT)
+    error= sub_select(join, join_tab, true);
+
+  thd->restore_active_arena(this, &backup_arena);
+  thd->change_list.move_elements_to(&change_list);
+  mysql_unlock_tables(thd, lock);
+
+  if (error == NESTED_LOOP_CURSOR_LIMIT)
+  {
+    /* All rows of this fetch are sent, possibly more rows are there */
+    join->resume_nested_loop= true;
+    thd->server_status|= SERVER_STATUS_CURSOR_EXISTS;
+    result->send_eof();
+  }
+  else
+  {
+    /*
+      Close before the end of the statement transaction, which
+      may close the transient cursors, if the transaction is rolled back.
+    */
+    close();
+    if (error == NESTED_LOOP_OK)
+    {
+      thd->server_status|= SERVER_STATUS_LAST_ROW_SENT;
+      result->send_eof();
+    }
+  }
+
+  if (thd->is_error())
+    trans_rollback_stmt(thd);
+  else
+    trans_commit_stmt(thd);
+}
+
+
+void Streaming_cursor::close()
+{
+  THD *thd= join->thd;
+  Item_change_list save_change_list;
+
+  (void) join->destroy();
+  delete join;
+  join= 0;
+
+  while (open_tables)
+  {
+    open_tables->file->ha_index_or_rnd_end();
+    open_tables->open_by_handler= 0;
+    close_thread_table(thd, &open_tables);
+  }
+
+  /* Clean up the statement for its next execution, see cleanup_stmt(). */
+  thd->change_list.move_elements_to(&save_change_list);
+  change_list.move_elements_to(&thd->change_list);
+  thd->rollback_item_tree_changes();
+  save_change_list.move_elements_to(&thd->change_list);
+  if (stmt_arena)
+    cleanup_items(stmt_arena->free_list);
+  stmt_arena= 0;
+  free_items();
+}
+
+
+Streaming_cursor::~Streaming_cursor()
+{
+  if (is_open())
+    close();
+}
+
+
 /***************************************************************************
  Select_materialize
 ****************************************************************************/
 
+/**
+  Open a Streaming_cursor for the join, if its rows can be read on
+  demand. Otherwise JOIN::exec() sends the rows to the temporary table.
+*/
+
+bool Select_materialize::take_over_join(JOIN *join)
+{
+  if (!Streaming_cursor::can_stream(join))
+    return false;
+
+  if (!(streaming_cursor= new (join->thd->mem_root) Streaming_cursor(result)))
+    return true;
+  if (streaming_cursor->open(join))
+  {
+    delete streaming_cursor;
+    streaming_cursor= 0;
+  }
+  return true;
+}
+
+
 bool Select_materialize::send_result_set_metadata(List<Item> &list, uint flags)
 {
   DBUG_ASSERT(table == 0);
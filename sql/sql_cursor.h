@@ -28,8 +28,8 @@ class JOIN;
 */
 
 /**
-  Server_side_cursor -- an interface for materialized
-  implementation of cursors. All cursors are self-contained
+  Server_side_cursor -- an interface for materialized and streaming
+  implementations of cursors. All cursors are self-contained
   (created in their own memory root).  For that reason they must
   be deleted only using a pointer to Server_side_cursor, not to
   its base class.
@@ -46,6 +46,11 @@ public:
   {}
 
   virtual bool is_open() const= 0;
+  /**
+    True if the cursor depends on the state of the current transaction,
+    and has to be closed at COMMIT or ROLLBACK.
+  */
+  virtual bool is_transient() const { return false; }
 
   virtual int open(JOIN *top_level_join)= 0;
   virtual void fetch(ulong num_rows)= 0;
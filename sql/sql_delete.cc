@@ -832,10 +832,14 @@ multi_delete::initialize_tables(JOIN *join)
   for (;walk ;walk= walk->next_local)
   {
     TABLE *table=walk->table;
+    /*
+      The row ids of a row found several times are the same bytes, so they
+      can be kept in a hash set; Unique::get() sorts them in disk order.
+    */
     *tempfiles_ptr++= new Unique (refpos_order_cmp,
 				  (void *) table->file,
 				  table->file->ref_length,
-				  MEM_STRIP_BUF_SIZE);
+				  MEM_STRIP_BUF_SIZE, true);
   }
   init_ftfuncs(thd, thd->lex->current_select(), 1);
   DBUG_RETURN(thd->is_fatal_error != 0);
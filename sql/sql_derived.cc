@@ -29,6 +29,7 @@
 #include "sql_view.h"                         // check_duplicate_names
 #include "auth_common.h"                      // SELECT_ACL
 #include "sql_tmp_table.h"                    // Tmp tables
+#include "opt_trace.h"                         // Opt_trace_object
 
 
 /**
@@ -297,6 +298,229 @@ bool mysql_derived_optimize(THD *thd, LEX *lex, TABLE_LIST *derived)
 }
 
 
+/**
+  Find the expression of the query of a derived table that a column of
+  the derived table is materialized from, if a condition on the column
+  may be evaluated on the expression before grouping.
+
+  @param select  The query of the derived table
+  @param column  The column, of the derived table
+
+  @return A new Item_field over the expression, or NULL if the column is
+    not materialized from a column of a table of the query or, for a
+    grouped query, not from a grouping column
+*/
+
+static Item *derived_column_expr(THD *thd, SELECT_LEX *select,
+                                 Item_field *column)
+{
+  List_iterator_fast<Item> it(select->item_list);
+  Item *expr;
+  for (uint i= 0; (expr= it++); i++)
+    if (i == column->field->field_index)
+      break;
+  if (expr == NULL || expr->type() != Item::FIELD_ITEM)
+    return NULL;
+
+  Item_field *const expr_field= static_cast<Item_field*>(expr);
+  if (select->group_list.elements)
+  {
+    ORDER *group;
+    for (group= select->group_list.first; group; group= group->next)
+      if ((*group->item)->real_item()->eq(expr_field, false))
+        break;
+    if (group == NULL)
+      return NULL;
+  }
+  return new Item_field(thd, &select->context, expr_field->field);
+}
+
+
+/**
+  Copy a condition on the columns of a derived table to a condition on
+  the expressions of its query that the columns are materialized from.
+
+  Only comparisons, BETWEEN and IN predicates whose arguments are columns
+  of the derived table and literals are copied. The literals are shared
+  with the original condition, so that a dynamic parameter has the same
+  value in both at each execution.
+
+  @param select   The query of the derived table
+  @param derived  The derived table
+  @param cond     The condition
+
+  @return The copy, fixed, or NULL if the condition cannot be copied or an
+    error occurred
+*/
+
+static Item *derived_copy_condition(THD *thd, SELECT_LEX *select,
+                                    TABLE_LIST *derived, Item *cond)
+{
+  if (cond->type() != Item::FUNC_ITEM)
+    return NULL;
+
+  Item_func *const func= static_cast<Item_func*>(cond);
+  const uint arg_count= func->argument_count();
+  if (arg_count < 2)
+    return NULL;
+
+  Item **const args= (Item**) thd->alloc(sizeof(Item*) * arg_count);
+  if (args == NULL)
+    return NULL;
+  bool has_column= false;
+  for (uint i= 0; i < arg_count; i++)
+  {
+    Item *const arg= func->arguments()[i];
+    Item *const real_arg= arg->real_item();
+    if (real_arg->type() == Item::FIELD_ITEM &&
+        static_cast<Item_field*>(real_arg)->field->table == derived->table)
+    {
+      if (!(args[i]= derived_column_expr(thd, select,
+                                         static_cast<Item_field*>(real_arg))))
+        return NULL;
+      has_column= true;
+    }
+    else if (arg->basic_const_item())
+      args[i]= arg;
+    else
+      return NULL;
+  }
+  if (!has_column)
+    return NULL;
+
+  Item *copy;
+  switch (func->functype())
+  {
+  case Item_func::EQ_FUNC:
+    copy= new Item_func_eq(args[0], args[1]);
+    break;
+  case Item_func::EQUAL_FUNC:
+    copy= new Item_func_equal(args[0], args[1]);
+    break;
+  case Item_func::NE_FUNC:
+    copy= new Item_func_ne(args[0], args[1]);
+    break;
+  case Item_func::LT_FUNC:
+    copy= new Item_func_lt(args[0], args[1]);
+    break;
+  case Item_func::LE_FUNC:
+    copy= new Item_func_le(args[0], args[1]);
+    break;
+  case Item_func::GT_FUNC:
+    copy= new Item_func_gt(args[0], args[1]);
+    break;
+  case Item_func::GE_FUNC:
+    copy= new Item_func_ge(args[0], args[1]);
+    break;
+  case Item_func::BETWEEN:
+  {
+    Item_func_between *const between=
+      new Item_func_between(args[0], args[1], args[2]);
+    if (between)
+      between->negated= static_cast<Item_func_between*>(func)->negated;
+    copy= between;
+    break;
+  }
+  case Item_func::IN_FUNC:
+  {
+    List<Item> list;
+    for (uint i= 0; i < arg_count; i++)
+      list.push_back(args[i]);
+    Item_func_in *const in= new Item_func_in(list);
+    if (in)
+      in->negated= static_cast<Item_func_in*>(func)->negated;
+    copy= in;
+    break;
+  }
+  default:
+    return NULL;
+  }
+  if (copy == NULL || copy->fix_fields(thd, &copy))
+    return NULL;
+  return copy;
+}
+
+
+/**
+  @brief
+  Push conditions of the WHERE clause of a query on a materialized
+  derived table down to the query of the derived table.
+
+  @param thd      thread handle
+  @param derived  The derived table, a table of the query
+  @param cond     The WHERE condition of the query
+
+  @details
+  The conjuncts of 'cond' that depend only on columns of the derived
+  table are copied to the WHERE clause of the derived table's query,
+  so that only the rows that the query can use are materialized. The
+  conjuncts are not removed from 'cond'.
+
+  Conditions are pushed only to a single query block without LIMIT or
+  ROLLUP and, if it is grouped, only if they are on grouping columns. The
+  derived table must not be an inner table of an outer join or of a
+  semi-join.
+
+  The pushed condition is added to the query before its first
+  optimization, in the statement mem_root, so it is kept for later
+  executions of a prepared statement.
+
+  @return FALSE ok.
+  @return TRUE if an error occur.
+*/
+
+bool mysql_derived_push_condition(THD *thd, TABLE_LIST *derived, Item *cond)
+{
+  SELECT_LEX_UNIT *unit= derived->get_unit();
+  DBUG_ENTER("mysql_derived_push_condition");
+
+  if (!derived->uses_materialization() || !derived->table ||
+      unit->is_union())
+    DBUG_RETURN(FALSE);
+
+  for (TABLE_LIST *tl= derived; tl; tl= tl->embedding)
+    if (tl->outer_join || tl->sj_on_expr)
+      DBUG_RETURN(FALSE);
+
+  SELECT_LEX *select= unit->first_select();
+  JOIN *join= select->join;
+  if (join == NULL || join->optimized || !select->first_cond_optimization ||
+      select->explicit_limit || select->olap != UNSPECIFIED_OLAP_TYPE ||
+      (select->with_sum_func && !select->group_list.elements))
+    DBUG_RETURN(FALSE);
+
+  Item *pushed= NULL;
+  SELECT_LEX *save_current_select= thd->lex->current_select();
+  thd->lex->set_current_select(select);
+  if (cond->type() == Item::COND_ITEM &&
+      static_cast<Item_cond*>(cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator<Item> li(*static_cast<Item_cond*>(cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+      pushed= and_conds(pushed, derived_copy_condition(thd, select, derived,
+                                                       item));
+  }
+  else
+    pushed= derived_copy_condition(thd, select, derived, cond);
+
+  bool res= thd->is_error();
+  if (pushed && !res)
+  {
+    Opt_trace_context *const trace= &thd->opt_trace;
+    Opt_trace_object trace_wrapper(trace);
+    Opt_trace_object(trace, "derived_condition_pushdown").
+      add_utf8_table(derived->table).add("pushed_condition", pushed);
+    Item *where= and_conds(join->conds, pushed);
+    res= where == NULL || (!where->fixed && where->fix_fields(thd, &where));
+    if (!res)
+      select->where= join->conds= where;
+  }
+  thd->lex->set_current_select(save_current_select);
+  DBUG_RETURN(res);
+}
+
+
 /**
   @brief
   Create result table for a materialized derived table/view.
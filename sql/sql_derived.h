@@ -17,6 +17,7 @@
 #define SQL_DERIVED_INCLUDED
 
 struct TABLE_LIST;
+class Item;
 class THD;
 struct LEX;
 
@@ -26,6 +27,7 @@ bool mysql_handle_single_derived(LEX *lex, TABLE_LIST *derived,
                                  bool (*processor)(THD*, LEX*, TABLE_LIST*));
 bool mysql_derived_prepare(THD *thd, LEX *lex, TABLE_LIST *t);
 bool mysql_derived_optimize(THD *thd, LEX *lex, TABLE_LIST *t);
+bool mysql_derived_push_condition(THD *thd, TABLE_LIST *derived, Item *cond);
 bool mysql_derived_create(THD *thd, LEX *lex, TABLE_LIST *t);
 bool mysql_derived_materialize(THD *thd, LEX *lex, TABLE_LIST *t);
 /**
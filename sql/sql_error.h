@@ -448,6 +448,10 @@ public:
   void inc_current_row_for_condition()
   { m_current_row_for_condition++; }
 
+  /** Advance the current row counter past rows that were skipped. */
+  void inc_current_row_for_condition(ulong rows)
+  { m_current_row_for_condition+= rows; }
+
   /** Reset the current row counter. Start counting from the first row. */
   void reset_current_row_for_condition()
   { m_current_row_for_condition= 1; }
@@ -37,6 +37,7 @@
 #include "filesort.h"
 #include "sql_tmp_table.h"
 #include "records.h"          // rr_sequential
+#include "sql_cond_kernel.h"  // Cond_kernel
 #include "opt_explain_format.h" // Explain_format_flags
 #include "debug_sync.h"
 
@@ -61,6 +62,8 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static void copy_sum_funcs(Item_sum **func_ptr, Item_sum **end_ptr);
 
 static int join_read_system(JOIN_TAB *tab);
@@ -189,6 +192,10 @@ JOIN::exec()
     DBUG_VOID_RETURN;
   }
 
+  /* A server side cursor may read the rows later, on demand. */
+  if (result->take_over_join(this))
+    DBUG_VOID_RETURN;
+
   THD_STAGE_INFO(thd, stage_sending_data);
   DBUG_PRINT("info", ("%s", thd->proc_info));
   result->send_result_set_metadata(*fields,
@@ -781,8 +788,17 @@ void setup_tmptable_write_func(JOIN_TAB *tab)
     */
     if (table->s->keys && !table->s->uniques)
     {
-      DBUG_PRINT("info",("Using end_update"));
-      op->set_write_func(end_update);
+      if (join->thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HASH_AGGREGATION) &&
+          !op->init_group_hash(join->thd))
+      {
+        DBUG_PRINT("info",("Using end_hash_update"));
+        op->set_write_func(end_hash_update);
+      }
+      else
+      {
+        DBUG_PRINT("info",("Using end_update"));
+        op->set_write_func(end_update);
+      }
     }
     else
     {
@@ -1242,11 +1258,30 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
 
   join->thd->get_stmt_da()->reset_current_row_for_condition();
 
+  const bool analyzing= join->analyzing;
+  if (analyzing)
+    join_tab->analyze_stats.loops++;
+
   enum_nested_loop_state rc= NESTED_LOOP_OK;
   bool in_first_read= true;
+  if (join->resume_nested_loop)
+  {
+    /*
+      A streaming cursor continues the join: the current row of this
+      table has been joined with the rows of the next tables up to the
+      last row sent, so continue with the next table, and read the next
+      row of this table only once that one is done.
+    */
+    in_first_read= false;
+    if (join_tab->next_select == sub_select)
+      rc= (*join_tab->next_select)(join, join_tab + 1, false);
+    else
+      join->resume_nested_loop= false;
+  }
   while (rc == NESTED_LOOP_OK && join->return_tab >= join_tab)
   {
     int error;
+    const ulonglong read_start= analyzing ? my_timer_nanoseconds() : 0;
     if (in_first_read)
     {
       in_first_read= false;
@@ -1255,6 +1290,24 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
     else
       error= info->read_record(info);
 
+    if (analyzing)
+    {
+      join_tab->analyze_stats.add_read(read_start, error == 0);
+      join_tab->analyze_stats.rows_read+= info->filtered_rows;
+    }
+
+    if (info->filtered_rows)
+    {
+      /*
+        Rows of a batched scan that did not satisfy the condition, see
+        join_init_read_record(). Count them like evaluate_join_record().
+      */
+      join->examined_rows+= info->filtered_rows;
+      join->thd->get_stmt_da()->
+        inc_current_row_for_condition((ulong) info->filtered_rows);
+      info->filtered_rows= 0;
+    }
+
     DBUG_EXECUTE_IF("bug13822652_1", join->thd->killed= THD::KILL_QUERY;);
 
     if (error > 0 || (join->thd->is_error()))   // Fatal error
@@ -1312,6 +1365,141 @@ bool JOIN_TAB::prepare_scan()
 }
 
 
+/**
+  @brief Get the kernel of the condition of the table.
+
+  @details The kernel is built the first time it is asked for the current
+  condition, on the statement's mem_root.
+
+  @returns the kernel, or NULL if the condition cannot be evaluated by a
+  kernel
+*/
+
+Cond_kernel *JOIN_TAB::get_cond_kernel()
+{
+  if (m_condition != cond_kernel_cond)
+  {
+    cond_kernel_cond= m_condition;
+    cond_kernel= m_condition ?
+      Cond_kernel::create(join->thd, m_condition, table) : NULL;
+  }
+  return cond_kernel;
+}
+
+
+/**
+  Prepare the in-memory hash set of rowid tuples of a duplicate weedout
+  table.
+
+  The hash set may use as much memory as tmp_table would before it is
+  converted to an on-disk table.
+
+  @return false if ok, true on out of memory
+*/
+
+bool SJ_TMP_TABLE::init_rowid_hash(THD *thd)
+{
+  const uint tuple_len= rowid_len + null_bytes;
+  const ulonglong mem_limit= min(thd->variables.tmp_table_size,
+                                 thd->variables.max_heap_table_size);
+  rowid_hash_max_records=
+    (ulong) min<ulonglong>(mem_limit / (ALIGN_SIZE(tuple_len) + HASH_OVERHEAD),
+                           UINT_MAX32);
+  init_sql_alloc(key_memory_sj_tmp_table_rowid_root, &rowid_root,
+                 ALLOC_ROOT_MIN_BLOCK_SIZE * 4, 0);
+  use_rowid_hash= true;
+  return my_hash_init(&rowid_hash, &my_charset_bin, 256, 0, tuple_len,
+                      NULL, NULL, 0);
+}
+
+
+/**
+  Empty the hash set of rowid tuples, and use it again instead of tmp_table
+*/
+
+void SJ_TMP_TABLE::reset_rowid_hash()
+{
+  if (!my_hash_inited(&rowid_hash))
+    return;
+  my_hash_reset(&rowid_hash);
+  free_root(&rowid_root, MYF(MY_MARK_BLOCKS_FREE));
+  use_rowid_hash= true;
+}
+
+
+void SJ_TMP_TABLE::free_rowid_hash()
+{
+  if (!my_hash_inited(&rowid_hash))
+    return;
+  my_hash_free(&rowid_hash);
+  my_hash_clear(&rowid_hash);
+  free_root(&rowid_root, MYF(0));
+  use_rowid_hash= false;
+}
+
+
+/**
+  Write the rowid tuple in the record of a duplicate weedout table to the
+  table, converting the table to an on-disk table if it is full.
+
+  @return -1 on error, 1 if the tuple is a duplicate, 0 otherwise
+*/
+
+static int sj_write_rowid_tuple(THD *thd, SJ_TMP_TABLE *sjtbl)
+{
+  int error= sjtbl->tmp_table->file->ha_write_row(sjtbl->tmp_table->record[0]);
+  if (error)
+  {
+    /* If this is a duplicate error, return immediately */
+    if (sjtbl->tmp_table->file->is_ignorable_error(error))
+      return 1;
+    /*
+      Other error than duplicate error: Attempt to create a temporary table.
+    */
+    bool is_duplicate;
+    if (create_myisam_from_heap(thd, sjtbl->tmp_table,
+                                sjtbl->start_recinfo, &sjtbl->recinfo,
+                                error, TRUE, &is_duplicate))
+      return -1;
+    return is_duplicate ? 1 : 0;
+  }
+  return 0;
+}
+
+
+/**
+  Move the tuples of the hash set of a duplicate weedout table to the
+  table, when the hash set is full.
+
+  @param sjtbl  The duplicate weedout table
+  @param tuple  Where the tuple is in the record of sjtbl->tmp_table. The
+                tuple there, which is not in the hash set, is left as is.
+
+  @return false if ok, true on error
+*/
+
+static bool sj_spill_rowid_hash(THD *thd, SJ_TMP_TABLE *sjtbl, uchar *tuple)
+{
+  const uint tuple_len= sjtbl->rowid_len + sjtbl->null_bytes;
+  uchar *const current= (uchar*) memdup_root(&sjtbl->rowid_root, tuple,
+                                             tuple_len);
+  if (current == NULL)
+    return true;
+
+  for (ulong i= 0; i < sjtbl->rowid_hash.records; i++)
+  {
+    memcpy(tuple, my_hash_element(&sjtbl->rowid_hash, i), tuple_len);
+    if (sj_write_rowid_tuple(thd, sjtbl) < 0)
+      return true;
+  }
+  memcpy(tuple, current, tuple_len);
+  my_hash_reset(&sjtbl->rowid_hash);
+  free_root(&sjtbl->rowid_root, MYF(MY_MARK_BLOCKS_FREE));
+  sjtbl->use_rowid_hash= false;
+  return false;
+}
+
+
 /**
   SemiJoinDuplicateElimination: Weed out duplicate row combinations
 
@@ -1325,6 +1513,9 @@ bool JOIN_TAB::prepare_scan()
     rowids) in the temporary table. This records the fact that we've seen 
     this record combination and also tells us if we've seen it before.
 
+    The record combinations are kept in the in-memory hash set
+    sjtbl->rowid_hash until it is full, then they are moved to the table.
+
   RETURN
     -1  Error
     1   The row combination is a duplicate (discard it)
@@ -1333,7 +1524,6 @@ bool JOIN_TAB::prepare_scan()
 
 int do_sj_dups_weedout(THD *thd, SJ_TMP_TABLE *sjtbl) 
 {
-  int error;
   SJ_TMP_TABLE::TAB *tab= sjtbl->tabs;
   SJ_TMP_TABLE::TAB *tab_end= sjtbl->tabs_end;
 
@@ -1389,23 +1579,24 @@ int do_sj_dups_weedout(THD *thd, SJ_TMP_TABLE *sjtbl)
     }
   }
 
-  error= sjtbl->tmp_table->file->ha_write_row(sjtbl->tmp_table->record[0]);
-  if (error)
+  if (sjtbl->use_rowid_hash)
   {
-    /* If this is a duplicate error, return immediately */
-    if (sjtbl->tmp_table->file->is_ignorable_error(error))
+    const uint tuple_len= sjtbl->rowid_len + sjtbl->null_bytes;
+    if (my_hash_search(&sjtbl->rowid_hash, nulls_ptr, tuple_len))
       DBUG_RETURN(1);
-    /*
-      Other error than duplicate error: Attempt to create a temporary table.
-    */
-    bool is_duplicate;
-    if (create_myisam_from_heap(thd, sjtbl->tmp_table,
-                                sjtbl->start_recinfo, &sjtbl->recinfo,
-                                error, TRUE, &is_duplicate))
+    if (sjtbl->rowid_hash.records < sjtbl->rowid_hash_max_records)
+    {
+      uchar *const tuple= (uchar*) memdup_root(&sjtbl->rowid_root, nulls_ptr,
+                                               tuple_len);
+      if (tuple == NULL || my_hash_insert(&sjtbl->rowid_hash, tuple))
+        DBUG_RETURN(-1);
+      DBUG_RETURN(0);
+    }
+    if (sj_spill_rowid_hash(thd, sjtbl, nulls_ptr))
       DBUG_RETURN(-1);
-    DBUG_RETURN(is_duplicate ? 1 : 0);
   }
-  DBUG_RETURN(0);
+
+  DBUG_RETURN(sj_write_rowid_tuple(thd, sjtbl));
 }
 
 
@@ -1418,7 +1609,10 @@ static int do_sj_reset(SJ_TMP_TABLE *sj_tbl)
   DBUG_ENTER("do_sj_reset");
   if (sj_tbl->tmp_table)
   {
-    int rc= sj_tbl->tmp_table->file->ha_delete_all_rows();
+    /* The table is empty as long as the hash set is used */
+    const bool table_is_empty= sj_tbl->use_rowid_hash;
+    sj_tbl->reset_rowid_hash();
+    int rc= table_is_empty ? 0 : sj_tbl->tmp_table->file->ha_delete_all_rows();
     DBUG_RETURN(rc);
   }
   sj_tbl->have_confluent_row= FALSE;
@@ -1453,9 +1647,17 @@ evaluate_join_record(JOIN *join, JOIN_TAB *join_tab)
               join, static_cast<int>(join_tab - join_tab->join->join_tab),
               join_tab->table->alias, condition));
 
-  if (condition)
+  /* The rows of a scan filtered with the kernel satisfy the condition */
+  if (condition && !join_tab->read_record.cond_kernel)
   {
-    found= test(condition->val_int());
+    if (join->analyzing)
+    {
+      const ulonglong cond_start= my_timer_nanoseconds();
+      found= test(condition->val_int());
+      join_tab->analyze_stats.cond_time+= my_timer_nanoseconds() - cond_start;
+    }
+    else
+      found= test(condition->val_int());
 
     if (join->thd->killed)
     {
@@ -1467,6 +1669,8 @@ evaluate_join_record(JOIN *join, JOIN_TAB *join_tab)
     if (join->thd->is_error())
       DBUG_RETURN(NESTED_LOOP_ERROR);
   }
+  if (found && join->analyzing)
+    join_tab->analyze_stats.rows_matched++;
   if (found)
   {
     /*
@@ -2391,10 +2595,26 @@ int join_init_read_record(JOIN_TAB *tab)
     report_handler_error(tab->table, error);
     return 1;
   }
+  /* Buffers of the previous scan of the table, if any */
+  free_read_record_buffers(&tab->read_record);
   if (init_read_record(&tab->read_record, tab->join->thd, tab->table,
                        tab->select, 1, 1, FALSE))
     return 1;
 
+  /*
+    Let a batched scan skip the rows that do not satisfy the condition.
+    Only sub_select() accounts for the skipped rows, so this is not done
+    for tables read by a join buffer or a temporary table operation. Rows
+    that a locking read skips would not be unlocked.
+  */
+  if (!tab->op && tab->condition() &&
+      tab->table->reginfo.lock_type <= TL_READ)
+  {
+    Cond_kernel *kernel= tab->get_cond_kernel();
+    if (kernel)
+      (void) set_read_record_filter(&tab->read_record, kernel);
+  }
+
   return (*tab->read_record.read_record)(&tab->read_record);
 }
 
@@ -3033,6 +3253,76 @@ end:
   DBUG_RETURN(NESTED_LOOP_OK);
 }
 
+/** Make the key of the group of the current row in the group buffer */
+
+static void make_group_key(TABLE *table)
+{
+  for (ORDER *group= table->group ; group ; group=group->next)
+  {
+    Item *item= *group->item;
+    item->save_org_in_field(group->field);
+    /* Store in the used key if the field was 0 */
+    if (item->maybe_null)
+      group->buff[-1]= (char) group->field->is_null();
+  }
+}
+
+
+/**
+  Copy null bits from group key to table
+  We can't copy all data as the key may have different format
+  as the row data (for example as with VARCHAR keys)
+*/
+
+static void copy_group_null_bits(TABLE *table)
+{
+  ORDER *group;
+  KEY_PART_INFO *key_part;
+  for (group=table->group,key_part=table->key_info[0].key_part;
+       group ;
+       group=group->next,key_part++)
+  {
+    if (key_part->null_bit)
+      memcpy(table->record[0]+key_part->offset, group->buff, 1);
+  }
+}
+
+
+/**
+  Write the record of a new group to the tmp table of end_update(),
+  converting it to an on-disk table if it is full.
+
+  @return false if OK, true on error
+*/
+
+static bool write_new_group(JOIN_TAB *join_tab)
+{
+  TABLE *const table= join_tab->table;
+  int error;
+  if ((error=table->file->ha_write_row(table->record[0])))
+  {
+    if (create_myisam_from_heap(join_tab->join->thd, table,
+                                join_tab->tmp_table_param->start_recinfo,
+                                &join_tab->tmp_table_param->recinfo,
+				error, FALSE, NULL))
+      return true;                              // Not a table_is_full error
+    /* Change method to update rows */
+    if ((error= table->file->ha_index_init(0, 0)))
+    {
+      table->file->print_error(error, MYF(0));
+      return true;
+    }
+    /*
+      InnoDB does not return the position of the duplicate row, so the
+      groups are still looked up by key.
+    */
+    if (table->s->db_type() != innodb_hton)
+      ((QEP_tmp_table*)join_tab->op)->set_write_func(end_unique_update);
+  }
+  return false;
+}
+
+
 /* ARGSUSED */
 /** Group by searching after group record and updating it if possible. */
 
@@ -3040,7 +3330,6 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
 {
   TABLE *const table= join_tab->table;
-  ORDER   *group;
   int	  error;
   DBUG_ENTER("end_update");
 
@@ -3055,14 +3344,7 @@ end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
   join->found_records++;
   copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
   /* Make a key of group index */
-  for (group=table->group ; group ; group=group->next)
-  {
-    Item *item= *group->item;
-    item->save_org_in_field(group->field);
-    /* Store in the used key if the field was 0 */
-    if (item->maybe_null)
-      group->buff[-1]= (char) group->field->is_null();
-  }
+  make_group_key(table);
   if (!table->file->ha_index_read_map(table->record[1],
                                       join_tab->tmp_table_param->group_buff,
                                       HA_WHOLE_KEY,
@@ -3079,37 +3361,108 @@ end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
     DBUG_RETURN(NESTED_LOOP_OK);
   }
 
-  /*
-    Copy null bits from group key to table
-    We can't copy all data as the key may have different format
-    as the row data (for example as with VARCHAR keys)
-  */
-  KEY_PART_INFO *key_part;
-  for (group=table->group,key_part=table->key_info[0].key_part;
-       group ;
-       group=group->next,key_part++)
-  {
-    if (key_part->null_bit)
-      memcpy(table->record[0]+key_part->offset, group->buff, 1);
-  }
+  copy_group_null_bits(table);
   init_tmptable_sum_functions(join->sum_funcs);
   if (copy_funcs(join_tab->tmp_table_param->items_to_copy, join->thd))
     DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
-  if ((error=table->file->ha_write_row(table->record[0])))
+  if (write_new_group(join_tab))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  join_tab->send_records++;
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
+/**
+  Write the groups of QEP_tmp_table::group_hash to the tmp table, and
+  empty the hash table.
+
+  @return false if OK, true on error
+*/
+
+static bool write_group_hash(JOIN_TAB *join_tab)
+{
+  QEP_tmp_table *const op= static_cast<QEP_tmp_table*>(join_tab->op);
+  TABLE *const table= join_tab->table;
+
+  for (ulong i= 0; i < op->group_hash.records; i++)
   {
-    if (create_myisam_from_heap(join->thd, table,
-                                join_tab->tmp_table_param->start_recinfo,
-                                &join_tab->tmp_table_param->recinfo,
-				error, FALSE, NULL))
-      DBUG_RETURN(NESTED_LOOP_ERROR);            // Not a table_is_full error
-    /* Change method to update rows */
-    if ((error= table->file->ha_index_init(0, 0)))
-    {
-      table->file->print_error(error, MYF(0));
+    const uchar *group= my_hash_element(&op->group_hash, i);
+    memcpy(table->record[0], group + op->group_key_length,
+           table->s->reclength);
+    if (write_new_group(join_tab))
+      return true;
+  }
+  op->reset_group_hash();
+  return false;
+}
+
+
+/**
+  Group by looking up the group in an in-memory hash table, where its
+  record is updated. The groups are written to the tmp table at the end.
+  If a new group does not fit in the memory budget, the groups are written
+  to the tmp table at once, and end_update() is used from then on.
+*/
+
+static enum_nested_loop_state
+end_hash_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
+{
+  TABLE *const table= join_tab->table;
+  QEP_tmp_table *const op= static_cast<QEP_tmp_table*>(join_tab->op);
+  const size_t reclength= table->s->reclength;
+  DBUG_ENTER("end_hash_update");
+
+  if (end_of_records)
+    DBUG_RETURN(write_group_hash(join_tab) ? NESTED_LOOP_ERROR :
+                                             NESTED_LOOP_OK);
+  if (join->thd->killed)			// Aborted by user
+  {
+    join->thd->send_kill_message();
+    DBUG_RETURN(NESTED_LOOP_KILLED);             /* purecov: inspected */
+  }
+
+  join->found_records++;
+  copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
+  make_group_key(table);
+  /* The key is hashed as bytes, so the value of a NULL must not matter */
+  for (ORDER *group= table->group; group; group= group->next)
+  {
+    if ((*group->item)->maybe_null && group->buff[-1])
+      memset(group->buff, 0, group->field->pack_length());
+  }
+
+  const uchar *const key= join_tab->tmp_table_param->group_buff;
+  uchar *group= my_hash_search(&op->group_hash, key, op->group_key_length);
+  if (group)
+  {						/* Update old group */
+    uchar *const record= group + op->group_key_length;
+    memcpy(table->record[0], record, reclength);
+    update_tmptable_sum_func(join->sum_funcs, table);
+    memcpy(record, table->record[0], reclength);
+    DBUG_RETURN(NESTED_LOOP_OK);
+  }
+
+  if (op->group_hash.records >= op->group_hash_max_records)
+  {
+    /* Continue with the groups in the tmp table */
+    op->set_write_func(end_update);
+    if (write_group_hash(join_tab))
       DBUG_RETURN(NESTED_LOOP_ERROR);
-    }
-    ((QEP_tmp_table*)join_tab->op)->set_write_func(end_unique_update);
+    join->found_records--;                      // Counted again
+    DBUG_RETURN(op->put_record());
   }
+
+  copy_group_null_bits(table);
+  init_tmptable_sum_functions(join->sum_funcs);
+  if (copy_funcs(join_tab->tmp_table_param->items_to_copy, join->thd))
+    DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+  if (!(group= (uchar*) alloc_root(&op->group_root,
+                                   op->group_key_length + reclength)))
+    DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+  memcpy(group, key, op->group_key_length);
+  memcpy(group + op->group_key_length, table->record[0], reclength);
+  if (my_hash_insert(&op->group_hash, group))
+    DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
   join_tab->send_records++;
   DBUG_RETURN(NESTED_LOOP_OK);
 }
@@ -3287,6 +3640,7 @@ create_sort_index(THD *thd, JOIN *join, JOIN_TAB *tab)
   ha_rows examined_rows;
   ha_rows found_rows;
   ha_rows filesort_retval= HA_POS_ERROR;
+  ulonglong merge_passes;
   TABLE *table;
   SQL_SELECT *select;
   Filesort *fsort= tab->filesort;
@@ -3322,8 +3676,20 @@ create_sort_index(THD *thd, JOIN *join, JOIN_TAB *tab)
 
   if (table->s->tmp_table)
     table->file->info(HA_STATUS_VARIABLE);	// Get record count
+  merge_passes= thd->status_var.filesort_merge_passes;
+  fsort->offset= join->can_skip_offset_in_sort(tab) ?
+                 join->unit->offset_limit_cnt : 0;
   filesort_retval= filesort(thd, table, fsort, tab->keep_current_rowid,
                             &examined_rows, &found_rows);
+  if (fsort->skipped)
+  {
+    /* The rows skipped by filesort are counted as sent, see end_send() */
+    join->unit->offset_limit_cnt-= fsort->skipped;
+    join->send_records+= fsort->skipped;
+  }
+  if (join->analyzing)
+    tab->analyze_stats.sort_merge_passes+=
+      thd->status_var.filesort_merge_passes - merge_passes;
   table->sort.found_records= filesort_retval;
   tab->records= found_rows;                     // For SQL_CALC_ROWS
   tab->join->examined_rows+=examined_rows;
@@ -3414,8 +3780,8 @@ JOIN_TAB::remove_duplicates()
 
   free_io_cache(table);				// Safety
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(reclength) + HASH_OVERHEAD) * table->file->stats.records <
 	join->thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table,
@@ -4251,6 +4617,12 @@ QEP_tmp_table::prepare_tmp_table()
     (void) table->file->extra(HA_EXTRA_WRITE_CACHE);
     empty_record(table);
   }
+  /* Groups are aggregated in memory again if they were already once */
+  if (use_group_hash)
+  {
+    reset_group_hash();
+    write_func= end_hash_update;
+  }
   /* If it wasn't already, start index scan for grouping using table index. */
   if (!table->file->inited && table->group &&
       join_tab->tmp_table_param->sum_func_count && table->s->keys)
@@ -4266,6 +4638,84 @@ QEP_tmp_table::prepare_tmp_table()
 }
 
 
+/**
+  Set up the hash table of end_hash_update().
+
+  @return false if OK, true if the groups can't be aggregated in a hash
+    table: their keys are not equal only when they are the same bytes, or
+    the record has BLOBs.
+*/
+
+bool QEP_tmp_table::init_group_hash(THD *thd)
+{
+  TABLE *const table= join_tab->table;
+
+  free_group_hash();
+  if (table->s->blob_fields)
+    return true;
+  group_key_length= 0;
+  for (ORDER *group= table->group; group; group= group->next)
+  {
+    switch (group->field->real_type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_YEAR:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_TIME2:
+    case MYSQL_TYPE_DATETIME2:
+    case MYSQL_TYPE_TIMESTAMP2:
+      break;
+    default:
+      return true;
+    }
+    group_key_length+= test((*group->item)->maybe_null) +
+                       group->field->pack_length();
+  }
+
+  const ulonglong mem_limit= min(thd->variables.tmp_table_size,
+                                 thd->variables.max_heap_table_size);
+  const size_t group_length= group_key_length + table->s->reclength;
+  group_hash_max_records=
+    (ulong) min<ulonglong>(mem_limit / (ALIGN_SIZE(group_length) +
+                                        HASH_OVERHEAD),
+                           UINT_MAX32);
+  init_sql_alloc(key_memory_QEP_tmp_table_group_root, &group_root,
+                 ALLOC_ROOT_MIN_BLOCK_SIZE * 4, 0);
+  if (my_hash_init(&group_hash, &my_charset_bin, 256, 0, group_key_length,
+                   NULL, NULL, 0))
+  {
+    free_root(&group_root, MYF(0));
+    return true;
+  }
+  use_group_hash= true;
+  return false;
+}
+
+
+void QEP_tmp_table::reset_group_hash()
+{
+  if (!my_hash_inited(&group_hash))
+    return;
+  my_hash_reset(&group_hash);
+  free_root(&group_root, MYF(MY_MARK_BLOCKS_FREE));
+}
+
+
+void QEP_tmp_table::free_group_hash()
+{
+  if (!my_hash_inited(&group_hash))
+    return;
+  my_hash_free(&group_hash);
+  my_hash_clear(&group_hash);
+  free_root(&group_root, MYF(0));
+  use_group_hash= false;
+}
+
+
 /**
   @brief Prepare table if necessary and call write_func to save record
 
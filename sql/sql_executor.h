@@ -19,6 +19,7 @@
 /** @file Classes for query execution */
 
 #include "records.h"                          /* READ_RECORD */
+#include "hash.h"                             /* HASH */
 
 class JOIN;
 typedef struct st_join_table JOIN_TAB;
@@ -78,6 +79,8 @@ typedef enum_nested_loop_state
 class SJ_TMP_TABLE : public Sql_alloc
 {
 public:
+  SJ_TMP_TABLE() : use_rowid_hash(false) { my_hash_clear(&rowid_hash); }
+
   /*
     Array of pointers to tables whose rowids compose the temporary table
     record.
@@ -123,6 +126,21 @@ public:
   MI_COLUMNDEF *start_recinfo;
   MI_COLUMNDEF *recinfo;
 
+  /*
+    In-memory hash set of the rowid tuples (null bytes and rowids) seen
+    since the last reset. Until it has rowid_hash_max_records tuples, the
+    tuples are looked up and stored there and tmp_table stays empty. Then
+    they are all written to tmp_table, which is used until the next reset.
+  */
+  HASH rowid_hash;
+  MEM_ROOT rowid_root;                   ///< the tuples of rowid_hash
+  ulong rowid_hash_max_records;
+  bool use_rowid_hash;                   ///< tuples are kept in rowid_hash
+
+  bool init_rowid_hash(THD *thd);
+  void reset_rowid_hash();
+  void free_rowid_hash();
+
   /* Pointer to next table (next->start_idx > this->end_idx) */
   SJ_TMP_TABLE *next; 
 };
@@ -225,6 +243,9 @@ public:
                          table. Input records aren't expected to be sorted.
                          Tmp table uses the heap engine
       end_update_unique  Same as above, but the engine is myisam.
+      end_hash_update    Like end_update, but the groups are first
+                         aggregated in group_hash, and written to the tmp
+                         table at the end, or when they don't fit in memory.
 
     Lazy table initialization is used - the table will be instantiated and
     rnd/index scan started on the first put_record() call.
@@ -235,10 +256,11 @@ class QEP_tmp_table :public QEP_operation
 {
 public:
   QEP_tmp_table(JOIN_TAB *tab) : QEP_operation(tab),
-    write_func(NULL)
-  {};
+    use_group_hash(false), write_func(NULL)
+  { my_hash_clear(&group_hash); };
   enum_op_type type() { return OT_TMP_TABLE; }
   enum_nested_loop_state put_record() { return put_record(false); };
+  void free() { free_group_hash(); }
   /*
     Send the result of operation further (to a next operation/client)
     This function is called after all records were put into the buffer
@@ -253,6 +275,21 @@ public:
     write_func= new_write_func;
   }
 
+  bool init_group_hash(THD *thd);
+  void reset_group_hash();
+  void free_group_hash();
+
+  /**
+    Groups aggregated by end_hash_update(). Each element is the group key,
+    as made in tmp_table_param->group_buff, followed by the record of the
+    group in the tmp table.
+  */
+  HASH group_hash;
+  MEM_ROOT group_root;
+  uint group_key_length;
+  ulong group_hash_max_records;   ///< Groups that fit in the memory budget
+  bool use_group_hash;
+
 private:
   /** Write function that would be used for saving records in tmp table. */
   Next_select_func write_func;
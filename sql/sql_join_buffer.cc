@@ -1834,7 +1834,6 @@ finish:
 
 enum_nested_loop_state JOIN_CACHE_BNL::join_matching_records(bool skip_last)
 {
-  uint cnt;
   int error;
   READ_RECORD *info;
   enum_nested_loop_state rc= NESTED_LOOP_OK;
@@ -1855,12 +1854,26 @@ enum_nested_loop_state JOIN_CACHE_BNL::join_matching_records(bool skip_last)
   if (skip_last)     
     put_record_in_cache();     
  
+  if (prepare_join_buffer(records - test(skip_last)))
+    return NESTED_LOOP_ERROR;
+
   if (join_tab->use_quick == QS_DYNAMIC_RANGE && join_tab->select->quick)
     /* A dynamic range access was used last. Clean up after it */
     join_tab->select->set_quick(NULL);
 
+  const bool analyzing= join->analyzing;
+  ulonglong start= 0;
+  if (analyzing)
+  {
+    join_tab->analyze_stats.loops++;
+    start= my_timer_nanoseconds();
+  }
+
   /* Start retrieving all records of the joined table */
-  if ((error= (*join_tab->read_first_record)(join_tab))) 
+  error= (*join_tab->read_first_record)(join_tab);
+  if (analyzing)
+    join_tab->analyze_stats.add_read(start, error == 0);
+  if (error)
     return error < 0 ? NESTED_LOOP_OK : NESTED_LOOP_ERROR;
 
   info= &join_tab->read_record;
@@ -1883,37 +1896,423 @@ enum_nested_loop_state JOIN_CACHE_BNL::join_matching_records(bool skip_last)
     if (rc == NESTED_LOOP_OK)
     {
       bool skip_record;
+      if (analyzing && select)
+        start= my_timer_nanoseconds();
       bool consider_record= (!select || 
                              (!select->skip_record(join->thd, &skip_record) &&
                               !skip_record));
+      if (analyzing && select)
+        join_tab->analyze_stats.cond_time+= my_timer_nanoseconds() - start;
       if (select && join->thd->is_error())
         return NESTED_LOOP_ERROR;
       if (consider_record)
       {
-        /* Prepare to read records from the join buffer */
-        reset_cache(false);
-
-        /* Read each record from the join buffer and look for matches */
-        for (cnt= records - test(skip_last) ; cnt; cnt--)
-        { 
-          /* 
-            If only the first match is needed and it has been already found for
-            the next record read from the join buffer then the record is skipped.
-          */
-          if (!check_only_first_match || !skip_record_if_match())
+        rc= match_join_buffer(records - test(skip_last));
+        if (rc != NESTED_LOOP_OK)
+          return rc;
+      }
+    }
+    if (analyzing)
+      start= my_timer_nanoseconds();
+    error= info->read_record(info);
+    if (analyzing)
+      join_tab->analyze_stats.add_read(start, error == 0);
+  } while (!error);
+
+  if (error > 0)				// Fatal error
+    rc= NESTED_LOOP_ERROR; 
+  return rc;
+}
+
+
+/*
+  Find matches for the current row of the joined table in the join buffer
+
+  SYNOPSIS
+    match_join_buffer()
+      n_records    the number of the records from the join buffer to check
+
+  DESCRIPTION
+    The function reads the first n_records records from the join buffer
+    one after another and generates all full extensions for those of them
+    that match the current row of join_tab.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNL::match_join_buffer(uint n_records)
+{
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+
+  /* Prepare to read records from the join buffer */
+  reset_cache(false);
+
+  /* Read each record from the join buffer and look for matches */
+  for (uint cnt= n_records; cnt; cnt--)
+  { 
+    /* 
+      If only the first match is needed and it has been already found for
+      the next record read from the join buffer then the record is skipped.
+    */
+    if (!check_only_first_match || !skip_record_if_match())
+    {
+      get_record();
+      rc= generate_full_extensions(get_curr_rec());
+      if (rc != NESTED_LOOP_OK)
+        return rc;
+    }
+  }
+  return rc;
+}
+
+
+/*
+  Check whether an equality can be used to build hash keys for a table
+
+  SYNOPSIS
+    get_hash_key_part()
+      item          a conjunct of the condition pushed to 'tab'
+      tab           the table joined through a hash join cache
+      build_item    OUT: the side of the equality to be evaluated over the
+                    buffered records
+      probe_item    OUT: the side of the equality to be evaluated over the
+                    rows of 'tab'
+      collation     OUT: the collation to hash the string values with, NULL
+                    if the values are compared as integers
+
+  DESCRIPTION
+    The function accepts an equality f(tab)=g(T1,...,Tn) where T1,...,Tn
+    precede 'tab' in the join order and whose arguments are compared as
+    integers or as strings. In these cases equal values always have equal
+    hash values, computed from the integer value or with the hash function
+    of the comparison collation. The equality itself is still evaluated for
+    each candidate match.
+
+  RETURN
+    TRUE   the equality can be used
+    FALSE  otherwise
+*/
+
+static bool get_hash_key_part(Item *item, JOIN_TAB *tab,
+                              Item **build_item, Item **probe_item,
+                              const CHARSET_INFO **collation)
+{
+  if (item->type() != Item::FUNC_ITEM ||
+      ((Item_func *) item)->functype() != Item_func::EQ_FUNC)
+    return FALSE;
+
+  Item_func_eq *const eq= (Item_func_eq *) item;
+  const Arg_comparator *const cmp= eq->get_comparator();
+  if (!cmp->compares_as_int() && !cmp->compares_as_string())
+    return FALSE;
+
+  const table_map inner_map= tab->table->map;
+  const table_map const_map= tab->join->const_table_map | OUTER_REF_TABLE_BIT;
+  Item **const args= eq->arguments();
+  for (uint i= 0; i < 2; i++)
+  {
+    Item *const probe= args[i];
+    Item *const build= args[1 - i];
+    const table_map probe_used= probe->used_tables();
+    const table_map build_used= build->used_tables();
+    if (!(probe_used & inner_map) ||
+        (probe_used & ~(inner_map | const_map)) ||
+        !(build_used & ~const_map) ||
+        (build_used & (inner_map | RAND_TABLE_BIT)) ||
+        probe->has_subquery() || build->has_subquery() ||
+        probe->has_stored_program() || build->has_stored_program())
+      continue;
+
+    *build_item= build;
+    *probe_item= probe;
+    *collation= cmp->compares_as_int() ? NULL : eq->compare_collation();
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/*
+  Collect the equalities of the condition of a table usable for hash keys
+
+  SYNOPSIS
+    collect_hash_key_parts()
+      tab           the table joined through a hash join cache
+      build_items   OUT: the buffered sides of the equalities, or NULL
+      probe_items   OUT: the sides of the equalities over 'tab', or NULL
+      collations    OUT: the collations for hashing the key parts, or NULL
+
+  DESCRIPTION
+    The function looks through the conjuncts of the condition pushed to
+    'tab'. For an inner table of an outer join it also looks into the
+    conjuncts guarded by the trigger that is switched off only while the
+    null complements for the table are generated: these are always on when
+    the rows of the table are matched with the records of the join buffer.
+
+  RETURN
+    the number of the equalities found
+*/
+
+static uint collect_hash_key_parts(JOIN_TAB *tab, Item **build_items,
+                                   Item **probe_items,
+                                   const CHARSET_INFO **collations)
+{
+  Item *cond= tab->condition();
+  if (cond == NULL)
+    return 0;
+
+  List<Item> single;
+  List<Item> *conjuncts= &single;
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond *) cond)->functype() == Item_func::COND_AND_FUNC)
+    conjuncts= ((Item_cond *) cond)->argument_list();
+  else
+    single.push_back(cond);
+
+  uint count= 0;
+  List_iterator<Item> it(*conjuncts);
+  Item *item;
+  while ((item= it++))
+  {
+    if (item->type() == Item::FUNC_ITEM &&
+        ((Item_func *) item)->functype() == Item_func::TRIG_COND_FUNC)
+    {
+      Item_func_trig_cond *const trig= (Item_func_trig_cond *) item;
+      if (trig->get_trig_var() != &tab->not_null_compl)
+        continue;
+      item= trig->arguments()[0];
+    }
+
+    Item *build, *probe;
+    const CHARSET_INFO *collation;
+    if (item->type() == Item::COND_ITEM &&
+        ((Item_cond *) item)->functype() == Item_func::COND_AND_FUNC)
+    {
+      /* The conjuncts of a guarded condition */
+      List_iterator<Item> guarded_it(*((Item_cond *) item)->argument_list());
+      Item *guarded;
+      while ((guarded= guarded_it++))
+      {
+        if (get_hash_key_part(guarded, tab, &build, &probe, &collation))
+        {
+          if (build_items)
           {
-            get_record();
-            rc= generate_full_extensions(get_curr_rec());
-            if (rc != NESTED_LOOP_OK)
-              return rc;
+            build_items[count]= build;
+            probe_items[count]= probe;
+            collations[count]= collation;
           }
+          count++;
         }
       }
     }
-  } while (!(error= info->read_record(info)));
+    else if (get_hash_key_part(item, tab, &build, &probe, &collation))
+    {
+      if (build_items)
+      {
+        build_items[count]= build;
+        probe_items[count]= probe;
+        collations[count]= collation;
+      }
+      count++;
+    }
+  }
+  return count;
+}
 
-  if (error > 0)				// Fatal error
-    rc= NESTED_LOOP_ERROR; 
+
+uint JOIN_CACHE_HASH::hash_key_count(JOIN_TAB *tab)
+{
+  return collect_hash_key_parts(tab, NULL, NULL, NULL);
+}
+
+
+/* 
+  Initialize a hash join cache
+
+  SYNOPSIS
+    init()
+
+  DESCRIPTION
+    The function collects the equalities used to build the hash keys and
+    then initializes the cache as a BNL cache. The hash table itself is
+    built in the join buffer every time the buffer has been filled.
+
+  RETURN
+    0   initialization with buffer allocations has been succeeded
+    1   otherwise
+*/
+
+int JOIN_CACHE_HASH::init()
+{
+  DBUG_ENTER("JOIN_CACHE_HASH::init");
+
+  key_parts= collect_hash_key_parts(join_tab, NULL, NULL, NULL);
+  DBUG_ASSERT(key_parts > 0);
+
+  build_items= (Item **) sql_alloc(2 * key_parts * sizeof(Item *));
+  key_collations=
+    (const CHARSET_INFO **) sql_alloc(key_parts * sizeof(CHARSET_INFO *));
+  if (build_items == NULL || key_collations == NULL)
+    DBUG_RETURN(1);
+  probe_items= build_items + key_parts;
+  collect_hash_key_parts(join_tab, build_items, probe_items, key_collations);
+
+  DBUG_RETURN(JOIN_CACHE_BNL::init());
+}
+
+
+/*
+  Calculate the hash value of a key
+
+  SYNOPSIS
+    calc_hash()
+      items    the items whose values make up the key
+      hash     OUT: the hash value
+
+  DESCRIPTION
+    Integer key parts are hashed as their 8 byte values, string key parts
+    with the hash function of the collation they are compared with.
+
+  RETURN
+    TRUE   a key part is NULL, the key matches no key
+    FALSE  otherwise
+*/
+
+bool JOIN_CACHE_HASH::calc_hash(Item **items, ulong *hash)
+{
+  ulong nr1= 1, nr2= 4;
+  for (uint i= 0; i < key_parts; i++)
+  {
+    Item *const item= items[i];
+    const CHARSET_INFO *const cs= key_collations[i];
+    if (cs == NULL)
+    {
+      uchar value[8];
+      int8store(value, item->val_int());
+      if (item->null_value)
+        return TRUE;
+      my_charset_bin.coll->hash_sort(&my_charset_bin, value, sizeof(value),
+                                     &nr1, &nr2);
+    }
+    else
+    {
+      const String *const str= item->val_str(&key_buff);
+      if (item->null_value)
+        return TRUE;
+      cs->coll->hash_sort(cs, (const uchar *) str->ptr(), str->length(),
+                          &nr1, &nr2);
+    }
+  }
+  *hash= nr1;
+  return FALSE;
+}
+
+
+/*
+  Build the hash table for the records in the join buffer
+
+  SYNOPSIS
+    prepare_join_buffer()
+      n_records    the number of the records from the join buffer to be
+                   matched
+
+  DESCRIPTION
+    The function reads the records from the join buffer one after another,
+    calculates the hash values of their keys and links the records into the
+    chains of the hash buckets. The records are linked in the reverse order
+    to the beginning of the chains, so each chain follows the order of the
+    records in the buffer.
+
+  RETURN
+    TRUE   an error occurred when the keys were evaluated
+    FALSE  otherwise
+*/
+
+bool JOIN_CACHE_HASH::prepare_join_buffer(uint n_records)
+{
+  uint n_buckets= 1;
+  while (n_buckets < n_records)
+    n_buckets<<= 1;
+  hash_mask= n_buckets - 1;
+
+  ulong entries_ofs= buff_size - n_records * sizeof(Hash_entry);
+  entries_ofs&= ~((ulong) sizeof(double) - 1);
+  hash_entries= (Hash_entry *) (buff + entries_ofs);
+  hash_buckets= (uint *) (buff + entries_ofs) - n_buckets;
+  DBUG_ASSERT((uchar *) hash_buckets >= end_pos);
+  memset(hash_buckets, 0, n_buckets * sizeof(uint));
+
+  THD *const thd= join->thd;
+  reset_cache(false);
+  for (uint i= 0; i < n_records; i++)
+  {
+    Hash_entry *const entry= hash_entries + i;
+    get_record();
+    entry->rec_ptr= get_curr_rec();
+    if (calc_hash(build_items, &entry->hash))
+      entry->rec_ptr= NULL;
+    if (thd->is_error())
+      return TRUE;
+  }
+
+  for (uint i= n_records; i-- > 0; )
+  {
+    Hash_entry *const entry= hash_entries + i;
+    if (entry->rec_ptr == NULL)
+      continue;
+    uint *const bucket= hash_buckets + (entry->hash & hash_mask);
+    entry->next= *bucket;
+    *bucket= i + 1;
+  }
+  return FALSE;
+}
+
+
+/*
+  Find matches for the current row of the joined table through the hash table
+
+  SYNOPSIS
+    match_join_buffer()
+      n_records    the number of the records from the join buffer to check
+
+  DESCRIPTION
+    The function calculates the hash value of the key of the current row of
+    join_tab and generates all full extensions for the records of the
+    corresponding hash chain that match the row.
+
+  RETURN
+    return one of enum_nested_loop_state.
+*/
+
+enum_nested_loop_state JOIN_CACHE_HASH::match_join_buffer(uint n_records)
+{
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  ulong hash;
+
+  if (calc_hash(probe_items, &hash))
+    return join->thd->is_error() ? NESTED_LOOP_ERROR : NESTED_LOOP_OK;
+  if (join->thd->is_error())
+    return NESTED_LOOP_ERROR;
+
+  for (uint i= hash_buckets[hash & hash_mask]; i; i= hash_entries[i - 1].next)
+  {
+    DBUG_ASSERT(i <= n_records);
+    Hash_entry *const entry= hash_entries + i - 1;
+    if (entry->hash != hash)
+      continue;
+    /* 
+      If only the first match is needed and it has been already found for
+      the record then the record is skipped. The match flag is the first
+      field of the record.
+    */
+    if (check_only_first_match && entry->rec_ptr[0])
+      continue;
+    get_record_by_pos(entry->rec_ptr);
+    rc= generate_full_extensions(entry->rec_ptr);
+    if (rc != NESTED_LOOP_OK)
+      return rc;
+  }
   return rc;
 }
 
@@ -2001,7 +2400,19 @@ enum_nested_loop_state JOIN_CACHE::generate_full_extensions(uchar *rec_ptr)
     Check whether the extended partial join record meets
     the pushdown conditions. 
   */
-  if (check_match(rec_ptr))
+  bool match;
+  if (join->analyzing)
+  {
+    const ulonglong start= my_timer_nanoseconds();
+    match= check_match(rec_ptr);
+    join_tab->analyze_stats.cond_time+= my_timer_nanoseconds() - start;
+    if (match)
+      join_tab->analyze_stats.rows_matched++;
+  }
+  else
+    match= check_match(rec_ptr);
+
+  if (match)
   {    
     int res= 0;
     if (!join_tab->check_weed_out_table || 
@@ -2353,6 +2764,8 @@ enum_nested_loop_state JOIN_CACHE_BKA::join_matching_records(bool skip_last)
 
   if (init_join_matching_records(&seq_funcs, records))
     return NESTED_LOOP_ERROR;
+  if (join->analyzing)
+    join_tab->analyze_stats.loops++;
 
   int error;
   handler *file= join_tab->table->file;
@@ -2361,6 +2774,8 @@ enum_nested_loop_state JOIN_CACHE_BKA::join_matching_records(bool skip_last)
 
   while (!(error= file->multi_range_read_next((char **) &rec_ptr)))
   {
+    if (join->analyzing)
+      join_tab->analyze_stats.rows_read++;
     if (join->thd->killed)
     {
       /* The user has aborted the execution of the query */
@@ -3256,6 +3671,8 @@ JOIN_CACHE_BKA_UNIQUE::join_matching_records(bool skip_last)
 
   if (init_join_matching_records(&seq_funcs, key_entries))
     return NESTED_LOOP_ERROR;
+  if (join->analyzing)
+    join_tab->analyze_stats.loops++;
 
   int error;
   uchar *key_chain_ptr;
@@ -3264,6 +3681,8 @@ JOIN_CACHE_BKA_UNIQUE::join_matching_records(bool skip_last)
 
   while (!(error= file->multi_range_read_next((char **) &key_chain_ptr)))
   {
+    if (join->analyzing)
+      join_tab->analyze_stats.rows_read++;
     if (no_association)
     {
       uchar *key_ref_ptr;
@@ -470,11 +470,12 @@ public:
   }
 
   /** Bits describing cache's type @sa setup_join_buffering() */
-  enum {ALG_NONE= 0, ALG_BNL= 1, ALG_BKA= 2, ALG_BKA_UNIQUE= 4};
+  enum {ALG_NONE= 0, ALG_BNL= 1, ALG_BKA= 2, ALG_BKA_UNIQUE= 4, ALG_HASH= 8};
 
   friend class JOIN_CACHE_BNL;
   friend class JOIN_CACHE_BKA;
   friend class JOIN_CACHE_BKA_UNIQUE;
+  friend class JOIN_CACHE_HASH;
 };
 
 class JOIN_CACHE_BNL :public JOIN_CACHE
@@ -485,6 +486,18 @@ protected:
   /* Using BNL find matches from the next table for records from join buffer */
   enum_nested_loop_state join_matching_records(bool skip_last);
 
+  /*
+    Prepare the first n_records records of the join buffer for matching
+    before the next table is scanned. Returns TRUE on error.
+  */
+  virtual bool prepare_join_buffer(uint n_records) { return FALSE; }
+
+  /*
+    Look for matches for the current row of the next table among the
+    first n_records records of the join buffer
+  */
+  virtual enum_nested_loop_state match_join_buffer(uint n_records);
+
 public:
 
   /* 
@@ -520,6 +533,125 @@ public:
 
 };
 
+/*
+  The class JOIN_CACHE_HASH supports the variant of the BNL join algorithm
+  that is used when the condition pushed to join_tab contains equalities
+  between an expression over join_tab and an expression over the tables
+  whose records are stored in the join buffer (or in the buffers of the
+  previous caches linked to it). Before the rows of join_tab are scanned,
+  a hash table is built on the values of the buffered sides of these
+  equalities. Each row of join_tab is then checked only against the
+  buffered records with the same hash value instead of against all of them,
+  so a scan costs O(rows of join_tab + matches) rather than
+  O(rows of join_tab * buffered records).
+  The records of a hash chain are linked in the order in which they were
+  put into the join buffer, hence the join produces the rows in the same
+  order as JOIN_CACHE_BNL does. Buffered records with a NULL value on the
+  buffered side of an equality are not put into the hash table: they can
+  only be extended by null complements.
+  The hash table is placed at the very end of the join buffer: the array of
+  hash entries, one per record, goes last, and the array of the hash
+  buckets precedes it. Space for it is reserved when the records are
+  written into the buffer (see rem_space()), so the buffer is refilled
+  earlier than a BNL buffer of the same size. When join_buffer_size is
+  exceeded the next table is scanned once per buffer refill, as with BNL.
+*/
+
+class JOIN_CACHE_HASH :public JOIN_CACHE_BNL
+{
+private:
+
+  /* An entry of the hash table, one per record in the join buffer */
+  struct Hash_entry
+  {
+    /* Position of the record fields in the join buffer, NULL for NULL keys */
+    uchar *rec_ptr;
+    /* Hash value of the key of the record */
+    ulong hash;
+    /* Number of the next entry with the same bucket plus 1, 0 if none */
+    uint next;
+  };
+
+  /* The number of the equalities used to build the hash keys */
+  uint key_parts;
+  /* The sides of the equalities evaluated over the buffered records */
+  Item **build_items;
+  /* The sides of the equalities evaluated over the rows of join_tab */
+  Item **probe_items;
+  /* Collations for hashing string key parts, NULL for integer key parts */
+  const CHARSET_INFO **key_collations;
+
+  /* The array of hash entries, built by prepare_join_buffer() */
+  Hash_entry *hash_entries;
+  /* The array of the hash buckets, each is a number of an entry plus 1 */
+  uint *hash_buckets;
+  /* The number of hash buckets minus 1, the number is a power of 2 */
+  uint hash_mask;
+
+  /* Buffer for the values of string key parts */
+  String key_buff;
+
+  /* Calculate the hash value of the key built from 'items' */
+  bool calc_hash(Item **items, ulong *hash);
+
+protected:
+
+  /* Space the hash table needs in the join buffer for 'n_records' records */
+  static ulong hash_area_size(ulong n_records)
+  {
+    return n_records * (sizeof(Hash_entry) + 2 * sizeof(uint)) +
+           sizeof(double);
+  }
+
+  /* The buffer must fit at least one record together with its hash entry */
+  uint aux_buffer_min_size() const { return hash_area_size(2); }
+
+  /*
+    Calculate how much space in the buffer would not be occupied by records
+    and by the hash table for them and for one more record.
+  */
+  ulong rem_space()
+  {
+    const ulong used= (end_pos - buff) + hash_area_size(records + 1);
+    return used < buff_size ? buff_size - used : 0;
+  }
+
+  /* Build the hash table for the records in the join buffer */
+  bool prepare_join_buffer(uint n_records);
+
+  /* Find matches for the current row of join_tab through the hash table */
+  enum_nested_loop_state match_join_buffer(uint n_records);
+
+public:
+
+  /*
+    This constructor creates a hash join cache, linked to 'prev' if it is
+    not NULL. The cache is to be used to join table 'tab' to the result of
+    joining the previous tables specified by the 'j' parameter.
+  */
+  JOIN_CACHE_HASH(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev)
+    :JOIN_CACHE_BNL(j, tab, prev), key_parts(0), build_items(NULL),
+     probe_items(NULL), key_collations(NULL), hash_entries(NULL),
+     hash_buckets(NULL), hash_mask(0)
+  {}
+
+  /* Initialize the hash join cache */
+  int init();
+
+  /*
+    Get the number of the equalities of the condition of 'tab' that can be
+    used to build hash keys. A hash join cache can be used for the table only
+    if the number is not 0.
+  */
+  static uint hash_key_count(JOIN_TAB *tab);
+
+  /* The growth of the space a record takes in the buffer (for costing) */
+  static uint record_overhead()
+  {
+    return sizeof(Hash_entry) + 2 * sizeof(uint);
+  }
+};
+
 class JOIN_CACHE_BKA :public JOIN_CACHE
 {
 protected:
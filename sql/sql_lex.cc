@@ -507,7 +507,7 @@ st_select_lex *LEX::new_empty_query_block()
     new (thd->mem_root) st_select_lex(NULL, NULL, NULL, NULL, NULL, NULL, 0);
   if (select == NULL)
     return NULL;             /* purecov: inspected */
-  if (describe)
+  if (is_explain_without_execution())
   select_lex->options|= SELECT_DESCRIBE;
 
   select->parent_lex= this;
@@ -1988,6 +1988,7 @@ st_select_lex_unit::st_select_lex_unit(enum_parsing_context parsing_context) :
   result_table_list(),
   union_result(NULL),
   table(NULL),
+  union_streamed(false),
   result(NULL),
   found_rows_for_union(0),
   saved_error(false),
@@ -2077,6 +2078,7 @@ st_select_lex::st_select_lex
   join_list(&top_join_list),
   embedding(NULL),
   sj_nests(),
+  saved_join_order(NULL),
   leaf_tables(NULL),
   order_list(),
   order_list_ptrs(NULL),
@@ -49,6 +49,7 @@ class sys_var;
 class Item_func_match;
 class File_parser;
 class Key_part_spec;
+struct Saved_join_order;
 
 #ifdef MYSQL_SERVER
 /*
@@ -182,6 +183,8 @@ typedef struct YYLTYPE
   additional "partitions" column even if partitioning is not compiled in.
 */
 #define DESCRIBE_PARTITIONS	4
+/* EXPLAIN ANALYZE: execute the query and show what was measured */
+#define DESCRIBE_ANALYZE	8
 
 #ifdef MYSQL_SERVER
 
@@ -538,6 +541,11 @@ protected:
   TABLE_LIST result_table_list;
   select_union *union_result;
   TABLE *table; /* temporary table using for appending UNION results */
+  /**
+    TRUE <=> the query blocks send their rows straight to 'result' through
+    a select_union_direct, and 'table' stays empty
+  */
+  bool union_streamed;
 
   select_result *result;
   ulonglong found_rows_for_union;
@@ -612,6 +620,7 @@ public:
   st_select_lex_unit* next_unit() const { return next; }
 
   select_result *get_result() const { return result; }
+  bool is_union_streamed() const { return union_streamed; }
   inline void set_result(select_result *res) { result= res; }
 
   /* UNION methods */
@@ -779,6 +788,8 @@ public:
   TABLE_LIST *embedding;          /* table embedding to the above list   */
   /// List of semi-join nests generated for this query block
   List<TABLE_LIST> sj_nests;
+  /// Join order kept across executions of the statement, or NULL
+  Saved_join_order *saved_join_order;
   //Dynamic_array<TABLE_LIST*> sj_nests; psergey-5:
   /*
     Beginning of the list of leaves in a FROM clause, where the leaves
@@ -2665,6 +2676,15 @@ public:
   /// Create query expression and query block in existing memory objects.
   void new_static_query(SELECT_LEX_UNIT *sel_unit, SELECT_LEX *select);
 
+  /**
+    @returns true for EXPLAIN of a query that is not executed, that is
+    for all EXPLAIN but EXPLAIN ANALYZE
+  */
+  bool is_explain_without_execution() const
+  {
+    return describe && !(describe & DESCRIBE_ANALYZE);
+  }
+
   inline bool is_ps_or_view_context_analysis()
   {
     return (context_analysis_only &
@@ -70,6 +70,12 @@ class READ_INFO {
   uint	field_term_length,line_term_length,enclosed_length;
   int	field_term_char,line_term_char,enclosed_char,escape_char;
   int	*stack,*stack_pos;
+  /*
+    CHAR_STOP_PLAIN and CHAR_STOP_ENCLOSED flags of the bytes that
+    read_field() must look at one by one, in fields that are not
+    enclosed and in enclosed fields
+  */
+  uchar char_class[256];
   bool	found_end_of_line,start_of_line,eof;
   bool  need_end_io_cache;
   IO_CACHE cache;
@@ -89,6 +95,8 @@ public:
 	    const String &enclosed,
             int escape,bool get_it_from_net, bool is_fifo);
   ~READ_INFO();
+  enum { CHAR_STOP_PLAIN= 1, CHAR_STOP_ENCLOSED= 2 };
+
   int read_field();
   int read_fixed_length(void);
   int next_line(void);
@@ -1439,6 +1447,21 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, const CHARSET_INFO *cs,
   field_term_char= field_term_length ? (uchar) field_term_ptr[0] : INT_MAX;
   line_term_char= line_term_length ? (uchar) line_term_ptr[0] : INT_MAX;
 
+  memset(char_class, 0, sizeof(char_class));
+  for (uint chr= 0; chr < 256; chr++)
+  {
+    if (my_mbcharlen(cs, chr) > 1)
+      char_class[chr]= CHAR_STOP_PLAIN | CHAR_STOP_ENCLOSED;
+  }
+  if (escape_char >= 0 && escape_char < 256)
+    char_class[escape_char]|= CHAR_STOP_PLAIN | CHAR_STOP_ENCLOSED;
+  if (enclosed_char != INT_MAX)
+    char_class[enclosed_char]|= CHAR_STOP_ENCLOSED;
+  if (field_term_char != INT_MAX)
+    char_class[field_term_char]|= CHAR_STOP_PLAIN;
+  if (line_term_char != INT_MAX)
+    char_class[line_term_char]|= CHAR_STOP_PLAIN;
+
 
   /* Set of a stack for unget if long terminators */
   uint length= max(cs->mbmaxlen, max(field_term_length, line_term_length)) + 1;
@@ -1524,6 +1547,7 @@ int READ_INFO::read_field()
 {
   int chr,found_enclosed_char;
   uchar *to,*new_buffer;
+  uchar stop_mask;
 
   found_null=0;
   if (found_end_of_line)
@@ -1553,11 +1577,33 @@ int READ_INFO::read_field()
     found_enclosed_char= INT_MAX;
     PUSH(chr);
   }
+  stop_mask= found_enclosed_char == INT_MAX ? CHAR_STOP_PLAIN :
+                                              CHAR_STOP_ENCLOSED;
 
   for (;;)
   {
     while ( to < end_of_buff)
     {
+      /*
+        Copy the bytes up to the next one that can end the field or that
+        needs unescaping directly from the read cache
+      */
+      if (stack_pos == stack)
+      {
+        uchar *pos= cache.read_pos;
+        uchar *end= cache.read_end;
+        if ((size_t) (end - pos) > (size_t) (end_of_buff - to))
+          end= pos + (end_of_buff - to);
+        while (pos < end && !(char_class[*pos] & stop_mask))
+          pos++;
+        if (pos != cache.read_pos)
+        {
+          memcpy(to, cache.read_pos, pos - cache.read_pos);
+          to+= pos - cache.read_pos;
+          cache.read_pos= pos;
+          continue;
+        }
+      }
       chr = GET;
       if (chr == my_b_EOF)
 	goto found_eof;
@@ -150,6 +150,22 @@ JOIN::optimize()
   if (flatten_subqueries())
     DBUG_RETURN(1); /* purecov: inspected */
 
+  /*
+    Copy conditions on materialized derived tables to their queries before
+    they are optimized. This is a permanent transformation.
+  */
+  if (first_optimization && conds &&
+      thd->optimizer_switch_flag(OPTIMIZER_SWITCH_DERIVED_CONDITION_PUSHDOWN))
+  {
+    Prepared_stmt_arena_holder ps_arena_holder(thd);
+    for (TABLE_LIST *tl= select_lex->leaf_tables; tl; tl= tl->next_leaf)
+    {
+      if (tl->is_view_or_derived() &&
+          mysql_derived_push_condition(thd, tl, conds))
+        DBUG_RETURN(1);
+    }
+  }
+
   /*
     Run optimize phase for all derived tables/views used in this SELECT,
     including those in semi-joins.
@@ -4937,7 +4953,22 @@ add_key_field(Key_field **key_fields,uint and_level, Item_func *cond,
           break;
       }
       if (is_const)
+      {
         stat[0].const_keys.merge(possible_keys);
+        /*
+          A skip scan can use a range over a later key part of a covering
+          index, see get_best_skip_scan().
+        */
+        if (field->table->in_use->
+            optimizer_switch_flag(OPTIMIZER_SWITCH_SKIP_SCAN))
+        {
+          key_map skip_scan_keys= field->part_of_key;
+          skip_scan_keys.intersect(field->table->keys_in_use_for_query);
+          skip_scan_keys.intersect(field->table->covering_keys);
+          stat[0].keys.merge(skip_scan_keys);
+          stat[0].const_keys.merge(skip_scan_keys);
+        }
+      }
       else if (!eq_func)
       {
         /* 
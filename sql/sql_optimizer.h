@@ -121,6 +121,13 @@ public:
       - on each fetch iteration we add num_rows to fetch to fetch_limit
   */
   ha_rows  fetch_limit;
+  /**
+    Set by a streaming server side cursor when a fetch stopped with
+    NESTED_LOOP_CURSOR_LIMIT: the next call of sub_select() continues
+    the scans from the current rows of the tables, instead of starting
+    them from the beginning.
+  */
+  bool     resume_nested_loop;
 
   /**
      Minimum number of matches that is needed to use JT_FT access.
@@ -398,6 +405,11 @@ public:
   bool set_group_rpa;
   /** Exec time only: TRUE <=> current group has been sent */
   bool group_sent;
+  /**
+    TRUE <=> EXPLAIN ANALYZE: the execution is measured in
+    JOIN_TAB::analyze_stats
+  */
+  bool analyzing;
 
   JOIN(THD *thd_arg, List<Item> &fields_arg, ulonglong select_options_arg,
        select_result *result_arg)
@@ -425,6 +437,7 @@ public:
     send_records= 0;
     found_records= 0;
     fetch_limit= HA_POS_ERROR;
+    resume_nested_loop= false;
     min_ft_matches= HA_POS_ERROR;
     examined_rows= 0;
     thd= thd_arg;
@@ -452,6 +465,7 @@ public:
     zero_result_cause= 0;
     optimized= child_subquery_can_materialize= false;
     executed= false;
+    analyzing= test(thd_arg->lex->describe & DESCRIBE_ANALYZE);
     cond_equal= 0;
     group_optimized_away= 0;
 
@@ -482,6 +496,12 @@ public:
   */
   bool plan_is_single_table() { return primary_tables - const_tables == 1; }
 
+  /**
+    True if the rows skipped by OFFSET may be skipped by filesort()
+    when sorting tab, see Filesort::offset.
+  */
+  bool can_skip_offset_in_sort(const JOIN_TAB *tab) const;
+
   int prepare(TABLE_LIST *tables, uint wind_num,
 	      Item *conds, uint og_num, ORDER *order, ORDER *group,
               Item *having,
@@ -818,10 +818,8 @@ void do_handle_bootstrap(THD *thd)
     goto end;
   }
 
-  mysql_mutex_lock(&LOCK_thread_count);
   thd_added= true;
   add_global_thread(thd);
-  mysql_mutex_unlock(&LOCK_thread_count);
 
   handle_bootstrap_impl(thd);
 
@@ -830,11 +828,7 @@ end:
   thd->release_resources();
 
   if (thd_added)
-  {
-    mysql_mutex_lock(&LOCK_thread_count);
     remove_global_thread(thd);
-    mysql_mutex_unlock(&LOCK_thread_count);
-  }
   /*
     For safety we delete the thd before signalling that bootstrap is done,
     since the server will be taken down immediately.
@@ -1758,7 +1752,7 @@ done:
 
   dec_thread_running();
   thd->packet.shrink(thd->variables.net_buffer_length);	// Reclaim some memory
-  free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
+  thd->free_mem_root_for_next_query();
 
   /* DTRACE instrumentation, end */
   if (MYSQL_QUERY_DONE_ENABLED() || MYSQL_COMMAND_DONE_ENABLED())
@@ -6098,6 +6092,26 @@ void add_join_natural(TABLE_LIST *a, TABLE_LIST *b, List<String> *using_fields,
 }
 
 
+/**
+  Find the connection thread with a given id, and lock its
+  THD::LOCK_thd_data. Daemon threads are not found.
+*/
+class Find_thd_with_id : public Find_THD_Impl
+{
+public:
+  Find_thd_with_id(ulong id) : m_id(id) {}
+  virtual bool operator()(THD *thd)
+  {
+    if (thd->get_command() == COM_DAEMON || thd->thread_id != m_id)
+      return false;
+    mysql_mutex_lock(&thd->LOCK_thd_data);      // Lock from delete
+    return true;
+  }
+private:
+  ulong m_id;
+};
+
+
 /**
   kill on thread.
 
@@ -6106,31 +6120,19 @@ void add_join_natural(TABLE_LIST *a, TABLE_LIST *b, List<String> *using_fields,
   @param only_kill_query        Should it kill the query or the connection
 
   @note
-    This is written such that we have a short lock on LOCK_thread_count
+    This is written such that we have a short lock on the partitions
+    of the global thread list
 */
 
 uint kill_one_thread(THD *thd, ulong id, bool only_kill_query)
 {
   THD *tmp= NULL;
   uint error=ER_NO_SUCH_THREAD;
+  Find_thd_with_id find_thd_with_id(id);
   DBUG_ENTER("kill_one_thread");
   DBUG_PRINT("enter", ("id=%lu only_kill=%d", id, only_kill_query));
 
-  mysql_mutex_lock(&LOCK_thread_count);
-  Thread_iterator it= global_thread_list_begin();
-  Thread_iterator end= global_thread_list_end();
-  for (; it != end; ++it)
-  {
-    if ((*it)->get_command() == COM_DAEMON)
-      continue;
-    if ((*it)->thread_id == id)
-    {
-      tmp= *it;
-      mysql_mutex_lock(&tmp->LOCK_thd_data);    // Lock from delete
-      break;
-    }
-  }
-  mysql_mutex_unlock(&LOCK_thread_count);
+  tmp= find_thd(&find_thd_with_id);
   if (tmp)
   {
 
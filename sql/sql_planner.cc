@@ -29,6 +29,7 @@
 #include "opt_range.h"
 #include "opt_trace.h"
 #include "sql_executor.h"
+#include "sql_join_buffer.h"
 #include "merge_sort.h"
 #include <my_bit.h>
 
@@ -40,6 +41,99 @@ static double prev_record_reads(JOIN *join, uint idx, table_map found_ref);
 static void trace_plan_prefix(JOIN *join, uint idx,
                               table_map excluded_tables);
 
+
+/**
+  The lowest cost and row count seen for partial plans of each set of
+  tables, during one step of greedy_search().
+
+  All partial plans of a step extend the same fixed prefix, and the cost
+  of an extension depends only on the tables already in the plan and on
+  its row count. A partial plan is then no better than another one of the
+  same tables with no higher cost and row count, and need not be
+  extended.
+
+  The entries are kept in a fixed-size open-addressing table. When the
+  slots around a table set are taken, its plans are not kept, which
+  only makes the pruning less complete.
+*/
+
+class Partial_plan_memo : public Sql_alloc
+{
+public:
+  static Partial_plan_memo *create(MEM_ROOT *mem_root)
+  {
+    Entry *entries= (Entry*) alloc_root(mem_root, sizeof(Entry) * SIZE);
+    if (entries == NULL)
+      return NULL;
+    memset(entries, 0, sizeof(Entry) * SIZE);
+    return new (mem_root) Partial_plan_memo(entries);
+  }
+
+  /// Forget the plans, for the next step of greedy_search()
+  void clear() { generation++; }
+
+  /**
+    Check if a partial plan is dominated by one of the same tables seen
+    before, and keep it otherwise.
+
+    @return true if the plan need not be extended
+  */
+  bool is_dominated(table_map tables, double cost, double rows)
+  {
+    uint pos= (uint) ((tables * 0x9E3779B97F4A7C15ULL) >> (64 - SIZE_LOG2));
+    for (uint probe= 0; probe < MAX_PROBES; probe++, pos= (pos + 1) % SIZE)
+    {
+      Entry *const entry= entries + pos;
+      if (entry->generation != generation)
+      {
+        entry->generation= generation;
+        entry->tables= tables;
+        entry->cost= cost;
+        entry->rows= rows;
+        return false;
+      }
+      if (entry->tables == tables)
+      {
+        if (entry->cost <= cost && entry->rows <= rows)
+        {
+          pruned++;
+          return true;
+        }
+        if (cost <= entry->cost && rows <= entry->rows)
+        {
+          entry->cost= cost;
+          entry->rows= rows;
+        }
+        return false;
+      }
+    }
+    return false;
+  }
+
+  /// Number of partial plans found to be dominated
+  ulonglong pruned;
+
+private:
+  static const uint SIZE_LOG2= 12;
+  static const uint SIZE= 1U << SIZE_LOG2;
+  static const uint MAX_PROBES= 8;
+
+  struct Entry
+  {
+    uint generation;
+    table_map tables;
+    double cost;
+    double rows;
+  };
+
+  explicit Partial_plan_memo(Entry *entries_arg)
+    : pruned(0), entries(entries_arg), generation(1)
+  {}
+
+  Entry *const entries;
+  uint generation;                      ///< of the entries in use
+};
+
 static uint
 max_part_bit(key_part_map bits)
 {
@@ -68,6 +162,247 @@ cache_record_length(JOIN *join,uint idx)
 }
 
 
+/**
+  Estimate the selectivity of "field = value" from the column histogram
+  kept by the storage engine.
+
+  @param field  column of the table; its value in record[0] is overwritten
+  @param value  constant compared to the column
+
+  @return estimated selectivity, 1.0 if there is no estimate
+*/
+
+static double field_eq_selectivity(Field *field, Item *value)
+{
+  TABLE *const table= field->table;
+
+  /*
+    Columns that start an index are estimated by the range optimizer,
+    which already accounts for them in quick_condition_rows.
+  */
+  if (!field->key_start.is_clear_all() ||
+      !value->const_item() || value->is_expensive())
+    return 1.0;
+
+  /* The histogram is ordered by the collation of the column. */
+  if (field->result_type() == STRING_RESULT &&
+      (value->result_type() != STRING_RESULT ||
+       field->charset() != value->collation.collation))
+    return 1.0;
+
+  if (field->result_type() != STRING_RESULT &&
+      value->result_type() == STRING_RESULT)
+    return 1.0;
+
+  THD *const thd= table->in_use;
+  const enum_check_fields save_count_cuted_fields= thd->count_cuted_fields;
+  thd->count_cuted_fields= CHECK_FIELD_IGNORE;
+  my_bitmap_map *old_map= dbug_tmp_use_all_columns(table, table->write_set);
+
+  const type_conversion_status err= value->save_in_field_no_warnings(field,
+                                                                     true);
+
+  dbug_tmp_restore_column_map(table->write_set, old_map);
+  thd->count_cuted_fields= save_count_cuted_fields;
+
+  // A value that does not fit into the column is not estimated
+  if (err != TYPE_OK)
+    return 1.0;
+
+  const double sel= table->file->column_eq_selectivity(field);
+  return sel > 0.0 ? min(sel, 1.0) : 1.0;
+}
+
+
+/**
+  Estimate the fraction of the rows of a table that satisfy the
+  "column = constant" equalities among the conjuncts of a condition.
+
+  @param cond   the condition
+  @param table  the table
+
+  @return estimated selectivity, 1.0 if there is no estimate
+*/
+
+static double cond_histogram_filter(Item *cond, TABLE *table)
+{
+  if (cond->type() == Item::COND_ITEM)
+  {
+    if (((Item_cond*) cond)->functype() != Item_func::COND_AND_FUNC)
+      return 1.0;
+
+    double sel= 1.0;
+    List_iterator<Item> li(*((Item_cond*) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+      sel*= cond_histogram_filter(item, table);
+    return sel;
+  }
+
+  if (cond->type() != Item::FUNC_ITEM)
+    return 1.0;
+
+  Item_func *const func= (Item_func*) cond;
+  switch (func->functype())
+  {
+  case Item_func::EQ_FUNC:
+  {
+    Item **const args= func->arguments();
+    for (uint i= 0; i < 2; i++)
+    {
+      Item *const real= args[i]->real_item();
+      if (real->type() == Item::FIELD_ITEM &&
+          ((Item_field*) real)->field->table == table)
+        return field_eq_selectivity(((Item_field*) real)->field,
+                                    args[1 - i]);
+    }
+    return 1.0;
+  }
+  case Item_func::MULT_EQUAL_FUNC:
+  {
+    Item_equal *const item_equal= (Item_equal*) func;
+    Item *const value= item_equal->get_const();
+    if (value == NULL)
+      return 1.0;
+
+    /*
+      All the columns are equal to the same constant, so their
+      selectivities are not independent: use the smallest one.
+    */
+    double sel= 1.0;
+    Item_equal_iterator it(*item_equal);
+    Item_field *item_field;
+    while ((item_field= it++))
+    {
+      if (item_field->field->table == table)
+        sel= min(sel, field_eq_selectivity(item_field->field, value));
+    }
+    return sel;
+  }
+  default:
+    return 1.0;
+  }
+}
+
+
+/**
+  Estimate the fraction of the rows of a table that remain after the
+  "column = constant" equalities on columns that start no index have
+  been applied, from the column histograms of the storage engine.
+  The estimate is computed once per table and kept in the JOIN_TAB.
+
+  @param join  the join being optimized
+  @param tab   the table
+
+  @return estimated selectivity, 1.0 if there is no estimate
+*/
+
+static double histogram_filter(JOIN *join, JOIN_TAB *tab)
+{
+  if (tab->histogram_filter < 0.0)
+  {
+    Item *const cond= tab->on_expr_ref && *tab->on_expr_ref ?
+                      *tab->on_expr_ref : join->conds;
+    tab->histogram_filter= cond ?
+                           cond_histogram_filter(cond, tab->table) : 1.0;
+  }
+  return tab->histogram_filter;
+}
+
+
+/**
+  Check whether a condition has an equality between a table and the tables
+  of a partial plan, which a hash join cache for the table could use.
+
+  @param cond              the condition
+  @param table             the table to be joined
+  @param remaining_tables  the tables not included in the partial plan
+
+  @return true if there is such an equality
+*/
+
+static bool cond_has_hash_key(Item *cond, TABLE *table,
+                              table_map remaining_tables)
+{
+  if (cond->type() == Item::COND_ITEM)
+  {
+    if (((Item_cond*) cond)->functype() != Item_func::COND_AND_FUNC)
+      return false;
+
+    List_iterator<Item> li(*((Item_cond*) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+    {
+      if (cond_has_hash_key(item, table, remaining_tables))
+        return true;
+    }
+    return false;
+  }
+
+  if (cond->type() != Item::FUNC_ITEM)
+    return false;
+
+  Item_func *const func= (Item_func*) cond;
+  switch (func->functype())
+  {
+  case Item_func::EQ_FUNC:
+  {
+    Item **const args= func->arguments();
+    for (uint i= 0; i < 2; i++)
+    {
+      const table_map probe_used=
+        args[i]->used_tables() & ~PSEUDO_TABLE_BITS;
+      const table_map build_used=
+        args[1 - i]->used_tables() & ~PSEUDO_TABLE_BITS;
+      if (probe_used == table->map && build_used != 0 &&
+          !(build_used & remaining_tables))
+        return true;
+    }
+    return false;
+  }
+  case Item_func::MULT_EQUAL_FUNC:
+  {
+    bool in_table= false;
+    bool in_prefix= false;
+    Item_equal_iterator it(*(Item_equal*) func);
+    Item_field *item_field;
+    while ((item_field= it++))
+    {
+      const table_map map= item_field->used_tables() & ~PSEUDO_TABLE_BITS;
+      if (map == table->map)
+        in_table= true;
+      else if (map != 0 && !(map & remaining_tables))
+        in_prefix= true;
+    }
+    return in_table && in_prefix;
+  }
+  default:
+    return false;
+  }
+}
+
+
+/**
+  Check whether a hash join cache could be used to join a table to a
+  partial plan, see JOIN_CACHE_HASH.
+
+  @param join              the join being optimized
+  @param tab               the table to be joined
+  @param remaining_tables  the tables not included in the partial plan
+
+  @return true if the hash join cache could be used
+*/
+
+static bool hash_join_possible(JOIN *join, JOIN_TAB *tab,
+                               table_map remaining_tables)
+{
+  Item *const cond= tab->on_expr_ref && *tab->on_expr_ref ?
+                    *tab->on_expr_ref : join->conds;
+  return cond != NULL &&
+         cond_has_hash_key(cond, tab->table, remaining_tables);
+}
+
+
 /**
   Find the best access path for an extension of a partial execution
   plan and add this path to the plan.
@@ -614,6 +949,17 @@ void Optimize_table_order::best_access_path(
     if (table->quick_condition_rows != s->found_records)
       rnd_records= table->quick_condition_rows;
 
+    /*
+      Equalities on columns that start no index are not seen by the range
+      optimizer; use the column histograms of the engine, if any.
+    */
+    const double hist_filter= histogram_filter(join, s);
+    if (hist_filter < 1.0 && rnd_records > 0)
+    {
+      rnd_records= max<ha_rows>(1, (ha_rows) (rnd_records * hist_filter));
+      trace_access_scan.add("histogram_filter", hist_filter);
+    }
+
     /*
       Range optimizer never proposes a RANGE if it isn't better
       than FULL: so if RANGE is present, it's always preferred to FULL.
@@ -659,12 +1005,21 @@ void Optimize_table_order::best_access_path(
       else
       {
         trace_access_scan.add("using_join_cache", true);
+        /*
+          With a hash join cache every record in the join buffer also takes
+          an entry of the hash table, see JOIN_CACHE_HASH.
+        */
+        const bool hash_join=
+          thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HASH_JOIN) &&
+          hash_join_possible(join, s, remaining_tables);
+        const uint rec_length= cache_record_length(join,idx) +
+          (hash_join ? JOIN_CACHE_HASH::record_overhead() : 0);
         /*
           We read the table as many times as join buffer becomes full.
           It would be more exact to round the result of the division with
           floor(), but that takes 5% of time in a 20-table query plan search.
         */
-        tmp*= (1.0 + ((double) cache_record_length(join,idx) *
+        tmp*= (1.0 + ((double) rec_length *
                       record_count /
                       (double) thd->variables.join_buff_size));
         /* 
@@ -675,6 +1030,17 @@ void Optimize_table_order::best_access_path(
            take into account cost to read and skip these records.
         */
         tmp+= (s->records - rnd_records) * ROW_EVALUATE_COST;
+        /*
+          The records of the join buffer are hashed once. Each row read is
+          then compared only with the records of its hash chain, which is
+          the estimate the row count below already makes for any join
+          buffer.
+        */
+        if (hash_join)
+        {
+          trace_access_scan.add("using_hash_join", true);
+          tmp+= record_count * ROW_EVALUATE_COST;
+        }
       }
     }
 
@@ -1160,16 +1526,38 @@ bool Optimize_table_order::choose_table_order()
     join_tables= join->all_table_map & ~join->const_table_map;
   }
 
+  const ulonglong partial_plans_before=
+    thd->status_var.last_query_partial_plans;
+  bool star_join= false;
+
   Opt_trace_object wrapper(&join->thd->opt_trace);
   Opt_trace_array
     trace_plan(&join->thd->opt_trace, "considered_execution_plans",
                Opt_trace_context::GREEDY_SEARCH);
   if (straight_join)
     optimize_straight_join(join_tables);
+  else if (reuse_saved_join_order())
+    optimize_straight_join(join_tables);
+  else if (!emb_sjm_nest && order_snowflake_join(join_tables))
+  {
+    star_join= true;
+    optimize_straight_join(join_tables);
+  }
   else
   {
     if (greedy_search(join_tables))
       DBUG_RETURN(true);
+    save_join_order();
+  }
+
+  if (thd->optimizer_switch_flag(OPTIMIZER_SWITCH_PLAN_MEMOIZATION) ||
+      thd->optimizer_switch_flag(OPTIMIZER_SWITCH_STAR_JOIN_ORDER))
+  {
+    Opt_trace_object(&thd->opt_trace).
+      add("partial_plans",
+          thd->status_var.last_query_partial_plans - partial_plans_before).
+      add("pruned_by_memoization", plan_memo ? plan_memo->pruned : 0ULL).
+      add("star_join_order", star_join);
   }
 
   // Remaining part of this function not needed when processing semi-join nests.
@@ -1318,6 +1706,215 @@ void Optimize_table_order::optimize_straight_join(table_map join_tables)
 }
 
 
+/**
+  Put the tables in the join order found by an earlier execution of the
+  statement, if it is still valid.
+
+  Prepared statements and statements of stored programs optimize their
+  query blocks again at each execution. The greedy search dominates the
+  optimization time of joins of many tables, and its result rarely changes
+  from one execution to the next, so the join order it found is kept in
+  SELECT_LEX::saved_join_order. The order is reused, and only the access
+  methods of the tables are chosen again, when:
+  - the same tables are constant, which may depend on parameter values
+  - the row estimate of no table has changed by more than a factor of 2,
+    which covers changed statistics and parameter-dependent ranges.
+  DDL on the tables makes the statement be prepared again, with no saved
+  order.
+
+  Query blocks with semi-join nests are not handled.
+
+  @return true if the tables of join->best_ref are in the saved order,
+    which optimize_straight_join() is to complete into a plan
+*/
+
+bool Optimize_table_order::reuse_saved_join_order()
+{
+  if (thd->stmt_arena->is_conventional() ||
+      !join->select_lex->sj_nests.is_empty())
+    return false;
+
+  const Saved_join_order *const saved= join->select_lex->saved_join_order;
+  if (saved == NULL || saved->tables != join->tables ||
+      saved->const_tables != join->const_table_map)
+  {
+    thd->status_var.join_order_cache_misses++;
+    return false;
+  }
+  for (uint i= join->const_tables; i < join->tables; i++)
+  {
+    const JOIN_TAB *const tab= join->best_ref[i];
+    const ha_rows rows= tab->found_records;
+    const ha_rows saved_rows= saved->found_records[tab->table->tablenr];
+    if (rows / 2 > saved_rows || saved_rows / 2 > rows)
+    {
+      thd->status_var.join_order_cache_misses++;
+      return false;
+    }
+  }
+
+  for (uint i= join->const_tables; i < join->tables; i++)
+  {
+    for (uint j= i; j < join->tables; j++)
+    {
+      if (join->best_ref[j]->table->tablenr == saved->order[i])
+      {
+        std::swap(join->best_ref[i], join->best_ref[j]);
+        break;
+      }
+    }
+    DBUG_ASSERT(join->best_ref[i]->table->tablenr == saved->order[i]);
+  }
+  thd->status_var.join_order_cache_hits++;
+  return true;
+}
+
+
+/**
+  Selectivity of the conditions on a table alone, used to order the
+  branches of a star or snowflake join.
+*/
+
+static double table_selectivity(JOIN *join, JOIN_TAB *tab)
+{
+  const double records= max(1.0, rows2double(tab->records));
+  return rows2double(tab->found_records) / records *
+         histogram_filter(join, tab);
+}
+
+
+/**
+  Order the tables of a star or snowflake join without a search.
+
+  The join is a star or snowflake when, taking the table with the most
+  rows as the root (the fact table), every other table is looked up by
+  key from exactly one table and all tables are reached that way from
+  the root. The root is put first. Then, among the tables whose parent
+  is already in the plan, the one with the most selective conditions is
+  put next, so that rows of the fact table are rejected as early as
+  possible. This takes time in the square of the number of tables,
+  where the search may be exponential.
+
+  Used only when the star_join_order optimizer switch is on, and not for
+  query blocks with outer joins or semi-joins.
+
+  @param join_tables  the tables to order
+
+  @return true if the tables of join->best_ref have been ordered, for
+    optimize_straight_join(), false if the join is not a star or
+    snowflake
+*/
+
+bool Optimize_table_order::order_snowflake_join(table_map join_tables)
+{
+  const uint first= join->const_tables;
+  if (!thd->optimizer_switch_flag(OPTIMIZER_SWITCH_STAR_JOIN_ORDER) ||
+      join->tables - first < 3 ||
+      !join->select_lex->sj_nests.is_empty())
+    return false;
+
+  JOIN_TAB *root= NULL;
+  for (uint i= first; i < join->tables; i++)
+  {
+    JOIN_TAB *const tab= join->best_ref[i];
+    if (tab->dependent & join_tables)
+      return false;                             // Outer join
+    if (root == NULL || tab->found_records > root->found_records)
+      root= tab;
+  }
+
+  /* Check that every table is reached from the root */
+  table_map reached= root->table->map;
+  bool extended;
+  do
+  {
+    extended= false;
+    for (uint i= first; i < join->tables; i++)
+    {
+      JOIN_TAB *const tab= join->best_ref[i];
+      const table_map parent= tab->key_dependent & join_tables;
+      if (!(reached & tab->table->map) && my_count_bits(parent) == 1 &&
+          (parent & reached))
+      {
+        reached|= tab->table->map;
+        extended= true;
+      }
+    }
+  } while (extended);
+  if (reached != join_tables)
+    return false;
+
+  /* Put each next table by selectivity among those whose parent is in */
+  for (uint i= first; i < join->tables; i++)
+  {
+    if (join->best_ref[i] == root)
+    {
+      std::swap(join->best_ref[first], join->best_ref[i]);
+      break;
+    }
+  }
+  table_map placed= root->table->map;
+  for (uint idx= first + 1; idx < join->tables; idx++)
+  {
+    uint best= 0;
+    double best_selectivity= 0.0;
+    for (uint i= idx; i < join->tables; i++)
+    {
+      JOIN_TAB *const tab= join->best_ref[i];
+      if (!(tab->key_dependent & placed))
+        continue;
+      const double selectivity= table_selectivity(join, tab);
+      if (best == 0 || selectivity < best_selectivity ||
+          (selectivity == best_selectivity &&
+           tab->found_records < join->best_ref[best]->found_records))
+      {
+        best= i;
+        best_selectivity= selectivity;
+      }
+    }
+    DBUG_ASSERT(best != 0);
+    std::swap(join->best_ref[idx], join->best_ref[best]);
+    placed|= join->best_ref[idx]->table->map;
+  }
+  return true;
+}
+
+
+/**
+  Keep the join order found by greedy_search() for the next executions of
+  the statement, see reuse_saved_join_order().
+*/
+
+void Optimize_table_order::save_join_order()
+{
+  if (thd->stmt_arena->is_conventional() ||
+      !join->select_lex->sj_nests.is_empty())
+    return;
+
+  Saved_join_order *saved= join->select_lex->saved_join_order;
+  if (saved == NULL || saved->tables != join->tables)
+  {
+    if (!(saved= (Saved_join_order*)
+          thd->stmt_arena->alloc(sizeof(Saved_join_order))) ||
+        !(saved->order= (uint*)
+          thd->stmt_arena->alloc(sizeof(uint) * join->tables)) ||
+        !(saved->found_records= (ha_rows*)
+          thd->stmt_arena->alloc(sizeof(ha_rows) * join->tables)))
+      return;                                   // The order is not kept
+    saved->tables= join->tables;
+    join->select_lex->saved_join_order= saved;
+  }
+  saved->const_tables= join->const_table_map;
+  for (uint i= join->const_tables; i < join->tables; i++)
+    saved->order[i]= join->best_positions[i].table->table->tablenr;
+  for (uint i= 0; i < join->tables; i++)
+  {
+    const JOIN_TAB *const tab= join->join_tab + i;
+    saved->found_records[tab->table->tablenr]= tab->found_records;
+  }
+}
+
+
 /**
   Check whether a semijoin materialization strategy is allowed for
   the current (semi)join table order.
@@ -1486,10 +2083,16 @@ bool Optimize_table_order::greedy_search(table_map remaining_tables)
   /* Number of tables remaining to be optimized */
   uint size_remain= n_tables;
 
+  if (thd->optimizer_switch_flag(OPTIMIZER_SWITCH_PLAN_MEMOIZATION) &&
+      join->select_lex->sj_nests.is_empty() && plan_memo == NULL)
+    plan_memo= Partial_plan_memo::create(thd->mem_root);
+
   do {
     /* Find the extension of the current QEP with the lowest cost */
     join->best_read= DBL_MAX;
     join->best_rowcount= HA_POS_ERROR;
+    if (plan_memo)
+      plan_memo->clear();
     if (best_extension_by_limited_search(remaining_tables, idx,
                                          record_count, read_time,
                                          search_depth))
@@ -1946,6 +2549,20 @@ bool Optimize_table_order::best_extension_by_limited_search(
         (remaining_tables & ~real_table_bit);
       if ((current_search_depth > 1) && remaining_tables_after)
       {
+        /*
+          Do not extend the plan if a cheaper plan of the same tables
+          has been extended already.
+        */
+        if (plan_memo &&
+            plan_memo->is_dominated(join->all_table_map &
+                                    ~remaining_tables_after,
+                                    current_read_time, current_record_count))
+        {
+          trace_one_table.add("pruned_by_memoization", true);
+          backout_nj_state(remaining_tables, s);
+          continue;
+        }
+
         /*
           Explore more extensions of plan:
           If possible, use heuristic to avoid a full expansion of partial QEP.
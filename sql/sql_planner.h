@@ -24,6 +24,23 @@
 #include "sql_optimizer.h"
 
 class Opt_trace_object;
+class Partial_plan_memo;
+
+/**
+  Join order chosen by the greedy search for a query block of a statement
+  that is executed repeatedly: a prepared statement or a statement of a
+  stored program. It is allocated on the statement's mem_root and lets
+  later executions skip the search, see
+  Optimize_table_order::reuse_saved_join_order().
+*/
+
+struct Saved_join_order
+{
+  uint tables;                  ///< JOIN::tables
+  table_map const_tables;       ///< JOIN::const_table_map
+  uint *order;                  ///< tablenr of the table at each position
+  ha_rows *found_records;       ///< JOIN_TAB::found_records, by tablenr
+};
 
 /**
   This class determines the optimal join order for tables within
@@ -52,7 +69,8 @@ public:
     cur_embedding_map(0), emb_sjm_nest(sjm_nest),
     excluded_tables((sjm_nest ?
                      (join->all_table_map & ~sjm_nest->sj_inner_tables) : 0) |
-                    (join->allow_outer_refs ? 0 : OUTER_REF_TABLE_BIT))
+                    (join->allow_outer_refs ? 0 : OUTER_REF_TABLE_BIT)),
+    plan_memo(NULL)
   {}
   ~Optimize_table_order()
   {}
@@ -89,6 +107,11 @@ private:
     @c excluded_tables tracks these tables.
   */
   const table_map excluded_tables;
+  /**
+    Lowest costs of partial plans by set of tables, for the pruning done
+    when the plan_memoization optimizer switch is on. NULL otherwise.
+  */
+  Partial_plan_memo *plan_memo;
 
   void best_access_path(JOIN_TAB *s, table_map remaining_tables, uint idx, 
                         bool disable_jbuf, double record_count,
@@ -104,6 +127,9 @@ private:
   void backout_nj_state(const table_map remaining_tables,
                         const JOIN_TAB *tab);
   void optimize_straight_join(table_map join_tables);
+  bool reuse_saved_join_order();
+  bool order_snowflake_join(table_map join_tables);
+  void save_join_order();
   bool greedy_search(table_map remaining_tables);
   bool best_extension_by_limited_search(table_map remaining_tables,
                                         uint idx,
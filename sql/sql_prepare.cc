@@ -180,6 +180,7 @@ public:
   virtual void cleanup_stmt();
   bool set_name(LEX_STRING *name);
   inline void close_cursor() { delete cursor; cursor= 0; }
+  virtual void close_transient_cursor();
   inline bool is_in_use() { return flags & (uint) IS_IN_USE; }
   inline bool is_sql_prepare() const { return flags & (uint) IS_SQL_PREPARE; }
   void set_sql_prepare() { flags|= (uint) IS_SQL_PREPARE; }
@@ -3261,6 +3262,20 @@ Query_arena::Type Prepared_statement::type() const
 }
 
 
+/**
+  Close the cursor of the statement at COMMIT or ROLLBACK, if it
+  reads the tables of the transaction on each fetch.
+  A cursor which is no longer open is being fetched from, and is
+  deleted by mysqld_stmt_fetch().
+*/
+
+void Prepared_statement::close_transient_cursor()
+{
+  if (cursor && cursor->is_open() && cursor->is_transient())
+    close_cursor();
+}
+
+
 void Prepared_statement::cleanup_stmt()
 {
   DBUG_ENTER("Prepared_statement::cleanup_stmt");
@@ -236,7 +236,47 @@ template <class T> bool valid_buffer_range(T jump,
 #define OPTIMIZER_SWITCH_FIRSTMATCH                (1ULL << 13)
 #define OPTIMIZER_SWITCH_SUBQ_MAT_COST_BASED       (1ULL << 14)
 #define OPTIMIZER_SWITCH_USE_INDEX_EXTENSIONS      (1ULL << 15)
-#define OPTIMIZER_SWITCH_LAST                      (1ULL << 16)
+/**
+   If OPTIMIZER_SWITCH_BNL is on and this is on, a join buffer for a table
+   scan that has equalities with the buffered tables is probed through a
+   hash table on the buffered side of the equalities.
+*/
+#define OPTIMIZER_SWITCH_HASH_JOIN                 (1ULL << 16)
+/**
+   If this is on, the join order search does not extend a partial plan if
+   a partial plan of the same tables with no higher cost and row count
+   has been seen.
+*/
+#define OPTIMIZER_SWITCH_PLAN_MEMOIZATION          (1ULL << 17)
+/**
+   If this is on, star and snowflake joins are ordered by the selectivity
+   of the tables at each branch instead of by a search.
+*/
+#define OPTIMIZER_SWITCH_STAR_JOIN_ORDER           (1ULL << 18)
+/**
+   If this is on, range access may skip over the values of the first key
+   parts of an index that have no conditions (QUICK_SKIP_SCAN_SELECT).
+*/
+#define OPTIMIZER_SWITCH_SKIP_SCAN                 (1ULL << 19)
+/**
+   If this is on, conditions of the WHERE clause on the columns of a
+   materialized derived table or view are copied to the WHERE clause of
+   its query before it is materialized.
+*/
+#define OPTIMIZER_SWITCH_DERIVED_CONDITION_PUSHDOWN (1ULL << 20)
+/**
+   If this is on, the rows of a top-level UNION ALL without ORDER BY or
+   LIMIT are sent to the client as each query block produces them,
+   instead of being stored in the temporary table of the union first.
+*/
+#define OPTIMIZER_SWITCH_UNION_ALL_STREAMING       (1ULL << 21)
+/**
+   If this is on, GROUP BY without a usable index aggregates the groups
+   in an in-memory hash table, and writes them to the temporary table
+   only when it is complete or too large
+*/
+#define OPTIMIZER_SWITCH_HASH_AGGREGATION          (1ULL << 22)
+#define OPTIMIZER_SWITCH_LAST                      (1ULL << 23)
 
 #define OPTIMIZER_SWITCH_DEFAULT (OPTIMIZER_SWITCH_INDEX_MERGE | \
                                   OPTIMIZER_SWITCH_INDEX_MERGE_UNION | \
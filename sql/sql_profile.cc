@@ -90,6 +90,10 @@ ST_FIELD_INFO query_profile_statistics_info[]=
   {"SOURCE_FUNCTION", 30, MYSQL_TYPE_STRING, 0, true, "Source_function", SKIP_OPEN_TABLE},
   {"SOURCE_FILE", 20, MYSQL_TYPE_STRING, 0, true, "Source_file", SKIP_OPEN_TABLE},
   {"SOURCE_LINE", 20, MYSQL_TYPE_LONG, 0, true, "Source_line", SKIP_OPEN_TABLE},
+  {"CYCLES", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, (MY_I_S_MAYBE_NULL | MY_I_S_UNSIGNED), "Cycles", SKIP_OPEN_TABLE},
+  {"INSTRUCTIONS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, (MY_I_S_MAYBE_NULL | MY_I_S_UNSIGNED), "Instructions", SKIP_OPEN_TABLE},
+  {"LLC_MISSES", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, (MY_I_S_MAYBE_NULL | MY_I_S_UNSIGNED), "LLC_misses", SKIP_OPEN_TABLE},
+  {"BRANCH_MISSES", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0, (MY_I_S_MAYBE_NULL | MY_I_S_UNSIGNED), "Branch_misses", SKIP_OPEN_TABLE},
   {NULL, 0,  MYSQL_TYPE_STRING, 0, true, NULL, 0}
 };
 
@@ -116,6 +120,10 @@ int make_profile_table_for_show(THD *thd, ST_SCHEMA_TABLE *schema_table)
     profile_options & PROFILE_SOURCE, /* Source_function */
     profile_options & PROFILE_SOURCE, /* Source_file */
     profile_options & PROFILE_SOURCE, /* Source_line */
+    profile_options & PROFILE_HARDWARE, /* Cycles */
+    profile_options & PROFILE_HARDWARE, /* Instructions */
+    profile_options & PROFILE_HARDWARE, /* LLC_misses */
+    profile_options & PROFILE_HARDWARE, /* Branch_misses */
   };
 
   ST_FIELD_INFO *field_info;
@@ -263,6 +271,7 @@ void PROF_MEASUREMENT::collect()
   // measurable by this function.
   GetProcessTimes(GetCurrentProcess(), &ftDummy, &ftDummy, &ftKernel, &ftUser);
 #endif
+  hw_counters_unavailable= my_perf_counters_read(&hw_counters);
 }
 
 
@@ -724,6 +733,22 @@ int PROFILING::fill_statistics_info(THD *thd_arg, TABLE_LIST *tables, Item *cond
         table->field[17]->set_notnull();
       }
 
+      /* NULL unless the counters were read in the same thread at both ends */
+      MY_PERF_COUNTERS hw_counters= entry->hw_counters;
+      if (!entry->hw_counters_unavailable &&
+          !previous->hw_counters_unavailable &&
+          !my_perf_counters_diff(&hw_counters, &previous->hw_counters))
+      {
+        table->field[18]->store(hw_counters.cycles, true);
+        table->field[18]->set_notnull();
+        table->field[19]->store(hw_counters.instructions, true);
+        table->field[19]->set_notnull();
+        table->field[20]->store(hw_counters.llc_misses, true);
+        table->field[20]->set_notnull();
+        table->field[21]->store(hw_counters.branch_misses, true);
+        table->field[21]->set_notnull();
+      }
+
       if (schema_table_store_record(thd_arg, table))
         DBUG_RETURN(1);
 
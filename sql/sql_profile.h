@@ -35,6 +35,7 @@ int make_profile_table_for_show(THD *thd, ST_SCHEMA_TABLE *schema_table);
 #define PROFILE_PAGE_FAULTS  (uint)(1<<4)
 #define PROFILE_IPC          (uint)(1<<5)
 #define PROFILE_SWAPS        (uint)(1<<6)
+#define PROFILE_HARDWARE     (uint)(1<<7)
 #define PROFILE_SOURCE       (uint)(1<<16)
 #define PROFILE_ALL          (uint)(~0)
 
@@ -42,6 +43,7 @@ int make_profile_table_for_show(THD *thd, ST_SCHEMA_TABLE *schema_table);
 #if defined(ENABLED_PROFILING)
 #include "sql_priv.h"
 #include "unireg.h"
+#include "my_perf_counters.h"
 
 #ifdef HAVE_SYS_RESOURCE_H
 #include <sys/resource.h>
@@ -177,6 +179,9 @@ private:
 #elif defined(_WIN32)
   FILETIME ftKernel, ftUser;
 #endif
+  /** Hardware counters, valid unless hw_counters_unavailable is set */
+  MY_PERF_COUNTERS hw_counters;
+  my_bool hw_counters_unavailable;
 
   char *function;
   char *file;
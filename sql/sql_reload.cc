@@ -22,6 +22,7 @@
 #include "sql_connect.h" // reset_mqh
 #include "sql_base.h"    // close_cached_tables
 #include "sql_db.h"      // my_dbopt_cleanup
+#include "sp.h"          // sp_definition_cache_flush
 #include "hostname.h"    // hostname_cache_refresh
 #include "rpl_master.h"  // reset_master
 #include "rpl_slave.h"   // reset_slave
@@ -180,6 +181,10 @@ bool reload_acl_and_cache(THD *thd, unsigned long options,
     query_cache.flush();			// RESET QUERY CACHE
   }
 
+  /* Routine definitions changed by editing mysql.proc directly */
+  if (options & REFRESH_TABLES)
+    sp_definition_cache_flush();
+
   DBUG_ASSERT(!thd || thd->locked_tables_mode ||
               !thd->mdl_context.has_locks() ||
               thd->handler_tables_hash.records ||
@@ -624,6 +624,8 @@ static bool setup_semijoin_dups_elimination(JOIN *join, ulonglong options,
                                                sjtbl->null_bytes,
                                                sjtbl);
           join->sj_tmp_tables.push_back(sjtbl->tmp_table);
+          if (sjtbl->tmp_table && sjtbl->init_rowid_hash(thd))
+            DBUG_RETURN(TRUE); /* purecov: inspected */
         }
         else
         {
@@ -710,6 +712,16 @@ static void destroy_sj_tmp_tables(JOIN *join)
     free_tmp_table(join->thd, table);
   }
   join->sj_tmp_tables.empty();
+
+  /* The hash sets of DuplicateWeedout tables */
+  if (join->join_tab)
+  {
+    for (uint i= 0; i < join->primary_tables; i++)
+    {
+      if (join->join_tab[i].starts_weedout())
+        join->join_tab[i].flush_weedout_table->free_rowid_hash();
+    }
+  }
 }
 
 
@@ -2335,6 +2347,8 @@ static bool setup_join_buffering(JOIN_TAB *tab, JOIN *join,
   JOIN_CACHE *prev_cache;
   const bool bnl_on= join->thd->optimizer_switch_flag(OPTIMIZER_SWITCH_BNL);
   const bool bka_on= join->thd->optimizer_switch_flag(OPTIMIZER_SWITCH_BKA);
+  const bool hash_on=
+    join->thd->optimizer_switch_flag(OPTIMIZER_SWITCH_HASH_JOIN);
   const uint tableno= tab - join->join_tab;
   const uint tab_sj_strategy= tab->get_sj_strategy();
   bool use_bka_unique= false;
@@ -2463,6 +2477,23 @@ static bool setup_join_buffering(JOIN_TAB *tab, JOIN *join,
       goto no_join_cache;
     }
 
+    /*
+      Probe the join buffer through a hash table if the condition of the
+      table has equalities with the buffered tables.
+    */
+    if (hash_on && JOIN_CACHE_HASH::hash_key_count(tab) > 0)
+    {
+      if ((tab->op= new JOIN_CACHE_HASH(join, tab, prev_cache)) &&
+          !tab->op->init())
+      {
+        *icp_other_tables_ok= FALSE;
+        DBUG_ASSERT(might_do_join_buffering(join_buffer_alg(join->thd), tab));
+        tab->use_join_cache= JOIN_CACHE::ALG_HASH;
+        return false;
+      }
+      goto no_join_cache;
+    }
+
     if (((tab->op= new JOIN_CACHE_BNL(join, tab, prev_cache)) &&
          !tab->op->init()))
     {
@@ -3610,6 +3641,32 @@ uint find_shortest_key(TABLE *table, const key_map *usable_keys)
   return best;
 }
 
+/**
+  Find the shortest index which contains the given columns, and can be
+  read without reading the rows.
+
+  @param table    Table to read
+  @param columns  Columns to read
+
+  @return
+    MAX_KEY     no such index
+    key index   otherwise
+*/
+
+uint find_covering_key(TABLE *table, const MY_BITMAP *columns)
+{
+  if (table->no_keyread)
+    return MAX_KEY;
+  key_map usable_keys= table->s->keys_for_keyread;
+  usable_keys.intersect(table->keys_in_use_for_query);
+  for (Field **field= table->field; *field; field++)
+  {
+    if (bitmap_is_set(columns, (*field)->field_index))
+      usable_keys.intersect((*field)->part_of_key);
+  }
+  return find_shortest_key(table, &usable_keys);
+}
+
 /**
   Test if a second key is the subkey of the first one.
 
@@ -3901,7 +3958,8 @@ test_if_skip_sort_order(JOIN_TAB *tab, ORDER *order, ha_rows select_limit,
   
     if (quick_type == QUICK_SELECT_I::QS_TYPE_INDEX_MERGE || 
         quick_type == QUICK_SELECT_I::QS_TYPE_ROR_UNION || 
-        quick_type == QUICK_SELECT_I::QS_TYPE_ROR_INTERSECT)
+        quick_type == QUICK_SELECT_I::QS_TYPE_ROR_INTERSECT ||
+        quick_type == QUICK_SELECT_I::QS_TYPE_SKIP_SCAN)
       DBUG_RETURN(0);
     ref_key=	   select->quick->index;
     ref_key_parts= select->quick->used_key_parts;
@@ -5435,6 +5493,33 @@ JOIN::add_sorting_to_table(JOIN_TAB *tab, ORDER_with_src *order)
   return false;
 }
 
+
+/**
+  Check if filesort() may skip the rows of the OFFSET clause, instead of
+  returning them to be discarded by the result: the rows of tab must be
+  sent as they are sorted, so tab must be the only non-const table, and
+  there must be no grouping, DISTINCT, HAVING or SQL_CALC_FOUND_ROWS.
+
+  The condition of tab is not checked: it is moved to filesort, see
+  add_sorting_to_table().
+
+  @param tab  the table sorted by filesort
+
+  @return true if filesort may skip the OFFSET rows
+*/
+
+bool JOIN::can_skip_offset_in_sort(const JOIN_TAB *tab) const
+{
+  return unit->offset_limit_cnt != 0 &&
+         !unit->is_union() &&
+         primary_tables == const_tables + 1 &&
+         tab == join_tab + const_tables &&
+         tmp_tables == 0 &&
+         !group_list && !select_distinct && !having && !implicit_grouping &&
+         !(select_options & OPTION_FOUND_ROWS) &&
+         !tab->first_inner && !tab->first_sj_inner_tab;
+}
+
 /**
   Find a cheaper access key than a given @a key
 
@@ -5528,6 +5613,36 @@ test_if_cheaper_ordering(const JOIN_TAB *tab, ORDER *order, TABLE *table,
   else
     read_time= table->file->scan_time();
 
+  /*
+    With OFFSET, filesort() only reads the skipped rows from the shortest
+    index covering the sort key, the condition and the row position, if
+    there is one, and the returned rows in full: see Filesort::offset.
+  */
+  if (join && has_limit && ref_key < 0 && join->can_skip_offset_in_sort(tab))
+  {
+    bitmap_clear_all(&table->tmp_set);
+    for (ORDER *tmp_order= order; tmp_order; tmp_order= tmp_order->next)
+      (*tmp_order->item)->walk(&Item::add_field_to_set_processor, 1,
+                               (uchar*) table);
+    if (tab->condition())
+      tab->condition()->walk(&Item::add_field_to_set_processor, 1,
+                             (uchar*) table);
+    if ((table->file->ha_table_flags() & HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) &&
+        table->s->primary_key < MAX_KEY)
+      table->mark_columns_used_by_index_no_reset(table->s->primary_key,
+                                                 &table->tmp_set);
+    const uint key= find_covering_key(table, &table->tmp_set);
+    if (key != MAX_KEY)
+    {
+      const ha_rows returned_rows=
+        select_limit - min(select_limit, join->unit->offset_limit_cnt);
+      const double late_read_time=
+        table->file->index_only_read_time(key, rows2double(table_records)) +
+        table->file->read_time(key, 1, returned_rows);
+      set_if_smaller(read_time, late_read_time);
+    }
+  }
+
   /*
     Calculate the selectivity of the ref_key for REF_ACCESS. For
     RANGE_ACCESS we use table->quick_condition_rows.
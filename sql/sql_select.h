@@ -34,6 +34,7 @@
 #include "mem_root_array.h"
 #include "sql_executor.h"
 #include "opt_explain_format.h" // for Extra_tag
+#include "my_rdtsc.h"                         /* my_timer_nanoseconds */
 
 #include <functional>
 /**
@@ -521,6 +522,39 @@ typedef struct st_position : public Sql_alloc
 struct st_cache_field;
 class QEP_operation;
 class Filesort;
+class Cond_kernel;
+
+/**
+  What EXPLAIN ANALYZE measures of the execution of a JOIN_TAB.
+
+  A loop is a scan of the table for one row combination of the preceding
+  tables, or for one join buffer when join buffering is used. The rows
+  read from the table and the rows that satisfied its condition are
+  counted over all loops.
+*/
+
+struct Join_tab_stats
+{
+  ulonglong loops;                      ///< Scans of the table
+  ulonglong rows_read;                  ///< Rows read, in all scans
+  ulonglong rows_matched;               ///< Rows which satisfied the condition
+  ulonglong read_time;                  ///< Nanoseconds of reading the rows
+  ulonglong cond_time;                  ///< Nanoseconds of the condition
+  ulonglong sort_merge_passes;          ///< Merge passes of the filesort
+
+  Join_tab_stats()
+    : loops(0), rows_read(0), rows_matched(0), read_time(0), cond_time(0),
+      sort_merge_passes(0)
+  {}
+
+  /// Account for a read of the table which started at 'start'
+  void add_read(ulonglong start, bool found)
+  {
+    read_time+= my_timer_nanoseconds() - start;
+    if (found)
+      rows_read++;
+  }
+};
 
 typedef struct st_join_table : public Sql_alloc
 {
@@ -607,6 +641,13 @@ public:
   READ_RECORD::Setup_func read_first_record;
   Next_select_func next_select;
   READ_RECORD	read_record;
+  /**
+    Kernel that filters the row batches of a full scan of the table with
+    the condition, and the condition it was built for. NULL kernel if the
+    condition has no kernel. @see get_cond_kernel()
+  */
+  Cond_kernel   *cond_kernel;
+  Item          *cond_kernel_cond;
   /* 
     The following two fields are used for a [NOT] IN subquery if it is
     executed by an alternative full table scan when the left operand of
@@ -649,6 +690,12 @@ public:
     E(#records) is in found_records.
   */
   ha_rows       read_time;
+  /**
+    Fraction of the rows that satisfy the "column = constant" conditions on
+    columns that start no index, estimated from the column histograms of
+    the storage engine; negative until it has been computed.
+  */
+  double        histogram_filter;
   /**
     The set of tables that this table depends on. Used for outer join and
     straight join dependencies.
@@ -797,6 +844,9 @@ public:
   /** TRUE <=> only index is going to be read for this table */
   bool use_keyread;
 
+  /** Measured execution of the table, if JOIN::analyzing */
+  Join_tab_stats analyze_stats;
+
   /** Clean up associated table after query execution, including resources */
   void cleanup();
 
@@ -908,6 +958,7 @@ public:
   }
   Item *unified_condition() const;
   bool prepare_scan();
+  Cond_kernel *get_cond_kernel();
   bool use_order() const; ///< Use ordering provided by chosen index?
   bool sort_table();
   bool remove_duplicates();
@@ -937,6 +988,8 @@ st_join_table::st_join_table()
     read_first_record(NULL),
     next_select(NULL),
     read_record(),
+    cond_kernel(NULL),
+    cond_kernel_cond(NULL),
     save_read_first_record(NULL),
     save_read_record(NULL),
     sj_mat_exec(NULL),
@@ -950,6 +1003,7 @@ st_join_table::st_join_table()
     records(0),
     found_records(0),
     read_time(0),
+    histogram_filter(-1.0),
 
     dependent(0),
     key_dependent(0),
@@ -998,7 +1052,8 @@ st_join_table::st_join_table()
     send_records(0),
     having(NULL),
     distinct(false),
-    use_keyread(false)
+    use_keyread(false),
+    analyze_stats()
 {
   /**
     @todo Add constructor to READ_RECORD.
@@ -1149,6 +1204,7 @@ void count_field_types(SELECT_LEX *select_lex, TMP_TABLE_PARAM *param,
                        List<Item> &fields, bool reset_with_sum_func,
                        bool save_sum_fields);
 uint find_shortest_key(TABLE *table, const key_map *usable_keys);
+uint find_covering_key(TABLE *table, const MY_BITMAP *columns);
 
 /* functions from opt_sum.cc */
 bool simple_pred(Item_func *func_item, Item **args, bool *inv_order);
@@ -2065,6 +2065,79 @@ static const char *thread_state_info(THD *tmp)
   }
 }
 
+/**
+  Collect the information of SHOW PROCESSLIST about a thread.
+*/
+class List_process_list : public Do_THD_Impl
+{
+public:
+  List_process_list(THD *client_thd, const char *user,
+                    Mem_root_array<thread_info*, true> *thread_infos,
+                    ulong max_query_length)
+    : m_client_thd(client_thd), m_user(user), m_thread_infos(thread_infos),
+      m_max_query_length(max_query_length)
+  {}
+  virtual void operator()(THD *tmp)
+  {
+    Security_context *tmp_sctx= tmp->security_ctx;
+    struct st_my_thread_var *mysys_var;
+    if ((tmp->vio_ok() || tmp->system_thread) &&
+        (!m_user || (tmp_sctx->user && !strcmp(tmp_sctx->user, m_user))))
+    {
+      thread_info *thd_info= new thread_info;
+
+      thd_info->thread_id=tmp->thread_id;
+      thd_info->user=
+        m_client_thd->strdup(tmp_sctx->user ? tmp_sctx->user :
+                             (tmp->system_thread ?
+                              "system user" : "unauthenticated user"));
+      if (tmp->peer_port && (tmp_sctx->get_host()->length() ||
+          tmp_sctx->get_ip()->length()) &&
+          m_client_thd->security_ctx->host_or_ip[0])
+      {
+        if ((thd_info->host=
+             (char*) m_client_thd->alloc(LIST_PROCESS_HOST_LEN+1)))
+          my_snprintf((char *) thd_info->host, LIST_PROCESS_HOST_LEN,
+                      "%s:%u", tmp_sctx->host_or_ip, tmp->peer_port);
+      }
+      else
+        thd_info->host= m_client_thd->strdup(tmp_sctx->host_or_ip[0] ?
+                                             tmp_sctx->host_or_ip :
+                                             tmp_sctx->get_host()->length() ?
+                                             tmp_sctx->get_host()->ptr() : "");
+      if ((thd_info->db=tmp->db))             // Safe test
+        thd_info->db=m_client_thd->strdup(thd_info->db);
+      thd_info->command=(int) tmp->get_command();
+      mysql_mutex_lock(&tmp->LOCK_thd_data);
+      if ((mysys_var= tmp->mysys_var))
+        mysql_mutex_lock(&mysys_var->mutex);
+      thd_info->proc_info= (char*) (tmp->killed == THD::KILL_CONNECTION?
+                                    "Killed" : 0);
+      thd_info->state_info= thread_state_info(tmp);
+      if (mysys_var)
+        mysql_mutex_unlock(&mysys_var->mutex);
+
+      /* Lock THD mutex that protects its data when looking at it. */
+      if (tmp->query())
+      {
+        uint length= min<uint>(m_max_query_length, tmp->query_length());
+        char *q= m_client_thd->strmake(tmp->query(),length);
+        /* Safety: in case strmake failed, we set length to 0. */
+        thd_info->query_string=
+          CSET_STRING(q, q ? length : 0, tmp->query_charset());
+      }
+      mysql_mutex_unlock(&tmp->LOCK_thd_data);
+      thd_info->start_time= tmp->start_time.tv_sec;
+      m_thread_infos->push_back(thd_info);
+    }
+  }
+private:
+  THD *m_client_thd;
+  const char *m_user;
+  Mem_root_array<thread_info*, true> *m_thread_infos;
+  ulong m_max_query_length;
+};
+
 void mysqld_list_processes(THD *thd,const char *user, bool verbose)
 {
   Item *field;
@@ -2093,62 +2166,10 @@ void mysqld_list_processes(THD *thd,const char *user, bool verbose)
 
   if (!thd->killed)
   {
-    mysql_mutex_lock(&LOCK_thread_count);
+    List_process_list list_process_list(thd, user, &thread_infos,
+                                        max_query_length);
     thread_infos.reserve(get_thread_count());
-    Thread_iterator it= global_thread_list_begin();
-    Thread_iterator end= global_thread_list_end();
-    for (; it != end; ++it)
-    {
-      THD *tmp= *it;
-      Security_context *tmp_sctx= tmp->security_ctx;
-      struct st_my_thread_var *mysys_var;
-      if ((tmp->vio_ok() || tmp->system_thread) &&
-          (!user || (tmp_sctx->user && !strcmp(tmp_sctx->user, user))))
-      {
-        thread_info *thd_info= new thread_info;
-
-        thd_info->thread_id=tmp->thread_id;
-        thd_info->user= thd->strdup(tmp_sctx->user ? tmp_sctx->user :
-                                    (tmp->system_thread ?
-                                     "system user" : "unauthenticated user"));
-	if (tmp->peer_port && (tmp_sctx->get_host()->length() || 
-            tmp_sctx->get_ip()->length()) && thd->security_ctx->host_or_ip[0])
-	{
-	  if ((thd_info->host= (char*) thd->alloc(LIST_PROCESS_HOST_LEN+1)))
-	    my_snprintf((char *) thd_info->host, LIST_PROCESS_HOST_LEN,
-			"%s:%u", tmp_sctx->host_or_ip, tmp->peer_port);
-	}
-	else
-	  thd_info->host= thd->strdup(tmp_sctx->host_or_ip[0] ? 
-                                      tmp_sctx->host_or_ip : 
-                                      tmp_sctx->get_host()->length() ?
-                                      tmp_sctx->get_host()->ptr() : "");
-        if ((thd_info->db=tmp->db))             // Safe test
-          thd_info->db=thd->strdup(thd_info->db);
-        thd_info->command=(int) tmp->get_command();
-        mysql_mutex_lock(&tmp->LOCK_thd_data);
-        if ((mysys_var= tmp->mysys_var))
-          mysql_mutex_lock(&mysys_var->mutex);
-        thd_info->proc_info= (char*) (tmp->killed == THD::KILL_CONNECTION? "Killed" : 0);
-        thd_info->state_info= thread_state_info(tmp);
-        if (mysys_var)
-          mysql_mutex_unlock(&mysys_var->mutex);
-
-        /* Lock THD mutex that protects its data when looking at it. */
-        if (tmp->query())
-        {
-          uint length= min<uint>(max_query_length, tmp->query_length());
-          char *q= thd->strmake(tmp->query(),length);
-          /* Safety: in case strmake failed, we set length to 0. */
-          thd_info->query_string=
-            CSET_STRING(q, q ? length : 0, tmp->query_charset());
-        }
-        mysql_mutex_unlock(&tmp->LOCK_thd_data);
-        thd_info->start_time= tmp->start_time.tv_sec;
-        thread_infos.push_back(thd_info);
-      }
-    }
-    mysql_mutex_unlock(&LOCK_thread_count);
+    do_for_all_thd(&list_process_list);
   }
 
   // Return list sorted by thread_id.
@@ -2181,10 +2202,111 @@ void mysqld_list_processes(THD *thd,const char *user, bool verbose)
   DBUG_VOID_RETURN;
 }
 
+/**
+  Store a row of INFORMATION_SCHEMA.PROCESSLIST about a thread. Once
+  storing a row has failed, the remaining threads are skipped.
+*/
+class Fill_process_list : public Do_THD_Impl
+{
+public:
+  Fill_process_list(THD *client_thd, TABLE *table, const char *user,
+                    time_t now)
+    : m_client_thd(client_thd), m_table(table), m_user(user), m_now(now),
+      m_failed(false)
+  {}
+  virtual void operator()(THD *tmp)
+  {
+    TABLE *table= m_table;
+    CHARSET_INFO *cs= system_charset_info;
+    Security_context *tmp_sctx= tmp->security_ctx;
+    struct st_my_thread_var *mysys_var;
+    const char *val;
+
+    if (m_failed)
+      return;
+
+    if ((!tmp->vio_ok() && !tmp->system_thread) ||
+        (m_user && (!tmp_sctx->user || strcmp(tmp_sctx->user, m_user))))
+      return;
+
+    restore_record(table, s->default_values);
+    /* ID */
+
+    table->field[0]->store((ulonglong) tmp->thread_id, TRUE);
+    /* USER */
+    val= tmp_sctx->user ? tmp_sctx->user :
+          (tmp->system_thread ? "system user" : "unauthenticated user");
+    table->field[1]->store(val, strlen(val), cs);
+    /* HOST */
+    if (tmp->peer_port && (tmp_sctx->get_host()->length() ||
+        tmp_sctx->get_ip()->length()) &&
+        m_client_thd->security_ctx->host_or_ip[0])
+    {
+      char host[LIST_PROCESS_HOST_LEN + 1];
+      my_snprintf(host, LIST_PROCESS_HOST_LEN, "%s:%u",
+                  tmp_sctx->host_or_ip, tmp->peer_port);
+      table->field[2]->store(host, strlen(host), cs);
+    }
+    else
+      table->field[2]->store(tmp_sctx->host_or_ip,
+                             strlen(tmp_sctx->host_or_ip), cs);
+    /* DB */
+    if (tmp->db)
+    {
+      table->field[3]->store(tmp->db, strlen(tmp->db), cs);
+      table->field[3]->set_notnull();
+    }
+
+    mysql_mutex_lock(&tmp->LOCK_thd_data);
+    if ((mysys_var= tmp->mysys_var))
+      mysql_mutex_lock(&mysys_var->mutex);
+    /* COMMAND */
+    if ((val= (char *) (tmp->killed == THD::KILL_CONNECTION? "Killed" : 0)))
+      table->field[4]->store(val, strlen(val), cs);
+    else
+      table->field[4]->store(command_name[tmp->get_command()].str,
+                             command_name[tmp->get_command()].length, cs);
+    /* MYSQL_TIME */
+    table->field[5]->store((longlong)(tmp->start_time.tv_sec ?
+                                    m_now - tmp->start_time.tv_sec : 0), FALSE);
+    /* STATE */
+    if ((val= thread_state_info(tmp)))
+    {
+      table->field[6]->store(val, strlen(val), cs);
+      table->field[6]->set_notnull();
+    }
+
+    if (mysys_var)
+      mysql_mutex_unlock(&mysys_var->mutex);
+    mysql_mutex_unlock(&tmp->LOCK_thd_data);
+
+    /* INFO */
+    /* Lock THD mutex that protects its data when looking at it. */
+    mysql_mutex_lock(&tmp->LOCK_thd_data);
+    if (tmp->query())
+    {
+      size_t const width=
+        min<size_t>(PROCESS_LIST_INFO_WIDTH, tmp->query_length());
+      table->field[7]->store(tmp->query(), width, cs);
+      table->field[7]->set_notnull();
+    }
+    mysql_mutex_unlock(&tmp->LOCK_thd_data);
+
+    if (schema_table_store_record(m_client_thd, table))
+      m_failed= true;
+  }
+  bool failed() const { return m_failed; }
+private:
+  THD *m_client_thd;
+  TABLE *m_table;
+  const char *m_user;
+  time_t m_now;
+  bool m_failed;
+};
+
 int fill_schema_processlist(THD* thd, TABLE_LIST* tables, Item* cond)
 {
   TABLE *table= tables->table;
-  CHARSET_INFO *cs= system_charset_info;
   char *user;
   time_t now= my_time(0);
   DBUG_ENTER("fill_process_list");
@@ -2194,89 +2316,10 @@ int fill_schema_processlist(THD* thd, TABLE_LIST* tables, Item* cond)
 
   if (!thd->killed)
   {
-    mysql_mutex_lock(&LOCK_thread_count);
-    Thread_iterator it= global_thread_list_begin();
-    Thread_iterator end= global_thread_list_end();
-    for (; it != end; ++it)
-    {
-      THD* tmp= *it;
-      Security_context *tmp_sctx= tmp->security_ctx;
-      struct st_my_thread_var *mysys_var;
-      const char *val;
-
-      if ((!tmp->vio_ok() && !tmp->system_thread) ||
-          (user && (!tmp_sctx->user || strcmp(tmp_sctx->user, user))))
-        continue;
-
-      restore_record(table, s->default_values);
-      /* ID */
-
-      table->field[0]->store((ulonglong) tmp->thread_id, TRUE);
-      /* USER */
-      val= tmp_sctx->user ? tmp_sctx->user :
-            (tmp->system_thread ? "system user" : "unauthenticated user");
-      table->field[1]->store(val, strlen(val), cs);
-      /* HOST */
-      if (tmp->peer_port && (tmp_sctx->get_host()->length() || 
-          tmp_sctx->get_ip()->length()) && thd->security_ctx->host_or_ip[0])
-      {
-        char host[LIST_PROCESS_HOST_LEN + 1];
-        my_snprintf(host, LIST_PROCESS_HOST_LEN, "%s:%u",
-                    tmp_sctx->host_or_ip, tmp->peer_port);
-        table->field[2]->store(host, strlen(host), cs);
-      }
-      else
-        table->field[2]->store(tmp_sctx->host_or_ip,
-                               strlen(tmp_sctx->host_or_ip), cs);
-      /* DB */
-      if (tmp->db)
-      {
-        table->field[3]->store(tmp->db, strlen(tmp->db), cs);
-        table->field[3]->set_notnull();
-      }
-
-      mysql_mutex_lock(&tmp->LOCK_thd_data);
-      if ((mysys_var= tmp->mysys_var))
-        mysql_mutex_lock(&mysys_var->mutex);
-      /* COMMAND */
-      if ((val= (char *) (tmp->killed == THD::KILL_CONNECTION? "Killed" : 0)))
-        table->field[4]->store(val, strlen(val), cs);
-      else
-        table->field[4]->store(command_name[tmp->get_command()].str,
-                               command_name[tmp->get_command()].length, cs);
-      /* MYSQL_TIME */
-      table->field[5]->store((longlong)(tmp->start_time.tv_sec ?
-                                      now - tmp->start_time.tv_sec : 0), FALSE);
-      /* STATE */
-      if ((val= thread_state_info(tmp)))
-      {
-        table->field[6]->store(val, strlen(val), cs);
-        table->field[6]->set_notnull();
-      }
-
-      if (mysys_var)
-        mysql_mutex_unlock(&mysys_var->mutex);
-      mysql_mutex_unlock(&tmp->LOCK_thd_data);
-
-      /* INFO */
-      /* Lock THD mutex that protects its data when looking at it. */
-      mysql_mutex_lock(&tmp->LOCK_thd_data);
-      if (tmp->query())
-      {
-        size_t const width=
-          min<size_t>(PROCESS_LIST_INFO_WIDTH, tmp->query_length());
-        table->field[7]->store(tmp->query(), width, cs);
-        table->field[7]->set_notnull();
-      }
-      mysql_mutex_unlock(&tmp->LOCK_thd_data);
-
-      if (schema_table_store_record(thd, table))
-      {
-        mysql_mutex_unlock(&LOCK_thread_count);
-        DBUG_RETURN(1);
-      }
-    }
-    mysql_mutex_unlock(&LOCK_thread_count);
+    Fill_process_list fill_process_list(thd, table, user, now);
+    do_for_all_thd(&fill_process_list);
+    if (fill_process_list.failed())
+      DBUG_RETURN(1);
   }
 
   DBUG_RETURN(0);
@@ -2618,10 +2661,12 @@ static bool show_status_array(THD *thd, const char *wild,
           break;
         }
         case SHOW_KEY_CACHE_LONG:
+          update_key_cache_stats(dflt_key_cache);
           value= (char*) dflt_key_cache + (ulong)value;
           end= int10_to_str(*(long*) value, buff, 10);
           break;
         case SHOW_KEY_CACHE_LONGLONG:
+          update_key_cache_stats(dflt_key_cache);
           value= (char*) dflt_key_cache + (ulong)value;
 	  end= longlong10_to_str(*(longlong*) value, buff, 10);
 	  break;
@@ -2652,39 +2697,38 @@ end:
 }
 
 
+/* Add the status of a thread to the sum of calc_sum_of_all_status() */
+
+class Add_status : public Do_THD_Impl
+{
+public:
+  Add_status(STATUS_VAR *value) : m_stat_var(value) {}
+  virtual void operator()(THD *thd)
+  {
+    add_to_status(m_stat_var, &thd->status_var);
+  }
+private:
+  STATUS_VAR *m_stat_var;
+};
+
+
 /* collect status for all running threads */
 
 void calc_sum_of_all_status(STATUS_VAR *to)
 {
   DBUG_ENTER("calc_sum_of_all_status");
 
-  /* take copy of global_thread_list */
-  std::set<THD*> global_thread_list_copy;
-
-  mysql_mutex_lock(&LOCK_thread_count);
-  mysql_mutex_lock(&LOCK_thread_remove);
-  copy_global_thread_list(&global_thread_list_copy);
+  /* Get global values as base */
+  *to= global_status_var;
 
-  /* 
-    Allow inserts to global_thread_list. Newly added thd
-    will not be accounted for summary calculation.
-    removal from global_thread_list is blocked as LOCK_thread_remove
-    mutex is not released yet 
+  /*
+    Add to this status from existing threads. Only the partition being
+    visited is locked: threads of the others come and go meanwhile.
   */
-  mysql_mutex_unlock(&LOCK_thread_count);
-  Thread_iterator it= global_thread_list_copy.begin();
-  Thread_iterator end= global_thread_list_copy.end();
+  Add_status add_status(to);
+  do_for_all_thd(&add_status);
 
-  /* Get global values as base */
-  *to= global_status_var;
-  
-  /* Add to this status from existing threads */
-  for (; it != end; ++it)
-    add_to_status(to, &(*it)->status_var);
-  
   DEBUG_SYNC_C("inside_calc_sum");
-
-  mysql_mutex_unlock(&LOCK_thread_remove);
   DBUG_VOID_RETURN;
 }
 
@@ -3672,6 +3716,54 @@ try_acquire_high_prio_shared_mdl_lock(THD *thd, TABLE_LIST *table,
 }
 
 
+/**
+  Read the definition of a table from its .frm file into a TABLE_SHARE
+  of the caller that is not added to the table definition cache.
+
+  @param[in]      thd          thread handler
+  @param[in]      table_list   the table, with its lock already acquired
+  @param[in]      key          table definition cache key of the table
+  @param[in]      key_length   length of the key
+  @param[out]     path         buffer of FN_REFLEN bytes for the path
+                               of the table, used by the share
+  @param[out]     share        the share to initialize
+
+  @return         Operation status
+    @retval       false        Ok, release the share with free_table_share()
+    @retval       true         Error, the share has been freed
+*/
+
+static bool open_uncached_table_share(THD *thd, TABLE_LIST *table_list,
+                                      const char *key, uint key_length,
+                                      char *path, TABLE_SHARE *share)
+{
+  bool was_truncated= false;
+
+  (void) build_table_filename(path, FN_REFLEN - 1 - reg_ext_length,
+                              table_list->db, table_list->table_name, "", 0,
+                              &was_truncated);
+  if (was_truncated)
+  {
+    my_error(ER_IDENT_CAUSES_TOO_LONG_PATH, MYF(0), FN_REFLEN - 1, path);
+    return true;
+  }
+
+  init_tmp_table_share(thd, share, key, key_length,
+                       table_list->table_name, path);
+  /* It is the definition of a base table, not of a temporary one */
+  share->tmp_table= NO_TMP_TABLE;
+  mysql_mutex_init(key_TABLE_SHARE_LOCK_ha_data,
+                   &share->LOCK_ha_data, MY_MUTEX_INIT_FAST);
+
+  if (open_table_def(thd, share, OPEN_VIEW))
+  {
+    free_table_share(share);
+    return true;
+  }
+  return false;
+}
+
+
 /**
   @brief          Fill I_S table with data from FRM file only
 
@@ -3706,6 +3798,7 @@ static int fill_schema_table_from_frm(THD *thd, TABLE_LIST *tables,
 {
   TABLE *table= tables->table;
   TABLE_SHARE *share;
+  TABLE_SHARE uncached_share;
   TABLE_LIST table_list;
   uint res= 0;
   int not_used;
@@ -3713,6 +3806,7 @@ static int fill_schema_table_from_frm(THD *thd, TABLE_LIST *tables,
   const char *key;
   uint key_length;
   char db_name_buff[NAME_LEN + 1], table_name_buff[NAME_LEN + 1];
+  char path[FN_REFLEN + 1];
 
   memset(&table_list, 0, sizeof(TABLE_LIST));
 
@@ -3798,12 +3892,34 @@ static int fill_schema_table_from_frm(THD *thd, TABLE_LIST *tables,
   key_length= get_table_def_key(&table_list, &key);
   hash_value= my_calc_hash(&table_def_cache, (uchar*) key, key_length);
   mysql_mutex_lock(&LOCK_open);
-  share= get_table_share(thd, &table_list, key,
-                         key_length, OPEN_VIEW, &not_used, hash_value);
-  if (!share)
+  if (my_hash_search_using_hash_value(&table_def_cache, hash_value,
+                                      (uchar*) key, key_length))
   {
-    res= 0;
-    goto end_unlock;
+    share= get_table_share(thd, &table_list, key,
+                           key_length, OPEN_VIEW, &not_used, hash_value);
+    if (!share)
+    {
+      res= 0;
+      goto end_unlock;
+    }
+  }
+  else
+  {
+    /*
+      The table is not in use. Read its definition without adding it to
+      the table definition cache, where a scan of many tables would push
+      out the definitions of the tables that are in use, and without
+      holding LOCK_open, which other connections need to open any table.
+      The metadata lock protects the .frm file from concurrent DDL.
+    */
+    mysql_mutex_unlock(&LOCK_open);
+    if (open_uncached_table_share(thd, &table_list, key, key_length,
+                                  path, &uncached_share))
+    {
+      res= 0;
+      goto end;
+    }
+    share= &uncached_share;
   }
 
   if (share->is_view)
@@ -3856,6 +3972,11 @@ static int fill_schema_table_from_frm(THD *thd, TABLE_LIST *tables,
   }
 
 end_share:
+  if (share == &uncached_share)
+  {
+    free_table_share(share);
+    goto end;
+  }
   release_table_share(share);
 
 end_unlock:
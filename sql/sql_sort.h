@@ -32,12 +32,19 @@ struct TABLE;
 
 #define MERGEBUFF		7
 #define MERGEBUFF2		15
+/*
+  A merge pass gives each run at least this much of the sort buffer, so
+  that the runs are read in chunks large enough not to be seek-bound,
+  but merges as many runs as fit, see merge_fanin().
+*/
+#define MERGE_RUN_BUFFER_SIZE	(16U * 1024U)
+#define MERGEBUFF_MAX		4096
 
 /*
    The structure SORT_ADDON_FIELD describes a fixed layout
    for field values appended to sorted values in records to be sorted
    in the sort buffer.
-   Only fixed layout is supported now.
+   In the sort buffer the layout is fixed.
    Null bit maps for the appended values is placed before the values 
    themselves. Offsets are from the last sorted field, that is from the
    record referefence, which is still last component of sorted records.
@@ -47,6 +54,15 @@ struct TABLE;
    from a temporary file/buffer. As the reading procedures are beyond the
    scope of the 'filesort' code the values have to be retrieved via
    the callback function 'unpack_addon_fields'.
+
+   If Sort_param::using_packed_addons is set, the records written to the
+   temporary files are packed: the null bit maps are preceded by the
+   length of the packed addon part (Sort_param::size_of_addon_length
+   bytes, counting itself), and CHAR and VARCHAR values take only the
+   bytes of their actual length. Null values are not stored.
+   The records are expanded to the fixed layout when they are read back
+   into the sort buffer for merging, and the final result file holds
+   packed addon parts, read by 'unpack_packed_addon_fields'.
 */
 
 typedef struct st_sort_addon_field {  /* Sort addon packed field */
@@ -87,11 +103,18 @@ public:
   SORT_ADDON_FIELD *addon_field; // Descriptors for companion fields.
   uchar *unique_buff;
   bool not_killable;
+  bool using_packed_addons;   // Addon fields are packed in the files.
+  uint sort_threads;          // Max threads sorting the sort buffer.
+  uint keyread_key;           // Covering index to read, or MAX_KEY.
   char* tmp_buffer;
+  uchar *packed_rec;          // For packing a record to be written.
   // The fields below are used only by Unique class.
   qsort2_cmp compare;
   BUFFPEK_COMPARE_CONTEXT cmp_context;
 
+  /// Bytes of the length stored in front of packed addon fields.
+  static const uint size_of_addon_length= 2;
+
   Sort_param()
   {
     memset(this, 0, sizeof(*this));
@@ -800,9 +800,12 @@ update_hidden:
   *blob_field= 0;				// End marker
   share->fields= field_count;
 
-  /* If result table is small; use a heap */
+  /*
+    If result table is small; use a heap. Heap stores BLOB values but
+    cannot index them, so keys over them need MyISAM.
+  */
   /* future: storage engine selection can be made dynamic? */
-  if (blob_count || using_unique_constraint
+  if ((blob_count && (group || distinct)) || using_unique_constraint
       || (thd->variables.big_tables && !(select_options & SELECT_SMALL_RESULT))
       || (select_options & TMP_TABLE_FORCE_MYISAM))
   {
@@ -985,7 +988,7 @@ update_hidden:
     field->table_name= &table->alias;
   }
 
-  param->copy_field_end=copy;
+  param->copy_field_end= merge_copy_fields(param->copy_field, copy);
   param->recinfo=recinfo;
   store_record(table,s->default_values);        // Make empty default record
 
@@ -1613,6 +1616,19 @@ bool open_tmp_table(TABLE *table)
   }
   (void) table->file->extra(HA_EXTRA_QUICK);		/* Faster */
 
+  /*
+    A transactional engine needs its transaction for the statement to be
+    registered before the table can be used.
+  */
+  if (table->s->db_type() == innodb_hton &&
+      (error= table->file->ha_external_lock(table->in_use, F_RDLCK)))
+  {
+    table->file->print_error(error, MYF(0));
+    (void) table->file->ha_close();
+    table->db_stat= 0;
+    return true;
+  }
+
   table->set_created();
 
   return false;
@@ -1791,6 +1807,8 @@ void trace_tmp_table(Opt_trace_context *trace, const TABLE *table)
     else 
       trace_tmp.add_alnum("record_format", "fixed");
   }
+  else if (table->s->db_type() == innodb_hton)
+    trace_tmp.add_alnum("location", "disk (InnoDB)");
   else
   {
     DBUG_ASSERT(table->s->db_type() == heap_hton);
@@ -1863,6 +1881,8 @@ free_tmp_table(THD *thd, TABLE *entry)
 
   if (entry->is_created())
   {
+    if (entry->file->get_lock_type() != F_UNLCK)
+      entry->file->ha_external_lock(thd, F_UNLCK);
     if (entry->db_stat)
       entry->file->ha_drop_table(entry->s->table_name.str);
     else
@@ -1888,6 +1908,85 @@ free_tmp_table(THD *thd, TABLE *entry)
   DBUG_VOID_RETURN;
 }
 
+/**
+  Create an InnoDB table for the rows of a MEMORY table that got full, if
+  internal_tmp_disk_storage_engine=INNODB.
+
+  InnoDB looks up the columns of an index by name and cannot represent a
+  unique constraint, so such tables, like those InnoDB fails to create,
+  are left to MyISAM. Errors are not reported in that case.
+
+  @param thd    THD reference
+  @param table  Copy of the MEMORY table, with its own share
+
+  @return true if the table was created, false if MyISAM is to be used
+*/
+
+static bool create_innodb_tmp_table(THD *thd, TABLE *table)
+{
+  TABLE_SHARE *share= table->s;
+  DBUG_ENTER("create_innodb_tmp_table");
+
+  if (internal_tmp_disk_storage_engine != TMP_TABLE_INNODB ||
+      innodb_hton == NULL || !ha_storage_engine_is_enabled(innodb_hton) ||
+      share->uniques)
+    DBUG_RETURN(false);
+
+  for (Field **field= table->field; *field; field++)
+  {
+    if ((*field)->field_name == NULL)
+      DBUG_RETURN(false);
+    for (Field **prev= table->field; prev != field; prev++)
+      if (!my_strcasecmp(system_charset_info, (*field)->field_name,
+                         (*prev)->field_name))
+        DBUG_RETURN(false);
+  }
+
+  share->db_plugin= ha_lock_engine(thd, innodb_hton);
+  handler *file= get_new_handler(share, &table->mem_root, innodb_hton);
+  if (file == NULL)
+    DBUG_RETURN(false);
+  if (file->set_ha_share_ref(&share->ha_share))
+    goto err;
+
+  if (share->keys)
+  {
+    KEY *keyinfo= share->key_info;
+    if (share->keys > file->max_keys() ||
+        keyinfo->key_length > file->max_key_length() ||
+        keyinfo->user_defined_key_parts > file->max_key_parts())
+      goto err;
+    for (uint i= 0; i < keyinfo->user_defined_key_parts; i++)
+      if (keyinfo->key_part[i].length > file->max_key_part_length())
+        goto err;
+  }
+
+  {
+    HA_CREATE_INFO create_info;
+    memset(&create_info, 0, sizeof(create_info));
+    create_info.db_type= innodb_hton;
+    create_info.row_type= ROW_TYPE_DEFAULT;
+    create_info.options= HA_LEX_CREATE_TMP_TABLE |
+                         HA_LEX_CREATE_INTERNAL_TMP_TABLE;
+
+    Dummy_error_handler error_handler;
+    thd->push_internal_handler(&error_handler);
+    int error= file->ha_create(share->table_name.str, table, &create_info);
+    thd->pop_internal_handler();
+    if (error)
+      goto err;
+  }
+
+  table->file= file;
+  thd->inc_status_created_tmp_disk_tables();
+  DBUG_RETURN(true);
+
+err:
+  delete file;
+  DBUG_RETURN(false);
+}
+
+
 /**
   If a MEMORY table gets full, create a disk-based table and copy all rows
   to this.
@@ -1908,7 +2007,9 @@ free_tmp_table(THD *thd, TABLE *entry)
     will be handled, all other errors cause a fatal error to be thrown.
     The function creates a disk-based temporary table, copies all records
     from the MEMORY table into this new table, deletes the old table and
-    switches to use the new table within the table handle.
+    switches to use the new table within the table handle. The new table
+    is created in InnoDB if internal_tmp_disk_storage_engine=INNODB and
+    InnoDB can represent it, otherwise in MyISAM.
     The function uses table->record[1] as a temporary buffer while copying.
 
     The function assumes that table->record[0] contains the row that caused
@@ -1950,24 +2051,25 @@ bool create_myisam_from_heap(THD *thd, TABLE *table,
   share= *table->s;
   share.ha_share= NULL;
   new_table.s= &share;
-  new_table.s->db_plugin= ha_lock_engine(thd, myisam_hton);
-  if (!(new_table.file= get_new_handler(&share, &new_table.mem_root,
-                                        new_table.s->db_type())))
-    DBUG_RETURN(1);				// End of memory
-  if (new_table.file->set_ha_share_ref(&share.ha_share))
-  {
-    delete new_table.file;
-    DBUG_RETURN(1);
-  }
   save_proc_info=thd->proc_info;
   THD_STAGE_INFO(thd, stage_converting_heap_to_myisam);
 
-  if (create_myisam_tmp_table(&new_table, table->s->key_info,
-                              start_recinfo, recinfo,
-			      (thd->lex->select_lex->options |
-                               thd->variables.option_bits),
-                              thd->variables.big_tables))
-    goto err2;
+  if (!create_innodb_tmp_table(thd, &new_table))
+  {
+    new_table.s->db_plugin= ha_lock_engine(thd, myisam_hton);
+    if (!(new_table.file= get_new_handler(&share, &new_table.mem_root,
+                                          new_table.s->db_type())))
+      goto err2;                                // End of memory
+    if (new_table.file->set_ha_share_ref(&share.ha_share))
+      goto err2;
+
+    if (create_myisam_tmp_table(&new_table, table->s->key_info,
+                                start_recinfo, recinfo,
+                                (thd->lex->select_lex->options |
+                                 thd->variables.option_bits),
+                                thd->variables.big_tables))
+      goto err2;
+  }
   if (open_tmp_table(&new_table))
     goto err1;
 
@@ -2067,6 +2169,8 @@ bool create_myisam_from_heap(THD *thd, TABLE *table,
   }
   if (table->file->inited)
     (void) table->file->ha_rnd_end();
+  if (new_table.file->get_lock_type() != F_UNLCK)
+    (void) new_table.file->ha_external_lock(thd, F_UNLCK);
   (void) new_table.file->ha_close();
  err1:
   new_table.file->ha_delete_table(new_table.s->table_name.str);
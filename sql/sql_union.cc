@@ -221,6 +221,21 @@ bool select_union::send_eof()
 }
 
 
+bool select_union_direct::send_data(List<Item> &values)
+{
+  if (unit->offset_limit_cnt)
+  {						// using limit offset,count
+    unit->offset_limit_cnt--;
+    return false;
+  }
+  fill_record(thd, table->field, values, 1, NULL, NULL);
+  if (thd->is_error())
+    return true;
+  sent_rows++;
+  return result->send_data(unit->item_list);
+}
+
+
 bool select_union::flush()
 {
   int error;
@@ -425,9 +440,28 @@ bool st_select_lex_unit::prepare(THD *thd_arg, select_result *sel_result,
 
   /* Global option */
 
+  /*
+    The rows of a top-level UNION ALL without global ORDER BY or LIMIT can
+    be sent to the client in the order the query blocks produce them. The
+    temporary table is still created, empty, for the result of
+    fake_select_lex to refer to.
+  */
+  union_streamed= is_union() && fake_select_lex && !union_distinct &&
+    this == thd_arg->lex->unit &&
+    thd_arg->lex->sql_command == SQLCOM_SELECT &&
+    !found_rows_for_union &&
+    !fake_select_lex->order_list.elements &&
+    !fake_select_lex->explicit_limit &&
+    thd_arg->variables.select_limit == HA_POS_ERROR &&
+    thd_arg->optimizer_switch_flag(OPTIMIZER_SWITCH_UNION_ALL_STREAMING);
+
   if (is_union_select)
   {
-    if (!(tmp_result= union_result= new select_union))
+    if (union_streamed)
+      tmp_result= union_result= new select_union_direct(sel_result);
+    else
+      tmp_result= union_result= new select_union;
+    if (!union_result)
       goto err;
   }
   else
@@ -792,6 +826,15 @@ bool st_select_lex_unit::exec()
       }
     }
 
+    if (union_streamed &&
+        result->send_result_set_metadata(item_list,
+                                         Protocol::SEND_NUM_ROWS |
+                                         Protocol::SEND_EOF))
+    {
+      thd->lex->set_current_select(lex_select_save);
+      DBUG_RETURN(true);
+    }
+
     for (SELECT_LEX *sl= first_select(); sl; sl= sl->next_select())
     {
       ha_rows records_at_start= 0;
@@ -865,6 +908,21 @@ bool st_select_lex_unit::exec()
     }
   }
 
+  if (union_streamed)
+  {
+    /* The rows have been sent to 'result' by the query blocks */
+    if (!saved_error && !thd->is_fatal_error)
+    {
+      saved_error= result->send_eof();
+      thd->limit_found_rows=
+        static_cast<select_union_direct*>(union_result)->sent_rows;
+      thd->inc_examined_row_count(examined_rows);
+    }
+    fake_select_lex->table_list.empty();
+    thd->lex->set_current_select(lex_select_save);
+    DBUG_RETURN(saved_error);
+  }
+
   if (!saved_error && !thd->is_fatal_error)
   {
     /* Send result to 'result' */
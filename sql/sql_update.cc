@@ -353,6 +353,13 @@ bool mysql_update(THD *thd,
       my_ok(thd);
       DBUG_RETURN(0);
     }
+    /*
+      prune_partitions() does not prune locks if the partitioning fields
+      are updated, try to find the single partition all rows move to.
+    */
+    if (!thd->lex->is_query_tables_locked() &&
+        partition_key_modified(table, table->write_set))
+      table->part_info->prune_update_lock_partitions(fields, values, update);
   }
 #endif
   if (lock_tables(thd, table_list, thd->lex->table_count, 0))
@@ -2312,7 +2319,7 @@ int multi_update::do_updates()
       Item_field *item= (Item_field* ) field_it++;
       (copy_field_ptr++)->set(item->field, *field, 0);
     }
-    copy_field_end=copy_field_ptr;
+    copy_field_end= merge_copy_fields(copy_field, copy_field_ptr);
 
     if ((local_error = tmp_table->file->ha_rnd_init(1)))
     {
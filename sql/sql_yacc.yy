@@ -1168,6 +1168,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, YYLTYPE **c, ulong *yystacksize);
 %token  GROUP_CONCAT_SYM
 %token  GT_SYM                        /* OPERATOR */
 %token  HANDLER_SYM
+%token  HARDWARE_SYM
 %token  HASH_SYM
 %token  HAVING                        /* SQL-2003-R */
 %token  HELP_SYM
@@ -1792,7 +1793,7 @@ bool my_yyoverflow(short **a, YYSTYPE **b, YYLTYPE **c, ulong *yystacksize);
         precision subselect_start opt_and charset
         subselect_end select_var_list select_var_list_init help 
         field_length opt_field_length
-        opt_extended_describe
+        opt_extended_describe opt_explain_format explain_format
         prepare prepare_src execute deallocate
         statement sp_suid
         sp_c_chistics sp_a_chistics sp_chistic sp_c_chistic xa
@@ -12345,6 +12346,10 @@ profile_def:
     {
       Lex->profile_options|= PROFILE_SOURCE;
     }
+  | HARDWARE_SYM
+    {
+      Lex->profile_options|= PROFILE_HARDWARE;
+    }
   | ALL
     {
       Lex->profile_options|= PROFILE_ALL;
@@ -12737,6 +12742,15 @@ describe:
             Lex->describe|= DESCRIBE_NORMAL;
           }
           explanable_command
+          {
+            if ((Lex->describe & DESCRIBE_ANALYZE) &&
+                Lex->sql_command != SQLCOM_SELECT)
+            {
+              my_error(ER_NOT_SUPPORTED_YET, MYF(0),
+                       "EXPLAIN ANALYZE of statements other than SELECT");
+              MYSQL_YYABORT;
+            }
+          }
         ;
 
 explanable_command:
@@ -12784,7 +12798,24 @@ opt_extended_describe:
               MYSQL_YYABORT;
             Lex->describe|= DESCRIBE_PARTITIONS;
           }
-        | FORMAT_SYM EQ ident_or_text
+        | explain_format
+        | ANALYZE_SYM opt_explain_format
+          {
+            Lex->describe|= DESCRIBE_ANALYZE;
+          }
+        ;
+
+opt_explain_format:
+          /* empty */
+          {
+            if ((Lex->explain_format= new Explain_format_traditional) == NULL)
+              MYSQL_YYABORT;
+          }
+        | explain_format
+        ;
+
+explain_format:
+          FORMAT_SYM EQ ident_or_text
           {
             if (!my_strcasecmp(system_charset_info, $3.str, "JSON"))
             {
@@ -14189,6 +14220,7 @@ keyword_sp:
         | GET_FORMAT               {}
         | GRANTS                   {}
         | GLOBAL_SYM               {}
+        | HARDWARE_SYM             {}
         | HASH_SYM                 {}
         | HOSTS_SYM                {}
         | HOUR_SYM                 {}
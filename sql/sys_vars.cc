@@ -64,6 +64,7 @@
 #include "sp_head.h" // SP_PSI_STATEMENT_INFO_COUNT 
 
 #include "log_event.h"
+#include "my_perf_counters.h"
 #ifdef WITH_PERFSCHEMA_STORAGE_ENGINE
 #include "../storage/perfschema/pfs_server.h"
 #endif /* WITH_PERFSCHEMA_STORAGE_ENGINE */
@@ -541,6 +542,15 @@ static Sys_var_ulong Sys_pfs_max_memory_classes(
        DEFAULT(PFS_MAX_MEMORY_CLASS),
        BLOCK_SIZE(1), PFS_TRAILING_PROPERTIES);
 
+static Sys_var_ulong Sys_pfs_cpu_sample_interval(
+       "performance_schema_cpu_sample_interval",
+       "Interval between two samples of the running threads,"
+         " in microseconds of CPU time. Use 0 to disable.",
+       READ_ONLY GLOBAL_VAR(pfs_param.m_cpu_sample_interval),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1000000),
+       DEFAULT(0),
+       BLOCK_SIZE(1), PFS_TRAILING_PROPERTIES);
+
 static Sys_var_long Sys_pfs_digest_size(
        "performance_schema_digests_size",
        "Size of the statement digest."
@@ -645,6 +655,37 @@ static Sys_var_ulong Sys_binlog_stmt_cache_size(
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_binlog_stmt_cache_size));
 
+static Sys_var_ulong Sys_binlog_cache_max_memory_size(
+       "binlog_cache_max_memory_size", "The transactional and statement "
+       "caches for the binary log grow in memory up to this size before "
+       "they are written to a temporary file, but never beyond "
+       "max_binlog_cache_size or max_binlog_stmt_cache_size. The memory "
+       "is given back at the end of the transaction. 0 writes to the "
+       "temporary file as soon as binlog_cache_size or "
+       "binlog_stmt_cache_size is exceeded",
+       GLOBAL_VAR(binlog_cache_max_memory_size),
+       CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(0), BLOCK_SIZE(IO_SIZE));
+
+static Sys_var_ulong Sys_binlog_group_commit_sync_delay(
+       "binlog_group_commit_sync_delay",
+       "Upper limit, in microseconds, of the time the binary log group "
+       "commit waits before syncing the binary log, so that more "
+       "transactions share one sync. The wait follows the observed sync "
+       "time and transaction arrival rate, and is only made when a sync "
+       "is due. 0 disables the wait",
+       GLOBAL_VAR(opt_binlog_group_commit_sync_delay),
+       CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1000000), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_binlog_group_commit_sync_no_delay_count(
+       "binlog_group_commit_sync_no_delay_count",
+       "The number of transactions waiting to be synced that ends the "
+       "wait of binlog_group_commit_sync_delay early. 0 means no limit",
+       GLOBAL_VAR(opt_binlog_group_commit_sync_no_delay_count),
+       CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 100000), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_int32 Sys_binlog_max_flush_queue_time(
        "binlog_max_flush_queue_time",
        "The maximum time that the binary log group commit will keep reading"
@@ -1001,6 +1042,27 @@ static Sys_var_mybool Sys_binlog_order_commits(
        GLOBAL_VAR(opt_binlog_order_commits),
        CMD_LINE(OPT_ARG), DEFAULT(TRUE));
 
+static const char *binlog_transaction_dependency_tracking_names[]=
+       {"COMMIT_ORDER", "WRITESET", NullS};
+static Sys_var_enum Sys_binlog_transaction_dependency_tracking(
+       "binlog_transaction_dependency_tracking",
+       "Selects how the commit parent of a transaction is computed for the "
+       "logical clock parallel applier on the slave. COMMIT_ORDER uses the "
+       "binary log group commit. WRITESET also lets a transaction join the "
+       "previous commit group when it changes no primary or unique key "
+       "value changed by that group",
+       GLOBAL_VAR(binlog_transaction_dependency_tracking),
+       CMD_LINE(REQUIRED_ARG), binlog_transaction_dependency_tracking_names,
+       DEFAULT(DEPENDENCY_TRACKING_COMMIT_ORDER));
+
+static Sys_var_ulong Sys_binlog_transaction_dependency_history_size(
+       "binlog_transaction_dependency_history_size",
+       "Maximum number of key hashes kept to find the dependencies of a "
+       "transaction when binlog_transaction_dependency_tracking=WRITESET",
+       GLOBAL_VAR(binlog_transaction_dependency_history_size),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 1000000), DEFAULT(25000),
+       BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_bulk_insert_buff_size(
        "bulk_insert_buffer_size", "Size of tree cache used in bulk "
        "insert optimisation. Note that this is a limit per thread!",
@@ -2133,6 +2195,28 @@ static Sys_var_ulong Sys_open_files_limit(
        /* open_files_limit is used as a sizing hint by the performance schema. */
        sys_var::PARSE_EARLY);
 
+static Sys_var_double Sys_optimizer_row_evaluate_cost(
+       "optimizer_row_evaluate_cost",
+       "Cost used by the optimizer for evaluating the condition on a row, "
+       "relative to reading a block from disk",
+       GLOBAL_VAR(opt_row_evaluate_cost), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0.001, 1000), DEFAULT(ROW_EVALUATE_COST_DEFAULT));
+
+static Sys_var_double Sys_optimizer_io_block_read_cost(
+       "optimizer_io_block_read_cost",
+       "Cost used by the optimizer for reading a block of a table from disk",
+       GLOBAL_VAR(opt_io_block_read_cost), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0.001, 1000), DEFAULT(IO_BLOCK_READ_COST_DEFAULT));
+
+static Sys_var_double Sys_optimizer_memory_block_read_cost(
+       "optimizer_memory_block_read_cost",
+       "Cost used by the optimizer for reading a block of a table from the "
+       "memory buffer of the storage engine. Together with "
+       "optimizer_io_block_read_cost it is weighted by the estimated part "
+       "of the table that is in the buffer",
+       GLOBAL_VAR(opt_memory_block_read_cost), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0.001, 1000), DEFAULT(MEMORY_BLOCK_READ_COST_DEFAULT));
+
 /// @todo change to enum
 static Sys_var_ulong Sys_optimizer_prune_level(
        "optimizer_prune_level",
@@ -2162,7 +2246,9 @@ static const char *optimizer_switch_names[]=
   "block_nested_loop", "batched_key_access",
   "materialization", "semijoin", "loosescan", "firstmatch",
   "subquery_materialization_cost_based",
-  "use_index_extensions", "default", NullS
+  "use_index_extensions", "hash_join", "plan_memoization",
+  "star_join_order", "skip_scan", "derived_condition_pushdown",
+  "union_all_streaming", "hash_aggregation", "default", NullS
 };
 static Sys_var_flagset Sys_optimizer_switch(
        "optimizer_switch",
@@ -2173,6 +2259,8 @@ static Sys_var_flagset Sys_optimizer_switch(
        ", materialization, semijoin, loosescan, firstmatch,"
        " subquery_materialization_cost_based"
        ", block_nested_loop, batched_key_access, use_index_extensions"
+       ", hash_join, plan_memoization, star_join_order, skip_scan"
+       ", derived_condition_pushdown, union_all_streaming, hash_aggregation"
        "} and val is one of {on, off, default}",
        SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
        optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT),
@@ -2279,6 +2367,14 @@ static Sys_var_uint Sys_protocol_version(
        READ_ONLY GLOBAL_VAR(protocol_version), NO_CMD_LINE,
        VALID_RANGE(0, ~0), DEFAULT(PROTOCOL_VERSION), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_protocol_compression_level(
+       "protocol_compression_level",
+       "The compression level, from 1 (fastest) to 9 (best), of the packets "
+       "sent to clients that use the compressed protocol and do not request "
+       "a level",
+       GLOBAL_VAR(opt_protocol_compression_level), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 9), DEFAULT(6), BLOCK_SIZE(1));
+
 static Sys_var_proxy_user Sys_proxy_user(
        "proxy_user", "The proxy user account name used when logging in",
        IN_SYSTEM_CHARSET);
@@ -2415,6 +2511,15 @@ static Sys_var_ulong Sys_range_alloc_block_size(
        VALID_RANGE(RANGE_ALLOC_BLOCK_SIZE, ULONG_MAX),
        DEFAULT(RANGE_ALLOC_BLOCK_SIZE), BLOCK_SIZE(1024));
 
+static Sys_var_ulong Sys_range_optimizer_max_mem_size(
+       "range_optimizer_max_mem_size",
+       "Maximum amount of memory used by the range optimizer for the "
+       "analysis of a table. When it is exceeded, the conditions that "
+       "are not analyzed yet are not used for range access. "
+       "If set to 0, there is no limit.",
+       SESSION_VAR(range_optimizer_max_mem_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(1536000), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_multi_range_count(
        "multi_range_count",
        "Number of key ranges to request at once. "
@@ -2450,6 +2555,18 @@ static Sys_var_ulong Sys_query_prealloc_size(
        BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_thd_mem_root));
 
+static Sys_var_ulong Sys_query_alloc_keep_size(
+       "query_alloc_keep_size",
+       "Upper limit for the memory of query parsing and execution "
+       "blocks, besides query_prealloc_size, which are kept for "
+       "reuse between statements. The memory kept follows the peak "
+       "usage of recent statements. 0 frees all blocks after each "
+       "statement",
+       SESSION_VAR(query_alloc_keep_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(QUERY_ALLOC_KEEP_SIZE),
+       BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(0));
+
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
 static Sys_var_mybool Sys_shared_memory(
        "shared_memory", "Enable the shared memory",
@@ -2531,18 +2648,65 @@ static Sys_var_ulong Sys_trans_prealloc_size(
        BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_trans_mem_root));
 
+static Sys_var_ulong Sys_thd_cache_size(
+       "thd_cache_size",
+       "How many blocks of the memory of deleted THD objects we should "
+       "keep in a cache for the THD objects of new connections",
+       GLOBAL_VAR(thd_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 16384), DEFAULT(16), BLOCK_SIZE(1));
+
 #ifndef EMBEDDED_LIBRARY
 static const char *thread_handling_names[]=
 {
-  "one-thread-per-connection", "no-threads", "loaded-dynamically",
-  0
+  "one-thread-per-connection", "no-threads", "pool-of-threads",
+  "loaded-dynamically", 0
 };
 static Sys_var_enum Sys_thread_handling(
        "thread_handling",
        "Define threads usage for handling queries, one of "
-       "one-thread-per-connection, no-threads, loaded-dynamically"
+       "one-thread-per-connection, no-threads, pool-of-threads, "
+       "loaded-dynamically"
        , READ_ONLY GLOBAL_VAR(Connection_handler_manager::thread_handling),
        CMD_LINE(REQUIRED_ARG), thread_handling_names, DEFAULT(0));
+
+static Sys_var_uint Sys_thread_pool_size(
+       "thread_pool_size",
+       "Number of thread groups of the thread pool. The connections are "
+       "divided between the groups",
+       READ_ONLY GLOBAL_VAR(Thread_pool_connection_handler::group_count),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 128), DEFAULT(16),
+       BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_stall_limit(
+       "thread_pool_stall_limit",
+       "Time in milliseconds after which a thread group of the thread pool "
+       "that makes no progress may handle one connection more",
+       GLOBAL_VAR(Thread_pool_connection_handler::stall_limit),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(10, UINT_MAX), DEFAULT(500),
+       BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_oversubscribe(
+       "thread_pool_oversubscribe",
+       "Number of threads of a thread group of the thread pool that may "
+       "handle connections at a time beyond the first one",
+       GLOBAL_VAR(Thread_pool_connection_handler::oversubscribe),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1000), DEFAULT(3),
+       BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_max_threads(
+       "thread_pool_max_threads",
+       "Maximum number of threads of the thread pool, divided evenly "
+       "between the thread groups",
+       GLOBAL_VAR(Thread_pool_connection_handler::max_threads),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 65536), DEFAULT(500),
+       BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_idle_timeout(
+       "thread_pool_idle_timeout",
+       "Time in seconds after which an idle thread of the thread pool ends",
+       GLOBAL_VAR(Thread_pool_connection_handler::idle_timeout),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, UINT_MAX), DEFAULT(60),
+       BLOCK_SIZE(1));
 #endif // !EMBEDDED_LIBRARY
 
 static bool fix_query_cache_size(sys_var *self, THD *thd, enum_var_type type)
@@ -2588,6 +2752,15 @@ static Sys_var_ulong Sys_query_cache_min_res_unit(
        BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_qcache_min_res_unit));
 
+static Sys_var_uint Sys_query_cache_partitions(
+       "query_cache_partitions",
+       "The number of partitions of the query cache, each with its own "
+       "memory and lock. With more than one partition, queries are not "
+       "removed from the cache when their tables change, but when they "
+       "are next looked up",
+       READ_ONLY GLOBAL_VAR(query_cache_partitions), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
 static const char *query_cache_type_names[]= { "OFF", "ON", "DEMAND", 0 };
 static bool check_query_cache_type(sys_var *self, THD *thd, set_var *var)
 {
@@ -2766,6 +2939,15 @@ static Sys_var_set Slave_rows_search_algorithms(
        DEFAULT(SLAVE_ROWS_INDEX_SCAN | SLAVE_ROWS_TABLE_SCAN),  NO_MUTEX_GUARD,
        NOT_IN_BINLOG, ON_CHECK(check_not_null_not_empty), ON_UPDATE(NULL));
 
+static Sys_var_mybool Sys_slave_rows_prefetch(
+       "slave_rows_prefetch",
+       "Before the slave applies the rows of an update or delete row event "
+       "one by one through an index, pass the keys of all the rows to the "
+       "storage engine, so that it can start reading them in the "
+       "background.",
+       GLOBAL_VAR(opt_slave_rows_prefetch), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 static const char *mts_parallel_type_names[]= {"DATABASE", "LOGICAL_CLOCK", 0};
 static Sys_var_enum Mts_parallel_type(
        "slave_parallel_type",
@@ -2838,6 +3020,13 @@ static Sys_var_ulong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, ULONG_MAX), DEFAULT(DEFAULT_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_sort_threads(
+       "sort_threads",
+       "The maximum number of threads that sort the keys in the sort buffer "
+       "of a filesort. 1 sorts them on the thread of the statement",
+       SESSION_VAR(sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, MAX_SORT_THREADS), DEFAULT(1), BLOCK_SIZE(1));
+
 export sql_mode_t expand_sql_mode(sql_mode_t sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -2988,6 +3177,31 @@ static Sys_var_charptr Sys_ssl_crlpath(
        READ_ONLY GLOBAL_VAR(opt_ssl_crlpath), SSL_OPT(OPT_SSL_CRLPATH),
        IN_FS_CHARSET, DEFAULT(0));
 
+static Sys_var_ulong Sys_ssl_session_cache_size(
+       "ssl_session_cache_size",
+       "The number of SSL sessions the server keeps, so that clients "
+       "reconnecting with the session of an earlier connection skip the "
+       "key exchange. 0 disables the session cache",
+       READ_ONLY GLOBAL_VAR(opt_ssl_session_cache_size),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1024 * 1024), DEFAULT(128),
+       BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_ssl_session_cache_timeout(
+       "ssl_session_cache_timeout",
+       "The number of seconds an SSL session can be resumed. The keys of "
+       "the session tickets are also renewed at this interval",
+       READ_ONLY GLOBAL_VAR(opt_ssl_session_cache_timeout),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 24 * 3600), DEFAULT(300),
+       BLOCK_SIZE(1));
+
+static Sys_var_mybool Sys_ssl_session_tickets(
+       "ssl_session_tickets",
+       "Let clients resume SSL sessions with session tickets, which keep "
+       "the session in the client instead of the session cache. Needs "
+       "OpenSSL",
+       READ_ONLY GLOBAL_VAR(opt_ssl_session_tickets),
+       CMD_LINE(OPT_ARG), DEFAULT(TRUE));
+
 
 // why ENUM and not BOOL ?
 static const char *updatable_views_with_limit_names[]= {"NO", "YES", 0};
@@ -3161,11 +3375,23 @@ static Sys_var_tx_read_only Sys_tx_read_only(
 static Sys_var_ulonglong Sys_tmp_table_size(
        "tmp_table_size",
        "If an internal in-memory temporary table exceeds this size, MySQL "
-       "will automatically convert it to an on-disk MyISAM table",
+       "will automatically convert it to an on-disk table, see "
+       "internal_tmp_disk_storage_engine",
        SESSION_VAR(tmp_table_size), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(1024, (ulonglong)~(intptr)0), DEFAULT(16*1024*1024),
        BLOCK_SIZE(1));
 
+static const char *internal_tmp_disk_storage_engine_names[]=
+  {"MYISAM", "INNODB", 0};
+static Sys_var_enum Sys_internal_tmp_disk_storage_engine(
+       "internal_tmp_disk_storage_engine",
+       "The storage engine of the on-disk tables that internal in-memory "
+       "temporary tables are converted to when they exceed tmp_table_size. "
+       "Possible values are MYISAM, INNODB. Tables that InnoDB cannot "
+       "represent are converted to MyISAM",
+       GLOBAL_VAR(internal_tmp_disk_storage_engine), CMD_LINE(REQUIRED_ARG),
+       internal_tmp_disk_storage_engine_names, DEFAULT(TMP_TABLE_MYISAM));
+
 static Sys_var_mybool Sys_timed_mutexes(
        "timed_mutexes",
        "Specify whether to time mutexes (only InnoDB mutexes are currently "
@@ -3471,6 +3697,15 @@ static Sys_var_ulong Sys_profiling_history_size(
        NOT_IN_BINLOG, ON_CHECK(0), ON_UPDATE(0), DEPRECATED(""));
 #endif
 
+static Sys_var_mybool Sys_hardware_counters(
+       "hardware_counters",
+       "Count the CPU cycles, instructions, last level cache misses and "
+       "branch misses of threads with the hardware performance counters "
+       "of Linux, for SHOW PROFILE HARDWARE and the stage events of the "
+       "Performance Schema",
+       GLOBAL_VAR(my_perf_counters_enabled),
+       CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+
 static Sys_var_harows Sys_select_limit(
        "sql_select_limit",
        "The maximum number of rows to return from SELECT statements",
@@ -3964,6 +4199,27 @@ static Sys_var_set Sys_log_output(
        log_output_names, DEFAULT(LOG_FILE), NO_MUTEX_GUARD, NOT_IN_BINLOG,
        ON_CHECK(check_not_empty_set), ON_UPDATE(fix_log_output));
 
+static Sys_var_ulong Sys_query_log_buffer_size(
+       "query_log_buffer_size",
+       "The size of each of the two buffers in which the entries of the "
+       "slow and general log files are kept until a writer thread of the "
+       "log writes them, or 0 to have sessions write their entries "
+       "themselves",
+       READ_ONLY GLOBAL_VAR(opt_query_log_buffer_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024*1024), DEFAULT(0), BLOCK_SIZE(1024));
+
+static const char *query_log_buffer_full_names[]= { "BLOCK", "DROP", NULL };
+
+static Sys_var_enum Sys_query_log_buffer_full(
+       "query_log_buffer_full",
+       "What a session does with a slow or general log entry when the "
+       "buffer of the log file is full. BLOCK = Wait until the writer "
+       "thread has taken the entries of the buffer. DROP = Do not log the "
+       "entry, and count it in Slow_log_entries_dropped or "
+       "General_log_entries_dropped",
+       GLOBAL_VAR(opt_query_log_buffer_full), CMD_LINE(REQUIRED_ARG),
+       query_log_buffer_full_names, DEFAULT(QUERY_LOG_BUFFER_BLOCK));
+
 #ifdef HAVE_REPLICATION
 static Sys_var_mybool Sys_log_slave_updates(
        "log_slave_updates", "Tells the slave to log the updates from "
@@ -334,13 +334,16 @@ public:
   size_t    addon_length;       /* Length of the buffer */
   struct st_sort_addon_field *addon_field;     /* Pointer to the fields info */
   void    (*unpack)(struct st_sort_addon_field *, uchar *); /* To unpack back */
+  bool      using_packed_addons; /* If io_cache holds packed addon fields */
   uchar     *record_pointers;    /* If sorted in memory */
   ha_rows   found_records;      /* How many records in sort */
+  my_off_t  io_cache_start;     /* Position of the first record in io_cache */
 
-  Filesort_info(): record_pointers(0) {};
+  Filesort_info(): using_packed_addons(false), record_pointers(0),
+    io_cache_start(0) {};
   /** Sort filesort_buffer */
-  void sort_buffer(Sort_param *param, uint count)
-  { filesort_buffer.sort_buffer(param, count); }
+  uint sort_buffer(Sort_param *param, uint count)
+  { return filesort_buffer.sort_buffer(param, count); }
 
   /**
      Accessors for Filesort_buffer (which @c).
@@ -655,7 +658,8 @@ struct TABLE_SHARE
   enum row_type row_type;		/* How rows are stored */
   enum tmp_table_type tmp_table;
 
-  uint ref_count;                       /* How many TABLE objects uses this */
+  /* How many TABLE objects uses this, see the comment for LOCK_open */
+  volatile int32 ref_count;
   uint key_block_size;			/* create key_block_size, if used */
   uint stats_sample_pages;		/* number of pages to sample during
 					stats estimation, if used, otherwise 0. */
@@ -1186,7 +1190,8 @@ public:
   my_bool locked_by_name;
   my_bool fulltext_searched;
   my_bool no_cache;
-  /* To signal that the table is associated with a HANDLER statement */
+  /* To signal that the table is associated with a HANDLER statement or a
+     streaming server side cursor, which lock it while scans are in progress */
   my_bool open_by_handler;
   /*
     To indicate that a non-null value of the auto_increment field
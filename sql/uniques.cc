@@ -28,6 +28,11 @@
 
   The unique entries will be returned in sort order, to ensure that we do the
   deletes in disk order.
+
+  When the keys are equal only if they are the same bytes, the tree can
+  be replaced by a hash set of the keys (use_hash), which costs a hash and
+  usually one comparison per key instead of a descent of the tree. Such a
+  set is sorted before it is written to disk or returned by get().
 */
 
 #include "sql_priv.h"
@@ -56,10 +61,17 @@ int unique_write_to_ptrs(uchar* key, element_count count, Unique *unique)
 }
 
 Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
-	       uint size_arg, ulonglong max_in_memory_size_arg)
+	       uint size_arg, ulonglong max_in_memory_size_arg,
+               bool use_hash_arg)
   :max_in_memory_size(max_in_memory_size_arg),
    record_pointers(NULL),
    size(size_arg),
+   use_hash(use_hash_arg),
+   hash_keys(NULL),
+   hash_index(NULL),
+   hash_count(0),
+   hash_capacity(0),
+   hash_index_mask(0),
    elements(0)
 {
   my_b_clear(&file);
@@ -72,6 +84,17 @@ Unique::Unique(qsort_cmp2 comp_func, void * comp_func_fixed_arg,
   */
   max_elements= (ulong) (max_in_memory_size /
                          ALIGN_SIZE(sizeof(TREE_ELEMENT)+size));
+  if (use_hash)
+  {
+    /*
+      A key takes its size in hash_keys, and up to 4 entries of
+      hash_index, which is kept at most half full.
+    */
+    max_elements= (ulong) MY_MIN(max_in_memory_size /
+                                 (size + 4 * sizeof(uint32)),
+                                 UINT_MAX32 / 4);
+    set_if_bigger(max_elements, 1);
+  }
   (void) open_cached_file(&file, mysql_tmpdir,TEMP_PREFIX, DISK_BUFFER_SIZE,
 		   MYF(MY_WME));
 }
@@ -321,6 +344,8 @@ Unique::~Unique()
   close_cached_file(&file);
   delete_tree(&tree);
   delete_dynamic(&file_ptrs);
+  my_free(hash_keys);
+  my_free(hash_index);
 }
 
 
@@ -328,10 +353,21 @@ Unique::~Unique()
 bool Unique::flush()
 {
   BUFFPEK file_ptr;
-  elements+= tree.elements_in_tree;
-  file_ptr.count=tree.elements_in_tree;
+  elements+= elements_in_tree();
+  file_ptr.count= elements_in_tree();
   file_ptr.file_pos=my_b_tell(&file);
 
+  if (use_hash)
+  {
+    /* The keys of the hash set are written as one sorted run too */
+    hash_sort();
+    if (my_b_write(&file, hash_keys, (size_t) hash_count * size) ||
+        insert_dynamic(&file_ptrs, &file_ptr))
+      return 1;
+    hash_clear();
+    return 0;
+  }
+
   if (tree_walk(&tree, (tree_walk_action) unique_write_to_file,
 		(void*) this, left_root_right) ||
       insert_dynamic(&file_ptrs, &file_ptr))
@@ -341,6 +377,95 @@ bool Unique::flush()
 }
 
 
+/*
+  Find the entry of hash_index for a key: the entry of the key if it is
+  in the hash set, or else the free entry to put it in.
+*/
+
+uint32 *Unique::hash_find(const uchar *key)
+{
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, key, size, &nr1, &nr2);
+  for (ulong pos= nr1 & hash_index_mask; ; pos= (pos + 1) & hash_index_mask)
+  {
+    uint32 *entry= hash_index + pos;
+    if (*entry == 0 ||
+        !memcmp(hash_keys + (size_t) (*entry - 1) * size, key, size))
+      return entry;
+  }
+}
+
+
+/*
+  Double the room of the hash set, up to max_elements keys, and rebuild
+  hash_index for it.
+*/
+
+bool Unique::hash_grow()
+{
+  ulong capacity= hash_capacity ? hash_capacity * 2 : 256;
+  set_if_smaller(capacity, max_elements);
+  ulong index_size= 1;
+  while (index_size < 2 * capacity)
+    index_size<<= 1;
+
+  uchar *keys= (uchar*) my_realloc(key_memory_Unique_hash, hash_keys,
+                                   (size_t) capacity * size + 1,
+                                   MYF(MY_ALLOW_ZERO_PTR));
+  uint32 *index= (uint32*) my_malloc(key_memory_Unique_hash,
+                                     index_size * sizeof(uint32),
+                                     MYF(MY_ZEROFILL));
+  if (keys)
+    hash_keys= keys;
+  if (!keys || !index)
+  {
+    my_free(index);
+    return true;
+  }
+  my_free(hash_index);
+  hash_index= index;
+  hash_index_mask= index_size - 1;
+  hash_capacity= capacity;
+  for (ulong i= 0; i < hash_count; i++)
+    *hash_find(hash_keys + (size_t) i * size)= i + 1;
+  return false;
+}
+
+
+/*
+  Add a key to the hash set, writing the set to the file first if it
+  is full.
+
+  RETURN
+    false  OK, also if the key was already in the set
+    true   Error
+*/
+
+bool Unique::hash_insert(const uchar *key)
+{
+  uint32 *entry= hash_index ? hash_find(key) : NULL;
+  if (entry && *entry)
+    return false;                               // Duplicate
+  if (hash_count == hash_capacity)
+  {
+    if (hash_count >= max_elements ? flush() : hash_grow())
+      return true;
+    entry= hash_find(key);
+  }
+  memcpy(hash_keys + (size_t) hash_count * size, key, size);
+  *entry= ++hash_count;
+  return false;
+}
+
+
+void Unique::hash_clear()
+{
+  if (hash_index)
+    memset(hash_index, 0, (hash_index_mask + 1) * sizeof(uint32));
+  hash_count= 0;
+}
+
+
 /*
   Clear the tree and the file.
   You must call reset() if you want to reuse Unique after walk().
@@ -349,7 +474,10 @@ bool Unique::flush()
 void
 Unique::reset()
 {
-  reset_tree(&tree);
+  if (use_hash)
+    hash_clear();
+  else
+    reset_tree(&tree);
   /*
     If elements != 0, some trees were stored in the file (see how
     flush() works). Note, that we can not count on my_b_tell(&file) == 0
@@ -553,6 +681,15 @@ bool Unique::walk(tree_walk_action action, void *walk_action_arg)
   int res;
   uchar *merge_buffer;
 
+  if (elements == 0 && use_hash)           /* the whole set is in memory */
+  {
+    for (ulong i= 0; i < hash_count; i++)
+    {
+      if ((res= action(hash_keys + (size_t) i * size, 1, walk_action_arg)))
+        return res;
+    }
+    return 0;
+  }
   if (elements == 0)                       /* the whole tree is in memory */
     return tree_walk(&tree, action, walk_action_arg, left_root_right);
 
@@ -580,7 +717,7 @@ bool Unique::walk(tree_walk_action action, void *walk_action_arg)
 
 bool Unique::get(TABLE *table)
 {
-  table->sort.found_records=elements+tree.elements_in_tree;
+  table->sort.found_records=elements+elements_in_tree();
 
   if (my_b_tell(&file) == 0)
   {
@@ -588,8 +725,14 @@ bool Unique::get(TABLE *table)
     DBUG_ASSERT(table->sort.record_pointers == NULL);
     if ((record_pointers=table->sort.record_pointers= (uchar*)
 	 my_malloc(key_memory_Filesort_info_record_pointers,
-                   size * tree.elements_in_tree, MYF(0))))
+                   size * elements_in_tree(), MYF(0))))
     {
+      if (use_hash)
+      {
+        hash_sort();
+        memcpy(record_pointers, hash_keys, (size_t) hash_count * size);
+        return 0;
+      }
       (void) tree_walk(&tree, (tree_walk_action) unique_write_to_ptrs,
 		       this, left_root_right);
       return 0;
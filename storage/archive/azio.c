@@ -36,10 +36,14 @@ int    destroy(azio_stream *s);
 void putLong(File file, uLong x);
 uLong  getLong(azio_stream *s);
 void read_header(azio_stream *s, unsigned char *buffer);
+static void update_window(azio_stream *s, const Byte *buf, size_t len);
+static void add_access_point(azio_stream *s);
+static void free_access_points(azio_stream *s);
 
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_file_key arch_key_file_data;
 #endif
+extern PSI_memory_key az_key_memory_access_point;
 
 /* ===========================================================================
   Opens a gzip (.gz) file for reading or writing. The mode parameter
@@ -388,6 +392,8 @@ int destroy (s)
       err = inflateEnd(&(s->stream));
   }
 
+  free_access_points(s);
+
   if (s->file > 0 && my_close(s->file, MYF(0))) 
       err = Z_ERRNO;
 
@@ -406,6 +412,7 @@ unsigned int ZEXPORT azread ( azio_stream *s, voidp buf, size_t len, int *error)
 {
   Bytef *start = (Bytef*)buf; /* starting point for crc computation */
   Byte  *next_out; /* == stream.next_out but not forced far (for MSDOS) */
+  Bytef *inflated; /* stream.next_out before the last inflate() */
   *error= 0;
 
   if (s->mode != 'r')
@@ -485,10 +492,27 @@ unsigned int ZEXPORT azread ( azio_stream *s, voidp buf, size_t len, int *error)
     }
     s->in += s->stream.avail_in;
     s->out += s->stream.avail_out;
-    s->z_err = inflate(&(s->stream), Z_NO_FLUSH);
+    inflated = s->stream.next_out;
+    /* While indexing, stop at each block boundary to see if it is a point */
+    s->z_err = inflate(&(s->stream), s->window ? Z_BLOCK : Z_NO_FLUSH);
     s->in -= s->stream.avail_in;
     s->out -= s->stream.avail_out;
 
+    if (s->window)
+    {
+      my_off_t last= s->access_points ?
+        s->access_point[s->access_points - 1]->out : 0;
+
+      update_window(s, inflated, (size_t)(s->stream.next_out - inflated));
+      if (s->z_err == Z_OK && (s->stream.data_type & 192) == 128 &&
+          s->out >= last + s->access_point_span)
+      {
+        s->crc = crc32(s->crc, start, (uInt)(s->stream.next_out - start));
+        start = s->stream.next_out;
+        add_access_point(s);
+      }
+    }
+
     if (s->z_err == Z_STREAM_END) {
       /* Check CRC and original size */
       s->crc = crc32(s->crc, start, (uInt)(s->stream.next_out - start));
@@ -673,13 +697,143 @@ int azrewind (s)
   return my_seek(s->file, (int)s->start, MY_SEEK_SET, MYF(0)) == MY_FILEPOS_ERROR;
 }
 
+/* ===========================================================================
+  Copies the len bytes just inflated into buf into the window ring, where
+  the byte at uncompressed offset pos lives at pos % AZ_WINDOW_SIZE.
+*/
+static void update_window(azio_stream *s, const Byte *buf, size_t len)
+{
+  my_off_t pos;
+
+  if (len > AZ_WINDOW_SIZE)
+  {
+    buf += len - AZ_WINDOW_SIZE;
+    len = AZ_WINDOW_SIZE;
+  }
+  pos = s->out - len;
+  while (len)
+  {
+    size_t offset = (size_t)(pos & (AZ_WINDOW_SIZE - 1));
+    size_t chunk = MY_MIN(len, AZ_WINDOW_SIZE - offset);
+
+    memcpy(s->window + offset, buf, chunk);
+    buf += chunk;
+    pos += chunk;
+    len -= chunk;
+  }
+}
+
+/* ===========================================================================
+  Records an access point at the current position, which must be a block
+  boundary. The index only speeds up seeks, so failing to allocate a point
+  is not an error.
+*/
+static void add_access_point(azio_stream *s)
+{
+  az_access_point *point;
+  size_t offset = (size_t)(s->out & (AZ_WINDOW_SIZE - 1));
+
+  if (s->access_points == AZ_MAX_ACCESS_POINTS)
+  {
+    unsigned int i, kept = 0;
+
+    for (i = 0; i < s->access_points; i++)
+    {
+      if (i & 1)
+        my_free(s->access_point[i]);
+      else
+        s->access_point[kept++] = s->access_point[i];
+    }
+    s->access_points = kept;
+    s->access_point_span *= 2;
+    if (s->out < s->access_point[kept - 1]->out + s->access_point_span)
+      return;
+  }
+
+  if (!(point = (az_access_point *)my_malloc(az_key_memory_access_point,
+                                             sizeof(az_access_point),
+                                             MYF(0))))
+    return;
+
+  point->file_pos = my_tell(s->file, MYF(0)) - s->stream.avail_in;
+  point->in = s->in;
+  point->out = s->out;
+  point->crc = s->crc;
+  point->bits = s->stream.data_type & 7;
+  /* Unroll the ring so that the window ends at out */
+  memcpy(point->window, s->window + offset, AZ_WINDOW_SIZE - offset);
+  memcpy(point->window + AZ_WINDOW_SIZE - offset, s->window, offset);
+  s->access_point[s->access_points++] = point;
+}
+
+/* ===========================================================================
+  Restarts inflate at the given access point. Returns 0 on success.
+*/
+static int restore_access_point(azio_stream *s, az_access_point *point)
+{
+  size_t offset = (size_t)(point->out & (AZ_WINDOW_SIZE - 1));
+
+  s->z_err = Z_OK;
+  s->z_eof = 0;
+  s->back = EOF;
+  s->stream.avail_in = 0;
+  s->stream.next_in = (Bytef *)s->inbuf;
+  (void)inflateReset(&s->stream);
+  if (my_seek(s->file, point->file_pos - (point->bits ? 1 : 0),
+              MY_SEEK_SET, MYF(0)) == MY_FILEPOS_ERROR)
+    return 1;
+  if (point->bits)
+  {
+    /* The block starts inside this byte, feed inflate its remaining bits */
+    int c = get_byte(s);
+    if (c == EOF)
+      return 1;
+    (void)inflatePrime(&s->stream, point->bits, c >> (8 - point->bits));
+  }
+  (void)inflateSetDictionary(&s->stream, point->window, AZ_WINDOW_SIZE);
+
+  memcpy(s->window + offset, point->window, AZ_WINDOW_SIZE - offset);
+  memcpy(s->window, point->window + AZ_WINDOW_SIZE - offset, offset);
+  s->in = point->in;
+  s->out = point->out;
+  s->crc = point->crc;
+  return 0;
+}
+
+/* ===========================================================================
+  Returns the last access point at or before offset, or NULL.
+*/
+static az_access_point *find_access_point(azio_stream *s, my_off_t offset)
+{
+  unsigned int low = 0, high = s->access_points;
+
+  while (low < high)
+  {
+    unsigned int mid = (low + high) / 2;
+    if (s->access_point[mid]->out <= offset)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low ? s->access_point[low - 1] : NULL;
+}
+
+static void free_access_points(azio_stream *s)
+{
+  while (s->access_points)
+    my_free(s->access_point[--s->access_points]);
+  my_free(s->window);
+  s->window = NULL;
+}
+
 /* ===========================================================================
   Sets the starting position for the next azread or azwrite on the given
   compressed file. The offset represents a number of bytes in the
   azseek returns the resulting offset location as measured in bytes from
   the beginning of the uncompressed stream, or -1 in case of error.
   SEEK_END is not implemented, returns error.
-  In this version of the library, azseek can be extremely slow.
+  When reading, the first backward seek starts indexing access points, so
+  that later seeks restart from the nearest one instead of the beginning.
 */
 my_off_t azseek (s, offset, whence)
   azio_stream *s;
@@ -729,12 +883,28 @@ my_off_t azseek (s, offset, whence)
     return offset;
   }
 
-  /* For a negative seek, rewind and use positive seek */
-  if (offset >= s->out) {
-    offset -= s->out;
-  } else if (azrewind(s)) {
-    return -1L;
+  if (offset < s->out && !s->window)
+  {
+    /* Seeking backwards is expensive, index the stream from now on */
+    s->window = (Byte *)my_malloc(az_key_memory_access_point,
+                                  AZ_WINDOW_SIZE, MYF(0));
+    s->access_point_span = AZ_ACCESS_POINT_SPAN;
+  }
+
+  /*
+    For a negative seek, or a forward one past an access point, restart from
+    the closest access point (or rewind) and use positive seek
+  */
+  {
+    az_access_point *point = find_access_point(s, offset);
+
+    if (offset < s->out || (point && point->out > s->out))
+    {
+      if (point ? restore_access_point(s, point) : azrewind(s))
+        return -1L;
+    }
   }
+  offset -= s->out;
   /* offset is now the number of bytes to skip. */
 
   if (offset && s->back != EOF) {
@@ -198,6 +198,26 @@ extern "C" {
 #define AZ_BUFSIZE_READ 32768
 #define AZ_BUFSIZE_WRITE 16384
 
+/*
+  Backward seeks on a stream opened for reading build an index of access
+  points: places at a deflate block boundary from which inflate can be
+  restarted given the last AZ_WINDOW_SIZE bytes of output. A point is kept
+  every AZ_ACCESS_POINT_SPAN bytes of uncompressed data; when
+  AZ_MAX_ACCESS_POINTS is reached every other point is dropped and the
+  span doubled, which bounds the memory used per stream.
+*/
+#define AZ_WINDOW_SIZE 32768
+#define AZ_ACCESS_POINT_SPAN (1024*1024)
+#define AZ_MAX_ACCESS_POINTS 128
+
+typedef struct az_access_point {
+  my_off_t file_pos; /* offset in file of the first byte of the block */
+  my_off_t in;       /* bytes into inflate */
+  my_off_t out;      /* bytes out of inflate */
+  uLong    crc;      /* crc32 of uncompressed data up to out */
+  int      bits;     /* bits of the preceding byte that belong to the block */
+  Byte     window[AZ_WINDOW_SIZE]; /* uncompressed data preceding out */
+} az_access_point;
 
 typedef struct azio_stream {
   z_stream stream;
@@ -229,6 +249,10 @@ typedef struct azio_stream {
   unsigned int frm_length;   /* Position for start of FRM */
   unsigned int comment_start_pos;   /* Position for start of comment */
   unsigned int comment_length;   /* Position for start of comment */
+  Byte     *window;   /* ring of recent output, set once indexing starts */
+  az_access_point *access_point[AZ_MAX_ACCESS_POINTS]; /* in order of out */
+  unsigned int access_points;   /* Number of access points */
+  my_off_t access_point_span;   /* Distance between access points */
 } azio_stream;
 
                         /* basic functions */
@@ -297,8 +321,10 @@ extern my_off_t azseek (azio_stream *file,
    given compressed file. The offset represents a number of bytes in the
    uncompressed data stream. The whence parameter is defined as in lseek(2);
    the value SEEK_END is not supported.
-     If the file is opened for reading, this function is emulated but can be
-   extremely slow. If the file is opened for writing, only forward seeks are
+     If the file is opened for reading, this function is emulated by
+   decompressing up to the new position. The first backward seek starts an
+   index of access points so that later seeks only need to decompress from
+   the nearest preceding point rather than from the start of the file. If the file is opened for writing, only forward seeks are
    supported; gzseek then compresses a sequence of zeroes up to the new
    starting position.
 
@@ -122,6 +122,7 @@
 #ifdef HAVE_PSI_INTERFACE
 extern "C" PSI_file_key arch_key_file_data;
 #endif
+extern "C" PSI_memory_key az_key_memory_access_point;
 
 /* Static declarations for handerton */
 static handler *archive_create_handler(handlerton *hton, 
@@ -151,6 +152,7 @@ static handler *archive_create_handler(handlerton *hton,
 
 PSI_memory_key az_key_memory_frm;
 PSI_memory_key az_key_memory_record_buffer;
+PSI_memory_key az_key_memory_access_point;
 
 #ifdef HAVE_PSI_INTERFACE
 PSI_mutex_key az_key_mutex_Archive_share_mutex;
@@ -172,6 +174,7 @@ static PSI_memory_info all_archive_memory[]=
 {
   { &az_key_memory_frm, "FRM", 0},
   { &az_key_memory_record_buffer, "record_buffer", 0},
+  { &az_key_memory_access_point, "access_point", 0},
 };
 
 
@@ -465,28 +465,24 @@ static int free_share(TINA_SHARE *share)
 my_off_t find_eoln_buff(Transparent_file *data_buff, my_off_t begin,
                      my_off_t end, int *eoln_len)
 {
+  my_off_t x= data_buff->find_eoln(begin, end);
+
   *eoln_len= 0;
+  if (x == end)
+    return 0;
 
-  for (my_off_t x= begin; x < end; x++)
+  /* Unix (includes Mac OS X) */
+  if (data_buff->get_value(x) == '\n')
+    *eoln_len= 1;
+  else // Mac or Dos
   {
-    /* Unix (includes Mac OS X) */
-    if (data_buff->get_value(x) == '\n')
+    /* old Mac line ending */
+    if (x + 1 == end || (data_buff->get_value(x + 1) != '\n'))
       *eoln_len= 1;
-    else
-      if (data_buff->get_value(x) == '\r') // Mac or Dos
-      {
-        /* old Mac line ending */
-        if (x + 1 == end || (data_buff->get_value(x + 1) != '\n'))
-          *eoln_len= 1;
-        else // DOS style ending
-          *eoln_len= 2;
-      }
-
-    if (*eoln_len)  // end of line was found
-      return x;
+    else // DOS style ending
+      *eoln_len= 2;
   }
-
-  return 0;
+  return x;
 }
 
 
@@ -20,7 +20,8 @@
 
 PSI_memory_key csv_key_memory_Transparent_file;
 
-Transparent_file::Transparent_file() : lower_bound(0), buff_size(IO_SIZE)
+Transparent_file::Transparent_file()
+  : lower_bound(0), buff_size(16 * IO_SIZE)
 { 
   buff= (uchar *) my_malloc(csv_key_memory_Transparent_file,
                             buff_size*sizeof(uchar),  MYF(MY_WME)); 
@@ -79,13 +80,43 @@ my_off_t Transparent_file::read_next()
 }
 
 
-char Transparent_file::get_value(my_off_t offset)
+/**
+  Find the first '\n' or '\r' in [offset, end).
+
+  Scans the buffered window directly instead of going through get_value()
+  for every byte, refilling it as needed.
+
+  @return offset of the end of line character, or end if there is none
+*/
+
+my_off_t Transparent_file::find_eoln(my_off_t offset, my_off_t end)
 {
-  size_t bytes_read;
+  while (offset < end)
+  {
+    const uchar *pos, *stop;
+
+    if (offset < lower_bound || offset >= upper_bound)
+    {
+      read_value(offset);
+      if (offset >= upper_bound)
+        break;
+    }
+    pos= buff + (offset - lower_bound);
+    stop= buff + (MY_MIN(end, upper_bound) - lower_bound);
+    for ( ; pos < stop; pos++)
+    {
+      if (*pos == '\n' || *pos == '\r')
+        return lower_bound + (pos - buff);
+    }
+    offset= lower_bound + (stop - buff);
+  }
+  return end;
+}
+
 
-  /* check boundaries */
-  if ((lower_bound <= offset) && (((my_off_t) offset) < upper_bound))
-    return buff[offset - lower_bound];
+char Transparent_file::read_value(my_off_t offset)
+{
+  size_t bytes_read;
 
   mysql_file_seek(filedes, offset, MY_SEEK_SET, MYF(0));
   /* read appropriate portion of the file */
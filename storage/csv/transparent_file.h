@@ -38,6 +38,17 @@ public:
   uchar *ptr();
   my_off_t start();
   my_off_t end();
-  char get_value (my_off_t offset);
   my_off_t read_next();
+  my_off_t find_eoln(my_off_t offset, my_off_t end);
+
+  char get_value(my_off_t offset)
+  {
+    /* check boundaries */
+    if ((lower_bound <= offset) && (offset < upper_bound))
+      return buff[offset - lower_bound];
+    return read_value(offset);
+  }
+
+private:
+  char read_value(my_off_t offset);
 };
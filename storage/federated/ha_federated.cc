@@ -1043,6 +1043,130 @@ static bool emit_key_part_element(String *to, KEY_PART_INFO *part,
   DBUG_RETURN(0);
 }
 
+/*
+  Emit a condition pushed by the optimizer as SQL for the remote server.
+
+  SYNOPSIS
+    emit_cond_item()
+    to                  String to append to
+    item                Condition or operand to translate
+    table               Table of this handler
+
+  DESCRIPTION
+    Only a conservative subset is translated: columns of this table,
+    integer, decimal, string and NULL literals, comparisons, IS [NOT] NULL,
+    [NOT] BETWEEN, [NOT] IN, NOT, AND and OR. Anything else (functions,
+    parameters, columns of other tables, ...) makes the translation fail.
+
+  RETURN VALUE
+    0  ok
+    1  item cannot be translated, or out of memory
+*/
+
+static bool emit_cond_item(String *to, Item *item, TABLE *table)
+{
+  DBUG_ENTER("emit_cond_item");
+
+  switch (item->type()) {
+  case Item::FIELD_ITEM:
+  {
+    Field *field= ((Item_field *) item)->field;
+    if (field->table != table)
+      DBUG_RETURN(1);
+    DBUG_RETURN(append_ident(to, field->field_name, strlen(field->field_name),
+                             ident_quote_char));
+  }
+  case Item::INT_ITEM:
+  case Item::DECIMAL_ITEM:
+  case Item::STRING_ITEM:
+  case Item::NULL_ITEM:
+    if (!item->basic_const_item())
+      DBUG_RETURN(1);
+    item->print(to, QT_ORDINARY);
+    DBUG_RETURN(0);
+  case Item::COND_ITEM:
+  {
+    Item_cond *cond= (Item_cond *) item;
+    List_iterator_fast<Item> li(*cond->argument_list());
+    const char *op;
+    Item *arg;
+
+    if (cond->functype() == Item_func::COND_AND_FUNC)
+      op= " AND ";
+    else if (cond->functype() == Item_func::COND_OR_FUNC)
+      op= " OR ";
+    else
+      DBUG_RETURN(1);
+
+    if (to->append('('))
+      DBUG_RETURN(1);
+    for (uint i= 0; (arg= li++); i++)
+    {
+      if ((i && to->append(op)) || emit_cond_item(to, arg, table))
+        DBUG_RETURN(1);
+    }
+    DBUG_RETURN(to->append(')'));
+  }
+  case Item::FUNC_ITEM:
+  {
+    Item_func *func= (Item_func *) item;
+    Item **args= func->arguments();
+
+    switch (func->functype()) {
+    case Item_func::EQ_FUNC:
+    case Item_func::EQUAL_FUNC:
+    case Item_func::NE_FUNC:
+    case Item_func::LT_FUNC:
+    case Item_func::LE_FUNC:
+    case Item_func::GE_FUNC:
+    case Item_func::GT_FUNC:
+      DBUG_RETURN(to->append('(') ||
+                  emit_cond_item(to, args[0], table) ||
+                  to->append(' ') || to->append(func->func_name()) ||
+                  to->append(' ') ||
+                  emit_cond_item(to, args[1], table) ||
+                  to->append(')'));
+    case Item_func::ISNULL_FUNC:
+    case Item_func::ISNOTNULL_FUNC:
+      DBUG_RETURN(to->append('(') ||
+                  emit_cond_item(to, args[0], table) ||
+                  to->append(func->functype() == Item_func::ISNULL_FUNC ?
+                             " IS NULL)" : " IS NOT NULL)"));
+    case Item_func::NOT_FUNC:
+      DBUG_RETURN(to->append(STRING_WITH_LEN("(NOT ")) ||
+                  emit_cond_item(to, args[0], table) ||
+                  to->append(')'));
+    case Item_func::BETWEEN:
+      DBUG_RETURN(to->append('(') ||
+                  emit_cond_item(to, args[0], table) ||
+                  to->append(((Item_func_between *) func)->negated ?
+                             " NOT BETWEEN " : " BETWEEN ") ||
+                  emit_cond_item(to, args[1], table) ||
+                  to->append(STRING_WITH_LEN(" AND ")) ||
+                  emit_cond_item(to, args[2], table) ||
+                  to->append(')'));
+    case Item_func::IN_FUNC:
+      if (to->append('(') ||
+          emit_cond_item(to, args[0], table) ||
+          to->append(((Item_func_in *) func)->negated ?
+                     " NOT IN (" : " IN ("))
+        DBUG_RETURN(1);
+      for (uint i= 1; i < func->argument_count(); i++)
+      {
+        if ((i > 1 && to->append(STRING_WITH_LEN(", "))) ||
+            emit_cond_item(to, args[i], table))
+          DBUG_RETURN(1);
+      }
+      DBUG_RETURN(to->append(STRING_WITH_LEN("))")));
+    default:
+      DBUG_RETURN(1);
+    }
+  }
+  default:
+    DBUG_RETURN(1);
+  }
+}
+
 /*
   Create a WHERE clause based off of values in keys
   Note: This code was inspired by key_copy from key.cc
@@ -2594,7 +2718,20 @@ int ha_federated::rnd_init(bool scan)
 
   if (scan)
   {
-    if (real_query(share->select_query, strlen(share->select_query)) ||
+    char sql_query_buffer[FEDERATED_QUERY_BUFFER_SIZE];
+    String sql_query(sql_query_buffer,
+                     sizeof(sql_query_buffer),
+                     &my_charset_bin);
+
+    /* Let the foreign server filter rows on the pushed condition */
+    sql_query.length(0);
+    if (sql_query.append(share->select_query) ||
+        (pushed_where.length() &&
+         (sql_query.append(STRING_WITH_LEN(" WHERE ")) ||
+          sql_query.append(pushed_where))))
+      DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+
+    if (real_query(sql_query.ptr(), sql_query.length()) ||
         !(stored_result= store_result(mysql)))
       DBUG_RETURN(stash_remote_error());
   }
@@ -2963,6 +3100,7 @@ int ha_federated::reset(void)
   insert_dup_update= FALSE;
   ignore_duplicates= FALSE;
   replace_duplicates= FALSE;
+  pushed_where.free();
 
   /* Free stored result sets. */
   for (uint i= 0; i < results.elements; i++)
@@ -2977,6 +3115,68 @@ int ha_federated::reset(void)
 }
 
 
+/**
+  @brief Push a condition down to the foreign server.
+
+  @details The parts of the condition that emit_cond_item() can translate
+  are added to the WHERE clause of the remote full table scan, so that
+  non-matching rows are not sent over the network and stored in the result
+  set. For a conjunction, each conjunct is translated on its own.
+
+  The foreign server may compare values differently (collations, time zone),
+  so the whole condition is still returned for evaluation here.
+
+  @return The condition, which the caller must still check
+*/
+
+const Item *ha_federated::cond_push(const Item *cond)
+{
+  Item *item= const_cast<Item *>(cond);
+  String where;
+  DBUG_ENTER("ha_federated::cond_push");
+
+  if (item->type() == Item::COND_ITEM &&
+      ((Item_cond *) item)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator_fast<Item> li(*((Item_cond *) item)->argument_list());
+    Item *arg;
+
+    while ((arg= li++))
+    {
+      uint32 length= where.length();
+      if ((length && where.append(STRING_WITH_LEN(" AND "))) ||
+          emit_cond_item(&where, arg, table))
+        where.length(length);
+    }
+  }
+  else if (emit_cond_item(&where, item, table))
+    where.length(0);
+
+  if (where.length())
+  {
+    if (pushed_where.length() &&
+        pushed_where.append(STRING_WITH_LEN(" AND ")))
+      DBUG_RETURN(cond);
+    pushed_where.append(where);
+    DBUG_PRINT("info", ("pushed condition: %s", pushed_where.c_ptr_safe()));
+  }
+  DBUG_RETURN(cond);
+}
+
+
+/**
+  @brief Forget the pushed conditions.
+
+  @details Conditions are only hints to the foreign server, so dropping
+  all of them rather than the last one is allowed.
+*/
+
+void ha_federated::cond_pop()
+{
+  pushed_where.free();
+}
+
+
 /*
   Used to delete all rows in a table. Both for cases of truncate and
   for cases where the optimizer realizes that all rows will be
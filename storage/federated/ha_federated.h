@@ -92,6 +92,7 @@ class ha_federated: public handler
   bool ignore_duplicates, replace_duplicates;
   bool insert_dup_update;
   DYNAMIC_STRING bulk_insert;
+  String pushed_where;      // Pushed condition, appended to remote scans
 
 private:
   /*
@@ -266,5 +267,7 @@ public:
   int connection_autocommit(bool state);
   int execute_simple_query(const char *query, int len);
   int reset(void);
+  const Item *cond_push(const Item *cond);
+  void cond_pop();
 };
 
@@ -110,6 +110,11 @@ static int check_one_key(HP_KEYDEF *keydef, uint keynr, ulong records,
   for (i=found=max_links=seek=0 ; i < records ; i++)
   {
     hash_info=hp_find_hash(&keydef->block,i);
+    if (hash_info->hash_of_key != hp_rec_hashnr(keydef, hash_info->ptr_to_rec))
+    {
+      DBUG_PRINT("error",("Wrong cached hash value at position %lu", i));
+      error=1;
+    }
     if (hp_mask(hp_rec_hashnr(keydef, hash_info->ptr_to_rec),
 		blength,records) == i)
     {
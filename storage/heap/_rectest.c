@@ -22,7 +22,9 @@ int hp_rectest(HP_INFO *info, const uchar *old)
 {
   DBUG_ENTER("hp_rectest");
 
-  if (memcmp(info->current_ptr,old,(size_t) info->s->reclength))
+  if (info->s->blobs ?
+      hp_blob_rec_differs(info->s, info->current_ptr, old) :
+      memcmp(info->current_ptr,old,(size_t) info->s->reclength))
   {
     DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED)); /* Record have changed */
   }
@@ -32,6 +32,14 @@ C_MODE_START
 #define HP_MIN_RECORDS_IN_BLOCK 16
 #define HP_MAX_RECORDS_IN_BLOCK 8192
 
+/*
+  BLOB values are stored in chains of chunks of this size. A chunk starts
+  with the pointer to the next chunk of the chain, the rest holds data.
+*/
+
+#define HP_BLOB_CHUNK_SIZE 256
+#define HP_BLOB_CHUNK_DATA (HP_BLOB_CHUNK_SIZE - sizeof(uchar*))
+
 	/* Some extern variables */
 
 extern LIST *heap_open_list,*heap_share_list;
@@ -48,6 +56,13 @@ typedef struct st_hp_hash_info
 {
   struct st_hp_hash_info *next_key;
   uchar *ptr_to_rec;
+  /*
+    hp_rec_hashnr() of the key in ptr_to_rec. Kept so that growing and
+    shrinking the hash array and walking a chain don't have to read the
+    records, and so that most non-matching keys are skipped without a
+    key comparison.
+  */
+  ulong hash_of_key;
 } HASH_INFO;
 
 typedef struct {
@@ -100,6 +115,13 @@ extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
 extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
                            key_part_map keypart_map);
+extern int hp_write_blobs(HP_INFO *info, const uchar *record);
+extern void hp_store_blob_heads(HP_INFO *info, uchar *pos);
+extern void hp_free_blob_heads(HP_INFO *info);
+extern void hp_free_blobs(HP_SHARE *share, uchar *pos);
+extern int hp_extract_record(HP_INFO *info, uchar *record, const uchar *pos);
+extern my_bool hp_blob_rec_differs(HP_SHARE *share, const uchar *pos,
+                                   const uchar *record);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
@@ -107,6 +129,7 @@ extern PSI_memory_key hp_key_memory_HP_SHARE;
 extern PSI_memory_key hp_key_memory_HP_INFO;
 extern PSI_memory_key hp_key_memory_HP_PTRS;
 extern PSI_memory_key hp_key_memory_HP_KEYDEF;
+extern PSI_memory_key hp_key_memory_HP_BLOB;
 
 #ifdef HAVE_PSI_INTERFACE
 extern PSI_mutex_key hp_key_mutex_HP_SHARE_intern_lock;
@@ -0,0 +1,311 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Storage of BLOB values in heap tables.
+
+  The records of a heap table have a fixed length. The value of a BLOB
+  column is stored in a chain of HP_BLOB_CHUNK_SIZE chunks, allocated from
+  HP_SHARE::blob_block like the records are from HP_SHARE::block, and
+  the stored record holds the pointer to the first chunk where the row
+  buffer of the server holds the pointer to the value. Freed chunks are
+  linked from HP_SHARE::blob_del_link and reused first.
+*/
+
+#include "heapdef.h"
+
+/* Length of a BLOB value, stored with packlength bytes at pos */
+
+static ulong hp_blob_length(uint packlength, const uchar *pos)
+{
+  switch (packlength) {
+  case 1:
+    return (ulong) *pos;
+  case 2:
+    return (ulong) uint2korr(pos);
+  case 3:
+    return (ulong) uint3korr(pos);
+  case 4:
+    return (ulong) uint4korr(pos);
+  default:
+    DBUG_ASSERT(0);
+    return 0;
+  }
+}
+
+
+static uchar *hp_get_blob_ptr(const HP_BLOB_DESC *desc, const uchar *record)
+{
+  uchar *ptr;
+  memcpy(&ptr, record + desc->offset + desc->packlength, sizeof(ptr));
+  return ptr;
+}
+
+
+static void hp_set_blob_ptr(const HP_BLOB_DESC *desc, uchar *record,
+                            const uchar *ptr)
+{
+  memcpy(record + desc->offset + desc->packlength, &ptr, sizeof(ptr));
+}
+
+
+	/* Find where to place a new chunk */
+
+static uchar *next_free_blob_chunk(HP_SHARE *share)
+{
+  ulong block_pos;
+  uchar *pos;
+  size_t length;
+
+  if ((pos= share->blob_del_link))
+  {
+    share->blob_del_link= *((uchar**) pos);
+    share->blob_deleted--;
+  }
+  else
+  {
+    if (!(block_pos= (share->blob_chunks %
+                      share->blob_block.records_in_block)))
+    {
+      if (share->data_length + share->index_length >= share->max_table_size)
+      {
+        my_errno= HA_ERR_RECORD_FILE_FULL;
+        return NULL;
+      }
+      if (hp_get_new_block(&share->blob_block, &length))
+        return NULL;
+      share->data_length+= length;
+    }
+    pos= (uchar*) share->blob_block.level_info[0].last_blocks +
+      block_pos * share->blob_block.recbuffer;
+    share->blob_chunks++;
+  }
+  *((uchar**) pos)= NULL;
+  return pos;
+}
+
+
+static void hp_free_blob_chain(HP_SHARE *share, uchar *chunk)
+{
+  while (chunk)
+  {
+    uchar *next= *((uchar**) chunk);
+    *((uchar**) chunk)= share->blob_del_link;
+    share->blob_del_link= chunk;
+    share->blob_deleted++;
+    chunk= next;
+  }
+}
+
+
+/*
+  Copy the BLOB values of a record to chains of chunks
+
+  SYNOPSIS
+    hp_write_blobs()
+    info		Heap handler
+    record		Row of the server with pointers to the values
+
+  NOTES
+    The first chunks of the chains are put in info->blob_heads, to be
+    stored in the record by hp_store_blob_heads(), or freed by
+    hp_free_blob_heads() if the record cannot be written.
+
+  RETURN
+    0      Ok
+    other  Error code; no chunks are left allocated
+*/
+
+int hp_write_blobs(HP_INFO *info, const uchar *record)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+  DBUG_ENTER("hp_write_blobs");
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    ulong length= hp_blob_length(desc->packlength, record + desc->offset);
+    const uchar *data= hp_get_blob_ptr(desc, record);
+    uchar **link= info->blob_heads + i;
+
+    *link= NULL;
+    while (length)
+    {
+      ulong chunk_length= MY_MIN(length, (ulong) HP_BLOB_CHUNK_DATA);
+      uchar *chunk= next_free_blob_chunk(share);
+      if (!chunk)
+      {
+        int error= my_errno;
+        /* The partial chain of this value, and the chains before it */
+        do
+          hp_free_blob_chain(share, info->blob_heads[i]);
+        while (i-- > 0);
+        DBUG_RETURN(my_errno= error);
+      }
+      *link= chunk;
+      memcpy(chunk + sizeof(uchar*), data, chunk_length);
+      data+= chunk_length;
+      length-= chunk_length;
+      link= (uchar**) chunk;
+    }
+  }
+  DBUG_RETURN(0);
+}
+
+
+/* Store the chains written by hp_write_blobs() in a record of the table */
+
+void hp_store_blob_heads(HP_INFO *info, uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+    hp_set_blob_ptr(share->blob_descs + i, pos, info->blob_heads[i]);
+}
+
+
+/* Free the chains written by hp_write_blobs() */
+
+void hp_free_blob_heads(HP_INFO *info)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+    hp_free_blob_chain(share, info->blob_heads[i]);
+}
+
+
+/* Free the chains of a record of the table */
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    hp_free_blob_chain(share, hp_get_blob_ptr(share->blob_descs + i, pos));
+    hp_set_blob_ptr(share->blob_descs + i, pos, NULL);
+  }
+}
+
+
+/*
+  Copy a record of the table to a row of the server
+
+  SYNOPSIS
+    hp_extract_record()
+    info		Heap handler
+    record		Row to copy to
+    pos			Record of the table
+
+  NOTES
+    The BLOB values are copied to info->blob_buffer, which is valid until
+    the next record is read with the handler.
+
+  RETURN
+    0      Ok
+    other  Error code
+*/
+
+int hp_extract_record(HP_INFO *info, uchar *record, const uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  size_t total_length= 0;
+  uchar *to;
+  uint i;
+
+  memcpy(record, pos, (size_t) share->reclength);
+  if (!share->blobs)
+    return 0;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    total_length+= hp_blob_length(desc->packlength, pos + desc->offset);
+  }
+  if (total_length > info->blob_buffer_length)
+  {
+    my_free(info->blob_buffer);
+    info->blob_buffer_length= 0;
+    if (!(info->blob_buffer= (uchar*) my_malloc(hp_key_memory_HP_BLOB,
+                                                total_length, MYF(MY_WME))))
+      return my_errno= HA_ERR_OUT_OF_MEM;
+    info->blob_buffer_length= total_length;
+  }
+
+  to= info->blob_buffer;
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    ulong length= hp_blob_length(desc->packlength, pos + desc->offset);
+    const uchar *chunk= hp_get_blob_ptr(desc, pos);
+
+    hp_set_blob_ptr(desc, record, length ? to : NULL);
+    while (length)
+    {
+      ulong chunk_length= MY_MIN(length, (ulong) HP_BLOB_CHUNK_DATA);
+      memcpy(to, chunk + sizeof(uchar*), chunk_length);
+      to+= chunk_length;
+      length-= chunk_length;
+      chunk= *((uchar**) chunk);
+    }
+  }
+  return 0;
+}
+
+
+/*
+  Compare a record of the table with a row of the server
+
+  RETURN
+    0  The row holds the same values as the record
+    1  The values differ
+*/
+
+my_bool hp_blob_rec_differs(HP_SHARE *share, const uchar *pos,
+                            const uchar *record)
+{
+  uint start= 0;
+  uint i;
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    uint length_end= desc->offset + desc->packlength;
+    ulong length;
+    const uchar *chunk, *data;
+
+    /* The columns before this one, and the length of the value */
+    if (memcmp(pos + start, record + start, length_end - start))
+      return 1;
+    length= hp_blob_length(desc->packlength, record + desc->offset);
+    chunk= hp_get_blob_ptr(desc, pos);
+    data= hp_get_blob_ptr(desc, record);
+    while (length)
+    {
+      ulong chunk_length= MY_MIN(length, (ulong) HP_BLOB_CHUNK_DATA);
+      if (memcmp(chunk + sizeof(uchar*), data, chunk_length))
+        return 1;
+      data+= chunk_length;
+      length-= chunk_length;
+      chunk= *((uchar**) chunk);
+    }
+    start= length_end + sizeof(uchar*);
+  }
+  return test(memcmp(pos + start, record + start, share->reclength - start));
+}
@@ -46,6 +46,7 @@ int hp_close(HP_INFO *info)
     heap_open_list=list_delete(heap_open_list,&info->open_list);
   if (!--info->s->open_count && info->s->delete_on_close)
     hp_free(info->s);				/* Table was deleted */
+  my_free(info->blob_buffer);
   my_free(info);
   DBUG_RETURN(error);
 }
@@ -30,6 +30,7 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
   HP_KEYDEF *keydef= create_info->keydef;
   uint reclength= create_info->reclength;
   uint keys= create_info->keys;
+  uint blobs= create_info->blobs;
   ulong min_records= create_info->min_records;
   ulong max_records= create_info->max_records;
   DBUG_ENTER("heap_create");
@@ -134,13 +135,19 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!(share= (HP_SHARE*) my_malloc(hp_key_memory_HP_SHARE,
                                        (uint) sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+				       blobs*sizeof(HP_BLOB_DESC),
 				       MYF(MY_ZEROFILL))))
       goto err;
     share->keydef= (HP_KEYDEF*) (share + 1);
     share->key_stat_version= 1;
     keyseg= (HA_KEYSEG*) (share->keydef + keys);
+    share->blob_descs= (HP_BLOB_DESC*) (keyseg + key_segs);
+    memcpy(share->blob_descs, create_info->blob_descs,
+           (size_t) (sizeof(HP_BLOB_DESC) * blobs));
+    share->blobs= blobs;
     init_block(&share->block, reclength + 1, min_records, max_records);
+    init_block(&share->blob_block, HP_BLOB_CHUNK_SIZE, 0, 0);
 	/* Fix keys */
     memcpy(share->keydef, keydef, (size_t) (sizeof(keydef[0]) * keys));
     for (i= 0, keyinfo= share->keydef; i < keys; i++, keyinfo++)
@@ -43,6 +43,8 @@ int heap_delete(HP_INFO *info, const uchar *record)
   }
 
   info->update=HA_STATE_DELETED;
+  if (share->blobs)
+    hp_free_blobs(share, pos);
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
   pos[share->reclength]=0;		/* Record deleted */
@@ -104,7 +106,7 @@ int hp_rb_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 		  const uchar *record, uchar *recpos, int flag)
 {
-  ulong blength, pos2, pos_hashnr, lastpos_hashnr, key_pos;
+  ulong blength, pos2, pos_hashnr, lastpos_hashnr, key_pos, rec_hashnr;
   HASH_INFO *lastpos,*gpos,*pos,*pos3,*empty,*last_ptr;
   HP_SHARE *share=info->s;
   DBUG_ENTER("hp_delete_key");
@@ -116,14 +118,16 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   last_ptr=0;
 
   /* Search after record with key */
-  key_pos= hp_mask(hp_rec_hashnr(keyinfo, record), blength, share->records + 1);
+  rec_hashnr= hp_rec_hashnr(keyinfo, record);
+  key_pos= hp_mask(rec_hashnr, blength, share->records + 1);
   pos= hp_find_hash(&keyinfo->block, key_pos);
 
   gpos = pos3 = 0;
 
   while (pos->ptr_to_rec != recpos)
   {
-    if (flag && !hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 0))
+    if (flag && pos->hash_of_key == rec_hashnr &&
+        !hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 0))
       last_ptr=pos;				/* Previous same key */
     gpos=pos;
     if (!(pos=pos->next_key))
@@ -149,6 +153,7 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   {
     empty=pos->next_key;
     pos->ptr_to_rec=empty->ptr_to_rec;
+    pos->hash_of_key=empty->hash_of_key;
     pos->next_key=empty->next_key;
   }
   else
@@ -158,7 +163,7 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     DBUG_RETURN (0);
 
   /* Move the last key (lastpos) */
-  lastpos_hashnr = hp_rec_hashnr(keyinfo, lastpos->ptr_to_rec);
+  lastpos_hashnr = lastpos->hash_of_key;
   /* pos is where lastpos should be */
   pos=hp_find_hash(&keyinfo->block, hp_mask(lastpos_hashnr, share->blength,
 					    share->records));
@@ -167,7 +172,7 @@ int hp_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     empty[0]=lastpos[0];
     DBUG_RETURN(0);
   }
-  pos_hashnr = hp_rec_hashnr(keyinfo, pos->ptr_to_rec);
+  pos_hashnr = pos->hash_of_key;
   /* pos3 is where the pos should be */
   pos3= hp_find_hash(&keyinfo->block,
 		     hp_mask(pos_hashnr, share->blength, share->records));
@@ -32,6 +32,7 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
 
   if (!(info= (HP_INFO*) my_malloc(hp_key_memory_HP_INFO,
                                    (uint) sizeof(HP_INFO) +
+                                   share->blobs * sizeof(uchar*) +
 				  2 * share->max_key_length,
 				  MYF(MY_ZEROFILL))))
   {
@@ -40,7 +41,8 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
   share->open_count++; 
   thr_lock_data_init(&share->lock,&info->lock,NULL);
   info->s= share;
-  info->lastkey= (uchar*) (info + 1);
+  info->blob_heads= (uchar**) (info + 1);
+  info->lastkey= (uchar*) (info->blob_heads + share->blobs);
   info->recbuf= (uchar*) (info->lastkey + share->max_key_length);
   info->mode= mode;
   info->current_record= (ulong) ~0L;		/* No current record */
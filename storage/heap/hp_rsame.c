@@ -47,7 +47,8 @@ int heap_rsame(HP_INFO *info, uchar *record, int inx)
 	DBUG_RETURN(my_errno);
       }
     }
-    memcpy(record,info->current_ptr,(size_t) share->reclength);
+    if (hp_extract_record(info, record, info->current_ptr))
+      DBUG_RETURN(my_errno);
     DBUG_RETURN(0);
   }
   info->update=0;
@@ -25,7 +25,7 @@ static int get_options(int argc, char *argv[]);
 static int rnd(int max_value);
 static sig_handler endprog(int sig_number);
 
-static uint flag=0,verbose=0,testflag=0,recant=10000,silent=0;
+static uint flag=0,verbose=0,testflag=0,recant=10000,silent=0,bench_rows=0;
 static uint keys=MAX_KEYS;
 static uint16 key1[1001];
 static my_bool key3[MAX_RECORDS];
@@ -33,6 +33,7 @@ static int reclength=39;
 
 
 static int calc_check(uchar *buf,uint length);
+static int run_hash_benchmark(uint rows);
 static void make_record(uchar *record, uint n1, uint n2, uint n3,
 			const char *mark, uint count);
 
@@ -62,9 +63,16 @@ int main(int argc, char *argv[])
   filename2= "test2_2";
   file=file2=0;
   get_options(argc,argv);
+  if (bench_rows)
+  {
+    error= run_hash_benchmark(bench_rows);
+    hp_panic(HA_PANIC_CLOSE);
+    my_end(0);
+    return error;
+  }
 
   memset(&hp_create_info, 0, sizeof(hp_create_info));
-  hp_create_info.max_table_size= 1024L*1024L;
+  hp_create_info.max_table_size= 2*1024L*1024L;
   hp_create_info.keys= keys;
   hp_create_info.keydef= keyinfo;
   hp_create_info.reclength= reclength;
@@ -583,6 +591,9 @@ static int get_options(int argc,char *argv[])
     case 'B':				/* Big file */
       flag=1;
       break;
+    case 'b':				/* Hash index benchmark */
+      bench_rows=atoi(++pos);
+      break;
     case 'v':				/* verbose */
       verbose=1;
       break;
@@ -600,7 +611,7 @@ static int get_options(int argc,char *argv[])
     case '?':
       printf("%s  Ver 1.1 for %s at %s\n",progname,SYSTEM_TYPE,MACHINE_TYPE);
       puts("TCX Datakonsult AB, by Monty, for your professional use\n");
-      printf("Usage: %s [-?ABIKLsWv] [-m#] [-t#]\n",progname);
+      printf("Usage: %s [-?ABIKLsWv] [-b#] [-m#] [-t#]\n",progname);
       exit(0);
     case '#':
       DBUG_PUSH (++pos);
@@ -644,3 +655,91 @@ static void make_record(uchar *record, uint n1, uint n2, uint n3,
   record[37]='A';				/* Store A in null key */
   record[38]=1;					/* set as null */
 }
+
+
+/*
+  Time the hash index the way GROUP BY uses it for internal temporary
+  tables: look the group up by key, update its row when found and write
+  a new row otherwise. Run with -b# where # is the number of groups.
+*/
+
+static int run_hash_benchmark(uint rows)
+{
+  HP_INFO *file;
+  HP_SHARE *share;
+  HP_KEYDEF keydef;
+  HA_KEYSEG seg;
+  HP_CREATE_INFO create_info;
+  uchar record[16], key[8];
+  uint i, found= 0, lookups= rows * 4;
+  ulonglong start, write_time, lookup_time;
+  my_bool unused;
+
+  memset(&create_info, 0, sizeof(create_info));
+  memset(&keydef, 0, sizeof(keydef));
+  memset(&seg, 0, sizeof(seg));
+  seg.type= HA_KEYTYPE_BINARY;
+  seg.start= 0;
+  seg.length= 8;
+  seg.charset= &my_charset_latin1;
+  keydef.seg= &seg;
+  keydef.keysegs= 1;
+  keydef.flag= HA_NOSAME;
+  keydef.algorithm= HA_KEY_ALG_HASH;
+  create_info.max_table_size= (ulonglong) rows * 256 + 1024L*1024L;
+  create_info.keys= 1;
+  create_info.keydef= &keydef;
+  create_info.reclength= sizeof(record);
+  create_info.max_records= rows;
+
+  if (heap_create("bench", &create_info, &share, &unused) ||
+      !(file= heap_open("bench", 2)))
+    return 1;
+
+  memset(record, 0, sizeof(record));
+  start= my_micro_time();
+  for (i= 0; i < lookups; i++)
+  {
+    ulonglong group= ((ulonglong) i * 2654435761UL) % rows;
+    int8store(key, group);
+    if (!heap_rkey(file, record, 0, key, 8, HA_READ_KEY_EXACT))
+    {
+      uchar old[sizeof(record)];
+      memcpy(old, record, sizeof(record));
+      int4store(record + 8, uint4korr(record + 8) + 1);
+      if (heap_update(file, old, record))
+        goto err;
+    }
+    else
+    {
+      int8store(record, group);
+      int4store(record + 8, 1);
+      if (heap_write(file, record))
+        goto err;
+    }
+  }
+  write_time= my_micro_time() - start;
+
+  start= my_micro_time();
+  for (i= 0; i < lookups; i++)
+  {
+    int8store(key, (ulonglong) i % (rows * 2));
+    if (!heap_rkey(file, record, 0, key, 8, HA_READ_KEY_EXACT))
+      found++;
+  }
+  lookup_time= my_micro_time() - start;
+
+  printf("Groups: %u  rows: %lu  group by: %.3f s  lookups: %.3f s  "
+         "found: %u\n", rows, (ulong) share->records,
+         (double) write_time / 1000000.0, (double) lookup_time / 1000000.0,
+         found);
+  heap_close(file);
+  heap_delete_table("bench");
+  return 0;
+
+err:
+  printf("Got error: %d when using heap-database\n", my_errno);
+  heap_close(file);
+  heap_delete_table("bench");
+  return 1;
+}
@@ -30,6 +30,8 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
 
   if (info->opt_flag & READ_CHECK_USED && hp_rectest(info,old))
     DBUG_RETURN(my_errno);				/* Record changed */
+  if (share->blobs && hp_write_blobs(info, heap_new))
+    DBUG_RETURN(my_errno);
   if (--(share->records) < share->blength >> 1) share->blength>>= 1;
   share->changed=1;
 
@@ -46,7 +48,11 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
     }
   }
 
+  if (share->blobs)
+    hp_free_blobs(share, pos);
   memcpy(pos,heap_new,(size_t) share->reclength);
+  if (share->blobs)
+    hp_store_blob_heads(info, pos);
   if (++(share->records) == share->blength) share->blength+= share->blength;
 
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
@@ -67,6 +73,8 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
       {
         if (++(share->records) == share->blength)
 	  share->blength+= share->blength;
+        if (share->blobs)
+          hp_free_blob_heads(info);
         DBUG_RETURN(my_errno);
       }
       keydef--;
@@ -84,5 +92,7 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
   }
   if (++(share->records) == share->blength)
     share->blength+= share->blength;
+  if (share->blobs)
+    hp_free_blob_heads(info);
   DBUG_RETURN(my_errno);
 } /* heap_update */
@@ -44,6 +44,14 @@ int heap_write(HP_INFO *info, const uchar *record)
 #endif
   if (!(pos=next_free_record_pos(share)))
     DBUG_RETURN(my_errno);
+  if (share->blobs && hp_write_blobs(info, record))
+  {
+    share->deleted++;
+    *((uchar**) pos)=share->del_link;
+    share->del_link=pos;
+    pos[share->reclength]=0;			/* Record deleted */
+    DBUG_RETURN(my_errno);
+  }
   share->changed=1;
 
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
@@ -54,6 +62,8 @@ int heap_write(HP_INFO *info, const uchar *record)
   }
 
   memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs)
+    hp_store_blob_heads(info, pos);
   pos[share->reclength]=1;		/* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -87,6 +97,8 @@ err:
       break;
     keydef--;
   } 
+  if (share->blobs)
+    hp_free_blob_heads(info);
 
   share->deleted++;
   *((uchar**) pos)=share->del_link;
@@ -196,7 +208,8 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 {
   HP_SHARE *share = info->s;
   int flag;
-  ulong halfbuff,hashnr,first_index;
+  ulong halfbuff,hashnr,first_index,rec_hashnr;
+  ulong UNINIT_VAR(hash_of_key),UNINIT_VAR(hash_of_key2);
   uchar *UNINIT_VAR(ptr_to_rec),*UNINIT_VAR(ptr_to_rec2);
   HASH_INFO *empty,*UNINIT_VAR(gpos),*UNINIT_VAR(gpos2),*pos;
   DBUG_ENTER("hp_write_key");
@@ -227,7 +240,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
   {
     do
     {
-      hashnr = hp_rec_hashnr(keyinfo, pos->ptr_to_rec);
+      hashnr = pos->hash_of_key;
       if (flag == 0)
       {
         /* 
@@ -260,6 +273,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	    /* key shall be moved to the current empty position */
 	    gpos=empty;
 	    ptr_to_rec=pos->ptr_to_rec;
+	    hash_of_key=pos->hash_of_key;
 	    empty=pos;				/* This place is now free */
 	  }
 	  else
@@ -271,6 +285,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	    flag=LOWFIND | LOWUSED;
 	    gpos=pos;
 	    ptr_to_rec=pos->ptr_to_rec;
+	    hash_of_key=pos->hash_of_key;
 	  }
 	}
 	else
@@ -280,11 +295,13 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	  {
 	    /* Change link of previous lower-list key */
 	    gpos->ptr_to_rec=ptr_to_rec;
+	    gpos->hash_of_key=hash_of_key;
 	    gpos->next_key=pos;
 	    flag= (flag & HIGHFIND) | (LOWFIND | LOWUSED);
 	  }
 	  gpos=pos;
 	  ptr_to_rec=pos->ptr_to_rec;
+	  hash_of_key=pos->hash_of_key;
 	}
       }
       else
@@ -297,6 +314,7 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	  gpos2= empty;
           empty= pos;
 	  ptr_to_rec2=pos->ptr_to_rec;
+	  hash_of_key2=pos->hash_of_key;
 	}
 	else
 	{
@@ -304,11 +322,13 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
 	  {
 	    /* Change link of previous upper-list key and save */
 	    gpos2->ptr_to_rec=ptr_to_rec2;
+	    gpos2->hash_of_key=hash_of_key2;
 	    gpos2->next_key=pos;
 	    flag= (flag & LOWFIND) | (HIGHFIND | HIGHUSED);
 	  }
 	  gpos2=pos;
 	  ptr_to_rec2=pos->ptr_to_rec;
+	  hash_of_key2=pos->hash_of_key;
 	}
       }
     }
@@ -326,21 +346,25 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     if ((flag & (LOWFIND | LOWUSED)) == LOWFIND)
     {
       gpos->ptr_to_rec=ptr_to_rec;
+      gpos->hash_of_key=hash_of_key;
       gpos->next_key=0;
     }
     if ((flag & (HIGHFIND | HIGHUSED)) == HIGHFIND)
     {
       gpos2->ptr_to_rec=ptr_to_rec2;
+      gpos2->hash_of_key=hash_of_key2;
       gpos2->next_key=0;
     }
   }
   /* Check if we are at the empty position */
 
-  pos=hp_find_hash(&keyinfo->block, hp_mask(hp_rec_hashnr(keyinfo, record),
+  rec_hashnr= hp_rec_hashnr(keyinfo, record);
+  pos=hp_find_hash(&keyinfo->block, hp_mask(rec_hashnr,
 					 share->blength, share->records + 1));
   if (pos == empty)
   {
     pos->ptr_to_rec=recpos;
+    pos->hash_of_key=rec_hashnr;
     pos->next_key=0;
     keyinfo->hash_buckets++;
   }
@@ -349,17 +373,19 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
     /* Check if more records in same hash-nr family */
     empty[0]=pos[0];
     gpos=hp_find_hash(&keyinfo->block,
-		      hp_mask(hp_rec_hashnr(keyinfo, pos->ptr_to_rec),
+		      hp_mask(pos->hash_of_key,
 			      share->blength, share->records + 1));
     if (pos == gpos)
     {
       pos->ptr_to_rec=recpos;
+      pos->hash_of_key=rec_hashnr;
       pos->next_key=empty;
     }
     else
     {
       keyinfo->hash_buckets++;
       pos->ptr_to_rec=recpos;
+      pos->hash_of_key=rec_hashnr;
       pos->next_key=0;
       hp_movelink(pos, gpos, empty);
     }
@@ -372,7 +398,8 @@ int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
       pos=empty;
       do
       {
-	if (! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 1))
+	if (pos->hash_of_key == rec_hashnr &&
+            ! hp_rec_key_cmp(keyinfo, record, pos->ptr_to_rec, 1))
 	{
 	  DBUG_RETURN(my_errno=HA_ERR_FOUND_DUPP_KEY);
 	}
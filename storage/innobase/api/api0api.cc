@@ -46,6 +46,9 @@ InnoDB Native API
 #include "trx0roll.h"
 #include "row0trunc.h"
 
+#include <algorithm>
+#include <vector>
+
 /** configure variable for binlog option with InnoDB APIs */
 my_bool ib_binlog_enabled = FALSE;
 
@@ -2189,24 +2192,16 @@ ib_cursor_next(
 }
 
 /*****************************************************************//**
-Search for key.
-@return DB_SUCCESS or err code */
-
-ib_err_t
-ib_cursor_moveto(
-/*=============*/
-	ib_crsr_t	ib_crsr,	/*!< in: InnoDB cursor instance */
-	ib_tpl_t	ib_tpl,		/*!< in: Key to search for */
-	ib_srch_mode_t	ib_srch_mode)	/*!< in: search mode */
+Copy a search key to the search tuple of the cursor. */
+static
+void
+ib_cursor_set_search_key(
+/*=====================*/
+	row_prebuilt_t*		prebuilt,	/*!< in/out: prebuilt struct */
+	const ib_tuple_t*	tuple)		/*!< in: key to search for */
 {
-	ulint		i;
 	ulint		n_fields;
-	ib_err_t	err = DB_SUCCESS;
-	ib_tuple_t*	tuple = (ib_tuple_t*) ib_tpl;
-	ib_cursor_t*	cursor = (ib_cursor_t*) ib_crsr;
-	row_prebuilt_t*	prebuilt = cursor->prebuilt;
 	dtuple_t*	search_tuple = prebuilt->search_tuple;
-	unsigned char*	buf;
 
 	ut_a(tuple->type == TPL_TYPE_KEY);
 
@@ -2216,19 +2211,246 @@ ib_cursor_moveto(
 	dtuple_set_n_fields_cmp(search_tuple, n_fields);
 
 	/* Do a shallow copy */
-	for (i = 0; i < n_fields; ++i) {
+	for (ulint i = 0; i < n_fields; ++i) {
 		dfield_copy(dtuple_get_nth_field(search_tuple, i),
 			    dtuple_get_nth_field(tuple->ptr, i));
 	}
+}
+
+/*****************************************************************//**
+Search for key, using the given buffer for the row.
+@return DB_SUCCESS or err code */
+static
+ib_err_t
+ib_cursor_moveto_low(
+/*=================*/
+	ib_cursor_t*		cursor,		/*!< in: InnoDB cursor */
+	const ib_tuple_t*	tuple,		/*!< in: key to search for */
+	ib_srch_mode_t		ib_srch_mode,	/*!< in: search mode */
+	byte*			buf)		/*!< in: buffer of
+						UNIV_PAGE_SIZE bytes */
+{
+	row_prebuilt_t*	prebuilt = cursor->prebuilt;
+
+	ib_cursor_set_search_key(prebuilt, tuple);
 
 	ut_a(prebuilt->select_lock_type <= LOCK_NUM);
 
 	prebuilt->innodb_api_rec = NULL;
 
+	return(static_cast<ib_err_t>(row_search_for_mysql(
+		buf, ib_srch_mode, prebuilt, cursor->match_mode, 0)));
+}
+
+/*****************************************************************//**
+Search for key.
+@return DB_SUCCESS or err code */
+
+ib_err_t
+ib_cursor_moveto(
+/*=============*/
+	ib_crsr_t	ib_crsr,	/*!< in: InnoDB cursor instance */
+	ib_tpl_t	ib_tpl,		/*!< in: Key to search for */
+	ib_srch_mode_t	ib_srch_mode)	/*!< in: search mode */
+{
+	ib_err_t	err;
+	unsigned char*	buf;
+
 	buf = static_cast<unsigned char*>(mem_alloc(UNIV_PAGE_SIZE));
 
-	err = static_cast<ib_err_t>(row_search_for_mysql(
-		buf, ib_srch_mode, prebuilt, cursor->match_mode, 0));
+	err = ib_cursor_moveto_low(
+		(ib_cursor_t*) ib_crsr, (const ib_tuple_t*) ib_tpl,
+		ib_srch_mode, buf);
+
+	mem_free(buf);
+
+	return(err);
+}
+
+/** Orders the keys of ib_cursor_moveto_batch() by their key values */
+class ib_key_less {
+public:
+	/** Constructor
+	@param[in]	tpls	the key tuples
+	@param[in]	n_fields	number of fields to compare */
+	ib_key_less(const ib_tpl_t* tpls, ulint n_fields)
+		:
+		m_tpls(tpls),
+		m_n_fields(n_fields)
+	{
+	}
+
+	bool operator()(ulint a, ulint b) const
+	{
+		const dtuple_t*	ta = ((const ib_tuple_t*) m_tpls[a])->ptr;
+		const dtuple_t*	tb = ((const ib_tuple_t*) m_tpls[b])->ptr;
+
+		for (ulint i = 0; i < m_n_fields; i++) {
+			int	cmp = cmp_dfield_dfield(
+				dtuple_get_nth_field(ta, i),
+				dtuple_get_nth_field(tb, i));
+
+			if (cmp != 0) {
+				return(cmp < 0);
+			}
+		}
+
+		/* Keep the order of equal keys stable */
+		return(a < b);
+	}
+
+private:
+	/** The key tuples */
+	const ib_tpl_t*	m_tpls;
+
+	/** Number of fields to compare */
+	ulint		m_n_fields;
+};
+
+/*****************************************************************//**
+Compare the search tuple of the cursor with the record that the cursor
+was positioned on by the last search.
+@return false if the cursor position was lost */
+static
+bool
+ib_cursor_cmp_positioned(
+/*=====================*/
+	row_prebuilt_t*	prebuilt,	/*!< in: prebuilt struct */
+	int*		cmp)		/*!< out: negative, 0 or positive if
+					the search tuple is less than, equal
+					to or greater than the record */
+{
+	btr_pcur_t*	pcur = &prebuilt->pcur;
+	mtr_t		mtr;
+	bool		positioned;
+
+	if (!ib_btr_cursor_is_positioned(pcur)) {
+		return(false);
+	}
+
+	mtr_start(&mtr);
+
+	positioned = btr_pcur_restore_position(BTR_SEARCH_LEAF, pcur, &mtr);
+
+	if (positioned) {
+		mem_heap_t*	heap = NULL;
+		ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+		ulint*		offsets = offsets_;
+		const rec_t*	rec = btr_pcur_get_rec(pcur);
+
+		rec_offs_init(offsets_);
+
+		/* The visible version of the record, see
+		ib_cursor_read_row() */
+		if (prebuilt->innodb_api_rec != NULL) {
+			rec = prebuilt->innodb_api_rec;
+		}
+
+		offsets = rec_get_offsets(rec, prebuilt->index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		*cmp = cmp_dtuple_rec(prebuilt->search_tuple, rec, offsets);
+
+		if (heap != NULL) {
+			mem_heap_free(heap);
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	return(positioned);
+}
+
+/*****************************************************************//**
+Search for several keys with one cursor. The keys are searched for in
+ascending order. While the cursor is positioned on a record, a key that
+is not greater than the record, or that is equal to the next record, is
+resolved from that position without descending the index tree again.
+The callback is called for each key, in the order of the search, with
+the cursor positioned on the matching record if the key was found.
+@return DB_SUCCESS or the first error returned by the callback */
+
+ib_err_t
+ib_cursor_moveto_batch(
+/*===================*/
+	ib_crsr_t	ib_crsr,	/*!< in: InnoDB cursor instance */
+	ib_tpl_t*	ib_tpls,	/*!< in: keys to search for */
+	ib_ulint_t	n_keys,		/*!< in: number of keys */
+	ib_key_cb_t	key_cb,		/*!< in: callback for each key */
+	void*		arg)		/*!< in: argument for the callback */
+{
+	ib_cursor_t*		cursor = (ib_cursor_t*) ib_crsr;
+	row_prebuilt_t*		prebuilt = cursor->prebuilt;
+	ib_err_t		err = DB_SUCCESS;
+	byte*			buf;
+	std::vector<ulint>	order(n_keys);
+
+	for (ulint i = 0; i < n_keys; i++) {
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(),
+		  ib_key_less(ib_tpls,
+			      dict_index_get_n_ordering_defined_by_user(
+				      prebuilt->index)));
+
+	/* Moving the cursor forward reads the record after the previous
+	key, which must not be locked, and the records are compared with
+	the keys only when they belong to the searched index. */
+	const bool	can_reuse = cursor->match_mode == IB_EXACT_MATCH
+		&& prebuilt->select_lock_type == LOCK_NONE
+		&& dict_index_is_clust(prebuilt->index)
+		&& !prebuilt->need_to_access_clustered;
+
+	/* Whether the cursor is positioned on the first visible record
+	that is not less than the previous key */
+	bool		positioned = false;
+
+	buf = static_cast<byte*>(mem_alloc(UNIV_PAGE_SIZE));
+
+	for (ulint k = 0; k < n_keys && err == DB_SUCCESS; k++) {
+		const ib_tuple_t*	tuple = (const ib_tuple_t*)
+			ib_tpls[order[k]];
+		ib_err_t		key_err = DB_RECORD_NOT_FOUND;
+		int			cmp = 1;
+
+		if (positioned) {
+			ib_cursor_set_search_key(prebuilt, tuple);
+
+			positioned = ib_cursor_cmp_positioned(prebuilt, &cmp);
+
+			if (positioned && cmp > 0) {
+				/* Try the next record */
+				dtuple_set_n_fields(prebuilt->search_tuple, 0);
+				prebuilt->innodb_api_rec = NULL;
+
+				key_err = static_cast<ib_err_t>(
+					row_search_for_mysql(
+						buf, PAGE_CUR_G, prebuilt, 0,
+						ROW_SEL_NEXT));
+
+				ib_cursor_set_search_key(prebuilt, tuple);
+
+				positioned = key_err == DB_SUCCESS
+					&& ib_cursor_cmp_positioned(
+						prebuilt, &cmp);
+			}
+		}
+
+		if (positioned && cmp <= 0) {
+			/* The key is equal to the record, or it lies
+			between the previous key and the record, which
+			is the next visible one. */
+			key_err = cmp == 0 ? DB_SUCCESS : DB_RECORD_NOT_FOUND;
+		} else {
+			key_err = ib_cursor_moveto_low(
+				cursor, tuple, IB_CUR_GE, buf);
+
+			positioned = can_reuse && key_err == DB_SUCCESS;
+		}
+
+		err = key_cb(ib_crsr, order[k], key_err, arg);
+	}
 
 	mem_free(buf);
 
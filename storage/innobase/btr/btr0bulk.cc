@@ -0,0 +1,621 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.cc
+The B-tree bulk load
+
+Created 10/14/2013
+*******************************************************/
+
+#include "btr0bulk.h"
+#include "btr0btr.h"
+#include "buf0lru.h"
+#include "fsp0fsp.h"
+#include "ibuf0ibuf.h"
+#include "log0log.h"
+#include "page0zip.h"
+#include "rem0cmp.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+
+/**
+Constructor
+@param index		the index being built
+@param trx_id		the transaction that builds the index
+@param page_no		page number to fill, or FIL_NULL to
+			allocate a new page
+@param level		B-tree level of the page */
+PageBulk::PageBulk(
+	dict_index_t*	index,
+	trx_id_t	trx_id,
+	ulint		page_no,
+	ulint		level)
+	:
+	m_index(index),
+	m_trx_id(trx_id),
+	m_heap(mem_heap_create(1000)),
+	m_block(NULL),
+	m_page_no(page_no),
+	m_level(level),
+	m_reserved_space(0)
+{
+}
+
+/**
+Destructor */
+PageBulk::~PageBulk()
+{
+	mem_heap_free(m_heap);
+}
+
+/**
+Allocate or latch the page and start the mini-transaction.
+@return DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+
+dberr_t
+PageBulk::init()
+{
+	ulint	space = dict_index_get_space(m_index);
+
+	mtr_start(&m_mtr);
+	mtr_set_log_mode(&m_mtr, MTR_LOG_NO_REDO);
+
+	if (m_page_no == FIL_NULL) {
+		mtr_t	alloc_mtr;
+		ulint	n_reserved;
+
+		/* The allocation is redo logged in a separate
+		mini-transaction, because the pages are not committed
+		in allocation order. */
+		mtr_start(&alloc_mtr);
+
+		if (!fsp_reserve_free_extents(
+			    &n_reserved, space, 1, FSP_NORMAL, &alloc_mtr)) {
+
+			mtr_commit(&alloc_mtr);
+			mtr_commit(&m_mtr);
+			return(DB_OUT_OF_FILE_SPACE);
+		}
+
+		m_block = btr_page_alloc(
+			m_index, 0, FSP_UP, m_level, &alloc_mtr, &m_mtr);
+
+		if (n_reserved > 0) {
+			fil_space_release_free_extents(space, n_reserved);
+		}
+
+		mtr_commit(&alloc_mtr);
+
+		if (m_block == NULL) {
+			mtr_commit(&m_mtr);
+			return(DB_OUT_OF_FILE_SPACE);
+		}
+
+		page_t*	page = buf_block_get_frame(m_block);
+
+		m_page_no = buf_block_get_page_no(m_block);
+
+		page_create(
+			m_block, &m_mtr, dict_table_is_comp(m_index->table));
+		btr_page_set_level(page, NULL, m_level, &m_mtr);
+		btr_page_set_next(page, NULL, FIL_NULL, &m_mtr);
+		btr_page_set_prev(page, NULL, FIL_NULL, &m_mtr);
+		btr_page_set_index_id(page, NULL, m_index->id, &m_mtr);
+
+		m_block->check_index_page_at_flush = TRUE;
+	} else {
+		/* This is the root page, which was created empty
+		together with the index. */
+		m_block = btr_block_get(
+			space, 0, m_page_no, RW_X_LATCH, m_index, &m_mtr);
+
+		ut_ad(page_get_n_recs(buf_block_get_frame(m_block)) == 0);
+
+		btr_page_set_level(
+			buf_block_get_frame(m_block), NULL, m_level, &m_mtr);
+	}
+
+	if (m_level == 0 && !dict_index_is_clust(m_index)) {
+		page_update_max_trx_id(m_block, NULL, m_trx_id, &m_mtr);
+	}
+
+	page_cur_set_before_first(m_block, &m_cur);
+
+	if (srv_fill_factor == 100 && dict_index_is_clust(m_index)) {
+		/* Leave the same room as sequential inserts would. */
+		m_reserved_space = dict_index_get_space_reserve();
+	} else {
+		m_reserved_space = UNIV_PAGE_SIZE * (100 - srv_fill_factor)
+			/ 100;
+	}
+
+	return(DB_SUCCESS);
+}
+
+/**
+Append a tuple after the last record of the page.
+@param tuple		the tuple to append; it must fit
+			(see is_space_available()) */
+
+void
+PageBulk::insert(const dtuple_t* tuple)
+{
+	ulint*	offsets = NULL;
+
+#ifdef UNIV_DEBUG
+	/* Check that the records are inserted in order. */
+	if (!page_rec_is_infimum(page_cur_get_rec(&m_cur))) {
+		offsets = rec_get_offsets(
+			page_cur_get_rec(&m_cur), m_index, offsets,
+			ULINT_UNDEFINED, &m_heap);
+		ut_ad(cmp_dtuple_rec(
+			      tuple, page_cur_get_rec(&m_cur), offsets) > 0);
+	}
+#endif /* UNIV_DEBUG */
+
+	rec_t*	rec = page_cur_tuple_insert(
+		&m_cur, tuple, m_index, &offsets, &m_heap, 0, &m_mtr);
+
+	ut_a(rec != NULL);
+
+	page_cur_move_to_next(&m_cur);
+	ut_ad(page_cur_get_rec(&m_cur) == rec);
+
+	mem_heap_empty(m_heap);
+}
+
+/**
+Append a copy of a record after the last record of the page.
+@param rec		the record to copy
+@param offsets		rec_get_offsets(rec, index) */
+
+void
+PageBulk::insert(const rec_t* rec, ulint* offsets)
+{
+	rec_t*	ins_rec = page_cur_rec_insert(
+		&m_cur, rec, m_index, offsets, &m_mtr);
+
+	ut_a(ins_rec != NULL);
+
+	page_cur_move_to_next(&m_cur);
+	ut_ad(page_cur_get_rec(&m_cur) == ins_rec);
+}
+
+/**
+Check whether a record fits on the page without exceeding the
+fill factor.
+@param rec_size		converted size of the record
+@return true if the record should go on this page */
+
+bool
+PageBulk::is_space_available(ulint rec_size) const
+{
+	const page_t*	page = buf_block_get_frame(m_block);
+	ulint		free_space = page_get_max_insert_size(page, 1);
+
+	if (rec_size > free_space) {
+		return(false);
+	}
+
+	/* Keep at least two records on each page, so that the tree
+	does not grow needlessly high. */
+	return(page_get_n_recs(page) < 2
+	       || free_space - rec_size >= m_reserved_space);
+}
+
+/**
+Build the node pointer for the page. The leftmost node pointer
+of a level gets REC_INFO_MIN_REC_FLAG.
+@param heap		memory heap for the node pointer
+@return node pointer to the first record of the page */
+
+dtuple_t*
+PageBulk::get_node_ptr(mem_heap_t* heap) const
+{
+	const page_t*	page = buf_block_get_frame(m_block);
+	const rec_t*	first_rec = page_rec_get_next_const(
+		page_get_infimum_rec(page));
+
+	ut_ad(page_rec_is_user_rec(first_rec));
+
+	dtuple_t*	node_ptr = dict_index_build_node_ptr(
+		m_index, first_rec, m_page_no, heap, m_level);
+
+	if (btr_page_get_prev(page, const_cast<mtr_t*>(&m_mtr)) == FIL_NULL) {
+		ulint	info_bits = dtuple_get_info_bits(node_ptr);
+
+		dtuple_set_info_bits(
+			node_ptr, info_bits | REC_INFO_MIN_REC_FLAG);
+	}
+
+	return(node_ptr);
+}
+
+/**
+Copy all the records of another page of the index to this page.
+@param block		the x-latched source page */
+
+void
+PageBulk::copy_in(const buf_block_t* block)
+{
+	const rec_t*	rec = page_rec_get_next_const(
+		page_get_infimum_rec(buf_block_get_frame(block)));
+	ulint*		offsets = NULL;
+
+	ut_ad(page_get_n_recs(buf_block_get_frame(m_block)) == 0);
+
+	while (!page_rec_is_supremum(rec)) {
+		offsets = rec_get_offsets(
+			rec, m_index, offsets, ULINT_UNDEFINED, &m_heap);
+
+		insert(rec, offsets);
+
+		rec = page_rec_get_next_const(rec);
+	}
+
+	mem_heap_empty(m_heap);
+}
+
+/**
+Set the next page number.
+@param next_page_no	next page number */
+
+void
+PageBulk::set_next(ulint next_page_no)
+{
+	btr_page_set_next(
+		buf_block_get_frame(m_block), NULL, next_page_no, &m_mtr);
+}
+
+/**
+Set the previous page number.
+@param prev_page_no	previous page number */
+
+void
+PageBulk::set_prev(ulint prev_page_no)
+{
+	btr_page_set_prev(
+		buf_block_get_frame(m_block), NULL, prev_page_no, &m_mtr);
+}
+
+/**
+Commit the mini-transaction of a page that will not be
+modified any more. */
+
+void
+PageBulk::commit()
+{
+	if (m_level == 0 && !dict_index_is_clust(m_index)) {
+		/* The page was never seen by the insert buffer.
+		Do not let it buffer anything before the page has
+		been read and its real free space is known. */
+		ibuf_reset_free_bits(m_block);
+	}
+
+	mtr_commit(&m_mtr);
+	m_block = NULL;
+}
+
+/**
+Commit the mini-transaction temporarily, so that a log
+checkpoint can flush the page. */
+
+void
+PageBulk::release()
+{
+	mtr_commit(&m_mtr);
+	m_block = NULL;
+}
+
+/**
+Latch the page again after release(). */
+
+void
+PageBulk::latch()
+{
+	ut_ad(m_block == NULL);
+
+	mtr_start(&m_mtr);
+	mtr_set_log_mode(&m_mtr, MTR_LOG_NO_REDO);
+
+	m_block = btr_block_get(
+		dict_index_get_space(m_index), 0, m_page_no, RW_X_LATCH,
+		m_index, &m_mtr);
+
+	page_cur_position(
+		page_rec_get_prev(
+			page_get_supremum_rec(buf_block_get_frame(m_block))),
+		m_block, &m_cur);
+}
+
+/**
+Destructor */
+BtrBulk::~BtrBulk()
+{
+	for (page_bulks_t::iterator it = m_page_bulks.begin();
+	     it != m_page_bulks.end();
+	     ++it) {
+
+		delete *it;
+	}
+}
+
+/**
+Check whether an index can be loaded in bulk. The loader does not
+handle compressed pages nor records that need off-page columns,
+and it avoids flushing the whole system tablespace.
+@param index		the index to check
+@return true if BtrBulk can build the index */
+
+bool
+BtrBulk::is_supported(const dict_index_t* index)
+{
+	const dict_table_t*	table = index->table;
+	ulint			comp = dict_table_is_comp(table);
+	ulint			n_fields = dict_index_get_n_fields(index);
+	ulint			rec_size;
+
+	if (dict_table_zip_size(table) != 0
+	    || dict_index_get_space(index) == TRX_SYS_SPACE
+	    || dict_index_is_ibuf(index)) {
+
+		return(false);
+	}
+
+	/* Bound the record size from above: every field at its maximum
+	length, with two length bytes in the header. */
+	rec_size = comp
+		? REC_N_NEW_EXTRA_BYTES + UT_BITS_IN_BYTES(index->n_nullable)
+		: REC_N_OLD_EXTRA_BYTES;
+
+	for (ulint i = 0; i < n_fields; i++) {
+		const dict_field_t*	field = dict_index_get_nth_field(
+			index, i);
+		const dict_col_t*	col = dict_field_get_col(field);
+
+		if (field->prefix_len > 0) {
+			rec_size += field->prefix_len;
+		} else if (DATA_LARGE_MTYPE(col->mtype)) {
+			return(false);
+		} else {
+			rec_size += col->len;
+		}
+
+		rec_size += 2;
+	}
+
+	return(!page_zip_rec_needs_ext(rec_size, comp, n_fields, 0));
+}
+
+/**
+Append a record to a level of the tree.
+@param tuple		the record to append
+@param level		the B-tree level
+@return DB_SUCCESS or error code */
+
+dberr_t
+BtrBulk::insert(dtuple_t* tuple, ulint level)
+{
+	dberr_t	err;
+
+	if (level == m_page_bulks.size()) {
+		/* The first page of a new level */
+		PageBulk*	new_page_bulk = new(std::nothrow) PageBulk(
+			m_index, m_trx->id, FIL_NULL, level);
+
+		if (new_page_bulk == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+
+		err = new_page_bulk->init();
+
+		if (err != DB_SUCCESS) {
+			delete new_page_bulk;
+			return(err);
+		}
+
+		m_page_bulks.push_back(new_page_bulk);
+	}
+
+	ut_ad(level < m_page_bulks.size());
+
+	PageBulk*	page_bulk = m_page_bulks[level];
+	ulint		rec_size = rec_get_converted_size(m_index, tuple, 0);
+
+	if (!page_bulk->is_space_available(rec_size)) {
+		PageBulk*	sibling_page_bulk = new(std::nothrow) PageBulk(
+			m_index, m_trx->id, FIL_NULL, level);
+
+		if (sibling_page_bulk == NULL) {
+			return(DB_OUT_OF_MEMORY);
+		}
+
+		err = sibling_page_bulk->init();
+
+		if (err != DB_SUCCESS) {
+			delete sibling_page_bulk;
+			return(err);
+		}
+
+		err = page_commit(page_bulk, sibling_page_bulk, true);
+
+		if (err != DB_SUCCESS) {
+			sibling_page_bulk->commit();
+			delete sibling_page_bulk;
+			return(err);
+		}
+
+		delete page_bulk;
+		m_page_bulks[level] = page_bulk = sibling_page_bulk;
+
+		if (level == 0) {
+			log_free_check();
+		}
+
+		ut_ad(page_bulk->is_space_available(rec_size));
+	}
+
+	page_bulk->insert(tuple);
+
+	return(DB_SUCCESS);
+}
+
+/**
+Commit a page and optionally add its node pointer to the level
+above.
+@param page_bulk	the page to commit
+@param next_page_bulk	the right sibling, or NULL
+@param insert_father	whether to insert the node pointer
+@return DB_SUCCESS or error code */
+
+dberr_t
+BtrBulk::page_commit(
+	PageBulk*	page_bulk,
+	PageBulk*	next_page_bulk,
+	bool		insert_father)
+{
+	if (next_page_bulk != NULL) {
+		page_bulk->set_next(next_page_bulk->page_no());
+		next_page_bulk->set_prev(page_bulk->page_no());
+	}
+
+	if (insert_father) {
+		mem_heap_t*	heap = mem_heap_create(1000);
+		dtuple_t*	node_ptr = page_bulk->get_node_ptr(heap);
+		dberr_t		err = insert(node_ptr, page_bulk->level() + 1);
+
+		mem_heap_free(heap);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	page_bulk->commit();
+
+	return(DB_SUCCESS);
+}
+
+/**
+Release all the page latches for the duration of log_free_check()
+if a log checkpoint is needed. */
+
+void
+BtrBulk::log_free_check()
+{
+	/* This is a dirty read, as in ::log_free_check(). */
+	if (!log_sys->check_flush_or_checkpoint) {
+		return;
+	}
+
+	for (page_bulks_t::iterator it = m_page_bulks.begin();
+	     it != m_page_bulks.end();
+	     ++it) {
+
+		(*it)->release();
+	}
+
+	::log_free_check();
+
+	for (page_bulks_t::iterator it = m_page_bulks.begin();
+	     it != m_page_bulks.end();
+	     ++it) {
+
+		(*it)->latch();
+	}
+}
+
+/**
+Commit the last page of each level, move the top level to the
+root page and write the pages to disk.
+@param err		error status of the load so far
+@return DB_SUCCESS or error code */
+
+dberr_t
+BtrBulk::finish(dberr_t err)
+{
+	ulint	last_page_no = FIL_NULL;
+
+	if (m_page_bulks.empty()) {
+		/* The root page was left empty. */
+		return(err);
+	}
+
+	/* The loop may add levels while it inserts node pointers. */
+	for (ulint level = 0; level < m_page_bulks.size(); level++) {
+		PageBulk*	page_bulk = m_page_bulks[level];
+
+		last_page_no = page_bulk->page_no();
+
+		if (err == DB_SUCCESS) {
+			err = page_commit(
+				page_bulk, NULL,
+				level + 1 < m_page_bulks.size());
+
+			if (err == DB_SUCCESS) {
+				continue;
+			}
+		}
+
+		page_bulk->commit();
+	}
+
+	if (err != DB_SUCCESS) {
+		/* The index will be dropped. */
+		return(err);
+	}
+
+	/* The top level consists of a single page. Copy its records
+	to the root page, which must keep its page number. */
+	ulint		root_level = m_page_bulks.size() - 1;
+	PageBulk	root_page_bulk(
+		m_index, m_trx->id, dict_index_get_page(m_index), root_level);
+	mtr_t		mtr;
+
+	err = root_page_bulk.init();
+	ut_a(err == DB_SUCCESS);
+
+	mtr_start(&mtr);
+
+	buf_block_t*	last_block = btr_block_get(
+		dict_index_get_space(m_index), 0, last_page_no, RW_X_LATCH,
+		m_index, &mtr);
+
+	root_page_bulk.copy_in(last_block);
+
+	btr_page_free_low(m_index, last_block, root_level, &mtr);
+
+	mtr_commit(&mtr);
+
+	root_page_bulk.commit();
+
+	if (!dict_table_is_temporary(m_index->table)) {
+		/* Nothing was redo logged: write the pages to disk
+		before the index can be used. */
+		buf_LRU_flush_or_remove_pages(
+			dict_index_get_space(m_index), BUF_REMOVE_FLUSH_WRITE,
+			m_trx);
+
+		if (trx_is_interrupted(m_trx)) {
+			err = DB_INTERRUPTED;
+		}
+	}
+
+	return(err);
+}
@@ -56,6 +56,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "rem0rec.h"
 #include "rem0cmp.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "btr0btr.h"
 #include "btr0sea.h"
 #include "row0log.h"
@@ -591,7 +592,7 @@ btr_cur_search_to_nth_level(
 	btr_cur_t*	cursor, /*!< in/out: tree cursor; the cursor page is
 				s- or x-latched, but see also above! */
 	ulint		has_search_latch,/*!< in: info on the latch mode the
-				caller currently has on btr_search_latch:
+				caller currently has on the search latch:
 				RW_S_LATCH, or 0 */
 	const char*	file,	/*!< in: file name */
 	ulint		line,	/*!< in: line where called */
@@ -732,7 +733,8 @@ btr_cur_search_to_nth_level(
 # ifdef UNIV_SEARCH_PERF_STAT
 	info->n_searches++;
 # endif
-	if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_NOT_LOCKED
+	if (rw_lock_get_writer(btr_get_search_latch(index))
+	    == RW_LOCK_NOT_LOCKED
 	    && latch_mode <= BTR_MODIFY_LEAF
 	    && info->last_hash_succ
 	    && !estimate
@@ -768,7 +770,7 @@ btr_cur_search_to_nth_level(
 
 	if (has_search_latch) {
 		/* Release possible search latch to obey latching order */
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_get_search_latch(index));
 	}
 
 	/* Store the position of the tree latch we push to mtr so that we
@@ -1393,7 +1395,7 @@ retry_page_get:
 		/* We do a dirty read of btr_search_enabled here.  We
 		will properly check btr_search_enabled again in
 		btr_search_build_page_hash_index() before building a
-		page hash index, while holding btr_search_latch. */
+		page hash index, while holding the partition latch. */
 		if (btr_search_enabled) {
 			btr_search_info_update(index, cursor);
 		}
@@ -1419,7 +1421,7 @@ func_exit:
 
 	if (has_search_latch) {
 
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(btr_get_search_latch(index));
 	}
 
 	DBUG_VOID_RETURN;
@@ -2045,6 +2047,67 @@ btr_cur_open_at_rnd_pos_func(
 	}
 }
 
+/** Starts reading in the background the first page that a search for
+tuple would have to read from disk. The search descends from the root
+through the pages that are in the buffer pool and stops at the first page
+that is not.
+@param[in]	index	index tree
+@param[in]	tuple	data tuple to search for
+@return true if a page read was started */
+
+bool
+btr_cur_prefetch(
+	dict_index_t*	index,
+	const dtuple_t*	tuple)
+{
+	mtr_t		mtr;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	ulint		space		= dict_index_get_space(index);
+	ulint		zip_size	= dict_table_zip_size(index->table);
+	ulint		page_no		= dict_index_get_page(index);
+	bool		missing		= false;
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	for (;;) {
+		buf_block_t*	block;
+		page_cur_t	page_cursor;
+		const rec_t*	node_ptr;
+
+		block = buf_page_get_gen(
+			space, zip_size, page_no, RW_S_LATCH, NULL,
+			BUF_GET_IF_IN_POOL, __FILE__, __LINE__, &mtr);
+
+		if (block == NULL) {
+			missing = true;
+			break;
+		}
+
+		if (btr_page_get_level(buf_block_get_frame(block), &mtr) == 0) {
+			break;
+		}
+
+		page_cur_search(block, index, tuple, PAGE_CUR_L, &page_cursor);
+
+		node_ptr = page_cur_get_rec(&page_cursor);
+		offsets = rec_get_offsets(
+			node_ptr, index, offsets, ULINT_UNDEFINED, &heap);
+		page_no = btr_node_ptr_get_child_page_no(node_ptr, offsets);
+	}
+
+	mtr_commit(&mtr);
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+
+	return(missing && buf_read_page_background(space, zip_size, page_no));
+}
+
 /*==================== B-TREE INSERT =========================*/
 
 /*************************************************************//**
@@ -2967,13 +3030,13 @@ btr_cur_update_in_place(
 			btr_search_update_hash_on_delete(cursor);
 		}
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(btr_get_search_latch(index));
 	}
 
 	row_upd_rec_in_place(rec, index, offsets, update, page_zip);
 
 	if (is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_get_search_latch(index));
 	}
 
 	btr_cur_update_in_place_log(flags, rec, index, update,
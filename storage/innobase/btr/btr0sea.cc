@@ -45,9 +45,12 @@ Created 2/17/1996 Heikki Tuuri
 #include "sync0sync.h"
 
 /** Flag: has the search system been enabled?
-Protected by btr_search_latch. */
+Protected by all the btr_search_latches. */
 char		btr_search_enabled	= TRUE;
 
+/** Number of adaptive hash index partitions */
+ulong		btr_ahi_parts		= 8;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 ulint		btr_search_n_succ	= 0;
@@ -55,24 +58,16 @@ ulint		btr_search_n_succ	= 0;
 ulint		btr_search_n_hash_fail	= 0;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-/** padding to prevent other memory update
-hotspots from residing on the same memory
-cache line as btr_search_latch */
-byte		btr_sea_pad1[64];
-
-/** The latch protecting the adaptive search system: this latch protects the
-(1) positions of records on those pages where a hash index has been built.
-NOTE: It does not protect values of non-ordering fields within a record from
-being updated in-place! We can use fact (1) to perform unique searches to
-indexes. */
-
-/* We will allocate the latch from dynamic memory to get it to the
-same DRAM page as other hotspot semaphores */
-rw_lock_t*		btr_search_latch_temp;
+/** The latches protecting the adaptive search system: each latch protects
+the (1) positions of records on those pages where a hash index has been
+built, for the indexes that map to its partition. NOTE: It does not protect
+values of non-ordering fields within a record from being updated in-place!
+We can use fact (1) to perform unique searches to indexes. */
 
-/** padding to prevent other memory update hotspots from residing on
-the same memory cache line */
-byte		btr_sea_pad2[64];
+/* We will allocate the latches from dynamic memory, each on its own
+cache line, to get them to the same DRAM page as other hotspot
+semaphores without false sharing between the partitions */
+rw_lock_t**		btr_search_latches;
 
 /** The adaptive hash index */
 btr_search_sys_t*	btr_search_sys;
@@ -113,18 +108,21 @@ allocate a new node to the hash table, it will succeed. However, the check
 will not guarantee success. */
 static
 void
-btr_search_check_free_space_in_heap(void)
-/*=====================================*/
+btr_search_check_free_space_in_heap(
+/*================================*/
+	const dict_index_t*	index)	/*!< in: index whose partition
+					is about to be modified */
 {
 	hash_table_t*	table;
 	mem_heap_t*	heap;
+	rw_lock_t*	latch = btr_get_search_latch(index);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_S));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 
 	heap = table->heap;
 
@@ -135,7 +133,7 @@ btr_search_check_free_space_in_heap(void)
 	if (heap->free_block == NULL) {
 		buf_block_t*	block = buf_block_alloc(NULL);
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 
 		if (heap->free_block == NULL) {
 			heap->free_block = block;
@@ -143,7 +141,7 @@ btr_search_check_free_space_in_heap(void)
 			buf_block_free(block);
 		}
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 }
 
@@ -155,24 +153,48 @@ btr_search_sys_create(
 /*==================*/
 	ulint	hash_size)	/*!< in: hash index hash table size */
 {
-	/* We allocate the search latch from dynamic memory:
-	see above at the global variable definition */
+	ut_a(btr_ahi_parts > 0);
+
+	/* Split the cells evenly between the partitions. */
+	hash_size = ut_max(hash_size / btr_ahi_parts, 1);
 
-	btr_search_latch_temp = reinterpret_cast<rw_lock_t*>(
-		mem_alloc(sizeof(rw_lock_t)));
+	/* We allocate the search latches from dynamic memory:
+	see above at the global variable definition */
 
-	rw_lock_create(
-		btr_search_latch_key, &btr_search_latch, SYNC_SEARCH_SYS);
+	btr_search_latches = reinterpret_cast<rw_lock_t**>(
+		mem_alloc(btr_ahi_parts * sizeof(*btr_search_latches)));
 
 	btr_search_sys = reinterpret_cast<btr_search_sys_t*>(
 		mem_alloc(sizeof(btr_search_sys_t)));
 
-	btr_search_sys->hash_index = ib_create(
-		hash_size, "hash_table_mutex", 0, MEM_HEAP_FOR_BTR_SEARCH);
+	btr_search_sys->hash_tables = reinterpret_cast<hash_table_t**>(
+		mem_alloc(btr_ahi_parts
+			  * sizeof(*btr_search_sys->hash_tables)));
+
+	btr_search_sys->part_stats =
+		reinterpret_cast<btr_search_part_stats_t*>(
+			mem_zalloc(btr_ahi_parts
+				   * sizeof(*btr_search_sys->part_stats)));
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+
+		/* Round the allocation up to a whole number of cache
+		lines so that no two partition latches share one. */
+		btr_search_latches[i] = reinterpret_cast<rw_lock_t*>(
+			mem_alloc(ut_calc_align(sizeof(rw_lock_t),
+						CACHE_LINE_SIZE)));
+
+		rw_lock_create(btr_search_latch_key,
+			       btr_search_latches[i], SYNC_SEARCH_SYS);
+
+		btr_search_sys->hash_tables[i] = ib_create(
+			hash_size, "hash_table_mutex", 0,
+			MEM_HEAP_FOR_BTR_SEARCH);
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
-	btr_search_sys->hash_index->adaptive = TRUE;
+		btr_search_sys->hash_tables[i]->adaptive = TRUE;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
+	}
 }
 
 /*****************************************************************//**
@@ -182,15 +204,56 @@ void
 btr_search_sys_free(void)
 /*=====================*/
 {
-	rw_lock_free(&btr_search_latch);
-	mem_free(btr_search_latch_temp);
-	btr_search_latch_temp = NULL;
-	mem_heap_free(btr_search_sys->hash_index->heap);
-	hash_table_free(btr_search_sys->hash_index);
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		rw_lock_free(btr_search_latches[i]);
+		mem_free(btr_search_latches[i]);
+
+		mem_heap_free(btr_search_sys->hash_tables[i]->heap);
+		hash_table_free(btr_search_sys->hash_tables[i]);
+	}
+
+	mem_free(btr_search_latches);
+	btr_search_latches = NULL;
+
+	mem_free(btr_search_sys->part_stats);
+	mem_free(btr_search_sys->hash_tables);
 	mem_free(btr_search_sys);
 	btr_search_sys = NULL;
 }
 
+/********************************************************************//**
+Resizes the hash tables of the adaptive search system, after the buffer
+pool was resized.  Nothing is done unless the adaptive hash index is
+disabled, and therefore empty. */
+
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size)	/*!< in: hash index hash table size */
+{
+	hash_size = ut_max(hash_size / btr_ahi_parts, 1);
+
+	btr_search_x_lock_all();
+
+	if (!btr_search_enabled) {
+		for (ulint i = 0; i < btr_ahi_parts; ++i) {
+
+			mem_heap_free(btr_search_sys->hash_tables[i]->heap);
+			hash_table_free(btr_search_sys->hash_tables[i]);
+
+			btr_search_sys->hash_tables[i] = ib_create(
+				hash_size, "hash_table_mutex", 0,
+				MEM_HEAP_FOR_BTR_SEARCH);
+
+#if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
+			btr_search_sys->hash_tables[i]->adaptive = TRUE;
+#endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
+		}
+	}
+
+	btr_search_x_unlock_all();
+}
+
 /********************************************************************//**
 Set index->ref_count = 0 on all indexes of a table. */
 static
@@ -203,7 +266,7 @@ btr_search_disable_ref_count(
 
 	ut_ad(mutex_own(&dict_sys->mutex));
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_all(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	for (index = dict_table_get_first_index(table); index;
@@ -223,7 +286,7 @@ btr_search_disable(void)
 	dict_table_t*	table;
 
 	mutex_enter(&dict_sys->mutex);
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	btr_search_enabled = FALSE;
 
@@ -247,10 +310,12 @@ btr_search_disable(void)
 	buf_pool_clear_hash_index();
 
 	/* Clear the adaptive hash index. */
-	hash_table_clear(btr_search_sys->hash_index);
-	mem_heap_empty(btr_search_sys->hash_index->heap);
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		hash_table_clear(btr_search_sys->hash_tables[i]);
+		mem_heap_empty(btr_search_sys->hash_tables[i]->heap);
+	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /********************************************************************//**
@@ -260,11 +325,11 @@ void
 btr_search_enable(void)
 /*====================*/
 {
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	btr_search_enabled = TRUE;
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /*****************************************************************//**
@@ -308,27 +373,29 @@ btr_search_info_create(
 }
 
 /*****************************************************************//**
-Returns the value of ref_count. The value is protected by
-btr_search_latch.
+Returns the value of ref_count. The value is protected by the
+adaptive hash index partition latch of the index.
 @return ref_count value. */
 
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info)	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index)	/*!< in: index */
 {
-	ulint ret;
+	ulint		ret;
+	rw_lock_t*	latch = btr_get_search_latch(index);
 
 	ut_ad(info);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_S));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 	ret = info->ref_count;
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	return(ret);
 }
@@ -348,8 +415,8 @@ btr_search_info_update_hash(
 	ulint		n_unique;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	index = cursor->index;
@@ -447,8 +514,8 @@ btr_search_update_block_hash_info(
 				/*!< in: cursor */
 {
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 	ut_ad(rw_lock_own(&block->lock, RW_LOCK_S)
 	      || rw_lock_own(&block->lock, RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
@@ -528,7 +595,7 @@ btr_search_update_hash_ref(
 
 	ut_ad(cursor->flag == BTR_CUR_HASH_FAIL);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
@@ -567,10 +634,10 @@ btr_search_update_hash_ref(
 			mem_heap_free(heap);
 		}
 #ifdef UNIV_SYNC_DEBUG
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-		ha_insert_for_fold(btr_search_sys->hash_index, fold,
+		ha_insert_for_fold(btr_get_search_table(index), fold,
 				   block, rec);
 
 		MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
@@ -590,8 +657,8 @@ btr_search_info_update_slow(
 	ibool		build_index;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	block = btr_cur_get_block(cursor);
@@ -607,7 +674,7 @@ btr_search_info_update_slow(
 
 	if (build_index || (cursor->flag == BTR_CUR_HASH_FAIL)) {
 
-		btr_search_check_free_space_in_heap();
+		btr_search_check_free_space_in_heap(cursor->index);
 	}
 
 	if (cursor->flag == BTR_CUR_HASH_FAIL) {
@@ -617,11 +684,13 @@ btr_search_info_update_slow(
 		btr_search_n_hash_fail++;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_t*	latch = btr_get_search_latch(cursor->index);
+
+		rw_lock_x_lock(latch);
 
 		btr_search_update_hash_ref(info, block, cursor);
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 
 	if (build_index) {
@@ -646,8 +715,8 @@ btr_search_check_guess(
 	btr_cur_t*	cursor,	/*!< in: guessed cursor position */
 	ibool		can_only_compare_to_cursor_rec,
 				/*!< in: if we do not have a latch on the page
-				of cursor, but only a latch on
-				btr_search_latch, then ONLY the columns
+				of cursor, but only a latch on the
+				partition latch, then ONLY the columns
 				of the record UNDER the cursor are
 				protected, not the next or previous record
 				in the chain: we cannot look at the next or
@@ -778,10 +847,15 @@ exit_func:
 
 static
 void
-btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
+btr_search_failure(
+	const dict_index_t*	index,
+	btr_search_t*		info,
+	btr_cur_t*		cursor)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	++btr_search_sys->part_stats[btr_search_get_part_no(index)].n_misses;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
 
@@ -815,13 +889,15 @@ btr_search_guess_on_hash(
 					to protect the record! */
 	btr_cur_t*	cursor,		/*!< out: tree cursor */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the adaptive
+					hash index partition latch of index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
 	const rec_t*	rec;
 	ulint		fold;
 	index_id_t	index_id;
+	rw_lock_t*	latch;
 #ifdef notdefined
 	btr_cur_t	cursor2;
 	btr_pcur_t	pcur;
@@ -856,29 +932,32 @@ btr_search_guess_on_hash(
 	cursor->fold = fold;
 	cursor->flag = BTR_CUR_HASH;
 
+	latch = btr_get_search_latch(index);
+
 	if (!has_search_latch) {
 
 		if (!btr_search_enabled) {
-			btr_search_failure(info, cursor);
+			btr_search_failure(index, info, cursor);
 
 			return(FALSE);
 		}
 
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(latch);
 	}
 
-	ut_ad(rw_lock_get_writer(&btr_search_latch) != RW_LOCK_X);
-	ut_ad(rw_lock_get_reader_count(&btr_search_latch) > 0);
+	ut_ad(rw_lock_get_writer(latch) != RW_LOCK_X);
+	ut_ad(rw_lock_get_reader_count(latch) > 0);
 
-	rec = (rec_t*) ha_search_and_get_data(btr_search_sys->hash_index, fold);
+	rec = (rec_t*) ha_search_and_get_data(
+		btr_get_search_table(index), fold);
 
 	if (rec == NULL) {
 
 		if (!has_search_latch) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(latch);
 		}
 
-		btr_search_failure(info, cursor);
+		btr_search_failure(index, info, cursor);
 
 		return(FALSE);
 	}
@@ -892,15 +971,15 @@ btr_search_guess_on_hash(
 			__FILE__, __LINE__, mtr)) {
 
 			if (!has_search_latch) {
-				rw_lock_s_unlock(&btr_search_latch);
+				rw_lock_s_unlock(latch);
 			}
 
-			btr_search_failure(info, cursor);
+			btr_search_failure(index, info, cursor);
 
 			return(FALSE);
 		}
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 	}
@@ -914,7 +993,7 @@ btr_search_guess_on_hash(
 			btr_leaf_page_release(block, latch_mode, mtr);
 		}
 
-		btr_search_failure(info, cursor);
+		btr_search_failure(index, info, cursor);
 
 		return(FALSE);
 	}
@@ -925,7 +1004,7 @@ btr_search_guess_on_hash(
 
 	/* Check the validity of the guess within the page */
 
-	/* If we only have the latch on btr_search_latch, not on the
+	/* If we only have the latch on the hash index partition, not on the
 	page, it only protects the columns of the record the cursor
 	is positioned on. We cannot look at the next of the previous
 	record to determine if our guess for the cursor position is
@@ -939,7 +1018,7 @@ btr_search_guess_on_hash(
 			btr_leaf_page_release(block, latch_mode, mtr);
 		}
 
-		btr_search_failure(info, cursor);
+		btr_search_failure(index, info, cursor);
 
 		return(FALSE);
 	}
@@ -986,6 +1065,8 @@ btr_search_guess_on_hash(
 #endif
 	info->last_hash_succ = TRUE;
 
+	++btr_search_sys->part_stats[btr_search_get_part_no(index)].n_hits;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
 #endif
@@ -1000,7 +1081,7 @@ btr_search_guess_on_hash(
 	{
 		buf_pool_t*	buf_pool = buf_pool_from_bpage(&block->page);
 
-		++buf_pool->stat.n_page_gets;
+		buf_pool->stat.n_page_gets.inc();
 	}
 
 	return(TRUE);
@@ -1036,30 +1117,42 @@ btr_search_drop_page_hash_index(
 	const dict_index_t*	index;
 	ulint*			offsets;
 	btr_search_t*		info;
+	rw_lock_t*		latch;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_S));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!btr_search_own_any(RW_LOCK_S));
+	ut_ad(!btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	/* Do a dirty check on block->index, return if the block is
 	not in the adaptive hash index. This is to avoid acquiring
-	shared btr_search_latch for performance consideration. */
+	a shared partition latch for performance consideration. */
 	if (!block->index) {
 		return;
 	}
 
+	/* We must not dereference block->index before holding the
+	partition latch, because the index could be freed meanwhile.
+	Determine the partition from the index id on the page instead. */
+	i = static_cast<ulint>(
+		btr_page_get_index_id(block->frame) % btr_ahi_parts);
+
+	latch = btr_search_latches[i];
+	table = btr_search_sys->hash_tables[i];
+
 retry:
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 	index = block->index;
 
 	if (UNIV_LIKELY(!index)) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		return;
 	}
 
+	ut_ad(btr_get_search_latch(index) == latch);
+
 	ut_a(!dict_index_is_ibuf(index));
 #ifdef UNIV_DEBUG
 	switch (dict_index_get_online_status(index)) {
@@ -1082,8 +1175,6 @@ retry:
 	}
 #endif /* UNIV_DEBUG */
 
-	table = btr_search_sys->hash_index;
-
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X)
@@ -1094,10 +1185,10 @@ retry:
 	n_fields = block->curr_n_fields;
 
 	/* NOTE: The fields of block must not be accessed after
-	releasing btr_search_latch, as the index page might only
+	releasing the partition latch, as the index page might only
 	be s-latched! */
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	ut_a(n_fields > 0);
 
@@ -1148,7 +1239,7 @@ next_rec:
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (UNIV_UNLIKELY(!block->index)) {
 		/* Someone else has meanwhile dropped the hash index */
@@ -1163,7 +1254,7 @@ next_rec:
 		/* Someone else has meanwhile built a new hash index on the
 		page, with different parameters */
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		mem_free(folds);
 		goto retry;
@@ -1194,14 +1285,14 @@ cleanup:
 			"InnoDB: the hash index to a page of %s,"
 			" still %lu hash nodes remain.\n",
 			index->name, (ulong) block->n_pointers);
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		ut_ad(btr_search_validate());
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 #else /* UNIV_AHI_DEBUG || UNIV_DEBUG */
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
 	mem_free(folds);
@@ -1274,35 +1365,38 @@ btr_search_build_page_hash_index(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	rw_lock_t*	latch;
 	rec_offs_init(offsets_);
 
 	ut_ad(index);
 	ut_a(!dict_index_is_ibuf(index));
 
+	latch = btr_get_search_latch(index);
+
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_X));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_S)
 	      || rw_lock_own(&(block->lock), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 
 	if (!btr_search_enabled) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 		return;
 	}
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
 	page = buf_block_get_frame(block);
 
 	if (block->index && ((block->curr_n_fields != n_fields)
 			     || (block->curr_left_side != left_side))) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		btr_search_drop_page_hash_index(block);
 	} else {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 	}
 
 	n_recs = page_get_n_recs(page);
@@ -1389,9 +1483,9 @@ btr_search_build_page_hash_index(
 		fold = next_fold;
 	}
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(index);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (UNIV_UNLIKELY(!btr_search_enabled)) {
 		goto exit_func;
@@ -1425,7 +1519,7 @@ btr_search_build_page_hash_index(
 	MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
 	MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_ADDED, n_cached);
 exit_func:
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 
 	mem_free(folds);
 	mem_free(recs);
@@ -1451,12 +1545,14 @@ btr_search_move_or_delete_hash_entries(
 					from this page */
 	dict_index_t*	index)		/*!< in: record descriptor */
 {
+	rw_lock_t*	latch = btr_get_search_latch(index);
+
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_X));
 	ut_ad(rw_lock_own(&(new_block->lock), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 
 	ut_a(!new_block->index || new_block->index == index);
 	ut_a(!block->index || block->index == index);
@@ -1465,7 +1561,7 @@ btr_search_move_or_delete_hash_entries(
 
 	if (new_block->index) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		btr_search_drop_page_hash_index(block);
 
@@ -1479,7 +1575,7 @@ btr_search_move_or_delete_hash_entries(
 		new_block->n_fields = block->curr_n_fields;
 		new_block->left_side = left_side;
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		ut_a(n_fields > 0);
 
@@ -1490,7 +1586,7 @@ btr_search_move_or_delete_hash_entries(
 		return;
 	}
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 }
 
 /********************************************************************//**
@@ -1508,6 +1604,7 @@ btr_search_update_hash_on_delete(
 	const rec_t*	rec;
 	ulint		fold;
 	dict_index_t*	index;
+	rw_lock_t*	latch;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	mem_heap_t*	heap		= NULL;
 	rec_offs_init(offsets_);
@@ -1529,7 +1626,8 @@ btr_search_update_hash_on_delete(
 	ut_a(block->curr_n_fields > 0);
 	ut_a(!dict_index_is_ibuf(index));
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
+	latch = btr_get_search_latch(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1540,7 +1638,7 @@ btr_search_update_hash_on_delete(
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (block->index) {
 		ut_a(block->index == index);
@@ -1553,7 +1651,7 @@ btr_search_update_hash_on_delete(
 		}
 	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 }
 
 /********************************************************************//**
@@ -1571,6 +1669,7 @@ btr_search_update_hash_node_on_insert(
 	buf_block_t*	block;
 	dict_index_t*	index;
 	rec_t*		rec;
+	rw_lock_t*	latch;
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1590,7 +1689,9 @@ btr_search_update_hash_node_on_insert(
 	ut_a(cursor->index == index);
 	ut_a(!dict_index_is_ibuf(index));
 
-	rw_lock_x_lock(&btr_search_latch);
+	latch = btr_get_search_latch(index);
+
+	rw_lock_x_lock(latch);
 
 	if (!block->index) {
 
@@ -1603,7 +1704,7 @@ btr_search_update_hash_node_on_insert(
 	    && (cursor->n_fields == block->curr_n_fields)
 	    && !block->curr_left_side) {
 
-		table = btr_search_sys->hash_index;
+		table = btr_get_search_table(index);
 
 		if (ha_search_and_update_if_found(
 			table, cursor->fold, rec, block,
@@ -1612,9 +1713,9 @@ btr_search_update_hash_node_on_insert(
 		}
 
 func_exit:
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		btr_search_update_hash_on_insert(cursor);
 	}
@@ -1646,6 +1747,7 @@ btr_search_update_hash_on_insert(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	rw_lock_t*	latch;
 	rec_offs_init(offsets_);
 
 	block = btr_cur_get_block(cursor);
@@ -1661,9 +1763,10 @@ btr_search_update_hash_on_insert(
 		return;
 	}
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(index);
 
-	table = btr_search_sys->hash_index;
+	table = btr_get_search_table(index);
+	latch = btr_get_search_latch(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1693,7 +1796,7 @@ btr_search_update_hash_on_insert(
 	} else {
 		if (left_side) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 
 			locked = TRUE;
 
@@ -1711,7 +1814,7 @@ btr_search_update_hash_on_insert(
 
 		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 
 			locked = TRUE;
 
@@ -1733,7 +1836,7 @@ check_next_rec:
 		if (!left_side) {
 
 			if (!locked) {
-				rw_lock_x_lock(&btr_search_latch);
+				rw_lock_x_lock(latch);
 
 				locked = TRUE;
 
@@ -1752,7 +1855,7 @@ check_next_rec:
 
 		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 
 			locked = TRUE;
 
@@ -1779,18 +1882,19 @@ function_exit:
 		mem_heap_free(heap);
 	}
 	if (locked) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 }
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 /********************************************************************//**
-Validates the search system.
+Validates one partition of the search system.
 @return TRUE if ok */
-
+static
 ibool
-btr_search_validate(void)
-/*=====================*/
+btr_search_hash_table_validate(
+/*===========================*/
+	ulint	hash_table_id)	/*!< in: partition number */
 {
 	ha_node_t*	node;
 	ulint		n_page_dumps	= 0;
@@ -1800,31 +1904,35 @@ btr_search_validate(void)
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	rw_lock_t*	latch		= btr_search_latches[hash_table_id];
+	hash_table_t*	table;
 
 	/* How many cells to check before temporarily releasing
-	btr_search_latch. */
+	the partition latch. */
 	ulint		chunk_size = 10000;
 
 	rec_offs_init(offsets_);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 	buf_pool_mutex_enter_all();
 
-	cell_count = hash_get_n_cells(btr_search_sys->hash_index);
+	table = btr_search_sys->hash_tables[hash_table_id];
+
+	cell_count = hash_get_n_cells(table);
 
 	for (i = 0; i < cell_count; i++) {
-		/* We release btr_search_latch every once in a while to
+		/* We release the partition latch every once in a while to
 		give other queries a chance to run. */
 		if ((i != 0) && ((i % chunk_size) == 0)) {
 			buf_pool_mutex_exit_all();
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(latch);
 			os_thread_yield();
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			buf_pool_mutex_enter_all();
 		}
 
 		node = (ha_node_t*)
-			hash_get_nth_cell(btr_search_sys->hash_index, i)->node;
+			hash_get_nth_cell(table, i)->node;
 
 		for (; node != NULL; node = node->next) {
 			const buf_block_t*	block
@@ -1862,7 +1970,7 @@ btr_search_validate(void)
 				After that, it invokes
 				btr_search_drop_page_hash_index() to
 				remove the block from
-				btr_search_sys->hash_index. */
+				the adaptive hash index. */
 
 				ut_a(buf_block_get_state(block)
 				     == BUF_BLOCK_REMOVE_HASH);
@@ -1925,27 +2033,69 @@ btr_search_validate(void)
 	for (i = 0; i < cell_count; i += chunk_size) {
 		ulint end_index = ut_min(i + chunk_size - 1, cell_count - 1);
 
-		/* We release btr_search_latch every once in a while to
+		/* We release the partition latch every once in a while to
 		give other queries a chance to run. */
 		if (i != 0) {
 			buf_pool_mutex_exit_all();
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(latch);
 			os_thread_yield();
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			buf_pool_mutex_enter_all();
 		}
 
-		if (!ha_validate(btr_search_sys->hash_index, i, end_index)) {
+		if (!ha_validate(table, i, end_index)) {
 			ok = FALSE;
 		}
 	}
 
 	buf_pool_mutex_exit_all();
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
 	}
 
 	return(ok);
 }
+
+/********************************************************************//**
+Validates the search system.
+@return TRUE if ok */
+
+ibool
+btr_search_validate(void)
+/*=====================*/
+{
+	ibool	ok = TRUE;
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		if (!btr_search_hash_table_validate(i)) {
+			ok = FALSE;
+		}
+	}
+
+	return(ok);
+}
 #endif /* defined UNIV_AHI_DEBUG || defined UNIV_DEBUG */
+
+/********************************************************************//**
+Prints the adaptive hash index partition statistics for
+SHOW ENGINE INNODB STATUS. */
+
+void
+btr_search_print_info(
+/*==================*/
+	FILE*	file)	/*!< in: file where to print */
+{
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		const btr_search_part_stats_t*	stats
+			= &btr_search_sys->part_stats[i];
+
+		fprintf(file, "Partition %lu: ", (ulong) i);
+
+		ha_print_info(file, btr_search_sys->hash_tables[i]);
+
+		fprintf(file, "Partition %lu: %lu hits, %lu misses\n",
+			(ulong) i, (ulong) stats->n_hits,
+			(ulong) stats->n_misses);
+	}
+}
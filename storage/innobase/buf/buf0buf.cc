@@ -56,6 +56,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0log.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "srv0mon.h"
@@ -64,6 +65,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0checksum.h"
 #include "sync0sync.h"
 
+#include <algorithm>
 #include <new>
 
 /*
@@ -159,6 +161,12 @@ There are several lists of control blocks.
 The free list (buf_pool->free) contains blocks which are currently not
 used.
 
+The withdraw list (buf_pool->withdraw) contains free blocks of the
+chunks that buf_pool_resize() is removing from the buffer pool.  While
+an instance is being shrunk, such blocks are put on it instead of the
+free list, and the pages in them are evicted, until all the blocks of
+the chunks are on it and the chunks can be freed.
+
 The common LRU list contains all the blocks holding a file page
 except those for which the bufferfix count is non-zero.
 The pages are in the LRU list roughly in the order of the last
@@ -263,6 +271,23 @@ static const ulint BUF_PAGE_READ_MAX_RETRIES = 100;
 /** The buffer pools of the database */
 buf_pool_t*	buf_pool_ptr;
 
+/** true while buf_pool_resize() is withdrawing blocks from the
+buffer pool: saved block pointers must not be dereferenced */
+volatile bool	buf_pool_withdrawing;
+
+/** Incremented each time buf_pool_resize() has removed chunks from
+a buffer pool instance */
+volatile ulint	buf_withdraw_clock;
+
+/** Number of threads reading the blocks of buf_pool->chunks[]
+without holding buf_pool->mutex, see buf_pool_chunks_pin() */
+static ulint	buf_pool_chunk_pins;
+
+/** Number of rounds of buf_pool_withdraw_blocks() without any block
+withdrawn, after which buf_pool_resize() gives up shrinking an
+instance */
+static const ulint	BUF_POOL_WITHDRAW_MAX_IDLE_ROUNDS = 30;
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 /** This is used to insert validation operations in execution
 in the debug version */
@@ -413,7 +438,7 @@ buf_get_total_stat(
 		buf_pool = buf_pool_from_array(i);
 
 		buf_stat = &buf_pool->stat;
-		tot_stat->n_page_gets += buf_stat->n_page_gets;
+		tot_stat->n_page_gets.add(buf_stat->n_page_gets);
 		tot_stat->n_pages_read += buf_stat->n_pages_read;
 		tot_stat->n_pages_written += buf_stat->n_pages_written;
 		tot_stat->n_pages_created += buf_stat->n_pages_created;
@@ -1168,6 +1193,11 @@ buf_chunk_init(
 		return(NULL);
 	}
 
+	/* Place the memory on the NUMA node of the instance before
+	the block descriptors and frames are first touched below. */
+	os_numa_bind_mem(chunk->mem, chunk->mem_size,
+			 buf_pool_index(buf_pool));
+
 	/* Allocate the block descriptors from
 	the start of the memory block. */
 	chunk->blocks = (buf_block_t*) chunk->mem;
@@ -1220,6 +1250,28 @@ buf_chunk_init(
 	return(chunk);
 }
 
+/********************************************************************//**
+Frees the memory of a chunk of buffer frames.  The blocks must not be
+used nor be on any list. */
+static
+void
+buf_chunk_free(
+/*===========*/
+	buf_chunk_t*	chunk)	/*!< in/out: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+
+	for (ulint i = chunk->size; i--; block++) {
+		mutex_free(&block->mutex);
+		rw_lock_free(&block->lock);
+#ifdef UNIV_SYNC_DEBUG
+		rw_lock_free(&block->debug_latch);
+#endif /* UNIV_SYNC_DEBUG */
+	}
+
+	os_mem_free_large(chunk->mem, chunk->mem_size);
+}
+
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Finds a block in the given buffer chunk that points to a
@@ -1373,13 +1425,21 @@ buf_pool_init_instance(
 	buf_pool_mutex_enter(buf_pool);
 
 	if (buf_pool_size > 0) {
-		buf_pool->n_chunks = 1;
+		ulint	chunk_size = srv_buf_pool_chunk_unit;
+
+		if (chunk_size == 0 || chunk_size > buf_pool_size) {
+			chunk_size = buf_pool_size;
+		}
 
-		buf_pool->chunks = chunk =
-			(buf_chunk_t*) mem_zalloc(sizeof *chunk);
+		buf_pool->n_chunks = buf_pool->n_chunks_new =
+			(buf_pool_size + chunk_size - 1) / chunk_size;
+
+		buf_pool->chunks = static_cast<buf_chunk_t*>(
+			mem_zalloc(buf_pool->n_chunks * sizeof *chunk));
 
 		UT_LIST_INIT(buf_pool->LRU, &buf_page_t::LRU);
 		UT_LIST_INIT(buf_pool->free, &buf_page_t::list);
+		UT_LIST_INIT(buf_pool->withdraw, &buf_page_t::list);
 		UT_LIST_INIT(buf_pool->flush_list, &buf_page_t::list);
 		UT_LIST_INIT(buf_pool->unzip_LRU, &buf_block_t::unzip_LRU);
 
@@ -1392,17 +1452,31 @@ buf_pool_init_instance(
 				buf_pool->zip_free[i], &buf_buddy_free_t::list);
 		}
 
-		if (!buf_chunk_init(buf_pool, chunk, buf_pool_size)) {
-			mem_free(chunk);
-			mem_free(buf_pool);
+		buf_pool->curr_size = 0;
 
-			buf_pool_mutex_exit(buf_pool);
+		for (i = 0, chunk = buf_pool->chunks;
+		     i < buf_pool->n_chunks;
+		     i++, chunk++) {
 
-			return(DB_ERROR);
+			if (!buf_chunk_init(buf_pool, chunk,
+					    ut_min(chunk_size, buf_pool_size
+						   - i * chunk_size))) {
+
+				while (--chunk >= buf_pool->chunks) {
+					buf_chunk_free(chunk);
+				}
+
+				mem_free(buf_pool->chunks);
+
+				buf_pool_mutex_exit(buf_pool);
+
+				return(DB_ERROR);
+			}
+
+			buf_pool->curr_size += chunk->size;
 		}
 
 		buf_pool->instance_no = instance_no;
-		buf_pool->curr_size = chunk->size;
 		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
 
 		/* Number of locks protecting page_hash must be a
@@ -1449,6 +1523,9 @@ buf_pool_init_instance(
 	/* Initialize the iterator for single page scan search */
 	new(&buf_pool->single_scan_itr) LRUItr(buf_pool, &buf_pool->mutex);
 
+	/* Initialize the hazard pointer for withdrawing blocks */
+	new(&buf_pool->withdraw_hp) LRUHp(buf_pool, &buf_pool->mutex);
+
 	buf_pool_mutex_exit(buf_pool);
 
 	return(DB_SUCCESS);
@@ -1498,17 +1575,7 @@ buf_pool_free_instance(
 	chunk = chunks + buf_pool->n_chunks;
 
 	while (--chunk >= chunks) {
-		buf_block_t*	block = chunk->blocks;
-
-		for (ulint i = chunk->size; i--; block++) {
-			mutex_free(&block->mutex);
-			rw_lock_free(&block->lock);
-#ifdef UNIV_SYNC_DEBUG
-			rw_lock_free(&block->debug_latch);
-# endif /* UNIV_SYNC_DEBUG */
-		}
-
-		os_mem_free_large(chunk->mem, chunk->mem_size);
+		buf_chunk_free(chunk);
 	}
 
 	for (ulint i = BUF_FLUSH_LRU; i < BUF_FLUSH_N_TYPES; ++i) {
@@ -1516,6 +1583,10 @@ buf_pool_free_instance(
 	}
 
 	mem_free(buf_pool->chunks);
+
+	if (buf_pool->chunks_old != NULL) {
+		mem_free(buf_pool->chunks_old);
+	}
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
@@ -1578,6 +1649,600 @@ buf_pool_free(
 	buf_pool_ptr = NULL;
 }
 
+/********************************************************************//**
+Rounds a buffer pool size up to a multiple of
+innodb_buffer_pool_chunk_size times innodb_buffer_pool_instances, the
+unit in which buf_pool_resize() grows and shrinks the buffer pool.
+@return size in bytes */
+
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size)	/*!< in: size in bytes */
+{
+	const ulint	unit = srv_buf_pool_chunk_unit * srv_buf_pool_instances;
+
+	if (unit == 0 || size % unit == 0) {
+		return(size);
+	}
+
+	return((size / unit + 1) * unit);
+}
+
+/********************************************************************//**
+Prevents buf_pool_resize() from freeing any chunk of the buffer pool,
+for a caller that reads the blocks of buf_pool->chunks[] without holding
+buf_pool->mutex.  Must be followed by buf_pool_chunks_unpin(). */
+
+void
+buf_pool_chunks_pin(void)
+/*=====================*/
+{
+	/* A full memory barrier: buf_pool_resize() either sees the pin,
+	or has already removed the chunks from buf_pool->n_chunks. */
+	os_atomic_increment_ulint(&buf_pool_chunk_pins, 1);
+}
+
+/********************************************************************//**
+Allows buf_pool_resize() to free chunks again, see
+buf_pool_chunks_pin(). */
+
+void
+buf_pool_chunks_unpin(void)
+/*=======================*/
+{
+	ut_ad(buf_pool_chunk_pins > 0);
+
+	os_atomic_decrement_ulint(&buf_pool_chunk_pins, 1);
+}
+
+/********************************************************************//**
+Waits until no thread reads chunks that buf_pool_resize() has removed
+from buf_pool->n_chunks or from buf_pool->chunks, see
+buf_pool_chunks_pin(). */
+static
+void
+buf_pool_wait_for_chunk_pins(void)
+/*==============================*/
+{
+	os_mb();
+
+	while (buf_pool_chunk_pins > 0) {
+		os_thread_sleep(10000);
+	}
+}
+
+/********************************************************************//**
+Sets the global variable that feeds MySQL's
+innodb_buffer_pool_resize_status to the specified string, and writes it
+to the error log if requested. The format and the following parameters
+are the same as the ones used for printf(3). */
+static __attribute__((nonnull, format(printf, 2, 3)))
+void
+buf_resize_status(
+/*==============*/
+	bool		log,	/*!< in: whether to write the status
+				to the error log */
+	const char*	fmt,	/*!< in: format */
+	...)			/*!< in: extra parameters according
+				to fmt */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+
+	ut_vsnprintf(
+		export_vars.innodb_buffer_pool_resize_status,
+		sizeof(export_vars.innodb_buffer_pool_resize_status),
+		fmt, ap);
+
+	va_end(ap);
+
+	if (log) {
+		ib_logf(IB_LOG_LEVEL_INFO, "%s",
+			export_vars.innodb_buffer_pool_resize_status);
+	}
+}
+
+/********************************************************************//**
+Gets the fold value of a page in buf_pool->page_hash.
+@return fold value */
+static
+ulint
+buf_page_hash_fold(
+/*===============*/
+	const buf_page_t*	bpage)	/*!< in: page in page_hash */
+{
+	return(buf_page_address_fold(bpage->space, bpage->offset));
+}
+
+/********************************************************************//**
+Resizes buf_pool->page_hash and buf_pool->zip_hash to the current size
+of a buffer pool instance, if it is more than twice as big or small as
+the hash tables were made for.  The sync objects of page_hash are kept,
+only its cell array is replaced, while all of them are held: see
+hash_calc_n_cells(). */
+static
+void
+buf_pool_resize_hash(
+/*=================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	hash_table_t*	new_hash;
+	const ulint	n_cells = 2 * buf_pool->curr_size;
+	const ulint	old_n_cells = hash_get_n_cells(buf_pool->page_hash);
+
+	if (old_n_cells < n_cells * 2 && old_n_cells > n_cells / 2) {
+		return;
+	}
+
+	buf_pool_mutex_enter(buf_pool);
+
+	new_hash = hash_create_n_cells(
+		hash_calc_n_cells(n_cells, buf_pool->page_hash->n_sync_obj));
+
+	hash_lock_x_all(buf_pool->page_hash);
+
+	HASH_MIGRATE(buf_pool->page_hash, new_hash, buf_page_t, hash,
+		     buf_page_hash_fold);
+
+	std::swap(buf_pool->page_hash->array, new_hash->array);
+	std::swap(buf_pool->page_hash->n_cells, new_hash->n_cells);
+
+	hash_unlock_x_all(buf_pool->page_hash);
+
+	/* Free the old cell array. */
+	hash_table_free(new_hash);
+
+	/* The zip_hash is only accessed under buf_pool->mutex. */
+	new_hash = hash_create(n_cells);
+
+	HASH_MIGRATE(buf_pool->zip_hash, new_hash, buf_page_t, hash,
+		     BUF_POOL_ZIP_FOLD_BPAGE);
+
+	hash_table_free(buf_pool->zip_hash);
+	buf_pool->zip_hash = new_hash;
+
+	buf_pool_mutex_exit(buf_pool);
+}
+
+/********************************************************************//**
+Adds chunks to a buffer pool instance.  The chunks array is replaced by
+a bigger copy, which is published before the new number of chunks, so
+that buf_block_align() can keep reading it without a mutex: the
+replaced array is only freed by the next resize.
+@return true if all the chunks could be allocated */
+static
+bool
+buf_pool_grow_instance(
+/*===================*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	ulint		n_chunks)	/*!< in: new number of chunks */
+{
+	buf_chunk_t*	chunks;
+	bool		success = true;
+
+	ut_ad(n_chunks > buf_pool->n_chunks);
+
+	chunks = static_cast<buf_chunk_t*>(
+		mem_zalloc(n_chunks * sizeof *chunks));
+
+	buf_pool_mutex_enter(buf_pool);
+
+	memcpy(chunks, buf_pool->chunks,
+	       buf_pool->n_chunks * sizeof *chunks);
+
+	buf_chunk_t*	old_chunks = buf_pool->chunks;
+
+	buf_pool->chunks = chunks;
+
+	buf_pool_mutex_exit(buf_pool);
+
+	/* Any thread still reading the array that chunks_old points to
+	did so before the previous resize completed. */
+	buf_pool_wait_for_chunk_pins();
+
+	if (buf_pool->chunks_old != NULL) {
+		mem_free(buf_pool->chunks_old);
+	}
+
+	buf_pool->chunks_old = old_chunks;
+
+	while (buf_pool->n_chunks < n_chunks) {
+		buf_chunk_t*	chunk = chunks + buf_pool->n_chunks;
+
+		/* buf_chunk_init() puts the blocks on the free list,
+		which must not be used before the chunk is visible. */
+		buf_pool_mutex_enter(buf_pool);
+
+		if (!buf_chunk_init(buf_pool, chunk,
+				    srv_buf_pool_chunk_unit)) {
+
+			buf_pool_mutex_exit(buf_pool);
+
+			ib_logf(IB_LOG_LEVEL_ERROR,
+				"Cannot allocate %lu bytes of memory for"
+				" buffer pool instance %lu.",
+				(ulong) srv_buf_pool_chunk_unit,
+				(ulong) buf_pool->instance_no);
+
+			success = false;
+			break;
+		}
+
+		os_mb();
+
+		buf_pool->n_chunks++;
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
+		buf_pool->curr_size += chunk->size;
+		buf_pool->curr_pool_size = buf_pool->curr_size
+			* UNIV_PAGE_SIZE;
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+
+	return(success);
+}
+
+/********************************************************************//**
+Evicts the pages of the LRU list which are in the chunks that are being
+removed from a buffer pool instance, so that their blocks are withdrawn
+when freed.  Dirty pages are written out first, at most
+innodb_lru_scan_depth of them per call.  The mutex is released every
+innodb_lru_scan_depth pages so as not to stall the other threads. */
+static
+void
+buf_pool_withdraw_evict(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	ulint		n_flushed = 0;
+	ulint		n_scanned = 0;
+	buf_page_t*	bpage;
+
+	buf_pool_mutex_enter(buf_pool);
+
+	for (bpage = UT_LIST_GET_LAST(buf_pool->LRU);
+	     bpage != NULL;
+	     bpage = buf_pool->withdraw_hp.get()) {
+
+		buf_pool->withdraw_hp.set(UT_LIST_GET_PREV(LRU, bpage));
+
+		if (buf_pool_will_withdraw(buf_pool, bpage)
+		    || (bpage->zip.data != NULL
+			&& buf_pool_will_withdraw(
+				buf_pool, bpage->zip.data))) {
+
+			BPageMutex*	block_mutex = buf_page_get_mutex(bpage);
+
+			mutex_enter(block_mutex);
+
+			if (buf_flush_ready_for_replace(bpage)) {
+				mutex_exit(block_mutex);
+
+				/* This may release buf_pool->mutex. */
+				buf_LRU_free_page(bpage, true);
+
+			} else if (n_flushed < srv_LRU_scan_depth
+				   && buf_flush_ready_for_flush(
+					   bpage, BUF_FLUSH_SINGLE_PAGE)) {
+
+				/* Releases both mutexes, the page is
+				evicted once written. */
+				buf_flush_page(buf_pool, bpage,
+					       BUF_FLUSH_SINGLE_PAGE, true);
+				n_flushed++;
+
+				buf_pool_mutex_enter(buf_pool);
+			} else {
+				mutex_exit(block_mutex);
+			}
+		}
+
+		if (++n_scanned % srv_LRU_scan_depth == 0) {
+			buf_pool_mutex_exit(buf_pool);
+			os_thread_yield();
+			buf_pool_mutex_enter(buf_pool);
+		}
+	}
+
+	buf_pool->withdraw_hp.set(NULL);
+
+	buf_pool_mutex_exit(buf_pool);
+}
+
+/********************************************************************//**
+Withdraws all the blocks of the chunks that are being removed from a
+buffer pool instance, in rounds of moving their free blocks to the
+withdraw list and evicting the pages in the others.
+@return true if all the blocks were withdrawn, false if no progress was
+made for BUF_POOL_WITHDRAW_MAX_IDLE_ROUNDS rounds or if the server is
+shutting down */
+static
+bool
+buf_pool_withdraw_blocks(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	ulint	n_idle_rounds = 0;
+	ulint	n_withdrawn_before = 0;
+
+	for (;;) {
+		ulint	n_withdrawn;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		buf_page_t*	bpage = UT_LIST_GET_FIRST(buf_pool->free);
+
+		while (bpage != NULL) {
+			buf_page_t*	next = UT_LIST_GET_NEXT(list, bpage);
+
+			if (buf_pool_will_withdraw(buf_pool, bpage)) {
+				ut_ad(bpage->in_free_list);
+				ut_d(bpage->in_free_list = FALSE);
+				UT_LIST_REMOVE(buf_pool->free, bpage);
+				UT_LIST_ADD_LAST(buf_pool->withdraw, bpage);
+			}
+
+			bpage = next;
+		}
+
+		n_withdrawn = UT_LIST_GET_LEN(buf_pool->withdraw);
+
+		buf_pool_mutex_exit(buf_pool);
+
+		if (n_withdrawn >= buf_pool->withdraw_target) {
+			return(true);
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			return(false);
+		}
+
+		if (n_withdrawn > n_withdrawn_before) {
+			n_idle_rounds = 0;
+		} else if (++n_idle_rounds > BUF_POOL_WITHDRAW_MAX_IDLE_ROUNDS) {
+			return(false);
+		}
+
+		n_withdrawn_before = n_withdrawn;
+
+		buf_resize_status(
+			false, "Withdrawing blocks from buffer pool"
+			" instance %lu: %lu of %lu.",
+			(ulong) buf_pool->instance_no, (ulong) n_withdrawn,
+			(ulong) buf_pool->withdraw_target);
+
+		buf_pool_withdraw_evict(buf_pool);
+
+		/* Throttle the eviction, and give the pages which are
+		in use some time to be released. */
+		os_thread_sleep(n_idle_rounds > 0 ? 1000000 : 10000);
+	}
+}
+
+/********************************************************************//**
+Removes chunks from a buffer pool instance.  The blocks of the chunks
+are withdrawn first, then the chunks are removed from buf_pool->n_chunks
+while buf_pool->mutex and all the page_hash locks are held, and freed
+once no thread can be reading them.
+@return true if the chunks were removed, false if their blocks could not
+all be withdrawn */
+static
+bool
+buf_pool_shrink_instance(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	ulint		n_chunks)	/*!< in: new number of chunks */
+{
+	const buf_chunk_t*	chunk;
+	ulint			n_chunks_old = buf_pool->n_chunks;
+	buf_page_t*		bpage;
+
+	ut_ad(n_chunks > 0);
+	ut_ad(n_chunks < n_chunks_old);
+
+	buf_pool_mutex_enter(buf_pool);
+
+	buf_pool->withdraw_target = 0;
+
+	for (chunk = buf_pool->chunks + n_chunks;
+	     chunk < buf_pool->chunks + n_chunks_old;
+	     chunk++) {
+
+		buf_pool->withdraw_target += chunk->size;
+	}
+
+	buf_pool->n_chunks_new = n_chunks;
+
+	buf_pool_mutex_exit(buf_pool);
+
+	bool	success = buf_pool_withdraw_blocks(buf_pool);
+
+	buf_pool_mutex_enter(buf_pool);
+
+	if (!success) {
+		/* Give the withdrawn blocks back. */
+		while ((bpage = UT_LIST_GET_FIRST(buf_pool->withdraw))
+		       != NULL) {
+
+			UT_LIST_REMOVE(buf_pool->withdraw, bpage);
+			UT_LIST_ADD_LAST(buf_pool->free, bpage);
+			ut_d(bpage->in_free_list = TRUE);
+		}
+
+		buf_pool->n_chunks_new = n_chunks_old;
+		buf_pool->withdraw_target = 0;
+
+		buf_pool_mutex_exit(buf_pool);
+
+		return(false);
+	}
+
+	/* All the blocks of the chunks are on the withdraw list, and no
+	other block can be added to it. */
+	ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw)
+	      == buf_pool->withdraw_target);
+
+	hash_lock_x_all(buf_pool->page_hash);
+
+	UT_LIST_INIT(buf_pool->withdraw, &buf_page_t::list);
+
+	buf_pool->n_chunks = n_chunks;
+	buf_pool->curr_size -= buf_pool->withdraw_target;
+	buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
+	buf_pool->withdraw_target = 0;
+
+	os_atomic_increment_ulint(&buf_withdraw_clock, 1);
+
+	hash_unlock_x_all(buf_pool->page_hash);
+
+	buf_pool_mutex_exit(buf_pool);
+
+	buf_pool_wait_for_chunk_pins();
+
+	for (ulint i = n_chunks; i < n_chunks_old; i++) {
+		buf_chunk_free(buf_pool->chunks + i);
+	}
+
+	return(true);
+}
+
+/********************************************************************//**
+Resizes the buffer pool to srv_buf_pool_size, one instance at a time.
+The adaptive hash index is disabled meanwhile, and its hash tables are
+resized along with the ones of the buffer pool. */
+static
+void
+buf_pool_resize(void)
+/*=================*/
+{
+	const ulint	old_size = buf_pool_get_curr_size();
+	const ulint	new_size = srv_buf_pool_size;
+	const ulint	n_chunks = ut_max(
+		new_size / srv_buf_pool_instances / srv_buf_pool_chunk_unit,
+		1UL);
+	bool		success = true;
+
+	ut_ad(srv_buf_pool_chunk_unit > 0);
+
+	buf_resize_status(
+		true, "Resizing the buffer pool from %lu to %lu bytes.",
+		(ulong) old_size, (ulong) new_size);
+
+	const bool	btr_search_was_enabled = btr_search_enabled;
+
+	if (btr_search_was_enabled) {
+		buf_resize_status(
+			true, "Disabling the adaptive hash index.");
+
+		btr_search_disable();
+	}
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		if (n_chunks > buf_pool->n_chunks) {
+			buf_resize_status(
+				true, "Adding %lu chunks to buffer pool"
+				" instance %lu.",
+				(ulong) (n_chunks - buf_pool->n_chunks),
+				(ulong) i);
+
+			if (!buf_pool_grow_instance(buf_pool, n_chunks)) {
+				success = false;
+			}
+		} else if (n_chunks < buf_pool->n_chunks) {
+			buf_resize_status(
+				true, "Removing %lu chunks from buffer pool"
+				" instance %lu.",
+				(ulong) (buf_pool->n_chunks - n_chunks),
+				(ulong) i);
+
+			buf_pool_withdrawing = true;
+
+			if (!buf_pool_shrink_instance(buf_pool, n_chunks)) {
+				ib_logf(IB_LOG_LEVEL_WARN,
+					"Could not free the chunks of buffer"
+					" pool instance %lu: some of their"
+					" pages stayed in use.", (ulong) i);
+				success = false;
+			}
+
+			buf_pool_withdrawing = false;
+		}
+
+		buf_pool_resize_hash(buf_pool);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			success = false;
+			break;
+		}
+	}
+
+	buf_pool_set_sizes();
+
+	btr_search_sys_resize(buf_pool_get_curr_size() / sizeof(void*) / 64);
+
+	if (btr_search_was_enabled) {
+		btr_search_enable();
+	}
+
+	ibuf_max_size_update(srv_change_buffer_max_size);
+
+	if (success) {
+		buf_resize_status(
+			true, "Completed resizing the buffer pool to %lu"
+			" bytes.", (ulong) buf_pool_get_curr_size());
+	} else {
+		buf_resize_status(
+			true, "Resizing the buffer pool to %lu bytes failed,"
+			" the buffer pool size is %lu bytes.",
+			(ulong) new_size, (ulong) buf_pool_get_curr_size());
+	}
+}
+
+/********************************************************************//**
+This is the thread which resizes the buffer pool to
+innodb_buffer_pool_size when it is signalled through
+srv_buf_resize_event.
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter
+						required by os_thread_create */
+{
+	srv_buf_resize_thread_active = TRUE;
+
+	buf_resize_status(false, "not started");
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		os_event_wait(srv_buf_resize_event);
+		os_event_reset(srv_buf_resize_event);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		if (srv_buf_pool_size == srv_buf_pool_old_size) {
+			continue;
+		}
+
+		buf_pool_resize();
+	}
+
+	srv_buf_resize_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /********************************************************************//**
 Clears the adaptive hash index on all pages in the buffer pool. */
 
@@ -1588,12 +2253,16 @@ buf_pool_clear_hash_index(void)
 	ulint	p;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_all(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(!btr_search_enabled);
 
 	for (p = 0; p < srv_buf_pool_instances; p++) {
 		buf_pool_t*	buf_pool = buf_pool_from_array(p);
+
+		/* buf_pool_resize() may be adding or removing chunks. */
+		buf_pool_mutex_enter(buf_pool);
+
 		buf_chunk_t*	chunks	= buf_pool->chunks;
 		buf_chunk_t*	chunk	= chunks + buf_pool->n_chunks;
 
@@ -1605,7 +2274,8 @@ buf_pool_clear_hash_index(void)
 				dict_index_t*	index	= block->index;
 
 				/* We can set block->index = NULL
-				when we have an x-latch on btr_search_latch;
+				when we have x-latches on all the
+				btr_search_latches;
 				see the comment in buf0buf.h */
 
 				if (!index) {
@@ -1619,6 +2289,8 @@ buf_pool_clear_hash_index(void)
 # endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 			}
 		}
+
+		buf_pool_mutex_exit(buf_pool);
 	}
 }
 
@@ -2071,6 +2743,46 @@ buf_page_make_young(
 	buf_pool_mutex_exit(buf_pool);
 }
 
+/********************************************************************//**
+Moves a page which a scan-resistant scan is done with to the end of the
+buffer pool LRU list, so that its frame is the next one to be replaced,
+unless the page was accessed before the scan started, or has been made
+young since.
+@return TRUE if the page was moved */
+
+ibool
+buf_page_release_scanned(
+/*=====================*/
+	ulint		space,		/*!< in: space id */
+	ulint		offset,		/*!< in: page number */
+	unsigned	scan_start)	/*!< in: ut_time_ms() when the
+					scan started */
+{
+	buf_page_t*	bpage;
+	ibool		moved = FALSE;
+	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
+
+	buf_pool_mutex_enter(buf_pool);
+
+	bpage = buf_page_hash_get(buf_pool, space, offset);
+
+	/* The access time is truncated to 32 bits: around a wrap-around,
+	a page read by the scan may not be moved, which is harmless. */
+
+	if (bpage != NULL
+	    && buf_page_in_file(bpage)
+	    && buf_page_is_old(bpage)
+	    && buf_page_is_accessed(bpage) >= scan_start) {
+
+		buf_LRU_make_block_old(bpage);
+		moved = TRUE;
+	}
+
+	buf_pool_mutex_exit(buf_pool);
+
+	return(moved);
+}
+
 /********************************************************************//**
 Moves a page to the start of the buffer pool LRU list if it is too old.
 This high-level function can be used to prevent an important page from
@@ -2240,7 +2952,7 @@ buf_page_get_zip(
 	ibool		must_read;
 	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
 
-	buf_pool->stat.n_page_gets++;
+	buf_pool->stat.n_page_gets.inc();
 
 	for (;;) {
 lookup:
@@ -2453,15 +3165,24 @@ buf_block_align_instance(
 					resides */
 	const byte*	ptr)		/*!< in: pointer to a frame */
 {
-	buf_chunk_t*	chunk;
-	ulint		i;
+	const buf_chunk_t*	chunk;
+	ulint			i;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	for (chunk = buf_pool->chunks, i = buf_pool->n_chunks; i--; chunk++) {
+	/* buf_pool_resize() publishes a grown chunks array before the
+	new n_chunks, and keeps the descriptors of removed chunks in
+	the array, so that no mutex is needed as long as n_chunks is
+	read first and only the descriptors are read before the chunk
+	is known to contain ptr. */
+	i = *reinterpret_cast<volatile ulint*>(&buf_pool->n_chunks);
+	chunk = *reinterpret_cast<buf_chunk_t* volatile*>(&buf_pool->chunks);
+
+	for (; i--; chunk++) {
 		ulint	offs;
 
-		if (UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
+		if (ptr < chunk->mem
+		    || ptr >= static_cast<const byte*>(chunk->mem)
+		    + chunk->mem_size
+		    || UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
 
 			continue;
 		}
@@ -2570,11 +3291,14 @@ buf_pointer_is_block_field_instance(
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	const void*	ptr)		/*!< in: pointer not dereferenced */
 {
-	const buf_chunk_t*		chunk	= buf_pool->chunks;
-	const buf_chunk_t* const	echunk	= chunk + buf_pool->n_chunks;
+	/* See buf_block_align_instance() on reading the chunks without
+	holding the mutex. */
+	const ulint			n_chunks = *reinterpret_cast<
+		volatile ulint*>(&buf_pool->n_chunks);
+	const buf_chunk_t*		chunk	= *reinterpret_cast<
+		buf_chunk_t* volatile*>(&buf_pool->chunks);
+	const buf_chunk_t* const	echunk	= chunk + n_chunks;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
 	while (chunk < echunk) {
 		if (ptr >= (void*) chunk->blocks
 		    && ptr < (void*) (chunk->blocks + chunk->size)) {
@@ -2713,7 +3437,7 @@ buf_page_get_gen(
 	      || ibuf_page_low(space, zip_size, offset,
 			       FALSE, file, line, NULL));
 #endif
-	buf_pool->stat.n_page_gets++;
+	buf_pool->stat.n_page_gets.inc();
 	fold = buf_page_address_fold(space, offset);
 	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 loop:
@@ -3293,7 +4017,7 @@ buf_page_optimistic_get(
 			    buf_block_get_page_no(block)) == 0);
 #endif
 	buf_pool = buf_pool_from_block(block);
-	buf_pool->stat.n_page_gets++;
+	buf_pool->stat.n_page_gets.inc();
 
 	return(TRUE);
 }
@@ -3403,7 +4127,7 @@ buf_page_get_known_nowait(
 	     || (ibuf_count_get(buf_block_get_space(block),
 				buf_block_get_page_no(block)) == 0));
 #endif
-	buf_pool->stat.n_page_gets++;
+	buf_pool->stat.n_page_gets.inc();
 
 	return(TRUE);
 }
@@ -3490,7 +4214,7 @@ buf_page_try_get_func(
 #endif /* UNIV_DEBUG_FILE_ACCESSES || UNIV_DEBUG */
 	buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
 
-	buf_pool->stat.n_page_gets++;
+	buf_pool->stat.n_page_gets.inc();
 
 #ifdef UNIV_IBUF_COUNT_DEBUG
 	ut_a(ibuf_count_get(buf_block_get_space(block),
@@ -3513,6 +4237,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
+	bpage->access_count = 0;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
 	HASH_INVALIDATE(bpage, hash);
@@ -4208,6 +4933,10 @@ buf_page_io_complete(
 		} else {
 			ut_a(uncompressed);
 			frame = ((buf_block_t*) bpage)->frame;
+
+			/* Decompress a page that was read from a page
+			compressed tablespace asynchronously. */
+			os_file_decompress_page(frame);
 		}
 
 		/* If this page is not uninitialized and not in the
@@ -4756,10 +5485,13 @@ assert_s_latched:
 	}
 
 	ut_a(UT_LIST_GET_LEN(buf_pool->LRU) == n_lru);
-	if (UT_LIST_GET_LEN(buf_pool->free) != n_free) {
+	if (UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw) != n_free) {
 		ib_logf(IB_LOG_LEVEL_FATAL,
-			"Free list len %lu, free blocks %lu  Aborting...",
+			"Free list len %lu, withdraw list len %lu,"
+			" free blocks %lu  Aborting...",
 			(ulong) UT_LIST_GET_LEN(buf_pool->free),
+			(ulong) UT_LIST_GET_LEN(buf_pool->withdraw),
 			(ulong) n_free);
 	}
 
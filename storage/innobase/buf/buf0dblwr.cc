@@ -46,6 +46,21 @@ buf_dblwr_t*	buf_dblwr = NULL;
 /** Set to TRUE when the doublewrite buffer is being created */
 ibool	buf_dblwr_being_created = FALSE;
 
+/** Doublewrite buffers in separate files, used instead of buf_dblwr
+for writing when innodb_doublewrite_files > 0. Buffer pool instance i
+uses buf_dblwr_files[i % buf_dblwr_n_files]. */
+static buf_dblwr_t**	buf_dblwr_files = NULL;
+
+/** Number of elements in buf_dblwr_files */
+static ulint		buf_dblwr_n_files = 0;
+
+/** Name prefix of the doublewrite files in the data home directory */
+#define BUF_DBLWR_FILE_PREFIX	"ib_doublewrite_"
+
+/** Number of pages in a doublewrite buffer, batch and single page
+flush slots included */
+#define BUF_DBLWR_N_PAGES	(2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -96,6 +111,125 @@ buf_dblwr_get(
 	return(buf_block_get_frame(block) + TRX_SYS_DOUBLEWRITE);
 }
 
+/****************************************************************//**
+Returns the doublewrite buffer that writes from a buffer pool instance
+go through.
+@return doublewrite buffer */
+UNIV_INLINE
+buf_dblwr_t*
+buf_dblwr_get_for_pool(
+/*===================*/
+	const buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	if (buf_dblwr_n_files == 0) {
+		return(buf_dblwr);
+	}
+
+	return(buf_dblwr_files[buf_pool_index(buf_pool) % buf_dblwr_n_files]);
+}
+
+/****************************************************************//**
+Returns the doublewrite buffer that the write of a page goes through.
+@return doublewrite buffer */
+UNIV_INLINE
+buf_dblwr_t*
+buf_dblwr_get_for_page(
+/*===================*/
+	const buf_page_t*	bpage)	/*!< in: page to write */
+{
+	return(buf_dblwr_get_for_pool(buf_pool_from_bpage(bpage)));
+}
+
+/****************************************************************//**
+Builds the path of the doublewrite file with the given number.
+@return path, to be freed with mem_free() */
+static
+char*
+buf_dblwr_file_name(
+/*================*/
+	ulint	n)	/*!< in: number of the doublewrite file */
+{
+	ulint	len = strlen(srv_data_home) + sizeof BUF_DBLWR_FILE_PREFIX
+		+ 22;
+	char*	name = static_cast<char*>(mem_alloc(len));
+
+	ut_snprintf(name, len, "%s%c" BUF_DBLWR_FILE_PREFIX "%lu",
+		    srv_data_home, SRV_PATH_SEPARATOR, (ulong) n);
+
+	return(name);
+}
+
+/********************************************************************//**
+Writes pages from memory to consecutive slots of a doublewrite buffer
+on disk. The write is synchronous; the caller must flush the doublewrite
+buffer with buf_dblwr_sync() before writing the pages to the datafiles. */
+static
+void
+buf_dblwr_write_slots(
+/*==================*/
+	buf_dblwr_t*	dblwr,	/*!< in: doublewrite buffer */
+	ulint		first,	/*!< in: first slot to write */
+	ulint		n,	/*!< in: number of slots to write */
+	const byte*	buf)	/*!< in: n pages to write */
+{
+	ut_ad(first + n <= BUF_DBLWR_N_PAGES);
+
+	if (dblwr->file_name != NULL) {
+		if (!os_file_write(dblwr->file_name, dblwr->file, buf,
+				   (os_offset_t) first * UNIV_PAGE_SIZE,
+				   n * UNIV_PAGE_SIZE)) {
+
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot write to the doublewrite file '%s'",
+				dblwr->file_name);
+		}
+
+		return;
+	}
+
+	/* The slots of the doublewrite buffer in the system tablespace
+	are split between the two blocks. */
+
+	while (n > 0) {
+		ulint	page_no;
+		ulint	len;
+
+		if (first < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+			page_no = dblwr->block1 + first;
+			len = ut_min(n, TRX_SYS_DOUBLEWRITE_BLOCK_SIZE - first);
+		} else {
+			page_no = dblwr->block2 + first
+				- TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+			len = n;
+		}
+
+		fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
+		       page_no, 0, len * UNIV_PAGE_SIZE,
+		       (void*) buf, NULL);
+
+		first += len;
+		n -= len;
+		buf += len * UNIV_PAGE_SIZE;
+	}
+}
+
+/********************************************************************//**
+Flushes the writes to a doublewrite buffer to disk. */
+static
+void
+buf_dblwr_sync(
+/*===========*/
+	buf_dblwr_t*	dblwr)	/*!< in: doublewrite buffer */
+{
+	if (dblwr->file_name == NULL) {
+		fil_flush(TRX_SYS_SPACE);
+	} else if (!os_file_flush(dblwr->file)) {
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Cannot flush the doublewrite file '%s'",
+			dblwr->file_name);
+	}
+}
+
 /********************************************************************//**
 Flush a batch of writes to the datafiles that have already been
 written to the dblwr buffer on disk. */
@@ -117,53 +251,134 @@ buf_dblwr_sync_datafiles()
 }
 
 /****************************************************************//**
-Creates or initialializes the doublewrite buffer at a database start. */
+Allocates and initializes the memory structure of a doublewrite buffer.
+@return doublewrite buffer */
 static
-void
-buf_dblwr_init(
-/*===========*/
-	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
-				header on trx sys page */
+buf_dblwr_t*
+buf_dblwr_alloc(void)
+/*=================*/
 {
-	ulint	buf_size;
+	buf_dblwr_t*	dblwr;
+	ulint		buf_size;
 
-	buf_dblwr = static_cast<buf_dblwr_t*>(
-		mem_zalloc(sizeof(buf_dblwr_t)));
+	dblwr = static_cast<buf_dblwr_t*>(mem_zalloc(sizeof(buf_dblwr_t)));
 
 	/* There are two blocks of same size in the doublewrite
 	buffer. */
-	buf_size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+	buf_size = BUF_DBLWR_N_PAGES;
 
 	/* There must be atleast one buffer for single page writes
 	and one buffer for batch writes. */
 	ut_a(srv_doublewrite_batch_size > 0
 	     && srv_doublewrite_batch_size < buf_size);
 
-	mutex_create("buf_dblwr", &buf_dblwr->mutex);
-
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
-	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
-	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
+	mutex_create("buf_dblwr", &dblwr->mutex);
 
-	buf_dblwr->block1 = mach_read_from_4(
-		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
-	buf_dblwr->block2 = mach_read_from_4(
-		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+	dblwr->b_event = os_event_create("dblwr_batch_event");
+	dblwr->s_event = os_event_create("dblwr_single_event");
+	dblwr->first_free = 0;
+	dblwr->s_reserved = 0;
+	dblwr->b_reserved = 0;
+	dblwr->file_name = NULL;
 
-	buf_dblwr->in_use = static_cast<bool*>(
+	dblwr->in_use = static_cast<bool*>(
 		mem_zalloc(buf_size * sizeof(bool)));
 
-	buf_dblwr->write_buf_unaligned = static_cast<byte*>(
+	dblwr->write_buf_unaligned = static_cast<byte*>(
 		ut_malloc((1 + buf_size) * UNIV_PAGE_SIZE));
 
-	buf_dblwr->write_buf = static_cast<byte*>(
-		ut_align(buf_dblwr->write_buf_unaligned,
+	dblwr->write_buf = static_cast<byte*>(
+		ut_align(dblwr->write_buf_unaligned,
 			 UNIV_PAGE_SIZE));
 
-	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
+	dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		mem_zalloc(buf_size * sizeof(void*)));
+
+	return(dblwr);
+}
+
+/****************************************************************//**
+Opens the doublewrite files, creating the ones that do not exist yet. */
+static
+void
+buf_dblwr_open_files(void)
+/*======================*/
+{
+	ut_ad(buf_dblwr_files == NULL);
+
+	buf_dblwr_files = static_cast<buf_dblwr_t**>(
+		mem_zalloc(srv_n_doublewrite_files * sizeof(*buf_dblwr_files)));
+
+	for (ulint i = 0; i < srv_n_doublewrite_files; ++i) {
+		buf_dblwr_t*	dblwr = buf_dblwr_alloc();
+		ibool		exists;
+		ibool		success;
+		os_file_type_t	type;
+
+		dblwr->block1 = ULINT_UNDEFINED;
+		dblwr->block2 = ULINT_UNDEFINED;
+		dblwr->file_name = buf_dblwr_file_name(i);
+
+		if (!os_file_status(dblwr->file_name, &exists, &type)) {
+			exists = FALSE;
+		}
+
+		dblwr->file = os_file_create(
+			innodb_data_file_key, dblwr->file_name,
+			exists ? OS_FILE_OPEN : OS_FILE_CREATE,
+			OS_FILE_NORMAL, OS_DATA_FILE, &success);
+
+		if (!success) {
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot open the doublewrite file '%s'",
+				dblwr->file_name);
+		}
+
+		if (os_file_get_size(dblwr->file)
+		    < (os_offset_t) BUF_DBLWR_N_PAGES * UNIV_PAGE_SIZE
+		    && !os_file_set_size(dblwr->file_name, dblwr->file,
+					 (os_offset_t) BUF_DBLWR_N_PAGES
+					 * UNIV_PAGE_SIZE)) {
+
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot extend the doublewrite file '%s'",
+				dblwr->file_name);
+		}
+
+		if (!exists) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Created doublewrite file '%s'",
+				dblwr->file_name);
+		}
+
+		buf_dblwr_files[i] = dblwr;
+	}
+
+	buf_dblwr_n_files = srv_n_doublewrite_files;
+}
+
+/****************************************************************//**
+Creates or initialializes the doublewrite buffer at a database start. */
+static
+void
+buf_dblwr_init(
+/*===========*/
+	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
+				header on trx sys page */
+{
+	buf_dblwr = buf_dblwr_alloc();
+
+	buf_dblwr->block1 = mach_read_from_4(
+		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
+	buf_dblwr->block2 = mach_read_from_4(
+		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
+
+	if (srv_n_doublewrite_files > 0
+	    && srv_use_doublewrite_buf
+	    && !srv_read_only_mode) {
+
+		buf_dblwr_open_files();
+	}
 }
 
 /****************************************************************//**
@@ -343,6 +558,195 @@ start_again:
 	goto start_again;
 }
 
+/****************************************************************//**
+Restores a page in a data file from its copy in a doublewrite buffer, if
+the page in the data file is corrupt. */
+static
+void
+buf_dblwr_recover_page(
+/*===================*/
+	ulint	i,		/*!< in: position of the copy in the
+				doublewrite buffer */
+	byte*	page,		/*!< in: copy of the page in the
+				doublewrite buffer */
+	byte*	read_buf)	/*!< in/out: buffer of UNIV_PAGE_SIZE for
+				reading the page from the data file */
+{
+	ulint	space_id = mach_read_from_4(
+		page + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
+	ulint	page_no = mach_read_from_4(page + FIL_PAGE_OFFSET);
+
+	if (mach_read_from_8(page + FIL_PAGE_LSN) == 0) {
+		/* An unused slot of a doublewrite file:
+		do nothing */
+
+	} else if (!fil_tablespace_exists_in_mem(space_id)) {
+		/* Maybe we have dropped the single-table tablespace
+		and this page once belonged to it: do nothing */
+
+	} else if (!fil_check_adress_in_tablespace(space_id,
+						   page_no)) {
+		/* Do not report the warning if the tablespace is
+		truncated as it's reasonable */
+		if (!srv_is_tablespace_truncated(space_id)) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"A page in the doublewrite buffer is "
+				"not within space bounds; space id %lu "
+				"page number %lu, page %lu in "
+				"doublewrite buf.",
+				(ulong) space_id, (ulong) page_no,
+				(ulong) i);
+		}
+
+	} else if (space_id == TRX_SYS_SPACE
+		   && buf_dblwr_page_inside(page_no)) {
+
+		/* It is an unwritten doublewrite buffer page:
+		do nothing */
+	} else {
+		ulint	zip_size = fil_space_get_zip_size(space_id);
+
+		/* Read in the actual page from the file */
+		fil_io(OS_FILE_READ, true, space_id, zip_size,
+		       page_no, 0,
+		       zip_size ? zip_size : UNIV_PAGE_SIZE,
+		       read_buf, NULL);
+
+		/* Check if the page is corrupt */
+
+		if (buf_page_is_corrupted(true, read_buf, zip_size)) {
+
+			fprintf(stderr,
+				"InnoDB: Warning: database page"
+				" corruption or a failed\n"
+				"InnoDB: file read of"
+				" space %lu page %lu.\n"
+				"InnoDB: Trying to recover it from"
+				" the doublewrite buffer.\n",
+				(ulong) space_id, (ulong) page_no);
+
+			if (buf_page_is_corrupted(true,
+						  page, zip_size)) {
+				fprintf(stderr,
+					"InnoDB: Dump of the page:\n");
+				buf_page_print(
+					read_buf, zip_size,
+					BUF_PAGE_PRINT_NO_CRASH);
+				fprintf(stderr,
+					"InnoDB: Dump of"
+					" corresponding page"
+					" in doublewrite buffer:\n");
+				buf_page_print(
+					page, zip_size,
+					BUF_PAGE_PRINT_NO_CRASH);
+
+				ib_logf(IB_LOG_LEVEL_FATAL,
+					"The page in the doublewrite"
+					" buffer is corrupt. Cannot"
+					" continue operation. You"
+					" can try to recover the"
+					" database with"
+					" innodb_force_recovery=6");
+			}
+
+			/* Write the good page from the
+			doublewrite buffer to the intended
+			position */
+
+			fil_io(OS_FILE_WRITE, true, space_id,
+			       zip_size, page_no, 0,
+			       zip_size ? zip_size : UNIV_PAGE_SIZE,
+			       page, NULL);
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Recovered the page from"
+				" the doublewrite buffer.");
+		}
+	}
+}
+
+/****************************************************************//**
+Uses the contents of the doublewrite files to restore half-written pages
+in the data files. Files beyond innodb_doublewrite_files that are left
+over from a run with a larger setting are used as well. */
+static
+void
+buf_dblwr_recover_files(
+/*====================*/
+	byte*	buf,		/*!< in/out: buffer of BUF_DBLWR_N_PAGES
+				pages for reading a doublewrite file */
+	byte*	read_buf)	/*!< in/out: buffer of UNIV_PAGE_SIZE for
+				reading pages from the data files */
+{
+	for (ulint n = 0;; ++n) {
+		char*		name;
+		os_file_t	file;
+		bool		own_file;
+		os_offset_t	size;
+		ulint		n_pages;
+
+		if (n < buf_dblwr_n_files) {
+			name = buf_dblwr_files[n]->file_name;
+			file = buf_dblwr_files[n]->file;
+			own_file = false;
+		} else {
+			ibool		exists;
+			ibool		success;
+			os_file_type_t	type;
+
+			name = buf_dblwr_file_name(n);
+
+			if (!os_file_status(name, &exists, &type)
+			    || !exists) {
+
+				mem_free(name);
+				break;
+			}
+
+			file = os_file_create(
+				innodb_data_file_key, name,
+				OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT,
+				OS_FILE_NORMAL, OS_DATA_FILE, &success);
+
+			if (!success) {
+				ib_logf(IB_LOG_LEVEL_WARN,
+					"Cannot open the doublewrite file"
+					" '%s'; pages in it are not used"
+					" for recovery", name);
+				mem_free(name);
+				continue;
+			}
+
+			own_file = true;
+		}
+
+		size = os_file_get_size(file);
+
+		n_pages = static_cast<ulint>(ut_min(
+			size / UNIV_PAGE_SIZE,
+			(os_offset_t) BUF_DBLWR_N_PAGES));
+
+		if (n_pages > 0
+		    && !os_file_read(file, buf, 0, n_pages * UNIV_PAGE_SIZE)) {
+
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Cannot read the doublewrite file '%s'; pages"
+				" in it are not used for recovery", name);
+			n_pages = 0;
+		}
+
+		for (ulint i = 0; i < n_pages; ++i) {
+			buf_dblwr_recover_page(
+				i, buf + i * UNIV_PAGE_SIZE, read_buf);
+		}
+
+		if (own_file) {
+			os_file_close(file);
+			mem_free(name);
+		}
+	}
+}
+
 /****************************************************************//**
 At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
@@ -364,8 +768,6 @@ buf_dblwr_init_or_restore_pages(
 	byte*	page;
 	ibool	reset_space_ids = FALSE;
 	byte*	doublewrite;
-	ulint	space_id;
-	ulint	page_no;
 	ulint	i;
 
 	/* We do the file i/o past the buffer pool */
@@ -427,12 +829,9 @@ buf_dblwr_init_or_restore_pages(
 
 	for (i = 0; i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * 2; i++) {
 
-		ulint source_page_no;
-		page_no = mach_read_from_4(page + FIL_PAGE_OFFSET);
-
 		if (reset_space_ids) {
+			ulint	source_page_no;
 
-			space_id = 0;
 			mach_write_to_4(page
 					+ FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID, 0);
 			/* We do not need to calculate new checksums for the
@@ -448,113 +847,55 @@ buf_dblwr_init_or_restore_pages(
 
 			fil_io(OS_FILE_WRITE, true, 0, 0, source_page_no, 0,
 			       UNIV_PAGE_SIZE, page, NULL);
-		} else {
-
-			space_id = mach_read_from_4(
-				page + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
 		}
 
-		if (!restore_corrupt_pages) {
-			/* The database was shut down gracefully: no need to
-			restore pages */
-
-		} else if (!fil_tablespace_exists_in_mem(space_id)) {
-			/* Maybe we have dropped the single-table tablespace
-			and this page once belonged to it: do nothing */
-
-		} else if (!fil_check_adress_in_tablespace(space_id,
-							   page_no)) {
-			/* Do not report the warning if the tablespace is
-			truncated as it's reasonable */
-			if (!srv_is_tablespace_truncated(space_id)) {
-				ib_logf(IB_LOG_LEVEL_WARN,
-					"A page in the doublewrite buffer is "
-					"not within space bounds; space id %lu "
-					"page number %lu, page %lu in "
-					"doublewrite buf.",
-					(ulong) space_id, (ulong) page_no,
-					(ulong) i);
-			}
-
-		} else if (space_id == TRX_SYS_SPACE
-			   && ((page_no >= block1
-				&& page_no
-				< block1 + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-			       || (page_no >= block2
-				   && page_no
-				   < (block2
-				      + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)))) {
-
-			/* It is an unwritten doublewrite buffer page:
-			do nothing */
-		} else {
-			ulint	zip_size = fil_space_get_zip_size(space_id);
+		if (restore_corrupt_pages) {
+			buf_dblwr_recover_page(i, page, read_buf);
+		}
 
-			/* Read in the actual page from the file */
-			fil_io(OS_FILE_READ, true, space_id, zip_size,
-			       page_no, 0,
-			       zip_size ? zip_size : UNIV_PAGE_SIZE,
-			       read_buf, NULL);
+		page += UNIV_PAGE_SIZE;
+	}
 
-			/* Check if the page is corrupt */
+	if (restore_corrupt_pages) {
+		buf_dblwr_recover_files(buf, read_buf);
+	}
 
-			if (buf_page_is_corrupted(true, read_buf, zip_size)) {
+	fil_flush_file_spaces(FIL_TABLESPACE);
 
-				fprintf(stderr,
-					"InnoDB: Warning: database page"
-					" corruption or a failed\n"
-					"InnoDB: file read of"
-					" space %lu page %lu.\n"
-					"InnoDB: Trying to recover it from"
-					" the doublewrite buffer.\n",
-					(ulong) space_id, (ulong) page_no);
-
-				if (buf_page_is_corrupted(true,
-							  page, zip_size)) {
-					fprintf(stderr,
-						"InnoDB: Dump of the page:\n");
-					buf_page_print(
-						read_buf, zip_size,
-						BUF_PAGE_PRINT_NO_CRASH);
-					fprintf(stderr,
-						"InnoDB: Dump of"
-						" corresponding page"
-						" in doublewrite buffer:\n");
-					buf_page_print(
-						page, zip_size,
-						BUF_PAGE_PRINT_NO_CRASH);
-
-					ib_logf(IB_LOG_LEVEL_FATAL,
-						"The page in the doublewrite"
-						" buffer is corrupt. Cannot"
-						" continue operation. You"
-						" can try to recover the"
-						" database with"
-						" innodb_force_recovery=6");
-				}
+leave_func:
+	ut_free(unaligned_read_buf);
+}
 
-				/* Write the good page from the
-				doublewrite buffer to the intended
-				position */
+/****************************************************************//**
+Frees the memory structure of a doublewrite buffer and closes its file. */
+static
+void
+buf_dblwr_free_low(
+/*===============*/
+	buf_dblwr_t*	dblwr)	/*!< in, own: doublewrite buffer */
+{
+	ut_ad(dblwr->s_reserved == 0);
+	ut_ad(dblwr->b_reserved == 0);
 
-				fil_io(OS_FILE_WRITE, true, space_id,
-				       zip_size, page_no, 0,
-				       zip_size ? zip_size : UNIV_PAGE_SIZE,
-				       page, NULL);
+	if (dblwr->file_name != NULL) {
+		os_file_close(dblwr->file);
+		mem_free(dblwr->file_name);
+		dblwr->file_name = NULL;
+	}
 
-				ib_logf(IB_LOG_LEVEL_INFO,
-					"Recovered the page from"
-					" the doublewrite buffer.");
-			}
-		}
+	os_event_destroy(dblwr->b_event);
+	os_event_destroy(dblwr->s_event);
+	ut_free(dblwr->write_buf_unaligned);
+	dblwr->write_buf_unaligned = NULL;
 
-		page += UNIV_PAGE_SIZE;
-	}
+	mem_free(dblwr->buf_block_arr);
+	dblwr->buf_block_arr = NULL;
 
-	fil_flush_file_spaces(FIL_TABLESPACE);
+	mem_free(dblwr->in_use);
+	dblwr->in_use = NULL;
 
-leave_func:
-	ut_free(unaligned_read_buf);
+	mutex_free(&dblwr->mutex);
+	mem_free(dblwr);
 }
 
 /****************************************************************//**
@@ -566,22 +907,18 @@ buf_dblwr_free(void)
 {
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
-	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
-
-	os_event_destroy(buf_dblwr->b_event);
-	os_event_destroy(buf_dblwr->s_event);
-	ut_free(buf_dblwr->write_buf_unaligned);
-	buf_dblwr->write_buf_unaligned = NULL;
 
-	mem_free(buf_dblwr->buf_block_arr);
-	buf_dblwr->buf_block_arr = NULL;
+	for (ulint i = 0; i < buf_dblwr_n_files; ++i) {
+		buf_dblwr_free_low(buf_dblwr_files[i]);
+	}
 
-	mem_free(buf_dblwr->in_use);
-	buf_dblwr->in_use = NULL;
+	if (buf_dblwr_files != NULL) {
+		mem_free(buf_dblwr_files);
+		buf_dblwr_files = NULL;
+		buf_dblwr_n_files = 0;
+	}
 
-	mutex_free(&buf_dblwr->mutex);
-	mem_free(buf_dblwr);
+	buf_dblwr_free_low(buf_dblwr);
 	buf_dblwr = NULL;
 }
 
@@ -594,46 +931,50 @@ buf_dblwr_update(
 	const buf_page_t*	bpage,	/*!< in: buffer block descriptor */
 	buf_flush_t		flush_type)/*!< in: flush type */
 {
+	buf_dblwr_t*	dblwr;
+
 	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
 		return;
 	}
 
+	dblwr = buf_dblwr_get_for_page(bpage);
+
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		mutex_enter(&dblwr->mutex);
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+		ut_ad(dblwr->batch_running);
+		ut_ad(dblwr->b_reserved > 0);
+		ut_ad(dblwr->b_reserved <= dblwr->first_free);
 
-		buf_dblwr->b_reserved--;
+		dblwr->b_reserved--;
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
+		if (dblwr->b_reserved == 0) {
+			mutex_exit(&dblwr->mutex);
 			/* This will finish the batch. Sync data files
 			to the disk. */
 			fil_flush_file_spaces(FIL_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&dblwr->mutex);
 
 			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
+			dblwr->first_free = 0;
+			dblwr->batch_running = false;
+			os_event_set(dblwr->b_event);
 		}
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&dblwr->mutex);
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
-			const ulint size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+			const ulint size = BUF_DBLWR_N_PAGES;
 			ulint i;
-			mutex_enter(&buf_dblwr->mutex);
+			mutex_enter(&dblwr->mutex);
 			for (i = srv_doublewrite_batch_size; i < size; ++i) {
-				if (buf_dblwr->buf_block_arr[i] == bpage) {
-					buf_dblwr->s_reserved--;
-					buf_dblwr->buf_block_arr[i] = NULL;
-					buf_dblwr->in_use[i] = false;
+				if (dblwr->buf_block_arr[i] == bpage) {
+					dblwr->s_reserved--;
+					dblwr->buf_block_arr[i] = NULL;
+					dblwr->in_use[i] = false;
 					break;
 				}
 			}
@@ -642,8 +983,8 @@ buf_dblwr_update(
 			reserved block. */
 			ut_a(i < size);
 		}
-		os_event_set(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
+		os_event_set(dblwr->s_event);
+		mutex_exit(&dblwr->mutex);
 		break;
 	case BUF_FLUSH_N_TYPES:
 		ut_error;
@@ -769,73 +1110,64 @@ buf_dblwr_write_block_to_datafile(
 }
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
-
+Flushes possible buffered writes from one doublewrite memory buffer to
+disk, and also wakes up the aio thread if simulated aio is used. */
+static
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_flush_low(
+/*================*/
+	buf_dblwr_t*	dblwr)	/*!< in: doublewrite buffer */
 {
 	byte*		write_buf;
 	ulint		first_free;
-	ulint		len;
-
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		return;
-	}
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&dblwr->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (dblwr->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&dblwr->mutex);
 
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (dblwr->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		ib_int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		ib_int64_t	sig_count = os_event_reset(dblwr->b_event);
+		mutex_exit(&dblwr->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(dblwr->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!dblwr->batch_running);
+	ut_ad(dblwr->first_free == dblwr->b_reserved);
 
 	/* Disallow anyone else to post to doublewrite buffer or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	dblwr->batch_running = true;
+	first_free = dblwr->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&dblwr->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	write_buf = dblwr->write_buf;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < dblwr->first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) dblwr->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -853,57 +1185,35 @@ try_again:
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
-
-	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-	       buf_dblwr->block1, 0, len,
-	       (void*) write_buf, NULL);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
-	}
-
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
-
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
+	/* Write out the batch to the doublewrite buffer on disk */
+	buf_dblwr_write_slots(dblwr, 0, first_free, dblwr->write_buf);
 
-	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-	       buf_dblwr->block2, 0, len,
-	       (void*) write_buf, NULL);
-
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(dblwr->first_free);
 	srv_stats.dblwr_writes.inc();
 
 	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	buf_dblwr_sync(dblwr);
 
 	/* We know that the writes have been flushed to disk now
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and dblwr->first_free are
+	same because we have set the dblwr->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access dblwr->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting dblwr->first_free to a higher value.
+	If this happens and we are using dblwr->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == dblwr->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			dblwr->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -913,6 +1223,38 @@ flush:
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+
+void
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	const buf_pool_t*	buf_pool)	/*!< in: flush only the
+					doublewrite buffer used by this
+					buffer pool instance, or NULL to
+					flush all doublewrite buffers */
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	if (buf_pool != NULL) {
+		buf_dblwr_flush_low(buf_dblwr_get_for_pool(buf_pool));
+	} else if (buf_dblwr_n_files == 0) {
+		buf_dblwr_flush_low(buf_dblwr);
+	} else {
+		for (ulint i = 0; i < buf_dblwr_n_files; ++i) {
+			buf_dblwr_flush_low(buf_dblwr_files[i]);
+		}
+	}
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -923,16 +1265,19 @@ buf_dblwr_add_to_batch(
 /*====================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
-	ulint	zip_size;
+	buf_dblwr_t*	dblwr;
+	ulint		zip_size;
 
 	ut_a(buf_page_in_file(bpage));
 
+	dblwr = buf_dblwr_get_for_page(bpage);
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&dblwr->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(dblwr->first_free <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->batch_running) {
+	if (dblwr->batch_running) {
 
 		/* This not nearly as bad as it looks. There is only
 		page_cleaner thread which does background flushing
@@ -940,17 +1285,17 @@ try_again:
 		point. The only exception is when a user thread is
 		forced to do a flush batch because of a sync
 		checkpoint. */
-		ib_int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		ib_int64_t	sig_count = os_event_reset(dblwr->b_event);
+		mutex_exit(&dblwr->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(dblwr->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (dblwr->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&(dblwr->mutex));
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_low(dblwr);
 
 		goto try_again;
 	}
@@ -960,40 +1305,40 @@ try_again:
 	if (zip_size) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
 		/* Copy the compressed page and clear the rest. */
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
+		memcpy(dblwr->write_buf
+		       + UNIV_PAGE_SIZE * dblwr->first_free,
 		       bpage->zip.data, zip_size);
-		memset(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free
+		memset(dblwr->write_buf
+		       + UNIV_PAGE_SIZE * dblwr->first_free
 		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 	} else {
 		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
 		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
 				   UNIV_PAGE_SIZE);
 
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
+		memcpy(dblwr->write_buf
+		       + UNIV_PAGE_SIZE * dblwr->first_free,
 		       ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	dblwr->buf_block_arr[dblwr->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	dblwr->first_free++;
+	dblwr->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!dblwr->batch_running);
+	ut_ad(dblwr->first_free == dblwr->b_reserved);
+	ut_ad(dblwr->b_reserved <= srv_doublewrite_batch_size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (dblwr->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&(dblwr->mutex));
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_low(dblwr);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&(dblwr->mutex));
 }
 
 /********************************************************************//**
@@ -1014,17 +1359,20 @@ buf_dblwr_write_single_page(
 	ulint		n_slots;
 	ulint		size;
 	ulint		zip_size;
-	ulint		offset;
 	ulint		i;
 
+	buf_dblwr_t*	dblwr;
+
 	ut_a(buf_page_in_file(bpage));
 	ut_a(srv_use_doublewrite_buf);
 	ut_a(buf_dblwr != NULL);
 
+	dblwr = buf_dblwr_get_for_page(bpage);
+
 	/* total number of slots available for single page flushes
 	starts from srv_doublewrite_batch_size to the end of the
 	buffer. */
-	size = 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+	size = BUF_DBLWR_N_PAGES;
 	ut_a(size > srv_doublewrite_batch_size);
 	n_slots = size - srv_doublewrite_batch_size;
 
@@ -1043,52 +1391,43 @@ buf_dblwr_write_single_page(
 	}
 
 retry:
-	mutex_enter(&buf_dblwr->mutex);
-	if (buf_dblwr->s_reserved == n_slots) {
+	mutex_enter(&dblwr->mutex);
+	if (dblwr->s_reserved == n_slots) {
 
 		/* All slots are reserved. */
 		ib_int64_t	sig_count =
-			os_event_reset(buf_dblwr->s_event);
-		mutex_exit(&buf_dblwr->mutex);
-		os_event_wait_low(buf_dblwr->s_event, sig_count);
+			os_event_reset(dblwr->s_event);
+		mutex_exit(&dblwr->mutex);
+		os_event_wait_low(dblwr->s_event, sig_count);
 
 		goto retry;
 	}
 
 	for (i = srv_doublewrite_batch_size; i < size; ++i) {
 
-		if (!buf_dblwr->in_use[i]) {
+		if (!dblwr->in_use[i]) {
 			break;
 		}
 	}
 
 	/* We are guaranteed to find a slot. */
 	ut_a(i < size);
-	buf_dblwr->in_use[i] = true;
-	buf_dblwr->s_reserved++;
-	buf_dblwr->buf_block_arr[i] = bpage;
+	dblwr->in_use[i] = true;
+	dblwr->s_reserved++;
+	dblwr->buf_block_arr[i] = bpage;
 
 	/* increment the doublewrite flushed pages counter */
 	srv_stats.dblwr_pages_written.inc();
 	srv_stats.dblwr_writes.inc();
 
-	mutex_exit(&buf_dblwr->mutex);
-
-	/* Lets see if we are going to write in the first or second
-	block of the doublewrite buffer. */
-	if (i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		offset = buf_dblwr->block1 + i;
-	} else {
-		offset = buf_dblwr->block2 + i
-			 - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
-	}
+	mutex_exit(&dblwr->mutex);
 
 	/* We deal with compressed and uncompressed pages a little
 	differently here. In case of uncompressed pages we can
 	directly write the block to the allocated slot in the
-	doublewrite buffer in the system tablespace and then after
-	syncing the system table space we can proceed to write the page
-	in the datafile.
+	doublewrite buffer on disk and then after syncing the
+	doublewrite buffer we can proceed to write the page in the
+	datafile.
 	In case of compressed page we first do a memcpy of the block
 	to the in-memory buffer of doublewrite before proceeding to
 	write it. This is so because we want to pad the remaining
@@ -1096,26 +1435,22 @@ retry:
 
 	zip_size = buf_page_get_zip_size(bpage);
 	if (zip_size) {
-		memcpy(buf_dblwr->write_buf + UNIV_PAGE_SIZE * i,
+		memcpy(dblwr->write_buf + UNIV_PAGE_SIZE * i,
 		       bpage->zip.data, zip_size);
-		memset(buf_dblwr->write_buf + UNIV_PAGE_SIZE * i
+		memset(dblwr->write_buf + UNIV_PAGE_SIZE * i
 		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 
-		fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-		       offset, 0, UNIV_PAGE_SIZE,
-		       (void*) (buf_dblwr->write_buf
-				+ UNIV_PAGE_SIZE * i), NULL);
+		buf_dblwr_write_slots(dblwr, i, 1,
+				      dblwr->write_buf + UNIV_PAGE_SIZE * i);
 	} else {
 		/* It is a regular page. Write it directly to the
 		doublewrite buffer */
-		fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-		       offset, 0, UNIV_PAGE_SIZE,
-		       (void*) ((buf_block_t*) bpage)->frame,
-		       NULL);
+		buf_dblwr_write_slots(dblwr, i, 1,
+				      ((buf_block_t*) bpage)->frame);
 	}
 
 	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
+	buf_dblwr_sync(dblwr);
 
 	/* We know that the write has been flushed to disk now
 	and during recovery we will find it in the doublewrite buffer
@@ -63,6 +63,36 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/* A page of a dump file as it is read back during load: the page id and
+the access count of the page at the time of the dump. Dumps written by
+older versions have no access counts; they are read as all 0. */
+struct buf_load_t {
+	buf_dump_t	page;	/*!< space id and page number */
+	ulint		hint;	/*!< access count of the page */
+};
+
+/* The pages of a load are read in batches of this many pages. The
+batches go from the most accessed pages to the least accessed ones, and
+the pages of one batch are read in page id order so that the reads of
+adjacent pages can be merged. */
+#define BUF_LOAD_BATCH_SIZE	1024
+
+/** Orders buf_load_t by descending access count */
+struct buf_load_hotter {
+	bool operator()(const buf_load_t& a, const buf_load_t& b) const
+	{
+		return(a.hint > b.hint);
+	}
+};
+
+/** Orders buf_load_t by page id */
+struct buf_load_page_less {
+	bool operator()(const buf_load_t& a, const buf_load_t& b) const
+	{
+		return(a.page < b.page);
+	}
+};
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -208,6 +238,7 @@ buf_dump(
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
 		buf_dump_t*		dump;
+		ulint*			hints;
 		ulint			n_pages;
 		ulint			j;
 
@@ -236,19 +267,22 @@ buf_dump(
 		}
 
 		dump = static_cast<buf_dump_t*>(
-			ut_malloc(n_pages * sizeof(*dump))) ;
+			ut_malloc(n_pages * (sizeof(*dump) + sizeof(*hints))));
 
 		if (dump == NULL) {
 			buf_pool_mutex_exit(buf_pool);
 			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
-					(ulint) (n_pages * sizeof(*dump)),
+					(ulint) (n_pages * (sizeof(*dump)
+							    + sizeof(*hints))),
 					strerror(errno));
 			/* leave tmp_filename to exist */
 			return;
 		}
 
+		hints = reinterpret_cast<ulint*>(dump + n_pages);
+
 		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
 		     bpage != NULL && j < n_pages;
 		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
@@ -257,6 +291,7 @@ buf_dump(
 
 			dump[j] = BUF_DUMP_CREATE(buf_page_get_space(bpage),
 						  buf_page_get_page_no(bpage));
+			hints[j] = buf_page_get_access_count(bpage);
 		}
 
 		ut_a(j == n_pages);
@@ -264,9 +299,10 @@ buf_dump(
 		buf_pool_mutex_exit(buf_pool);
 
 		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
+			ret = fprintf(f, ULINTPF "," ULINTPF "," ULINTPF "\n",
 				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+				      BUF_DUMP_PAGE(dump[j]),
+				      hints[j]);
 			if (ret < 0) {
 				ut_free(dump);
 				fclose(f);
@@ -395,6 +431,38 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/*****************************************************************//**
+Reads the next entry of a buffer pool dump file. An entry is a line
+"space,page,count", or "space,page" in the dumps of older versions.
+Empty lines are skipped.
+@return true if an entry was read, false at the end of the file or if the
+next line cannot be parsed */
+static __attribute__((nonnull, warn_unused_result))
+bool
+buf_load_read_entry(
+/*================*/
+	FILE*		f,		/*!< in/out: dump file */
+	ulint*		space_id,	/*!< out: space id */
+	ulint*		page_no,	/*!< out: page number */
+	ulint*		hint)		/*!< out: access count, or 0 */
+{
+	char	line[80];
+	int	ret;
+
+	do {
+		if (fgets(line, sizeof(line), f) == NULL) {
+			return(false);
+		}
+
+		*hint = 0;
+
+		ret = sscanf(line, ULINTPF "," ULINTPF "," ULINTPF,
+			     space_id, page_no, hint);
+	} while (ret == EOF);
+
+	return(ret >= 2);
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -409,13 +477,13 @@ buf_load()
 	char		full_filename[OS_FILE_MAX_PATH];
 	char		now[32];
 	FILE*		f;
-	buf_dump_t*	dump;
+	buf_load_t*	dump;
 	ulint		dump_n;
 	ulint		total_buffer_pools_pages;
 	ulint		i;
 	ulint		space_id;
 	ulint		page_no;
-	int		fscanf_ret;
+	ulint		hint;
 
 	/* Ignore any leftovers from before */
 	buf_load_abort_flag = FALSE;
@@ -440,13 +508,13 @@ buf_load()
 	This file is tiny (approx 500KB per 1GB buffer pool), reading it
 	two times is fine. */
 	dump_n = 0;
-	while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2
+	while (buf_load_read_entry(f, &space_id, &page_no, &hint)
 	       && !SHUTTING_DOWN()) {
 		dump_n++;
 	}
 
 	if (!SHUTTING_DOWN() && !feof(f)) {
-		/* fscanf() returned != 2 */
+		/* buf_load_read_entry() failed before the end */
 		const char*	what;
 		if (ferror(f)) {
 			what = "reading";
@@ -469,7 +537,7 @@ buf_load()
 		dump_n = total_buffer_pools_pages;
 	}
 
-	dump = static_cast<buf_dump_t*>(ut_malloc(dump_n * sizeof(*dump)));
+	dump = static_cast<buf_load_t*>(ut_malloc(dump_n * sizeof(*dump)));
 
 	if (dump == NULL) {
 		fclose(f);
@@ -483,10 +551,7 @@ buf_load()
 	rewind(f);
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-		fscanf_ret = fscanf(f, ULINTPF "," ULINTPF,
-				    &space_id, &page_no);
-
-		if (fscanf_ret != 2) {
+		if (!buf_load_read_entry(f, &space_id, &page_no, &hint)) {
 			if (feof(f)) {
 				break;
 			}
@@ -515,7 +580,8 @@ buf_load()
 			return;
 		}
 
-		dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].page = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].hint = hint;
 	}
 
 	/* Set dump_n to the actual number of initialized elements,
@@ -534,8 +600,11 @@ buf_load()
 		return;
 	}
 
+	/* Read the most accessed pages first. The dump is in LRU order,
+	so pages that were accessed equally often keep their recency
+	order. */
 	if (!SHUTTING_DOWN()) {
-		std::sort(dump, dump + dump_n);
+		std::stable_sort(dump, dump + dump_n, buf_load_hotter());
 	}
 
 	ulint	last_check_time = 0;
@@ -543,10 +612,19 @@ buf_load()
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
 
-		buf_read_page_async(BUF_DUMP_SPACE(dump[i]),
-				    BUF_DUMP_PAGE(dump[i]));
+		if (i % BUF_LOAD_BATCH_SIZE == 0) {
+			/* Sort the next batch, so that adjacent pages are
+			submitted together and their reads are merged. */
+			std::sort(dump + i,
+				  dump + ut_min(i + BUF_LOAD_BATCH_SIZE,
+						dump_n),
+				  buf_load_page_less());
+		}
 
-		if (i % 64 == 63) {
+		buf_read_page_async(BUF_DUMP_SPACE(dump[i].page),
+				    BUF_DUMP_PAGE(dump[i].page));
+
+		if (i % 64 == 63 || i + 1 == dump_n) {
 			os_aio_simulated_wake_handler_threads();
 		}
 
@@ -589,10 +667,44 @@ buf_load_abort()
 	buf_load_abort_flag = TRUE;
 }
 
+/*****************************************************************//**
+Waits for a dump or load request. If innodb_buffer_pool_dump_interval is
+set, requests a dump once that many seconds have passed since the last
+one, so that a recent dump exists even after a crash. */
+static
+void
+buf_dump_wait_for_request(
+/*======================*/
+	ib_time_t	last_dump_time)	/*!< in: time of the last dump */
+{
+	ulint	interval = srv_buf_pool_dump_interval;
+
+	if (interval == 0) {
+		os_event_wait(srv_buf_dump_event);
+		return;
+	}
+
+	double	elapsed = ut_difftime(ut_time(), last_dump_time);
+
+	if (elapsed < interval) {
+		os_event_wait_time(srv_buf_dump_event,
+				   (ulint) ((interval - elapsed) * 1000000));
+	}
+
+	/* The interval may have been changed while we waited. */
+	interval = srv_buf_pool_dump_interval;
+
+	if (interval > 0
+	    && ut_difftime(ut_time(), last_dump_time) >= interval
+	    && !SHUTTING_DOWN()) {
+		buf_dump_should_start = TRUE;
+	}
+}
+
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
-again.
+again. It also wakes up for the periodic dumps.
 @return this function does not return, it calls os_thread_exit() */
 extern "C"
 os_thread_ret_t
@@ -601,6 +713,8 @@ DECLARE_THREAD(buf_dump_thread)(
 	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter
 						required by os_thread_create */
 {
+	ib_time_t	last_dump_time;
+
 	ut_ad(!srv_read_only_mode);
 
 	srv_buf_dump_thread_active = TRUE;
@@ -612,13 +726,18 @@ DECLARE_THREAD(buf_dump_thread)(
 		buf_load();
 	}
 
+	/* Count the first dump interval from the end of the load, which
+	gives the buffer pool time to warm up before its first dump. */
+	last_dump_time = ut_time();
+
 	while (!SHUTTING_DOWN()) {
 
-		os_event_wait(srv_buf_dump_event);
+		buf_dump_wait_for_request(last_dump_time);
 
 		if (buf_dump_should_start) {
 			buf_dump_should_start = FALSE;
 			buf_dump(TRUE /* quit on shutdown */);
+			last_dump_time = ut_time();
 		}
 
 		if (buf_load_should_start) {
@@ -61,11 +61,132 @@ ibool buf_page_cleaner_is_active = FALSE;
 
 #ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t page_cleaner_thread_key;
+mysql_pfs_key_t page_cleaner_worker_thread_key;
+mysql_pfs_key_t lru_manager_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 /** Event to synchronise with the flushing. */
 os_event_t	buf_flush_event;
 
+/** State for each slot of the page_cleaner. A slot is bound to one
+buffer pool instance and is picked up by whichever page_cleaner thread
+(coordinator or worker) gets to it first. */
+enum page_cleaner_state_t {
+	/** Not requested any yet. Moved from FINISHED by the
+	coordinator. */
+	PAGE_CLEANER_STATE_NONE = 0,
+	/** Requested but not started flushing. Moved from NONE by
+	the coordinator. */
+	PAGE_CLEANER_STATE_REQUESTED,
+	/** Flushing is ongoing. Moved from REQUESTED by the page
+	cleaner thread that picked up the slot. */
+	PAGE_CLEANER_STATE_FLUSHING,
+	/** Flushing was finished. Moved from FLUSHING by the page
+	cleaner thread that did the flushing. */
+	PAGE_CLEANER_STATE_FINISHED
+};
+
+/** Page cleaner request state for one buffer pool instance */
+struct page_cleaner_slot_t {
+	page_cleaner_state_t	state;		/*!< state of the request,
+						protected by
+						page_cleaner_t::mutex */
+	ulint			n_pages_requested;
+						/*!< number of pages requested
+						from the flush_list */
+	ulint			n_flushed_lru;	/*!< number of pages flushed
+						from the LRU by the last
+						request */
+	ulint			n_flushed_list;	/*!< number of pages flushed
+						from the flush_list by the
+						last request */
+	bool			succeeded_list;	/*!< true if the flush_list
+						batch could be started */
+	ulint			flush_lru_time;	/*!< elapsed time (ms) of
+						LRU batches since the last
+						monitor update */
+	ulint			flush_list_time;/*!< elapsed time (ms) of
+						flush_list batches since the
+						last monitor update */
+	ulint			flush_lru_pass;	/*!< number of LRU batches
+						since the last monitor
+						update */
+	ulint			flush_list_pass;/*!< number of flush_list
+						batches since the last
+						monitor update */
+};
+
+/** Page cleaner structure shared by the coordinator and the worker
+threads. The coordinator (buf_flush_page_cleaner_coordinator) decides how
+much to flush, publishes one request per buffer pool instance and then
+takes part in the flushing itself. The workers
+(buf_flush_page_cleaner_worker) pick up the remaining slots so that the
+buffer pool instances are flushed in parallel. */
+struct page_cleaner_t {
+	ib_mutex_t		mutex;		/*!< mutex to protect the
+						whole of page_cleaner_t
+						except the slots being
+						flushed */
+	os_event_t		is_requested;	/*!< event to activate the
+						worker threads */
+	os_event_t		is_finished;	/*!< event to signal that
+						all the slots were
+						finished */
+	volatile ulint		n_workers;	/*!< number of worker threads
+						still alive */
+	ulint			n_started;	/*!< number of worker threads
+						that have started; numbers
+						the workers for binding
+						them to NUMA nodes */
+	bool			requested;	/*!< true if a request is
+						pending */
+	lsn_t			lsn_limit;	/*!< upper limit of LSN to be
+						flushed */
+	ulint			n_slots;	/*!< total number of slots */
+	ulint			n_slots_requested;
+						/*!< number of slots in the
+						REQUESTED state */
+	ulint			n_slots_flushing;
+						/*!< number of slots in the
+						FLUSHING state */
+	ulint			n_slots_finished;
+						/*!< number of slots in the
+						FINISHED state */
+	ulint			flush_time;	/*!< elapsed time (ms) of
+						coordinator passes since the
+						last monitor update */
+	ulint			flush_pass;	/*!< number of coordinator
+						passes since the last
+						monitor update */
+	page_cleaner_slot_t*	slots;		/*!< one slot per buffer
+						pool instance */
+	volatile bool		is_running;	/*!< false if attempting to
+						shut down the worker
+						threads */
+};
+
+/** The page_cleaner instance, created by buf_flush_page_cleaner_init() */
+static page_cleaner_t*	page_cleaner = NULL;
+
+/** State of the LRU manager thread of one buffer pool instance */
+struct lru_manager_slot_t {
+	os_event_t		event;		/*!< set to wake up the LRU
+						manager before its sleep
+						time is over */
+	ulint			instance_no;	/*!< buffer pool instance
+						served by the thread */
+};
+
+/** The LRU manager slots, one per buffer pool instance, created by
+buf_flush_lru_manager_init() */
+static lru_manager_slot_t*	lru_managers = NULL;
+
+/** Number of LRU manager threads that are alive */
+volatile ulint	buf_lru_manager_n_threads = 0;
+
+/** Longest sleep of an LRU manager thread between two batches, in ms */
+#define BUF_LRU_MANAGER_MAX_SLEEP	1000
+
 /** If LRU list of a buf_pool is less than this size then LRU eviction
 should not happen. This is because when we do LRU flushing we also put
 the blocks on free list. If LRU list is very small then we can end up
@@ -997,7 +1118,7 @@ buf_flush_page(
 		flush_list or LRU_list. */
 
 		if (!is_s_latched) {
-			buf_dblwr_flush_buffered_writes();
+			buf_dblwr_flush_buffered_writes(NULL);
 
 			if (is_uncompressed) {
 				rw_lock_sx_lock_gen(&((buf_block_t*) bpage)
@@ -1668,10 +1789,11 @@ static
 void
 buf_flush_common(
 /*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_dblwr_flush_buffered_writes();
+	buf_dblwr_flush_buffered_writes(buf_pool);
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
@@ -1800,7 +1922,7 @@ buf_flush_LRU(
 
 	buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-	buf_flush_common(BUF_FLUSH_LRU, page_count);
+	buf_flush_common(buf_pool, BUF_FLUSH_LRU, page_count);
 
 	if (n_processed) {
 		*n_processed = page_count;
@@ -1809,6 +1931,55 @@ buf_flush_LRU(
 	return(true);
 }
 
+/*******************************************************************//**
+This utility flushes dirty blocks from the end of the flush list of one
+buffer pool instance.
+NOTE: The calling thread is not allowed to own any latches on pages!
+@return true if a batch was queued successfully. false if another batch
+of same type was already running. */
+static
+bool
+buf_flush_list_instance(
+/*====================*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	ulint		min_n,		/*!< in: wished minimum mumber of blocks
+					flushed (it is not guaranteed that the
+					actual number is that big, though) */
+	lsn_t		lsn_limit,	/*!< in: all blocks whose
+					oldest_modification is smaller than
+					this should be flushed (if their
+					number does not exceed min_n) */
+	ulint*		n_processed)	/*!< out: the number of pages
+					which were processed */
+{
+	ulint		page_count;
+
+	*n_processed = 0;
+
+	if (!buf_flush_start(buf_pool, BUF_FLUSH_LIST)) {
+		return(false);
+	}
+
+	page_count = buf_flush_batch(
+		buf_pool, BUF_FLUSH_LIST, min_n, lsn_limit);
+
+	buf_flush_end(buf_pool, BUF_FLUSH_LIST);
+
+	buf_flush_common(buf_pool, BUF_FLUSH_LIST, page_count);
+
+	if (page_count) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_FLUSH_BATCH_TOTAL_PAGE,
+			MONITOR_FLUSH_BATCH_COUNT,
+			MONITOR_FLUSH_BATCH_PAGES,
+			page_count);
+	}
+
+	*n_processed = page_count;
+
+	return(true);
+}
+
 /*******************************************************************//**
 This utility flushes dirty blocks from the end of the flush list of
 all buffer pool instances.
@@ -1851,12 +2022,11 @@ buf_flush_list(
 
 	/* Flush to lsn_limit in all buffer pool instances */
 	for (i = 0; i < srv_buf_pool_instances; i++) {
-		buf_pool_t*	buf_pool;
 		ulint		page_count = 0;
 
-		buf_pool = buf_pool_from_array(i);
-
-		if (!buf_flush_start(buf_pool, BUF_FLUSH_LIST)) {
+		if (!buf_flush_list_instance(buf_pool_from_array(i),
+					     min_n, lsn_limit,
+					     &page_count)) {
 			/* We have two choices here. If lsn_limit was
 			specified then skipping an instance of buffer
 			pool means we cannot guarantee that all pages
@@ -1872,24 +2042,9 @@ buf_flush_list(
 			continue;
 		}
 
-		page_count = buf_flush_batch(
-			buf_pool, BUF_FLUSH_LIST, min_n, lsn_limit);
-
-		buf_flush_end(buf_pool, BUF_FLUSH_LIST);
-
-		buf_flush_common(BUF_FLUSH_LIST, page_count);
-
 		if (n_processed) {
 			*n_processed += page_count;
 		}
-
-		if (page_count) {
-			MONITOR_INC_VALUE_CUMULATIVE(
-				MONITOR_FLUSH_BATCH_TOTAL_PAGE,
-				MONITOR_FLUSH_BATCH_COUNT,
-				MONITOR_FLUSH_BATCH_PAGES,
-				page_count);
-		}
 	}
 
 	return(success);
@@ -2049,26 +2204,6 @@ buf_flush_wait_LRU_batch_end(void)
 	}
 }
 
-/*********************************************************************//**
-Flush a batch of dirty pages from the flush list
-@return number of pages flushed, 0 if no page is flushed or if another
-flush_list type batch is running */
-static
-ulint
-page_cleaner_do_flush_batch(
-/*========================*/
-	ulint		n_to_flush,	/*!< in: number of pages that
-					we should attempt to flush. */
-	lsn_t		lsn_limit)	/*!< in: LSN up to which flushing
-					must happen */
-{
-	ulint n_flushed;
-
-	buf_flush_list(n_to_flush, lsn_limit, &n_flushed);
-
-	return(n_flushed);
-}
-
 /*********************************************************************//**
 Calculates if flushing is required based on number of dirty pages in
 the buffer pool.
@@ -2143,14 +2278,17 @@ af_get_pct_for_lsn(
 
 /*********************************************************************//**
 This function is called approximately once every second by the
-page_cleaner thread. Based on various factors it decides if there is a
-need to do flushing. If flushing is needed it is performed and the
-number of pages flushed is returned.
-@return number of pages flushed */
+page_cleaner coordinator. Based on various factors it decides how many
+pages should be flushed from the flush_list and up to which LSN.
+@return number of pages recommended to be flushed */
 static
 ulint
-page_cleaner_flush_pages_if_needed(void)
+page_cleaner_flush_pages_recommendation(
 /*====================================*/
+	lsn_t*	lsn_limit,	/*!< out: LSN up to which flushing
+				should happen */
+	ulint	last_pages_in)	/*!< in: number of pages flushed by
+				the previous batch */
 {
 	static	lsn_t		lsn_avg_rate = 0;
 	static	lsn_t		prev_lsn = 0;
@@ -2170,6 +2308,8 @@ page_cleaner_flush_pages_if_needed(void)
 	ulint			pct_total = 0;
 	int			age_factor = 0;
 
+	*lsn_limit = LSN_MAX;
+
 	cur_lsn = log_get_lsn();
 
 	if (prev_lsn == 0) {
@@ -2182,6 +2322,9 @@ page_cleaner_flush_pages_if_needed(void)
 		return(0);
 	}
 
+	sum_pages += last_pages_in;
+	last_pages = last_pages_in + 1;
+
 	/* We update our variables every srv_flushing_avg_loops
 	iterations to smooth out transition in workload. */
 	if (++n_iterations >= srv_flushing_avg_loops) {
@@ -2227,27 +2370,16 @@ page_cleaner_flush_pages_if_needed(void)
 	MONITOR_SET(MONITOR_FLUSH_N_TO_FLUSH_REQUESTED, n_pages);
 
 	prev_pages = n_pages;
-	n_pages = page_cleaner_do_flush_batch(
-		n_pages, oldest_lsn + lsn_avg_rate * (age_factor + 1));
 
-	last_lsn= cur_lsn;
-	last_pages= n_pages + 1;
+	*lsn_limit = oldest_lsn + lsn_avg_rate * (age_factor + 1);
+
+	last_lsn = cur_lsn;
 
 	MONITOR_SET(MONITOR_FLUSH_AVG_PAGE_RATE, avg_page_rate);
 	MONITOR_SET(MONITOR_FLUSH_LSN_AVG_RATE, lsn_avg_rate);
 	MONITOR_SET(MONITOR_FLUSH_PCT_FOR_DIRTY, pct_for_dirty);
 	MONITOR_SET(MONITOR_FLUSH_PCT_FOR_LSN, pct_for_lsn);
 
-	if (n_pages) {
-		MONITOR_INC_VALUE_CUMULATIVE(
-			MONITOR_FLUSH_ADAPTIVE_TOTAL_PAGE,
-			MONITOR_FLUSH_ADAPTIVE_COUNT,
-			MONITOR_FLUSH_ADAPTIVE_PAGES,
-			n_pages);
-
-		sum_pages += n_pages;
-	}
-
 	return(n_pages);
 }
 
@@ -2277,13 +2409,412 @@ page_cleaner_sleep_if_needed(
 }
 
 /******************************************************************//**
-page_cleaner thread tasked with flushing dirty pages from the buffer
-pools. As of now we'll have only one instance of this thread.
+Initialize page_cleaner. Must be called before the page_cleaner
+coordinator and worker threads are created. */
+
+void
+buf_flush_page_cleaner_init(void)
+/*=============================*/
+{
+	ut_ad(page_cleaner == NULL);
+	ut_ad(srv_n_page_cleaners >= 1);
+	ut_ad(srv_n_page_cleaners <= srv_buf_pool_instances);
+
+	page_cleaner = static_cast<page_cleaner_t*>(
+		mem_zalloc(sizeof(*page_cleaner)));
+
+	mutex_create("page_cleaner", &page_cleaner->mutex);
+
+	page_cleaner->is_requested = os_event_create("pc_is_requested");
+	page_cleaner->is_finished = os_event_create("pc_is_finished");
+
+	page_cleaner->n_slots = srv_buf_pool_instances;
+
+	page_cleaner->slots = static_cast<page_cleaner_slot_t*>(
+		mem_zalloc(page_cleaner->n_slots
+			   * sizeof(*page_cleaner->slots)));
+
+	/* The workers are counted here rather than when they start so
+	that the coordinator cannot miss a worker that has not been
+	scheduled yet when shutdown begins. */
+	page_cleaner->n_workers = srv_n_page_cleaners - 1;
+
+	page_cleaner->is_running = true;
+}
+
+/******************************************************************//**
+Close page_cleaner. */
+static
+void
+buf_flush_page_cleaner_close(void)
+/*==============================*/
+{
+	/* Wait for all the worker threads to exit. */
+	while (page_cleaner->n_workers > 0) {
+		os_thread_sleep(10000);
+	}
+
+	mutex_free(&page_cleaner->mutex);
+
+	mem_free(page_cleaner->slots);
+
+	os_event_destroy(page_cleaner->is_finished);
+	os_event_destroy(page_cleaner->is_requested);
+
+	mem_free(page_cleaner);
+
+	page_cleaner = NULL;
+}
+
+/******************************************************************//**
+Requests all the slots to flush all the buffer pool instances.
+@param min_n	wished minimum mumber of blocks flushed
+		(it is not guaranteed that the actual number is that big)
+@param lsn_limit in the case BUF_FLUSH_LIST all blocks whose
+		oldest_modification is smaller than this should be flushed
+		(if their number does not exceed min_n), otherwise ignored */
+static
+void
+pc_request(
+/*=======*/
+	ulint		min_n,
+	lsn_t		lsn_limit)
+{
+	if (min_n != ULINT_MAX) {
+		/* Ensure that flushing is spread evenly amongst the
+		buffer pool instances. When min_n is ULINT_MAX
+		we need to flush everything up to the lsn limit
+		so no limit here. */
+		min_n = (min_n + srv_buf_pool_instances - 1)
+			/ srv_buf_pool_instances;
+	}
+
+	mutex_enter(&page_cleaner->mutex);
+
+	ut_ad(!page_cleaner->requested);
+	ut_ad(page_cleaner->n_slots_requested == 0);
+	ut_ad(page_cleaner->n_slots_flushing == 0);
+	ut_ad(page_cleaner->n_slots_finished == 0);
+
+	page_cleaner->requested = true;
+	page_cleaner->lsn_limit = lsn_limit;
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t* slot = &page_cleaner->slots[i];
+
+		ut_ad(slot->state == PAGE_CLEANER_STATE_NONE);
+
+		slot->state = PAGE_CLEANER_STATE_REQUESTED;
+		slot->n_pages_requested = min_n;
+	}
+
+	page_cleaner->n_slots_requested = page_cleaner->n_slots;
+
+	os_event_set(page_cleaner->is_requested);
+
+	mutex_exit(&page_cleaner->mutex);
+}
+
+/******************************************************************//**
+Do flush for one slot.
+@return the number of the slots which has not been treated yet. */
+static
+ulint
+pc_flush_slot(void)
+/*===============*/
+{
+	page_cleaner_slot_t*	slot = NULL;
+	lsn_t			lsn_limit;
+	ulint			i = 0;
+
+	mutex_enter(&page_cleaner->mutex);
+
+	if (page_cleaner->n_slots_requested > 0) {
+
+		for (i = 0; i < page_cleaner->n_slots; i++) {
+			slot = &page_cleaner->slots[i];
+
+			if (slot->state == PAGE_CLEANER_STATE_REQUESTED) {
+				break;
+			}
+		}
+
+		/* slot should be found because
+		page_cleaner->n_slots_requested > 0 */
+		ut_a(i < page_cleaner->n_slots);
+
+		slot->state = PAGE_CLEANER_STATE_FLUSHING;
+
+		page_cleaner->n_slots_requested--;
+		page_cleaner->n_slots_flushing++;
+
+		if (page_cleaner->n_slots_requested == 0) {
+			os_event_reset(page_cleaner->is_requested);
+		}
+	}
+
+	lsn_limit = page_cleaner->lsn_limit;
+
+	mutex_exit(&page_cleaner->mutex);
+
+	if (slot != NULL) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		ulint		scan_depth;
+		ulint		start_ms;
+
+		/* srv_LRU_scan_depth can be arbitrarily large value.
+		We cap it with current LRU size. */
+		buf_pool_mutex_enter(buf_pool);
+		scan_depth = UT_LIST_GET_LEN(buf_pool->LRU);
+		buf_pool_mutex_exit(buf_pool);
+
+		scan_depth = ut_min(srv_LRU_scan_depth, scan_depth);
+
+		/* Flush pages from end of LRU if required, unless the
+		LRU manager of the instance does it. The slot is owned by
+		this thread in the FLUSHING state, so its counters can be
+		updated without the mutex. */
+		if (buf_lru_manager_n_threads == 0) {
+			start_ms = ut_time_ms();
+			buf_flush_LRU(buf_pool, scan_depth,
+				      &slot->n_flushed_lru);
+			slot->flush_lru_time += ut_time_ms() - start_ms;
+			slot->flush_lru_pass++;
+		} else {
+			slot->n_flushed_lru = 0;
+		}
+
+		/* Flush pages from flush_list if required */
+		start_ms = ut_time_ms();
+		slot->succeeded_list = buf_flush_list_instance(
+			buf_pool, slot->n_pages_requested, lsn_limit,
+			&slot->n_flushed_list);
+		slot->flush_list_time += ut_time_ms() - start_ms;
+		slot->flush_list_pass++;
+
+		mutex_enter(&page_cleaner->mutex);
+
+		ut_ad(slot->state == PAGE_CLEANER_STATE_FLUSHING);
+
+		slot->state = PAGE_CLEANER_STATE_FINISHED;
+
+		page_cleaner->n_slots_flushing--;
+		page_cleaner->n_slots_finished++;
+
+		if (page_cleaner->n_slots_finished
+		    == page_cleaner->n_slots) {
+			os_event_set(page_cleaner->is_finished);
+		}
+
+		mutex_exit(&page_cleaner->mutex);
+	}
+
+	/* No mutex: this is only a hint for the caller's loop. */
+	return(page_cleaner->n_slots_requested);
+}
+
+/******************************************************************//**
+Wait until all flush requests are finished.
+@param n_flushed_lru	number of pages flushed from the end of the LRU list.
+@param n_flushed_list	number of pages flushed from the end of the
+			flush_list.
+@return			true if all flush_list flushing batch were success. */
+static
+bool
+pc_wait_finished(
+/*=============*/
+	ulint*	n_flushed_lru,
+	ulint*	n_flushed_list)
+{
+	bool	all_succeeded = true;
+
+	*n_flushed_lru = 0;
+	*n_flushed_list = 0;
+
+	os_event_wait(page_cleaner->is_finished);
+
+	mutex_enter(&page_cleaner->mutex);
+
+	ut_ad(page_cleaner->n_slots_requested == 0);
+	ut_ad(page_cleaner->n_slots_flushing == 0);
+	ut_ad(page_cleaner->n_slots_finished == page_cleaner->n_slots);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t* slot = &page_cleaner->slots[i];
+
+		ut_ad(slot->state == PAGE_CLEANER_STATE_FINISHED);
+
+		*n_flushed_lru += slot->n_flushed_lru;
+		*n_flushed_list += slot->n_flushed_list;
+		all_succeeded &= slot->succeeded_list;
+
+		slot->state = PAGE_CLEANER_STATE_NONE;
+	}
+
+	page_cleaner->n_slots_finished = 0;
+	page_cleaner->requested = false;
+
+	os_event_reset(page_cleaner->is_finished);
+
+	mutex_exit(&page_cleaner->mutex);
+
+	if (*n_flushed_lru) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
+			MONITOR_LRU_BATCH_FLUSH_COUNT,
+			MONITOR_LRU_BATCH_FLUSH_PAGES,
+			*n_flushed_lru);
+	}
+
+	return(all_succeeded);
+}
+
+/******************************************************************//**
+Requests a flush of all buffer pool instances, takes part in it and waits
+for the worker threads to finish the remaining slots.
+@return true if all flush_list flushing batch were success. */
+static
+bool
+pc_flush_all(
+/*=========*/
+	ulint	min_n,		/*!< in: wished minimum mumber of blocks
+				flushed from the flush_list */
+	lsn_t	lsn_limit,	/*!< in: LSN up to which flushing
+				must happen */
+	ulint*	n_flushed_lru,	/*!< out: pages flushed from the LRU */
+	ulint*	n_flushed_list)	/*!< out: pages flushed from the
+				flush_list */
+{
+	ulint	start_ms = ut_time_ms();
+	bool	success;
+
+	pc_request(min_n, lsn_limit);
+
+	while (pc_flush_slot() > 0) {}
+
+	success = pc_wait_finished(n_flushed_lru, n_flushed_list);
+
+	page_cleaner->flush_time += ut_time_ms() - start_ms;
+	page_cleaner->flush_pass++;
+
+	return(success);
+}
+
+/******************************************************************//**
+Updates the per slot and per thread batch timing monitor counters.
+The values are averaged over srv_flushing_avg_loops coordinator passes. */
+static
+void
+pc_update_monitors(void)
+/*====================*/
+{
+	static ulint	n_iterations = 0;
+
+	if (++n_iterations < srv_flushing_avg_loops) {
+		return;
+	}
+
+	n_iterations = 0;
+
+	ulint	lru_time = 0;
+	ulint	list_time = 0;
+	ulint	lru_pass = 0;
+	ulint	list_pass = 0;
+
+	mutex_enter(&page_cleaner->mutex);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t* slot = &page_cleaner->slots[i];
+
+		lru_time += slot->flush_lru_time;
+		list_time += slot->flush_list_time;
+		lru_pass += slot->flush_lru_pass;
+		list_pass += slot->flush_list_pass;
+
+		slot->flush_lru_time = 0;
+		slot->flush_list_time = 0;
+		slot->flush_lru_pass = 0;
+		slot->flush_list_pass = 0;
+	}
+
+	ulint	flush_time = page_cleaner->flush_time;
+	ulint	flush_pass = page_cleaner->flush_pass;
+
+	page_cleaner->flush_time = 0;
+	page_cleaner->flush_pass = 0;
+
+	mutex_exit(&page_cleaner->mutex);
+
+	/* Average time of one batch on one buffer pool instance. */
+	if (lru_pass) {
+		MONITOR_SET(MONITOR_LRU_BATCH_FLUSH_AVG_TIME_SLOT,
+			    lru_time / lru_pass);
+	}
+
+	if (list_pass) {
+		MONITOR_SET(MONITOR_FLUSH_ADAPTIVE_AVG_TIME_SLOT,
+			    list_time / list_pass);
+	}
+
+	/* Average time spent by one page_cleaner thread in one
+	coordinator pass. */
+	if (flush_pass) {
+		ulint	per_thread = flush_pass * srv_n_page_cleaners;
+
+		MONITOR_SET(MONITOR_LRU_BATCH_FLUSH_AVG_TIME_THREAD,
+			    lru_time / per_thread);
+		MONITOR_SET(MONITOR_FLUSH_ADAPTIVE_AVG_TIME_THREAD,
+			    list_time / per_thread);
+		MONITOR_SET(MONITOR_FLUSH_AVG_TIME, flush_time / flush_pass);
+	}
+
+	MONITOR_SET(MONITOR_FLUSH_AVG_PASS, flush_pass);
+}
+
+/******************************************************************//**
+Wait for the LRU manager threads to exit. They exit on their own at the
+start of the shutdown. */
+static
+void
+buf_flush_lru_manager_wait_exit(void)
+/*=================================*/
+{
+	while (buf_lru_manager_n_threads > 0) {
+		os_thread_sleep(10000);
+	}
+}
+
+/******************************************************************//**
+Free the LRU manager slots. */
+static
+void
+buf_flush_lru_manager_close(void)
+/*=============================*/
+{
+	ut_ad(buf_lru_manager_n_threads == 0);
+
+	if (lru_managers == NULL) {
+		return;
+	}
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		os_event_destroy(lru_managers[i].event);
+	}
+
+	mem_free(lru_managers);
+
+	lru_managers = NULL;
+}
+
+/******************************************************************//**
+page_cleaner coordinator thread tasked with flushing dirty pages from
+the buffer pools. It distributes the work over the page_cleaner worker
+threads and flushes buffer pool instances itself as well.
 @return a dummy parameter */
 extern "C"
 os_thread_ret_t
-DECLARE_THREAD(buf_flush_page_cleaner_thread)(
-/*==========================================*/
+DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
+/*===============================================*/
 	void*	arg __attribute__((unused)))
 			/*!< in: a dummy parameter required by
 			os_thread_create */
@@ -2291,6 +2822,7 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 	ulint	next_loop_time = ut_time_ms() + 1000;
 	ulint	n_flushed = 0;
 	ulint	last_activity = srv_get_activity_count();
+	ulint	last_pages = 0;
 
 	ut_ad(!srv_read_only_mode);
 
@@ -2307,8 +2839,15 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 
 	buf_flush_event = os_event_create("buf_flush_event");
 
+	/* The coordinator is page cleaner thread 0, the workers are
+	numbered from 1. */
+	os_numa_bind_thread(0);
+
 	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 
+		ulint	n_flushed_lru = 0;
+		ulint	n_flushed_list = 0;
+
 		/* The page_cleaner skips sleep if the server is
 		idle and there are no pending IOs in the buffer pool
 		and there is work to do. */
@@ -2322,25 +2861,45 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 		next_loop_time = ut_time_ms() + 1000;
 
 		if (srv_check_activity(last_activity)) {
+			ulint	n_to_flush;
+			lsn_t	lsn_limit;
+
 			last_activity = srv_get_activity_count();
 
-			/* Flush pages from end of LRU if required */
-			n_flushed = buf_flush_LRU_tail();
+			/* Estimate pages from flush_list to be flushed */
+			n_to_flush = page_cleaner_flush_pages_recommendation(
+				&lsn_limit, last_pages);
+
+			/* Flush pages from end of LRU and from
+			flush_list of all instances in parallel */
+			pc_flush_all(n_to_flush, lsn_limit,
+				     &n_flushed_lru, &n_flushed_list);
+
+			if (n_flushed_list) {
+				MONITOR_INC_VALUE_CUMULATIVE(
+					MONITOR_FLUSH_ADAPTIVE_TOTAL_PAGE,
+					MONITOR_FLUSH_ADAPTIVE_COUNT,
+					MONITOR_FLUSH_ADAPTIVE_PAGES,
+					n_flushed_list);
+			}
 
-			/* Flush pages from flush_list if required */
-			n_flushed += page_cleaner_flush_pages_if_needed();
+			last_pages = n_flushed_list;
 		} else {
-			n_flushed = page_cleaner_do_flush_batch(
-				PCT_IO(100), LSN_MAX);
+			pc_flush_all(PCT_IO(100), LSN_MAX,
+				     &n_flushed_lru, &n_flushed_list);
 
-			if (n_flushed) {
+			if (n_flushed_list) {
 				MONITOR_INC_VALUE_CUMULATIVE(
 					MONITOR_FLUSH_BACKGROUND_TOTAL_PAGE,
 					MONITOR_FLUSH_BACKGROUND_COUNT,
 					MONITOR_FLUSH_BACKGROUND_PAGES,
-					n_flushed);
+					n_flushed_list);
 			}
 		}
+
+		n_flushed = n_flushed_lru + n_flushed_list;
+
+		pc_update_monitors();
 	}
 
 	ut_ad(srv_shutdown_state > 0);
@@ -2363,7 +2922,13 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 	dirtied until we enter SRV_SHUTDOWN_FLUSH_PHASE phase. */
 
 	do {
-		n_flushed = page_cleaner_do_flush_batch(PCT_IO(100), LSN_MAX);
+		ulint	n_flushed_lru = 0;
+		ulint	n_flushed_list = 0;
+
+		pc_flush_all(PCT_IO(100), LSN_MAX,
+			     &n_flushed_lru, &n_flushed_list);
+
+		n_flushed = n_flushed_list;
 
 		/* We sleep only if there are no pages to flush */
 		if (n_flushed == 0) {
@@ -2371,6 +2936,10 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 		}
 	} while (srv_shutdown_state == SRV_SHUTDOWN_CLEANUP);
 
+	/* The LRU managers stop at the start of the shutdown. Wait for
+	them so that no LRU batch is started after the final sweep. */
+	buf_flush_lru_manager_wait_exit();
+
 	/* At this point all threads including the master and the purge
 	thread must have been suspended. */
 	ut_a(srv_get_active_thread_type() == SRV_NONE);
@@ -2389,8 +2958,11 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 	bool	success;
 
 	do {
+		ulint	n_flushed_lru = 0;
+
+		success = pc_flush_all(PCT_IO(100), LSN_MAX,
+				       &n_flushed_lru, &n_flushed);
 
-		success = buf_flush_list(PCT_IO(100), LSN_MAX, &n_flushed);
 		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
 
 	} while (!success || n_flushed > 0);
@@ -2407,6 +2979,17 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 	/* We have lived our life. Time to die. */
 
 thread_exit:
+	buf_flush_lru_manager_wait_exit();
+	buf_flush_lru_manager_close();
+
+	/* All worker threads are waiting for the event here,
+	and no more access to page_cleaner structure by them.
+	Wakes worker threads up just to make them exit. */
+	page_cleaner->is_running = false;
+	os_event_set(page_cleaner->is_requested);
+
+	buf_flush_page_cleaner_close();
+
 	buf_page_cleaner_is_active = FALSE;
 
 	os_event_destroy(buf_flush_event);
@@ -2418,6 +3001,236 @@ thread_exit:
 	OS_THREAD_DUMMY_RETURN;
 }
 
+/******************************************************************//**
+Worker thread of page_cleaner. Flushes the buffer pool instances
+requested by the coordinator.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_flush_page_cleaner_worker)(
+/*==========================================*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(page_cleaner_worker_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: page_cleaner worker running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	mutex_enter(&page_cleaner->mutex);
+	ulint	thread_no = ++page_cleaner->n_started;
+	mutex_exit(&page_cleaner->mutex);
+
+	os_numa_bind_thread(thread_no);
+
+	while (true) {
+		os_event_wait(page_cleaner->is_requested);
+
+		if (!page_cleaner->is_running) {
+			break;
+		}
+
+		pc_flush_slot();
+	}
+
+	mutex_enter(&page_cleaner->mutex);
+	page_cleaner->n_workers--;
+	mutex_exit(&page_cleaner->mutex);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/******************************************************************//**
+Initialize the LRU managers. Must be called before the LRU manager
+threads are created. */
+
+void
+buf_flush_lru_manager_init(void)
+/*============================*/
+{
+	ut_ad(lru_managers == NULL);
+
+	lru_managers = static_cast<lru_manager_slot_t*>(
+		mem_zalloc(srv_buf_pool_instances * sizeof(*lru_managers)));
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		lru_managers[i].event = os_event_create("lru_manager_event");
+		lru_managers[i].instance_no = i;
+	}
+
+	/* Counted here rather than when the threads start, for the same
+	reason as page_cleaner_t::n_workers. */
+	buf_lru_manager_n_threads = srv_buf_pool_instances;
+}
+
+/******************************************************************//**
+Returns the LRU manager slot for a buffer pool instance, to be passed to
+buf_flush_lru_manager_thread().
+@return LRU manager slot */
+
+void*
+buf_flush_lru_manager_get_slot(
+/*===========================*/
+	ulint	i)	/*!< in: buffer pool instance number */
+{
+	ut_ad(i < srv_buf_pool_instances);
+
+	return(&lru_managers[i]);
+}
+
+/******************************************************************//**
+Wakes up the LRU manager of a buffer pool instance whose free list was
+found empty. */
+
+void
+buf_flush_lru_manager_wakeup(
+/*=========================*/
+	const buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	if (buf_lru_manager_n_threads > 0) {
+		os_event_set(lru_managers[buf_pool->instance_no].event);
+	}
+}
+
+/******************************************************************//**
+Decides how many pages the next LRU batch of an LRU manager may flush.
+The batch only has to make up for the shortfall of the free list, except
+when the free list has run dry and user threads are waiting.
+@return LRU batch size */
+static
+ulint
+buf_lru_manager_scan_depth(
+/*=======================*/
+	ulint	free_len,	/*!< in: length of the free list */
+	ulint	lru_len)	/*!< in: length of the LRU list */
+{
+	ulint	scan_depth;
+
+	if (free_len == 0) {
+		scan_depth = srv_LRU_scan_depth;
+	} else {
+		scan_depth = srv_LRU_scan_depth - free_len;
+	}
+
+	/* srv_LRU_scan_depth can be arbitrarily large value.
+	We cap it with current LRU size. */
+	return(ut_min(scan_depth, lru_len));
+}
+
+/******************************************************************//**
+Adapts the sleep time of an LRU manager to how full the free list is
+after a batch. A nearly empty free list makes the thread run again at
+once, a full one doubles the sleep time.
+@return sleep time in ms */
+static
+ulint
+buf_lru_manager_adapt_sleep_time(
+/*=============================*/
+	ulint	free_len,	/*!< in: length of the free list */
+	ulint	sleep_ms)	/*!< in: current sleep time in ms */
+{
+	if (free_len < srv_LRU_scan_depth / 10) {
+		return(0);
+	} else if (free_len < srv_LRU_scan_depth) {
+		return(ut_max(sleep_ms / 2, static_cast<ulint>(1)));
+	}
+
+	return(ut_min(sleep_ms * 2 + 1,
+		      static_cast<ulint>(BUF_LRU_MANAGER_MAX_SLEEP)));
+}
+
+/******************************************************************//**
+LRU manager thread of one buffer pool instance. It keeps
+innodb_LRU_scan_depth pages in the free list, so that user threads do not
+have to scan the LRU or flush pages themselves to find a free block.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_flush_lru_manager_thread)(
+/*=========================================*/
+	void*	arg)	/*!< in: LRU manager slot, see
+			buf_flush_lru_manager_get_slot() */
+{
+	lru_manager_slot_t*	slot = static_cast<lru_manager_slot_t*>(arg);
+	buf_pool_t*		buf_pool = buf_pool_from_array(
+		slot->instance_no);
+	ulint			sleep_ms = BUF_LRU_MANAGER_MAX_SLEEP;
+
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(lru_manager_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: LRU manager thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	/* Run on the NUMA node that holds the memory of the instance. */
+	os_numa_bind_thread(slot->instance_no);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+
+		if (sleep_ms > 0) {
+			ib_int64_t	sig_count = os_event_reset(
+				slot->event);
+
+			os_event_wait_time_low(
+				slot->event, sleep_ms * 1000, sig_count);
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		ulint	free_len;
+		ulint	lru_len;
+
+		buf_pool_mutex_enter(buf_pool);
+		free_len = UT_LIST_GET_LEN(buf_pool->free);
+		lru_len = UT_LIST_GET_LEN(buf_pool->LRU);
+		buf_pool_mutex_exit(buf_pool);
+
+		if (free_len < srv_LRU_scan_depth) {
+			ulint	n_flushed = 0;
+
+			buf_flush_LRU(
+				buf_pool,
+				buf_lru_manager_scan_depth(free_len, lru_len),
+				&n_flushed);
+
+			if (n_flushed) {
+				MONITOR_INC_VALUE_CUMULATIVE(
+					MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
+					MONITOR_LRU_BATCH_FLUSH_COUNT,
+					MONITOR_LRU_BATCH_FLUSH_PAGES,
+					n_flushed);
+			}
+
+			/* The dirty pages that were flushed are put on
+			the free list at the end of their writes. */
+			free_len = UT_LIST_GET_LEN(buf_pool->free)
+				+ n_flushed;
+		}
+
+		sleep_ms = buf_lru_manager_adapt_sleep_time(free_len, sleep_ms);
+	}
+
+	os_atomic_decrement_ulint(&buf_lru_manager_n_threads, 1);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*******************************************************************//**
 Synchronously flush dirty blocks from the end of the flush list of all buffer
 pool instances.
@@ -81,6 +81,14 @@ buffer pools. */
 during LRU eviction. */
 #define BUF_LRU_SEARCH_SCAN_THRESHOLD	100
 
+/** When the free list is empty, a thread waits this many times for the
+LRU manager before it frees a block itself. */
+#define BUF_LRU_MANAGER_MAX_WAITS	100
+
+/** Time to wait for the LRU manager to refill the free list, in
+microseconds */
+#define BUF_LRU_MANAGER_WAIT_USEC	1000
+
 /** If we switch on the InnoDB monitor because there are too few available
 frames in the buffer pool, we set this to TRUE */
 static ibool	buf_lru_switched_on_innodb_mon	= FALSE;
@@ -1101,6 +1109,7 @@ buf_LRU_buf_pool_running_out(void)
 
 		if (!recv_recovery_on
 		    && UT_LIST_GET_LEN(buf_pool->free)
+		       + UT_LIST_GET_LEN(buf_pool->withdraw)
 		       + UT_LIST_GET_LEN(buf_pool->LRU)
 		       < buf_pool->curr_size / 4) {
 
@@ -1127,9 +1136,8 @@ buf_LRU_get_free_only(
 
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
-	block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
-
-	if (block) {
+	while ((block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free))
+	       != NULL) {
 
 		ut_ad(block->page.in_free_list);
 		ut_d(block->page.in_free_list = FALSE);
@@ -1138,6 +1146,13 @@ buf_LRU_get_free_only(
 		ut_a(!buf_page_in_file(&block->page));
 		UT_LIST_REMOVE(buf_pool->free, &block->page);
 
+		if (buf_pool_will_withdraw(buf_pool, block)) {
+			/* The chunk of the block is being removed by
+			buf_pool_resize(). */
+			UT_LIST_ADD_LAST(buf_pool->withdraw, &block->page);
+			continue;
+		}
+
 		buf_page_mutex_enter(block);
 
 		buf_block_set_state(block, BUF_BLOCK_READY_FOR_USE);
@@ -1146,6 +1161,7 @@ buf_LRU_get_free_only(
 		ut_ad(buf_pool_from_block(block) == buf_pool);
 
 		buf_page_mutex_exit(block);
+		break;
 	}
 
 	return(block);
@@ -1165,6 +1181,7 @@ buf_LRU_check_size_of_non_data_objects(
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
 	if (!recv_recovery_on && UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw)
 	    + UT_LIST_GET_LEN(buf_pool->LRU) < buf_pool->curr_size / 20) {
 		ib_logf(IB_LOG_LEVEL_FATAL,
 			"Over 95 percent of the buffer pool is occupied by"
@@ -1179,6 +1196,7 @@ buf_LRU_check_size_of_non_data_objects(
 
 	} else if (!recv_recovery_on
 		   && (UT_LIST_GET_LEN(buf_pool->free)
+		       + UT_LIST_GET_LEN(buf_pool->withdraw)
 		       + UT_LIST_GET_LEN(buf_pool->LRU))
 		   < buf_pool->curr_size / 3) {
 
@@ -1254,6 +1272,7 @@ buf_LRU_get_free_block(
 	buf_block_t*	block		= NULL;
 	bool		freed		= false;
 	ulint		n_iterations	= 0;
+	ulint		n_waits		= 0;
 	ulint		flush_failures	= 0;
 	ibool		mon_value_was	= FALSE;
 	ibool		started_monitor	= FALSE;
@@ -1280,6 +1299,26 @@ loop:
 		return(block);
 	}
 
+	if (buf_lru_manager_n_threads > 0
+	    && n_waits < BUF_LRU_MANAGER_MAX_WAITS) {
+		/* Leave the LRU scan and the flushing to the LRU manager
+		of this instance, and wait for it to refill the free list.
+		If it cannot keep up, fall back to freeing a block
+		ourselves. */
+		buf_pool_mutex_exit(buf_pool);
+
+		buf_flush_lru_manager_wakeup(buf_pool);
+
+		MONITOR_INC(MONITOR_LRU_GET_FREE_WAITS);
+		srv_stats.buf_pool_wait_free.add(n_waits, 1);
+
+		os_thread_sleep(BUF_LRU_MANAGER_WAIT_USEC);
+
+		n_waits++;
+
+		goto loop;
+	}
+
 	freed = false;
 	if (buf_pool->try_LRU_scan || n_iterations > 0) {
 		/* If no block was in the free list, search from the
@@ -1505,6 +1544,7 @@ buf_LRU_adjust_hp(
 	buf_pool->lru_hp.adjust(bpage);
 	buf_pool->lru_scan_itr.adjust(bpage);
 	buf_pool->single_scan_itr.adjust(bpage);
+	buf_pool->withdraw_hp.adjust(bpage);
 }
 
 /******************************************************************//**
@@ -2141,8 +2181,14 @@ buf_LRU_block_free_non_file_page(
 		page_zip_set_size(&block->page.zip, 0);
 	}
 
-	UT_LIST_ADD_FIRST(buf_pool->free, &block->page);
-	ut_d(block->page.in_free_list = TRUE);
+	if (buf_pool_will_withdraw(buf_pool, block)) {
+		/* The chunk of the block is being removed by
+		buf_pool_resize(). */
+		UT_LIST_ADD_LAST(buf_pool->withdraw, &block->page);
+	} else {
+		UT_LIST_ADD_FIRST(buf_pool->free, &block->page);
+		ut_d(block->page.in_free_list = TRUE);
+	}
 
 	UNIV_MEM_ASSERT_AND_FREE(block->frame, UNIV_PAGE_SIZE);
 }
@@ -2521,6 +2567,27 @@ buf_LRU_old_ratio_update(
 	return(new_ratio);
 }
 
+/**********************************************************************//**
+Determines if a scan of the given number of pages would replace all the
+"old" blocks of the LRU lists. The pages read by such a scan should be
+released with buf_page_release_scanned() once the scan is done with them,
+so that the scan keeps reusing the same few frames at the end of the LRU
+lists instead of evicting pages which were about to be made young.
+@return TRUE if the scan should be scan-resistant */
+
+ibool
+buf_LRU_scan_is_large(
+/*==================*/
+	ulint	n_pages)	/*!< in: number of pages to scan */
+{
+	/* All instances have the same LRU_old_ratio. */
+	ulint	old_len = buf_pool_get_n_pages()
+		/ BUF_LRU_OLD_RATIO_DIV
+		* buf_pool_from_array(0)->LRU_old_ratio;
+
+	return(n_pages > old_len);
+}
+
 /********************************************************************//**
 Update the historical stats that we are collecting for LRU eviction
 policy at the end of each interval. */
@@ -470,6 +470,33 @@ buf_read_page_async(
 	return(count > 0);
 }
 
+/********************************************************************//**
+Queues an asynchronous read of a page into buf_pool if it is not already
+there, and returns without waiting for the read to complete.
+@return TRUE if a read request was queued */
+
+ibool
+buf_read_page_background(
+/*=====================*/
+	ulint	space,	/*!< in: space id */
+	ulint	zip_size,/*!< in: compressed page size in bytes, or 0 */
+	ulint	offset)	/*!< in: page number */
+{
+	ib_int64_t	tablespace_version;
+	ulint		count;
+	dberr_t		err;
+
+	tablespace_version = fil_space_get_version(space);
+
+	count = buf_read_page_low(&err, false, BUF_READ_ANY_PAGE
+				  | BUF_READ_IGNORE_NONEXISTENT_PAGES,
+				  space, zip_size, FALSE,
+				  tablespace_version, offset);
+	srv_stats.buf_pool_reads.add(count);
+
+	return(count > 0);
+}
+
 /********************************************************************//**
 Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
@@ -100,6 +100,8 @@ ulong	zip_pad_max = 50;
 					hash table fixed size in bytes */
 #define DICT_POOL_PER_VARYING	4	/*!< buffer pool max size per data
 					dictionary varying size in bytes */
+#define DICT_TABLE_HASH_LATCHES_SIZE 64	/*!< number of rw-locks protecting
+					the cells of dict_sys->table_hash */
 
 /** Identifies generated InnoDB foreign key names */
 static char	dict_ibfk[] = "_ibfk_";
@@ -376,6 +378,103 @@ dict_table_stats_unlock(
 	}
 }
 
+/**********************************************************************//**
+Increments the count of open handles to a table. The count is modified
+atomically, because dict_table_open_on_name_in_cache() increments it
+without holding dict_sys->mutex. */
+UNIV_INLINE
+void
+dict_table_n_ref_inc(
+/*=================*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+#ifdef HAVE_ATOMIC_BUILTINS
+	os_atomic_increment_ulint(&table->n_ref_count, 1);
+#else
+	++table->n_ref_count;
+#endif /* HAVE_ATOMIC_BUILTINS */
+}
+
+/**********************************************************************//**
+Decrements the count of open handles to a table.
+@return the count after decrementing */
+UNIV_INLINE
+ulint
+dict_table_n_ref_dec(
+/*=================*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+	ut_a(table->n_ref_count > 0);
+
+#ifdef HAVE_ATOMIC_BUILTINS
+	return(os_atomic_decrement_ulint(&table->n_ref_count, 1));
+#else
+	return(--table->n_ref_count);
+#endif /* HAVE_ATOMIC_BUILTINS */
+}
+
+#ifdef HAVE_ATOMIC_BUILTINS
+/**********************************************************************//**
+Looks up a table that somebody already has open and increments its count
+of open handles without acquiring dict_sys->mutex. The count is never
+incremented from zero, because a table that nobody has open may be evicted
+or dropped, and its persistent statistics must be re-read on the next open
+(see dict_table_close()). Such tables, as well as corrupted tables and
+tables with aborted index creations, are left to the caller, which must
+then use the regular path under dict_sys->mutex. The table is not moved
+to the start of the LRU list, because it cannot be evicted while it is
+open.
+@return table, or NULL if it must be opened under dict_sys->mutex */
+static
+dict_table_t*
+dict_table_open_on_name_in_cache(
+/*=============================*/
+	const char*	table_name)	/*!< in: table name */
+{
+	dict_table_t*	table;
+	ulint		fold = ut_fold_string(table_name);
+
+	hash_lock_s(dict_sys->table_hash, fold);
+
+	HASH_SEARCH(name_hash, dict_sys->table_hash, fold,
+		    dict_table_t*, table, ut_ad(table->cached),
+		    !strcmp(table->name, table_name));
+
+	if (table != NULL && (table->corrupted || table->drop_aborted)) {
+		table = NULL;
+	}
+
+	if (table != NULL) {
+		ulint	n_ref = table->n_ref_count;
+
+		for (;;) {
+			if (n_ref == 0) {
+				table = NULL;
+				break;
+			}
+
+			if (os_compare_and_swap_ulint(
+				    &table->n_ref_count, n_ref, n_ref + 1)) {
+				break;
+			}
+
+			n_ref = table->n_ref_count;
+		}
+	}
+
+	hash_unlock_s(dict_sys->table_hash, fold);
+
+	if (table != NULL) {
+		MONITOR_INC(MONITOR_TABLE_REFERENCE);
+	}
+
+	return(table);
+}
+#endif /* HAVE_ATOMIC_BUILTINS */
+
 /**********************************************************************//**
 Try to drop any indexes after an aborted index creation.
 This can also be after a server kill during DROP INDEX. */
@@ -463,9 +562,8 @@ dict_table_close(
 	}
 
 	ut_ad(mutex_own(&dict_sys->mutex));
-	ut_a(table->n_ref_count > 0);
 
-	--table->n_ref_count;
+	ulint	n_ref = dict_table_n_ref_dec(table);
 
 	/* Force persistent stats re-read upon next open of the table
 	so that FLUSH TABLE can be used to forcibly fetch stats from disk
@@ -473,7 +571,7 @@ dict_table_close(
 	only if table reference count is 0 because we do not want too frequent
 	stats re-reads (e.g. in other cases than FLUSH TABLE). */
 	if (strchr(table->name, '/') != NULL
-	    && table->n_ref_count == 0
+	    && n_ref == 0
 	    && dict_stats_is_persistent_enabled(table)) {
 
 		dict_stats_deinit(table);
@@ -824,7 +922,7 @@ dict_table_open_on_id(
 			dict_move_to_mru(table);
 		}
 
-		++table->n_ref_count;
+		dict_table_n_ref_inc(table);
 
 		MONITOR_INC(MONITOR_TABLE_REFERENCE);
 	}
@@ -908,6 +1006,12 @@ dict_init(void)
 		buf_pool_get_curr_size()
 		/ (DICT_POOL_PER_TABLE_HASH * UNIV_WORD_SIZE));
 
+	/* The name hash is modified only while holding dict_sys->mutex
+	and the rw-lock of the cell, so that dict_table_open_on_name()
+	can look up a table holding only the rw-lock in shared mode. */
+	hash_create_sync_obj(dict_sys->table_hash, HASH_TABLE_SYNC_RW_LOCK,
+			     "dict_table_hash", DICT_TABLE_HASH_LATCHES_SIZE);
+
 	dict_sys->table_id_hash = hash_create(
 		buf_pool_get_curr_size()
 		/ (DICT_POOL_PER_TABLE_HASH * UNIV_WORD_SIZE));
@@ -972,6 +1076,16 @@ dict_table_open_on_name(
 	DBUG_ENTER("dict_table_open_on_name");
 	DBUG_PRINT("dict_table_open_on_name", ("table: '%s'", table_name));
 
+#ifdef HAVE_ATOMIC_BUILTINS
+	if (!dict_locked) {
+		table = dict_table_open_on_name_in_cache(table_name);
+
+		if (table != NULL) {
+			DBUG_RETURN(table);
+		}
+	}
+#endif /* HAVE_ATOMIC_BUILTINS */
+
 	if (!dict_locked) {
 		mutex_enter(&(dict_sys->mutex));
 	}
@@ -1014,7 +1128,7 @@ dict_table_open_on_name(
 			dict_move_to_mru(table);
 		}
 
-		++table->n_ref_count;
+		dict_table_n_ref_inc(table);
 
 		MONITOR_INC(MONITOR_TABLE_REFERENCE);
 	}
@@ -1158,8 +1272,10 @@ dict_table_add_to_cache(
 	}
 
 	/* Add table to hash table of tables */
+	hash_lock_x(dict_sys->table_hash, fold);
 	HASH_INSERT(dict_table_t, name_hash, dict_sys->table_hash, fold,
 		    table);
+	hash_unlock_x(dict_sys->table_hash, fold);
 
 	/* Add table to hash table of tables based on table id */
 	HASH_INSERT(dict_table_t, id_hash, dict_sys->table_id_hash, id_fold,
@@ -1227,7 +1343,7 @@ dict_table_can_be_evicted(
 
 			See also: dict_index_remove_from_cache_low() */
 
-			if (btr_search_info_get_ref_count(info) > 0) {
+			if (btr_search_info_get_ref_count(info, index) > 0) {
 				return(FALSE);
 			}
 		}
@@ -1524,8 +1640,12 @@ dict_table_rename_in_cache(
 	}
 
 	/* Remove table from the hash tables of tables */
+	ulint	old_fold = ut_fold_string(old_name);
+
+	hash_lock_x(dict_sys->table_hash, old_fold);
 	HASH_DELETE(dict_table_t, name_hash, dict_sys->table_hash,
-		    ut_fold_string(old_name), table);
+		    old_fold, table);
+	hash_unlock_x(dict_sys->table_hash, old_fold);
 
 	if (strlen(new_name) > strlen(table->name)) {
 		/* We allocate MAX_FULL_NAME_LEN + 1 bytes here to avoid
@@ -1539,8 +1659,10 @@ dict_table_rename_in_cache(
 	memcpy(table->name, new_name, strlen(new_name) + 1);
 
 	/* Add table to hash table of tables */
+	hash_lock_x(dict_sys->table_hash, fold);
 	HASH_INSERT(dict_table_t, name_hash, dict_sys->table_hash, fold,
 		    table);
+	hash_unlock_x(dict_sys->table_hash, fold);
 
 	dict_sys->size += strlen(new_name) - strlen(old_name);
 	ut_a(dict_sys->size > 0);
@@ -1856,9 +1978,12 @@ dict_table_remove_from_cache_low(
 	}
 
 	/* Remove table from the hash tables of tables */
+	ulint	fold = ut_fold_string(table->name);
 
+	hash_lock_x(dict_sys->table_hash, fold);
 	HASH_DELETE(dict_table_t, name_hash, dict_sys->table_hash,
-		    ut_fold_string(table->name), table);
+		    fold, table);
+	hash_unlock_x(dict_sys->table_hash, fold);
 
 	HASH_DELETE(dict_table_t, id_hash, dict_sys->table_id_hash,
 		    ut_fold_ull(table->id), table);
@@ -2514,6 +2639,7 @@ undo_size_ok:
 	new_index->table = table;
 	new_index->table_name = table->name;
 	new_index->search_info = btr_search_info_create(new_index->heap);
+	new_index->fixed_offsets = rec_get_fixed_offsets(new_index);
 
 	new_index->page = page_no;
 	rw_lock_create(index_tree_rw_lock_key, &new_index->lock,
@@ -2570,7 +2696,7 @@ dict_index_remove_from_cache_low(
 	zero. See also: dict_table_can_be_evicted() */
 
 	do {
-		ulint ref_count = btr_search_info_get_ref_count(info);
+		ulint ref_count = btr_search_info_get_ref_count(info, index);
 
 		if (ref_count == 0) {
 			break;
@@ -6335,6 +6461,12 @@ dict_close(void)
 		}
 	}
 
+	for (i = 0; i < dict_sys->table_hash->n_sync_obj; i++) {
+		rw_lock_free(&dict_sys->table_hash->sync_obj.rw_locks[i]);
+	}
+
+	mem_free(dict_sys->table_hash->sync_obj.rw_locks);
+
 	hash_table_free(dict_sys->table_hash);
 
 	/* The elements are the same instance as in dict_sys->table_hash,
@@ -152,6 +152,10 @@ dict_mem_table_free(
 #ifndef UNIV_HOTBACKUP
 	mutex_free(&(table->autoinc_mutex));
 #endif /* UNIV_HOTBACKUP */
+	if (table->stat_hist_heap != NULL) {
+		mem_heap_free(table->stat_hist_heap);
+	}
+
 	ut_free(table->name);
 	mem_heap_free(table->heap);
 }
@@ -45,8 +45,10 @@ Created Jan 06, 2010 Vasil Dimov
 #include "row0types.h"
 #include "trx0trx.h"
 #include "trx0roll.h"
+#include "srv0srv.h"
 #include "ut0rnd.h"
 
+#include <algorithm>
 #include <vector>
 
 /* Sampling algorithm description @{
@@ -119,6 +121,12 @@ where n=1..n_uniq.
 #define TABLE_STATS_NAME_PRINT	"mysql.innodb_table_stats"
 #define INDEX_STATS_NAME	"mysql/innodb_index_stats"
 #define INDEX_STATS_NAME_PRINT	"mysql.innodb_index_stats"
+#define COLUMN_STATS_NAME	"mysql/innodb_column_stats"
+#define COLUMN_STATS_NAME_PRINT	"mysql.innodb_column_stats"
+
+/* Maximum length of a column for which a histogram is sampled; this is
+the length of mysql.innodb_column_stats.endpoint */
+#define HIST_MAX_COL_LEN	767
 
 #ifdef UNIV_STATS_DEBUG
 #define DEBUG_PRINTF(fmt, ...)	printf(fmt, ## __VA_ARGS__)
@@ -267,6 +275,77 @@ dict_stats_persistent_storage_check(
 	return(true);
 }
 
+/*********************************************************************//**
+Checks whether the table for the column histograms exists and has the
+proper structure. The table is optional: if it is missing, the histograms
+are neither saved nor fetched and no error is reported.
+@return true if exists and is ok */
+static
+bool
+dict_stats_column_stats_check(
+/*==========================*/
+	bool	caller_has_dict_sys_mutex)	/*!< in: true if the caller
+						owns dict_sys->mutex */
+{
+	/* definition for the table COLUMN_STATS_NAME */
+	dict_col_meta_t	column_stats_columns[] = {
+		{"database_name", DATA_VARMYSQL,
+			DATA_NOT_NULL, 192},
+
+		{"table_name", DATA_VARMYSQL,
+			DATA_NOT_NULL, 192},
+
+		{"column_name", DATA_VARMYSQL,
+			DATA_NOT_NULL, 192},
+
+		{"bucket_no", DATA_INT,
+			DATA_NOT_NULL | DATA_UNSIGNED, 8},
+
+		{"last_update", DATA_FIXBINARY,
+			DATA_NOT_NULL, 4},
+
+		{"endpoint", DATA_BINARY,
+			DATA_NOT_NULL, HIST_MAX_COL_LEN},
+
+		{"n_rows", DATA_INT,
+			DATA_NOT_NULL | DATA_UNSIGNED, 8},
+
+		{"n_endpoint_rows", DATA_INT,
+			DATA_NOT_NULL | DATA_UNSIGNED, 8},
+
+		{"n_distinct", DATA_INT,
+			DATA_NOT_NULL | DATA_UNSIGNED, 8},
+
+		{"sample_size", DATA_INT,
+			DATA_NOT_NULL | DATA_UNSIGNED, 8}
+	};
+	dict_table_schema_t	column_stats_schema = {
+		COLUMN_STATS_NAME,
+		UT_ARR_SIZE(column_stats_columns),
+		column_stats_columns,
+		0 /* n_foreign */,
+		0 /* n_referenced */
+	};
+
+	char		errstr[512];
+	dberr_t		ret;
+
+	if (!caller_has_dict_sys_mutex) {
+		mutex_enter(&(dict_sys->mutex));
+	}
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	ret = dict_table_schema_check(&column_stats_schema, errstr,
+				      sizeof(errstr));
+
+	if (!caller_has_dict_sys_mutex) {
+		mutex_exit(&(dict_sys->mutex));
+	}
+
+	return(ret == DB_SUCCESS);
+}
+
 /*********************************************************************//**
 Executes a given SQL statement using the InnoDB internal SQL parser
 in its own transaction and commits it.
@@ -319,6 +398,109 @@ dict_stats_exec_sql(
 	return(err);
 }
 
+/*********************************************************************//**
+Frees the column histograms of a table.
+The caller must own the table's stats latch in X mode, unless the table
+is a private copy made by dict_stats_table_clone_create(). */
+static
+void
+dict_stats_hist_free(
+/*=================*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	if (table->stat_hist_heap != NULL) {
+		mem_heap_free(table->stat_hist_heap);
+	}
+
+	table->stat_hist_heap = NULL;
+	table->stat_n_hist = 0;
+	table->stat_hist = NULL;
+}
+
+/*********************************************************************//**
+Copies the column histograms of one table to another, replacing the
+histograms of the destination table. */
+static
+void
+dict_stats_hist_copy(
+/*=================*/
+	dict_table_t*		dst,	/*!< in/out: destination table */
+	const dict_table_t*	src)	/*!< in: source table */
+{
+	dict_stats_hist_free(dst);
+
+	if (src->stat_n_hist == 0) {
+		return;
+	}
+
+	mem_heap_t*	heap = mem_heap_create(1024);
+
+	dst->stat_hist = static_cast<dict_col_hist_t*>(
+		mem_heap_alloc(heap,
+			       src->stat_n_hist * sizeof(*dst->stat_hist)));
+
+	for (ulint i = 0; i < src->stat_n_hist; i++) {
+		const dict_col_hist_t*	s = &src->stat_hist[i];
+		dict_col_hist_t*	d = &dst->stat_hist[i];
+
+		*d = *s;
+
+		d->col_name = mem_heap_strdup(heap, s->col_name);
+
+		d->buckets = static_cast<dict_col_hist_bucket_t*>(
+			mem_heap_alloc(heap,
+				       s->n_buckets * sizeof(*d->buckets)));
+
+		for (ulint j = 0; j < s->n_buckets; j++) {
+			d->buckets[j] = s->buckets[j];
+			d->buckets[j].endpoint = static_cast<const byte*>(
+				mem_heap_dup(heap, s->buckets[j].endpoint,
+					     s->buckets[j].endpoint_len));
+		}
+	}
+
+	dst->stat_hist_heap = heap;
+	dst->stat_n_hist = src->stat_n_hist;
+}
+
+/*********************************************************************//**
+Looks up the columns of the histograms of a table by their names, after
+the histograms have been fetched from the persistent storage. Histograms
+of columns that no longer exist, or whose type is no longer sampled, are
+ignored. The caller must own the table's stats latch in X mode. */
+static
+void
+dict_stats_hist_resolve(
+/*====================*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	for (ulint i = 0; i < table->stat_n_hist; i++) {
+		dict_col_hist_t*	hist = &table->stat_hist[i];
+
+		hist->col_no = ULINT_UNDEFINED;
+
+		for (ulint j = 0; j < dict_table_get_n_user_cols(table); j++) {
+			const dict_col_t*	col;
+
+			if (strcmp(dict_table_get_col_name(table, j),
+				   hist->col_name) != 0) {
+				continue;
+			}
+
+			col = dict_table_get_nth_col(table, j);
+
+			if (!DATA_LARGE_MTYPE(col->mtype)
+			    && dict_col_get_max_size(col)
+			    <= HIST_MAX_COL_LEN) {
+
+				hist->col_no = j;
+			}
+
+			break;
+		}
+	}
+}
+
 /*********************************************************************//**
 Duplicate a table object and its indexes.
 This function creates a dummy dict_table_t object and initializes the
@@ -327,6 +509,7 @@ dict_table_t::id (copied)
 dict_table_t::heap (newly created)
 dict_table_t::name (copied)
 dict_table_t::corrupted (copied)
+dict_table_t::stat_hist (empty)
 dict_table_t::indexes<> (newly created)
 dict_table_t::magic_n
 for each entry in dict_table_t::indexes, the following are initialized:
@@ -406,6 +589,10 @@ dict_stats_table_clone_create(
 
 	t->corrupted = table->corrupted;
 
+	t->stat_hist_heap = NULL;
+	t->stat_n_hist = 0;
+	t->stat_hist = NULL;
+
 	UT_LIST_INIT(t->indexes, &dict_index_t::indexes);
 
 	for (index = dict_table_get_first_index(table);
@@ -484,6 +671,7 @@ dict_stats_table_clone_free(
 /*========================*/
 	dict_table_t*	t)	/*!< in: dummy table object to free */
 {
+	dict_stats_hist_free(t);
 	mem_heap_free(t->heap);
 }
 
@@ -533,6 +721,8 @@ dict_stats_empty_table(
 		= UT_LIST_GET_LEN(table->indexes) - 1;
 	table->stat_modified_counter = 0;
 
+	dict_stats_hist_free(table);
+
 	dict_index_t*	index;
 
 	for (index = dict_table_get_first_index(table);
@@ -652,6 +842,8 @@ dict_stats_copy(
 	dst->stat_sum_of_other_index_sizes = src->stat_sum_of_other_index_sizes;
 	dst->stat_modified_counter = src->stat_modified_counter;
 
+	dict_stats_hist_copy(dst, src);
+
 	dict_index_t*	dst_idx;
 	dict_index_t*	src_idx;
 
@@ -729,6 +921,7 @@ dict_table_t::stat_n_rows
 dict_table_t::stat_clustered_index_size
 dict_table_t::stat_sum_of_other_index_sizes
 dict_table_t::stat_modified_counter
+dict_table_t::stat_hist
 dict_index_t::stat_n_diff_key_vals[]
 dict_index_t::stat_n_sample_sizes[]
 dict_index_t::stat_n_non_null_key_vals[]
@@ -2002,6 +2195,311 @@ found_level:
 	DBUG_VOID_RETURN;
 }
 
+/** A sampled value of a column, see dict_stats_analyze_columns() */
+struct hist_val_t {
+	const byte*	data;	/*!< the value, in the InnoDB format */
+	ulint		len;	/*!< length of data */
+};
+
+/** The sampled values of a column */
+typedef std::vector<hist_val_t>	hist_vals_t;
+
+/** Orders sampled values by the collation of their column */
+class hist_val_less {
+public:
+	hist_val_less(const dict_col_t* col) : m_col(col) {}
+
+	bool operator()(const hist_val_t& a, const hist_val_t& b) const
+	{
+		return(cmp_data_data(m_col->mtype, m_col->prtype,
+				     a.data, a.len, b.data, b.len) < 0);
+	}
+
+private:
+	/** the column whose values are compared */
+	const dict_col_t*	m_col;
+};
+
+/*********************************************************************//**
+Adds the values of the sampled columns in the user records of a leaf
+page of the clustered index to the samples. Delete-marked records are
+skipped, SQL NULL values are only counted in n_sampled. */
+static
+void
+dict_stats_sample_page(
+/*===================*/
+	const page_t*			page,	/*!< in: leaf page */
+	dict_index_t*			index,	/*!< in: clustered index */
+	const std::vector<ulint>&	cols,	/*!< in: numbers of the
+						sampled columns */
+	std::vector<hist_vals_t>&	vals,	/*!< in/out: sampled values
+						of each column in cols */
+	ib_uint64_t*			n_sampled,/*!< in/out: number of
+						sampled records */
+	mem_heap_t*			heap)	/*!< in: heap for the values */
+{
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	mem_heap_t*	offsets_heap = NULL;
+	const ulint	comp = page_is_comp(page);
+
+	rec_offs_init(offsets_);
+
+	for (const rec_t* rec = page_rec_get_next_const(
+		     page_get_infimum_rec(page));
+	     !page_rec_is_supremum(rec);
+	     rec = page_rec_get_next_const(rec)) {
+
+		if (rec_get_deleted_flag(rec, comp)) {
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &offsets_heap);
+
+		for (ulint i = 0; i < cols.size(); i++) {
+			const dict_col_t*	col;
+			const byte*		data;
+			ulint			len;
+			ulint			pos;
+
+			col = dict_table_get_nth_col(index->table, cols[i]);
+			pos = dict_col_get_clust_pos(col, index);
+
+			data = rec_get_nth_field(rec, offsets, pos, &len);
+
+			if (len == UNIV_SQL_NULL
+			    || rec_offs_nth_extern(offsets, pos)) {
+				continue;
+			}
+
+			hist_val_t	val;
+
+			val.data = static_cast<const byte*>(
+				mem_heap_dup(heap, data, len));
+			val.len = len;
+
+			vals[i].push_back(val);
+		}
+
+		++*n_sampled;
+	}
+
+	if (offsets_heap != NULL) {
+		mem_heap_free(offsets_heap);
+	}
+}
+
+/*********************************************************************//**
+Builds the histogram of a column from its sorted sampled values. When
+there are more distinct values than buckets, the values are put in
+buckets of about vals.size() / n_buckets rows each, and a bucket is only
+closed after the last occurrence of a value, so that frequent values
+become bucket endpoints with an exact count. */
+static
+void
+dict_stats_build_hist(
+/*==================*/
+	dict_col_hist_t*	hist,		/*!< out: histogram; col_name,
+						col_no and sample_size must
+						be set by the caller */
+	const dict_col_t*	col,		/*!< in: the column */
+	const hist_vals_t&	vals,		/*!< in: sorted values */
+	ulint			n_buckets,	/*!< in: maximum number of
+						buckets */
+	mem_heap_t*		heap)		/*!< in: heap for hist */
+{
+	ulint		n_distinct = 0;
+
+	ut_ad(!vals.empty());
+
+	for (ulint i = 0; i < vals.size(); i++) {
+		if (i == 0
+		    || cmp_data_data(col->mtype, col->prtype,
+				     vals[i - 1].data, vals[i - 1].len,
+				     vals[i].data, vals[i].len) != 0) {
+			++n_distinct;
+		}
+	}
+
+	/* With no more distinct values than buckets, close a bucket after
+	each value, giving a singleton histogram. */
+	const ib_uint64_t	rows_per_bucket = n_distinct <= n_buckets
+		? 0 : (vals.size() + n_buckets - 1) / n_buckets;
+
+	hist->buckets = static_cast<dict_col_hist_bucket_t*>(
+		mem_heap_zalloc(heap,
+				ut_min(n_distinct, n_buckets)
+				* sizeof(*hist->buckets)));
+	hist->n_buckets = 0;
+
+	dict_col_hist_bucket_t*	bucket = hist->buckets;
+
+	for (ulint i = 0; i < vals.size(); ) {
+		ulint	end = i + 1;
+
+		while (end < vals.size()
+		       && cmp_data_data(col->mtype, col->prtype,
+					vals[i].data, vals[i].len,
+					vals[end].data, vals[end].len) == 0) {
+			++end;
+		}
+
+		bucket->n_rows += end - i;
+		bucket->n_distinct++;
+
+		if (bucket->n_rows >= rows_per_bucket || end == vals.size()) {
+			bucket->endpoint = vals[i].data;
+			bucket->endpoint_len = vals[i].len;
+			bucket->n_endpoint_rows = end - i;
+
+			++hist->n_buckets;
+			++bucket;
+
+			ut_ad(hist->n_buckets <= ut_min(n_distinct, n_buckets));
+		}
+
+		i = end;
+	}
+
+	/* The endpoints point to the sampled values, copy them to the
+	heap of the histogram. */
+	for (ulint i = 0; i < hist->n_buckets; i++) {
+		hist->buckets[i].endpoint = static_cast<const byte*>(
+			mem_heap_dup(heap, hist->buckets[i].endpoint,
+				     hist->buckets[i].endpoint_len));
+	}
+}
+
+/*********************************************************************//**
+Samples the values of the columns of a table from the leaf pages of its
+clustered index and builds a histogram for each column, replacing the old
+histograms. Columns that can be stored externally or that are longer than
+HIST_MAX_COL_LEN do not get a histogram. The leaf pages are sampled the
+same way as the leaf pages of the index statistics: all of them if there
+are no more than N_SAMPLE_PAGES(index), otherwise as many pages reached
+by random dives.
+The caller must own the table's stats latch in X mode. */
+static
+void
+dict_stats_analyze_columns(
+/*=======================*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	const ulint	n_buckets = srv_stats_histogram_buckets;
+
+	dict_stats_hist_free(table);
+
+	if (n_buckets == 0 || (table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
+		return;
+	}
+
+	dict_index_t*		index = dict_table_get_first_index(table);
+	std::vector<ulint>	cols;
+
+	for (ulint i = 0; i < dict_table_get_n_user_cols(table); i++) {
+		const dict_col_t*	col = dict_table_get_nth_col(table, i);
+
+		if (!DATA_LARGE_MTYPE(col->mtype)
+		    && dict_col_get_max_size(col) <= HIST_MAX_COL_LEN) {
+
+			cols.push_back(i);
+		}
+	}
+
+	if (cols.empty()) {
+		return;
+	}
+
+	std::vector<hist_vals_t>	vals(cols.size());
+	ib_uint64_t			n_sampled = 0;
+	mem_heap_t*			heap = mem_heap_create(16384);
+	const ulint			n_sample_pages = static_cast<ulint>(
+		N_SAMPLE_PAGES(index));
+	btr_pcur_t			pcur;
+	mtr_t				mtr;
+
+	if (index->stat_n_leaf_pages <= n_sample_pages) {
+
+		mtr_start(&mtr);
+
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+
+		for (ulint i = 0; i < n_sample_pages; i++) {
+			const page_t*	page = btr_pcur_get_page(&pcur);
+
+			dict_stats_sample_page(page, index, cols, vals,
+					       &n_sampled, heap);
+
+			if (btr_page_get_next(page, &mtr) == FIL_NULL) {
+				break;
+			}
+
+			btr_pcur_move_to_last_on_page(&pcur, &mtr);
+			btr_pcur_move_to_next_page(&pcur, &mtr);
+		}
+
+		btr_pcur_close(&pcur);
+		mtr_commit(&mtr);
+	} else {
+		for (ulint i = 0;
+		     i < n_sample_pages
+		     && !(table->stats_bg_flag & BG_STAT_SHOULD_QUIT);
+		     i++) {
+
+			mtr_start(&mtr);
+
+			btr_pcur_open_at_rnd_pos(
+				index, BTR_SEARCH_LEAF, &pcur, &mtr);
+
+			dict_stats_sample_page(btr_pcur_get_page(&pcur),
+					       index, cols, vals,
+					       &n_sampled, heap);
+
+			btr_pcur_close(&pcur);
+			mtr_commit(&mtr);
+		}
+	}
+
+	if (n_sampled > 0) {
+		mem_heap_t*	hist_heap = mem_heap_create(1024);
+
+		table->stat_hist = static_cast<dict_col_hist_t*>(
+			mem_heap_alloc(hist_heap,
+				       cols.size() * sizeof(*table->stat_hist)));
+
+		for (ulint i = 0; i < cols.size(); i++) {
+			const dict_col_t*	col;
+			dict_col_hist_t*	hist;
+
+			if (vals[i].empty()) {
+				continue;
+			}
+
+			col = dict_table_get_nth_col(table, cols[i]);
+
+			std::sort(vals[i].begin(), vals[i].end(),
+				  hist_val_less(col));
+
+			hist = &table->stat_hist[table->stat_n_hist++];
+
+			hist->col_name = mem_heap_strdup(
+				hist_heap, dict_table_get_col_name(
+					table, cols[i]));
+			hist->col_no = cols[i];
+			hist->sample_size = n_sampled;
+
+			dict_stats_build_hist(hist, col, vals[i], n_buckets,
+					      hist_heap);
+		}
+
+		table->stat_hist_heap = hist_heap;
+	}
+
+	mem_heap_free(heap);
+}
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
@@ -2072,6 +2570,8 @@ dict_stats_update_persistent(
 			+= index->stat_index_size;
 	}
 
+	dict_stats_analyze_columns(table);
+
 	table->stats_last_recalc = ut_time();
 
 	table->stat_modified_counter = 0;
@@ -2212,31 +2712,168 @@ dict_stats_save_index_stat(
 }
 
 /*********************************************************************//**
-Save the table's statistics into the persistent statistics storage.
+Executes
+DELETE FROM mysql.innodb_column_stats
+WHERE database_name = '...' AND table_name = '...';
+Creates its own transaction and commits it.
 @return DB_SUCCESS or error code */
-static
+UNIV_INLINE
 dberr_t
-dict_stats_save(
-/*============*/
-	dict_table_t*	table_orig)	/*!< in: table */
+dict_stats_delete_from_column_stats(
+/*================================*/
+	const char*	database_name,	/*!< in: database name, e.g. 'db' */
+	const char*	table_name)	/*!< in: table name, e.g. 'table' */
 {
 	pars_info_t*	pinfo;
-	lint		now;
 	dberr_t		ret;
-	dict_table_t*	table;
-	char		db_utf8[MAX_DB_UTF8_LEN];
-	char		table_utf8[MAX_TABLE_UTF8_LEN];
 
-	table = dict_stats_snapshot_create(table_orig);
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&dict_operation_lock, RW_LOCK_X));
+#endif /* UNIV_SYNC_DEBUG */
+	ut_ad(mutex_own(&dict_sys->mutex));
 
-	dict_fs2utf8(table->name, db_utf8, sizeof(db_utf8),
-		     table_utf8, sizeof(table_utf8));
+	pinfo = pars_info_create();
 
-	rw_lock_x_lock(&dict_operation_lock);
-	mutex_enter(&dict_sys->mutex);
+	pars_info_add_str_literal(pinfo, "database_name", database_name);
+	pars_info_add_str_literal(pinfo, "table_name", table_name);
 
-	/* MySQL's timestamp is 4 byte, so we use
-	pars_info_add_int4_literal() which takes a lint arg, so "now" is
+	ret = dict_stats_exec_sql(
+		pinfo,
+		"PROCEDURE DELETE_FROM_COLUMN_STATS () IS\n"
+		"BEGIN\n"
+		"DELETE FROM \"" COLUMN_STATS_NAME "\" WHERE\n"
+		"database_name = :database_name AND\n"
+		"table_name = :table_name;\n"
+		"END;\n");
+
+	return(ret);
+}
+
+/*********************************************************************//**
+Save the column histograms of a table into mysql.innodb_column_stats,
+replacing the histograms that were saved before. Nothing is done if
+that table does not exist.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+dict_stats_save_hists(
+/*==================*/
+	const dict_table_t*	table,		/*!< in: table */
+	const char*		db_utf8,	/*!< in: database name */
+	const char*		table_utf8,	/*!< in: table name */
+	lint			last_update)	/*!< in: timestamp of the
+						stats */
+{
+	dberr_t	ret;
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&dict_operation_lock, RW_LOCK_X));
+#endif /* UNIV_SYNC_DEBUG */
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	if (!dict_stats_column_stats_check(true)) {
+		return(DB_SUCCESS);
+	}
+
+	ret = dict_stats_delete_from_column_stats(db_utf8, table_utf8);
+
+	for (ulint i = 0; i < table->stat_n_hist && ret == DB_SUCCESS; i++) {
+		const dict_col_hist_t*	hist = &table->stat_hist[i];
+
+		for (ulint j = 0; j < hist->n_buckets; j++) {
+			const dict_col_hist_bucket_t*	bucket
+				= &hist->buckets[j];
+			pars_info_t*			pinfo;
+
+			pinfo = pars_info_create();
+
+			pars_info_add_str_literal(pinfo, "database_name",
+						  db_utf8);
+			pars_info_add_str_literal(pinfo, "table_name",
+						  table_utf8);
+			pars_info_add_str_literal(pinfo, "column_name",
+						  hist->col_name);
+			pars_info_add_ull_literal(pinfo, "bucket_no", j);
+			pars_info_add_int4_literal(pinfo, "last_update",
+						   last_update);
+			pars_info_add_literal(pinfo, "endpoint",
+					      bucket->endpoint,
+					      bucket->endpoint_len,
+					      DATA_BINARY, DATA_BINARY_TYPE);
+			pars_info_add_ull_literal(pinfo, "n_rows",
+						  bucket->n_rows);
+			pars_info_add_ull_literal(pinfo, "n_endpoint_rows",
+						  bucket->n_endpoint_rows);
+			pars_info_add_ull_literal(pinfo, "n_distinct",
+						  bucket->n_distinct);
+			pars_info_add_ull_literal(pinfo, "sample_size",
+						  hist->sample_size);
+
+			ret = dict_stats_exec_sql(
+				pinfo,
+				"PROCEDURE COLUMN_STATS_SAVE () IS\n"
+				"BEGIN\n"
+				"INSERT INTO \"" COLUMN_STATS_NAME "\"\n"
+				"VALUES\n"
+				"(\n"
+				":database_name,\n"
+				":table_name,\n"
+				":column_name,\n"
+				":bucket_no,\n"
+				":last_update,\n"
+				":endpoint,\n"
+				":n_rows,\n"
+				":n_endpoint_rows,\n"
+				":n_distinct,\n"
+				":sample_size\n"
+				");\n"
+				"END;");
+
+			if (ret != DB_SUCCESS) {
+				break;
+			}
+		}
+	}
+
+	if (ret != DB_SUCCESS) {
+		char	buf[MAX_FULL_NAME_LEN];
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			" InnoDB: Cannot save column histograms for table "
+			"%s: %s\n",
+			ut_format_name(table->name, TRUE, buf, sizeof(buf)),
+			ut_strerr(ret));
+	}
+
+	return(ret);
+}
+
+/*********************************************************************//**
+Save the table's statistics into the persistent statistics storage.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+dict_stats_save(
+/*============*/
+	dict_table_t*	table_orig)	/*!< in: table */
+{
+	pars_info_t*	pinfo;
+	lint		now;
+	dberr_t		ret;
+	dict_table_t*	table;
+	char		db_utf8[MAX_DB_UTF8_LEN];
+	char		table_utf8[MAX_TABLE_UTF8_LEN];
+
+	table = dict_stats_snapshot_create(table_orig);
+
+	dict_fs2utf8(table->name, db_utf8, sizeof(db_utf8),
+		     table_utf8, sizeof(table_utf8));
+
+	rw_lock_x_lock(&dict_operation_lock);
+	mutex_enter(&dict_sys->mutex);
+
+	/* MySQL's timestamp is 4 byte, so we use
+	pars_info_add_int4_literal() which takes a lint arg, so "now" is
 	lint */
 	now = (lint) ut_time();
 
@@ -2369,6 +3006,8 @@ dict_stats_save(
 		}
 	}
 
+	ret = dict_stats_save_hists(table, db_utf8, table_utf8, now);
+
 end:
 	mutex_exit(&dict_sys->mutex);
 	rw_lock_x_unlock(&dict_operation_lock);
@@ -2725,6 +3364,246 @@ dict_stats_fetch_index_stats_step(
 	return(TRUE);
 }
 
+/** A bucket fetched from mysql.innodb_column_stats */
+struct hist_fetch_row_t {
+	const char*		col_name;	/*!< column name */
+	ib_uint64_t		sample_size;	/*!< sampled rows */
+	dict_col_hist_bucket_t	bucket;		/*!< the bucket */
+};
+
+/** Aux struct used to collect the buckets fetched by
+dict_stats_fetch_column_stats_step(). */
+struct hist_fetch_t {
+	mem_heap_t*			heap;	/*!< heap for the rows */
+	std::vector<hist_fetch_row_t>	rows;	/*!< the fetched rows, in the
+						order of the primary key */
+};
+
+/*********************************************************************//**
+Called for the rows that are selected by
+SELECT ... FROM mysql.innodb_column_stats WHERE table='...'
+The second argument is a hist_fetch_t where the rows are collected.
+@return non-NULL dummy */
+static
+ibool
+dict_stats_fetch_column_stats_step(
+/*===============================*/
+	void*	node_void,	/*!< in: select node */
+	void*	arg_void)	/*!< out: the fetched rows */
+{
+	sel_node_t*		node = (sel_node_t*) node_void;
+	hist_fetch_t*		arg = (hist_fetch_t*) arg_void;
+	que_common_t*		cnode;
+	hist_fetch_row_t	row;
+	int			i;
+
+	/* this should loop exactly 6 times - for
+	column_name,endpoint,n_rows,n_endpoint_rows,n_distinct,sample_size */
+	for (cnode = static_cast<que_common_t*>(node->select_list), i = 0;
+	     cnode != NULL;
+	     cnode = static_cast<que_common_t*>(que_node_get_next(cnode)),
+	     i++) {
+
+		const byte*	data;
+		dfield_t*	dfield = que_node_get_val(cnode);
+		dtype_t*	type = dfield_get_type(dfield);
+		ulint		len = dfield_get_len(dfield);
+
+		data = static_cast<const byte*>(dfield_get_data(dfield));
+
+		switch (i) {
+		case 0: /* mysql.innodb_column_stats.column_name */
+
+			ut_a(dtype_get_mtype(type) == DATA_VARMYSQL);
+
+			row.col_name = mem_heap_strdupl(
+				arg->heap, (const char*) data, len);
+
+			break;
+
+		case 1: /* mysql.innodb_column_stats.endpoint */
+
+			ut_a(dtype_get_mtype(type) == DATA_BINARY);
+			ut_a(len != UNIV_SQL_NULL);
+
+			row.bucket.endpoint = static_cast<const byte*>(
+				mem_heap_dup(arg->heap, data, len));
+			row.bucket.endpoint_len = len;
+
+			break;
+
+		case 2: /* mysql.innodb_column_stats.n_rows */
+		case 3: /* mysql.innodb_column_stats.n_endpoint_rows */
+		case 4: /* mysql.innodb_column_stats.n_distinct */
+		case 5: /* mysql.innodb_column_stats.sample_size */
+
+			ut_a(dtype_get_mtype(type) == DATA_INT);
+			ut_a(len == 8);
+
+			switch (i) {
+			case 2:
+				row.bucket.n_rows = mach_read_from_8(data);
+				break;
+			case 3:
+				row.bucket.n_endpoint_rows
+					= mach_read_from_8(data);
+				break;
+			case 4:
+				row.bucket.n_distinct = mach_read_from_8(data);
+				break;
+			default:
+				row.sample_size = mach_read_from_8(data);
+			}
+
+			break;
+
+		default:
+
+			/* someone changed the SELECT to select more
+			columns from innodb_column_stats without adjusting
+			here */
+			ut_error;
+		}
+	}
+
+	/* if i < 6 this means someone changed the SELECT to select less
+	columns from innodb_column_stats without adjusting here;
+	if i > 6 we would have ut_error'ed earlier */
+	ut_a(i == 6);
+
+	arg->rows.push_back(row);
+
+	/* XXX this is not used but returning non-NULL is necessary */
+	return(TRUE);
+}
+
+/*********************************************************************//**
+Read the column histograms of a table from mysql.innodb_column_stats.
+The histograms are stored in the table with undefined column numbers,
+see dict_stats_hist_resolve(). */
+static
+void
+dict_stats_fetch_hists(
+/*===================*/
+	dict_table_t*	table,		/*!< in/out: table */
+	const char*	db_utf8,	/*!< in: database name */
+	const char*	table_utf8,	/*!< in: table name */
+	trx_t*		trx)		/*!< in/out: transaction */
+{
+	hist_fetch_t	fetch_arg;
+	pars_info_t*	pinfo;
+	dberr_t		ret;
+
+	fetch_arg.heap = mem_heap_create(1024);
+
+	pinfo = pars_info_create();
+
+	pars_info_add_str_literal(pinfo, "database_name", db_utf8);
+
+	pars_info_add_str_literal(pinfo, "table_name", table_utf8);
+
+	pars_info_bind_function(pinfo,
+				"fetch_column_stats_step",
+				dict_stats_fetch_column_stats_step,
+				&fetch_arg);
+
+	/* The cursor returns the rows in the order of the primary key,
+	that is, the buckets of each column in ascending order. */
+	ret = que_eval_sql(pinfo,
+			   "PROCEDURE FETCH_COLUMN_STATS () IS\n"
+			   "found INT;\n"
+			   "DECLARE FUNCTION fetch_column_stats_step;\n"
+			   "DECLARE CURSOR column_stats_cur IS\n"
+			   "  SELECT\n"
+			   /* if you change the selected fields, be
+			   sure to adjust
+			   dict_stats_fetch_column_stats_step() */
+			   "  column_name,\n"
+			   "  endpoint,\n"
+			   "  n_rows,\n"
+			   "  n_endpoint_rows,\n"
+			   "  n_distinct,\n"
+			   "  sample_size\n"
+			   "  FROM \"" COLUMN_STATS_NAME "\"\n"
+			   "  WHERE\n"
+			   "  database_name = :database_name AND\n"
+			   "  table_name = :table_name;\n"
+
+			   "BEGIN\n"
+
+			   "OPEN column_stats_cur;\n"
+			   "found := 1;\n"
+			   "WHILE found = 1 LOOP\n"
+			   "  FETCH column_stats_cur INTO\n"
+			   "    fetch_column_stats_step();\n"
+			   "  IF (SQL % NOTFOUND) THEN\n"
+			   "    found := 0;\n"
+			   "  END IF;\n"
+			   "END LOOP;\n"
+			   "CLOSE column_stats_cur;\n"
+
+			   "END;",
+			   TRUE, trx);
+	/* pinfo is freed by que_eval_sql() */
+
+	const std::vector<hist_fetch_row_t>&	rows = fetch_arg.rows;
+
+	if (ret == DB_SUCCESS && !rows.empty()) {
+		ulint	n_hist = 1;
+
+		for (ulint i = 1; i < rows.size(); i++) {
+			if (strcmp(rows[i - 1].col_name,
+				   rows[i].col_name) != 0) {
+				++n_hist;
+			}
+		}
+
+		dict_stats_hist_free(table);
+
+		table->stat_hist_heap = fetch_arg.heap;
+		fetch_arg.heap = NULL;
+
+		table->stat_hist = static_cast<dict_col_hist_t*>(
+			mem_heap_alloc(table->stat_hist_heap,
+				       n_hist * sizeof(*table->stat_hist)));
+
+		for (ulint i = 0; i < rows.size(); ) {
+			ulint		end = i + 1;
+			dict_col_hist_t*	hist;
+
+			while (end < rows.size()
+			       && strcmp(rows[i].col_name,
+					 rows[end].col_name) == 0) {
+				++end;
+			}
+
+			hist = &table->stat_hist[table->stat_n_hist++];
+
+			hist->col_name = rows[i].col_name;
+			hist->col_no = ULINT_UNDEFINED;
+			hist->sample_size = rows[i].sample_size;
+			hist->n_buckets = end - i;
+			hist->buckets = static_cast<dict_col_hist_bucket_t*>(
+				mem_heap_alloc(
+					table->stat_hist_heap,
+					hist->n_buckets
+					* sizeof(*hist->buckets)));
+
+			for (ulint j = i; j < end; j++) {
+				hist->buckets[j - i] = rows[j].bucket;
+			}
+
+			i = end;
+		}
+
+		ut_ad(table->stat_n_hist == n_hist);
+	}
+
+	if (fetch_arg.heap != NULL) {
+		mem_heap_free(fetch_arg.heap);
+	}
+}
+
 /*********************************************************************//**
 Read table's statistics from the persistent statistics storage.
 @return DB_SUCCESS or error code */
@@ -2743,6 +3622,8 @@ dict_stats_fetch_from_ps(
 
 	ut_ad(!mutex_own(&dict_sys->mutex));
 
+	const bool	fetch_hists = dict_stats_column_stats_check(false);
+
 	/* Initialize all stats to dummy values before fetching because if
 	the persistent storage contains incomplete stats (e.g. missing stats
 	for some index) then we would end up with (partially) uninitialized
@@ -2841,6 +3722,13 @@ dict_stats_fetch_from_ps(
 			   TRUE, trx);
 	/* pinfo is freed by que_eval_sql() */
 
+	if (ret == DB_SUCCESS
+	    && index_fetch_arg.stats_were_modified
+	    && fetch_hists) {
+
+		dict_stats_fetch_hists(table, db_utf8, table_utf8, trx);
+	}
+
 	trx_commit_for_mysql(trx);
 
 	trx_free_for_background(trx);
@@ -3062,6 +3950,8 @@ dict_stats_update(
 
 			dict_stats_copy(table, t);
 
+			dict_stats_hist_resolve(table);
+
 			dict_stats_assert_initialized(table);
 
 			dict_table_stats_unlock(table, RW_X_LATCH);
@@ -3126,6 +4016,8 @@ transient:
 
 	dict_stats_update_transient(table);
 
+	dict_stats_hist_free(table);
+
 	dict_table_stats_unlock(table, RW_X_LATCH);
 
 	return(DB_SUCCESS);
@@ -3329,9 +4221,11 @@ dict_stats_drop_table(
 		return(DB_SUCCESS);
 	}
 
-	/* skip innodb_table_stats and innodb_index_stats themselves */
+	/* skip innodb_table_stats, innodb_index_stats and
+	innodb_column_stats themselves */
 	if (strcmp(db_and_table, TABLE_STATS_NAME) == 0
-	    || strcmp(db_and_table, INDEX_STATS_NAME) == 0) {
+	    || strcmp(db_and_table, INDEX_STATS_NAME) == 0
+	    || strcmp(db_and_table, COLUMN_STATS_NAME) == 0) {
 
 		return(DB_SUCCESS);
 	}
@@ -3345,6 +4239,10 @@ dict_stats_drop_table(
 		ret = dict_stats_delete_from_index_stats(db_utf8, table_utf8);
 	}
 
+	if (ret == DB_SUCCESS && dict_stats_column_stats_check(true)) {
+		ret = dict_stats_delete_from_column_stats(db_utf8, table_utf8);
+	}
+
 	if (ret == DB_STATS_DO_NOT_EXIST) {
 		ret = DB_SUCCESS;
 	}
@@ -3468,6 +4366,52 @@ dict_stats_rename_table_in_index_stats(
 	return(ret);
 }
 
+/*********************************************************************//**
+Executes
+UPDATE mysql.innodb_column_stats SET
+database_name = '...', table_name = '...'
+WHERE database_name = '...' AND table_name = '...';
+Creates its own transaction and commits it.
+@return DB_SUCCESS or error code */
+UNIV_INLINE
+dberr_t
+dict_stats_rename_table_in_column_stats(
+/*====================================*/
+	const char*	old_dbname_utf8,/*!< in: database name, e.g. 'olddb' */
+	const char*	old_tablename_utf8,/*!< in: table name, e.g. 'oldtable' */
+	const char*	new_dbname_utf8,/*!< in: database name, e.g. 'newdb' */
+	const char*	new_tablename_utf8)/*!< in: table name, e.g. 'newtable' */
+{
+	pars_info_t*	pinfo;
+	dberr_t		ret;
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&dict_operation_lock, RW_LOCK_X));
+#endif /* UNIV_SYNC_DEBUG */
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	pinfo = pars_info_create();
+
+	pars_info_add_str_literal(pinfo, "old_dbname_utf8", old_dbname_utf8);
+	pars_info_add_str_literal(pinfo, "old_tablename_utf8", old_tablename_utf8);
+	pars_info_add_str_literal(pinfo, "new_dbname_utf8", new_dbname_utf8);
+	pars_info_add_str_literal(pinfo, "new_tablename_utf8", new_tablename_utf8);
+
+	ret = dict_stats_exec_sql(
+		pinfo,
+		"PROCEDURE RENAME_TABLE_IN_COLUMN_STATS () IS\n"
+		"BEGIN\n"
+		"UPDATE \"" COLUMN_STATS_NAME "\" SET\n"
+		"database_name = :new_dbname_utf8,\n"
+		"table_name = :new_tablename_utf8\n"
+		"WHERE\n"
+		"database_name = :old_dbname_utf8 AND\n"
+		"table_name = :old_tablename_utf8;\n"
+		"END;\n");
+
+	return(ret);
+}
+
 /*********************************************************************//**
 Renames a table in InnoDB persistent stats storage.
 This function creates its own transaction and commits it.
@@ -3493,11 +4437,14 @@ dict_stats_rename_table(
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(!mutex_own(&dict_sys->mutex));
 
-	/* skip innodb_table_stats and innodb_index_stats themselves */
+	/* skip innodb_table_stats, innodb_index_stats and
+	innodb_column_stats themselves */
 	if (strcmp(old_name, TABLE_STATS_NAME) == 0
 	    || strcmp(old_name, INDEX_STATS_NAME) == 0
+	    || strcmp(old_name, COLUMN_STATS_NAME) == 0
 	    || strcmp(new_name, TABLE_STATS_NAME) == 0
-	    || strcmp(new_name, INDEX_STATS_NAME) == 0) {
+	    || strcmp(new_name, INDEX_STATS_NAME) == 0
+	    || strcmp(new_name, COLUMN_STATS_NAME) == 0) {
 
 		return(DB_SUCCESS);
 	}
@@ -3596,6 +4543,64 @@ dict_stats_rename_table(
 		  || ret == DB_LOCK_WAIT_TIMEOUT)
 		 && n_attempts < 5);
 
+	if (ret != DB_SUCCESS) {
+		ut_snprintf(errstr, errstr_sz,
+			    "Unable to rename statistics from "
+			    "%s.%s to %s.%s in %s: %s. "
+			    "They can be renamed later using "
+
+			    "UPDATE %s SET "
+			    "database_name = '%s', "
+			    "table_name = '%s' "
+			    "WHERE "
+			    "database_name = '%s' AND "
+			    "table_name = '%s';",
+
+			    old_db_utf8, old_table_utf8,
+			    new_db_utf8, new_table_utf8,
+			    INDEX_STATS_NAME_PRINT,
+			    ut_strerr(ret),
+
+			    INDEX_STATS_NAME_PRINT,
+			    new_db_utf8, new_table_utf8,
+			    old_db_utf8, old_table_utf8);
+		mutex_exit(&dict_sys->mutex);
+		rw_lock_x_unlock(&dict_operation_lock);
+		return(ret);
+	}
+	/* else */
+
+	n_attempts = 0;
+	while (dict_stats_column_stats_check(true)) {
+		n_attempts++;
+
+		ret = dict_stats_rename_table_in_column_stats(
+			old_db_utf8, old_table_utf8,
+			new_db_utf8, new_table_utf8);
+
+		if (ret == DB_DUPLICATE_KEY) {
+			dict_stats_delete_from_column_stats(
+				new_db_utf8, new_table_utf8);
+		}
+
+		if (ret == DB_STATS_DO_NOT_EXIST) {
+			ret = DB_SUCCESS;
+		}
+
+		if ((ret != DB_DEADLOCK
+		     && ret != DB_DUPLICATE_KEY
+		     && ret != DB_LOCK_WAIT_TIMEOUT)
+		    || n_attempts >= 5) {
+			break;
+		}
+
+		mutex_exit(&dict_sys->mutex);
+		rw_lock_x_unlock(&dict_operation_lock);
+		os_thread_sleep(200000 /* 0.2 sec */);
+		rw_lock_x_lock(&dict_operation_lock);
+		mutex_enter(&dict_sys->mutex);
+	}
+
 	mutex_exit(&dict_sys->mutex);
 	rw_lock_x_unlock(&dict_operation_lock);
 
@@ -3614,10 +4619,10 @@ dict_stats_rename_table(
 
 			    old_db_utf8, old_table_utf8,
 			    new_db_utf8, new_table_utf8,
-			    INDEX_STATS_NAME_PRINT,
+			    COLUMN_STATS_NAME_PRINT,
 			    ut_strerr(ret),
 
-			    INDEX_STATS_NAME_PRINT,
+			    COLUMN_STATS_NAME_PRINT,
 			    new_db_utf8, new_table_utf8,
 			    old_db_utf8, old_table_utf8);
 	}
@@ -3683,6 +4688,86 @@ dict_stats_rename_index(
 	return(ret);
 }
 
+/*********************************************************************//**
+Estimates the fraction of the rows of a table whose column is equal to a
+given value, from the histogram of the column in the persistent statistics.
+@return estimated selectivity in (0, 1], or a negative value if the column
+has no histogram */
+
+double
+dict_stats_col_eq_selectivity(
+/*==========================*/
+	const dict_table_t*	table,	/*!< in: table */
+	ulint			col_no,	/*!< in: column number */
+	const byte*		data,	/*!< in: value in the InnoDB format */
+	ulint			len)	/*!< in: length of data */
+{
+	const dict_col_t*	col = dict_table_get_nth_col(table, col_no);
+	double			sel = -1.0;
+
+	dict_table_stats_lock(table, RW_S_LATCH);
+
+	for (ulint i = 0; i < table->stat_n_hist; i++) {
+		const dict_col_hist_t*	hist = &table->stat_hist[i];
+
+		if (hist->col_no != col_no
+		    || hist->n_buckets == 0
+		    || hist->sample_size == 0) {
+			continue;
+		}
+
+		/* Find the first bucket whose endpoint is not less
+		than the value. */
+		ulint	low = 0;
+		ulint	high = hist->n_buckets;
+
+		while (low < high) {
+			ulint	mid = (low + high) / 2;
+
+			if (cmp_data_data(col->mtype, col->prtype,
+					  hist->buckets[mid].endpoint,
+					  hist->buckets[mid].endpoint_len,
+					  data, len) < 0) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+
+		/* A value that was not seen in the sample is assumed
+		to be as frequent as a single sampled row. */
+		double	n_rows = 1.0;
+
+		if (low < hist->n_buckets) {
+			const dict_col_hist_bucket_t*	b
+				= &hist->buckets[low];
+
+			if (cmp_data_data(col->mtype, col->prtype,
+					  b->endpoint, b->endpoint_len,
+					  data, len) == 0) {
+				n_rows = static_cast<double>(
+					b->n_endpoint_rows);
+			} else if (b->n_distinct > 1) {
+				n_rows = static_cast<double>(
+					b->n_rows - b->n_endpoint_rows)
+					/ (b->n_distinct - 1);
+			}
+		}
+
+		sel = n_rows / hist->sample_size;
+
+		if (sel > 1.0) {
+			sel = 1.0;
+		}
+
+		break;
+	}
+
+	dict_table_stats_unlock(table, RW_S_LATCH);
+
+	return(sel);
+}
+
 /* tests @{ */
 #ifdef UNIV_COMPILE_TEST_FUNCS
 
@@ -3860,6 +4945,9 @@ test_dict_stats_save()
 	table.stat_n_rows = TEST_N_ROWS;
 	table.stat_clustered_index_size = TEST_CLUSTERED_INDEX_SIZE;
 	table.stat_sum_of_other_index_sizes = TEST_SUM_OF_OTHER_INDEX_SIZES;
+	table.stat_hist_heap = NULL;
+	table.stat_n_hist = 0;
+	table.stat_hist = NULL;
 	UT_LIST_INIT(table.indexes);
 	UT_LIST_ADD_LAST(indexes, table.indexes, &index1);
 	UT_LIST_ADD_LAST(indexes, table.indexes, &index2);
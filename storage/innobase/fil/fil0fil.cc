@@ -57,6 +57,8 @@ static ulint srv_data_read, srv_data_written;
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0space.h"
 #include <set>
+#include <string>
+#include <vector>
 
 /*
 		IMPLEMENTATION OF THE TABLESPACE MEMORY CACHE
@@ -3103,6 +3105,92 @@ fil_reinit_space_header(
 	mtr_commit(&mtr);
 }
 
+/**********************************************************************//**
+Truncate the data file of a tablespace that consists of a single file to
+the given size. The caller must have removed the pages of the tablespace
+from the buffer pool.
+@return true if success */
+
+bool
+fil_truncate_tablespace(
+/*====================*/
+	ulint		id,	/*!< in: space id */
+	ulint		size)	/*!< in: new size in pages */
+{
+	ut_a(!Tablespace::is_system_tablespace(id));
+
+	mutex_enter(&fil_system->mutex);
+
+	fil_space_t*	space = fil_space_get_by_id(id);
+
+	if (space == NULL) {
+		mutex_exit(&fil_system->mutex);
+		return(false);
+	}
+
+	/* The following code must change when InnoDB supports
+	multiple datafiles per tablespace. */
+	ut_a(UT_LIST_GET_LEN(space->chain) == 1);
+
+	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+
+	ut_a(node->n_pending == 0);
+
+	bool	opened;
+
+	if (!node->open) {
+
+		ibool	ret;
+
+		node->handle = os_file_create_simple_no_error_handling(
+			innodb_data_file_key, node->name, OS_FILE_OPEN,
+			OS_FILE_READ_WRITE, &ret);
+
+		if (!ret) {
+
+			ib_logf(IB_LOG_LEVEL_ERROR,
+				"Failed to open tablespace file %s.",
+				node->name);
+
+			mutex_exit(&fil_system->mutex);
+
+			return(false);
+		}
+
+		node->open = TRUE;
+		opened = true;
+	} else {
+		opened = false;
+	}
+
+	bool	success = os_file_truncate(
+		node->name, node->handle, (os_offset_t) size * UNIV_PAGE_SIZE);
+
+	if (success) {
+		space->size = node->size = size;
+	} else {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Cannot truncate file %s to %lu pages.",
+			node->name, (ulong) size);
+	}
+
+	if (opened) {
+		if (os_file_close(node->handle)) {
+			node->open = FALSE;
+		} else {
+			ib_logf(IB_LOG_LEVEL_ERROR,
+				"Failed to close tablespace file %s.",
+				node->name);
+
+			success = false;
+		}
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	return(success);
+}
+
 /*******************************************************************//**
 Returns TRUE if a single-table tablespace is being deleted.
 @return TRUE if being deleted */
@@ -4672,6 +4760,95 @@ func_exit_after_close:
 	mem_free(def.filepath);
 }
 
+#ifndef UNIV_HOTBACKUP
+# ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	fil_load_thread_key;
+# endif /* UNIV_PFS_THREAD */
+#endif /* !UNIV_HOTBACKUP */
+
+/** Minimum number of tablespace files for each fil_load thread; fewer
+files are opened by fewer threads, as starting a thread would cost more
+than it saves. */
+#define FIL_LOAD_MIN_FILES_PER_THREAD	32
+
+/** A single-table tablespace file found in a database directory. */
+struct fil_load_file_t {
+	std::string	dbname;		/*!< database directory name */
+	std::string	filename;	/*!< name of the .ibd or .isl file */
+};
+
+/** The single-table tablespace files found by
+fil_load_single_table_tablespaces(), and the threads which open them. */
+struct fil_load_t {
+	std::vector<fil_load_file_t>
+			files;		/*!< the files, one per table */
+	ulint		next;		/*!< index of the next file to open,
+					protected by fil_system->mutex */
+	ulint		n_threads_active;/*!< number of fil_load threads
+					which have not finished, protected
+					by fil_system->mutex */
+};
+
+/********************************************************************//**
+Opens the tablespace files of fil_load_t::files which no other thread
+took yet, until there are none left. */
+static
+void
+fil_load_tablespace_files(
+/*======================*/
+	fil_load_t*	load)	/*!< in/out: the files to open */
+{
+	for (;;) {
+		ulint	i;
+
+		mutex_enter(&fil_system->mutex);
+		i = load->next;
+		if (i < load->files.size()) {
+			load->next++;
+		}
+		mutex_exit(&fil_system->mutex);
+
+		if (i >= load->files.size()) {
+			break;
+		}
+
+		fil_load_single_table_tablespace(
+			load->files[i].dbname.c_str(),
+			load->files[i].filename.c_str());
+	}
+}
+
+/********************************************************************//**
+A thread which reads the headers of single-table tablespace files at
+crash recovery, together with the thread which found the files.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(fil_load_thread)(
+/*============================*/
+	void*	arg)	/*!< in: the fil_load_t */
+{
+	fil_load_t*	load = static_cast<fil_load_t*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(fil_load_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	fil_load_tablespace_files(load);
+
+	mutex_enter(&fil_system->mutex);
+	ut_a(load->n_threads_active > 0);
+	load->n_threads_active--;
+	mutex_exit(&fil_system->mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /***********************************************************************//**
 A fault-tolerant function that tries to read the next file name in the
 directory. We retry 100 times if os_file_readdir_next_file() returns -1. The
@@ -4715,6 +4892,11 @@ single-table tablespaces. We need to know the space id in each of them so that
 we know into which file we should look to check the contents of a page stored
 in the doublewrite buffer, also to know where to apply log records where the
 space id is != 0.
+
+The directories are scanned first, and then the first page of each file is
+read by innodb_recovery_threads threads, the calling thread included.
+The files are only validated and registered in the tablespace memory cache;
+they are opened again on their first access, like any closed file.
 @return DB_SUCCESS or error number */
 
 dberr_t
@@ -4729,6 +4911,10 @@ fil_load_single_table_tablespaces(void)
 	os_file_stat_t	dbinfo;
 	os_file_stat_t	fileinfo;
 	dberr_t		err		= DB_SUCCESS;
+	fil_load_t	load;
+	std::set<std::string>	tablenames;
+	ulint		n_threads;
+	ib_time_t	start_time	= ut_time();
 
 	/* The datadir of MySQL is always the default directory of mysqld */
 
@@ -4798,10 +4984,25 @@ fil_load_single_table_tablespaces(void)
 					|| 0 == strcmp(fileinfo.name
 						   + strlen(fileinfo.name) - 4,
 						   ".isl"))) {
-					/* The name ends in .ibd or .isl;
-					try opening the file */
-					fil_load_single_table_tablespace(
-						dbinfo.name, fileinfo.name);
+					/* The name ends in .ibd or .isl.
+					A table may have both, and
+					fil_load_single_table_tablespace()
+					looks at both, so remember the
+					table only once. */
+					fil_load_file_t	file;
+					std::string	tablename(
+						fileinfo.name,
+						strlen(fileinfo.name) - 4);
+
+					tablename.insert(0, "/");
+					tablename.insert(0, dbinfo.name);
+
+					if (tablenames.insert(
+						    tablename).second) {
+						file.dbname = dbinfo.name;
+						file.filename = fileinfo.name;
+						load.files.push_back(file);
+					}
 				}
 next_file_item:
 				ret = fil_file_readdir_next_file(&err,
@@ -4834,6 +5035,54 @@ next_datadir_item:
 		return(DB_ERROR);
 	}
 
+	/* Read the headers of the files in parallel: with many tables,
+	the time is spent waiting for these reads. */
+
+#ifdef UNIV_HOTBACKUP
+	/* Hot backup renames files whose space id is already in the
+	cache, which needs the files to be looked at one by one. */
+	n_threads = 1;
+#else
+	n_threads = ut_min(ut_max(srv_n_recovery_threads, 1),
+			   load.files.size() / FIL_LOAD_MIN_FILES_PER_THREAD);
+	n_threads = ut_max(n_threads, 1);
+#endif /* UNIV_HOTBACKUP */
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Reading the headers of %lu single-table tablespace files"
+		" using %lu threads.",
+		(ulong) load.files.size(), (ulong) n_threads);
+
+	load.next = 0;
+	load.n_threads_active = n_threads - 1;
+
+	for (ulint i = 1; i < n_threads; i++) {
+		os_thread_create(fil_load_thread, &load, NULL);
+	}
+
+	fil_load_tablespace_files(&load);
+
+	/* Wait until the other threads have opened their last files */
+
+	mutex_enter(&fil_system->mutex);
+
+	while (load.n_threads_active != 0) {
+
+		mutex_exit(&fil_system->mutex);
+
+		os_thread_sleep(10000);
+
+		mutex_enter(&fil_system->mutex);
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Read the headers of %lu single-table tablespace files"
+		" in %lu seconds.",
+		(ulong) load.files.size(),
+		(ulong) (ut_time() - start_time));
+
 	return(err);
 }
 
@@ -5589,6 +5838,8 @@ fil_io(
 	ulint		wake_later;
 	os_offset_t	offset;
 	ibool		ignore_nonexistent_pages;
+	bool		page_compressed;
+	ulint		compression = 0;
 
 	is_log = type & OS_FILE_LOG;
 	type = type & ~OS_FILE_LOG;
@@ -5727,6 +5978,18 @@ fil_io(
 		ut_error;
 	}
 
+	/* Whole pages of page compressed tablespaces are compressed
+	when they are written, except the first page, which must be
+	readable when the tablespace is opened. */
+	page_compressed = !zip_size && !byte_offset && len == UNIV_PAGE_SIZE
+		&& space->purpose == FIL_TABLESPACE
+		&& FSP_FLAGS_HAS_PAGE_COMPRESSION(space->flags);
+
+	if (page_compressed && type == OS_FILE_WRITE && block_offset != 0) {
+		compression = OS_FILE_COMPRESSION(
+			FSP_FLAGS_GET_ZIP_ALGORITHM(space->flags));
+	}
+
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
@@ -5771,8 +6034,8 @@ fil_io(
 	}
 #else
 	/* Queue the aio request */
-	ret = os_aio(type, mode | wake_later, node->name, node->handle, buf,
-		     offset, len, node, message);
+	ret = os_aio(type | compression, mode | wake_later, node->name,
+		     node->handle, buf, offset, len, node, message);
 #endif /* UNIV_HOTBACKUP */
 	ut_a(ret);
 
@@ -5787,6 +6050,10 @@ fil_io(
 		mutex_exit(&fil_system->mutex);
 
 		ut_ad(fil_validate_skip());
+
+		if (page_compressed && type == OS_FILE_READ) {
+			os_file_decompress_page(static_cast<byte*>(buf));
+		}
 	}
 
 	return(DB_SUCCESS);
@@ -6242,6 +6509,7 @@ struct fil_iterator_t {
 	ulint		page_size;		/*!< Page size */
 	ulint		n_io_buffers;		/*!< Number of pages to use
 						for IO */
+	ulint		page_stride;		/*!< Visit every Nth page */
 	byte*		io_buffer;		/*!< Buffer to use for IO */
 };
 
@@ -6266,19 +6534,22 @@ fil_iterate(
 	PageCallback&		callback)
 {
 	os_offset_t		offset;
-	ulint			page_no = 0;
 	ulint			space_id = callback.get_space_id();
 	ulint			n_bytes = iter.n_io_buffers * iter.page_size;
 
 	ut_ad(!srv_read_only_mode);
+	ut_ad(iter.page_stride == 1 || iter.n_io_buffers == 1);
 
 	/* TODO: For compressed tables we do a lot of useless
 	copying for non-index pages. Unfortunately, it is
 	required by buf_zip_decompress() */
 
-	for (offset = iter.start; offset < iter.end; offset += n_bytes) {
+	for (offset = iter.start;
+	     offset < iter.end;
+	     offset += n_bytes * iter.page_stride) {
 
 		byte*		io_buffer = iter.io_buffer;
+		ulint		page_no = (ulint) (offset / iter.page_size);
 
 		block->frame = io_buffer;
 
@@ -6461,6 +6732,7 @@ fil_tablespace_iterate(
 		iter.file_size = file_size;
 		iter.n_io_buffers = n_io_buffers;
 		iter.page_size = callback.get_page_size();
+		iter.page_stride = callback.get_page_stride();
 
 		/* Compressed pages can't be optimised for block IO for now.
 		We do the IMPORT page by page. */
@@ -6470,6 +6742,12 @@ fil_tablespace_iterate(
 			ut_a(iter.page_size == callback.get_zip_size());
 		}
 
+		/* When pages are skipped, read them one at a time. */
+
+		if (iter.page_stride > 1) {
+			iter.n_io_buffers = 1;
+		}
+
 		/** Add an extra page for compressed page scratch area. */
 
 		void*	io_buffer = mem_alloc(
@@ -244,7 +244,9 @@ static
 dberr_t
 fts_sync(
 /*=====*/
-	fts_sync_t*	sync)		/*!< in: sync state */
+	fts_sync_t*	sync,		/*!< in: sync state */
+	bool		unlock_cache)	/*!< in: true=release the cache
+					lock while writing the nodes */
 	__attribute__((nonnull));
 
 /****************************************************************//**
@@ -677,6 +679,9 @@ fts_cache_create(
 		mem_heap_zalloc(heap, sizeof(fts_sync_t)));
 
 	cache->sync->table = table;
+	cache->sync->event = os_event_create(0);
+
+	cache->deleted_set = new fts_doc_id_set_t;
 
 	/* Create the index cache vector that will hold the inverted indexes. */
 	cache->indexes = ib_vector_create(
@@ -1232,6 +1237,8 @@ fts_cache_destroy(
 	mutex_free(&cache->optimize_lock);
 	mutex_free(&cache->deleted_lock);
 	mutex_free(&cache->doc_id_lock);
+	os_event_destroy(cache->sync->event);
+	delete cache->deleted_set;
 
 	if (cache->stopword_info.cached_stopword) {
 		rbt_free(cache->stopword_info.cached_stopword);
@@ -1325,6 +1332,7 @@ fts_cache_node_add_positions(
 	}
 #endif
 	ut_ad(doc_id >= node->last_doc_id);
+	ut_ad(!node->synced);
 
 	/* Calculate the space required to store the ilist. */
 	doc_id_delta = (ulint)(doc_id - node->last_doc_id);
@@ -1459,7 +1467,10 @@ fts_cache_add_doc(
 				ib_vector_last(word->nodes));
 		}
 
+		/* A node that a running SYNC has written is not
+		appended to, it is freed when the SYNC commits. */
 		if (fts_node == NULL
+		    || fts_node->synced
 		    || fts_node->ilist_size > FTS_ILIST_MAX_SIZE
 		    || doc_id < fts_node->last_doc_id) {
 
@@ -3015,6 +3026,10 @@ fts_delete(
 
 		++table->fts->cache->deleted;
 
+		/* Queries filter out the doc id from now on, slightly
+		before the transaction commits the DELETED row. */
+		table->fts->cache->deleted_set->insert(doc_id);
+
 		mutex_exit(&table->fts->cache->deleted_lock);
 	}
 
@@ -3542,6 +3557,8 @@ fts_add_doc_by_id(
 
 			if (doc.found) {
 				ibool	success __attribute__((unused));
+				bool	need_sync = false;
+				bool	bg_sync = false;
 
 				btr_pcur_store_position(doc_pcur, &mtr);
 				mtr_commit(&mtr);
@@ -3553,16 +3570,43 @@ fts_add_doc_by_id(
 					get_doc->index_cache,
 					doc_id, doc.tokens);
 
+				/* Leave the SYNC to the FTS optimize thread
+				so that this commit does not wait for it.
+				Only if the cache has grown to twice its
+				size meanwhile, or there is no optimize
+				thread, SYNC it here. */
+				if (cache->total_size
+				    > 2 * fts_max_cache_size) {
+					need_sync = true;
+				} else if ((cache->total_size
+					    > fts_max_cache_size
+					    || fts_need_sync)
+					   && !cache->sync->in_progress
+					   && !cache->sync->bg_requested) {
+					cache->sync->bg_requested = true;
+					bg_sync = true;
+				}
+
 				rw_lock_x_unlock(&table->fts->cache->lock);
 
 				DBUG_EXECUTE_IF(
 					"fts_instrument_sync",
-					fts_sync(cache->sync);
+					fts_sync(cache->sync, false);
 				);
 
-				if (cache->total_size > fts_max_cache_size
-				    || fts_need_sync) {
-					fts_sync(cache->sync);
+				if (bg_sync
+				    && !fts_optimize_request_sync_table(
+					    table)) {
+					rw_lock_x_lock(
+						&table->fts->cache->lock);
+					cache->sync->bg_requested = false;
+					rw_lock_x_unlock(
+						&table->fts->cache->lock);
+					need_sync = true;
+				}
+
+				if (need_sync) {
+					fts_sync(cache->sync, false);
 				}
 
 				mtr_start(&mtr);
@@ -3934,16 +3978,23 @@ fts_sync_add_deleted_cache(
 }
 
 /*********************************************************************//**
-Write the words and ilist to disk.
+Write the nodes of the words and ilist to disk that the SYNC has not
+written yet, and mark them as written. The cache is freed only when the
+SYNC commits, so that queries keep finding the words until then.
 @return DB_SUCCESS if all went well else error code */
 static __attribute__((nonnull, warn_unused_result))
 dberr_t
 fts_sync_write_words(
 /*=================*/
-	trx_t*		trx,			/*!< in: transaction */
+	fts_sync_t*	sync,			/*!< in: sync state */
 	fts_index_cache_t*
-			index_cache)		/*!< in: index cache */
+			index_cache,		/*!< in: index cache */
+	bool		unlock_cache)		/*!< in: true=release the
+						cache lock while writing
+						each node */
 {
+	trx_t*		trx = sync->trx;
+	fts_cache_t*	cache = sync->table->fts->cache;
 	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
 	ulint		n_words = 0;
@@ -3960,11 +4011,13 @@ fts_sync_write_words(
 
 	n_words = rbt_size(index_cache->words);
 
-	/* We iterate over the entire tree, even if there is an error,
-	since we want to free the memory used during caching. */
+	/* Words that are added while the cache lock is released are
+	inserted into the tree without moving the existing nodes, and
+	the words are only removed by fts_cache_clear(). Thus rbt_node
+	stays valid across the release of the cache lock. */
 	for (rbt_node = rbt_first(index_cache->words);
-	     rbt_node;
-	     rbt_node = rbt_first(index_cache->words)) {
+	     rbt_node && error == DB_SUCCESS;
+	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
 
 		ulint			i;
 		ulint			selected;
@@ -3997,25 +4050,37 @@ fts_sync_write_words(
 		}
 #endif /* FTS_DOC_STATS_DEBUG */
 
-		n_nodes += ib_vector_size(word->nodes);
-
-		/* We iterate over all the nodes even if there was an error,
-		this is to free the memory of the fts_node_t elements. */
-		for (i = 0; i < ib_vector_size(word->nodes); ++i) {
+		for (i = 0;
+		     i < ib_vector_size(word->nodes) && error == DB_SUCCESS;
+		     ++i) {
 
 			fts_node_t* fts_node = static_cast<fts_node_t*>(
 				ib_vector_get(word->nodes, i));
 
-			if (error == DB_SUCCESS) {
+			if (fts_node->synced) {
+				continue;
+			}
+
+			/* Nothing is added to a synced node, so a copy
+			of it can be written without the cache lock, even
+			if word->nodes is reallocated meanwhile. */
+			fts_node->synced = true;
 
-				error = fts_write_node(
-					trx,
-					&index_cache->ins_graph[selected],
-					&fts_table, &word->text, fts_node);
+			fts_node_t	node = *fts_node;
+
+			++n_nodes;
+
+			if (unlock_cache) {
+				rw_lock_x_unlock(&cache->lock);
 			}
 
-			ut_free(fts_node->ilist);
-			fts_node->ilist = NULL;
+			error = fts_write_node(
+				trx, &index_cache->ins_graph[selected],
+				&fts_table, &word->text, &node);
+
+			if (unlock_cache) {
+				rw_lock_x_lock(&cache->lock);
+			}
 		}
 
 		if (error != DB_SUCCESS && !print_error) {
@@ -4026,9 +4091,6 @@ fts_sync_write_words(
 
 			print_error = TRUE;
 		}
-
-		/* NOTE: We are responsible for free'ing the node */
-		ut_free(rbt_remove_node(index_cache->words, rbt_node));
 	}
 
 #ifdef FTS_DOC_STATS_DEBUG
@@ -4315,7 +4377,10 @@ dberr_t
 fts_sync_index(
 /*===========*/
 	fts_sync_t*		sync,		/*!< in: sync state */
-	fts_index_cache_t*	index_cache)	/*!< in: index cache */
+	fts_index_cache_t*	index_cache,	/*!< in: index cache */
+	bool			unlock_cache)	/*!< in: true=release the
+						cache lock while writing
+						the nodes */
 {
 	trx_t*		trx = sync->trx;
 	dberr_t		error = DB_SUCCESS;
@@ -4329,7 +4394,7 @@ fts_sync_index(
 
 	ut_ad(rbt_validate(index_cache->words));
 
-	error = fts_sync_write_words(trx, index_cache);
+	error = fts_sync_write_words(sync, index_cache, unlock_cache);
 
 #ifdef FTS_DOC_STATS_DEBUG
 	/* FTS_RESOLVE: the word counter info in auxiliary table "DOC_ID"
@@ -4378,10 +4443,13 @@ fts_sync_commit(
 
 	/* We need to do this within the deleted lock since fts_delete() can
 	attempt to add a deleted doc id to the cache deleted id array. Set
-	the shutdown flag to FALSE, signifying that we don't want to release
-	all resources. */
-	fts_cache_clear(cache, FALSE);
+	the free_words flag to TRUE, because the written words are kept in
+	the cache until now. */
+	fts_cache_clear(cache, TRUE);
 	fts_cache_init(cache);
+
+	sync->in_progress = false;
+	os_event_set(sync->event);
 	rw_lock_x_unlock(&cache->lock);
 
 	if (error == DB_SUCCESS) {
@@ -4422,6 +4490,38 @@ fts_sync_rollback(
 	trx_t*		trx = sync->trx;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
+	/* The writes of the nodes are rolled back, so the next SYNC has
+	to write them again. */
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+		const ib_rbt_node_t*	rbt_node;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		for (rbt_node = rbt_first(index_cache->words);
+		     rbt_node;
+		     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+
+			fts_tokenizer_word_t*	word;
+
+			word = rbt_value(fts_tokenizer_word_t, rbt_node);
+
+			for (ulint j = 0; j < ib_vector_size(word->nodes);
+			     ++j) {
+
+				fts_node_t*	fts_node;
+
+				fts_node = static_cast<fts_node_t*>(
+					ib_vector_get(word->nodes, j));
+
+				fts_node->synced = false;
+			}
+		}
+	}
+
+	sync->in_progress = false;
+	os_event_set(sync->event);
 	rw_lock_x_unlock(&cache->lock);
 
 	fts_sql_rollback(trx);
@@ -4430,32 +4530,59 @@ fts_sync_rollback(
 
 /****************************************************************//**
 Run SYNC on the table, i.e., write out data from the cache to the
-FTS auxiliary INDEX table and clear the cache at the end.
+FTS auxiliary INDEX table and clear the cache at the end. If unlock_cache
+is true, the cache lock is released while each node is written, so that
+documents can be added to the cache meanwhile; the caller must then prevent
+changes to the FTS indexes of the table, e.g., by holding
+dict_operation_lock. The nodes added meanwhile are written in a final pass
+that holds the cache lock.
 @return DB_SUCCESS if all OK */
 static
 dberr_t
 fts_sync(
 /*=====*/
-	fts_sync_t*	sync)		/*!< in: sync state */
+	fts_sync_t*	sync,		/*!< in: sync state */
+	bool		unlock_cache)	/*!< in: true=release the cache
+					lock while writing the nodes */
 {
-	ulint		i;
 	dberr_t		error = DB_SUCCESS;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
 	rw_lock_x_lock(&cache->lock);
 
+	/* Wait for a SYNC that released the cache lock to complete. */
+	while (sync->in_progress) {
+		ib_int64_t	sig_count = os_event_reset(sync->event);
+
+		rw_lock_x_unlock(&cache->lock);
+
+		os_event_wait_low(sync->event, sig_count);
+
+		rw_lock_x_lock(&cache->lock);
+	}
+
+	sync->in_progress = true;
+	sync->bg_requested = false;
+
 	fts_sync_begin(sync);
 
-	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
-		fts_index_cache_t*	index_cache;
+	for (int pass = unlock_cache ? 0 : 1; pass < 2; ++pass) {
 
-		index_cache = static_cast<fts_index_cache_t*>(
-			ib_vector_get(cache->indexes, i));
+		for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+			fts_index_cache_t*	index_cache;
+
+			index_cache = static_cast<fts_index_cache_t*>(
+				ib_vector_get(cache->indexes, i));
+
+			error = fts_sync_index(sync, index_cache, pass == 0);
 
-		error = fts_sync_index(sync, index_cache);
+			if (error != DB_SUCCESS && !sync->interrupted) {
 
-		if (error != DB_SUCCESS && !sync->interrupted) {
+				break;
+			}
+		}
 
+		if (error != DB_SUCCESS) {
 			break;
 		}
 	}
@@ -4473,11 +4600,12 @@ fts_sync(
 	/* We need to check whether an optimize is required, for that
 	we make copies of the two variables that control the trigger. These
 	variables can change behind our back and we don't want to hold the
-	lock for longer than is needed. */
+	lock for longer than is needed. The deleted count is kept until the
+	background OPTIMIZE has purged the deleted doc ids, see
+	fts_optimize_table_bk(). */
 	mutex_enter(&cache->deleted_lock);
 
 	cache->added = 0;
-	cache->deleted = 0;
 
 	mutex_exit(&cache->deleted_lock);
 
@@ -4491,12 +4619,15 @@ FTS auxiliary INDEX table and clear the cache at the end. */
 void
 fts_sync_table(
 /*===========*/
-	dict_table_t*	table)		/*!< in: table */
+	dict_table_t*	table,		/*!< in: table */
+	bool		unlock_cache)	/*!< in: true=release the cache
+					lock while writing the nodes,
+					see fts_sync() */
 {
 	ut_ad(table->fts);
 
 	if (table->fts->cache) {
-		fts_sync(table->fts->cache->sync);
+		fts_sync(table->fts->cache->sync, unlock_cache);
 	}
 }
 
@@ -5188,6 +5319,89 @@ fts_cache_append_deleted_doc_ids(
 	mutex_exit((ib_mutex_t*) &cache->deleted_lock);
 }
 
+/*********************************************************************//**
+Copy the doc ids of the table that are deleted and not yet purged by
+OPTIMIZE. The DELETED and DELETED_CACHE tables are read only the first time
+this is called for the cache; fts_delete() and OPTIMIZE keep the set up to
+date after that.
+@return DB_SUCCESS or error code */
+
+dberr_t
+fts_cache_copy_deleted_doc_ids(
+/*===========================*/
+	dict_table_t*		table,		/*!< in: table */
+	fts_doc_id_set_t*	deleted)	/*!< out: deleted doc ids */
+{
+	fts_cache_t*	cache = table->fts->cache;
+	dberr_t		error = DB_SUCCESS;
+	ulint		i;
+	bool		loaded;
+
+	mutex_enter(&cache->deleted_lock);
+	loaded = cache->deleted_set_loaded;
+	mutex_exit(&cache->deleted_lock);
+
+	if (!loaded) {
+		fts_table_t	fts_table;
+		fts_doc_ids_t*	doc_ids = fts_doc_ids_create();
+
+		/* The doc ids that are deleted while we read the tables
+		are added to the set by fts_delete(). */
+		FTS_INIT_FTS_TABLE(
+			&fts_table, "DELETED", FTS_COMMON_TABLE, table);
+
+		error = fts_table_fetch_doc_ids(NULL, &fts_table, doc_ids);
+
+		if (error == DB_SUCCESS) {
+			fts_table.suffix = "DELETED_CACHE";
+
+			error = fts_table_fetch_doc_ids(
+				NULL, &fts_table, doc_ids);
+		}
+
+		if (error == DB_SUCCESS) {
+			mutex_enter(&cache->deleted_lock);
+
+			for (i = 0; i < ib_vector_size(doc_ids->doc_ids); ++i) {
+				const fts_update_t*	update;
+
+				update = static_cast<const fts_update_t*>(
+					ib_vector_get_const(
+						doc_ids->doc_ids, i));
+
+				cache->deleted_set->insert(update->doc_id);
+			}
+
+			cache->deleted_set_loaded = true;
+
+			mutex_exit(&cache->deleted_lock);
+		}
+
+		fts_doc_ids_free(doc_ids);
+
+		if (error != DB_SUCCESS) {
+			return(error);
+		}
+	}
+
+	mutex_enter(&cache->deleted_lock);
+
+	*deleted = *cache->deleted_set;
+
+	for (i = 0; i < ib_vector_size(cache->deleted_doc_ids); ++i) {
+		const fts_update_t*	update;
+
+		update = static_cast<const fts_update_t*>(
+			ib_vector_get_const(cache->deleted_doc_ids, i));
+
+		deleted->insert(update->doc_id);
+	}
+
+	mutex_exit(&cache->deleted_lock);
+
+	return(error);
+}
+
 /*********************************************************************//**
 Wait for the background thread to start. We poll to detect change
 of state, which is acceptable, since the wait should happen only
@@ -33,6 +33,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "fts0priv.h"
 #include "fts0types.h"
 #include "ut0wqueue.h"
+#include "srv0srv.h"
 #include "srv0start.h"
 #include "ut0list.h"
 #include "zlib.h"
@@ -54,6 +55,10 @@ static const ulint FTS_QUEUE_WAIT_IN_USECS = 5000000;
 /** Default optimize interval in secs. */
 static const ulint FTS_OPTIMIZE_INTERVAL_IN_SECS = 300;
 
+/** Interval in secs between the passes of a background optimize that has
+not yet optimized all the words of the indexes. */
+static const ulint FTS_OPTIMIZE_RESUME_INTERVAL_IN_SECS = 1;
+
 /** Server is shutting down, so does we exiting the optimize thread */
 static bool fts_opt_start_shutdown = false;
 
@@ -90,6 +95,8 @@ enum fts_msg_type_t {
 
 	FTS_MSG_DEL_TABLE,		/*!< Remove a table from the optimize
 					threads work queue */
+
+	FTS_MSG_SYNC_TABLE,		/*!< SYNC the cache of a table */
 };
 
 /** Compressed list of words that have been read from FTS INDEX
@@ -165,6 +172,9 @@ struct fts_optimize_t {
 
 	ibool		done;		/*!< TRUE when optimize finishes */
 
+	ulint		n_words_limit;	/*!< Maximum number of words of each
+					index to optimize in this pass */
+
 	ib_vector_t*	words;		/*!< Word + Nodes read from FTS_INDEX,
 					it contains instances of fts_word_t */
 
@@ -204,6 +214,10 @@ struct fts_slot_t {
 
 	ib_time_t	interval_time;	/*!< Minimum time to wait before
 					optimizing the table again. */
+
+	bool		resume;		/*!< true if the background optimize
+					has stopped at its word budget and
+					continues in the next pass */
 };
 
 /** A table remove message for the FTS optimize thread. */
@@ -1597,6 +1611,8 @@ fts_optimize_create(
 
 	optim->to_delete = fts_doc_ids_create();
 
+	optim->n_words_limit = fts_num_word_optimize;
+
 	optim->words = ib_vector_create(
 		optim->self_heap, sizeof(fts_word_t), 256);
 
@@ -1782,7 +1798,9 @@ fts_optimize_words(
 	fetch.read_arg = optim->words;
 	fetch.read_record = fts_optimize_index_fetch_node;
 
-	fprintf(stderr, "%.*s\n", (int) word->f_len, word->f_str);
+	if (fts_enable_diag_print) {
+		fprintf(stderr, "%.*s\n", (int) word->f_len, word->f_str);
+	}
 
 	while(!optim->done) {
 		dberr_t	error;
@@ -1957,7 +1975,7 @@ fts_optimize_index_read_words(
 	while (error == DB_SUCCESS) {
 
 		error = fts_index_fetch_words(
-			optim, word, fts_num_word_optimize);
+			optim, word, optim->n_words_limit);
 
 		if (error == DB_SUCCESS) {
 
@@ -2338,7 +2356,28 @@ fts_optimize_purge_snapshot(
 	}
 
 	if (error == DB_SUCCESS) {
+		fts_cache_t*	cache = optim->table->fts->cache;
+
 		fts_sql_commit(optim->trx);
+
+		/* The purged doc ids no longer need to be filtered by
+		the queries. */
+		mutex_enter(&cache->deleted_lock);
+
+		for (ulint i = 0;
+		     i < ib_vector_size(optim->to_delete->doc_ids);
+		     ++i) {
+
+			const fts_update_t*	update;
+
+			update = static_cast<const fts_update_t*>(
+				ib_vector_get_const(
+					optim->to_delete->doc_ids, i));
+
+			cache->deleted_set->erase(update->doc_id);
+		}
+
+		mutex_exit(&cache->deleted_lock);
 	} else {
 		fts_sql_rollback(optim->trx);
 	}
@@ -2386,56 +2425,25 @@ fts_optimize_reset_start_time(
 }
 
 /*********************************************************************//**
-Run OPTIMIZE on the given table by a background thread.
+Run one pass of OPTIMIZE on the given table, optimizing at most
+n_words_limit words of each FTS index.
 @return DB_SUCCESS if all OK */
 static __attribute__((nonnull))
 dberr_t
-fts_optimize_table_bk(
-/*==================*/
-	fts_slot_t*	slot)	/*!< in: table to optimiza */
-{
-	dberr_t		error;
-	dict_table_t*	table = slot->table;
-	fts_t*		fts = table->fts;
-
-	/* Avoid optimizing tables that were optimized recently. */
-	if (slot->last_run > 0
-	    && (ut_time() - slot->last_run) < slot->interval_time) {
-
-		return(DB_SUCCESS);
-
-	} else if (fts && fts->cache
-		   && fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD) {
-
-		error = fts_optimize_table(table);
-
-		if (error == DB_SUCCESS) {
-			slot->state = FTS_STATE_DONE;
-			slot->last_run = 0;
-			slot->completed = ut_time();
-		}
-	} else {
-		error = DB_SUCCESS;
-	}
-
-	/* Note time this run completed. */
-	slot->last_run = ut_time();
-
-	return(error);
-}
-/*********************************************************************//**
-Run OPTIMIZE on the given table.
-@return DB_SUCCESS if all OK */
-
-dberr_t
-fts_optimize_table(
-/*===============*/
-	dict_table_t*	table)	/*!< in: table to optimiza */
+fts_optimize_table_low(
+/*===================*/
+	dict_table_t*	table,		/*!< in: table to optimize */
+	ulint		n_words_limit,	/*!< in: maximum number of words
+					of each index to optimize */
+	bool*		completed)	/*!< out: true if all the deleted
+					doc ids have been purged */
 {
 	dberr_t		error = DB_SUCCESS;
 	fts_optimize_t*	optim = NULL;
 	fts_t*		fts = table->fts;
 
+	*completed = false;
+
 	if (fts_enable_diag_print) {
 		ib_logf(IB_LOG_LEVEL_INFO,
 			"FTS start optimize %s\n",
@@ -2444,6 +2452,8 @@ fts_optimize_table(
 
 	optim = fts_optimize_create(table);
 
+	optim->n_words_limit = n_words_limit;
+
 	// FIXME: Call this only at the start of optimize, currently we
 	// rely on DB_DUPLICATE_KEY to handle corrupting the snapshot.
 
@@ -2478,6 +2488,8 @@ fts_optimize_table(
 			are deleted records to be cleaned up */
 			if (ib_vector_size(optim->to_delete->doc_ids) > 0) {
 				error = fts_optimize_indexes(optim);
+			} else {
+				*completed = true;
 			}
 
 		} else {
@@ -2509,6 +2521,8 @@ fts_optimize_table(
 				so that optimize can be restarted. */
 				error = fts_optimize_reset_start_time(optim);
 			}
+
+			*completed = (error == DB_SUCCESS);
 		}
 	}
 
@@ -2523,6 +2537,94 @@ fts_optimize_table(
 	return(error);
 }
 
+/*********************************************************************//**
+Run OPTIMIZE on the given table.
+@return DB_SUCCESS if all OK */
+
+dberr_t
+fts_optimize_table(
+/*===============*/
+	dict_table_t*	table)	/*!< in: table to optimiza */
+{
+	bool	completed;
+
+	return(fts_optimize_table_low(
+		       table, fts_num_word_optimize, &completed));
+}
+
+/*********************************************************************//**
+Run OPTIMIZE on the given table by a background thread.
+@return DB_SUCCESS if all OK */
+static __attribute__((nonnull))
+dberr_t
+fts_optimize_table_bk(
+/*==================*/
+	fts_slot_t*	slot)	/*!< in: table to optimiza */
+{
+	dberr_t		error;
+	dict_table_t*	table = slot->table;
+	fts_t*		fts = table->fts;
+
+	/* Avoid optimizing tables that were optimized recently. */
+	if (slot->last_run > 0
+	    && (ut_time() - slot->last_run) < slot->interval_time) {
+
+		return(DB_SUCCESS);
+
+	} else if (fts && fts->cache
+		   && (slot->resume
+		       || fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD)) {
+
+		bool	completed;
+
+		if (!slot->resume) {
+			/* Remember how many deletes this optimize
+			covers, so that only those are forgotten when
+			it completes. */
+			mutex_enter(&fts->cache->deleted_lock);
+			slot->deleted = fts->cache->deleted;
+			mutex_exit(&fts->cache->deleted_lock);
+		}
+
+		/* Merge the words incrementally: at most
+		innodb_io_capacity words of each index per pass, with
+		FTS_OPTIMIZE_RESUME_INTERVAL_IN_SECS between passes
+		and the message queue served in between. */
+		error = fts_optimize_table_low(
+			table,
+			ut_max(ut_min(fts_num_word_optimize,
+				      srv_io_capacity), 1UL),
+			&completed);
+
+		if (error != DB_SUCCESS) {
+			slot->resume = false;
+			slot->interval_time = FTS_OPTIMIZE_INTERVAL_IN_SECS;
+		} else if (completed) {
+			slot->state = FTS_STATE_DONE;
+			slot->last_run = 0;
+			slot->completed = ut_time();
+			slot->resume = false;
+			slot->interval_time = FTS_OPTIMIZE_INTERVAL_IN_SECS;
+
+			mutex_enter(&fts->cache->deleted_lock);
+			fts->cache->deleted -= ut_min(
+				slot->deleted, fts->cache->deleted);
+			mutex_exit(&fts->cache->deleted_lock);
+		} else {
+			slot->resume = true;
+			slot->interval_time
+				= FTS_OPTIMIZE_RESUME_INTERVAL_IN_SECS;
+		}
+	} else {
+		error = DB_SUCCESS;
+	}
+
+	/* Note time this run completed. */
+	slot->last_run = ut_time();
+
+	return(error);
+}
+
 /********************************************************************//**
 Add the table to add to the OPTIMIZER's list.
 @return new message instance */
@@ -2588,6 +2690,29 @@ fts_optimize_do_table(
 	ib_wqueue_add(fts_optimize_wq, msg, msg->heap);
 }
 
+/**********************************************************************//**
+Ask the optimize thread to SYNC the cache of a table in the background.
+@return true if the request was queued */
+
+bool
+fts_optimize_request_sync_table(
+/*============================*/
+	dict_table_t*	table)			/*!< in: table to SYNC */
+{
+	fts_msg_t*	msg;
+
+	/* Optimizer thread could be shutdown */
+	if (!fts_optimize_wq || fts_opt_start_shutdown) {
+		return(false);
+	}
+
+	msg = fts_optimize_create_msg(FTS_MSG_SYNC_TABLE, table);
+
+	ib_wqueue_add(fts_optimize_wq, msg, msg->heap);
+
+	return(true);
+}
+
 /**********************************************************************//**
 Remove the table from the OPTIMIZER's list. We do wait for
 acknowledgement from the consumer of the message. */
@@ -2658,6 +2783,56 @@ fts_optimize_find_slot(
 	return(NULL);
 }
 
+/**********************************************************************//**
+SYNC the cache of a table on request of fts_add_doc_by_id(). */
+static
+void
+fts_optimize_sync_table(
+/*====================*/
+	ib_vector_t*	tables,			/*!< in: vector of tables */
+	dict_table_t*	table)			/*!< in: table to SYNC */
+{
+	ulint		i;
+	fts_cache_t*	cache;
+
+	/* The table object is valid as long as it is in our list:
+	fts_optimize_remove_table() waits for us before it is freed. */
+	for (i = 0; i < ib_vector_size(tables); ++i) {
+		const fts_slot_t*	slot;
+
+		slot = static_cast<const fts_slot_t*>(
+			ib_vector_get_const(tables, i));
+
+		if (slot->state != FTS_STATE_EMPTY && slot->table == table) {
+			break;
+		}
+	}
+
+	if (i == ib_vector_size(tables) || !table->fts->cache) {
+		return;
+	}
+
+	cache = table->fts->cache;
+
+	/* The SYNC releases the cache lock between the nodes, so the
+	FTS indexes must not change meanwhile. Do not wait for a DDL
+	operation, which could itself be waiting for this thread; the
+	next document added to the cache requests the SYNC again. */
+	if (!rw_lock_s_lock_nowait(&dict_operation_lock,
+				   __FILE__, __LINE__)) {
+
+		rw_lock_x_lock(&cache->lock);
+		cache->sync->bg_requested = false;
+		rw_lock_x_unlock(&cache->lock);
+
+		return;
+	}
+
+	fts_sync_table(table, true);
+
+	rw_lock_s_unlock(&dict_operation_lock);
+}
+
 /**********************************************************************//**
 Start optimizing table. */
 static
@@ -2808,7 +2983,7 @@ fts_optimize_how_many(
 
 			delta = current_time - slot->last_run;
 
-			if (delta > slot->interval_time) {
+			if (delta >= slot->interval_time) {
 				++n_tables;
 			}
 			break;
@@ -2897,7 +3072,7 @@ fts_optimize_need_sync(
 
 		if (table->fts->cache->added
 		    >= fts_optimize_add_threshold) {
-			fts_sync_table(table);
+			fts_sync_table(table, false);
 		} else if (deleted >= fts_optimize_delete_threshold) {
 			fts_optimize_do_table(table);
 
@@ -2986,6 +3161,10 @@ fts_optimize_thread(
 					fts_need_sync = true;
 				}
 
+				/* Pick up the tables whose incremental
+				optimize is due to resume. */
+				n_optimize = fts_optimize_how_many(tables);
+
 				continue;
 			}
 
@@ -3020,6 +3199,15 @@ fts_optimize_thread(
 				}
 				break;
 
+			case FTS_MSG_SYNC_TABLE:
+				if (!done) {
+					fts_optimize_sync_table(
+						tables,
+						static_cast<dict_table_t*>(
+						msg->ptr));
+				}
+				break;
+
 			case FTS_MSG_DEL_TABLE:
 				if (fts_optimize_del_table(
 					tables, static_cast<fts_msg_del_t*>(
@@ -3068,7 +3256,7 @@ fts_optimize_thread(
 				if (table) {
 
 					if (dict_table_has_fts_index(table)) {
-						fts_sync_table(table);
+						fts_sync_table(table, false);
 					}
 
 					if (table->fts) {
@@ -85,7 +85,8 @@ struct fts_query_t {
 
 	ulint		total_size;	/*!< total memory size used by query */
 
-	fts_doc_ids_t*	deleted;	/*!< Deleted doc ids that need to be
+	fts_doc_id_set_t*
+			deleted;	/*!< Deleted doc ids that need to be
 					filtered from the output */
 
 	fts_ast_node_t*	root;		/*!< Abstract syntax tree */
@@ -747,11 +748,9 @@ fts_query_union_doc_id(
 					rank associated with the doc_id */
 {
 	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	fts_update_t*	array = (fts_update_t*) query->deleted->doc_ids->data;
 
 	/* Check if the doc id is deleted and it's not already in our set. */
-	if (fts_bsearch(array, 0, (int) size, doc_id) < 0
+	if (!query->deleted->contains(doc_id)
 	    && rbt_search(query->doc_ids, &parent, &doc_id) != 0) {
 
 		fts_ranking_t	ranking;
@@ -778,11 +777,9 @@ fts_query_remove_doc_id(
 	doc_id_t	doc_id)		/*!< in: the doc id to add */
 {
 	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	fts_update_t*	array = (fts_update_t*) query->deleted->doc_ids->data;
 
 	/* Check if the doc id is deleted and it's in our set. */
-	if (fts_bsearch(array, 0, (int) size, doc_id) < 0
+	if (!query->deleted->contains(doc_id)
 	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
 		ut_free(rbt_remove_node(query->doc_ids, parent.last));
 
@@ -808,11 +805,9 @@ fts_query_change_ranking(
 	ibool		downgrade)	/*!< in: Whether to downgrade ranking */
 {
 	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	fts_update_t*	array = (fts_update_t*) query->deleted->doc_ids->data;
 
 	/* Check if the doc id is deleted and it's in our set. */
-	if (fts_bsearch(array, 0, (int) size, doc_id) < 0
+	if (!query->deleted->contains(doc_id)
 	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
 
 		fts_ranking_t*	ranking;
@@ -845,12 +840,10 @@ fts_query_intersect_doc_id(
 					rank associated with the doc_id */
 {
 	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	fts_update_t*	array = (fts_update_t*) query->deleted->doc_ids->data;
 	fts_ranking_t*	ranking= NULL;
 
 	/* Check if the doc id is deleted and it's in our set */
-	if (fts_bsearch(array, 0, (int) size, doc_id) < 0) {
+	if (!query->deleted->contains(doc_id)) {
 		fts_ranking_t	new_ranking;
 
 		/* Check doc_id in doc_ids:
@@ -3533,9 +3526,6 @@ fts_query_prepare_result(
 
 	if (query->flags == FTS_OPT_RANKING) {
 		fts_word_freq_t*	word_freq;
-		ulint		size = ib_vector_size(query->deleted->doc_ids);
-		fts_update_t*	array =
-			(fts_update_t*) query->deleted->doc_ids->data;
 
 		node = rbt_first(query->word_freqs);
 		ut_ad(node);
@@ -3550,8 +3540,7 @@ fts_query_prepare_result(
 			doc_freq = rbt_value(fts_doc_freq_t, node);
 
 			/* Don't put deleted docs into result */
-			if (fts_bsearch(array, 0, (int) size, doc_freq->doc_id)
-			    >= 0) {
+			if (query->deleted->contains(doc_freq->doc_id)) {
 				continue;
 			}
 
@@ -3650,9 +3639,7 @@ fts_query_free(
 		fts_ast_free_node(query->root);
 	}
 
-	if (query->deleted) {
-		fts_doc_ids_free(query->deleted);
-	}
+	delete query->deleted;
 
 	if (query->doc_ids) {
 		fts_query_free_doc_ids(query, query->doc_ids);
@@ -3792,7 +3779,7 @@ fts_query(
 	query.index = index;
 	query.inited = FALSE;
 	query.boolean_mode = boolean_mode;
-	query.deleted = fts_doc_ids_create();
+	query.deleted = new fts_doc_id_set_t;
 	query.cur_node = NULL;
 
 	query.fts_common_table.type = FTS_COMMON_TABLE;
@@ -3834,32 +3821,13 @@ fts_query(
 	}
 #endif /* FTS_DOC_STATS_DEBUG */
 
-	query.fts_common_table.suffix = "DELETED";
-
-	/* Read the deleted doc_ids, we need these for filtering. */
-	error = fts_table_fetch_doc_ids(
-		NULL, &query.fts_common_table, query.deleted);
-
-	if (error != DB_SUCCESS) {
-		goto func_exit;
-	}
-
-	query.fts_common_table.suffix = "DELETED_CACHE";
-
-	error = fts_table_fetch_doc_ids(
-		NULL, &query.fts_common_table, query.deleted);
+	/* Get the deleted doc_ids, we need these for filtering. */
+	error = fts_cache_copy_deleted_doc_ids(index->table, query.deleted);
 
 	if (error != DB_SUCCESS) {
 		goto func_exit;
 	}
 
-	/* Get the deleted doc ids that are in the cache. */
-	fts_cache_append_deleted_doc_ids(
-		index->table->fts->cache, query.deleted->doc_ids);
-
-	/* Sort the vector so that we can do a binary search over the ids. */
-	ib_vector_sort(query.deleted->doc_ids, fts_update_doc_id_cmp);
-
 	/* Convert the query string to lower case before parsing. We own
 	the ut_malloc'ed result and so remember to free it before return. */
 
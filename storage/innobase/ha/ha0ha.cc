@@ -37,7 +37,7 @@ Created 8/22/1994 Heikki Tuuri
 
 /*************************************************************//**
 Creates a hash table with at least n array cells.  The actual number
-of cells is chosen to be a prime number slightly bigger than n.
+of cells is chosen by hash_calc_n_cells().
 @return own: created table */
 
 hash_table_t*
@@ -57,7 +57,7 @@ ib_create(
 	     || type == MEM_HEAP_FOR_PAGE_HASH);
 
 	ut_ad(ut_is_2pow(n_sync_obj));
-	table = hash_create(n);
+	table = hash_create_n_cells(hash_calc_n_cells(n, n_sync_obj));
 
 	/* Creating MEM_HEAP_BTR_SEARCH type heaps can potentially fail,
 	but in practise it never should in this case, hence the asserts. */
@@ -101,7 +101,7 @@ ha_clear(
 {
 	ut_ad(table->magic_n == HASH_TABLE_MAGIC_N);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!table->adaptive || rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(!table->adaptive || btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	for (ulint i = 0; i < table->n_sync_obj; i++) {
@@ -266,7 +266,7 @@ ha_delete_hash_node(
 	ut_ad(table);
 	ut_ad(table->magic_n == HASH_TABLE_MAGIC_N);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(btr_search_enabled);
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
@@ -305,7 +305,7 @@ ha_search_and_update_if_found_func(
 	ut_a(new_block->frame == page_align(new_data));
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_X));
+	ut_ad(btr_search_own_any(RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 
 	if (!btr_search_enabled) {
@@ -283,23 +283,32 @@ hash_table_t*
 hash_create(
 /*========*/
 	ulint	n)	/*!< in: number of array cells */
+{
+	return(hash_create_n_cells(ut_find_prime(n)));
+}
+
+/*************************************************************//**
+Creates a hash table with exactly n_cells array cells.
+@return own: created table */
+
+hash_table_t*
+hash_create_n_cells(
+/*================*/
+	ulint	n_cells)	/*!< in: number of array cells */
 {
 	hash_cell_t*	array;
-	ulint		prime;
 	hash_table_t*	table;
 
-	prime = ut_find_prime(n);
-
 	table = static_cast<hash_table_t*>(mem_alloc(sizeof(hash_table_t)));
 
 	array = static_cast<hash_cell_t*>(
-		ut_malloc(sizeof(hash_cell_t) * prime));
+		ut_malloc(sizeof(hash_cell_t) * n_cells));
 
 	/* The default type of hash_table is HASH_TABLE_SYNC_NONE i.e.:
 	the caller is responsible for access control to the table. */
 	table->type = HASH_TABLE_SYNC_NONE;
 	table->array = array;
-	table->n_cells = prime;
+	table->n_cells = n_cells;
 #ifndef UNIV_HOTBACKUP
 # if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 	table->adaptive = FALSE;
@@ -332,6 +341,29 @@ hash_table_free(
 }
 
 #ifndef UNIV_HOTBACKUP
+/*************************************************************//**
+Calculates the number of array cells for a hash table with >= n cells
+that is protected by n_sync_obj sync objects.
+@return number of array cells */
+
+ulint
+hash_calc_n_cells(
+/*==============*/
+	ulint	n,		/*!< in: minimum number of array cells */
+	ulint	n_sync_obj)	/*!< in: number of sync objects,
+				a power of 2, or 0 */
+{
+	ut_ad(ut_is_2pow(n_sync_obj));
+
+	if (n_sync_obj <= 1) {
+		return(ut_find_prime(n));
+	}
+
+	/* hash_get_sync_obj_index() takes the cell number modulo
+	n_sync_obj, which is then the fold value modulo n_sync_obj. */
+	return(ut_find_prime(n / n_sync_obj + 1) * n_sync_obj);
+}
+
 /*************************************************************//**
 Creates a sync object array to protect a hash table.
 ::sync_obj can be mutexes or rw_locks depening on the type of
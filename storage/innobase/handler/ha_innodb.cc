@@ -48,6 +48,8 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include <sql_show.h>
 #include <sql_table.h>
 
+#include <algorithm>
+
 /* Include necessary InnoDB headers */
 #include "buf0dump.h"
 #include "buf0lru.h"
@@ -78,6 +80,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "fil0fil.h"
 #include "trx0xa.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "dict0boot.h"
 #include "dict0stats.h"
 #include "dict0stats_bg.h"
@@ -138,10 +141,6 @@ static long long innobase_buffer_pool_size, innobase_log_file_size;
 Connected to buf_LRU_old_ratio. */
 static uint innobase_old_blocks_pct;
 
-/** Maximum on-disk size of change buffer in terms of percentage
-of the buffer pool. */
-static uint innobase_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
-
 /* The default values for the following char* start-up parameters
 are determined in innobase_init below: */
 
@@ -223,6 +222,24 @@ static TYPELIB innodb_checksum_algorithm_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_compression_algorithm",
+in the order of page_zip_algorithm_t. */
+static const char* innodb_compression_algorithm_names[] = {
+	"zlib",
+	"lz4",
+	"zstd",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_compression_algorithm. */
+static TYPELIB innodb_compression_algorithm_typelib = {
+	array_elements(innodb_compression_algorithm_names) - 1,
+	"innodb_compression_algorithm_typelib",
+	innodb_compression_algorithm_names,
+	NULL
+};
+
 /* The following counter is used to convey information to InnoDB
 about server activity: in selects it is not sensible to call
 srv_active_wake_master_thread after each fetch or search, we only do
@@ -328,11 +345,12 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(sync_thread_mutex),
 #  endif /* UNIV_SYNC_DEBUG */
 	PSI_KEY(buf_dblwr_mutex),
+	PSI_KEY(page_cleaner_mutex),
 	PSI_KEY(trx_undo_mutex),
 	PSI_KEY(trx_pool_mutex),
 	PSI_KEY(trx_pool_manager_mutex),
 	PSI_KEY(srv_sys_mutex),
-	PSI_KEY(lock_mutex),
+	PSI_KEY(lock_rec_hash_mutex),
 	PSI_KEY(lock_wait_mutex),
 	PSI_KEY(trx_mutex),
 	PSI_KEY(srv_threads_mutex),
@@ -370,6 +388,7 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_KEY(fts_cache_init_rw_lock),
 	PSI_KEY(trx_i_s_cache_lock),
 	PSI_KEY(trx_purge_latch),
+	PSI_KEY(lock_sys_latch),
 	PSI_KEY(index_tree_rw_lock),
 	PSI_KEY(index_online_log),
 	PSI_KEY(dict_table_stats),
@@ -389,12 +408,18 @@ static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(io_write_thread),
 	PSI_KEY(io_handler_thread),
 	PSI_KEY(srv_lock_timeout_thread),
+	PSI_KEY(srv_lock_deadlock_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_monitor_thread),
 	PSI_KEY(srv_master_thread),
 	PSI_KEY(srv_purge_thread),
 	PSI_KEY(page_cleaner_thread),
-	PSI_KEY(recv_writer_thread)
+	PSI_KEY(page_cleaner_worker_thread),
+	PSI_KEY(lru_manager_thread),
+	PSI_KEY(recv_writer_thread),
+	PSI_KEY(log_writer_thread),
+	PSI_KEY(log_flusher_thread),
+	PSI_KEY(recv_apply_thread)
 };
 # endif /* UNIV_PFS_THREAD */
 
@@ -471,7 +496,8 @@ ib_cb_t innodb_api_cb[] = {
 	(ib_cb_t) ib_get_idx_field_name,
 	(ib_cb_t) ib_trx_get_start_time,
 	(ib_cb_t) ib_cfg_bk_commit_interval,
-	(ib_cb_t) ib_ut_strerr
+	(ib_cb_t) ib_ut_strerr,
+	(ib_cb_t) ib_cursor_moveto_batch
 };
 
 /*************************************************************//**
@@ -514,6 +540,12 @@ static MYSQL_THDVAR_BOOL(table_locks, PLUGIN_VAR_OPCMDARG,
   /* check_func */ NULL, /* update_func */ NULL,
   /* default */ TRUE);
 
+static MYSQL_THDVAR_BOOL(scan_resistant, PLUGIN_VAR_OPCMDARG,
+  "Move the pages read by a table scan larger than the old sublist of the"
+  " buffer pool LRU list to its end once the scan is done with them, so"
+  " that the scan does not evict the pages of the working set.",
+  NULL, NULL, TRUE);
+
 static MYSQL_THDVAR_BOOL(strict_mode, PLUGIN_VAR_OPCMDARG,
   "Use strict mode when evaluating create options.",
   NULL, NULL, FALSE);
@@ -527,6 +559,12 @@ static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 1, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_ULONG(buffer_page_sample_rate, PLUGIN_VAR_RQCMDARG,
+  "Read every Nth block of the buffer pool without latching it in"
+  " INFORMATION_SCHEMA.INNODB_BUFFER_PAGE. The default 0 reads all the"
+  " blocks under the buffer pool mutex.",
+  NULL, NULL, 0, 0, 1024 * 1024, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
@@ -537,6 +575,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
   {"buffer_pool_load_status",
   (char*) &export_vars.innodb_buffer_pool_load_status,	  SHOW_CHAR},
+  {"buffer_pool_resize_status",
+  (char*) &export_vars.innodb_buffer_pool_resize_status,  SHOW_CHAR},
   {"buffer_pool_pages_data",
   (char*) &export_vars.innodb_buffer_pool_pages_data,	  SHOW_LONG},
   {"buffer_pool_bytes_data",
@@ -1222,6 +1262,20 @@ thd_supports_xa(
 	return(THDVAR(thd, support_xa));
 }
 
+/******************************************************************//**
+Returns true if large table scans of the thread should be scan-resistant,
+global value of innodb_scan_resistant if thd is NULL.
+@return true if large scans should not evict the working set */
+
+ibool
+thd_scan_resistant(
+/*===============*/
+	THD*	thd)	/*!< in: thread handle, or NULL to query
+			the global innodb_scan_resistant */
+{
+	return(THDVAR(thd, scan_resistant));
+}
+
 /******************************************************************//**
 Returns the lock wait timeout for the current connection.
 @return the lock wait timeout, in seconds */
@@ -1237,6 +1291,21 @@ thd_lock_wait_timeout(
 	return(THDVAR(thd, lock_wait_timeout));
 }
 
+/******************************************************************//**
+Returns the sampling rate of the buffer pool information schema tables
+for the current connection.
+@return read every Nth buffer pool block without latching it, or 0 to
+read all the blocks under the buffer pool mutex */
+
+ulong
+thd_buffer_page_sample_rate(
+/*========================*/
+	THD*	thd)	/*!< in: thread handle, or NULL to query the
+			global innodb_buffer_page_sample_rate */
+{
+	return(THDVAR(thd, buffer_page_sample_rate));
+}
+
 /******************************************************************//**
 Set the time waited for the lock for the current query. */
 
@@ -2164,10 +2233,13 @@ ha_innobase::ha_innobase(
 		  HA_CAN_FULLTEXT |
 		  HA_CAN_FULLTEXT_EXT |
 		  HA_CAN_EXPORT |
-		  HA_HAS_RECORDS
+		  HA_HAS_RECORDS |
+		  HA_CAN_READ_BATCH
 		  ),
 	start_of_scan(0),
-	num_write_row(0)
+	num_write_row(0),
+	bulk_heap(NULL),
+	bulk_size(0)
 {}
 
 /*********************************************************************//**
@@ -3115,6 +3187,8 @@ innobase_change_buffering_inited_ok:
 	}
 #endif
 
+	os_numa_init(srv_numa_bind);
+
 	row_rollback_on_timeout = (ibool) innobase_rollback_on_timeout;
 
 	srv_locks_unsafe_for_binlog = (ibool) innobase_locks_unsafe_for_binlog;
@@ -3197,13 +3271,16 @@ innobase_change_buffering_inited_ok:
 		DBUG_RETURN(innobase_init_abort());
 	}
 
+	/* The size was rounded up to whole buffer pool chunks. */
+	innobase_buffer_pool_size = static_cast<long long>(srv_buf_pool_size);
+
 	/* Adjust the innodb_undo_logs config object */
 	innobase_undo_logs_init_default_max();
 
 	innobase_old_blocks_pct = buf_LRU_old_ratio_update(
 		innobase_old_blocks_pct, TRUE);
 
-	ibuf_max_size_update(innobase_change_buffer_max_size);
+	ibuf_max_size_update(srv_change_buffer_max_size);
 
 	innobase_open_tables = hash_create(200);
 	mysql_mutex_init(innobase_share_mutex_key,
@@ -4433,6 +4510,49 @@ innobase_index_lookup(
 	return(share->idx_trans_tbl.index_mapping[keynr]);
 }
 
+/** Index comment word that disables change buffering for the index */
+static const char	innobase_no_change_buffering[] = "NO_CHANGE_BUFFERING";
+
+/*******************************************************************//**
+Sets the options that InnoDB reads from the index comments of the MySQL
+table definition. An index whose comment contains NO_CHANGE_BUFFERING
+does not buffer changes in the change buffer. The options are not stored
+in the InnoDB data dictionary; they are set again whenever the table is
+opened. */
+static
+void
+innobase_parse_index_comments(
+/*==========================*/
+	const TABLE*	table,	/*!< in: table in MySQL data dictionary */
+	INNOBASE_SHARE*	share)	/*!< in: share with the index translation
+				table */
+{
+	const size_t	len = sizeof(innobase_no_change_buffering) - 1;
+
+	for (uint i = 0; i < table->s->keys; i++) {
+		const KEY*	key = &table->key_info[i];
+		dict_index_t*	index = innobase_index_lookup(share, i);
+		bool		disabled = false;
+
+		if (index == NULL) {
+			continue;
+		}
+
+		if (key->flags & HA_USES_COMMENT) {
+			for (size_t pos = 0;
+			     !disabled && pos + len <= key->comment.length;
+			     pos++) {
+
+				disabled = !strncasecmp(
+					key->comment.str + pos,
+					innobase_no_change_buffering, len);
+			}
+		}
+
+		index->ibuf_disabled = disabled;
+	}
+}
+
 /************************************************************************
 Set the autoinc column max value. This should only be called once from
 ha_innobase::open(). Therefore there's no need for a covering lock. */
@@ -4563,8 +4683,8 @@ ha_innobase::open(
 	thd = ha_thd();
 
 	/* Under some cases MySQL seems to call this function while
-	holding btr_search_latch. This breaks the latching order as
-	we acquire dict_sys->mutex below and leads to a deadlock. */
+	holding an adaptive hash index latch. This breaks the latching
+	order as we acquire dict_sys->mutex below and leads to a deadlock. */
 	if (thd != NULL) {
 		innobase_release_temporary_latches(ht, thd);
 	}
@@ -4770,6 +4890,8 @@ table_opened:
 				  " Table %s failed", name);
 	}
 
+	innobase_parse_index_comments(table, share);
+
 	/* Allocate a buffer for a 'row reference'. A row reference is
 	a string of bytes of length ref_length which uniquely specifies
 	a row in our table. Note that MySQL may also compare two row
@@ -4974,6 +5096,8 @@ ha_innobase::close()
 		innobase_release_temporary_latches(ht, thd);
 	}
 
+	bulk_insert_free();
+
 	row_prebuilt_free(prebuilt, FALSE);
 
 	if (upd_buf != NULL) {
@@ -6185,6 +6309,227 @@ ha_innobase::innobase_set_max_autoinc(
 	return(error);
 }
 
+/** Orders rows in MySQL format by the primary key of their table */
+struct bulk_row_less {
+	const KEY*	key;	/*!< the primary key */
+	const uchar*	rec0;	/*!< table->record[0] */
+
+	bool operator()(const uchar* a, const uchar* b) const
+	{
+		const KEY_PART_INFO*	key_part = key->key_part;
+		const KEY_PART_INFO*	end = key_part
+			+ key->user_defined_key_parts;
+
+		for (; key_part != end; key_part++) {
+			Field*	field = key_part->field;
+			int	cmp = field->cmp_max(field->ptr + (a - rec0),
+						     field->ptr + (b - rec0),
+						     key_part->length);
+			if (cmp != 0) {
+				return(cmp < 0);
+			}
+		}
+
+		return(false);
+	}
+};
+
+/********************************************************************//**
+Prepares for the insert of many rows by INSERT or LOAD DATA. The rows are
+copied by write_row() and inserted in primary key order when they fill
+innodb_sort_buffer_size, or by end_bulk_insert(), so that consecutive
+inserts go to the same clustered index leaf while it is in the buffer
+pool. Rows are not buffered when the order of the inserts matters: for
+AUTO_INCREMENT values, duplicate key handling, or foreign keys. */
+
+void
+ha_innobase::start_bulk_insert(
+/*===========================*/
+	ha_rows	rows)	/*!< in: number of rows, or 0 if unknown */
+{
+	DBUG_ENTER("ha_innobase::start_bulk_insert");
+
+	bulk_insert_free();
+
+	switch (thd_sql_command(ha_thd())) {
+	case SQLCOM_INSERT:
+	case SQLCOM_INSERT_SELECT:
+	case SQLCOM_LOAD:
+		break;
+	default:
+		DBUG_VOID_RETURN;
+	}
+
+	if (rows == 1
+	    || srv_read_only_mode
+	    || prebuilt->clust_index_was_generated
+	    || table->s->primary_key >= MAX_KEY
+	    || table->found_next_number_field != NULL
+	    || thd_to_trx(ha_thd())->duplicates
+	    || dict_table_has_fts_index(prebuilt->table)
+	    || UT_LIST_GET_LEN(prebuilt->table->foreign_list) > 0
+	    || UT_LIST_GET_LEN(prebuilt->table->referenced_list) > 0) {
+
+		DBUG_VOID_RETURN;
+	}
+
+	bulk_heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	DBUG_VOID_RETURN;
+}
+
+/********************************************************************//**
+Inserts the rows buffered since start_bulk_insert().
+@return error code */
+
+int
+ha_innobase::end_bulk_insert()
+/*==========================*/
+{
+	int	error;
+
+	DBUG_ENTER("ha_innobase::end_bulk_insert");
+
+	if (bulk_heap == NULL) {
+		DBUG_RETURN(0);
+	}
+
+	/* After an error table->record[0] can point to BLOBs in bulk_heap,
+	which is then freed at the end of the statement by reset(). */
+	if (!(error = bulk_insert_flush())) {
+		bulk_insert_free();
+	}
+
+	DBUG_RETURN(error);
+}
+
+/********************************************************************//**
+Copies a row to the rows to insert in primary key order, and inserts the
+rows when they fill innodb_sort_buffer_size.
+@return error code */
+
+int
+ha_innobase::bulk_insert_row(
+/*=========================*/
+	const uchar*	record)	/*!< in: table->record[0] */
+{
+	ulint		size = table->s->reclength;
+	uchar*		row = static_cast<uchar*>(
+		mem_heap_dup(bulk_heap, record, size));
+	my_ptrdiff_t	diff = row - record;
+
+	ut_ad(record == table->record[0]);
+
+	/* Copy the BLOB values too, as the MySQL row only points to them */
+	for (uint i = 0; i < table->s->blob_fields; i++) {
+		Field_blob*	field = static_cast<Field_blob*>(
+			table->field[table->s->blob_field[i]]);
+		uint32		length = field->get_length(field->ptr + diff);
+		uchar*		data;
+
+		if (length == 0) {
+			continue;
+		}
+
+		memcpy(&data, field->ptr + diff + field->pack_length_no_ptr(),
+		       sizeof(data));
+		field->set_ptr_offset(diff, length, static_cast<uchar*>(
+					      mem_heap_dup(bulk_heap,
+							   data, length)));
+		size += length;
+	}
+
+	bulk_rows.push_back(row);
+	bulk_size += size;
+
+	if (bulk_size >= srv_sort_buf_size) {
+		return(bulk_insert_flush());
+	}
+
+	return(0);
+}
+
+/********************************************************************//**
+Inserts the rows copied by bulk_insert_row() in primary key order. If an
+insert fails, the row is copied to table->record[0] for the error
+message, and the rows after it are discarded.
+@return error code */
+
+int
+ha_innobase::bulk_insert_flush()
+/*============================*/
+{
+	dberr_t		error = DB_SUCCESS;
+	bulk_row_less	less = {
+		table->key_info + table->s->primary_key, table->record[0]
+	};
+
+	if (bulk_rows.empty()) {
+		return(0);
+	}
+
+	/* Keep the order of rows with equal keys, so that the same one
+	gets the duplicate key error as without the buffering */
+	std::stable_sort(bulk_rows.begin(), bulk_rows.end(), less);
+
+	if (prebuilt->mysql_template == NULL
+	    || prebuilt->template_type != ROW_MYSQL_WHOLE_ROW) {
+
+		build_template(true);
+	}
+
+	innobase_srv_conc_enter_innodb(prebuilt->trx);
+
+	for (std::vector<uchar*>::const_iterator it = bulk_rows.begin();
+	     it != bulk_rows.end();
+	     ++it) {
+
+		error = row_insert_for_mysql(*it, prebuilt);
+
+		if (error != DB_SUCCESS) {
+			memcpy(table->record[0], *it, table->s->reclength);
+			break;
+		}
+	}
+
+	innobase_srv_conc_exit_innodb(prebuilt->trx);
+
+	bulk_rows.clear();
+	bulk_size = 0;
+
+	if (error != DB_SUCCESS) {
+		if (error == DB_TABLESPACE_DELETED) {
+			ib_senderrf(
+				prebuilt->trx->mysql_thd, IB_LOG_LEVEL_ERROR,
+				ER_TABLESPACE_DISCARDED,
+				table->s->table_name.str);
+		}
+
+		return(convert_error_code_to_mysql(
+			       error, prebuilt->table->flags, user_thd));
+	}
+
+	mem_heap_empty(bulk_heap);
+
+	return(0);
+}
+
+/********************************************************************//**
+Discards the rows buffered for a multi-row insert. */
+
+void
+ha_innobase::bulk_insert_free()
+/*===========================*/
+{
+	if (bulk_heap != NULL) {
+		mem_heap_free(bulk_heap);
+		bulk_heap = NULL;
+	}
+
+	bulk_rows.clear();
+	bulk_size = 0;
+}
+
 /********************************************************************//**
 Stores a row in an InnoDB database, to the table specified in this
 handle.
@@ -6325,6 +6670,13 @@ no_commit:
 		auto_inc_used = TRUE;
 	}
 
+	if (bulk_heap != NULL && record == table->record[0]) {
+		ut_ad(!auto_inc_used);
+
+		error_result = bulk_insert_row(record);
+		goto func_exit;
+	}
+
 	if (prebuilt->mysql_template == NULL
 	    || prebuilt->template_type != ROW_MYSQL_WHOLE_ROW) {
 
@@ -6997,6 +7349,8 @@ ha_innobase::index_init(
 {
 	DBUG_ENTER("index_init");
 
+	prebuilt->scan_resistant = FALSE;
+
 	DBUG_RETURN(change_active_index(keynr));
 }
 
@@ -7011,6 +7365,7 @@ ha_innobase::index_end(void)
 	int	error	= 0;
 	DBUG_ENTER("index_end");
 	active_index = MAX_KEY;
+	prebuilt->scan_resistant = FALSE;
 	in_range_check_pushed_down = FALSE;
 	ds_mrr.dsmrr_close();
 	DBUG_RETURN(error);
@@ -7279,6 +7634,47 @@ ha_innobase::index_read_last(
 	return(index_read(buf, key_ptr, key_len, HA_READ_PREFIX_LAST));
 }
 
+/*******************************************************************//**
+Starts reading in the background the index pages that a later
+index_read() of the key in the active index would wait for. */
+
+void
+ha_innobase::prefetch_key(
+/*======================*/
+	const uchar*	key_ptr,	/*!< in: key value */
+	key_part_map	keypart_map)	/*!< in: key parts present in key_ptr */
+{
+	dict_index_t*	index = prebuilt->index;
+	mem_heap_t*	heap;
+	dtuple_t*	tuple;
+	uint		key_len;
+
+	if (index == NULL
+	    || !prebuilt->index_usable
+	    || dict_index_is_corrupted(index)
+	    || (index->type & DICT_FTS)
+	    || prebuilt->table->ibd_file_missing) {
+		return;
+	}
+
+	key_len = calculate_key_len(table, active_index, key_ptr, keypart_map);
+
+	heap = mem_heap_create(
+		sizeof(dtuple_t) + index->n_fields * sizeof(dfield_t));
+	tuple = dtuple_create(heap, index->n_fields);
+	dict_index_copy_types(tuple, index, index->n_fields);
+
+	row_sel_convert_mysql_key_to_innobase(
+		tuple, srch_key_val2, sizeof(srch_key_val2),
+		index, (byte*) key_ptr, (ulint) key_len, prebuilt->trx);
+
+	if (dtuple_get_n_fields(tuple) > 0) {
+		btr_cur_prefetch(index, tuple);
+	}
+
+	mem_heap_free(heap);
+}
+
 /********************************************************************//**
 Get the index for a handle. Does not change active index.
 @return NULL or index instance. */
@@ -7645,6 +8041,17 @@ ha_innobase::rnd_init(
 		try_semi_consistent_read(0);
 	}
 
+	/* A scan of a table larger than the old sublist of the LRU
+	would evict all of it, including the pages that were about to
+	be made young. Let it reuse the frames of the pages it is done
+	with instead. */
+
+	prebuilt->scan_resistant = scan
+		&& thd_scan_resistant(ha_thd())
+		&& buf_LRU_scan_is_large(
+			prebuilt->table->stat_clustered_index_size);
+	prebuilt->scan_start_time = ut_time_ms();
+
 	start_of_scan = 1;
 
 	return(err);
@@ -7692,6 +8099,41 @@ ha_innobase::rnd_next(
 	DBUG_RETURN(error);
 }
 
+/**********************************************************************//**
+Reads the next rows in a table scan (also used to read the FIRST row
+in a table scan). After the first row, rows are only added to the
+batch while they are in the prefetch cache, which grows while the scan
+lasts; the batch thus never reads further ahead than a single row scan.
+@return 0, HA_ERR_END_OF_FILE, or error number */
+
+int
+ha_innobase::rnd_next_batch(
+/*========================*/
+	uchar*	buf,		/*!< in/out: returns the rows in this buffer,
+				in MySQL format, one row every
+				rec_buff_length bytes */
+	uint	max_rows,	/*!< in: maximum number of rows to read */
+	uint*	rows_read)	/*!< out: number of rows returned */
+{
+	const ulint	stride = table->s->rec_buff_length;
+	uint		n_rows = 0;
+	int		error;
+
+	DBUG_ENTER("rnd_next_batch");
+
+	do {
+		error = rnd_next(buf + n_rows * stride);
+
+		if (error != 0) {
+			break;
+		}
+	} while (++n_rows < max_rows && prebuilt->n_fetch_cached > 0);
+
+	*rows_read = n_rows;
+
+	DBUG_RETURN(error);
+}
+
 /**********************************************************************//**
 Fetches a row from the table based on a row reference.
 @return 0, HA_ERR_KEY_NOT_FOUND, or error code */
@@ -9166,8 +9608,23 @@ index_bad:
 
 	dict_tf_set(flags, innodb_row_format, zip_ssize, use_data_dir);
 
+	if (zip_ssize) {
+		*flags |= page_zip_algorithm << DICT_TF_POS_ZIP_ALGORITHM;
+	} else if (srv_page_compression
+		   && innodb_row_format == REC_FORMAT_DYNAMIC
+		   && use_tablespace && !is_temp) {
+		/* Compress the pages of the tablespace when they
+		are written to the file. */
+		*flags |= DICT_TF_MASK_PAGE_COMPRESSION
+			| (page_zip_algorithm << DICT_TF_POS_ZIP_ALGORITHM);
+	}
+
 	if (create_info->options & HA_LEX_CREATE_TMP_TABLE) {
 		*flags2 |= DICT_TF2_TEMPORARY;
+
+		if (create_info->options & HA_LEX_CREATE_INTERNAL_TMP_TABLE) {
+			*flags2 |= DICT_TF2_INTRINSIC;
+		}
 	}
 
 	if (use_tablespace) {
@@ -9431,7 +9888,11 @@ ha_innobase::create(
 		dict_table_get_all_fts_indexes(innobase_table, fts->indexes);
 	}
 
-	stmt = innobase_get_stmt(thd, &stmt_len);
+	/* Intrinsic tables are created by the optimizer while
+	executing a statement, which cannot define foreign keys on
+	them. */
+	stmt = (flags2 & DICT_TF2_INTRINSIC)
+		? NULL : innobase_get_stmt(thd, &stmt_len);
 
 	if (stmt) {
 		dberr_t	err = row_table_add_foreign_constraints(
@@ -9477,9 +9938,12 @@ ha_innobase::create(
 
 	/* Flush the log to reduce probability that the .frm files and
 	the InnoDB data dictionary get out-of-sync if the user runs
-	with innodb_flush_log_at_trx_commit = 0 */
+	with innodb_flush_log_at_trx_commit = 0. Intrinsic tables
+	have no .frm file. */
 
-	log_buffer_flush_to_disk();
+	if (!(flags2 & DICT_TF2_INTRINSIC)) {
+		log_buffer_flush_to_disk();
+	}
 
 	innobase_table = dict_table_open_on_name(
 		norm_name, FALSE, FALSE, DICT_ERR_IGNORE_NONE);
@@ -9719,6 +10183,27 @@ ha_innobase::truncate()
 	DBUG_RETURN(error);
 }
 
+/*****************************************************************//**
+Deletes all rows of an intrinsic table; other tables are emptied row by
+row by the caller.
+@return error number */
+
+int
+ha_innobase::delete_all_rows()
+/*==========================*/
+{
+	DBUG_ENTER("ha_innobase::delete_all_rows");
+
+	if (!dict_table_is_intrinsic(prebuilt->table)) {
+		DBUG_RETURN(HA_ERR_WRONG_COMMAND);
+	}
+
+	dberr_t	err = row_truncate_intrinsic_table(prebuilt->table);
+
+	DBUG_RETURN(convert_error_code_to_mysql(
+			    err, prebuilt->table->flags, ha_thd()));
+}
+
 /*****************************************************************//**
 Drops a table from an InnoDB database. Before calling this function,
 MySQL calls innobase_commit to commit the transaction of the current user.
@@ -9800,6 +10285,17 @@ ha_innobase::delete_table(
 	/* We are doing a DDL operation. */
 	++trx->will_lock;
 
+	/* Intrinsic tables have no .frm file that could get out-of-sync
+	with the InnoDB data dictionary. */
+	bool		is_intrinsic = false;
+	dict_table_t*	ib_table = dict_table_open_on_name(
+		norm_name, FALSE, FALSE, DICT_ERR_IGNORE_NONE);
+
+	if (ib_table != NULL) {
+		is_intrinsic = dict_table_is_intrinsic(ib_table);
+		dict_table_close(ib_table, FALSE, FALSE);
+	}
+
 	/* Drop the table in InnoDB */
 	err = row_drop_table_for_mysql(
 		norm_name, trx, thd_sql_command(thd) == SQLCOM_DROP_DB);
@@ -9841,7 +10337,9 @@ ha_innobase::delete_table(
 	the InnoDB data dictionary get out-of-sync if the user runs
 	with innodb_flush_log_at_trx_commit = 0 */
 
-	log_buffer_flush_to_disk();
+	if (!is_intrinsic) {
+		log_buffer_flush_to_disk();
+	}
 
 	/* Tell the InnoDB server that there might be work for
 	utility threads: */
@@ -10206,7 +10704,12 @@ ha_innobase::records()
 	build_template(false);
 
 	/* Count the records in the clustered index */
-	ret = row_scan_index_for_mysql(prebuilt, index, false, &n_rows);
+	if (srv_parallel_read_threads > 1) {
+		ret = row_pread_count(prebuilt->trx, index, false, &n_rows);
+	} else {
+		ret = row_scan_index_for_mysql(
+			prebuilt, index, false, &n_rows);
+	}
 	reset_template();
 	switch (ret) {
 	case DB_SUCCESS:
@@ -10356,6 +10859,50 @@ func_exit:
 	DBUG_RETURN((ha_rows) n_rows);
 }
 
+/*********************************************************************//**
+Estimates the fraction of the rows whose column is equal to the value
+currently stored in the field, from the column histogram in the
+persistent statistics.
+@return selectivity in (0, 1], or a negative value if unknown */
+
+double
+ha_innobase::column_eq_selectivity(
+/*===============================*/
+	const Field*	field)	/*!< in: column, holding the value */
+{
+	dict_table_t*	ib_table = prebuilt->table;
+	ulint		col_no = field->field_index;
+	byte		buf[REC_VERSION_56_MAX_INDEX_COL_LEN + 2];
+	dfield_t	dfield;
+
+	DBUG_ENTER("column_eq_selectivity");
+
+	if (ib_table->stat_n_hist == 0
+	    || col_no >= dict_table_get_n_user_cols(ib_table)
+	    || field->is_null()
+	    || field->pack_length() > sizeof(buf)) {
+
+		DBUG_RETURN(-1.0);
+	}
+
+	const dict_col_t*	col = dict_table_get_nth_col(ib_table, col_no);
+
+	if (DATA_LARGE_MTYPE(col->mtype)) {
+		DBUG_RETURN(-1.0);
+	}
+
+	dict_col_copy_type(col, dfield_get_type(&dfield));
+
+	row_mysql_store_col_in_innobase_format(
+		&dfield, buf, TRUE, field->ptr, field->pack_length(),
+		dict_table_is_comp(ib_table));
+
+	DBUG_RETURN(dict_stats_col_eq_selectivity(
+			    ib_table, col_no,
+			    static_cast<const byte*>(dfield_get_data(&dfield)),
+			    dfield_get_len(&dfield)));
+}
+
 /*********************************************************************//**
 Gives an UPPER BOUND to the number of rows in a table. This is used in
 filesort.cc.
@@ -10447,7 +10994,7 @@ ha_innobase::scan_time()
 	dict_table_stats_unlock(prebuilt->table, RW_S_LATCH);
 #endif
 
-	return((double) stat_clustered_index_size);
+	return(page_read_cost((double) stat_clustered_index_size));
 }
 
 /******************************************************************//**
@@ -10472,7 +11019,7 @@ ha_innobase::read_time(
 
 	if (rows <= 2) {
 
-		return((double) rows);
+		return(page_read_cost((double) rows));
 	}
 
 	/* Assume that the read time is proportional to the scan time for all
@@ -10485,7 +11032,8 @@ ha_innobase::read_time(
 		return(time_for_scan);
 	}
 
-	return(ranges + (double) rows / (double) total_rows * time_for_scan);
+	return(page_read_cost(ranges)
+	       + (double) rows / (double) total_rows * time_for_scan);
 }
 
 /******************************************************************//**
@@ -11099,7 +11647,7 @@ ha_innobase::optimize(
 
 	if (innodb_optimize_fulltext_only) {
 		if (prebuilt->table->fts && prebuilt->table->fts->cache) {
-			fts_sync_table(prebuilt->table);
+			fts_sync_table(prebuilt->table, false);
 			fts_optimize_table(prebuilt->table);
 		}
 		return(HA_ADMIN_OK);
@@ -11253,9 +11801,18 @@ ha_innobase::check(
 
 		prebuilt->select_lock_type = LOCK_NONE;
 
-		/* Scan this index. */
-		dberr_t ret = row_scan_index_for_mysql(
-			prebuilt, index, true, &n_rows);
+		/* Scan this index. The clustered index can be read by
+		several threads. */
+		dberr_t ret;
+
+		if (dict_index_is_clust(index)
+		    && srv_parallel_read_threads > 1) {
+			ret = row_pread_count(
+				prebuilt->trx, index, true, &n_rows);
+		} else {
+			ret = row_scan_index_for_mysql(
+				prebuilt, index, true, &n_rows);
+		}
 
 		DBUG_EXECUTE_IF(
 			"dict_set_index_corrupted",
@@ -11827,6 +12384,7 @@ ha_innobase::reset()
 
 	reset_template();
 	ds_mrr.reset();
+	bulk_insert_free();
 
 	/* TODO: This should really be reset in reset_template() but for now
 	it's safer to do it explicitly here. */
@@ -14043,9 +14601,9 @@ innodb_change_buffer_max_size_update(
 	const void*			save)	/*!< in: immediate result
 						from check function */
 {
-	innobase_change_buffer_max_size =
+	srv_change_buffer_max_size =
 			(*static_cast<const uint*>(save));
-	ibuf_max_size_update(innobase_change_buffer_max_size);
+	ibuf_max_size_update(srv_change_buffer_max_size);
 }
 
 
@@ -14151,6 +14709,62 @@ innodb_change_buffering_update(
 		 *static_cast<const char*const*>(save);
 }
 
+/*************************************************************//**
+Check if it is a valid value of innodb_compression_algorithm. Only the
+algorithms that are available in this build are accepted.
+@return 0 for valid algorithm */
+static
+int
+innodb_compression_algorithm_validate(
+/*==================================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to system
+						variable */
+	void*				save,	/*!< out: immediate result
+						for update function */
+	struct st_mysql_value*		value)	/*!< in: incoming string
+						or number */
+{
+	long long	algorithm;
+
+	ut_a(save != NULL);
+	ut_a(value != NULL);
+
+	if (value->value_type(value) == MYSQL_VALUE_TYPE_STRING) {
+		char		buff[STRING_BUFFER_USUAL_SIZE];
+		int		len = sizeof(buff);
+		const char*	name = value->val_str(value, buff, &len);
+
+		if (name == NULL) {
+			return(1);
+		}
+
+		algorithm = (long long) find_type(
+			&innodb_compression_algorithm_typelib,
+			name, len, false) - 1;
+	} else if (value->val_int(value, &algorithm)) {
+		return(1);
+	}
+
+	if (algorithm < 0 || algorithm > PAGE_ZIP_ALGORITHM_MAX) {
+		return(1);
+	}
+
+	if (!page_zip_algorithm_is_supported((ulint) algorithm)) {
+		push_warning_printf(
+			thd, Sql_condition::SL_WARNING,
+			ER_WRONG_ARGUMENTS,
+			"InnoDB: compression algorithm %s is not"
+			" available in this build.",
+			innodb_compression_algorithm_names[algorithm]);
+		return(1);
+	}
+
+	*static_cast<ulong*>(save) = (ulong) algorithm;
+
+	return(0);
+}
+
 /*************************************************************//**
 Just emit a warning that the usage of the variable is deprecated.
 @return 0 */
@@ -14203,6 +14817,8 @@ innodb_monitor_set_option(
 	function to set options */
 	ut_a(!(monitor_info->monitor_type & MONITOR_GROUP_MODULE));
 
+	srv_mon_fold();
+
 	switch (set_option) {
 	case MONITOR_TURN_ON:
 		MONITOR_ON(monitor_id);
@@ -15175,6 +15791,124 @@ buffer_pool_load_abort(
 	}
 }
 
+/****************************************************************//**
+Update innodb_buffer_pool_dump_interval and wake up the buffer pool
+dump/load thread, so that it starts waiting for the new interval. This
+function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_dump_interval_update(
+/*====================================*/
+	THD*				thd	/*!< in: thread handle */
+					__attribute__((unused)),
+	struct st_mysql_sys_var*	var	/*!< in: pointer to system
+						variable */
+					__attribute__((unused)),
+	void*				var_ptr	/*!< out: where the formal
+						string goes */
+					__attribute__((unused)),
+	const void*			save)	/*!< in: immediate result from
+						check function */
+{
+	srv_buf_pool_dump_interval = *static_cast<const ulong*>(save);
+
+	if (!srv_read_only_mode) {
+		os_event_set(srv_buf_dump_event);
+	}
+}
+
+/****************************************************************//**
+Check the new value of innodb_buffer_pool_size: it cannot be changed in
+read-only mode or while the buffer pool is being resized, and it is
+rounded up to a multiple of innodb_buffer_pool_chunk_size times
+innodb_buffer_pool_instances.
+@return 0 for a valid value */
+static
+int
+innodb_buffer_pool_size_validate(
+/*=============================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to system
+						variable */
+	void*				save,	/*!< out: immediate result
+						for update function */
+	struct st_mysql_value*		value)	/*!< in: incoming string */
+{
+	long long	intbuf;
+
+	if (value->val_int(value, &intbuf)) {
+		/* The value is NULL. That is invalid. */
+		return(1);
+	}
+
+	if (intbuf < 5 * 1024 * 1024L
+	    || (sizeof(ulint) == 4 && intbuf > UINT_MAX32)) {
+
+		push_warning_printf(thd, Sql_condition::SL_WARNING,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size is out of"
+				    " range.");
+		return(1);
+	}
+
+	if (srv_read_only_mode) {
+		push_warning_printf(thd, Sql_condition::SL_WARNING,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size cannot be"
+				    " changed in read-only mode.");
+		return(1);
+	}
+
+	if (srv_buf_pool_old_size != srv_buf_pool_size) {
+		push_warning_printf(thd, Sql_condition::SL_WARNING,
+				    ER_WRONG_ARGUMENTS,
+				    "Another buffer pool resize is already"
+				    " in progress.");
+		return(1);
+	}
+
+	ulint	requested = static_cast<ulint>(intbuf);
+	ulint	aligned = buf_pool_size_align(requested);
+
+	if (aligned != requested) {
+		push_warning_printf(thd, Sql_condition::SL_WARNING,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size must be a"
+				    " multiple of innodb_buffer_pool_chunk_size"
+				    " * innodb_buffer_pool_instances,"
+				    " setting it to %lu.", (ulong) aligned);
+	}
+
+	*static_cast<long long*>(save) = aligned;
+
+	return(0);
+}
+
+/****************************************************************//**
+Update innodb_buffer_pool_size and wake up the buffer pool resize thread.
+This function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_size_update(
+/*===========================*/
+	THD*				thd	/*!< in: thread handle */
+					__attribute__((unused)),
+	struct st_mysql_sys_var*	var	/*!< in: pointer to system
+						variable */
+					__attribute__((unused)),
+	void*				var_ptr	/*!< out: where the formal
+						string goes */
+					__attribute__((unused)),
+	const void*			save)	/*!< in: immediate result from
+						check function */
+{
+	innobase_buffer_pool_size = *static_cast<const long long*>(save);
+
+	srv_buf_pool_size = static_cast<ulint>(innobase_buffer_pool_size);
+
+	os_event_set(srv_buf_resize_event);
+}
+
 static SHOW_VAR innodb_status_variables_export[]= {
 	{"Innodb", (char*) &show_innodb_vars, SHOW_FUNC},
 	{NullS, NullS, SHOW_LONG}
@@ -15228,6 +15962,14 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   "Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_files, srv_n_doublewrite_files,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of doublewrite files in the data home directory, each with its"
+  " own batch and single page slots. Buffer pool instances are spread"
+  " over the files. Default (0) uses the doublewrite buffer in the system"
+  " tablespace.",
+  NULL, NULL, 0, 0, MAX_BUFFER_POOLS, 0);
+
 static MYSQL_SYSVAR_ULONG(io_capacity, srv_io_capacity,
   PLUGIN_VAR_RQCMDARG,
   "Number of IOPs the server can do. Tunes the background IO rate",
@@ -15453,12 +16195,27 @@ static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   "statistics (by ANALYZE, default 20)",
   NULL, NULL, 20, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(stats_histogram_buckets,
+  srv_stats_histogram_buckets,
+  PLUGIN_VAR_RQCMDARG,
+  "The maximum number of buckets of the column histograms that are "
+  "sampled together with the persistent statistics and used to estimate "
+  "the selectivity of conditions on columns (0 disables the histograms, "
+  "default 0)",
+  NULL, NULL, 0, 0, 1024, 0);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default).  "
   "Disable with --skip-innodb-adaptive-hash-index.",
   NULL, innodb_adaptive_hash_index_update, TRUE);
 
+static MYSQL_SYSVAR_ULONG(adaptive_hash_index_parts, btr_ahi_parts,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of InnoDB adaptive hash index partitions, each protected by "
+  "its own latch (default 8).",
+  NULL, NULL, 8, 1, 512, 0);
+
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
   PLUGIN_VAR_RQCMDARG,
   "Replication thread delay (ms) on the slave server if "
@@ -15471,6 +16228,22 @@ static MYSQL_SYSVAR_UINT(compression_level, page_zip_level,
   ", 1 is fastest, 9 is best compression and default is 6.",
   NULL, NULL, DEFAULT_COMPRESSION_LEVEL, 0, 9, 0);
 
+static MYSQL_SYSVAR_ENUM(compression_algorithm, page_zip_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "Compression algorithm of newly created ROW_FORMAT=COMPRESSED tables."
+  " The possible values are ZLIB (the default), and LZ4 and ZSTD if"
+  " the server was built with them. The algorithm of a table is"
+  " changed by rebuilding it.",
+  innodb_compression_algorithm_validate, NULL, PAGE_ZIP_ALGORITHM_ZLIB,
+  &innodb_compression_algorithm_typelib);
+
+static MYSQL_SYSVAR_BOOL(page_compression, srv_page_compression,
+  PLUGIN_VAR_OPCMDARG,
+  "Compress the pages of new ROW_FORMAT=DYNAMIC file-per-table tables"
+  " with innodb_compression_algorithm when writing them, and release"
+  " the unused end of each page with hole punching.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(log_compressed_pages, page_zip_log_pages,
        PLUGIN_VAR_OPCMDARG,
   "Enables/disables the logging of entire compressed page images."
@@ -15500,9 +16273,17 @@ can be removed and 8 used instead. The problem with the current setup is that
 with 128MiB default buffer pool size and 8 instances by default we would emit
 a warning when no options are specified. */
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
-  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  PLUGIN_VAR_RQCMDARG,
   "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
-  NULL, NULL, 128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+  innodb_buffer_pool_size_validate,
+  innodb_buffer_pool_size_update,
+  128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_chunk_size, srv_buf_pool_chunk_unit,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Size of the chunks in which the buffer pool is allocated, and grown or"
+  " shrunk when innodb_buffer_pool_size is changed.",
+  NULL, NULL, 128*1024*1024L, 1024*1024L, LONG_MAX, 1024*1024L);
 
 #if defined UNIV_DEBUG || defined UNIV_PERF_DEBUG
 static MYSQL_SYSVAR_ULONG(page_hash_locks, srv_n_page_hash_locks,
@@ -15521,6 +16302,28 @@ static MYSQL_SYSVAR_ULONG(buffer_pool_instances, srv_buf_pool_instances,
   "Number of buffer pool instances, set to higher value on high-end machines to increase scalability",
   NULL, NULL, SRV_BUF_POOL_INSTANCES_NOT_SET, 0, MAX_BUFFER_POOLS, 0);
 
+static MYSQL_SYSVAR_BOOL(numa_bind, srv_numa_bind,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Bind the memory of each buffer pool instance, and the threads that"
+  " serve it, to a NUMA node. The instances are spread round-robin"
+  " over the nodes.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONG(page_cleaners, srv_n_page_cleaners,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Page cleaner threads can be from 1 to 64. Default (0) is one thread per"
+  " buffer pool instance; the value is capped at innodb_buffer_pool_instances.",
+  NULL, NULL,
+  SRV_N_PAGE_CLEANERS_NOT_SET,	/* Default setting */
+  0,				/* Minimum value */
+  MAX_BUFFER_POOLS, 0);		/* Maximum value */
+
+static MYSQL_SYSVAR_ULONG(recovery_threads, srv_n_recovery_threads,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads reading the headers of .ibd files and applying redo"
+  " log records during crash recovery.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_STR(buffer_pool_filename, srv_buf_dump_filename,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
   "Filename to/from which to dump/load the InnoDB buffer pool",
@@ -15541,6 +16344,12 @@ static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
   "Dump only the hottest N% of each buffer pool, defaults to 100",
   NULL, NULL, 100, 1, 100, 0);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_pool_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the buffer pool into a file named @@innodb_buffer_pool_filename"
+  " every N seconds, 0 (the default) disables the periodic dumps",
+  NULL, innodb_buffer_pool_dump_interval_update, 0, 0, 86400, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   PLUGIN_VAR_RQCMDARG,
@@ -15648,11 +16457,46 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(sort_pll_degree, srv_sort_pll_degree,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that sort and merge index entries in index creation",
+  NULL, NULL, 2, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(fill_factor, srv_fill_factor,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of B-tree page filled during sorted index build",
+  NULL, NULL, 100, 10, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(parallel_read_threads, srv_parallel_read_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the clustered index for COUNT(*)"
+  " and CHECK TABLE; 1 reads it in the calling thread only",
+  NULL, NULL, 4, 1, 256, 0);
+
+static MYSQL_SYSVAR_BOOL(normalized_key_search, srv_normalized_key_search,
+  PLUGIN_VAR_OPCMDARG,
+  "Order the records in an index page search by a memcmp-comparable"
+  " prefix of the first key field where its collation allows it",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
   NULL, NULL, 128<<20, 65536, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(online_alter_apply_threads, srv_online_apply_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that apply the modification log of online"
+  " ALTER TABLE; 1 applies it in the ALTER TABLE thread only",
+  NULL, NULL, 4, 1, 256, 0);
+
+static MYSQL_SYSVAR_ULONG(online_alter_log_throttle, srv_online_log_throttle,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of innodb_sort_buffer_size blocks that the modification log"
+  " of online ALTER TABLE may be ahead of its apply before DML on the"
+  " table is delayed; 0 disables the delay",
+  NULL, NULL, 16, 0, 1024, 0);
+
 static MYSQL_SYSVAR_BOOL(optimize_fulltext_only, innodb_optimize_fulltext_only,
   PLUGIN_VAR_NOCMDARG,
   "Only optimize the Fulltext index of the table",
@@ -15691,6 +16535,12 @@ static MYSQL_SYSVAR_LONG(log_buffer_size, innobase_log_buffer_size,
   "The size of the buffer which InnoDB uses to write log to the log files on disk.",
   NULL, NULL, 8*1024*1024L, 256*1024L, LONG_MAX, 1024);
 
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Write and flush the redo log in dedicated threads that the committing"
+  " transactions wait for, instead of in the committing threads.",
+  NULL, NULL, TRUE);
+
 static MYSQL_SYSVAR_LONGLONG(log_file_size, innobase_log_file_size,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Size of each log file in a log group.",
@@ -15742,6 +16592,13 @@ static MYSQL_SYSVAR_ULONG(
   150000,			/* Default setting */
   0,				/* Minimum value */
   1000000, 0);			/* Maximum value */
+
+static MYSQL_SYSVAR_BOOL(adaptive_concurrency, srv_adaptive_concurrency,
+  PLUGIN_VAR_OPCMDARG,
+  "Adjust the number of threads admitted into InnoDB to the measured"
+  " throughput, separately for read-only and read-write threads."
+  " innodb_thread_concurrency is the upper limit.",
+  NULL, NULL, FALSE);
 #endif /* HAVE_ATOMIC_BUILTINS */
 
 static MYSQL_SYSVAR_ULONG(thread_sleep_delay, srv_thread_sleep_delay,
@@ -15784,6 +16641,21 @@ static MYSQL_SYSVAR_ULONG(undo_logs, srv_undo_logs,
   1,			/* Minimum value */
   TRX_SYS_N_RSEGS, 0);	/* Maximum value */
 
+static MYSQL_SYSVAR_BOOL(undo_log_truncate, srv_undo_log_truncate,
+  PLUGIN_VAR_OPCMDARG,
+  "Enable or disable the online truncation of undo tablespaces that grew"
+  " beyond innodb_max_undo_log_size.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONGLONG(max_undo_log_size, srv_max_undo_log_size,
+  PLUGIN_VAR_OPCMDARG,
+  "Size in bytes above which an undo tablespace is marked for truncation"
+  " when innodb_undo_log_truncate is enabled.",
+  NULL, NULL,
+  1024 * 1024 * 1024L,	/* Default setting */
+  10 * 1024 * 1024L,	/* Minimum value */
+  ~0ULL, 0);		/* Maximum value */
+
 /* Alias for innodb_undo_logs, this config variable is deprecated. */
 static MYSQL_SYSVAR_ULONG(rollback_segments, srv_undo_logs,
   PLUGIN_VAR_OPCMDARG,
@@ -15860,13 +16732,19 @@ static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
   innodb_change_buffering_update, "all");
 
 static MYSQL_SYSVAR_UINT(change_buffer_max_size,
-  innobase_change_buffer_max_size,
+  srv_change_buffer_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum on-disk size of change buffer in terms of percentage"
   " of the buffer pool.",
   NULL, innodb_change_buffer_max_size_update,
   CHANGE_BUFFER_DEFAULT_SIZE, 0, 50, 0);
 
+static MYSQL_SYSVAR_UINT(change_buffer_max_index_size, ibuf_max_index_pct,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum size of the changes buffered for one index in terms of"
+  " percentage of the maximum size of the change buffer.",
+  NULL, NULL, CHANGE_BUFFER_DEFAULT_INDEX_SIZE, 1, 100, 0);
+
 static MYSQL_SYSVAR_ENUM(stats_method, srv_innodb_stats_method,
    PLUGIN_VAR_RQCMDARG,
   "Specifies how InnoDB index statistics collection code should "
@@ -15927,6 +16805,12 @@ static MYSQL_SYSVAR_BOOL(print_all_deadlocks, srv_print_all_deadlocks,
   "Print all deadlocks to MySQL error log (off by default)",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_BOOL(deadlock_detect_async, srv_deadlock_detect_async,
+  PLUGIN_VAR_OPCMDARG,
+  "Detect deadlocks in a background thread instead of in the thread"
+  " that has to wait for a lock (off by default)",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(compression_failure_threshold_pct,
   zip_failure_threshold_pct, PLUGIN_VAR_OPCMDARG,
   "If the compression failure rate of a table is greater than this number"
@@ -15976,11 +16860,16 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(api_bk_commit_interval),
   MYSQL_SYSVAR(autoextend_increment),
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_chunk_size),
   MYSQL_SYSVAR(buffer_pool_instances),
+  MYSQL_SYSVAR(numa_bind),
+  MYSQL_SYSVAR(page_cleaners),
+  MYSQL_SYSVAR(recovery_threads),
   MYSQL_SYSVAR(buffer_pool_filename),
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
@@ -15994,10 +16883,13 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(commit_concurrency),
   MYSQL_SYSVAR(concurrency_tickets),
   MYSQL_SYSVAR(compression_level),
+  MYSQL_SYSVAR(compression_algorithm),
+  MYSQL_SYSVAR(page_compression),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_files),
   MYSQL_SYSVAR(api_enable_binlog),
   MYSQL_SYSVAR(api_enable_mdl),
   MYSQL_SYSVAR(api_disable_rowlock),
@@ -16028,8 +16920,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
+  MYSQL_SYSVAR(buffer_page_sample_rate),
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
+  MYSQL_SYSVAR(log_writer_threads),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_group_home_dir),
@@ -16056,21 +16950,31 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_transient_sample_pages),
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
+  MYSQL_SYSVAR(stats_histogram_buckets),
   MYSQL_SYSVAR(stats_auto_recalc),
   MYSQL_SYSVAR(adaptive_hash_index),
+  MYSQL_SYSVAR(adaptive_hash_index_parts),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(sort_pll_degree),
+  MYSQL_SYSVAR(fill_factor),
+  MYSQL_SYSVAR(parallel_read_threads),
+  MYSQL_SYSVAR(normalized_key_search),
   MYSQL_SYSVAR(online_alter_log_max_size),
+  MYSQL_SYSVAR(online_alter_apply_threads),
+  MYSQL_SYSVAR(online_alter_log_throttle),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
   MYSQL_SYSVAR(table_locks),
+  MYSQL_SYSVAR(scan_resistant),
   MYSQL_SYSVAR(thread_concurrency),
 #ifdef HAVE_ATOMIC_BUILTINS
   MYSQL_SYSVAR(adaptive_max_sleep_delay),
+  MYSQL_SYSVAR(adaptive_concurrency),
 #endif /* HAVE_ATOMIC_BUILTINS */
   MYSQL_SYSVAR(thread_sleep_delay),
   MYSQL_SYSVAR(autoinc_lock_mode),
@@ -16079,6 +16983,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(use_native_aio),
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
+  MYSQL_SYSVAR(change_buffer_max_index_size),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffering_debug),
   MYSQL_SYSVAR(disable_background_merge),
@@ -16104,11 +17009,14 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(doublewrite_batch_size),
 #endif /* defined UNIV_DEBUG || defined UNIV_PERF_DEBUG */
   MYSQL_SYSVAR(print_all_deadlocks),
+  MYSQL_SYSVAR(deadlock_detect_async),
   MYSQL_SYSVAR(cmp_per_index_enabled),
   MYSQL_SYSVAR(undo_logs),
   MYSQL_SYSVAR(rollback_segments),
   MYSQL_SYSVAR(undo_directory),
   MYSQL_SYSVAR(undo_tablespaces),
+  MYSQL_SYSVAR(undo_log_truncate),
+  MYSQL_SYSVAR(max_undo_log_size),
   MYSQL_SYSVAR(sync_array_size),
   MYSQL_SYSVAR(compression_failure_threshold_pct),
   MYSQL_SYSVAR(compression_pad_pct_max),
@@ -16147,6 +17055,7 @@ i_s_innodb_cmp_per_index,
 i_s_innodb_cmp_per_index_reset,
 i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
+i_s_innodb_buffer_page_summary,
 i_s_innodb_buffer_stats,
 i_s_innodb_temp_table_info,
 i_s_innodb_metrics,
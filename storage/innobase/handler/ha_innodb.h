@@ -25,6 +25,8 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "dict0stats.h"
 
+#include <vector>
+
 /* Structure defines translation table between mysql index and InnoDB
 index structures */
 struct innodb_idx_translate_t {
@@ -87,6 +89,13 @@ class ha_innobase: public handler
 					ROW_SEL_EXACT, ROW_SEL_EXACT_PREFIX,
 					or undefined */
 	uint		num_write_row;	/*!< number of write_row() calls */
+	mem_heap_t*	bulk_heap;	/*!< copies of the rows buffered by
+					write_row() between
+					start_bulk_insert() and
+					end_bulk_insert(), or NULL if rows
+					are not buffered */
+	std::vector<uchar*> bulk_rows;	/*!< the buffered rows */
+	ulint		bulk_size;	/*!< bytes used by the buffered rows */
 
 	uint store_key_val_for_row(uint keynr, char* buff, uint buff_len,
                                    const uchar* record);
@@ -101,6 +110,9 @@ class ha_innobase: public handler
 	dberr_t innobase_get_autoinc(ulonglong* value);
 	void innobase_initialize_autoinc();
 	dict_index_t* innobase_get_index(uint keynr);
+	int bulk_insert_row(const uchar* record);
+	int bulk_insert_flush();
+	void bulk_insert_free();
 
 	/* Init values for the class: */
  public:
@@ -129,6 +141,8 @@ class ha_innobase: public handler
 	double read_time(uint index, uint ranges, ha_rows rows);
 	longlong get_memory_buffer_size() const;
 
+	void start_bulk_insert(ha_rows rows);
+	int end_bulk_insert();
 	int write_row(uchar * buf);
 	int update_row(const uchar * old_data, uchar * new_data);
 	int delete_row(const uchar * buf);
@@ -143,6 +157,7 @@ class ha_innobase: public handler
 	int index_read_idx(uchar * buf, uint index, const uchar * key,
 			   uint key_len, enum ha_rkey_function find_flag);
 	int index_read_last(uchar * buf, const uchar * key, uint key_len);
+	void prefetch_key(const uchar * key, key_part_map keypart_map);
 	int index_next(uchar * buf);
 	int index_next_same(uchar * buf, const uchar *key, uint keylen);
 	int index_prev(uchar * buf);
@@ -152,6 +167,7 @@ class ha_innobase: public handler
 	int rnd_init(bool scan);
 	int rnd_end();
 	int rnd_next(uchar *buf);
+	int rnd_next_batch(uchar *buf, uint max_rows, uint *rows_read);
 	int rnd_pos(uchar * buf, uchar *pos);
 
 	int ft_init();
@@ -174,6 +190,7 @@ class ha_innobase: public handler
 	ha_rows records_in_range(uint inx, key_range *min_key, key_range
 								*max_key);
 	ha_rows estimate_rows_upper_bound();
+	double column_eq_selectivity(const Field* field);
 
 	void update_create_info(HA_CREATE_INFO* create_info);
 	int parse_table_name(const char*name,
@@ -186,6 +203,7 @@ class ha_innobase: public handler
 	int create(const char *name, register TABLE *form,
 					HA_CREATE_INFO *create_info);
 	int truncate();
+	int delete_all_rows();
 	int delete_table(const char *name);
 	int rename_table(const char* from, const char* to);
 	int check(THD* thd, HA_CHECK_OPT* check_opt);
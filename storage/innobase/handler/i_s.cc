@@ -51,6 +51,8 @@ Created July 18, 2007 Vasil Dimov
 #include "page0zip.h"
 #include "srv0space.h"
 
+#include <map>
+
 /** structure associates a name string with a file page type and/or buffer
 page state. */
 struct buf_page_desc_t{
@@ -2478,6 +2480,8 @@ i_s_metrics_fill(
 	DBUG_ENTER("i_s_metrics_fill");
 	fields = table_to_fill->field;
 
+	srv_mon_fold();
+
 	for (count = 0; count < NUM_MONITOR; count++) {
 		monitor_info = srv_mon_get_info((monitor_id_t) count);
 
@@ -5315,9 +5319,86 @@ i_s_innodb_buffer_page_get_info(
 	}
 }
 
+/*******************************************************************//**
+Collects the general information of a buffer pool block like
+i_s_innodb_buffer_page_get_info(), but without holding the buffer pool
+mutex or any latch on the block. The block can change while it is read,
+so that the fields may not be consistent with each other. This is
+tolerated because the control block and the frame of a block in a chunk
+stay allocated, and mapped to the same memory, as long as the buffer
+pool exists. */
+static
+void
+i_s_innodb_buffer_page_get_info_nolock(
+/*===================================*/
+	const buf_block_t*block,	/*!< in: buffer pool block to scan */
+	ulint		pool_id,	/*!< in: buffer pool id */
+	ulint		pos,		/*!< in: buffer block position in
+					buffer pool */
+	buf_page_info_t*page_info)	/*!< in: zero filled info structure;
+					out: structure filled with scanned
+					info */
+{
+	const buf_page_t*	bpage = &block->page;
+
+	ut_ad(pool_id < MAX_BUFFER_POOLS);
+
+	page_info->pool_id = pool_id;
+
+	page_info->block_id = pos;
+
+	/* Read the state and the I/O fix once; the checking accessors
+	would assert the consistency that is not guaranteed here */
+	page_info->page_state = bpage->state;
+
+	if (page_info->page_state != BUF_BLOCK_FILE_PAGE) {
+		/* A block of a chunk holds a file page only in the state
+		BUF_BLOCK_FILE_PAGE; the compressed-only states are for
+		control blocks outside of the chunks. */
+		page_info->page_type = I_S_PAGE_TYPE_UNKNOWN;
+		return;
+	}
+
+	page_info->space_id = bpage->space;
+
+	page_info->page_num = bpage->offset;
+
+	page_info->flush_type = bpage->flush_type;
+
+	page_info->fix_count = bpage->buf_fix_count;
+
+	page_info->newest_mod = bpage->newest_modification;
+
+	page_info->oldest_mod = bpage->oldest_modification;
+
+	page_info->access_time = bpage->access_time;
+
+	page_info->zip_ssize = bpage->zip.ssize;
+
+	page_info->io_fix = bpage->io_fix;
+
+	page_info->is_old = bpage->old;
+
+	page_info->freed_page_clock = bpage->freed_page_clock;
+
+	page_info->hashed = (block->index != NULL);
+
+	if (page_info->io_fix == BUF_IO_READ) {
+		/* The frame is being read from the file */
+		page_info->page_type = I_S_PAGE_TYPE_UNKNOWN;
+		return;
+	}
+
+	i_s_innodb_set_page_type(
+		page_info, fil_page_get_type(block->frame), block->frame);
+}
+
 /*******************************************************************//**
 This is the function that goes through each block of the buffer pool
 and fetch information to information schema tables: INNODB_BUFFER_PAGE.
+With a sample rate, only every sample_rate-th block of each chunk is
+read, and no mutex is held, so that the scan does not block the users of
+the buffer pool.
 @return 0 on success, 1 on failure */
 static
 int
@@ -5326,7 +5407,12 @@ i_s_innodb_fill_buffer_pool(
 	THD*			thd,		/*!< in: thread */
 	TABLE_LIST*		tables,		/*!< in/out: tables to fill */
 	buf_pool_t*		buf_pool,	/*!< in: buffer pool to scan */
-	const ulint		pool_id)	/*!< in: buffer pool id */
+	const ulint		pool_id,	/*!< in: buffer pool id */
+	const ulint		sample_rate)	/*!< in: read every
+						sample_rate-th block without
+						latching, or 0 to read all
+						the blocks under the buffer
+						pool mutex */
 {
 	int			status	= 0;
 	mem_heap_t*		heap;
@@ -5335,9 +5421,12 @@ i_s_innodb_fill_buffer_pool(
 
 	heap = mem_heap_create(10000);
 
-	/* Go through each chunk of buffer pool. Currently, we only
-	have one single chunk for each buffer pool */
-	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+	/* Keep buf_pool_resize() from freeing the chunks while they are
+	being read. */
+	buf_pool_chunks_pin();
+
+	/* Go through each chunk of buffer pool. */
+	for (ulint n = 0; n < buf_pool->n_chunks && status == 0; n++) {
 		const buf_block_t*	block;
 		ulint			n_blocks;
 		buf_page_info_t*	info_buffer;
@@ -5365,22 +5454,42 @@ i_s_innodb_fill_buffer_pool(
 			info_buffer = (buf_page_info_t*) mem_heap_zalloc(
 				heap, mem_size);
 
-			/* Obtain appropriate mutexes. Since this is diagnostic
-			buffer pool info printout, we are not required to
-			preserve the overall consistency, so we can
-			release mutex periodically */
-			buf_pool_mutex_enter(buf_pool);
-
-			/* GO through each block in the chunk */
-			for (n_blocks = num_to_process; n_blocks--; block++) {
-				i_s_innodb_buffer_page_get_info(
-					&block->page, pool_id, block_id,
-					info_buffer + num_page);
-				block_id++;
-				num_page++;
-			}
+			if (sample_rate > 0) {
+				/* Sample the blocks of the chunk without
+				any mutex */
+				for (n_blocks = num_to_process; n_blocks--;
+				     block++, block_id++) {
+
+					if (block_id % sample_rate != 0) {
+						continue;
+					}
+
+					i_s_innodb_buffer_page_get_info_nolock(
+						block, pool_id, block_id,
+						info_buffer + num_page);
+					num_page++;
+				}
+			} else {
+				/* Obtain appropriate mutexes. Since this is
+				diagnostic buffer pool info printout, we are
+				not required to preserve the overall
+				consistency, so we can release mutex
+				periodically */
+				buf_pool_mutex_enter(buf_pool);
+
+				/* GO through each block in the chunk */
+				for (n_blocks = num_to_process; n_blocks--;
+				     block++) {
+					i_s_innodb_buffer_page_get_info(
+						&block->page, pool_id,
+						block_id,
+						info_buffer + num_page);
+					block_id++;
+					num_page++;
+				}
 
-			buf_pool_mutex_exit(buf_pool);
+				buf_pool_mutex_exit(buf_pool);
+			}
 
 			/* Fill in information schema table with information
 			just collected from the buffer chunk scan */
@@ -5399,6 +5508,8 @@ i_s_innodb_fill_buffer_pool(
 		}
 	}
 
+	buf_pool_chunks_unpin();
+
 	mem_heap_free(heap);
 
 	DBUG_RETURN(status);
@@ -5417,6 +5528,7 @@ i_s_innodb_buffer_page_fill_table(
 	Item*		)		/*!< in: condition (ignored) */
 {
 	int	status	= 0;
+	ulint	sample_rate;
 
 	DBUG_ENTER("i_s_innodb_buffer_page_fill_table");
 
@@ -5427,6 +5539,8 @@ i_s_innodb_buffer_page_fill_table(
 		DBUG_RETURN(0);
 	}
 
+	sample_rate = thd_buffer_page_sample_rate(thd);
+
 	/* Walk through each buffer pool */
 	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
 		buf_pool_t*	buf_pool;
@@ -5435,7 +5549,8 @@ i_s_innodb_buffer_page_fill_table(
 
 		/* Fetch information from pages in this buffer pool,
 		and fill the corresponding I_S table */
-		status = i_s_innodb_fill_buffer_pool(thd, tables, buf_pool, i);
+		status = i_s_innodb_fill_buffer_pool(
+			thd, tables, buf_pool, i, sample_rate);
 
 		/* If something wrong, break and return */
 		if (status) {
@@ -6072,6 +6187,338 @@ struct st_mysql_plugin	i_s_innodb_buffer_page_lru =
 	STRUCT_FLD(flags, 0UL),
 };
 
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_BUFFER_PAGE_SUMMARY */
+static ST_FIELD_INFO	i_s_innodb_buffer_page_summary_fields_info[] =
+{
+#define IDX_BUF_SUMMARY_TABLE_NAME	0
+	{STRUCT_FLD(field_name,		"TABLE_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_INDEX_NAME	1
+	{STRUCT_FLD(field_name,		"INDEX_NAME"),
+	 STRUCT_FLD(field_length,	1024),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_INDEX_ID	2
+	{STRUCT_FLD(field_name,		"INDEX_ID"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_SPACE	3
+	{STRUCT_FLD(field_name,		"SPACE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_NUM_PAGES	4
+	{STRUCT_FLD(field_name,		"NUMBER_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_DIRTY_PAGES	5
+	{STRUCT_FLD(field_name,		"NUMBER_DIRTY_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_OLD_PAGES	6
+	{STRUCT_FLD(field_name,		"NUMBER_OLD_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_NUM_RECS	7
+	{STRUCT_FLD(field_name,		"NUMBER_RECORDS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_SUMMARY_DATA_SIZE	8
+	{STRUCT_FLD(field_name,		"DATA_SIZE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/** The pages of one index in the buffer pool */
+struct buf_index_summary_t {
+	ulint	space_id;	/*!< tablespace of the index */
+	ulint	n_pages;	/*!< number of pages */
+	ulint	n_dirty;	/*!< number of modified pages */
+	ulint	n_old;		/*!< number of pages in the old
+				blocks of the LRU list */
+	ulint	n_recs;		/*!< number of records on the pages */
+	ulint	data_size;	/*!< sum of the sizes of the records */
+};
+
+/** Summaries of the buffer pool pages, per index id */
+typedef std::map<index_id_t, buf_index_summary_t>	buf_index_summaries_t;
+
+/*******************************************************************//**
+Adds the index pages of a buffer pool instance to the per-index summaries.
+The blocks are read chunk by chunk without any mutex, as in the sampling
+mode of INNODB_BUFFER_PAGE, and only the counts are kept. */
+static
+void
+i_s_innodb_buffer_page_summarize(
+/*=============================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool to scan */
+	ulint			sample_rate,	/*!< in: read every
+						sample_rate-th block */
+	buf_index_summaries_t*	summaries)	/*!< in/out: per-index
+						summaries */
+{
+	ut_ad(sample_rate > 0);
+
+	buf_pool_chunks_pin();
+
+	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+		const buf_block_t*	blocks;
+		ulint			chunk_size;
+
+		blocks = buf_get_nth_chunk_block(buf_pool, n, &chunk_size);
+
+		for (ulint i = 0; i < chunk_size; i += sample_rate) {
+			buf_page_info_t	page_info;
+
+			memset(&page_info, 0, sizeof(page_info));
+
+			i_s_innodb_buffer_page_get_info_nolock(
+				blocks + i, 0, i, &page_info);
+
+			if (page_info.page_type != I_S_PAGE_TYPE_INDEX) {
+				continue;
+			}
+
+			buf_index_summary_t&	summary
+				= (*summaries)[page_info.index_id];
+
+			summary.space_id = page_info.space_id;
+			summary.n_pages++;
+			summary.n_dirty += (page_info.oldest_mod != 0);
+			summary.n_old += page_info.is_old;
+			summary.n_recs += page_info.num_recs;
+			summary.data_size += page_info.data_size;
+		}
+	}
+
+	buf_pool_chunks_unpin();
+}
+
+/*******************************************************************//**
+Fill the dynamic table INFORMATION_SCHEMA.INNODB_BUFFER_PAGE_SUMMARY with
+the number of buffer pool pages of each index. With
+innodb_buffer_page_sample_rate N > 1, every Nth block is read and the
+counts are estimates, scaled by N.
+@return 0 on success, 1 on failure */
+static
+int
+i_s_innodb_buffer_page_summary_fill_table(
+/*======================================*/
+	THD*		thd,		/*!< in: thread */
+	TABLE_LIST*	tables,		/*!< in/out: tables to fill */
+	Item*		)		/*!< in: condition (ignored) */
+{
+	TABLE*			table	= tables->table;
+	Field**			fields	= table->field;
+	buf_index_summaries_t	summaries;
+	ulint			sample_rate;
+
+	DBUG_ENTER("i_s_innodb_buffer_page_summary_fill_table");
+
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
+
+	/* deny access to user without PROCESS privilege */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	sample_rate = ut_max(thd_buffer_page_sample_rate(thd), 1UL);
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		i_s_innodb_buffer_page_summarize(
+			buf_pool_from_array(i), sample_rate, &summaries);
+	}
+
+	for (buf_index_summaries_t::const_iterator it = summaries.begin();
+	     it != summaries.end();
+	     ++it) {
+
+		const buf_index_summary_t&	summary = it->second;
+		const dict_index_t*		index;
+		char		table_name[MAX_FULL_NAME_LEN + 1];
+		const char*	table_name_end = NULL;
+		char		index_name[MAX_FULL_NAME_LEN + 1];
+
+		mutex_enter(&dict_sys->mutex);
+
+		index = dict_index_get_if_in_cache_low(it->first);
+
+		if (index != NULL) {
+			table_name_end = innobase_convert_name(
+				table_name, sizeof(table_name),
+				index->table_name,
+				strlen(index->table_name),
+				thd, TRUE);
+
+			ut_strlcpy(index_name, index->name,
+				   sizeof(index_name));
+		}
+
+		mutex_exit(&dict_sys->mutex);
+
+		if (table_name_end != NULL) {
+			OK(fields[IDX_BUF_SUMMARY_TABLE_NAME]->store(
+				table_name,
+				(uint) (table_name_end - table_name),
+				system_charset_info));
+			fields[IDX_BUF_SUMMARY_TABLE_NAME]->set_notnull();
+
+			OK(field_store_index_name(
+				fields[IDX_BUF_SUMMARY_INDEX_NAME],
+				index_name));
+		} else {
+			fields[IDX_BUF_SUMMARY_TABLE_NAME]->set_null();
+			fields[IDX_BUF_SUMMARY_INDEX_NAME]->set_null();
+		}
+
+		OK(fields[IDX_BUF_SUMMARY_INDEX_ID]->store(
+			(longlong) it->first, true));
+
+		OK(fields[IDX_BUF_SUMMARY_SPACE]->store(
+			(double) summary.space_id));
+
+		OK(fields[IDX_BUF_SUMMARY_NUM_PAGES]->store(
+			(double) (summary.n_pages * sample_rate)));
+
+		OK(fields[IDX_BUF_SUMMARY_DIRTY_PAGES]->store(
+			(double) (summary.n_dirty * sample_rate)));
+
+		OK(fields[IDX_BUF_SUMMARY_OLD_PAGES]->store(
+			(double) (summary.n_old * sample_rate)));
+
+		OK(fields[IDX_BUF_SUMMARY_NUM_RECS]->store(
+			(double) (summary.n_recs * sample_rate)));
+
+		OK(fields[IDX_BUF_SUMMARY_DATA_SIZE]->store(
+			(double) (summary.data_size * sample_rate)));
+
+		if (schema_table_store_record(thd, table)) {
+			DBUG_RETURN(1);
+		}
+	}
+
+	DBUG_RETURN(0);
+}
+
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_BUFFER_PAGE_SUMMARY.
+@return 0 on success, 1 on failure */
+static
+int
+i_s_innodb_buffer_page_summary_init(
+/*================================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("i_s_innodb_buffer_page_summary_init");
+
+	schema = reinterpret_cast<ST_SCHEMA_TABLE*>(p);
+
+	schema->fields_info = i_s_innodb_buffer_page_summary_fields_info;
+	schema->fill_table = i_s_innodb_buffer_page_summary_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+struct st_mysql_plugin	i_s_innodb_buffer_page_summary =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_BUFFER_PAGE_SUMMARY"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB Buffer Page Summary by Index"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_innodb_buffer_page_summary_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
+
 /*******************************************************************//**
 Unbind a dynamic INFORMATION_SCHEMA table.
 @return 0 on success */
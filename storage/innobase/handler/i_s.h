@@ -46,6 +46,7 @@ extern struct st_mysql_plugin	i_s_innodb_ft_index_table;
 extern struct st_mysql_plugin	i_s_innodb_ft_config;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page_lru;
+extern struct st_mysql_plugin	i_s_innodb_buffer_page_summary;
 extern struct st_mysql_plugin	i_s_innodb_buffer_stats;
 extern struct st_mysql_plugin	i_s_innodb_temp_table_info;
 extern struct st_mysql_plugin	i_s_innodb_sys_tables;
@@ -65,6 +65,8 @@ my_bool	srv_ibuf_disable_background_merge;
 #include "srv0space.h"
 #include "rem0cmp.h"
 
+#include <map>
+
 /*	STRUCTURE OF AN INSERT BUFFER RECORD
 
 In versions < 4.1.x:
@@ -197,6 +199,10 @@ access order rules. */
 /** Operations that can currently be buffered. */
 ibuf_use_t	ibuf_use		= IBUF_USE_ALL;
 
+/** Maximum size of the changes buffered for one index, in percentage
+of ibuf->max_size */
+uint	ibuf_max_index_pct	= CHANGE_BUFFER_DEFAULT_INDEX_SIZE;
+
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
 /** Flag to control insert buffer debugging. */
 uint	ibuf_debug;
@@ -293,6 +299,20 @@ static ib_mutex_t	ibuf_mutex;
 /** The mutex protecting the insert buffer bitmaps */
 static ib_mutex_t	ibuf_bitmap_mutex;
 
+/** Identifies the index of buffered changes: (space id, index id). The
+space id comes first so that all the indexes of a tablespace are adjacent. */
+typedef std::pair<ulint, index_id_t>		ibuf_index_key_t;
+
+/** Bytes of insert buffer records buffered since startup, per index */
+typedef std::map<ibuf_index_key_t, ulint>	ibuf_index_sizes_t;
+
+/** Sizes of the changes buffered for each index, protected by
+ibuf_index_size_mutex */
+static ibuf_index_sizes_t*	ibuf_index_sizes;
+
+/** The mutex protecting ibuf_index_sizes */
+static ib_mutex_t	ibuf_index_size_mutex;
+
 /** The area in pages from which contract looks for page numbers for merge */
 #define	IBUF_MERGE_AREA			8UL
 
@@ -305,6 +325,15 @@ page are merged along with the page whose buffer became full */
 batch, in order to merge the entries for them in the insert buffer */
 #define	IBUF_MAX_N_PAGES_MERGED		IBUF_MERGE_AREA
 
+/** Number of random positions of the insert buffer tree from which
+ibuf_merge_pages() picks the batch of pages that is most likely to be
+read soon */
+#define IBUF_MERGE_N_SAMPLES		4
+
+/** The area in pages around a merge candidate that is looked up in the
+buffer pool to estimate how soon the candidate will be read */
+#define IBUF_MERGE_HEAT_AREA		FSP_EXTENT_SIZE
+
 /** If the combined size of the ibuf trees exceeds ibuf->max_size by this
 many pages, we start to contract it in connection to inserts there, using
 non-synchronous contract */
@@ -469,6 +498,12 @@ ibuf_close(void)
 	mutex_free(&ibuf_bitmap_mutex);
 	memset(&ibuf_bitmap_mutex, 0x0, sizeof(ibuf_mutex));
 
+	mutex_free(&ibuf_index_size_mutex);
+	memset(&ibuf_index_size_mutex, 0x0, sizeof(ibuf_index_size_mutex));
+
+	delete ibuf_index_sizes;
+	ibuf_index_sizes = NULL;
+
 	mem_free(ibuf);
 	ibuf = NULL;
 }
@@ -527,6 +562,10 @@ ibuf_init_at_db_start(void)
 
 	mutex_create("ibuf_pessimistic_insert", &ibuf_pessimistic_insert_mutex);
 
+	mutex_create("ibuf_index_size", &ibuf_index_size_mutex);
+
+	ibuf_index_sizes = new ibuf_index_sizes_t();
+
 	mtr_start(&mtr);
 
 	mutex_enter(&ibuf_mutex);
@@ -603,6 +642,95 @@ ibuf_max_size_update(
 	mutex_exit(&ibuf_mutex);
 }
 
+/*********************************************************************//**
+Adjusts the size of the changes buffered for an index. Records that were
+buffered before the startup are not counted, so a decrement can exceed
+the counted size; the size then becomes 0. */
+static
+void
+ibuf_index_size_add(
+/*================*/
+	ulint		space,		/*!< in: space id of the index */
+	index_id_t	index_id,	/*!< in: index id */
+	lint		delta)		/*!< in: change of the size,
+					in bytes */
+{
+	ibuf_index_key_t	key(space, index_id);
+
+	mutex_enter(&ibuf_index_size_mutex);
+
+	ibuf_index_sizes_t::iterator	it = ibuf_index_sizes->find(key);
+
+	if (delta > 0) {
+		if (it == ibuf_index_sizes->end()) {
+			ibuf_index_sizes->insert(
+				ibuf_index_sizes_t::value_type(key, delta));
+		} else {
+			it->second += delta;
+		}
+	} else if (it != ibuf_index_sizes->end()) {
+		if (it->second > (ulint) -delta) {
+			it->second -= -delta;
+		} else {
+			ibuf_index_sizes->erase(it);
+		}
+	}
+
+	mutex_exit(&ibuf_index_size_mutex);
+}
+
+/*********************************************************************//**
+Forgets the sizes of the changes buffered for the indexes of a
+tablespace whose buffered changes were all discarded. */
+static
+void
+ibuf_index_size_discard(
+/*====================*/
+	ulint	space)	/*!< in: space id */
+{
+	mutex_enter(&ibuf_index_size_mutex);
+
+	ibuf_index_sizes->erase(
+		ibuf_index_sizes->lower_bound(ibuf_index_key_t(space, 0)),
+		ibuf_index_sizes->lower_bound(ibuf_index_key_t(space + 1, 0)));
+
+	mutex_exit(&ibuf_index_size_mutex);
+}
+
+/*********************************************************************//**
+Checks if an index already uses its share of the change buffer, which
+is innodb_change_buffer_max_index_size percent of ibuf->max_size.
+@return true if no more changes should be buffered for the index */
+static
+bool
+ibuf_index_too_big(
+/*===============*/
+	ulint		space,		/*!< in: space id of the index */
+	index_id_t	index_id)	/*!< in: index id */
+{
+	/* Dirty reads of the settable limit and of ibuf->max_size, as
+	in ibuf_insert_low() */
+	ulint	pct = ibuf_max_index_pct;
+
+	if (pct >= 100) {
+		return(false);
+	}
+
+	ulint	limit = ibuf->max_size * UNIV_PAGE_SIZE / 100 * pct;
+	bool	too_big;
+
+	mutex_enter(&ibuf_index_size_mutex);
+
+	ibuf_index_sizes_t::const_iterator	it = ibuf_index_sizes->find(
+		ibuf_index_key_t(space, index_id));
+
+	too_big = it != ibuf_index_sizes->end() && it->second >= limit;
+
+	mutex_exit(&ibuf_index_size_mutex);
+
+	return(too_big);
+}
+
 
 #endif /* !UNIV_HOTBACKUP */
 /*********************************************************************//**
@@ -2555,8 +2683,53 @@ ibuf_get_merge_pages(
 	return(volume);
 }
 
+/*********************************************************************//**
+Estimates how soon a page with buffered changes will be read, from the
+pages around it that are in the buffer pool. No latch protects the counts,
+they are only used as a heuristic.
+@return number of recently accessed pages near the page */
+static
+ulint
+ibuf_merge_area_heat(
+/*=================*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no)	/*!< in: page number */
+{
+	ulint	first_page_no = page_no - page_no % IBUF_MERGE_HEAT_AREA;
+	ulint	heat = 0;
+
+	for (ulint i = first_page_no;
+	     i < first_page_no + IBUF_MERGE_HEAT_AREA;
+	     i++) {
+
+		buf_pool_t*		buf_pool = buf_pool_get(space, i);
+		rw_lock_t*		hash_lock;
+		const buf_page_t*	bpage;
+
+		bpage = buf_page_hash_get_s_locked(
+			buf_pool, space, i, &hash_lock);
+
+		if (bpage == NULL) {
+			continue;
+		}
+
+		if (buf_page_is_accessed(bpage)
+		    && buf_page_peek_if_young(bpage)) {
+			heat++;
+		}
+
+		rw_lock_s_unlock(hash_lock);
+	}
+
+	return(heat);
+}
+
 /*********************************************************************//**
 Contracts insert buffer trees by reading pages to the buffer pool.
+Several random positions of the tree are looked at, and the pages of the
+position whose neighbourhood is the most recently accessed in the buffer
+pool are read, because these pages are the most likely to be read soon,
+which would merge their changes in the foreground.
 @return a lower limit for the combined size in bytes of entries which
 will be merged from ibuf trees to the pages read, 0 if ibuf is
 empty */
@@ -2571,48 +2744,83 @@ ibuf_merge_pages(
 {
 	mtr_t		mtr;
 	btr_pcur_t	pcur;
-	ulint		sum_sizes;
+	ulint		sum_sizes = 0;
+	ulint		best_heat = 0;
 	ulint		page_nos[IBUF_MAX_N_PAGES_MERGED];
 	ulint		space_ids[IBUF_MAX_N_PAGES_MERGED];
 	ib_int64_t	space_versions[IBUF_MAX_N_PAGES_MERGED];
 
 	*n_pages = 0;
 
-	ibuf_mtr_start(&mtr);
+	for (ulint i = 0; i < IBUF_MERGE_N_SAMPLES; i++) {
+		ulint		n_stored;
+		ulint		sizes;
+		ulint		heat;
+		ulint		pages[IBUF_MAX_N_PAGES_MERGED];
+		ulint		spaces[IBUF_MAX_N_PAGES_MERGED];
+		ib_int64_t	versions[IBUF_MAX_N_PAGES_MERGED];
+
+		ibuf_mtr_start(&mtr);
+
+		/* Open a cursor to a randomly chosen leaf of the tree, at a
+		random position within the leaf */
+
+		btr_pcur_open_at_rnd_pos(
+			ibuf->index, BTR_SEARCH_LEAF, &pcur, &mtr);
+
+		ut_ad(page_validate(btr_pcur_get_page(&pcur), ibuf->index));
+
+		if (page_is_empty(btr_pcur_get_page(&pcur))) {
+			/* If a B-tree page is empty, it must be the root
+			page and the whole B-tree must be empty. InnoDB
+			does not allow empty B-tree pages other than the
+			root. */
+			ut_ad(ibuf->empty);
+			ut_ad(page_get_space_id(btr_pcur_get_page(&pcur))
+			      == IBUF_SPACE_ID);
+			ut_ad(page_get_page_no(btr_pcur_get_page(&pcur))
+			      == FSP_IBUF_TREE_ROOT_PAGE_NO);
 
-	/* Open a cursor to a randomly chosen leaf of the tree, at a random
-	position within the leaf */
+			ibuf_mtr_commit(&mtr);
+			btr_pcur_close(&pcur);
 
-	btr_pcur_open_at_rnd_pos(ibuf->index, BTR_SEARCH_LEAF, &pcur, &mtr);
+			if (i == 0) {
+				return(0);
+			}
 
-	ut_ad(page_validate(btr_pcur_get_page(&pcur), ibuf->index));
+			/* The tree was emptied after the first sample */
+			break;
+		}
 
-	if (page_is_empty(btr_pcur_get_page(&pcur))) {
-		/* If a B-tree page is empty, it must be the root page
-		and the whole B-tree must be empty. InnoDB does not
-		allow empty B-tree pages other than the root. */
-		ut_ad(ibuf->empty);
-		ut_ad(page_get_space_id(btr_pcur_get_page(&pcur))
-		      == IBUF_SPACE_ID);
-		ut_ad(page_get_page_no(btr_pcur_get_page(&pcur))
-		      == FSP_IBUF_TREE_ROOT_PAGE_NO);
+		sizes = ibuf_get_merge_page_nos(TRUE,
+						btr_pcur_get_rec(&pcur), &mtr,
+						spaces, versions,
+						pages, &n_stored);
 
 		ibuf_mtr_commit(&mtr);
 		btr_pcur_close(&pcur);
 
-		return(0);
-	}
+		if (n_stored == 0) {
+			continue;
+		}
+
+		heat = ibuf_merge_area_heat(spaces[0], pages[0]);
+
+		if (*n_pages == 0 || heat > best_heat) {
+			memcpy(page_nos, pages, n_stored * sizeof(*pages));
+			memcpy(space_ids, spaces, n_stored * sizeof(*spaces));
+			memcpy(space_versions, versions,
+			       n_stored * sizeof(*versions));
 
-	sum_sizes = ibuf_get_merge_page_nos(TRUE,
-					    btr_pcur_get_rec(&pcur), &mtr,
-					    space_ids, space_versions,
-					    page_nos, n_pages);
+			*n_pages = n_stored;
+			sum_sizes = sizes;
+			best_heat = heat;
+		}
+	}
 #if 0 /* defined UNIV_IBUF_DEBUG */
 	fprintf(stderr, "Ibuf contract sync %lu pages %lu volume %lu\n",
 		sync, *n_pages, sum_sizes);
 #endif
-	ibuf_mtr_commit(&mtr);
-	btr_pcur_close(&pcur);
 
 	buf_read_ibuf_merge_pages(
 		sync, space_ids, space_versions, page_nos, *n_pages);
@@ -3475,6 +3683,7 @@ ibuf_insert_low(
 	ib_int64_t	space_versions[IBUF_MAX_N_PAGES_MERGED];
 	ulint		page_nos[IBUF_MAX_N_PAGES_MERGED];
 	ulint		n_stored;
+	ulint		ibuf_entry_size;
 	mtr_t		mtr;
 	mtr_t		bitmap_mtr;
 
@@ -3523,6 +3732,8 @@ ibuf_insert_low(
 		op, index, entry, space, page_no,
 		no_counter ? ULINT_UNDEFINED : 0xFFFF, heap);
 
+	ibuf_entry_size = dtuple_get_data_size(ibuf_entry, 0);
+
 	/* Open a cursor to the insert buffer tree to calculate if we can add
 	the new entry to it without exceeding the free space limit for the
 	page. */
@@ -3760,6 +3971,10 @@ func_exit:
 
 	mem_heap_free(heap);
 
+	if (err == DB_SUCCESS) {
+		ibuf_index_size_add(space, index->id, ibuf_entry_size);
+	}
+
 	if (err == DB_SUCCESS
 	    && BTR_LATCH_MODE_WITHOUT_INTENTION(mode) == BTR_MODIFY_TREE) {
 		ibuf_contract_after_insert(entry_size);
@@ -3894,6 +4109,12 @@ check_watch:
 	}
 
 skip_watch:
+	if (ibuf_index_too_big(space, index->id)) {
+		/* Leave the rest of the change buffer to the other
+		indexes; the change is applied to the page directly. */
+		DBUG_RETURN(FALSE);
+	}
+
 	entry_size = rec_get_converted_size(index, entry, 0);
 
 	if (entry_size
@@ -4555,6 +4776,8 @@ ibuf_merge_or_delete_for_page(
 	page_zip_des_t*	page_zip		= NULL;
 	ibool		tablespace_being_deleted = FALSE;
 	ibool		corruption_noticed	= FALSE;
+	index_id_t	index_id		= 0;
+	ulint		removed_size		= 0;
 	mtr_t		mtr;
 
 	/* Counts for merged & discarded operations. */
@@ -4697,6 +4920,8 @@ ibuf_merge_or_delete_for_page(
 				(ulong)
 				fil_page_get_type(block->frame));
 			ut_ad(0);
+		} else {
+			index_id = btr_page_get_index_id(block->frame);
 		}
 	}
 
@@ -4865,6 +5090,8 @@ loop:
 			dops[ibuf_rec_get_op_type(&mtr, rec)]++;
 		}
 
+		removed_size += rec_get_data_size_old(rec);
+
 		/* Delete the record from ibuf */
 		if (ibuf_delete_rec(space, page_no, &pcur, search_tuple,
 				    &mtr)) {
@@ -4912,6 +5139,12 @@ reset_bit:
 	btr_pcur_close(&pcur);
 	mem_heap_free(heap);
 
+	/* Without the page, the index of the discarded changes is not
+	known. It has been dropped, so its size is never looked up again. */
+	if (index_id != 0 && removed_size > 0) {
+		ibuf_index_size_add(space, index_id, -(lint) removed_size);
+	}
+
 #ifdef HAVE_ATOMIC_BUILTINS
 	os_atomic_increment_ulint(&ibuf->n_merges, 1);
 	ibuf_add_ops(ibuf->n_merged_ops, mops);
@@ -5018,6 +5251,8 @@ leave_loop:
 	ibuf_mtr_commit(&mtr);
 	btr_pcur_close(&pcur);
 
+	ibuf_index_size_discard(space);
+
 #ifdef HAVE_ATOMIC_BUILTINS
 	ibuf_add_ops(ibuf->n_discarded_ops, dops);
 #else /* HAVE_ATOMIC_BUILTINS */
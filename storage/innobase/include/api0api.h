@@ -416,6 +416,19 @@ typedef struct trx_t* ib_trx_t;
 /** InnoDB cursor handle */
 typedef struct ib_cursor_t* ib_crsr_t;
 
+/** Callback for each key searched for by ib_cursor_moveto_batch().
+@param ib_crsr	the cursor, positioned on the record of the key if found
+@param key_no	index of the key in the array passed to the search
+@param err	DB_SUCCESS if the key was found, otherwise the error of
+		the search
+@param arg	argument passed to the search
+@return DB_SUCCESS, or an error to stop the search */
+typedef ib_err_t (*ib_key_cb_t)(
+	ib_crsr_t		ib_crsr,
+	ib_ulint_t		key_no,
+	ib_err_t		err,
+	void*			arg);
+
 /*************************************************************//**
 This function is used to compare two data fields for which the data type
 is such that we must use the client code to compare them.
@@ -713,6 +726,24 @@ ib_cursor_moveto(
 	ib_tpl_t	ib_tpl,		/*!< in: Key to search for */
 	ib_srch_mode_t	ib_srch_mode);	/*!< in: search mode */
 
+/*****************************************************************//**
+Search for several keys with one cursor. The keys are searched for in
+ascending order. While the cursor is positioned on a record, a key that
+is not greater than the record, or that is equal to the next record, is
+resolved from that position without descending the index tree again.
+The callback is called for each key, in the order of the search, with
+the cursor positioned on the matching record if the key was found.
+@return DB_SUCCESS or the first error returned by the callback */
+
+ib_err_t
+ib_cursor_moveto_batch(
+/*===================*/
+	ib_crsr_t	ib_crsr,	/*!< in: InnoDB cursor instance */
+	ib_tpl_t*	ib_tpls,	/*!< in: keys to search for */
+	ib_ulint_t	n_keys,		/*!< in: number of keys */
+	ib_key_cb_t	key_cb,		/*!< in: callback for each key */
+	void*		arg);		/*!< in: argument for the callback */
+
 /*****************************************************************//**
 Set the match mode for ib_cursor_move(). */
 
@@ -0,0 +1,256 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+The B-tree bulk load
+
+Created 10/14/2013
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+#include "dict0dict.h"
+#include "page0cur.h"
+#include "mtr0mtr.h"
+
+#include <vector>
+
+/** One page of a B-tree level that is being filled by a bulk load.
+The page stays x-latched in its own mini-transaction, which generates
+no redo log, until it is full or the load finishes. */
+class PageBulk {
+public:
+	/**
+	Constructor
+	@param index		the index being built
+	@param trx_id		the transaction that builds the index
+	@param page_no		page number to fill, or FIL_NULL to
+				allocate a new page
+	@param level		B-tree level of the page */
+	PageBulk(
+		dict_index_t*	index,
+		trx_id_t	trx_id,
+		ulint		page_no,
+		ulint		level);
+
+	/**
+	Destructor */
+	~PageBulk();
+
+	/**
+	Allocate or latch the page and start the mini-transaction.
+	@return DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+	dberr_t init()
+		__attribute__((warn_unused_result));
+
+	/**
+	Append a tuple after the last record of the page.
+	@param tuple		the tuple to append; it must fit
+				(see is_space_available()) */
+	void insert(const dtuple_t* tuple);
+
+	/**
+	Append a copy of a record after the last record of the page.
+	@param rec		the record to copy
+	@param offsets		rec_get_offsets(rec, index) */
+	void insert(const rec_t* rec, ulint* offsets);
+
+	/**
+	Check whether a record fits on the page without exceeding the
+	fill factor.
+	@param rec_size		converted size of the record
+	@return true if the record should go on this page */
+	bool is_space_available(ulint rec_size) const;
+
+	/**
+	Build the node pointer for the page. The leftmost node pointer
+	of a level gets REC_INFO_MIN_REC_FLAG.
+	@param heap		memory heap for the node pointer
+	@return node pointer to the first record of the page */
+	dtuple_t* get_node_ptr(mem_heap_t* heap) const;
+
+	/**
+	Copy all the records of another page of the index to this page.
+	@param block		the x-latched source page */
+	void copy_in(const buf_block_t* block);
+
+	/**
+	Set the next page number.
+	@param next_page_no	next page number */
+	void set_next(ulint next_page_no);
+
+	/**
+	Set the previous page number.
+	@param prev_page_no	previous page number */
+	void set_prev(ulint prev_page_no);
+
+	/**
+	Commit the mini-transaction of a page that will not be
+	modified any more. */
+	void commit();
+
+	/**
+	Commit the mini-transaction temporarily, so that a log
+	checkpoint can flush the page. */
+	void release();
+
+	/**
+	Latch the page again after release(). */
+	void latch();
+
+	/**
+	@return the page number */
+	ulint page_no() const { return(m_page_no); }
+
+	/**
+	@return the B-tree level of the page */
+	ulint level() const { return(m_level); }
+
+private:
+	// Prevent copying
+	PageBulk(const PageBulk&);
+	PageBulk& operator=(const PageBulk&);
+
+private:
+	/** The index being built */
+	dict_index_t*	m_index;
+
+	/** The transaction that builds the index */
+	trx_id_t	m_trx_id;
+
+	/** Memory heap for converting records */
+	mem_heap_t*	m_heap;
+
+	/** Mini-transaction that holds the page latch */
+	mtr_t		m_mtr;
+
+	/** The page being filled */
+	buf_block_t*	m_block;
+
+	/** Cursor positioned on the last record of the page */
+	page_cur_t	m_cur;
+
+	/** Page number */
+	ulint		m_page_no;
+
+	/** B-tree level of the page */
+	ulint		m_level;
+
+	/** Free space in bytes that is left on a full page */
+	ulint		m_reserved_space;
+};
+
+/** Builds a B-tree from tuples that arrive in ascending order. Leaf
+pages are filled one after another up to innodb_fill_factor, and a node
+pointer is appended to the level above whenever a page is full, so that
+the whole tree is built bottom-up without any descents or page splits.
+The pages are not redo logged; they are written out when the load
+finishes. */
+class BtrBulk {
+public:
+	/**
+	Constructor
+	@param index		the empty index to load
+	@param trx		the transaction that builds the index */
+	BtrBulk(dict_index_t* index, const trx_t* trx)
+		:
+		m_index(index),
+		m_trx(trx)
+	{
+	}
+
+	/**
+	Destructor */
+	~BtrBulk();
+
+	/**
+	Check whether an index can be loaded in bulk. The loader does not
+	handle compressed pages nor records that need off-page columns,
+	and it avoids flushing the whole system tablespace.
+	@param index		the index to check
+	@return true if BtrBulk can build the index */
+	static bool is_supported(const dict_index_t* index)
+		__attribute__((warn_unused_result));
+
+	/**
+	Append a leaf record.
+	@param tuple		tuple that is greater than all previously
+				inserted ones
+	@return DB_SUCCESS or error code */
+	dberr_t insert(dtuple_t* tuple)
+		__attribute__((warn_unused_result))
+	{
+		return(insert(tuple, 0));
+	}
+
+	/**
+	Commit the last page of each level, move the top level to the
+	root page and write the pages to disk.
+	@param err		error status of the load so far
+	@return DB_SUCCESS or error code */
+	dberr_t finish(dberr_t err)
+		__attribute__((warn_unused_result));
+
+private:
+	/**
+	Append a record to a level of the tree.
+	@param tuple		the record to append
+	@param level		the B-tree level
+	@return DB_SUCCESS or error code */
+	dberr_t insert(dtuple_t* tuple, ulint level)
+		__attribute__((warn_unused_result));
+
+	/**
+	Commit a page and optionally add its node pointer to the level
+	above.
+	@param page_bulk	the page to commit
+	@param next_page_bulk	the right sibling, or NULL
+	@param insert_father	whether to insert the node pointer
+	@return DB_SUCCESS or error code */
+	dberr_t page_commit(
+		PageBulk*	page_bulk,
+		PageBulk*	next_page_bulk,
+		bool		insert_father)
+		__attribute__((warn_unused_result));
+
+	/**
+	Release all the page latches for the duration of log_free_check()
+	if a log checkpoint is needed. */
+	void log_free_check();
+
+	// Prevent copying
+	BtrBulk(const BtrBulk&);
+	BtrBulk& operator=(const BtrBulk&);
+
+private:
+	typedef std::vector<PageBulk*> page_bulks_t;
+
+	/** The index being built */
+	dict_index_t*	m_index;
+
+	/** The transaction that builds the index */
+	const trx_t*	m_trx;
+
+	/** The page being filled on each level, leaf level first */
+	page_bulks_t	m_page_bulks;
+};
+
+#endif /* btr0bulk_h */
@@ -33,6 +33,7 @@ Created 2/17/1996 Heikki Tuuri
 #include "btr0types.h"
 #include "mtr0mtr.h"
 #include "ha0ha.h"
+#include "ut0counter.h"
 
 /*****************************************************************//**
 Creates and initializes the adaptive search system at a database start. */
@@ -42,6 +43,14 @@ btr_search_sys_create(
 /*==================*/
 	ulint	hash_size);	/*!< in: hash index hash table size */
 /*****************************************************************//**
+Resizes the hash tables of the adaptive search system, if the adaptive
+hash index is disabled. */
+
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
+/*****************************************************************//**
 Frees the adaptive search system at a database shutdown. */
 
 void
@@ -79,14 +88,15 @@ btr_search_info_create(
 /*===================*/
 	mem_heap_t*	heap);	/*!< in: heap where created */
 /*****************************************************************//**
-Returns the value of ref_count. The value is protected by
-btr_search_latch.
+Returns the value of ref_count. The value is protected by the
+adaptive hash index partition latch of the index.
 @return ref_count value. */
 
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info);	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index);	/*!< in: index */
 /*********************************************************************//**
 Updates the search info. */
 UNIV_INLINE
@@ -112,7 +122,8 @@ btr_search_guess_on_hash(
 	ulint		latch_mode,	/*!< in: BTR_SEARCH_LEAF, ... */
 	btr_cur_t*	cursor,		/*!< out: tree cursor */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the adaptive
+					hash index partition latch of index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr);		/*!< in: mtr */
 /********************************************************************//**
@@ -193,12 +204,81 @@ btr_search_validate(void);
 # define btr_search_validate()	TRUE
 #endif /* defined UNIV_AHI_DEBUG || defined UNIV_DEBUG */
 
+/********************************************************************//**
+Prints the adaptive hash index partition statistics for
+SHOW ENGINE INNODB STATUS. */
+
+void
+btr_search_print_info(
+/*==================*/
+	FILE*	file);	/*!< in: file where to print */
+
+/********************************************************************//**
+Returns the adaptive hash index partition number of an index.
+@return partition number, 0 .. btr_ahi_parts - 1 */
+UNIV_INLINE
+ulint
+btr_search_get_part_no(
+/*===================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, pure, warn_unused_result));
+/********************************************************************//**
+Returns the latch protecting the adaptive hash index partition of an index.
+@return partition latch */
+UNIV_INLINE
+rw_lock_t*
+btr_get_search_latch(
+/*=================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, pure, warn_unused_result));
+/********************************************************************//**
+Returns the adaptive hash index partition hash table of an index.
+@return partition hash table */
+UNIV_INLINE
+hash_table_t*
+btr_get_search_table(
+/*=================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, pure, warn_unused_result));
+/********************************************************************//**
+X-latches all the adaptive hash index partitions. */
+UNIV_INLINE
+void
+btr_search_x_lock_all(void);
+/*========================*/
+/********************************************************************//**
+Releases the X-latches on all the adaptive hash index partitions. */
+UNIV_INLINE
+void
+btr_search_x_unlock_all(void);
+/*==========================*/
+#ifdef UNIV_SYNC_DEBUG
+/********************************************************************//**
+Checks if the thread owns all the adaptive hash index partition latches
+in the given mode.
+@return true if all the latches are owned */
+UNIV_INLINE
+bool
+btr_search_own_all(
+/*===============*/
+	ulint	mode);	/*!< in: RW_LOCK_S or RW_LOCK_X */
+/********************************************************************//**
+Checks if the thread owns any of the adaptive hash index partition
+latches in the given mode.
+@return true if any of the latches is owned */
+UNIV_INLINE
+bool
+btr_search_own_any(
+/*===============*/
+	ulint	mode);	/*!< in: RW_LOCK_S or RW_LOCK_X */
+#endif /* UNIV_SYNC_DEBUG */
+
 /** The search info struct in an index */
 struct btr_search_t{
 	ulint	ref_count;	/*!< Number of blocks in this index tree
 				that have search index built
 				i.e. block->index points to this index.
-				Protected by btr_search_latch except
+				Protected by the partition latch except
 				when during initialization in
 				btr_search_info_create(). */
 
@@ -245,11 +325,25 @@ struct btr_search_t{
 #endif /* UNIV_DEBUG */
 };
 
+/** Statistics of one adaptive hash index partition. The counters are
+updated without any latch, so they are approximate. Each instance is
+padded to its own cache line. */
+struct btr_search_part_stats_t{
+	ulint		n_hits;		/*!< successful hash searches */
+	ulint		n_misses;	/*!< failed hash searches */
+	byte		pad[CACHE_LINE_SIZE - 2 * sizeof(ulint)];
+};
+
 /** The hash index system */
 struct btr_search_sys_t{
-	hash_table_t*	hash_index;	/*!< the adaptive hash index,
+	hash_table_t**	hash_tables;	/*!< the adaptive hash index
+					partitions, btr_ahi_parts of them,
 					mapping dtuple_fold values
-					to rec_t pointers on index pages */
+					to rec_t pointers on index pages;
+					hash_tables[i] is protected by
+					btr_search_latches[i] */
+	btr_search_part_stats_t*
+			part_stats;	/*!< per partition statistics */
 };
 
 /** The adaptive hash index */
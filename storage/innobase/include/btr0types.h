@@ -53,18 +53,20 @@ but does NOT protect:
 (4) next or previous records on the same page.
 
 Bear in mind (3) and (4) when using the hash index.
-*/
-extern rw_lock_t*	btr_search_latch_temp;
 
-#endif /* UNIV_HOTBACKUP */
+The adaptive hash index is partitioned by index id: there are
+btr_ahi_parts latches, each protecting its own hash table. */
+extern rw_lock_t**	btr_search_latches;
 
-/** The latch protecting the adaptive search system */
-#define btr_search_latch	(*btr_search_latch_temp)
+#endif /* UNIV_HOTBACKUP */
 
 /** Flag: has the search system been enabled?
-Protected by btr_search_latch. */
+Protected by all the btr_search_latches. */
 extern char	btr_search_enabled;
 
+/** Number of adaptive hash index partitions */
+extern ulong	btr_ahi_parts;
+
 #ifdef UNIV_BLOB_DEBUG
 # include "buf0types.h"
 /** An index->blobs entry for keeping track of off-page column references */
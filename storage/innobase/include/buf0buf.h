@@ -38,6 +38,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "ut0rbt.h"
 #include "os0proc.h"
 #include "log0log.h"
+#include "ut0counter.h"
 #include "srv0srv.h"
 
 /** @name Modes for buf_page_get_gen */
@@ -86,6 +87,12 @@ Created 11/5/1995 Heikki Tuuri
 
 extern	buf_pool_t*	buf_pool_ptr;	/*!< The buffer pools
 					of the database */
+extern volatile bool	buf_pool_withdrawing; /*!< true while
+					buf_pool_resize() is withdrawing
+					blocks from the buffer pool */
+extern volatile ulint	buf_withdraw_clock; /*!< incremented each
+					time buf_pool_resize() has removed
+					chunks from a buffer pool instance */
 #else /* !UNIV_HOTBACKUP */
 extern buf_block_t*	back_block1;	/*!< first block, for --apply-log */
 extern buf_block_t*	back_block2;	/*!< second block, for page reorganize */
@@ -236,6 +243,46 @@ buf_pool_free(
 /*==========*/
 	ulint	n_instances);	/*!< in: numbere of instances to free */
 
+/********************************************************************//**
+Rounds a buffer pool size up to a multiple of
+innodb_buffer_pool_chunk_size times innodb_buffer_pool_instances, the
+unit in which buf_pool_resize() grows and shrinks the buffer pool.
+@return size in bytes */
+
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size);	/*!< in: size in bytes */
+
+/********************************************************************//**
+This is the thread which resizes the buffer pool to
+innodb_buffer_pool_size when it is signalled through
+srv_buf_resize_event.
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
+/********************************************************************//**
+Prevents buf_pool_resize() from freeing any chunk of the buffer pool,
+for a caller that reads the blocks of buf_pool->chunks[] without holding
+buf_pool->mutex.  Must be followed by buf_pool_chunks_unpin(). */
+
+void
+buf_pool_chunks_pin(void);
+/*=====================*/
+
+/********************************************************************//**
+Allows buf_pool_resize() to free chunks again, see
+buf_pool_chunks_pin(). */
+
+void
+buf_pool_chunks_unpin(void);
+/*=======================*/
+
 /********************************************************************//**
 Clears the adaptive hash index on all pages in the buffer pool. */
 
@@ -485,6 +532,20 @@ buf_page_make_young(
 /*================*/
 	buf_page_t*	bpage);	/*!< in: buffer block of a file page */
 /********************************************************************//**
+Moves a page which a scan-resistant scan is done with to the end of the
+buffer pool LRU list, so that its frame is the next one to be replaced,
+unless the page was accessed before the scan started, or has been made
+young since.
+@return TRUE if the page was moved */
+
+ibool
+buf_page_release_scanned(
+/*=====================*/
+	ulint		space,		/*!< in: space id */
+	ulint		offset,		/*!< in: page number */
+	unsigned	scan_start);	/*!< in: ut_time_ms() when the
+					scan started */
+/********************************************************************//**
 Returns TRUE if the page can be found in the buffer pool hash table.
 
 NOTE that it is possible that the page is not yet read from disk,
@@ -1020,7 +1081,7 @@ buf_page_is_accessed(
 	const buf_page_t*	bpage)	/*!< in: control block */
 	__attribute__((nonnull, pure));
 /*********************************************************************//**
-Flag a block accessed. */
+Flag a block accessed and count the access. */
 UNIV_INLINE
 void
 buf_page_set_accessed(
@@ -1028,6 +1089,17 @@ buf_page_set_accessed(
 	buf_page_t*	bpage)		/*!< in/out: control block */
 	__attribute__((nonnull));
 /*********************************************************************//**
+Get the number of accesses to a block since it was read into the buffer
+pool. This is only a heuristic value; it may be read without holding the
+block mutex.
+@return number of accesses */
+UNIV_INLINE
+unsigned
+buf_page_get_access_count(
+/*======================*/
+	const buf_page_t*	bpage)	/*!< in: control block */
+	__attribute__((nonnull, pure));
+/*********************************************************************//**
 Gets the buf_block_t handle of a buffered file block if an uncompressed
 page frame exists, or NULL. Note: even though bpage is not declared a
 const we don't update its value. It is safe to make this pure.
@@ -1408,6 +1480,28 @@ buf_get_nth_chunk_block(
 	const buf_pool_t* buf_pool,	/*!< in: buffer pool instance */
 	ulint		n,		/*!< in: nth chunk in the buffer pool */
 	ulint*		chunk_size);	/*!< in: chunk size */
+/*********************************************************************//**
+Determines if a block, or a frame, belongs to one of the chunks that
+buf_pool_resize() is removing from a buffer pool instance.  Such blocks
+are put on buf_pool->withdraw instead of buf_pool->free when freed.
+@return true if ptr will be withdrawn */
+UNIV_INLINE
+bool
+buf_pool_will_withdraw(
+/*===================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const void*		ptr);		/*!< in: pointer to a block
+						or a frame, not dereferenced */
+/*********************************************************************//**
+Determines if a block pointer that was saved while
+buf_withdraw_clock had the given value may point to memory that
+buf_pool_resize() has freed since then.
+@return true if the saved block pointer must not be dereferenced */
+UNIV_INLINE
+bool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock);	/*!< in: saved buf_withdraw_clock */
 
 /********************************************************************//**
 Calculate the checksum of a page from compressed table and update the page. */
@@ -1585,6 +1679,11 @@ struct buf_page_t{
 					0 if the block was never accessed
 					in the buffer pool. Protected by
 					block mutex */
+	unsigned	access_count;	/*!< number of accesses since the
+					page was read into the buffer pool,
+					saturating at ULINT32_MASK; stored
+					as a hotness hint in buffer pool
+					dumps. Protected by block mutex */
 # if defined UNIV_DEBUG_FILE_ACCESSES || defined UNIV_DEBUG
 	ibool		file_page_was_freed;
 					/*!< this is set to TRUE when
@@ -1677,7 +1776,8 @@ struct buf_block_t{
 
 	/** @name Hash search fields
 	These 5 fields may only be modified when we have
-	an x-latch on btr_search_latch AND
+	an x-latch on the btr_search_latches partition of
+	the index AND
 	- we are holding an s-latch or x-latch on buf_block_t::lock or
 	- we know that buf_block_t::buf_fix_count == 0.
 
@@ -1685,7 +1785,7 @@ struct buf_block_t{
 	in the buffer pool in buf0buf.cc.
 
 	Another exception is that assigning block->index = NULL
-	is allowed whenever holding an x-latch on btr_search_latch. */
+	is allowed whenever holding an x-latch on the partition latch. */
 
 	/* @{ */
 
@@ -1884,12 +1984,14 @@ struct buf_buddy_free_t {
 
 /** @brief The buffer pool statistics structure. */
 struct buf_pool_stat_t{
-	ulint	n_page_gets;	/*!< number of page gets performed;
+	ib_counter_t<ulint, IB_N_SLOTS>
+		n_page_gets;	/*!< number of page gets performed;
 				also successful searches through
 				the adaptive hash index are
 				counted as page gets; this field
 				is NOT protected by the buffer
-				pool mutex */
+				pool mutex, and it is split into
+				per-CPU slots */
 	ulint	n_pages_read;	/*!< number read operations */
 	ulint	n_pages_written;/*!< number write operations */
 	ulint	n_pages_created;/*!< number of pages created
@@ -1949,7 +2051,18 @@ struct buf_pool_t{
 	ulint		mutex_exit_forbidden; /*!< Forbid release mutex */
 #endif
 	ulint		n_chunks;	/*!< number of buffer pool chunks */
-	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
+	ulint		n_chunks_new;	/*!< number of buffer pool chunks
+					once buf_pool_resize() has withdrawn
+					the blocks of chunks[n_chunks_new]
+					to chunks[n_chunks - 1]; equal to
+					n_chunks when not shrinking */
+	buf_chunk_t*	chunks;		/*!< buffer pool chunks; the array
+					is replaced, never modified, when
+					chunks are added, so that it can be
+					read without holding the mutex */
+	buf_chunk_t*	chunks_old;	/*!< the chunks array replaced by
+					the latest growth of this instance,
+					freed by the next resize */
 	ulint		curr_size;	/*!< current pool size in pages */
 	hash_table_t*	page_hash;	/*!< hash table of buf_page_t or
 					buf_block_t file pages,
@@ -2052,6 +2165,19 @@ struct buf_pool_t{
 					/*!< base node of the free
 					block list */
 
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the list of the
+					free blocks that buf_pool_resize()
+					has withdrawn from the chunks it is
+					removing */
+	ulint		withdraw_target;/*!< number of blocks to withdraw,
+					0 when not shrinking */
+
+	/** "hazard pointer" used by buf_pool_resize() to scan the LRU
+	list for pages in the chunks being removed.
+	Protected by buf_pool::mutex */
+	LRUHp		withdraw_hp;
+
 	/** "hazard pointer" used during scan of LRU while doing
 	LRU list batch.  Protected by buf_pool::mutex */
 	LRUHp		lru_hp;
@@ -29,10 +29,11 @@ Created 2011/12/19 Inaam Rana
 #include "univ.i"
 #include "ut0byte.h"
 #include "log0log.h"
+#include "buf0types.h"
 
 #ifndef UNIV_HOTBACKUP
 
-/** Doublewrite system */
+/** Doublewrite system of the system tablespace */
 extern buf_dblwr_t*	buf_dblwr;
 /** Set to TRUE when the doublewrite buffer is being created */
 extern ibool		buf_dblwr_being_created;
@@ -97,8 +98,12 @@ and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
 
 void
-buf_dblwr_flush_buffered_writes(void);
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	const buf_pool_t*	buf_pool);	/*!< in: flush only the
+					doublewrite buffer used by this
+					buffer pool instance, or NULL to
+					flush all doublewrite buffers */
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -121,6 +126,11 @@ struct buf_dblwr_t{
 	ulint		block1;	/*!< the page number of the first
 				doublewrite block (64 pages) */
 	ulint		block2;	/*!< page number of the second block */
+	char*		file_name;/*!< name of the doublewrite file, or
+				NULL if the pages are written to block1
+				and block2 of the system tablespace */
+	os_file_t	file;	/*!< handle to the doublewrite file,
+				if file_name != NULL */
 	ulint		first_free;/*!< first free position in write_buf
 				measured in units of UNIV_PAGE_SIZE */
 	ulint		b_reserved;/*!< number of slots currently reserved
@@ -36,6 +36,10 @@ Created 11/5/1995 Heikki Tuuri
 /** Flag indicating if the page_cleaner is in active state. */
 extern ibool buf_page_cleaner_is_active;
 
+/** Number of LRU manager threads that are alive. While it is nonzero,
+user threads leave the LRU flushing to the LRU managers. */
+extern volatile ulint buf_lru_manager_n_threads;
+
 /** Event to synchronise with the flushing. */
 extern os_event_t	buf_flush_event;
 
@@ -177,15 +181,68 @@ buf_flush_ready_for_replace(
 	buf_page_t*	bpage);	/*!< in: buffer control block, must be
 				buf_page_in_file(bpage) and in the LRU list */
 /******************************************************************//**
-page_cleaner thread tasked with flushing dirty pages from the buffer
-pools. As of now we'll have only one instance of this thread.
+Initialize page_cleaner. Must be called before the page_cleaner
+coordinator and worker threads are created. */
+
+void
+buf_flush_page_cleaner_init(void);
+/*=============================*/
+/******************************************************************//**
+page_cleaner coordinator thread tasked with flushing dirty pages from
+the buffer pools. It distributes the work over the page_cleaner worker
+threads and flushes buffer pool instances itself as well.
 @return a dummy parameter */
 extern "C"
 os_thread_ret_t
-DECLARE_THREAD(buf_flush_page_cleaner_thread)(
+DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
+/*===============================================*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
+/******************************************************************//**
+Worker thread of page_cleaner. Flushes the buffer pool instances
+requested by the coordinator.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_flush_page_cleaner_worker)(
 /*==========================================*/
 	void*	arg);		/*!< in: a dummy parameter required by
 				os_thread_create */
+/******************************************************************//**
+Initialize the LRU managers. Must be called before the LRU manager
+threads are created. */
+
+void
+buf_flush_lru_manager_init(void);
+/*============================*/
+/******************************************************************//**
+Returns the LRU manager slot for a buffer pool instance, to be passed to
+buf_flush_lru_manager_thread().
+@return LRU manager slot */
+
+void*
+buf_flush_lru_manager_get_slot(
+/*===========================*/
+	ulint	i);	/*!< in: buffer pool instance number */
+/******************************************************************//**
+Wakes up the LRU manager of a buffer pool instance whose free list was
+found empty. */
+
+void
+buf_flush_lru_manager_wakeup(
+/*=========================*/
+	const buf_pool_t*	buf_pool);	/*!< in: buffer pool instance */
+/******************************************************************//**
+LRU manager thread of one buffer pool instance. It keeps
+innodb_LRU_scan_depth pages in the free list, so that user threads do not
+have to scan the LRU or flush pages themselves to find a free block.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_flush_lru_manager_thread)(
+/*=========================================*/
+	void*	arg);	/*!< in: LRU manager slot, see
+			buf_flush_lru_manager_get_slot() */
 /*********************************************************************//**
 Clears up tail of the LRU lists:
 * Put replaceable pages at the tail of LRU to the free list
@@ -210,6 +210,15 @@ buf_LRU_old_ratio_update(
 	ibool	adjust);/*!< in: TRUE=adjust the LRU list;
 			FALSE=just assign buf_pool->LRU_old_ratio
 			during the initialization of InnoDB */
+/**********************************************************************//**
+Determines if a scan of the given number of pages would replace all the
+"old" blocks of the LRU lists, so that it should be scan-resistant.
+@return TRUE if the scan should be scan-resistant */
+
+ibool
+buf_LRU_scan_is_large(
+/*==================*/
+	ulint	n_pages);	/*!< in: number of pages to scan */
 /********************************************************************//**
 Update the historical stats that we are collecting for LRU eviction
 policy at the end of each interval. */
@@ -55,6 +55,17 @@ buf_read_page_async(
 	ulint	space,	/*!< in: space id */
 	ulint	offset);/*!< in: page number */
 /********************************************************************//**
+Queues an asynchronous read of a page into buf_pool if it is not already
+there, and returns without waiting for the read to complete.
+@return TRUE if a read request was queued */
+
+ibool
+buf_read_page_background(
+/*=====================*/
+	ulint	space,	/*!< in: space id */
+	ulint	zip_size,/*!< in: compressed page size in bytes, or 0 */
+	ulint	offset);/*!< in: page number */
+/********************************************************************//**
 Applies a random read-ahead in buf_pool if there are at least a threshold
 value of accessed pages from the random read-ahead area. Does not read any
 page, not even the one at the position (space, offset), if the read-ahead
@@ -1582,7 +1582,9 @@ struct dict_sys_t{
 					recovery this must be derived from
 					the log records */
 	hash_table_t*	table_hash;	/*!< hash table of the tables, based
-					on name */
+					on name; modified while holding both
+					the mutex and the rw-lock of the
+					cell in exclusive mode */
 	hash_table_t*	table_id_hash;	/*!< hash table of the tables, based
 					on id */
 	ulint		size;		/*!< varying space in bytes occupied
@@ -1781,6 +1783,17 @@ dict_table_is_temporary(
 	const dict_table_t*	table)	/*!< in: table to check */
 	__attribute__((nonnull, pure, warn_unused_result));
 
+/********************************************************************//**
+Check if it is an intrinsic table, that is, an internal temporary table
+of the optimizer.
+@return true if intrinsic table flag is set. */
+UNIV_INLINE
+bool
+dict_table_is_intrinsic(
+/*====================*/
+	const dict_table_t*	table)	/*!< in: table to check */
+	__attribute__((nonnull, pure, warn_unused_result));
+
 /********************************************************************//**
 Turn-off redo-logging if temporary table. */
 UNIV_INLINE
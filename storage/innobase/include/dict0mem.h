@@ -118,12 +118,24 @@ innodb-file-per-table, an older engine will not be able to find that table.
 This flag prevents older engines from attempting to open the table and
 allows InnoDB to update_create_info() accordingly. */
 #define DICT_TF_WIDTH_DATA_DIR		1
+/** Width of the ZIP_ALGORITHM flag.  This is the page_zip_algorithm_t
+that compresses the pages of a ROW_FORMAT=COMPRESSED table.  It is 0
+(zlib) for all other tables, so that their flags stay the same as in
+older engines. */
+#define DICT_TF_WIDTH_ZIP_ALGORITHM	2
+/** Width of the PAGE_COMPRESSION flag.  If this is set, the pages of a
+ROW_FORMAT=DYNAMIC file-per-table tablespace are compressed with the
+ZIP_ALGORITHM when they are written, and the unused end of each page is
+released from the file. */
+#define DICT_TF_WIDTH_PAGE_COMPRESSION	1
 
 /** Width of all the currently known table flags */
 #define DICT_TF_BITS	(DICT_TF_WIDTH_COMPACT		\
 			+ DICT_TF_WIDTH_ZIP_SSIZE	\
 			+ DICT_TF_WIDTH_ATOMIC_BLOBS	\
-			+ DICT_TF_WIDTH_DATA_DIR)
+			+ DICT_TF_WIDTH_DATA_DIR	\
+			+ DICT_TF_WIDTH_ZIP_ALGORITHM	\
+			+ DICT_TF_WIDTH_PAGE_COMPRESSION)
 
 /** A mask of all the known/used bits in table flags */
 #define DICT_TF_BIT_MASK	(~(~0 << DICT_TF_BITS))
@@ -139,9 +151,15 @@ allows InnoDB to update_create_info() accordingly. */
 /** Zero relative shift position of the DATA_DIR field */
 #define DICT_TF_POS_DATA_DIR		(DICT_TF_POS_ATOMIC_BLOBS	\
 					+ DICT_TF_WIDTH_ATOMIC_BLOBS)
-/** Zero relative shift position of the start of the UNUSED bits */
-#define DICT_TF_POS_UNUSED		(DICT_TF_POS_DATA_DIR		\
+/** Zero relative shift position of the ZIP_ALGORITHM field */
+#define DICT_TF_POS_ZIP_ALGORITHM	(DICT_TF_POS_DATA_DIR		\
 					+ DICT_TF_WIDTH_DATA_DIR)
+/** Zero relative shift position of the PAGE_COMPRESSION field */
+#define DICT_TF_POS_PAGE_COMPRESSION	(DICT_TF_POS_ZIP_ALGORITHM	\
+					+ DICT_TF_WIDTH_ZIP_ALGORITHM)
+/** Zero relative shift position of the start of the UNUSED bits */
+#define DICT_TF_POS_UNUSED		(DICT_TF_POS_PAGE_COMPRESSION	\
+					+ DICT_TF_WIDTH_PAGE_COMPRESSION)
 
 /** Bit mask of the COMPACT field */
 #define DICT_TF_MASK_COMPACT				\
@@ -159,6 +177,14 @@ allows InnoDB to update_create_info() accordingly. */
 #define DICT_TF_MASK_DATA_DIR				\
 		((~(~0 << DICT_TF_WIDTH_DATA_DIR))	\
 		<< DICT_TF_POS_DATA_DIR)
+/** Bit mask of the ZIP_ALGORITHM field */
+#define DICT_TF_MASK_ZIP_ALGORITHM			\
+		((~(~0 << DICT_TF_WIDTH_ZIP_ALGORITHM))	\
+		<< DICT_TF_POS_ZIP_ALGORITHM)
+/** Bit mask of the PAGE_COMPRESSION field */
+#define DICT_TF_MASK_PAGE_COMPRESSION			\
+		((~(~0 << DICT_TF_WIDTH_PAGE_COMPRESSION))	\
+		<< DICT_TF_POS_PAGE_COMPRESSION)
 
 /** Return the value of the COMPACT field */
 #define DICT_TF_GET_COMPACT(flags)			\
@@ -176,6 +202,14 @@ allows InnoDB to update_create_info() accordingly. */
 #define DICT_TF_HAS_DATA_DIR(flags)			\
 		((flags & DICT_TF_MASK_DATA_DIR)	\
 		>> DICT_TF_POS_DATA_DIR)
+/** Return the value of the ZIP_ALGORITHM field */
+#define DICT_TF_GET_ZIP_ALGORITHM(flags)		\
+		((flags & DICT_TF_MASK_ZIP_ALGORITHM)	\
+		>> DICT_TF_POS_ZIP_ALGORITHM)
+/** Return the value of the PAGE_COMPRESSION field */
+#define DICT_TF_HAS_PAGE_COMPRESSION(flags)		\
+		((flags & DICT_TF_MASK_PAGE_COMPRESSION)	\
+		>> DICT_TF_POS_PAGE_COMPRESSION)
 /** Return the contents of the UNUSED bits */
 #define DICT_TF_GET_UNUSED(flags)			\
 		(flags >> DICT_TF_POS_UNUSED)
@@ -190,7 +224,7 @@ ROW_FORMAT=REDUNDANT.  InnoDB engines do not check these flags
 for unknown bits in order to protect backward incompatibility. */
 /* @{ */
 /** Total number of bits in table->flags2. */
-#define DICT_TF2_BITS			6
+#define DICT_TF2_BITS			7
 #define DICT_TF2_BIT_MASK		~(~0 << DICT_TF2_BITS)
 
 /** TEMPORARY; TRUE for tables from CREATE TEMPORARY TABLE. */
@@ -208,6 +242,11 @@ use its own tablespace instead of the system tablespace. */
 
 /** Set when we discard/detach the tablespace */
 #define DICT_TF2_DISCARDED		32
+
+/** Intrinsic table: a temporary table created by the optimizer for
+query processing, visible only to the creating statement. It needs no
+undo logging, locking or redo log flushing. */
+#define DICT_TF2_INTRINSIC		64
 /* @} */
 
 #define DICT_TF2_FLAG_SET(table, flag)				\
@@ -591,6 +630,17 @@ struct dict_index_t{
 			indexes;/*!< list of indexes of the table */
 	btr_search_t*	search_info;
 				/*!< info used in optimistic searches */
+	bool		ibuf_disabled;
+				/*!< true if changes to the index must
+				not be buffered in the change buffer;
+				set from the index comment when the
+				table is opened in MySQL */
+	const ulint*	fixed_offsets;
+				/*!< if all the fields are NOT NULL and
+				of fixed length in ROW_FORMAT=COMPACT or
+				later, the rec_get_offsets() of every
+				ordinary record, for all the fields;
+				otherwise NULL */
 	row_log_t*	online_log;
 				/*!< the log of modifications
 				during online index creation;
@@ -722,6 +772,39 @@ a foreign key constraint is enforced, therefore RESTRICT just means no flag */
 #define DICT_FOREIGN_ON_UPDATE_NO_ACTION 32	/*!< ON UPDATE NO ACTION */
 /* @} */
 
+/** One bucket of a column histogram. The bucket holds the sampled values
+that are greater than the endpoint of the previous bucket and not greater
+than its own endpoint. */
+struct dict_col_hist_bucket_t{
+	const byte*	endpoint;	/*!< upper endpoint of the bucket,
+					in the InnoDB format of the column */
+	ulint		endpoint_len;	/*!< length of endpoint in bytes */
+	ib_uint64_t	n_rows;		/*!< number of sampled rows in the
+					bucket */
+	ib_uint64_t	n_endpoint_rows;/*!< number of sampled rows that are
+					equal to endpoint */
+	ib_uint64_t	n_distinct;	/*!< number of distinct sampled values
+					in the bucket */
+};
+
+/** Histogram of the sampled values of a column, computed together with
+the persistent statistics. If the sample contains no more distinct values
+than there are buckets, each value gets a bucket of its own (a singleton
+histogram), otherwise the buckets hold about the same number of rows
+(an equi-height histogram). SQL NULL values are not stored in the
+buckets but are counted in sample_size. */
+struct dict_col_hist_t{
+	const char*	col_name;	/*!< name of the column */
+	ulint		col_no;		/*!< number of the column in the
+					table, ULINT_UNDEFINED if the
+					column name was not found */
+	ib_uint64_t	sample_size;	/*!< number of sampled rows */
+	ulint		n_buckets;	/*!< number of buckets */
+	dict_col_hist_bucket_t*
+			buckets;	/*!< the buckets, in ascending order
+					of endpoint */
+};
+
 /** List of locks that different transactions have acquired on a table. This
 list has a list node that is embedded in a nested union/structure. We have to
 generate a specific template for it. */
@@ -900,6 +983,15 @@ struct dict_table_t{
 				database pages */
 	ulint		stat_sum_of_other_index_sizes;
 				/*!< other indexes in database pages */
+	mem_heap_t*	stat_hist_heap;
+				/*!< memory heap for stat_hist, or NULL */
+	ulint		stat_n_hist;
+				/*!< number of elements in stat_hist */
+	dict_col_hist_t*
+			stat_hist;
+				/*!< column histograms of the persistent
+				statistics, or NULL; see
+				srv_stats_histogram_buckets */
 	ib_uint64_t	stat_modified_counter;
 				/*!< when a row is inserted, updated,
 				or deleted,
@@ -988,7 +1080,9 @@ struct dict_table_t{
 				/*!< Count of the number of record locks on
 				this table. We use this to determine whether
 				we can evict the table from the dictionary
-				cache. It is protected by lock_sys->mutex. */
+				cache. It is protected by lock_sys->latch;
+				it is incremented atomically while holding
+				the latch in shared mode. */
 	ulint		n_ref_count;
 				/*!< count of how many handles are opened
 				to this table; dropping of the table is
@@ -209,6 +209,21 @@ dict_stats_rename_index(
 	const char*		new_index_name)	/*!< in: new index name */
 	__attribute__((warn_unused_result));
 
+/*********************************************************************//**
+Estimates the fraction of the rows of a table whose column is equal to a
+given value, from the histogram of the column in the persistent statistics.
+@return estimated selectivity in (0, 1], or a negative value if the column
+has no histogram */
+
+double
+dict_stats_col_eq_selectivity(
+/*==========================*/
+	const dict_table_t*	table,	/*!< in: table */
+	ulint			col_no,	/*!< in: column number */
+	const byte*		data,	/*!< in: value in the InnoDB format */
+	ulint			len)	/*!< in: length of data */
+	__attribute__((nonnull, warn_unused_result));
+
 #ifndef UNIV_NONINL
 #include "dict0stats.ic"
 #endif
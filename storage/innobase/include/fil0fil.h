@@ -130,6 +130,14 @@ extern fil_addr_t	fil_addr_null;
 					data file (ibdata*, not *.ibd):
 					the file has been flushed to disk
 					at least up to this lsn */
+#define FIL_PAGE_COMPRESS_ALGORITHM FIL_PAGE_FILE_FLUSH_LSN
+					/*!< in a FIL_PAGE_COMPRESSED page:
+					the compression algorithm, 1 byte */
+#define FIL_PAGE_COMPRESS_SIZE	(FIL_PAGE_FILE_FLUSH_LSN + 2)
+					/*!< in a FIL_PAGE_COMPRESSED page:
+					the size of the compressed data
+					that starts at FIL_PAGE_DATA,
+					2 bytes */
 #define FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID  34 /*!< starting from 4.1.x this
 					contains the space id of the page */
 #define FIL_PAGE_DATA		38	/*!< start of the data on the page */
@@ -159,6 +167,10 @@ extern fil_addr_t	fil_addr_null;
 #define FIL_PAGE_TYPE_ZBLOB2	12	/*!< Subsequent compressed BLOB page */
 #define FIL_PAGE_TYPE_LAST	FIL_PAGE_TYPE_ZBLOB2
 					/*!< Last page type */
+#define FIL_PAGE_COMPRESSED	14	/*!< Page compressed by
+					transparent page compression;
+					this type only exists in the file,
+					never in the buffer pool */
 /* @} */
 
 #ifndef UNIV_INNOCHECKSUM
@@ -497,6 +509,17 @@ fil_reinit_space_header(
 /*====================*/
 	ulint		id,	/*!< in: space id */
 	ulint		size);	/*!< in: size in blocks */
+/**********************************************************************//**
+Truncate the data file of a tablespace that consists of a single file to
+the given size. The caller must have removed the pages of the tablespace
+from the buffer pool.
+@return true if success */
+
+bool
+fil_truncate_tablespace(
+/*====================*/
+	ulint		id,	/*!< in: space id */
+	ulint		size);	/*!< in: new size in pages */
 /*******************************************************************//**
 Closes a single-table tablespace. The tablespace must be cached in the
 memory cache. Free all pages used by the tablespace.
@@ -973,6 +996,16 @@ struct PageCallback {
 		return(m_page_size);
 	}
 
+	/** Pages to visit: only every Nth page is read and passed to the
+	callback, starting from page 0. The stride must divide the number
+	of pages described by an extent descriptor page, so that those pages
+	are always visited.
+	@return the stride in pages, 1 to visit every page */
+	virtual ulint get_page_stride() const UNIV_NOTHROW
+	{
+		return(1);
+	}
+
 	/** Compressed table page size */
 	ulint			m_zip_size;
 
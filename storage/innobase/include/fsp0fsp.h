@@ -53,12 +53,21 @@ to the two Barracuda row formats COMPRESSED and DYNAMIC. */
 /** Width of the DATA_DIR flag.  This flag indicates that the tablespace
 is found in a remote location, not the default data directory. */
 #define FSP_FLAGS_WIDTH_DATA_DIR	1
+/** Width of the ZIP_ALGORITHM flag.  This is the page_zip_algorithm_t
+of the compressed pages in the tablespace. */
+#define FSP_FLAGS_WIDTH_ZIP_ALGORITHM	2
+/** Width of the PAGE_COMPRESSION flag.  This flag indicates that the
+pages of the tablespace are compressed with the ZIP_ALGORITHM when they
+are written to the file. */
+#define FSP_FLAGS_WIDTH_PAGE_COMPRESSION	1
 /** Width of all the currently known tablespace flags */
 #define FSP_FLAGS_WIDTH		(FSP_FLAGS_WIDTH_POST_ANTELOPE	\
 				+ FSP_FLAGS_WIDTH_ZIP_SSIZE	\
 				+ FSP_FLAGS_WIDTH_ATOMIC_BLOBS	\
 				+ FSP_FLAGS_WIDTH_PAGE_SSIZE	\
-				+ FSP_FLAGS_WIDTH_DATA_DIR)
+				+ FSP_FLAGS_WIDTH_DATA_DIR	\
+				+ FSP_FLAGS_WIDTH_ZIP_ALGORITHM	\
+				+ FSP_FLAGS_WIDTH_PAGE_COMPRESSION)
 
 /** A mask of all the known/used bits in tablespace flags */
 #define FSP_FLAGS_MASK		(~(~0 << FSP_FLAGS_WIDTH))
@@ -77,9 +86,15 @@ is found in a remote location, not the default data directory. */
 /** Zero relative shift position of the start of the UNUSED bits */
 #define FSP_FLAGS_POS_DATA_DIR		(FSP_FLAGS_POS_PAGE_SSIZE	\
 					+ FSP_FLAGS_WIDTH_PAGE_SSIZE)
-/** Zero relative shift position of the start of the UNUSED bits */
-#define FSP_FLAGS_POS_UNUSED		(FSP_FLAGS_POS_DATA_DIR	\
+/** Zero relative shift position of the ZIP_ALGORITHM field */
+#define FSP_FLAGS_POS_ZIP_ALGORITHM	(FSP_FLAGS_POS_DATA_DIR		\
 					+ FSP_FLAGS_WIDTH_DATA_DIR)
+/** Zero relative shift position of the PAGE_COMPRESSION field */
+#define FSP_FLAGS_POS_PAGE_COMPRESSION	(FSP_FLAGS_POS_ZIP_ALGORITHM	\
+					+ FSP_FLAGS_WIDTH_ZIP_ALGORITHM)
+/** Zero relative shift position of the start of the UNUSED bits */
+#define FSP_FLAGS_POS_UNUSED		(FSP_FLAGS_POS_PAGE_COMPRESSION	\
+					+ FSP_FLAGS_WIDTH_PAGE_COMPRESSION)
 
 /** Bit mask of the POST_ANTELOPE field */
 #define FSP_FLAGS_MASK_POST_ANTELOPE				\
@@ -101,6 +116,14 @@ is found in a remote location, not the default data directory. */
 #define FSP_FLAGS_MASK_DATA_DIR					\
 		((~(~0 << FSP_FLAGS_WIDTH_DATA_DIR))		\
 		<< FSP_FLAGS_POS_DATA_DIR)
+/** Bit mask of the ZIP_ALGORITHM field */
+#define FSP_FLAGS_MASK_ZIP_ALGORITHM				\
+		((~(~0 << FSP_FLAGS_WIDTH_ZIP_ALGORITHM))	\
+		<< FSP_FLAGS_POS_ZIP_ALGORITHM)
+/** Bit mask of the PAGE_COMPRESSION field */
+#define FSP_FLAGS_MASK_PAGE_COMPRESSION				\
+		((~(~0 << FSP_FLAGS_WIDTH_PAGE_COMPRESSION))	\
+		<< FSP_FLAGS_POS_PAGE_COMPRESSION)
 
 /** Return the value of the POST_ANTELOPE field */
 #define FSP_FLAGS_GET_POST_ANTELOPE(flags)			\
@@ -122,6 +145,14 @@ is found in a remote location, not the default data directory. */
 #define FSP_FLAGS_HAS_DATA_DIR(flags)				\
 		((flags & FSP_FLAGS_MASK_DATA_DIR)		\
 		>> FSP_FLAGS_POS_DATA_DIR)
+/** Return the value of the ZIP_ALGORITHM field */
+#define FSP_FLAGS_GET_ZIP_ALGORITHM(flags)			\
+		((flags & FSP_FLAGS_MASK_ZIP_ALGORITHM)		\
+		>> FSP_FLAGS_POS_ZIP_ALGORITHM)
+/** Return the value of the PAGE_COMPRESSION field */
+#define FSP_FLAGS_HAS_PAGE_COMPRESSION(flags)			\
+		((flags & FSP_FLAGS_MASK_PAGE_COMPRESSION)	\
+		>> FSP_FLAGS_POS_PAGE_COMPRESSION)
 /** Return the contents of the UNUSED bits */
 #define FSP_FLAGS_GET_UNUSED(flags)				\
 		(flags >> FSP_FLAGS_POS_UNUSED)
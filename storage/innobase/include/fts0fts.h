@@ -92,7 +92,7 @@ those defined in mysql file ft_global.h */
 #define FTS_INDEX_TABLE_IND_NAME	"FTS_INDEX_TABLE_IND"
 
 /** Threshold where our optimize thread automatically kicks in */
-#define FTS_OPTIMIZE_THRESHOLD		10000000
+#define FTS_OPTIMIZE_THRESHOLD		10000
 
 #define FTS_DOC_ID_MAX_STEP		10000
 /** Variable specifying the FTS parallel sort degree */
@@ -834,7 +834,11 @@ FTS auxiliary INDEX table and clear the cache at the end. */
 void
 fts_sync_table(
 /*===========*/
-	dict_table_t*	table)			/*!< in: table */
+	dict_table_t*	table,			/*!< in: table */
+	bool		unlock_cache)		/*!< in: true=release the
+						cache lock while writing
+						the nodes; the caller must
+						prevent DDL on the table */
 	__attribute__((nonnull));
 
 /****************************************************************//**
@@ -523,6 +523,19 @@ fts_cache_append_deleted_doc_ids(
 			cache,		/*!< in: cache to use */
 	ib_vector_t*	vector);	/*!< in: append to this vector */
 /******************************************************************//**
+Copy the doc ids of the table that are deleted and not yet purged by
+OPTIMIZE, reading them from the DELETED and DELETED_CACHE tables on the
+first call for the cache.
+@return DB_SUCCESS or error code */
+
+dberr_t
+fts_cache_copy_deleted_doc_ids(
+/*===========================*/
+	dict_table_t*	table,		/*!< in: table */
+	fts_doc_id_set_t*
+			deleted)	/*!< out: deleted doc ids */
+	__attribute__((nonnull, warn_unused_result));
+/******************************************************************//**
 Wait for the background thread to start. We poll to detect change
 of state, which is acceptable, since the wait should happen only
 once during startup.
@@ -612,6 +625,15 @@ fts_optimize_do_table(
 	dict_table_t*	table)		/*!< in: table to optimize */
 	__attribute__((nonnull));
 /******************************************************************//**
+Ask the optimize thread to SYNC the cache of a table in the background.
+@return true if the request was queued */
+
+bool
+fts_optimize_request_sync_table(
+/*============================*/
+	dict_table_t*	table)		/*!< in: table to SYNC */
+	__attribute__((nonnull));
+/******************************************************************//**
 Construct the prefix name of an FTS table.
 @return own: table name, must be freed with mem_free() */
 
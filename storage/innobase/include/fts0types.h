@@ -34,6 +34,8 @@ Created 2007-03-27 Sunny Bains
 #include "ut0byte.h"
 #include "ut0rbt.h"
 
+#include <map>
+
 /** Types used within FTS. */
 struct fts_que_t;
 struct fts_node_t;
@@ -125,6 +127,71 @@ struct fts_sync_t {
 					noted as being full, we use this to
 					set the upper_limit field */
         ib_time_t	start_time;	/*!< SYNC start time */
+	bool		in_progress;	/*!< true while a SYNC is running;
+					a SYNC that releases the cache
+					lock between nodes keeps other
+					SYNCs out with this flag */
+	bool		bg_requested;	/*!< true if a SYNC has been
+					requested from the FTS optimize
+					thread and has not started yet */
+	os_event_t	event;		/*!< signalled when a SYNC
+					completes */
+};
+
+/** Set of the deleted doc ids of a table, kept in memory so that queries
+can filter out the deleted documents without reading the DELETED and
+DELETED_CACHE tables. The ids are stored as bitmap words of 64 ids, and
+words without any ids are not stored. */
+class fts_doc_id_set_t {
+public:
+	/** Add a doc id.
+	@param doc_id	the doc id to add */
+	void insert(doc_id_t doc_id)
+	{
+		m_words[doc_id >> 6] |= bit(doc_id);
+	}
+
+	/** Remove a doc id.
+	@param doc_id	the doc id to remove */
+	void erase(doc_id_t doc_id)
+	{
+		words_t::iterator	it = m_words.find(doc_id >> 6);
+
+		if (it != m_words.end()) {
+			it->second &= ~bit(doc_id);
+
+			if (it->second == 0) {
+				m_words.erase(it);
+			}
+		}
+	}
+
+	/** @return true if the doc id is in the set
+	@param doc_id	the doc id to look for */
+	bool contains(doc_id_t doc_id) const
+	{
+		words_t::const_iterator	it = m_words.find(doc_id >> 6);
+
+		return(it != m_words.end() && (it->second & bit(doc_id)));
+	}
+
+	/** Remove all the doc ids. */
+	void clear()
+	{
+		m_words.clear();
+	}
+
+private:
+	/** @return the bit of a doc id within its word */
+	static ib_uint64_t bit(doc_id_t doc_id)
+	{
+		return(static_cast<ib_uint64_t>(1) << (doc_id & 63));
+	}
+
+	/** Bitmap words, keyed by doc id / 64 */
+	typedef std::map<doc_id_t, ib_uint64_t>	words_t;
+
+	words_t		m_words;
 };
 
 /** The cache for the FTS system. It is a memory-based inverted index
@@ -148,6 +215,19 @@ struct fts_cache_t {
 	ib_vector_t*	deleted_doc_ids;/*!< Array of deleted doc ids, each
 					element is of type fts_update_t */
 
+	fts_doc_id_set_t*
+			deleted_set;	/*!< All deleted doc ids of the
+					table that OPTIMIZE has not purged
+					yet, covered by deleted_lock */
+
+	bool		deleted_set_loaded;
+					/*!< true if the doc ids of the
+					DELETED and DELETED_CACHE tables have
+					been read into deleted_set; until then
+					it only contains the doc ids deleted
+					since the cache was created. Covered
+					by deleted_lock */
+
 	ib_vector_t*	indexes;	/*!< We store the stats and inverted
 					index for the individual FTS indexes
 					in this vector. Each element is
@@ -214,6 +294,10 @@ struct fts_node_t {
 	ulint		ilist_size_alloc;
 					/*!< Allocated size of ilist in
 					bytes */
+
+	bool		synced;		/*!< true if the node has been
+					written by the running SYNC; no
+					more positions are added to it */
 };
 
 /** A tokenizer word. Contains information about one word. */
@@ -83,7 +83,7 @@ updates the pointer to data if found.
 
 /*************************************************************//**
 Creates a hash table with at least n array cells.  The actual number
-of cells is chosen to be a prime number slightly bigger than n.
+of cells is chosen by hash_calc_n_cells().
 @return own: created table */
 
 hash_table_t*
@@ -286,6 +286,17 @@ thd_supports_xa(
 	THD*	thd);	/*!< in: thread handle, or NULL to query
 			the global innodb_supports_xa */
 
+/******************************************************************//**
+Returns true if large table scans of the thread should be scan-resistant,
+global value of innodb_scan_resistant if thd is NULL.
+@return true if large scans should not evict the working set */
+
+ibool
+thd_scan_resistant(
+/*===============*/
+	THD*	thd);	/*!< in: thread handle, or NULL to query
+			the global innodb_scan_resistant */
+
 /******************************************************************//**
 Returns the lock wait timeout for the current connection.
 @return the lock wait timeout, in seconds */
@@ -295,6 +306,18 @@ thd_lock_wait_timeout(
 /*==================*/
 	THD*	thd);	/*!< in: thread handle, or NULL to query
 			the global innodb_lock_wait_timeout */
+
+/******************************************************************//**
+Returns the sampling rate of the buffer pool information schema tables
+for the current connection.
+@return read every Nth buffer pool block without latching it, or 0 to
+read all the blocks under the buffer pool mutex */
+
+ulong
+thd_buffer_page_sample_rate(
+/*========================*/
+	THD*	thd);	/*!< in: thread handle, or NULL to query the
+			global innodb_buffer_page_sample_rate */
 /******************************************************************//**
 Add up the time waited for the lock for the current query. */
 
@@ -63,8 +63,31 @@ hash_table_t*
 hash_create(
 /*========*/
 	ulint	n);	/*!< in: number of array cells */
+/*************************************************************//**
+Creates a hash table with exactly n_cells array cells.
+@return own: created table */
+
+hash_table_t*
+hash_create_n_cells(
+/*================*/
+	ulint	n_cells);	/*!< in: number of array cells */
 #ifndef UNIV_HOTBACKUP
 /*************************************************************//**
+Calculates the number of array cells for a hash table with >= n cells
+that is protected by n_sync_obj sync objects.  With more than one sync
+object, this is a prime number times n_sync_obj: since n_sync_obj is a
+power of 2, the sync object of a fold value then does not depend on the
+number of cells, and the cell array can be replaced by a bigger or
+smaller one while all the sync objects are held.
+@return number of array cells */
+
+ulint
+hash_calc_n_cells(
+/*==============*/
+	ulint	n,		/*!< in: minimum number of array cells */
+	ulint	n_sync_obj);	/*!< in: number of sync objects,
+				a power of 2, or 0 */
+/*************************************************************//**
 Creates a sync object array array to protect a hash table.
 ::sync_obj can be mutexes or rw_locks depening on the type of
 hash table. */
@@ -327,7 +350,8 @@ do {\
 	cell_count2222 = hash_get_n_cells(OLD_TABLE);\
 \
 	for (i2222 = 0; i2222 < cell_count2222; i2222++) {\
-		NODE_TYPE*	node2222 = HASH_GET_FIRST((OLD_TABLE), i2222);\
+		NODE_TYPE*	node2222 = static_cast<NODE_TYPE*>(\
+			HASH_GET_FIRST((OLD_TABLE), i2222));\
 \
 		while (node2222) {\
 			NODE_TYPE*	next2222 = node2222->PTR_NAME;\
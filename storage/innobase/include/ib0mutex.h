@@ -309,6 +309,7 @@ private:
 
 #ifdef HAVE_IB_LINUX_FUTEX
 
+#include <errno.h>
 #include <linux/futex.h>
 #include <sys/syscall.h>
 
@@ -372,7 +373,7 @@ struct TTASFutexMutex {
 		if (lock != MUTEX_STATE_UNLOCKED
 		    && (lock != MUTEX_STATE_LOCKED || !set_waiters())) {
 
-			wait();
+			wait(filename, line);
 		}
 	}
 
@@ -470,16 +471,31 @@ private:
 		       != MUTEX_STATE_UNLOCKED);
 	}
 
-	/** Wait if the lock is contended. */
-	void wait() UNIV_NOTHROW
+	/** Wait if the lock is contended. Only this thread is parked and
+	woken; the sync array is not involved. The wait is done in slices
+	of one second, so that a hang is reported like a long semaphore
+	wait in the sync array.
+	@param filename		from where called
+	@param line		within filename */
+	void wait(const char* filename, ulint line) UNIV_NOTHROW
 	{
+		struct timespec	timeout;
+		ulint		n_secs = 0;
+
+		timeout.tv_sec = 1;
+		timeout.tv_nsec = 0;
+
 		/* Use FUTEX_WAIT_PRIVATE because our mutexes are
 		not shared between processes. */
 
 		do {
-			syscall(SYS_futex, &m_lock_word,
-				FUTEX_WAIT_PRIVATE, MUTEX_STATE_WAITERS,
-				0, 0, 0);
+			if (syscall(SYS_futex, &m_lock_word,
+				    FUTEX_WAIT_PRIVATE, MUTEX_STATE_WAITERS,
+				    &timeout, 0, 0) == -1
+			    && errno == ETIMEDOUT) {
+
+				long_wait(++n_secs, filename, line);
+			}
 
 			// Since we are retrying the operation the return
 			// value doesn't matter.
@@ -487,6 +503,35 @@ private:
 		} while (!set_waiters());
 	}
 
+	/** Report a long wait for the mutex, and crash the server if the
+	wait has lasted longer than innodb_fatal_semaphore_wait_threshold.
+	@param n_secs		seconds waited so far
+	@param filename		from where called
+	@param line		within filename */
+	void long_wait(ulint n_secs, const char* filename, ulint line)
+		UNIV_NOTHROW
+	{
+		if (n_secs % LONG_WAIT_SECS == 0) {
+			fprintf(stderr,
+				"InnoDB: Warning: a long semaphore wait:\n"
+				"--Thread %lu has waited at %s line %lu"
+				" for %lu seconds the mutex at %p\n",
+				(ulong) os_thread_pf(os_thread_get_curr_id()),
+				filename, (ulong) line,
+				(ulong) n_secs, (void*) this);
+		}
+
+		if (n_secs > srv_fatal_semaphore_wait_threshold) {
+			fprintf(stderr,
+				"InnoDB: Error: semaphore wait has lasted"
+				" > %lu seconds\n"
+				"InnoDB: We intentionally crash the server,"
+				" because it appears to be hung.\n",
+				(ulong) srv_fatal_semaphore_wait_threshold);
+			ut_error;
+		}
+	}
+
 	/** Wakeup a waiting thread */
 	void signal () UNIV_NOTHROW
 	{
@@ -518,6 +563,10 @@ private:
 	}
 
 private:
+	/** Interval of the long wait warnings in seconds, as in
+	sync_array_print_long_waits() */
+	static const ulint	LONG_WAIT_SECS = 240;
+
 	MutexPolicy		m_policy;
 
 	volatile lock_word_t	m_lock_word;
@@ -39,6 +39,10 @@ Created 7/19/1997 Heikki Tuuri
 of percentage of the buffer pool. */
 #define CHANGE_BUFFER_DEFAULT_SIZE	(25)
 
+/** Default value for maximum size of the changes buffered for one index
+in terms of percentage of the maximum size of the change buffer. */
+#define CHANGE_BUFFER_DEFAULT_INDEX_SIZE	(50)
+
 /* Possible operations buffered in the insert/whatever buffer. See
 ibuf_insert(). DO NOT CHANGE THE VALUES OF THESE, THEY ARE STORED ON DISK. */
 typedef enum {
@@ -67,6 +71,10 @@ typedef enum {
 /** Operations that can currently be buffered. */
 extern ibuf_use_t	ibuf_use;
 
+/** Maximum size of the changes buffered for one index, in percentage
+of the maximum size of the change buffer */
+extern uint		ibuf_max_index_pct;
+
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
 /** Flag to control insert buffer debugging. */
 extern uint		ibuf_debug;
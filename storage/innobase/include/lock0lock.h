@@ -35,12 +35,15 @@ Created 5/7/1996 Heikki Tuuri
 #include "que0types.h"
 #include "lock0types.h"
 #include "hash0hash.h"
+#include "sync0rw.h"
 #include "srv0srv.h"
 #include "ut0vec.h"
 
 // Forward declaration
 class ReadView;
 
+typedef ib_mutex_t LockMutex;
+
 /*********************************************************************//**
 Gets the size of a lock struct.
 @return size in bytes */
@@ -531,6 +534,17 @@ lock_rec_hash(
 	ulint	space,	/*!< in: space */
 	ulint	page_no);/*!< in: page number */
 
+/** Gets the mutex protecting the partition of lock_sys->rec_hash that
+holds the record locks of a page.
+@param[in]	space	tablespace id
+@param[in]	page_no	page number
+@return mutex protecting the record locks of the page */
+UNIV_INLINE
+LockMutex*
+lock_rec_get_mutex(
+	ulint	space,
+	ulint	page_no);
+
 /**********************************************************************//**
 Looks for a set bit in a record lock bitmap. Returns ULINT_UNDEFINED,
 if none found.
@@ -766,6 +780,17 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	void*	arg);	/*!< in: a dummy parameter required by
 			os_thread_create */
 
+/*********************************************************************//**
+A thread which checks the lock waits enqueued while
+innodb_deadlock_detect_async is set for deadlocks, and resolves them.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_thread)(
+/*=================================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -944,14 +969,33 @@ struct lock_op_t{
 	enum lock_mode	mode;	/*!< lock mode */
 };
 
-typedef ib_mutex_t LockMutex;
+/** Number of partitions of lock_sys->rec_hash that are protected by
+their own mutex; must be a power of 2 */
+#define LOCK_REC_N_MUTEXES	64
 
 /** The lock system struct */
 struct lock_sys_t{
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. Operations that only
+						access the record locks of
+						one page hold it in shared
+						mode, together with the
+						rec_mutexes[] entry of the
+						page. Table locks, lock waits,
+						deadlock detection, and all
+						operations that span several
+						pages or transactions hold
+						it in exclusive mode, which
+						also covers all of
+						rec_hash. */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
+	LockMutex*	rec_mutexes[LOCK_REC_N_MUTEXES];
+						/*!< Mutexes protecting the
+						partitions of rec_hash; a
+						page maps to the partition
+						lock_rec_hash() modulo
+						LOCK_REC_N_MUTEXES */
 	LockMutex	wait_mutex;		/*!< Mutex protecting the
 						next two fields */
 	srv_slot_t*	waiting_threads;	/*!< Array  of user threads
@@ -977,28 +1021,96 @@ struct lock_sys_t{
 
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
+
+	UT_LIST_BASE_NODE_T(trx_t)
+			deadlock_waits;		/*!< Transactions whose lock
+						wait has not yet been checked
+						for deadlocks, in the order the
+						waits were enqueued, when
+						innodb_deadlock_detect_async
+						is set; protected by
+						lock_sys->latch in exclusive
+						mode */
+
+	os_event_t	deadlock_event;		/*!< Set when deadlock_waits
+						becomes non-empty, to wake up
+						the deadlock detector thread */
+
+	bool		deadlock_thread_active;	/*!< True if the deadlock
+						detector thread is running */
 };
 
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
+/** Test if lock_sys->latch can be x-latched without waiting.
+@return 0 if the latch was acquired */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys->mutex.trylock(__FILE__, __LINE__))
-
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() (lock_sys->mutex.is_owned())
-
-/** Acquire the lock_sys->mutex. */
+	(!rw_lock_x_lock_nowait(&lock_sys->latch))
+
+/** Test if lock_sys->latch is x-latched by the current thread. */
+#ifdef UNIV_SYNC_DEBUG
+# define lock_mutex_own() rw_lock_own(&lock_sys->latch, RW_LOCK_X)
+#else /* UNIV_SYNC_DEBUG */
+# define lock_mutex_own()					\
+	(rw_lock_get_writer(&lock_sys->latch) == RW_LOCK_X		\
+	 && os_thread_eq(lock_sys->latch.writer_thread,		\
+			 os_thread_get_curr_id()))
+#endif /* UNIV_SYNC_DEBUG */
+
+/** Test if lock_sys->latch is held in shared or exclusive mode by the
+current thread. Without UNIV_SYNC_DEBUG, a shared latch held by some other
+thread may be mistaken for one held by the current thread. */
+#ifdef UNIV_SYNC_DEBUG
+# define lock_sys_latched()					\
+	(rw_lock_own(&lock_sys->latch, RW_LOCK_S) || lock_mutex_own())
+#else /* UNIV_SYNC_DEBUG */
+# define lock_sys_latched()					\
+	(rw_lock_is_locked(&lock_sys->latch, RW_LOCK_S)		\
+	 || lock_mutex_own())
+#endif /* UNIV_SYNC_DEBUG */
+
+/** Acquire lock_sys->latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release lock_sys->latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	lock_sys->mutex.exit();			\
+	rw_lock_x_unlock(&lock_sys->latch);	\
 } while (0)
 
+/** Acquire lock_sys->latch in shared mode and the mutex protecting the
+record locks of a page.
+@param space	tablespace id of the page
+@param page_no	page number */
+#define lock_rec_mutex_enter(space, page_no) do {		\
+	rw_lock_s_lock(&lock_sys->latch);			\
+	mutex_enter(lock_rec_get_mutex(space, page_no));	\
+} while (0)
+
+/** Release the latches acquired by lock_rec_mutex_enter().
+@param space	tablespace id of the page
+@param page_no	page number */
+#define lock_rec_mutex_exit(space, page_no) do {		\
+	mutex_exit(lock_rec_get_mutex(space, page_no));		\
+	rw_lock_s_unlock(&lock_sys->latch);			\
+} while (0)
+
+/** Test if the record locks of a page are protected by the current
+thread: either lock_sys->latch is x-latched or the mutex of the page
+is owned.
+@param space	tablespace id of the page
+@param page_no	page number */
+#define lock_rec_mutex_own(space, page_no)			\
+	(lock_mutex_own()					\
+	 || mutex_own(lock_rec_get_mutex(space, page_no)))
+
+/** lock_rec_mutex_own() for a buffer block */
+#define lock_rec_mutex_own_block(block)				\
+	lock_rec_mutex_own(buf_block_get_space(block),		\
+			   buf_block_get_page_no(block))
+
 /** Test if lock_sys->wait_mutex is owned. */
 #define lock_wait_mutex_own() (lock_sys->wait_mutex.is_owned())
 
@@ -132,6 +132,38 @@ log_write_low(
 	byte*	str,		/*!< in: string */
 	ulint	str_len);	/*!< in: string length */
 /************************************************************//**
+Reserves space for a string in the log buffer. The lsn and the log block
+headers and trailers are advanced as in log_write_low(), but the string
+itself is not copied: the caller must copy it with log_write_reserved() and
+then call log_write_reserved_complete(). The copying may be done after the
+log mutex has been released. It is assumed that the caller holds the log
+mutex.
+@return offset in the log buffer where the string is to be copied */
+
+ulint
+log_reserve_low(
+/*============*/
+	ulint	str_len);	/*!< in: string length */
+/************************************************************//**
+Copies a part of a string into the log buffer space that was reserved with
+log_reserve_low(). The log mutex need not be held.
+@return offset in the log buffer where the next part is to be copied */
+
+ulint
+log_write_reserved(
+/*===============*/
+	ulint		offset,	/*!< in: offset returned by log_reserve_low()
+				or by the previous call */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len);/*!< in: string length */
+/************************************************************//**
+Signals that the string reserved with log_reserve_low() has been copied to
+the log buffer in full. The log mutex need not be held. */
+
+void
+log_write_reserved_complete(void);
+/*=============================*/
+/************************************************************//**
 Closes the log.
 @return lsn */
 
@@ -209,6 +241,14 @@ log_write_up_to(
 			/*!< in: TRUE if we want the written log
 			also to be flushed to disk */
 /****************************************************************//**
+Starts the log writer and log flusher threads if innodb_log_writer_threads
+is set. After this, log_write_up_to() leaves the writes and flushes of the
+log to these threads and only waits for them. */
+
+void
+log_writer_threads_start(void);
+/*==========================*/
+/****************************************************************//**
 Does a syncronous flush of the log buffer to disk. */
 
 void
@@ -765,6 +805,15 @@ struct log_t{
 	ulint		max_buf_free;	/*!< recommended maximum value of
 					buf_free, after which the buffer is
 					flushed */
+	volatile ulint	n_pending_copies;/*!< number of mini-transactions that
+					have reserved space in the log buffer
+					with log_reserve_low() but not yet
+					completed copying their records there;
+					incremented under the log mutex,
+					decremented without it with an atomic
+					operation. The log buffer contents
+					must not be written or moved while
+					this is nonzero. */
  #ifdef UNIV_LOG_DEBUG
 	ulint		old_buf_free;	/*!< value of buf free when log was
 					last time opened; only in the debug
@@ -854,6 +903,33 @@ struct log_t{
 					but NOTE that to set or reset this
 					event, the thread MUST own the log
 					mutex! */
+	/** Fields of the log writer and log flusher threads @{ */
+	bool		writer_threads;	/*!< true if the log writer and
+					log flusher threads are running and
+					log_write_up_to() should wait for
+					them instead of writing itself */
+	ulint		n_writer_threads;/*!< number of log writer and log
+					flusher threads that have not yet
+					exited */
+	lsn_t		flush_requested_lsn;
+					/*!< highest lsn up to which a
+					thread waits for the log to be
+					flushed; the flusher thread only
+					flushes when this is above
+					flushed_to_disk_lsn */
+	os_event_t	writer_event;	/*!< set to wake up the log writer
+					thread */
+	os_event_t	flusher_event;	/*!< set to wake up the log flusher
+					thread */
+	os_event_t*	write_events;	/*!< LOG_N_LSN_EVENTS events, set by
+					the writer thread when the log has
+					been written past an lsn that maps to
+					the event; see log_lsn_event_slot() */
+	os_event_t*	flush_events;	/*!< LOG_N_LSN_EVENTS events, set by
+					the flusher thread when the log has
+					been flushed past an lsn that maps to
+					the event */
+	/* @} */
 	ulint		n_log_ios;	/*!< number of log i/os initiated thus
 					far */
 	ulint		n_log_ios_old;	/*!< number of log i/o's at the
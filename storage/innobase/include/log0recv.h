@@ -223,7 +223,7 @@ recv_sys_var_init(void);
 #endif /* !UNIV_HOTBACKUP */
 /*******************************************************************//**
 Empties the hash table of stored log records, applying them to appropriate
-pages. */
+pages. The work is divided between innodb_recovery_threads threads. */
 
 void
 recv_apply_hashed_log_recs(
@@ -353,6 +353,21 @@ struct recv_sys_t{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+	ulint		n_apply_threads;
+				/*!< number of threads applying the
+				current batch, the caller included */
+	ulint		n_apply_threads_active;
+				/*!< number of recv_apply threads that
+				have not yet gone through their cells */
+	ulint		n_apply_cells;
+				/*!< number of addr_hash cells processed
+				in the current batch */
+	ulint		n_apply_pages;
+				/*!< number of pages submitted for
+				recovery in the current batch */
+	ibool		apply_progress;
+				/*!< TRUE if the progress of the current
+				batch is printed to the error log */
 };
 
 /** The recovery system */
@@ -90,6 +90,21 @@ Closes the memory system. */
 void
 mem_close(void);
 /*===========*/
+#ifndef UNIV_HOTBACKUP
+/******************************************************************//**
+Creates the per-thread caches of free heap blocks. They are used only when
+the blocks are allocated with malloc(), that is, with innodb_use_sys_malloc. */
+
+void
+mem_block_cache_init(void);
+/*======================*/
+/******************************************************************//**
+Frees the heap block cache of the calling thread and stops caching. */
+
+void
+mem_block_cache_close(void);
+/*=======================*/
+#endif /* !UNIV_HOTBACKUP */
 
 /**************************************************************//**
 Use this macro instead of the corresponding function! Macro for memory
@@ -119,6 +119,11 @@ Returns the old value of *ptr, atomically sets *ptr to new_val */
 # define os_atomic_test_and_set_ulint(ptr, new_val) \
 	__sync_lock_test_and_set(ptr, new_val)
 
+/**********************************************************//**
+Full memory barrier: no load or store is reordered across it. */
+
+# define os_mb()	__sync_synchronize()
+
 #elif defined(HAVE_IB_SOLARIS_ATOMICS)
 
 # define HAVE_ATOMIC_BUILTINS
@@ -198,6 +203,11 @@ Returns the old value of *ptr, atomically sets *ptr to new_val */
 # define os_atomic_test_and_set_ulint(ptr, new_val) \
 	atomic_swap_ulong(ptr, new_val)
 
+/**********************************************************//**
+Full memory barrier: no load or store is reordered across it. */
+
+# define os_mb()	(membar_enter(), membar_consumer())
+
 #elif defined(HAVE_WINDOWS_ATOMICS)
 
 # define HAVE_ATOMIC_BUILTINS
@@ -317,6 +327,11 @@ clobbered */
 
 # define os_atomic_test_and_set_u32(ptr, new_val) \
 	InterlockedExchange(ptr, new_val)
+
+/**********************************************************//**
+Full memory barrier: no load or store is reordered across it. */
+
+# define os_mb()	MemoryBarrier()
 #else
 # define IB_ATOMICS_STARTUP_MSG \
 	"Mutexes uses sys mutexes and rw_locks use InnoDB's own implementation"
@@ -163,6 +163,17 @@ enum os_file_create_t {
 #define OS_FILE_WRITE	11
 
 #define OS_FILE_LOG	256	/* This can be ORed to type */
+#define OS_FILE_COMPRESSED	2048	/* This can be ORed to
+				OS_FILE_WRITE together with the compression
+				algorithm, to write a compressed page and
+				punch a hole for the rest of it */
+#define OS_FILE_COMPRESSION_SHIFT	12
+/** Type bits for writing a page compressed with an algorithm */
+#define OS_FILE_COMPRESSION(algorithm)				\
+	(OS_FILE_COMPRESSED | ((algorithm) << OS_FILE_COMPRESSION_SHIFT))
+/** All the type bits that os_aio() strips for page compression */
+#define OS_FILE_COMPRESSION_FLAGS				\
+	(OS_FILE_COMPRESSED | (3 << OS_FILE_COMPRESSION_SHIFT))
 /* @} */
 
 #define OS_AIO_N_PENDING_IOS_PER_THREAD 32	/*!< Win NT does not allow more
@@ -188,8 +199,9 @@ enum os_file_create_t {
 				in the call of os_aio(...),
 				if the caller wants to post several i/o
 				requests in a batch, and only after that
-				wake the i/o-handler thread; this has
-				effect only in simulated aio */
+				wake the i/o-handler thread; with Linux
+				native aio the requests are then
+				submitted to the kernel in one batch */
 /* @} */
 
 #define OS_WIN31	1	/*!< Microsoft Windows 3.x */
@@ -1102,7 +1114,9 @@ Requests an asynchronous i/o operation.
 ibool
 os_aio_func(
 /*========*/
-	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE,
+				the latter possibly ORed to
+				OS_FILE_COMPRESSION(algorithm) */
 	ulint		mode,	/*!< in: OS_AIO_NORMAL, ..., possibly ORed
 				to OS_AIO_SIMULATED_WAKE_LATER: the
 				last flag advises this function not to wake
@@ -1131,6 +1145,16 @@ os_aio_func(
 				(can be used to identify a completed
 				aio operation); ignored if mode is
 				OS_AIO_SYNC */
+/*******************************************************************//**
+Decompress a page that was read from a page compressed tablespace. Pages
+of other types are left alone, as are pages that fail to decompress, so
+that the checksum check reports them as corrupted.
+@return false if the page was compressed but could not be decompressed */
+
+bool
+os_file_decompress_page(
+/*====================*/
+	byte*	buf);	/*!< in/out: page of UNIV_PAGE_SIZE bytes */
 /************************************************************************//**
 Wakes up all async i/o threads so that they know to exit themselves in
 shutdown. */
@@ -1146,7 +1170,9 @@ void
 os_aio_wait_until_no_pending_writes(void);
 /*=====================================*/
 /**********************************************************************//**
-Wakes up simulated aio i/o-handler threads if they have something to do. */
+Wakes up simulated aio i/o-handler threads if they have something to do.
+With Linux native aio, submits the requests that were posted with
+OS_AIO_SIMULATED_WAKE_LATER instead. */
 
 void
 os_aio_simulated_wake_handler_threads(void);
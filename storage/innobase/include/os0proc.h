@@ -40,6 +40,9 @@ typedef unsigned long int	os_process_id_t;
 extern ibool os_use_large_pages;
 /* Large page size. This may be a boot-time option on some platforms */
 extern ulint os_large_page_size;
+/** Number of NUMA nodes that buffer pool instances and their threads
+are bound to, or 0 if they are not bound */
+extern ulint os_numa_n_nodes;
 
 /****************************************************************//**
 Converts the current process id to a number. It is not guaranteed that the
@@ -69,6 +72,36 @@ os_mem_free_large(
 					os_mem_alloc_large() */
 	ulint	size);			/*!< in: size returned by
 					os_mem_alloc_large() */
+/****************************************************************//**
+Determine the NUMA nodes that memory and threads can be bound to, and
+set os_numa_n_nodes. Binding is only done on systems with more than one
+node. */
+
+void
+os_numa_init(
+/*=========*/
+	bool	bind);			/*!< in: whether binding is wanted */
+/****************************************************************//**
+Bind memory that has not been touched yet to a NUMA node. Does nothing
+if os_numa_n_nodes == 0. */
+
+void
+os_numa_bind_mem(
+/*=============*/
+	void*	ptr,			/*!< in: start of the memory */
+	ulint	size,			/*!< in: size of the memory */
+	ulint	i);			/*!< in: buffer pool instance number,
+					mapped round-robin to the nodes */
+/****************************************************************//**
+Make the calling thread run on the CPUs of a NUMA node only. Does nothing
+if os_numa_n_nodes == 0. */
+
+void
+os_numa_bind_thread(
+/*================*/
+	ulint	i);			/*!< in: buffer pool instance or thread
+					number, mapped round-robin to the
+					nodes */
 
 #ifndef UNIV_NONINL
 #include "os0proc.ic"
@@ -60,6 +60,19 @@ ssize, which is the number of shifts from 512. */
 # error "PAGE_ZIP_SSIZE_MAX >= (1 << PAGE_ZIP_SSIZE_BITS)"
 #endif
 
+/** Compression algorithms of ROW_FORMAT=COMPRESSED pages. The
+algorithm is stored in the table and tablespace flags, and it is used
+for compressing the B-tree pages of the table. BLOB pages are always
+compressed with zlib. */
+enum page_zip_algorithm_t {
+	PAGE_ZIP_ALGORITHM_ZLIB = 0,	/*!< zlib deflate() */
+	PAGE_ZIP_ALGORITHM_LZ4 = 1,	/*!< LZ4 */
+	PAGE_ZIP_ALGORITHM_ZSTD = 2	/*!< Zstandard */
+};
+
+/** Largest valid page_zip_algorithm_t */
+#define PAGE_ZIP_ALGORITHM_MAX	PAGE_ZIP_ALGORITHM_ZSTD
+
 /** The information used for compressing a page when applying
 TRUNCATE log record during recovery */
 struct redo_page_compress_t {
@@ -64,6 +64,50 @@ extern uint	page_zip_level;
 compression algorithm changes in zlib. */
 extern my_bool	page_zip_log_pages;
 
+/* Compression algorithm (page_zip_algorithm_t) of newly created
+ROW_FORMAT=COMPRESSED tables. Settable by user. */
+extern ulong	page_zip_algorithm;
+
+/**********************************************************************//**
+Check if a page compression algorithm is available in this build.
+@return true if pages can be compressed and decompressed with it */
+
+bool
+page_zip_algorithm_is_supported(
+/*============================*/
+	ulint	algorithm)	/*!< in: page_zip_algorithm_t */
+	__attribute__((const));
+
+/**********************************************************************//**
+Compress a block of data, such as a whole page.
+@return length of the compressed data, or 0 if it did not fit in dst */
+
+ulint
+page_zip_block_compress(
+/*====================*/
+	ulint		algorithm,	/*!< in: page_zip_algorithm_t,
+					which must be supported */
+	const byte*	src,		/*!< in: data to compress */
+	ulint		src_len,	/*!< in: length of src in bytes */
+	byte*		dst,		/*!< out: compressed data */
+	ulint		dst_len,	/*!< in: size of dst in bytes */
+	ulint		level)		/*!< in: compression level */
+	__attribute__((nonnull, warn_unused_result));
+
+/**********************************************************************//**
+Decompress a block of data that was compressed by page_zip_block_compress().
+@return length of the decompressed data, or ULINT_UNDEFINED on error */
+
+ulint
+page_zip_block_decompress(
+/*======================*/
+	ulint		algorithm,	/*!< in: page_zip_algorithm_t */
+	const byte*	src,		/*!< in: compressed data */
+	ulint		src_len,	/*!< in: length of src in bytes */
+	byte*		dst,		/*!< out: decompressed data */
+	ulint		dst_len)	/*!< in: size of dst in bytes */
+	__attribute__((nonnull, warn_unused_result));
+
 /**********************************************************************//**
 Determine the size of a compressed page in bytes.
 @return size in bytes */
@@ -301,6 +301,10 @@ private:
 	was taken */
 	ids_t		m_ids;
 
+	/** Value of trx_sys->rw_trx_ids_version when this snapshot
+	was taken */
+	ulint		m_version;
+
 	/** The view does not need to see the undo logs for transactions
 	whose transaction number is strictly smaller (<) than this value:
 	they can be removed in purge if not needed by other views */
@@ -202,6 +202,47 @@ cmp_dfield_dfield_like_prefix(
 	const dfield_t*	dfield1,
 	const dfield_t*	dfield2);
 
+/** Normalization of a data type into a memcmp-comparable weight string.
+The normalized prefix of a field consists of the weights of its first bytes,
+padded with the weight of the padding character, so that whenever the
+normalized prefixes of two fields differ, they order the fields the same
+way as cmp_data_data(). */
+struct cmp_norm_t {
+	/** Weight of each byte value, or NULL if the weight of a byte
+	is its value */
+	const byte*	map;
+	/** Weight that the shorter field is padded with */
+	byte		pad;
+};
+
+/** Determine whether the fields of a data type can be ordered by their
+normalized prefixes, that is, whether cmp_data_data() compares the weights
+of the bytes one by one.
+@param[out] norm normalization of the data type
+@param[in] mtype main type
+@param[in] prtype precise type
+@return whether the data type can be normalized */
+
+bool
+cmp_norm_init(
+	cmp_norm_t*	norm,
+	ulint		mtype,
+	ulint		prtype)
+	__attribute__((nonnull, warn_unused_result));
+
+/** Compute the normalized prefix of a field.
+@param[in] norm normalization from cmp_norm_init()
+@param[in] data data field
+@param[in] len length of data in bytes (not UNIV_SQL_NULL)
+@return the weights of the first 8 bytes, as an integer in memcmp order */
+UNIV_INLINE
+ib_uint64_t
+cmp_norm_prefix(
+	const cmp_norm_t*	norm,
+	const byte*		data,
+	ulint			len)
+	__attribute__((nonnull, warn_unused_result));
+
 #ifndef UNIV_NONINL
 #include "rem0cmp.ic"
 #endif
@@ -428,6 +428,20 @@ rec_get_n_extern_new(
 	ulint			n)	/*!< in: number of columns to scan */
 	__attribute__((nonnull, warn_unused_result));
 
+/******************************************************//**
+Build the offsets that every ordinary record of an index has when the
+records of the index have a fixed layout: ROW_FORMAT=COMPACT or later,
+and only NOT NULL fixed-length fields. rec_get_offsets() then copies
+them instead of parsing the record header.
+@return offsets for all the fields, allocated from index->heap, or NULL
+if the layout of the records is not fixed */
+
+const ulint*
+rec_get_fixed_offsets(
+/*==================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, warn_unused_result));
+
 /******************************************************//**
 The following function determines the offsets to each field
 in the record.	It can reuse a previously allocated array.
@@ -217,6 +217,17 @@ row_log_get_max_trx(
 	dict_index_t*	index)	/*!< in: index, must be locked */
 	__attribute__((nonnull, warn_unused_result));
 
+/******************************************************//**
+Delays a DML operation on a table while the apply of an online
+ALTER TABLE modification log on the table is lagging behind by more than
+srv_online_log_throttle blocks. */
+
+void
+row_log_throttle(
+/*=============*/
+	const dict_table_t*	table)	/*!< in: table to be modified */
+	__attribute__((nonnull));
+
 /******************************************************//**
 Merge the row log to the index upon completing index creation.
 @return DB_SUCCESS, or error code on failure */
@@ -118,6 +118,78 @@ struct row_merge_dup_t {
 	ulint			n_dup;	/*!< number of duplicates */
 };
 
+/** Status of a parallel index sort thread */
+#define ROW_MERGE_CHILD_RUNNING		0
+#define ROW_MERGE_CHILD_COMPLETE	1
+#define ROW_MERGE_CHILD_EXITING		2
+
+/** State of a sort buffer handed over by the clustered index scan */
+enum row_merge_job_state_t {
+	ROW_MERGE_JOB_FREE,		/*!< the buffer is empty */
+	ROW_MERGE_JOB_QUEUED,		/*!< waiting to be sorted */
+	ROW_MERGE_JOB_RUNNING,		/*!< being sorted and written */
+	ROW_MERGE_JOB_FAILED		/*!< sorting or writing failed */
+};
+
+/** A sort buffer that a parallel sort thread sorts and writes
+to a merge file as one run */
+struct row_merge_job_t {
+	row_merge_job_state_t	state;	/*!< job state */
+	row_merge_buf_t*	buf;	/*!< sort buffer */
+	ulint			idx;	/*!< index number in
+					row_merge_build_indexes() */
+	int			fd;	/*!< merge file */
+	ulint			offset;	/*!< block offset of the run in fd */
+	ulint			seq;	/*!< sequence number of the job */
+	dberr_t			error;	/*!< error, if state is
+					ROW_MERGE_JOB_FAILED */
+};
+
+struct row_merge_psort_t;
+
+/** Common info passed to each parallel index sort thread */
+struct row_merge_psort_common_t {
+	trx_t*			trx;	/*!< transaction */
+	row_merge_psort_t*	all_info;/*!< all parallel sort info */
+	ulint			n_threads;/*!< number of parallel sort
+					threads */
+	os_event_t		event;	/*!< signalled by the parallel
+					sort threads */
+	os_event_t		job_event;/*!< signalled when a job is
+					queued or the scan completes */
+	ib_mutex_t		mutex;	/*!< protects jobs[] and
+					scan_complete */
+	row_merge_job_t*	jobs;	/*!< sort buffers of the clustered
+					index scan, or NULL */
+	ulint			n_jobs;	/*!< number of elements in jobs[] */
+	ulint			n_queued;/*!< number of jobs queued so far */
+	bool			scan_complete;/*!< true when the scan
+					will queue no more jobs */
+	row_merge_dup_t		dup;	/*!< index of the merge pass, with
+					dup.table == NULL */
+	const merge_file_t*	file;	/*!< input file of the merge pass */
+	const ulint*		run_offset;/*!< first offset of each run
+					in file */
+	ulint			n_run;	/*!< number of runs in file */
+	ulint*			out_offset;/*!< out: first offset of each
+					merged run in the output file */
+};
+
+/** Parallel index sort thread info */
+struct row_merge_psort_t {
+	ulint			psort_id;/*!< parallel sort thread number */
+	row_merge_block_t*	block;	/*!< 3 buffers */
+	row_merge_block_t*	block_alloc;/*!< buffer to be freed */
+	ulint			child_status;/*!< child thread status */
+	ulint			first;	/*!< first pair of runs to merge */
+	ulint			last;	/*!< last pair of runs to merge,
+					exclusive */
+	merge_file_t		of;	/*!< output of the merged runs */
+	dberr_t			error;	/*!< error of the merge */
+	row_merge_psort_common_t*
+				psort_common;/*!< common info */
+};
+
 /*************************************************************//**
 Report a duplicate key. */
 
@@ -369,7 +441,27 @@ row_merge_sort(
 	merge_file_t*		file,	/*!< in/out: file containing
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
-	int*			tmpfd)	/*!< in/out: temporary file handle */
+	int*			tmpfd,	/*!< in/out: temporary file handle */
+	row_merge_psort_t*	psort)	/*!< in/out: parallel sort threads,
+					or NULL to merge in this thread */
+	__attribute__((nonnull(1,2,3,4,5)));
+/*********************************************************************//**
+Create the info of srv_sort_pll_degree parallel index sort threads.
+@return parallel sort info, or NULL if index creation should not
+use parallel sort threads */
+
+row_merge_psort_t*
+row_merge_psort_create(
+/*===================*/
+	trx_t*		trx)	/*!< in: transaction */
+	__attribute__((nonnull, warn_unused_result));
+/*********************************************************************//**
+Free the info of the parallel index sort threads. */
+
+void
+row_merge_psort_destroy(
+/*====================*/
+	row_merge_psort_t*	psort)	/*!< in,own: parallel sort info */
 	__attribute__((nonnull));
 /*********************************************************************//**
 Allocate a sort buffer.
@@ -672,6 +672,10 @@ struct mysql_row_templ_t {
 };
 
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* The fetch cache of a long scan grows up to this many rows, as long as
+the cached rows take at most MYSQL_FETCH_CACHE_MAX_BYTES */
+#define MYSQL_FETCH_CACHE_SIZE_MAX	64
+#define MYSQL_FETCH_CACHE_MAX_BYTES	65536
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -845,7 +849,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE_MAX];
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
@@ -855,6 +859,13 @@ struct row_prebuilt_t {
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
 					start and at the end */
+	ulint		fetch_cache_capacity;/*!< number of allocated
+					buffers in fetch_cache */
+	ulint		fetch_cache_limit;/*!< number of rows to fill the
+					fetch cache with; this starts at
+					MYSQL_FETCH_CACHE_SIZE and doubles
+					while the same cursor keeps
+					fetching rows */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -891,6 +902,14 @@ struct row_prebuilt_t {
 	ulint		idx_cond_n_cols;/*!< Number of fields in idx_cond_cols.
 					0 if and only if idx_cond == NULL. */
 	/*----------------------*/
+	ibool		scan_resistant;	/*!< TRUE if the cursor releases
+					each leaf page it is done with by
+					buf_page_release_scanned(), because
+					the scan is larger than the old
+					sublist of the buffer pool LRU */
+	unsigned	scan_start_time;/*!< ut_time_ms() when the
+					scan-resistant scan started */
+	/*----------------------*/
 	unsigned	innodb_api:1;	/*!< whether this is a InnoDB API
 					query */
 	const rec_t*	innodb_api_rec;	/*!< InnoDB API search result */
@@ -0,0 +1,207 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel read of the clustered index
+
+Created 10/14/2013
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "dict0dict.h"
+#include "read0types.h"
+#include "rem0types.h"
+#include "trx0types.h"
+
+#include <vector>
+
+/** Reads the clustered index with several threads under one read view.
+The tree is split into key ranges along the node pointers of its upper
+levels, and the threads take the ranges one at a time until all of them
+have been scanned. Each visible record version is passed to a callback
+together with the number of the thread that read it, so that the callback
+can keep per-thread state without synchronisation. */
+class ParallelReader {
+public:
+	/**
+	Callback for each record version visible in the read view. It is
+	called while the leaf page is latched, so it must not access the
+	index itself.
+	@param thread_no	number of the reading thread,
+				less than n_threads()
+	@param rec		the visible record version
+	@param offsets		rec_get_offsets(rec, index)
+	@param arg		argument passed to run()
+	@return DB_SUCCESS, or an error to stop the whole read */
+	typedef dberr_t (*callback_t)(
+		ulint		thread_no,
+		const rec_t*	rec,
+		const ulint*	offsets,
+		void*		arg);
+
+	/**
+	Constructor
+	@param index		the clustered index to read
+	@param trx		transaction whose read view is used, or
+				whose isolation level is READ UNCOMMITTED
+	@param n_threads	maximum number of threads to use
+	@param check_keys	whether to check that the records are in
+				ascending order */
+	ParallelReader(
+		dict_index_t*	index,
+		trx_t*		trx,
+		ulint		n_threads,
+		bool		check_keys);
+
+	/**
+	Destructor */
+	~ParallelReader();
+
+	/**
+	Split the index into ranges and read them.
+	@param callback		callback for each visible record
+	@param arg		argument for the callback
+	@return DB_SUCCESS, DB_INTERRUPTED, DB_INDEX_CORRUPT if check_keys
+	found records out of order, or the error of the callback */
+	dberr_t run(callback_t callback, void* arg)
+		__attribute__((warn_unused_result));
+
+	/**
+	@return the number of threads that run() uses; valid after the
+	index has been split, otherwise the maximum */
+	ulint n_threads() const { return(m_n_threads); }
+
+	/**
+	Body of the additional reading threads.
+	@param arg		the ParallelReader::Thread to run */
+	static void thread_main(void* arg);
+
+private:
+	class Range;
+
+	/**
+	Split the index into key ranges along the node pointers of the
+	highest level that has enough of them. */
+	void partition();
+
+	/**
+	Read the ranges until there are none left.
+	@param thread_no	number of this thread */
+	void worker(ulint thread_no);
+
+	/**
+	Read one key range.
+	@param thread_no	number of this thread
+	@param range		the range to read
+	@return DB_SUCCESS or error code */
+	dberr_t read_range(ulint thread_no, const Range& range);
+
+	// Prevent copying
+	ParallelReader(const ParallelReader&);
+	ParallelReader& operator=(const ParallelReader&);
+
+private:
+	/** A key range [start, end) of the index; NULL means the
+	corresponding end of the index */
+	class Range {
+	public:
+		Range(const dtuple_t* start, const dtuple_t* end)
+			:
+			m_start(start),
+			m_end(end)
+		{
+		}
+
+		/** First key of the range */
+		const dtuple_t*	m_start;
+
+		/** First key after the range */
+		const dtuple_t*	m_end;
+	};
+
+	/** State of one additional reading thread */
+	struct Thread {
+		/** The reader */
+		ParallelReader*	m_reader;
+
+		/** Number of the thread */
+		ulint		m_thread_no;
+
+		/** Signalled when the thread has finished */
+		os_event_t	m_done;
+	};
+
+	typedef std::vector<Range> ranges_t;
+
+	/** The clustered index */
+	dict_index_t*	m_index;
+
+	/** The transaction doing the read */
+	trx_t*		m_trx;
+
+	/** Read view, or NULL for READ UNCOMMITTED */
+	ReadView*	m_view;
+
+	/** Number of threads to use */
+	ulint		m_n_threads;
+
+	/** Whether to check the order of the records */
+	bool		m_check_keys;
+
+	/** Memory heap for the range boundaries */
+	mem_heap_t*	m_heap;
+
+	/** The ranges to read */
+	ranges_t	m_ranges;
+
+	/** Index of the next range to read, protected by m_mutex */
+	ulint		m_next;
+
+	/** Protects m_next and m_err */
+	ib_mutex_t	m_mutex;
+
+	/** First error of any thread, protected by m_mutex */
+	dberr_t		m_err;
+
+	/** Callback for the visible records */
+	callback_t	m_callback;
+
+	/** Argument of the callback */
+	void*		m_arg;
+};
+
+/*********************************************************************//**
+Count the records of the clustered index that are visible in the read view
+of the transaction, reading it with srv_parallel_read_threads threads.
+@return DB_SUCCESS, DB_INTERRUPTED or DB_INDEX_CORRUPT */
+
+dberr_t
+row_pread_count(
+/*============*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_index_t*	index,		/*!< in: clustered index */
+	bool		check_keys,	/*!< in: true=check the order of
+					the records, as in CHECK TABLE */
+	ulint*		n_rows)		/*!< out: number of visible rows */
+	__attribute__((nonnull, warn_unused_result));
+
+#endif /* row0pread_h */
@@ -35,6 +35,10 @@ struct trx_t;
 /** The version number of the export meta-data text file. */
 #define IB_EXPORT_CFG_VERSION_V1	0x1UL
 
+/** Version 2 appends the state of the tablespace at the time of the export,
+that lets IMPORT skip the rewrite of every page. */
+#define IB_EXPORT_CFG_VERSION_V2	0x2UL
+
 /*********************************************************************//**
 Quiesce the tablespace that the table resides in. */
 
@@ -391,5 +391,15 @@ Truncates a table for MySQL.
 dberr_t
 row_truncate_table_for_mysql(dict_table_t* table, trx_t* trx);
 
+/**
+Empties an intrinsic table. The index trees are re-created in memory;
+there is nothing to log or commit because the table is visible only to
+the statement that created it.
+@param table		intrinsic table being emptied
+@return	error code or DB_SUCCESS */
+
+dberr_t
+row_truncate_intrinsic_table(dict_table_t* table);
+
 #endif /* row0trunc_h */
 
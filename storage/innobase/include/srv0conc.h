@@ -94,6 +94,14 @@ srv_conc_force_exit_innodb(
 	trx_t*	trx);		/*!< in: transaction object associated with
 				the thread */
 
+/*********************************************************************//**
+Adjust the admission limits of innodb_adaptive_concurrency to the
+throughput measured since the previous call. Called once per second. */
+
+void
+srv_conc_adapt(void);
+/*================*/
+
 /*********************************************************************//**
 Get the count of threads waiting inside InnoDB. */
 
@@ -30,6 +30,7 @@ Created 12/15/2009	Jimmy Yang
 
 #include "univ.i"
 #include "sync0mutex.h"
+#include "ut0counter.h"
 
 #ifndef UNIV_HOTBACKUP
 
@@ -132,6 +133,9 @@ enum monitor_id_t {
 	MONITOR_MODULE_LOCK,
 	MONITOR_DEADLOCK,
 	MONITOR_TIMEOUT,
+	MONITOR_DEADLOCK_CHECKS,
+	MONITOR_DEADLOCK_SEARCH_STEPS,
+	MONITOR_DEADLOCK_DETECT_LATENCY,
 	MONITOR_LOCKREC_WAIT,
 	MONITOR_TABLELOCK_WAIT,
 	MONITOR_NUM_RECLOCK_REQ,
@@ -183,6 +187,12 @@ enum monitor_id_t {
 	MONITOR_FLUSH_PCT_FOR_DIRTY,
 	MONITOR_FLUSH_PCT_FOR_LSN,
 	MONITOR_FLUSH_SYNC_WAITS,
+	MONITOR_FLUSH_ADAPTIVE_AVG_TIME_SLOT,
+	MONITOR_LRU_BATCH_FLUSH_AVG_TIME_SLOT,
+	MONITOR_FLUSH_ADAPTIVE_AVG_TIME_THREAD,
+	MONITOR_LRU_BATCH_FLUSH_AVG_TIME_THREAD,
+	MONITOR_FLUSH_AVG_TIME,
+	MONITOR_FLUSH_AVG_PASS,
 	MONITOR_FLUSH_ADAPTIVE_TOTAL_PAGE,
 	MONITOR_FLUSH_ADAPTIVE_COUNT,
 	MONITOR_FLUSH_ADAPTIVE_PAGES,
@@ -206,6 +216,7 @@ enum monitor_id_t {
 	MONITOR_LRU_SINGLE_FLUSH_SCANNED_PER_CALL,
 	MONITOR_LRU_SINGLE_FLUSH_FAILURE_COUNT,
 	MONITOR_LRU_GET_FREE_SEARCH,
+	MONITOR_LRU_GET_FREE_WAITS,
 	MONITOR_LRU_SEARCH_SCANNED,
 	MONITOR_LRU_SEARCH_SCANNED_NUM_CALL,
 	MONITOR_LRU_SEARCH_SCANNED_PER_CALL,
@@ -365,6 +376,10 @@ enum monitor_id_t {
 	MONITOR_OVLD_RWLOCK_S_OS_WAITS,
 	MONITOR_OVLD_RWLOCK_X_OS_WAITS,
 	MONITOR_OVLD_RWLOCK_SX_OS_WAITS,
+	MONITOR_CONC_RO_LIMIT,
+	MONITOR_CONC_RW_LIMIT,
+	MONITOR_CONC_LIMIT_INCREASED,
+	MONITOR_CONC_LIMIT_DECREASED,
 
 	/* Data DML related counters */
 	MONITOR_MODULE_DML_STATS,
@@ -457,11 +472,36 @@ counter option. */
 value */
 extern monitor_value_t	 innodb_counter_value[NUM_MONITOR];
 
+/** Number of per-CPU slots for the monitor counters */
+#define MONITOR_N_SLOTS		IB_N_SLOTS
+
+/** Running totals of the changes that MONITOR_INC(), MONITOR_DEC(),
+MONITOR_INC_VALUE() and MONITOR_DEC_VALUE() made to each monitor counter
+on one CPU. They are added to innodb_counter_value by srv_mon_fold()
+when the counters are read, turned on or off or reset, so that the
+hot paths do not write to cache lines shared with other CPUs. The
+padding keeps the totals of two slots off the same cache line. */
+struct monitor_slot_t {
+	mon_type_t	mon_value[NUM_MONITOR];	/*!< changes by this CPU */
+	byte		mon_pad[CACHE_LINE_SIZE];
+};
+
+/** The per-CPU changes of the monitor counters */
+extern monitor_slot_t	innodb_counter_slots[MONITOR_N_SLOTS];
+
+/** Access the total changes of a monitor counter on the current CPU */
+#define MONITOR_SLOT_VALUE(monitor)					\
+	(innodb_counter_slots[						\
+		default_indexer_t<mon_type_t, MONITOR_N_SLOTS>		\
+		::get_rnd_index() % MONITOR_N_SLOTS].mon_value[monitor])
+
 /** Following are macro defines for basic montior counter manipulations.
 Please note we do not provide any synchronization for these monitor
 operations due to performance consideration. Most counters can
 be placed under existing mutex protections in respective code
-module. */
+module. MONITOR_INC(), MONITOR_DEC(), MONITOR_INC_VALUE() and
+MONITOR_DEC_VALUE() update the per-CPU innodb_counter_slots, and
+the max and min values are only tracked when the slots are folded. */
 
 /** Macros to access various fields of a monitor counters */
 #define MONITOR_FIELD(monitor, field)			\
@@ -532,10 +572,7 @@ already exists. No additional mutex is necessary when operating
 on the counters */
 #define	MONITOR_INC(monitor)						\
 	if (MONITOR_IS_ON(monitor)) {					\
-		MONITOR_VALUE(monitor)++;				\
-		if (MONITOR_VALUE(monitor) > MONITOR_MAX_VALUE(monitor)) {  \
-			MONITOR_MAX_VALUE(monitor) = MONITOR_VALUE(monitor);\
-		}							\
+		MONITOR_SLOT_VALUE(monitor)++;				\
 	}
 
 /** Increment a monitor counter under mutex protection.
@@ -595,24 +632,10 @@ Use MONITOR_DEC if appropriate mutex protection exists.
 			MONITOR_MIN_VALUE(monitor) = value;		\
 		}							\
 	}
-# define srv_mon_create() ((void) 0)
-# define srv_mon_free() ((void) 0)
 #else /* HAVE_ATOMIC_BUILTINS_64 */
 /** Mutex protecting atomic operations on platforms that lack
 built-in operations for atomic memory access */
 extern ib_mutex_t	monitor_mutex;
-/****************************************************************//**
-Initialize the monitor subsystem. */
-
-void
-srv_mon_create(void);
-/*================*/
-/****************************************************************//**
-Close the monitor subsystem. */
-
-void
-srv_mon_free(void);
-/*==============*/
 
 /** Atomically increment a monitor counter.
 Use MONITOR_INC if appropriate mutex protection exists.
@@ -626,10 +649,7 @@ Use MONITOR_DEC if appropriate mutex protection exists.
 
 #define	MONITOR_DEC(monitor)						\
 	if (MONITOR_IS_ON(monitor)) {					\
-		MONITOR_VALUE(monitor)--;				\
-		if (MONITOR_VALUE(monitor) < MONITOR_MIN_VALUE(monitor)) {  \
-			MONITOR_MIN_VALUE(monitor) = MONITOR_VALUE(monitor);\
-		}							\
+		MONITOR_SLOT_VALUE(monitor)--;				\
 	}
 
 #ifdef UNIV_DEBUG_VALGRIND
@@ -644,20 +664,13 @@ Use MONITOR_DEC if appropriate mutex protection exists.
 #define	MONITOR_INC_VALUE(monitor, value)				\
 	MONITOR_CHECK_DEFINED(value);					\
 	if (MONITOR_IS_ON(monitor)) {					\
-		MONITOR_VALUE(monitor) += (mon_type_t) (value);		\
-		if (MONITOR_VALUE(monitor) > MONITOR_MAX_VALUE(monitor)) {  \
-			MONITOR_MAX_VALUE(monitor) = MONITOR_VALUE(monitor);\
-		}							\
+		MONITOR_SLOT_VALUE(monitor) += (mon_type_t) (value);	\
 	}
 
 #define	MONITOR_DEC_VALUE(monitor, value)				\
 	MONITOR_CHECK_DEFINED(value);					\
 	if (MONITOR_IS_ON(monitor)) {					\
-		ut_ad(MONITOR_VALUE(monitor) >= (mon_type_t) (value);	\
-		MONITOR_VALUE(monitor) -= (mon_type_t) (value);		\
-		if (MONITOR_VALUE(monitor) < MONITOR_MIN_VALUE(monitor)) {  \
-			MONITOR_MIN_VALUE(monitor) = MONITOR_VALUE(monitor);\
-		}							\
+		MONITOR_SLOT_VALUE(monitor) -= (mon_type_t) (value);	\
 	}
 
 /* Increment/decrement counter without check the monitor on/off bit, which
@@ -834,6 +847,26 @@ srv_mon_set_module_control(
 	mon_option_t	set_option);	/*!< in: Turn on/off reset the
 					counter */
 /****************************************************************//**
+Initialize the monitor subsystem. */
+
+void
+srv_mon_create(void);
+/*================*/
+/****************************************************************//**
+Close the monitor subsystem. */
+
+void
+srv_mon_free(void);
+/*==============*/
+/****************************************************************//**
+Add the changes that were made to innodb_counter_slots since the previous
+call to innodb_counter_value, and update the max and min values. This must
+be called before the counter values are read, turned on or off or reset. */
+
+void
+srv_mon_fold(void);
+/*==============*/
+/****************************************************************//**
 This function consolidates some existing server counters used
 by "system status variables". These existing system variables do not have
 mechanism to start/stop and reset the counters, so we simulate these
@@ -62,10 +62,10 @@ struct srv_stats_t {
 	typedef ib_counter_t<ib_int64_t, 1, single_indexer_t> ib_int64_ctr_1_t;
 
 	/** Count the amount of data written in total (in bytes) */
-	ulint_ctr_1_t		data_written;
+	ulint_ctr_64_t		data_written;
 
 	/** Number of the log write requests done */
-	ulint_ctr_1_t		log_write_requests;
+	ulint_ctr_64_t		log_write_requests;
 
 	/** Number of physical writes to the log performed */
 	ulint_ctr_1_t		log_writes;
@@ -88,7 +88,7 @@ struct srv_stats_t {
 	ulint_ctr_1_t		dblwr_pages_written;
 
 	/** Store the number of write requests issued */
-	ulint_ctr_1_t		buf_pool_write_requests;
+	ulint_ctr_64_t		buf_pool_write_requests;
 
 	/** Store the number of times when we had to wait for a free page
 	in the buffer pool. It happens when the buffer pool is full and we
@@ -101,10 +101,10 @@ struct srv_stats_t {
 
 	/** Number of buffer pool reads that led to the reading of
 	a disk page */
-	ulint_ctr_1_t		buf_pool_reads;
+	ulint_ctr_64_t		buf_pool_reads;
 
 	/** Number of data read in total (in bytes) */
-	ulint_ctr_1_t		data_read;
+	ulint_ctr_64_t		data_read;
 
 	/** Wait time of database locks */
 	ib_int64_ctr_1_t	n_lock_wait_time;
@@ -126,6 +126,12 @@ struct srv_stats_t {
 
 	/** Number of rows inserted */
 	ulint_ctr_64_t		n_rows_inserted;
+
+	/** Number of heap blocks taken from the per-thread caches */
+	ulint_ctr_64_t		n_mem_block_cache_hits;
+
+	/** Number of cacheable heap blocks that were not in the cache */
+	ulint_ctr_64_t		n_mem_block_cache_misses;
 };
 
 extern const char*	srv_main_thread_op_info;
@@ -142,6 +148,9 @@ extern os_event_t	srv_error_event;
 /** The buffer pool dump/load thread waits on this event. */
 extern os_event_t	srv_buf_dump_event;
 
+/** The buffer pool resize thread waits on this event. */
+extern os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 #define SRV_BUF_DUMP_FILENAME_DEFAULT	"ib_buffer_pool"
 extern char*		srv_buf_dump_filename;
@@ -188,11 +197,18 @@ extern my_bool	srv_read_only_mode;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 extern my_bool	srv_file_per_table;
+/** compress the pages of new ROW_FORMAT=DYNAMIC file-per-table
+tablespaces when writing them, and release the unused end of each
+page from the file */
+extern my_bool	srv_page_compression;
 /** Sleep delay for threads waiting to enter InnoDB. In micro-seconds. */
 extern	ulong	srv_thread_sleep_delay;
 #if defined(HAVE_ATOMIC_BUILTINS)
 /** Maximum sleep delay (in micro-seconds), value of 0 disables it.*/
 extern	ulong	srv_adaptive_max_sleep_delay;
+/** Adjust the limits of innodb_thread_concurrency to the measured
+throughput, separately for read-only and read-write threads */
+extern	my_bool	srv_adaptive_concurrency;
 #endif /* HAVE_ATOMIC_BUILTINS */
 
 /** The file format to use on new *.ibd files. */
@@ -207,8 +223,26 @@ extern ibool	srv_locks_unsafe_for_binlog;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of parallel sort threads in index creation */
+extern ulong	srv_sort_pll_degree;
+/** Percentage of each B-tree page filled when an index is built
+bottom-up from sorted entries */
+extern ulong	srv_fill_factor;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
+/** Number of threads that apply the modification log of online
+ALTER TABLE; 1 applies it in the ALTER TABLE thread only */
+extern ulong	srv_online_apply_threads;
+/** Number of modification log blocks that the log apply of online
+ALTER TABLE may fall behind before DML on the table is delayed;
+0 disables the delay */
+extern ulong	srv_online_log_throttle;
+/** Number of threads that read the clustered index in parallel for
+COUNT(*) and CHECK TABLE; 1 disables the parallel read */
+extern ulong	srv_parallel_read_threads;
+/** Whether the searches within an index page first compare normalized
+prefixes of the first key field */
+extern my_bool	srv_normalized_key_search;
 
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
@@ -232,6 +266,13 @@ extern ulint	srv_undo_tablespaces_open;
 /** The number of undo segments to use */
 extern ulong	srv_undo_logs;
 
+/** Enable or disable the truncation of undo tablespaces by purge. */
+extern my_bool	srv_undo_log_truncate;
+
+/** Size in bytes above which purge marks an undo tablespace for
+truncation. */
+extern unsigned long long	srv_max_undo_log_size;
+
 /** UNDO logs not redo logged, these logs reside in the temp tablespace.*/
 extern const ulong	srv_tmp_undo_logs;
 
@@ -244,6 +285,9 @@ extern ulong	srv_n_log_files;
 extern ib_uint64_t	srv_log_file_size;
 extern ib_uint64_t	srv_log_file_size_requested;
 extern ulint	srv_log_buffer_size;
+/** Whether dedicated threads write and flush the log for the committing
+threads */
+extern my_bool	srv_log_writer_threads;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
 extern char	srv_adaptive_flushing;
@@ -259,8 +303,19 @@ extern my_bool	srv_use_sys_malloc;
 extern ibool	srv_use_sys_malloc;
 #endif /* UNIV_HOTBACKUP */
 extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
+extern ulong	srv_buf_pool_chunk_unit;/*!< unit in bytes in which the
+					buffer pool is allocated and
+					resized */
 #define SRV_BUF_POOL_INSTANCES_NOT_SET	0
 extern ulong	srv_buf_pool_instances; /*!< requested number of buffer pool instances */
+extern my_bool	srv_numa_bind;		/*!< bind the buffer pool instances
+					and their threads to NUMA nodes */
+#define SRV_N_PAGE_CLEANERS_NOT_SET	0
+extern ulong	srv_n_page_cleaners;	/*!< number of page_cleaner threads,
+					the coordinator included */
+extern ulong	srv_n_recovery_threads;	/*!< number of threads reading
+					.ibd file headers and applying
+					redo log records during recovery */
 extern ulong	srv_n_page_hash_locks;	/*!< number of locks to
 					protect buf_pool->page_hash */
 extern ulong	srv_LRU_scan_depth;	/*!< Scan depth for LRU
@@ -271,6 +326,11 @@ extern ulint	srv_buf_pool_old_size;	/*!< previously requested size */
 extern ulint	srv_buf_pool_curr_size;	/*!< current size in bytes */
 extern ulong	srv_buf_pool_dump_pct;	/*!< dump that may % of each buffer
 					pool during BP dump */
+extern uint	srv_change_buffer_max_size;/*!< maximum on-disk size of the
+					change buffer, in percent of the
+					buffer pool size */
+extern ulong	srv_buf_pool_dump_interval;/*!< seconds between periodic
+					buffer pool dumps, 0 to disable */
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
 
@@ -328,9 +388,11 @@ extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
+extern ulong			srv_stats_histogram_buckets;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+extern ulong	srv_n_doublewrite_files;
 extern ulong	srv_checksum_algorithm;
 
 extern ulong	srv_max_buf_pool_modified_pct;
@@ -356,6 +418,9 @@ extern ibool	srv_error_monitor_active;
 /* TRUE during the lifetime of the buffer pool dump/load thread */
 extern ibool	srv_buf_dump_thread_active;
 
+/* TRUE during the lifetime of the buffer pool resize thread */
+extern ibool	srv_buf_resize_thread_active;
+
 /* TRUE during the lifetime of the stats thread */
 extern ibool	srv_dict_stats_thread_active;
 
@@ -407,6 +472,9 @@ extern ulong srv_sync_array_size;
 /* print all user-level transactions deadlocks to mysqld stderr */
 extern my_bool srv_print_all_deadlocks;
 
+/* leave deadlock detection to the deadlock detector thread */
+extern my_bool srv_deadlock_detect_async;
+
 extern my_bool	srv_cmp_per_index_enabled;
 
 /** Status variables to be passed to MySQL */
@@ -418,18 +486,25 @@ extern srv_stats_t	srv_stats;
 # ifdef UNIV_PFS_THREAD
 /* Keys to register InnoDB threads with performance schema */
 extern mysql_pfs_key_t	page_cleaner_thread_key;
+extern mysql_pfs_key_t	page_cleaner_worker_thread_key;
+extern mysql_pfs_key_t	lru_manager_thread_key;
 extern mysql_pfs_key_t	trx_rollback_clean_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
 extern mysql_pfs_key_t	io_ibuf_thread_key;
 extern mysql_pfs_key_t	io_log_thread_key;
 extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
+extern mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
+extern mysql_pfs_key_t	fil_load_thread_key;
 
 /* This macro register the current thread and its key with performance
 schema */
@@ -776,6 +851,8 @@ struct export_var_t{
 	ulint innodb_data_reads;		/*!< I/O read requests */
 	char  innodb_buffer_pool_dump_status[512];/*!< Buf pool dump status */
 	char  innodb_buffer_pool_load_status[512];/*!< Buf pool load status */
+	char  innodb_buffer_pool_resize_status[512];/*!< Buf pool resize
+						status */
 	ulint innodb_buffer_pool_pages_total;	/*!< Buffer pool size */
 	ulint innodb_buffer_pool_pages_data;	/*!< Data pages */
 	ulint innodb_buffer_pool_bytes_data;	/*!< File bytes used */
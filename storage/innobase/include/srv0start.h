@@ -146,6 +146,9 @@ extern	ibool	srv_startup_is_before_trx_rollback_phase;
 /** TRUE if a raw partition is in use */
 extern	ibool	srv_start_raw_disk_in_use;
 
+/** Default undo tablespace size in UNIV_PAGEs count (10MB). */
+extern	const ulint	SRV_UNDO_TABLESPACE_SIZE_IN_PAGES;
+
 
 /** Shutdown state */
 enum srv_shutdown_state {
@@ -218,6 +218,7 @@ enum latch_level_t {
 
 	SYNC_BUF_BLOCK,
 	SYNC_BUF_PAGE_HASH,
+	SYNC_DICT_TABLE_HASH,
 
 	SYNC_BUF_POOL,
 
@@ -240,6 +241,7 @@ enum latch_level_t {
 	SYNC_THREADS,
 	SYNC_TRX,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_REC_HASH,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
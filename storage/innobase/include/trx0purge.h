@@ -111,6 +111,53 @@ Resume purge, move to PURGE_STATE_RUN. */
 void
 trx_purge_run(void);
 /*================*/
+/*******************************************************************//**
+Check whether an undo tablespace is marked for truncation and purge
+should keep calling the history truncation until it has been truncated.
+@return true if an undo tablespace is marked for truncation */
+
+bool
+trx_purge_undo_trunc_pending(void);
+/*==============================*/
+/*******************************************************************//**
+Look for the truncate log files of undo tablespaces whose truncation was
+interrupted by a crash. Redo log records of such tablespaces are ignored
+during recovery and the truncation is completed by
+trx_purge_undo_trunc_fixup(). This is called before the redo log is
+applied. */
+
+void
+trx_purge_undo_trunc_scan(
+/*======================*/
+	ulint	n_undo_tablespaces);	/*!< in: number of open undo
+					tablespaces */
+/*******************************************************************//**
+Check whether the truncation of an undo tablespace is being completed
+at startup.
+@return true if the tablespace is being fixed up */
+
+bool
+trx_purge_undo_trunc_fixup_active(
+/*==============================*/
+	ulint	space_id);		/*!< in: tablespace id */
+/*******************************************************************//**
+Complete the truncation of the undo tablespaces found by
+trx_purge_undo_trunc_scan(): reinitialise the tablespaces and their
+rollback segment headers. This must be called after redo log recovery and
+before the rollback segments are loaded by trx_sys_init_at_db_start().
+@return DB_SUCCESS or error code */
+
+dberr_t
+trx_purge_undo_trunc_fixup(void);
+/*============================*/
+/*******************************************************************//**
+Make the completed truncations durable with a checkpoint and remove their
+truncate log files. This must be called after redo log recovery has
+finished. */
+
+void
+trx_purge_undo_trunc_fixup_done(void);
+/*=================================*/
 
 /** Purge states */
 enum purge_state_t {
@@ -184,6 +231,11 @@ struct trx_purge_t{
 	volatile ulint	n_submitted;	/*!< Count of total tasks submitted
 					to the task queue */
 	volatile ulint	n_completed;	/*!< Count of total tasks completed */
+	ulint		n_tables;	/*!< Number of tables that had undo
+					records in the last batch; no more
+					purge threads than this can be kept
+					busy, because all the records of a
+					table go to the same thread */
 
 	/*------------------------------*/
 	/* The following two fields form the 'purge pointer' which advances
@@ -126,6 +126,17 @@ trx_rseg_mem_free(
 	trx_rseg_t*	rseg,		/*!< in, own: instance to free */
 	trx_rseg_t**	rseg_array);	/*!< out: add rseg reference to this
 					central array. */
+/***************************************************************************
+Reset the memory object of a rollback segment whose undo tablespace was
+truncated and whose header was re-created. The rollback segment must not
+be in use by any transaction or by purge. */
+
+void
+trx_rseg_mem_reset(
+/*===============*/
+	trx_rseg_t*	rseg,		/*!< in/out: rollback segment */
+	ulint		page_no);	/*!< in: page number of the new
+					rollback segment header */
 /*********************************************************************
 Creates a rollback segment. */
 
@@ -193,6 +204,15 @@ struct trx_rseg_t{
 					yet purged log */
 	ibool		last_del_marks;	/*!< TRUE if the last not yet purged log
 					needs purging */
+	/*--------------------------------------------------------*/
+	bool		skip_allocation;/*!< true if the rollback segment
+					resides in an undo tablespace that
+					is marked for truncation and must
+					not be assigned to new transactions */
+	ulint		trx_ref_count;	/*!< number of transactions that have
+					been assigned this rollback segment
+					and are not yet committed or rolled
+					back */
 };
 
 /* Undo log segment slot in a rollback segment header */
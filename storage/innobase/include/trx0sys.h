@@ -673,6 +673,16 @@ struct trx_sys_t {
 
 	trx_ids_t	rw_trx_ids;	/*!< Read write transaction IDs */
 
+	ulint		rw_trx_ids_version;
+					/*!< Incremented whenever an id is
+					removed from rw_trx_ids; insertions
+					always come with a new max_trx_id.
+					If neither this nor max_trx_id has
+					changed, a read view still describes
+					the current snapshot and can be reused
+					without acquiring the mutex. Modified
+					under the mutex, read without it */
+
 	char		pad3[64];	/*!< To avoid false sharing */
 	trx_rseg_t*	rseg_array[TRX_SYS_N_RSEGS];
 					/*!< Pointer array to rollback
@@ -716,6 +716,16 @@ struct trx_lock_t {
 	time_t		wait_started;	/*!< lock wait started at this time,
 					protected only by lock_sys->mutex */
 
+	bool		in_deadlock_list;
+					/*!< true if the lock wait is in
+					lock_sys->deadlock_waits; protected
+					by lock_sys->latch in exclusive mode */
+
+	ullint		deadlock_queued;
+					/*!< time in microseconds when the
+					lock wait was added to
+					lock_sys->deadlock_waits */
+
 	que_thr_t*	wait_thr;	/*!< query thread belonging to this
 					trx that is in QUE_THR_LOCK_WAIT
 					state. For threads suspended in a
@@ -733,12 +743,14 @@ struct trx_lock_t {
 	ulint		table_cached;	/*!< Next free table lock in pool */
 
 	mem_heap_t*	lock_heap;	/*!< memory heap for trx_locks;
-					protected by lock_sys->mutex */
+					protected by trx->mutex and
+					lock_sys->latch */
 
 	trx_lock_list_t trx_locks;	/*!< locks requested by the transaction;
 					insertions are protected by trx->mutex
-					and lock_sys->mutex; removals are
-					protected by lock_sys->mutex */
+					and lock_sys->latch in any mode;
+					removals are protected by
+					lock_sys->latch in exclusive mode */
 
 	ib_vector_t*	table_locks;	/*!< All table locks requested by this
 					transaction, including AUTOINC locks */
@@ -853,6 +865,10 @@ struct trx_t{
 			no_list;	/*!< Required during view creation
 					to check for the view limit for
 					transactions that are committing */
+	UT_LIST_NODE_T(trx_t)
+			deadlock_list;	/*!< lock waits that the deadlock
+					detector thread has yet to check,
+					see lock_sys_t::deadlock_waits */
 
 	trx_id_t	id;		/*!< transaction id */
 
@@ -990,6 +1006,10 @@ struct trx_t{
 	bool		has_search_latch;
 					/*!< TRUE if this trx has latched the
 					search system latch in S-mode */
+	rw_lock_t*	search_latch;
+					/*!< the adaptive hash index partition
+					latch that this trx holds in S-mode
+					if has_search_latch, else NULL */
 	ulint		search_latch_timeout;
 					/*!< If we notice that someone is
 					waiting for our S-lock on the search
@@ -1013,6 +1033,10 @@ struct trx_t{
 					declared_to_... is TRUE; when we come
 					to srv_conc_innodb_enter, if the value
 					here is > 0, we decrement this by 1 */
+	ulint		conc_class;	/*!< read-only or read-write class
+					of innodb_adaptive_concurrency
+					that the thread entered InnoDB
+					through, or ULINT_UNDEFINED */
 	ib_uint32_t	dict_operation_lock_mode;
 					/*!< 0, RW_S_LATCH, or RW_X_LATCH:
 					the latch mode trx currently holds
@@ -1253,24 +1277,6 @@ struct commit_node_t{
 	mutex_exit(&t->mutex);			\
 } while (0)
 
-/** @brief The latch protecting the adaptive search system
-
-This latch protects the
-(1) hash index;
-(2) columns of a record to which we have a pointer in the hash index;
-
-but does NOT protect:
-
-(3) next record offset field in a record;
-(4) next or previous records on the same page.
-
-Bear in mind (3) and (4) when using the hash index.
-*/
-extern rw_lock_t*	btr_search_latch_temp;
-
-/** The latch protecting the adaptive search system */
-#define btr_search_latch	(*btr_search_latch_temp)
-
 #ifndef UNIV_NONINL
 #include "trx0trx.ic"
 #endif
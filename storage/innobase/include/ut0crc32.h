@@ -48,4 +48,23 @@ extern ib_ut_crc32_t	ut_crc32;
 
 extern bool	ut_crc32_sse2_enabled;
 
+/** Name of the implementation that ut_crc32 points to */
+extern const char*	ut_crc32_implementation;
+
+/** A CRC32 implementation */
+struct ut_crc32_impl_t {
+	const char*	name;	/*!< name of the implementation */
+	ib_ut_crc32_t	func;	/*!< the function */
+};
+
+/********************************************************************//**
+Returns the CRC32 implementations that the CPU supports, the one that
+ut_crc32 points to first. Valid after ut_crc32_init().
+@return array of implementations */
+
+const ut_crc32_impl_t*
+ut_crc32_get_impls(
+/*===============*/
+	ulint*	n);	/*!< out: number of implementations */
+
 #endif /* ut0crc32_h */
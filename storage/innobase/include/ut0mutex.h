@@ -31,6 +31,7 @@ Created 2012-03-24 Sunny Bains.
 extern ulong	srv_spin_wait_delay;
 extern ulong	srv_n_spin_wait_rounds;
 extern ulong	srv_force_recovery_crash;
+extern ulint	srv_fatal_semaphore_wait_threshold;
 
 #include "os0atomic.h"
 #include "sync0policy.h"
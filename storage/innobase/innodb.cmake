@@ -29,15 +29,54 @@ IF(UNIX)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
     ENDIF()
+    # Hole punching for transparent page compression
+    CHECK_C_SOURCE_COMPILES("
+    #define _GNU_SOURCE
+    #include <fcntl.h>
+    #include <linux/falloc.h>
+    int main() {
+      return(fallocate(0, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, 0));
+    }"
+    HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE)
+    IF(HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE)
+      ADD_DEFINITIONS(-DHAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE=1)
+    ENDIF()
+    # NUMA placement of buffer pool instances
+    CHECK_INCLUDE_FILES (numa.h HAVE_NUMA_H)
+    CHECK_LIBRARY_EXISTS(numa numa_available "" HAVE_LIBNUMA)
+    IF(HAVE_NUMA_H AND HAVE_LIBNUMA)
+      ADD_DEFINITIONS(-DHAVE_LIBNUMA=1)
+      LINK_LIBRARIES(numa)
+    ENDIF()
   ELSEIF(CMAKE_SYSTEM_NAME STREQUAL "SunOS")
     ADD_DEFINITIONS("-DUNIV_SOLARIS")
   ENDIF()
 ENDIF()
 
+# Optional page compression algorithms for ROW_FORMAT=COMPRESSED,
+# used if the system provides them
+CHECK_INCLUDE_FILES (lz4.h HAVE_LZ4_H)
+CHECK_LIBRARY_EXISTS(lz4 LZ4_compress_default "" HAVE_LZ4)
+IF(HAVE_LZ4_H AND HAVE_LZ4)
+  ADD_DEFINITIONS(-DHAVE_LZ4=1)
+  LINK_LIBRARIES(lz4)
+ENDIF()
+
+CHECK_INCLUDE_FILES (zstd.h HAVE_ZSTD_H)
+CHECK_LIBRARY_EXISTS(zstd ZSTD_compress "" HAVE_ZSTD)
+IF(HAVE_ZSTD_H AND HAVE_ZSTD)
+  ADD_DEFINITIONS(-DHAVE_ZSTD=1)
+  LINK_LIBRARIES(zstd)
+ENDIF()
+
 OPTION(INNODB_COMPILER_HINTS "Compile InnoDB with compiler hints" ON)
 MARK_AS_ADVANCED(INNODB_COMPILER_HINTS)
 
-SET(MUTEXTYPE "event" CACHE STRING "Mutex type: event, sys or futex")
+IF(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  SET(MUTEXTYPE "futex" CACHE STRING "Mutex type: event, sys or futex")
+ELSE()
+  SET(MUTEXTYPE "event" CACHE STRING "Mutex type: event, sys or futex")
+ENDIF()
 
 IF(CMAKE_CXX_COMPILER_ID MATCHES "GNU")
 # After: WL#5825 Using C++ Standard Library with MySQL code
@@ -302,10 +341,11 @@ IF(NOT DEFINED HAVE_IB_GCC_ATOMIC_BUILTINS
 
 ENDIF()
 
-IF(MUTEXTYPE MATCHES "event")
-  ADD_DEFINITIONS(-DMUTEX_EVENT)
-ELSEIF(MUTEXTYPE MATCHES "futex" AND DEFINED HAVE_IB_LINUX_FUTEX)
+IF(MUTEXTYPE MATCHES "futex" AND HAVE_IB_LINUX_FUTEX)
   ADD_DEFINITIONS(-DMUTEX_FUTEX)
+ELSEIF(MUTEXTYPE MATCHES "event" OR MUTEXTYPE MATCHES "futex")
+  # Without futex support, fall back to the default of other systems
+  ADD_DEFINITIONS(-DMUTEX_EVENT)
 ELSE()
    ADD_DEFINITIONS(-DMUTEX_SYS)
 ENDIF()
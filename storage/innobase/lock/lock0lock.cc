@@ -40,6 +40,8 @@ Created 5/7/1996 Heikki Tuuri
 #include "trx0purge.h"
 #include "trx0sys.h"
 #include "srv0mon.h"
+#include "srv0start.h"
+#include "sync0sync.h"
 #include "ut0vec.h"
 #include "btr0btr.h"
 #include "dict0boot.h"
@@ -375,6 +377,12 @@ public:
 		const lock_t*	lock,
 		const trx_t*	trx);
 
+	/** Checks a lock wait that was queued for the deadlock detector
+	thread. If the waiting transaction is chosen as the victim, its
+	lock wait is cancelled and it will be rolled back.
+	@param trx transaction waiting for a lock */
+	static void check_and_resolve_async(trx_t* trx);
+
 private:
 	/** Do a shallow copy. Default destructor OK.
 	@param trx the start transaction (start node)
@@ -589,6 +597,26 @@ bool	lock_deadlock_found = false;
 /** Only created if !srv_read_only_mode */
 static FILE*		lock_latest_err_file;
 
+#ifdef UNIV_DEBUG
+/** Test if the current thread protects the queue of a lock. A table lock
+queue is protected by lock_sys->latch in exclusive mode; a record lock
+queue is also protected by the mutex of its page.
+@param[in]	lock	table or record lock
+@return whether the lock queue is protected */
+static
+bool
+lock_queue_own(
+	const lock_t*	lock)
+{
+	if (lock_get_type_low(lock) != LOCK_REC) {
+		return(lock_mutex_own());
+	}
+
+	return(lock_rec_mutex_own(lock->un_member.rec_lock.space,
+				  lock->un_member.rec_lock.page_no));
+}
+#endif /* UNIV_DEBUG */
+
 /*********************************************************************//**
 Gets the nth bit of a record lock.
 @return TRUE if bit set also if i == ULINT_UNDEFINED return FALSE*/
@@ -774,14 +802,29 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create("lock_sys", &lock_sys->mutex);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
 
 	mutex_create("lock_sys_wait", &lock_sys->wait_mutex);
 
 	lock_sys->timeout_event = os_event_create(0);
 
+	lock_sys->deadlock_event = os_event_create(0);
+
+	UT_LIST_INIT(lock_sys->deadlock_waits, &trx_t::deadlock_list);
+
 	lock_sys->rec_hash = hash_create(n_cells);
 
+	for (ulint i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+
+		/* Round the allocation up to a whole number of cache
+		lines so that no two partition mutexes share one. */
+		lock_sys->rec_mutexes[i] = static_cast<LockMutex*>(
+			mem_alloc(ut_calc_align(sizeof(LockMutex),
+						CACHE_LINE_SIZE)));
+
+		mutex_create("lock_rec_hash", lock_sys->rec_mutexes[i]);
+	}
+
 	if (!srv_read_only_mode) {
 		lock_latest_err_file = os_file_create_tmpfile();
 		ut_a(lock_latest_err_file);
@@ -802,9 +845,16 @@ lock_sys_close(void)
 
 	hash_table_free(lock_sys->rec_hash);
 
+	for (ulint i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_destroy(lock_sys->rec_mutexes[i]);
+		mem_free(lock_sys->rec_mutexes[i]);
+	}
+
 	os_event_destroy(lock_sys->timeout_event);
 
-	mutex_destroy(&lock_sys->mutex);
+	os_event_destroy(lock_sys->deadlock_event);
+
+	rw_lock_free(&lock_sys->latch);
 	mutex_destroy(&lock_sys->wait_mutex);
 
 	srv_slot_t*	slot = lock_sys->waiting_threads;
@@ -1012,7 +1062,7 @@ lock_set_lock_and_trx_wait(
 	ut_ad(lock);
 	ut_ad(lock->trx == trx);
 	ut_ad(trx->lock.wait_lock == NULL);
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 	ut_ad(trx_mutex_own(trx));
 
 	trx->lock.wait_lock = lock;
@@ -1029,7 +1079,7 @@ lock_reset_lock_and_trx_wait(
 	lock_t*	lock)	/*!< in/out: record lock */
 {
 	ut_ad(lock_get_wait(lock));
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	/* Reset the back pointer in trx to this waiting lock request */
 	if (!(lock->type_mode & LOCK_CONV_BY_OTHER)) {
@@ -1329,8 +1379,8 @@ lock_rec_get_next_on_page_const(
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
+	ut_ad(lock_queue_own(lock));
 
 	space = lock->un_member.rec_lock.space;
 	page_no = lock->un_member.rec_lock.page_no;
@@ -1378,7 +1428,7 @@ lock_rec_get_first_on_page_addr(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own(space, page_no));
 
 	for (lock = static_cast<lock_t*>(
 			HASH_GET_FIRST(lock_sys->rec_hash,
@@ -1408,9 +1458,9 @@ lock_rec_expl_exist_on_page(
 {
 	lock_t*	lock;
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 	lock = lock_rec_get_first_on_page_addr(space, page_no);
-	lock_mutex_exit();
+	lock_rec_mutex_exit(space, page_no);
 
 	return(lock);
 }
@@ -1430,7 +1480,7 @@ lock_rec_get_first_on_page(
 	ulint	space	= buf_block_get_space(block);
 	ulint	page_no	= buf_block_get_page_no(block);
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own(space, page_no));
 
 	hash = buf_block_get_lock_hash_val(block);
 
@@ -1459,7 +1509,7 @@ lock_rec_get_next(
 	ulint	heap_no,/*!< in: heap number of the record */
 	lock_t*	lock)	/*!< in: lock */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	do {
 		ut_ad(lock_get_type_low(lock) == LOCK_REC);
@@ -1494,7 +1544,7 @@ lock_rec_get_first(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 
 	for (lock = lock_rec_get_first_on_page(block); lock;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -1661,7 +1711,7 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1711,7 +1761,7 @@ lock_rec_other_has_expl_req(
 {
 	const lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	for (lock = lock_rec_get_first(block, heap_no);
@@ -1752,7 +1802,7 @@ lock_rec_other_has_conflicting(
 	const lock_t*		lock;
 	ibool			is_supremum;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 
 	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1782,7 +1832,7 @@ lock_rec_find_similar_on_page(
 	lock_t*		lock,		/*!< in: lock_rec_get_first_on_page() */
 	const trx_t*	trx)		/*!< in: transaction */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock == NULL || lock_queue_own(lock));
 
 	for (/* No op */;
 	     lock != NULL;
@@ -1942,7 +1992,7 @@ lock_rec_create(
 	ulint		n_bytes;
 	const page_t*	page;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -1975,6 +2025,15 @@ lock_rec_create(
 	n_bits = page_dir_get_n_heap(page) + LOCK_PAGE_BITMAP_MARGIN;
 	n_bytes = 1 + n_bits / 8;
 
+	/* The lock may be created on behalf of another transaction
+	while only lock_sys->latch is held in shared mode: trx->mutex
+	protects the lock pool and heap of the transaction. */
+
+	if (!caller_owns_trx_mutex) {
+		trx_mutex_enter(trx);
+	}
+	ut_ad(trx_mutex_own(trx));
+
 	if (trx->lock.rec_cached >= trx->lock.rec_pool.size()
 	    || sizeof(lock_t) + n_bytes > REC_LOCK_SIZE) {
 
@@ -2002,18 +2061,15 @@ lock_rec_create(
 	/* Set the bit corresponding to rec */
 	lock_rec_set_nth_bit(lock, heap_no);
 
-	index->table->n_rec_locks++;
+	/* Record locks on different pages of the table may be
+	created concurrently. */
+	os_atomic_increment_ulint(&index->table->n_rec_locks, 1);
 
 	ut_ad(index->table->n_ref_count > 0 || !index->table->can_be_evicted);
 
 	HASH_INSERT(lock_t, hash, lock_sys->rec_hash,
 		    lock_rec_fold(space, page_no), lock);
 
-	if (!caller_owns_trx_mutex) {
-		trx_mutex_enter(trx);
-	}
-	ut_ad(trx_mutex_own(trx));
-
 	if (lock_is_wait_not_by_other(type_mode)) {
 
 		lock_set_lock_and_trx_wait(lock, trx);
@@ -2025,12 +2081,55 @@ lock_rec_create(
 		trx_mutex_exit(trx);
 	}
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
 	return(lock);
 }
 
+/*********************************************************************//**
+Queues a lock wait for the deadlock detector thread. */
+static
+void
+lock_deadlock_queue(
+/*================*/
+	trx_t*	trx)	/*!< in/out: transaction that has to wait */
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(trx_mutex_own(trx));
+
+	if (trx->lock.in_deadlock_list) {
+		return;
+	}
+
+	bool	was_empty = UT_LIST_GET_LEN(lock_sys->deadlock_waits) == 0;
+
+	trx->lock.in_deadlock_list = true;
+	trx->lock.deadlock_queued = ut_time_us(NULL);
+
+	UT_LIST_ADD_LAST(lock_sys->deadlock_waits, trx);
+
+	if (was_empty) {
+		os_event_set(lock_sys->deadlock_event);
+	}
+}
+
+/*********************************************************************//**
+Removes a transaction from the queue of the deadlock detector thread. */
+static
+void
+lock_deadlock_dequeue(
+/*==================*/
+	trx_t*	trx)	/*!< in/out: transaction */
+{
+	ut_ad(lock_mutex_own());
+
+	if (trx->lock.in_deadlock_list) {
+		UT_LIST_REMOVE(lock_sys->deadlock_waits, trx);
+		trx->lock.in_deadlock_list = false;
+	}
+}
+
 /*********************************************************************//**
 Enqueues a waiting request for a lock which cannot be granted immediately.
 Checks for deadlocks.
@@ -2121,9 +2220,11 @@ lock_rec_enqueue_waiting(
 
 	trx_mutex_exit(trx);
 
+	const bool	async = srv_deadlock_detect_async;
 	const trx_t*	victim_trx;
 
-	victim_trx = DeadlockChecker::check_and_resolve(lock, trx);
+	victim_trx = async
+		? 0 : DeadlockChecker::check_and_resolve(lock, trx);
 
 	trx_mutex_enter(trx);
 
@@ -2150,6 +2251,10 @@ lock_rec_enqueue_waiting(
 	trx->lock.was_chosen_as_deadlock_victim = false;
 	trx->lock.wait_started = ut_time();
 
+	if (async) {
+		lock_deadlock_queue(trx);
+	}
+
 	ut_a(que_thr_stop(thr));
 
 	DBUG_PRINT("ib_lock", ("wait for trx " TRX_ID_FMT
@@ -2188,7 +2293,7 @@ lock_rec_add_to_queue(
 	lock_t*	lock;
 	lock_t*	first_lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 #ifdef UNIV_DEBUG
@@ -2302,7 +2407,7 @@ lock_rec_lock_fast(
 	trx_t*			trx;
 	enum lock_rec_req_status status = LOCK_REC_SUCCESS;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -2360,6 +2465,9 @@ This is the general, and slower, routine for locking a record. This is a
 low-level function which does NOT look at implicit locks! Checks lock
 compatibility within explicit locks. This function sets a normal next-key
 lock, or in the case of a page supremum record, a gap type lock.
+If the request has to wait and the caller does not hold lock_sys->latch
+in exclusive mode, nothing is enqueued and DB_LOCK_WAIT is returned; the
+caller must then retry with the exclusive latch.
 @return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -2377,13 +2485,17 @@ lock_rec_lock_slow(
 					the record */
 	ulint			heap_no,/*!< in: heap number of record */
 	dict_index_t*		index,	/*!< in: index of record */
-	que_thr_t*		thr)	/*!< in: query thread */
+	que_thr_t*		thr,	/*!< in: query thread */
+	bool			exclusive)
+					/*!< in: whether lock_sys->latch
+					is held in exclusive mode */
 {
 	trx_t*			trx;
 	lock_t*			lock;
 	dberr_t			err = DB_SUCCESS;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
+	ut_ad(exclusive == lock_mutex_own());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -2436,8 +2548,14 @@ lock_rec_lock_slow(
 
 		ut_ad(lock == NULL);
 enqueue_waiting:
-		err = lock_rec_enqueue_waiting(
-			mode, block, heap_no, lock, index, thr);
+		if (!exclusive) {
+			/* Deadlock detection and lock waits require
+			the exclusive lock_sys->latch. */
+			err = DB_LOCK_WAIT;
+		} else {
+			err = lock_rec_enqueue_waiting(
+				mode, block, heap_no, lock, index, thr);
+		}
 
 	} else if (!impl) {
 		/* Set the requested lock on the record, note that
@@ -2454,12 +2572,58 @@ enqueue_waiting:
 	return(err);
 }
 
+/*********************************************************************//**
+Tries to lock the specified record in the mode requested, first with the
+fast routine and then with the general one. The caller must hold the
+record lock mutex of the page.
+@return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
+or DB_QUE_THR_SUSPENDED */
+static
+dberr_t
+lock_rec_lock_low(
+/*==============*/
+	ibool			impl,	/*!< in: if TRUE, no lock is set
+					if no wait is necessary: we
+					assume that the caller will
+					set an implicit lock */
+	ulint			mode,	/*!< in: lock mode: LOCK_X or
+					LOCK_S possibly ORed to either
+					LOCK_GAP or LOCK_REC_NOT_GAP */
+	const buf_block_t*	block,	/*!< in: buffer block containing
+					the record */
+	ulint			heap_no,/*!< in: heap number of record */
+	dict_index_t*		index,	/*!< in: index of record */
+	que_thr_t*		thr,	/*!< in: query thread */
+	bool			exclusive)
+					/*!< in: whether lock_sys->latch
+					is held in exclusive mode */
+{
+	/* We try a simplified and faster subroutine for the most
+	common cases */
+	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	case LOCK_REC_SUCCESS:
+		return(DB_SUCCESS);
+	case LOCK_REC_SUCCESS_CREATED:
+		return(DB_SUCCESS_LOCKED_REC);
+	case LOCK_REC_FAIL:
+		return(lock_rec_lock_slow(impl, mode, block,
+					  heap_no, index, thr, exclusive));
+	}
+
+	ut_error;
+	return(DB_ERROR);
+}
+
 /*********************************************************************//**
 Tries to lock the specified record in the mode requested. If not immediately
 possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
 of a page supremum record, a gap type lock.
+
+The request is first attempted while holding lock_sys->latch in shared
+mode and the record lock mutex of the page only. If it has to wait, it
+is retried while holding lock_sys->latch in exclusive mode.
 @return DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -2479,7 +2643,11 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	dberr_t	err;
+	ulint	space	= buf_block_get_space(block);
+	ulint	page_no	= buf_block_get_page_no(block);
+
+	ut_ad(!lock_mutex_own());
 	ut_ad(!srv_read_only_mode);
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
@@ -2492,20 +2660,25 @@ lock_rec_lock(
 	      || mode - (LOCK_MODE_MASK & mode) == 0);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
-	/* We try a simplified and faster subroutine for the most
-	common cases */
-	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
-	case LOCK_REC_SUCCESS:
-		return(DB_SUCCESS);
-	case LOCK_REC_SUCCESS_CREATED:
-		return(DB_SUCCESS_LOCKED_REC);
-	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+	lock_rec_mutex_enter(space, page_no);
+
+	err = lock_rec_lock_low(
+		impl, mode, block, heap_no, index, thr, false);
+
+	lock_rec_mutex_exit(space, page_no);
+
+	if (err == DB_LOCK_WAIT) {
+		/* The queue may have changed after we released the
+		record lock mutex: check it again. */
+		lock_mutex_enter();
+
+		err = lock_rec_lock_low(
+			impl, mode, block, heap_no, index, thr, true);
+
+		lock_mutex_exit();
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	return(err);
 }
 
 /*********************************************************************//**
@@ -2524,9 +2697,9 @@ lock_rec_has_to_wait_in_queue(
 	ulint		bit_mask;
 	ulint		bit_offset;
 
-	ut_ad(lock_mutex_own());
-	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
+	ut_ad(lock_queue_own(wait_lock));
+	ut_ad(lock_get_wait(wait_lock));
 
 	space = wait_lock->un_member.rec_lock.space;
 	page_no = wait_lock->un_member.rec_lock.page_no;
@@ -2554,14 +2727,15 @@ lock_rec_has_to_wait_in_queue(
 
 /*************************************************************//**
 Grants a lock to a waiting lock request and releases the waiting transaction.
-The caller must hold lock_sys->mutex but not lock->trx->mutex. */
+The caller must protect the lock queue (see lock_sys_t::latch) but must not
+hold lock->trx->mutex. */
 static
 void
 lock_grant(
 /*=======*/
 	lock_t*	lock)	/*!< in/out: waiting lock request */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -2615,8 +2789,8 @@ lock_rec_cancel(
 {
 	que_thr_t*	thr;
 
-	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
+	ut_ad(lock_queue_own(lock));
 	ut_ad(!(lock->type_mode & LOCK_CONV_BY_OTHER));
 
 	/* Reset the bit (there can be only one set bit) in the lock bitmap */
@@ -2778,7 +2952,7 @@ lock_rec_reset_and_release_wait(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(block));
 
 	for (lock = lock_rec_get_first(block, heap_no);
 	     lock != NULL;
@@ -2818,7 +2992,8 @@ lock_rec_inherit_to_gap(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(heir_block));
+	ut_ad(lock_rec_mutex_own_block(block));
 
 	/* If srv_locks_unsafe_for_binlog is TRUE or session is using
 	READ COMMITTED isolation level, we do not want locks set
@@ -2861,8 +3036,10 @@ lock_rec_inherit_to_gap_if_gap_lock(
 						on this record */
 {
 	lock_t*	lock;
+	ulint	space	= buf_block_get_space(block);
+	ulint	page_no	= buf_block_get_page_no(block);
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 
 	for (lock = lock_rec_get_first(block, heap_no);
 	     lock != NULL;
@@ -2879,7 +3056,7 @@ lock_rec_inherit_to_gap_if_gap_lock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_rec_mutex_exit(space, page_no);
 }
 
 /*************************************************************//**
@@ -2902,7 +3079,8 @@ lock_rec_move(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_mutex_own_block(receiver));
+	ut_ad(lock_rec_mutex_own_block(donator));
 
 	ut_ad(lock_rec_get_first(receiver, receiver_heap_no) == NULL);
 
@@ -3586,6 +3764,8 @@ lock_update_delete(
 	const rec_t*		rec)	/*!< in: the record to be removed */
 {
 	const page_t*	page = block->frame;
+	ulint		space = buf_block_get_space(block);
+	ulint		page_no = buf_block_get_page_no(block);
 	ulint		heap_no;
 	ulint		next_heap_no;
 
@@ -3603,7 +3783,7 @@ lock_update_delete(
 								       FALSE));
 	}
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 
 	/* Let the next record inherit the locks from rec, in gap mode */
 
@@ -3613,7 +3793,7 @@ lock_update_delete(
 
 	lock_rec_reset_and_release_wait(block, heap_no);
 
-	lock_mutex_exit();
+	lock_rec_mutex_exit(space, page_no);
 }
 
 /*********************************************************************//**
@@ -3636,13 +3816,16 @@ lock_rec_store_on_page_infimum(
 {
 	ulint	heap_no = page_rec_get_heap_no(rec);
 
+	ulint	space = buf_block_get_space(block);
+	ulint	page_no = buf_block_get_page_no(block);
+
 	ut_ad(block->frame == page_align(rec));
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 
 	lock_rec_move(block, block, PAGE_HEAP_NO_INFIMUM, heap_no);
 
-	lock_mutex_exit();
+	lock_rec_mutex_exit(space, page_no);
 }
 
 /*********************************************************************//**
@@ -3948,9 +4131,11 @@ lock_table_enqueue_waiting(
 
 	trx_mutex_exit(trx);
 
+	const bool	async = srv_deadlock_detect_async;
 	const trx_t*	victim_trx;
 
-	victim_trx = DeadlockChecker::check_and_resolve(lock, trx);
+	victim_trx = async
+		? 0 : DeadlockChecker::check_and_resolve(lock, trx);
 
 	trx_mutex_enter(trx);
 
@@ -3975,6 +4160,10 @@ lock_table_enqueue_waiting(
 	trx->lock.wait_started = ut_time();
 	trx->lock.was_chosen_as_deadlock_victim = false;
 
+	if (async) {
+		lock_deadlock_queue(trx);
+	}
+
 	ut_a(que_thr_stop(thr));
 
 	MONITOR_INC(MONITOR_TABLELOCK_WAIT);
@@ -4217,6 +4406,8 @@ lock_rec_unlock(
 	lock_t*		first_lock;
 	lock_t*		lock;
 	ulint		heap_no;
+	ulint		space;
+	ulint		page_no;
 	const char*	stmt;
 	size_t		stmt_len;
 
@@ -4227,8 +4418,10 @@ lock_rec_unlock(
 	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
 
 	heap_no = page_rec_get_heap_no(rec);
+	space = buf_block_get_space(block);
+	page_no = buf_block_get_page_no(block);
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 	trx_mutex_enter(trx);
 
 	first_lock = lock_rec_get_first(block, heap_no);
@@ -4243,7 +4436,7 @@ lock_rec_unlock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_rec_mutex_exit(space, page_no);
 	trx_mutex_exit(trx);
 
 	stmt = innobase_get_stmt(trx->mysql_thd, &stmt_len);
@@ -4262,6 +4455,11 @@ released:
 	ut_a(!lock_get_wait(lock));
 	lock_rec_reset_nth_bit(lock, heap_no);
 
+	/* Other lock queues may be modified concurrently: in order to
+	avoid a deadlock between trx->mutex of different transactions,
+	we must not hold our own trx->mutex while granting locks. */
+	trx_mutex_exit(trx);
+
 	/* Check if we can now grant waiting lock requests */
 
 	for (lock = first_lock; lock != NULL;
@@ -4275,8 +4473,7 @@ released:
 		}
 	}
 
-	lock_mutex_exit();
-	trx_mutex_exit(trx);
+	lock_rec_mutex_exit(space, page_no);
 }
 
 #ifdef UNIV_DEBUG
@@ -5744,6 +5941,8 @@ lock_rec_insert_check_and_lock(
 	lock_t*		lock;
 	dberr_t		err;
 	ulint		next_rec_heap_no;
+	ulint		space;
+	ulint		page_no;
 
 	ut_ad(block->frame == page_align(rec));
 	ut_ad(!dict_index_is_online_ddl(index)
@@ -5759,8 +5958,10 @@ lock_rec_insert_check_and_lock(
 	trx = thr_get_trx(thr);
 	next_rec = page_rec_get_next_const(rec);
 	next_rec_heap_no = page_rec_get_heap_no(next_rec);
+	space = buf_block_get_space(block);
+	page_no = buf_block_get_page_no(block);
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -5775,7 +5976,7 @@ lock_rec_insert_check_and_lock(
 	if (UNIV_LIKELY(lock == NULL)) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
+		lock_rec_mutex_exit(space, page_no);
 
 		if (!dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -5801,24 +6002,42 @@ lock_rec_insert_check_and_lock(
 	had to wait for their insert. Both had waiting gap type lock requests
 	on the successor, which produced an unnecessary deadlock. */
 
-	if (lock_rec_other_has_conflicting(
+	if (!lock_rec_other_has_conflicting(
 		    static_cast<enum lock_mode>(
 			    LOCK_X | LOCK_GAP | LOCK_INSERT_INTENTION),
 		    block, next_rec_heap_no, trx)) {
 
-		/* Note that we may get DB_SUCCESS also here! */
-		trx_mutex_enter(trx);
+		err = DB_SUCCESS;
 
-		err = lock_rec_enqueue_waiting(
-			LOCK_X | LOCK_GAP | LOCK_INSERT_INTENTION,
-			block, next_rec_heap_no, NULL, index, thr);
+		lock_rec_mutex_exit(space, page_no);
 
-		trx_mutex_exit(trx);
 	} else {
-		err = DB_SUCCESS;
-	}
+		/* Waiting requires the exclusive lock_sys->latch.
+		The conflicting lock may have been released meanwhile,
+		so check again. */
 
-	lock_mutex_exit();
+		lock_rec_mutex_exit(space, page_no);
+		lock_mutex_enter();
+
+		if (lock_rec_other_has_conflicting(
+			    static_cast<enum lock_mode>(
+				    LOCK_X | LOCK_GAP | LOCK_INSERT_INTENTION),
+			    block, next_rec_heap_no, trx)) {
+
+			/* Note that we may get DB_SUCCESS also here! */
+			trx_mutex_enter(trx);
+
+			err = lock_rec_enqueue_waiting(
+				LOCK_X | LOCK_GAP | LOCK_INSERT_INTENTION,
+				block, next_rec_heap_no, NULL, index, thr);
+
+			trx_mutex_exit(trx);
+		} else {
+			err = DB_SUCCESS;
+		}
+
+		lock_mutex_exit();
+	}
 
 	switch (err) {
 	case DB_SUCCESS_LOCKED_REC:
@@ -5875,11 +6094,14 @@ lock_rec_convert_impl_to_expl_for_trx(
 	trx_t*			trx,	/*!< in/out: active transaction */
 	ulint			heap_no)/*!< in: rec heap number to lock */
 {
+	ulint	space = buf_block_get_space(block);
+	ulint	page_no = buf_block_get_page_no(block);
+
 	ut_ad(trx_is_referenced(trx));
 
 	DEBUG_SYNC_C("before_lock_rec_convert_impl_to_expl_for_trx");
 
-	lock_mutex_enter();
+	lock_rec_mutex_enter(space, page_no);
 
 	ut_ad(!trx_state_eq(trx, TRX_STATE_NOT_STARTED));
 
@@ -5908,7 +6130,7 @@ lock_rec_convert_impl_to_expl_for_trx(
 			type_mode, block, heap_no, index, trx, FALSE);
 	}
 
-	lock_mutex_exit();
+	lock_rec_mutex_exit(space, page_no);
 
 	trx_release_reference(trx);
 
@@ -6003,16 +6225,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6064,16 +6282,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -6165,8 +6379,6 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6175,9 +6387,7 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6239,8 +6449,6 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6248,9 +6456,7 @@ lock_clust_rec_read_check_and_lock(
 
 	err = lock_rec_lock(FALSE, mode | gap_mode, block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6702,6 +6908,10 @@ lock_trx_release_locks(
 	is protected by both the lock_sys->mutex and the trx->mutex. */
 	lock_mutex_enter();
 
+	/* A lock wait that has ended can still be queued for the
+	deadlock detector thread. */
+	lock_deadlock_dequeue(trx);
+
 	trx_mutex_enter(trx);
 
 	/* The following assignment makes the transaction committed in memory
@@ -7440,12 +7650,17 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, const trx_t* trx)
 
 	const trx_t*	victim_trx;
 
+	MONITOR_INC(MONITOR_DEADLOCK_CHECKS);
+
 	/* Try and resolve as many deadlocks as possible. */
 	do {
 		DeadlockChecker	checker(trx, lock, s_lock_mark_counter);
 
 		victim_trx = checker.search();
 
+		MONITOR_INC_VALUE(MONITOR_DEADLOCK_SEARCH_STEPS,
+				  checker.m_cost);
+
 		/* Search too deep, we rollback the joining transaction. */
 		if (checker.is_too_deep()) {
 
@@ -7481,6 +7696,111 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, const trx_t* trx)
 	return(victim_trx);
 }
 
+/** Checks a lock wait that was queued for the deadlock detector thread.
+If the waiting transaction is chosen as the victim, its lock wait is
+cancelled and it will be rolled back.
+@param trx transaction waiting for a lock */
+void
+DeadlockChecker::check_and_resolve_async(trx_t* trx)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(trx->lock.wait_lock != NULL);
+
+	const trx_t*	victim_trx;
+
+	victim_trx = check_and_resolve(trx->lock.wait_lock, trx);
+
+	/* Other victims may have been rolled back before trx was
+	chosen, and trx may have been granted its lock meanwhile. */
+	if (victim_trx != 0 && trx->lock.wait_lock != NULL) {
+
+		ut_ad(victim_trx == trx);
+
+		MONITOR_INC(MONITOR_DEADLOCK);
+
+		trx_mutex_enter(trx);
+
+		trx->lock.was_chosen_as_deadlock_victim = true;
+
+		lock_cancel_waiting_and_release(trx->lock.wait_lock);
+
+		trx_mutex_exit(trx);
+	}
+}
+
+/*********************************************************************//**
+A thread which checks the lock waits queued by lock_deadlock_queue()
+for deadlocks, when innodb_deadlock_detect_async is set.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_thread)(
+/*=================================*/
+	void*	arg __attribute__((unused)))
+			/* in: a dummy parameter required by
+			os_thread_create */
+{
+	ib_int64_t	sig_count = 0;
+	os_event_t	event = lock_sys->deadlock_event;
+
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(srv_lock_deadlock_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	lock_sys->deadlock_thread_active = true;
+
+	do {
+		os_event_wait_time_low(event, 1000000, sig_count);
+		sig_count = os_event_reset(event);
+
+		if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
+			break;
+		}
+
+		/* Check one queued lock wait per lock_sys->mutex
+		acquisition, so that the lock system is not blocked
+		for long when many transactions are waiting. */
+
+		for (;;) {
+			lock_mutex_enter();
+
+			trx_t*	trx = UT_LIST_GET_FIRST(
+				lock_sys->deadlock_waits);
+
+			if (trx == NULL) {
+				lock_mutex_exit();
+				break;
+			}
+
+			lock_deadlock_dequeue(trx);
+
+			MONITOR_INC_VALUE(
+				MONITOR_DEADLOCK_DETECT_LATENCY,
+				ut_time_us(NULL) - trx->lock.deadlock_queued);
+
+			if (trx->lock.que_state == TRX_QUE_LOCK_WAIT
+			    && trx->lock.wait_lock != NULL) {
+
+				DeadlockChecker::check_and_resolve_async(trx);
+			}
+
+			lock_mutex_exit();
+		}
+
+	} while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP);
+
+	lock_sys->deadlock_thread_active = false;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /**
 Allocate cached locks for the transaction.
 @param trx		allocate cached record locks for this transaction */
@@ -82,6 +82,11 @@ reduce the size of the log.
 /* Global log system variable */
 log_t*	log_sys	= NULL;
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t	log_writer_thread_key;
+mysql_pfs_key_t	log_flusher_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 #ifdef UNIV_DEBUG
 ibool	log_do_write = TRUE;
 #endif /* UNIV_DEBUG */
@@ -281,6 +286,160 @@ part_loop:
 	srv_stats.log_write_requests.inc();
 }
 
+/************************************************************//**
+Reserves space for a string in the log buffer. The lsn and the log block
+headers and trailers are advanced as in log_write_low(), but the string
+itself is not copied: the caller must copy it with log_write_reserved() and
+then call log_write_reserved_complete(). The copying may be done after the
+log mutex has been released. It is assumed that the caller holds the log
+mutex.
+@return offset in the log buffer where the string is to be copied */
+
+ulint
+log_reserve_low(
+/*============*/
+	ulint	str_len)	/*!< in: string length */
+{
+	log_t*	log	= log_sys;
+	ulint	offset;
+	ulint	len;
+	ulint	data_len;
+	byte*	log_block;
+
+	ut_ad(mutex_own(&(log->mutex)));
+	ut_ad(!recv_no_log_write);
+	ut_ad(str_len > 0);
+
+	offset = log->buf_free;
+
+	do {
+		/* Calculate a part length */
+
+		data_len = (log->buf_free % OS_FILE_LOG_BLOCK_SIZE) + str_len;
+
+		if (data_len <= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+
+			/* The string fits within the current log block */
+
+			len = str_len;
+		} else {
+			data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
+
+			len = OS_FILE_LOG_BLOCK_SIZE
+				- (log->buf_free % OS_FILE_LOG_BLOCK_SIZE)
+				- LOG_BLOCK_TRL_SIZE;
+		}
+
+		str_len -= len;
+
+		log_block = static_cast<byte*>(
+			ut_align_down(
+				log->buf + log->buf_free,
+				OS_FILE_LOG_BLOCK_SIZE));
+
+		log_block_set_data_len(log_block, data_len);
+
+		if (data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* This block became full */
+			log_block_set_data_len(log_block,
+					       OS_FILE_LOG_BLOCK_SIZE);
+			log_block_set_checkpoint_no(
+				log_block, log_sys->next_checkpoint_no);
+			len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
+
+			log->lsn += len;
+
+			/* Initialize the next block header */
+			log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE,
+				       log->lsn);
+		} else {
+			log->lsn += len;
+		}
+
+		log->buf_free += len;
+
+		ut_ad(log->buf_free <= log->buf_size);
+	} while (str_len > 0);
+
+	os_atomic_increment_ulint(&log->n_pending_copies, 1);
+
+	srv_stats.log_write_requests.inc();
+
+	return(offset);
+}
+
+/************************************************************//**
+Copies a part of a string into the log buffer space that was reserved with
+log_reserve_low(). The log mutex need not be held.
+@return offset in the log buffer where the next part is to be copied */
+
+ulint
+log_write_reserved(
+/*===============*/
+	ulint		offset,	/*!< in: offset returned by log_reserve_low()
+				or by the previous call */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len)/*!< in: string length */
+{
+	ut_ad(log_sys->n_pending_copies > 0);
+
+	while (str_len > 0) {
+		ulint	len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- offset % OS_FILE_LOG_BLOCK_SIZE;
+
+		if (len > str_len) {
+			len = str_len;
+		}
+
+		ut_memcpy(log_sys->buf + offset, str, len);
+
+		str += len;
+		str_len -= len;
+		offset += len;
+
+		if (offset % OS_FILE_LOG_BLOCK_SIZE
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+
+			/* Skip the trailer of this block and the header
+			of the next block, written by log_reserve_low() */
+			offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+
+	return(offset);
+}
+
+/************************************************************//**
+Signals that the string reserved with log_reserve_low() has been copied to
+the log buffer in full. The log mutex need not be held. */
+
+void
+log_write_reserved_complete(void)
+/*=============================*/
+{
+	ut_ad(log_sys->n_pending_copies > 0);
+
+	os_atomic_decrement_ulint(&log_sys->n_pending_copies, 1);
+}
+
+/************************************************************//**
+Waits until all the strings reserved with log_reserve_low() have been
+copied to the log buffer. New reservations cannot be made meanwhile,
+because the caller holds the log mutex. */
+static
+void
+log_wait_for_pending_copies(void)
+/*=============================*/
+{
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	while (log_sys->n_pending_copies > 0) {
+		/* The copies are plain memcpy() calls that do not wait
+		for anything, so they will complete soon. */
+		os_thread_yield();
+	}
+}
+
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -655,6 +814,7 @@ log_init(void)
 
 	log_sys->max_buf_free = log_sys->buf_size / LOG_BUF_FLUSH_RATIO
 		- LOG_BUF_FLUSH_MARGIN;
+	log_sys->n_pending_copies = 0;
 	log_sys->check_flush_or_checkpoint = TRUE;
 	UT_LIST_INIT(log_sys->log_groups, &log_group_t::log_groups);
 
@@ -867,6 +1027,8 @@ log_sys_check_flush_completion(void)
 			/* Move the log buffer content to the start of the
 			buffer */
 
+			log_wait_for_pending_copies();
+
 			move_start = ut_calc_align_down(
 				log_sys->write_end_offset,
 				OS_FILE_LOG_BLOCK_SIZE);
@@ -1123,14 +1285,13 @@ loop:
 }
 
 /******************************************************//**
-This function is called, e.g., when a transaction wants to commit. It checks
-that the log has been written to the log file up to the last log entry written
-by the transaction. If there is a flush running, it waits and checks if the
-flush flushed enough. If not, starts a new flush. */
-
+Writes the log up to an lsn in the calling thread. If there is a flush
+running, it waits and checks if the flush flushed enough. If not, starts a
+new flush. */
+static
 void
-log_write_up_to(
-/*============*/
+log_write_up_to_low(
+/*================*/
 	lsn_t	lsn,	/*!< in: log sequence number up to which
 			the log should be written,
 			LSN_MAX if not specified */
@@ -1149,16 +1310,10 @@ log_write_up_to(
 	ulint		loop_count	= 0;
 #endif /* UNIV_DEBUG */
 	ulint		unlock;
+	lsn_t		flushed_lsn	= 0;
 
 	ut_ad(!srv_read_only_mode);
 
-	if (recv_no_ibuf_operations) {
-		/* Recovery is running and no operations on the log files are
-		allowed yet (the variable name .._no_ibuf_.. is misleading) */
-
-		return;
-	}
-
 loop:
 #ifdef UNIV_DEBUG
 	loop_count++;
@@ -1238,6 +1393,11 @@ loop:
 	os_event_reset(log_sys->no_flush_event);
 	os_event_reset(log_sys->one_flushed_event);
 
+	/* Let the mini-transactions that have already reserved their
+	space finish copying their records before we write the buffer */
+
+	log_wait_for_pending_copies();
+
 	start_offset = log_sys->buf_next_to_write;
 	end_offset = log_sys->buf_free;
 
@@ -1293,18 +1453,23 @@ loop:
 		/* O_DSYNC means the OS did not buffer the log file at all:
 		so we have also flushed to disk what we have written */
 
-		log_sys->flushed_to_disk_lsn = log_sys->write_lsn;
+		flushed_lsn = log_sys->write_lsn;
 
 	} else if (flush_to_disk) {
 
 		group = UT_LIST_GET_FIRST(log_sys->log_groups);
 
 		fil_flush(group->space_id);
-		log_sys->flushed_to_disk_lsn = log_sys->write_lsn;
+		flushed_lsn = log_sys->write_lsn;
 	}
 
 	log_mutex_enter();
 
+	/* The log flusher thread may have flushed further meanwhile */
+	if (flushed_lsn > log_sys->flushed_to_disk_lsn) {
+		log_sys->flushed_to_disk_lsn = flushed_lsn;
+	}
+
 	group = UT_LIST_GET_FIRST(log_sys->log_groups);
 
 	ut_a(group->n_pending_writes == 1);
@@ -1342,6 +1507,347 @@ do_waits:
 	}
 }
 
+/** Number of events in log_sys->write_events and log_sys->flush_events */
+#define LOG_N_LSN_EVENTS	1024
+
+/******************************************************//**
+Maps an lsn to the event that a thread waiting for that lsn waits on.
+All lsns of one log block share an event.
+@return slot in log_sys->write_events or log_sys->flush_events */
+UNIV_INLINE
+ulint
+log_lsn_event_slot(
+/*===============*/
+	lsn_t	lsn)	/*!< in: lsn */
+{
+	return(static_cast<ulint>(
+		(lsn / OS_FILE_LOG_BLOCK_SIZE) % LOG_N_LSN_EVENTS));
+}
+
+/******************************************************//**
+Sets the events of the threads waiting for an lsn in (start_lsn, end_lsn]. */
+static
+void
+log_lsn_events_set(
+/*===============*/
+	os_event_t*	events,		/*!< in: log_sys->write_events or
+					log_sys->flush_events */
+	lsn_t		start_lsn,	/*!< in: the old written or flushed
+					lsn */
+	lsn_t		end_lsn)	/*!< in: the new written or flushed
+					lsn */
+{
+	if (end_lsn <= start_lsn) {
+		return;
+	}
+
+	lsn_t	start_block = start_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	lsn_t	end_block = end_lsn / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (end_block - start_block >= LOG_N_LSN_EVENTS) {
+		for (ulint i = 0; i < LOG_N_LSN_EVENTS; ++i) {
+			os_event_set(events[i]);
+		}
+		return;
+	}
+
+	for (lsn_t block = start_block; block <= end_block; ++block) {
+		os_event_set(events[block % LOG_N_LSN_EVENTS]);
+	}
+}
+
+/******************************************************//**
+Called by the log writer or log flusher thread on exit: makes
+log_write_up_to() write in the calling thread again and wakes up all the
+threads that wait for the exiting thread. */
+static
+void
+log_writer_thread_exit(void)
+/*========================*/
+{
+	log_mutex_enter();
+
+	log_sys->writer_threads = false;
+	log_mutex_exit();
+
+	for (ulint i = 0; i < LOG_N_LSN_EVENTS; ++i) {
+		os_event_set(log_sys->write_events[i]);
+		os_event_set(log_sys->flush_events[i]);
+	}
+
+	os_event_set(log_sys->writer_event);
+	os_event_set(log_sys->flusher_event);
+
+	/* Only now may log_shutdown() free the events */
+	log_mutex_enter();
+	ut_a(log_sys->n_writer_threads > 0);
+	log_sys->n_writer_threads--;
+	log_mutex_exit();
+}
+
+/******************************************************************//**
+The log writer thread. It writes the log buffer to the log files as long
+as there is anything in it, and wakes up the threads that wait for the
+written lsn.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(
+/*==============================*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_writer_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP) {
+
+		ib_int64_t	sig_count = os_event_reset(log_sys->writer_event);
+
+		log_mutex_enter();
+
+		lsn_t	old_lsn = log_sys->written_to_all_lsn;
+		bool	empty = log_sys->buf_free
+			== log_sys->buf_next_to_write;
+
+		log_mutex_exit();
+
+		if (empty) {
+			os_event_wait_time_low(
+				log_sys->writer_event, 10000, sig_count);
+			continue;
+		}
+
+		log_write_up_to_low(LSN_MAX, LOG_NO_WAIT, FALSE);
+
+		log_mutex_enter();
+		lsn_t	new_lsn = log_sys->written_to_all_lsn;
+		log_mutex_exit();
+
+		log_lsn_events_set(log_sys->write_events, old_lsn, new_lsn);
+
+		if (srv_unix_file_flush_method == SRV_UNIX_O_DSYNC) {
+			log_lsn_events_set(
+				log_sys->flush_events, old_lsn, new_lsn);
+		}
+
+		os_event_set(log_sys->flusher_event);
+	}
+
+	log_writer_thread_exit();
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/******************************************************************//**
+The log flusher thread. It flushes the log files when a thread waits for
+the log to be flushed past the flushed lsn, and wakes the waiting threads
+up. All the writes that completed while the previous flush ran are covered
+by one flush, so the number of commits per flush grows with the latency of
+the device.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(
+/*===============================*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flusher_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP) {
+
+		ib_int64_t	sig_count = os_event_reset(log_sys->flusher_event);
+
+		log_mutex_enter();
+
+		lsn_t	old_lsn = log_sys->flushed_to_disk_lsn;
+		lsn_t	written_lsn = log_sys->written_to_all_lsn;
+		ulint	space_id = UT_LIST_GET_FIRST(
+			log_sys->log_groups)->space_id;
+		bool	flush = log_sys->flush_requested_lsn > old_lsn
+			&& written_lsn > old_lsn;
+
+		log_mutex_exit();
+
+		if (!flush) {
+			os_event_wait_time_low(
+				log_sys->flusher_event, 10000, sig_count);
+			continue;
+		}
+
+		if (srv_unix_file_flush_method != SRV_UNIX_O_DSYNC) {
+			fil_flush(space_id);
+		}
+
+		log_mutex_enter();
+
+		if (written_lsn > log_sys->flushed_to_disk_lsn) {
+			log_sys->flushed_to_disk_lsn = written_lsn;
+		}
+
+		log_mutex_exit();
+
+		log_lsn_events_set(log_sys->flush_events, old_lsn, written_lsn);
+	}
+
+	log_writer_thread_exit();
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/****************************************************************//**
+Starts the log writer and log flusher threads if innodb_log_writer_threads
+is set. After this, log_write_up_to() leaves the writes and flushes of the
+log to these threads and only waits for them. */
+
+void
+log_writer_threads_start(void)
+/*==========================*/
+{
+	ut_ad(!srv_read_only_mode);
+
+	if (!srv_log_writer_threads) {
+		return;
+	}
+
+	log_sys->writer_event = os_event_create(0);
+	log_sys->flusher_event = os_event_create(0);
+
+	log_sys->write_events = static_cast<os_event_t*>(
+		mem_alloc(LOG_N_LSN_EVENTS * sizeof(os_event_t)));
+	log_sys->flush_events = static_cast<os_event_t*>(
+		mem_alloc(LOG_N_LSN_EVENTS * sizeof(os_event_t)));
+
+	for (ulint i = 0; i < LOG_N_LSN_EVENTS; ++i) {
+		log_sys->write_events[i] = os_event_create(0);
+		log_sys->flush_events[i] = os_event_create(0);
+	}
+
+	log_mutex_enter();
+	log_sys->flush_requested_lsn = log_sys->flushed_to_disk_lsn;
+	log_sys->n_writer_threads = 2;
+	log_sys->writer_threads = true;
+	log_mutex_exit();
+
+	os_thread_create(log_writer_thread, NULL, NULL);
+	os_thread_create(log_flusher_thread, NULL, NULL);
+}
+
+/******************************************************//**
+This function is called, e.g., when a transaction wants to commit. It checks
+that the log has been written to the log file up to the last log entry written
+by the transaction. If the log writer and log flusher threads are running it
+waits for them to write (and flush) far enough, otherwise it writes the log
+itself. */
+
+void
+log_write_up_to(
+/*============*/
+	lsn_t	lsn,	/*!< in: log sequence number up to which
+			the log should be written,
+			LSN_MAX if not specified */
+	ulint	wait,	/*!< in: LOG_NO_WAIT, LOG_WAIT_ONE_GROUP,
+			or LOG_WAIT_ALL_GROUPS */
+	ibool	flush_to_disk)
+			/*!< in: TRUE if we want the written log
+			also to be flushed to disk */
+{
+	ut_ad(!srv_read_only_mode);
+
+	if (recv_no_ibuf_operations) {
+		/* Recovery is running and no operations on the log files are
+		allowed yet (the variable name .._no_ibuf_.. is misleading) */
+
+		return;
+	}
+
+	if (!log_sys->writer_threads) {
+		log_write_up_to_low(lsn, wait, flush_to_disk);
+		return;
+	}
+
+	if (wait == LOG_NO_WAIT) {
+		if (flush_to_disk) {
+			log_mutex_enter();
+
+			if (lsn > log_sys->lsn) {
+				lsn = log_sys->lsn;
+			}
+
+			if (lsn > log_sys->flush_requested_lsn) {
+				log_sys->flush_requested_lsn = lsn;
+			}
+
+			log_mutex_exit();
+
+			os_event_set(log_sys->flusher_event);
+		}
+
+		os_event_set(log_sys->writer_event);
+		return;
+	}
+
+	os_event_t*	events = flush_to_disk
+		? log_sys->flush_events : log_sys->write_events;
+
+	for (;;) {
+		os_event_t	event;
+		ib_int64_t	sig_count;
+
+		log_mutex_enter();
+
+		if (lsn > log_sys->lsn) {
+			lsn = log_sys->lsn;
+		}
+
+		/* Reset the event before checking the lsn, so that a
+		set by the writer or flusher thread after the check is
+		not lost */
+		event = events[log_lsn_event_slot(lsn)];
+		sig_count = os_event_reset(event);
+
+		if (flush_to_disk
+		    ? log_sys->flushed_to_disk_lsn >= lsn
+		    : log_sys->written_to_all_lsn >= lsn) {
+
+			log_mutex_exit();
+			return;
+		}
+
+		if (!log_sys->writer_threads) {
+			/* The threads are exiting at shutdown */
+			log_mutex_exit();
+
+			log_write_up_to_low(lsn, wait, flush_to_disk);
+			return;
+		}
+
+		if (flush_to_disk && lsn > log_sys->flush_requested_lsn) {
+			log_sys->flush_requested_lsn = lsn;
+		}
+
+		log_mutex_exit();
+
+		os_event_set(log_sys->writer_event);
+
+		if (flush_to_disk) {
+			os_event_set(log_sys->flusher_event);
+		}
+
+		os_event_wait_low(event, sig_count);
+	}
+}
+
 /****************************************************************//**
 Does a syncronous flush of the log buffer to disk. */
 
@@ -2508,6 +3014,23 @@ log_shutdown(void)
 	os_event_destroy(log_sys->no_flush_event);
 	os_event_destroy(log_sys->one_flushed_event);
 
+	if (log_sys->write_events != NULL) {
+		ut_a(log_sys->n_writer_threads == 0);
+
+		for (ulint i = 0; i < LOG_N_LSN_EVENTS; ++i) {
+			os_event_destroy(log_sys->write_events[i]);
+			os_event_destroy(log_sys->flush_events[i]);
+		}
+
+		mem_free(log_sys->write_events);
+		mem_free(log_sys->flush_events);
+		log_sys->write_events = NULL;
+		log_sys->flush_events = NULL;
+
+		os_event_destroy(log_sys->writer_event);
+		os_event_destroy(log_sys->flusher_event);
+	}
+
 	rw_lock_free(&log_sys->checkpoint_lock);
 
 	mutex_free(&log_sys->mutex);
@@ -154,6 +154,7 @@ mysql_pfs_key_t	trx_rollback_clean_thread_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t	recv_writer_thread_key;
+mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 /** Flag indicating if recv_writer thread is active. */
@@ -389,6 +390,11 @@ recv_sys_init(
 
 	recv_sys->addr_hash = hash_create(available_memory / 512);
 	recv_sys->n_addrs = 0;
+	recv_sys->n_apply_threads = 0;
+	recv_sys->n_apply_threads_active = 0;
+	recv_sys->n_apply_cells = 0;
+	recv_sys->n_apply_pages = 0;
+	recv_sys->apply_progress = FALSE;
 
 	recv_sys->apply_log_recs = FALSE;
 	recv_sys->apply_batch_on = FALSE;
@@ -1622,9 +1628,125 @@ recv_read_in_area(
 	return(n);
 }
 
+/*******************************************************************//**
+Applies the hashed log records of every n_workers'th cell of
+recv_sys->addr_hash, starting from cell number worker. A given (space,
+page_no) always hashes to one cell, so the workers never process the same
+page. Pages that are not in the buffer pool are read in asynchronously and
+the records are applied by the i/o handler threads on read completion. */
+static
+void
+recv_apply_hashed_cells(
+/*====================*/
+	ulint	worker,		/*!< in: worker number, 0 .. n_workers - 1 */
+	ulint	n_workers)	/*!< in: number of apply workers */
+{
+	recv_addr_t*	recv_addr;
+	ulint		n_cells;
+	ulint		i;
+	mtr_t		mtr;
+
+	mutex_enter(&(recv_sys->mutex));
+
+	n_cells = hash_get_n_cells(recv_sys->addr_hash);
+
+	for (i = worker; i < n_cells; i += n_workers) {
+
+		for (recv_addr = static_cast<recv_addr_t*>(
+				HASH_GET_FIRST(recv_sys->addr_hash, i));
+		     recv_addr != 0;
+		     recv_addr = static_cast<recv_addr_t*>(
+				HASH_GET_NEXT(addr_hash, recv_addr))) {
+
+			ulint	space = recv_addr->space;
+			ulint	zip_size = fil_space_get_zip_size(space);
+			ulint	page_no = recv_addr->page_no;
+
+			if (recv_addr->state != RECV_NOT_PROCESSED) {
+				continue;
+			}
+
+			recv_sys->n_apply_pages++;
+
+			mutex_exit(&(recv_sys->mutex));
+
+			if (buf_page_peek(space, page_no)) {
+				buf_block_t*	block;
+
+				mtr_start(&mtr);
+
+				block = buf_page_get(
+					space, zip_size, page_no,
+					RW_X_LATCH, &mtr);
+				buf_block_dbg_add_level(
+					block, SYNC_NO_ORDER_CHECK);
+
+				recv_recover_page(FALSE, block);
+				mtr_commit(&mtr);
+			} else {
+				recv_read_in_area(space, zip_size, page_no);
+			}
+
+			mutex_enter(&(recv_sys->mutex));
+		}
+
+		/* Report the progress of the whole batch, not only of
+		the cells of this worker. */
+
+		if (recv_sys->apply_progress
+		    && (recv_sys->n_apply_cells * 100) / n_cells
+		    != ((recv_sys->n_apply_cells + 1) * 100) / n_cells) {
+
+			fprintf(stderr, "%lu ", (ulong)
+				((recv_sys->n_apply_cells * 100) / n_cells));
+		}
+
+		recv_sys->n_apply_cells++;
+	}
+
+	mutex_exit(&(recv_sys->mutex));
+}
+
+/******************************************************************//**
+Redo log apply worker thread. Applies the log records of its share of the
+cells of recv_sys->addr_hash and exits at the end of the batch.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: pointer to the worker number */
+{
+	ulint	worker = *static_cast<ulint*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: recv_apply thread %lu running, id %lu\n",
+		worker, os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	recv_apply_hashed_cells(worker, recv_sys->n_apply_threads);
+
+	mutex_enter(&(recv_sys->mutex));
+	ut_a(recv_sys->n_apply_threads_active > 0);
+	recv_sys->n_apply_threads_active--;
+	mutex_exit(&(recv_sys->mutex));
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*******************************************************************//**
 Empties the hash table of stored log records, applying them to appropriate
-pages. */
+pages. The cells of the hash table are divided between the calling thread
+and innodb_recovery_threads - 1 recv_apply threads. */
 
 void
 recv_apply_hashed_log_recs(
@@ -1639,10 +1761,11 @@ recv_apply_hashed_log_recs(
 				the caller must in this case own the log
 				mutex */
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
+	ulint		n_threads;
+	ulint*		workers;
+	ulint		n_pages;
+	ulint		i;
+	ib_time_t	start_time;
 loop:
 	mutex_enter(&(recv_sys->mutex));
 
@@ -1664,64 +1787,58 @@ loop:
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	n_threads = ut_min(ut_max(srv_n_recovery_threads, 1),
+			   hash_get_n_cells(recv_sys->addr_hash));
 
-		for (recv_addr = static_cast<recv_addr_t*>(
-				HASH_GET_FIRST(recv_sys->addr_hash, i));
-		     recv_addr != 0;
-		     recv_addr = static_cast<recv_addr_t*>(
-				HASH_GET_NEXT(addr_hash, recv_addr))) {
+	if (recv_sys->n_addrs < n_threads * RECV_READ_AHEAD_AREA) {
+		/* Not worth starting threads for a small batch */
+		n_threads = 1;
+	}
 
-			ulint	space = recv_addr->space;
-			ulint	zip_size = fil_space_get_zip_size(space);
-			ulint	page_no = recv_addr->page_no;
+	recv_sys->n_apply_threads = n_threads;
+	recv_sys->n_apply_threads_active = n_threads - 1;
+	recv_sys->n_apply_cells = 0;
+	recv_sys->n_apply_pages = 0;
+	recv_sys->apply_progress = recv_sys->n_addrs != 0;
 
-			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ib_logf(IB_LOG_LEVEL_INFO,
-						"Starting an apply batch"
-						" of log records"
-						" to the database...");
-					fputs("InnoDB: Progress in percent: ",
-					      stderr);
-					has_printed = TRUE;
-				}
+	start_time = ut_time();
 
-				mutex_exit(&(recv_sys->mutex));
+	if (recv_sys->apply_progress) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Starting an apply batch of log records for %lu pages"
+			" to the database using %lu threads...",
+			(ulong) recv_sys->n_addrs, (ulong) n_threads);
+		fputs("InnoDB: Progress in percent: ", stderr);
+	}
 
-				if (buf_page_peek(space, page_no)) {
-					buf_block_t*	block;
+	mutex_exit(&(recv_sys->mutex));
 
-					mtr_start(&mtr);
+	workers = static_cast<ulint*>(
+		mem_alloc(n_threads * sizeof *workers));
 
-					block = buf_page_get(
-						space, zip_size, page_no,
-						RW_X_LATCH, &mtr);
-					buf_block_dbg_add_level(
-						block, SYNC_NO_ORDER_CHECK);
+	for (i = 1; i < n_threads; i++) {
+		workers[i] = i;
+		os_thread_create(recv_apply_thread, &workers[i], NULL);
+	}
 
-					recv_recover_page(FALSE, block);
-					mtr_commit(&mtr);
-				} else {
-					recv_read_in_area(space, zip_size,
-							  page_no);
-				}
+	/* The calling thread is worker 0 */
+	recv_apply_hashed_cells(0, n_threads);
 
-				mutex_enter(&(recv_sys->mutex));
-			}
-		}
+	mutex_enter(&(recv_sys->mutex));
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
+	/* Wait until the apply threads have gone through their cells */
 
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
-		}
+	while (recv_sys->n_apply_threads_active != 0) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_thread_sleep(100000);
+
+		mutex_enter(&(recv_sys->mutex));
 	}
 
+	mem_free(workers);
+
 	/* Wait until all the pages have been processed */
 
 	while (recv_sys->n_addrs != 0) {
@@ -1733,7 +1850,9 @@ loop:
 		mutex_enter(&(recv_sys->mutex));
 	}
 
-	if (has_printed) {
+	n_pages = recv_sys->n_apply_pages;
+
+	if (recv_sys->apply_progress) {
 
 		fprintf(stderr, "\n");
 	}
@@ -1773,8 +1892,17 @@ loop:
 
 	recv_sys_empty_hash();
 
-	if (has_printed) {
-		fprintf(stderr, "InnoDB: Apply batch completed\n");
+	if (recv_sys->apply_progress) {
+		double	elapsed = ut_difftime(ut_time(), start_time);
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Apply batch completed: %lu pages in %.0f seconds"
+			" (%.0f pages/s), log scanned up to " LSN_PF,
+			(ulong) n_pages, elapsed,
+			elapsed > 0 ? n_pages / elapsed : (double) n_pages,
+			recv_sys->scanned_lsn);
+
+		recv_sys->apply_progress = FALSE;
 	}
 
 	mutex_exit(&(recv_sys->mutex));
@@ -170,6 +170,8 @@ mem_init(
 	}
 
 	mem_comm_pool = mem_pool_create(size);
+
+	mem_block_cache_init();
 }
 
 /******************************************************************//**
@@ -179,6 +181,8 @@ void
 mem_close(void)
 /*===========*/
 {
+	mem_block_cache_close();
+
 	mem_pool_free(mem_comm_pool);
 	mem_comm_pool = NULL;
 #ifdef UNIV_MEM_DEBUG
@@ -35,6 +35,224 @@ Created 6/9/1994 Heikki Tuuri
 #include "mem0dbg.cc"
 #include <stdarg.h>
 
+#if !defined UNIV_HOTBACKUP && !defined __WIN__
+/** The blocks in the per-thread caches have power-of-2 sizes from
+2^MEM_BLOCK_CACHE_MIN_SHIFT to 2^MEM_BLOCK_CACHE_MAX_SHIFT bytes, which
+covers the blocks up to MEM_BLOCK_STANDARD_SIZE */
+#define MEM_BLOCK_CACHE_MIN_SHIFT	7
+#define MEM_BLOCK_CACHE_MAX_SHIFT	13
+#define MEM_BLOCK_CACHE_N_CLASSES	\
+	(MEM_BLOCK_CACHE_MAX_SHIFT - MEM_BLOCK_CACHE_MIN_SHIFT + 1)
+/** Maximum number of free blocks of one size that a thread caches */
+#define MEM_BLOCK_CACHE_DEPTH		4
+
+/** Free heap blocks of a thread. The row operations create and free
+several heaps apiece, for example for rec_get_offsets() and for the
+dyn arrays of the mini-transaction log, so in a steady state the blocks
+they need are in the cache of the thread. */
+struct mem_block_cache_t {
+	/** Number of blocks in each size class */
+	ulint	n_blocks[MEM_BLOCK_CACHE_N_CLASSES];
+	/** The free blocks of each size class */
+	void*	blocks[MEM_BLOCK_CACHE_N_CLASSES][MEM_BLOCK_CACHE_DEPTH];
+};
+
+/** Key of the mem_block_cache_t of each thread */
+static pthread_key_t	mem_block_cache_key;
+
+/** Whether the heap blocks are cached */
+static bool		mem_block_cache_enabled	= false;
+
+/******************************************************************//**
+Frees the cached blocks of an exiting thread. */
+extern "C"
+void
+mem_block_cache_destroy(
+/*====================*/
+	void*	arg)	/*!< in: mem_block_cache_t of the thread */
+{
+	mem_block_cache_t*	cache = static_cast<mem_block_cache_t*>(arg);
+
+	for (ulint i = 0; i < MEM_BLOCK_CACHE_N_CLASSES; i++) {
+		while (cache->n_blocks[i] > 0) {
+			free(cache->blocks[i][--cache->n_blocks[i]]);
+		}
+	}
+
+	free(cache);
+}
+
+/******************************************************************//**
+Creates the per-thread caches of free heap blocks. They are used only when
+the blocks are allocated with malloc(), that is, with innodb_use_sys_malloc. */
+
+void
+mem_block_cache_init(void)
+/*======================*/
+{
+	ut_ad(!mem_block_cache_enabled);
+
+	if (srv_use_sys_malloc
+	    && !pthread_key_create(&mem_block_cache_key,
+				   mem_block_cache_destroy)) {
+
+		mem_block_cache_enabled = true;
+	}
+}
+
+/******************************************************************//**
+Frees the heap block cache of the calling thread and stops caching. */
+
+void
+mem_block_cache_close(void)
+/*=======================*/
+{
+	if (!mem_block_cache_enabled) {
+		return;
+	}
+
+	mem_block_cache_enabled = false;
+
+	if (void* cache = pthread_getspecific(mem_block_cache_key)) {
+		pthread_setspecific(mem_block_cache_key, NULL);
+		mem_block_cache_destroy(cache);
+	}
+
+	pthread_key_delete(mem_block_cache_key);
+}
+
+/******************************************************************//**
+Determines the size class of a heap block.
+@return size class, or ULINT_UNDEFINED if the block is too big */
+static
+ulint
+mem_block_cache_get_class(
+/*======================*/
+	ulint	len)	/*!< in: size of the block in bytes */
+{
+	for (ulint i = 0; i < MEM_BLOCK_CACHE_N_CLASSES; i++) {
+		if (len <= (ulint) 1 << (i + MEM_BLOCK_CACHE_MIN_SHIFT)) {
+			return(i);
+		}
+	}
+
+	return(ULINT_UNDEFINED);
+}
+
+/******************************************************************//**
+Allocates a heap block from the cache of the thread, or from the common
+pool if the cache has no block of the size.
+@return the block */
+static
+void*
+mem_block_cache_alloc(
+/*==================*/
+	ulint*	psize,	/*!< in: requested size in bytes;
+			out: allocated size in bytes */
+	ulint	type)	/*!< in: type of the heap */
+{
+	ulint	i;
+	ulint	size;
+
+	if (!mem_block_cache_enabled
+	    || (i = mem_block_cache_get_class(*psize)) == ULINT_UNDEFINED) {
+
+		return(mem_area_alloc(psize, mem_comm_pool));
+	}
+
+	size = (ulint) 1 << (i + MEM_BLOCK_CACHE_MIN_SHIFT);
+
+	if (type != MEM_HEAP_DYNAMIC && size >= UNIV_PAGE_SIZE / 2) {
+		/* A block of this size would be taken from and
+		freed to the buffer pool. */
+		return(mem_area_alloc(psize, mem_comm_pool));
+	}
+
+	*psize = size;
+
+	mem_block_cache_t*	cache = static_cast<mem_block_cache_t*>(
+		pthread_getspecific(mem_block_cache_key));
+
+	if (cache != NULL && cache->n_blocks[i] > 0) {
+		void*	block = cache->blocks[i][--cache->n_blocks[i]];
+
+		srv_stats.n_mem_block_cache_hits.inc();
+		UNIV_MEM_ALLOC(block, size);
+
+		return(block);
+	}
+
+	srv_stats.n_mem_block_cache_misses.inc();
+
+	return(mem_area_alloc(psize, mem_comm_pool));
+}
+
+/******************************************************************//**
+Puts a free heap block to the cache of the thread, or frees it to the
+common pool. */
+static
+void
+mem_block_cache_free(
+/*=================*/
+	void*	block,	/*!< in: the block */
+	ulint	len)	/*!< in: size of the block in bytes */
+{
+	ulint	i;
+
+	if (!mem_block_cache_enabled
+	    || (i = mem_block_cache_get_class(len)) == ULINT_UNDEFINED
+	    || len != (ulint) 1 << (i + MEM_BLOCK_CACHE_MIN_SHIFT)) {
+
+		mem_area_free(block, mem_comm_pool);
+		return;
+	}
+
+	mem_block_cache_t*	cache = static_cast<mem_block_cache_t*>(
+		pthread_getspecific(mem_block_cache_key));
+
+	if (cache == NULL) {
+		cache = static_cast<mem_block_cache_t*>(
+			calloc(1, sizeof *cache));
+
+		if (cache == NULL
+		    || pthread_setspecific(mem_block_cache_key, cache)) {
+
+			free(cache);
+			mem_area_free(block, mem_comm_pool);
+			return;
+		}
+	}
+
+	if (cache->n_blocks[i] == MEM_BLOCK_CACHE_DEPTH) {
+		mem_area_free(block, mem_comm_pool);
+		return;
+	}
+
+	UNIV_MEM_FREE(block, len);
+	cache->blocks[i][cache->n_blocks[i]++] = block;
+}
+#else /* !UNIV_HOTBACKUP && !__WIN__ */
+/* TlsAlloc() has no destructor that could free the cache of an
+exiting thread, so the heap blocks are not cached on Windows. */
+# ifndef UNIV_HOTBACKUP
+void
+mem_block_cache_init(void)
+/*======================*/
+{
+}
+
+void
+mem_block_cache_close(void)
+/*=======================*/
+{
+}
+# endif /* !UNIV_HOTBACKUP */
+# define mem_block_cache_alloc(psize, type)	\
+	mem_area_alloc(psize, mem_comm_pool)
+# define mem_block_cache_free(block, len)	\
+	mem_area_free(block, mem_comm_pool)
+#endif /* !UNIV_HOTBACKUP && !__WIN__ */
+
 /*
 			THE MEMORY MANAGEMENT
 			=====================
@@ -334,7 +552,7 @@ mem_heap_create_block(
 		ut_ad(type == MEM_HEAP_DYNAMIC || n <= MEM_MAX_ALLOC_IN_BUF);
 
 		block = static_cast<mem_block_t*>(
-			mem_area_alloc(&len, mem_comm_pool));
+			mem_block_cache_alloc(&len, type));
 	} else {
 		len = UNIV_PAGE_SIZE;
 
@@ -517,7 +735,7 @@ mem_heap_block_free(
 	if (type == MEM_HEAP_DYNAMIC || len < UNIV_PAGE_SIZE / 2) {
 
 		ut_ad(!buf_block);
-		mem_area_free(block, mem_comm_pool);
+		mem_block_cache_free(block, len);
 	} else {
 		ut_ad(type & MEM_HEAP_BUFFER);
 
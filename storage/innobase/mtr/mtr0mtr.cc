@@ -287,7 +287,9 @@ mtr_log_reserve_and_write(
 	mtr->start_lsn = log_reserve_and_open(data_size);
 
 	if (mtr->log_mode == MTR_LOG_ALL) {
-
+#ifdef UNIV_LOG_DEBUG
+		/* log_close() checks the records in the log buffer:
+		copy them while holding the log mutex. */
 		for (dyn_block_t* block = mlog;
 		     block != 0;
 		     block = dyn_array_get_next_block(mlog, block)) {
@@ -296,7 +298,29 @@ mtr_log_reserve_and_write(
 				dyn_block_get_data(block),
 				dyn_block_get_used(block));
 		}
+#else /* UNIV_LOG_DEBUG */
+		/* Only reserve the space while holding the log mutex;
+		the records are copied after it has been released. */
+		ulint	offset = log_reserve_low(data_size);
+
+		mtr->end_lsn = log_close();
+
+		mtr_add_dirtied_pages_to_flush_list(mtr);
+
+		for (const dyn_block_t* block = mlog;
+		     block != 0;
+		     block = dyn_array_get_next_block(mlog, block)) {
+
+			offset = log_write_reserved(
+				offset,
+				dyn_block_get_data(block),
+				dyn_block_get_used(block));
+		}
+
+		log_write_reserved_complete();
 
+		return;
+#endif /* UNIV_LOG_DEBUG */
 	} else {
 		ut_ad(mtr->log_mode == MTR_LOG_NONE
 		      || mtr->log_mode == MTR_LOG_NO_REDO);
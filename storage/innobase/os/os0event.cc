@@ -33,6 +33,11 @@ Created 2012-09-23 Sunny Bains
 
 #include <list>
 
+#ifdef HAVE_IB_LINUX_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif /* HAVE_IB_LINUX_FUTEX */
+
 /** The number of microsecnds in a second. */
 static const ulint MICROSECS_IN_A_SECOND = 1000000;
 
@@ -83,6 +88,173 @@ static WakeConditionVariableProc wake_condition_variable;
 typedef pthread_cond_t		os_cond_t;
 #endif /* _WIN32 */
 
+#ifdef HAVE_IB_LINUX_FUTEX
+/** InnoDB event on a Linux futex. The futex word holds the signal count
+in its upper bits and the signaled state in its lowest bit. Setting and
+resetting the event are atomic operations on the word; only a thread that
+has to wait, and a thread that sets an event that has waiters, enter the
+kernel. */
+struct os_event {
+	os_event(const char* name) UNIV_NOTHROW
+		:
+		m_word(),
+		m_n_waiters()
+	{
+	}
+
+	/** Set the event */
+	void set() UNIV_NOTHROW
+	{
+		for (;;) {
+			unsigned	word = m_word;
+
+			if (word & SET) {
+				return;
+			}
+
+			/* Incrementing the signal count and setting
+			the state is one transition. */
+			if (os_compare_and_swap(
+				    &m_word, word, (word + COUNT_ONE) | SET)) {
+				break;
+			}
+		}
+
+		/* The compare-and-swap above is a full barrier: either
+		we see the waiter, or the waiter sees the new word. */
+		if (m_n_waiters > 0) {
+			futex(FUTEX_WAKE_PRIVATE, INT_MAX, NULL);
+		}
+	}
+
+	ib_int64_t reset() UNIV_NOTHROW
+	{
+		for (;;) {
+			unsigned	word = m_word;
+
+			if (!(word & SET)
+			    || os_compare_and_swap(&m_word, word, word & ~SET)) {
+
+				return(sig_count(word));
+			}
+		}
+	}
+
+	/**
+	Waits for an event object until it is in the signaled state.
+	If reset_sig_count is not zero, also returns when the event has
+	been set after the os_event_reset() that returned it, even if the
+	event has been reset since.
+	@param reset_sig_count - zero or the value returned by
+			previous call of os_event_reset(). */
+	void wait_low(ib_int64_t reset_sig_count) UNIV_NOTHROW
+	{
+		wait_time_low(OS_SYNC_INFINITE_TIME, reset_sig_count);
+	}
+
+	/**
+	Waits for an event object until it is in the signaled state or
+	a timeout is exceeded.
+	@param time_in_usec - timeout in microseconds,
+			or OS_SYNC_INFINITE_TIME
+	@param reset_sig_count- zero or the value returned by
+			previous call of os_event_reset().
+	@return	0 if success, OS_SYNC_TIME_EXCEEDED if timeout was exceeded */
+	ulint wait_time_low(
+		ulint		time_in_usec,
+		ib_int64_t	reset_sig_count) UNIV_NOTHROW
+	{
+		ullint		deadline = 0;
+		ulint		ret = 0;
+
+		if (time_in_usec != OS_SYNC_INFINITE_TIME) {
+			deadline = ut_time_us(NULL) + time_in_usec;
+		}
+
+		if (!reset_sig_count) {
+			reset_sig_count = sig_count(m_word);
+		}
+
+		os_atomic_increment_ulint(&m_n_waiters, 1);
+
+		for (;;) {
+			unsigned	word = m_word;
+
+			if ((word & SET) || sig_count(word) != reset_sig_count) {
+				break;
+			}
+
+			if (time_in_usec == OS_SYNC_INFINITE_TIME) {
+				futex(FUTEX_WAIT_PRIVATE, word, NULL);
+				continue;
+			}
+
+			ullint	now = ut_time_us(NULL);
+
+			if (now >= deadline) {
+				ret = OS_SYNC_TIME_EXCEEDED;
+				break;
+			}
+
+			struct timespec	timeout;
+
+			timeout.tv_sec = (deadline - now) / 1000000;
+			timeout.tv_nsec = (deadline - now) % 1000000 * 1000;
+
+			/* Spurious wakeups, EINTR and EAGAIN are handled
+			by checking the word again. */
+			futex(FUTEX_WAIT_PRIVATE, word, &timeout);
+		}
+
+		os_atomic_decrement_ulint(&m_n_waiters, 1);
+
+		return(ret);
+	}
+
+	/** @return true if the event is in the signalled state. */
+	bool is_set() const UNIV_NOTHROW
+	{
+		return(m_word & SET);
+	}
+
+private:
+	/** The signaled state in m_word */
+	static const unsigned	SET = 1;
+
+	/** Increment of the signal count in m_word */
+	static const unsigned	COUNT_ONE = 2;
+
+	/**
+	@return the value that os_event_reset() returns for the futex word;
+	never zero, because zero is reserved for "no signal count" */
+	static ib_int64_t sig_count(unsigned word) UNIV_NOTHROW
+	{
+		return(word | SET);
+	}
+
+	/** Call futex(2) on m_word.
+	@param op	FUTEX_WAIT_PRIVATE or FUTEX_WAKE_PRIVATE
+	@param val	expected value of m_word, or number of threads
+			to wake
+	@param timeout	relative timeout, or NULL */
+	void futex(int op, unsigned val, const timespec* timeout)
+		UNIV_NOTHROW
+	{
+		syscall(SYS_futex, &m_word, op, val, timeout, 0, 0);
+	}
+
+	/** Signal count and signaled state */
+	volatile unsigned	m_word;
+
+	/** Number of threads waiting or about to wait */
+	volatile ulint		m_n_waiters;
+
+protected:
+	// Disable copying
+	os_event(const os_event&);
+	os_event& operator=(const os_event&);
+};
+#else /* HAVE_IB_LINUX_FUTEX */
 typedef std::list<os_event_t> os_event_list_t;
 typedef os_event_list_t::iterator event_iter_t;
 
@@ -604,6 +776,7 @@ os_event::~os_event() UNIV_NOTHROW
 		mutex_destroy(&mutex);
 	}
 }
+#endif /* HAVE_IB_LINUX_FUTEX */
 
 /**
 Creates an event semaphore, i.e., a semaphore which may just have two
@@ -45,6 +45,7 @@ Created 10/21/1995 Heikki Tuuri
 #include "srv0start.h"
 #include "fil0fil.h"
 #include "buf0buf.h"
+#include "page0zip.h"
 #include "srv0mon.h"
 #ifndef UNIV_HOTBACKUP
 # include "os0event.h"
@@ -62,6 +63,11 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif
 
+#ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
+#include <fcntl.h>
+#include <linux/falloc.h>
+#endif /* HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE */
+
 /** Insert buffer segment id */
 static const ulint IO_IBUF_SEGMENT = 0;
 
@@ -166,6 +172,10 @@ struct os_aio_slot_t{
 	ulint		len;		/*!< length of the block to read or
 					write */
 	byte*		buf;		/*!< buffer used in i/o */
+	byte*		compressed;	/*!< if not NULL, buf points into
+					this memory that holds a compressed
+					copy of the page being written, and
+					which is freed with the slot */
 	ulint		type;		/*!< OS_FILE_READ or OS_FILE_WRITE */
 	os_offset_t	offset;		/*!< file offset in bytes */
 	os_file_t	file;		/*!< file where to read or write */
@@ -240,6 +250,16 @@ struct os_aio_array_t{
 				There is one such event for each
 				possible pending IO. The size of the
 				array is equal to n_slots. */
+	struct iocb**		pending;
+				/* Control blocks of the requests posted
+				with OS_AIO_SIMULATED_WAKE_LATER that
+				have not been submitted to the kernel.
+				Segment i owns the n_slots / n_segments
+				entries starting at i * n_slots /
+				n_segments; protected by mutex. */
+	ulint*			n_pending;
+				/* Number of unsubmitted requests of each
+				segment in pending */
 #endif /* LINUX_NATIV_AIO */
 };
 
@@ -252,6 +272,13 @@ struct os_aio_array_t{
 
 /** number of attempts before giving up on io_setup(). */
 #define OS_AIO_IO_SETUP_RETRY_ATTEMPTS	5
+
+/** maximum number of requests passed to one io_submit() call when
+submitting a batch of postponed requests. */
+#define OS_AIO_SUBMIT_BATCH	64
+
+/** time to sleep, in microseconds, if io_submit() returns EAGAIN. */
+#define OS_AIO_SUBMIT_RETRY_SLEEP	10000UL
 #endif
 
 /** Array of events used in simulated aio */
@@ -3875,6 +3902,14 @@ os_aio_array_create(
 	memset(io_event, 0x0, sizeof(*io_event) * n);
 	array->aio_events = io_event;
 
+	array->pending = static_cast<struct iocb**>(
+		ut_malloc(n * sizeof(*array->pending)));
+
+	array->n_pending = static_cast<ulint*>(
+		ut_malloc(n_segments * sizeof(*array->n_pending)));
+
+	memset(array->n_pending, 0x0, n_segments * sizeof(*array->n_pending));
+
 skip_native_aio:
 #endif /* LINUX_NATIVE_AIO */
 	for (ulint i = 0; i < n; i++) {
@@ -3931,6 +3966,8 @@ os_aio_array_free(
 	if (srv_use_native_aio) {
 		ut_free(array->aio_events);
 		ut_free(array->aio_ctx);
+		ut_free(array->pending);
+		ut_free(array->n_pending);
 	}
 #endif /* LINUX_NATIVE_AIO */
 
@@ -4276,7 +4313,11 @@ os_aio_array_reserve_slot(
 	void*		buf,	/*!< in: buffer where to read or from which
 				to write */
 	os_offset_t	offset,	/*!< in: file offset */
-	ulint		len)	/*!< in: length of the block to read or write */
+	ulint		len,	/*!< in: length of the block to read or write */
+	byte*		compressed)
+				/*!< in: memory of a compressed page
+				that buf points into, to be freed with
+				the slot, or NULL */
 {
 	os_aio_slot_t*	slot = NULL;
 #ifdef WIN_ASYNC_IO
@@ -4364,6 +4405,7 @@ found:
 	slot->len      = len;
 	slot->type     = type;
 	slot->buf      = static_cast<byte*>(buf);
+	slot->compressed = compressed;
 	slot->offset   = offset;
 	slot->io_already_done = FALSE;
 
@@ -4422,6 +4464,11 @@ os_aio_array_free_slot(
 
 	slot->reserved = FALSE;
 
+	if (slot->compressed != NULL) {
+		ut_free(slot->compressed);
+		slot->compressed = NULL;
+	}
+
 	array->n_reserved--;
 
 	if (array->n_reserved == array->n_slots - 1) {
@@ -4502,15 +4549,97 @@ os_aio_simulated_wake_handler_thread(
 	mutex_exit(&array->mutex);
 }
 
+#if defined(LINUX_NATIVE_AIO)
+/*******************************************************************//**
+Submits to the kernel the requests of an aio array that were posted with
+OS_AIO_SIMULATED_WAKE_LATER, with one io_submit() call per
+OS_AIO_SUBMIT_BATCH requests of a segment. */
+static
+void
+os_aio_linux_submit_pending(
+/*========================*/
+	os_aio_array_t*	array)	/*!< in: io request array */
+{
+	ulint	n_per_seg = array->n_slots / array->n_segments;
+
+	for (ulint seg = 0; seg < array->n_segments; ++seg) {
+
+		for (;;) {
+			struct iocb*	iocbs[OS_AIO_SUBMIT_BATCH];
+			ulint		n;
+			ulint		done;
+
+			mutex_enter(&array->mutex);
+
+			n = ut_min(array->n_pending[seg],
+				   static_cast<ulint>(OS_AIO_SUBMIT_BATCH));
+
+			array->n_pending[seg] -= n;
+
+			memcpy(iocbs, array->pending + seg * n_per_seg
+			       + array->n_pending[seg], n * sizeof(*iocbs));
+
+			mutex_exit(&array->mutex);
+
+			if (n == 0) {
+				break;
+			}
+
+			for (done = 0; done < n; ) {
+				int	ret;
+
+				ret = io_submit(array->aio_ctx[seg],
+						static_cast<long>(n - done),
+						iocbs + done);
+
+#if defined(UNIV_AIO_DEBUG)
+				fprintf(stderr,
+					"io_submit batch ret[%d]: n[%lu]"
+					" ctx[%p] seg[%lu]\n", ret,
+					(ulong) (n - done),
+					array->aio_ctx[seg], (ulong) seg);
+#endif
+
+				if (ret > 0) {
+					done += ret;
+				} else if (ret == -EAGAIN || ret == 0) {
+					os_thread_sleep(
+						OS_AIO_SUBMIT_RETRY_SLEEP);
+				} else {
+					ib_logf(IB_LOG_LEVEL_FATAL,
+						"io_submit() of %lu postponed"
+						" requests failed with"
+						" error %d",
+						(ulong) (n - done), -ret);
+				}
+			}
+		}
+	}
+}
+#endif /* LINUX_NATIVE_AIO */
+
 /**********************************************************************//**
-Wakes up simulated aio i/o-handler threads if they have something to do. */
+Wakes up simulated aio i/o-handler threads if they have something to do.
+With Linux native aio, submits the requests that were posted with
+OS_AIO_SIMULATED_WAKE_LATER instead. */
 
 void
 os_aio_simulated_wake_handler_threads(void)
 /*=======================================*/
 {
 	if (srv_use_native_aio) {
-		/* We do not use simulated aio: do nothing */
+#if defined(LINUX_NATIVE_AIO)
+		os_aio_array_t*	arrays[] = {
+			os_aio_read_array, os_aio_write_array,
+			os_aio_ibuf_array, os_aio_log_array
+		};
+
+		for (ulint i = 0; i < UT_ARR_SIZE(arrays); ++i) {
+			if (arrays[i] != NULL) {
+				os_aio_linux_submit_pending(arrays[i]);
+			}
+		}
+#endif /* LINUX_NATIVE_AIO */
 
 		return;
 	}
@@ -4561,14 +4690,19 @@ readahead requests. */
 
 #if defined(LINUX_NATIVE_AIO)
 /*******************************************************************//**
-Dispatch an AIO request to the kernel.
+Dispatch an AIO request to the kernel. If wake_later is set, the request
+is only queued in the array and submitted together with the rest of the
+batch by os_aio_simulated_wake_handler_threads().
 @return TRUE on success. */
 static
 ibool
 os_aio_linux_dispatch(
 /*==================*/
 	os_aio_array_t*	array,	/*!< in: io request array. */
-	os_aio_slot_t*	slot)	/*!< in: an already reserved slot. */
+	os_aio_slot_t*	slot,	/*!< in: an already reserved slot. */
+	ulint		wake_later)/*!< in: nonzero if the caller will
+				call os_aio_simulated_wake_handler_threads()
+				after posting a batch of requests */
 {
 	int		ret;
 	ulint		io_ctx_index;
@@ -4586,6 +4720,21 @@ os_aio_linux_dispatch(
 	iocb = &slot->control;
 	io_ctx_index = (slot->pos * array->n_segments) / array->n_slots;
 
+	if (wake_later) {
+		ulint	n_per_seg = array->n_slots / array->n_segments;
+
+		mutex_enter(&array->mutex);
+
+		ut_a(array->n_pending[io_ctx_index] < n_per_seg);
+
+		array->pending[io_ctx_index * n_per_seg
+			       + array->n_pending[io_ctx_index]++] = iocb;
+
+		mutex_exit(&array->mutex);
+
+		return(TRUE);
+	}
+
 	ret = io_submit(array->aio_ctx[io_ctx_index], 1, &iocb);
 
 #if defined(UNIV_AIO_DEBUG)
@@ -4607,6 +4756,128 @@ os_aio_linux_dispatch(
 #endif /* LINUX_NATIVE_AIO */
 
 
+/** Whether punching holes in data files works; cleared when the file
+system refuses it, after which pages are written uncompressed */
+static bool	os_file_punch_hole_works = true;
+
+/*******************************************************************//**
+Free the space of a part of a file without changing the file size.
+@return true if the range is now a hole in the file */
+static
+bool
+os_file_punch_hole(
+/*===============*/
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	offset,	/*!< in: start of the hole */
+	os_offset_t	len)	/*!< in: length of the hole in bytes */
+{
+#ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
+	if (!os_file_punch_hole_works) {
+		return(false);
+	}
+
+	if (fallocate(file, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+		      offset, len) == 0) {
+		return(true);
+	}
+
+	if (errno == EOPNOTSUPP || errno == ENOSYS) {
+		os_file_punch_hole_works = false;
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"The file system does not support punching holes"
+			" in files; pages will be written without"
+			" innodb_page_compression.");
+	}
+#else
+	os_file_punch_hole_works = false;
+#endif /* HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE */
+	return(false);
+}
+
+/*******************************************************************//**
+Compress a page for writing it to a page compressed tablespace. The header
+up to FIL_PAGE_TYPE and the space id are kept, the page type becomes
+FIL_PAGE_COMPRESSED and the rest of the page is compressed into the data
+area of the page.
+@return number of bytes to write, or 0 if the page did not compress
+by at least one OS_FILE_LOG_BLOCK_SIZE */
+static
+ulint
+os_file_compress_page(
+/*==================*/
+	ulint		algorithm,	/*!< in: page_zip_algorithm_t */
+	const byte*	src,		/*!< in: page to compress */
+	byte*		dst)		/*!< out: UNIV_PAGE_SIZE bytes for
+					the compressed page */
+{
+	ulint	data_len = page_zip_block_compress(
+		algorithm, src + FIL_PAGE_TYPE,
+		UNIV_PAGE_SIZE - FIL_PAGE_TYPE,
+		dst + FIL_PAGE_DATA,
+		UNIV_PAGE_SIZE - FIL_PAGE_DATA - OS_FILE_LOG_BLOCK_SIZE,
+		page_zip_level);
+
+	if (data_len == 0) {
+		return(0);
+	}
+
+	memcpy(dst, src, FIL_PAGE_TYPE);
+	mach_write_to_2(dst + FIL_PAGE_TYPE, FIL_PAGE_COMPRESSED);
+	memset(dst + FIL_PAGE_FILE_FLUSH_LSN, 0, 8);
+	mach_write_to_1(dst + FIL_PAGE_COMPRESS_ALGORITHM, algorithm);
+	mach_write_to_2(dst + FIL_PAGE_COMPRESS_SIZE, data_len);
+	memcpy(dst + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID,
+	       src + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID, 4);
+
+	/* Pad the compressed data to a whole number of blocks. */
+	ulint	len = ut_calc_align(FIL_PAGE_DATA + data_len,
+				    OS_FILE_LOG_BLOCK_SIZE);
+
+	memset(dst + FIL_PAGE_DATA + data_len, 0,
+	       len - FIL_PAGE_DATA - data_len);
+
+	return(len);
+}
+
+/*******************************************************************//**
+Decompress a page that was read from a page compressed tablespace. Pages
+of other types are left alone, as are pages that fail to decompress, so
+that the checksum check reports them as corrupted.
+@return false if the page was compressed but could not be decompressed */
+
+bool
+os_file_decompress_page(
+/*====================*/
+	byte*	buf)	/*!< in/out: page of UNIV_PAGE_SIZE bytes */
+{
+	if (mach_read_from_2(buf + FIL_PAGE_TYPE) != FIL_PAGE_COMPRESSED) {
+		return(true);
+	}
+
+	ulint	algorithm = mach_read_from_1(buf + FIL_PAGE_COMPRESS_ALGORITHM);
+	ulint	len = mach_read_from_2(buf + FIL_PAGE_COMPRESS_SIZE);
+
+	if (len > UNIV_PAGE_SIZE - FIL_PAGE_DATA) {
+		return(false);
+	}
+
+	byte*	tmp = static_cast<byte*>(ut_malloc(UNIV_PAGE_SIZE));
+
+	bool	success = page_zip_block_decompress(
+		algorithm, buf + FIL_PAGE_DATA, len,
+		tmp, UNIV_PAGE_SIZE - FIL_PAGE_TYPE)
+		== UNIV_PAGE_SIZE - FIL_PAGE_TYPE;
+
+	if (success) {
+		memcpy(buf + FIL_PAGE_TYPE, tmp, UNIV_PAGE_SIZE - FIL_PAGE_TYPE);
+	}
+
+	ut_free(tmp);
+
+	return(success);
+}
+
 /*******************************************************************//**
 NOTE! Use the corresponding macro os_aio(), not directly this function!
 Requests an asynchronous i/o operation.
@@ -4615,7 +4886,9 @@ Requests an asynchronous i/o operation.
 ibool
 os_aio_func(
 /*========*/
-	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	ulint		type,	/*!< in: OS_FILE_READ or OS_FILE_WRITE,
+				the latter possibly ORed to
+				OS_FILE_COMPRESSION(algorithm) */
 	ulint		mode,	/*!< in: OS_AIO_NORMAL, ..., possibly ORed
 				to OS_AIO_SIMULATED_WAKE_LATER: the
 				last flag advises this function not to wake
@@ -4670,6 +4943,45 @@ os_aio_func(
 	wake_later = mode & OS_AIO_SIMULATED_WAKE_LATER;
 	mode = mode & (~OS_AIO_SIMULATED_WAKE_LATER);
 
+	byte*	compressed = NULL;
+
+	if (type & OS_FILE_COMPRESSED) {
+		ulint	algorithm = (type & ~OS_FILE_COMPRESSED)
+			>> OS_FILE_COMPRESSION_SHIFT;
+
+		type &= ~OS_FILE_COMPRESSION_FLAGS;
+		ut_ad(type == OS_FILE_WRITE);
+		ut_ad(n == UNIV_PAGE_SIZE);
+
+		if (os_file_punch_hole_works
+		    && page_zip_algorithm_is_supported(algorithm)) {
+
+			compressed = static_cast<byte*>(
+				ut_malloc(2 * UNIV_PAGE_SIZE));
+
+			byte*	page = static_cast<byte*>(
+				ut_align(compressed, UNIV_PAGE_SIZE));
+
+			ulint	len = os_file_compress_page(
+				algorithm, static_cast<const byte*>(buf),
+				page);
+
+			/* Release the end of the page before writing
+			the compressed page. If the write does not
+			complete, the doublewrite buffer restores the
+			page. */
+			if (len != 0
+			    && os_file_punch_hole(file, offset + len,
+						  n - len)) {
+				buf = page;
+				n = len;
+			} else {
+				ut_free(compressed);
+				compressed = NULL;
+			}
+		}
+	}
+
 	if (mode == OS_AIO_SYNC
 #ifdef WIN_ASYNC_IO
 	    && !srv_use_native_aio
@@ -4695,7 +5007,13 @@ os_aio_func(
 		ut_ad(!srv_read_only_mode);
 		ut_a(type == OS_FILE_WRITE);
 
-		return(os_file_write_func(name, file, buf, offset, n));
+		ibool	ret = os_file_write_func(name, file, buf, offset, n);
+
+		if (compressed != NULL) {
+			ut_free(compressed);
+		}
+
+		return(ret);
 	}
 
 try_again:
@@ -4741,7 +5059,7 @@ try_again:
 	}
 
 	slot = os_aio_array_reserve_slot(type, array, message1, message2, file,
-					 name, buf, offset, n);
+					 name, buf, offset, n, compressed);
 	if (type == OS_FILE_READ) {
 		if (srv_use_native_aio) {
 			os_n_file_reads++;
@@ -4751,7 +5069,8 @@ try_again:
 				       &(slot->control));
 
 #elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+			if (!os_aio_linux_dispatch(array, slot,
+						   wake_later)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -4771,7 +5090,8 @@ try_again:
 					&(slot->control));
 
 #elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+			if (!os_aio_linux_dispatch(array, slot,
+						   wake_later)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -4818,6 +5138,8 @@ try_again:
 #if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
 err_exit:
 #endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
+	/* Keep the compressed page for retrying the write. */
+	slot->compressed = NULL;
 	os_aio_array_free_slot(array, slot);
 
 	if (os_file_handle_error(
@@ -4826,6 +5148,10 @@ err_exit:
 		goto try_again;
 	}
 
+	if (compressed != NULL) {
+		ut_free(compressed);
+	}
+
 	return(FALSE);
 }
 
@@ -24,6 +24,8 @@ process control primitives
 Created 9/30/1995 Heikki Tuuri
 *******************************************************/
 
+#include "ha_prototypes.h"
+
 #include "os0proc.h"
 #ifdef UNIV_NONINL
 #include "os0proc.ic"
@@ -32,6 +34,11 @@ Created 9/30/1995 Heikki Tuuri
 #include "ut0mem.h"
 #include "ut0byte.h"
 
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#include <numaif.h>
+#endif /* HAVE_LIBNUMA */
+
 /* FreeBSD for example has only MAP_ANON, Linux has MAP_ANONYMOUS and
 MAP_ANON but MAP_ANON is marked as deprecated */
 #if defined(MAP_ANONYMOUS)
@@ -44,6 +51,19 @@ ibool os_use_large_pages;
 /* Large page size. This may be a boot-time option on some platforms */
 ulint os_large_page_size;
 
+/** Number of NUMA nodes that buffer pool instances and their threads
+are bound to, or 0 if they are not bound */
+ulint os_numa_n_nodes;
+
+#ifdef HAVE_LIBNUMA
+/** Maximum number of NUMA nodes that are used for binding */
+# define OS_NUMA_MAX_NODES	64
+
+/** The ids of the first os_numa_n_nodes NUMA nodes that this process
+may allocate memory on */
+static int os_numa_nodes[OS_NUMA_MAX_NODES];
+#endif /* HAVE_LIBNUMA */
+
 /****************************************************************//**
 Converts the current process id to a number. It is not guaranteed that the
 number is unique. In Linux returns the 'process number' of the current
@@ -74,8 +94,10 @@ os_mem_alloc_large(
 	void*	ptr;
 	ulint	size;
 #if defined HAVE_LARGE_PAGES && defined UNIV_LINUX
+# ifndef MAP_HUGETLB
 	int shmid;
 	struct shmid_ds buf;
+# endif /* !MAP_HUGETLB */
 
 	if (!os_use_large_pages || !os_large_page_size) {
 		goto skip;
@@ -86,6 +108,21 @@ os_mem_alloc_large(
 	size = ut_2pow_round(*n + (os_large_page_size - 1),
 			     os_large_page_size);
 
+# ifdef MAP_HUGETLB
+	/* Ask for explicit huge pages of os_large_page_size, which
+	can be 2 MiB or 1 GiB on x86-64. */
+	ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | OS_MAP_ANON | MAP_HUGETLB
+#  ifdef MAP_HUGE_SHIFT
+		   | (int) (ut_2_log(os_large_page_size) << MAP_HUGE_SHIFT)
+#  endif /* MAP_HUGE_SHIFT */
+		   , -1, 0);
+	if (ptr == MAP_FAILED) {
+		fprintf(stderr, "InnoDB: HugeTLB: Warning: Failed to allocate"
+			" %lu bytes. errno %d\n", size, errno);
+		ptr = NULL;
+	}
+# else
 	shmid = shmget(IPC_PRIVATE, (size_t) size, SHM_HUGETLB | SHM_R | SHM_W);
 	if (shmid < 0) {
 		fprintf(stderr, "InnoDB: HugeTLB: Warning: Failed to allocate"
@@ -105,6 +142,7 @@ os_mem_alloc_large(
 		process exits */
 		shmctl(shmid, IPC_RMID, &buf);
 	}
+# endif /* MAP_HUGETLB */
 
 	if (ptr) {
 		*n = size;
@@ -162,6 +200,13 @@ skip:
 			(ulong) size, (ulong) errno);
 		ptr = NULL;
 	} else {
+# if defined HAVE_LARGE_PAGES && defined MADV_HUGEPAGE
+		if (os_use_large_pages) {
+			/* Let the kernel back the memory with
+			transparent huge pages. */
+			madvise(ptr, size, MADV_HUGEPAGE);
+		}
+# endif /* HAVE_LARGE_PAGES && MADV_HUGEPAGE */
 		mutex_enter(&ut_list_mutex);
 		ut_total_allocated_memory += size;
 		mutex_exit(&ut_list_mutex);
@@ -186,7 +231,7 @@ os_mem_free_large(
 	ut_a(ut_total_allocated_memory >= size);
 	mutex_exit(&ut_list_mutex);
 
-#if defined HAVE_LARGE_PAGES && defined UNIV_LINUX
+#if defined HAVE_LARGE_PAGES && defined UNIV_LINUX && !defined MAP_HUGETLB
 	if (os_use_large_pages && os_large_page_size && !shmdt(ptr)) {
 		mutex_enter(&ut_list_mutex);
 		ut_a(ut_total_allocated_memory >= size);
@@ -195,7 +240,7 @@ os_mem_free_large(
 		UNIV_MEM_FREE(ptr, size);
 		return;
 	}
-#endif /* HAVE_LARGE_PAGES && UNIV_LINUX */
+#endif /* HAVE_LARGE_PAGES && UNIV_LINUX && !MAP_HUGETLB */
 #ifdef _WIN32
 	/* When RELEASE memory, the size parameter must be 0.
 	Do not use MEM_RELEASE with MEM_DECOMMIT. */
@@ -230,3 +275,119 @@ os_mem_free_large(
 	}
 #endif
 }
+
+/****************************************************************//**
+Determine the NUMA nodes that memory and threads can be bound to, and
+set os_numa_n_nodes. Binding is only done on systems with more than one
+node. */
+
+void
+os_numa_init(
+/*=========*/
+	bool	bind)			/*!< in: whether binding is wanted */
+{
+	os_numa_n_nodes = 0;
+
+	if (!bind) {
+		return;
+	}
+
+#ifdef HAVE_LIBNUMA
+	if (numa_available() < 0) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"NUMA is not available; buffer pool instances"
+			" will not be bound to NUMA nodes.");
+		return;
+	}
+
+	ulint	n_nodes = 0;
+
+	for (int node = 0;
+	     node <= numa_max_node() && n_nodes < OS_NUMA_MAX_NODES;
+	     node++) {
+
+		if (numa_bitmask_isbitset(numa_all_nodes_ptr, node)) {
+			os_numa_nodes[n_nodes++] = node;
+		}
+	}
+
+	if (n_nodes < 2) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Only one NUMA node is available; buffer pool"
+			" instances will not be bound to NUMA nodes.");
+		return;
+	}
+
+	os_numa_n_nodes = n_nodes;
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Binding buffer pool instances to %lu NUMA nodes.",
+		n_nodes);
+#else
+	ib_logf(IB_LOG_LEVEL_WARN,
+		"InnoDB was built without NUMA support; buffer pool"
+		" instances will not be bound to NUMA nodes.");
+#endif /* HAVE_LIBNUMA */
+}
+
+/****************************************************************//**
+Bind memory that has not been touched yet to a NUMA node. Does nothing
+if os_numa_n_nodes == 0. */
+
+void
+os_numa_bind_mem(
+/*=============*/
+	void*	ptr,			/*!< in: start of the memory */
+	ulint	size,			/*!< in: size of the memory */
+	ulint	i)			/*!< in: buffer pool instance number,
+					mapped round-robin to the nodes */
+{
+#ifdef HAVE_LIBNUMA
+	if (os_numa_n_nodes == 0) {
+		return;
+	}
+
+	int		node = os_numa_nodes[i % os_numa_n_nodes];
+	struct bitmask*	mask = numa_allocate_nodemask();
+
+	numa_bitmask_setbit(mask, node);
+
+	/* Prefer the node rather than insisting on it, so that an
+	exhausted node does not make the allocation fail. */
+	if (mbind(ptr, size, MPOL_PREFERRED, mask->maskp, mask->size + 1,
+		  0) != 0) {
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Failed to bind %lu bytes of memory to NUMA"
+			" node %d, errno %d.", size, node, errno);
+	}
+
+	numa_bitmask_free(mask);
+#endif /* HAVE_LIBNUMA */
+}
+
+/****************************************************************//**
+Make the calling thread run on the CPUs of a NUMA node only. Does nothing
+if os_numa_n_nodes == 0. */
+
+void
+os_numa_bind_thread(
+/*================*/
+	ulint	i)			/*!< in: buffer pool instance or thread
+					number, mapped round-robin to the
+					nodes */
+{
+#ifdef HAVE_LIBNUMA
+	if (os_numa_n_nodes == 0) {
+		return;
+	}
+
+	int	node = os_numa_nodes[i % os_numa_n_nodes];
+
+	if (numa_run_on_node(node) != 0) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Failed to bind a thread to NUMA node %d, errno %d.",
+			node, errno);
+	}
+#endif /* HAVE_LIBNUMA */
+}
@@ -216,6 +216,49 @@ page_cur_rec_field_extends(
 }
 #endif /* PAGE_CUR_LE_OR_EXTENDS */
 
+/** Compare the first field of a data tuple to that of a record by their
+normalized prefixes.
+@param[in] norm normalization of the first field
+@param[in] prefix cmp_norm_prefix() of the first field of the tuple
+@param[in] rec user record
+@param[in] offsets rec_get_offsets(rec)
+@return positive or negative if the tuple is greater or less than rec,
+0 if the prefixes do not decide the order */
+static
+int
+page_cur_cmp_norm(
+	const cmp_norm_t*	norm,
+	ib_uint64_t		prefix,
+	const rec_t*		rec,
+	const ulint*		offsets)
+{
+	const byte*	data;
+	ulint		len;
+	ib_uint64_t	rec_prefix;
+
+	if (UNIV_UNLIKELY(rec_get_info_bits(rec, rec_offs_comp(offsets))
+			  & REC_INFO_MIN_REC_FLAG)) {
+		/* The record is smaller than any tuple. */
+		return(0);
+	}
+
+	data = rec_get_nth_field(rec, offsets, 0, &len);
+
+	if (len == UNIV_SQL_NULL) {
+		return(0);
+	}
+
+	rec_prefix = cmp_norm_prefix(norm, data, len);
+
+	if (prefix > rec_prefix) {
+		return(1);
+	} else if (prefix < rec_prefix) {
+		return(-1);
+	}
+
+	return(0);
+}
+
 /****************************************************************//**
 Searches the right position for a page cursor. */
 
@@ -258,6 +301,15 @@ page_cur_search_with_match(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	/* Whether offsets[] holds the offsets of every user record of
+	the page, which is the case on the leaf pages of an index with
+	dict_index_t::fixed_offsets once they have been read */
+	bool		same_offsets	= false;
+	/* Normalization of the first field of the tuple, if the
+	search compares normalized prefixes of it first */
+	cmp_norm_t	norm;
+	bool		use_norm	= false;
+	ib_uint64_t	prefix		= 0;
 	rec_offs_init(offsets_);
 
 	ut_ad(dtuple_validate(tuple));
@@ -315,6 +367,23 @@ page_cur_search_with_match(
 	up_matched_fields  = *iup_matched_fields;
 	low_matched_fields = *ilow_matched_fields;
 
+	if (srv_normalized_key_search
+	    && min(low_matched_fields, up_matched_fields) == 0
+	    && !(dtuple_get_info_bits(tuple) & REC_INFO_MIN_REC_FLAG)) {
+		const dfield_t*	field = dtuple_get_nth_field(tuple, 0);
+		const dtype_t*	type = dfield_get_type(field);
+
+		if (!dfield_is_null(field)
+		    && cmp_norm_init(&norm, type->mtype, type->prtype)) {
+			use_norm = true;
+			prefix = cmp_norm_prefix(
+				&norm,
+				static_cast<const byte*>(
+					dfield_get_data(field)),
+				dfield_get_len(field));
+		}
+	}
+
 	/* Perform binary search. First the search is done through the page
 	directory, after that as a linear search in the list of records
 	owned by the upper limit directory slot. */
@@ -333,12 +402,26 @@ page_cur_search_with_match(
 		cur_matched_fields = min(low_matched_fields,
 					 up_matched_fields);
 
-		offsets = rec_get_offsets(mid_rec, index, offsets,
-					  dtuple_get_n_fields_cmp(tuple),
-					  &heap);
+		if (same_offsets) {
+			rec_offs_make_valid(mid_rec, index, offsets);
+		} else {
+			offsets = rec_get_offsets(
+				mid_rec, index, offsets,
+				dtuple_get_n_fields_cmp(tuple), &heap);
+
+			same_offsets = index->fixed_offsets != NULL
+				&& page_is_leaf(page);
+		}
+
+		cmp = use_norm && cur_matched_fields == 0
+			? page_cur_cmp_norm(&norm, prefix, mid_rec, offsets)
+			: 0;
 
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, offsets,
-						&cur_matched_fields);
+		if (cmp == 0) {
+			cmp = cmp_dtuple_rec_with_match(
+				tuple, mid_rec, offsets,
+				&cur_matched_fields);
+		}
 		if (cmp > 0) {
 low_slot_match:
 			low = mid;
@@ -386,12 +469,26 @@ up_slot_match:
 		cur_matched_fields = min(low_matched_fields,
 					 up_matched_fields);
 
-		offsets = rec_get_offsets(mid_rec, index, offsets,
-					  dtuple_get_n_fields_cmp(tuple),
-					  &heap);
+		if (same_offsets) {
+			rec_offs_make_valid(mid_rec, index, offsets);
+		} else {
+			offsets = rec_get_offsets(
+				mid_rec, index, offsets,
+				dtuple_get_n_fields_cmp(tuple), &heap);
+
+			same_offsets = index->fixed_offsets != NULL
+				&& page_is_leaf(page);
+		}
+
+		cmp = use_norm && cur_matched_fields == 0
+			? page_cur_cmp_norm(&norm, prefix, mid_rec, offsets)
+			: 0;
 
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, offsets,
-						&cur_matched_fields);
+		if (cmp == 0) {
+			cmp = cmp_dtuple_rec_with_match(
+				tuple, mid_rec, offsets,
+				&cur_matched_fields);
+		}
 		if (cmp > 0) {
 low_rec_match:
 			low_rec = mid_rec;
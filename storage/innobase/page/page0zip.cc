@@ -38,6 +38,12 @@ Created June 2005 by Marko Makela
 #include "log0recv.h"
 #include "row0trunc.h"
 #include "zlib.h"
+#ifdef HAVE_LZ4
+# include <lz4.h>
+#endif /* HAVE_LZ4 */
+#ifdef HAVE_ZSTD
+# include <zstd.h>
+#endif /* HAVE_ZSTD */
 #ifndef UNIV_HOTBACKUP
 # include "buf0buf.h"
 # include "buf0lru.h"
@@ -47,6 +53,7 @@ Created June 2005 by Marko Makela
 # include "srv0mon.h"
 # include "srv0srv.h"
 # include "ut0crc32.h"
+# include "fil0fil.h"
 #else /* !UNIV_HOTBACKUP */
 # include "buf0checksum.h"
 # define lock_move_reorganize_page(block, temp_block)	((void) 0)
@@ -70,6 +77,10 @@ uint	page_zip_level = DEFAULT_COMPRESSION_LEVEL;
 compression algorithm changes in zlib. */
 my_bool	page_zip_log_pages = true;
 
+/* Compression algorithm of newly created compressed tables.
+Settable by user. */
+ulong	page_zip_algorithm = PAGE_ZIP_ALGORITHM_ZLIB;
+
 /* Please refer to ../include/page0zip.ic for a description of the
 compressed page format. */
 
@@ -755,6 +766,556 @@ page_zip_set_alloc(
 	strm->opaque = heap;
 }
 
+/* The compressed page stream.
+
+With zlib, the stream is the output of deflate().  The other algorithms
+do not support the incremental flushing that zlib offers.  For them, the
+stream consists of a single byte that identifies the algorithm, followed
+by two blocks: the index field information that page_zip_compress()
+flushes with Z_FULL_FLUSH, and the records that it compresses with
+Z_FINISH.  Each block is preceded by 2 bytes of compressed length and
+2 bytes of uncompressed length.  The first byte of a zlib stream is
+a CMF byte whose low nibble is always Z_DEFLATED (8), so the two formats
+cannot be confused, and page_zip_decompress() can detect the algorithm
+from the stream itself.
+
+The functions page_zip_deflate() and page_zip_inflate() are drop-in
+replacements of deflate() and inflate() for the way they are used in
+this file.  For the block algorithms, they buffer the input until the
+next flush, or decompress a whole block at a time and copy the output
+in the pieces that the caller asks for. */
+
+/** Size of a block header in the compressed page stream */
+#define PAGE_ZIP_BLOCK_HEADER_SIZE	4
+
+/** Number of blocks in a compressed page stream */
+#define PAGE_ZIP_N_BLOCKS		2
+
+/** A block compression algorithm */
+struct page_zip_codec_t {
+	/** Compress a block.
+	@param src	uncompressed data
+	@param src_len	length of src in bytes
+	@param dst	output buffer
+	@param dst_len	size of dst in bytes
+	@param level	compression level
+	@return length of the compressed data, or 0 if it did not fit */
+	ulint	(*compress)(const byte* src, ulint src_len,
+			    byte* dst, ulint dst_len, ulint level);
+	/** Decompress a block.
+	@param src	compressed data
+	@param src_len	length of src in bytes
+	@param dst	output buffer
+	@param dst_len	size of dst in bytes
+	@return length of the decompressed data, or ULINT_UNDEFINED
+	on error */
+	ulint	(*decompress)(const byte* src, ulint src_len,
+			      byte* dst, ulint dst_len);
+};
+
+/** Compress a block with zlib.
+@see page_zip_codec_t::compress */
+static
+ulint
+page_zip_zlib_compress(
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		dst_len,
+	ulint		level)
+{
+	uLongf	len = dst_len;
+
+	if (compress2(dst, &len, src, src_len, (int) level) != Z_OK) {
+		return(0);
+	}
+
+	return(len);
+}
+
+/** Decompress a block with zlib.
+@see page_zip_codec_t::decompress */
+static
+ulint
+page_zip_zlib_decompress(
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		dst_len)
+{
+	uLongf	len = dst_len;
+
+	if (uncompress(dst, &len, src, src_len) != Z_OK) {
+		return(ULINT_UNDEFINED);
+	}
+
+	return(len);
+}
+
+/** The zlib codec.  Compressed pages use zlib as a stream, so this is
+only used by page_zip_block_compress() and page_zip_block_decompress(). */
+static const page_zip_codec_t	page_zip_zlib = {
+	page_zip_zlib_compress,
+	page_zip_zlib_decompress
+};
+
+#ifdef HAVE_LZ4
+/** Compress a block with LZ4.
+@see page_zip_codec_t::compress */
+static
+ulint
+page_zip_lz4_compress(
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		dst_len,
+	ulint		level __attribute__((unused)))
+{
+	int	len = LZ4_compress_default(
+		reinterpret_cast<const char*>(src),
+		reinterpret_cast<char*>(dst),
+		static_cast<int>(src_len), static_cast<int>(dst_len));
+
+	return(len > 0 ? static_cast<ulint>(len) : 0);
+}
+
+/** Decompress a block with LZ4.
+@see page_zip_codec_t::decompress */
+static
+ulint
+page_zip_lz4_decompress(
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		dst_len)
+{
+	int	len = LZ4_decompress_safe(
+		reinterpret_cast<const char*>(src),
+		reinterpret_cast<char*>(dst),
+		static_cast<int>(src_len), static_cast<int>(dst_len));
+
+	return(len >= 0 ? static_cast<ulint>(len) : ULINT_UNDEFINED);
+}
+
+/** The LZ4 codec */
+static const page_zip_codec_t	page_zip_lz4 = {
+	page_zip_lz4_compress,
+	page_zip_lz4_decompress
+};
+#endif /* HAVE_LZ4 */
+
+#ifdef HAVE_ZSTD
+/** Compress a block with Zstandard.
+@see page_zip_codec_t::compress */
+static
+ulint
+page_zip_zstd_compress(
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		dst_len,
+	ulint		level)
+{
+	size_t	len = ZSTD_compress(dst, dst_len, src, src_len,
+				    static_cast<int>(level));
+
+	return(ZSTD_isError(len) ? 0 : len);
+}
+
+/** Decompress a block with Zstandard.
+@see page_zip_codec_t::decompress */
+static
+ulint
+page_zip_zstd_decompress(
+	const byte*	src,
+	ulint		src_len,
+	byte*		dst,
+	ulint		dst_len)
+{
+	size_t	len = ZSTD_decompress(dst, dst_len, src, src_len);
+
+	return(ZSTD_isError(len) ? ULINT_UNDEFINED : len);
+}
+
+/** The Zstandard codec */
+static const page_zip_codec_t	page_zip_zstd = {
+	page_zip_zstd_compress,
+	page_zip_zstd_decompress
+};
+#endif /* HAVE_ZSTD */
+
+/**********************************************************************//**
+Look up the block codec of a compression algorithm.
+@return the codec, or NULL for zlib or an algorithm that is not
+available in this build */
+static
+const page_zip_codec_t*
+page_zip_get_codec(
+/*===============*/
+	ulint	algorithm)	/*!< in: page_zip_algorithm_t */
+{
+	switch (algorithm) {
+#ifdef HAVE_LZ4
+	case PAGE_ZIP_ALGORITHM_LZ4:
+		return(&page_zip_lz4);
+#endif /* HAVE_LZ4 */
+#ifdef HAVE_ZSTD
+	case PAGE_ZIP_ALGORITHM_ZSTD:
+		return(&page_zip_zstd);
+#endif /* HAVE_ZSTD */
+	}
+
+	return(NULL);
+}
+
+/**********************************************************************//**
+Check if a page compression algorithm is available in this build.
+@return true if pages can be compressed and decompressed with it */
+
+bool
+page_zip_algorithm_is_supported(
+/*============================*/
+	ulint	algorithm)	/*!< in: page_zip_algorithm_t */
+{
+	return(algorithm == PAGE_ZIP_ALGORITHM_ZLIB
+	       || page_zip_get_codec(algorithm) != NULL);
+}
+
+/**********************************************************************//**
+Compress a block of data, such as a whole page.
+@return length of the compressed data, or 0 if it did not fit in dst */
+
+ulint
+page_zip_block_compress(
+/*====================*/
+	ulint		algorithm,	/*!< in: page_zip_algorithm_t */
+	const byte*	src,		/*!< in: data to compress */
+	ulint		src_len,	/*!< in: length of src in bytes */
+	byte*		dst,		/*!< out: compressed data */
+	ulint		dst_len,	/*!< in: size of dst in bytes */
+	ulint		level)		/*!< in: compression level */
+{
+	const page_zip_codec_t*	codec = algorithm == PAGE_ZIP_ALGORITHM_ZLIB
+		? &page_zip_zlib
+		: page_zip_get_codec(algorithm);
+
+	ut_a(codec != NULL);
+
+	return(codec->compress(src, src_len, dst, dst_len, level));
+}
+
+/**********************************************************************//**
+Decompress a block of data that was compressed by page_zip_block_compress().
+@return length of the decompressed data, or ULINT_UNDEFINED on error */
+
+ulint
+page_zip_block_decompress(
+/*======================*/
+	ulint		algorithm,	/*!< in: page_zip_algorithm_t */
+	const byte*	src,		/*!< in: compressed data */
+	ulint		src_len,	/*!< in: length of src in bytes */
+	byte*		dst,		/*!< out: decompressed data */
+	ulint		dst_len)	/*!< in: size of dst in bytes */
+{
+	const page_zip_codec_t*	codec = algorithm == PAGE_ZIP_ALGORITHM_ZLIB
+		? &page_zip_zlib
+		: page_zip_get_codec(algorithm);
+
+	if (codec == NULL) {
+		return(ULINT_UNDEFINED);
+	}
+
+	return(codec->decompress(src, src_len, dst, dst_len));
+}
+
+/** A compressed page stream. The z_stream members next_in, avail_in,
+total_in, next_out, avail_out, total_out and msg are maintained for all
+the algorithms. */
+struct page_zip_stream_t : public z_stream {
+	/** Block codec, or NULL for zlib */
+	const page_zip_codec_t*	codec;
+	/** Compression level */
+	ulint			level;
+	/** Buffered input of the block being compressed, or the
+	decompressed block being copied out */
+	byte*			buf;
+	/** Number of bytes in buf */
+	ulint			len;
+	/** Number of bytes of buf copied out by page_zip_inflate() */
+	ulint			pos;
+	/** Number of blocks compressed or decompressed */
+	ulint			n_blocks;
+	/** Whether only the stream header has been decompressed */
+	bool			header;
+};
+
+/**********************************************************************//**
+Prepare a page stream for block compression or decompression. The
+memory heap must have been set by page_zip_set_alloc(). */
+static
+void
+page_zip_stream_init(
+/*=================*/
+	page_zip_stream_t*	strm,	/*!< in/out: stream */
+	const page_zip_codec_t*	codec,	/*!< in: block codec */
+	ulint			level)	/*!< in: compression level */
+{
+	strm->codec = codec;
+	strm->level = level;
+	strm->buf = static_cast<byte*>(
+		mem_heap_alloc(static_cast<mem_heap_t*>(strm->opaque),
+			       UNIV_PAGE_SIZE));
+	strm->len = 0;
+	strm->pos = 0;
+	strm->n_blocks = 0;
+	strm->header = true;
+	strm->total_in = 0;
+	strm->total_out = 0;
+	strm->msg = NULL;
+}
+
+/**********************************************************************//**
+Initialize a page stream for compression.
+@return Z_OK, or a zlib error code */
+static
+int
+page_zip_deflate_init(
+/*==================*/
+	page_zip_stream_t*	strm,		/*!< in/out: stream */
+	ulint			algorithm,	/*!< in: page_zip_algorithm_t */
+	ulint			level)		/*!< in: compression level */
+{
+	const page_zip_codec_t*	codec = page_zip_get_codec(algorithm);
+
+	if (codec == NULL || level == 0) {
+		/* Level 0 means no compression. Only zlib can
+		store data uncompressed, in stored blocks. */
+		strm->codec = NULL;
+		return(deflateInit2(strm, (int) level,
+				    Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
+				    MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY));
+	}
+
+	page_zip_stream_init(strm, codec, level);
+
+	/* The first byte of the stream identifies the algorithm. */
+	if (strm->avail_out == 0) {
+		return(Z_BUF_ERROR);
+	}
+
+	*strm->next_out++ = static_cast<byte>(algorithm);
+	strm->avail_out--;
+	strm->total_out++;
+
+	return(Z_OK);
+}
+
+/**********************************************************************//**
+Compress data.  This is deflate() for the page stream.  Block codecs
+compress the buffered input when flush is Z_FULL_FLUSH or Z_FINISH.
+@return Z_OK, Z_STREAM_END, or a zlib error code */
+static
+int
+page_zip_deflate(
+/*=============*/
+	page_zip_stream_t*	strm,	/*!< in/out: stream */
+	int			flush)	/*!< in: flushing method */
+{
+	ulint	len;
+	byte*	out;
+
+	if (strm->codec == NULL) {
+		return(deflate(strm, flush));
+	}
+
+	if (strm->len + strm->avail_in > UNIV_PAGE_SIZE) {
+		return(Z_STREAM_ERROR);
+	}
+
+	memcpy(strm->buf + strm->len, strm->next_in, strm->avail_in);
+	strm->len += strm->avail_in;
+	strm->next_in += strm->avail_in;
+	strm->total_in += strm->avail_in;
+	strm->avail_in = 0;
+
+	if (flush == Z_NO_FLUSH) {
+		return(Z_OK);
+	}
+
+	ut_ad(flush == Z_FULL_FLUSH || flush == Z_FINISH);
+	ut_ad(strm->n_blocks < PAGE_ZIP_N_BLOCKS);
+
+	if (strm->avail_out <= PAGE_ZIP_BLOCK_HEADER_SIZE) {
+		return(Z_BUF_ERROR);
+	}
+
+	out = strm->next_out + PAGE_ZIP_BLOCK_HEADER_SIZE;
+
+	if (strm->len == 0) {
+		len = 0;
+	} else {
+		len = strm->codec->compress(
+			strm->buf, strm->len, out,
+			strm->avail_out - PAGE_ZIP_BLOCK_HEADER_SIZE,
+			strm->level);
+
+		if (len == 0) {
+			return(Z_BUF_ERROR);
+		}
+	}
+
+	mach_write_to_2(strm->next_out, len);
+	mach_write_to_2(strm->next_out + 2, strm->len);
+
+	len += PAGE_ZIP_BLOCK_HEADER_SIZE;
+	strm->next_out += len;
+	strm->avail_out -= (uInt) len;
+	strm->total_out += len;
+	strm->len = 0;
+	strm->n_blocks++;
+
+	return(flush == Z_FINISH ? Z_STREAM_END : Z_OK);
+}
+
+/**********************************************************************//**
+Free a page stream after compression.
+@return Z_OK, or a zlib error code */
+static
+int
+page_zip_deflate_end(
+/*=================*/
+	page_zip_stream_t*	strm)	/*!< in/out: stream */
+{
+	/* The buffer of a block codec is in the memory heap. */
+	return(strm->codec == NULL ? deflateEnd(strm) : Z_OK);
+}
+
+/**********************************************************************//**
+Initialize a page stream for decompression.  The algorithm is detected
+from the first byte of the stream, which must be available in next_in.
+@return Z_OK, or a zlib error code */
+static
+int
+page_zip_inflate_init(
+/*==================*/
+	page_zip_stream_t*	strm)	/*!< in/out: stream */
+{
+	ulint	algorithm = strm->avail_in
+		? *strm->next_in
+		: PAGE_ZIP_ALGORITHM_ZLIB;
+
+	if ((algorithm & 0xf) == Z_DEFLATED
+	    || algorithm == PAGE_ZIP_ALGORITHM_ZLIB) {
+		strm->codec = NULL;
+		return(inflateInit2(strm, UNIV_PAGE_SIZE_SHIFT));
+	}
+
+	page_zip_stream_init(strm, page_zip_get_codec(algorithm), 0);
+
+	if (strm->codec == NULL) {
+		strm->msg = const_cast<char*>(
+			"unknown compression algorithm");
+		return(Z_DATA_ERROR);
+	}
+
+	strm->next_in++;
+	strm->avail_in--;
+	strm->total_in++;
+
+	return(Z_OK);
+}
+
+/**********************************************************************//**
+Decompress data.  This is inflate() for the page stream.  Block codecs
+decompress a whole block when the previous one has been copied out.
+With Z_BLOCK, no data is copied over a block boundary.
+@return Z_OK, Z_STREAM_END, or a zlib error code */
+static
+int
+page_zip_inflate(
+/*=============*/
+	page_zip_stream_t*	strm,	/*!< in/out: stream */
+	int			flush)	/*!< in: flushing method */
+{
+	ulint	len;
+
+	if (strm->codec == NULL) {
+		return(inflate(strm, flush));
+	}
+
+	if (strm->pos == strm->len) {
+		ulint	c_len;
+
+		if (strm->n_blocks == PAGE_ZIP_N_BLOCKS) {
+			return(Z_STREAM_END);
+		}
+
+		if (flush == Z_BLOCK && strm->header) {
+			/* Like inflate(), stop after the stream header. */
+			strm->header = false;
+			return(Z_OK);
+		}
+
+		if (strm->avail_in < PAGE_ZIP_BLOCK_HEADER_SIZE) {
+			strm->msg = const_cast<char*>("truncated block");
+			return(Z_DATA_ERROR);
+		}
+
+		c_len = mach_read_from_2(strm->next_in);
+		len = mach_read_from_2(strm->next_in + 2);
+
+		if (c_len > strm->avail_in - PAGE_ZIP_BLOCK_HEADER_SIZE
+		    || len > UNIV_PAGE_SIZE
+		    || (c_len == 0) != (len == 0)
+		    || (len && strm->codec->decompress(
+				strm->next_in + PAGE_ZIP_BLOCK_HEADER_SIZE,
+				c_len, strm->buf, UNIV_PAGE_SIZE) != len)) {
+			strm->msg = const_cast<char*>("invalid block");
+			return(Z_DATA_ERROR);
+		}
+
+		c_len += PAGE_ZIP_BLOCK_HEADER_SIZE;
+		strm->header = false;
+		strm->next_in += c_len;
+		strm->avail_in -= (uInt) c_len;
+		strm->total_in += c_len;
+		strm->len = len;
+		strm->pos = 0;
+		strm->n_blocks++;
+	}
+
+	len = ut_min(static_cast<ulint>(strm->avail_out),
+		     strm->len - strm->pos);
+
+	memcpy(strm->next_out, strm->buf + strm->pos, len);
+	strm->next_out += len;
+	strm->avail_out -= (uInt) len;
+	strm->total_out += len;
+	strm->pos += len;
+
+	if (strm->pos == strm->len && strm->n_blocks == PAGE_ZIP_N_BLOCKS) {
+		return(Z_STREAM_END);
+	}
+
+	if (flush == Z_FINISH) {
+		return(Z_BUF_ERROR);
+	}
+
+	return(len || flush == Z_BLOCK ? Z_OK : Z_BUF_ERROR);
+}
+
+/**********************************************************************//**
+Free a page stream after decompression.
+@return Z_OK, or a zlib error code */
+static
+int
+page_zip_inflate_end(
+/*=================*/
+	page_zip_stream_t*	strm)	/*!< in/out: stream */
+{
+	return(strm->codec == NULL ? inflateEnd(strm) : Z_OK);
+}
+
 #if 0 || defined UNIV_DEBUG || defined UNIV_ZIP_DEBUG
 /** Symbol for enabling compression and decompression diagnostics */
 # define PAGE_ZIP_COMPRESS_DBG
@@ -778,7 +1339,7 @@ int
 page_zip_compress_deflate(
 /*======================*/
 	FILE*		logfile,/*!< in: log file, or NULL */
-	z_streamp	strm,	/*!< in/out: compressed stream for deflate() */
+	page_zip_stream_t*	strm,	/*!< in/out: compressed stream */
 	int		flush)	/*!< in: deflate() flushing method */
 {
 	int	status;
@@ -791,21 +1352,21 @@ page_zip_compress_deflate(
 			perror("fwrite");
 		}
 	}
-	status = deflate(strm, flush);
+	status = page_zip_deflate(strm, flush);
 	if (UNIV_UNLIKELY(page_zip_compress_dbg)) {
 		fprintf(stderr, " -> %d\n", status);
 	}
 	return(status);
 }
 
-/* Redefine deflate(). */
-# undef deflate
-/** Debug wrapper for the zlib compression routine deflate().
+/* Redefine page_zip_deflate(). */
+/** Debug wrapper for the compression routine page_zip_deflate().
 Log the operation if page_zip_compress_dbg is set.
 @param strm in/out: compressed stream
 @param flush in: flushing method
 @return deflate() status: Z_OK, Z_BUF_ERROR, ... */
-# define deflate(strm, flush) page_zip_compress_deflate(logfile, strm, flush)
+# define page_zip_deflate(strm, flush)			\
+	page_zip_compress_deflate(logfile, strm, flush)
 /** Declaration of the logfile parameter */
 # define FILE_LOGFILE FILE* logfile,
 /** The logfile parameter */
@@ -825,7 +1386,7 @@ int
 page_zip_compress_node_ptrs(
 /*========================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed page stream */
 	const rec_t**	recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -854,7 +1415,7 @@ page_zip_compress_node_ptrs(
 			- c_stream->next_in);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -868,7 +1429,7 @@ page_zip_compress_node_ptrs(
 			- REC_NODE_PTR_SIZE);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -893,7 +1454,7 @@ int
 page_zip_compress_sec(
 /*==================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed page stream */
 	const rec_t**	recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense)	/*!< in: size of recs[] */
@@ -913,7 +1474,7 @@ page_zip_compress_sec(
 		if (UNIV_LIKELY(c_stream->avail_in)) {
 			UNIV_MEM_ASSERT_RW(c_stream->next_in,
 					   c_stream->avail_in);
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 				break;
 			}
@@ -939,7 +1500,7 @@ int
 page_zip_compress_clust_ext(
 /*========================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed page stream */
 	const rec_t*	rec,		/*!< in: record */
 	const ulint*	offsets,	/*!< in: rec_get_offsets(rec) */
 	ulint		trx_id_col,	/*!< in: position of of DB_TRX_ID */
@@ -977,7 +1538,7 @@ page_zip_compress_clust_ext(
 				(uInt) (src - c_stream->next_in);
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1006,7 +1567,7 @@ page_zip_compress_clust_ext(
 			c_stream->avail_in =
 				(uInt) (src - c_stream->next_in);
 			if (UNIV_LIKELY(c_stream->avail_in)) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1066,7 +1627,7 @@ int
 page_zip_compress_clust(
 /*====================*/
 	FILE_LOGFILE
-	z_stream*	c_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	c_stream,	/*!< in/out: compressed page stream */
 	const rec_t**	recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -1104,7 +1665,7 @@ page_zip_compress_clust(
 			- c_stream->next_in);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1152,7 +1713,7 @@ page_zip_compress_clust(
 				(uInt) (src - c_stream->next_in);
 
 			if (c_stream->avail_in) {
-				err = deflate(c_stream, Z_NO_FLUSH);
+				err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 				if (UNIV_UNLIKELY(err != Z_OK)) {
 
 					return(err);
@@ -1181,7 +1742,7 @@ page_zip_compress_clust(
 			- c_stream->next_in);
 
 		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
+			err = page_zip_deflate(c_stream, Z_NO_FLUSH);
 			if (UNIV_UNLIKELY(err != Z_OK)) {
 
 				goto func_exit;
@@ -1193,6 +1754,31 @@ page_zip_compress_clust(
 func_exit:
 	return(err);}
 
+/**********************************************************************//**
+Determine the compression algorithm of a page.  During recovery, and when
+applying a TRUNCATE log record, the index is a dummy or missing, and the
+algorithm is taken from the tablespace flags instead.
+@return page_zip_algorithm_t */
+static
+ulint
+page_zip_compress_algorithm(
+/*========================*/
+	const page_t*		page,	/*!< in: uncompressed page */
+	const dict_index_t*	index)	/*!< in: index of the page, or NULL */
+{
+	ulint	flags;
+
+	if (index != NULL && !recv_recovery_is_on()) {
+		return(DICT_TF_GET_ZIP_ALGORITHM(index->table->flags));
+	}
+
+	flags = fil_space_get_flags(page_get_space_id(page));
+
+	return(flags == ULINT_UNDEFINED
+	       ? PAGE_ZIP_ALGORITHM_ZLIB
+	       : FSP_FLAGS_GET_ZIP_ALGORITHM(flags));
+}
+
 /**********************************************************************//**
 Compress a page.
 @return TRUE on success, FALSE on failure; page_zip will be left
@@ -1215,7 +1801,7 @@ page_zip_compress(
 	mtr_t*			mtr)		/*!< in/out: mini-transaction,
 						or NULL */
 {
-	z_stream		c_stream;
+	page_zip_stream_t	c_stream;
 	int			err;
 	ulint			n_fields;	/* number of index fields
 						needed */
@@ -1355,17 +1941,16 @@ page_zip_compress(
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, (int) level,
-			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
-			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
-	ut_a(err == Z_OK);
-
 	c_stream.next_out = buf;
 
 	/* Subtract the space reserved for uncompressed data. */
 	/* Page header and the end marker of the modification log */
 	c_stream.avail_out = (uInt) (buf_end - buf - 1);
 
+	err = page_zip_deflate_init(
+		&c_stream, page_zip_compress_algorithm(page, index), level);
+	ut_a(err == Z_OK);
+
 	/* Dense page directory and uncompressed columns, if any */
 	if (page_is_leaf(page)) {
 		if ((index && dict_index_is_clust(index))
@@ -1424,7 +2009,7 @@ page_zip_compress(
 	}
 
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FULL_FLUSH);
+	err = page_zip_deflate(&c_stream, Z_FULL_FLUSH);
 	if (err != Z_OK) {
 		goto zlib_error;
 	}
@@ -1478,11 +2063,11 @@ page_zip_compress(
 	ut_a(c_stream.avail_in <= UNIV_PAGE_SIZE - PAGE_ZIP_START - PAGE_DIR);
 
 	UNIV_MEM_ASSERT_RW(c_stream.next_in, c_stream.avail_in);
-	err = deflate(&c_stream, Z_FINISH);
+	err = page_zip_deflate(&c_stream, Z_FINISH);
 
 	if (UNIV_UNLIKELY(err != Z_STREAM_END)) {
 zlib_error:
-		deflateEnd(&c_stream);
+		page_zip_deflate_end(&c_stream);
 		mem_heap_free(heap);
 err_exit:
 #ifdef PAGE_ZIP_COMPRESS_DBG
@@ -1508,7 +2093,7 @@ err_exit:
 		return(FALSE);
 	}
 
-	err = deflateEnd(&c_stream);
+	err = page_zip_deflate_end(&c_stream);
 	ut_a(err == Z_OK);
 
 	ut_ad(buf + c_stream.total_out == c_stream.next_out);
@@ -2206,7 +2791,7 @@ static
 ibool
 page_zip_decompress_heap_no(
 /*========================*/
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed page stream */
 	rec_t*		rec,		/*!< in/out: record */
 	ulint&		heap_status)	/*!< in/out: heap_no and status bits */
 {
@@ -2232,7 +2817,7 @@ ibool
 page_zip_decompress_node_ptrs(
 /*==========================*/
 	page_zip_des_t*	page_zip,	/*!< in/out: compressed page */
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed page stream */
 	rec_t**		recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -2260,7 +2845,7 @@ page_zip_decompress_node_ptrs(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			page_zip_decompress_heap_no(
 				d_stream, rec, heap_status);
@@ -2296,7 +2881,7 @@ page_zip_decompress_node_ptrs(
 			(uInt) rec_offs_data_size(offsets)
 			- REC_NODE_PTR_SIZE;
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 			goto zlib_done;
 		case Z_OK:
@@ -2335,12 +2920,12 @@ page_zip_decompress_node_ptrs(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_node_ptrs:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2348,7 +2933,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2424,7 +3009,7 @@ ibool
 page_zip_decompress_sec(
 /*====================*/
 	page_zip_des_t*	page_zip,	/*!< in/out: compressed page */
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed page stream */
 	rec_t**		recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -2449,7 +3034,7 @@ page_zip_decompress_sec(
 			- d_stream->next_out);
 
 		if (UNIV_LIKELY(d_stream->avail_out)) {
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 				page_zip_decompress_heap_no(
 					d_stream, rec, heap_status);
@@ -2489,12 +3074,12 @@ page_zip_decompress_sec(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_sec:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2502,7 +3087,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2561,7 +3146,7 @@ static
 ibool
 page_zip_decompress_clust_ext(
 /*==========================*/
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed page stream */
 	rec_t*		rec,		/*!< in/out: record */
 	const ulint*	offsets,	/*!< in: rec_get_offsets(rec) */
 	ulint		trx_id_col)	/*!< in: position of of DB_TRX_ID */
@@ -2595,7 +3180,7 @@ page_zip_decompress_clust_ext(
 			d_stream->avail_out =
 				(uInt) (dst - d_stream->next_out);
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2626,7 +3211,7 @@ page_zip_decompress_clust_ext(
 
 			d_stream->avail_out =
 				(uInt) (dst - d_stream->next_out);
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2672,7 +3257,7 @@ ibool
 page_zip_decompress_clust(
 /*======================*/
 	page_zip_des_t*	page_zip,	/*!< in/out: compressed page */
-	z_stream*	d_stream,	/*!< in/out: compressed page stream */
+	page_zip_stream_t*	d_stream,	/*!< in/out: compressed page stream */
 	rec_t**		recs,		/*!< in: dense page directory
 					sorted by address */
 	ulint		n_dense,	/*!< in: size of recs[] */
@@ -2706,7 +3291,7 @@ page_zip_decompress_clust(
 
 		ut_ad(d_stream->avail_out < UNIV_PAGE_SIZE
 		      - PAGE_ZIP_START - PAGE_DIR);
-		err = inflate(d_stream, Z_SYNC_FLUSH);
+		err = page_zip_inflate(d_stream, Z_SYNC_FLUSH);
 		switch (err) {
 		case Z_STREAM_END:
 			page_zip_decompress_heap_no(
@@ -2763,7 +3348,7 @@ page_zip_decompress_clust(
 			d_stream->avail_out =
 				(uInt) (dst - d_stream->next_out);
 
-			switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+			switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 			case Z_STREAM_END:
 			case Z_OK:
 			case Z_BUF_ERROR:
@@ -2794,7 +3379,7 @@ page_zip_decompress_clust(
 			(uInt) (rec_get_end(rec, offsets)
 			- d_stream->next_out);
 
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
+		switch (page_zip_inflate(d_stream, Z_SYNC_FLUSH)) {
 		case Z_STREAM_END:
 		case Z_OK:
 		case Z_BUF_ERROR:
@@ -2824,12 +3409,12 @@ page_zip_decompress_clust(
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(d_stream, Z_FINISH) != Z_STREAM_END)) {
 		page_zip_fail(("page_zip_decompress_clust:"
 			       " inflate(Z_FINISH)=%s\n",
 			       d_stream->msg));
 zlib_error:
-		inflateEnd(d_stream);
+		page_zip_inflate_end(d_stream);
 		return(FALSE);
 	}
 
@@ -2837,7 +3422,7 @@ zlib_error:
 	if the modification log is nonempty. */
 
 zlib_done:
-	if (UNIV_UNLIKELY(inflateEnd(d_stream) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate_end(d_stream) != Z_OK)) {
 		ut_error;
 	}
 
@@ -2981,7 +3566,7 @@ page_zip_decompress_low(
 				page header fields that should not change
 				after page creation */
 {
-	z_stream	d_stream;
+	page_zip_stream_t	d_stream;
 	dict_index_t*	index	= NULL;
 	rec_t**		recs;	/*!< dense page directory, sorted by address */
 	ulint		n_dense;/* number of user records on the page */
@@ -3071,20 +3656,22 @@ zlib_error:
 	d_stream.next_out = page + PAGE_ZIP_START;
 	d_stream.avail_out = UNIV_PAGE_SIZE - PAGE_ZIP_START;
 
-	if (UNIV_UNLIKELY(inflateInit2(&d_stream, UNIV_PAGE_SIZE_SHIFT)
-			  != Z_OK)) {
-		ut_error;
+	if (UNIV_UNLIKELY(page_zip_inflate_init(&d_stream) != Z_OK)) {
+
+		page_zip_fail(("page_zip_decompress:"
+			       " inflateInit2=%s\n", d_stream.msg));
+		goto zlib_error;
 	}
 
 	/* Decode the zlib header and the index information. */
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
 			       " 1 inflate(Z_BLOCK)=%s\n", d_stream.msg));
 		goto zlib_error;
 	}
 
-	if (UNIV_UNLIKELY(inflate(&d_stream, Z_BLOCK) != Z_OK)) {
+	if (UNIV_UNLIKELY(page_zip_inflate(&d_stream, Z_BLOCK) != Z_OK)) {
 
 		page_zip_fail(("page_zip_decompress:"
 			       " 2 inflate(Z_BLOCK)=%s\n", d_stream.msg));
@@ -328,6 +328,7 @@ ReadView::ReadView()
 	m_up_limit_id(),
 	m_creator_trx_id(),
 	m_ids(),
+	m_version(),
 	m_low_limit_no()
 {
 	ut_d(::memset(&m_view_list, 0x0, sizeof(m_view_list)));
@@ -447,6 +448,8 @@ ReadView::prepare(trx_id_t id)
 
 	m_low_limit_no = m_low_limit_id = trx_sys->max_trx_id;
 
+	m_version = trx_sys->rw_trx_ids_version;
+
 	if (!trx_sys->rw_trx_ids.empty()) {
 		copy_trx_ids(trx_sys->rw_trx_ids);
 	} else {
@@ -545,8 +548,9 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 {
 	ut_ad(!srv_read_only_mode);
 
-	/** If no new RW transaction has been started since the last view
-	was created then reuse the the existing view. */
+	/** If no RW transaction has been started, committed or rolled
+	back since the last view was created then reuse the existing
+	view. */
 	if (view != NULL) {
 
 		uintptr_t	p = reinterpret_cast<uintptr_t>(view);
@@ -555,24 +559,34 @@ MVCC::view_open(ReadView*& view, trx_t* trx)
 
 		ut_ad(view->m_closed);
 
-		/* NOTE: This can be optimised further, for now we only
-		resuse the view iff there are no active RW transactions.
+		/* Starting a RW transaction and assigning a serialisation
+		number both advance trx_sys->max_trx_id, and removing a
+		transaction from trx_sys->rw_trx_ids advances its version.
+		If neither has moved, the snapshot is still current,
+		whatever the number of active RW transactions.
 
 		There is an inherent race here between purge and this
 		thread. Purge will skip views that are marked as closed.
-		Therefore we must set the low limit id after we reset the
-		closed status after the check. */
+		Therefore we must check the limits only after the reset
+		of the closed status is visible to other threads. */
 
-		if (trx_is_autocommit_non_locking(trx) && view->empty()) {
+#ifdef HAVE_ATOMIC_BUILTINS
+		if (trx_is_autocommit_non_locking(trx)) {
 
 			view->m_closed = false;
 
-			if (view->m_low_limit_id == trx_sys_get_max_trx_id()) {
+			os_mb();
+
+			if (view->m_low_limit_id == trx_sys_get_max_trx_id()
+			    && view->m_version
+			    == trx_sys->rw_trx_ids_version) {
+
 				return;
 			} else {
 				view->m_closed = true;
 			}
 		}
+#endif /* HAVE_ATOMIC_BUILTINS */
 
 		mutex_enter(&trx_sys->mutex);
 
@@ -646,6 +660,8 @@ ReadView::copy_prepare(const ReadView& other)
 
 	m_low_limit_id = other.m_low_limit_id;
 
+	m_version = other.m_version;
+
 	m_creator_trx_id = other.m_creator_trx_id;
 }
 
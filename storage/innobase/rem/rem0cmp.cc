@@ -418,6 +418,73 @@ cmp_data_data(
 	return(cmp_data(mtype, prtype, data1, len1, data2, len2));
 }
 
+/** Determine whether the fields of a data type can be ordered by their
+normalized prefixes, that is, whether cmp_data_data() compares the weights
+of the bytes one by one.
+@param[out] norm normalization of the data type
+@param[in] mtype main type
+@param[in] prtype precise type
+@return whether the data type can be normalized */
+
+bool
+cmp_norm_init(
+	cmp_norm_t*	norm,
+	ulint		mtype,
+	ulint		prtype)
+{
+	const CHARSET_INFO*	cs;
+
+	norm->map = NULL;
+
+	switch (mtype) {
+	case DATA_FIXBINARY:
+	case DATA_BINARY:
+		if (dtype_get_charset_coll(prtype)
+		    != DATA_MYSQL_BINARY_CHARSET_COLL) {
+			norm->pad = 0x20;
+			return(true);
+		}
+		/* fall through */
+	case DATA_INT:
+	case DATA_SYS_CHILD:
+	case DATA_SYS:
+		/* A shorter field that is a prefix of a longer one
+		is smaller; padding with the smallest weight keeps
+		the order. */
+		norm->pad = 0;
+		return(true);
+	case DATA_VARCHAR:
+	case DATA_CHAR:
+		cs = &my_charset_latin1;
+		break;
+	case DATA_VARMYSQL:
+	case DATA_MYSQL:
+		cs = get_charset((uint) dtype_get_charset_coll(prtype),
+				 MYF(0));
+		if (cs == NULL) {
+			return(false);
+		}
+		break;
+	default:
+		return(false);
+	}
+
+	/* The collations that compare the bytes one by one, padding the
+	shorter string with spaces. The other collations map multi-byte
+	characters or contractions to weights. */
+	if (cs->coll == &my_collation_8bit_simple_ci_handler) {
+		norm->map = cs->sort_order;
+		norm->pad = cs->sort_order[' '];
+		return(true);
+	} else if (cs->coll == &my_collation_8bit_bin_handler
+		   || cs->coll == &my_collation_mb_bin_handler) {
+		norm->pad = ' ';
+		return(true);
+	}
+
+	return(false);
+}
+
 /** Compare a data tuple to a physical record.
 @param[in] dtuple data tuple
 @param[in] rec B-tree record
@@ -596,7 +596,69 @@ rec_get_offsets_func(
 	}
 
 	rec_offs_set_n_fields(offsets, n);
-	rec_init_offsets(rec, index, offsets);
+
+	if (index->fixed_offsets != NULL
+	    && rec_get_status(rec) == REC_STATUS_ORDINARY) {
+		/* All the ordinary records of the index have
+		these offsets. */
+		memcpy(rec_offs_base(offsets),
+		       rec_offs_base(index->fixed_offsets),
+		       (n + 1) * sizeof *offsets);
+
+		rec_offs_make_valid(rec, index, offsets);
+	} else {
+		rec_init_offsets(rec, index, offsets);
+	}
+
+	return(offsets);
+}
+
+/******************************************************//**
+Build the offsets that every ordinary record of an index has when the
+records of the index have a fixed layout: ROW_FORMAT=COMPACT or later,
+and only NOT NULL fixed-length fields. rec_get_offsets() then copies
+them instead of parsing the record header.
+@return offsets for all the fields, allocated from index->heap, or NULL
+if the layout of the records is not fixed */
+
+const ulint*
+rec_get_fixed_offsets(
+/*==================*/
+	const dict_index_t*	index)	/*!< in: index */
+{
+	ulint	n = dict_index_get_n_fields(index);
+	ulint	size = n + (1 + REC_OFFS_HEADER_SIZE);
+	ulint	offs = 0;
+	ulint*	offsets;
+
+	if (!dict_table_is_comp(index->table)
+	    || index->n_nullable > 0
+	    || dict_index_is_ibuf(index)) {
+
+		return(NULL);
+	}
+
+	for (ulint i = 0; i < n; i++) {
+		if (!dict_index_get_nth_field(index, i)->fixed_len) {
+			return(NULL);
+		}
+	}
+
+	offsets = static_cast<ulint*>(
+		mem_heap_zalloc(index->heap, size * sizeof *offsets));
+
+	rec_offs_set_n_alloc(offsets, size);
+	rec_offs_set_n_fields(offsets, n);
+
+	/* There are no null flags and no lengths in the header, and
+	no field can be stored externally. */
+	rec_offs_base(offsets)[0] = REC_N_NEW_EXTRA_BYTES | REC_OFFS_COMPACT;
+
+	for (ulint i = 0; i < n; i++) {
+		offs += dict_index_get_nth_field(index, i)->fixed_len;
+		rec_offs_base(offsets)[i + 1] = offs;
+	}
+
 	return(offsets);
 }
 
@@ -832,7 +832,7 @@ exit:
 
 		row_merge_sort(psort_info->psort_common->trx,
 			       psort_info->psort_common->dup,
-			       merge_file[i], block[i], &tmpfd[i]);
+			       merge_file[i], block[i], &tmpfd[i], NULL);
 		total_rec += merge_file[i]->n_rec;
 		close(tmpfd[i]);
 	}
@@ -41,6 +41,7 @@ Created 2012-02-08 by Sunny Bains.
 #include "row0mysql.h"
 #include "srv0start.h"
 #include "row0quiesce.h"
+#include "read0read.h"
 
 #include <vector>
 
@@ -118,7 +119,10 @@ struct row_import {
 		m_col_names(),
 		m_n_indexes(),
 		m_indexes(),
-		m_missing(true) { }
+		m_missing(true),
+		m_export_space(ULINT_UNDEFINED),
+		m_export_lsn(),
+		m_export_max_trx_id() { }
 
 	~row_import() UNIV_NOTHROW;
 
@@ -220,6 +224,18 @@ struct row_import {
 
 	bool		m_missing;		/*!< true if a .cfg file was
 						found and was readable */
+
+	ulint		m_export_space;		/*!< Space id of the exported
+						tablespace, or ULINT_UNDEFINED
+						if the .cfg file is older than
+						IB_EXPORT_CFG_VERSION_V2 */
+
+	lsn_t		m_export_lsn;		/*!< No page in the exported
+						tablespace is newer */
+
+	trx_id_t	m_export_max_trx_id;	/*!< All the transactions that
+						modified the exported table
+						have a smaller id */
 };
 
 /** Use the page cursor to iterate over records in a block. */
@@ -2135,6 +2151,252 @@ PageConverter::operator() (
 	return(err);
 }
 
+/* Functor that is called for a sample of the pages of a tablespace that was
+exported with FLUSH TABLES ... FOR EXPORT from a table with the same space id
+and index ids. The pages can then be used as they are, only the tablespace
+header page is updated.
+
+  1. Check every FSP_EXTENT_SIZE-th page for corruption. This includes
+     all the extent descriptor pages.
+
+  2. Check that the space id, the LSN and, on B-tree pages, the index
+     id and the max trx id agree with the .cfg file. If not, return
+     DB_FAIL so that the caller converts all the pages.
+
+  3. Update the LSN in the tablespace header page. */
+class PageValidator : public AbstractCallback {
+public:
+	/** Constructor
+	@param cfg config of table being imported.
+	@param trx transaction covering the import */
+	PageValidator(row_import* cfg, trx_t* trx) UNIV_NOTHROW
+		:
+		AbstractCallback(trx),
+		m_cfg(cfg),
+		m_current_lsn(log_get_lsn()),
+		m_n_checked() { }
+
+	virtual ~PageValidator() UNIV_NOTHROW { }
+
+	/**
+	@retval the server space id of the tablespace being iterated over */
+	virtual ulint get_space_id() const UNIV_NOTHROW
+	{
+		return(m_cfg->m_table->space);
+	}
+
+	/**
+	@return the first page of every extent is checked */
+	virtual ulint get_page_stride() const UNIV_NOTHROW
+	{
+		return(FSP_EXTENT_SIZE);
+	}
+
+	/** Called for each sampled block as it is read from the file.
+	@param offset physical offset in the file
+	@param block block to check, it is not from the buffer pool.
+	@retval DB_SUCCESS, DB_FAIL if the page doesn't match the .cfg file
+	or error code */
+	virtual dberr_t operator() (
+		os_offset_t	offset,
+		buf_block_t*	block) UNIV_NOTHROW;
+
+	/**
+	@return number of pages that were checked */
+	ulint get_n_checked() const UNIV_NOTHROW
+	{
+		return(m_n_checked);
+	}
+
+private:
+	/** Check a B-tree page against the .cfg file.
+	@param block block read from file
+	@retval DB_SUCCESS or DB_FAIL */
+	dberr_t check_index_page(const buf_block_t* block) UNIV_NOTHROW;
+
+	/** Validate the space flags and update tablespace header page.
+	@param block block read from file, not from the buffer pool.
+	@retval DB_SUCCESS or error code */
+	dberr_t update_header(buf_block_t* block) UNIV_NOTHROW;
+
+	/** Tell fil_iterate() that the page need not be written back.
+	@param block block read from file */
+	void set_unchanged(buf_block_t* block) UNIV_NOTHROW
+	{
+		buf_block_set_state(block, BUF_BLOCK_NOT_USED);
+		buf_block_set_state(block, BUF_BLOCK_READY_FOR_USE);
+	}
+
+private:
+	/** Config for table that is being imported. */
+	row_import*		m_cfg;
+
+	/** Current system LSN */
+	lsn_t			m_current_lsn;
+
+	/** Number of pages checked */
+	ulint			m_n_checked;
+};
+
+/** Check a B-tree page against the .cfg file.
+@param block block read from file
+@retval DB_SUCCESS or DB_FAIL */
+dberr_t
+PageValidator::check_index_page(
+	const buf_block_t*	block) UNIV_NOTHROW
+{
+	const page_t*	page = get_frame(const_cast<buf_block_t*>(block));
+	index_id_t	id = btr_page_get_index_id(page);
+
+	/* Free pages can belong to dropped indexes. */
+	if (is_free(buf_block_get_page_no(block))) {
+		return(DB_SUCCESS);
+	}
+
+	for (ulint i = 0; i < m_cfg->m_n_indexes; ++i) {
+		const row_index_t*	cfg_index = &m_cfg->m_indexes[i];
+
+		if (cfg_index->m_id != id) {
+			continue;
+		}
+
+		ut_ad(cfg_index->m_srv_index->id == id);
+
+		/* The uncompressed page header is also present at the
+		start of a compressed page. */
+
+		if (page_get_max_trx_id(page)
+		    > m_cfg->m_export_max_trx_id) {
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Page %lu has max trx id " TRX_ID_FMT
+				" that is newer than the export",
+				(ulong) buf_block_get_page_no(block),
+				page_get_max_trx_id(page));
+
+			return(DB_FAIL);
+		}
+
+		return(DB_SUCCESS);
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Page %lu belongs to index " IB_ID_FMT " that is not in "
+		"the meta-data file",
+		(ulong) buf_block_get_page_no(block), id);
+
+	return(DB_FAIL);
+}
+
+/** Validate the space flags and update tablespace header page.
+@param block block read from file, not from the buffer pool.
+@retval DB_SUCCESS or error code */
+dberr_t
+PageValidator::update_header(
+	buf_block_t*	block) UNIV_NOTHROW
+{
+	ulint		space_flags = fsp_header_get_flags(get_frame(block));
+
+	if (!fsp_flags_is_valid(space_flags)) {
+
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Unsupported tablespace format %lu",
+			(ulong) space_flags);
+
+		return(DB_UNSUPPORTED);
+	}
+
+	mach_write_to_8(
+		get_frame(block) + FIL_PAGE_FILE_FLUSH_LSN, m_current_lsn);
+
+	if (!is_compressed_table()) {
+		buf_flush_init_for_writing(block->frame, 0, m_current_lsn);
+	} else {
+		buf_flush_update_zip_checksum(
+			get_frame(block), get_zip_size(), m_current_lsn);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/** Called for each sampled page of the tablespace. Only the tablespace
+header page is written back.
+@param offset physical offset within the file
+@param block block read from file, note it is not from the buffer pool
+@retval DB_SUCCESS, DB_FAIL if the page doesn't match the .cfg file
+or error code. */
+dberr_t
+PageValidator::operator() (
+	os_offset_t	offset,
+	buf_block_t*	block) UNIV_NOTHROW
+{
+	dberr_t		err;
+
+	if ((err = periodic_check()) != DB_SUCCESS) {
+		return(err);
+	}
+
+	const page_t*	page = get_frame(block);
+	ulint		page_no = page_get_page_no(page);
+
+	++m_n_checked;
+
+	if (buf_page_is_corrupted(false, page, get_zip_size())
+	    || (page_no != offset / m_page_size && page_no != 0)) {
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"%s: Page %lu at offset " UINT64PF " looks corrupted.",
+			m_filepath, (ulong) (offset / m_page_size), offset);
+
+		return(DB_CORRUPTION);
+
+	} else if (offset > 0 && page_no == 0) {
+
+		/* A page that was allocated but not yet initialised. */
+		set_unchanged(block);
+
+		return(DB_SUCCESS);
+
+	} else if (mach_read_from_4(page + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID)
+		   != get_space_id()
+		   || mach_read_from_8(page + FIL_PAGE_LSN)
+		   > m_cfg->m_export_lsn) {
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Page %lu was not written by the export",
+			(ulong) page_no);
+
+		return(DB_FAIL);
+	}
+
+	switch (fil_page_get_type(page)) {
+	case FIL_PAGE_TYPE_FSP_HDR:
+		ut_a(page_no == 0);
+
+		if (m_space != get_space_id()) {
+			return(DB_FAIL);
+		}
+
+		return(update_header(block));
+
+	case FIL_PAGE_TYPE_XDES:
+		err = set_current_xdes(page_no, page);
+		break;
+
+	case FIL_PAGE_INDEX:
+		err = check_index_page(block);
+		break;
+
+	case FIL_PAGE_TYPE_SYS:
+		/* This is page 0 in the system tablespace. */
+		return(DB_CORRUPTION);
+	}
+
+	set_unchanged(block);
+
+	return(err);
+}
+
 /*****************************************************************//**
 Clean up after import tablespace failure, this function will acquire
 the dictionary latches on behalf of the transaction if the transaction
@@ -3085,6 +3347,45 @@ row_import_read_v1(
 	return(err);
 }
 
+/*****************************************************************//**
+Read the state of the tablespace at the time of the export, written by
+IB_EXPORT_CFG_VERSION_V2 and later.
+@return DB_SUCCESS or error code. */
+static	__attribute__((nonnull, warn_unused_result))
+dberr_t
+row_import_read_export_state(
+/*=========================*/
+	FILE*		file,		/*!< in: File to read from */
+	THD*		thd,		/*!< in: session */
+	row_import*	cfg)		/*!< out: meta data */
+{
+	byte		row[sizeof(ib_uint32_t) + 2 * sizeof(ib_uint64_t)];
+	const byte*	ptr = row;
+
+	/* Trigger EOF */
+	DBUG_EXECUTE_IF("ib_import_io_read_error_10",
+			(void) fseek(file, 0L, SEEK_END););
+
+	if (fread(row, 1, sizeof(row), file) != sizeof(row)) {
+		ib_senderrf(
+			thd, IB_LOG_LEVEL_ERROR, ER_IO_READ_ERROR,
+			errno, strerror(errno),
+			"while reading tablespace export state.");
+
+		return(DB_IO_ERROR);
+	}
+
+	cfg->m_export_space = mach_read_from_4(ptr);
+	ptr += sizeof(ib_uint32_t);
+
+	cfg->m_export_lsn = mach_read_from_8(ptr);
+	ptr += sizeof(ib_uint64_t);
+
+	cfg->m_export_max_trx_id = mach_read_from_8(ptr);
+
+	return(DB_SUCCESS);
+}
+
 /**
 Read the contents of the <tablespace>.cfg file.
 @return DB_SUCCESS or error code. */
@@ -3119,6 +3420,17 @@ row_import_read_meta_data(
 	case IB_EXPORT_CFG_VERSION_V1:
 
 		return(row_import_read_v1(file, thd, &cfg));
+
+	case IB_EXPORT_CFG_VERSION_V2: {
+
+		dberr_t	err = row_import_read_v1(file, thd, &cfg);
+
+		if (err == DB_SUCCESS) {
+			err = row_import_read_export_state(file, thd, &cfg);
+		}
+
+		return(err);
+	}
 	default:
 		ib_errf(thd, IB_LOG_LEVEL_ERROR, ER_IO_READ_ERROR,
 			"Unsupported meta-data version number (%lu), "
@@ -3405,6 +3717,67 @@ row_import_update_discarded_flag(
 	return(err);
 }
 
+/*****************************************************************//**
+Check if the pages of the tablespace can be imported without rewriting
+them. This requires a .cfg file written by FLUSH TABLES ... FOR EXPORT from
+a table with the same space id and index ids, whose LSNs and transaction ids
+are all in the past of this server, so that no read view can see the
+records as uncommitted.
+@return true if only the tablespace header page needs to be updated */
+static	__attribute__((nonnull, warn_unused_result))
+bool
+row_import_can_skip_conversion(
+/*===========================*/
+	const row_import&	cfg)	/*!< in: contents of the .cfg file,
+					matched with the table */
+{
+	const dict_table_t*	table = cfg.m_table;
+
+	DBUG_EXECUTE_IF("ib_import_disable_fast_path", return(false););
+
+	/* The corrupt BLOB reference is only found by PageConverter. */
+	DBUG_EXECUTE_IF("ib_import_trigger_corruption_2", return(false););
+
+	if (cfg.m_missing
+	    || cfg.m_version < IB_EXPORT_CFG_VERSION_V2
+	    || cfg.m_export_space != table->space
+	    || cfg.m_n_indexes != UT_LIST_GET_LEN(table->indexes)) {
+
+		return(false);
+	}
+
+	for (const dict_index_t* index = dict_table_get_first_index(table);
+	     index != 0;
+	     index = dict_table_get_next_index(index)) {
+
+		const row_index_t*	cfg_index = cfg.get_index(index->name);
+
+		if (cfg_index == 0
+		    || cfg_index->m_id != index->id
+		    || cfg_index->m_srv_index != index) {
+
+			return(false);
+		}
+	}
+
+	/* Redo log records written after the import must be newer than
+	the pages. */
+
+	if (cfg.m_export_lsn >= log_get_lsn()) {
+		return(false);
+	}
+
+	/* The DB_TRX_ID and DB_ROLL_PTR of the records are not reset. No
+	current or future read view may consider them active, otherwise
+	it would follow a DB_ROLL_PTR into undo logs of another server. */
+
+	ReadView	view;
+
+	trx_sys->mvcc->clone_oldest_view(&view);
+
+	return(view.sees(cfg.m_export_max_trx_id));
+}
+
 /*****************************************************************//**
 Imports a tablespace. The space id in the .ibd file must match the space id
 of the table in the data dictionary.
@@ -3549,17 +3922,46 @@ row_import_for_mysql(
 
 	prebuilt->trx->op_info = "importing tablespace";
 
-	ib_logf(IB_LOG_LEVEL_INFO, "Phase I - Update all pages");
+	if (row_import_can_skip_conversion(cfg)) {
 
-	/* Iterate over all the pages and do the sanity checking and
-	the conversion required to import the tablespace. */
+		ib_logf(IB_LOG_LEVEL_INFO, "Phase I - Validate sampled pages");
 
-	PageConverter	converter(&cfg, trx);
+		/* The tablespace was exported from a table with the same
+		ids. Only check a sample of the pages and update the
+		tablespace header page. */
 
-	/* Set the IO buffer size in pages. */
+		PageValidator	validator(&cfg, trx);
 
-	err = fil_tablespace_iterate(
-		table, IO_BUFFER_SIZE(cfg.m_page_size), converter);
+		err = fil_tablespace_iterate(table, 1, validator);
+
+		if (err == DB_SUCCESS) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Validated %lu pages, skipping the update "
+				"of all pages",
+				(ulong) validator.get_n_checked());
+		} else if (err == DB_FAIL) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"The tablespace pages do not match the "
+				"meta-data file");
+		}
+	} else {
+		err = DB_FAIL;
+	}
+
+	if (err == DB_FAIL) {
+
+		ib_logf(IB_LOG_LEVEL_INFO, "Phase I - Update all pages");
+
+		/* Iterate over all the pages and do the sanity checking and
+		the conversion required to import the tablespace. */
+
+		PageConverter	converter(&cfg, trx);
+
+		/* Set the IO buffer size in pages. */
+
+		err = fil_tablespace_iterate(
+			table, IO_BUFFER_SIZE(cfg.m_page_size), converter);
+	}
 
 	DBUG_EXECUTE_IF("ib_import_reset_space_and_lsn_failure",
 			err = DB_TOO_MANY_CONCURRENT_TRXS;);
@@ -1859,9 +1859,11 @@ row_ins_dupl_error_with_rec(
 	}
 
 	/* In a unique secondary index we allow equal key values if they
-	contain SQL NULLs */
+	contain SQL NULLs, except in intrinsic tables, where the optimizer
+	relies on NULL == NULL for DISTINCT and GROUP BY */
 
-	if (!dict_index_is_clust(index)) {
+	if (!dict_index_is_clust(index)
+	    && !dict_table_is_intrinsic(index->table)) {
 
 		for (i = 0; i < n_unique; i++) {
 			if (dfield_is_null(dtuple_get_nth_field(entry, i))) {
@@ -1908,9 +1910,12 @@ row_ins_scan_sec_index_for_duplicate(
 
 	/* If the secondary index is unique, but one of the fields in the
 	n_unique first fields is NULL, a unique key violation cannot occur,
-	since we define NULL != NULL in this case */
+	since we define NULL != NULL in this case. Intrinsic tables define
+	NULL == NULL. */
 
-	for (ulint i = 0; i < n_unique; i++) {
+	for (ulint i = 0;
+	     i < n_unique && !dict_table_is_intrinsic(index->table);
+	     i++) {
 		if (UNIV_SQL_NULL == dfield_get_len(
 			    dtuple_get_nth_field(entry, i))) {
 
@@ -1935,8 +1935,12 @@ row_log_table_apply_op(
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
 	const mrec_t*		mrec,		/*!< in: merge record */
 	const mrec_t*		mrec_end,	/*!< in: end of buffer */
-	ulint*			offsets)	/*!< in/out: work area
+	ulint*			offsets,	/*!< in/out: work area
 						for parsing mrec */
+	ulonglong*		total)		/*!< in/out: log position,
+						advanced past the record;
+						&log->head.total unless the
+						record is applied in parallel */
 {
 	row_log_t*	log	= dup->index->online_log;
 	dict_index_t*	new_index = dict_table_get_first_index(log->table);
@@ -1988,7 +1992,7 @@ row_log_table_apply_op(
 		if (next_mrec > mrec_end) {
 			return(NULL);
 		} else {
-			log->head.total += next_mrec - mrec_start;
+			*total += next_mrec - mrec_start;
 
 			ulint		len;
 			const byte*	db_trx_id
@@ -2023,7 +2027,7 @@ row_log_table_apply_op(
 			return(NULL);
 		}
 
-		log->head.total += next_mrec - mrec_start;
+		*total += next_mrec - mrec_start;
 
 		/* If there are external fields, retrieve those logged
 		prefix info and reconstruct the row_ext_t */
@@ -2181,7 +2185,7 @@ row_log_table_apply_op(
 		}
 
 		ut_ad(next_mrec <= mrec_end);
-		log->head.total += next_mrec - mrec_start;
+		*total += next_mrec - mrec_start;
 		dtuple_set_n_fields_cmp(old_pk, new_index->n_uniq);
 
 		{
@@ -2205,6 +2209,479 @@ row_log_table_apply_op(
 	return(next_mrec);
 }
 
+/** Applies complete records of the modification log on several threads.
+The records are partitioned by a hash of their key, and the records of
+each partition are applied in log order by one thread, so that all
+operations on one key are replayed in the order they were logged. */
+class RowLogApplier {
+public:
+	/** Work area of one applying thread */
+	struct Slot {
+		/** Copy of the duplicate key reporting context */
+		row_merge_dup_t	m_dup;
+
+		/** Memory heap for data tuples */
+		mem_heap_t*	m_heap;
+
+		/** Memory heap for offsets; can be emptied */
+		mem_heap_t*	m_offsets_heap;
+
+		/** Work area for parsing the records */
+		ulint*		m_offsets;
+
+		/** Log position, for row_log_table_apply_op() */
+		ulonglong	m_total;
+
+		/** Records of the partition, as [start, end) pairs */
+		std::vector<std::pair<const mrec_t*, const mrec_t*> >
+				m_recs;
+
+		/** Error from applying the partition */
+		dberr_t		m_err;
+
+		/** Signalled when the applying thread has finished */
+		os_event_t	m_done;
+
+		/** The applier */
+		RowLogApplier*	m_applier;
+
+		/** Number of the thread */
+		ulint		m_thread_no;
+	};
+
+	/**
+	Callback that applies one complete log record.
+	@param slot		work area of the applying thread
+	@param mrec		start of the record
+	@param mrec_end		end of the record
+	@param arg		argument passed to run()
+	@return DB_SUCCESS or error code */
+	typedef dberr_t (*apply_t)(
+		Slot&		slot,
+		const mrec_t*	mrec,
+		const mrec_t*	mrec_end,
+		void*		arg);
+
+	/**
+	Constructor
+	@param trx		transaction, for checking for interrupts
+	@param dup		duplicate key reporting context
+	@param n_threads	number of applying threads
+	@param n_offsets	size of the offsets work area
+	@param n_fields		initial offsets[1] */
+	RowLogApplier(
+		trx_t*			trx,
+		const row_merge_dup_t&	dup,
+		ulint			n_threads,
+		ulint			n_offsets,
+		ulint			n_fields)
+		:
+		m_trx(trx),
+		m_slots(n_threads),
+		m_n_recs(0),
+		m_failed(false)
+	{
+		for (ulint i = 0; i < n_threads; ++i) {
+			Slot&	slot = m_slots[i];
+
+			slot.m_dup = dup;
+			slot.m_heap = mem_heap_create(UNIV_PAGE_SIZE);
+			slot.m_offsets_heap = mem_heap_create(UNIV_PAGE_SIZE);
+			slot.m_offsets = static_cast<ulint*>(
+				ut_malloc(n_offsets * sizeof *slot.m_offsets));
+			slot.m_offsets[0] = n_offsets;
+			slot.m_offsets[1] = n_fields;
+			slot.m_total = 0;
+			slot.m_err = DB_SUCCESS;
+			slot.m_done = NULL;
+			slot.m_applier = this;
+			slot.m_thread_no = i;
+		}
+	}
+
+	/**
+	Destructor */
+	~RowLogApplier()
+	{
+		for (ulint i = 0; i < m_slots.size(); ++i) {
+			mem_heap_free(m_slots[i].m_heap);
+			mem_heap_free(m_slots[i].m_offsets_heap);
+			ut_free(m_slots[i].m_offsets);
+		}
+	}
+
+	/**
+	Add a complete record to the partition of its key. The record
+	must stay in the buffer until run() has returned.
+	@param fold		hash value of the key of the record
+	@param mrec		start of the record
+	@param mrec_end		end of the record */
+	void add(ulint fold, const mrec_t* mrec, const mrec_t* mrec_end)
+	{
+		m_slots[fold % m_slots.size()].m_recs.push_back(
+			std::make_pair(mrec, mrec_end));
+		m_n_recs++;
+	}
+
+	/**
+	@return whether no records have been added since run() */
+	bool empty() const { return(m_n_recs == 0); }
+
+	/**
+	Apply the added records and forget about them. The calling
+	thread applies the first partition.
+	@param apply		callback for each record
+	@param arg		argument for the callback
+	@return DB_SUCCESS, DB_INTERRUPTED or the first error of
+	the callback */
+	dberr_t run(apply_t apply, void* arg);
+
+	/**
+	Body of the additional applying threads.
+	@param arg		the RowLogApplier::Slot to apply */
+	static void thread_main(void* arg);
+
+private:
+	/**
+	Apply the records of one partition.
+	@param slot		the partition */
+	void worker(Slot& slot);
+
+	// Prevent copying
+	RowLogApplier(const RowLogApplier&);
+	RowLogApplier& operator=(const RowLogApplier&);
+
+private:
+	/** Transaction, for checking for interrupts */
+	trx_t*			m_trx;
+
+	/** The partitions, one for each thread */
+	std::vector<Slot>	m_slots;
+
+	/** Number of records added since the last run() */
+	ulint			m_n_recs;
+
+	/** Set when any thread has failed, so that the others can
+	stop early; read without synchronisation */
+	volatile bool		m_failed;
+
+	/** Callback for the records */
+	apply_t			m_apply;
+
+	/** Argument of the callback */
+	void*			m_arg;
+};
+
+/*********************************************************************//**
+Apply the records of one partition. */
+
+void
+RowLogApplier::worker(
+/*==================*/
+	Slot&	slot)		/*!< in/out: partition */
+{
+	for (ulint i = 0; i < slot.m_recs.size(); ++i) {
+		if (m_failed) {
+			break;
+		}
+
+		if (trx_is_interrupted(m_trx)) {
+			slot.m_err = DB_INTERRUPTED;
+		} else {
+			/* Take the opportunity to do a redo log
+			checkpoint if needed. */
+			log_free_check();
+
+			slot.m_err = m_apply(slot, slot.m_recs[i].first,
+					     slot.m_recs[i].second, m_arg);
+		}
+
+		if (slot.m_err != DB_SUCCESS) {
+			m_failed = true;
+			break;
+		}
+	}
+}
+
+/*********************************************************************//**
+Body of the additional applying threads. */
+
+void
+RowLogApplier::thread_main(
+/*=======================*/
+	void*	arg)			/*!< in: the Slot to apply */
+{
+	Slot*	slot = static_cast<Slot*>(arg);
+
+	slot->m_applier->worker(*slot);
+
+	os_event_set(slot->m_done);
+}
+
+/*********************************************************************//**
+Thread that applies a partition of the records for RowLogApplier::run().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_log_apply_thread)(
+/*=================================*/
+	void*	arg)			/*!< in: RowLogApplier::Slot */
+{
+	RowLogApplier::thread_main(arg);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Apply the added records and forget about them.
+@return DB_SUCCESS or error code */
+
+dberr_t
+RowLogApplier::run(
+/*===============*/
+	apply_t	apply,			/*!< in: callback for each record */
+	void*	arg)			/*!< in: argument for the callback */
+{
+	dberr_t	err = DB_SUCCESS;
+
+	if (m_n_recs == 0) {
+		return(err);
+	}
+
+	m_apply = apply;
+	m_arg = arg;
+
+	for (ulint i = 1; i < m_slots.size(); ++i) {
+		if (!m_slots[i].m_recs.empty()) {
+			m_slots[i].m_done = os_event_create(NULL);
+			os_thread_create(row_log_apply_thread,
+					 &m_slots[i], NULL);
+		}
+	}
+
+	worker(m_slots[0]);
+
+	for (ulint i = 0; i < m_slots.size(); ++i) {
+		Slot&	slot = m_slots[i];
+
+		if (slot.m_done != NULL) {
+			os_event_wait(slot.m_done);
+			os_event_destroy(slot.m_done);
+			slot.m_done = NULL;
+		}
+
+		if (err == DB_SUCCESS) {
+			err = slot.m_err;
+		}
+
+		slot.m_recs.clear();
+		slot.m_err = DB_SUCCESS;
+	}
+
+	m_n_recs = 0;
+
+	return(err);
+}
+
+/******************************************************//**
+Determines if the leading fields of an index can partition the log
+records for the parallel apply, that is, if the fields compare equal
+only when their bytes are equal.
+@return true if the fields can be hashed byte by byte */
+static __attribute__((nonnull, warn_unused_result))
+bool
+row_log_key_is_binary(
+/*==================*/
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			n_fields)/*!< in: number of leading fields */
+{
+	for (ulint i = 0; i < n_fields; i++) {
+		const dict_col_t*	col = dict_index_get_nth_col(index, i);
+
+		switch (col->mtype) {
+		case DATA_FIXBINARY:
+		case DATA_BINARY:
+			if (dtype_get_charset_coll(col->prtype)
+			    != DATA_MYSQL_BINARY_CHARSET_COLL) {
+				return(false);
+			}
+			break;
+		case DATA_INT:
+		case DATA_SYS:
+			break;
+		default:
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/******************************************************//**
+Computes the hash value of the leading fields of a log record, for
+choosing the partition of the parallel apply.
+@return hash value */
+static __attribute__((nonnull, warn_unused_result))
+ulint
+row_log_key_fold(
+/*=============*/
+	const mrec_t*	mrec,		/*!< in: record */
+	const ulint*	offsets,	/*!< in: rec_init_offsets_temp() */
+	ulint		n_fields)	/*!< in: number of leading fields */
+{
+	ulint	fold = 0;
+
+	for (ulint i = 0; i < n_fields; i++) {
+		ulint		len;
+		const byte*	data = rec_get_nth_field(
+			mrec, offsets, i, &len);
+
+		if (len != UNIV_SQL_NULL) {
+			fold = ut_fold_ulint_pair(
+				fold, ut_fold_binary(data, len));
+		}
+	}
+
+	return(fold);
+}
+
+/******************************************************//**
+Parses an operation of a table-rebuilding log whose PRIMARY KEY
+definition did not change, for applying it in parallel.
+@return end of the record, or NULL if the record is incomplete,
+corrupted or must be applied by row_log_table_apply_op() in log order
+with respect to all other records */
+static __attribute__((nonnull, warn_unused_result))
+const mrec_t*
+row_log_table_parse_op(
+/*===================*/
+	const dict_index_t*	index,		/*!< in: clustered index
+						of the old table */
+	const dict_index_t*	new_index,	/*!< in: clustered index
+						of the new table */
+	const mrec_t*		mrec,		/*!< in: merge record */
+	const mrec_t*		mrec_end,	/*!< in: end of buffer */
+	ulint*			offsets,	/*!< in/out: work area
+						for parsing mrec */
+	ulint*			fold)		/*!< out: hash value of
+						the PRIMARY KEY */
+{
+	ulint		extra_size;
+	ulint		ext_size;
+	const mrec_t*	next_mrec;
+
+	ut_ad(index->online_log->same_pk);
+	ut_ad(new_index->n_uniq == index->n_uniq);
+
+	/* 3 = 1 (op type) + 1 (ext_size) + at least 1 byte payload */
+	if (mrec + 3 >= mrec_end) {
+		return(NULL);
+	}
+
+	switch (*mrec++) {
+	case ROW_T_INSERT:
+	case ROW_T_UPDATE:
+		/* With the same PRIMARY KEY, both carry the row in the
+		old table definition, starting with the PRIMARY KEY. */
+		extra_size = *mrec++;
+
+		if (extra_size >= 0x80) {
+			/* Read another byte of extra_size. */
+
+			extra_size = (extra_size & 0x7f) << 8;
+			extra_size |= *mrec++;
+		}
+
+		mrec += extra_size;
+
+		if (mrec > mrec_end) {
+			return(NULL);
+		}
+
+		rec_offs_set_n_fields(offsets, index->n_fields);
+		rec_init_offsets_temp(mrec, index, offsets);
+
+		next_mrec = mrec + rec_offs_data_size(offsets);
+
+		if (next_mrec > mrec_end || rec_offs_any_extern(offsets)) {
+			/* Fetching off-page columns depends on
+			row_log_t::head::total at this record. */
+			return(NULL);
+		}
+		break;
+
+	case ROW_T_DELETE:
+		/* 1 (extra_size) + 2 (ext_size) + at least 1 (payload) */
+		if (mrec + 4 >= mrec_end) {
+			return(NULL);
+		}
+
+		extra_size = *mrec++;
+		ext_size = mach_read_from_2(mrec);
+		mrec += 2 + extra_size;
+
+		rec_offs_set_n_fields(offsets, new_index->n_uniq + 1);
+		rec_init_offsets_temp(mrec, new_index, offsets);
+		next_mrec = mrec + rec_offs_data_size(offsets) + ext_size;
+
+		if (next_mrec > mrec_end) {
+			return(NULL);
+		}
+		break;
+
+	default:
+		return(NULL);
+	}
+
+	*fold = row_log_key_fold(mrec, offsets, new_index->n_uniq);
+	return(next_mrec);
+}
+
+/** Argument of row_log_table_apply_pll_op() */
+struct row_log_table_pll_t {
+	que_thr_t*	thr;		/*!< query graph */
+	ulint		trx_id_col;	/*!< position of DB_TRX_ID
+					in the old index */
+	ulint		new_trx_id_col;	/*!< position of DB_TRX_ID
+					in the new index */
+};
+
+/******************************************************//**
+Applies a complete operation of a table-rebuilding log in one of the
+RowLogApplier threads.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_log_table_apply_pll_op(
+/*=======================*/
+	RowLogApplier::Slot&	slot,		/*!< in/out: work area */
+	const mrec_t*		mrec,		/*!< in: merge record */
+	const mrec_t*		mrec_end,	/*!< in: end of mrec */
+	void*			arg)		/*!< in: row_log_table_pll_t */
+{
+	const row_log_table_pll_t*	pll
+		= static_cast<const row_log_table_pll_t*>(arg);
+	dberr_t				error;
+	const mrec_t*			next_mrec;
+
+	next_mrec = row_log_table_apply_op(
+		pll->thr, pll->trx_id_col, pll->new_trx_id_col,
+		&slot.m_dup, &error, slot.m_offsets_heap, slot.m_heap,
+		mrec, mrec_end, slot.m_offsets, &slot.m_total);
+
+	if (error == DB_SUCCESS && next_mrec != mrec_end) {
+		/* The record was parsed differently before. */
+		ut_ad(0);
+		error = DB_CORRUPTION;
+	}
+
+	return(error);
+}
+
 /******************************************************//**
 Applies operations to a table was rebuilt.
 @return DB_SUCCESS, or error code on failure */
@@ -2238,6 +2715,10 @@ row_log_table_apply_ops(
 	const ulint	new_trx_id_col	= dict_col_get_clust_pos(
 		dict_table_get_sys_col(new_table, DATA_TRX_ID), new_index);
 	trx_t*		trx		= thr_get_trx(thr);
+	RowLogApplier*	applier		= NULL;
+	row_log_table_pll_t	pll	= {
+		thr, trx_id_col, new_trx_id_col
+	};
 
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(dict_index_is_online_ddl(index));
@@ -2261,12 +2742,36 @@ row_log_table_apply_ops(
 	offsets_heap = mem_heap_create(UNIV_PAGE_SIZE);
 	has_index_lock = true;
 
+	/* The blocks that are not being written to can be applied on
+	several threads, partitioned by the PRIMARY KEY, when no operation
+	can affect another PRIMARY KEY value. That requires the PRIMARY
+	KEY to be unchanged and to be hashable byte by byte, and no
+	UNIQUE secondary index in the new table, because the duplicate
+	checks could observe the operations in a different order. */
+	if (srv_online_apply_threads > 1
+	    && index->online_log->same_pk
+	    && row_log_key_is_binary(new_index, new_index->n_uniq)) {
+		const dict_index_t*	sec_index = new_index;
+		bool			unique = false;
+
+		while ((sec_index = dict_table_get_next_index(sec_index))) {
+			unique = unique || dict_index_is_unique(sec_index);
+		}
+
+		if (!unique) {
+			applier = new RowLogApplier(
+				trx, *dup, srv_online_apply_threads,
+				i, dict_index_get_n_fields(index));
+		}
+	}
+
 next_block:
 	ut_ad(has_index_lock);
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(dict_index_get_lock(index), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(index->online_log->head.bytes == 0);
+	ut_ad(!applier || applier->empty());
 
 	if (trx_is_interrupted(trx)) {
 		goto interrupted;
@@ -2359,7 +2864,7 @@ all_done:
 		and be ignored when the operation is unsupported. */
 		fallocate(index->online_log->fd,
 			  FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
-			  ofs, srv_buf_size);
+			  ofs, srv_sort_buf_size);
 #endif /* FALLOC_FL_PUNCH_HOLE */
 
 		next_mrec = index->online_log->head.block;
@@ -2392,7 +2897,8 @@ all_done:
 			thr, trx_id_col, new_trx_id_col,
 			dup, &error, offsets_heap, heap,
 			index->online_log->head.buf,
-			(&index->online_log->head.buf)[1], offsets);
+			(&index->online_log->head.buf)[1], offsets,
+			&index->online_log->head.total);
 		if (error != DB_SUCCESS) {
 			goto func_exit;
 		} else if (UNIV_UNLIKELY(mrec == NULL)) {
@@ -2486,10 +2992,37 @@ all_done:
 			goto func_exit;
 		}
 
-		next_mrec = row_log_table_apply_op(
-			thr, trx_id_col, new_trx_id_col,
-			dup, &error, offsets_heap, heap,
-			mrec, mrec_end, offsets);
+		next_mrec = NULL;
+
+		if (applier && !has_index_lock) {
+			ulint	fold;
+
+			next_mrec = row_log_table_parse_op(
+				index, new_index, mrec, mrec_end,
+				offsets, &fold);
+
+			if (next_mrec) {
+				applier->add(fold, mrec, next_mrec);
+				index->online_log->head.total
+					+= next_mrec - mrec;
+			} else {
+				/* Apply the preceding records first. */
+				error = applier->run(
+					row_log_table_apply_pll_op, &pll);
+
+				if (error != DB_SUCCESS) {
+					goto func_exit;
+				}
+			}
+		}
+
+		if (!next_mrec) {
+			next_mrec = row_log_table_apply_op(
+				thr, trx_id_col, new_trx_id_col,
+				dup, &error, offsets_heap, heap,
+				mrec, mrec_end, offsets,
+				&index->online_log->head.total);
+		}
 
 		if (error != DB_SUCCESS) {
 			goto func_exit;
@@ -2504,6 +3037,16 @@ all_done:
 
 			mrec = NULL;
 process_next_block:
+			if (applier) {
+				/* The next block will be read over this one. */
+				error = applier->run(
+					row_log_table_apply_pll_op, &pll);
+
+				if (error != DB_SUCCESS) {
+					goto func_exit;
+				}
+			}
+
 			rw_lock_x_lock(dict_index_get_lock(index));
 			has_index_lock = true;
 
@@ -2538,6 +3081,7 @@ func_exit:
 		rw_lock_x_lock(dict_index_get_lock(index));
 	}
 
+	delete applier;
 	mem_heap_free(offsets_heap);
 	mem_heap_free(heap);
 	ut_free(offsets);
@@ -2704,6 +3248,56 @@ row_log_get_max_trx(
 	return(index->online_log->max_trx);
 }
 
+/******************************************************//**
+Delays a DML operation on a table while the apply of an online
+ALTER TABLE modification log on the table is lagging behind by more than
+srv_online_log_throttle blocks, so that the apply can catch up before
+the final phase that blocks the writes. */
+
+void
+row_log_throttle(
+/*=============*/
+	const dict_table_t*	table)	/*!< in: table to be modified */
+{
+	ulint	lag = 0;
+
+	if (!srv_online_log_throttle) {
+		return;
+	}
+
+	for (dict_index_t* index = dict_table_get_first_index(table);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		if (dict_index_get_online_status(index)
+		    != ONLINE_INDEX_CREATION) {
+			continue;
+		}
+
+		/* The index->lock protects index->online_log from
+		being freed. The block counts are read without
+		index->online_log->mutex, which is good enough for
+		deciding on a delay. */
+		rw_lock_s_lock(dict_index_get_lock(index));
+
+		if (const row_log_t* log = index->online_log) {
+			if (log->tail.blocks > log->head.blocks
+			    && log->tail.blocks - log->head.blocks > lag) {
+				lag = log->tail.blocks - log->head.blocks;
+			}
+		}
+
+		rw_lock_s_unlock(dict_index_get_lock(index));
+	}
+
+	if (lag > srv_online_log_throttle) {
+		/* Sleep 1 millisecond for each block beyond the
+		limit, but at most 100 milliseconds. */
+		os_thread_sleep(ut_min(lag - srv_online_log_throttle,
+				       ulint(100)) * 1000);
+	}
+}
+
 /******************************************************//**
 Applies an operation to a secondary index that was being created. */
 static __attribute__((nonnull))
@@ -3022,6 +3616,103 @@ corrupted:
 	return(mrec);
 }
 
+/******************************************************//**
+Parses an operation of a secondary index log, for applying it in
+parallel.
+@return end of the record, or NULL if the record is incomplete or
+corrupted */
+static __attribute__((nonnull, warn_unused_result))
+const mrec_t*
+row_log_parse_op(
+/*=============*/
+	const dict_index_t*	index,		/*!< in: index */
+	const mrec_t*		mrec,		/*!< in: merge record */
+	const mrec_t*		mrec_end,	/*!< in: end of buffer */
+	ulint*			offsets,	/*!< in/out: work area for
+						rec_init_offsets_temp() */
+	ulint*			fold)		/*!< out: hash value of
+						the index entry */
+{
+	ulint	extra_size;
+
+	if (mrec + ROW_LOG_HEADER_SIZE >= mrec_end) {
+		return(NULL);
+	}
+
+	switch (*mrec) {
+	case ROW_OP_INSERT:
+		if (ROW_LOG_HEADER_SIZE + DATA_TRX_ID_LEN + mrec >= mrec_end) {
+			return(NULL);
+		}
+
+		mrec += 1 + DATA_TRX_ID_LEN;
+		break;
+	case ROW_OP_DELETE:
+		mrec++;
+		break;
+	default:
+		return(NULL);
+	}
+
+	extra_size = *mrec++;
+
+	if (extra_size >= 0x80) {
+		/* Read another byte of extra_size. */
+
+		extra_size = (extra_size & 0x7f) << 8;
+		extra_size |= *mrec++;
+	}
+
+	mrec += extra_size;
+
+	if (mrec > mrec_end) {
+		return(NULL);
+	}
+
+	rec_init_offsets_temp(mrec, index, offsets);
+
+	if (rec_offs_any_extern(offsets)
+	    || mrec + rec_offs_data_size(offsets) > mrec_end) {
+		return(NULL);
+	}
+
+	*fold = row_log_key_fold(
+		mrec, offsets, dict_index_get_n_unique(index));
+	return(mrec + rec_offs_data_size(offsets));
+}
+
+/******************************************************//**
+Applies a complete operation of a secondary index log in one of the
+RowLogApplier threads.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_log_apply_pll_op(
+/*=================*/
+	RowLogApplier::Slot&	slot,		/*!< in/out: work area */
+	const mrec_t*		mrec,		/*!< in: merge record */
+	const mrec_t*		mrec_end,	/*!< in: end of mrec */
+	void*			arg)		/*!< in/out: index */
+{
+	dberr_t		error;
+	const mrec_t*	next_mrec;
+
+	next_mrec = row_log_apply_op(
+		static_cast<dict_index_t*>(arg), &slot.m_dup, &error,
+		slot.m_offsets_heap, slot.m_heap, false,
+		mrec, mrec_end, slot.m_offsets);
+
+	mem_heap_empty(slot.m_heap);
+
+	if (error == DB_SUCCESS && next_mrec != mrec_end) {
+		/* The record was parsed differently before. */
+		ut_ad(0);
+		error = DB_CORRUPTION;
+	}
+
+	return(error);
+}
+
 /******************************************************//**
 Applies operations to a secondary index that was being created.
 @return DB_SUCCESS, or error code on failure */
@@ -3046,6 +3737,7 @@ row_log_apply_ops(
 	bool		has_index_lock;
 	const ulint	i	= 1 + REC_OFFS_HEADER_SIZE
 		+ dict_index_get_n_fields(index);
+	RowLogApplier*	applier	= NULL;
 
 	ut_ad(dict_index_is_online_ddl(index));
 	ut_ad(*index->name == TEMP_INDEX_PREFIX);
@@ -3063,12 +3755,26 @@ row_log_apply_ops(
 	heap = mem_heap_create(UNIV_PAGE_SIZE);
 	has_index_lock = true;
 
+	/* The blocks that are not being written to can be applied on
+	several threads, partitioned by the whole index entry, which
+	must be hashable byte by byte. In a UNIQUE index, the duplicate
+	checks could observe the operations in a different order. */
+	if (srv_online_apply_threads > 1
+	    && !dict_index_is_unique(index)
+	    && row_log_key_is_binary(index,
+				     dict_index_get_n_unique(index))) {
+		applier = new RowLogApplier(
+			trx, *dup, srv_online_apply_threads,
+			i, dict_index_get_n_fields(index));
+	}
+
 next_block:
 	ut_ad(has_index_lock);
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(dict_index_get_lock(index), RW_LOCK_X));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(index->online_log->head.bytes == 0);
+	ut_ad(!applier || applier->empty());
 
 	if (trx_is_interrupted(trx)) {
 		goto interrupted;
@@ -3150,7 +3856,7 @@ all_done:
 		and be ignored when the operation is unsupported. */
 		fallocate(index->online_log->fd,
 			  FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
-			  ofs, srv_buf_size);
+			  ofs, srv_sort_buf_size);
 #endif /* FALLOC_FL_PUNCH_HOLE */
 
 		next_mrec = index->online_log->head.block;
@@ -3258,9 +3964,32 @@ all_done:
 			ut_ad(mrec >= index->online_log->tail.block);
 		}
 
-		next_mrec = row_log_apply_op(
-			index, dup, &error, offsets_heap, heap,
-			has_index_lock, mrec, mrec_end, offsets);
+		next_mrec = NULL;
+
+		if (applier && !has_index_lock) {
+			ulint	fold;
+
+			next_mrec = row_log_parse_op(
+				index, mrec, mrec_end, offsets, &fold);
+
+			if (next_mrec) {
+				applier->add(fold, mrec, next_mrec);
+			} else {
+				/* Apply the preceding records first. */
+				error = applier->run(
+					row_log_apply_pll_op, index);
+
+				if (error != DB_SUCCESS) {
+					goto func_exit;
+				}
+			}
+		}
+
+		if (!next_mrec) {
+			next_mrec = row_log_apply_op(
+				index, dup, &error, offsets_heap, heap,
+				has_index_lock, mrec, mrec_end, offsets);
+		}
 
 		if (error != DB_SUCCESS) {
 			goto func_exit;
@@ -3275,6 +4004,16 @@ all_done:
 
 			mrec = NULL;
 process_next_block:
+			if (applier) {
+				/* The next block will be read over this one. */
+				error = applier->run(
+					row_log_apply_pll_op, index);
+
+				if (error != DB_SUCCESS) {
+					goto func_exit;
+				}
+			}
+
 			rw_lock_x_lock(dict_index_get_lock(index));
 			has_index_lock = true;
 
@@ -3326,6 +4065,7 @@ func_exit:
 		index->type |= DICT_CORRUPT;
 	}
 
+	delete applier;
 	mem_heap_free(heap);
 	mem_heap_free(offsets_heap);
 	ut_free(offsets);
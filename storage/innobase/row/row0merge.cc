@@ -40,6 +40,8 @@ Completed by Sunny Bains and Marko Makela
 #include "row0import.h"
 #include "handler0alter.h"
 #include "srv0space.h"
+#include "btr0bulk.h"
+#include "buf0lru.h"
 
 /* Ignore posix_fadvise() on those platforms where it does not exist */
 #if defined _WIN32
@@ -464,9 +466,10 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (!dup->n_dup++ && dup->table != NULL) {
 		/* Only report the first duplicate record,
-		but count all duplicate records. */
+		but count all duplicate records.  A parallel sort
+		thread only counts the duplicates. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
 	}
 }
@@ -1053,6 +1056,501 @@ row_merge_write_eof(
 	DBUG_RETURN(&block[0]);
 }
 
+/*********************************************************************//**
+Create the info of srv_sort_pll_degree parallel index sort threads.
+@return parallel sort info, or NULL if index creation should not
+use parallel sort threads */
+
+row_merge_psort_t*
+row_merge_psort_create(
+/*===================*/
+	trx_t*		trx)	/*!< in: transaction */
+{
+	row_merge_psort_common_t*	common;
+	row_merge_psort_t*		psort;
+
+	if (srv_sort_pll_degree <= 1) {
+		return(NULL);
+	}
+
+	common = static_cast<row_merge_psort_common_t*>(
+		mem_zalloc(sizeof *common));
+
+	psort = static_cast<row_merge_psort_t*>(
+		mem_zalloc(srv_sort_pll_degree * sizeof *psort));
+
+	common->trx = trx;
+	common->all_info = psort;
+	common->n_threads = srv_sort_pll_degree;
+	common->event = os_event_create(0);
+	common->job_event = os_event_create(0);
+
+	mutex_create("row_merge_psort", &common->mutex);
+
+	for (ulint i = 0; i < common->n_threads; i++) {
+		psort[i].psort_id = i;
+		psort[i].child_status = ROW_MERGE_CHILD_EXITING;
+		psort[i].psort_common = common;
+	}
+
+	for (ulint i = 0; i < common->n_threads; i++) {
+		/* Align the buffers like the ones of the FTS parallel
+		sort, for srv_disable_sort_file_cache. */
+		psort[i].block_alloc = static_cast<row_merge_block_t*>(
+			ut_malloc_low(3 * srv_sort_buf_size + 1024, FALSE));
+
+		if (psort[i].block_alloc == NULL) {
+			row_merge_psort_destroy(psort);
+			return(NULL);
+		}
+
+		psort[i].block = static_cast<row_merge_block_t*>(
+			ut_align(psort[i].block_alloc, 1024));
+	}
+
+	return(psort);
+}
+
+/*********************************************************************//**
+Free the info of the parallel index sort threads. */
+
+void
+row_merge_psort_destroy(
+/*====================*/
+	row_merge_psort_t*	psort)	/*!< in,own: parallel sort info */
+{
+	row_merge_psort_common_t*	common = psort->psort_common;
+
+	ut_ad(common->jobs == NULL);
+
+	for (ulint i = 0; i < common->n_threads; i++) {
+		ut_ad(psort[i].child_status == ROW_MERGE_CHILD_EXITING);
+
+		if (psort[i].block_alloc != NULL) {
+			ut_free(psort[i].block_alloc);
+		}
+	}
+
+	mutex_free(&common->mutex);
+	os_event_destroy(common->job_event);
+	os_event_destroy(common->event);
+
+	mem_free(psort);
+	mem_free(common);
+}
+
+/*********************************************************************//**
+Start parallel index sort threads. */
+static
+void
+row_merge_psort_start(
+/*==================*/
+	row_merge_psort_t*	psort,	/*!< in/out: parallel sort info */
+	ulint			n,	/*!< in: number of threads to start */
+	os_thread_ret_t		(*func)(void*))
+					/*!< in: thread function */
+{
+	os_thread_id_t	thd_id;
+
+	ut_ad(n <= psort->psort_common->n_threads);
+
+	for (ulint i = 0; i < n; i++) {
+		psort[i].child_status = ROW_MERGE_CHILD_RUNNING;
+		os_thread_create(func, &psort[i], &thd_id);
+	}
+}
+
+/*********************************************************************//**
+Wait until parallel index sort threads have exited. */
+static
+void
+row_merge_psort_wait(
+/*=================*/
+	row_merge_psort_t*	psort,	/*!< in/out: parallel sort info */
+	ulint			n)	/*!< in: number of started threads */
+{
+	os_event_t	event = psort->psort_common->event;
+	ulint		trial_count = 0;
+	bool		all_exit;
+
+	for (;;) {
+		ib_int64_t	sig_count = os_event_reset(event);
+		ulint		i;
+
+		for (i = 0; i < n; i++) {
+			if (psort[i].child_status
+			    == ROW_MERGE_CHILD_RUNNING) {
+				break;
+			}
+		}
+
+		if (i == n) {
+			break;
+		}
+
+		os_event_wait_time_low(event, 1000000, sig_count);
+	}
+
+	/* Now all children should complete, wait a bit until
+	they all finish setting the event, before we free everything.
+	This has a 10 second timeout */
+	do {
+		all_exit = true;
+
+		for (ulint i = 0; i < n; i++) {
+			if (psort[i].child_status != ROW_MERGE_CHILD_EXITING) {
+				all_exit = false;
+				os_thread_sleep(1000);
+				break;
+			}
+		}
+	} while (!all_exit && ++trial_count < 10000);
+
+	if (!all_exit) {
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Not all child sort threads exited"
+			" when creating indexes");
+	}
+}
+
+/*********************************************************************//**
+Sort a buffer of the clustered index scan and write it to the merge
+file as one run.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_job_run(
+/*==============*/
+	row_merge_job_t*	job,	/*!< in/out: sort job */
+	row_merge_block_t*	block)	/*!< out: file buffer */
+{
+	row_merge_buf_t*	buf = job->buf;
+	merge_file_t		file = { job->fd, job->offset, 0 };
+
+	if (buf->n_tuples == 0) {
+		/* Nothing to sort. */
+	} else if (dict_index_is_unique(buf->index)) {
+		row_merge_dup_t	dup = { buf->index, NULL, NULL, 0 };
+		const ulint	size = buf->n_tuples * sizeof *buf->tuples;
+		mtuple_t*	tuples = static_cast<mtuple_t*>(
+			ut_malloc(size));
+
+		memcpy(tuples, buf->tuples, size);
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			/* Restore the original order, so that sorting
+			the buffer again reports the same duplicate as
+			sorting it in the scan would have done. */
+			memcpy(buf->tuples, tuples, size);
+			ut_free(tuples);
+			return(DB_DUPLICATE_KEY);
+		}
+
+		ut_free(tuples);
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, &file, block);
+
+	if (!row_merge_write(job->fd, job->offset, block)) {
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	UNIV_MEM_INVALID(&block[0], srv_sort_buf_size);
+	job->buf = row_merge_buf_empty(buf);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Function performs parallel sorting of the buffers of the clustered
+index scan, until the scan completes.
+@return OS_THREAD_DUMMY_RETURN */
+static
+os_thread_ret_t
+row_merge_parallel_sort(
+/*====================*/
+	void*		arg)	/*!< in: parallel sort info */
+{
+	row_merge_psort_t*		psort
+		= static_cast<row_merge_psort_t*>(arg);
+	row_merge_psort_common_t*	common = psort->psort_common;
+
+	mutex_enter(&common->mutex);
+
+	for (;;) {
+		row_merge_job_t*	job = NULL;
+
+		for (ulint i = 0; i < common->n_jobs; i++) {
+			if (common->jobs[i].state == ROW_MERGE_JOB_QUEUED) {
+				job = &common->jobs[i];
+				break;
+			}
+		}
+
+		if (job == NULL) {
+			if (common->scan_complete) {
+				break;
+			}
+
+			ib_int64_t	sig_count = os_event_reset(
+				common->job_event);
+
+			mutex_exit(&common->mutex);
+			os_event_wait_low(common->job_event, sig_count);
+			mutex_enter(&common->mutex);
+			continue;
+		}
+
+		job->state = ROW_MERGE_JOB_RUNNING;
+		mutex_exit(&common->mutex);
+
+		dberr_t	error = row_merge_job_run(job, psort->block);
+
+		mutex_enter(&common->mutex);
+
+		if (error == DB_SUCCESS) {
+			job->state = ROW_MERGE_JOB_FREE;
+		} else {
+			job->error = error;
+			job->state = ROW_MERGE_JOB_FAILED;
+		}
+
+		os_event_set(common->event);
+	}
+
+	mutex_exit(&common->mutex);
+
+	psort->child_status = ROW_MERGE_CHILD_COMPLETE;
+	os_event_set(common->event);
+	psort->child_status = ROW_MERGE_CHILD_EXITING;
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Start the parallel sort threads for the clustered index scan.
+@return true if the threads were started, false if no index can
+be sorted by them */
+static
+bool
+row_merge_psort_start_scan(
+/*=======================*/
+	row_merge_psort_t*	psort,	/*!< in/out: parallel sort info */
+	dict_index_t**		index,	/*!< in: indexes to be created */
+	ulint			n_index)/*!< in: number of indexes */
+{
+	row_merge_psort_common_t*	common = psort->psort_common;
+	ulint				n = 0;
+
+	ut_ad(common->jobs == NULL);
+
+	/* The full-text index is tokenized and sorted by the
+	FTS parallel sort threads. */
+	for (ulint i = 0; i < n_index; i++) {
+		if (!(index[i]->type & DICT_FTS)) {
+			n++;
+		}
+	}
+
+	if (n == 0) {
+		return(false);
+	}
+
+	/* Each index gets one spare buffer per thread, while the
+	scan is filling its own buffer. */
+	common->n_jobs = n * common->n_threads;
+	common->n_queued = 0;
+	common->scan_complete = false;
+	common->jobs = static_cast<row_merge_job_t*>(
+		mem_zalloc(common->n_jobs * sizeof *common->jobs));
+
+	row_merge_job_t*	job = common->jobs;
+
+	for (ulint i = 0; i < n_index; i++) {
+		if (index[i]->type & DICT_FTS) {
+			continue;
+		}
+
+		for (ulint j = 0; j < common->n_threads; j++, job++) {
+			job->state = ROW_MERGE_JOB_FREE;
+			job->buf = row_merge_buf_create(index[i]);
+			job->idx = i;
+			job->fd = -1;
+		}
+	}
+
+	row_merge_psort_start(psort, common->n_threads,
+			      row_merge_parallel_sort);
+
+	return(true);
+}
+
+/*********************************************************************//**
+Hand over a full buffer of the clustered index scan to the parallel
+sort threads, and replace it with an empty buffer of the same index.
+@return DB_SUCCESS, or the error of a job that failed earlier */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_psort_queue(
+/*==================*/
+	row_merge_psort_t*	psort,	/*!< in/out: parallel sort info */
+	ulint			idx,	/*!< in: index number */
+	row_merge_buf_t**	buf,	/*!< in/out: sort buffer */
+	int			fd,	/*!< in: merge file */
+	ulint			offset)	/*!< in: block offset of the run */
+{
+	row_merge_psort_common_t*	common = psort->psort_common;
+	row_merge_job_t*		job;
+
+	mutex_enter(&common->mutex);
+
+	for (;;) {
+		job = NULL;
+
+		for (ulint i = 0; i < common->n_jobs; i++) {
+			row_merge_job_t*	j = &common->jobs[i];
+
+			if (j->state == ROW_MERGE_JOB_FAILED) {
+				dberr_t	error = j->error;
+
+				mutex_exit(&common->mutex);
+				return(error);
+			}
+
+			if (job == NULL && j->idx == idx
+			    && j->state == ROW_MERGE_JOB_FREE) {
+				job = j;
+			}
+		}
+
+		if (job != NULL) {
+			break;
+		}
+
+		/* Wait until a spare buffer of this index is free. */
+		ib_int64_t	sig_count = os_event_reset(common->event);
+
+		mutex_exit(&common->mutex);
+		os_event_wait_low(common->event, sig_count);
+		mutex_enter(&common->mutex);
+	}
+
+	row_merge_buf_t*	empty = job->buf;
+
+	job->buf = *buf;
+	job->fd = fd;
+	job->offset = offset;
+	job->seq = common->n_queued++;
+	job->state = ROW_MERGE_JOB_QUEUED;
+
+	mutex_exit(&common->mutex);
+
+	os_event_set(common->job_event);
+
+	*buf = empty;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Wait for the parallel sort threads to write all the buffers of the
+clustered index scan, and stop the threads.
+@return DB_SUCCESS, or the error of the failed job that was queued
+first */
+static __attribute__((nonnull(1,4), warn_unused_result))
+dberr_t
+row_merge_psort_finish_scan(
+/*========================*/
+	row_merge_psort_t*	psort,	/*!< in/out: parallel sort info */
+	struct TABLE*		table,	/*!< in/out: MySQL table object,
+					for reporting duplicate keys */
+	const ulint*		col_map,/*!< in: mapping of old column
+					numbers to new ones, or NULL */
+	const ulint*		key_numbers)
+					/*!< in: MySQL key numbers */
+{
+	row_merge_psort_common_t*	common = psort->psort_common;
+	row_merge_job_t*		failed = NULL;
+	dberr_t				error = DB_SUCCESS;
+
+	mutex_enter(&common->mutex);
+
+	for (;;) {
+		ulint	i;
+
+		for (i = 0; i < common->n_jobs; i++) {
+			if (common->jobs[i].state == ROW_MERGE_JOB_QUEUED
+			    || common->jobs[i].state
+			    == ROW_MERGE_JOB_RUNNING) {
+				break;
+			}
+		}
+
+		if (i == common->n_jobs) {
+			break;
+		}
+
+		ib_int64_t	sig_count = os_event_reset(common->event);
+
+		mutex_exit(&common->mutex);
+		os_event_wait_low(common->event, sig_count);
+		mutex_enter(&common->mutex);
+	}
+
+	common->scan_complete = true;
+
+	mutex_exit(&common->mutex);
+
+	os_event_set(common->job_event);
+
+	row_merge_psort_wait(psort, common->n_threads);
+
+	/* Report the error of the run that the scan would have
+	written first if it sorted the buffers itself. */
+	for (ulint i = 0; i < common->n_jobs; i++) {
+		row_merge_job_t*	job = &common->jobs[i];
+
+		if (job->state == ROW_MERGE_JOB_FAILED
+		    && (failed == NULL || job->seq < failed->seq)) {
+			failed = job;
+		}
+	}
+
+	if (failed != NULL) {
+		trx_t*	trx = common->trx;
+
+		error = failed->error;
+
+		if (error == DB_DUPLICATE_KEY) {
+			row_merge_dup_t	dup = {
+				failed->buf->index, table, col_map, 0};
+
+			row_merge_buf_sort(failed->buf, &dup);
+			ut_ad(dup.n_dup);
+
+			trx->error_key_num = key_numbers[failed->idx];
+		} else {
+			trx->error_key_num = failed->idx;
+		}
+	}
+
+	for (ulint i = 0; i < common->n_jobs; i++) {
+		row_merge_buf_free(common->jobs[i].buf);
+	}
+
+	mem_free(common->jobs);
+	common->jobs = NULL;
+	common->n_jobs = 0;
+
+	return(error);
+}
+
 /********************************************************************//**
 Reads clustered index of the table and create temporary files
 containing the index entries for the indexes to be built.
@@ -1093,7 +1591,9 @@ row_merge_read_clustered_index(
 					AUTO_INCREMENT column, or
 					ULINT_UNDEFINED if none is added */
 	ib_sequence_t&		sequence,/*!< in/out: autoinc sequence */
-	row_merge_block_t*	block)	/*!< in/out: file buffer */
+	row_merge_block_t*	block,	/*!< in/out: file buffer */
+	row_merge_psort_t*	psort)	/*!< in/out: parallel sort threads
+					for sorting the buffers, or NULL */
 {
 	dict_index_t*		clust_index;	/* Clustered index */
 	mem_heap_t*		row_heap;	/* Heap memory to create
@@ -1113,6 +1613,10 @@ row_merge_read_clustered_index(
 	os_event_t		fts_parallel_sort_event = NULL;
 	ibool			fts_pll_sort = FALSE;
 	ib_int64_t		sig_count = 0;
+	ibool			scan_resistant;	/* TRUE if the pages
+						read are released with
+						buf_page_release_scanned() */
+	unsigned		scan_start_time;
 	DBUG_ENTER("row_merge_read_clustered_index");
 
 	ut_ad((old_table == new_table) == !col_map);
@@ -1161,6 +1665,11 @@ row_merge_read_clustered_index(
 		}
 	}
 
+	if (psort != NULL
+	    && !row_merge_psort_start_scan(psort, index, n_index)) {
+		psort = NULL;
+	}
+
 	mtr_start(&mtr);
 
 	/* Find the clustered index and create a persistent cursor
@@ -1168,6 +1677,10 @@ row_merge_read_clustered_index(
 
 	clust_index = dict_table_get_first_index(old_table);
 
+	scan_resistant = thd_scan_resistant(trx->mysql_thd)
+		&& buf_LRU_scan_is_large(old_table->stat_clustered_index_size);
+	scan_start_time = ut_time_ms();
+
 	btr_pcur_open_at_index_side(
 		true, clust_index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
 
@@ -1316,8 +1829,18 @@ end_of_index:
 					next_page_no, BTR_SEARCH_LEAF,
 					clust_index, &mtr);
 
+				ulint	prev_page_no = buf_block_get_page_no(
+					page_cur_get_block(cur));
+
 				btr_leaf_page_release(page_cur_get_block(cur),
 						      BTR_SEARCH_LEAF, &mtr);
+
+				if (scan_resistant) {
+					buf_page_release_scanned(
+						buf_block_get_space(block),
+						prev_page_no, scan_start_time);
+				}
+
 				page_cur_set_before_first(block, cur);
 				page_cur_move_to_next(cur);
 
@@ -1517,8 +2040,14 @@ write_buffers:
 			/* We have enough data tuples to form a block.
 			Sort them and write to disk. */
 
+			const bool	pll_sort = psort != NULL
+				&& !(buf->index->type & DICT_FTS);
+
 			if (buf->n_tuples) {
-				if (dict_index_is_unique(buf->index)) {
+				if (pll_sort) {
+					/* A parallel sort thread will
+					sort the buffer. */
+				} else if (dict_index_is_unique(buf->index)) {
 					row_merge_dup_t	dup = {
 						buf->index, table, col_map, 0};
 
@@ -1558,17 +2087,33 @@ write_buffers:
 					dict_index_get_lock(buf->index));
 			}
 
-			row_merge_buf_write(buf, file, block);
+			if (pll_sort) {
+				err = row_merge_psort_queue(
+					psort, i, &merge_buf[i],
+					file->fd, file->offset++);
 
-			if (!row_merge_write(file->fd, file->offset++,
-					     block)) {
-				err = DB_OUT_OF_FILE_SPACE;
-				trx->error_key_num = i;
-				break;
-			}
+				if (err != DB_SUCCESS) {
+					/* The error will be reported
+					by row_merge_psort_finish_scan(). */
+					break;
+				}
+
+				buf = merge_buf[i];
+			} else {
+				row_merge_buf_write(buf, file, block);
+
+				if (!row_merge_write(file->fd,
+						     file->offset++,
+						     block)) {
+					err = DB_OUT_OF_FILE_SPACE;
+					trx->error_key_num = i;
+					break;
+				}
 
-			UNIV_MEM_INVALID(&block[0], srv_sort_buf_size);
-			merge_buf[i] = row_merge_buf_empty(buf);
+				UNIV_MEM_INVALID(&block[0],
+						 srv_sort_buf_size);
+				merge_buf[i] = row_merge_buf_empty(buf);
+			}
 
 			if (UNIV_LIKELY(row != NULL)) {
 				/* Try writing the record again, now
@@ -1609,6 +2154,17 @@ func_exit:
 	}
 
 all_done:
+	if (psort != NULL) {
+		dberr_t	psort_err = row_merge_psort_finish_scan(
+			psort, table, col_map, key_numbers);
+
+		/* A failed run was formed before the scan
+		stopped, so its error takes precedence. */
+		if (psort_err != DB_SUCCESS) {
+			err = psort_err;
+		}
+	}
+
 #ifdef FTS_INTERNAL_DIAG_PRINT
 	DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Scan Table\n");
 #endif
@@ -1881,10 +2437,223 @@ done0:
 		    != NULL);
 }
 
+/*************************************************************//**
+Get the number of blocks that a merge run may occupy in a file.
+@return number of blocks */
+UNIV_INLINE
+ulint
+row_merge_run_size(
+/*===============*/
+	const merge_file_t*	file,	/*!< in: file containing the runs */
+	const ulint*		run_offset,/*!< in: first offset of
+					each run */
+	ulint			n_run,	/*!< in: number of runs */
+	ulint			run)	/*!< in: run number */
+{
+	ut_ad(run < n_run);
+
+	return((run + 1 < n_run ? run_offset[run + 1] : file->offset)
+	       - run_offset[run]);
+}
+
+/*********************************************************************//**
+Function performs the parallel merge of pairs of runs of a merge pass.
+@return OS_THREAD_DUMMY_RETURN */
+static
+os_thread_ret_t
+row_merge_parallel_merge(
+/*=====================*/
+	void*		arg)	/*!< in: parallel sort info */
+{
+	row_merge_psort_t*		psort
+		= static_cast<row_merge_psort_t*>(arg);
+	const row_merge_psort_common_t*	common = psort->psort_common;
+	const ulint			half = common->n_run / 2;
+	dberr_t				error = DB_SUCCESS;
+
+	for (ulint i = psort->first; i < psort->last; i++) {
+		ulint	foffs0 = common->run_offset[i];
+		ulint	foffs1 = common->run_offset[half + i];
+
+		if (trx_is_interrupted(common->trx)) {
+			error = DB_INTERRUPTED;
+			break;
+		}
+
+		/* Remember the offset number for this run */
+		common->out_offset[i] = psort->of.offset;
+
+		error = row_merge_blocks(&common->dup, common->file,
+					 psort->block, &foffs0, &foffs1,
+					 &psort->of);
+
+		if (error != DB_SUCCESS) {
+			break;
+		}
+	}
+
+	psort->error = error;
+
+	psort->child_status = ROW_MERGE_CHILD_COMPLETE;
+	os_event_set(common->event);
+	psort->child_status = ROW_MERGE_CHILD_EXITING;
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*************************************************************//**
+Merge the runs of one merge pass in parallel sort threads.
+
+Each thread merges a range of pairs of runs into its own range of
+the output file.  Because a merged run never needs more blocks than
+its two input runs, the range of each thread starts where the input
+runs of its first pair would start if the input file were merged
+by a single thread.  The unused blocks at the end of each range
+are never read, because the runs are located through run_offset[].
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_parallel_pass(
+/*====================*/
+	const row_merge_dup_t*	dup,	/*!< in: descriptor of
+					index being created */
+	merge_file_t*		file,	/*!< in/out: file containing
+					index entries */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd,	/*!< in/out: temporary file handle */
+	ulint*			num_run,/*!< in/out: Number of runs remain
+					to be merged */
+	ulint*			run_offset,/*!< in/out: Array contains the
+					first offset number for each merge
+					run */
+	row_merge_psort_t*	psort)	/*!< in/out: parallel sort threads */
+{
+	row_merge_psort_common_t*	common = psort->psort_common;
+	const ulint			half = *num_run / 2;
+	const ulint			n_threads
+		= ut_min(common->n_threads, half);
+	ulint*				out_offset;
+	merge_file_t			of;
+	ulint				first = 0;
+	dberr_t				error = DB_SUCCESS;
+
+	ut_ad(n_threads > 1);
+	ut_ad(common->jobs == NULL);
+
+	out_offset = static_cast<ulint*>(
+		mem_alloc((half + 1) * sizeof *out_offset));
+
+	/* Compute the output offset of each pair of runs as if
+	the pairs were merged by a single thread. */
+	out_offset[0] = 0;
+
+	for (ulint i = 0; i < half; i++) {
+		out_offset[i + 1] = out_offset[i]
+			+ row_merge_run_size(file, run_offset, *num_run, i)
+			+ row_merge_run_size(file, run_offset, *num_run,
+					     half + i);
+	}
+
+	/* Give each thread about the same number of blocks. */
+	for (ulint t = 0; t < n_threads; t++) {
+		ulint	last = half;
+
+		if (t + 1 < n_threads) {
+			const ulint	end = out_offset[half] * (t + 1)
+				/ n_threads;
+
+			for (last = first;
+			     last < half && out_offset[last] < end;
+			     last++) {
+			}
+		}
+
+		psort[t].first = first;
+		psort[t].last = last;
+		psort[t].of.fd = *tmpfd;
+		psort[t].of.offset = out_offset[first];
+		psort[t].of.n_rec = 0;
+		psort[t].error = DB_SUCCESS;
+
+		first = last;
+	}
+
+	common->dup = *dup;
+	common->dup.table = NULL;
+	common->dup.n_dup = 0;
+	common->file = file;
+	common->run_offset = run_offset;
+	common->n_run = *num_run;
+	common->out_offset = out_offset;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+	posix_fadvise(file->fd, 0, 0,
+		      POSIX_FADV_SEQUENTIAL | POSIX_FADV_NOREUSE);
+#endif /* POSIX_FADV_SEQUENTIAL */
+
+	row_merge_psort_start(psort, n_threads, row_merge_parallel_merge);
+
+	/* Copy the last run, if there is one, while the
+	threads are merging. */
+	of.fd = *tmpfd;
+	of.offset = out_offset[half];
+	of.n_rec = 0;
+
+	if (*num_run & 1) {
+		ulint	foffs = run_offset[2 * half];
+
+		if (!row_merge_blocks_copy(dup->index, file, block,
+					   &foffs, &of)) {
+			error = DB_CORRUPTION;
+		}
+	}
+
+	row_merge_psort_wait(psort, n_threads);
+
+	ib_uint64_t	n_rec = of.n_rec;
+
+	for (ulint t = 0; t < n_threads; t++) {
+		if (error == DB_SUCCESS) {
+			error = psort[t].error;
+		}
+
+		n_rec += psort[t].of.n_rec;
+	}
+
+	if (error == DB_SUCCESS && n_rec != file->n_rec) {
+		error = DB_CORRUPTION;
+	}
+
+	if (error == DB_SUCCESS) {
+		if (!(*num_run & 1)) {
+			of.offset = psort[n_threads - 1].of.offset;
+		}
+
+		*num_run = half + (*num_run & 1);
+		memcpy(run_offset, out_offset, *num_run * sizeof *run_offset);
+
+		ut_ad(of.offset <= file->offset);
+
+		of.n_rec = n_rec;
+
+		/* Swap file descriptors for the next pass. */
+		*tmpfd = file->fd;
+		*file = of;
+
+		UNIV_MEM_INVALID(&block[0], 3 * srv_sort_buf_size);
+	}
+
+	mem_free(out_offset);
+
+	return(error);
+}
+
 /*************************************************************//**
 Merge disk files.
 @return DB_SUCCESS or error code */
-static __attribute__((nonnull))
+static __attribute__((nonnull(1,2,3,4,5,6,7)))
 dberr_t
 row_merge(
 /*======*/
@@ -1897,22 +2666,39 @@ row_merge(
 	int*			tmpfd,	/*!< in/out: temporary file handle */
 	ulint*			num_run,/*!< in/out: Number of runs remain
 					to be merged */
-	ulint*			run_offset) /*!< in/out: Array contains the
+	ulint*			run_offset, /*!< in/out: Array contains the
 					first offset number for each merge
 					run */
+	row_merge_psort_t*	psort)	/*!< in/out: parallel sort threads,
+					or NULL */
 {
 	ulint		foffs0;	/*!< first input offset */
 	ulint		foffs1;	/*!< second input offset */
 	dberr_t		error;	/*!< error code */
 	merge_file_t	of;	/*!< output file */
-	const ulint	ihalf	= run_offset[*num_run / 2];
-				/*!< half the input file */
+	const ulint	half	= *num_run / 2;
+				/*!< number of pairs of runs to merge */
 	ulint		n_run	= 0;
 				/*!< num of runs generated from this merge */
 
 	UNIV_MEM_ASSERT_W(&block[0], 3 * srv_sort_buf_size);
 
-	ut_ad(ihalf < file->offset);
+	ut_ad(half > 0);
+	ut_ad(run_offset[half] < file->offset);
+
+	if (psort != NULL && half > 1) {
+		error = row_merge_parallel_pass(
+			dup, file, block, tmpfd, num_run, run_offset, psort);
+
+		if (error != DB_DUPLICATE_KEY) {
+			return(error);
+		}
+
+		/* The parallel sort threads do not report the
+		duplicate key value.  Merge the runs again in this
+		thread, to report the same duplicate as a single
+		threaded merge. */
+	}
 
 	of.fd = *tmpfd;
 	of.offset = 0;
@@ -1926,18 +2712,21 @@ row_merge(
 		      POSIX_FADV_SEQUENTIAL | POSIX_FADV_NOREUSE);
 #endif /* POSIX_FADV_SEQUENTIAL */
 
-	/* Merge blocks to the output file. */
-	foffs0 = 0;
-	foffs1 = ihalf;
-
-	UNIV_MEM_INVALID(run_offset, *num_run * sizeof *run_offset);
+	/* Merge each run of the first half with the corresponding run
+	of the second half.  The runs are located through run_offset[],
+	because a parallel merge pass leaves unused blocks between
+	them.  The output offsets overwrite the input offsets that
+	have already been consumed. */
 
-	for (; foffs0 < ihalf && foffs1 < file->offset; foffs0++, foffs1++) {
+	for (ulint i = 0; i < half; i++) {
 
 		if (trx_is_interrupted(trx)) {
 			return(DB_INTERRUPTED);
 		}
 
+		foffs0 = run_offset[i];
+		foffs1 = run_offset[half + i];
+
 		/* Remember the offset number for this run */
 		run_offset[n_run++] = of.offset;
 
@@ -1947,31 +2736,16 @@ row_merge(
 		if (error != DB_SUCCESS) {
 			return(error);
 		}
-
 	}
 
-	/* Copy the last blocks, if there are any. */
+	/* Copy the last run, if there is one. */
 
-	while (foffs0 < ihalf) {
+	if (*num_run & 1) {
 		if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
 			return(DB_INTERRUPTED);
 		}
 
-		/* Remember the offset number for this run */
-		run_offset[n_run++] = of.offset;
-
-		if (!row_merge_blocks_copy(dup->index, file, block,
-					   &foffs0, &of)) {
-			return(DB_CORRUPTION);
-		}
-	}
-
-	ut_ad(foffs0 == ihalf);
-
-	while (foffs1 < file->offset) {
-		if (trx_is_interrupted(trx)) {
-			return(DB_INTERRUPTED);
-		}
+		foffs1 = run_offset[2 * half];
 
 		/* Remember the offset number for this run */
 		run_offset[n_run++] = of.offset;
@@ -1982,8 +2756,6 @@ row_merge(
 		}
 	}
 
-	ut_ad(foffs1 == file->offset);
-
 	if (UNIV_UNLIKELY(of.n_rec != file->n_rec)) {
 		return(DB_CORRUPTION);
 	}
@@ -2024,9 +2796,10 @@ row_merge_sort(
 	merge_file_t*		file,	/*!< in/out: file containing
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
-	int*			tmpfd)	/*!< in/out: temporary file handle */
+	int*			tmpfd,	/*!< in/out: temporary file handle */
+	row_merge_psort_t*	psort)	/*!< in/out: parallel sort threads,
+					or NULL to merge in this thread */
 {
-	const ulint	half	= file->offset / 2;
 	ulint		num_runs;
 	ulint*		run_offset;
 	dberr_t		error	= DB_SUCCESS;
@@ -2043,9 +2816,10 @@ row_merge_sort(
 	/* "run_offset" records each run's first offset number */
 	run_offset = (ulint*) mem_alloc(file->offset * sizeof(ulint));
 
-	/* This tells row_merge() where to start for the first round
-	of merge. */
-	run_offset[half] = half;
+	/* Each block is a run for the first round of merge. */
+	for (ulint i = 0; i < num_runs; i++) {
+		run_offset[i] = i;
+	}
 
 	/* The file should always contain at least one byte (the end
 	of file marker).  Thus, it must be at least one block. */
@@ -2054,7 +2828,7 @@ row_merge_sort(
 	/* Merge the runs until we have one big run */
 	do {
 		error = row_merge(trx, dup, file, block, tmpfd,
-				  &num_runs, run_offset);
+				  &num_runs, run_offset, psort);
 
 		if (error != DB_SUCCESS) {
 			break;
@@ -2113,13 +2887,14 @@ row_merge_copy_blobs(
 
 /********************************************************************//**
 Read sorted file containing index data tuples and insert these data
-tuples to the index
+tuples to the index. The tree is built bottom-up by BtrBulk when the
+index allows it.
 @return DB_SUCCESS or error number */
 static __attribute__((nonnull, warn_unused_result))
 dberr_t
 row_merge_insert_index_tuples(
 /*==========================*/
-	trx_id_t		trx_id, /*!< in: transaction identifier */
+	const trx_t*		trx,	/*!< in: transaction */
 	dict_index_t*		index,	/*!< in: index */
 	const dict_table_t*	old_table,/*!< in: old table */
 	int			fd,	/*!< in: file descriptor */
@@ -2133,6 +2908,9 @@ row_merge_insert_index_tuples(
 	ulint			foffs = 0;
 	ulint*			offsets;
 	mrec_buf_t*		buf;
+	const trx_id_t		trx_id = trx->id;
+	const bool		bulk = BtrBulk::is_supported(index);
+	BtrBulk			btr_bulk(index, trx);
 	DBUG_ENTER("row_merge_insert_index_tuples");
 
 	ut_ad(!srv_read_only_mode);
@@ -2223,6 +3001,18 @@ row_merge_insert_index_tuples(
 			}
 
 			ut_ad(dtuple_validate(dtuple));
+
+			if (bulk) {
+				error = btr_bulk.insert(dtuple);
+
+				if (error != DB_SUCCESS) {
+					goto err_exit;
+				}
+
+				mem_heap_empty(tuple_heap);
+				continue;
+			}
+
 			log_free_check();
 
 			mtr_start(&mtr);
@@ -2314,6 +3104,10 @@ row_merge_insert_index_tuples(
 	}
 
 err_exit:
+	if (bulk) {
+		error = btr_bulk.finish(error);
+	}
+
 	mem_heap_free(tuple_heap);
 	mem_heap_free(ins_heap);
 	mem_heap_free(heap);
@@ -3307,6 +4101,7 @@ row_merge_build_indexes(
 	dict_index_t*		fts_sort_idx = NULL;
 	fts_psort_t*		psort_info = NULL;
 	fts_psort_t*		merge_info = NULL;
+	row_merge_psort_t*	psort = NULL;
 	ib_int64_t		sig_count = 0;
 	bool			fts_psort_initiated = false;
 	DBUG_ENTER("row_merge_build_indexes");
@@ -3328,6 +4123,8 @@ row_merge_build_indexes(
 
 	trx_start_if_not_started_xa(trx, true);
 
+	psort = row_merge_psort_create(trx);
+
 	merge_files = static_cast<merge_file_t*>(
 		mem_alloc(n_indexes * sizeof *merge_files));
 
@@ -3390,7 +4187,7 @@ row_merge_build_indexes(
 		trx, table, old_table, new_table, online, indexes,
 		fts_sort_idx, psort_info, merge_files, key_numbers,
 		n_indexes, add_cols, col_map,
-		add_autoinc, sequence, block);
+		add_autoinc, sequence, block, psort);
 
 	if (error != DB_SUCCESS) {
 
@@ -3477,11 +4274,11 @@ wait_again:
 
 			error = row_merge_sort(
 				trx, &dup, &merge_files[i],
-				block, &tmpfd);
+				block, &tmpfd, psort);
 
 			if (error == DB_SUCCESS) {
 				error = row_merge_insert_index_tuples(
-					trx->id, sort_idx, old_table,
+					trx, sort_idx, old_table,
 					merge_files[i].fd, block);
 			}
 		}
@@ -3543,6 +4340,10 @@ func_exit:
 		dict_mem_index_free(fts_sort_idx);
 	}
 
+	if (psort != NULL) {
+		row_merge_psort_destroy(psort);
+	}
+
 	mem_free(merge_files);
 	os_mem_free_large(block, block_size);
 
@@ -62,6 +62,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "fts0types.h"
 #include "srv0space.h"
 #include "row0import.h"
+#include "row0log.h"
 #include <deque>
 
 /** Provide optional 4.x backwards compatibility for 5.0 and above */
@@ -141,15 +142,19 @@ row_add_table_to_background_drop_list(
 	const char*	name);	/*!< in: table name */
 
 /*******************************************************************//**
-Delays an INSERT, DELETE or UPDATE operation if the purge is lagging. */
+Delays an INSERT, DELETE or UPDATE operation if the purge is lagging,
+or if the table is being altered online and the log apply is lagging. */
 static
 void
-row_mysql_delay_if_needed(void)
-/*===========================*/
+row_mysql_delay_if_needed(
+/*======================*/
+	const dict_table_t*	table)	/*!< in: table to be modified */
 {
 	if (srv_dml_needed_delay) {
 		os_thread_sleep(srv_dml_needed_delay);
 	}
+
+	row_log_throttle(table);
 }
 
 /*******************************************************************//**
@@ -955,7 +960,7 @@ row_prebuilt_free(
 		byte*	base = prebuilt->fetch_cache[0] - 4;
 		byte*	ptr = base;
 
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
+		for (ulint i = 0; i < prebuilt->fetch_cache_capacity; i++) {
 			byte*	row;
 			ulint	magic1;
 			ulint	magic2;
@@ -1373,7 +1378,7 @@ row_insert_for_mysql(
 
 	trx->op_info = "inserting";
 
-	row_mysql_delay_if_needed();
+	row_mysql_delay_if_needed(table);
 
 	trx_start_if_not_started_xa(trx, true);
 
@@ -1780,7 +1785,7 @@ row_update_for_mysql(
 
 	trx->op_info = "updating or deleting";
 
-	row_mysql_delay_if_needed();
+	row_mysql_delay_if_needed(table);
 
 	init_fts_doc_id_for_ref(table, &fk_depth);
 
@@ -2581,11 +2586,14 @@ row_create_index_for_mysql(
 
 		index_id_t index_id = index->id;
 
-		/* add index to dictionary cache and also free index object */
+		/* add index to dictionary cache and also free index object.
+		Intrinsic tables always check the record size strictly: the
+		optimizer falls back to another engine if it is too big. */
 		err = dict_index_add_to_cache(
 			table, index, FIL_NULL,
 			(trx_is_strict(trx)
-			 || dict_table_get_format(table) >= UNIV_FORMAT_B));
+			 || dict_table_get_format(table) >= UNIV_FORMAT_B
+			 || dict_table_is_intrinsic(table)));
 
 		if (err != DB_SUCCESS) {
 			goto error_handling;
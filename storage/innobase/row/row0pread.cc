@@ -0,0 +1,552 @@
+/*****************************************************************************
+
+Copyright (c) 2013, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel read of the clustered index
+
+Created 10/14/2013
+*******************************************************/
+
+#include "ha_prototypes.h"
+
+#include "row0pread.h"
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "lock0lock.h"
+#include "os0thread.h"
+#include "read0read.h"
+#include "rem0cmp.h"
+#include "row0row.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "sync0mutex.h"
+#include "trx0trx.h"
+
+/** Number of key ranges to aim for per thread, so that the threads that
+get the smaller ranges can take over more of the work */
+static const ulint	PARALLEL_READ_RANGES_PER_THREAD = 16;
+
+/*********************************************************************//**
+Constructor */
+
+ParallelReader::ParallelReader(
+/*===========================*/
+	dict_index_t*	index,		/*!< in: the clustered index */
+	trx_t*		trx,		/*!< in: transaction */
+	ulint		n_threads,	/*!< in: maximum number of threads */
+	bool		check_keys)	/*!< in: whether to check the order */
+	:
+	m_index(index),
+	m_trx(trx),
+	m_view(NULL),
+	m_n_threads(ut_max(n_threads, 1UL)),
+	m_check_keys(check_keys),
+	m_heap(mem_heap_create(1024)),
+	m_next(0),
+	m_err(DB_SUCCESS),
+	m_callback(NULL),
+	m_arg(NULL)
+{
+	ut_ad(dict_index_is_clust(index));
+
+	mutex_create("parallel_read", &m_mutex);
+
+	if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED
+	    && !dict_table_is_temporary(index->table)) {
+
+		m_view = trx_assign_read_view(trx);
+	}
+}
+
+/*********************************************************************//**
+Destructor */
+
+ParallelReader::~ParallelReader()
+/*==============================*/
+{
+	mutex_free(&m_mutex);
+	mem_heap_free(m_heap);
+}
+
+/*********************************************************************//**
+Split the index into key ranges along the node pointers of the highest
+level that has at least PARALLEL_READ_RANGES_PER_THREAD of them per thread,
+or of level 1. The boundaries are copied, so that the tree may change
+afterwards; a range then covers the same keys, just on other pages. */
+
+void
+ParallelReader::partition()
+/*========================*/
+{
+	mtr_t			mtr;
+	std::vector<ulint>	pages;
+	std::vector<dtuple_t*>	keys;
+	ulint			space = dict_index_get_space(m_index);
+	ulint			zip_size = dict_table_zip_size(m_index->table);
+	ulint			n_unique = dict_index_get_n_unique_in_tree(
+		m_index);
+	ulint			target = m_n_threads
+		* PARALLEL_READ_RANGES_PER_THREAD;
+	mem_heap_t*		heap = NULL;
+	ulint			offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*			offsets = offsets_;
+
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+
+	mtr_s_lock(dict_index_get_lock(m_index), &mtr);
+
+	pages.push_back(dict_index_get_page(m_index));
+
+	for (;;) {
+		std::vector<ulint>	children;
+		ulint			level = ULINT_UNDEFINED;
+
+		keys.clear();
+
+		for (ulint i = 0; i < pages.size(); ++i) {
+			buf_block_t*	block = btr_block_get(
+				space, zip_size, pages[i], RW_S_LATCH,
+				m_index, &mtr);
+			const page_t*	page = buf_block_get_frame(block);
+
+			level = btr_page_get_level(page, &mtr);
+
+			if (level == 0) {
+				break;
+			}
+
+			for (const rec_t* rec = page_rec_get_next_const(
+				     page_get_infimum_rec(page));
+			     !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+
+				offsets = rec_get_offsets(
+					rec, m_index, offsets,
+					ULINT_UNDEFINED, &heap);
+
+				children.push_back(
+					btr_node_ptr_get_child_page_no(
+						rec, offsets));
+
+				/* The leftmost node pointer of the level
+				starts the first range, from the low end
+				of the index. */
+				if (rec_get_info_bits(
+					    rec, dict_table_is_comp(
+						    m_index->table))
+				    & REC_INFO_MIN_REC_FLAG) {
+
+					continue;
+				}
+
+				keys.push_back(dict_index_build_data_tuple(
+					m_index, const_cast<rec_t*>(rec),
+					n_unique, m_heap));
+			}
+		}
+
+		if (level <= 1 || keys.size() + 1 >= target) {
+			break;
+		}
+
+		/* Go down one level for more node pointers. */
+		pages.swap(children);
+	}
+
+	mtr_commit(&mtr);
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
+
+	const dtuple_t*	start = NULL;
+
+	for (ulint i = 0; i < keys.size(); ++i) {
+		m_ranges.push_back(Range(start, keys[i]));
+		start = keys[i];
+	}
+
+	m_ranges.push_back(Range(start, NULL));
+
+	m_n_threads = ut_min(m_n_threads, m_ranges.size());
+}
+
+/*********************************************************************//**
+Read one key range.
+@return DB_SUCCESS or error code */
+
+dberr_t
+ParallelReader::read_range(
+/*=======================*/
+	ulint		thread_no,	/*!< in: number of this thread */
+	const Range&	range)		/*!< in: the range to read */
+{
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	dberr_t		err = DB_SUCCESS;
+	ulint		comp = dict_table_is_comp(m_index->table);
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE);
+	mem_heap_t*	prev_heap = NULL;
+	const rec_t*	prev_rec = NULL;
+	ulint*		prev_offsets = NULL;
+
+	mtr_start(&mtr);
+
+	if (range.m_start == NULL) {
+		btr_pcur_open_at_index_side(
+			true, m_index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	} else {
+		btr_pcur_open(m_index, range.m_start, PAGE_CUR_GE,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+
+		/* Step back, so that the loop below starts at the
+		record that the cursor was positioned on. */
+		btr_pcur_move_to_prev_on_page(&pcur);
+	}
+
+	if (m_check_keys) {
+		prev_heap = mem_heap_create(UNIV_PAGE_SIZE);
+	}
+
+	for (;;) {
+		page_cur_t*	cur = btr_pcur_get_page_cur(&pcur);
+		const rec_t*	rec;
+		rec_t*		vers;
+		ulint*		offsets;
+
+		page_cur_move_to_next(cur);
+
+		if (page_cur_is_after_last(cur)) {
+			ulint		next_page_no;
+			buf_block_t*	block;
+
+			if (trx_is_interrupted(m_trx)) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+
+			next_page_no = btr_page_get_next(
+				page_cur_get_page(cur), &mtr);
+
+			if (next_page_no == FIL_NULL) {
+				break;
+			}
+
+			if (rw_lock_get_waiters(dict_index_get_lock(m_index))) {
+				/* Do not starve the threads that are
+				waiting for the index tree lock, as in
+				row_merge_read_clustered_index(). */
+
+				btr_pcur_move_to_prev_on_page(&pcur);
+
+				btr_pcur_store_position(&pcur, &mtr);
+				mtr_commit(&mtr);
+
+				os_thread_yield();
+
+				mtr_start(&mtr);
+				btr_pcur_restore_position(
+					BTR_SEARCH_LEAF, &pcur, &mtr);
+
+				if (!btr_pcur_move_to_next_user_rec(
+					    &pcur, &mtr)) {
+					break;
+				}
+			} else {
+				block = page_cur_get_block(cur);
+				block = btr_block_get(
+					buf_block_get_space(block),
+					buf_block_get_zip_size(block),
+					next_page_no, BTR_SEARCH_LEAF,
+					m_index, &mtr);
+
+				btr_leaf_page_release(page_cur_get_block(cur),
+						      BTR_SEARCH_LEAF, &mtr);
+				page_cur_set_before_first(block, cur);
+				page_cur_move_to_next(cur);
+
+				if (page_cur_is_after_last(cur)) {
+					/* An empty leaf page can only be
+					the root page. */
+					break;
+				}
+			}
+		}
+
+		rec = page_cur_get_rec(cur);
+
+		mem_heap_empty(heap);
+
+		offsets = rec_get_offsets(rec, m_index, NULL,
+					  ULINT_UNDEFINED, &heap);
+
+		if (range.m_end != NULL
+		    && cmp_dtuple_rec(range.m_end, rec, offsets) <= 0) {
+
+			break;
+		}
+
+		if (m_check_keys) {
+			if (prev_rec != NULL
+			    && cmp_rec_rec(prev_rec, rec, prev_offsets,
+					   offsets, m_index) >= 0) {
+
+				fputs("InnoDB: index records in a wrong order"
+				      " in ", stderr);
+				dict_index_name_print(stderr, m_trx, m_index);
+				fputs("\nInnoDB: record ", stderr);
+				rec_print_new(stderr, rec, offsets);
+				putc('\n', stderr);
+
+				/* Keep reading, like CHECK TABLE does. */
+				err = DB_INDEX_CORRUPT;
+			}
+
+			mem_heap_empty(prev_heap);
+
+			prev_rec = rec_copy(
+				mem_heap_alloc(prev_heap,
+					       rec_offs_size(offsets)),
+				rec, offsets);
+
+			prev_offsets = rec_get_offsets(
+				prev_rec, m_index, NULL, ULINT_UNDEFINED,
+				&prev_heap);
+		}
+
+		vers = const_cast<rec_t*>(rec);
+
+		if (m_view != NULL
+		    && !lock_clust_rec_cons_read_sees(
+			    rec, m_index, offsets, m_view)) {
+
+			row_vers_build_for_consistent_read(
+				rec, &mtr, m_index, &offsets, m_view,
+				&heap, heap, &vers);
+
+			if (vers == NULL) {
+				/* Inserted after the read view. */
+				continue;
+			}
+		}
+
+		if (rec_get_deleted_flag(vers, comp)) {
+			continue;
+		}
+
+		dberr_t	cb_err = m_callback(thread_no, vers, offsets, m_arg);
+
+		if (cb_err != DB_SUCCESS) {
+			err = cb_err;
+			break;
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	btr_pcur_close(&pcur);
+
+	if (prev_heap != NULL) {
+		mem_heap_free(prev_heap);
+	}
+
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Read the ranges until there are none left, or until another thread has
+failed. */
+
+void
+ParallelReader::worker(
+/*===================*/
+	ulint	thread_no)		/*!< in: number of this thread */
+{
+	for (;;) {
+		ulint	i;
+
+		mutex_enter(&m_mutex);
+
+		if (m_err != DB_SUCCESS && m_err != DB_INDEX_CORRUPT) {
+			i = m_ranges.size();
+		} else {
+			i = m_next;
+		}
+
+		if (i < m_ranges.size()) {
+			++m_next;
+		}
+
+		mutex_exit(&m_mutex);
+
+		if (i >= m_ranges.size()) {
+			return;
+		}
+
+		dberr_t	err = read_range(thread_no, m_ranges[i]);
+
+		if (err != DB_SUCCESS) {
+			mutex_enter(&m_mutex);
+
+			/* Out of order records do not stop CHECK TABLE,
+			but any other error takes precedence. */
+			if (m_err == DB_SUCCESS || m_err == DB_INDEX_CORRUPT) {
+				m_err = err;
+			}
+
+			mutex_exit(&m_mutex);
+		}
+	}
+}
+
+/*********************************************************************//**
+Body of the additional reading threads. */
+
+void
+ParallelReader::thread_main(
+/*========================*/
+	void*	arg)			/*!< in: the Thread to run */
+{
+	Thread*	thread = static_cast<Thread*>(arg);
+
+	thread->m_reader->worker(thread->m_thread_no);
+
+	os_event_set(thread->m_done);
+}
+
+/*********************************************************************//**
+Thread that reads ranges of the index for ParallelReader::run().
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_pread_thread)(
+/*=============================*/
+	void*	arg)			/*!< in: ParallelReader::Thread */
+{
+	ParallelReader::thread_main(arg);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Split the index into ranges and read them. The calling thread reads too,
+as thread number 0.
+@return DB_SUCCESS or error code */
+
+dberr_t
+ParallelReader::run(
+/*================*/
+	callback_t	callback,	/*!< in: callback for each
+					visible record */
+	void*		arg)		/*!< in: argument for the callback */
+{
+	m_callback = callback;
+	m_arg = arg;
+
+	partition();
+
+	std::vector<Thread>	threads(m_n_threads - 1);
+
+	for (ulint i = 0; i < threads.size(); ++i) {
+		threads[i].m_reader = this;
+		threads[i].m_thread_no = i + 1;
+		threads[i].m_done = os_event_create(NULL);
+
+		os_thread_create(row_pread_thread, &threads[i], NULL);
+	}
+
+	worker(0);
+
+	for (ulint i = 0; i < threads.size(); ++i) {
+		os_event_wait(threads[i].m_done);
+		os_event_destroy(threads[i].m_done);
+	}
+
+	return(m_err);
+}
+
+/** Per-thread row counts of row_pread_count(), padded to stay on
+separate cache lines */
+struct row_pread_count_t {
+	ulint	n_rows;
+	char	pad[64 - sizeof(ulint)];
+};
+
+/*********************************************************************//**
+Count one visible record for row_pread_count().
+@return DB_SUCCESS */
+static
+dberr_t
+row_pread_count_rec(
+/*================*/
+	ulint		thread_no,	/*!< in: number of the thread */
+	const rec_t*	rec __attribute__((unused)),
+					/*!< in: the visible record */
+	const ulint*	offsets __attribute__((unused)),
+					/*!< in: rec_get_offsets(rec) */
+	void*		arg)		/*!< in/out: row_pread_count_t[] */
+{
+	++static_cast<row_pread_count_t*>(arg)[thread_no].n_rows;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Count the records of the clustered index that are visible in the read view
+of the transaction, reading it with srv_parallel_read_threads threads.
+@return DB_SUCCESS, DB_INTERRUPTED or DB_INDEX_CORRUPT */
+
+dberr_t
+row_pread_count(
+/*============*/
+	trx_t*		trx,		/*!< in: transaction */
+	dict_index_t*	index,		/*!< in: clustered index */
+	bool		check_keys,	/*!< in: true=check the order of
+					the records, as in CHECK TABLE */
+	ulint*		n_rows)		/*!< out: number of visible rows */
+{
+	trx_start_if_not_started(trx, false);
+
+	ParallelReader	reader(index, trx, srv_parallel_read_threads,
+			       check_keys);
+
+	std::vector<row_pread_count_t>	counts(reader.n_threads());
+
+	for (ulint i = 0; i < counts.size(); ++i) {
+		counts[i].n_rows = 0;
+	}
+
+	dberr_t	err = reader.run(row_pread_count_rec, &counts[0]);
+
+	*n_rows = 0;
+
+	for (ulint i = 0; i < counts.size(); ++i) {
+		*n_rows += counts[i].n_rows;
+	}
+
+	return(err);
+}
@@ -307,7 +307,7 @@ row_quiesce_write_header(
 	byte			value[sizeof(ib_uint32_t)];
 
 	/* Write the meta-data version number. */
-	mach_write_to_4(value, IB_EXPORT_CFG_VERSION_V1);
+	mach_write_to_4(value, IB_EXPORT_CFG_VERSION_V2);
 
 	DBUG_EXECUTE_IF("ib_export_io_write_failure_4", close(fileno(file)););
 
@@ -414,6 +414,51 @@ row_quiesce_write_header(
 	return(DB_SUCCESS);
 }
 
+/*********************************************************************//**
+Write the state of the tablespace after the quiesce: its space id, an upper
+bound of the page LSNs and of the transaction ids on the pages. IMPORT uses
+these to decide whether the pages can be used as they are.
+@return DB_SUCCESS or error code. */
+static	__attribute__((nonnull, warn_unused_result))
+dberr_t
+row_quiesce_write_export_state(
+/*===========================*/
+	const dict_table_t*	table,	/*!< in: write the state of the
+					tablespace of this table */
+	FILE*			file,	/*!< in: file to write to */
+	THD*			thd)	/*!< in/out: session */
+{
+	byte		row[sizeof(ib_uint32_t) + 2 * sizeof(ib_uint64_t)];
+	byte*		ptr = row;
+
+	/* Write the space id. */
+	mach_write_to_4(ptr, table->space);
+	ptr += sizeof(ib_uint32_t);
+
+	/* All the pages have been flushed, no page can be newer than
+	the current LSN. */
+	mach_write_to_8(ptr, log_get_lsn());
+	ptr += sizeof(ib_uint64_t);
+
+	/* The table is locked, all the transactions that modified it
+	have committed and have a smaller id than this. */
+	mach_write_to_8(ptr, trx_sys_get_max_trx_id());
+
+	DBUG_EXECUTE_IF("ib_export_io_write_failure_13",
+			close(fileno(file)););
+
+	if (fwrite(row, 1, sizeof(row), file) != sizeof(row)) {
+		ib_senderrf(
+			thd, IB_LOG_LEVEL_WARN, ER_IO_WRITE_ERROR,
+			errno, strerror(errno),
+			"while writing tablespace export state.");
+
+		return(DB_IO_ERROR);
+	}
+
+	return(DB_SUCCESS);
+}
+
 /*********************************************************************//**
 Write the table meta data after quiesce.
 @return DB_SUCCESS or error code */
@@ -450,6 +495,10 @@ row_quiesce_write_cfg(
 			err = row_quiesce_write_indexes(table, file, thd);
 		}
 
+		if (err == DB_SUCCESS) {
+			err = row_quiesce_write_export_state(table, file, thd);
+		}
+
 		if (fflush(file) != 0) {
 
 			char	msg[BUFSIZ];
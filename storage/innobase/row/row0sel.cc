@@ -1212,7 +1212,7 @@ row_sel_try_search_shortcut(
 				index */
 	ibool		search_latch_locked,
 				/*!< in: whether the search holds
-				btr_search_latch */
+				the search latch of plan->index */
 	mtr_t*		mtr)	/*!< in: mtr */
 {
 	dict_index_t*	index;
@@ -1230,7 +1230,7 @@ row_sel_try_search_shortcut(
 	ut_ad(!plan->must_get_clust);
 #ifdef UNIV_SYNC_DEBUG
 	if (search_latch_locked) {
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_S));
+		ut_ad(rw_lock_own(btr_get_search_latch(index), RW_LOCK_S));
 	}
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -1326,6 +1326,9 @@ row_sel(
 	rec_t*		old_vers;
 	rec_t*		clust_rec;
 	ibool		search_latch_locked;
+	rw_lock_t*	search_latch = NULL;
+					/* the adaptive hash index partition
+					latch held if search_latch_locked */
 	ibool		consistent_read;
 
 	/* The following flag becomes TRUE when we are doing a
@@ -1403,11 +1406,22 @@ table_loop:
 	if (consistent_read && plan->unique_search && !plan->pcur_is_open
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
+		rw_lock_t*	plan_latch = btr_get_search_latch(plan->index);
+
+		if (search_latch_locked && search_latch != plan_latch) {
+			/* The latch is for the partition of another index */
+			rw_lock_s_unlock(search_latch);
+
+			search_latch_locked = FALSE;
+		}
+
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			search_latch = plan_latch;
+
+			rw_lock_s_lock(search_latch);
 
 			search_latch_locked = TRUE;
-		} else if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_X_WAIT) {
+		} else if (rw_lock_get_writer(search_latch) == RW_LOCK_X_WAIT) {
 
 			/* There is an x-latch request waiting: release the
 			s-latch for a moment; as an s-latch here is often
@@ -1416,8 +1430,8 @@ table_loop:
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
+			rw_lock_s_lock(search_latch);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan,
@@ -1442,7 +1456,7 @@ table_loop:
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 
 		search_latch_locked = FALSE;
 	}
@@ -2031,7 +2045,7 @@ lock_wait_or_error:
 
 func_exit:
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 	}
 
 	if (heap != NULL) {
@@ -3387,6 +3401,23 @@ row_sel_dequeue_cached_row_for_mysql(
 	}
 }
 
+/********************************************************************//**
+Get the number of rows that the prefetch cache can hold. Short rows get
+more buffers, so that a long scan can return more rows per batch.
+@return number of buffers in fetch_cache */
+UNIV_INLINE
+ulint
+row_sel_fetch_cache_capacity(
+/*=========================*/
+	const row_prebuilt_t*	prebuilt)	/*!< in: prebuilt struct */
+{
+	ulint	n = MYSQL_FETCH_CACHE_MAX_BYTES
+		/ (prebuilt->mysql_row_len + 8);
+
+	return(ut_min(ut_max(n, static_cast<ulint>(MYSQL_FETCH_CACHE_SIZE)),
+		      static_cast<ulint>(MYSQL_FETCH_CACHE_SIZE_MAX)));
+}
+
 /********************************************************************//**
 Initialise the prefetch cache. */
 UNIV_INLINE
@@ -3399,11 +3430,14 @@ row_sel_prefetch_cache_init(
 	ulint	sz;
 	byte*	ptr;
 
+	prebuilt->fetch_cache_capacity = row_sel_fetch_cache_capacity(
+		prebuilt);
+
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = prebuilt->fetch_cache_capacity * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(mem_alloc(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < prebuilt->fetch_cache_capacity; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3430,7 +3464,7 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 	if (prebuilt->fetch_cache[0] == NULL) {
 		/* Allocate memory for the fetch cache */
@@ -3764,15 +3798,14 @@ row_search_for_mysql(
 	adaptive hash index latch if there is someone waiting behind */
 
 	if (trx->has_search_latch
-	    && rw_lock_get_writer(&btr_search_latch) != RW_LOCK_NOT_LOCKED) {
+	    && rw_lock_get_writer(trx->search_latch) != RW_LOCK_NOT_LOCKED) {
 
 		/* There is an x-latch request on the adaptive hash index:
 		release the s-latch to reduce starvation and wait for
 		BTR_SEA_TIMEOUT rounds before trying to keep it again over
 		calls from MySQL */
 
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = false;
+		trx_search_latch_release_if_reserved(trx);
 
 		trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 	}
@@ -3792,6 +3825,7 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3816,6 +3850,7 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -3827,7 +3862,8 @@ row_search_for_mysql(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_limit) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -3844,6 +3880,17 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 500000000;
 		}
 
+		if (prebuilt->n_rows_fetched >= 2 * prebuilt->fetch_cache_limit
+		    && prebuilt->fetch_cache_limit < MYSQL_FETCH_CACHE_SIZE_MAX) {
+
+			/* The cursor has already returned the contents of
+			a few full caches: fetch bigger batches. */
+
+			prebuilt->fetch_cache_limit = ut_min(
+				2 * prebuilt->fetch_cache_limit,
+				row_sel_fetch_cache_capacity(prebuilt));
+		}
+
 		mode = pcur->search_mode;
 	}
 
@@ -3923,9 +3970,20 @@ row_search_for_mysql(
 			hash index semaphore! */
 
 #ifndef UNIV_SEARCH_DEBUG
+			rw_lock_t*	latch = btr_get_search_latch(index);
+
+			if (trx->has_search_latch
+			    && trx->search_latch != latch) {
+
+				/* We are holding the latch of another
+				adaptive hash index partition. */
+				trx_search_latch_release_if_reserved(trx);
+			}
+
 			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
+				rw_lock_s_lock(latch);
 				trx->has_search_latch = true;
+				trx->search_latch = latch;
 			}
 #endif
 			switch (row_sel_try_search_shortcut_for_mysql(
@@ -3996,8 +4054,8 @@ release_search_latch_if_needed:
 
 					trx->search_latch_timeout--;
 
-					rw_lock_s_unlock(&btr_search_latch);
-					trx->has_search_latch = false;
+					trx_search_latch_release_if_reserved(
+						trx);
 				}
 
 				/* NOTE that we do NOT store the cursor
@@ -4019,10 +4077,7 @@ release_search_latch_if_needed:
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = false;
-	}
+	trx_search_latch_release_if_reserved(trx);
 
 	/* The state of a running trx can only be changed by the
 	thread that is currently serving the transaction. Because we
@@ -4817,7 +4872,7 @@ requires_clust_rec:
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -4870,7 +4925,7 @@ requires_clust_rec:
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
 			goto next_rec;
 		}
 
@@ -4999,6 +5054,12 @@ next_rec:
 	}
 
 	if (moves_up) {
+		ulint	prev_page_no;
+
+		prev_page_no = UNIV_UNLIKELY(prebuilt->scan_resistant)
+			? buf_block_get_page_no(btr_pcur_get_block(pcur))
+			: FIL_NULL;
+
 		if (UNIV_UNLIKELY(!btr_pcur_move_to_next(pcur, &mtr))) {
 not_moved:
 			btr_pcur_store_position(pcur, &mtr);
@@ -5011,6 +5072,15 @@ not_moved:
 
 			goto normal_return;
 		}
+
+		if (UNIV_UNLIKELY(prev_page_no != FIL_NULL)
+		    && buf_block_get_page_no(btr_pcur_get_block(pcur))
+		    != prev_page_no) {
+			/* The scan is done with the previous leaf page. */
+			buf_page_release_scanned(
+				dict_index_get_space(index), prev_page_no,
+				prebuilt->scan_start_time);
+		}
 	} else {
 		if (UNIV_UNLIKELY(!btr_pcur_move_to_prev(pcur, &mtr))) {
 			goto not_moved;
@@ -31,6 +31,7 @@ Created 2013-04-12 Sunny Bains
 #include "dict0stats_bg.h"
 #include "lock0lock.h"
 #include "fts0fts.h"
+#include "fts0types.h"
 #include "srv0space.h"
 #include "srv0start.h"
 #include "row0trunc.h"
@@ -1432,6 +1433,13 @@ row_truncate_update_system_tables(
 			fts_update_next_doc_id(trx, table, NULL, 0);
 			fts_cache_clear(table->fts->cache, TRUE);
 			fts_cache_init(table->fts->cache);
+
+			/* The doc ids start over, forget the deleted ones. */
+			mutex_enter(&table->fts->cache->deleted_lock);
+			table->fts->cache->deleted_set->clear();
+			table->fts->cache->deleted_set_loaded = false;
+			table->fts->cache->deleted = 0;
+			mutex_exit(&table->fts->cache->deleted_lock);
 			table->fts->fts_status &= ~TABLE_DICT_LOCKED;
 		}
 	}
@@ -1979,6 +1987,52 @@ row_truncate_table_for_mysql(
 	return(row_truncate_complete(table, trx, flags, logger, err));
 }
 
+/**
+Empties an intrinsic table. The index trees are re-created in memory;
+there is nothing to log or commit because the table is visible only to
+the statement that created it.
+@param table		intrinsic table being emptied
+@return	error code or DB_SUCCESS */
+
+dberr_t
+row_truncate_intrinsic_table(dict_table_t* table)
+{
+	dberr_t		err = DB_SUCCESS;
+
+	ut_ad(dict_table_is_intrinsic(table));
+
+	/* Rollback looks for the table based on the table id: with a
+	new id it sees the table as 'dropped' and discards the undo
+	records of the rows that are removed here. */
+	table_id_t	new_id;
+	dict_hdr_get_new_id(&new_id, NULL, NULL, table, false);
+
+	mutex_enter(&dict_sys->mutex);
+
+	dict_table_x_lock_indexes(table);
+
+	for (dict_index_t* index = UT_LIST_GET_FIRST(table->indexes);
+	     index != NULL && err == DB_SUCCESS;
+	     index = UT_LIST_GET_NEXT(indexes, index)) {
+
+		err = dict_truncate_index_tree_in_mem(index);
+	}
+
+	dict_table_x_unlock_indexes(table);
+
+	if (err == DB_SUCCESS) {
+		dict_table_change_id_in_cache(table, new_id);
+	}
+
+	mutex_exit(&dict_sys->mutex);
+
+	dict_table_autoinc_lock(table);
+	dict_table_autoinc_initialize(table, 1);
+	dict_table_autoinc_unlock(table);
+
+	return(err);
+}
+
 /**
 Fix the table truncate by applying information parsed from TRUNCATE log.
 Fix-up includes re-creating table (drop and re-create indexes) and for
@@ -41,6 +41,7 @@ Created 2011/04/18 Sunny Bains
 #include <mysql/plugin.h>
 
 #include "srv0srv.h"
+#include "srv0mon.h"
 #include "sync0mutex.h"
 #include "trx0trx.h"
 
@@ -51,6 +52,10 @@ ulong	srv_n_free_tickets_to_enter = 500;
 #ifdef HAVE_ATOMIC_BUILTINS
 /** Maximum sleep delay (in micro-seconds), value of 0 disables it. */
 ulong	srv_adaptive_max_sleep_delay = 150000;
+
+/** Adjust the limits of innodb_thread_concurrency to the measured
+throughput, separately for read-only and read-write threads */
+my_bool	srv_adaptive_concurrency = FALSE;
 #endif /* HAVE_ATOMIC_BUILTINS */
 
 ulong	srv_thread_sleep_delay	= 10000;
@@ -118,6 +123,62 @@ struct srv_conc_t {
 /* Control variables for tracking concurrency. */
 static srv_conc_t	srv_conc;
 
+#ifdef HAVE_ATOMIC_BUILTINS
+/** Classes of threads that innodb_adaptive_concurrency admits
+separately */
+enum srv_conc_class_t {
+	SRV_CONC_READ_ONLY = 0,		/*!< threads of transactions that
+					have not written anything */
+	SRV_CONC_READ_WRITE,		/*!< threads of transactions that
+					write or will take locks */
+	SRV_CONC_N_CLASSES
+};
+
+/** Admission state of one class of threads in innodb_adaptive_concurrency.
+Each class has its own limit, which srv_conc_adapt() climbs towards the
+highest measured throughput. The sum of the threads inside InnoDB stays
+within innodb_thread_concurrency. */
+struct srv_conc_class_state_t {
+	char		pad[64];
+
+	/** Number of threads inside InnoDB that entered in this class */
+	volatile lint	n_active;
+
+	/** Number of threads waiting to enter in this class */
+	volatile lint	n_waiting;
+
+	/** Number of the waiting threads that hold locks; they are
+	admitted before the others */
+	volatile lint	n_waiting_locked;
+
+	/** Current admission limit of the class */
+	volatile ulint	limit;
+
+	/** Number of times a thread of this class has left InnoDB,
+	which is the measure of throughput */
+	volatile ulint	n_exits;
+
+	/** n_exits at the previous srv_conc_adapt() */
+	ulint		last_exits;
+
+	/** Exits per second in the previous interval */
+	double		last_rate;
+
+	/** Direction of the last change of limit: 1 or -1 */
+	lint		direction;
+};
+
+/** Admission state of the adaptive concurrency control, per class */
+static srv_conc_class_state_t	srv_conc_classes[SRV_CONC_N_CLASSES];
+
+/** Time of the previous srv_conc_adapt() in milliseconds */
+static ulint	srv_conc_last_adapt_ms;
+
+/** Minimum relative change of throughput that srv_conc_adapt() follows;
+smaller changes are taken as noise */
+static const double	SRV_CONC_ADAPT_NOISE = 0.05;
+#endif /* HAVE_ATOMIC_BUILTINS */
+
 /*********************************************************************//**
 Initialise the concurrency management data structures */
 void
@@ -170,6 +231,122 @@ srv_enter_innodb_with_tickets(
 {
 	trx->declared_to_be_inside_innodb = TRUE;
 	trx->n_tickets_to_enter_innodb = srv_n_free_tickets_to_enter;
+	trx->conc_class = ULINT_UNDEFINED;
+}
+
+/*********************************************************************//**
+Determine the innodb_adaptive_concurrency class of a transaction.
+@return SRV_CONC_READ_ONLY or SRV_CONC_READ_WRITE */
+static
+srv_conc_class_t
+srv_conc_get_class(
+/*===============*/
+	const trx_t*	trx)		/*!< in: transaction */
+{
+	return(trx->rsegs.m_redo.rseg != NULL || trx->will_lock > 0
+	       ? SRV_CONC_READ_WRITE : SRV_CONC_READ_ONLY);
+}
+
+/*********************************************************************//**
+Handle the scheduling of a user thread that wants to enter InnoDB when
+innodb_adaptive_concurrency is on. Read-only and read-write threads are
+admitted up to the limit of their class. Within a class, threads that hold
+locks are admitted before the threads that do not, so that they can finish
+and release the locks sooner. */
+static
+void
+srv_conc_enter_innodb_adaptive(
+/*===========================*/
+	trx_t*	trx)			/*!< in/out: transaction that wants
+					to enter InnoDB */
+{
+	srv_conc_class_t	conc_class = srv_conc_get_class(trx);
+	srv_conc_class_state_t*	state = &srv_conc_classes[conc_class];
+	const bool		has_locks
+		= UT_LIST_GET_LEN(trx->lock.trx_locks) > 0;
+	bool			waiting = false;
+
+	ut_a(!trx->declared_to_be_inside_innodb);
+
+	for (;;) {
+		/* Until srv_conc_adapt() has run, admit up to
+		innodb_thread_concurrency. */
+		lint	limit = state->limit > 0
+			? (lint) state->limit : (lint) srv_thread_concurrency;
+
+		if (state->n_active < limit
+		    && (has_locks || state->n_waiting_locked == 0)
+		    && srv_conc.n_active < (lint) srv_thread_concurrency) {
+
+			if (os_atomic_increment_lint(&state->n_active, 1)
+			    <= limit) {
+
+				if (os_atomic_increment_lint(
+					    &srv_conc.n_active, 1)
+				    <= (lint) srv_thread_concurrency) {
+
+					break;
+				}
+
+				(void) os_atomic_decrement_lint(
+					&srv_conc.n_active, 1);
+			}
+
+			/* Relinquish the overbooked seat. */
+			(void) os_atomic_decrement_lint(&state->n_active, 1);
+		}
+
+		if (!waiting) {
+			(void) os_atomic_increment_lint(&srv_conc.n_waiting, 1);
+			(void) os_atomic_increment_lint(&state->n_waiting, 1);
+
+			if (has_locks) {
+				(void) os_atomic_increment_lint(
+					&state->n_waiting_locked, 1);
+			}
+
+			/* Release possible search system latch this
+			thread has */
+
+			if (trx->has_search_latch) {
+				trx_search_latch_release_if_reserved(trx);
+			}
+
+			thd_wait_begin(trx->mysql_thd, THD_WAIT_USER_LOCK);
+
+			waiting = true;
+		}
+
+		trx->op_info = "sleeping before entering InnoDB";
+
+		ulint	sleep_in_us = srv_thread_sleep_delay;
+
+		if (srv_adaptive_max_sleep_delay > 0
+		    && sleep_in_us > srv_adaptive_max_sleep_delay) {
+
+			sleep_in_us = srv_adaptive_max_sleep_delay;
+		}
+
+		/* Poll more often while holding locks. */
+		os_thread_sleep(has_locks ? sleep_in_us / 4 : sleep_in_us);
+
+		trx->op_info = "";
+	}
+
+	srv_enter_innodb_with_tickets(trx);
+	trx->conc_class = conc_class;
+
+	if (waiting) {
+		if (has_locks) {
+			(void) os_atomic_decrement_lint(
+				&state->n_waiting_locked, 1);
+		}
+
+		(void) os_atomic_decrement_lint(&state->n_waiting, 1);
+		(void) os_atomic_decrement_lint(&srv_conc.n_waiting, 1);
+
+		thd_wait_end(trx->mysql_thd);
+	}
 }
 
 /*********************************************************************//**
@@ -292,6 +469,16 @@ srv_conc_exit_innodb_with_atomics(
 	trx->n_tickets_to_enter_innodb = 0;
 	trx->declared_to_be_inside_innodb = FALSE;
 
+	if (trx->conc_class != ULINT_UNDEFINED) {
+		srv_conc_class_state_t*	state
+			= &srv_conc_classes[trx->conc_class];
+
+		trx->conc_class = ULINT_UNDEFINED;
+
+		(void) os_atomic_increment_ulint(&state->n_exits, 1);
+		(void) os_atomic_decrement_lint(&state->n_active, 1);
+	}
+
 	(void) os_atomic_decrement_lint(&srv_conc.n_active, 1);
 }
 #else
@@ -510,7 +697,11 @@ srv_conc_enter_innodb(
 	}
 
 #ifdef HAVE_ATOMIC_BUILTINS
-	srv_conc_enter_innodb_with_atomics(trx);
+	if (srv_adaptive_concurrency) {
+		srv_conc_enter_innodb_adaptive(trx);
+	} else {
+		srv_conc_enter_innodb_with_atomics(trx);
+	}
 #else
 	srv_conc_enter_innodb_without_atomics(trx);
 #endif /* HAVE_ATOMIC_BUILTINS */
@@ -541,6 +732,7 @@ srv_conc_force_enter_innodb(
 
 #ifdef HAVE_ATOMIC_BUILTINS
 	(void) os_atomic_increment_lint(&srv_conc.n_active, 1);
+	trx->conc_class = ULINT_UNDEFINED;
 #else
 	mutex_enter(&srv_conc_mutex);
 	++srv_conc.n_active;
@@ -581,6 +773,80 @@ srv_conc_force_exit_innodb(
 	}
 }
 
+/*********************************************************************//**
+Adjust the admission limits of innodb_adaptive_concurrency to the
+throughput measured since the previous call. Called once per second.
+This is hill climbing: while threads of a class are kept waiting, its
+limit keeps moving in the same direction as long as the throughput
+improves, and turns around when it drops. When the throughput stays the
+same, the limit is lowered, because fewer threads inside InnoDB cause
+less contention. */
+
+void
+srv_conc_adapt(void)
+/*================*/
+{
+#ifdef HAVE_ATOMIC_BUILTINS
+	ulint	now = ut_time_ms();
+	ulint	elapsed = now - srv_conc_last_adapt_ms;
+	ulint	max_limit = ut_max(srv_thread_concurrency, 1UL);
+
+	srv_conc_last_adapt_ms = now;
+
+	for (ulint i = 0; i < SRV_CONC_N_CLASSES; i++) {
+		srv_conc_class_state_t*	state = &srv_conc_classes[i];
+		ulint			n_exits = state->n_exits;
+		ulint			limit = ut_min(state->limit, max_limit);
+		double			rate = 0;
+
+		if (elapsed > 0) {
+			rate = (n_exits - state->last_exits) * 1000.0
+				/ elapsed;
+		}
+
+		state->last_exits = n_exits;
+
+		if (!srv_adaptive_concurrency || limit == 0) {
+			/* Start from innodb_thread_concurrency when the
+			adaptive control is switched on. */
+			limit = max_limit;
+			state->direction = -1;
+		} else if (state->n_waiting > 0) {
+			ulint	step = ut_max(limit / 8, 1UL);
+
+			if (rate > state->last_rate
+			    * (1 + SRV_CONC_ADAPT_NOISE)) {
+				/* Keep going. */
+			} else if (rate < state->last_rate
+				   * (1 - SRV_CONC_ADAPT_NOISE)) {
+				state->direction = -state->direction;
+			} else {
+				state->direction = -1;
+			}
+
+			if (state->direction > 0 && limit < max_limit) {
+				limit = ut_min(limit + step, max_limit);
+				MONITOR_INC(MONITOR_CONC_LIMIT_INCREASED);
+			} else if (state->direction < 0 && limit > 1) {
+				limit = limit > step ? limit - step : 1;
+				MONITOR_INC(MONITOR_CONC_LIMIT_DECREASED);
+			} else {
+				/* Bounce off the bounds. */
+				state->direction = -state->direction;
+			}
+		}
+
+		state->last_rate = rate;
+		state->limit = limit;
+	}
+
+	MONITOR_SET(MONITOR_CONC_RO_LIMIT,
+		    srv_conc_classes[SRV_CONC_READ_ONLY].limit);
+	MONITOR_SET(MONITOR_CONC_RW_LIMIT,
+		    srv_conc_classes[SRV_CONC_READ_WRITE].limit);
+#endif /* HAVE_ATOMIC_BUILTINS */
+}
+
 /*********************************************************************//**
 Get the count of threads waiting inside InnoDB. */
 
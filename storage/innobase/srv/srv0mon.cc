@@ -109,6 +109,22 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DEFAULT_ON,
 	 MONITOR_DEFAULT_START, MONITOR_TIMEOUT},
 
+	{"lock_deadlock_checks", "lock",
+	 "Number of lock waits checked for deadlocks",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECKS},
+
+	{"lock_deadlock_search_steps", "lock",
+	 "Number of waiting transactions visited by deadlock checks",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_SEARCH_STEPS},
+
+	{"lock_deadlock_detect_latency", "lock",
+	 "Time in microseconds lock waits spent queued for the deadlock"
+	 " detector thread (innodb_deadlock_detect_async)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_DETECT_LATENCY},
+
 	{"lock_rec_lock_waits", "lock",
 	 "Number of times enqueued into record lock wait queue",
 	 MONITOR_NONE,
@@ -388,6 +404,36 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_FLUSH_SYNC_WAITS},
 
+	{"buffer_flush_adaptive_avg_time_slot", "buffer",
+	 "Avg time (ms) spent for adaptive flushing recently per slot.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_ADAPTIVE_AVG_TIME_SLOT},
+
+	{"buffer_LRU_batch_flush_avg_time_slot", "buffer",
+	 "Avg time (ms) spent for LRU batch flushing recently per slot.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_BATCH_FLUSH_AVG_TIME_SLOT},
+
+	{"buffer_flush_adaptive_avg_time_thread", "buffer",
+	 "Avg time (ms) spent for adaptive flushing recently per thread.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_ADAPTIVE_AVG_TIME_THREAD},
+
+	{"buffer_LRU_batch_flush_avg_time_thread", "buffer",
+	 "Avg time (ms) spent for LRU batch flushing recently per thread.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_BATCH_FLUSH_AVG_TIME_THREAD},
+
+	{"buffer_flush_avg_time", "buffer",
+	 "Avg time (ms) spent for flushing recently per page_cleaner pass.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_AVG_TIME},
+
+	{"buffer_flush_avg_pass", "buffer",
+	 "Number of page_cleaner passes used for the recent averages.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_AVG_PASS},
+
 	/* Cumulative counter for flush batches for adaptive flushing  */
 	{"buffer_flush_adaptive_total_pages", "buffer",
 	 "Total pages flushed as part of adaptive flushing",
@@ -511,6 +557,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_LRU_GET_FREE_SEARCH},
 
+	{"buffer_LRU_get_free_waits", "Buffer",
+	 "Number of times a thread waited for the LRU manager to refill"
+	 " the free list",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_GET_FREE_WAITS},
+
 	/* Cumulative counter for LRU search scans */
 	{"buffer_LRU_search_scanned", "buffer",
 	 "Total pages scanned as part of LRU search",
@@ -1150,6 +1202,28 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_RWLOCK_SX_OS_WAITS},
 
+	{"innodb_concurrency_ro_limit", "server",
+	 "Number of read-only threads admitted into InnoDB at the same time"
+	 " by innodb_adaptive_concurrency",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_CONC_RO_LIMIT},
+
+	{"innodb_concurrency_rw_limit", "server",
+	 "Number of read-write threads admitted into InnoDB at the same time"
+	 " by innodb_adaptive_concurrency",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_CONC_RW_LIMIT},
+
+	{"innodb_concurrency_limit_increased", "server",
+	 "Number of times innodb_adaptive_concurrency raised a limit",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_CONC_LIMIT_INCREASED},
+
+	{"innodb_concurrency_limit_decreased", "server",
+	 "Number of times innodb_adaptive_concurrency lowered a limit",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_CONC_LIMIT_DECREASED},
+
 	/* ========== Counters for DML operations ========== */
 	{"module_dml", "dml", "Statistics for DMLs",
 	 MONITOR_MODULE,
@@ -1235,10 +1309,22 @@ has been turned on/off. */
 ulint		monitor_set_tbl[(NUM_MONITOR + NUM_BITS_ULINT
 						- 1) / NUM_BITS_ULINT];
 
+/* The "innodb_counter_slots" array stores the per-CPU changes of the
+counters that are not yet in innodb_counter_value */
+monitor_slot_t	innodb_counter_slots[MONITOR_N_SLOTS];
+
+/** Sums of innodb_counter_slots that srv_mon_fold() has added to
+innodb_counter_value; protected by monitor_fold_mutex */
+static mon_type_t	monitor_folded[NUM_MONITOR];
+
+/** Mutex serializing srv_mon_fold() */
+static ib_mutex_t	monitor_fold_mutex;
+
 #ifndef HAVE_ATOMIC_BUILTINS_64
 /** Mutex protecting atomic operations on platforms that lack
 built-in operations for atomic memory access */
 ib_mutex_t	monitor_mutex;
+#endif /* !HAVE_ATOMIC_BUILTINS_64 */
 
 /****************************************************************//**
 Initialize the monitor subsystem. */
@@ -1247,7 +1333,10 @@ void
 srv_mon_create(void)
 /*================*/
 {
+	mutex_create("monitor_fold", &monitor_fold_mutex);
+#ifndef HAVE_ATOMIC_BUILTINS_64
 	mutex_create("monitor", &monitor_mutex);
+#endif /* !HAVE_ATOMIC_BUILTINS_64 */
 }
 /****************************************************************//**
 Close the monitor subsystem. */
@@ -1256,9 +1345,58 @@ void
 srv_mon_free(void)
 /*==============*/
 {
+	mutex_free(&monitor_fold_mutex);
+#ifndef HAVE_ATOMIC_BUILTINS_64
 	mutex_free(&monitor_mutex);
-}
 #endif /* !HAVE_ATOMIC_BUILTINS_64 */
+}
+
+/****************************************************************//**
+Add the changes that were made to innodb_counter_slots since the previous
+call to innodb_counter_value, and update the max and min values. */
+
+void
+srv_mon_fold(void)
+/*==============*/
+{
+	mon_type_t	sum[NUM_MONITOR];
+
+	memset(sum, 0, sizeof sum);
+
+	/* The slots are read without synchronisation, like the
+	counters are updated. */
+	for (ulint i = 0; i < MONITOR_N_SLOTS; i++) {
+		const mon_type_t*	value
+			= innodb_counter_slots[i].mon_value;
+
+		for (ulint j = 0; j < NUM_MONITOR; j++) {
+			sum[j] += value[j];
+		}
+	}
+
+	mutex_enter(&monitor_fold_mutex);
+
+	for (ulint j = 0; j < NUM_MONITOR; j++) {
+		mon_type_t	delta = sum[j] - monitor_folded[j];
+
+		if (delta == 0) {
+			continue;
+		}
+
+		monitor_folded[j] = sum[j];
+		MONITOR_VALUE(j) += delta;
+
+		if (delta > 0) {
+			if (MONITOR_VALUE(j) > MONITOR_MAX_VALUE(j)) {
+				MONITOR_MAX_VALUE(j) = MONITOR_VALUE(j);
+			}
+		} else if (MONITOR_VALUE(j) < MONITOR_MIN_VALUE(j)) {
+			MONITOR_MIN_VALUE(j) = MONITOR_VALUE(j);
+		}
+	}
+
+	mutex_exit(&monitor_fold_mutex);
+}
 
 /****************************************************************//**
 Get a monitor's "monitor_info" by its monitor id (index into the
@@ -1323,6 +1461,8 @@ srv_mon_set_module_control(
 	/* The module_id must be an ID of MONITOR_MODULE type */
 	ut_a(innodb_counter_info[module_id].monitor_type & MONITOR_MODULE);
 
+	srv_mon_fold();
+
 	/* start with the first monitor in the module. If module_id
 	is MONITOR_ALL_COUNTER, this means we need to turn on all
 	monitor counters. */
@@ -80,6 +80,8 @@ ibool	srv_error_monitor_active = FALSE;
 
 ibool	srv_buf_dump_thread_active = FALSE;
 
+ibool	srv_buf_resize_thread_active = FALSE;
+
 ibool	srv_dict_stats_thread_active = FALSE;
 
 const char*	srv_main_thread_op_info = "";
@@ -106,6 +108,13 @@ ulint	srv_undo_tablespaces_open = 8;
 /* The number of rollback segments to use */
 ulong	srv_undo_logs = 1;
 
+/** Enable or disable the truncation of undo tablespaces by purge. */
+my_bool	srv_undo_log_truncate = FALSE;
+
+/** Size in bytes above which purge marks an undo tablespace for
+truncation. */
+unsigned long long	srv_max_undo_log_size;
+
 /** UNDO logs that are not redo logged.
 These logs reside in the temp tablespace.*/
 const ulong		srv_tmp_undo_logs = 32;
@@ -117,6 +126,9 @@ my_bool	srv_read_only_mode;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 my_bool	srv_file_per_table;
+/* If this flag is TRUE, then new ROW_FORMAT=DYNAMIC file-per-table
+tablespaces use transparent page compression */
+my_bool	srv_page_compression;
 /** The file format to use on new *.ibd files. */
 ulint	srv_file_format = 0;
 /** Whether to check file format during startup.  A value of
@@ -133,8 +145,26 @@ on duplicate key checking and foreign key checking */
 ibool	srv_locks_unsafe_for_binlog = FALSE;
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size = 1048576;
+/** Number of parallel sort threads in index creation */
+ulong	srv_sort_pll_degree = 2;
+/** Percentage of each B-tree page filled when an index is built
+bottom-up from sorted entries */
+ulong	srv_fill_factor = 100;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
+/** Number of threads that apply the modification log of online
+ALTER TABLE; 1 applies it in the ALTER TABLE thread only */
+ulong	srv_online_apply_threads = 4;
+/** Number of modification log blocks that the log apply of online
+ALTER TABLE may fall behind before DML on the table is delayed;
+0 disables the delay */
+ulong	srv_online_log_throttle = 16;
+/** Number of threads that read the clustered index in parallel for
+COUNT(*) and CHECK TABLE; 1 disables the parallel read */
+ulong	srv_parallel_read_threads = 4;
+/** Whether the searches within an index page first compare normalized
+prefixes of the first key field */
+my_bool	srv_normalized_key_search = TRUE;
 
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
@@ -151,6 +181,9 @@ ib_uint64_t	srv_log_file_size	= IB_UINT64_MAX;
 ib_uint64_t	srv_log_file_size_requested;
 /* size in database pages */
 ulint	srv_log_buffer_size	= ULINT_MAX;
+/** Whether dedicated threads write and flush the log for the committing
+threads */
+my_bool	srv_log_writer_threads	= TRUE;
 ulong	srv_flush_log_at_trx_commit = 1;
 uint	srv_flush_log_at_timeout = 1;
 ulong	srv_page_size		= UNIV_PAGE_SIZE_DEF;
@@ -174,8 +207,17 @@ with mutex_enter(), which will wait until it gets the mutex. */
 my_bool	srv_use_sys_malloc	= TRUE;
 /* requested size in kilobytes */
 ulint	srv_buf_pool_size	= ULINT_MAX;
+/* unit in bytes in which the buffer pool is allocated and resized */
+ulong	srv_buf_pool_chunk_unit;
 /* requested number of buffer pool instances */
 ulong	srv_buf_pool_instances;
+/* If this flag is TRUE, then buffer pool instances, and the threads that
+serve them, are bound round-robin to the NUMA nodes of the system */
+my_bool	srv_numa_bind;
+/* number of page_cleaner threads, including the coordinator */
+ulong	srv_n_page_cleaners;
+/* number of threads applying redo log records during crash recovery */
+ulong	srv_n_recovery_threads = 4;
 /* number of locks to protect buf_pool->page_hash */
 ulong	srv_n_page_hash_locks = 16;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
@@ -188,6 +230,11 @@ ulint	srv_buf_pool_old_size;
 ulint	srv_buf_pool_curr_size	= 0;
 /* dump that may % of each buffer pool during BP dump */
 ulong	srv_buf_pool_dump_pct;
+/* seconds between periodic buffer pool dumps, 0 if disabled */
+ulong	srv_buf_pool_dump_interval;
+/* maximum on-disk size of the change buffer, in percent of the buffer
+pool size */
+uint	srv_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
 /* size in bytes */
 ulint	srv_mem_pool_size	= ULINT_MAX;
 ulint	srv_lock_table_size	= ULINT_MAX;
@@ -271,6 +318,11 @@ ulong	srv_force_recovery_crash;
 
 my_bool	srv_print_all_deadlocks = FALSE;
 
+/** Leave deadlock detection to lock_deadlock_thread instead of searching
+the wait-for graph in the thread that enqueues a lock wait */
+
+my_bool	srv_deadlock_detect_async = FALSE;
+
 /** Enable INFORMATION_SCHEMA.innodb_cmp_per_index */
 my_bool	srv_cmp_per_index_enabled = FALSE;
 
@@ -293,6 +345,10 @@ unsigned long long	srv_stats_transient_sample_pages = 8;
 my_bool		srv_stats_persistent = TRUE;
 unsigned long long	srv_stats_persistent_sample_pages = 20;
 my_bool		srv_stats_auto_recalc = TRUE;
+/* Maximum number of buckets of the column histograms that are sampled
+with the persistent statistics and saved in mysql.innodb_column_stats;
+0 disables the histograms */
+ulong		srv_stats_histogram_buckets = 0;
 
 ibool	srv_use_doublewrite_buf	= TRUE;
 
@@ -302,6 +358,10 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 ulong	srv_doublewrite_batch_size	= 120;
 
+/** number of doublewrite files that batch and single page flushes are
+spread over; 0 means the doublewrite buffer in the system tablespace */
+ulong	srv_n_doublewrite_files		= 0;
+
 ulong	srv_replication_delay		= 0;
 
 /*-------------------------------------------*/
@@ -521,6 +581,9 @@ os_event_t	srv_error_event;
 /** Event to signal the buffer pool dump/load thread */
 os_event_t	srv_buf_dump_event;
 
+/** Event to signal the buffer pool resize thread */
+os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 char*	srv_buf_dump_filename;
 
@@ -883,6 +946,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create(0);
 
+		srv_buf_resize_event = os_event_create(0);
+
 		UT_LIST_INIT(srv_sys->tasks, &que_thr_t::queue);
 	}
 
@@ -936,6 +1001,7 @@ srv_free(void)
 		os_event_destroy(srv_error_event);
 		os_event_destroy(srv_monitor_event);
 		os_event_destroy(srv_buf_dump_event);
+		os_event_destroy(srv_buf_resize_event);
 	}
 
 	trx_i_s_cache_free(trx_i_s_cache);
@@ -1146,7 +1212,7 @@ srv_printf_innodb_monitor(
 	      "-------------------------------------\n", file);
 	ibuf_print(file);
 
-	ha_print_info(file, btr_search_sys->hash_index);
+	btr_search_print_info(file);
 
 	fprintf(file,
 		"%.2f hash searches/s, %.2f non-hash searches/s\n",
@@ -1173,6 +1239,17 @@ srv_printf_innodb_monitor(
 	fprintf(file, "Dictionary memory allocated " ULINTPF "\n",
 		dict_sys->size);
 
+	ulint	cache_hits = srv_stats.n_mem_block_cache_hits;
+	ulint	cache_misses = srv_stats.n_mem_block_cache_misses;
+
+	fprintf(file,
+		"Heap block cache hits " ULINTPF ", misses " ULINTPF
+		", hit rate %.2f%%\n",
+		cache_hits, cache_misses,
+		cache_hits + cache_misses
+		? 100.0 * cache_hits / (cache_hits + cache_misses)
+		: 0.0);
+
 	buf_print_io(file);
 
 	fputs("--------------\n"
@@ -1665,6 +1742,10 @@ loop:
 	eviction policy. */
 	buf_LRU_stat_update();
 
+	/* Let innodb_adaptive_concurrency react to the throughput
+	of the last second. */
+	srv_conc_adapt();
+
 	/* In case mutex_exit is not a memory barrier, it is
 	theoretically possible some threads are left waiting though
 	the semaphore is already released. Wake up those threads: */
@@ -1777,18 +1858,26 @@ srv_any_background_threads_are_active(void)
 		thread_active = "srv_error_monitor_thread";
 	} else if (lock_sys->timeout_thread_active) {
 		thread_active = "srv_lock_timeout thread";
+	} else if (lock_sys->deadlock_thread_active) {
+		thread_active = "lock_deadlock_thread";
 	} else if (srv_monitor_active) {
 		thread_active = "srv_monitor_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_active = "buf_dump_thread";
+	} else if (srv_buf_resize_thread_active) {
+		thread_active = "buf_resize_thread";
 	} else if (srv_dict_stats_thread_active) {
 		thread_active = "dict_stats_thread";
+	} else if (log_sys->n_writer_threads > 0) {
+		thread_active = "log writer thread";
 	}
 
 	os_event_set(srv_error_event);
 	os_event_set(srv_monitor_event);
 	os_event_set(srv_buf_dump_event);
+	os_event_set(srv_buf_resize_event);
 	os_event_set(lock_sys->timeout_event);
+	os_event_set(lock_sys->deadlock_event);
 	os_event_set(dict_stats_event);
 
 	return(thread_active);
@@ -2476,17 +2565,27 @@ srv_do_purge(
 	}
 
 	do {
-		if (trx_sys->rseg_history_len > rseg_history_len
+		ulint	history_len = trx_sys->rseg_history_len;
+
+		if (history_len > rseg_history_len
 		    || (srv_max_purge_lag > 0
 			&& rseg_history_len > srv_max_purge_lag)) {
 
 			/* History length is now longer than what it was
-			when we took the last snapshot. Use more threads. */
+			when we took the last snapshot. Use more threads:
+			one more, plus one for every batch worth of undo
+			logs that the history list grew by. */
+
+			ulint	n_more = 1;
 
-			if (n_use_threads < n_threads) {
-				++n_use_threads;
+			if (history_len > rseg_history_len) {
+				n_more += (history_len - rseg_history_len)
+					/ srv_purge_batch_size;
 			}
 
+			n_use_threads = ut_min(n_use_threads + n_more,
+					       n_threads);
+
 		} else if (srv_check_activity(old_activity_count)
 			   && n_use_threads > 1) {
 
@@ -2498,6 +2597,16 @@ srv_do_purge(
 			old_activity_count = srv_get_activity_count();
 		}
 
+		/* All the undo records of a table are purged by the same
+		thread. Threads beyond the number of tables in the last
+		batch would have nothing to do. */
+
+		if (purge_sys->n_tables > 0
+		    && n_use_threads > purge_sys->n_tables) {
+
+			n_use_threads = purge_sys->n_tables;
+		}
+
 		/* Ensure that the purge threads are less than what
 		was configured. */
 
@@ -2506,6 +2615,14 @@ srv_do_purge(
 
 		/* Take a snapshot of the history list before purge. */
 		if ((rseg_history_len = trx_sys->rseg_history_len) == 0) {
+
+			/* An undo tablespace marked for truncation can be
+			truncated once its history is gone. */
+			if (trx_purge_undo_trunc_pending()) {
+				*n_total_purged += trx_purge(
+					1, srv_purge_batch_size, true);
+			}
+
 			break;
 		}
 
@@ -2818,7 +2935,8 @@ srv_is_tablespace_truncated(ulint space_id)
 		return(false);
 	}
 
-	return(truncate_t::is_tablespace_truncated(space_id));
+	return(truncate_t::is_tablespace_truncated(space_id)
+	       || trx_purge_undo_trunc_fixup_active(space_id));
 
 }
 
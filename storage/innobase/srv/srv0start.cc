@@ -153,7 +153,7 @@ static char*	srv_monitor_file_name;
 static const ulint MIN_EXPECTED_TABLESPACE_SIZE = 5 * 1024 * 1024;
 
 /** Default undo tablespace size in UNIV_PAGEs count (10MB). */
-static const ulint SRV_UNDO_TABLESPACE_SIZE_IN_PAGES =
+const ulint SRV_UNDO_TABLESPACE_SIZE_IN_PAGES =
 	((1024 * 1024) * 10) / UNIV_PAGE_SIZE_DEF;
 
 /** */
@@ -168,6 +168,7 @@ mysql_pfs_key_t	io_read_thread_key;
 mysql_pfs_key_t	io_write_thread_key;
 mysql_pfs_key_t	io_handler_thread_key;
 mysql_pfs_key_t	srv_lock_timeout_thread_key;
+mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 mysql_pfs_key_t	srv_error_monitor_thread_key;
 mysql_pfs_key_t	srv_monitor_thread_key;
 mysql_pfs_key_t	srv_master_thread_key;
@@ -277,6 +278,16 @@ DECLARE_THREAD(io_handler_thread)(
 	}
 #endif /* UNIV_PFS_THREAD */
 
+	/* Spread the read and write i/o threads over the NUMA nodes
+	of the buffer pool instances. */
+	ulint	first_rw = srv_read_only_mode ? 0 : 2;
+
+	if (segment >= first_rw + srv_n_read_io_threads) {
+		os_numa_bind_thread(segment - first_rw - srv_n_read_io_threads);
+	} else if (segment >= first_rw) {
+		os_numa_bind_thread(segment - first_rw);
+	}
+
 	while (srv_shutdown_state != SRV_SHUTDOWN_EXIT_THREADS) {
 		fil_aio_wait(segment);
 	}
@@ -931,6 +942,12 @@ srv_undo_tablespaces_init(
 		}
 	}
 
+	/* Find the undo tablespaces whose truncation was interrupted, their
+	redo log records must be ignored by the recovery. */
+	if (!create_new_db && !srv_read_only_mode) {
+		trx_purge_undo_trunc_scan(n_undo_tablespaces);
+	}
+
 	if (create_new_db) {
 		mtr_t	mtr;
 
@@ -1102,8 +1119,10 @@ srv_shutdown_all_bg_threads()
 		if (!srv_read_only_mode) {
 
 			if (srv_start_state_is_set(SRV_START_STATE_LOCK_SYS)) {
-				/* a. Let the lock timeout thread exit */
+				/* a. Let the lock timeout and deadlock
+				detector threads exit */
 				os_event_set(lock_sys->timeout_event);
+				os_event_set(lock_sys->deadlock_event);
 			}
 
 			/* b. srv error monitor thread exits automatically,
@@ -1460,11 +1479,42 @@ innobase_start_or_create_for_mysql(void)
 		}
 	}
 
+	/* The buffer pool is allocated and resized in chunks of
+	innodb_buffer_pool_chunk_size, and every instance has at least
+	one of them. */
+	if (srv_buf_pool_chunk_unit * srv_buf_pool_instances
+	    > srv_buf_pool_size) {
+
+		srv_buf_pool_chunk_unit = static_cast<ulong>(
+			srv_buf_pool_size / srv_buf_pool_instances);
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Adjusting innodb_buffer_pool_chunk_size to %lu"
+			" since it cannot exceed innodb_buffer_pool_size"
+			" / innodb_buffer_pool_instances",
+			srv_buf_pool_chunk_unit);
+	}
+
+	srv_buf_pool_size = buf_pool_size_align(srv_buf_pool_size);
+
+	/* By default use one page_cleaner thread per buffer pool
+	instance. More threads than instances would have nothing to do. */
+	if (srv_n_page_cleaners == SRV_N_PAGE_CLEANERS_NOT_SET) {
+		srv_n_page_cleaners = srv_buf_pool_instances;
+	} else if (srv_n_page_cleaners > srv_buf_pool_instances) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Adjusting innodb_page_cleaners from %lu to %lu"
+			" since it cannot exceed"
+			" innodb_buffer_pool_instances",
+			srv_n_page_cleaners, srv_buf_pool_instances);
+
+		srv_n_page_cleaners = srv_buf_pool_instances;
+	}
+
 	srv_boot();
 
 	ib_logf(IB_LOG_LEVEL_INFO,
-		"%s CPU crc32 instructions",
-		ut_crc32_sse2_enabled ? "Using" : "Not using");
+		"Using %s crc32 implementation", ut_crc32_implementation);
 
 	if (!srv_read_only_mode) {
 
@@ -2008,6 +2058,14 @@ files_checked:
 			return(srv_init_abort(err));
 		}
 
+		/* Reinitialise the undo tablespaces whose truncation was
+		interrupted before their rollback segments are loaded. */
+		err = trx_purge_undo_trunc_fixup();
+
+		if (err != DB_SUCCESS) {
+			return(srv_init_abort(err));
+		}
+
 		purge_queue = trx_sys_init_at_db_start();
 		n_recovered_trx = UT_LIST_GET_LEN(trx_sys->rw_trx_list);
 
@@ -2058,6 +2116,8 @@ files_checked:
 			return(srv_init_abort(err));
 		}
 
+		trx_purge_undo_trunc_fixup_done();
+
 		if (!srv_force_recovery
 		    && !recv_sys->found_corrupt_log
 		    && (srv_log_file_size_requested != srv_log_file_size
@@ -2230,6 +2290,10 @@ files_checked:
 			lock_wait_timeout_thread,
 			NULL, thread_ids + 2 + SRV_MAX_N_IO_THREADS);
 
+		/* Create the thread which resolves deadlocks for lock
+		waits when innodb_deadlock_detect_async is set */
+		os_thread_create(lock_deadlock_thread, NULL, NULL);
+
 		/* Create the thread which warns of long semaphore waits */
 		os_thread_create(
 			srv_error_monitor_thread,
@@ -2296,7 +2360,27 @@ files_checked:
 	}
 
 	if (!srv_read_only_mode) {
-		os_thread_create(buf_flush_page_cleaner_thread, NULL, NULL);
+		log_writer_threads_start();
+
+		buf_flush_page_cleaner_init();
+
+		os_thread_create(buf_flush_page_cleaner_coordinator,
+				 NULL, NULL);
+
+		for (i = 1; i < srv_n_page_cleaners; ++i) {
+			os_thread_create(buf_flush_page_cleaner_worker,
+					 NULL, NULL);
+		}
+
+		/* One LRU manager per buffer pool instance keeps the
+		free lists filled. */
+		buf_flush_lru_manager_init();
+
+		for (i = 0; i < srv_buf_pool_instances; ++i) {
+			os_thread_create(buf_flush_lru_manager_thread,
+					 buf_flush_lru_manager_get_slot(i),
+					 NULL);
+		}
 	}
 
 	sum_of_data_file_sizes = srv_sys_space.get_sum_of_sizes();
@@ -2444,6 +2528,9 @@ files_checked:
 		/* Create the buffer pool dump/load thread */
 		os_thread_create(buf_dump_thread, NULL, NULL);
 
+		/* Create the buffer pool resize thread */
+		os_thread_create(buf_resize_thread, NULL, NULL);
+
 		/* Create the dict stats gathering thread */
 		os_thread_create(dict_stats_thread, NULL, NULL);
 
@@ -2472,7 +2559,7 @@ srv_fts_close(void)
 		fts_t*          fts = table->fts;
 
 		if (fts != NULL) {
-			fts_sync_table(table);
+			fts_sync_table(table, false);
 		}
 	}
 
@@ -2481,7 +2568,7 @@ srv_fts_close(void)
 		fts_t*          fts = table->fts;
 
 		if (fts != NULL) {
-			fts_sync_table(table);
+			fts_sync_table(table, false);
 		}
 	}
 }
@@ -578,9 +578,9 @@ SyncDebug::check_order(const latch_t* latch)
 	case SYNC_ANY_LATCH:
 	case SYNC_FILE_FORMAT_TAG:
 	case SYNC_DOUBLEWRITE:
-	case SYNC_SEARCH_SYS:
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
+	case SYNC_LOCK_REC_HASH:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_TRX_SYS:
 	case SYNC_IBUF_BITMAP_MUTEX:
@@ -592,6 +592,7 @@ SyncDebug::check_order(const latch_t* latch)
 	case SYNC_DICT_AUTOINC_MUTEX:
 	case SYNC_DICT_OPERATION:
 	case SYNC_DICT_HEADER:
+	case SYNC_DICT_TABLE_HASH:
 	case SYNC_TRX_I_S_RWLOCK:
 	case SYNC_TRX_I_S_LAST_READ:
 	case SYNC_IBUF_MUTEX:
@@ -605,7 +606,7 @@ SyncDebug::check_order(const latch_t* latch)
 
 	case SYNC_TRX:
 
-		/* Either the thread must own the lock_sys->mutex, or
+		/* Either the thread must hold the lock_sys->latch, or
 		it is allowed to own only ONE trx_t::mutex. */
 
 		if (less(latches, latch->m_level) != 0) {
@@ -616,6 +617,7 @@ SyncDebug::check_order(const latch_t* latch)
 
 	case SYNC_BUF_FLUSH_LIST:
 	case SYNC_BUF_POOL:
+	case SYNC_SEARCH_SYS:
 
 		/* We can have multiple mutexes of this type therefore we
 		can only check whether the greater than condition holds. */
@@ -927,6 +929,10 @@ sync_latch_meta_init()
 		  SYNC_IBUF_PESS_INSERT_MUTEX,
 		  ibuf_pessimistic_insert_mutex_key);
 
+	LATCH_ADD(SrvLatches, "ibuf_index_size",
+		  SYNC_NO_ORDER_CHECK,
+		  PFS_NOT_INSTRUMENTED);
+
 	LATCH_ADD(SrvLatches, "log_sys",
 		  SYNC_LOG,
 		  log_sys_mutex_key);
@@ -1025,6 +1031,10 @@ sync_latch_meta_init()
 		  SYNC_DOUBLEWRITE,
 		  buf_dblwr_mutex_key);
 
+	LATCH_ADD(SrvLatches, "page_cleaner",
+		  SYNC_NO_ORDER_CHECK,
+		  page_cleaner_mutex_key);
+
 	LATCH_ADD(SrvLatches, "trx_undo",
 		  SYNC_TRX_UNDO,
 		  trx_undo_mutex_key);
@@ -1041,9 +1051,9 @@ sync_latch_meta_init()
 		  SYNC_TRX,
 		  trx_mutex_key);
 
-	LATCH_ADD(SrvLatches, "lock_sys",
-		  SYNC_LOCK_SYS,
-		  lock_mutex_key);
+	LATCH_ADD(SrvLatches, "lock_rec_hash",
+		  SYNC_LOCK_REC_HASH,
+		  lock_rec_hash_mutex_key);
 
 	LATCH_ADD(SrvLatches, "lock_sys_wait",
 		  SYNC_LOCK_WAIT_SYS,
@@ -1071,6 +1081,10 @@ sync_latch_meta_init()
 		  srv_conc_mutex_key);
 #endif /* !HAVE_ATOMIC_BUILTINS */
 
+	LATCH_ADD(SrvLatches, "monitor_fold",
+		  SYNC_NO_ORDER_CHECK,
+		  PFS_NOT_INSTRUMENTED);
+
 #ifndef HAVE_ATOMIC_BUILTINS_64
 	LATCH_ADD(SrvLatches, "monitor",
 		  SYNC_MONITOR_MUTEX,
@@ -1137,6 +1151,14 @@ sync_latch_meta_init()
 		  SYNC_WORK_QUEUE,
 		  PFS_NOT_INSTRUMENTED);
 
+	LATCH_ADD(SrvLatches, "row_merge_psort",
+		  SYNC_NO_ORDER_CHECK,
+		  PFS_NOT_INSTRUMENTED);
+
+	LATCH_ADD(SrvLatches, "parallel_read",
+		  SYNC_NO_ORDER_CHECK,
+		  PFS_NOT_INSTRUMENTED);
+
 	// Add the RW locks
 #ifdef UNIV_LOG_ARCHIVE
 	LATCH_ADD(SrvLatches, "archive",
@@ -1186,6 +1208,10 @@ sync_latch_meta_init()
 		  SYNC_PURGE_LATCH,
 		  trx_purge_latch_key);
 
+	LATCH_ADD(SrvLatches, "lock_sys",
+		  SYNC_LOCK_SYS,
+		  lock_sys_latch_key);
+
 	LATCH_ADD(SrvLatches, "ibuf_index_tree",
 		  SYNC_IBUF_INDEX_TREE,
 		  index_tree_rw_lock_key);
@@ -1201,6 +1227,10 @@ sync_latch_meta_init()
 	LATCH_ADD(SrvLatches, "hash_table_rw_lock",
 		  SYNC_BUF_PAGE_HASH,
 		  hash_table_locks_key);
+
+	LATCH_ADD(SrvLatches, "dict_table_hash",
+		  SYNC_DICT_TABLE_HASH,
+		  hash_table_locks_key);
 }
 
 /**
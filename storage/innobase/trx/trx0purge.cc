@@ -31,8 +31,10 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0purge.ic"
 #endif
 
+#include "buf0lru.h"
 #include "fsp0fsp.h"
 #include "fut0fut.h"
+#include "log0log.h"
 #include "mach0data.h"
 #include "mtr0log.h"
 #include "os0thread.h"
@@ -50,6 +52,9 @@ Created 3/26/1996 Heikki Tuuri
 #include "trx0rseg.h"
 #include "trx0trx.h"
 
+#include <map>
+#include <vector>
+
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 ulong		srv_max_purge_lag = 0;
 
@@ -1037,6 +1042,16 @@ trx_purge_attach_undo_recs(
 	ulint		n_pages_handled = 0;
 	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
 
+	typedef std::map<table_id_t, ulint>	table_thr_map_t;
+
+	/* The purge threads in use, and the number of undo records that
+	were given to each of them */
+	std::vector<que_thr_t*>	thrs;
+	std::vector<ulint>	n_recs;
+
+	/* The thread that each table of the batch was given to */
+	table_thr_map_t		table_thrs;
+
 	ut_a(n_purge_threads > 0);
 
 	purge_sys->limit = purge_sys->iter;
@@ -1056,6 +1071,9 @@ trx_purge_attach_undo_recs(
 		ut_a(node->done);
 
 		node->done = FALSE;
+
+		thrs.push_back(thr);
+		n_recs.push_back(0);
 	}
 
 	/* There should never be fewer nodes than threads, the inverse
@@ -1063,26 +1081,30 @@ trx_purge_attach_undo_recs(
 	ut_a(i == n_purge_threads);
 
 	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
-	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
-	ut_a(n_thrs > 0 && thr != NULL);
+	to a per purge node vector. All the records of a table go to the
+	same purge node, so that no two purge threads work on the same
+	indexes; each new table goes to the node that has the fewest
+	records so far. The records of a table stay in undo log order. */
+	ut_a(n_thrs > 0);
 
 	ut_ad(trx_purge_check_limit());
 
-	i = 0;
+	/* The records are read into this heap first, and copied to the
+	heap of their purge node once their table is known. */
+	mem_heap_t*	heap = mem_heap_create(1024);
 
 	for (;;) {
 		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
+		trx_purge_rec_t		purge_rec;
+		ulint			least = 0;
 
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
+		for (i = 1; i < n_purge_threads; ++i) {
+			if (n_recs[i] < n_recs[least]) {
+				least = i;
+			}
+		}
 
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		mem_heap_empty(heap);
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1092,39 +1114,70 @@ trx_purge_attach_undo_recs(
 		}
 
 		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled, heap);
 
-		if (purge_rec->undo_rec != NULL) {
+		if (purge_rec.undo_rec == NULL) {
+			break;
+		}
 
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		ulint	n = least;
 
-			ib_vector_push(node->undo_recs, purge_rec);
+		if (purge_rec.undo_rec != &trx_purge_dummy_rec) {
+			ulint		type;
+			ulint		cmpl_info;
+			bool		updated_extern;
+			undo_no_t	undo_no;
+			table_id_t	table_id;
 
-			if (n_pages_handled >= batch_size) {
+			trx_undo_rec_get_pars(
+				purge_rec.undo_rec, &type, &cmpl_info,
+				&updated_extern, &undo_no, &table_id);
 
-				break;
-			}
-		} else {
-			break;
+			std::pair<table_thr_map_t::iterator, bool>	ins
+				= table_thrs.insert(
+					table_thr_map_t::value_type(
+						table_id, least));
+
+			n = ins.first->second;
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		thr = thrs[n];
+
+		ut_a(!thr->is_active);
+
+		/* Get the purge node. */
+		node = (purge_node_t*) thr->child;
+		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+		if (purge_rec.undo_rec != &trx_purge_dummy_rec) {
+			purge_rec.undo_rec = trx_undo_rec_copy(
+				purge_rec.undo_rec, node->heap);
 		}
 
-		ut_a(thr != NULL);
+		if (node->undo_recs == NULL) {
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
+		} else {
+			ut_a(!ib_vector_is_empty(node->undo_recs));
+		}
+
+		ib_vector_push(node->undo_recs, &purge_rec);
+
+		++n_recs[n];
+
+		if (n_pages_handled >= batch_size) {
+
+			break;
+		}
 	}
 
+	mem_heap_free(heap);
+
+	purge_sys->n_tables = table_thrs.size();
+
 	ut_ad(trx_purge_check_limit());
 
 	return(n_pages_handled);
@@ -1217,6 +1270,487 @@ trx_purge_wait_for_workers_to_complete(
 	ut_a(srv_get_task_queue_length() == 0);
 }
 
+/** Magic number written to the truncate log file of an undo tablespace
+when the truncation is complete, so that a log file whose removal failed is
+not acted upon at the next startup. */
+static const ib_uint32_t	undo_trunc_magic = 76845412;
+
+/** Undo tablespace marked for truncation, or ULINT_UNDEFINED. This is
+only accessed by the purge coordinator thread. */
+static ulint			undo_trunc_space = ULINT_UNDEFINED;
+
+/** The undo tablespace that was truncated last, so that the undo
+tablespaces take turns */
+static ulint			undo_trunc_last_space = 0;
+
+/** Undo tablespaces whose truncation is completed at startup */
+typedef std::vector<ulint>	undo_trunc_spaces_t;
+static undo_trunc_spaces_t	undo_trunc_fixup_spaces;
+
+/********************************************************************//**
+Build the name of the truncate log file of an undo tablespace. */
+static
+void
+trx_purge_undo_trunc_log_name(
+/*==========================*/
+	ulint	space_id,	/*!< in: undo tablespace id */
+	char*	name,		/*!< out: file name */
+	ulint	len)		/*!< in: size of name */
+{
+	ulint	dir_len = strlen(srv_log_group_home_dir);
+	bool	add_sep = dir_len > 0
+		&& srv_log_group_home_dir[dir_len - 1] != SRV_PATH_SEPARATOR;
+
+	if (add_sep) {
+		ut_snprintf(name, len, "%s%cundo_%lu_trunc.log",
+			    srv_log_group_home_dir, SRV_PATH_SEPARATOR,
+			    (ulong) space_id);
+	} else {
+		ut_snprintf(name, len, "%sundo_%lu_trunc.log",
+			    srv_log_group_home_dir, (ulong) space_id);
+	}
+}
+
+/********************************************************************//**
+Create the truncate log file of an undo tablespace. While the file exists
+the redo log records of the tablespace are ignored at startup and the
+tablespace is reinitialised instead.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+trx_purge_undo_trunc_log_write(
+/*===========================*/
+	ulint	space_id)	/*!< in: undo tablespace id */
+{
+	char	name[OS_FILE_MAX_PATH];
+
+	trx_purge_undo_trunc_log_name(space_id, name, sizeof(name));
+
+	ibool		ret;
+	os_file_t	handle = os_file_create(
+		innodb_log_file_key, name, OS_FILE_CREATE, OS_FILE_NORMAL,
+		OS_LOG_FILE, &ret);
+
+	if (!ret) {
+		return(DB_IO_ERROR);
+	}
+
+	void*	buf = mem_zalloc(2 * UNIV_PAGE_SIZE);
+
+	/* Align the memory for file i/o if we might have O_DIRECT set */
+	byte*	log_buf = static_cast<byte*>(ut_align(buf, UNIV_PAGE_SIZE));
+
+	/* The first 4 bytes are reserved for the magic number, which is
+	written when the truncation is complete. */
+	mach_write_to_4(log_buf + 4, space_id);
+
+	ret = os_file_write(name, handle, log_buf, 0, UNIV_PAGE_SIZE);
+
+	if (ret) {
+		ret = os_file_flush(handle);
+	}
+
+	os_file_close(handle);
+
+	mem_free(buf);
+
+	if (!ret) {
+		os_file_delete(innodb_log_file_key, name);
+
+		return(DB_IO_ERROR);
+	}
+
+	return(DB_SUCCESS);
+}
+
+/********************************************************************//**
+Mark the truncation of an undo tablespace complete and remove its truncate
+log file. The magic number protects against file system anomalies in the
+removal of the file. */
+static
+void
+trx_purge_undo_trunc_log_done(
+/*==========================*/
+	ulint	space_id)	/*!< in: undo tablespace id */
+{
+	char	name[OS_FILE_MAX_PATH];
+
+	trx_purge_undo_trunc_log_name(space_id, name, sizeof(name));
+
+	ibool		ret;
+	os_file_t	handle = os_file_create_simple_no_error_handling(
+		innodb_log_file_key, name, OS_FILE_OPEN,
+		OS_FILE_READ_WRITE, &ret);
+
+	if (ret) {
+		byte	buffer[sizeof(undo_trunc_magic)];
+
+		mach_write_to_4(buffer, undo_trunc_magic);
+
+		os_file_write(name, handle, buffer, 0, sizeof(buffer));
+		os_file_flush(handle);
+		os_file_close(handle);
+	}
+
+	DBUG_EXECUTE_IF("ib_undo_trunc_crash_before_log_removal",
+			DBUG_SUICIDE(););
+
+	os_file_delete(innodb_log_file_key, name);
+}
+
+/********************************************************************//**
+Re-create the file space header and the rollback segment headers of an
+undo tablespace that has been truncated to the given size.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+trx_purge_undo_trunc_reinit(
+/*========================*/
+	ulint	space_id,	/*!< in: undo tablespace id */
+	ulint	size,		/*!< in: size of the tablespace in pages */
+	bool	fix_up)		/*!< in: true if completing an interrupted
+				truncation at startup; the rollback segments
+				are then found in the trx system header and
+				the changes are not redo logged */
+{
+	mtr_t	mtr;
+
+	mtr_start(&mtr);
+
+	if (fix_up) {
+		mtr_set_log_mode(&mtr, MTR_LOG_NO_REDO);
+	}
+
+	fsp_header_init(space_id, size, &mtr);
+
+	mtr_commit(&mtr);
+
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		ulint		page_no;
+		trx_rseg_t*	rseg = NULL;
+
+		if (trx_sys_is_noredo_rseg_slot(i)) {
+			continue;
+		}
+
+		mtr_start(&mtr);
+
+		if (fix_up) {
+			mtr_set_log_mode(&mtr, MTR_LOG_NO_REDO);
+		}
+
+		/* To obey the latching order, acquire the file space
+		x-latch before the trx system header. */
+		mtr_x_lock(fil_space_get_latch(space_id, NULL), &mtr);
+
+		if (fix_up) {
+			trx_sysf_t*	sys_header = trx_sysf_get(&mtr);
+
+			if (trx_sysf_rseg_get_page_no(sys_header, i, &mtr)
+			    == FIL_NULL
+			    || trx_sysf_rseg_get_space(sys_header, i, &mtr)
+			    != space_id) {
+
+				mtr_commit(&mtr);
+				continue;
+			}
+
+			page_no = trx_rseg_header_create(
+				space_id, 0, ULINT_MAX, i, &mtr);
+		} else {
+			rseg = trx_sys->rseg_array[i];
+
+			if (rseg == NULL || rseg->space != space_id) {
+
+				mtr_commit(&mtr);
+				continue;
+			}
+
+			page_no = trx_rseg_header_create(
+				space_id, rseg->zip_size, rseg->max_size,
+				i, &mtr);
+		}
+
+		mtr_commit(&mtr);
+
+		if (page_no == FIL_NULL) {
+			ib_logf(IB_LOG_LEVEL_ERROR,
+				"Failed to re-create rollback segment %lu"
+				" in undo tablespace %lu.",
+				(ulong) i, (ulong) space_id);
+
+			return(DB_OUT_OF_FILE_SPACE);
+		}
+
+		if (rseg != NULL) {
+			trx_rseg_mem_reset(rseg, page_no);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+
+/********************************************************************//**
+Set or clear the skip_allocation flag of the rollback segments residing
+in an undo tablespace. */
+static
+void
+trx_purge_undo_set_skip_allocation(
+/*===============================*/
+	ulint	space_id,	/*!< in: undo tablespace id */
+	bool	skip)		/*!< in: value of the flag */
+{
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg != NULL && rseg->space == space_id) {
+			mutex_enter(&rseg->mutex);
+			rseg->skip_allocation = skip;
+			mutex_exit(&rseg->mutex);
+		}
+	}
+}
+
+/********************************************************************//**
+Mark an undo tablespace that has grown beyond srv_max_undo_log_size for
+truncation, so that its rollback segments are no longer assigned to new
+transactions and purge can drain it. A tablespace is only marked if the
+transactions can keep allocating from the rollback segments of another
+undo tablespace. */
+static
+void
+trx_purge_mark_undo_for_truncate(void)
+/*==================================*/
+{
+	ut_ad(undo_trunc_space == ULINT_UNDEFINED);
+
+	ulint	n_spaces = srv_undo_tablespaces_open;
+
+	if (n_spaces < 2) {
+		return;
+	}
+
+	/* Find the undo tablespaces holding rollback segments and those
+	that the rollback segment assignment round robin uses. */
+	bool	has_rsegs[TRX_SYS_N_RSEGS + 1];
+	bool	in_use[TRX_SYS_N_RSEGS + 1];
+	ulint	n_in_use = 0;
+
+	memset(has_rsegs, 0x0, sizeof(has_rsegs));
+	memset(in_use, 0x0, sizeof(in_use));
+
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		const trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg == NULL
+		    || rseg->space == srv_sys_space.space_id()
+		    || rseg->space == srv_tmp_space.space_id()
+		    || rseg->space > n_spaces) {
+
+			continue;
+		}
+
+		has_rsegs[rseg->space] = true;
+
+		if (i < srv_undo_logs && !in_use[rseg->space]) {
+			in_use[rseg->space] = true;
+			++n_in_use;
+		}
+	}
+
+	for (ulint i = 1; i <= n_spaces; ++i) {
+		ulint	space_id = (undo_trunc_last_space + i - 1)
+			% n_spaces + 1;
+
+		if (!has_rsegs[space_id]) {
+			continue;
+		}
+
+		/* At least one other undo tablespace must stay active. */
+		if (n_in_use - (in_use[space_id] ? 1 : 0) == 0) {
+			continue;
+		}
+
+		ulint	size = fil_space_get_size(space_id);
+
+		if ((ib_uint64_t) size * UNIV_PAGE_SIZE
+		    <= srv_max_undo_log_size) {
+			continue;
+		}
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Marking undo tablespace %lu of %lu pages"
+			" for truncation.",
+			(ulong) space_id, (ulong) size);
+
+		trx_purge_undo_set_skip_allocation(space_id, true);
+
+		undo_trunc_space = space_id;
+
+		return;
+	}
+}
+
+/********************************************************************//**
+Check whether the rollback segments of the undo tablespace marked for
+truncation are drained: no transaction uses them and their history has
+been purged.
+@return true if the tablespace can be truncated */
+static
+bool
+trx_purge_undo_is_drained(void)
+/*===========================*/
+{
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg == NULL || rseg->space != undo_trunc_space) {
+			continue;
+		}
+
+		mtr_t	mtr;
+
+		mtr_start(&mtr);
+		mutex_enter(&rseg->mutex);
+
+		ut_ad(rseg->skip_allocation);
+
+		bool	drained = rseg->trx_ref_count == 0
+			&& UT_LIST_GET_LEN(rseg->update_undo_list) == 0
+			&& UT_LIST_GET_LEN(rseg->insert_undo_list) == 0
+			&& rseg->last_page_no == FIL_NULL;
+
+		if (drained) {
+			trx_rsegf_t*	rseg_hdr = trx_rsegf_get(
+				rseg->space, rseg->zip_size,
+				rseg->page_no, &mtr);
+
+			drained = flst_get_len(
+				rseg_hdr + TRX_RSEG_HISTORY, &mtr) == 0;
+		}
+
+		mutex_exit(&rseg->mutex);
+		mtr_commit(&mtr);
+
+		if (!drained) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/********************************************************************//**
+Truncate the undo tablespace marked for truncation back to its initial
+size once purge has drained it, and make its rollback segments available
+again. NOTE that when this function is called, the caller must not have
+any latches on undo log pages! */
+static
+void
+trx_purge_truncate_undo_space(void)
+/*===============================*/
+{
+	if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+		return;
+	}
+
+	if (undo_trunc_space == ULINT_UNDEFINED) {
+
+		if (!srv_undo_log_truncate) {
+			return;
+		}
+
+		trx_purge_mark_undo_for_truncate();
+
+		if (undo_trunc_space == ULINT_UNDEFINED) {
+			return;
+		}
+
+	} else if (!srv_undo_log_truncate) {
+
+		/* Truncation was disabled after the tablespace was
+		marked. */
+		trx_purge_undo_set_skip_allocation(undo_trunc_space, false);
+
+		undo_trunc_space = ULINT_UNDEFINED;
+
+		return;
+	}
+
+	if (!trx_purge_undo_is_drained()) {
+		return;
+	}
+
+	ulint	space_id = undo_trunc_space;
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Truncating undo tablespace %lu.", (ulong) space_id);
+
+	if (trx_purge_undo_trunc_log_write(space_id) != DB_SUCCESS) {
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Unable to create the truncate log file of undo"
+			" tablespace %lu. Skipping the truncation.",
+			(ulong) space_id);
+
+		trx_purge_undo_set_skip_allocation(space_id, false);
+
+		undo_trunc_space = ULINT_UNDEFINED;
+		undo_trunc_last_space = space_id;
+
+		return;
+	}
+
+	DBUG_EXECUTE_IF("ib_undo_trunc_crash_after_log_write",
+			DBUG_SUICIDE(););
+
+	/* Nothing in the tablespace is needed any more. Discard its
+	pages, their changes will not be written back. */
+	buf_LRU_flush_or_remove_pages(space_id, BUF_REMOVE_ALL_NO_WRITE, 0);
+
+	ulint	size = SRV_UNDO_TABLESPACE_SIZE_IN_PAGES;
+
+	if (!fil_truncate_tablespace(space_id, size)) {
+
+		/* Reinitialise the tablespace at its current size, so
+		that the rollback segments are usable again. */
+		size = fil_space_get_size(space_id);
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Unable to shrink undo tablespace %lu. It is emptied"
+			" but keeps its size of %lu pages.",
+			(ulong) space_id, (ulong) size);
+	}
+
+	DBUG_EXECUTE_IF("ib_undo_trunc_crash_after_truncate",
+			DBUG_SUICIDE(););
+
+	dberr_t	err = trx_purge_undo_trunc_reinit(space_id, size, false);
+
+	/* The initial size of an undo tablespace always has room for the
+	rollback segment headers that it held when it was created. */
+	ut_a(err == DB_SUCCESS);
+
+	DBUG_EXECUTE_IF("ib_undo_trunc_crash_before_checkpoint",
+			DBUG_SUICIDE(););
+
+	/* Make the reinitialised pages durable and move the checkpoint
+	past the redo log records written before the truncation, which
+	must never be applied to the new tablespace. */
+	log_make_checkpoint_at(LSN_MAX, TRUE);
+
+	trx_purge_undo_trunc_log_done(space_id);
+
+	trx_purge_undo_set_skip_allocation(space_id, false);
+
+	undo_trunc_space = ULINT_UNDEFINED;
+	undo_trunc_last_space = space_id;
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Completed truncation of undo tablespace %lu.",
+		(ulong) space_id);
+}
+
 /******************************************************************//**
 Remove old historical changes from the rollback segments. */
 static
@@ -1231,6 +1765,8 @@ trx_purge_truncate(void)
 	} else {
 		trx_purge_truncate_history(&purge_sys->limit, &purge_sys->view);
 	}
+
+	trx_purge_truncate_undo_space();
 }
 
 /*******************************************************************//**
@@ -1471,3 +2007,183 @@ trx_purge_run(void)
 
 	srv_purge_wakeup();
 }
+
+/*******************************************************************//**
+Check whether an undo tablespace is marked for truncation and purge
+should keep calling the history truncation until it has been truncated.
+@return true if an undo tablespace is marked for truncation */
+
+bool
+trx_purge_undo_trunc_pending(void)
+/*==============================*/
+{
+	return(undo_trunc_space != ULINT_UNDEFINED);
+}
+
+/*******************************************************************//**
+Look for the truncate log files of undo tablespaces whose truncation was
+interrupted by a crash. Redo log records of such tablespaces are ignored
+during recovery and the truncation is completed by
+trx_purge_undo_trunc_fixup(). This is called before the redo log is
+applied. */
+
+void
+trx_purge_undo_trunc_scan(
+/*======================*/
+	ulint	n_undo_tablespaces)	/*!< in: number of open undo
+					tablespaces */
+{
+	ut_ad(undo_trunc_fixup_spaces.empty());
+
+	for (ulint space_id = 1; space_id <= n_undo_tablespaces; ++space_id) {
+		char		name[OS_FILE_MAX_PATH];
+		ibool		exists;
+		os_file_type_t	type;
+
+		trx_purge_undo_trunc_log_name(space_id, name, sizeof(name));
+
+		if (!os_file_status(name, &exists, &type) || !exists) {
+			continue;
+		}
+
+		ibool		ret;
+		os_file_t	handle = os_file_create_simple_no_error_handling(
+			innodb_log_file_key, name, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, &ret);
+
+		if (!ret) {
+			continue;
+		}
+
+		byte	buffer[8];
+		bool	done = true;
+
+		if (os_file_get_size(handle) >= sizeof(buffer)
+		    && os_file_read(handle, buffer, 0, sizeof(buffer))) {
+
+			done = mach_read_from_4(buffer) == undo_trunc_magic
+				|| mach_read_from_4(buffer + 4) != space_id;
+		}
+
+		os_file_close(handle);
+
+		if (done) {
+			/* Either the truncation did not start because the
+			log file was not written completely, or it completed
+			but the file was not removed. */
+			os_file_delete(innodb_log_file_key, name);
+			continue;
+		}
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Undo tablespace %lu was being truncated. The"
+			" truncation will be completed after recovery.",
+			(ulong) space_id);
+
+		undo_trunc_fixup_spaces.push_back(space_id);
+	}
+}
+
+/*******************************************************************//**
+Check whether the truncation of an undo tablespace is being completed
+at startup.
+@return true if the tablespace is being fixed up */
+
+bool
+trx_purge_undo_trunc_fixup_active(
+/*==============================*/
+	ulint	space_id)		/*!< in: tablespace id */
+{
+	undo_trunc_spaces_t::const_iterator	end
+		= undo_trunc_fixup_spaces.end();
+
+	for (undo_trunc_spaces_t::const_iterator it
+		= undo_trunc_fixup_spaces.begin();
+	     it != end;
+	     ++it) {
+
+		if (*it == space_id) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/*******************************************************************//**
+Complete the truncation of the undo tablespaces found by
+trx_purge_undo_trunc_scan(): reinitialise the tablespaces and their
+rollback segment headers. This must be called after redo log recovery and
+before the rollback segments are loaded by trx_sys_init_at_db_start().
+@return DB_SUCCESS or error code */
+
+dberr_t
+trx_purge_undo_trunc_fixup(void)
+/*============================*/
+{
+	undo_trunc_spaces_t::const_iterator	end
+		= undo_trunc_fixup_spaces.end();
+
+	for (undo_trunc_spaces_t::const_iterator it
+		= undo_trunc_fixup_spaces.begin();
+	     it != end;
+	     ++it) {
+
+		ulint	space_id = *it;
+		ulint	size = SRV_UNDO_TABLESPACE_SIZE_IN_PAGES;
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Completing truncation of undo tablespace %lu.",
+			(ulong) space_id);
+
+		buf_LRU_flush_or_remove_pages(
+			space_id, BUF_REMOVE_ALL_NO_WRITE, 0);
+
+		if (!fil_truncate_tablespace(space_id, size)) {
+			size = fil_space_get_size(space_id);
+		}
+
+		dberr_t	err = trx_purge_undo_trunc_reinit(
+			space_id, size, true);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	return(DB_SUCCESS);
+}
+
+/*******************************************************************//**
+Make the completed truncations durable with a checkpoint and remove their
+truncate log files. This must be called after redo log recovery has
+finished. */
+
+void
+trx_purge_undo_trunc_fixup_done(void)
+/*=================================*/
+{
+	if (undo_trunc_fixup_spaces.empty()) {
+		return;
+	}
+
+	/* The reinitialised pages were not redo logged. */
+	log_make_checkpoint_at(LSN_MAX, TRUE);
+
+	undo_trunc_spaces_t::const_iterator	end
+		= undo_trunc_fixup_spaces.end();
+
+	for (undo_trunc_spaces_t::const_iterator it
+		= undo_trunc_fixup_spaces.begin();
+	     it != end;
+	     ++it) {
+
+		trx_purge_undo_trunc_log_done(*it);
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Completed truncation of undo tablespace %lu.",
+			(ulong) *it);
+	}
+
+	undo_trunc_fixup_spaces.clear();
+}
@@ -115,24 +115,16 @@ trx_rseg_header_create(
 }
 
 /***********************************************************************//**
-Free's an instance of the rollback segment in memory. */
-
+Free the cached undo log segments of a rollback segment. */
+static
 void
-trx_rseg_mem_free(
-/*==============*/
-	trx_rseg_t*	rseg,		/* in, own: instance to free */
-	trx_rseg_t**	rseg_array)	/*!< out: add rseg reference to this
-					central array. */
+trx_rseg_free_cached(
+/*=================*/
+	trx_rseg_t*	rseg)		/*!< in/out: rollback segment */
 {
 	trx_undo_t*	undo;
 	trx_undo_t*	next_undo;
 
-	mutex_free(&rseg->mutex);
-
-	/* There can't be any active transactions. */
-	ut_a(UT_LIST_GET_LEN(rseg->update_undo_list) == 0);
-	ut_a(UT_LIST_GET_LEN(rseg->insert_undo_list) == 0);
-
 	for (undo = UT_LIST_GET_FIRST(rseg->update_undo_cached);
 	     undo != NULL;
 	     undo = next_undo) {
@@ -158,6 +150,25 @@ trx_rseg_mem_free(
 
 		trx_undo_mem_free(undo);
 	}
+}
+
+/***********************************************************************//**
+Free's an instance of the rollback segment in memory. */
+
+void
+trx_rseg_mem_free(
+/*==============*/
+	trx_rseg_t*	rseg,		/* in, own: instance to free */
+	trx_rseg_t**	rseg_array)	/*!< out: add rseg reference to this
+					central array. */
+{
+	mutex_free(&rseg->mutex);
+
+	/* There can't be any active transactions. */
+	ut_a(UT_LIST_GET_LEN(rseg->update_undo_list) == 0);
+	ut_a(UT_LIST_GET_LEN(rseg->insert_undo_list) == 0);
+
+	trx_rseg_free_cached(rseg);
 
 	ut_a(*((trx_rseg_t**) rseg_array + rseg->id) == rseg);
 	*((trx_rseg_t**) rseg_array + rseg->id) = NULL;
@@ -165,6 +176,38 @@ trx_rseg_mem_free(
 	mem_free(rseg);
 }
 
+/***************************************************************************
+Reset the memory object of a rollback segment whose undo tablespace was
+truncated and whose header was re-created. The rollback segment must not
+be in use by any transaction or by purge. */
+
+void
+trx_rseg_mem_reset(
+/*===============*/
+	trx_rseg_t*	rseg,		/*!< in/out: rollback segment */
+	ulint		page_no)	/*!< in: page number of the new
+					rollback segment header */
+{
+	mutex_enter(&rseg->mutex);
+
+	ut_a(rseg->trx_ref_count == 0);
+	ut_a(UT_LIST_GET_LEN(rseg->update_undo_list) == 0);
+	ut_a(UT_LIST_GET_LEN(rseg->insert_undo_list) == 0);
+
+	/* The cached undo log segments were freed with the tablespace. */
+	trx_rseg_free_cached(rseg);
+
+	rseg->page_no = page_no;
+	rseg->curr_size = 1;
+
+	rseg->last_page_no = FIL_NULL;
+	rseg->last_offset = 0;
+	rseg->last_trx_no = 0;
+	rseg->last_del_marks = FALSE;
+
+	mutex_exit(&rseg->mutex);
+}
+
 /***************************************************************************
 Creates and initializes a rollback segment object. The values for the
 fields are read from the header. The object is inserted to the rseg
@@ -116,6 +116,8 @@ trx_init(
 
 	trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 
+	trx->search_latch = NULL;
+
 	trx->dict_operation = TRX_DICT_OP_NONE;
 
 	trx->table_id = 0;
@@ -277,6 +279,7 @@ struct TrxFactory {
 
 		ut_a(trx->lock.wait_thr == NULL);
 		ut_a(trx->lock.wait_lock == NULL);
+		ut_a(!trx->lock.in_deadlock_list);
 
 		ut_a(!trx->has_search_latch);
 
@@ -711,6 +714,7 @@ trx_resurrect_insert(
 	ut_d(trx->start_line = __LINE__);
 
 	trx->rsegs.m_redo.rseg = rseg;
+	++rseg->trx_ref_count;
 	*trx->xid = undo->xid;
 	trx->id = undo->trx_id;
 	trx->rsegs.m_redo.insert_undo = undo;
@@ -827,6 +831,12 @@ trx_resurrect_update(
 	trx_undo_t*	undo,	/*!< in/out: update UNDO record */
 	trx_rseg_t*	rseg)	/*!< in/out: rollback segment */
 {
+	/* The transaction may already have been resurrected from its
+	insert undo log in the same rollback segment. */
+	if (trx->rsegs.m_redo.rseg == NULL) {
+		++rseg->trx_ref_count;
+	}
+
 	trx->rsegs.m_redo.rseg = rseg;
 	*trx->xid = undo->xid;
 	trx->id = undo->trx_id;
@@ -958,6 +968,26 @@ trx_lists_init_at_db_start(void)
 	}
 }
 
+/******************************************************************//**
+Release the reference of a transaction to its redo rollback segment, so
+that purge can tell when an undo tablespace marked for truncation has been
+drained. */
+static
+void
+trx_release_rseg(
+/*=============*/
+	trx_t*	trx)	/*!< in: transaction */
+{
+	trx_rseg_t*	rseg = trx->rsegs.m_redo.rseg;
+
+	if (rseg != NULL) {
+		mutex_enter(&rseg->mutex);
+		ut_ad(rseg->trx_ref_count > 0);
+		--rseg->trx_ref_count;
+		mutex_exit(&rseg->mutex);
+	}
+}
+
 /******************************************************************//**
 Get next redo rollback segment. (Segment are assigned in round-robin fashion).
 @return assigned rollback segment instance */
@@ -1025,13 +1055,28 @@ get_next_redo_rseg(
 			   && n_tablespaces > 0
 			   && trx_sys->rseg_array[slot] != NULL
 			   && trx_sys->rseg_array[slot]->space
-			   != srv_sys_space.space_id()) {
+			   != srv_sys_space.space_id()
+			   && !trx_sys->rseg_array[slot]->skip_allocation) {
 			/* If undo-tablespace is configured, skip
 			rseg from system-tablespace and try to use
 			undo-tablespace rseg unless it is not possible
 			due to lower limit of undo-logs. */
 			continue;
 		}
+
+		mutex_enter(&rseg->mutex);
+
+		if (rseg->skip_allocation) {
+			/* The undo tablespace of the rseg is marked for
+			truncation. Let purge drain it. */
+			mutex_exit(&rseg->mutex);
+			continue;
+		}
+
+		++rseg->trx_ref_count;
+
+		mutex_exit(&rseg->mutex);
+
 		break;
 	}
 
@@ -1158,6 +1203,69 @@ trx_assign_rseg(
 	}
 }
 
+/****************************************************************//**
+Starts a non-locking auto-commit read-only transaction. It gets neither
+a transaction id nor a rollback segment, and it is not added to any of
+the trx_sys_t lists, so that starting it does not acquire any mutex. Its
+consistent reads reuse the read view of the previous such transaction
+of the same trx_t whenever that view is still current. */
+static
+void
+trx_start_ac_nl_ro_low(
+/*===================*/
+	trx_t*	trx)		/*!< in/out: transaction */
+{
+	ut_ad(trx_is_autocommit_non_locking(trx));
+	ut_ad(!trx->in_rw_trx_list);
+	ut_ad(!trx->in_ro_trx_list);
+	ut_a(ib_vector_is_empty(trx->autoinc_locks));
+	ut_a(ib_vector_is_empty(trx->lock.table_locks));
+
+	trx->read_only = true;
+
+	/* The initial value for trx->no: TRX_ID_MAX is used in
+	read_view_open_now: */
+
+	trx->no = TRX_ID_MAX;
+
+	trx->id = 0;
+
+	trx->state = TRX_STATE_ACTIVE;
+
+	trx->start_time = thd_start_time_in_secs(trx->mysql_thd);
+
+	MONITOR_INC(MONITOR_TRX_ACTIVE);
+}
+
+/****************************************************************//**
+Turns an active non-locking auto-commit read-only transaction into a
+read-only transaction, which can write to temporary tables. This happens
+when a SELECT converts an internal temporary table to InnoDB. */
+static
+void
+trx_ac_nl_ro_to_ro(
+/*===============*/
+	trx_t*	trx)		/*!< in/out: transaction */
+{
+	ut_ad(trx_is_autocommit_non_locking(trx));
+	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
+	ut_ad(!trx->in_ro_trx_list);
+	ut_ad(!trx->in_rw_trx_list);
+
+	/* The transaction is no longer non-locking, so that it is
+	committed and its read view closed like the other read-only
+	transactions. */
+	++trx->will_lock;
+
+	trx_sys_mutex_enter();
+
+	UT_LIST_ADD_FIRST(trx_sys->ro_trx_list, trx);
+
+	ut_d(trx->in_ro_trx_list = true);
+
+	trx_sys_mutex_exit();
+}
+
 /****************************************************************//**
 Starts a transaction. */
 static
@@ -1181,6 +1289,12 @@ trx_start_low(
 	/* Check whether it is an AUTOCOMMIT SELECT */
 	trx->auto_commit = thd_trx_is_auto_commit(trx->mysql_thd);
 
+	if (trx_is_autocommit_non_locking(trx)) {
+		ut_ad(!read_write);
+		trx_start_ac_nl_ro_low(trx);
+		return;
+	}
+
 	trx->read_only =
 		(!trx->ddl
 		 && !trx->internal
@@ -1189,8 +1303,6 @@ trx_start_low(
 
 	if (!trx->auto_commit) {
 		++trx->will_lock;
-	} else if (trx->will_lock == 0) {
-		trx->read_only = true;
 	}
 
 	/* The initial value for trx->no: TRX_ID_MAX is used in
@@ -1260,38 +1372,31 @@ trx_start_low(
 	} else {
 		trx->id = 0;
 
-		if (!trx_is_autocommit_non_locking(trx)) {
-
-			mutex_enter(&trx_sys->mutex);
+		mutex_enter(&trx_sys->mutex);
 
-			/* If this is a read-only transaction that is writing
-			to a temporary table then it needs a transaction id
-			to write to the temporary table. */
+		/* If this is a read-only transaction that is writing
+		to a temporary table then it needs a transaction id
+		to write to the temporary table. */
 
-			if (read_write) {
+		if (read_write) {
 
-				ut_ad(!srv_read_only_mode);
+			ut_ad(!srv_read_only_mode);
 
-				trx->id = trx_sys_get_new_trx_id();
+			trx->id = trx_sys_get_new_trx_id();
 
-				trx_sys->rw_trx_ids.push_back(trx->id);
+			trx_sys->rw_trx_ids.push_back(trx->id);
 
-				trx_sys->rw_trx_set.insert(
-					TrxTrack(trx->id, trx));
-			}
+			trx_sys->rw_trx_set.insert(TrxTrack(trx->id, trx));
+		}
 
-			UT_LIST_ADD_FIRST(trx_sys->ro_trx_list, trx);
+		UT_LIST_ADD_FIRST(trx_sys->ro_trx_list, trx);
 
-			trx->state = TRX_STATE_ACTIVE;
+		trx->state = TRX_STATE_ACTIVE;
 
-			ut_d(trx->in_ro_trx_list = true);
-			ut_ad(trx_sys_validate_trx_list());
+		ut_d(trx->in_ro_trx_list = true);
+		ut_ad(trx_sys_validate_trx_list());
 
-			trx_sys_mutex_exit();
-		} else {
-			ut_ad(!read_write);
-			trx->state = TRX_STATE_ACTIVE;
-		}
+		trx_sys_mutex_exit();
 	}
 
 	if (trx->mysql_thd != NULL) {
@@ -1674,6 +1779,47 @@ trx_update_mod_tables_timestamp(
 	trx->mod_tables.clear();
 }
 
+/****************************************************************//**
+Commits a non-locking auto-commit read-only transaction in memory. The
+read view is only marked closed, so that the next such transaction of
+this trx_t can reuse it without acquiring trx_sys_t::mutex. */
+static
+void
+trx_commit_in_memory_ac_nl_ro(
+/*==========================*/
+	trx_t*	trx)		/*!< in/out: transaction */
+{
+	ut_ad(trx->read_only);
+	ut_a(!trx->is_recovered);
+	ut_ad(trx->rsegs.m_redo.rseg == NULL);
+	ut_ad(!trx->in_ro_trx_list);
+	ut_ad(!trx->in_rw_trx_list);
+
+	/* Note: We are asserting without holding the lock mutex. But
+	that is OK because this transaction is not waiting and cannot
+	be rolled back and no new locks can (or should not) be added
+	becuase it is flagged as a non-locking read-only transaction. */
+
+	ut_a(UT_LIST_GET_LEN(trx->lock.trx_locks) == 0);
+
+	/* This state change is not protected by any mutex, therefore
+	there is an inherent race here around state transition during
+	printouts. We ignore this race for the sake of efficiency.
+	However, the trx_sys_t::mutex will protect the trx_t instance
+	and it cannot be removed from the mysql_trx_list and freed
+	without first acquiring the trx_sys_t::mutex. */
+
+	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
+
+	trx->state = TRX_STATE_NOT_STARTED;
+
+	if (trx->read_view != NULL) {
+		trx_sys->mvcc->view_close(trx->read_view, false);
+	}
+
+	MONITOR_INC(MONITOR_TRX_NL_RO_COMMIT);
+}
+
 /****************************************************************//**
 Commits a transaction in memory. */
 static
@@ -1689,35 +1835,7 @@ trx_commit_in_memory(
 	trx->must_flush_log_later = false;
 
 	if (trx_is_autocommit_non_locking(trx)) {
-		ut_ad(trx->read_only);
-		ut_a(!trx->is_recovered);
-		ut_ad(trx->rsegs.m_redo.rseg == NULL);
-		ut_ad(!trx->in_ro_trx_list);
-		ut_ad(!trx->in_rw_trx_list);
-
-		/* Note: We are asserting without holding the lock mutex. But
-		that is OK because this transaction is not waiting and cannot
-		be rolled back and no new locks can (or should not) be added
-		becuase it is flagged as a non-locking read-only transaction. */
-
-		ut_a(UT_LIST_GET_LEN(trx->lock.trx_locks) == 0);
-
-		/* This state change is not protected by any mutex, therefore
-		there is an inherent race here around state transition during
-		printouts. We ignore this race for the sake of efficiency.
-		However, the trx_sys_t::mutex will protect the trx_t instance
-		and it cannot be removed from the mysql_trx_list and freed
-		without first acquiring the trx_sys_t::mutex. */
-
-		ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
-
-		trx->state = TRX_STATE_NOT_STARTED;
-
-		if (trx->read_view != NULL) {
-			trx_sys->mvcc->view_close(trx->read_view, false);
-		}
-
-		MONITOR_INC(MONITOR_TRX_NL_RO_COMMIT);
+		trx_commit_in_memory_ac_nl_ro(trx);
 	} else {
 
 		lock_trx_release_locks(trx);
@@ -1827,6 +1945,8 @@ trx_commit_in_memory(
                 trx_finalize_for_fts(trx, not_rollback);
         }
 
+	trx_release_rseg(trx);
+
 	trx_init(trx);
 
 	assert_trx_is_free(trx);
@@ -1935,6 +2055,8 @@ trx_commit_low(
 
 		trx_sys->rw_trx_ids.erase(it);
 
+		++trx_sys->rw_trx_ids_version;
+
 		mutex_exit(&trx_sys->mutex);
 	}
 
@@ -1983,6 +2105,8 @@ trx_cleanup_at_db_startup(
 		trx_undo_insert_cleanup(&trx->rsegs.m_redo);
 	}
 
+	trx_release_rseg(trx);
+
 	trx->rsegs.m_redo.rseg = NULL;
 	trx->undo_no = 0;
 	trx->undo_rseg_space = 0;
@@ -2174,6 +2298,31 @@ trx_commit_for_mysql(
 		trx_start_low(trx, true);
 		/* fall through */
 	case TRX_STATE_ACTIVE:
+		if (trx_is_autocommit_non_locking(trx)) {
+			/* There is nothing to write, and no locks to
+			release: skip the mini-transaction, the full text
+			search and the trx_sys_t bookkeeping of trx_commit(). */
+
+			trx->must_flush_log_later = false;
+
+			trx_commit_in_memory_ac_nl_ro(trx);
+
+			if (UT_LIST_GET_LEN(trx->trx_savepoints) > 0) {
+				trx_roll_savepoints_free(
+					trx,
+					UT_LIST_GET_FIRST(trx->trx_savepoints));
+			}
+
+			ut_ad(trx->fts_trx == NULL);
+
+			trx_init(trx);
+
+			assert_trx_is_free(trx);
+
+			MONITOR_DEC(MONITOR_TRX_ACTIVE);
+			return(DB_SUCCESS);
+		}
+		/* fall through */
 	case TRX_STATE_PREPARED:
 
 		trx->op_info = "committing";
@@ -2822,6 +2971,11 @@ trx_start_if_not_started_xa_low(
 			if (!trx->read_only) {
 				trx_set_rw_mode(trx);
 			} else if (!srv_read_only_mode) {
+
+				if (trx_is_autocommit_non_locking(trx)) {
+					trx_ac_nl_ro_to_ro(trx);
+				}
+
 				trx_assign_rseg(trx);
 			}
 		}
@@ -2976,11 +3130,16 @@ trx_set_rw_mode(
 	it here for the non-debug case. It can always be moved
 	out and the code #ifdefed to handle both variations. */
 
-	mutex_enter(&trx_sys->mutex);
+	/* The rollback segment assignment acquires rseg->mutex, which
+	must not be acquired while holding trx_sys->mutex. */
 
-	trx->rsegs.m_redo.rseg = trx_assign_rseg_low(
+	trx_rseg_t*	rseg = trx_assign_rseg_low(
 		srv_undo_logs, srv_undo_tablespaces, TRX_RSEG_TYPE_REDO);
 
+	mutex_enter(&trx_sys->mutex);
+
+	trx->rsegs.m_redo.rseg = rseg;
+
 	ut_ad(trx->rsegs.m_redo.rseg != 0);
 
 	ut_ad(trx->id == 0);
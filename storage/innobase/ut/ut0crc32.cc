@@ -84,8 +84,24 @@ mysys/my_perf.c, contributed by Facebook under the following license.
 #include "univ.i"
 #include "ut0crc32.h"
 
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+# include <sys/auxv.h>
+# ifndef HWCAP_CRC32
+#  define HWCAP_CRC32		(1 << 7)
+# endif /* !HWCAP_CRC32 */
+#endif /* __GNUC__ && __aarch64__ && __linux__ */
+
 ib_ut_crc32_t	ut_crc32;
 
+/** Name of the implementation that ut_crc32 points to */
+const char*	ut_crc32_implementation;
+
+/** The implementations supported by the CPU, the best one first */
+static ut_crc32_impl_t	ut_crc32_impls[4];
+
+/** Number of elements in ut_crc32_impls */
+static ulint		ut_crc32_n_impls;
+
 /* Precalculated table used to generate the CRC32 if the CPU does not
 have support for it */
 static ib_uint32_t	ut_crc32_slice8_table[8][256];
@@ -94,6 +110,12 @@ static ibool		ut_crc32_slice8_table_initialized = FALSE;
 /* Flag that tells whether the CPU supports CRC32 or not */
 bool	ut_crc32_sse2_enabled = false;
 
+/* Flag that tells whether the CPU supports PCLMULQDQ or not */
+static bool	ut_crc32_pclmul_enabled = false;
+
+/* Flag that tells whether the CPU supports the ARMv8 CRC32 instructions */
+static bool	ut_crc32_armv8_enabled = false;
+
 /********************************************************************//**
 Initializes the table that is used to generate the CRC32 if the CPU does
 not have support for it. */
@@ -216,6 +238,227 @@ ut_crc32_sse42(
 #endif /* defined(__GNUC__) && defined(__x86_64__) */
 }
 
+#if defined(__GNUC__) && defined(__x86_64__)
+/** Length in bytes of each of the three streams that
+ut_crc32_sse42_3way() processes in parallel, for long and short
+blocks. Both must be multiples of 8. */
+#define UT_CRC32_3WAY_LONG	1024
+#define UT_CRC32_3WAY_SHORT	128
+
+/* Multipliers for shifting a CRC over UT_CRC32_3WAY_LONG and
+UT_CRC32_3WAY_SHORT zero bytes (index 0) and twice that (index 1),
+see ut_crc32_3way_constants_init() */
+static ib_uint64_t	ut_crc32_3way_long_k[2];
+static ib_uint64_t	ut_crc32_3way_short_k[2];
+
+/********************************************************************//**
+Updates a CRC32 with 8 bytes of data using the SSE4.2 instruction.
+@return the updated, not inverted, CRC */
+UNIV_INLINE
+ib_uint64_t
+ut_crc32_sse42_u64(
+/*===============*/
+	ib_uint64_t	crc,	/*!< in: CRC */
+	ib_uint64_t	data)	/*!< in: 8 bytes of data */
+{
+	asm("crc32q %1, %0" : "+r" (crc) : "rm" (data));
+
+	return(crc);
+}
+
+/********************************************************************//**
+Carry-less multiplication of two 32-bit polynomials with PCLMULQDQ.
+@return 63-bit product */
+UNIV_INLINE
+ib_uint64_t
+ut_crc32_clmul(
+/*===========*/
+	ib_uint64_t	a,	/*!< in: first factor, < 2^32 */
+	ib_uint64_t	b)	/*!< in: second factor, < 2^32 */
+{
+	ib_uint64_t	product;
+
+	asm("movq %1, %%xmm0\n\t"
+	    "movq %2, %%xmm1\n\t"
+	    "pclmulqdq $0x00, %%xmm1, %%xmm0\n\t"
+	    "movq %%xmm0, %0"
+	    : "=r" (product) : "r" (a), "r" (b) : "xmm0", "xmm1");
+
+	return(product);
+}
+
+/********************************************************************//**
+Computes x^n modulo the CRC-32C polynomial in the bit-reflected
+representation used by the crc32 instruction.
+@return x^n mod P */
+static
+ib_uint64_t
+ut_crc32_xpow(
+/*==========*/
+	ulint	n)	/*!< in: exponent */
+{
+	/* bit-reversed poly 0x1EDC6F41 */
+	static const ib_uint32_t	poly = 0x82f63b78;
+	ib_uint32_t			r = 0x80000000;	/* x^0 */
+
+	while (n--) {
+		r = (r & 1) ? (r >> 1) ^ poly : r >> 1;
+	}
+
+	return(r);
+}
+
+/********************************************************************//**
+Initializes the multipliers used for combining the CRCs of the three
+streams of ut_crc32_sse42_3way(). For a CRC value c of a stream that is
+followed by n more bytes, crc32q(0, clmul(c, x^(8n-33) mod P)) equals c
+shifted over n zero bytes. */
+static
+void
+ut_crc32_3way_constants_init()
+/*==========================*/
+{
+	ut_crc32_3way_long_k[0] = ut_crc32_xpow(8 * UT_CRC32_3WAY_LONG - 33);
+	ut_crc32_3way_long_k[1] = ut_crc32_xpow(
+		2 * 8 * UT_CRC32_3WAY_LONG - 33);
+	ut_crc32_3way_short_k[0] = ut_crc32_xpow(
+		8 * UT_CRC32_3WAY_SHORT - 33);
+	ut_crc32_3way_short_k[1] = ut_crc32_xpow(
+		2 * 8 * UT_CRC32_3WAY_SHORT - 33);
+}
+
+/********************************************************************//**
+Runs the CRC of three adjacent streams of n bytes each in parallel and
+combines the results into the CRC of the whole 3 * n bytes.
+@return the updated, not inverted, CRC */
+UNIV_INLINE
+ib_uint64_t
+ut_crc32_sse42_3way_block(
+/*======================*/
+	ib_uint64_t		crc,	/*!< in: CRC before the block */
+	const byte*		buf,	/*!< in: 3 * n bytes of data */
+	ulint			n,	/*!< in: stream length */
+	const ib_uint64_t*	k)	/*!< in: shift multipliers for n */
+{
+	ib_uint64_t	crc0 = crc;
+	ib_uint64_t	crc1 = 0;
+	ib_uint64_t	crc2 = 0;
+	const byte*	end = buf + n;
+
+	/* The three crc32 instructions are independent of each other,
+	so that the CPU can pipeline them. */
+
+	do {
+		crc0 = ut_crc32_sse42_u64(crc0, *(ib_uint64_t*) buf);
+		crc1 = ut_crc32_sse42_u64(crc1, *(ib_uint64_t*) (buf + n));
+		crc2 = ut_crc32_sse42_u64(crc2, *(ib_uint64_t*) (buf + 2 * n));
+		buf += 8;
+	} while (buf < end);
+
+	/* Shift crc0 over 2n and crc1 over n zero bytes and add them to
+	crc2; the shifts are done with a carry-less multiplication and
+	one more crc32 instruction. */
+
+	return(crc2 ^ ut_crc32_sse42_u64(
+		       0, ut_crc32_clmul(crc0, k[1])
+		       ^ ut_crc32_clmul(crc1, k[0])));
+}
+
+/********************************************************************//**
+Calculates CRC32 using the SSE4.2 instruction on three interleaved
+streams, combined with PCLMULQDQ.
+@return CRC-32C (polynomial 0x11EDC6F41) */
+static
+ib_uint32_t
+ut_crc32_sse42_3way(
+/*================*/
+	const byte*	buf,	/*!< in: data over which to calculate CRC32 */
+	ulint		len)	/*!< in: data length */
+{
+	ib_uint64_t	crc = (ib_uint32_t) (-1);
+
+	ut_a(ut_crc32_sse2_enabled && ut_crc32_pclmul_enabled);
+
+	while (len && ((ulint) buf & 7)) {
+		ut_crc32_sse42_byte;
+	}
+
+	while (len >= 3 * UT_CRC32_3WAY_LONG) {
+		crc = ut_crc32_sse42_3way_block(
+			crc, buf, UT_CRC32_3WAY_LONG, ut_crc32_3way_long_k);
+		buf += 3 * UT_CRC32_3WAY_LONG;
+		len -= 3 * UT_CRC32_3WAY_LONG;
+	}
+
+	while (len >= 3 * UT_CRC32_3WAY_SHORT) {
+		crc = ut_crc32_sse42_3way_block(
+			crc, buf, UT_CRC32_3WAY_SHORT, ut_crc32_3way_short_k);
+		buf += 3 * UT_CRC32_3WAY_SHORT;
+		len -= 3 * UT_CRC32_3WAY_SHORT;
+	}
+
+	while (len >= 8) {
+		ut_crc32_sse42_quadword;
+	}
+
+	while (len) {
+		ut_crc32_sse42_byte;
+	}
+
+	return((ib_uint32_t) ((~crc) & 0xFFFFFFFF));
+}
+#endif /* defined(__GNUC__) && defined(__x86_64__) */
+
+#if defined(__GNUC__) && defined(__aarch64__)
+/* The ".arch" directive lets the assembler accept the CRC32
+instructions without compiling the whole file for armv8-a+crc */
+#define ut_crc32_armv8_byte \
+	asm(".arch armv8-a+crc\n\tcrc32cb %w0, %w0, %w1" \
+	    : "+r"(crc) : "r"((ib_uint32_t) *buf)); \
+	len--, buf++
+
+#define ut_crc32_armv8_quadword \
+	asm(".arch armv8-a+crc\n\tcrc32cx %w0, %w0, %x1" \
+	    : "+r"(crc) : "r"(*(ib_uint64_t*) buf)); \
+	len -= 8, buf += 8
+
+/********************************************************************//**
+Calculates CRC32 using the ARMv8 CRC32 instructions.
+@return CRC-32C (polynomial 0x11EDC6F41) */
+static
+ib_uint32_t
+ut_crc32_armv8(
+/*===========*/
+	const byte*	buf,	/*!< in: data over which to calculate CRC32 */
+	ulint		len)	/*!< in: data length */
+{
+	ib_uint32_t	crc = (ib_uint32_t) (-1);
+
+	ut_a(ut_crc32_armv8_enabled);
+
+	while (len && ((ulint) buf & 7)) {
+		ut_crc32_armv8_byte;
+	}
+
+	while (len >= 32) {
+		ut_crc32_armv8_quadword;
+		ut_crc32_armv8_quadword;
+		ut_crc32_armv8_quadword;
+		ut_crc32_armv8_quadword;
+	}
+
+	while (len >= 8) {
+		ut_crc32_armv8_quadword;
+	}
+
+	while (len) {
+		ut_crc32_armv8_byte;
+	}
+
+	return(~crc);
+}
+#endif /* defined(__GNUC__) && defined(__aarch64__) */
+
 #define ut_crc32_slice8_byte \
 	crc = (crc >> 8) ^ ut_crc32_slice8_table[0][(crc ^ *buf++) & 0xFF]; \
 	len--
@@ -305,14 +548,60 @@ ut_crc32_init()
 	*/
 #ifndef UNIV_DEBUG_VALGRIND
 	ut_crc32_sse2_enabled = (features_ecx >> 20) & 1;
+	ut_crc32_pclmul_enabled = (features_ecx >> 1) & 1;
 #endif /* UNIV_DEBUG_VALGRIND */
 
+#endif /* defined(__GNUC__) && defined(__x86_64__) */
+
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__linux__)
+	ut_crc32_armv8_enabled = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif /* __GNUC__ && __aarch64__ && __linux__ */
+
+	ut_crc32_n_impls = 0;
+
+#if defined(__GNUC__) && defined(__x86_64__)
+	if (ut_crc32_sse2_enabled && ut_crc32_pclmul_enabled) {
+		ut_crc32_3way_constants_init();
+		ut_crc32_impls[ut_crc32_n_impls].name = "sse4.2-pclmul";
+		ut_crc32_impls[ut_crc32_n_impls++].func = ut_crc32_sse42_3way;
+	}
 #endif /* defined(__GNUC__) && defined(__x86_64__) */
 
 	if (ut_crc32_sse2_enabled) {
-		ut_crc32 = ut_crc32_sse42;
-	} else {
-		ut_crc32_slice8_table_init();
-		ut_crc32 = ut_crc32_slice8;
+		ut_crc32_impls[ut_crc32_n_impls].name = "sse4.2";
+		ut_crc32_impls[ut_crc32_n_impls++].func = ut_crc32_sse42;
 	}
+
+#if defined(__GNUC__) && defined(__aarch64__)
+	if (ut_crc32_armv8_enabled) {
+		ut_crc32_impls[ut_crc32_n_impls].name = "armv8";
+		ut_crc32_impls[ut_crc32_n_impls++].func = ut_crc32_armv8;
+	}
+#endif /* defined(__GNUC__) && defined(__aarch64__) */
+
+	/* The software implementation is always available, and used for
+	benchmarking even when the CPU has instructions for CRC32. */
+	ut_crc32_slice8_table_init();
+	ut_crc32_impls[ut_crc32_n_impls].name = "slice-by-8";
+	ut_crc32_impls[ut_crc32_n_impls++].func = ut_crc32_slice8;
+
+	ut_a(ut_crc32_n_impls <= UT_ARR_SIZE(ut_crc32_impls));
+
+	ut_crc32 = ut_crc32_impls[0].func;
+	ut_crc32_implementation = ut_crc32_impls[0].name;
+}
+
+/********************************************************************//**
+Returns the CRC32 implementations that the CPU supports, the one that
+ut_crc32 points to first. Valid after ut_crc32_init().
+@return array of implementations */
+
+const ut_crc32_impl_t*
+ut_crc32_get_impls(
+/*===============*/
+	ulint*	n)	/*!< out: number of implementations */
+{
+	*n = ut_crc32_n_impls;
+
+	return(ut_crc32_impls);
 }
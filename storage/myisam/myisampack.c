@@ -183,6 +183,7 @@ static int error_on_write=0,test_only=0,verbose=0,silent=0,
 	   write_loop=0,force_pack=0, isamchk_neaded=0;
 static int tmpfile_createflag=O_RDWR | O_TRUNC | O_EXCL;
 static my_bool backup, opt_wait;
+static uint opt_threads;
 /*
   tree_buff_length is somewhat arbitrary. The bigger it is the better
   the chance to win in terms of compression factor. On the other hand,
@@ -195,7 +196,6 @@ static my_off_t intervall_length;
 static ha_checksum glob_crc;
 static struct st_file_buffer file_buffer;
 static QUEUE queue;
-static HUFF_COUNTS *global_count;
 static char zero_string[]={0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 static const char *load_default_groups[]= { "myisampack",0 };
 
@@ -254,7 +254,7 @@ int main(int argc, char **argv)
 #endif
 }
 
-enum options_mp {OPT_CHARSETS_DIR_MP=256};
+enum options_mp {OPT_CHARSETS_DIR_MP=256, OPT_THREADS_MP};
 
 static struct my_option my_long_options[] =
 {
@@ -280,6 +280,10 @@ static struct my_option my_long_options[] =
    0, 0, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"test", 't', "Don't pack table, only test packing it.",
    0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"threads", OPT_THREADS_MP,
+   "Number of threads that count the column values. Not used for tables "
+   "with BLOB/TEXT columns.",
+   &opt_threads, &opt_threads, 0, GET_UINT, REQUIRED_ARG, 1, 1, 64, 0, 1, 0},
   {"verbose", 'v', "Write info about progress and packing result. Use many -v for more verbosity!",
    0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"version", 'V', "Output version information and exit.",
@@ -821,7 +825,7 @@ static HUFF_COUNTS *init_huff_count(MI_INFO *info,my_off_t records)
         This is accomplished by '-1' as the element size.
       */
       init_tree(&count[i].int_tree,0,0,-1,(qsort_cmp2) compare_tree,0, NULL,
-		NULL);
+		count + i);
       if (records && type != FIELD_BLOB && type != FIELD_VARCHAR)
 	count[i].tree_pos=count[i].tree_buff =
 	  my_malloc(PSI_NOT_INSTRUMENTED,
@@ -868,36 +872,445 @@ static void free_counts_and_tree_and_queue(HUFF_TREE *huff_trees, uint trees,
   return;
 }
 
+/*
+  Count the incidence of the values and bytes of one column value
+
+  SYNOPSIS
+    count_field_values()
+    count                       The statistics of the column.
+    pos                         The column value in the record.
+    tot_blob_length      IN/OUT The total length of the blobs of the record.
+*/
+
+static void count_field_values(HUFF_COUNTS *count, uchar *pos,
+                               ulong *tot_blob_length)
+{
+  uint length;
+  uchar *next_pos,*end_pos,*start_pos;
+  TREE_ELEMENT *element;
+
+  next_pos=end_pos=(start_pos=pos)+count->field_length;
+
+  /*
+    Put the whole column value in a tree if there is room for it.
+    'int_tree' is used to quickly check for duplicate values.
+    'tree_buff' collects as many distinct column values as
+    possible. If the field length is > 1, it is tree_buff_length,
+    else 2 bytes. Each value is 'field_length' bytes big. If there
+    are more distinct column values than fit into the buffer, we
+    give up with this tree. BLOBs and VARCHARs do not have a
+    tree_buff as it can only be used with fixed length columns.
+    For the special case of field length == 1, we handle only the
+    case that there is only one distinct value in the table(s).
+    Otherwise, we can have a maximum of 256 distinct values. This
+    is then handled by the normal Huffman tree build.
+
+    Another limit for collecting distinct column values is the
+    number of values itself. Since we would need to build a
+    Huffman tree for the values, we are limited by the 'IS_OFFSET'
+    constant. This constant expresses a bit which is used to
+    determine if a tree element holds a final value or an offset
+    to a child element. Hence, all values and offsets need to be
+    smaller than 'IS_OFFSET'. A tree element is implemented with
+    two integer values, one for the left branch and one for the
+    right branch. For the extreme case that the first element
+    points to the last element, the number of integers in the tree
+    must be less or equal to IS_OFFSET. So the number of elements
+    must be less or equal to IS_OFFSET / 2.
+
+    WARNING: At first, we insert a pointer into the record buffer
+    as the key for the tree. If we got a new distinct value, which
+    is really inserted into the tree, instead of being counted
+    only, we will copy the column value from the record buffer to
+    'tree_buff' and adjust the key pointer of the tree accordingly.
+  */
+  if (count->tree_buff)
+  {
+    if (!(element=tree_insert(&count->int_tree,pos, 0, 
+			      count->int_tree.custom_arg)) ||
+	(element->count == 1 &&
+	 (count->tree_buff + tree_buff_length <
+	  count->tree_pos + count->field_length)) ||
+	(count->int_tree.elements_in_tree > IS_OFFSET / 2) ||
+	(count->field_length == 1 &&
+	 count->int_tree.elements_in_tree > 1))
+    {
+      delete_tree(&count->int_tree);
+      my_free(count->tree_buff);
+      count->tree_buff=0;
+    }
+    else
+    {
+      /*
+	If tree_insert() succeeds, it either creates a new element
+	or increments the counter of an existing element.
+      */
+      if (element->count == 1)
+      {
+	/* Copy the new column value into 'tree_buff'. */
+	memcpy(count->tree_pos,pos,(size_t) count->field_length);
+	/* Adjust the key pointer in the tree. */
+	tree_set_pointer(element,count->tree_pos);
+	/* Point behind the last column value so far. */
+	count->tree_pos+=count->field_length;
+      }
+    }
+  }
+
+  /* Save character counters and space-counts and zero-field-counts */
+  if (count->field_type == FIELD_NORMAL ||
+      count->field_type == FIELD_SKIP_ENDSPACE)
+  {
+    /* Ignore trailing space. */
+    for ( ; end_pos > pos ; end_pos--)
+      if (end_pos[-1] != ' ')
+	break;
+    /* Empty fields are just counted. */
+    if (end_pos == pos)
+    {
+      count->empty_fields++;
+      count->max_zero_fill=0;
+      return;
+    }
+    /*
+      Count the total of all trailing spaces and the number of
+      short trailing spaces. Remember the longest trailing space.
+    */
+    length= (uint) (next_pos-end_pos);
+    count->tot_end_space+=length;
+    if (length < 8)
+      count->end_space[length]++;
+    if (count->max_end_space < length)
+      count->max_end_space = length;
+  }
+
+  if (count->field_type == FIELD_NORMAL ||
+      count->field_type == FIELD_SKIP_PRESPACE)
+  {
+    /* Ignore leading space. */
+    for (pos=start_pos; pos < end_pos ; pos++)
+      if (pos[0] != ' ')
+	break;
+    /* Empty fields are just counted. */
+    if (end_pos == pos)
+    {
+      count->empty_fields++;
+      count->max_zero_fill=0;
+      return;
+    }
+    /*
+      Count the total of all leading spaces and the number of
+      short leading spaces. Remember the longest leading space.
+    */
+    length= (uint) (pos-start_pos);
+    count->tot_pre_space+=length;
+    if (length < 8)
+      count->pre_space[length]++;
+    if (count->max_pre_space < length)
+      count->max_pre_space = length;
+  }
+
+  /* Calculate pos, end_pos, and max_length for variable length fields. */
+  if (count->field_type == FIELD_BLOB)
+  {
+    uint field_length=count->field_length -portable_sizeof_char_ptr;
+    ulong blob_length= _mi_calc_blob_length(field_length, start_pos);
+    memcpy(&pos, start_pos+field_length, sizeof(char*));
+    end_pos=pos+blob_length;
+    *tot_blob_length+=blob_length;
+    set_if_bigger(count->max_length,blob_length);
+  }
+  else if (count->field_type == FIELD_VARCHAR)
+  {
+    uint pack_length= HA_VARCHAR_PACKLENGTH(count->field_length-1);
+    length= (pack_length == 1 ? (uint) *(uchar*) start_pos :
+	     uint2korr(start_pos));
+    pos= start_pos+pack_length;
+    end_pos= pos+length;
+    set_if_bigger(count->max_length,length);
+  }
+
+  /* Evaluate 'max_zero_fill' for short fields. */
+  if (count->field_length <= 8 &&
+      (count->field_type == FIELD_NORMAL ||
+       count->field_type == FIELD_SKIP_ZERO))
+  {
+    uint i;
+    /* Zero fields are just counted. */
+    if (!memcmp((uchar*) start_pos,zero_string,count->field_length))
+    {
+      count->zero_fields++;
+      return;
+    }
+    /*
+      max_zero_fill starts with field_length. It is decreased every
+      time a shorter "zero trailer" is found. It is set to zero when
+      an empty field is found (see above). This suggests that the
+      variable should be called 'min_zero_fill'.
+    */
+    for (i =0 ; i < count->max_zero_fill && ! end_pos[-1 - (int) i] ;
+	 i++) ;
+    if (i < count->max_zero_fill)
+      count->max_zero_fill=i;
+  }
+
+  /* Ignore zero fields and check fields. */
+  if (count->field_type == FIELD_ZERO ||
+      count->field_type == FIELD_CHECK)
+    return;
+
+  /*
+    Count the incidence of every byte value in the
+    significant field value.
+  */
+  for ( ; pos < end_pos ; pos++)
+    count->counts[(uchar) *pos]++;
+}
+
+/*
+  Counting column values in several threads
+
+  The main thread reads the rows into batches and hands every full
+  batch to the counting threads. Each thread counts its own share of
+  the columns for all rows of the batch. So every HUFF_COUNTS is still
+  updated by one thread, in row order, and the statistics are the same
+  as with one thread. While the threads count one batch, the main
+  thread reads the next one into the other buffer.
+
+  BLOB values are not in the row buffer, but in a buffer of the
+  MI_INFO that the next read overwrites. Tables with BLOBs are
+  therefore always counted by the main thread.
+*/
+
+typedef struct st_stat_threads
+{
+  mysql_mutex_t lock;
+  mysql_cond_t cond;
+  HUFF_COUNTS *huff_counts,*end_count;
+  uchar *batch[2];                      /* Read by turns */
+  uint rows[2];                         /* Rows in each batch */
+  uint batch_rows;                      /* Max rows in a batch */
+  uint current;                         /* Batch being read */
+  uint filled;                          /* Rows read into that batch */
+  ulong reclength;
+  ulong published;                      /* Batches handed to the threads */
+  uint threads;
+  uint busy;                            /* Threads counting a batch */
+  uint running;                         /* Threads started, not ended */
+  my_bool end;
+} STAT_THREADS;
+
+typedef struct st_stat_thread_arg
+{
+  STAT_THREADS *stats;
+  uint nr;
+} STAT_THREAD_ARG;
+
+#define STAT_BATCH_SIZE (1024*1024)
+
+static pthread_handler_t count_thread(void *arg)
+{
+  STAT_THREAD_ARG *thread_arg= (STAT_THREAD_ARG*) arg;
+  STAT_THREADS *stats= thread_arg->stats;
+  ulong done= 0;
+  my_thread_init();
+
+  for (;;)
+  {
+    uchar *record,*end,*pos;
+    HUFF_COUNTS *count;
+    ulong tot_blob_length= 0;
+    uint nr;
+
+    mysql_mutex_lock(&stats->lock);
+    while (stats->published == done && !stats->end)
+      mysql_cond_wait(&stats->cond, &stats->lock);
+    if (stats->published == done)
+      break;
+    record= stats->batch[done & 1];
+    end= record + stats->rows[done & 1] * stats->reclength;
+    done++;
+    mysql_mutex_unlock(&stats->lock);
+
+    for ( ; record < end ; record+= stats->reclength)
+    {
+      for (pos=record, count=stats->huff_counts, nr=0 ;
+           count < stats->end_count ;
+           pos+=count->field_length, count++, nr++)
+      {
+        if (nr % stats->threads == thread_arg->nr)
+          count_field_values(count, pos, &tot_blob_length);
+      }
+    }
+
+    mysql_mutex_lock(&stats->lock);
+    if (!--stats->busy)
+      mysql_cond_broadcast(&stats->cond);
+    mysql_mutex_unlock(&stats->lock);
+  }
+  stats->running--;
+  mysql_cond_broadcast(&stats->cond);
+  mysql_mutex_unlock(&stats->lock);
+  my_thread_end();
+  return 0;
+}
+
+
+/* Where to read the next row for the counting threads */
+
+static inline uchar *stats_record(STAT_THREADS *stats)
+{
+  return stats->batch[stats->current] + stats->filled * stats->reclength;
+}
+
+
+/*
+  Hand the rows read so far to the counting threads, once they are done
+  with the previous batch
+*/
+
+static void publish_batch(STAT_THREADS *stats)
+{
+  mysql_mutex_lock(&stats->lock);
+  while (stats->busy)
+    mysql_cond_wait(&stats->cond, &stats->lock);
+  stats->rows[stats->current]= stats->filled;
+  stats->published++;
+  stats->busy= stats->threads;
+  mysql_cond_broadcast(&stats->cond);
+  mysql_mutex_unlock(&stats->lock);
+  stats->current^= 1;
+  stats->filled= 0;
+}
+
+
+/* A row was read into stats_record(stats) */
+
+static void stats_row_read(STAT_THREADS *stats)
+{
+  if (++stats->filled == stats->batch_rows)
+    publish_batch(stats);
+}
+
+
+/* Count the last rows, stop the threads and free the batches */
+
+static void end_stat_threads(STAT_THREADS *stats)
+{
+  if (stats->filled)
+    publish_batch(stats);
+  mysql_mutex_lock(&stats->lock);
+  stats->end= 1;
+  mysql_cond_broadcast(&stats->cond);
+  while (stats->running)
+    mysql_cond_wait(&stats->cond, &stats->lock);
+  mysql_mutex_unlock(&stats->lock);
+  mysql_mutex_destroy(&stats->lock);
+  mysql_cond_destroy(&stats->cond);
+  my_free(stats->batch[0]);
+}
+
+
+/*
+  Start the threads that count column values
+
+  RETURN
+    0   ok, read the rows into stats_record(stats)
+    1   could not start all threads, count in the main thread
+*/
+
+static my_bool start_stat_threads(STAT_THREADS *stats, HUFF_COUNTS *huff_counts,
+                                  HUFF_COUNTS *end_count, ulong reclength,
+                                  STAT_THREAD_ARG *args)
+{
+  pthread_t thread;
+  pthread_attr_t thr_attr;
+  uint i;
+
+  memset(stats, 0, sizeof(*stats));
+  stats->huff_counts= huff_counts;
+  stats->end_count= end_count;
+  stats->reclength= reclength;
+  stats->batch_rows= MY_MAX(STAT_BATCH_SIZE / reclength, 1);
+  if (!(stats->batch[0]= (uchar*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                            2 * stats->batch_rows * reclength,
+                                            MYF(MY_WME))))
+    return 1;
+  stats->batch[1]= stats->batch[0] + stats->batch_rows * reclength;
+  stats->threads= opt_threads;
+  mysql_mutex_init(0, &stats->lock, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(0, &stats->cond, NULL);
+
+  (void) pthread_attr_init(&thr_attr);
+  (void) pthread_attr_setdetachstate(&thr_attr, PTHREAD_CREATE_DETACHED);
+  for (i= 0; i < stats->threads; i++)
+  {
+    args[i].stats= stats;
+    args[i].nr= i;
+    mysql_mutex_lock(&stats->lock);
+    if (mysql_thread_create(0, &thread, &thr_attr, count_thread,
+                            (void*) (args + i)))
+    {
+      mysql_mutex_unlock(&stats->lock);
+      break;
+    }
+    stats->running++;
+    mysql_mutex_unlock(&stats->lock);
+  }
+  (void) pthread_attr_destroy(&thr_attr);
+  if (i < stats->threads)
+  {
+    (void) fprintf(stderr, "Cannot start a counting thread, "
+                   "counting in one thread\n");
+    end_stat_threads(stats);
+    return 1;
+  }
+  return 0;
+}
+
+
 	/* Read through old file and gather some statistics */
 
 static int get_statistic(PACK_MRG_INFO *mrg,HUFF_COUNTS *huff_counts)
 {
   int error;
-  uint length;
   ulong reclength,max_blob_length;
-  uchar *record,*pos,*next_pos,*end_pos,*start_pos;
+  uchar *record,*row_buff,*pos;
   ha_rows record_count;
-  my_bool static_row_size;
+  my_bool static_row_size, has_blobs;
   HUFF_COUNTS *count,*end_count;
-  TREE_ELEMENT *element;
+  STAT_THREADS stats;
+  STAT_THREAD_ARG *thread_args= NULL;
+  my_bool use_threads= 0;
   DBUG_ENTER("get_statistic");
 
   reclength=mrg->file[0]->s->base.reclength;
-  record=(uchar*) my_alloca(reclength);
+  record=row_buff=(uchar*) my_alloca(reclength);
   end_count=huff_counts+mrg->file[0]->s->base.fields;
   record_count=0; glob_crc=0;
   max_blob_length=0;
 
   /* Check how to calculate checksum */
   static_row_size=1;
+  has_blobs=0;
   for (count=huff_counts ; count < end_count ; count++)
   {
     if (count->field_type == FIELD_BLOB ||
         count->field_type == FIELD_VARCHAR)
-    {
       static_row_size=0;
-      break;
-    }
+    if (count->field_type == FIELD_BLOB)
+      has_blobs=1;
+  }
+
+  if (opt_threads > 1 && !has_blobs &&
+      (thread_args= (STAT_THREAD_ARG*)
+       my_malloc(PSI_NOT_INSTRUMENTED, opt_threads * sizeof(STAT_THREAD_ARG),
+                 MYF(MY_WME))) &&
+      !start_stat_threads(&stats, huff_counts, end_count, reclength,
+                          thread_args))
+  {
+    use_threads=1;
+    record=stats_record(&stats);
   }
 
   mrg_reset(mrg);
@@ -913,190 +1326,17 @@ static int get_statistic(PACK_MRG_INFO *mrg,HUFF_COUNTS *huff_counts)
 	glob_crc+=mi_checksum(mrg->file[0],record);
 
       /* Count the incidence of values separately for every column. */
-      for (pos=record,count=huff_counts ;
-	   count < end_count ;
-	   count++,
-	   pos=next_pos)
+      if (use_threads)
       {
-	next_pos=end_pos=(start_pos=pos)+count->field_length;
-
-	/*
-          Put the whole column value in a tree if there is room for it.
-          'int_tree' is used to quickly check for duplicate values.
-          'tree_buff' collects as many distinct column values as
-          possible. If the field length is > 1, it is tree_buff_length,
-          else 2 bytes. Each value is 'field_length' bytes big. If there
-          are more distinct column values than fit into the buffer, we
-          give up with this tree. BLOBs and VARCHARs do not have a
-          tree_buff as it can only be used with fixed length columns.
-          For the special case of field length == 1, we handle only the
-          case that there is only one distinct value in the table(s).
-          Otherwise, we can have a maximum of 256 distinct values. This
-          is then handled by the normal Huffman tree build.
-
-          Another limit for collecting distinct column values is the
-          number of values itself. Since we would need to build a
-          Huffman tree for the values, we are limited by the 'IS_OFFSET'
-          constant. This constant expresses a bit which is used to
-          determine if a tree element holds a final value or an offset
-          to a child element. Hence, all values and offsets need to be
-          smaller than 'IS_OFFSET'. A tree element is implemented with
-          two integer values, one for the left branch and one for the
-          right branch. For the extreme case that the first element
-          points to the last element, the number of integers in the tree
-          must be less or equal to IS_OFFSET. So the number of elements
-          must be less or equal to IS_OFFSET / 2.
-
-          WARNING: At first, we insert a pointer into the record buffer
-          as the key for the tree. If we got a new distinct value, which
-          is really inserted into the tree, instead of being counted
-          only, we will copy the column value from the record buffer to
-          'tree_buff' and adjust the key pointer of the tree accordingly.
-        */
-	if (count->tree_buff)
-	{
-	  global_count=count;
-	  if (!(element=tree_insert(&count->int_tree,pos, 0, 
-				    count->int_tree.custom_arg)) ||
-	      (element->count == 1 &&
-	       (count->tree_buff + tree_buff_length <
-                count->tree_pos + count->field_length)) ||
-              (count->int_tree.elements_in_tree > IS_OFFSET / 2) ||
-	      (count->field_length == 1 &&
-	       count->int_tree.elements_in_tree > 1))
-	  {
-	    delete_tree(&count->int_tree);
-	    my_free(count->tree_buff);
-	    count->tree_buff=0;
-	  }
-	  else
-	  {
-            /*
-              If tree_insert() succeeds, it either creates a new element
-              or increments the counter of an existing element.
-            */
-	    if (element->count == 1)
-	    {
-              /* Copy the new column value into 'tree_buff'. */
-	      memcpy(count->tree_pos,pos,(size_t) count->field_length);
-              /* Adjust the key pointer in the tree. */
-	      tree_set_pointer(element,count->tree_pos);
-              /* Point behind the last column value so far. */
-	      count->tree_pos+=count->field_length;
-	    }
-	  }
-	}
-
-	/* Save character counters and space-counts and zero-field-counts */
-	if (count->field_type == FIELD_NORMAL ||
-	    count->field_type == FIELD_SKIP_ENDSPACE)
-	{
-          /* Ignore trailing space. */
-	  for ( ; end_pos > pos ; end_pos--)
-	    if (end_pos[-1] != ' ')
-	      break;
-          /* Empty fields are just counted. Go to the next record. */
-	  if (end_pos == pos)
-	  {
-	    count->empty_fields++;
-	    count->max_zero_fill=0;
-	    continue;
-	  }
-          /*
-            Count the total of all trailing spaces and the number of
-            short trailing spaces. Remember the longest trailing space.
-          */
-	  length= (uint) (next_pos-end_pos);
-	  count->tot_end_space+=length;
-	  if (length < 8)
-	    count->end_space[length]++;
-	  if (count->max_end_space < length)
-	    count->max_end_space = length;
-	}
-
-	if (count->field_type == FIELD_NORMAL ||
-	    count->field_type == FIELD_SKIP_PRESPACE)
-	{
-          /* Ignore leading space. */
-	  for (pos=start_pos; pos < end_pos ; pos++)
-	    if (pos[0] != ' ')
-	      break;
-          /* Empty fields are just counted. Go to the next record. */
-	  if (end_pos == pos)
-	  {
-	    count->empty_fields++;
-	    count->max_zero_fill=0;
-	    continue;
-	  }
-          /*
-            Count the total of all leading spaces and the number of
-            short leading spaces. Remember the longest leading space.
-          */
-	  length= (uint) (pos-start_pos);
-	  count->tot_pre_space+=length;
-	  if (length < 8)
-	    count->pre_space[length]++;
-	  if (count->max_pre_space < length)
-	    count->max_pre_space = length;
-	}
-
-        /* Calculate pos, end_pos, and max_length for variable length fields. */
-	if (count->field_type == FIELD_BLOB)
-	{
-	  uint field_length=count->field_length -portable_sizeof_char_ptr;
-	  ulong blob_length= _mi_calc_blob_length(field_length, start_pos);
-	  memcpy(&pos, start_pos+field_length, sizeof(char*));
-	  end_pos=pos+blob_length;
-	  tot_blob_length+=blob_length;
-	  set_if_bigger(count->max_length,blob_length);
-	}
-	else if (count->field_type == FIELD_VARCHAR)
-	{
-          uint pack_length= HA_VARCHAR_PACKLENGTH(count->field_length-1);
-	  length= (pack_length == 1 ? (uint) *(uchar*) start_pos :
-                   uint2korr(start_pos));
-	  pos= start_pos+pack_length;
-	  end_pos= pos+length;
-	  set_if_bigger(count->max_length,length);
-	}
-
-        /* Evaluate 'max_zero_fill' for short fields. */
-	if (count->field_length <= 8 &&
-	    (count->field_type == FIELD_NORMAL ||
-	     count->field_type == FIELD_SKIP_ZERO))
-	{
-	  uint i;
-          /* Zero fields are just counted. Go to the next record. */
-	  if (!memcmp((uchar*) start_pos,zero_string,count->field_length))
-	  {
-	    count->zero_fields++;
-	    continue;
-	  }
-          /*
-            max_zero_fill starts with field_length. It is decreased every
-            time a shorter "zero trailer" is found. It is set to zero when
-            an empty field is found (see above). This suggests that the
-            variable should be called 'min_zero_fill'.
-          */
-	  for (i =0 ; i < count->max_zero_fill && ! end_pos[-1 - (int) i] ;
-	       i++) ;
-	  if (i < count->max_zero_fill)
-	    count->max_zero_fill=i;
-	}
-
-        /* Ignore zero fields and check fields. */
-	if (count->field_type == FIELD_ZERO ||
-	    count->field_type == FIELD_CHECK)
-	  continue;
-
-        /*
-          Count the incidence of every byte value in the
-          significant field value.
-        */
-	for ( ; pos < end_pos ; pos++)
-	  count->counts[(uchar) *pos]++;
-
-        /* Step to next field. */
+        stats_row_read(&stats);
+        record=stats_record(&stats);
+      }
+      else
+      {
+        for (pos=record,count=huff_counts ;
+             count < end_count ;
+             pos+=count->field_length, count++)
+          count_field_values(count, pos, &tot_blob_length);
       }
 
       if (tot_blob_length > max_blob_length)
@@ -1116,6 +1356,9 @@ static int get_statistic(PACK_MRG_INFO *mrg,HUFF_COUNTS *huff_counts)
 
     /* Step to next record. */
   }
+  if (use_threads)
+    end_stat_threads(&stats);
+  my_free(thread_args);
   if (write_loop)
   {
     printf("            \r");
@@ -1176,7 +1419,7 @@ static int get_statistic(PACK_MRG_INFO *mrg,HUFF_COUNTS *huff_counts)
 
   mrg->records=record_count;
   mrg->max_blob_length=max_blob_length;
-  my_afree((uchar*) record);
+  my_afree((uchar*) row_buff);
   DBUG_RETURN(error != HA_ERR_END_OF_FILE);
 }
 
@@ -1700,11 +1943,10 @@ static int make_huff_tree(HUFF_TREE *huff_tree, HUFF_COUNTS *huff_counts)
   return 0;
 }
 
-static int compare_tree(void* cmp_arg __attribute__((unused)),
-			const uchar *s, const uchar *t)
+static int compare_tree(void* cmp_arg, const uchar *s, const uchar *t)
 {
   uint length;
-  for (length=global_count->field_length; length-- ;)
+  for (length=((HUFF_COUNTS*) cmp_arg)->field_length; length-- ;)
     if (*s++ != *t++)
       return (int) s[-1] - (int) t[-1];
   return 0;
@@ -2676,7 +2918,6 @@ static int compress_isam_file(PACK_MRG_INFO *mrg, HUFF_COUNTS *huff_counts)
 	  start_pos=end_pos;
 	  break;
 	case FIELD_INTERVALL:
-	  global_count=count;
 	  pos=(uchar*) tree_search(&count->int_tree, start_pos,
 				  count->int_tree.custom_arg);
 	  intervall=(uint) (pos - count->tree_buff)/field_length;
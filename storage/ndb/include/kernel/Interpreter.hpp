@@ -72,6 +72,7 @@ public:
   STATIC_CONST( BRANCH_ATTR_EQ_NULL   = 24 );
   STATIC_CONST( BRANCH_ATTR_NE_NULL   = 25 );
   STATIC_CONST( BRANCH_ATTR_OP_ARG_2  = 26 );
+  STATIC_CONST( BRANCH_ATTR_OP_ATTR   = 27 );
 
   /**
    * Macros for creating code
@@ -134,12 +135,28 @@ public:
   static Uint32 BranchColParameter(BinaryCondition cond);
   static Uint32 BranchColParameter_2(Uint32 AttrId, Uint32 ParamNo);
 
+  /**
+   * Branch OP_ATTR, compare two attributes of the same type
+   * (EQ - GE only)
+   *
+   * a = Attribute id             -  16 bits
+   * r = Attribute id compared to -  16 bits, in place of the string
+   *
+   *           1111111111222222222233
+   * 01234567890123456789012345678901
+   * iiiiii      ttttbbbbbbbbbbbbbbbb
+   * aaaaaaaaaaaaaaaarrrrrrrrrrrrrrrr
+   */
+  static Uint32 BranchColAttr(BinaryCondition cond);
+  static Uint32 BranchColAttr_2(Uint32 AttrId, Uint32 ArgAttrId);
+
   static Uint32 getBinaryCondition(Uint32 op1);
   static Uint32 getArrayLengthDiff(Uint32 op1);
   static Uint32 isVarchar(Uint32 op1);
   static Uint32 getBranchCol_AttrId(Uint32 op2);
   static Uint32 getBranchCol_Len(Uint32 op2);
   static Uint32 getBranchCol_ParamNo(Uint32 op2);
+  static Uint32 getBranchCol_ArgAttrId(Uint32 op2);
   
   /**
    * Macros for decoding code
@@ -249,6 +266,19 @@ Interpreter::BranchColParameter_2(Uint32 AttrId, Uint32 ParamNo){
   return (AttrId << 16) + ParamNo;
 }
 
+inline
+Uint32
+Interpreter::BranchColAttr(BinaryCondition cond)
+{
+  return BRANCH_ATTR_OP_ATTR + (cond << 12);
+}
+
+inline
+Uint32
+Interpreter::BranchColAttr_2(Uint32 AttrId, Uint32 ArgAttrId){
+  return (AttrId << 16) + ArgAttrId;
+}
+
 inline
 Uint32 
 Interpreter::BranchCol_2(Uint32 AttrId, Uint32 Len){
@@ -297,6 +327,12 @@ Interpreter::getBranchCol_ParamNo(Uint32 op){
   return op & 0xFFFF;
 }
 
+inline
+Uint32
+Interpreter::getBranchCol_ArgAttrId(Uint32 op){
+  return op & 0xFFFF;
+}
+
 inline
 Uint32
 Interpreter::ExitOK(){
@@ -390,6 +426,7 @@ Interpreter::getInstructionPreProcessingInfo(Uint32 *op,
     processing= LABEL_ADDRESS_REPLACEMENT;
     return op+2;
   }
+  case BRANCH_ATTR_OP_ATTR:
   case BRANCH_ATTR_EQ_NULL:
   case BRANCH_ATTR_NE_NULL:
     processing= LABEL_ADDRESS_REPLACEMENT;
@@ -32,7 +32,7 @@ class AccFragReq {
    */
   friend class Dbacc;
 public:
-  STATIC_CONST( SignalLength = 12 );
+  STATIC_CONST( SignalLength = 14 );
 
 private:
   Uint32 userPtr;
@@ -47,6 +47,8 @@ private:
   Uint32 lhFragBits;
   Uint32 lhDirBits;
   Uint32 keyLength;
+  Uint32 minRowsLow;  // MIN_ROWS of the fragment, used to pre-size it
+  Uint32 minRowsHigh;
 };
 
 class AccFragConf {
@@ -234,12 +234,16 @@ class BackupFragmentRef {
   friend bool printBACKUP_FRAGMENT_REF(FILE *, const Uint32 *, Uint32, Uint16);
 public:
   STATIC_CONST( SignalLength = 5 );
+  STATIC_CONST( SignalLength_v2 = 7 ); // With tableId and fragmentNo
 
 private:
   Uint32 backupId;
   Uint32 backupPtr;
   Uint32 errorCode;
   Uint32 nodeId;
+  Uint32 unused;
+  Uint32 tableId;
+  Uint32 fragmentNo;
 };
 
 class BackupFragmentConf {
@@ -202,6 +202,11 @@
 #define CFG_DB_FREE_PCT                  630
 
 /* 632 used for CFG_DB_NO_REDOLOG_PARTS */
+#define CFG_DB_MAX_SEND_DELAY            633
+#define CFG_DB_AUTO_THREAD_PLACEMENT     634
+#define CFG_DB_ODIRECT_NATIVE_AIO        635
+#define CFG_DB_TUX_NORM_KEYS             636
+#define CFG_DB_BACKUP_DATA_FILE_PARTS    637
 
 #define CFG_NODE_ARBIT_RANK           200
 #define CFG_NODE_ARBIT_DELAY          201
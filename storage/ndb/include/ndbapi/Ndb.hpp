@@ -1308,6 +1308,19 @@ public:
   const NdbEventOperation*
     getGCIEventOperations(Uint32* iter, Uint32* event_types);
   
+  /**
+   * Limit the memory used by this Ndb object for buffering events
+   * which have been received but not yet consumed with nextEvent().
+   * When the limit is reached, new data events are discarded
+   * and their epochs are reported as inconsistent, see
+   * isConsistent() and isConsistentGCI().  Events are buffered again
+   * when the consumer has freed memory below the limit.
+   *
+   * @param sz  the limit in bytes, 0 (the default) means no limit
+   */
+  void setEventBufferMaxAlloc(unsigned sz);
+  unsigned getEventBufferMaxAlloc() const;
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_INTERNAL
   int flushIncompleteEvents(Uint64 gci);
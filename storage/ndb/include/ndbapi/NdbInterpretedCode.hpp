@@ -256,6 +256,38 @@ public:
   int branch_col_eq_null(Uint32 attrId, Uint32 Label);
   int branch_col_ne_null(Uint32 attrId, Uint32 Label);
 
+  /* Table based column to column conditional operations
+   * ---------------------------------------------------
+   * These instructions are used to branch based on comparisons
+   * between two columns of the same row.  Both columns must have
+   * the same type, length and character set.
+   * Comparisons with NULL follow the same rules as above,
+   * NULL == NULL and NULL < any non-NULL value.
+   *
+   * These instructions require that the table being operated
+   * upon was supplied when the NdbInterpretedCode object was
+   * constructed.
+   *
+   * if ( ValueOf(attrId1) <cond> ValueOf(attrId2) )
+   *   goto Label;
+   *
+   * Space required        Buffer          Request message
+   *   branch_col_*_col    2 words         2 words
+   *
+   * Requires data nodes supporting ndbd_interpreter_branch_col_col().
+   *
+   * @param attrId1   first column to compare
+   * @param attrId2   second column to compare
+   * @param Label     Program label to jump to if condition is true
+   * @return 0 if successful, -1 otherwise.
+   */
+  int branch_col_eq_col(Uint32 attrId1, Uint32 attrId2, Uint32 Label);
+  int branch_col_ne_col(Uint32 attrId1, Uint32 attrId2, Uint32 Label);
+  int branch_col_lt_col(Uint32 attrId1, Uint32 attrId2, Uint32 Label);
+  int branch_col_le_col(Uint32 attrId1, Uint32 attrId2, Uint32 Label);
+  int branch_col_gt_col(Uint32 attrId1, Uint32 attrId2, Uint32 Label);
+  int branch_col_ge_col(Uint32 attrId1, Uint32 attrId2, Uint32 Label);
+
 
   /* Table based pattern match conditional operations
    * ------------------------------------------------
@@ -644,7 +676,8 @@ private:
     BranchToBadLabel    = 4221,
     BadLength           = 4209,
     BadSubNumber        = 4227,
-    BadState            = 4231
+    BadState            = 4231,
+    BadColumnTypes      = 4556
   };
 
   int error(Uint32 code);
@@ -661,6 +694,8 @@ private:
   int write_attr_impl(const NdbColumnImpl *c, Uint32 RegSource);
   int branch_col(Uint32 branch_type, Uint32 attrId, const void * val,
                  Uint32 len, Uint32 label);
+  int branch_col_col(Uint32 branch_type, Uint32 attrId1, Uint32 attrId2,
+                     Uint32 label);
   int getInfo(Uint32 number, CodeMetaInfo &info) const;
   static int compareMetaInfo(const void *a, 
                              const void *b);
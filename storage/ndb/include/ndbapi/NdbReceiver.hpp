@@ -108,11 +108,13 @@ private:
   void calculate_batch_size(const NdbImpl&,
                             Uint32 parallelism,
                             Uint32& batch_size,
-                            Uint32& batch_byte_size);
+                            Uint32& batch_byte_size,
+                            Uint32 rowsize = 0);
 
   void calculate_batch_size(Uint32 parallelism,
                             Uint32& batch_size,
-                            Uint32& batch_byte_size) const;
+                            Uint32& batch_byte_size,
+                            Uint32 rowsize = 0) const;
 
   /*
     Set up buffers for receiving TRANSID_AI and KEYINFO20 signals
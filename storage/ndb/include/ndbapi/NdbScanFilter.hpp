@@ -209,6 +209,17 @@ public:
    *  return  0 if successful, -1 otherwise
    */
   int isnotnull(int ColId);          
+
+  /**
+   * Compare column <b>ColId1</b> with column <b>ColId2</b> of the
+   * same row, e.g. COND_LT is ColId1 < ColId2.
+   * Only COND_LE, COND_LT, COND_GE, COND_GT, COND_EQ and COND_NE are
+   * supported, and both columns must have the same type, see the
+   * branch_col_*_col instructions in NdbInterpretedCode.hpp
+   *
+   *  return  0 if successful, -1 otherwise
+   */
+  int cmp_cols(BinaryCondition cond, int ColId1, int ColId2);
   
   enum Error {
     FilterTooLarge = 4294
@@ -397,6 +397,23 @@ public:
 
   Uint64 get_bytes_sent(NodeId nodeId) const;
   Uint64 get_bytes_received(NodeId nodeId) const;
+
+  /**
+   * Histograms of the sends to a node.
+   *   Bucket 0 counts the zero values, bucket i > 0 counts
+   *   the values from 2^(i-1) to 2^i - 1, the last bucket
+   *   also counts all larger values.
+   */
+  enum SendHistogram {
+    SH_BYTES_PER_SEND = 0, // Bytes written per send system call
+    SH_SEND_DELAY = 1,     // Microseconds sends were delayed by send threads
+    SH_HISTOGRAMS = 2
+  };
+  enum { SEND_HISTOGRAM_BUCKETS = 24 };
+
+  Uint64 get_send_histogram(NodeId nodeId, Uint32 histogram,
+                            Uint32 bucket) const;
+  void update_send_delay(NodeId nodeId, Uint32 micros);
 protected:
   
 private:
@@ -483,6 +500,7 @@ private:
   Uint32 poll_TCP(Uint32 timeOutMillis, TransporterReceiveHandle&);
   Uint32 poll_SCI(Uint32 timeOutMillis, TransporterReceiveHandle&);
   Uint32 poll_SHM(Uint32 timeOutMillis, TransporterReceiveHandle&);
+  void set_shm_awake(TransporterReceiveHandle&, bool awake);
 
   int m_shm_own_pid;
   int m_transp_count;
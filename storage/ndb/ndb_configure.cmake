@@ -176,6 +176,22 @@ int main()
 }"
 HAVE_LINUX_FUTEX)
 
+# Linux native asynchronous I/O support
+CHECK_C_SOURCE_COMPILES("
+#include <linux/aio_abi.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+int main()
+{
+  aio_context_t ctx = 0;
+  struct iocb cb;
+  struct io_event ev;
+  cb.aio_lio_opcode = IOCB_CMD_PREAD;
+  ev.res = 0;
+  return syscall(SYS_io_setup, 1, &ctx);
+}"
+HAVE_LINUX_NATIVE_AIO)
+
 OPTION(WITH_NDBMTD
   "Build the MySQL Cluster multithreadded data node" ON)
 
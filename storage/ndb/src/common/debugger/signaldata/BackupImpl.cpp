@@ -86,6 +86,9 @@ printBACKUP_FRAGMENT_REF(FILE * out, const Uint32 * data, Uint32 l, Uint16 bno){
   BackupFragmentRef* sig = (BackupFragmentRef*)data;
   fprintf(out, " backupPtr: %d backupId: %d nodeId: %d errorCode: %d\n",
 	  sig->backupPtr, sig->backupId, sig->nodeId, sig->errorCode);
+  if (l >= BackupFragmentRef::SignalLength_v2)
+    fprintf(out, " tableId: %d fragmentNo: %d\n",
+            sig->tableId, sig->fragmentNo);
   return true;
 }
 
@@ -22,11 +22,17 @@
 #include <ndb_global.h>
 
 #include <NdbSleep.h>
+#include "../../kernel/vm/mt-asm.h"
 
 /**
  * These classes implement a circular buffer
  *
  * One reader and one writer
+ *
+ * The writer publishes data by storing the write index after the data,
+ * and the reader releases space by storing the read index after it is
+ * done with the data. The barriers below keep these stores ordered
+ * with the data on all platforms.
  */
 
 /**
@@ -81,8 +87,8 @@ private:
   Uint32 m_bufferSize;
   Uint32 m_readIndex;
 
-  Uint32 * m_sharedReadIndex;
-  Uint32 * m_sharedWriteIndex;
+  volatile Uint32 * m_sharedReadIndex;
+  volatile Uint32 * m_sharedWriteIndex;
 };
 
 inline 
@@ -104,6 +110,7 @@ SHM_Reader::getReadPtr(Uint32 * & ptr, Uint32 * & eod)
 {
   Uint32 tReadIndex  = m_readIndex;
   Uint32 tWriteIndex = * m_sharedWriteIndex;
+  rmb();
   
   ptr = (Uint32*)&m_startOfBuffer[tReadIndex];
   
@@ -130,6 +137,7 @@ SHM_Reader::updateReadPtr(Uint32 *ptr)
   }
 
   m_readIndex = tReadIndex;
+  mb();
   * m_sharedReadIndex = tReadIndex;
 }
 
@@ -173,8 +181,8 @@ private:
   
   Uint32 m_writeIndex;
   
-  Uint32 * m_sharedReadIndex;
-  Uint32 * m_sharedWriteIndex;
+  volatile Uint32 * m_sharedReadIndex;
+  volatile Uint32 * m_sharedWriteIndex;
 };
 
 inline
@@ -216,6 +224,7 @@ SHM_Writer::updateWritePtr(Uint32 sz){
   }
 
   m_writeIndex = tWriteIndex;
+  wmb();
   * m_sharedWriteIndex = tWriteIndex;
 }
 
@@ -310,6 +319,7 @@ SHM_Writer::writev(const struct iovec *vec, int count)
   }
 
   m_writeIndex = tWriteIndex;
+  wmb();
   *m_sharedWriteIndex = tWriteIndex;
 
   return total;
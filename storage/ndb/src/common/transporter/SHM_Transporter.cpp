@@ -58,6 +58,8 @@ SHM_Transporter::SHM_Transporter(TransporterRegistry &t_reg,
   shmBuf = 0;
   reader = 0;
   writer = 0;
+  readerAwakeFlag = 0;
+  peerAwakeFlag = 0;
   
   setupBuffersDone=false;
 #ifdef DEBUG_TRANSPORTER
@@ -109,12 +111,14 @@ SHM_Transporter::setupBuffers(){
 
   Uint32 * sharedReadIndex1 = base1;
   Uint32 * sharedWriteIndex1 = base1 + 1;
+  Uint32 * sharedAwake1 = base1 + 2;
   serverStatusFlag = base1 + 4;
   char * startOfBuf1 = shmBuf+sharedSize;
 
   Uint32 * base2 = (Uint32*)(shmBuf + sizeOfBuffer + sharedSize);
   Uint32 * sharedReadIndex2 = base2;
   Uint32 * sharedWriteIndex2 = base2 + 1;
+  Uint32 * sharedAwake2 = base2 + 2;
   clientStatusFlag = base2 + 4;
   char * startOfBuf2 = ((char *)base2)+sharedSize;
   
@@ -137,6 +141,10 @@ SHM_Transporter::setupBuffers(){
 
     * sharedReadIndex2 = 0;
     * sharedWriteIndex2 = 0;
+
+    readerAwakeFlag = sharedAwake1;
+    peerAwakeFlag = sharedAwake2;
+    * readerAwakeFlag = 0;
     
     reader->clear();
     writer->clear();
@@ -179,6 +187,10 @@ SHM_Transporter::setupBuffers(){
     
     * sharedReadIndex2 = 0;
     * sharedWriteIndex1 = 0;
+
+    readerAwakeFlag = sharedAwake2;
+    peerAwakeFlag = sharedAwake1;
+    * readerAwakeFlag = 0;
     
     reader->clear();
     writer->clear();
@@ -394,7 +406,13 @@ SHM_Transporter::doSend()
 
   if (nBytesSent > 0)
   {
-    kill(m_remote_pid, g_ndb_shm_signum);
+    /**
+     * Only signal the receiver if it may be sleeping, the write index
+     * stored by writev() must be visible before the flag is read
+     */
+    mb();
+    if (* peerAwakeFlag == 0)
+      kill(m_remote_pid, g_ndb_shm_signum);
     iovec_data_sent(nBytesSent);
 
     if (Uint32(nBytesSent) == sum && (cnt != NDB_ARRAY_SIZE(iov)))
@@ -66,6 +66,18 @@ public:
   void updateReceivePtr(Uint32 * ptr){
     reader->updateReadPtr(ptr);
   }
+
+  /**
+   * Tell the peer whether we are polling our receive buffer.
+   * While awake the peer does not signal us after sending, so this
+   * must be cleared before sleeping, and the buffer checked once more
+   * after clearing it.
+   */
+  void set_awake(bool awake){
+    * readerAwakeFlag = awake ? 1 : 0;
+    if (!awake)
+      mb();
+  }
   
 protected:
   /**
@@ -136,6 +148,13 @@ private:
   key_t shmKey;
   volatile Uint32 * serverStatusFlag;
   volatile Uint32 * clientStatusFlag;  
+  /**
+   * Set by the reader of a buffer while it polls the buffer.
+   * Peers which do not know about it leave it 0, and are always
+   * signaled, as before.
+   */
+  volatile Uint32 * readerAwakeFlag;
+  volatile Uint32 * peerAwakeFlag;
   bool setupBuffersDone;
   
 #ifdef NDB_WIN32
@@ -317,6 +317,12 @@ TCP_Transporter::doSend() {
     int nBytesSent = (int)my_socket_writev(theSocket, iov+pos, iovcnt);
     assert(nBytesSent <= (int)remain);
 
+    if (nBytesSent > 0)
+    {
+      update_send_histogram(TransporterRegistry::SH_BYTES_PER_SEND,
+                            Uint32(nBytesSent));
+    }
+
     if (Uint32(nBytesSent) == remain)
     {
       sum_sent += nBytesSent;
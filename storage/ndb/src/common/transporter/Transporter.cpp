@@ -76,6 +76,7 @@ Transporter::Transporter(TransporterRegistry &t_reg,
   signalIdUsed    = _signalId;
 
   m_timeOutMillis = 3000;
+  bzero(m_send_histogram, sizeof(m_send_histogram));
 
   m_connect_address.s_addr= 0;
   if(s_port<0)
@@ -289,6 +290,7 @@ Transporter::doDisconnect() {
   m_connected = false;
   m_bytes_sent = 0;
   m_bytes_received = 0;
+  bzero(m_send_histogram, sizeof(m_send_histogram));
 
   disconnectImpl();
 }
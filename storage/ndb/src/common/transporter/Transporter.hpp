@@ -160,6 +160,21 @@ protected:
   Uint32 m_slowdown_limit;
   Uint64 m_bytes_sent;
   Uint64 m_bytes_received;
+  /* See TransporterRegistry::SendHistogram */
+  Uint64 m_send_histogram[TransporterRegistry::SH_HISTOGRAMS]
+                         [TransporterRegistry::SEND_HISTOGRAM_BUCKETS];
+
+  void update_send_histogram(Uint32 histogram, Uint32 value)
+  {
+    Uint32 bucket = 0;
+    while (value != 0 &&
+           bucket < TransporterRegistry::SEND_HISTOGRAM_BUCKETS - 1)
+    {
+      value >>= 1;
+      bucket++;
+    }
+    m_send_histogram[histogram][bucket]++;
+  }
 
 private:
 
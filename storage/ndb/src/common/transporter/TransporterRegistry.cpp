@@ -68,6 +68,23 @@ TransporterRegistry::get_bytes_received(NodeId node_id) const
   return theTransporters[node_id]->m_bytes_received;
 }
 
+Uint64
+TransporterRegistry::get_send_histogram(NodeId node_id, Uint32 histogram,
+                                        Uint32 bucket) const
+{
+  assert(histogram < SH_HISTOGRAMS);
+  assert(bucket < SEND_HISTOGRAM_BUCKETS);
+  return theTransporters[node_id]->m_send_histogram[histogram][bucket];
+}
+
+void
+TransporterRegistry::update_send_delay(NodeId node_id, Uint32 micros)
+{
+  Transporter *t = theTransporters[node_id];
+  if (t != NULL)
+    t->update_send_histogram(SH_SEND_DELAY, micros);
+}
+
 SocketServer::Session * TransporterService::newSession(NDB_SOCKET_TYPE sockfd)
 {
   DBUG_ENTER("SocketServer::Session * TransporterService::newSession");
@@ -1119,6 +1136,20 @@ TransporterRegistry::pollReceive(Uint32 timeOutMillis,
       retVal |= res;
       timeOutMillis = 0;
     }
+    else if (timeOutMillis > 0)
+    {
+      /**
+       * About to sleep, ask the SHM peers to signal us when they send,
+       * and check again for data sent before they saw the request
+       */
+      set_shm_awake(recvdata, false);
+      res = poll_SHM(0, recvdata);
+      if (res)
+      {
+        retVal |= res;
+        timeOutMillis = 0;
+      }
+    }
   }
 #endif
 
@@ -1172,6 +1203,7 @@ TransporterRegistry::pollReceive(Uint32 timeOutMillis,
 #ifdef NDB_SHM_TRANSPORTER
   if (nSHMTransporters > 0)
   {
+    set_shm_awake(recvdata, true);
     int res = poll_SHM(0, recvdata);
     retVal |= res;
   }
@@ -1211,6 +1243,23 @@ TransporterRegistry::poll_SCI(Uint32 timeOutMillis,
 
 
 #ifdef NDB_SHM_TRANSPORTER
+void
+TransporterRegistry::set_shm_awake(TransporterReceiveHandle& recvdata,
+                                   bool awake)
+{
+  for (int i = 0; i<nSHMTransporters; i++)
+  {
+    SHM_Transporter * t = theSHMTransporters[i];
+    Uint32 node_id = t->getRemoteNodeId();
+
+    if (!recvdata.m_transporters.get(node_id))
+      continue;
+
+    if (t->isConnected() && is_connected(node_id))
+      t->set_awake(awake);
+  }
+}
+
 static int g_shm_counter = 0;
 Uint32
 TransporterRegistry::poll_SHM(Uint32 timeOutMillis,
@@ -874,6 +874,41 @@ Backup::findTable(const BackupRecordPtr & ptr,
   return false;
 }
 
+bool
+Backup::findDataFile(const BackupRecordPtr & ptr,
+                     BackupFilePtr & filePtr, Uint32 part) const
+{
+  for(ptr.p->files.first(filePtr);
+      filePtr.i != RNIL;
+      ptr.p->files.next(filePtr)) {
+    jam();
+    if(filePtr.p->fileType == BackupFormat::DATA_FILE &&
+       filePtr.p->m_part == part){
+      jam();
+      return true;
+    }//if
+  }//for
+  filePtr.i = RNIL;
+  filePtr.p = 0;
+  return false;
+}
+
+bool
+Backup::isScanningDataFiles(const BackupRecordPtr & ptr) const
+{
+  BackupFilePtr filePtr;
+  for(ptr.p->files.first(filePtr);
+      filePtr.i != RNIL;
+      ptr.p->files.next(filePtr)) {
+    jam();
+    if(filePtr.p->m_flags & BackupFile::BF_SCAN_THREAD){
+      jam();
+      return true;
+    }//if
+  }//for
+  return false;
+}
+
 static Uint32 xps(Uint64 x, Uint64 ms)
 {
   float fx = float(x);
@@ -1011,6 +1046,7 @@ Backup::validSlaveTransitions[] = {
   DEFINED,  STARTED,
   STARTED,  STARTED, // Several START_BACKUP_REQ is sent
   STARTED,  SCANNING,
+  SCANNING, SCANNING, // Several data file parts scanned in parallel
   SCANNING, STARTED,
   STARTED,  STOPPING,
   STOPPING, CLEANING,
@@ -2265,33 +2301,53 @@ Backup::nextFragment(Signal* signal, BackupRecordPtr ptr)
   req->backupPtr = ptr.i;
   req->backupId = ptr.p->backupId;
 
+  /**
+   * Scan one fragment per LDM instance and node at a time, the fragments
+   *   of different LDM instances go to different data file parts.
+   *   Nodes not supporting data file parts scan one fragment at a time.
+   */
+  bool parallel = true;
   NdbNodeBitmask nodes = ptr.p->nodes;
-  Uint32 idleNodes = nodes.count();
-  Uint32 saveIdleNodes = idleNodes;
-  ndbrequire(idleNodes > 0);
+  ndbrequire(!nodes.isclear());
+  for (Uint32 nodeId = nodes.find(0); nodeId != NdbNodeBitmask::NotFound;
+       nodeId = nodes.find(nodeId + 1))
+  {
+    if (!ndbd_backup_data_file_parts(getNodeInfo(nodeId).m_version))
+    {
+      jam();
+      parallel = false;
+    }
+  }
+
+  Uint32 busyInstances[MAX_NDB_NODES];
+  bzero(busyInstances, sizeof(busyInstances));
+  bool scanning = false;
 
   TablePtr tabPtr;
   ptr.p->tables.first(tabPtr);
-  for(; tabPtr.i != RNIL && idleNodes > 0; ptr.p->tables.next(tabPtr)) {
+  for(; tabPtr.i != RNIL; ptr.p->tables.next(tabPtr)) {
     jam();
     FragmentPtr fragPtr;
     Array<Fragment> & frags = tabPtr.p->fragments;
     const Uint32 fragCount = frags.getSize();
     
-    for(Uint32 i = 0; i<fragCount && idleNodes > 0; i++) {
+    for(Uint32 i = 0; i<fragCount; i++) {
       jam();
       tabPtr.p->fragments.getPtr(fragPtr, i);
       const Uint32 nodeId = fragPtr.p->node;
+      const Uint32 instanceBit =
+        parallel ? 1 << (fragPtr.p->lqhInstanceKey % 32) : 1;
       if(fragPtr.p->scanning != 0) {
         jam();
-	ndbrequire(nodes.get(nodeId));
-	nodes.clear(nodeId);
-	idleNodes--;
-      } else if(fragPtr.p->scanned == 0 && nodes.get(nodeId)){
+	ndbrequire(ptr.p->nodes.get(nodeId));
+	busyInstances[nodeId] |= instanceBit;
+	scanning = true;
+      } else if(fragPtr.p->scanned == 0 && nodes.get(nodeId) &&
+                (busyInstances[nodeId] & instanceBit) == 0){
 	jam();
 	fragPtr.p->scanning = 1;
-	nodes.clear(nodeId);
-	idleNodes--;
+	busyInstances[nodeId] |= instanceBit;
+	scanning = true;
 	
 	req->tableId = tabPtr.p->tableId;
 	req->fragmentNo = i;
@@ -2305,7 +2361,7 @@ Backup::nextFragment(Signal* signal, BackupRecordPtr ptr)
     }//for
   }//for
   
-  if(idleNodes != saveIdleNodes){
+  if(scanning){
     jam();
     return;
   }//if
@@ -2418,6 +2474,8 @@ Backup::execBACKUP_FRAGMENT_REF(Signal* signal)
   const Uint32 ptrI = ref->backupPtr;
   //const Uint32 backupId = ref->backupId;
   const Uint32 nodeId = ref->nodeId;
+  const bool hasFragment =
+    signal->getLength() >= BackupFragmentRef::SignalLength_v2;
   
   BackupRecordPtr ptr LINT_SET_PTR;
   c_backupPool.getPtr(ptr, ptrI);
@@ -2433,7 +2491,9 @@ Backup::execBACKUP_FRAGMENT_REF(Signal* signal)
     for(Uint32 i = 0; i<fragCount; i++) {
       jam();
       tabPtr.p->fragments.getPtr(fragPtr, i);
-        if(fragPtr.p->scanning != 0 && nodeId == fragPtr.p->node) 
+        if(fragPtr.p->scanning != 0 && nodeId == fragPtr.p->node &&
+           (!hasFragment ||
+            (tabPtr.p->tableId == ref->tableId && i == ref->fragmentNo)))
       {
         jam();
 	ndbrequire(fragPtr.p->scanned == 0);
@@ -2839,12 +2899,21 @@ Backup::reportStatus(Signal* signal, BackupRecordPtr ptr,
     return;
   }
 
-  BackupFilePtr dataFilePtr LINT_SET_PTR;
-  ptr.p->files.getPtr(dataFilePtr, ptr.p->dataFilePtr);
-  signal->theData[3] = (Uint32)(dataFilePtr.p->operation.m_bytes_total & 0xFFFFFFFF);
-  signal->theData[4] = (Uint32)(dataFilePtr.p->operation.m_bytes_total >> 32);
-  signal->theData[5] = (Uint32)(dataFilePtr.p->operation.m_records_total & 0xFFFFFFFF);
-  signal->theData[6] = (Uint32)(dataFilePtr.p->operation.m_records_total >> 32);
+  Uint64 bytes_total = 0;
+  Uint64 records_total = 0;
+  BackupFilePtr dataFilePtr;
+  for(ptr.p->files.first(dataFilePtr); dataFilePtr.i != RNIL;
+      ptr.p->files.next(dataFilePtr))
+  {
+    if (dataFilePtr.p->fileType != BackupFormat::DATA_FILE)
+      continue;
+    bytes_total += dataFilePtr.p->operation.m_bytes_total;
+    records_total += dataFilePtr.p->operation.m_records_total;
+  }
+  signal->theData[3] = (Uint32)(bytes_total & 0xFFFFFFFF);
+  signal->theData[4] = (Uint32)(bytes_total >> 32);
+  signal->theData[5] = (Uint32)(records_total & 0xFFFFFFFF);
+  signal->theData[6] = (Uint32)(records_total >> 32);
  
   if (ptr.p->logFilePtr == RNIL)
   {
@@ -3098,7 +3167,8 @@ Backup::execDEFINE_BACKUP_REQ(Signal* signal)
   ptr.p->stopGCP = 0;
 
   /**
-   * Allocate files
+   * Allocate files, the data file is the last one and is allocated
+   * once per data file part
    */
   BackupFilePtr files[3];
   Uint32 noOfPages[] = {
@@ -3140,8 +3210,11 @@ Backup::execDEFINE_BACKUP_REQ(Signal* signal)
   
   ptr.p->ctlFilePtr = ptr.p->logFilePtr = ptr.p->dataFilePtr = RNIL;
 
-  for(Uint32 i = 0; i<3; i++) {
+  const Uint32 noOfDataFiles =
+    ptr.p->is_lcp() ? 1 : c_defaults.m_data_file_parts;
+  for(Uint32 f = 0; f < 2 + noOfDataFiles; f++) {
     jam();
+    const Uint32 i = f < 2 ? f : 2;
     if(ptr.p->is_lcp() && i != 2)
     {
       files[i].i = RNIL;
@@ -3159,6 +3232,7 @@ Backup::execDEFINE_BACKUP_REQ(Signal* signal)
     files[i].p->filePointer = RNIL;
     files[i].p->m_flags = 0;
     files[i].p->errorCode = 0;
+    files[i].p->m_part = f - i;
 
     if(ERROR_INSERTED(10035) || files[i].p->pages.seize(noOfPages[i]) == false)
     {
@@ -3197,7 +3271,8 @@ Backup::execDEFINE_BACKUP_REQ(Signal* signal)
       break;
     case 2:
       files[i].p->fileType = BackupFormat::DATA_FILE;
-      ptr.p->dataFilePtr = files[i].i;
+      if (files[i].p->m_part == 0)
+        ptr.p->dataFilePtr = files[i].i;
     }
     files[i].p->operation.m_bytes_total = 0;
     files[i].p->operation.m_records_total = 0;
@@ -3375,22 +3450,31 @@ Backup::openFiles(Signal* signal, BackupRecordPtr ptr)
   sendSignal(NDBFS_REF, GSN_FSOPENREQ, signal, FsOpenReq::SignalLength, JBA);
 
   /**
-   * Data file
+   * Data files, BACKUP-<id>-<part>.<node>.Data
+   *
+   * Each file is bound to its own Ndbfs thread, so the parts are
+   *   written and compressed in parallel.
    */
-  c_backupFilePool.getPtr(filePtr, ptr.p->dataFilePtr);
-  filePtr.p->m_flags |= BackupFile::BF_OPENING;
-
   if (c_defaults.m_o_direct)
     req->fileFlags |= FsOpenReq::OM_DIRECT;
   if (c_defaults.m_compressed_backup)
     req->fileFlags |= FsOpenReq::OM_GZ;
-  req->userPointer = filePtr.i;
-  FsOpenReq::setVersion(req->fileNumber, 2);
-  FsOpenReq::setSuffix(req->fileNumber, FsOpenReq::S_DATA);
-  FsOpenReq::v2_setSequence(req->fileNumber, ptr.p->backupId);
-  FsOpenReq::v2_setNodeId(req->fileNumber, getOwnNodeId());
-  FsOpenReq::v2_setCount(req->fileNumber, 0);
-  sendSignal(NDBFS_REF, GSN_FSOPENREQ, signal, FsOpenReq::SignalLength, JBA);
+  for(ptr.p->files.first(filePtr); filePtr.i!=RNIL;ptr.p->files.next(filePtr))
+  {
+    jam();
+    if (filePtr.p->fileType != BackupFormat::DATA_FILE)
+      continue;
+
+    filePtr.p->m_flags |= BackupFile::BF_OPENING;
+
+    req->userPointer = filePtr.i;
+    FsOpenReq::setVersion(req->fileNumber, 2);
+    FsOpenReq::setSuffix(req->fileNumber, FsOpenReq::S_DATA);
+    FsOpenReq::v2_setSequence(req->fileNumber, ptr.p->backupId);
+    FsOpenReq::v2_setNodeId(req->fileNumber, getOwnNodeId());
+    FsOpenReq::v2_setCount(req->fileNumber, filePtr.p->m_part);
+    sendSignal(NDBFS_REF, GSN_FSOPENREQ, signal, FsOpenReq::SignalLength, JBA);
+  }
 }
 
 void
@@ -3507,12 +3591,18 @@ Backup::openFilesReply(Signal* signal,
       return;
     }//if
     
-    ptr.p->files.getPtr(filePtr, ptr.p->dataFilePtr);
-    if(!insertFileHeader(BackupFormat::DATA_FILE, ptr.p, filePtr.p)) {
+    for(ptr.p->files.first(filePtr); filePtr.i != RNIL;
+        ptr.p->files.next(filePtr))
+    {
       jam();
-      defineBackupRef(signal, ptr, DefineBackupRef::FailedInsertFileHeader);
-      return;
-    }//if
+      if (filePtr.p->fileType != BackupFormat::DATA_FILE)
+        continue;
+      if(!insertFileHeader(BackupFormat::DATA_FILE, ptr.p, filePtr.p)) {
+        jam();
+        defineBackupRef(signal, ptr, DefineBackupRef::FailedInsertFileHeader);
+        return;
+      }//if
+    }
   }
   else
   {
@@ -4119,19 +4209,6 @@ Backup::execBACKUP_FRAGMENT_REQ(Signal* signal)
   BackupRecordPtr ptr LINT_SET_PTR;
   c_backupPool.getPtr(ptr, ptrI);
 
-  ptr.p->slaveState.setState(SCANNING);
-  ptr.p->m_gsn = GSN_BACKUP_FRAGMENT_REQ;
-
-  /**
-   * Get file
-   */
-  BackupFilePtr filePtr LINT_SET_PTR;
-  c_backupFilePool.getPtr(filePtr, ptr.p->dataFilePtr);
-  
-  ndbrequire(filePtr.p->backupPtr == ptrI);
-  ndbrequire(filePtr.p->m_flags == 
-	     (BackupFile::BF_OPEN | BackupFile::BF_FILE_THREAD));
-  
   /**
    * Get table
    */
@@ -4148,6 +4225,38 @@ Backup::execBACKUP_FRAGMENT_REQ(Signal* signal)
   ndbrequire(fragPtr.p->scanning == 0 || 
 	     refToNode(ptr.p->masterRef) == getOwnNodeId());
 
+  /**
+   * Get file, the data file part of the LDM instance owning the fragment
+   */
+  Uint32 part = 0;
+  if (!ptr.p->is_lcp())
+  {
+    jam();
+    ndbrequire(fragPtr.p->lqhInstanceKey != 0);
+    part = (fragPtr.p->lqhInstanceKey - 1) % c_defaults.m_data_file_parts;
+  }
+  BackupFilePtr filePtr LINT_SET_PTR;
+  ndbrequire(findDataFile(ptr, filePtr, part));
+  
+  ndbrequire(filePtr.p->backupPtr == ptrI);
+  if (filePtr.p->m_flags & BackupFile::BF_SCAN_THREAD)
+  {
+    jam();
+    /**
+     * The master has more data file parts than this node,
+     *   wait for the fragment scanned into this part
+     */
+    req->count = count + 1;
+    sendSignalWithDelay(reference(), GSN_BACKUP_FRAGMENT_REQ, signal, 50,
+			signal->length());
+    return;
+  }
+  ndbrequire(filePtr.p->m_flags == 
+	     (BackupFile::BF_OPEN | BackupFile::BF_FILE_THREAD));
+
+  ptr.p->slaveState.setState(SCANNING);
+  ptr.p->m_gsn = GSN_BACKUP_FRAGMENT_REQ;
+
   /**
    * Init operation
    */
@@ -4165,7 +4274,11 @@ Backup::execBACKUP_FRAGMENT_REQ(Signal* signal)
     req->count = count + 1;
     sendSignalWithDelay(reference(), GSN_BACKUP_FRAGMENT_REQ, signal, 50,
 			signal->length());
-    ptr.p->slaveState.setState(STARTED);
+    if (!isScanningDataFiles(ptr))
+    {
+      jam();
+      ptr.p->slaveState.setState(STARTED);
+    }
     return;
   }//if
   
@@ -4588,7 +4701,11 @@ Backup::fragmentCompleted(Signal* signal, BackupFilePtr filePtr)
 	       BackupFragmentConf::SignalLength, JBB);
 
     ptr.p->m_gsn = GSN_BACKUP_FRAGMENT_CONF;
-    ptr.p->slaveState.setState(STARTED);
+    if (!isScanningDataFiles(ptr))
+    {
+      jam();
+      ptr.p->slaveState.setState(STARTED);
+    }
   }
   return;
 }
@@ -4606,8 +4723,11 @@ Backup::backupFragmentRef(Signal * signal, BackupFilePtr filePtr)
   ref->backupPtr = ptr.i;
   ref->nodeId = getOwnNodeId();
   ref->errorCode = filePtr.p->errorCode;
+  ref->unused = 0;
+  ref->tableId = filePtr.p->tableId;
+  ref->fragmentNo = filePtr.p->fragmentNo;
   sendSignal(ptr.p->masterRef, GSN_BACKUP_FRAGMENT_REF, signal,
-	     BackupFragmentRef::SignalLength, JBB);
+	     BackupFragmentRef::SignalLength_v2, JBB);
 }
  
 void
@@ -315,7 +315,7 @@ public:
   typedef Ptr<TriggerRecord> TriggerPtr;
   
   /**
-   * BackupFile - At least 3 per backup
+   * BackupFile - At least 3 per backup, ctl + log + one per data file part
    */
   struct BackupFile {
     BackupFile(Backup & backup, ArrayPool<Page32> & pp) 
@@ -327,6 +327,7 @@ public:
     Uint32 filePointer;
     Uint32 m_retry_count;
     Uint32 errorCode;
+    Uint32 m_part;    // Data file part, see Config::m_data_file_parts
     BackupFormat::FileType fileType;
     OperationRecord operation;
     
@@ -542,6 +543,13 @@ public:
     Uint32 m_o_direct;
     Uint32   m_compressed_backup;
     Uint32 m_compressed_lcp;
+
+    /**
+     * Number of data files written in parallel by a backup, each with
+     * its own part of m_dataBufferSize and its own Ndbfs thread.
+     * A fragment is written to part (lqhInstanceKey - 1) % parts.
+     */
+    Uint32 m_data_file_parts;
   };
   
   /**
@@ -655,6 +663,8 @@ public:
 
   NodeId getMasterNodeId() const { return c_masterNodeId; }
   bool findTable(const BackupRecordPtr &, TablePtr &, Uint32 tableId) const;
+  bool findDataFile(const BackupRecordPtr &, BackupFilePtr &, Uint32 part) const;
+  bool isScanningDataFiles(const BackupRecordPtr &) const;
   bool parseTableDescription(Signal*, BackupRecordPtr ptr, TablePtr, const Uint32*, Uint32);
   
   bool insertFileHeader(BackupFormat::FileType, BackupRecord*, BackupFile*);
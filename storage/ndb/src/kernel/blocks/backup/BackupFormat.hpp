@@ -80,6 +80,11 @@ struct BackupFormat {
   
   /**
    * Data file formats
+   *
+   * A node writes one data file per data file part (BackupDataFileParts),
+   *   named BACKUP-<id>-<part>.<node>.Data.  Each part has its own file
+   *   header and holds whole fragments, so the parts can be read
+   *   independently of each other.
    */
   struct DataFile {
 
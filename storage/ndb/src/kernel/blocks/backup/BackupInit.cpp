@@ -175,6 +175,19 @@ Backup::execREAD_CONFIG_REQ(Signal* signal)
   ndb_mgm_get_int_parameter(p, CFG_DB_COMPRESSED_LCP,
 			    &c_defaults.m_compressed_lcp);
 
+  /**
+   * One data file part per LDM instance unless configured
+   */
+  Uint32 dataFileParts = 0;
+  ndb_mgm_get_int_parameter(p, CFG_DB_BACKUP_DATA_FILE_PARTS,
+                            &dataFileParts);
+  if (dataFileParts == 0)
+    dataFileParts = globalData.ndbMtLqhWorkers;
+  if (dataFileParts == 0)
+    dataFileParts = 1;
+  if (dataFileParts > MAX_NDBMT_LQH_WORKERS)
+    dataFileParts = MAX_NDBMT_LQH_WORKERS;
+
   m_backup_report_frequency = 0;
   ndb_mgm_get_int_parameter(p, CFG_DB_BACKUP_REPORT_FREQUENCY, 
 			    &m_backup_report_frequency);
@@ -196,7 +209,7 @@ Backup::execREAD_CONFIG_REQ(Signal* signal)
 
   c_nodePool.setSize(MAX_NDB_NODES);
   c_backupPool.setSize(noBackups + 1);
-  c_backupFilePool.setSize(3 * noBackups + 1);
+  c_backupFilePool.setSize((2 + dataFileParts) * noBackups + 1);
   c_tablePool.setSize(noBackups * noTables + 1);
   c_triggerPool.setSize(noBackups * 3 * noTables);
   c_fragmentPool.setSize(noBackups * noFrags + 1);
@@ -230,22 +243,31 @@ Backup::execREAD_CONFIG_REQ(Signal* signal)
    */
   Uint32 extra = szWrite + 4 * (/* align * 512b */ 128);
 
-  szDataBuf += extra;
+  /**
+   * Split the data buffer between the data file parts,
+   *   keep at least 2M per part
+   */
+  while (dataFileParts > 1 && szDataBuf / dataFileParts < 2 * 1024 * 1024)
+    dataFileParts--;
+  c_defaults.m_data_file_parts = dataFileParts;
+  const Uint32 szLcpBuf = szDataBuf + extra;
+  szDataBuf = szDataBuf / dataFileParts + extra;
   szLogBuf += extra;
 
   c_defaults.m_logBufferSize = szLogBuf;
   c_defaults.m_dataBufferSize = szDataBuf;
   c_defaults.m_minWriteSize = szWrite;
   c_defaults.m_maxWriteSize = maxWriteSize;
-  c_defaults.m_lcp_buffer_size = szDataBuf;
+  c_defaults.m_lcp_buffer_size = szLcpBuf;
 
   Uint32 szMem = 0;
   ndb_mgm_get_int_parameter(p, CFG_DB_BACKUP_MEM, &szMem);
 
-  szMem += 3 * extra; // (data+log+lcp);
+  szMem += (dataFileParts + 2) * extra; // (data parts+log+lcp);
   Uint32 noPages =
     (szMem + sizeof(Page32) - 1) / sizeof(Page32) +
-    (c_defaults.m_lcp_buffer_size + sizeof(Page32) - 1) / sizeof(Page32);
+    (c_defaults.m_lcp_buffer_size + sizeof(Page32) - 1) / sizeof(Page32) +
+    dataFileParts; // each part rounded up to whole pages
 
   // We need to allocate an additional of 2 pages. 1 page because of a bug in
   // ArrayPool and another one for DICTTAINFO.
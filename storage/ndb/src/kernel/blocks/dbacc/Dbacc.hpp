@@ -83,6 +83,7 @@ ndbout << "Ptr: " << ptr.p->word32 << " \tIndex: " << tmp_string << " \tValue: "
 #define ZFREE_LIMIT 65
 #define ZNO_CONTAINERS 64
 #define ZELEM_HEAD_SIZE 1
+#define ZEXPAND_SPLIT_BATCH 8
 /* ------------------------------------------------------------------------- */
 /*  THESE CONSTANTS DEFINE THE USE OF THE PAGE HEADER IN THE INDEX PAGES.    */
 /* ------------------------------------------------------------------------- */
@@ -414,6 +415,8 @@ struct Fragmentrec {
 // bucketSize * hysteresis
 // Since at most RNIL 8KiB-pages can be used for a fragment, the extreme values
 // for slack will be within -2^43 and +2^43 words.
+// minBuckets is the number of buckets needed for the MIN_ROWS of the table.
+// The fragment is expanded to it when created and never shrinks below it.
 //-----------------------------------------------------------------------------
   LHLevelRH level;
   Uint32 localkeylen;
@@ -421,6 +424,7 @@ struct Fragmentrec {
   Uint32 minloadfactor;
   Int64 slack;
   Int64 slackCheck;
+  Uint32 minBuckets;
 
 //-----------------------------------------------------------------------------
 // nextfreefrag is the next free fragment if linked into a free list
@@ -481,6 +485,7 @@ struct Fragmentrec {
   Uint8 dirRangeFull;
 
 public:
+  bool needExpand() const;
   Uint32 getPageNumber(Uint32 bucket_number) const;
   Uint32 getPageIndex(Uint32 bucket_number) const;
   bool enough_valid_bits(LHBits16 const& reduced_hash_value) const;
@@ -840,6 +845,7 @@ private:
   void acckeyref1Lab(Signal* signal, Uint32 result_code);
   void insertelementLab(Signal* signal);
   void checkNextFragmentLab(Signal* signal);
+  bool expandBucket(Signal* signal);
   void endofexpLab(Signal* signal);
   void endofshrinkbucketLab(Signal* signal);
   void senddatapagesLab(Signal* signal);
@@ -1109,6 +1115,13 @@ private:
   Uint32 c_memusage_report_frequency;
 };
 
+inline bool Dbacc::Fragmentrec::needExpand() const
+{
+  if (level.isFull())
+    return false;
+  return slack < 0 || level.getSize() < minBuckets;
+}
+
 inline Uint32 Dbacc::Fragmentrec::getPageNumber(Uint32 bucket_number) const
 {
   assert(bucket_number < RNIL);
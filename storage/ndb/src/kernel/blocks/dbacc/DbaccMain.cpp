@@ -528,6 +528,15 @@ void Dbacc::execACCFRAGREQ(Signal* signal)
   conf->fragPtr[1] = RNIL;
   conf->rootHashCheck = fragrecptr.p->roothashcheck;
   sendSignal(retRef, GSN_ACCFRAGCONF, signal, AccFragConf::SignalLength, JBB);
+
+  if (fragrecptr.p->needExpand())
+  {
+    jam();
+    /* Pre-size the fragment to minBuckets */
+    signal->theData[0] = fragrecptr.i;
+    fragrecptr.p->expandOrShrinkQueued = true;
+    sendSignal(cownBlockref, GSN_EXPANDCHECK2, signal, 1, JBB);
+  }
 }//Dbacc::execACCFRAGREQ()
 
 void Dbacc::addFragRefuse(Signal* signal, Uint32 errorCode) 
@@ -2341,7 +2350,8 @@ void Dbacc::execACC_COMMITREQ(Signal* signal)
 	fragrecptr.p->slack += fragrecptr.p->elementLength;
 	if (fragrecptr.p->slack > fragrecptr.p->slackCheck) { 
           /* TIME FOR JOIN BUCKETS PROCESS */
-	  if (fragrecptr.p->expandCounter > 0) {
+	  if (fragrecptr.p->expandCounter > 0 &&
+              fragrecptr.p->level.getSize() > fragrecptr.p->minBuckets) {
             if (!fragrecptr.p->expandOrShrinkQueued)
             {
 	      jam();
@@ -2356,7 +2366,7 @@ void Dbacc::execACC_COMMITREQ(Signal* signal)
       jam();                                                /* EXPAND PROCESS HANDLING */
       fragrecptr.p->noOfElements++;
       fragrecptr.p->slack -= fragrecptr.p->elementLength;
-      if (fragrecptr.p->slack < 0 && !fragrecptr.p->level.isFull())
+      if (fragrecptr.p->needExpand())
       {
 	/* IT MEANS THAT IF SLACK < ZERO */
         if (!fragrecptr.p->expandOrShrinkQueued)
@@ -5178,10 +5188,40 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
   }
 
   fragrecptr.i = signal->theData[0];
-  tresult = 0;	/* 0= FALSE,1= TRUE,> ZLIMIT_OF_ERROR =ERRORCODE */
   ptrCheckGuard(fragrecptr, cfragmentsize, fragmentrec);
   fragrecptr.p->expandOrShrinkQueued = false;
-  if (fragrecptr.p->slack > 0) {
+
+  /**
+   * Split up to ZEXPAND_SPLIT_BATCH buckets per signal, a bulk insert
+   * otherwise pays for one signal round trip per split bucket.
+   */
+  for (Uint32 i = 0; i < ZEXPAND_SPLIT_BATCH; i++)
+  {
+    if (!expandBucket(signal))
+    {
+      jam();
+      return;
+    }
+  }
+
+  if (fragrecptr.p->needExpand())
+  {
+    jam();
+    /* --------------------------------------------------------------------------------- */
+    /*       IT IS STILL NECESSARY TO EXPAND THE FRAGMENT EVEN MORE. START IT FROM HERE  */
+    /*       WITHOUT WAITING FOR NEXT COMMIT ON THE FRAGMENT.                            */
+    /* --------------------------------------------------------------------------------- */
+    signal->theData[0] = fragrecptr.i;
+    fragrecptr.p->expandOrShrinkQueued = true;
+    sendSignal(cownBlockref, GSN_EXPANDCHECK2, signal, 1, JBB);
+  }
+}//Dbacc::execEXPANDCHECK2()
+
+bool Dbacc::expandBucket(Signal* signal)
+{
+  tresult = 0;	/* 0= FALSE,1= TRUE,> ZLIMIT_OF_ERROR =ERRORCODE */
+  if (fragrecptr.p->slack > 0 &&
+      fragrecptr.p->level.getSize() >= fragrecptr.p->minBuckets) {
     jam();
     /* IT MEANS THAT IF SLACK > ZERO */
     /*--------------------------------------------------------------*/
@@ -5194,7 +5234,7 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
       jam();
       fragrecptr.p->dirRangeFull = ZFALSE;
     }
-    return;
+    return false;
   }//if
   if (fragrecptr.p->firstOverflowRec == RNIL) {
     jam();
@@ -5205,7 +5245,7 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
       /* WE COULD NOT ALLOCATE ANY OVERFLOW PAGE. THUS WE HAVE TO STOP*/
       /* THE EXPAND SINCE WE CANNOT GUARANTEE ITS COMPLETION.         */
       /*--------------------------------------------------------------*/
-      return;
+      return false;
     }//if
   }//if
   if (cfirstfreepage == RNIL)
@@ -5215,7 +5255,7 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
     /* PAGES. THIS MEANS THAT WE COULD BE FORCED TO CRASH SINCE WE  */
     /* CANNOT COMPLETE THE EXPAND. TO AVOID THE CRASH WE EXIT HERE. */
     /*--------------------------------------------------------------*/
-    return;
+    return false;
   }//if
 
   if (fragrecptr.p->level.isFull())
@@ -5225,7 +5265,7 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
      * The level structure does not allow more buckets.
      * Do not expand.
      */
-    return;
+    return false;
   }
 
   Uint32 splitBucket;
@@ -5240,7 +5280,7 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
     // A scan state was inconsistent with performing an expand
     // operation.
     /*--------------------------------------------------------------*/
-    return;
+    return false;
   }//if
 
   /*--------------------------------------------------------------------------*/
@@ -5267,14 +5307,14 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
     seizePage(signal);
     if (tresult > ZLIMIT_OF_ERROR) {
       jam();
-      return;
+      return false;
     }//if
     if (!setPagePtr(fragrecptr.p->directory, texpDirInd, spPageptr.i))
     {
       jam();
       // TODO: should release seized page
       tresult = ZDIR_RANGE_FULL_ERROR;
-      return;
+      return false;
     }
     tipPageId = texpDirInd;
     inpPageptr = spPageptr;
@@ -5301,14 +5341,14 @@ void Dbacc::execEXPANDCHECK2(Signal* signal)
   if (excPageptr.i == RNIL) {
     jam();
     endofexpLab(signal);	/* EMPTY BUCKET */
-    return;
+    return true;
   }//if
   fragrecptr.p->expReceiveForward = ZTRUE;
   ptrCheckGuard(excPageptr, cpagesize, page8);
   expandcontainer(signal);
   endofexpLab(signal);
-  return;
-}//Dbacc::execEXPANDCHECK2()
+  return true;
+}//Dbacc::expandBucket()
   
 void Dbacc::endofexpLab(Signal* signal) 
 {
@@ -5318,18 +5358,6 @@ void Dbacc::endofexpLab(Signal* signal)
   Uint32 noOfBuckets = fragrecptr.p->level.getSize();
   Uint32 Thysteres = fragrecptr.p->maxloadfactor - fragrecptr.p->minloadfactor;
   fragrecptr.p->slackCheck = Int64(noOfBuckets) * Thysteres;
-  if (fragrecptr.p->slack < 0 && !fragrecptr.p->level.isFull())
-  {
-    jam();
-    /* IT MEANS THAT IF SLACK < ZERO */
-    /* --------------------------------------------------------------------------------- */
-    /*       IT IS STILL NECESSARY TO EXPAND THE FRAGMENT EVEN MORE. START IT FROM HERE  */
-    /*       WITHOUT WAITING FOR NEXT COMMIT ON THE FRAGMENT.                            */
-    /* --------------------------------------------------------------------------------- */
-    signal->theData[0] = fragrecptr.i;
-    fragrecptr.p->expandOrShrinkQueued = true;
-    sendSignal(cownBlockref, GSN_EXPANDCHECK2, signal, 1, JBB);
-  }//if
   return;
 }//Dbacc::endofexpLab()
 
@@ -5810,6 +5838,13 @@ void Dbacc::execSHRINKCHECK2(Signal* signal)
     /*--------------------------------------------------------------*/
     return;
   }//if
+  if (fragrecptr.p->level.getSize() <= fragrecptr.p->minBuckets) {
+    jam();
+    /*--------------------------------------------------------------*/
+    /* DO NOT SHRINK BELOW THE SIZE THE FRAGMENT WAS PRE-SIZED TO.  */
+    /*--------------------------------------------------------------*/
+    return;
+  }//if
   if (fragrecptr.p->firstOverflowRec == RNIL) {
     jam();
     allocOverflowPage(signal);
@@ -6341,6 +6376,16 @@ void Dbacc::initFragAdd(Signal* signal,
     regFragPtr.p->scan[i] = RNIL;
   }//for
   
+  /**
+   * Pre-size the fragment for the expected number of rows, the buckets
+   * are split in the background from execACCFRAGREQ.
+   */
+  const Uint64 minRows = req->minRowsLow + (Uint64(req->minRowsHigh) << 32);
+  const Uint64 minBuckets =
+    (minRows * regFragPtr.p->elementLength + maxLoadFactor - 1) / maxLoadFactor;
+  regFragPtr.p->minBuckets =
+    minBuckets < RNIL ? Uint32(minBuckets) : RNIL;
+
   Uint32 hasCharAttr = g_key_descriptor_pool.getPtr(req->tableId)->hasCharAttr;
   regFragPtr.p->hasCharAttr = hasCharAttr;
 }//Dbacc::initFragAdd()
@@ -2003,6 +2003,8 @@ void Dblqh::execLQHFRAGREQ(Signal* signal)
     accreq->lhFragBits = addfragptr.p->m_lqhFragReq.lh3DistrBits;
     accreq->lhDirBits = addfragptr.p->m_lqhFragReq.lh3PageBits;
     accreq->keyLength = addfragptr.p->m_lqhFragReq.keyLength;
+    accreq->minRowsLow = addfragptr.p->m_lqhFragReq.minRowsLow;
+    accreq->minRowsHigh = addfragptr.p->m_lqhFragReq.minRowsHigh;
     /* --------------------------------------------------------------------- */
     /* Send ACCFRAGREQ, when confirmation is received send 2 * TUPFRAGREQ to */
     /* create 2 tuple fragments on this node.                                */
@@ -3100,6 +3100,7 @@ int Dbtup::interpreterNextLab(Signal* signal,
 	  break;
 	}
 
+      case Interpreter::BRANCH_ATTR_OP_ATTR:
       case Interpreter::BRANCH_ATTR_OP_ARG_2:
       case Interpreter::BRANCH_ATTR_OP_ARG:{
 	jam();
@@ -3166,6 +3167,51 @@ int Dbtup::interpreterNextLab(Signal* signal,
           step = 0;
           s2 = (char*)(paramptr + 1);
         }
+        else if (Interpreter::getOpCode(theInstruction) ==
+                 Interpreter::BRANCH_ATTR_OP_ATTR)
+        {
+          jam();
+          /**
+           * Read the other attribute into the upper half of tmpArea,
+           * the lower half keeps tmpHabitant
+           */
+          Uint32 argAttrId = Interpreter::getBranchCol_ArgAttrId(ins2) << 16;
+          Uint32 * argArea = tmpArea + (tmpAreaSz / 2);
+          Int32 TnoDataR = readAttributes(req_struct,
+                                          &argAttrId, 1,
+                                          argArea, tmpAreaSz - tmpAreaSz / 2,
+                                          false);
+          if (TnoDataR < 0) {
+            jam();
+            terrorCode = Uint32(-TnoDataR);
+            tupkeyErrorLab(req_struct);
+            return -1;
+          }
+
+          // both attributes must have the same type and charset
+          argAttrId >>= 16;
+          Uint32 TargDescrIndex = req_struct->tablePtrP->tabDescriptor +
+            (argAttrId << ZAD_LOG_SIZE);
+          Uint32 TargDesc1 = tableDescriptor[TargDescrIndex].tabDescr;
+          Uint32 TargDesc2 = tableDescriptor[TargDescrIndex+1].tabDescr;
+          void * argcs = 0;
+          if (AttributeOffset::getCharsetFlag(TargDesc2))
+          {
+            Uint32 pos = AttributeOffset::getCharsetPos(TargDesc2);
+            argcs = req_struct->tablePtrP->charsetArray[pos];
+          }
+          if (unlikely(AttributeDescriptor::getType(TargDesc1) != typeId ||
+                       argcs != cs ||
+                       cond > Interpreter::GE))
+          {
+            return TUPKEY_abort(req_struct, 40);
+          }
+
+          AttributeHeader argah(argArea[0]);
+          argLen = argah.isNULL() ? 0 : argah.getByteSize();
+          step = 0;
+          s2 = (char*)(argArea + 1);
+        }
         
         if (typeId == NDB_TYPE_BIT)
         {
@@ -203,11 +203,20 @@ private:
   static const TreeEnt NullTreeEnt;
 
   /*
-   * Tree node has 3 parts:
+   * Tree node has 4 parts:
    *
    * 1) struct TreeNode - the header (6 words)
    * 2) some key values for min entry - the min prefix
-   * 3) list of TreeEnt (each 2 words)
+   * 3) optional list of normalized keys (each 1 word)
+   * 4) list of TreeEnt (each 2 words)
+   *
+   * The normalized key of an entry is an unsigned word whose order
+   * agrees with the order of the first index attribute.  NULL is 0.
+   * Different normalized keys decide a comparison without reading the
+   * tuple.  Equal ones do not decide anything.  They are stored only if
+   * ordered index normalized keys are configured and the first
+   * attribute is an integer type.  The list is contiguous, so a binary
+   * search within the node reads at most two cache lines of it.
    *
    * There are 3 links to other nodes: left child, right child, parent.
    * Occupancy (number of entries) is at least 1 except temporarily when
@@ -237,10 +246,12 @@ private:
     Uint8 m_prefSize;           // words in min prefix
     Uint8 m_minOccup;           // min entries in internal node
     Uint8 m_maxOccup;           // max entries in node
+    Uint8 m_normSize;           // words per entry in normalized keys
     TupLoc m_root;              // root node
     TreeHead();
     // methods
     Uint32* getPref(TreeNode* node) const;
+    Uint32* getNormList(TreeNode* node) const;
     TreeEnt* getEntList(TreeNode* node) const;
   };
 
@@ -311,6 +322,7 @@ private:
     DataBuffer<ScanBoundSegmentSize>::Head m_head;
     Uint16 m_cnt;       // number of attributes
     Int16 m_side;
+    Uint32 m_normKey;   // normalized key if m_cnt != 0
     ScanBound();
   };
   DataBuffer<ScanBoundSegmentSize>::DataBufferPool c_scanBoundPool;
@@ -416,7 +428,7 @@ private:
     State m_state;
     DictTabInfo::TableType m_tableType;
     Uint32 m_tableId;
-    Uint16 unused;
+    Uint16 m_normKeys;          // entries have normalized keys
     Uint16 m_numFrags;
     Uint32 m_fragId[MaxIndexFragments];
     Uint32 m_fragPtrI[MaxIndexFragments];
@@ -521,6 +533,7 @@ private:
     // access other parts of the node
     Uint32* getPref();
     TreeEnt getEnt(unsigned pos);
+    Uint32 getNormKey(unsigned pos);
     // for ndbrequire and ndbassert
     void progError(int line, int cause, const char* file);
   };
@@ -640,6 +653,7 @@ private:
   void deleteNode(NodeHandle& node);
   void freePreallocatedNode(Frag& frag);
   void setNodePref(struct TuxCtx &, NodeHandle& node);
+  Uint32 readNormKey(TuxCtx&, const Frag& frag, TreeEnt ent);
   // node operations
   void nodePushUp(TuxCtx&, NodeHandle& node, unsigned pos, const TreeEnt& ent, Uint32 scanList);
   void nodePushUpScans(NodeHandle& node, unsigned pos);
@@ -690,7 +704,7 @@ private:
   void scanFirst(ScanOpPtr scanPtr);
   void scanFind(ScanOpPtr scanPtr);
   void scanNext(ScanOpPtr scanPtr, bool fromMaintReq);
-  bool scanCheck(ScanOpPtr scanPtr, TreeEnt ent);
+  bool scanCheck(ScanOpPtr scanPtr, NodeHandle& node, unsigned pos);
   bool scanVisible(ScanOpPtr scanPtr, TreeEnt ent);
   void scanClose(Signal* signal, ScanOpPtr scanPtr);
   void abortAccLockOps(Signal* signal, ScanOpPtr scanPtr);
@@ -715,6 +729,9 @@ private:
    */
   int cmpSearchKey(TuxCtx&, const KeyDataC& searchKey, const KeyDataC& entryKey, Uint32 cnt);
   int cmpSearchBound(TuxCtx&, const KeyBoundC& searchBound, const KeyDataC& entryKey, Uint32 cnt);
+  bool isNormKeyType(Uint32 typeId);
+  Uint32 getNormKey(const KeyDataC& keyData, bool allNullable);
+  int cmpNormKey(Uint32 normKey1, Uint32 normKey2);
 
   /*
    * DbtuxStat.cpp
@@ -818,6 +835,9 @@ private:
 
   struct TuxCtx c_ctx; // Global Tux context, for everything build MT-index build
 
+  // normalized keys in new ordered indexes
+  bool c_normKeys;
+
   // index stats
   bool c_indexStatAutoUpdate;
   Uint32 c_indexStatSaveSize;
@@ -984,6 +1004,7 @@ Dbtux::TreeHead::TreeHead() :
   m_prefSize(0),
   m_minOccup(0),
   m_maxOccup(0),
+  m_normSize(0),
   m_root()
 {
 }
@@ -995,10 +1016,18 @@ Dbtux::TreeHead::getPref(TreeNode* node) const
   return ptr;
 }
 
+inline Uint32*
+Dbtux::TreeHead::getNormList(TreeNode* node) const
+{
+  Uint32* ptr = (Uint32*)node + NodeHeadSize + m_prefSize;
+  return ptr;
+}
+
 inline Dbtux::TreeEnt*
 Dbtux::TreeHead::getEntList(TreeNode* node) const
 {
-  Uint32* ptr = (Uint32*)node + NodeHeadSize + m_prefSize;
+  Uint32* ptr = (Uint32*)node + NodeHeadSize + m_prefSize +
+                m_maxOccup * m_normSize;
   return (TreeEnt*)ptr;
 }
 
@@ -1034,7 +1063,8 @@ inline
 Dbtux::ScanBound::ScanBound() :
   m_head(),
   m_cnt(0),
-  m_side(0)
+  m_side(0),
+  m_normKey(0)
 {
 }
 
@@ -1073,6 +1103,7 @@ Dbtux::Index::Index() :
   m_state(NotDefined),
   m_tableType(DictTabInfo::UndefTableType),
   m_tableId(RNIL),
+  m_normKeys(0),
   m_numFrags(0),
   m_descPage(RNIL),
   m_descOff(0),
@@ -1257,6 +1288,16 @@ Dbtux::NodeHandle::getEnt(unsigned pos)
   return entList[pos];
 }
 
+inline Uint32
+Dbtux::NodeHandle::getNormKey(unsigned pos)
+{
+  TreeHead& tree = m_frag.m_tree;
+  Uint32* normList = tree.getNormList(m_node);
+  const unsigned occup = m_node->m_occup;
+  ndbrequire(tree.m_normSize != 0 && pos < occup);
+  return normList[pos];
+}
+
 // stats
 
 inline
@@ -1444,4 +1485,123 @@ Dbtux::cmpSearchBound(TuxCtx& ctx, const KeyBoundC& searchBound, const KeyDataC&
   return ret;
 }
 
+/*
+ * Integer types have an order preserving 32-bit normalized key.
+ */
+inline bool
+Dbtux::isNormKeyType(Uint32 typeId)
+{
+  switch (typeId) {
+  case NdbSqlUtil::Type::Tinyint:
+  case NdbSqlUtil::Type::Tinyunsigned:
+  case NdbSqlUtil::Type::Smallint:
+  case NdbSqlUtil::Type::Smallunsigned:
+  case NdbSqlUtil::Type::Mediumint:
+  case NdbSqlUtil::Type::Mediumunsigned:
+  case NdbSqlUtil::Type::Int:
+  case NdbSqlUtil::Type::Unsigned:
+  case NdbSqlUtil::Type::Bigint:
+  case NdbSqlUtil::Type::Bigunsigned:
+    return true;
+  default:
+    break;
+  }
+  return false;
+}
+
+/*
+ * Normalized key of the first attribute.  Signed values have the sign
+ * bit flipped and 64-bit values keep the high word.  NULL is 0 and a
+ * non-NULL value is at least 1, so 0 and 1 may both become 1.
+ */
+inline Uint32
+Dbtux::getNormKey(const KeyDataC& keyData, bool allNullable)
+{
+  const KeySpec& keySpec = keyData.get_spec();
+  const KeyType& keyType = keySpec.get_type(0);
+  const Uint8* buf = static_cast<const Uint8*>(keyData.get_data_buf());
+  // null bit of first attribute is bit 0
+  if ((keyType.get_nullable() || allNullable) && (buf[0] & 1) != 0)
+    return 0;
+  const Uint8* p = &buf[keySpec.get_nullmask_len(allNullable)];
+  const Uint32 signBit = (Uint32)1 << 31;
+  Uint32 key = 0;
+  switch (keyType.get_type_id()) {
+  case NdbSqlUtil::Type::Tinyint:
+    {
+      Int8 v;
+      memcpy(&v, p, sizeof(v));
+      key = (Uint32)(Int32)v ^ signBit;
+    }
+    break;
+  case NdbSqlUtil::Type::Tinyunsigned:
+    key = p[0];
+    break;
+  case NdbSqlUtil::Type::Smallint:
+    {
+      Int16 v;
+      memcpy(&v, p, sizeof(v));
+      key = (Uint32)(Int32)v ^ signBit;
+    }
+    break;
+  case NdbSqlUtil::Type::Smallunsigned:
+    {
+      Uint16 v;
+      memcpy(&v, p, sizeof(v));
+      key = v;
+    }
+    break;
+  case NdbSqlUtil::Type::Mediumint:
+    {
+      uchar b[4];
+      memcpy(b, p, 3);
+      b[3] = 0;
+      key = (Uint32)(Int32)sint3korr(b) ^ signBit;
+    }
+    break;
+  case NdbSqlUtil::Type::Mediumunsigned:
+    {
+      uchar b[4];
+      memcpy(b, p, 3);
+      b[3] = 0;
+      key = (Uint32)uint3korr(b);
+    }
+    break;
+  case NdbSqlUtil::Type::Int:
+    {
+      Int32 v;
+      memcpy(&v, p, sizeof(v));
+      key = (Uint32)v ^ signBit;
+    }
+    break;
+  case NdbSqlUtil::Type::Unsigned:
+    memcpy(&key, p, sizeof(key));
+    break;
+  case NdbSqlUtil::Type::Bigint:
+    {
+      Int64 v;
+      memcpy(&v, p, sizeof(v));
+      key = (Uint32)((Uint64)v >> 32) ^ signBit;
+    }
+    break;
+  case NdbSqlUtil::Type::Bigunsigned:
+    {
+      Uint64 v;
+      memcpy(&v, p, sizeof(v));
+      key = (Uint32)(v >> 32);
+    }
+    break;
+  default:
+    ndbrequire(false);
+    break;
+  }
+  return key != 0 ? key : 1;
+}
+
+inline int
+Dbtux::cmpNormKey(Uint32 normKey1, Uint32 normKey2)
+{
+  return normKey1 < normKey2 ? -1 : normKey1 > normKey2 ? +1 : 0;
+}
+
 #endif
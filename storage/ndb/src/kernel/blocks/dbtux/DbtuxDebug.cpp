@@ -298,6 +298,16 @@ Dbtux::printNode(TuxCtx & ctx,
       out << "inline prefix mismatch" << endl;
     }
   }
+  // check normalized keys
+  if (tree.m_normSize != 0) {
+    for (unsigned j = 0; j < node.getOccup(); j++) {
+      if (readNormKey(ctx, frag, node.getEnt(j)) != node.getNormKey(j)) {
+        par.m_ok = false;
+        out << par.m_path << sep;
+        out << "normalized key mismatch at " << j << endl;
+      }
+    }
+  }
   // check ordering within node
   for (unsigned j = 1; j < node.getOccup(); j++) {
     const TreeEnt ent1 = node.getEnt(j - 1);
@@ -395,6 +405,7 @@ operator<<(NdbOut& out, const Dbtux::TreeHead& tree)
   out << " [prefSize " << dec << tree.m_prefSize << "]";
   out << " [minOccup " << dec << tree.m_minOccup << "]";
   out << " [maxOccup " << dec << tree.m_maxOccup << "]";
+  out << " [normSize " << dec << tree.m_normSize << "]";
   out << " [root " << hex << tree.m_root << "]";
   out << "]";
   return out;
@@ -476,6 +487,7 @@ operator<<(NdbOut& out, const Dbtux::Index& index)
   out << " [numAttrs " << dec << index.m_numAttrs << "]";
   out << " [prefAttrs " << dec << index.m_prefAttrs << "]";
   out << " [prefBytes " << dec << index.m_prefBytes << "]";
+  out << " [normKeys " << dec << index.m_normKeys << "]";
   out << " [statFragPtrI " << hex << index.m_statFragPtrI << "]";
   out << " [statLoadTime " << dec << index.m_statLoadTime << "]";
   out << "]";
@@ -524,9 +536,17 @@ operator<<(NdbOut& out, const Dbtux::NodeHandle& node)
   for (unsigned j = 0; j < tree.m_prefSize; j++)
     out << " " << hex << data[j];
   out << "]";
-  out << " [entList";
   unsigned numpos = node.m_node->m_occup;
-  data = (const Uint32*)node.m_node + Dbtux::NodeHeadSize + tree.m_prefSize;
+  if (tree.m_normSize != 0) {
+    out << " [normList";
+    data = (const Uint32*)node.m_node + Dbtux::NodeHeadSize + tree.m_prefSize;
+    for (unsigned pos = 0; pos < numpos; pos++)
+      out << " " << hex << data[pos];
+    out << "]";
+  }
+  out << " [entList";
+  data = (const Uint32*)node.m_node + Dbtux::NodeHeadSize + tree.m_prefSize +
+         tree.m_maxOccup * tree.m_normSize;
   const Dbtux::TreeEnt* entList = (const Dbtux::TreeEnt*)data;
   for (unsigned pos = 0; pos < numpos; pos++)
     out << " " << entList[pos];
@@ -32,6 +32,7 @@ Dbtux::Dbtux(Block_context& ctx, Uint32 instanceNumber) :
 #endif
   c_internalStartPhase(0),
   c_typeOfStart(NodeState::ST_ILLEGAL_TYPE),
+  c_normKeys(false),
   c_indexStatAutoUpdate(false),
   c_indexStatSaveSize(0),
   c_indexStatSaveScale(0),
@@ -233,6 +234,9 @@ Dbtux::execREAD_CONFIG_REQ(Signal* signal)
   ndbrequire(!ndb_mgm_get_int_parameter(p, CFG_TUX_SCAN_OP, &nScanOp));
   ndbrequire(!ndb_mgm_get_int_parameter(p, CFG_DB_BATCH_SIZE, &nScanBatch));
 
+  Uint32 nNormKeys = 0;
+  ndb_mgm_get_int_parameter(p, CFG_DB_TUX_NORM_KEYS, &nNormKeys);
+
   nStatAutoUpdate = 0;
   ndb_mgm_get_int_parameter(p, CFG_DB_INDEX_STAT_AUTO_UPDATE,
                             &nStatAutoUpdate);
@@ -270,6 +274,7 @@ Dbtux::execREAD_CONFIG_REQ(Signal* signal)
   c_scanBoundPool.setSize(nScanBoundWords);
   c_scanLockPool.setSize(nScanLock);
   c_statOpPool.setSize(nStatOp);
+  c_normKeys = (nNormKeys != 0);
   c_indexStatAutoUpdate = nStatAutoUpdate;
   c_indexStatSaveSize = nStatSaveSize;
   c_indexStatSaveScale = nStatSaveScale;
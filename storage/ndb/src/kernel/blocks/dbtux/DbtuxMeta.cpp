@@ -225,6 +225,9 @@ Dbtux::execTUX_ADD_ATTRREQ(Signal* signal)
         bytes = 0;
       indexPtr.p->m_prefAttrs = attrs;
       indexPtr.p->m_prefBytes = bytes;
+      // normalized keys of first attribute
+      indexPtr.p->m_normKeys =
+        c_normKeys && isNormKeyType(keySpec.get_type(0).get_type_id());
       // fragment is defined
 #ifdef VM_TRACE
       if (debugFlags & DebugMeta) {
@@ -335,6 +338,7 @@ Dbtux::execTUXFRAGREQ(Signal* signal)
     // make these configurable later
     tree.m_nodeSize = MAX_TTREE_NODE_SIZE;
     tree.m_prefSize = (indexPtr.p->m_prefBytes + 3) / 4;
+    tree.m_normSize = indexPtr.p->m_normKeys ? 1 : 0;
     const unsigned maxSlack = MAX_TTREE_NODE_SLACK;
     // size of header and min prefix
     const unsigned fixedSize = NodeHeadSize + tree.m_prefSize;
@@ -343,7 +347,8 @@ Dbtux::execTUXFRAGREQ(Signal* signal)
       errorCode = (TuxFragRef::ErrorCode)TuxAddAttrRef::InvalidNodeSize;
       break;
     }
-    const unsigned slots = (tree.m_nodeSize - fixedSize) / TreeEntSize;
+    const unsigned slots =
+      (tree.m_nodeSize - fixedSize) / (TreeEntSize + tree.m_normSize);
     tree.m_maxOccup = slots;
     // min occupancy of interior node must be at least 2
     if (! (2 + maxSlack <= tree.m_maxOccup)) {
@@ -362,6 +367,7 @@ Dbtux::execTUXFRAGREQ(Signal* signal)
         debugOut << " headSize=" << NodeHeadSize;
         debugOut << " prefSize=" << tree.m_prefSize;
         debugOut << " entrySize=" << TreeEntSize;
+        debugOut << " normSize=" << tree.m_normSize;
         debugOut << " minOccup=" << tree.m_minOccup;
         debugOut << " maxOccup=" << tree.m_maxOccup;
         debugOut << endl;
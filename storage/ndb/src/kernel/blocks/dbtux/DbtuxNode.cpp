@@ -101,6 +101,8 @@ Dbtux::insertNode(NodeHandle& node)
 #ifdef VM_TRACE
   TreeHead& tree = frag.m_tree;
   memset(node.getPref(), DataFillByte, tree.m_prefSize << 2);
+  Uint32* normList = tree.getNormList(node.m_node);
+  memset(normList, NodeFillByte, tree.m_maxOccup * (tree.m_normSize << 2));
   TreeEnt* entList = tree.getEntList(node.m_node);
   memset(entList, NodeFillByte, tree.m_maxOccup * (TreeEntSize << 2));
 #endif
@@ -177,6 +179,19 @@ Dbtux::setNodePref(TuxCtx & ctx, NodeHandle& node)
   }
 }
 
+/*
+ * Read normalized key of an entry.  Reads the first attribute.
+ */
+Uint32
+Dbtux::readNormKey(TuxCtx& ctx, const Frag& frag, TreeEnt ent)
+{
+  const Index& index = *c_indexPool.getPtr(frag.m_indexId);
+  KeyData entryKey(index.m_keySpec, false, 0);
+  entryKey.set_buf(ctx.c_entryKey, MaxAttrDataSize << 2);
+  readKeyAttrs(ctx, frag, ent, entryKey, 1);
+  return getNormKey(entryKey, false);
+}
+
 // node operations
 
 /*
@@ -207,6 +222,12 @@ Dbtux::nodePushUp(TuxCtx & ctx, NodeHandle& node, unsigned pos, const TreeEnt& e
     entList[i] = entList[i - 1];
   }
   entList[pos] = ent;
+  if (tree.m_normSize != 0) {
+    Uint32* const normList = tree.getNormList(node.m_node);
+    for (unsigned i = occup; i > pos; i--)
+      normList[i] = normList[i - 1];
+    normList[pos] = readNormKey(ctx, frag, ent);
+  }
   node.setOccup(occup + 1);
   // add new scans
   if (scanList != RNIL)
@@ -277,6 +298,11 @@ Dbtux::nodePopDown(TuxCtx& ctx, NodeHandle& node, unsigned pos, TreeEnt& ent, Ui
     thrjam(ctx.jamBuffer);
     entList[i] = entList[i + 1];
   }
+  if (tree.m_normSize != 0) {
+    Uint32* const normList = tree.getNormList(node.m_node);
+    for (unsigned i = pos; i < occup - 1; i++)
+      normList[i] = normList[i + 1];
+  }
   node.setOccup(occup - 1);
   // fix prefix
   if (occup != 1 && pos == 0)
@@ -343,6 +369,12 @@ Dbtux::nodePushDown(TuxCtx& ctx, NodeHandle& node, unsigned pos, TreeEnt& ent, U
     entList[i] = entList[i + 1];
   }
   entList[pos] = ent;
+  if (tree.m_normSize != 0) {
+    Uint32* const normList = tree.getNormList(node.m_node);
+    for (unsigned i = 0; i < pos; i++)
+      normList[i] = normList[i + 1];
+    normList[pos] = readNormKey(ctx, frag, ent);
+  }
   ent = oldMin;
   // fix prefix
   if (true)
@@ -411,6 +443,12 @@ Dbtux::nodePopUp(TuxCtx& ctx, NodeHandle& node, unsigned pos, TreeEnt& ent, Uint
     entList[i] = entList[i - 1];
   }
   entList[0] = newMin;
+  if (tree.m_normSize != 0) {
+    Uint32* const normList = tree.getNormList(node.m_node);
+    for (unsigned i = pos; i > 0; i--)
+      normList[i] = normList[i - 1];
+    normList[0] = readNormKey(ctx, frag, newMin);
+  }
   // add scans
   if (scanList != RNIL)
     addScanList(node, 0, scanList);
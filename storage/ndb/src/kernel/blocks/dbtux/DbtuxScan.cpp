@@ -305,6 +305,10 @@ Dbtux::execTUX_BOUND_INFO(Signal* signal)
     ScanBound& scanBound = scan.m_scanBound[idir];
     scanBound.m_cnt = maxAttrId;
     scanBound.m_side = side;
+    if (index.m_normKeys && maxAttrId != 0) {
+      jam();
+      scanBound.m_normKey = getNormKey(searchBoundData, true);
+    }
     // save data words in segmented memory
     {
       DataBuffer<ScanBoundSegmentSize>::Head& head = scanBound.m_head;
@@ -799,8 +803,7 @@ Dbtux::scanFirst(ScanOpPtr scanPtr)
     if (treePos.m_dir == 3) {
       jam();
       // check upper bound
-      TreeEnt ent = node.getEnt(treePos.m_pos);
-      if (scanCheck(scanPtr, ent)) {
+      if (scanCheck(scanPtr, node, treePos.m_pos)) {
         jam();
         scan.m_state = ScanOp::Current;
       } else {
@@ -1014,7 +1017,7 @@ Dbtux::scanNext(ScanOpPtr scanPtr, bool fromMaintReq)
         jam();
         pos.m_dir = 3;  // unchanged
         ent = node.getEnt(pos.m_pos);
-        if (! scanCheck(scanPtr, ent)) {
+        if (! scanCheck(scanPtr, node, pos.m_pos)) {
           jam();
           pos.m_loc = NullTupLoc;
         }
@@ -1073,14 +1076,15 @@ Dbtux::scanNext(ScanOpPtr scanPtr, bool fromMaintReq)
 }
 
 /*
- * Check end key.  Return true if scan is still within range.
+ * Check end key.  Return true if scan is still within range.  The
+ * entry is read only if its normalized key (if any) does not decide.
  *
  * Error handling:  If scan error code has been set, return false at
  * once.  This terminates the scan and also avoids kernel crash on
  * invalid data.
  */
 bool
-Dbtux::scanCheck(ScanOpPtr scanPtr, TreeEnt ent)
+Dbtux::scanCheck(ScanOpPtr scanPtr, NodeHandle& node, unsigned pos)
 {
   ScanOp& scan = *scanPtr.p;
   if (unlikely(scan.m_errorCode != 0)) {
@@ -1095,18 +1099,25 @@ Dbtux::scanCheck(ScanOpPtr scanPtr, TreeEnt ent)
   int ret = 0;
   if (scanBound.m_cnt != 0) {
     jam();
-    // set up bound from segmented memory
-    KeyDataC searchBoundData(index.m_keySpec, true);
-    KeyBoundC searchBound(searchBoundData);
-    unpackBound(c_ctx, scanBound, searchBound);
-    // key data for the entry
-    KeyData entryKey(index.m_keySpec, true, 0);
-    entryKey.set_buf(c_ctx.c_entryKey, MaxAttrDataSize << 2);
-    readKeyAttrs(c_ctx, frag, ent, entryKey, index.m_numAttrs);
-    // compare bound to key
-    const Uint32 boundCount = searchBound.get_data().get_cnt();
-    ret = cmpSearchBound(c_ctx, searchBound, entryKey, boundCount);
-    ndbrequire(ret != 0);
+    if (frag.m_tree.m_normSize != 0) {
+      jam();
+      ret = cmpNormKey(scanBound.m_normKey, node.getNormKey(pos));
+    }
+    if (ret == 0) {
+      jam();
+      // set up bound from segmented memory
+      KeyDataC searchBoundData(index.m_keySpec, true);
+      KeyBoundC searchBound(searchBoundData);
+      unpackBound(c_ctx, scanBound, searchBound);
+      // key data for the entry
+      KeyData entryKey(index.m_keySpec, true, 0);
+      entryKey.set_buf(c_ctx.c_entryKey, MaxAttrDataSize << 2);
+      readKeyAttrs(c_ctx, frag, node.getEnt(pos), entryKey, index.m_numAttrs);
+      // compare bound to key
+      const Uint32 boundCount = searchBound.get_data().get_cnt();
+      ret = cmpSearchBound(c_ctx, searchBound, entryKey, boundCount);
+      ndbrequire(ret != 0);
+    }
     ret = (-1) * ret; // reverse for key vs bound
     ret = jdir * ret; // reverse for descending scan
   }
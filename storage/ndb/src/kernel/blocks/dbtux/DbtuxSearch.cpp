@@ -100,11 +100,14 @@ Dbtux::findNodeToUpdate(TuxCtx& ctx, Frag& frag, const KeyDataC& searchKey, Tree
 /*
  * Find position within the final node to add entry to.  Use binary
  * search.  Return true if ok i.e. entry to add is not a duplicate.
+ * Normalized keys, if any, are compared before reading the entry.
  */
 bool
 Dbtux::findPosToAdd(TuxCtx& ctx, Frag& frag, const KeyDataC& searchKey, TreeEnt searchEnt, NodeHandle& currNode, TreePos& treePos)
 {
   const Index& index = *c_indexPool.getPtr(frag.m_indexId);
+  const bool normKeys = (frag.m_tree.m_normSize != 0);
+  const Uint32 searchNormKey = normKeys ? getNormKey(searchKey, false) : 0;
   int lo = -1;
   int hi = (int)currNode.getOccup();
   KeyData entryKey(index.m_keySpec, false, 0);
@@ -113,9 +116,16 @@ Dbtux::findPosToAdd(TuxCtx& ctx, Frag& frag, const KeyDataC& searchKey, TreeEnt
     thrjam(ctx.jamBuffer);
     // hi - lo > 1 implies lo < j < hi
     int j = (hi + lo) / 2;
-    // read and compare all attributes
-    readKeyAttrs(ctx, frag, currNode.getEnt(j), entryKey, index.m_numAttrs);
-    int ret = cmpSearchKey(ctx, searchKey, entryKey, index.m_numAttrs);
+    int ret = 0;
+    if (normKeys) {
+      thrjam(ctx.jamBuffer);
+      ret = cmpNormKey(searchNormKey, currNode.getNormKey(j));
+    }
+    if (ret == 0) {
+      // read and compare all attributes
+      readKeyAttrs(ctx, frag, currNode.getEnt(j), entryKey, index.m_numAttrs);
+      ret = cmpSearchKey(ctx, searchKey, entryKey, index.m_numAttrs);
+    }
     if (ret == 0) {
       thrjam(ctx.jamBuffer);
       // keys are equal, compare entry values
@@ -284,7 +294,9 @@ Dbtux::findNodeToScan(Frag& frag, unsigned idir, const KeyBoundC& searchBound, N
 
 /*
  * Search across final node for position to start scan from.  Use binary
- * search similar to findPosToAdd().
+ * search similar to findPosToAdd().  A bound whose first attribute has
+ * a different normalized key than the entry is on the same side of the
+ * entry as the normalized key.
  */
 void
 Dbtux::findPosToScan(Frag& frag, unsigned idir, const KeyBoundC& searchBound, NodeHandle& currNode, Uint16* pos)
@@ -292,6 +304,9 @@ Dbtux::findPosToScan(Frag& frag, unsigned idir, const KeyBoundC& searchBound, No
   const int jdir = 1 - 2 * int(idir);
   const Index& index = *c_indexPool.getPtr(frag.m_indexId);
   const Uint32 numAttrs = searchBound.get_data().get_cnt();
+  const bool normKeys = (frag.m_tree.m_normSize != 0 && numAttrs != 0);
+  const Uint32 boundNormKey =
+    normKeys ? getNormKey(searchBound.get_data(), true) : 0;
   int lo = -1;
   int hi = (int)currNode.getOccup();
   KeyData entryKey(index.m_keySpec, false, 0);
@@ -302,10 +317,17 @@ Dbtux::findPosToScan(Frag& frag, unsigned idir, const KeyBoundC& searchBound, No
     int j = (hi + lo) / 2;
     int ret = (-1) * jdir;
     if (numAttrs != 0) {
-      // read and compare all attributes
-      readKeyAttrs(c_ctx, frag, currNode.getEnt(j), entryKey, numAttrs);
-      ret = cmpSearchBound(c_ctx, searchBound, entryKey, numAttrs);
-      ndbrequire(ret != 0);
+      ret = 0;
+      if (normKeys) {
+        jam();
+        ret = cmpNormKey(boundNormKey, currNode.getNormKey(j));
+      }
+      if (ret == 0) {
+        // read and compare all attributes
+        readKeyAttrs(c_ctx, frag, currNode.getEnt(j), entryKey, numAttrs);
+        ret = cmpSearchBound(c_ctx, searchBound, entryKey, numAttrs);
+        ndbrequire(ret != 0);
+      }
     }
     if (ret < 0) {
       jam();
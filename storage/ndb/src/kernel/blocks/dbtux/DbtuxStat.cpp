@@ -458,6 +458,8 @@ Dbtux::execINDEX_STAT_REP(Signal* signal)
       // index.m_statFragPtrI need not be defined yet
       D("loadTime" << V(index.m_statLoadTime) << " ->" << V(rep->loadTime));
       index.m_statLoadTime = rep->loadTime;
+      // count changes from this update on, not since monitoring started
+      fragPtr.p->m_entryOps = 0;
     }
     break;
   default:
@@ -27,6 +27,10 @@
 #include "Ndbfs.hpp"
 #include <NdbSleep.h>
 
+#ifdef HAVE_LINUX_NATIVE_AIO
+#include <sys/syscall.h>
+#endif
+
 #include <EventLogger.hpp>
 extern EventLogger * g_eventLogger;
 
@@ -43,6 +47,9 @@ AsyncIoThread::AsyncIoThread(class Ndbfs& fs, bool bound)
     theMemoryChannelPtr = &m_fs.theToUnboundThreads;
   }
   theReportTo = &m_fs.theFromThreads;
+#ifdef HAVE_LINUX_NATIVE_AIO
+  m_aio_ctx = 0;
+#endif
 }
 
 static int numAsyncFiles = 0;
@@ -77,6 +84,16 @@ AsyncIoThread::doStart()
   NdbMutex_Lock(theStartMutexPtr);
   theStartFlag = false;
 
+#ifdef HAVE_LINUX_NATIVE_AIO
+  if (m_fs.m_odirect_native_aio &&
+      syscall(SYS_io_setup, NDB_FS_RW_PAGES, &m_aio_ctx) != 0)
+  {
+    g_eventLogger->info("%s: io_setup failed, errno: %d, "
+                        "not using native aio", buf, errno);
+    m_aio_ctx = 0;
+  }
+#endif
+
   theThreadPtr = NdbThread_Create(runAsyncIoThread,
                                   (void**)this,
                                   stackSize,
@@ -112,6 +129,13 @@ AsyncIoThread::shutdown()
   this->theMemoryChannelPtr->writeChannel( &request );
   NdbThread_WaitFor(theThreadPtr, &status);
   NdbThread_Destroy(&theThreadPtr);
+#ifdef HAVE_LINUX_NATIVE_AIO
+  if (m_aio_ctx != 0)
+  {
+    syscall(SYS_io_destroy, m_aio_ctx);
+    m_aio_ctx = 0;
+  }
+#endif
 }
 
 void
@@ -146,6 +170,7 @@ AsyncIoThread::run()
 
     AsyncFile * file = request->file;
     m_current_request= request;
+    request->m_thread = this;
     switch (request->action) {
     case Request::open:
       file->openReq(request);
@@ -20,6 +20,10 @@
 #include "MemoryChannel.hpp"
 #include <signaldata/BuildIndxImpl.hpp>
 
+#ifdef HAVE_LINUX_NATIVE_AIO
+#include <linux/aio_abi.h>
+#endif
+
 // Use this define if you want printouts from AsyncFile class
 //#define DEBUG_ASYNCFILE
 
@@ -36,6 +40,7 @@ void printErrorAndFlags(Uint32 used_flags);
 const int ERR_ReadUnderflow = 1000;
 
 class AsyncFile;
+class AsyncIoThread;
 struct Block_context;
 
 class Request
@@ -116,6 +121,8 @@ public:
   AsyncFile* file;
   Uint32 theTrace;
   bool m_do_bind;
+  // Thread executing the request
+  AsyncIoThread* m_thread;
 
   MemoryChannel<Request>::ListMember m_mem_channel;
 };
@@ -155,6 +162,19 @@ public:
   AsyncFile * m_current_file;
   Request *m_current_request, *m_last_request;
 
+#ifdef HAVE_LINUX_NATIVE_AIO
+  /**
+   * Native aio context of the thread, 0 if native aio is not used.
+   *   The pages of one read or write request are submitted together,
+   *   and the thread waits for all of them to complete.
+   */
+  aio_context_t m_aio_ctx;
+  struct iocb m_aio_cb[NDB_FS_RW_PAGES];
+  struct iocb* m_aio_cbp[NDB_FS_RW_PAGES];
+  struct io_event m_aio_events[NDB_FS_RW_PAGES];
+  Uint64 m_aio_done[NDB_FS_RW_PAGES]; // Bytes transferred per iocb
+#endif
+
 private:
   Ndbfs & m_fs;
 
@@ -67,7 +67,8 @@ Ndbfs::Ndbfs(Block_context& ctx) :
   m_maxOpenedFiles(0),
   m_bound_threads_cnt(0),
   m_unbounds_threads_cnt(0),
-  m_active_bound_threads_cnt(0)
+  m_active_bound_threads_cnt(0),
+  m_odirect_native_aio(false)
 {
   BLOCK_CONSTRUCTOR(Ndbfs);
 
@@ -295,6 +296,10 @@ Ndbfs::execREAD_CONFIG_REQ(Signal* signal)
   if (noIdleFiles > m_maxFiles && m_maxFiles != 0)
     m_maxFiles = noIdleFiles;
 
+  Uint32 native_aio = 0;
+  ndb_mgm_get_int_parameter(p, CFG_DB_ODIRECT_NATIVE_AIO, &native_aio);
+  m_odirect_native_aio = (native_aio != 0);
+
   // Create idle AsyncFiles
   for (Uint32 i = 0; i < noIdleFiles; i++)
   {
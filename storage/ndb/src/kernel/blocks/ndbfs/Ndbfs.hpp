@@ -110,6 +110,9 @@ private:
   Uint32 m_unbounds_threads_cnt;
   Uint32 m_active_bound_threads_cnt;
   void cnt_active_bound(int val);
+
+  // Use native aio for O_DIRECT files (ODirectNativeAio)
+  bool m_odirect_native_aio;
 public:
   const BaseString& get_base_path(Uint32 no) const;
 };
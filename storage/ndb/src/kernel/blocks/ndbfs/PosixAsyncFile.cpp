@@ -41,10 +41,15 @@
 #include <sys/uio.h>
 #include <dirent.h>
 
+#ifdef HAVE_LINUX_NATIVE_AIO
+#include <sys/syscall.h>
+#endif
+
 PosixAsyncFile::PosixAsyncFile(SimulatedBlock& fs) :
   AsyncFile(fs),
   theFd(-1),
-  use_gz(0)
+  use_gz(0),
+  m_native_aio(false)
 {
   memset(&nzf,0,sizeof(nzf));
   init_mutex();
@@ -161,6 +166,7 @@ void PosixAsyncFile::openReq(Request *request)
   m_auto_sync_freq = 0;
   m_write_wo_sync = 0;
   m_open_flags = request->par.open.flags;
+  m_native_aio = false;
 
   // for open.flags, see signal FSOPENREQ
   Uint32 flags = request->par.open.flags;
@@ -493,6 +499,10 @@ no_odirect:
       abort();
     }
   }
+
+#if defined(HAVE_LINUX_NATIVE_AIO) && defined(O_DIRECT)
+  m_native_aio = !use_gz && (new_flags & O_DIRECT);
+#endif
 }
 
 int PosixAsyncFile::readBuffer(Request *req, char *buf,
@@ -581,8 +591,22 @@ int PosixAsyncFile::readBuffer(Request *req, char *buf,
   return 0;
 }
 
+void PosixAsyncFile::readReq(Request *request)
+{
+  if (request->action != Request::readPartial &&
+      nativeAioReq(request, false))
+  {
+    return;
+  }
+  AsyncFile::readReq(request);
+}
+
 void PosixAsyncFile::readvReq(Request *request)
 {
+  if (nativeAioReq(request, false))
+  {
+    return;
+  }
 #if ! defined(HAVE_PREAD)
   readReq(request);
   return;
@@ -607,6 +631,170 @@ void PosixAsyncFile::readvReq(Request *request)
 #endif
 }
 
+void PosixAsyncFile::writeReq(Request *request)
+{
+  if (!nativeAioReq(request, true))
+  {
+    AsyncFile::writeReq(request);
+    return;
+  }
+  if (request->error == 0 &&
+      m_auto_sync_freq && m_write_wo_sync > m_auto_sync_freq)
+  {
+    syncReq(request);
+  }
+}
+
+bool PosixAsyncFile::nativeAioReq(Request *request, bool write)
+{
+#ifdef HAVE_LINUX_NATIVE_AIO
+  AsyncIoThread* thr = request->m_thread;
+  if (!m_native_aio || thr == 0 || thr->m_aio_ctx == 0)
+    return false;
+
+  /**
+   * O_DIRECT needs aligned buffers, sizes and offsets,
+   *   else use pread/pwrite which will fail the same way as before
+   */
+  const Uint32 cnt = request->par.readWrite.numberOfPages;
+  const UintPtr mask = NDB_O_DIRECT_WRITE_ALIGNMENT - 1;
+  for (Uint32 i = 0; i < cnt; i++)
+  {
+    if ((UintPtr(request->par.readWrite.pages[i].buf) |
+         UintPtr(request->par.readWrite.pages[i].size) |
+         UintPtr(request->par.readWrite.pages[i].offset)) & mask)
+      return false;
+  }
+
+  /**
+   * One iocb per range of pages consecutive both in memory and in the file
+   */
+  Uint32 n = 0;
+  for (Uint32 i = 0; i < cnt; i++)
+  {
+    char * buf = request->par.readWrite.pages[i].buf;
+    const size_t size = request->par.readWrite.pages[i].size;
+    const off_t offset = request->par.readWrite.pages[i].offset;
+    if (n > 0)
+    {
+      struct iocb * prev = &thr->m_aio_cb[n - 1];
+      if (prev->aio_buf + prev->aio_nbytes == UintPtr(buf) &&
+          prev->aio_offset + (Int64)prev->aio_nbytes == (Int64)offset)
+      {
+        prev->aio_nbytes += size;
+        continue;
+      }
+    }
+    struct iocb * cb = &thr->m_aio_cb[n];
+    memset(cb, 0, sizeof(* cb));
+    cb->aio_data = n;
+    cb->aio_lio_opcode = write ? IOCB_CMD_PWRITE : IOCB_CMD_PREAD;
+    cb->aio_fildes = theFd;
+    cb->aio_buf = UintPtr(buf);
+    cb->aio_nbytes = size;
+    cb->aio_offset = offset;
+    thr->m_aio_cbp[n] = cb;
+    n++;
+  }
+
+  Uint32 submitted = 0;
+  while (submitted < n)
+  {
+    long ret = syscall(SYS_io_submit, thr->m_aio_ctx, long(n - submitted),
+                       thr->m_aio_cbp + submitted);
+    if (ret > 0)
+    {
+      submitted += Uint32(ret);
+      continue;
+    }
+    if (ret == -1 && errno == EINTR)
+      continue;
+    if (submitted == 0 && ret == -1 && errno == EINVAL)
+    {
+      /**
+       * File system does not support native aio
+       */
+      ndbout_c("%s native aio not supported, disabling",
+               theFileName.c_str());
+      m_native_aio = false;
+      return false;
+    }
+    /**
+     * Out of aio resources (EAGAIN), do the rest with pread/pwrite
+     */
+    break;
+  }
+
+  Uint64 * done = thr->m_aio_done;
+  for (Uint32 i = 0; i < n; i++)
+    done[i] = 0;
+
+  Uint32 completed = 0;
+  while (completed < submitted)
+  {
+    long ret = syscall(SYS_io_getevents, thr->m_aio_ctx, 1L,
+                       long(submitted - completed), thr->m_aio_events,
+                       (struct timespec*)0);
+    if (ret == -1)
+    {
+      if (errno == EINTR)
+        continue;
+      ndbout_c("ERROR IN PosixAsyncFile::nativeAioReq io_getevents %d",
+               errno);
+      abort();
+    }
+    for (long i = 0; i < ret; i++)
+    {
+      const struct io_event * ev = &thr->m_aio_events[i];
+      const Int64 res = (Int64)ev->res;
+      if (res < 0)
+      {
+        if (request->error == 0)
+          request->error = int(-res);
+      }
+      else
+      {
+        done[ev->data] = Uint64(res);
+      }
+    }
+    completed += Uint32(ret);
+  }
+
+  if (write)
+  {
+    for (Uint32 i = 0; i < n; i++)
+      m_write_wo_sync += size_t(done[i]);
+  }
+
+  if (request->error)
+    return true;
+
+  /**
+   * Finish short transfers and the iocbs that could not be submitted
+   */
+  for (Uint32 i = 0; i < n; i++)
+  {
+    const struct iocb * cb = &thr->m_aio_cb[i];
+    if (done[i] == cb->aio_nbytes)
+      continue;
+    char * buf = (char*)UintPtr(cb->aio_buf + done[i]);
+    const size_t size = size_t(cb->aio_nbytes - done[i]);
+    const off_t offset = off_t(cb->aio_offset + done[i]);
+    const int err = write ?
+      writeBuffer(buf, size, offset) :
+      readBuffer(request, buf, size, offset);
+    if (err != 0)
+    {
+      request->error = err;
+      return true;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 int PosixAsyncFile::writeBuffer(const char *buf, size_t size, off_t offset)
 {
   size_t chunk_size = 256*1024;
@@ -688,6 +876,7 @@ void PosixAsyncFile::closeReq(Request *request)
   else
     r= ::close(theFd);
   use_gz= 0;
+  m_native_aio = false;
   Byte *a,*b;
   a= nzf.inbuf;
   b= nzf.outbuf;
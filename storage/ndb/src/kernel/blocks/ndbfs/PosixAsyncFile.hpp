@@ -49,7 +49,9 @@ public:
   virtual bool isOpen();
 
   virtual void openReq(Request *request);
+  virtual void readReq(Request *request);
   virtual void readvReq(Request *request);
+  virtual void writeReq(Request *request);
 
   virtual void closeReq(Request *request);
   virtual void syncReq(Request *request);
@@ -73,6 +75,14 @@ private:
   int check_odirect_read(Uint32 flags, int&new_flags, int mode);
   int check_odirect_write(Uint32 flags, int&new_flags, int mode);
 
+  /**
+   * Native aio, used when the file is opened with O_DIRECT
+   *   and ODirectNativeAio is set.
+   *   Returns false if the request should use pread/pwrite instead.
+   */
+  bool m_native_aio;
+  bool nativeAioReq(Request *request, bool write);
+
 #ifndef HAVE_PREAD
   struct FileGuard;
   friend struct FileGuard;
@@ -105,6 +105,37 @@ Thrman::execDBINFO_SCANREQ(Signal* signal)
     ndbinfo_send_row(signal, req, row, rl);
     break;
   }
+  case Ndbinfo::THREADSTAT_HISTORY_TABLEID:{
+    ndb_thr_stat_sample arr[MT_THR_STAT_HISTORY];
+    Uint32 len = mt_get_thr_stat_history(this, arr, NDB_ARRAY_SIZE(arr));
+    Uint32 pos = cursor->data[0];
+    for (; pos < len; )
+    {
+      Ndbinfo::Row row(signal, req);
+      row.write_uint32(getOwnNodeId());
+      row.write_uint32(getThreadId());  // thr_no
+      row.write_uint32(pos);            // sample_no
+      row.write_uint64(arr[pos].elapsed);
+      row.write_uint64(arr[pos].exec_cnt);
+      row.write_uint64(arr[pos].sleep_time);
+      row.write_uint64(arr[pos].send_time);
+      row.write_uint64(arr[pos].jbfull_cnt);
+      row.write_uint64(arr[pos].jbfull_time);
+      row.write_uint64(arr[pos].os_utime);
+      row.write_uint64(arr[pos].os_stime);
+      row.write_uint32(arr[pos].jbb_pages);
+      ndbinfo_send_row(signal, req, row, rl);
+
+      pos++;
+      if (pos < len && rl.need_break(req))
+      {
+        jam();
+        ndbinfo_send_scan_break(signal, req, rl, pos);
+        return;
+      }
+    }
+    break;
+  }
   default:
     break;
   }
@@ -447,6 +447,62 @@ Trpman::execDBINFO_SCANREQ(Signal *signal)
     break;
   }
 
+  case Ndbinfo::TRANSPORTER_SENDS_TABLEID:
+  {
+    jam();
+    const Uint32 buckets = TransporterRegistry::SEND_HISTOGRAM_BUCKETS;
+    const Uint32 positions = TransporterRegistry::SH_HISTOGRAMS * buckets;
+    Uint32 rnode = cursor->data[0];
+    Uint32 pos = cursor->data[1];
+    if (rnode == 0)
+      rnode++; // Skip node 0
+
+    while (rnode < MAX_NODES)
+    {
+      if (!handles_this_node(rnode) ||
+          globalTransporterRegistry.get_transporter(rnode) == NULL)
+      {
+        rnode++;
+        pos = 0;
+        continue;
+      }
+
+      for (; pos < positions; pos++)
+      {
+        const Uint32 histogram = pos / buckets;
+        const Uint32 bucket = pos % buckets;
+        const Uint64 count =
+          globalTransporterRegistry.get_send_histogram(rnode, histogram,
+                                                       bucket);
+        if (count == 0)
+          continue;
+
+        jam();
+        Ndbinfo::Row row(signal, req);
+        row.write_uint32(getOwnNodeId()); // Node id
+        row.write_uint32(rnode); // Remote node id
+        row.write_uint32(histogram);
+        if (bucket == buckets - 1)
+          row.write_uint64(~(Uint64)0); // Last bucket has no upper bound
+        else
+          row.write_uint64((Uint64(1) << bucket) - 1);
+        row.write_uint64(count);
+        ndbinfo_send_row(signal, req, row, rl);
+
+        if (rl.need_break(req))
+        {
+          jam();
+          ndbinfo_send_scan_break(signal, req, rl, rnode, pos + 1);
+          return;
+        }
+      }
+
+      rnode++;
+      pos = 0;
+    }
+    break;
+  }
+
   default:
     break;
   }
@@ -394,6 +394,12 @@ Configuration::setupConfiguration(){
     }
   }
 
+  {
+    Uint32 autoPlacement = 0;
+    iter.get(CFG_DB_AUTO_THREAD_PLACEMENT, &autoPlacement);
+    m_thr_config.setAutomaticThreadPlacement(autoPlacement != 0);
+  }
+
   {
     Uint32 maintCPU = NO_LOCK_CPU;
     iter.get(CFG_DB_MAINT_LOCK_CPU, &maintCPU);
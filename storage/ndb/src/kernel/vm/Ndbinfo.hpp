@@ -51,7 +51,9 @@ public:
     THREADSTAT_TABLEID =         12,
     TRANSACTIONS_TABLEID =       13,
     OPERATIONS_TABLEID =         14,
-    MEMBERSHIP_TABLEID =         15
+    MEMBERSHIP_TABLEID =         15,
+    TRANSPORTER_SENDS_TABLEID =  16,
+    THREADSTAT_HISTORY_TABLEID = 17
   };
 
   struct Table {
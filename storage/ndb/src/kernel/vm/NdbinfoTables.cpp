@@ -262,6 +262,36 @@ DECLARE_NDBINFO_TABLE(MEMBERSHIP, 13) =
   }
 };
 
+DECLARE_NDBINFO_TABLE(TRANSPORTER_SENDS, 5) =
+{ { "transporter_sends", 5, 0, "transporter send histograms" },
+  {
+    {"node_id",            Ndbinfo::Number, ""},
+    {"remote_node_id",     Ndbinfo::Number, ""},
+    {"histogram",          Ndbinfo::Number,
+     "0 = bytes per send, 1 = send delay in microseconds"},
+    {"bucket_max",         Ndbinfo::Number64, "largest value in bucket"},
+    {"count",              Ndbinfo::Number64, ""}
+  }
+};
+
+DECLARE_NDBINFO_TABLE(THREADSTAT_HISTORY, 12) =
+{ { "threadstat_history", 12, 0, "Per second statistics on execution threads" },
+  {
+    {"node_id",             Ndbinfo::Number, "node id"},
+    {"thr_no",              Ndbinfo::Number, "thread number"},
+    {"sample_no",           Ndbinfo::Number, "Sample number, 0 is the newest"},
+    {"elapsed",             Ndbinfo::Number64,"Length of sample (millis)"},
+    {"c_exec",              Ndbinfo::Number64,"No of signals executed"},
+    {"sleep_time",          Ndbinfo::Number64,"Time waited for more input (micros)"},
+    {"send_time",           Ndbinfo::Number64,"Time spent sending (micros)"},
+    {"c_jbfull_wait",       Ndbinfo::Number64,"No of waits for full job buffers"},
+    {"jbfull_time",         Ndbinfo::Number64,"Time waited for full job buffers (micros)"},
+    {"os_ru_utime",         Ndbinfo::Number64,"OS user CPU time (micros)"},
+    {"os_ru_stime",         Ndbinfo::Number64,"OS system CPU time (micros)"},
+    {"jbb_pages",           Ndbinfo::Number, "Job buffer pages waiting at end of sample"}
+  }
+};
+
 #define DBINFOTBL(x) { Ndbinfo::x##_TABLEID, (Ndbinfo::Table*)&ndbinfo_##x }
 
 static
@@ -286,7 +316,9 @@ struct ndbinfo_table_list_entry {
   DBINFOTBL(THREADSTAT),
   DBINFOTBL(TRANSACTIONS),
   DBINFOTBL(OPERATIONS),
-  DBINFOTBL(MEMBERSHIP)
+  DBINFOTBL(MEMBERSHIP),
+  DBINFOTBL(TRANSPORTER_SENDS),
+  DBINFOTBL(THREADSTAT_HISTORY)
 };
 
 static int no_ndbinfo_tables =
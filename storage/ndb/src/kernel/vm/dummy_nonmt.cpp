@@ -88,3 +88,10 @@ mt_get_thr_stat(class SimulatedBlock *, ndb_thr_stat* dst)
   dst->name = "main";
 }
 
+Uint32
+mt_get_thr_stat_history(class SimulatedBlock *,
+                        ndb_thr_stat_sample dst[], Uint32 len)
+{
+  return 0;
+}
+
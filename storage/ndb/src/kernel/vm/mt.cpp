@@ -33,6 +33,7 @@
 #include <signaldata/StopForCrash.hpp>
 #include "TransporterCallbackKernel.hpp"
 #include <NdbSleep.h>
+#include <NdbGetRUsage.h>
 #include <portlib/ndb_prefetch.h>
 
 #include "mt-asm.h"
@@ -911,8 +912,32 @@ struct thr_data
     Uint64 m_prioa_size;
     Uint64 m_priob_count;
     Uint64 m_priob_size;
+    Uint64 m_sleep_time;
+    Uint64 m_send_time;
+    Uint64 m_jbfull_cnt;
+    Uint64 m_jbfull_time;
   } m_stat;
 
+  /**
+   * Snapshots of m_stat and of the OS CPU usage of this thread,
+   * taken about once per second, in a circular buffer.
+   * Samples are the differences between two consecutive snapshots.
+   */
+  struct
+  {
+    NDB_TICKS m_time;
+    Uint64 m_exec_cnt;
+    Uint64 m_sleep_time;
+    Uint64 m_send_time;
+    Uint64 m_jbfull_cnt;
+    Uint64 m_jbfull_time;
+    Uint64 m_os_utime;
+    Uint64 m_os_stime;
+    Uint32 m_jbb_pages;
+  } m_stat_history[MT_THR_STAT_HISTORY + 1];
+  Uint32 m_stat_history_pos;  /* Next snapshot to write */
+  Uint32 m_stat_history_cnt;  /* No of valid snapshots */
+
   /* Array of node ids with pending remote send data. */
   Uint8 m_pending_send_nodes[MAX_NTRANSPORTERS];
   /* Number of node ids in m_pending_send_nodes. */
@@ -1084,7 +1109,8 @@ struct thr_send_thread_instance
                m_waiter_struct(),
                m_send_buffer_pool(0,
                                   THR_SEND_BUFFER_MAX_FREE,
-                                  THR_SEND_BUFFER_ALLOC_SIZE)
+                                  THR_SEND_BUFFER_ALLOC_SIZE),
+               m_delayed_count(0)
   {}
   Uint32 m_instance_no;
   Uint32 m_watchdog_counter;
@@ -1092,6 +1118,10 @@ struct thr_send_thread_instance
   NdbThread *m_thread;
   thr_wait m_waiter_struct;
   class thread_local_pool<thr_send_page> m_send_buffer_pool;
+
+  /* Nodes this send thread has delayed sending to, see delay_send() */
+  Uint32 m_delayed_count;
+  NodeId m_delayed_nodes[MAX_NODES];
 };
 
 struct thr_send_nodes
@@ -1099,6 +1129,14 @@ struct thr_send_nodes
   /* 0 means NULL */
   Uint16 m_next;
   Uint16 m_data_available;
+
+  /* Microseconds: time of the last send to the node */
+  NDB_TICKS m_last_send;
+  /* Microseconds: average time between two sends to the node */
+  NDB_TICKS m_send_interval;
+  /* Microseconds: when a delayed send was first ready, and is due */
+  NDB_TICKS m_delay_start;
+  NDB_TICKS m_delay_end;
 };
 
 class thr_send_threads
@@ -1147,6 +1185,20 @@ private:
   /* Get a node from the list in order to send to it */
   NodeId get_node();
 
+  /*
+   * Get a node to send to now: a node delayed by this send thread
+   * which is due, else a node from the list which is not delayed.
+   */
+  NodeId get_node_to_send(struct thr_send_thread_instance *send_thread);
+
+  /* Check if the send to this node should be delayed, and delay it */
+  bool delay_send(struct thr_send_thread_instance *send_thread,
+                  NodeId node, NDB_TICKS now);
+
+  /* Nanoseconds until the first send delayed by this send thread is due */
+  Uint32 get_delayed_wait(struct thr_send_thread_instance *send_thread,
+                          Uint32 max_wait);
+
   /* Get a send thread which isn't awake currently */
   struct thr_send_thread_instance* get_not_awake_send_thread();
   /*
@@ -1171,6 +1223,9 @@ private:
   /* Is data available and next reference for each node in cluster */
   struct thr_send_nodes m_node_state[MAX_NODES];
 
+  /* Microseconds a send may be delayed, the MaxSendDelay config parameter */
+  Uint32 m_max_send_delay;
+
   /**
    * Very few compiler (gcc) allow zero length arrays
    */
@@ -1222,7 +1277,15 @@ thr_send_threads::thr_send_threads()
   {
     m_node_state[i].m_next = 0;
     m_node_state[i].m_data_available = FALSE;
-  }
+    m_node_state[i].m_last_send = 0;
+    m_node_state[i].m_send_interval = 0;
+    m_node_state[i].m_delay_start = 0;
+    m_node_state[i].m_delay_end = 0;
+  }
+  m_max_send_delay = 0;
+  ndb_mgm_get_int_parameter(globalEmulatorData.theConfiguration->
+                              getOwnConfigIterator(),
+                            CFG_DB_MAX_SEND_DELAY, &m_max_send_delay);
   for (Uint32 i = 0; i < NDB_ARRAY_SIZE(m_send_threads); i++)
   {
     m_send_threads[i].m_waiter_struct.init();
@@ -1312,6 +1375,122 @@ thr_send_threads::get_node()
   return 0;
 }
 
+static inline
+NDB_TICKS
+get_micros_now()
+{
+  NDB_TICKS secs;
+  Uint32 micros;
+  NdbTick_CurrentMicrosecond(&secs, &micros);
+  return secs * 1000000 + micros;
+}
+
+/**
+ * Adaptive send delay
+ *
+ * Sending as soon as data is available for a node gives the lowest
+ * latency, but at high signal rates it makes many small writes to the
+ * same node.  So when a node is sent to more often than once per
+ * MaxSendDelay, on average, its next send is delayed until MaxSendDelay
+ * after the last send, letting more signals go out in the same system
+ * call.  Nodes sent to less often are never delayed.
+ *
+ * The delayed node stays flagged as having data available, so that
+ * no other send thread picks it up, and it is kept in a list of the send
+ * thread which delayed it.  Called under protection of send_thread_mutex.
+ */
+bool
+thr_send_threads::delay_send(struct thr_send_thread_instance *send_thread,
+                             NodeId node, NDB_TICKS now)
+{
+  struct thr_send_nodes *node_state = &m_node_state[node];
+  const NDB_TICKS send_at = node_state->m_last_send + m_max_send_delay;
+
+  if (node_state->m_send_interval >= m_max_send_delay || now >= send_at)
+    return false;
+
+  node_state->m_data_available = TRUE;
+  node_state->m_delay_end = send_at;
+  send_thread->m_delayed_nodes[send_thread->m_delayed_count++] = node;
+  return true;
+}
+
+/* Called under mutex protection of send_thread_mutex */
+NodeId
+thr_send_threads::get_node_to_send(struct thr_send_thread_instance *send_thread)
+{
+  if (m_max_send_delay == 0)
+    return get_node();
+
+  const NDB_TICKS now = get_micros_now();
+  NodeId node = 0;
+
+  for (Uint32 i = 0; i < send_thread->m_delayed_count; i++)
+  {
+    const NodeId delayed = send_thread->m_delayed_nodes[i];
+    if (now >= m_node_state[delayed].m_delay_end)
+    {
+      send_thread->m_delayed_nodes[i] =
+        send_thread->m_delayed_nodes[--send_thread->m_delayed_count];
+      m_node_state[delayed].m_data_available = FALSE;
+      node = delayed;
+      break;
+    }
+  }
+
+  while (node == 0 && (node = get_node()) != 0)
+  {
+    m_node_state[node].m_delay_start = now;
+    if (delay_send(send_thread, node, now))
+      node = 0;
+  }
+
+  if (node != 0)
+  {
+    struct thr_send_nodes *node_state = &m_node_state[node];
+    const NDB_TICKS start = node_state->m_delay_start;
+    const NDB_TICKS last = node_state->m_last_send;
+    NDB_TICKS interval = 2 * m_max_send_delay;
+    if (last != 0 && now > last && now - last < interval)
+      interval = now - last;
+
+    /**
+     * Moving average of the time between sends, weight 1/8.
+     * Long idle periods count as 2 * MaxSendDelay, so that the
+     * average quickly follows when the send rate goes up again.
+     */
+    node_state->m_send_interval =
+      (7 * node_state->m_send_interval + interval) / 8;
+    node_state->m_last_send = now;
+
+    globalTransporterRegistry.update_send_delay(node,
+                                                Uint32(now - start));
+  }
+  return node;
+}
+
+/* Called under mutex protection of send_thread_mutex */
+Uint32
+thr_send_threads::get_delayed_wait(struct thr_send_thread_instance *send_thread,
+                                   Uint32 max_wait)
+{
+  if (send_thread->m_delayed_count == 0)
+    return max_wait;
+
+  const NDB_TICKS now = get_micros_now();
+  NDB_TICKS wait = max_wait / 1000;
+  for (Uint32 i = 0; i < send_thread->m_delayed_count; i++)
+  {
+    const NDB_TICKS end =
+      m_node_state[send_thread->m_delayed_nodes[i]].m_delay_end;
+    if (end <= now)
+      return 0;
+    if (end - now < wait)
+      wait = end - now;
+  }
+  return Uint32(wait * 1000);
+}
+
 struct thr_send_thread_instance*
 thr_send_threads::get_not_awake_send_thread()
 {
@@ -1491,12 +1670,15 @@ thr_send_threads::run_send_thread(Uint32 instance_no)
   this_send_thread->m_awake = FALSE;
   NdbMutex_Unlock(send_thread_mutex);
 
+  /* Yield for a maximum of 1ms */
+  const Uint32 max_wait = 1000000;
+  Uint32 wait = max_wait;
+
   while (globalData.theRestartFlag != perform_stop)
   {
     this_send_thread->m_watchdog_counter = 1;
 
-    /* Yield for a maximum of 1ms */
-    const Uint32 wait = 1000000;
+    /* Yield until the first delayed send is due, at most max_wait */
     yield(&this_send_thread->m_waiter_struct, wait,
           check_available_send_data, NULL);
 
@@ -1504,7 +1686,7 @@ thr_send_threads::run_send_thread(Uint32 instance_no)
     this_send_thread->m_awake = TRUE;
 
     NodeId node;
-    while ((node = get_node()) != 0 &&
+    while ((node = get_node_to_send(this_send_thread)) != 0 &&
            globalData.theRestartFlag != perform_stop)
     {
       this_send_thread->m_watchdog_counter = 2;
@@ -1529,6 +1711,7 @@ thr_send_threads::run_send_thread(Uint32 instance_no)
     }
 
     /* No data to send, prepare to sleep */
+    wait = get_delayed_wait(this_send_thread, max_wait);
     this_send_thread->m_awake = FALSE;
     NdbMutex_Unlock(send_thread_mutex);
   }
@@ -2810,6 +2993,8 @@ do_send(struct thr_data* selfptr, bool must_send)
     return 0; // send-buffers empty
   }
 
+  const NDB_TICKS start = get_micros_now();
+
   /* Clear the pending list. */
   selfptr->m_pending_send_mask.clear();
   selfptr->m_pending_send_count = 0;
@@ -2909,6 +3094,7 @@ do_send(struct thr_data* selfptr, bool must_send)
 
   selfptr->m_send_buffer_pool.release_global(rep->m_mm, RG_TRANSPORTER_BUFFERS);
 
+  selfptr->m_stat.m_send_time += get_micros_now() - start;
   return selfptr->m_pending_send_count;
 }
 
@@ -3543,6 +3729,46 @@ aligned_signal(unsigned char signal_buf[SIGBUF_SIZE], unsigned thr_no)
 TransporterReceiveHandleKernel *
   g_trp_receive_handle_ptr[MAX_NDBMT_RECEIVE_THREADS];
 
+/**
+ * Take a snapshot of the thread statistics for the history kept for
+ *   ndbinfo, if a second has passed since the last one
+ */
+static
+void
+sample_thr_stat(thr_data *selfptr, NDB_TICKS now)
+{
+  const Uint32 pos = selfptr->m_stat_history_pos;
+  const Uint32 last = (pos + MT_THR_STAT_HISTORY) % (MT_THR_STAT_HISTORY + 1);
+  if (selfptr->m_stat_history_cnt > 0 &&
+      now < selfptr->m_stat_history[last].m_time + 1000)
+  {
+    return;
+  }
+
+  struct ndb_rusage os_rusage;
+  Ndb_GetRUSage(&os_rusage);
+
+  Uint32 jbb_pages = 0;
+  for (Uint32 i = 0; i < g_thr_repository.m_thread_count; i++)
+  {
+    jbb_pages += selfptr->m_in_queue_head[i].used();
+  }
+
+  selfptr->m_stat_history[pos].m_time = now;
+  selfptr->m_stat_history[pos].m_exec_cnt = selfptr->m_stat.m_exec_cnt;
+  selfptr->m_stat_history[pos].m_sleep_time = selfptr->m_stat.m_sleep_time;
+  selfptr->m_stat_history[pos].m_send_time = selfptr->m_stat.m_send_time;
+  selfptr->m_stat_history[pos].m_jbfull_cnt = selfptr->m_stat.m_jbfull_cnt;
+  selfptr->m_stat_history[pos].m_jbfull_time = selfptr->m_stat.m_jbfull_time;
+  selfptr->m_stat_history[pos].m_os_utime = os_rusage.ru_utime;
+  selfptr->m_stat_history[pos].m_os_stime = os_rusage.ru_stime;
+  selfptr->m_stat_history[pos].m_jbb_pages = jbb_pages;
+
+  selfptr->m_stat_history_pos = (pos + 1) % (MT_THR_STAT_HISTORY + 1);
+  if (selfptr->m_stat_history_cnt < MT_THR_STAT_HISTORY + 1)
+    selfptr->m_stat_history_cnt++;
+}
+
 /**
  * Array for mapping nodes to receiver threads and function to access it.
  */
@@ -3618,6 +3844,7 @@ mt_receiver_thread_main(void *thr_arg)
     }
     selfptr->m_stat.m_loop_cnt++;
     selfptr->m_stat.m_exec_cnt += sum;
+    sample_thr_stat(selfptr, now);
   }
 
   globalEmulatorData.theWatchDog->unregisterWatchedThread(thr_no);
@@ -3726,7 +3953,10 @@ loop:
     }
 
     const Uint32 wait = 1000000;    /* 1 ms */
+    const NDB_TICKS start = get_micros_now();
     yield(&selfptr->m_waiter, wait, check_job_buffer_full, selfptr);
+    selfptr->m_stat.m_jbfull_cnt++;
+    selfptr->m_stat.m_jbfull_time += get_micros_now() - start;
     goto loop;
   }
 
@@ -3816,11 +4046,13 @@ mt_job_thread_main(void *thr_arg)
 
       if (pending_send == 0)
       {
+        const NDB_TICKS start = get_micros_now();
         bool waited = yield(&selfptr->m_waiter, nowait, check_queues_empty,
                             selfptr);
         if (waited)
         {
           waits++;
+          selfptr->m_stat.m_sleep_time += get_micros_now() - start;
           /* Update current time after sleeping */
           now = NdbTick_CurrentMillisecond();
           selfptr->m_stat.m_wait_cnt += waits;
@@ -3870,6 +4102,7 @@ mt_job_thread_main(void *thr_arg)
       waits = loops = 0;
     }
     selfptr->m_stat.m_exec_cnt += sum;
+    sample_thr_stat(selfptr, now);
   }
 
   globalEmulatorData.theWatchDog->unregisterWatchedThread(thr_no);
@@ -5189,6 +5422,43 @@ mt_get_thr_stat(class SimulatedBlock * block, ndb_thr_stat* dst)
   dst->local_sent_priob = selfptr->m_stat.m_priob_count;
 }
 
+Uint32
+mt_get_thr_stat_history(class SimulatedBlock * block,
+                        ndb_thr_stat_sample dst[], Uint32 len)
+{
+  Uint32 thr_no = block->getThreadId();
+  const struct thr_data *selfptr = &g_thr_repository.m_thread[thr_no].m_thr_data;
+  const Uint32 size = MT_THR_STAT_HISTORY + 1;
+
+  /**
+   * Only called from THRMAN in the thread itself,
+   *   so the history does not change while it is read
+   */
+  Uint32 cnt = 0;
+  Uint32 pos = selfptr->m_stat_history_pos;
+  while (cnt + 1 < selfptr->m_stat_history_cnt && cnt < len)
+  {
+    const Uint32 newer = (pos + size - 1) % size;
+    const Uint32 older = (pos + size - 2) % size;
+    dst[cnt].elapsed = selfptr->m_stat_history[newer].m_time -
+                       selfptr->m_stat_history[older].m_time;
+#define THR_STAT_DIFF(x) \
+    selfptr->m_stat_history[newer].x - selfptr->m_stat_history[older].x
+    dst[cnt].exec_cnt = THR_STAT_DIFF(m_exec_cnt);
+    dst[cnt].sleep_time = THR_STAT_DIFF(m_sleep_time);
+    dst[cnt].send_time = THR_STAT_DIFF(m_send_time);
+    dst[cnt].jbfull_cnt = THR_STAT_DIFF(m_jbfull_cnt);
+    dst[cnt].jbfull_time = THR_STAT_DIFF(m_jbfull_time);
+    dst[cnt].os_utime = THR_STAT_DIFF(m_os_utime);
+    dst[cnt].os_stime = THR_STAT_DIFF(m_os_stime);
+#undef THR_STAT_DIFF
+    dst[cnt].jbb_pages = selfptr->m_stat_history[newer].m_jbb_pages;
+    pos = newer;
+    cnt++;
+  }
+  return cnt;
+}
+
 TransporterReceiveHandle *
 mt_get_trp_receive_handle(unsigned instance)
 {
@@ -103,6 +103,33 @@ struct ndb_thr_stat
 void
 mt_get_thr_stat(class SimulatedBlock *, ndb_thr_stat* dst);
 
+/**
+ * Each block thread samples its statistics about once per second,
+ * the last MT_THR_STAT_HISTORY samples are kept
+ */
+#define MT_THR_STAT_HISTORY 20
+
+struct ndb_thr_stat_sample
+{
+  Uint64 elapsed;       // millis since previous sample
+  Uint64 exec_cnt;      // No of signals executed
+  Uint64 sleep_time;    // micros waited for more input
+  Uint64 send_time;     // micros spent sending
+  Uint64 jbfull_cnt;    // No of times waited for full job buffers
+  Uint64 jbfull_time;   // micros waited for full job buffers
+  Uint64 os_utime;      // OS user CPU time (micros)
+  Uint64 os_stime;      // OS system CPU time (micros)
+  Uint32 jbb_pages;     // job buffer pages not executed at end of sample
+};
+
+/**
+ * return the statistics of the thread running block over the last
+ *   seconds, newest first, one row per sample
+ */
+Uint32
+mt_get_thr_stat_history(class SimulatedBlock *,
+                        ndb_thr_stat_sample dst[], Uint32 len);
+
 /**
  * Get TransporterReceiveHandle for a specific trpman instance
  *   Currently used for error insert that block/unblock traffic
@@ -88,6 +88,7 @@ getEntryType(const char * type)
 THRConfig::THRConfig()
 {
   m_classic = false;
+  m_auto_placement = false;
 }
 
 THRConfig::~THRConfig()
@@ -365,6 +366,21 @@ THRConfig::do_bindings(bool allow_too_few_cpus)
     cnt_unbound--;
   }
 
+  if (m_auto_placement && m_LockExecuteThreadToCPU.count() == 0)
+  {
+    if (m_cpu_topology.size() == 0 &&
+        read_cpu_topology(m_cpu_topology) != 0)
+    {
+      m_info_msg.append("WARNING: Failed to read the CPU topology, "
+                        "threads are not placed automatically\n");
+    }
+    else
+    {
+      do_auto_bindings();
+    }
+    return 0;
+  }
+
   if (m_LockExecuteThreadToCPU.count())
   {
     /**
@@ -493,6 +509,211 @@ THRConfig::do_bindings(bool allow_too_few_cpus)
   return 0;
 }
 
+#ifdef __linux__
+static
+bool
+read_sysfs_uint(const char * path, unsigned * val)
+{
+  FILE * f = fopen(path, "r");
+  if (f == 0)
+    return false;
+  int res = fscanf(f, "%u", val);
+  fclose(f);
+  return res == 1;
+}
+#endif
+
+int
+THRConfig::read_cpu_topology(Vector<T_Cpu>& cpus)
+{
+#ifdef __linux__
+  const char * dir = "/sys/devices/system/cpu";
+  char path[256];
+  long cnt = sysconf(_SC_NPROCESSORS_CONF);
+  for (long i = 0; i < cnt; i++)
+  {
+    unsigned online = 1;
+    BaseString::snprintf(path, sizeof(path), "%s/cpu%ld/online", dir, i);
+    if (read_sysfs_uint(path, &online) && online == 0)
+      continue;
+
+    unsigned package, core, l3;
+    BaseString::snprintf(path, sizeof(path),
+                         "%s/cpu%ld/topology/physical_package_id", dir, i);
+    if (!read_sysfs_uint(path, &package))
+      return -1;
+    BaseString::snprintf(path, sizeof(path),
+                         "%s/cpu%ld/topology/core_id", dir, i);
+    if (!read_sysfs_uint(path, &core))
+      return -1;
+
+    /**
+     * The first CPU sharing the L3 cache identifies the cache,
+     *   if there is no L3 cache, the package is the domain
+     */
+    BaseString::snprintf(path, sizeof(path),
+                         "%s/cpu%ld/cache/index3/shared_cpu_list", dir, i);
+    if (!read_sysfs_uint(path, &l3))
+      l3 = 0x10000 + package;
+
+    T_Cpu cpu;
+    cpu.m_cpu_no = (unsigned)i;
+    cpu.m_core = (package << 16) + core;
+    cpu.m_l3 = l3;
+    cpus.push_back(cpu);
+  }
+  return cpus.size() ? 0 : -1;
+#else
+  (void)cpus;
+  return -1;
+#endif
+}
+
+/**
+ * States of a CPU during automatic placement
+ */
+#define CPU_FREE        0
+#define CPU_TAKEN       1
+#define CPU_LDM_SIBLING 2 // SMT sibling of a CPU running an LDM thread
+
+/**
+ * Find a CPU for a thread, starting with the L3 domain
+ *   given and trying the other domains in turn.
+ *   First a core which is completely free, then any free CPU,
+ *   then (unless for LDM) the SMT sibling of an LDM thread.
+ */
+static
+int
+find_cpu(const Vector<THRConfig::T_Cpu>& cpus,
+         const Vector<unsigned>& state,
+         const Vector<unsigned>& domains,
+         unsigned first_domain,
+         bool ldm)
+{
+  for (unsigned pass = 0; pass < (ldm ? 2U : 3U); pass++)
+  {
+    for (unsigned d = 0; d < domains.size(); d++)
+    {
+      const unsigned l3 = domains[(first_domain + d) % domains.size()];
+      for (unsigned i = 0; i < cpus.size(); i++)
+      {
+        if (cpus[i].m_l3 != l3)
+          continue;
+
+        if (pass == 2)
+        {
+          if (state[i] == CPU_LDM_SIBLING)
+            return (int)i;
+          continue;
+        }
+
+        if (state[i] != CPU_FREE)
+          continue;
+
+        bool core_free = true;
+        for (unsigned j = 0; pass == 0 && j < cpus.size(); j++)
+        {
+          if (cpus[j].m_core == cpus[i].m_core && state[j] != CPU_FREE)
+            core_free = false;
+        }
+        if (core_free)
+          return (int)i;
+      }
+    }
+  }
+  return -1;
+}
+
+/**
+ * Automatic thread placement (AutomaticThreadPlacement)
+ *
+ * LDM threads get a core of their own, with the SMT siblings
+ *   left to other threads only when nothing else is free, and are
+ *   spread round robin over the L3 cache domains.
+ * Receive, tc and send threads are spread over the domains the
+ *   same way, so that LDM thread i and receive thread i share a domain.
+ * Main and rep threads share a CPU.
+ * Threads bound explicitly in ThreadConfig keep their binding, and
+ *   threads for which no CPU is left stay unbound.
+ */
+void
+THRConfig::do_auto_bindings()
+{
+  const Vector<T_Cpu>& cpus = m_cpu_topology;
+  Vector<unsigned> state;
+  Vector<unsigned> domains;
+
+  for (unsigned i = 0; i < cpus.size(); i++)
+  {
+    unsigned s = CPU_FREE;
+    for (unsigned k = 0; k < m_cpu_sets.size(); k++)
+    {
+      if (m_cpu_sets[k].get(cpus[i].m_cpu_no))
+        s = CPU_TAKEN;
+    }
+    for (unsigned t = 0; t < NDB_ARRAY_SIZE(m_threads); t++)
+    {
+      for (unsigned j = 0; j < m_threads[t].size(); j++)
+      {
+        if (m_threads[t][j].m_bind_type == T_Thread::B_CPU_BOUND &&
+            m_threads[t][j].m_bind_no == cpus[i].m_cpu_no)
+          s = CPU_TAKEN;
+      }
+    }
+    state.push_back(s);
+
+    bool found = false;
+    for (unsigned d = 0; d < domains.size(); d++)
+    {
+      if (domains[d] == cpus[i].m_l3)
+        found = true;
+    }
+    if (!found)
+      domains.push_back(cpus[i].m_l3);
+  }
+
+  if (domains.size() == 0)
+    return;
+
+  static const T_Type order[] = { T_LDM, T_RECV, T_TC, T_SEND };
+  for (unsigned t = 0; t < NDB_ARRAY_SIZE(order); t++)
+  {
+    const bool ldm = (order[t] == T_LDM);
+    Vector<T_Thread>& vec = m_threads[order[t]];
+    for (unsigned i = 0; i < vec.size(); i++)
+    {
+      if (vec[i].m_bind_type != T_Thread::B_UNBOUND)
+        continue;
+
+      int cpu = find_cpu(cpus, state, domains, i % domains.size(), ldm);
+      if (cpu == -1 && ldm)
+        cpu = find_cpu(cpus, state, domains, i % domains.size(), false);
+      if (cpu == -1)
+        break;
+
+      vec[i].m_bind_type = T_Thread::B_CPU_BOUND;
+      vec[i].m_bind_no = cpus[cpu].m_cpu_no;
+      state[cpu] = CPU_TAKEN;
+      for (unsigned j = 0; ldm && j < cpus.size(); j++)
+      {
+        if (cpus[j].m_core == cpus[cpu].m_core && state[j] == CPU_FREE)
+          state[j] = CPU_LDM_SIBLING;
+      }
+    }
+  }
+
+  int cpu = find_cpu(cpus, state, domains, 0, false);
+  if (cpu != -1)
+  {
+    bind_unbound(m_threads[T_MAIN], cpus[cpu].m_cpu_no);
+    bind_unbound(m_threads[T_REP], cpus[cpu].m_cpu_no);
+  }
+
+  m_info_msg.appfmt("Automatic thread placement on %u CPU(s) "
+                    "in %u L3 cache domain(s)\n",
+                    cpus.size(), domains.size());
+}
+
 unsigned
 THRConfig::count_unbound(const Vector<T_Thread>& vec) const
 {
@@ -1004,6 +1225,7 @@ THRConfig::createCpuSet(const SparseBitmask& mask)
 
 template class Vector<SparseBitmask>;
 template class Vector<THRConfig::T_Thread>;
+template class Vector<THRConfig::T_Cpu>;
 
 #ifndef TEST_MT_THR_CONFIG
 #include <BlockNumbers.h>
@@ -1286,6 +1508,55 @@ TAPTEST(mt_thr_config)
     }
   }
 
+  {
+    /**
+     * Test automatic thread placement, on 2 L3 cache domains
+     *   of 4 cores with 2 SMT siblings each.
+     *   CPU c and c + 4 are siblings, 0-7 and 8-15 share L3.
+     */
+    Vector<THRConfig::T_Cpu> cpus;
+    for (unsigned c = 0; c < 16; c++)
+    {
+      THRConfig::T_Cpu cpu;
+      cpu.m_cpu_no = c;
+      cpu.m_core = (c / 8) * 4 + c % 4;
+      cpu.m_l3 = (c / 8) * 8;
+      cpus.push_back(cpu);
+    }
+
+    const char * t[] =
+    {
+      /** threads, answer */
+      "ldm={count=4},recv={count=2},tc={count=2}",
+      "main={cpubind=6},ldm={cpubind=0},ldm={cpubind=8},ldm={cpubind=1},ldm={cpubind=9},recv={cpubind=2},recv={cpubind=10},rep={cpubind=6},tc={cpubind=3},tc={cpubind=11}",
+
+      "ldm={count=4,cpubind=8,9,10,11},recv",
+      "main={cpubind=1},ldm={cpubind=8},ldm={cpubind=9},ldm={cpubind=10},ldm={cpubind=11},recv={cpubind=0},rep={cpubind=1}",
+
+      "ldm={count=8},recv={count=4},tc={count=4}",
+      "main,ldm={cpubind=0},ldm={cpubind=8},ldm={cpubind=1},ldm={cpubind=9},ldm={cpubind=2},ldm={cpubind=10},ldm={cpubind=3},ldm={cpubind=11},recv={cpubind=4},recv={cpubind=12},recv={cpubind=5},recv={cpubind=13},rep,tc={cpubind=6},tc={cpubind=14},tc={cpubind=7},tc={cpubind=15}",
+
+      // END
+      0
+    };
+
+    for (unsigned i = 0; t[i]; i+= 2)
+    {
+      THRConfig tmp;
+      tmp.setAutomaticThreadPlacement(true);
+      tmp.setCpuTopology(cpus);
+      const int res = tmp.do_parse(t[i+0]);
+      int ok = res == 0 && strcmp(tmp.getConfigString(), t[i+1]) == 0;
+      printf("auto conf: %s => %s(%s) - %s - %s\n",
+             t[i+0],
+             res == 0 ? "OK" : "FAIL",
+             res == 0 ? "" : tmp.getErrorMessage(),
+             tmp.getConfigString(),
+             ok == 1 ? "CORRECT" : "INCORRECT");
+      OK(ok == 1);
+    }
+  }
+
   for (Uint32 i = 9; i < 48; i++)
   {
     Uint32 t,l,s,r;
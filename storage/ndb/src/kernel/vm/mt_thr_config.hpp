@@ -55,6 +55,22 @@ public:
   // NOTE: needs to be called before do_parse
   int setLockExecuteThreadToCPU(const char * val);
   int setLockIoThreadsToCPU(unsigned val);
+  void setAutomaticThreadPlacement(bool val) { m_auto_placement = val; }
+
+  /**
+   * A CPU as seen by automatic thread placement
+   *   m_core is the same for SMT siblings of a core
+   *   m_l3 is the same for CPUs sharing a last level cache
+   */
+  struct T_Cpu
+  {
+    unsigned m_cpu_no;
+    unsigned m_core;
+    unsigned m_l3;
+  };
+
+  // NOTE: if not set, the topology is read from the OS by do_parse
+  void setCpuTopology(const Vector<T_Cpu>& cpus) { m_cpu_topology = cpus; }
 
   int do_parse(const char * ThreadConfig);
   int do_parse(unsigned MaxNoOfExecutionThreads,
@@ -78,6 +94,8 @@ protected:
     unsigned m_bind_no; // cpu_no/cpuset_no
   };
   bool m_classic;
+  bool m_auto_placement;
+  Vector<T_Cpu> m_cpu_topology;
   SparseBitmask m_LockExecuteThreadToCPU;
   SparseBitmask m_LockIoThreadsToCPU;
   Vector<SparseBitmask> m_cpu_sets;
@@ -95,6 +113,8 @@ protected:
 
   unsigned createCpuSet(const SparseBitmask&);
   int do_bindings(bool allow_too_few_cpus);
+  int read_cpu_topology(Vector<T_Cpu>&);
+  void do_auto_bindings();
   int do_validate();
 
   unsigned count_unbound(const Vector<T_Thread>& vec) const;
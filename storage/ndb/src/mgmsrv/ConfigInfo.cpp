@@ -653,6 +653,20 @@ const ConfigInfo::ParamInfo ConfigInfo::m_ParamInfo[] = {
     "65535"
   },
 
+  {
+    CFG_DB_AUTO_THREAD_PLACEMENT,
+    "AutomaticThreadPlacement",
+    DB_TOKEN,
+    "Bind the execution threads to CPUs based on the CPU topology, "
+    "when no CPUs are given with LockExecuteThreadToCPU",
+    ConfigInfo::CI_USED,
+    false,
+    ConfigInfo::CI_BOOL,
+    "false",
+    "false",
+    "true"
+  },
+
   {
     CFG_DB_MAINT_LOCK_CPU,
     "LockMaintThreadsToCPU",
@@ -1569,6 +1583,20 @@ const ConfigInfo::ParamInfo ConfigInfo::m_ParamInfo[] = {
     "0",
     STR_VALUE(MAX_INT_RNIL) },
 
+  {
+    CFG_DB_BACKUP_DATA_FILE_PARTS,
+    "BackupDataFileParts",
+    DB_TOKEN,
+    "Number of data files a node writes in parallel during a backup, each"
+    " using its own part of BackupDataBufferSize.  0 means one per LDM"
+    " thread",
+    ConfigInfo::CI_USED,
+    false,
+    ConfigInfo::CI_INT,
+    "0",
+    "0",
+    STR_VALUE(MAX_NDBMT_LQH_WORKERS) },
+
   { 
     CFG_DB_BACKUP_WRITE_SIZE,
     "BackupWriteSize",
@@ -1664,6 +1692,19 @@ const ConfigInfo::ParamInfo ConfigInfo::m_ParamInfo[] = {
     "false",
     "false",
     "true"},
+
+  {
+    CFG_DB_ODIRECT_NATIVE_AIO,
+    "ODirectNativeAio",
+    DB_TOKEN,
+    "Use Linux native asynchronous I/O to read and write files "
+    "opened with O_DIRECT",
+    ConfigInfo::CI_USED,
+    false,
+    ConfigInfo::CI_BOOL,
+    "false",
+    "false",
+    "true"},
   {
     CFG_DB_COMPRESSED_BACKUP,
     "CompressedBackup",
@@ -2064,6 +2105,22 @@ const ConfigInfo::ParamInfo ConfigInfo::m_ParamInfo[] = {
     "1"
   },
 
+  {
+    CFG_DB_TUX_NORM_KEYS,
+    "OrderedIndexNormalizedKeys",
+    DB_TOKEN,
+    "Store a normalized key of the first attribute with each ordered index"
+    " entry, if the attribute is an integer.  Most key comparisons within"
+    " an index node then do not read the row, but a node holds fewer"
+    " entries.  Applies to indexes built after a restart",
+    ConfigInfo::CI_USED,
+    false,
+    ConfigInfo::CI_BOOL,
+    "false",
+    "false",
+    "true"
+  },
+
   {
     CFG_DB_INDEX_STAT_AUTO_UPDATE,
     "IndexStatAutoUpdate",
@@ -2187,6 +2244,19 @@ const ConfigInfo::ParamInfo ConfigInfo::m_ParamInfo[] = {
     "100"
   },
 
+  {
+    CFG_DB_MAX_SEND_DELAY,
+    "MaxSendDelay",
+    DB_TOKEN,
+    "Max number of microseconds the send threads delay a send to a node which is sent to frequently, to send more data per system call (0 = never delay)",
+    ConfigInfo::CI_USED,
+    false,
+    ConfigInfo::CI_INT,
+    "0",
+    "0",
+    "11000"
+  },
+
   /***************************************************************************
    * API
    ***************************************************************************/
@@ -2073,6 +2073,16 @@ void Ndb::setReportThreshEventFreeMem(unsigned thresh)
   }
 }
 
+void Ndb::setEventBufferMaxAlloc(unsigned sz)
+{
+  theEventBuffer->m_max_alloc= sz;
+}
+
+unsigned Ndb::getEventBufferMaxAlloc() const
+{
+  return theEventBuffer->m_max_alloc;
+}
+
 Uint64 Ndb::allocate_transaction_id()
 {
   Uint64 ret= theFirstTransId;
@@ -1110,6 +1110,9 @@ NdbEventBuffer::NdbEventBuffer(Ndb *ndb) :
   m_highest_sub_gcp_complete_GCI(0),
   m_latest_poll_GCI(0),
   m_total_alloc(0),
+  m_max_alloc(0),
+  m_overloaded(false),
+  m_dropped_events(0),
   m_free_thresh(0),
   m_min_free_thresh(0),
   m_max_free_thresh(0),
@@ -2532,6 +2535,18 @@ NdbEventBuffer::insertDataL(NdbEventOperationImpl *op,
       data = hpos.data;
     }
     
+    if (data == 0 && is_data_event && unlikely(is_overloaded()))
+    {
+      /**
+       * Out of event buffer memory, discard the event and mark
+       * the epoch as possibly missing data, the consumer sees
+       * the gap through isConsistent()
+       */
+      bucket->m_state |= Gci_container::GC_INCONSISTENT;
+      m_dropped_events++;
+      DBUG_RETURN_EVENT(0);
+    }
+
     if (data == 0)
     {
       // allocate new result buffer
@@ -2631,6 +2646,39 @@ NdbEventBuffer::insertDataL(NdbEventOperationImpl *op,
 #endif
 }
 
+/**
+ * Check the memory in use against m_max_alloc.  The state changes
+ * are reported once, with the number of events discarded.
+ */
+bool
+NdbEventBuffer::is_overloaded()
+{
+  if (m_max_alloc == 0 && !m_overloaded)
+    return false;
+
+  const Uint32 used = m_total_alloc - m_free_data_sz;
+  if (!m_overloaded)
+  {
+    if (used < m_max_alloc)
+      return false;
+    m_overloaded = true;
+    g_eventLogger->warning("Event buffer full, %u bytes in use, limit %u: "
+                           "discarding events until the consumer catches up",
+                           used, m_max_alloc);
+  }
+  else
+  {
+    if (m_max_alloc != 0 && used >= m_max_alloc)
+      return true;
+    m_overloaded = false;
+    g_eventLogger->info("Event buffer has free memory again, "
+                        "%llu events were discarded",
+                        m_dropped_events);
+    m_dropped_events = 0;
+  }
+  return m_overloaded;
+}
+
 // allocate EventBufData
 EventBufData*
 NdbEventBuffer::alloc_data()
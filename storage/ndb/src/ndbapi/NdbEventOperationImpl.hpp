@@ -558,6 +558,7 @@ public:
   void free_list(EventBufData_list &list);
 
   void reportStatus();
+  bool is_overloaded();
 
   // Global Mutex used for some things
   static NdbMutex *p_add_drop_mutex;
@@ -594,6 +595,9 @@ public:
   EventBufData_list m_used_data;
 
   unsigned m_total_alloc; // total allocated memory
+  unsigned m_max_alloc;   // limit on memory in use, 0 - unlimited
+  bool m_overloaded;      // discarding data events at m_max_alloc
+  Uint64 m_dropped_events;
 
   // threshholds to report status
   unsigned m_free_thresh, m_min_free_thresh, m_max_free_thresh;
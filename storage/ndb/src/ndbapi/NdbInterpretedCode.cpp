@@ -636,6 +636,95 @@ NdbInterpretedCode::branch_col_ge(const void * val,
   return branch_col(Interpreter::GE, attrId, val, 0, Label);
 }
 
+int
+NdbInterpretedCode::branch_col_col(Uint32 branch_type,
+                                   Uint32 attrId1,
+                                   Uint32 attrId2,
+                                   Uint32 Label)
+{
+  DBUG_ENTER("NdbInterpretedCode::branch_col_col");
+  DBUG_PRINT("enter", ("type: %u  col1: %u  col2: %u  label: %u",
+                       branch_type, attrId1, attrId2, Label));
+
+  if (unlikely(m_table_impl == NULL))
+    /* NdbInterpretedCode instruction requires that table is set */
+    DBUG_RETURN(error(4538));
+
+  const NdbColumnImpl * col1 = m_table_impl->getColumn(attrId1);
+  const NdbColumnImpl * col2 = m_table_impl->getColumn(attrId2);
+
+  if (col1 == NULL || col2 == NULL)
+    DBUG_RETURN(error(BadAttributeId));
+
+  /* The data node compares the values with the type of the first column */
+  if (col1->m_type != col2->m_type ||
+      col1->m_attrSize != col2->m_attrSize ||
+      col1->m_arraySize != col2->m_arraySize ||
+      col1->m_precision != col2->m_precision ||
+      col1->m_scale != col2->m_scale ||
+      col1->m_cs != col2->m_cs ||
+      col1->m_type == NdbDictionary::Column::Bit ||
+      col1->getBlobType())
+    DBUG_RETURN(error(BadColumnTypes));
+
+  if (col1->m_storageType == NDB_STORAGETYPE_DISK ||
+      col2->m_storageType == NDB_STORAGETYPE_DISK)
+    m_flags|= UsesDisk;
+
+  /**
+   * The instruction compares <arg attr> <cond> <attr>, like the
+   * constant in BRANCH_ATTR_OP_ARG, so attrId1 is the argument
+   */
+  Interpreter::BinaryCondition c=
+    (Interpreter::BinaryCondition)branch_type;
+  if (add_branch(Interpreter::BranchColAttr(c), Label) != 0)
+    DBUG_RETURN(-1);
+
+  DBUG_RETURN(add1(Interpreter::BranchColAttr_2(attrId2, attrId1)));
+}
+
+int
+NdbInterpretedCode::branch_col_eq_col(Uint32 attrId1, Uint32 attrId2,
+                                      Uint32 Label)
+{
+  return branch_col_col(Interpreter::EQ, attrId1, attrId2, Label);
+}
+
+int
+NdbInterpretedCode::branch_col_ne_col(Uint32 attrId1, Uint32 attrId2,
+                                      Uint32 Label)
+{
+  return branch_col_col(Interpreter::NE, attrId1, attrId2, Label);
+}
+
+int
+NdbInterpretedCode::branch_col_lt_col(Uint32 attrId1, Uint32 attrId2,
+                                      Uint32 Label)
+{
+  return branch_col_col(Interpreter::LT, attrId1, attrId2, Label);
+}
+
+int
+NdbInterpretedCode::branch_col_le_col(Uint32 attrId1, Uint32 attrId2,
+                                      Uint32 Label)
+{
+  return branch_col_col(Interpreter::LE, attrId1, attrId2, Label);
+}
+
+int
+NdbInterpretedCode::branch_col_gt_col(Uint32 attrId1, Uint32 attrId2,
+                                      Uint32 Label)
+{
+  return branch_col_col(Interpreter::GT, attrId1, attrId2, Label);
+}
+
+int
+NdbInterpretedCode::branch_col_ge_col(Uint32 attrId1, Uint32 attrId2,
+                                      Uint32 Label)
+{
+  return branch_col_col(Interpreter::GE, attrId1, attrId2, Label);
+}
+
 int 
 NdbInterpretedCode::branch_col_like(const void * val, 
                                     Uint32 len,
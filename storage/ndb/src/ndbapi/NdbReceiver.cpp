@@ -166,13 +166,22 @@ NdbReceiver::prepareRead(char *buf, Uint32 rows)
   'batch_size' rows from each fragment.
   ::ndbrecord_rowsize() might be usefull for calculating the
   buffersize to allocate for this resultset.
+
+  If the user did not specify a batch size, and 'rowsize' (the largest
+  possible size of a row, from ::ndbrecord_rowsize()) is given, the
+  batch is sized by bytes: as many rows as fit into 'batch_byte_size'.
+  Small rows then get more rows per round trip than the configured
+  BatchSize, and large rows do not make the receive buffers
+  (batch_size * rowsize for each fragment) grow beyond what
+  MaxScanBatchSize allows for the whole scan.
 */
 //static
 void
 NdbReceiver::calculate_batch_size(const NdbImpl& theImpl,
                                   Uint32 parallelism,
                                   Uint32& batch_size,
-                                  Uint32& batch_byte_size)
+                                  Uint32& batch_byte_size,
+                                  Uint32 rowsize)
 {
   const NdbApiConfig & cfg = theImpl.get_ndbapi_config_parameters();
   const Uint32 max_scan_batch_size= cfg.m_scan_batch_size;
@@ -184,7 +193,13 @@ NdbReceiver::calculate_batch_size(const NdbImpl& theImpl,
     batch_byte_size= max_scan_batch_size / parallelism;
   }
 
-  if (batch_size == 0 || batch_size > max_batch_size) {
+  if (batch_size == 0 && rowsize > 0) {
+    batch_size= batch_byte_size / rowsize;
+    if (batch_size == 0) {
+      batch_size= 1;
+    }
+  }
+  else if (batch_size == 0 || batch_size > max_batch_size) {
     batch_size= max_batch_size;
   }
   if (unlikely(batch_size > MAX_PARALLEL_OP_PER_SCAN)) {
@@ -200,12 +215,14 @@ NdbReceiver::calculate_batch_size(const NdbImpl& theImpl,
 void
 NdbReceiver::calculate_batch_size(Uint32 parallelism,
                                   Uint32& batch_size,
-                                  Uint32& batch_byte_size) const
+                                  Uint32& batch_byte_size,
+                                  Uint32 rowsize) const
 {
   calculate_batch_size(* m_ndb->theImpl,
                        parallelism,
                        batch_size,
-                       batch_byte_size);
+                       batch_byte_size,
+                       rowsize);
 }
 
 void
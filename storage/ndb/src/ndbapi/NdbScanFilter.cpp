@@ -58,6 +58,9 @@ public:
   int cond_col_const(Interpreter::BinaryCondition, Uint32 attrId, 
 		     const void * value, Uint32 len);
 
+  int cond_col_col(Interpreter::BinaryCondition, Uint32 attrId1,
+                   Uint32 attrId2);
+
   /* Method to initialise the members */
   void init (NdbInterpretedCode *code)
   {
@@ -719,6 +722,140 @@ NdbScanFilter::cmp(BinaryCondition cond, int ColId,
   return -1;
 }
 
+/* Column to column branch definition method signature */
+typedef int (NdbInterpretedCode:: * ColBranch2)(Uint32, Uint32, Uint32);
+
+struct tab4 {
+  ColBranch2 m_branches[5];
+};
+
+/* Table of branch methods to use for column to column
+ * comparisons, for each logical group type, as in table3.
+ * The second column takes the place of the constant value.
+ */
+static const tab4 table4[] = {
+  /**
+   * EQ (AND, OR, NAND, NOR)
+   */
+  { { 0, 
+      &NdbInterpretedCode::branch_col_ne_col, 
+      &NdbInterpretedCode::branch_col_eq_col, 
+      &NdbInterpretedCode::branch_col_ne_col,  
+      &NdbInterpretedCode::branch_col_eq_col } }
+  
+  /**
+   * NEQ
+   */
+  ,{ { 0, 
+       &NdbInterpretedCode::branch_col_eq_col, 
+       &NdbInterpretedCode::branch_col_ne_col, 
+       &NdbInterpretedCode::branch_col_eq_col, 
+       &NdbInterpretedCode::branch_col_ne_col } }
+  
+  /**
+   * LT
+   */
+  ,{ { 0, 
+       &NdbInterpretedCode::branch_col_le_col, 
+       &NdbInterpretedCode::branch_col_gt_col, 
+       &NdbInterpretedCode::branch_col_le_col,
+       &NdbInterpretedCode::branch_col_gt_col } }
+  
+  /**
+   * LE
+   */
+  ,{ { 0, 
+       &NdbInterpretedCode::branch_col_lt_col, 
+       &NdbInterpretedCode::branch_col_ge_col, 
+       &NdbInterpretedCode::branch_col_lt_col, 
+       &NdbInterpretedCode::branch_col_ge_col } }
+  
+  /**
+   * GT
+   */
+  ,{ { 0, 
+       &NdbInterpretedCode::branch_col_ge_col, 
+       &NdbInterpretedCode::branch_col_lt_col, 
+       &NdbInterpretedCode::branch_col_ge_col, 
+       &NdbInterpretedCode::branch_col_lt_col } }
+
+  /**
+   * GE
+   */
+  ,{ { 0, 
+       &NdbInterpretedCode::branch_col_gt_col, 
+       &NdbInterpretedCode::branch_col_le_col, 
+       &NdbInterpretedCode::branch_col_gt_col, 
+       &NdbInterpretedCode::branch_col_le_col } }
+};
+
+const int tab4_sz = sizeof(table4)/sizeof(table4[0]);
+
+int
+NdbScanFilterImpl::cond_col_col(Interpreter::BinaryCondition op,
+                                Uint32 AttrId1,
+                                Uint32 AttrId2){
+  if (m_error.code != 0) return -1;
+
+  if(op < 0 || op >= tab4_sz){
+    /* Condition is out of bounds */
+    m_error.code= 4262;
+    return -1;
+  }
+  
+  if(m_current.m_group < NdbScanFilter::AND || 
+     m_current.m_group > NdbScanFilter::NOR){
+    /* Operator is not defined in NdbScanFilter::Group */
+    m_error.code= 4260;
+    return -1;
+  }
+
+  ColBranch2 branch;
+  if(m_negative == 1){  //change NdbOperation to its negative
+    if(m_current.m_group == NdbScanFilter::AND)
+      branch = table4[op].m_branches[NdbScanFilter::OR];
+    else if(m_current.m_group == NdbScanFilter::OR)
+      branch = table4[op].m_branches[NdbScanFilter::AND];
+    else
+    {
+      assert(FALSE);
+      m_error.code= 4260;
+      return -1;
+    }
+  }else{
+    branch = table4[op].m_branches[(Uint32)(m_current.m_group)];
+  }
+
+  if ((m_code->* branch)(AttrId2, AttrId1, m_current.m_ownLabel) == -1)
+    return propagateErrorFromCode();
+
+  return 0;
+}
+
+int
+NdbScanFilter::cmp_cols(BinaryCondition cond, int ColId1, int ColId2)
+{
+  switch(cond){
+  case COND_LE:
+    return m_impl.cond_col_col(Interpreter::LE, ColId1, ColId2);
+  case COND_LT:
+    return m_impl.cond_col_col(Interpreter::LT, ColId1, ColId2);
+  case COND_GE:
+    return m_impl.cond_col_col(Interpreter::GE, ColId1, ColId2);
+  case COND_GT:
+    return m_impl.cond_col_col(Interpreter::GT, ColId1, ColId2);
+  case COND_EQ:
+    return m_impl.cond_col_col(Interpreter::EQ, ColId1, ColId2);
+  case COND_NE:
+    return m_impl.cond_col_col(Interpreter::NE, ColId1, ColId2);
+  default:
+    break;
+  }
+  /* Condition is out of bounds */
+  m_impl.m_error.code= 4262;
+  return -1;
+}
+
 static void
 update(const NdbError & _err){
   NdbError & error = (NdbError &) _err;
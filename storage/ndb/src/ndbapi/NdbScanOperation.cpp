@@ -2310,16 +2310,27 @@ int NdbScanOperation::prepareSendScan(Uint32 aTC_ConnectPtr,
   bool keyInfo = m_keyInfo;
   Uint32 key_size= keyInfo ? m_attribute_record->m_keyLenInWords : 0;
 
+  /* All scans use NdbRecord internally */
+  assert(theStatus == UseNdbRecord);
+  
+  assert(theParallelism > 0);
+  Uint32 rowsize= NdbReceiver::ndbrecord_rowsize(m_attribute_record,
+                                                 theReceiver.theFirstRecAttr,
+                                                 key_size,
+                                                 m_read_range_no);
+
   /**
    * The number of records sent by each LQH is calculated and the kernel
-   * is informed of this number by updating the SCAN_TABREQ signal
+   * is informed of this number by updating the SCAN_TABREQ signal.
+   * Unless the user specified it, the batch size follows the row size.
    */
   ScanTabReq * req = CAST_PTR(ScanTabReq, theSCAN_TABREQ->getDataPtrSend());
   Uint32 batch_size = req->first_batch_size; // User specified
   Uint32 batch_byte_size;
   theReceiver.calculate_batch_size(theParallelism,
                                    batch_size,
-                                   batch_byte_size);
+                                   batch_byte_size,
+                                   rowsize);
   ScanTabReq::setScanBatch(req->requestInfo, batch_size);
   req->batch_byte_size= batch_byte_size;
   req->first_batch_size= batch_size;
@@ -2339,14 +2350,6 @@ int NdbScanOperation::prepareSendScan(Uint32 aTC_ConnectPtr,
   req->distributionKey= theDistributionKey;
   theSCAN_TABREQ->setLength(ScanTabReq::StaticLength + theDistrKeyIndicator_);
 
-  /* All scans use NdbRecord internally */
-  assert(theStatus == UseNdbRecord);
-  
-  assert(theParallelism > 0);
-  Uint32 rowsize= NdbReceiver::ndbrecord_rowsize(m_attribute_record,
-                                                 theReceiver.theFirstRecAttr,
-                                                 key_size,
-                                                 m_read_range_no);
   Uint32 bufsize= batch_size*rowsize;
   char *buf= new char[bufsize*theParallelism];
   if (!buf)
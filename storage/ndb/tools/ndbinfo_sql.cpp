@@ -70,6 +70,16 @@ struct view {
     " remote_address, bytes_sent, bytes_received "
     "FROM `<NDBINFO_DB>`.`<TABLE_PREFIX>transporters`"
   },
+  { "transporter_sends",
+    "SELECT node_id, remote_node_id, "
+    " CASE histogram"
+    "  WHEN 0 THEN \"BYTES_PER_SEND\""
+    "  WHEN 1 THEN \"SEND_DELAY\""
+    "  ELSE NULL "
+    " END AS histogram, "
+    " bucket_max, count "
+    "FROM `<NDBINFO_DB>`.`<TABLE_PREFIX>transporter_sends`"
+  },
   { "logspaces",
     "SELECT node_id, "
     " CASE log_type"
@@ -196,6 +206,9 @@ struct view {
   { "threadstat",
     "SELECT * from `<NDBINFO_DB>`.`<TABLE_PREFIX>threadstat`"
   },
+  { "threadstat_history",
+    "SELECT * from `<NDBINFO_DB>`.`<TABLE_PREFIX>threadstat_history`"
+  },
   { "cluster_transactions",
     "SELECT"
     " t.node_id,"
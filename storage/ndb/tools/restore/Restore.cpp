@@ -773,11 +773,11 @@ RestoreMetaData::parseTableDescriptor(const Uint32 * data, Uint32 len)
 }
 
 // Constructor
-RestoreDataIterator::RestoreDataIterator(const RestoreMetaData & md, void (* _free_data_callback)())
+RestoreDataIterator::RestoreDataIterator(const RestoreMetaData & md, void (* _free_data_callback)(), Uint32 part)
   : BackupFile(_free_data_callback), m_metaData(md)
 {
   debug << "RestoreDataIterator constructor" << endl;
-  setDataFile(md, 0);
+  setDataFile(md, part);
 
   m_bitfield_storage_len = 8192;
   m_bitfield_storage_ptr = (Uint32*)malloc(4*m_bitfield_storage_len);
@@ -1351,6 +1351,16 @@ BackupFile::openFile(){
   return true;
 }
 
+bool
+BackupFile::exists() const
+{
+  FILE * f = fopen(m_fileName, "rb");
+  if (f == 0)
+    return false;
+  fclose(f);
+  return true;
+}
+
 Uint32 BackupFile::buffer_get_ptr_ahead(void **p_buf_ptr, Uint32 size, Uint32 nmemb)
 {
   Uint32 sz = size*nmemb;
@@ -2012,9 +2022,11 @@ RestoreLogIterator::getNextLogEntry(int & res) {
     const Uint32 sz = ah->getDataSize();
     if(sz == 0){
       attr->Data.null = true;
+      attr->Data.size = 0;
       attr->Data.void_value = NULL;
     } else {
       attr->Data.null = false;
+      attr->Data.size = 4*sz;
       attr->Data.void_value = ah->getDataPtr();
       Twiddle(attr->Desc, &(attr->Data));
     }
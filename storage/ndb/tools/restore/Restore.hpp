@@ -353,6 +353,7 @@ protected:
 public:
   bool readHeader();
   bool validateFooter();
+  bool exists() const;
 
   const char * getPath() const { return m_path;}
   const char * getFilename() const { return m_fileName;}
@@ -424,7 +425,8 @@ public:
 
   // Constructor
   RestoreDataIterator(const RestoreMetaData &,
-                      void (* free_data_callback)());
+                      void (* free_data_callback)(),
+                      Uint32 part = 0);
   virtual ~RestoreDataIterator();
   
   // Read data file fragment header
@@ -35,6 +35,7 @@ extern FilteredNdbOut info;
 extern FilteredNdbOut debug;
 
 static void callback(int, NdbTransaction*, void*);
+static void log_callback(int, NdbTransaction*, void*);
 static Uint32 get_part_id(const NdbDictionary::Table *table,
                           Uint32 hash_value);
 
@@ -813,6 +814,24 @@ BackupRestore::init(Uint32 tableChangesMask)
   }
   m_callback[m_parallelism-1].next = 0;
 
+  m_log_callback = new restore_log_callback_t[m_parallelism];
+
+  if (m_log_callback == 0)
+  {
+    err << "Failed to allocate log callback structs" << endl;
+    return false;
+  }
+
+  m_free_log_callback= m_log_callback;
+  for (Uint32 i= 0; i < m_parallelism; i++) {
+    m_log_callback[i].restore= this;
+    m_log_callback[i].connection= 0;
+    m_log_callback[i].table= 0;
+    if (i > 0)
+      m_log_callback[i-1].next= &(m_log_callback[i]);
+  }
+  m_log_callback[m_parallelism-1].next = 0;
+
   return true;
 }
 
@@ -830,6 +849,13 @@ void BackupRestore::release()
     m_callback= 0;
   }
 
+  if (m_log_callback)
+  {
+    delete [] m_log_callback;
+    m_log_callback= 0;
+    m_free_log_callback= 0;
+  }
+
   if (m_cluster_connection)
   {
     delete m_cluster_connection;
@@ -2813,13 +2839,79 @@ struct TransGuard
   ~TransGuard() { if (pTrans) pTrans->close();}
 };
 
+bool
+BackupRestore::log_fragment_busy(const TableS *table, Uint32 fragId) const
+{
+  for (Uint32 i= 0; i < m_parallelism; i++)
+  {
+    const restore_log_callback_t *cb = &m_log_callback[i];
+    if (cb->connection != 0 && cb->table == table && cb->fragId == fragId)
+      return true;
+  }
+  return false;
+}
+
 void
 BackupRestore::logEntry(const LogEntry & tup)
 {
   if (!m_restore)
     return;
 
+  /**
+   * Wait for a free transaction, and for the previous change
+   * of the same fragment to complete
+   */
+  while (m_free_log_callback == 0 ||
+         log_fragment_busy(tup.m_table, tup.m_frag_id))
+  {
+    // send-poll all transactions
+    // close transaction is done in callback
+    m_ndb->sendPollNdb(3000, 1);
+  }
+
+  restore_log_callback_t * cb = m_free_log_callback;
+  m_free_log_callback = cb->next;
+
+  cb->retries = 0;
+  cb->type = tup.m_type;
+  cb->table = tup.m_table;
+  cb->fragId = tup.m_frag_id;
+
+  /**
+   * Copy the values, each aligned to 8 bytes
+   */
+  Uint32 words = 0;
+  for (Uint32 i= 0; i < tup.size(); i++)
+  {
+    const AttributeS * attr = tup[i];
+    if (!attr->Data.null)
+      words += (MAX(attr->Data.size, attr->Desc->getSizeInBytes()) + 7) / 8;
+  }
+  Uint64 zero = 0;
+  cb->buf.clear();
+  cb->buf.fill(words, zero);
+  cb->attrs.clear();
+
+  Uint32 pos = 0;
+  for (Uint32 i= 0; i < tup.size(); i++)
+  {
+    AttributeS attr = *tup[i];
+    if (!attr.Data.null)
+    {
+      char * dst = (char*)(cb->buf.getBase() + pos);
+      memcpy(dst, attr.Data.string_value, attr.Data.size);
+      attr.Data.string_value = dst;
+      pos += (MAX(attr.Data.size, attr.Desc->getSizeInBytes()) + 7) / 8;
+    }
+    cb->attrs.push_back(attr);
+  }
+
+  logEntry_a(cb);
+}
 
+void
+BackupRestore::logEntry_a(restore_log_callback_t *cb)
+{
   Uint32 retries = 0;
   NdbError errobj;
 retry:
@@ -2847,8 +2939,7 @@ retry:
     exitHandler();
   } // if
   
-  TransGuard g(trans);
-  const NdbDictionary::Table * table = get_table(tup.m_table->m_dictTable);
+  const NdbDictionary::Table * table = get_table(cb->table->m_dictTable);
   NdbOperation * op = trans->getNdbOperation(table);
   if (op == NULL) 
   {
@@ -2857,7 +2948,7 @@ retry:
   } // if
   
   int check = 0;
-  switch(tup.m_type)
+  switch(cb->type)
   {
   case LogEntry::LE_INSERT:
     check = op->insertTuple();
@@ -2880,23 +2971,24 @@ retry:
     exitHandler();
   } // if
 
+  const Uint32 no_attrs = cb->attrs.size();
   if (table->getFragmentType() == NdbDictionary::Object::UserDefined)
   {
     if (table->getDefaultNoPartitionsFlag())
     {
-      const AttributeS * attr = tup[tup.size()-1];
+      const AttributeS * attr = &cb->attrs[no_attrs-1];
       Uint32 hash_value = *(Uint32*)attr->Data.string_value;
       op->setPartitionId(get_part_id(table, hash_value));
     }
     else
-      op->setPartitionId(tup.m_frag_id);
+      op->setPartitionId(cb->fragId);
   }
 
   Bitmask<4096> keys;
   Uint32 n_bytes= 0;
-  for (Uint32 i= 0; i < tup.size(); i++) 
+  for (Uint32 i= 0; i < no_attrs; i++) 
   {
-    const AttributeS * attr = tup[i];
+    const AttributeS * attr = &cb->attrs[i];
     int size = attr->Desc->size;
     int arraySize = attr->Desc->arraySize;
     const char * dataPtr = attr->Data.string_value;
@@ -2904,8 +2996,8 @@ retry:
     if (attr->Desc->m_exclude)
       continue;
     
-    if (tup.m_table->have_auto_inc(attr->Desc->attrId))
-      tup.m_table->update_max_auto_val(dataPtr,size*arraySize);
+    if (cb->retries == 0 && cb->table->have_auto_inc(attr->Desc->attrId))
+      cb->table->update_max_auto_val(dataPtr,size*arraySize);
 
     const Uint32 length = (size / 8) * arraySize;
     n_bytes+= length;
@@ -2952,17 +3044,44 @@ retry:
   {
     op->setAnyValue(NDB_ANYVALUE_FOR_NOLOGGING);
   }
-  const int ret = trans->execute(NdbTransaction::Commit);
-  if (ret != 0)
+
+  // Prepare transaction (the transaction is NOT yet sent to NDB)
+  cb->connection = trans;
+  cb->n_bytes = n_bytes;
+  trans->executeAsynchPrepare(NdbTransaction::Commit,
+                              &log_callback, cb);
+  m_transactions++;
+}
+
+void
+BackupRestore::log_cback(int result, restore_log_callback_t *cb)
+{
+  m_transactions--;
+
+  if (result < 0)
   {
     // Both insert update and delete can fail during log running
     // and it's ok
     bool ok= false;
-    errobj= trans->getNdbError();
+    NdbError errobj= cb->connection->getNdbError();
+    m_ndb->closeTransaction(cb->connection);
+    cb->connection= 0;
+
     if (errobj.status == NdbError::TemporaryError)
-      goto retry;
+    {
+      cb->retries++;
+      if (cb->retries == 11)
+      {
+        err << "execute failed: " << errobj << endl;
+        exitHandler();
+      }
+      m_temp_error = true;
+      NdbSleep_MilliSleep(100 + (cb->retries - 1) * 100);
+      logEntry_a(cb); // retry, the fragment stays busy until done
+      return;
+    }
 
-    switch(tup.m_type)
+    switch(cb->type)
     {
     case LogEntry::LE_INSERT:
       if(errobj.status == NdbError::PermanentError &&
@@ -2982,17 +3101,36 @@ retry:
       exitHandler();
     }
   }
-  
-  m_logBytes+= n_bytes;
+  else
+  {
+    m_ndb->closeTransaction(cb->connection);
+    cb->connection= 0;
+  }
+
+  cb->next= m_free_log_callback;
+  m_free_log_callback= cb;
+  m_logBytes+= cb->n_bytes;
   m_logCount++;
 }
 
+void
+BackupRestore::log_free()
+{
+  // Poll all transactions
+  while (m_transactions)
+  {
+    m_ndb->sendPollNdb(3000);
+  }
+}
+
 void
 BackupRestore::endOfLogEntrys()
 {
   if (!m_restore)
     return;
 
+  log_free();
+
   info.setLevel(254);
   info << "Restored " << m_dataCount << " tuples and "
        << m_logCount << " log entries" << endl;
@@ -3014,6 +3152,13 @@ callback(int result, NdbTransaction* trans, void* aObject)
   (cb->restore)->cback(result, cb);
 }
 
+static void
+log_callback(int result, NdbTransaction* trans, void* aObject)
+{
+  restore_log_callback_t *cb = (restore_log_callback_t *)aObject;
+  (cb->restore)->log_cback(result, cb);
+}
+
 
 AttrCheckCompatFunc 
 BackupRestore::get_attr_check_compatability(const NDBCOL::Type &old_type, 
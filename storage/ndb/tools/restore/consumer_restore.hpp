@@ -33,6 +33,24 @@ struct restore_callback_t {
   restore_callback_t *next;
 };
 
+/**
+ * A log entry being applied asynchronously.
+ * The attribute values are copied into buf since the log iterator
+ * reuses its buffers, and a temporary error redefines the operation.
+ */
+struct restore_log_callback_t {
+  class BackupRestore *restore;
+  class NdbTransaction *connection;
+  int    retries;
+  LogEntry::EntryType type;
+  TableS *table;
+  Uint32 fragId;
+  Uint32 n_bytes;
+  Vector<AttributeS> attrs;
+  Vector<Uint64> buf;
+  restore_log_callback_t *next;
+};
+
 struct char_n_padding_struct {
 Uint32 n_old; // used also for time precision
 Uint32 n_new;
@@ -79,6 +97,8 @@ public:
     m_parallelism = parallelism;
     m_callback = 0;
     m_free_callback = 0;
+    m_log_callback = 0;
+    m_free_log_callback = 0;
     m_temp_error = false;
     m_no_upgrade = false;
     m_tableChangesMask = 0;
@@ -106,6 +126,9 @@ public:
   virtual void exitHandler();
   virtual void endOfTuples();
   virtual void logEntry(const LogEntry &);
+  virtual void logEntry_a(restore_log_callback_t *cb);
+  virtual void log_cback(int result, restore_log_callback_t *cb);
+  virtual void log_free();
   virtual void endOfLogEntrys();
   virtual bool finalize_table(const TableS &);
   virtual bool rebuild_indexes(const TableS&);
@@ -216,6 +239,15 @@ public:
 
   restore_callback_t *m_callback;
   restore_callback_t *m_free_callback;
+
+  /**
+   * Log entries are applied with up to m_parallelism transactions
+   * in flight, at most one per table fragment, which keeps the
+   * changes to each row in log order.
+   */
+  restore_log_callback_t *m_log_callback;
+  restore_log_callback_t *m_free_log_callback;
+  bool log_fragment_busy(const TableS *table, Uint32 fragId) const;
   bool m_temp_error;
 
   /**
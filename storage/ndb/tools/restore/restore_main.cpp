@@ -177,7 +177,7 @@ static struct my_option my_long_options[] =
    (uchar**) &ga_skip_table_check, (uchar**) &ga_skip_table_check, 0,
    GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0 },
   { "parallelism", 'p',
-    "No of parallel transactions during restore of data."
+    "No of parallel transactions during restore of data and log."
     "(parallelism can be 1 to 1024)", 
     (uchar**) &ga_nParallelism, (uchar**) &ga_nParallelism, 0,
     GET_INT, REQUIRED_ARG, 128, 1, 1024, 0, 1, 0 },
@@ -1431,56 +1431,68 @@ main(int argc, char** argv)
           } 
         }
       }
-      RestoreDataIterator dataIter(metaData, &free_data_callback);
-      
-      // Read data file header
-      if (!dataIter.readHeader())
+      /**
+       * A node writes one data file per data file part,
+       *   BACKUP-<id>-<part>.<node>.Data
+       */
+      for (Uint32 part = 0; ; part++)
       {
-	err << "Failed to read header of data file. Exiting..." << endl;
-	exitHandler(NDBT_FAILED);
-      }
+        RestoreDataIterator dataIter(metaData, &free_data_callback, part);
+        if (part > 0 && !dataIter.exists())
+          break;
       
-      Uint32 fragmentId; 
-      while (dataIter.readFragmentHeader(res= 0, &fragmentId))
-      {
-	const TupleS* tuple;
-	while ((tuple = dataIter.getNextTuple(res= 1)) != 0)
-	{
-          const TableS* table = tuple->getTable();
-          OutputStream *output = table_output[table->getLocalId()];
-          if (!output)
-            continue;
-          OutputStream *tmp = ndbout.m_out;
-          ndbout.m_out = output;
-          for(Uint32 j= 0; j < g_consumers.size(); j++) 
-            g_consumers[j]->tuple(* tuple, fragmentId);
-          ndbout.m_out =  tmp;
-          if (check_progress())
-            report_progress("Data file progress: ", dataIter);
-	} // while (tuple != NULL);
-	
-	if (res < 0)
-	{
-	  err <<" Restore: An error occured while restoring data. Exiting...";
-          err << endl;
-	  exitHandler(NDBT_FAILED);
-	}
-	if (!dataIter.validateFragmentFooter()) {
-	  err << "Restore: Error validating fragment footer. ";
-          err << "Exiting..." << endl;
+        // Read data file header
+        if (!dataIter.readHeader())
+        {
+	  err << "Failed to read header of data file. Exiting..." << endl;
 	  exitHandler(NDBT_FAILED);
-	}
-      } // while (dataIter.readFragmentHeader(res))
+        }
       
-      if (res < 0)
-      {
-	err << "Restore: An error occured while restoring data. Exiting... "
-	    << "res= " << res << endl;
-	exitHandler(NDBT_FAILED);
-      }
+        Uint32 fragmentId; 
+        while (dataIter.readFragmentHeader(res= 0, &fragmentId))
+        {
+	  const TupleS* tuple;
+	  while ((tuple = dataIter.getNextTuple(res= 1)) != 0)
+	  {
+            const TableS* table = tuple->getTable();
+            OutputStream *output = table_output[table->getLocalId()];
+            if (!output)
+              continue;
+            OutputStream *tmp = ndbout.m_out;
+            ndbout.m_out = output;
+            for(Uint32 j= 0; j < g_consumers.size(); j++) 
+              g_consumers[j]->tuple(* tuple, fragmentId);
+            ndbout.m_out =  tmp;
+            if (check_progress())
+              report_progress("Data file progress: ", dataIter);
+	  } // while (tuple != NULL);
+	
+	  if (res < 0)
+	  {
+	    err <<" Restore: An error occured while restoring data. Exiting...";
+            err << endl;
+	    exitHandler(NDBT_FAILED);
+	  }
+	  if (!dataIter.validateFragmentFooter()) {
+	    err << "Restore: Error validating fragment footer. ";
+            err << "Exiting..." << endl;
+	    exitHandler(NDBT_FAILED);
+	  }
+        } // while (dataIter.readFragmentHeader(res))
+      
+        if (res < 0)
+        {
+	  err << "Restore: An error occured while restoring data. Exiting... "
+	      << "res= " << res << endl;
+	  exitHandler(NDBT_FAILED);
+        }
       
       
-      dataIter.validateFooter(); //not implemented
+        dataIter.validateFooter(); //not implemented
+
+        // Tuples still in flight refer to the buffers of dataIter
+        free_data_callback();
+      }
       
       for (i= 0; i < g_consumers.size(); i++)
 	g_consumers[i]->endOfTuples();
@@ -41,6 +41,7 @@
 #include "sp_head.h"
 #include "pfs_digest.h"
 #include "pfs_program.h"
+#include "pfs_cpu_sample.h"
 
 /**
   @page PAGE_PERFORMANCE_SCHEMA The Performance Schema main page
@@ -2316,6 +2317,23 @@ void pfs_delete_thread_v1(PSI_thread *thread)
   }
 }
 
+/**
+  Decide if a synchronization wait is timed, when sampling.
+  Only one wait in @c PFS_instr_class::m_sample_rate is timed.
+  The number of waits already counted for the instance
+  is used as the sample sequence, so that no other shared
+  state is written to in the instrumented code.
+  @param klass the instrument class
+  @param stat the wait statistics of the instance
+  @return true if this wait is timed
+*/
+static inline bool is_wait_sampled(const PFS_instr_class *klass,
+                                   const PFS_single_stat *stat)
+{
+  uint rate= klass->m_sample_rate;
+  return (rate <= 1) || (stat->m_count % rate == 0);
+}
+
 /**
   Implementation of the mutex instrumentation interface.
   @sa PSI_v1::start_mutex_wait.
@@ -2338,6 +2356,8 @@ pfs_start_mutex_wait_v1(PSI_mutex_locker_state *state,
 
   uint flags;
   ulonglong timer_start= 0;
+  bool timed= pfs_mutex->m_timed &&
+    is_wait_sampled(pfs_mutex->m_class, & pfs_mutex->m_mutex_stat.m_wait_stat);
 
   if (flag_thread_instrumentation)
   {
@@ -2349,7 +2369,7 @@ pfs_start_mutex_wait_v1(PSI_mutex_locker_state *state,
     state->m_thread= reinterpret_cast<PSI_thread *> (pfs_thread);
     flags= STATE_FLAG_THREAD;
 
-    if (pfs_mutex->m_timed)
+    if (timed)
     {
       timer_start= get_timer_raw_value_and_function(wait_timer, & state->m_timer);
       state->m_timer_start= timer_start;
@@ -2390,7 +2410,7 @@ pfs_start_mutex_wait_v1(PSI_mutex_locker_state *state,
   }
   else
   {
-    if (pfs_mutex->m_timed)
+    if (timed)
     {
       timer_start= get_timer_raw_value_and_function(wait_timer, & state->m_timer);
       state->m_timer_start= timer_start;
@@ -2436,6 +2456,8 @@ pfs_start_rwlock_rdwait_v1(PSI_rwlock_locker_state *state,
 
   uint flags;
   ulonglong timer_start= 0;
+  bool timed= pfs_rwlock->m_timed &&
+    is_wait_sampled(pfs_rwlock->m_class, & pfs_rwlock->m_rwlock_stat.m_wait_stat);
 
   if (flag_thread_instrumentation)
   {
@@ -2447,7 +2469,7 @@ pfs_start_rwlock_rdwait_v1(PSI_rwlock_locker_state *state,
     state->m_thread= reinterpret_cast<PSI_thread *> (pfs_thread);
     flags= STATE_FLAG_THREAD;
 
-    if (pfs_rwlock->m_timed)
+    if (timed)
     {
       timer_start= get_timer_raw_value_and_function(wait_timer, & state->m_timer);
       state->m_timer_start= timer_start;
@@ -2488,7 +2510,7 @@ pfs_start_rwlock_rdwait_v1(PSI_rwlock_locker_state *state,
   }
   else
   {
-    if (pfs_rwlock->m_timed)
+    if (timed)
     {
       timer_start= get_timer_raw_value_and_function(wait_timer, & state->m_timer);
       state->m_timer_start= timer_start;
@@ -2553,6 +2575,8 @@ pfs_start_cond_wait_v1(PSI_cond_locker_state *state,
 
   uint flags;
   ulonglong timer_start= 0;
+  bool timed= pfs_cond->m_timed &&
+    is_wait_sampled(pfs_cond->m_class, & pfs_cond->m_cond_stat.m_wait_stat);
 
   if (flag_thread_instrumentation)
   {
@@ -2564,7 +2588,7 @@ pfs_start_cond_wait_v1(PSI_cond_locker_state *state,
     state->m_thread= reinterpret_cast<PSI_thread *> (pfs_thread);
     flags= STATE_FLAG_THREAD;
 
-    if (pfs_cond->m_timed)
+    if (timed)
     {
       timer_start= get_timer_raw_value_and_function(wait_timer, & state->m_timer);
       state->m_timer_start= timer_start;
@@ -2605,7 +2629,7 @@ pfs_start_cond_wait_v1(PSI_cond_locker_state *state,
   }
   else
   {
-    if (pfs_cond->m_timed)
+    if (timed)
     {
       timer_start= get_timer_raw_value_and_function(wait_timer, & state->m_timer);
       state->m_timer_start= timer_start;
@@ -3596,6 +3620,7 @@ void pfs_end_mutex_wait_v1(PSI_mutex_locker* locker, int rc)
 
   PFS_mutex *mutex= reinterpret_cast<PFS_mutex *> (state->m_mutex);
   DBUG_ASSERT(mutex != NULL);
+  uint sample_rate= mutex->m_class->m_sample_rate;
   PFS_thread *thread= reinterpret_cast<PFS_thread *> (state->m_thread);
 
   uint flags= state->m_flags;
@@ -3605,7 +3630,7 @@ void pfs_end_mutex_wait_v1(PSI_mutex_locker* locker, int rc)
     timer_end= state->m_timer();
     wait_time= timer_end - state->m_timer_start;
     /* Aggregate to EVENTS_WAITS_SUMMARY_BY_INSTANCE (timed) */
-    mutex->m_mutex_stat.m_wait_stat.aggregate_value(wait_time);
+    mutex->m_mutex_stat.m_wait_stat.aggregate_sampled(wait_time, sample_rate);
   }
   else
   {
@@ -3628,7 +3653,7 @@ void pfs_end_mutex_wait_v1(PSI_mutex_locker* locker, int rc)
     if (flags & STATE_FLAG_TIMED)
     {
       /* Aggregate to EVENTS_WAITS_SUMMARY_BY_THREAD_BY_EVENT_NAME (timed) */
-      event_name_array[index].aggregate_value(wait_time);
+      event_name_array[index].aggregate_sampled(wait_time, sample_rate);
     }
     else
     {
@@ -3666,13 +3691,14 @@ void pfs_end_rwlock_rdwait_v1(PSI_rwlock_locker* locker, int rc)
 
   PFS_rwlock *rwlock= reinterpret_cast<PFS_rwlock *> (state->m_rwlock);
   DBUG_ASSERT(rwlock != NULL);
+  uint sample_rate= rwlock->m_class->m_sample_rate;
 
   if (state->m_flags & STATE_FLAG_TIMED)
   {
     timer_end= state->m_timer();
     wait_time= timer_end - state->m_timer_start;
     /* Aggregate to EVENTS_WAITS_SUMMARY_BY_INSTANCE (timed) */
-    rwlock->m_rwlock_stat.m_wait_stat.aggregate_value(wait_time);
+    rwlock->m_rwlock_stat.m_wait_stat.aggregate_sampled(wait_time, sample_rate);
   }
   else
   {
@@ -3707,7 +3733,7 @@ void pfs_end_rwlock_rdwait_v1(PSI_rwlock_locker* locker, int rc)
     if (state->m_flags & STATE_FLAG_TIMED)
     {
       /* Aggregate to EVENTS_WAITS_SUMMARY_BY_THREAD_BY_EVENT_NAME (timed) */
-      event_name_array[index].aggregate_value(wait_time);
+      event_name_array[index].aggregate_sampled(wait_time, sample_rate);
     }
     else
     {
@@ -3745,6 +3771,7 @@ void pfs_end_rwlock_wrwait_v1(PSI_rwlock_locker* locker, int rc)
 
   PFS_rwlock *rwlock= reinterpret_cast<PFS_rwlock *> (state->m_rwlock);
   DBUG_ASSERT(rwlock != NULL);
+  uint sample_rate= rwlock->m_class->m_sample_rate;
   PFS_thread *thread= reinterpret_cast<PFS_thread *> (state->m_thread);
 
   if (state->m_flags & STATE_FLAG_TIMED)
@@ -3752,7 +3779,7 @@ void pfs_end_rwlock_wrwait_v1(PSI_rwlock_locker* locker, int rc)
     timer_end= state->m_timer();
     wait_time= timer_end - state->m_timer_start;
     /* Aggregate to EVENTS_WAITS_SUMMARY_BY_INSTANCE (timed) */
-    rwlock->m_rwlock_stat.m_wait_stat.aggregate_value(wait_time);
+    rwlock->m_rwlock_stat.m_wait_stat.aggregate_sampled(wait_time, sample_rate);
   }
   else
   {
@@ -3779,7 +3806,7 @@ void pfs_end_rwlock_wrwait_v1(PSI_rwlock_locker* locker, int rc)
     if (state->m_flags & STATE_FLAG_TIMED)
     {
       /* Aggregate to EVENTS_WAITS_SUMMARY_BY_THREAD_BY_EVENT_NAME (timed) */
-      event_name_array[index].aggregate_value(wait_time);
+      event_name_array[index].aggregate_sampled(wait_time, sample_rate);
     }
     else
     {
@@ -3816,6 +3843,7 @@ void pfs_end_cond_wait_v1(PSI_cond_locker* locker, int rc)
   ulonglong wait_time= 0;
 
   PFS_cond *cond= reinterpret_cast<PFS_cond *> (state->m_cond);
+  uint sample_rate= cond->m_class->m_sample_rate;
   /* PFS_mutex *mutex= reinterpret_cast<PFS_mutex *> (state->m_mutex); */
 
   if (state->m_flags & STATE_FLAG_TIMED)
@@ -3823,7 +3851,7 @@ void pfs_end_cond_wait_v1(PSI_cond_locker* locker, int rc)
     timer_end= state->m_timer();
     wait_time= timer_end - state->m_timer_start;
     /* Aggregate to EVENTS_WAITS_SUMMARY_BY_INSTANCE (timed) */
-    cond->m_cond_stat.m_wait_stat.aggregate_value(wait_time);
+    cond->m_cond_stat.m_wait_stat.aggregate_sampled(wait_time, sample_rate);
   }
   else
   {
@@ -3843,7 +3871,7 @@ void pfs_end_cond_wait_v1(PSI_cond_locker* locker, int rc)
     if (state->m_flags & STATE_FLAG_TIMED)
     {
       /* Aggregate to EVENTS_WAITS_SUMMARY_BY_THREAD_BY_EVENT_NAME (timed) */
-      event_name_array[index].aggregate_value(wait_time);
+      event_name_array[index].aggregate_sampled(wait_time, sample_rate);
     }
     else
     {
@@ -4352,6 +4380,37 @@ void pfs_end_file_close_wait_v1(PSI_file_locker *locker, int rc)
   return;
 }
 
+/**
+  Read the hardware counters of the thread at the start of a stage.
+  The counters are not read when they are disabled or unavailable.
+*/
+static inline void start_stage_hw_counters(PFS_events_stages *pfs)
+{
+  pfs->m_hw_counters_valid= false;
+  if (! my_perf_counters_enabled ||
+      my_perf_counters_read(& pfs->m_hw_counters))
+    pfs->m_hw_counters.thread_id= 0;
+}
+
+/**
+  Compute the hardware counts of a stage when it ends.
+  The counts are valid only if the counters could be read in the same
+  thread at both ends of the stage.
+*/
+static inline void end_stage_hw_counters(PFS_events_stages *pfs)
+{
+  MY_PERF_COUNTERS hw_end;
+
+  if (my_perf_counters_enabled &&
+      pfs->m_hw_counters.thread_id != 0 &&
+      ! my_perf_counters_read(& hw_end) &&
+      ! my_perf_counters_diff(& hw_end, & pfs->m_hw_counters))
+  {
+    pfs->m_hw_counters= hw_end;
+    pfs->m_hw_counters_valid= true;
+  }
+}
+
 void pfs_start_stage_v1(PSI_stage_key key, const char *src_file, int src_line)
 {
   ulonglong timer_value= 0;
@@ -4399,6 +4458,7 @@ void pfs_start_stage_v1(PSI_stage_key key, const char *src_file, int src_line)
     if (flag_events_stages_current)
     {
       pfs->m_end_event_id= pfs_thread->m_event_id;
+      end_stage_hw_counters(pfs);
       if (flag_events_stages_history)
         insert_events_stages_history(pfs_thread, pfs);
       if (flag_events_stages_history_long)
@@ -4446,6 +4506,7 @@ void pfs_start_stage_v1(PSI_stage_key key, const char *src_file, int src_line)
     pfs->m_end_event_id= 0;
     pfs->m_source_file= src_file;
     pfs->m_source_line= src_line;
+    start_stage_hw_counters(pfs);
 
     /* New wait events will have this new stage as parent. */
     child_wait->m_event_id= pfs->m_event_id;
@@ -4497,6 +4558,7 @@ void pfs_end_stage_v1()
     if (flag_events_stages_current)
     {
       pfs->m_end_event_id= pfs_thread->m_event_id;
+      end_stage_hw_counters(pfs);
       if (flag_events_stages_history)
         insert_events_stages_history(pfs_thread, pfs);
       if (flag_events_stages_history_long)
@@ -4669,6 +4731,7 @@ pfs_get_thread_statement_locker_v1(PSI_statement_locker_state *state,
   state->m_sort_scan= 0;
   state->m_no_index_used= 0;
   state->m_no_good_index_used= 0;
+  state->m_cpu_samples_start= 0;
 
   state->m_schema_name_length= 0;
   state->m_parent_sp_share= sp_share;
@@ -4740,6 +4803,17 @@ void pfs_start_statement_v1(PSI_statement_locker *locker,
     state->m_timer_start= timer_start;
   }
 
+  if ((flags & STATE_FLAG_DIGEST) && cpu_sample_interval != 0)
+  {
+    PFS_thread *thread;
+    if (flags & STATE_FLAG_THREAD)
+      thread= reinterpret_cast<PFS_thread *> (state->m_thread);
+    else
+      thread= my_pthread_get_THR_PFS();
+    if (thread != NULL)
+      state->m_cpu_samples_start= thread->m_cpu_samples;
+  }
+
   compile_time_assert(PSI_SCHEMA_NAME_LEN == NAME_LEN);
   DBUG_ASSERT(db_len <= sizeof(state->m_schema_name));
 
@@ -4945,6 +5019,7 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
    Capture statement stats by digest.
   */
   PSI_digest_storage *digest_storage= NULL;
+  PFS_statements_digest_stat *digest_record= NULL;
   PFS_statement_stat *digest_stat= NULL;
   PFS_program *pfs_program= NULL;
 
@@ -4960,9 +5035,13 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
     {
       digest_storage= &state->m_digest_state.m_digest_storage;
       /* Populate PFS_statements_digest_stat with computed digest information.*/
-      digest_stat= find_or_create_digest(thread, digest_storage,
-                                         state->m_schema_name,
-                                         state->m_schema_name_length);
+      digest_record= find_or_create_digest(thread, digest_storage,
+                                           state->m_schema_name,
+                                           state->m_schema_name_length);
+      /* Aggregate to EVENTS_CPU_SAMPLES_SUMMARY_BY_DIGEST */
+      if (digest_record != NULL && cpu_sample_interval != 0)
+        digest_record->m_cpu_samples+=
+          thread->m_cpu_samples - state->m_cpu_samples_start;
     }
 
     if (flags & STATE_FLAG_EVENT)
@@ -5033,9 +5112,13 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
         /* Set digest stat. */
         digest_storage= &state->m_digest_state.m_digest_storage;
         /* Populate statements_digest_stat with computed digest information. */
-        digest_stat= find_or_create_digest(thread, digest_storage,
-                                           state->m_schema_name,
-                                           state->m_schema_name_length);
+        digest_record= find_or_create_digest(thread, digest_storage,
+                                             state->m_schema_name,
+                                             state->m_schema_name_length);
+        /* Aggregate to EVENTS_CPU_SAMPLES_SUMMARY_BY_DIGEST */
+        if (digest_record != NULL && cpu_sample_interval != 0)
+          digest_record->m_cpu_samples+=
+            thread->m_cpu_samples - state->m_cpu_samples_start;
       }
     }
 
@@ -5044,10 +5127,23 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
     stat= & event_name_array[index];
   }
 
+  if (digest_record != NULL)
+    digest_stat= & digest_record->m_stat;
+
   if (flags & STATE_FLAG_TIMED)
   {
     /* Aggregate to EVENTS_STATEMENTS_SUMMARY_..._BY_EVENT_NAME (timed) */
     stat->aggregate_value(wait_time);
+
+    /*
+      Aggregate to EVENTS_STATEMENTS_QUANTILES_GLOBAL_BY_EVENT_NAME
+      and EVENTS_STATEMENTS_QUANTILES_BY_DIGEST, directly:
+      histograms are not kept per thread, account, user or host.
+    */
+    global_instr_class_statements_histogram_array[index]
+      .aggregate_value(wait_time);
+    if (digest_record != NULL)
+      digest_record->m_histogram.aggregate_value(wait_time);
   }
   else
   {
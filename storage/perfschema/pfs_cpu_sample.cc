@@ -0,0 +1,119 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+/**
+  @file storage/perfschema/pfs_cpu_sample.cc
+  CPU samples of the running threads (implementation).
+*/
+
+#include "my_global.h"
+#include "my_pthread.h"
+#include "pfs.h"
+#include "pfs_server.h"
+#include "pfs_instr_class.h"
+#include "pfs_instr.h"
+#include "pfs_events_waits.h"
+#include "pfs_atomic.h"
+#include "pfs_cpu_sample.h"
+
+#include <signal.h>
+#include <errno.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#if defined(HAVE_SIGACTION) && defined(ITIMER_PROF)
+#define PFS_HAVE_CPU_SAMPLE
+#endif
+
+ulong cpu_sample_interval= 0;
+
+#ifdef PFS_HAVE_CPU_SAMPLE
+
+/**
+  Signal handler for @c SIGPROF.
+  The kernel delivers the signal to the thread
+  which was running when the profiling timer expired.
+*/
+static void cpu_sample_handler(int)
+{
+  int saved_errno= errno;
+
+  if (flag_global_instrumentation)
+  {
+    PFS_thread *thread= my_pthread_getspecific_ptr(PFS_thread*, THR_PFS);
+    if (thread != NULL)
+    {
+      thread->m_cpu_samples++;
+
+      /* The stage key is the stage class index + 1. */
+      PFS_stage_key stage= thread->m_stage;
+      volatile uint64 *array= global_instr_class_stages_cpu_samples_array;
+      if (stage != 0 && stage <= stage_class_max && array != NULL)
+        PFS_atomic::add_u64(& array[stage - 1], 1);
+    }
+  }
+
+  errno= saved_errno;
+}
+
+static void set_cpu_sample_timer(ulong interval)
+{
+  struct itimerval timer;
+
+  timer.it_interval.tv_sec= interval / 1000000;
+  timer.it_interval.tv_usec= interval % 1000000;
+  timer.it_value= timer.it_interval;
+  setitimer(ITIMER_PROF, & timer, NULL);
+}
+
+#endif /* PFS_HAVE_CPU_SAMPLE */
+
+int init_cpu_sample(const PFS_global_param *param)
+{
+  cpu_sample_interval= 0;
+
+  if (param->m_cpu_sample_interval == 0)
+    return 0;
+
+#ifdef PFS_HAVE_CPU_SAMPLE
+  struct sigaction action;
+
+  memset(& action, 0, sizeof(action));
+  action.sa_handler= cpu_sample_handler;
+  action.sa_flags= SA_RESTART;
+  sigemptyset(& action.sa_mask);
+  if (sigaction(SIGPROF, & action, NULL))
+    return 1;
+
+  cpu_sample_interval= param->m_cpu_sample_interval;
+  set_cpu_sample_timer(cpu_sample_interval);
+#endif
+  return 0;
+}
+
+void cleanup_cpu_sample()
+{
+#ifdef PFS_HAVE_CPU_SAMPLE
+  /*
+    The signal handler stays installed:
+    the default action of a pending SIGPROF is to terminate the process.
+  */
+  if (cpu_sample_interval != 0)
+    set_cpu_sample_timer(0);
+#endif
+  cpu_sample_interval= 0;
+}
+
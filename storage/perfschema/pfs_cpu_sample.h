@@ -0,0 +1,60 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+#ifndef PFS_CPU_SAMPLE_H
+#define PFS_CPU_SAMPLE_H
+
+/**
+  @file storage/perfschema/pfs_cpu_sample.h
+  CPU samples of the running threads (declarations).
+*/
+
+struct PFS_global_param;
+
+/**
+  @addtogroup Performance_schema_buffers
+  @{
+*/
+
+/**
+  Interval between two CPU samples, in microseconds of CPU time.
+  0 when CPU samples are not taken.
+*/
+extern ulong cpu_sample_interval;
+
+/**
+  Start taking CPU samples.
+  A profiling timer (@c ITIMER_PROF) interrupts the thread
+  which is running on a CPU when the process has used
+  @c m_cpu_sample_interval microseconds of CPU time.
+  The signal handler then counts a sample:
+  - for the instrumented thread, in @c PFS_thread::m_cpu_samples,
+  which is aggregated to the statement digest when a statement ends,
+  - for the current stage of the thread,
+  in @c global_instr_class_stages_cpu_samples_array.
+  The signal handler only writes to memory of the current thread
+  and increments counters atomically, it takes no locks.
+  On platforms without profiling timers, no samples are taken.
+  @param param the performance schema parameters
+  @return 0 on success
+*/
+int init_cpu_sample(const PFS_global_param *param);
+
+/** Stop taking CPU samples. */
+void cleanup_cpu_sample();
+
+/** @} */
+#endif
+
@@ -169,7 +169,29 @@ static LF_PINS* get_digest_hash_pins(PFS_thread *thread)
   return thread->m_digest_hash_pins;
 }
 
-PFS_statement_stat*
+/**
+  Hash the tokens and the schema of a statement,
+  for the per thread digest cache.
+  This hash only needs to be fast, collisions are detected
+  by comparing the tokens with the cached digest record.
+*/
+static ulonglong digest_cache_hash(const PSI_digest_storage *digest_storage,
+                                   const char *schema_name,
+                                   uint schema_name_length)
+{
+  /* 64 bits FNV-1a */
+  ulonglong hash= 14695981039346656037ULL;
+  const uchar *pos= digest_storage->m_token_array;
+  const uchar *end= pos + digest_storage->m_byte_count;
+
+  for ( ; pos < end; pos++)
+    hash= (hash ^ *pos) * 1099511628211ULL;
+  for (uint i= 0; i < schema_name_length; i++)
+    hash= (hash ^ (uchar) schema_name[i]) * 1099511628211ULL;
+  return hash;
+}
+
+PFS_statements_digest_stat*
 find_or_create_digest(PFS_thread *thread,
                       PSI_digest_storage *digest_storage,
                       const char *schema_name,
@@ -181,6 +203,34 @@ find_or_create_digest(PFS_thread *thread,
   if (digest_storage->m_byte_count <= 0)
     return NULL;
 
+  PFS_statements_digest_stat *pfs= NULL;
+  ulonglong cache_hash= digest_cache_hash(digest_storage, schema_name,
+                                          schema_name_length);
+  PFS_digest_cache_entry *cache_entry=
+    & thread->m_digest_cache[cache_hash & (DIGEST_CACHE_SIZE - 1)];
+
+  if (cache_entry->m_hash == cache_hash &&
+      cache_entry->m_digest_stat != NULL)
+  {
+    /*
+      The record may have been reset or reused for another statement
+      since it was cached, by TRUNCATE TABLE, so check what it holds.
+      This is a dirty read, like the aggregation of the stats.
+    */
+    pfs= cache_entry->m_digest_stat;
+    if (pfs->m_digest_storage.m_byte_count == digest_storage->m_byte_count &&
+        pfs->m_digest_key.m_schema_name_length == schema_name_length &&
+        memcmp(pfs->m_digest_key.m_schema_name, schema_name,
+               schema_name_length) == 0 &&
+        memcmp(pfs->m_digest_storage.m_token_array,
+               digest_storage->m_token_array,
+               digest_storage->m_byte_count) == 0)
+    {
+      pfs->m_last_seen= my_micro_time();
+      return pfs;
+    }
+  }
+
   LF_PINS *pins= get_digest_hash_pins(thread);
   if (unlikely(pins == NULL))
     return NULL;
@@ -206,7 +256,6 @@ find_or_create_digest(PFS_thread *thread,
   uint retry_count= 0;
   const uint retry_max= 3;
   PFS_statements_digest_stat **entry;
-  PFS_statements_digest_stat *pfs= NULL;
 
   ulonglong now= my_micro_time();
 
@@ -223,7 +272,9 @@ search:
     pfs= *entry;
     pfs->m_last_seen= now;
     lf_hash_search_unpin(pins);
-    return & pfs->m_stat;
+    cache_entry->m_hash= cache_hash;
+    cache_entry->m_digest_stat= pfs;
+    return pfs;
   }
 
   lf_hash_search_unpin(pins);
@@ -237,7 +288,7 @@ search:
     if (pfs->m_first_seen == 0)
       pfs->m_first_seen= now;
     pfs->m_last_seen= now;
-    return & pfs->m_stat;
+    return pfs;
   }
 
   safe_index= PFS_atomic::add_u32(& digest_index, 1);
@@ -250,7 +301,7 @@ search:
     if (pfs->m_first_seen == 0)
       pfs->m_first_seen= now;
     pfs->m_last_seen= now;
-    return & pfs->m_stat;
+    return pfs;
   }
 
   /* Add a new record in digest stat array. */
@@ -271,7 +322,9 @@ search:
   res= lf_hash_insert(&digest_hash, pins, &pfs);
   if (likely(res == 0))
   {
-    return & pfs->m_stat;
+    cache_entry->m_hash= cache_hash;
+    cache_entry->m_digest_stat= pfs;
+    return pfs;
   }
 
   if (res > 0)
@@ -317,6 +370,8 @@ void PFS_statements_digest_stat::reset_data()
 {
   digest_reset(& m_digest_storage);
   m_stat.reset();
+  m_histogram.reset();
+  m_cpu_samples= 0;
   m_first_seen= 0;
   m_last_seen= 0;
 }
@@ -355,6 +410,28 @@ void reset_esms_by_digest()
   digest_index= 1;
 }
 
+void reset_esms_quantiles_by_digest()
+{
+  uint index;
+
+  if (statements_digest_stat_array == NULL)
+    return;
+
+  for (index= 0; index < digest_max; index++)
+    statements_digest_stat_array[index].m_histogram.reset();
+}
+
+void reset_ecss_by_digest()
+{
+  uint index;
+
+  if (statements_digest_stat_array == NULL)
+    return;
+
+  for (index= 0; index < digest_max; index++)
+    statements_digest_stat_array[index].m_cpu_samples= 0;
+}
+
 /*
   Iterate token array and updates digest_text.
 */
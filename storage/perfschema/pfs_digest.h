@@ -57,6 +57,12 @@ struct PFS_ALIGNED PFS_statements_digest_stat
   /** Statement stat. */
   PFS_statement_stat m_stat;
 
+  /** Statement latency histogram. */
+  PFS_histogram m_histogram;
+
+  /** Number of CPU samples taken while executing this digest. */
+  ulonglong m_cpu_samples;
+
   /** First and last seen timestamps.*/
   ulonglong m_first_seen;
   ulonglong m_last_seen;
@@ -72,14 +78,17 @@ void cleanup_digest();
 
 int init_digest_hash(void);
 void cleanup_digest_hash(void);
-PFS_statement_stat* find_or_create_digest(PFS_thread *thread,
-                                          PSI_digest_storage *digest_storage,
-                                          const char *schema_name,
-                                          uint schema_name_length);
+PFS_statements_digest_stat*
+find_or_create_digest(PFS_thread *thread,
+                      PSI_digest_storage *digest_storage,
+                      const char *schema_name,
+                      uint schema_name_length);
 
 void get_digest_text(char *digest_text, PSI_digest_storage *digest_storage);
 
 void reset_esms_by_digest();
+void reset_esms_quantiles_by_digest();
+void reset_ecss_by_digest();
 
 /* Exposing the data directly, for iterators. */
 extern PFS_statements_digest_stat *statements_digest_stat_array;
@@ -62,6 +62,10 @@
 #include "table_esms_by_account_by_event_name.h"
 #include "table_esms_global_by_event_name.h"
 #include "table_esms_by_digest.h"
+#include "table_esq_by_digest.h"
+#include "table_esq_global_by_event_name.h"
+#include "table_ecss_by_digest.h"
+#include "table_ecss_global_by_event_name.h"
 #include "table_esms_by_program.h"
 
 #include "table_users.h"
@@ -153,6 +157,10 @@ static PFS_engine_table_share *all_shares[]=
   &table_esms_global_by_event_name::m_share,
   &table_esms_by_digest::m_share,
   &table_esms_by_program::m_share,
+  &table_esq_by_digest::m_share,
+  &table_esq_global_by_event_name::m_share,
+  &table_ecss_by_digest::m_share,
+  &table_ecss_global_by_event_name::m_share,
 
   &table_users::m_share,
   &table_accounts::m_share,
@@ -568,6 +576,13 @@ void PFS_engine_table::set_field_timestamp(Field *f, ulonglong value)
   f2->store_timestamp(& tm);
 }
 
+ulong PFS_engine_table::get_field_ulong(Field *f)
+{
+  DBUG_ASSERT(f->real_type() == MYSQL_TYPE_LONG);
+  Field_long *f2= (Field_long*) f;
+  return (ulong) f2->val_int();
+}
+
 ulonglong PFS_engine_table::get_field_enum(Field *f)
 {
   DBUG_ASSERT(f->real_type() == MYSQL_TYPE_ENUM);
@@ -1559,11 +1574,37 @@ bool pfs_show_status(handlerton *hton, THD *thd,
       size= host_max * memory_class_max * sizeof(PFS_memory_stat);
       total_memory+= size;
       break;
+    case 177:
+      name= "events_statements_quantiles_global_by_event_name.size";
+      size= sizeof(PFS_histogram);
+      break;
+    case 178:
+      name= "events_statements_quantiles_global_by_event_name.count";
+      size= statement_class_max;
+      break;
+    case 179:
+      name= "events_statements_quantiles_global_by_event_name.memory";
+      size= statement_class_max * sizeof(PFS_histogram);
+      total_memory+= size;
+      break;
+    case 180:
+      name= "events_cpu_samples_summary_global_by_event_name.size";
+      size= sizeof(uint64);
+      break;
+    case 181:
+      name= "events_cpu_samples_summary_global_by_event_name.count";
+      size= stage_class_max;
+      break;
+    case 182:
+      name= "events_cpu_samples_summary_global_by_event_name.memory";
+      size= stage_class_max * sizeof(uint64);
+      total_memory+= size;
+      break;
     /*
       This case must be last,
       for aggregation in total_memory.
     */
-    case 177:
+    case 183:
       name= "performance_schema.memory";
       size= total_memory;
       /* This will fail if something is not advertised here */
@@ -137,6 +137,12 @@ public:
     @param value the value to assign
   */
   static void set_field_timestamp(Field *f, ulonglong value);
+  /**
+    Helper, read a value from an ulong field.
+    @param f the field to read
+    @return the field value
+  */
+  static ulong get_field_ulong(Field *f);
   /**
     Helper, read a value from an enum field.
     @param f the field to read
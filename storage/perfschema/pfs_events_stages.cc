@@ -250,3 +250,16 @@ void reset_events_stages_global()
     stat->reset();
 }
 
+/** Reset table EVENTS_CPU_SAMPLES_SUMMARY_GLOBAL_BY_EVENT_NAME data. */
+void reset_events_stages_cpu_samples_global()
+{
+  uint index;
+
+  if (global_instr_class_stages_cpu_samples_array == NULL)
+    return;
+
+  for (index= 0; index < stage_class_max; index++)
+    PFS_atomic::store_u64(
+      & global_instr_class_stages_cpu_samples_array[index], 0);
+}
+
@@ -22,6 +22,7 @@
 */
 
 #include "pfs_events.h"
+#include "my_perf_counters.h"
 
 struct PFS_thread;
 struct PFS_account;
@@ -31,7 +32,14 @@ struct PFS_host;
 /** A stage record. */
 struct PFS_events_stages : public PFS_events
 {
-  /* No specific attributes */
+  /**
+    Hardware counters of the thread.
+    Values at the start of the stage, replaced with the counts of the
+    stage when it ends.
+  */
+  MY_PERF_COUNTERS m_hw_counters;
+  /** True when @c m_hw_counters holds the counts of the completed stage. */
+  bool m_hw_counters_valid;
 };
 
 void insert_events_stages_history(PFS_thread *thread, PFS_events_stages *stage);
@@ -57,6 +65,7 @@ void reset_events_stages_by_account();
 void reset_events_stages_by_user();
 void reset_events_stages_by_host();
 void reset_events_stages_global();
+void reset_events_stages_cpu_samples_global();
 void aggregate_account_stages(PFS_account *account);
 void aggregate_user_stages(PFS_user *user);
 void aggregate_host_stages(PFS_host *host);
@@ -254,3 +254,14 @@ void reset_events_statements_global()
     stat->reset();
 }
 
+/** Reset table EVENTS_STATEMENTS_QUANTILES_GLOBAL_BY_EVENT_NAME data. */
+void reset_events_statements_quantiles_global()
+{
+  PFS_histogram *histogram= global_instr_class_statements_histogram_array;
+  PFS_histogram *histogram_last= global_instr_class_statements_histogram_array
+                                 + statement_class_max;
+
+  for ( ; histogram < histogram_last; histogram++)
+    histogram->reset();
+}
+
@@ -123,6 +123,7 @@ void reset_events_statements_by_account();
 void reset_events_statements_by_user();
 void reset_events_statements_by_host();
 void reset_events_statements_global();
+void reset_events_statements_quantiles_global();
 void aggregate_account_statements(PFS_account *account);
 void aggregate_user_statements(PFS_user *user);
 void aggregate_host_statements(PFS_host *host);
@@ -0,0 +1,131 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+#ifndef PFS_FREE_LIST_H
+#define PFS_FREE_LIST_H
+
+/**
+  @file storage/perfschema/pfs_free_list.h
+  Performance schema free records lists (declarations).
+*/
+
+#include "pfs_atomic.h"
+
+/**
+  @addtogroup Performance_schema_buffers
+  @{
+*/
+
+/** End of list marker, in @c PFS_free_list. */
+#define PFS_FREE_LIST_END 0xFFFFFFFF
+
+/**
+  The free records of a performance schema instances buffer.
+
+  Records are handed out in buffer order the first time,
+  and freed records are reused in last in, first out order,
+  from a lock free stack chained through @c T::m_free_next.
+  Finding a free record is a constant time operation,
+  instead of a scan of the buffer,
+  and only the beginning of the buffer, as large as the
+  maximum number of records used at the same time, is ever written to.
+  As the buffers are allocated zero filled by the operating system,
+  the rest of the buffer does not use physical memory.
+
+  The index returned by @c pop() is a hint only:
+  the caller owns the record only after a successful
+  @c pfs_lock::free_to_dirty() transition.
+*/
+template <class T>
+struct PFS_free_list
+{
+  /**
+    Top of the stack of freed records.
+    The record index is stored in the low 32 bits,
+    a version number in the high 32 bits,
+    which is incremented on every change to avoid the 'ABA' problem.
+  */
+  volatile uint64 m_head;
+  /** Number of records handed out in buffer order so far. */
+  volatile uint32 m_used;
+  /** Size of the buffer. */
+  uint m_max;
+  /** The buffer. */
+  T *m_array;
+
+  /**
+    Initialize the list of free records of a buffer.
+    @param array the buffer
+    @param max size of the buffer
+  */
+  void init(T *array, uint max)
+  {
+    m_head= PFS_FREE_LIST_END;
+    m_used= 0;
+    m_max= max;
+    m_array= array;
+  }
+
+  /**
+    Take a free record.
+    @return the record index, or m_max if the buffer is full
+  */
+  uint pop()
+  {
+    uint64 old_head= PFS_atomic::load_u64(& m_head);
+    uint32 index;
+    uint32 next;
+
+    while ((index= (uint32) old_head) != PFS_FREE_LIST_END)
+    {
+      /* Dirty read, a stale value fails the compare and swap. */
+      next= m_array[index].m_free_next;
+      uint64 new_head= (((old_head >> 32) + 1) << 32) | next;
+      if (PFS_atomic::cas_u64(& m_head, & old_head, new_head))
+        return index;
+    }
+
+    /* Nothing was freed, take the next record never used so far. */
+    uint32 used= PFS_atomic::load_u32(& m_used);
+    while (used < m_max)
+    {
+      if (PFS_atomic::cas_u32(& m_used, & used, used + 1))
+        return used;
+    }
+    return m_max;
+  }
+
+  /**
+    Give back a record, after it was freed.
+    @param index the record index
+  */
+  void push(uint index)
+  {
+    DBUG_ASSERT(index < m_max);
+    uint64 old_head= PFS_atomic::load_u64(& m_head);
+    uint64 new_head;
+
+    do
+    {
+      m_array[index].m_free_next= (uint32) old_head;
+      new_head= (((old_head >> 32) + 1) << 32) | index;
+    }
+    while (! PFS_atomic::cas_u64(& m_head, & old_head, new_head));
+  }
+};
+
+/** @} */
+#endif
+
@@ -36,13 +36,51 @@
   #include <arpa/inet.h>
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 bool pfs_initialized= false;
 size_t pfs_allocated_memory= 0;
 
+#if defined(HAVE_SYS_MMAN_H) && (defined(MAP_ANONYMOUS) || defined(MAP_ANON))
+#define PFS_USE_MMAP
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/**
+  Zero filled allocations of at least this size are mapped
+  directly from the operating system.
+*/
+#define PFS_MMAP_THRESHOLD (64 * 1024)
+
+/**
+  Maximum number of memory mapped buffers.
+  The performance schema allocates a few dozen buffers at startup,
+  buffers past this limit are allocated from the heap.
+*/
+#define PFS_MMAP_MAX 128
+
+/** A memory mapped buffer. */
+struct PFS_mmap_buffer
+{
+  void *m_ptr;
+  size_t m_size;
+};
+
+static PFS_mmap_buffer pfs_mmap_buffers[PFS_MMAP_MAX];
+static uint pfs_mmap_count= 0;
+#endif /* PFS_USE_MMAP */
+
 /**
   Memory allocation for the performance schema.
   The memory used internally in the performance schema implementation
   is allocated once during startup, and considered static thereafter.
+  Large zero filled buffers are mapped from the operating system,
+  which provides zero filled pages on first use only:
+  the parts of a buffer that are never written to
+  do not use physical memory.
 */
 void *pfs_malloc(size_t size, myf flags)
 {
@@ -51,6 +89,23 @@ void *pfs_malloc(size_t size, myf flags)
 
   void *ptr;
 
+#ifdef PFS_USE_MMAP
+  if ((flags & MY_ZEROFILL) && size >= PFS_MMAP_THRESHOLD &&
+      pfs_mmap_count < PFS_MMAP_MAX)
+  {
+    ptr= mmap(NULL, size, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (unlikely(ptr == MAP_FAILED))
+      return NULL;
+
+    pfs_mmap_buffers[pfs_mmap_count].m_ptr= ptr;
+    pfs_mmap_buffers[pfs_mmap_count].m_size= size;
+    pfs_mmap_count++;
+    pfs_allocated_memory+= size;
+    return ptr;
+  }
+#endif
+
 #ifdef PFS_ALIGNEMENT
 #ifdef HAVE_POSIX_MEMALIGN
   /* Linux */
@@ -91,6 +146,19 @@ void pfs_free(void *ptr)
   if (ptr == NULL)
     return;
 
+#ifdef PFS_USE_MMAP
+  for (uint i= 0; i < pfs_mmap_count; i++)
+  {
+    if (pfs_mmap_buffers[i].m_ptr == ptr)
+    {
+      munmap(ptr, pfs_mmap_buffers[i].m_size);
+      pfs_mmap_count--;
+      pfs_mmap_buffers[i]= pfs_mmap_buffers[pfs_mmap_count];
+      return;
+    }
+  }
+#endif
+
 #ifdef HAVE_POSIX_MEMALIGN
   /* Allocated with posix_memalign() */
   free(ptr);
@@ -30,6 +30,7 @@
 #include "pfs_account.h"
 #include "pfs_global.h"
 #include "pfs_instr_class.h"
+#include "pfs_free_list.h"
 
 ulong nested_statement_lost= 0;
 
@@ -162,8 +163,19 @@ PFS_table *table_array= NULL;
 */
 PFS_socket *socket_array= NULL;
 
+/** Free records of the instances arrays. */
+static PFS_free_list<PFS_mutex> mutex_free_list;
+static PFS_free_list<PFS_rwlock> rwlock_free_list;
+static PFS_free_list<PFS_cond> cond_free_list;
+static PFS_free_list<PFS_thread> thread_free_list;
+static PFS_free_list<PFS_file> file_free_list;
+static PFS_free_list<PFS_table> table_free_list;
+static PFS_free_list<PFS_socket> socket_free_list;
+
 PFS_stage_stat *global_instr_class_stages_array= NULL;
 PFS_statement_stat *global_instr_class_statements_array= NULL;
+PFS_histogram *global_instr_class_statements_histogram_array= NULL;
+volatile uint64 *global_instr_class_stages_cpu_samples_array= NULL;
 PFS_memory_stat *global_instr_class_memory_array= NULL;
 
 static volatile uint64 thread_internal_id_counter= 0;
@@ -286,6 +298,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(mutex_array == NULL))
       return 1;
   }
+  mutex_free_list.init(mutex_array, mutex_max);
 
   if (rwlock_max > 0)
   {
@@ -293,6 +306,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(rwlock_array == NULL))
       return 1;
   }
+  rwlock_free_list.init(rwlock_array, rwlock_max);
 
   if (cond_max > 0)
   {
@@ -300,6 +314,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(cond_array == NULL))
       return 1;
   }
+  cond_free_list.init(cond_array, cond_max);
 
   if (file_max > 0)
   {
@@ -307,6 +322,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(file_array == NULL))
       return 1;
   }
+  file_free_list.init(file_array, file_max);
 
   if (file_handle_max > 0)
   {
@@ -321,6 +337,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(table_array == NULL))
       return 1;
   }
+  table_free_list.init(table_array, table_max);
 
   if (socket_max > 0)
   {
@@ -328,6 +345,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(socket_array == NULL))
       return 1;
   }
+  socket_free_list.init(socket_array, socket_max);
 
   if (thread_max > 0)
   {
@@ -335,6 +353,7 @@ int init_instruments(const PFS_global_param *param)
     if (unlikely(thread_array == NULL))
       return 1;
   }
+  thread_free_list.init(thread_array, thread_max);
 
   if (thread_waits_history_sizing > 0)
   {
@@ -460,6 +479,12 @@ int init_instruments(const PFS_global_param *param)
 
     for (index= 0; index < stage_class_max; index++)
       global_instr_class_stages_array[index].reset();
+
+    global_instr_class_stages_cpu_samples_array=
+      PFS_MALLOC_ARRAY(stage_class_max,
+                       uint64, MYF(MY_ZEROFILL));
+    if (unlikely(global_instr_class_stages_cpu_samples_array == NULL))
+      return 1;
   }
 
   if (statement_class_max > 0)
@@ -472,6 +497,12 @@ int init_instruments(const PFS_global_param *param)
 
     for (index= 0; index < statement_class_max; index++)
       global_instr_class_statements_array[index].reset();
+
+    global_instr_class_statements_histogram_array=
+      PFS_MALLOC_ARRAY(statement_class_max,
+                       PFS_histogram, MYF(MY_ZEROFILL));
+    if (unlikely(global_instr_class_statements_histogram_array == NULL))
+      return 1;
   }
 
   if (memory_class_max > 0)
@@ -528,8 +559,12 @@ void cleanup_instruments(void)
   thread_instr_class_waits_array= NULL;
   pfs_free(global_instr_class_stages_array);
   global_instr_class_stages_array= NULL;
+  pfs_free((void*) global_instr_class_stages_cpu_samples_array);
+  global_instr_class_stages_cpu_samples_array= NULL;
   pfs_free(global_instr_class_statements_array);
   global_instr_class_statements_array= NULL;
+  pfs_free(global_instr_class_statements_histogram_array);
+  global_instr_class_statements_histogram_array= NULL;
   pfs_free(global_instr_class_memory_array);
   global_instr_class_memory_array= NULL;
   pfs_free(thread_session_connect_attrs_array);
@@ -657,7 +692,6 @@ void PFS_scan::init(uint random, uint max_size)
 */
 PFS_mutex* create_mutex(PFS_mutex_class *klass, const void *identity)
 {
-  static uint PFS_ALIGNED mutex_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_mutex *pfs;
@@ -676,25 +710,15 @@ PFS_mutex* create_mutex(PFS_mutex_class *klass, const void *identity)
   while (++attempts <= mutex_max)
   {
     /*
-      Problem:
-      Multiple threads running concurrently may need to create a new
-      instrumented mutex, and find an empty slot in mutex_array[].
-      With N1 threads running on a N2 core hardware:
-      - up to N2 hardware threads can run concurrently,
-      causing contention if looking at the same array[i] slot.
-      - up to N1 threads can run almost concurrently (with thread scheduling),
-      scanning maybe overlapping regions in the [0-mutex_max] array.
-
-      Solution:
-      Instead of letting different threads compete on the same array[i] entry,
-      this code forces all threads to cooperate with the monotonic_index.
-      Only one thread will be allowed to test a given array[i] slot.
-      All threads do scan from the same region, starting at monotonic_index.
-      Serializing on monotonic_index ensures that when a slot is found occupied
-      in a given loop by a given thread, other threads will not attempt this
-      slot.
+      The free list hands out each free slot to only one thread,
+      so concurrent threads do not compete for the same mutex_array[i]
+      entry, and finding a free slot does not depend on how full the
+      array is. The free_to_dirty() transition below still decides
+      who owns the record.
     */
-    index= PFS_atomic::add_u32(& mutex_monotonic_index, 1) % mutex_max;
+    index= mutex_free_list.pop();
+    if (index >= mutex_max)
+      break;
     pfs= mutex_array + index;
 
     if (pfs->m_lock.is_free())
@@ -743,6 +767,7 @@ void destroy_mutex(PFS_mutex *pfs)
   if (klass->is_singleton())
     klass->m_singleton= NULL;
   pfs->m_lock.allocated_to_free();
+  mutex_free_list.push(pfs - mutex_array);
   mutex_full= false;
 }
 
@@ -754,7 +779,6 @@ void destroy_mutex(PFS_mutex *pfs)
 */
 PFS_rwlock* create_rwlock(PFS_rwlock_class *klass, const void *identity)
 {
-  static uint PFS_ALIGNED rwlock_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_rwlock *pfs;
@@ -768,7 +792,9 @@ PFS_rwlock* create_rwlock(PFS_rwlock_class *klass, const void *identity)
   while (++attempts <= rwlock_max)
   {
     /* See create_mutex() */
-    index= PFS_atomic::add_u32(& rwlock_monotonic_index, 1) % rwlock_max;
+    index= rwlock_free_list.pop();
+    if (index >= rwlock_max)
+      break;
     pfs= rwlock_array + index;
 
     if (pfs->m_lock.is_free())
@@ -811,6 +837,7 @@ void destroy_rwlock(PFS_rwlock *pfs)
   if (klass->is_singleton())
     klass->m_singleton= NULL;
   pfs->m_lock.allocated_to_free();
+  rwlock_free_list.push(pfs - rwlock_array);
   rwlock_full= false;
 }
 
@@ -822,7 +849,6 @@ void destroy_rwlock(PFS_rwlock *pfs)
 */
 PFS_cond* create_cond(PFS_cond_class *klass, const void *identity)
 {
-  static uint PFS_ALIGNED cond_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_cond *pfs;
@@ -836,7 +862,9 @@ PFS_cond* create_cond(PFS_cond_class *klass, const void *identity)
   while (++attempts <= cond_max)
   {
     /* See create_mutex() */
-    index= PFS_atomic::add_u32(& cond_monotonic_index, 1) % cond_max;
+    index= cond_free_list.pop();
+    if (index >= cond_max)
+      break;
     pfs= cond_array + index;
 
     if (pfs->m_lock.is_free())
@@ -877,6 +905,7 @@ void destroy_cond(PFS_cond *pfs)
   if (klass->is_singleton())
     klass->m_singleton= NULL;
   pfs->m_lock.allocated_to_free();
+  cond_free_list.push(pfs - cond_array);
   cond_full= false;
 }
 
@@ -943,7 +972,6 @@ void carry_global_memory_stat_delta(PFS_memory_stat_delta *delta, uint index)
 PFS_thread* create_thread(PFS_thread_class *klass, const void *identity,
                           ulonglong processlist_id)
 {
-  static uint PFS_ALIGNED thread_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_thread *pfs;
@@ -957,7 +985,9 @@ PFS_thread* create_thread(PFS_thread_class *klass, const void *identity,
   while (++attempts <= thread_max)
   {
     /* See create_mutex() */
-    index= PFS_atomic::add_u32(& thread_monotonic_index, 1) % thread_max;
+    index= thread_free_list.pop();
+    if (index >= thread_max)
+      break;
     pfs= thread_array + index;
 
     if (pfs->m_lock.is_free())
@@ -993,6 +1023,7 @@ PFS_thread* create_thread(PFS_thread_class *klass, const void *identity,
         pfs->m_host_hash_pins= NULL;
         pfs->m_digest_hash_pins= NULL;
         pfs->m_program_hash_pins= NULL;
+        memset(pfs->m_digest_cache, 0, sizeof(pfs->m_digest_cache));
 
         pfs->m_username_length= 0;
         pfs->m_hostname_length= 0;
@@ -1000,6 +1031,7 @@ PFS_thread* create_thread(PFS_thread_class *klass, const void *identity,
         pfs->m_command= 0;
         pfs->m_start_time= 0;
         pfs->m_stage= 0;
+        pfs->m_cpu_samples= 0;
         pfs->m_processlist_info[0]= '\0';
         pfs->m_processlist_info_length= 0;
 
@@ -1196,6 +1228,7 @@ void destroy_thread(PFS_thread *pfs)
     pfs->m_program_hash_pins= NULL;
   }
   pfs->m_lock.allocated_to_free();
+  thread_free_list.push(pfs - thread_array);
   thread_full= false;
 }
 
@@ -1322,7 +1355,6 @@ find_or_create_file(PFS_thread *thread, PFS_file_class *klass,
   PFS_file **entry;
   uint retry_count= 0;
   const uint retry_max= 3;
-  static uint PFS_ALIGNED file_monotonic_index= 0;
   uint index;
   uint attempts= 0;
 
@@ -1356,7 +1388,9 @@ search:
   while (++attempts <= file_max)
   {
     /* See create_mutex() */
-    index= PFS_atomic::add_u32(& file_monotonic_index, 1) % file_max;
+    index= file_free_list.pop();
+    if (index >= file_max)
+      break;
     pfs= file_array + index;
 
     if (pfs->m_lock.is_free())
@@ -1385,6 +1419,7 @@ search:
         }
 
         pfs->m_lock.dirty_to_free();
+        file_free_list.push(index);
 
         if (res > 0)
         {
@@ -1446,6 +1481,7 @@ void destroy_file(PFS_thread *thread, PFS_file *pfs)
   if (klass->is_singleton())
     klass->m_singleton= NULL;
   pfs->m_lock.allocated_to_free();
+  file_free_list.push(pfs - file_array);
   file_full= false;
 }
 
@@ -1459,7 +1495,6 @@ void destroy_file(PFS_thread *thread, PFS_file *pfs)
 PFS_table* create_table(PFS_table_share *share, PFS_thread *opening_thread,
                         const void *identity)
 {
-  static uint PFS_ALIGNED table_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_table *pfs;
@@ -1473,7 +1508,9 @@ PFS_table* create_table(PFS_table_share *share, PFS_thread *opening_thread,
   while (++attempts <= table_max)
   {
     /* See create_mutex() */
-    index= PFS_atomic::add_u32(& table_monotonic_index, 1) % table_max;
+    index= table_free_list.pop();
+    if (index >= table_max)
+      break;
     pfs= table_array + index;
 
     if (pfs->m_lock.is_free())
@@ -1598,6 +1635,7 @@ void destroy_table(PFS_table *pfs)
   DBUG_ASSERT(pfs != NULL);
   pfs->m_share->dec_refcount();
   pfs->m_lock.allocated_to_free();
+  table_free_list.push(pfs - table_array);
   table_full= false;
 }
 
@@ -1612,7 +1650,6 @@ void destroy_table(PFS_table *pfs)
 PFS_socket* create_socket(PFS_socket_class *klass, const my_socket *fd,
                           const struct sockaddr *addr, socklen_t addr_len)
 {
-  static uint PFS_ALIGNED socket_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_socket *pfs;
@@ -1634,7 +1671,10 @@ PFS_socket* create_socket(PFS_socket_class *klass, const my_socket *fd,
 
   while (++attempts <= socket_max)
   {
-    index= PFS_atomic::add_u32(& socket_monotonic_index, 1) % socket_max;
+    /* See create_mutex() */
+    index= socket_free_list.pop();
+    if (index >= socket_max)
+      break;
     pfs= socket_array + index;
 
     if (pfs->m_lock.is_free())
@@ -1710,6 +1750,7 @@ void destroy_socket(PFS_socket *pfs)
   pfs->m_fd= 0;
   pfs->m_addr_len= 0;
   pfs->m_lock.allocated_to_free();
+  socket_free_list.push(pfs - socket_array);
   socket_full= false;
 }
 
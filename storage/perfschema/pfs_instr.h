@@ -28,6 +28,7 @@ struct PFS_file_class;
 struct PFS_table_share;
 struct PFS_thread_class;
 struct PFS_socket_class;
+struct PFS_statements_digest_stat;
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -65,6 +66,8 @@ struct PFS_instr
   bool m_enabled;
   /** Timed flag. */
   bool m_timed;
+  /** Next free record, @sa PFS_free_list. */
+  uint32 m_free_next;
 };
 
 /** Instrumented mutex implementation. @see PSI_mutex. */
@@ -220,6 +223,8 @@ public:
 
   /** Internal lock. */
   pfs_lock m_lock;
+  /** Next free record, @sa PFS_free_list. */
+  uint32 m_free_next;
   /** Owner. */
   PFS_thread *m_thread_owner;
   /** Table share. */
@@ -296,6 +301,18 @@ struct PFS_ALIGNED PFS_socket : public PFS_instr
 */
 #define WAIT_STACK_SIZE (WAIT_STACK_BOTTOM + WAIT_STACK_LOGICAL_SIZE)
 
+/** Number of entries in the per thread digest cache, a power of 2. */
+#define DIGEST_CACHE_SIZE 16
+
+/** An entry in the per thread digest cache. */
+struct PFS_digest_cache_entry
+{
+  /** Hash of the tokens and schema of the digest. */
+  ulonglong m_hash;
+  /** Digest record found for that hash. */
+  PFS_statements_digest_stat *m_digest_stat;
+};
+
 /** Max size of the statements stack. */
 extern uint statement_stack_max;
 
@@ -379,6 +396,8 @@ struct PFS_ALIGNED PFS_thread : PFS_connection_slice
     use one of @c m_stmt_lock or @c m_session_lock instead.
   */
   pfs_lock m_lock;
+  /** Next free record, @sa PFS_free_list. */
+  uint32 m_free_next;
   /** Pins for filename_hash. */
   LF_PINS *m_filename_hash_pins;
   /** Pins for table_share_hash. */
@@ -397,6 +416,13 @@ struct PFS_ALIGNED PFS_thread : PFS_connection_slice
   LF_PINS *m_digest_hash_pins;
   /** Pins for routine_hash. */
   LF_PINS *m_program_hash_pins;
+  /**
+    Digest records of the statements recently executed by this thread,
+    indexed by a hash of the statement tokens.
+    This spares find_or_create_digest() the MD5 computation
+    and the digest_hash lookup when a statement is repeated.
+  */
+  PFS_digest_cache_entry m_digest_cache[DIGEST_CACHE_SIZE];
   /** Internal thread identifier, unique. */
   ulonglong m_thread_internal_id;
   /** Parent internal thread identifier. */
@@ -529,6 +555,13 @@ struct PFS_ALIGNED PFS_thread : PFS_connection_slice
 
   PFS_events_stages m_stage_current;
 
+  /**
+    Number of CPU samples taken while this thread was running.
+    Only written by this thread, from the CPU sample signal handler.
+    @sa pfs_cpu_sample.h
+  */
+  volatile ulong m_cpu_samples;
+
   /** Size of @c m_events_statements_stack. */
   uint m_events_statements_count;
   PFS_events_statements *m_statement_stack;
@@ -563,6 +596,8 @@ void carry_global_memory_stat_delta(PFS_memory_stat_delta *delta, uint index);
 
 extern PFS_stage_stat *global_instr_class_stages_array;
 extern PFS_statement_stat *global_instr_class_statements_array;
+extern PFS_histogram *global_instr_class_statements_histogram_array;
+extern volatile uint64 *global_instr_class_stages_cpu_samples_array;
 extern PFS_memory_stat *global_instr_class_memory_array;
 
 PFS_mutex *sanitize_mutex(PFS_mutex *unsafe);
@@ -29,6 +29,7 @@
 #include "pfs_events_waits.h"
 #include "pfs_setup_object.h"
 #include "pfs_atomic.h"
+#include "pfs_free_list.h"
 #include "pfs_program.h"
 #include "mysql/psi/mysql_thread.h"
 #include "lf.h"
@@ -139,6 +140,8 @@ static PFS_thread_class *thread_class_array= NULL;
   @sa table_share_hash
 */
 PFS_table_share *table_share_array= NULL;
+/** Free records of @c table_share_array. */
+static PFS_free_list<PFS_table_share> table_share_free_list;
 
 PFS_ALIGNED PFS_single_stat global_idle_stat;
 PFS_ALIGNED PFS_table_io_stat global_table_io_stat;
@@ -361,6 +364,7 @@ int init_table_share(uint table_share_sizing)
   }
   else
     table_share_array= NULL;
+  table_share_free_list.init(table_share_array, table_share_max);
 
   return result;
 }
@@ -663,6 +667,7 @@ static void init_instr_class(PFS_instr_class *klass,
   klass->m_flags= flags;
   klass->m_enabled= true;
   klass->m_timed= true;
+  klass->m_sample_rate= 1;
   klass->m_type= class_type;
   klass->m_timer= class_timers[class_type];
 }
@@ -1361,7 +1366,6 @@ PFS_table_share* find_or_create_table_share(PFS_thread *thread,
   const uint retry_max= 3;
   bool enabled= true;
   bool timed= true;
-  static uint PFS_ALIGNED table_share_monotonic_index= 0;
   uint index;
   uint attempts= 0;
   PFS_table_share *pfs;
@@ -1404,7 +1408,9 @@ search:
   while (++attempts <= table_share_max)
   {
     /* See create_mutex() */
-    index= PFS_atomic::add_u32(& table_share_monotonic_index, 1) % table_share_max;
+    index= table_share_free_list.pop();
+    if (index >= table_share_max)
+      break;
     pfs= table_share_array + index;
 
     if (pfs->m_lock.is_free())
@@ -1431,6 +1437,7 @@ search:
         }
 
         pfs->m_lock.dirty_to_free();
+        table_share_free_list.push(index);
 
         if (res > 0)
         {
@@ -1518,6 +1525,7 @@ void drop_table_share(PFS_thread *thread,
     lf_hash_delete(&table_share_hash, pins,
                    pfs->m_key.m_hash_key, pfs->m_key.m_key_length);
     pfs->m_lock.allocated_to_free();
+    table_share_free_list.push(pfs - table_share_array);
   }
 
   lf_hash_search_unpin(pins);
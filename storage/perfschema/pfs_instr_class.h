@@ -130,6 +130,12 @@ struct PFS_instr_class
   bool m_enabled;
   /** True if this instrument is timed. */
   bool m_timed;
+  /**
+    Sample rate of timed waits.
+    Only one wait in @c m_sample_rate is timed, all waits are counted.
+    Used for mutexes, rwlocks and conditions only.
+  */
+  uint m_sample_rate;
   /** Instrument flags. */
   int m_flags;
   /**
@@ -307,6 +313,8 @@ public:
   uint m_table_name_length;
   /** Number of indexes. */
   uint m_key_count;
+  /** Next free record, @sa PFS_free_list. */
+  uint32 m_free_next;
   /** Table statistics. */
   PFS_table_stat m_table_stat;
   /** Index names. */
@@ -38,6 +38,7 @@
 #include "pfs_defaults.h"
 #include "pfs_digest.h"
 #include "pfs_program.h"
+#include "pfs_cpu_sample.h"
 
 PFS_global_param pfs_param;
 
@@ -117,7 +118,8 @@ initialize_performance_schema(PFS_global_param *param)
       init_digest(param) ||
       init_digest_hash() ||
       init_program(param) ||
-      init_program_hash())
+      init_program_hash() ||
+      init_cpu_sample(param))
   {
     /*
       The performance schema initialization failed.
@@ -168,6 +170,7 @@ static void destroy_pfs_thread(void *key)
 
 static void cleanup_performance_schema(void)
 {
+  cleanup_cpu_sample();
   cleanup_instrument_config();
 /*  Disabled: Bug#5666
   cleanup_instruments();
@@ -214,6 +214,12 @@ struct PFS_global_param
     @sa memory_class_lost.
   */
   ulong m_memory_class_sizing;
+  /**
+    Interval between two CPU samples of the running threads,
+    in microseconds of CPU time. 0 disables CPU samples.
+    @sa init_cpu_sample.
+  */
+  ulong m_cpu_sample_interval;
   /** Sizing hints, for auto tuning. */
   PFS_sizing_hints m_hints;
 };
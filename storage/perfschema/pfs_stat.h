@@ -20,6 +20,7 @@
 #include "sql_const.h"
 /* memcpy */
 #include "string.h"
+#include "pfs_atomic.h"
 using std::min;
 
 /**
@@ -94,6 +95,21 @@ struct PFS_single_stat
     if (unlikely(m_max < value))
       m_max= value;
   }
+
+  /**
+    Aggregate a timed value, when only one value in @c rate is timed.
+    The count stays exact, the sum is extrapolated from the sample,
+    min and max are those of the sampled values.
+  */
+  inline void aggregate_sampled(ulonglong value, uint rate)
+  {
+    m_count++;
+    m_sum+= value * rate;
+    if (unlikely(m_min > value))
+      m_min= value;
+    if (unlikely(m_max < value))
+      m_max= value;
+  }
 };
 
 /** Combined statistic. */
@@ -433,6 +449,82 @@ struct PFS_statement_stat
   }
 };
 
+/** Number of buckets per power of two, in @c PFS_histogram. */
+#define PFS_HISTOGRAM_SUB_BITS 2
+#define PFS_HISTOGRAM_SUB_BUCKETS (1 << PFS_HISTOGRAM_SUB_BITS)
+/** Largest power of two with buckets, in @c PFS_histogram. */
+#define PFS_HISTOGRAM_MAX_EXPONENT 48
+/** Number of buckets in @c PFS_histogram. */
+#define PFS_HISTOGRAM_BUCKETS \
+  ((PFS_HISTOGRAM_MAX_EXPONENT - PFS_HISTOGRAM_SUB_BITS + 2) \
+   * PFS_HISTOGRAM_SUB_BUCKETS)
+
+/**
+  Log linear histogram of timer values.
+  Each power of two is split in @c PFS_HISTOGRAM_SUB_BUCKETS buckets
+  of the same width, so a value is known within 1/8 of itself,
+  whatever its magnitude, with a fixed number of buckets.
+  Values above 2^(PFS_HISTOGRAM_MAX_EXPONENT + 1) are counted
+  in the last bucket.
+  Buckets are incremented atomically, so that concurrent statements
+  can aggregate to the same histogram without a lock.
+*/
+struct PFS_histogram
+{
+  /** Count of values, per bucket. */
+  volatile uint32 m_buckets[PFS_HISTOGRAM_BUCKETS];
+
+  inline void reset(void)
+  {
+    for (uint index= 0; index < PFS_HISTOGRAM_BUCKETS; index++)
+      m_buckets[index]= 0;
+  }
+
+  inline void aggregate_value(ulonglong value)
+  {
+    PFS_atomic::add_u32(& m_buckets[bucket_index(value)], 1);
+  }
+
+  /** Bucket counting a value. */
+  static inline uint bucket_index(ulonglong value)
+  {
+    if (value < PFS_HISTOGRAM_SUB_BUCKETS)
+      return (uint) value;
+
+    /* Position of the most significant bit. */
+    uint exponent= 0;
+    ulonglong v= value;
+    if (v >> 32) { v>>= 32; exponent+= 32; }
+    if (v >> 16) { v>>= 16; exponent+= 16; }
+    if (v >> 8) { v>>= 8; exponent+= 8; }
+    if (v >> 4) { v>>= 4; exponent+= 4; }
+    if (v >> 2) { v>>= 2; exponent+= 2; }
+    if (v >> 1) exponent+= 1;
+
+    if (unlikely(exponent > PFS_HISTOGRAM_MAX_EXPONENT))
+      return PFS_HISTOGRAM_BUCKETS - 1;
+
+    uint sub= (uint) (value >> (exponent - PFS_HISTOGRAM_SUB_BITS))
+              & (PFS_HISTOGRAM_SUB_BUCKETS - 1);
+    return (exponent - PFS_HISTOGRAM_SUB_BITS + 1) * PFS_HISTOGRAM_SUB_BUCKETS
+           + sub;
+  }
+
+  /** Value representing a bucket, the middle of its range. */
+  static inline ulonglong bucket_value(uint index)
+  {
+    if (index < PFS_HISTOGRAM_SUB_BUCKETS)
+      return index;
+
+    uint exponent= index / PFS_HISTOGRAM_SUB_BUCKETS
+                   + PFS_HISTOGRAM_SUB_BITS - 1;
+    uint sub= index % PFS_HISTOGRAM_SUB_BUCKETS;
+    uint shift= exponent - PFS_HISTOGRAM_SUB_BITS;
+    ulonglong low= ((ulonglong) (PFS_HISTOGRAM_SUB_BUCKETS + sub)) << shift;
+    return low + ((1ULL << shift) >> 1);
+  }
+};
+
 /** Single table io statistic. */
 struct PFS_table_io_stat
 {
@@ -0,0 +1,90 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+#ifndef TABLE_ECSS_BY_DIGEST_H
+#define TABLE_ECSS_BY_DIGEST_H
+
+/**
+  @file storage/perfschema/table_ecss_by_digest.h
+  Table EVENTS_CPU_SAMPLES_SUMMARY_BY_DIGEST (declarations).
+*/
+
+#include "table_helper.h"
+#include "pfs_digest.h"
+
+/**
+  @addtogroup Performance_schema_tables
+  @{
+*/
+
+/**
+  A row of table
+  PERFORMANCE_SCHEMA.EVENTS_CPU_SAMPLES_SUMMARY_BY_DIGEST.
+*/
+struct row_ecss_by_digest
+{
+  /** Columns SCHEMA_NAME/DIGEST. */
+  PFS_digest_row m_digest;
+
+  /** Column COUNT_SAMPLES. */
+  ulonglong m_count_samples;
+};
+
+/** Table PERFORMANCE_SCHEMA.EVENTS_CPU_SAMPLES_SUMMARY_BY_DIGEST. */
+class table_ecss_by_digest : public PFS_engine_table
+{
+public:
+  /** Table share */
+  static PFS_engine_table_share m_share;
+  static PFS_engine_table* create();
+  static int delete_all_rows();
+
+  virtual int rnd_next();
+  virtual int rnd_pos(const void *pos);
+  virtual void reset_position(void);
+
+protected:
+  virtual int read_row_values(TABLE *table,
+                              unsigned char *buf,
+                              Field **fields,
+                              bool read_all);
+
+  table_ecss_by_digest();
+
+public:
+  ~table_ecss_by_digest()
+  {}
+
+protected:
+  void make_row(PFS_statements_digest_stat*);
+
+private:
+  /** Table share lock. */
+  static THR_LOCK m_table_lock;
+  /** Fields definition. */
+  static TABLE_FIELD_DEF m_field_def;
+
+  /** Current row. */
+  row_ecss_by_digest m_row;
+  /** True is the current row exists. */
+  bool m_row_exists;
+  /** Current position. */
+  PFS_simple_index m_pos;
+  /** Next position. */
+  PFS_simple_index m_next_pos;
+};
+
+/** @} */
+#endif
@@ -0,0 +1,172 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+/**
+  @file storage/perfschema/table_ecss_global_by_event_name.cc
+  Table EVENTS_CPU_SAMPLES_SUMMARY_GLOBAL_BY_EVENT_NAME (implementation).
+*/
+
+#include "my_global.h"
+#include "my_pthread.h"
+#include "pfs_instr_class.h"
+#include "pfs_column_types.h"
+#include "pfs_column_values.h"
+#include "table_ecss_global_by_event_name.h"
+#include "pfs_global.h"
+#include "pfs_instr.h"
+#include "pfs_atomic.h"
+#include "pfs_events_stages.h"
+
+THR_LOCK table_ecss_global_by_event_name::m_table_lock;
+
+static const TABLE_FIELD_TYPE field_types[]=
+{
+  {
+    { C_STRING_WITH_LEN("EVENT_NAME") },
+    { C_STRING_WITH_LEN("varchar(128)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("COUNT_SAMPLES") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  }
+};
+
+TABLE_FIELD_DEF
+table_ecss_global_by_event_name::m_field_def=
+{ 2, field_types };
+
+PFS_engine_table_share
+table_ecss_global_by_event_name::m_share=
+{
+  { C_STRING_WITH_LEN("events_cpu_samples_summary_global_by_event_name") },
+  &pfs_truncatable_acl,
+  table_ecss_global_by_event_name::create,
+  NULL, /* write_row */
+  table_ecss_global_by_event_name::delete_all_rows,
+  NULL, /* get_row_count */
+  1000, /* records */
+  sizeof(PFS_simple_index),
+  &m_table_lock,
+  &m_field_def,
+  false /* checked */
+};
+
+PFS_engine_table*
+table_ecss_global_by_event_name::create(void)
+{
+  return new table_ecss_global_by_event_name();
+}
+
+int
+table_ecss_global_by_event_name::delete_all_rows(void)
+{
+  reset_events_stages_cpu_samples_global();
+  return 0;
+}
+
+table_ecss_global_by_event_name::table_ecss_global_by_event_name()
+  : PFS_engine_table(&m_share, &m_pos),
+    m_row_exists(false), m_pos(1), m_next_pos(1)
+{}
+
+void table_ecss_global_by_event_name::reset_position(void)
+{
+  m_pos= 1;
+  m_next_pos= 1;
+}
+
+int table_ecss_global_by_event_name::rnd_next(void)
+{
+  PFS_stage_class *stage_class;
+
+  if (global_instr_class_stages_cpu_samples_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  m_pos.set_at(&m_next_pos);
+
+  stage_class= find_stage_class(m_pos.m_index);
+  if (stage_class)
+  {
+    make_row(stage_class);
+    m_next_pos.set_after(&m_pos);
+    return 0;
+  }
+
+  return HA_ERR_END_OF_FILE;
+}
+
+int
+table_ecss_global_by_event_name::rnd_pos(const void *pos)
+{
+  PFS_stage_class *stage_class;
+
+  set_position(pos);
+
+  if (global_instr_class_stages_cpu_samples_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  stage_class= find_stage_class(m_pos.m_index);
+  if (stage_class)
+  {
+    make_row(stage_class);
+    return 0;
+  }
+
+  return HA_ERR_RECORD_DELETED;
+}
+
+void table_ecss_global_by_event_name
+::make_row(PFS_stage_class *klass)
+{
+  m_row.m_event_name.make_row(klass);
+  m_row.m_count_samples= PFS_atomic::load_u64(
+    & global_instr_class_stages_cpu_samples_array[klass->m_event_name_index]);
+  m_row_exists= true;
+}
+
+int table_ecss_global_by_event_name
+::read_row_values(TABLE *table, unsigned char *, Field **fields,
+                  bool read_all)
+{
+  Field *f;
+
+  if (unlikely(! m_row_exists))
+    return HA_ERR_RECORD_DELETED;
+
+  /* Set the null bits */
+  DBUG_ASSERT(table->s->null_bytes == 0);
+
+  for (; (f= *fields) ; fields++)
+  {
+    if (read_all || bitmap_is_set(table->read_set, f->field_index))
+    {
+      switch(f->field_index)
+      {
+      case 0: /* NAME */
+        m_row.m_event_name.set_field(f);
+        break;
+      case 1: /* COUNT_SAMPLES */
+        set_field_ulonglong(f, m_row.m_count_samples);
+        break;
+      default:
+        DBUG_ASSERT(false);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,196 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+/**
+  @file storage/perfschema/table_esq_global_by_event_name.cc
+  Table EVENTS_STATEMENTS_QUANTILES_GLOBAL_BY_EVENT_NAME (implementation).
+*/
+
+#include "my_global.h"
+#include "my_pthread.h"
+#include "pfs_instr_class.h"
+#include "pfs_column_types.h"
+#include "pfs_column_values.h"
+#include "table_esq_global_by_event_name.h"
+#include "pfs_global.h"
+#include "pfs_instr.h"
+#include "pfs_timer.h"
+#include "pfs_events_statements.h"
+
+THR_LOCK table_esq_global_by_event_name::m_table_lock;
+
+static const TABLE_FIELD_TYPE field_types[]=
+{
+  {
+    { C_STRING_WITH_LEN("EVENT_NAME") },
+    { C_STRING_WITH_LEN("varchar(128)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("COUNT_STAR") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("QUANTILE_50") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("QUANTILE_95") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("QUANTILE_99") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("QUANTILE_999") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  }
+};
+
+TABLE_FIELD_DEF
+table_esq_global_by_event_name::m_field_def=
+{ 6, field_types };
+
+PFS_engine_table_share
+table_esq_global_by_event_name::m_share=
+{
+  { C_STRING_WITH_LEN("events_statements_quantiles_global_by_event_name") },
+  &pfs_truncatable_acl,
+  table_esq_global_by_event_name::create,
+  NULL, /* write_row */
+  table_esq_global_by_event_name::delete_all_rows,
+  NULL, /* get_row_count */
+  1000, /* records */
+  sizeof(PFS_simple_index),
+  &m_table_lock,
+  &m_field_def,
+  false /* checked */
+};
+
+PFS_engine_table*
+table_esq_global_by_event_name::create(void)
+{
+  return new table_esq_global_by_event_name();
+}
+
+int
+table_esq_global_by_event_name::delete_all_rows(void)
+{
+  reset_events_statements_quantiles_global();
+  return 0;
+}
+
+table_esq_global_by_event_name::table_esq_global_by_event_name()
+  : PFS_engine_table(&m_share, &m_pos),
+    m_row_exists(false), m_pos(1), m_next_pos(1)
+{}
+
+void table_esq_global_by_event_name::reset_position(void)
+{
+  m_pos= 1;
+  m_next_pos= 1;
+}
+
+int table_esq_global_by_event_name::rnd_init(bool scan)
+{
+  m_normalizer= time_normalizer::get(statement_timer);
+  return 0;
+}
+
+int table_esq_global_by_event_name::rnd_next(void)
+{
+  PFS_statement_class *statement_class;
+
+  if (global_instr_class_statements_histogram_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  m_pos.set_at(&m_next_pos);
+
+  statement_class= find_statement_class(m_pos.m_index);
+  if (statement_class)
+  {
+    make_row(statement_class);
+    m_next_pos.set_after(&m_pos);
+    return 0;
+  }
+
+  return HA_ERR_END_OF_FILE;
+}
+
+int
+table_esq_global_by_event_name::rnd_pos(const void *pos)
+{
+  PFS_statement_class *statement_class;
+
+  set_position(pos);
+
+  if (global_instr_class_statements_histogram_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  statement_class= find_statement_class(m_pos.m_index);
+  if (statement_class)
+  {
+    make_row(statement_class);
+    return 0;
+  }
+
+  return HA_ERR_RECORD_DELETED;
+}
+
+void table_esq_global_by_event_name
+::make_row(PFS_statement_class *klass)
+{
+  m_row.m_event_name.make_row(klass);
+  m_row.m_quantiles.set(m_normalizer,
+    & global_instr_class_statements_histogram_array[klass->m_event_name_index]);
+  m_row_exists= true;
+}
+
+int table_esq_global_by_event_name
+::read_row_values(TABLE *table, unsigned char *, Field **fields,
+                  bool read_all)
+{
+  Field *f;
+
+  if (unlikely(! m_row_exists))
+    return HA_ERR_RECORD_DELETED;
+
+  /* Set the null bits */
+  DBUG_ASSERT(table->s->null_bytes == 0);
+
+  for (; (f= *fields) ; fields++)
+  {
+    if (read_all || bitmap_is_set(table->read_set, f->field_index))
+    {
+      switch(f->field_index)
+      {
+      case 0: /* NAME */
+        m_row.m_event_name.set_field(f);
+        break;
+      default: /* 1, ... COUNT/QUANTILE */
+        m_row.m_quantiles.set_field(f->field_index - 1, f);
+        break;
+      }
+    }
+  }
+
+  return 0;
+}
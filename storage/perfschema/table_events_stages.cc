@@ -79,12 +79,32 @@ static const TABLE_FIELD_TYPE field_types[]=
     { C_STRING_WITH_LEN("NESTING_EVENT_TYPE") },
     { C_STRING_WITH_LEN("enum(\'STATEMENT\',\'STAGE\',\'WAIT\'") },
     { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("CYCLES") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("INSTRUCTIONS") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("LLC_MISSES") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("BRANCH_MISSES") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
   }
 };
 
 TABLE_FIELD_DEF
 table_events_stages_current::m_field_def=
-{10 , field_types };
+{14 , field_types };
 
 PFS_engine_table_share
 table_events_stages_current::m_share=
@@ -172,6 +192,10 @@ void table_events_stages_common::make_row(PFS_events_stages *stage)
   m_row.m_name= klass->m_name;
   m_row.m_name_length= klass->m_name_length;
 
+  m_row.m_hw_counters_valid= stage->m_hw_counters_valid;
+  if (m_row.m_hw_counters_valid)
+    m_row.m_hw_counters= stage->m_hw_counters;
+
   safe_source_file= stage->m_source_file;
   if (unlikely(safe_source_file == NULL))
     return;
@@ -197,8 +221,9 @@ int table_events_stages_common::read_row_values(TABLE *table,
     return HA_ERR_RECORD_DELETED;
 
   /* Set the null bits */
-  DBUG_ASSERT(table->s->null_bytes == 1);
+  DBUG_ASSERT(table->s->null_bytes == 2);
   buf[0]= 0;
+  buf[1]= 0;
 
   for (; (f= *fields) ; fields++)
   {
@@ -254,6 +279,30 @@ int table_events_stages_common::read_row_values(TABLE *table,
         else
           f->set_null();
         break;
+      case 10: /* CYCLES */
+        if (m_row.m_hw_counters_valid)
+          set_field_ulonglong(f, m_row.m_hw_counters.cycles);
+        else
+          f->set_null();
+        break;
+      case 11: /* INSTRUCTIONS */
+        if (m_row.m_hw_counters_valid)
+          set_field_ulonglong(f, m_row.m_hw_counters.instructions);
+        else
+          f->set_null();
+        break;
+      case 12: /* LLC_MISSES */
+        if (m_row.m_hw_counters_valid)
+          set_field_ulonglong(f, m_row.m_hw_counters.llc_misses);
+        else
+          f->set_null();
+        break;
+      case 13: /* BRANCH_MISSES */
+        if (m_row.m_hw_counters_valid)
+          set_field_ulonglong(f, m_row.m_hw_counters.branch_misses);
+        else
+          f->set_null();
+        break;
       default:
         DBUG_ASSERT(false);
       }
@@ -59,6 +59,10 @@ struct row_events_stages
   char m_source[COL_SOURCE_SIZE];
   /** Length in bytes of @c m_source. */
   uint m_source_length;
+  /** True if the hardware counter columns are not NULL. */
+  bool m_hw_counters_valid;
+  /** Columns CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES. */
+  MY_PERF_COUNTERS m_hw_counters;
 };
 
 /** Position of a cursor on PERFORMANCE_SCHEMA.EVENTS_STAGES_HISTORY. */
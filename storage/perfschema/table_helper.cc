@@ -328,6 +328,64 @@ void PFS_statement_stat_row::set_field(uint index, Field *f)
   }
 }
 
+void PFS_quantile_row::set(time_normalizer *normalizer,
+                           const PFS_histogram *histogram)
+{
+  /* Quantiles, in thousandths. */
+  static const ulonglong quantiles[PFS_QUANTILE_COUNT]= { 500, 950, 990, 999 };
+  uint32 buckets[PFS_HISTOGRAM_BUCKETS];
+  uint index;
+  uint q;
+
+  /*
+    Take a copy first: buckets keep changing while the row is built,
+    and the ranks must match the buckets they are looked up in.
+  */
+  m_count= 0;
+  for (index= 0; index < PFS_HISTOGRAM_BUCKETS; index++)
+  {
+    buckets[index]= histogram->m_buckets[index];
+    m_count+= buckets[index];
+  }
+
+  ulonglong seen= 0;
+  index= 0;
+  for (q= 0; q < PFS_QUANTILE_COUNT; q++)
+  {
+    if (m_count == 0)
+    {
+      m_quantile[q]= 0;
+      continue;
+    }
+
+    /* Rank of the quantile, rounded up, in [1, m_count]. */
+    ulonglong rank= (m_count * quantiles[q] + 999) / 1000;
+    while (seen + buckets[index] < rank)
+      seen+= buckets[index++];
+    m_quantile[q]=
+      normalizer->wait_to_pico(PFS_histogram::bucket_value(index));
+  }
+}
+
+void PFS_quantile_row::set_field(uint index, Field *f)
+{
+  switch (index)
+  {
+    case 0: /* COUNT_STAR */
+      PFS_engine_table::set_field_ulonglong(f, m_count);
+      break;
+    case 1: /* QUANTILE_50 */
+    case 2: /* QUANTILE_95 */
+    case 3: /* QUANTILE_99 */
+    case 4: /* QUANTILE_999 */
+      PFS_engine_table::set_field_ulonglong(f, m_quantile[index - 1]);
+      break;
+    default:
+      DBUG_ASSERT(false);
+      break;
+  }
+}
+
 void PFS_connection_stat_row::set_field(uint index, Field *f)
 {
   switch (index)
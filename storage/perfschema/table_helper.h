@@ -446,6 +446,27 @@ struct PFS_statement_stat_row
   void set_field(uint index, Field *f);
 };
 
+/** Number of quantiles in @c PFS_quantile_row. */
+#define PFS_QUANTILE_COUNT 4
+
+/**
+  Row fragment for statement latency quantiles.
+  Corresponds to PFS_histogram.
+*/
+struct PFS_quantile_row
+{
+  /** Column COUNT_STAR. */
+  ulonglong m_count;
+  /** Columns QUANTILE_50, QUANTILE_95, QUANTILE_99, QUANTILE_999. */
+  ulonglong m_quantile[PFS_QUANTILE_COUNT];
+
+  /** Build a row from a memory buffer. */
+  void set(time_normalizer *normalizer, const PFS_histogram *histogram);
+
+  /** Set a table field from the row. */
+  void set_field(uint index, Field *f);
+};
+
 /** Row fragment for stored program statistics. */
 struct PFS_sp_stat_row
 {
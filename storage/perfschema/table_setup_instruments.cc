@@ -46,12 +46,17 @@ static const TABLE_FIELD_TYPE field_types[]=
     { C_STRING_WITH_LEN("TIMED") },
     { C_STRING_WITH_LEN("enum(\'YES\',\'NO\')") },
     { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("SAMPLE_RATE") },
+    { C_STRING_WITH_LEN("int(10)") },
+    { NULL, 0}
   }
 };
 
 TABLE_FIELD_DEF
 table_setup_instruments::m_field_def=
-{ 3, field_types };
+{ 4, field_types };
 
 PFS_engine_table_share
 table_setup_instruments::m_share=
@@ -233,6 +238,9 @@ int table_setup_instruments::read_row_values(TABLE *table,
       case 2: /* TIMED */
         set_field_enum(f, m_row.m_instr_class->m_timed ? ENUM_YES : ENUM_NO);
         break;
+      case 3: /* SAMPLE_RATE */
+        set_field_ulong(f, m_row.m_instr_class->m_sample_rate);
+        break;
       default:
         DBUG_ASSERT(false);
       }
@@ -249,6 +257,7 @@ int table_setup_instruments::update_row_values(TABLE *table,
 {
   Field *f;
   enum_yes_no value;
+  ulong sample_rate;
 
   for (; (f= *fields) ; fields++)
   {
@@ -266,6 +275,10 @@ int table_setup_instruments::update_row_values(TABLE *table,
         value= (enum_yes_no) get_field_enum(f);
         m_row.m_instr_class->m_timed= (value == ENUM_YES) ? true : false;
         break;
+      case 3: /* SAMPLE_RATE */
+        sample_rate= get_field_ulong(f);
+        m_row.m_instr_class->m_sample_rate= (sample_rate > 0) ? sample_rate : 1;
+        break;
       default:
         DBUG_ASSERT(false);
       }
@@ -114,6 +114,7 @@ void test_bootstrap()
   param.m_program_sizing= 0;
   param.m_statement_stack_sizing= 0;
   param.m_memory_class_sizing= 0;
+  param.m_cpu_sample_interval= 0;
 
   pre_initialize_performance_schema();
   boot= initialize_performance_schema(& param);
@@ -176,6 +177,7 @@ PSI * load_perfschema()
   param.m_program_sizing= 0;
   param.m_statement_stack_sizing= 10;
   param.m_memory_class_sizing= 10;
+  param.m_cpu_sample_interval= 0;
 
   /* test_bootstrap() covered this, assuming it just works */
   boot= initialize_performance_schema(& param);
@@ -1523,6 +1525,7 @@ void test_event_name_index()
   param.m_program_sizing= 0;
   param.m_statement_stack_sizing= 10;
   param.m_memory_class_sizing= 12;
+  param.m_cpu_sample_interval= 0;
 
   param.m_mutex_sizing= 0;
   param.m_rwlock_sizing= 0;
@@ -0,0 +1,84 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef CTYPE_ASCII_INCLUDED
+#define CTYPE_ASCII_INCLUDED
+
+/*
+  Fast scanning of ASCII text for the multi-byte character sets.
+
+  In the ASCII based multi-byte character sets (utf8, utf8mb4, sjis,
+  gbk, ...) a byte below 0x80 at a character boundary is always a
+  complete character, so a run of such bytes can be counted without
+  decoding it. Character sets with MY_CS_NONASCII (filename, ucs2,
+  utf16, utf32) must not use this.
+*/
+
+#include <my_global.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+  Length of the run of ASCII bytes at the start of a string.
+
+  Checks 32 (AVX2) or 16 (SSE2, NEON) bytes at a time, then 8 bytes at
+  a time, and finds the exact end of the run byte by byte.
+
+  @param s  Start of the string
+  @param e  End of the string
+
+  @return Number of bytes below 0x80 before the first other byte or e
+*/
+
+static inline size_t my_ascii_prefix_length(const uchar *s, const uchar *e)
+{
+  const uchar *s0= s;
+#if defined(__AVX2__)
+  for (; e - s >= 32; s+= 32)
+  {
+    if (_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *) s)))
+      break;
+  }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+  for (; e - s >= 16; s+= 16)
+  {
+    if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *) s)))
+      break;
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; e - s >= 16; s+= 16)
+  {
+    if (vmaxvq_u8(vld1q_u8(s)) & 0x80)
+      break;
+  }
+#endif
+  for (; e - s >= 8; s+= 8)
+  {
+    if (uint8korr(s) & 0x8080808080808080ULL)
+      break;
+  }
+  while (s < e && *s < 0x80)
+    s++;
+  return (size_t) (s - s0);
+}
+
+#endif /* CTYPE_ASCII_INCLUDED */
@@ -16,6 +16,7 @@
 #include <my_global.h>
 #include "m_ctype.h"
 #include "m_string.h"
+#include "ctype-ascii.h"
 
 
 size_t my_caseup_str_mb(const CHARSET_INFO *cs, char *str)
@@ -371,13 +372,22 @@ int my_wildcmp_mb(const CHARSET_INFO *cs,
 }
 
 
-size_t my_numchars_mb(const CHARSET_INFO *cs __attribute__((unused)),
+size_t my_numchars_mb(const CHARSET_INFO *cs,
 		      const char *pos, const char *end)
 {
   size_t count= 0;
+  my_bool ascii_based= !(cs->state & MY_CS_NONASCII);
   while (pos < end) 
   {
     uint mb_len;
+    if (ascii_based && (uchar) *pos < 0x80)
+    {
+      size_t ascii_len= my_ascii_prefix_length((const uchar *) pos,
+                                               (const uchar *) end);
+      pos+= ascii_len;
+      count+= ascii_len;
+      continue;
+    }
     pos+= (mb_len= my_ismbchar(cs,pos,end)) ? mb_len : 1;
     count++;
   }
@@ -385,14 +395,25 @@ size_t my_numchars_mb(const CHARSET_INFO *cs __attribute__((unused)),
 }
 
 
-size_t my_charpos_mb(const CHARSET_INFO *cs __attribute__((unused)),
+size_t my_charpos_mb(const CHARSET_INFO *cs,
 		     const char *pos, const char *end, size_t length)
 {
   const char *start= pos;
+  my_bool ascii_based= !(cs->state & MY_CS_NONASCII);
   
   while (length && pos < end)
   {
     uint mb_len;
+    if (ascii_based && (uchar) *pos < 0x80)
+    {
+      size_t ascii_len= my_ascii_prefix_length((const uchar *) pos,
+                                               (const uchar *) pos +
+                                               MY_MIN((size_t) (end - pos),
+                                                      length));
+      pos+= ascii_len;
+      length-= ascii_len;
+      continue;
+    }
     pos+= (mb_len= my_ismbchar(cs, pos, end)) ? mb_len : 1;
     length--;
   }
@@ -19466,6 +19466,7 @@ typedef struct my_uca_scanner_st
   int page;
   int code;
   const CHARSET_INFO *cs;
+  my_bool ascii_fast;   /* ASCII weights are read without decoding */
 } my_uca_scanner;
 
 /*
@@ -19615,6 +19616,55 @@ my_uca_have_contractions_quick(const MY_UCA_WEIGHT_LEVEL *level)
 }
 
 
+/**
+  Check if ASCII characters can be weighed one byte at a time
+
+  In an ASCII based character set every byte below 0x80 is a character
+  of its own. If the level has no contractions, the weights of such a
+  character do not depend on its neighbours and are found on page 0.
+
+  @param cs       Character set information
+  @param level    Pointer to UCA level data
+
+  @return   TRUE if the ASCII fast path can be used
+*/
+
+static inline my_bool
+my_uca_ascii_fast(const CHARSET_INFO *cs, const MY_UCA_WEIGHT_LEVEL *level)
+{
+  return cs->mbminlen == 1 && !(cs->state & MY_CS_NONASCII) &&
+         !my_uca_have_contractions_quick(level) && level->weights[0];
+}
+
+
+/**
+  Length of the common prefix of ASCII bytes of two strings
+
+  Only valid for a collation where my_uca_ascii_fast() is TRUE.
+  The weights of the prefix are the same in both strings, so
+  comparing them can start after the prefix.
+
+  @return   Length of the prefix in bytes
+*/
+
+static size_t
+my_uca_common_ascii_prefix(const uchar *s, size_t slen,
+                           const uchar *t, size_t tlen)
+{
+  size_t len= MY_MIN(slen, tlen);
+  size_t i= 0;
+  for (; i + 8 <= len; i+= 8)
+  {
+    ulonglong sw= uint8korr(s + i);
+    if (sw != uint8korr(t + i) || (sw & 0x8080808080808080ULL))
+      break;
+  }
+  for (; i < len && s[i] == t[i] && s[i] < 0x80; i++)
+  { }
+  return i;
+}
+
+
 
 /**
   Check if a character can be contraction head
@@ -19912,6 +19962,7 @@ my_uca_scanner_init_any(my_uca_scanner *scanner,
   scanner->wbeg= nochar; 
   scanner->level= level;
   scanner->cs= cs;
+  scanner->ascii_fast= my_uca_ascii_fast(cs, level);
 }
 
 static int my_uca_scanner_next_any(my_uca_scanner *scanner)
@@ -19925,6 +19976,21 @@ static int my_uca_scanner_next_any(my_uca_scanner *scanner)
   if (scanner->wbeg[0])      /* More weights left from the previous step: */
     return *scanner->wbeg++; /* return the next weight from expansion     */
 
+  if (scanner->ascii_fast)
+  {
+    /* Take ASCII weights from page 0, skipping ignorable characters */
+    const uint16 *wpage= scanner->level->weights[0];
+    uint length= scanner->level->lengths[0];
+    while (scanner->sbeg < scanner->send && scanner->sbeg[0] < 0x80)
+    {
+      scanner->page= 0;
+      scanner->code= *scanner->sbeg++;
+      scanner->wbeg= wpage + scanner->code * length;
+      if (scanner->wbeg[0])
+        return *scanner->wbeg++;
+    }
+  }
+
   do
   {
     uint16 *wpage;
@@ -20051,6 +20117,15 @@ static int my_strnncoll_uca(const CHARSET_INFO *cs,
   my_uca_scanner tscanner;
   int s_res;
   int t_res;
+
+  if (my_uca_ascii_fast(cs, &cs->uca->level[0]))
+  {
+    size_t prefix= my_uca_common_ascii_prefix(s, slen, t, tlen);
+    s+= prefix;
+    slen-= prefix;
+    t+= prefix;
+    tlen-= prefix;
+  }
   
   scanner_handler->init(&sscanner, cs, &cs->uca->level[0], s, slen);
   scanner_handler->init(&tscanner, cs, &cs->uca->level[0], t, tlen);
@@ -20157,6 +20232,15 @@ static int my_strnncollsp_uca(const CHARSET_INFO *cs,
   diff_if_only_endspace_difference= 0;
 #endif
 
+  if (my_uca_ascii_fast(cs, &cs->uca->level[0]))
+  {
+    size_t prefix= my_uca_common_ascii_prefix(s, slen, t, tlen);
+    s+= prefix;
+    slen-= prefix;
+    t+= prefix;
+    tlen-= prefix;
+  }
+
   scanner_handler->init(&sscanner, cs, &cs->uca->level[0], s, slen);
   scanner_handler->init(&tscanner, cs, &cs->uca->level[0], t, tlen);
   
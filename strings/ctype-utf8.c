@@ -20,6 +20,7 @@
 #include <my_global.h>
 #include "m_string.h"
 #include "m_ctype.h"
+#include "ctype-ascii.h"
 #include <errno.h>
 
 #ifndef EILSEQ
@@ -5106,14 +5107,20 @@ my_strnxfrm_unicode(const CHARSET_INFO *cs,
   const uchar *se= src + srclen;
   MY_UNICASE_INFO *uni_plane= (cs->state & MY_CS_BINSORT) ?
                                NULL : cs->caseinfo;
+  my_bool ascii_based= cs->mbminlen == 1 && !(cs->state & MY_CS_NONASCII);
   LINT_INIT(wc);
   DBUG_ASSERT(src);
   
   for (; dst < de && nweights; nweights--)
   {
-    if ((res= cs->cset->mb_wc(cs, &wc, src, se)) <= 0)
-      break;
-    src+= res;
+    if (ascii_based && src < se && *src < 0x80)
+      wc= *src++;                               /* No need to decode */
+    else
+    {
+      if ((res= cs->cset->mb_wc(cs, &wc, src, se)) <= 0)
+        break;
+      src+= res;
+    }
 
     if (uni_plane)
       my_tosort_unicode(uni_plane, &wc, cs->state);
@@ -5568,7 +5575,7 @@ static void my_hash_sort_utf8(const CHARSET_INFO *cs, const uchar *s,
 {
   my_wc_t wc;
   int res;
-  const uchar *e=s+slen;
+  const uchar *e;
   MY_UNICASE_INFO *uni_plane= cs->caseinfo;
   ulong tmp1;
   ulong tmp2;
@@ -5577,14 +5584,21 @@ static void my_hash_sort_utf8(const CHARSET_INFO *cs, const uchar *s,
     Remove end space. We have to do this to be able to compare
     'A ' and 'A' as identical
   */
-  while (e > s && e[-1] == ' ')
-    e--;
+  e= skip_trailing_space(s, slen);
 
   tmp1= *n1;
   tmp2= *n2;
 
-  while ((s < e) && (res=my_utf8_uni(cs,&wc, (uchar *)s, (uchar*)e))>0 )
+  while (s < e)
   {
+    if (*s < 0x80)
+    {
+      /* An ASCII character, no need to decode it */
+      wc= *s;
+      res= 1;
+    }
+    else if ((res= my_utf8_uni(cs, &wc, (uchar *) s, (uchar*) e)) <= 0)
+      break;
     my_tosort_unicode(uni_plane, &wc, cs->state);
     tmp1^= (((tmp1 & 63) + tmp2) * (wc & 0xFF)) + (tmp1 << 8);
     tmp2+=3;
@@ -5946,6 +5960,41 @@ static uint my_ismbchar_utf8(const CHARSET_INFO *cs, const char *b,
   return (res>1) ? res : 0;
 }
 
+/*
+  Same as my_well_formed_len_mb(), but skips runs of ASCII
+  characters without decoding them.
+*/
+static size_t my_well_formed_len_utf8(const CHARSET_INFO *cs,
+                                      const char *b, const char *e,
+                                      size_t pos, int *error)
+{
+  const char *b_start= b;
+  *error= 0;
+  while (pos)
+  {
+    my_wc_t wc;
+    int mb_len;
+
+    if (b < e && (uchar) *b < 0x80)
+    {
+      size_t ascii_len= my_ascii_prefix_length((const uchar *) b,
+                                               (const uchar *) b +
+                                               MY_MIN((size_t) (e - b), pos));
+      b+= ascii_len;
+      pos-= ascii_len;
+      continue;
+    }
+    if ((mb_len= my_utf8_uni(cs, &wc, (uchar*) b, (uchar*) e)) <= 0)
+    {
+      *error= b < e ? 1 : 0;
+      break;
+    }
+    b+= mb_len;
+    pos--;
+  }
+  return (size_t) (b - b_start);
+}
+
 static uint my_mbcharlen_utf8(const CHARSET_INFO *cs  __attribute__((unused)),
                               uint c)
 {
@@ -6007,7 +6056,7 @@ MY_CHARSET_HANDLER my_charset_utf8_handler=
     my_mbcharlen_utf8,
     my_numchars_mb,
     my_charpos_mb,
-    my_well_formed_len_mb,
+    my_well_formed_len_utf8,
     my_lengthsp_8bit,
     my_numcells_mb,
     my_utf8_uni,
@@ -8060,7 +8109,7 @@ my_hash_sort_utf8mb4(const CHARSET_INFO *cs, const uchar *s, size_t slen,
 {
   my_wc_t wc;
   int res;
-  const uchar *e= s + slen;
+  const uchar *e;
   MY_UNICASE_INFO *uni_plane= cs->caseinfo;
   ulong tmp1;
   ulong tmp2;
@@ -8070,14 +8119,21 @@ my_hash_sort_utf8mb4(const CHARSET_INFO *cs, const uchar *s, size_t slen,
     Remove end space. We do this to be able to compare
     'A ' and 'A' as identical
   */
-  while (e > s && e[-1] == ' ')
-    e--;
+  e= skip_trailing_space(s, slen);
 
   tmp1= *n1;
   tmp2= *n2;
 
-  while ((res= my_mb_wc_utf8mb4(cs, &wc, (uchar*) s, (uchar*) e)) > 0)
+  for (;;)
   {
+    if (s < e && *s < 0x80)
+    {
+      /* An ASCII character, no need to decode it */
+      wc= *s;
+      res= 1;
+    }
+    else if ((res= my_mb_wc_utf8mb4(cs, &wc, (uchar*) s, (uchar*) e)) <= 0)
+      break;
     my_tosort_unicode(uni_plane, &wc, cs->state);
 
     ch= (wc & 0xFF);
@@ -8442,6 +8498,43 @@ my_ismbchar_utf8mb4(const CHARSET_INFO *cs, const char *b, const char *e)
 }
 
 
+/*
+  Same as my_well_formed_len_mb(), but skips runs of ASCII
+  characters without decoding them.
+*/
+static size_t
+my_well_formed_len_utf8mb4(const CHARSET_INFO *cs,
+                           const char *b, const char *e,
+                           size_t pos, int *error)
+{
+  const char *b_start= b;
+  *error= 0;
+  while (pos)
+  {
+    my_wc_t wc;
+    int mb_len;
+
+    if (b < e && (uchar) *b < 0x80)
+    {
+      size_t ascii_len= my_ascii_prefix_length((const uchar *) b,
+                                               (const uchar *) b +
+                                               MY_MIN((size_t) (e - b), pos));
+      b+= ascii_len;
+      pos-= ascii_len;
+      continue;
+    }
+    if ((mb_len= my_mb_wc_utf8mb4(cs, &wc, (uchar*) b, (uchar*) e)) <= 0)
+    {
+      *error= b < e ? 1 : 0;
+      break;
+    }
+    b+= mb_len;
+    pos--;
+  }
+  return (size_t) (b - b_start);
+}
+
+
 static uint
 my_mbcharlen_utf8mb4(const CHARSET_INFO *cs __attribute__((unused)), uint c)
 {
@@ -8498,7 +8591,7 @@ MY_CHARSET_HANDLER my_charset_utf8mb4_handler=
   my_mbcharlen_utf8mb4,
   my_numchars_mb,
   my_charpos_mb,
-  my_well_formed_len_mb,
+  my_well_formed_len_utf8mb4,
   my_lengthsp_8bit,
   my_numcells_mb,
   my_mb_wc_utf8mb4,
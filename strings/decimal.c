@@ -1103,6 +1103,53 @@ int decimal2longlong(decimal_t *from, longlong *to)
 }
 
 
+/*
+  Convert decimal to an integer scaled by 10^scale
+
+  SYNOPSIS
+    decimal2scaled_longlong()
+      from    - value to convert
+      to      - result, from * 10^scale
+      scale   - number of fractional digits to keep
+
+  NOTE
+    This is exact: it fails rather than rounds, so that callers can fall
+    back to the decimal_t arithmetic. Used for summing up values with
+    at most 18 digits as plain integers.
+
+  RETURN VALUE
+    E_DEC_OK
+    E_DEC_OVERFLOW  - more than 18 digits needed, *to is not changed
+    E_DEC_TRUNCATED - from has more than scale fractional digits,
+                      *to is not changed
+*/
+
+int decimal2scaled_longlong(const decimal_t *from, longlong *to, int scale)
+{
+  const dec1 *buf=from->buf;
+  longlong x=0;
+  int intg, frac;
+
+  if (from->frac > scale)
+    return E_DEC_TRUNCATED;
+  if (from->intg + scale > 18)
+    return E_DEC_OVERFLOW;
+
+  for (intg=from->intg; intg > 0; intg-=DIG_PER_DEC1)
+    x=x*DIG_BASE + *buf++;
+  for (frac=from->frac; scale > 0; frac-=DIG_PER_DEC1, scale-=DIG_PER_DEC1)
+  {
+    dec1 y= frac > 0 ? *buf++ : 0;
+    if (scale >= DIG_PER_DEC1)
+      x=x*DIG_BASE + y;
+    else
+      x=x*powers10[scale] + y / powers10[DIG_PER_DEC1 - scale];
+  }
+  *to=from->sign ? -x : x;
+  return E_DEC_OK;
+}
+
+
 #define LLDIV_MIN -1000000000000000000LL
 #define LLDIV_MAX  1000000000000000000LL
 
@@ -1508,6 +1555,88 @@ err:
   return(E_DEC_BAD_NUM);
 }
 
+/*
+  Restores an integer scaled by 10^scale from the binary representation
+  of a decimal
+
+  SYNOPSIS
+    bin2scaled_longlong()
+      from    - value to convert
+      to      - result, the value * 10^scale
+      precision/scale - see decimal_bin_size(), precision must be <= 18
+
+  NOTE
+    The same as bin2decimal() followed by decimal2scaled_longlong(),
+    without the decimal_t in between. See decimal2bin() for the format.
+
+  RETURN VALUE
+    E_DEC_OK
+    E_DEC_OVERFLOW  - precision is too big
+    E_DEC_BAD_NUM   - invalid binary representation, *to is not changed
+*/
+
+int bin2scaled_longlong(const uchar *from, longlong *to,
+                        int precision, int scale)
+{
+  int intg=precision-scale,
+      intg0=intg/DIG_PER_DEC1, frac0=scale/DIG_PER_DEC1,
+      intg0x=intg-intg0*DIG_PER_DEC1, frac0x=scale-frac0*DIG_PER_DEC1;
+  dec1 mask=(*from & 0x80) ? 0 : -1;
+  uchar d_copy[16];
+  longlong x=0;
+  int i;
+
+  if (precision > 18)
+    return E_DEC_OVERFLOW;
+  DBUG_ASSERT(decimal_bin_size(precision, scale) <= (int) sizeof(d_copy));
+  memcpy(d_copy, from, decimal_bin_size(precision, scale));
+  d_copy[0]^= 0x80;
+  from= d_copy;
+
+  if (intg0x)
+  {
+    dec1 UNINIT_VAR(y);
+    switch (dig2bytes[intg0x])
+    {
+      case 1: y=mi_sint1korr(from); break;
+      case 2: y=mi_sint2korr(from); break;
+      case 3: y=mi_sint3korr(from); break;
+      case 4: y=mi_sint4korr(from); break;
+      default: DBUG_ASSERT(0);
+    }
+    from+=dig2bytes[intg0x];
+    y^= mask;
+    if (((uint32) y) >= (uint32) powers10[intg0x])
+      return E_DEC_BAD_NUM;
+    x=y;
+  }
+  for (i=intg0+frac0; i > 0; i--, from+=sizeof(dec1))
+  {
+    dec1 y=mi_sint4korr(from) ^ mask;
+    if (((uint32) y) > DIG_MAX)
+      return E_DEC_BAD_NUM;
+    x=x*DIG_BASE + y;
+  }
+  if (frac0x)
+  {
+    dec1 UNINIT_VAR(y);
+    switch (dig2bytes[frac0x])
+    {
+      case 1: y=mi_sint1korr(from); break;
+      case 2: y=mi_sint2korr(from); break;
+      case 3: y=mi_sint3korr(from); break;
+      case 4: y=mi_sint4korr(from); break;
+      default: DBUG_ASSERT(0);
+    }
+    y^= mask;
+    if (((uint32) y) >= (uint32) powers10[frac0x])
+      return E_DEC_BAD_NUM;
+    x=x*powers10[frac0x] + y;
+  }
+  *to=mask ? -x : x;
+  return E_DEC_OK;
+}
+
 /*
   Returns the size of array to hold a decimal with given precision and scale
 
@@ -54,6 +54,7 @@
 static double my_strtod_int(const char *, char **, int *, char *, size_t);
 static char *dtoa(double, int, int, int *, int *, char **, char *, size_t);
 static void dtoa_free(char *, char *, size_t);
+static char *grisu3(double, int *, int *, char **, char *);
 
 /**
    @brief
@@ -212,7 +213,7 @@ size_t my_fcvt(double x, int precision, char *to, my_bool *error)
 size_t my_gcvt(double x, my_gcvt_arg_type type, int width, char *to,
                my_bool *error)
 {
-  int decpt, sign, len, exp_len;
+  int decpt, sign, len, exp_len, ndigits;
   char *res, *src, *end, *dst= to, *dend= dst + width;
   char buf[DTOA_BUFF_SIZE];
   my_bool have_space, force_e_format;
@@ -222,8 +223,14 @@ size_t my_gcvt(double x, my_gcvt_arg_type type, int width, char *to,
   if (x < 0.)
     width--;
 
-  res= dtoa(x, 4, type == MY_GCVT_ARG_DOUBLE ? width : MY_MIN(width, FLT_DIG),
-            &decpt, &sign, &end, buf, sizeof(buf));
+  /*
+    With 17 or more digits allowed, mode 4 gives the shortest digits
+    that read back as x, which grisu3() usually finds much faster.
+  */
+  ndigits= type == MY_GCVT_ARG_DOUBLE ? width : MY_MIN(width, FLT_DIG);
+  if (ndigits < DBL_DIG + 2 ||
+      !(res= grisu3(x, &decpt, &sign, &end, buf)))
+    res= dtoa(x, 4, ndigits, &decpt, &sign, &end, buf, sizeof(buf));
   if (decpt == DTOA_OVERFLOW)
   {
     dtoa_free(res, buf, sizeof(buf));
@@ -2828,3 +2835,320 @@ ret1:
     *rve= s;
   return s0;
 }
+
+
+/*
+  Shortest digits by the Grisu3 algorithm
+
+  Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+  with Integers", PLDI 2010. Grisu3 works with 64-bit integers only, and
+  either produces the same shortest, closest digits as dtoa() in mode 0,
+  or reports that it cannot be sure of them (for about 0.5% of the
+  numbers), in which case we use dtoa().
+*/
+
+/* A floating point number f * 2^e with a 64-bit significand */
+typedef struct { ulonglong f; int e; } Diy_fp;
+
+/* 10^decimal_exp ~= significand * 2^binary_exp, every 8th power of ten */
+static const struct
+{
+  ulonglong significand;
+  int16 binary_exp;
+  int16 decimal_exp;
+} grisu_cached_powers[]=
+{
+  {ULL(0xfa8fd5a0081c0288), -1220, -348},
+  {ULL(0xbaaee17fa23ebf76), -1193, -340},
+  {ULL(0x8b16fb203055ac76), -1166, -332},
+  {ULL(0xcf42894a5dce35ea), -1140, -324},
+  {ULL(0x9a6bb0aa55653b2d), -1113, -316},
+  {ULL(0xe61acf033d1a45df), -1087, -308},
+  {ULL(0xab70fe17c79ac6ca), -1060, -300},
+  {ULL(0xff77b1fcbebcdc4f), -1034, -292},
+  {ULL(0xbe5691ef416bd60c), -1007, -284},
+  {ULL(0x8dd01fad907ffc3c),  -980, -276},
+  {ULL(0xd3515c2831559a83),  -954, -268},
+  {ULL(0x9d71ac8fada6c9b5),  -927, -260},
+  {ULL(0xea9c227723ee8bcb),  -901, -252},
+  {ULL(0xaecc49914078536d),  -874, -244},
+  {ULL(0x823c12795db6ce57),  -847, -236},
+  {ULL(0xc21094364dfb5637),  -821, -228},
+  {ULL(0x9096ea6f3848984f),  -794, -220},
+  {ULL(0xd77485cb25823ac7),  -768, -212},
+  {ULL(0xa086cfcd97bf97f4),  -741, -204},
+  {ULL(0xef340a98172aace5),  -715, -196},
+  {ULL(0xb23867fb2a35b28e),  -688, -188},
+  {ULL(0x84c8d4dfd2c63f3b),  -661, -180},
+  {ULL(0xc5dd44271ad3cdba),  -635, -172},
+  {ULL(0x936b9fcebb25c996),  -608, -164},
+  {ULL(0xdbac6c247d62a584),  -582, -156},
+  {ULL(0xa3ab66580d5fdaf6),  -555, -148},
+  {ULL(0xf3e2f893dec3f126),  -529, -140},
+  {ULL(0xb5b5ada8aaff80b8),  -502, -132},
+  {ULL(0x87625f056c7c4a8b),  -475, -124},
+  {ULL(0xc9bcff6034c13053),  -449, -116},
+  {ULL(0x964e858c91ba2655),  -422, -108},
+  {ULL(0xdff9772470297ebd),  -396, -100},
+  {ULL(0xa6dfbd9fb8e5b88f),  -369,  -92},
+  {ULL(0xf8a95fcf88747d94),  -343,  -84},
+  {ULL(0xb94470938fa89bcf),  -316,  -76},
+  {ULL(0x8a08f0f8bf0f156b),  -289,  -68},
+  {ULL(0xcdb02555653131b6),  -263,  -60},
+  {ULL(0x993fe2c6d07b7fac),  -236,  -52},
+  {ULL(0xe45c10c42a2b3b06),  -210,  -44},
+  {ULL(0xaa242499697392d3),  -183,  -36},
+  {ULL(0xfd87b5f28300ca0e),  -157,  -28},
+  {ULL(0xbce5086492111aeb),  -130,  -20},
+  {ULL(0x8cbccc096f5088cc),  -103,  -12},
+  {ULL(0xd1b71758e219652c),   -77,   -4},
+  {ULL(0x9c40000000000000),   -50,    4},
+  {ULL(0xe8d4a51000000000),   -24,   12},
+  {ULL(0xad78ebc5ac620000),     3,   20},
+  {ULL(0x813f3978f8940984),    30,   28},
+  {ULL(0xc097ce7bc90715b3),    56,   36},
+  {ULL(0x8f7e32ce7bea5c70),    83,   44},
+  {ULL(0xd5d238a4abe98068),   109,   52},
+  {ULL(0x9f4f2726179a2245),   136,   60},
+  {ULL(0xed63a231d4c4fb27),   162,   68},
+  {ULL(0xb0de65388cc8ada8),   189,   76},
+  {ULL(0x83c7088e1aab65db),   216,   84},
+  {ULL(0xc45d1df942711d9a),   242,   92},
+  {ULL(0x924d692ca61be758),   269,  100},
+  {ULL(0xda01ee641a708dea),   295,  108},
+  {ULL(0xa26da3999aef774a),   322,  116},
+  {ULL(0xf209787bb47d6b85),   348,  124},
+  {ULL(0xb454e4a179dd1877),   375,  132},
+  {ULL(0x865b86925b9bc5c2),   402,  140},
+  {ULL(0xc83553c5c8965d3d),   428,  148},
+  {ULL(0x952ab45cfa97a0b3),   455,  156},
+  {ULL(0xde469fbd99a05fe3),   481,  164},
+  {ULL(0xa59bc234db398c25),   508,  172},
+  {ULL(0xf6c69a72a3989f5c),   534,  180},
+  {ULL(0xb7dcbf5354e9bece),   561,  188},
+  {ULL(0x88fcf317f22241e2),   588,  196},
+  {ULL(0xcc20ce9bd35c78a5),   614,  204},
+  {ULL(0x98165af37b2153df),   641,  212},
+  {ULL(0xe2a0b5dc971f303a),   667,  220},
+  {ULL(0xa8d9d1535ce3b396),   694,  228},
+  {ULL(0xfb9b7cd9a4a7443c),   720,  236},
+  {ULL(0xbb764c4ca7a44410),   747,  244},
+  {ULL(0x8bab8eefb6409c1a),   774,  252},
+  {ULL(0xd01fef10a657842c),   800,  260},
+  {ULL(0x9b10a4e5e9913129),   827,  268},
+  {ULL(0xe7109bfba19c0c9d),   853,  276},
+  {ULL(0xac2820d9623bf429),   880,  284},
+  {ULL(0x80444b5e7aa7cf85),   907,  292},
+  {ULL(0xbf21e44003acdd2d),   933,  300},
+  {ULL(0x8e679c2f5e44ff8f),   960,  308},
+  {ULL(0xd433179d9c8cb841),   986,  316},
+  {ULL(0x9e19db92b4e31ba9),  1013,  324},
+  {ULL(0xeb96bf6ebadf77d9),  1039,  332},
+  {ULL(0xaf87023b9bf0ee6b),  1066,  340}
+
+};
+
+#define GRISU_CACHED_POWERS_OFFSET 348
+#define GRISU_DECIMAL_EXP_DISTANCE 8
+/* Range of the binary exponent of the scaled value, see grisu3() */
+#define GRISU_MIN_TARGET_EXP -60
+#define GRISU_MAX_TARGET_EXP -32
+
+static const uint32 grisu_small_powers10[]=
+{
+  0, 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+  1000000000
+};
+
+
+/* x * y rounded to 64 bits */
+
+static Diy_fp diy_fp_mul(Diy_fp x, Diy_fp y)
+{
+  const ulonglong m32= 0xFFFFFFFFULL;
+  ulonglong a= x.f >> 32, b= x.f & m32, c= y.f >> 32, d= y.f & m32;
+  ulonglong ac= a * c, bc= b * c, ad= a * d, bd= b * d;
+  ulonglong tmp= (bd >> 32) + (ad & m32) + (bc & m32) + (1ULL << 31);
+  Diy_fp r;
+  r.f= ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e= x.e + y.e + 64;
+  return r;
+}
+
+
+static Diy_fp diy_fp_normalize(Diy_fp x)
+{
+  while (!(x.f & 0xFFC0000000000000ULL))
+  {
+    x.f<<= 10;
+    x.e-= 10;
+  }
+  while (!(x.f & 0x8000000000000000ULL))
+  {
+    x.f<<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+
+/*
+  Move the last digit of buf towards w while it stays in the safe
+  interval, and check that the result is closest to w for sure.
+  See round_weed() in the paper.
+*/
+
+static my_bool grisu_round_weed(char *buf, int len, ulonglong dist_high_w,
+                                ulonglong unsafe_interval, ulonglong rest,
+                                ulonglong ten_kappa, ulonglong unit)
+{
+  ulonglong small_dist= dist_high_w - unit;
+  ulonglong big_dist= dist_high_w + unit;
+
+  while (rest < small_dist &&
+         unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_dist ||
+          small_dist - rest >= rest + ten_kappa - small_dist))
+  {
+    buf[len - 1]--;
+    rest+= ten_kappa;
+  }
+  if (rest < big_dist &&
+      unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_dist ||
+       big_dist - rest > rest + ten_kappa - big_dist))
+    return FALSE;
+  return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+
+/*
+  Generate the shortest digits of a number in [low, high], which are
+  w scaled by a power of ten. See digit_gen() in the paper.
+*/
+
+static my_bool grisu_digit_gen(Diy_fp low, Diy_fp w, Diy_fp high,
+                               char *buf, int *len, int *kappa)
+{
+  ulonglong unit= 1;
+  ulonglong too_high= high.f + unit;
+  ulonglong unsafe_interval= too_high - (low.f - unit);
+  int shift= -w.e;
+  ulonglong one= 1ULL << shift;
+  uint32 integrals= (uint32) (too_high >> shift);
+  ulonglong fractionals= too_high & (one - 1);
+  uint32 divisor;
+  int k;
+
+  /* The biggest power of ten <= integrals, integrals < 2^(64 - shift) */
+  k= (((64 - shift) + 1) * 1233 >> 12) + 1;
+  if (integrals < grisu_small_powers10[k])
+    k--;
+  divisor= grisu_small_powers10[k];
+  *kappa= k;
+  *len= 0;
+
+  while (*kappa > 0)
+  {
+    ulonglong rest;
+    buf[(*len)++]= (char) ('0' + integrals / divisor);
+    integrals%= divisor;
+    (*kappa)--;
+    rest= ((ulonglong) integrals << shift) + fractionals;
+    if (rest < unsafe_interval)
+      return grisu_round_weed(buf, *len, too_high - w.f, unsafe_interval,
+                              rest, (ulonglong) divisor << shift, unit);
+    divisor/= 10;
+  }
+  for (;;)
+  {
+    fractionals*= 10;
+    unit*= 10;
+    unsafe_interval*= 10;
+    buf[(*len)++]= (char) ('0' + (fractionals >> shift));
+    fractionals&= one - 1;
+    (*kappa)--;
+    if (fractionals < unsafe_interval)
+      return grisu_round_weed(buf, *len, (too_high - w.f) * unit,
+                              unsafe_interval, fractionals, one, unit);
+  }
+}
+
+
+/**
+   Shortest digits of a double that read back as the same double.
+
+   @details
+   Does what dtoa() does in mode 0 for a finite, non-zero x, with 64-bit
+   integer arithmetic instead of Bigints.
+
+   @param x      the number
+   @param decpt  position of the decimal point, as for dtoa()
+   @param sign   set to 1 for negative x
+   @param rve    set to the end of the digits
+   @param buf    at least 18 bytes for the digits and '\0'
+
+   @return       buf, or NULL if the fast algorithm could not decide and
+                 dtoa() must be used.
+*/
+
+static char *grisu3(double x, int *decpt, int *sign, char **rve, char *buf)
+{
+  ulonglong bits, significand;
+  int biased_exp, k, index, len, kappa;
+  Diy_fp v, w, m_plus, m_minus, c_mk;
+
+  memcpy(&bits, &x, sizeof(bits));
+  *sign= (int) (bits >> 63);
+  biased_exp= (int) ((bits >> 52) & 0x7FF);
+  significand= bits & 0xFFFFFFFFFFFFFULL;
+  if (biased_exp == 0x7FF || (biased_exp == 0 && significand == 0))
+    return NULL;                                /* inf, nan, zero */
+  if (biased_exp)
+  {
+    v.f= significand | 0x10000000000000ULL;
+    v.e= biased_exp - 1075;
+  }
+  else
+  {
+    v.f= significand;
+    v.e= -1074;
+  }
+
+  /* The boundaries halfway to the neighbouring doubles */
+  m_plus.f= (v.f << 1) + 1;
+  m_plus.e= v.e - 1;
+  m_plus= diy_fp_normalize(m_plus);
+  if (v.f == 0x10000000000000ULL && biased_exp > 1)
+  {
+    m_minus.f= (v.f << 2) - 1;
+    m_minus.e= v.e - 2;
+  }
+  else
+  {
+    m_minus.f= (v.f << 1) - 1;
+    m_minus.e= v.e - 1;
+  }
+  m_minus.f<<= m_minus.e - m_plus.e;
+  m_minus.e= m_plus.e;
+  w= diy_fp_normalize(v);
+
+  /* A power of ten that brings w.e into the target exponent range */
+  k= (int) ceil((GRISU_MIN_TARGET_EXP - (w.e + 64) + 64 - 1) *
+                0.30102999566398114);
+  index= (GRISU_CACHED_POWERS_OFFSET + k - 1) / GRISU_DECIMAL_EXP_DISTANCE + 1;
+  c_mk.f= grisu_cached_powers[index].significand;
+  c_mk.e= grisu_cached_powers[index].binary_exp;
+  DBUG_ASSERT(GRISU_MIN_TARGET_EXP <= w.e + c_mk.e + 64 &&
+              w.e + c_mk.e + 64 <= GRISU_MAX_TARGET_EXP);
+
+  if (!grisu_digit_gen(diy_fp_mul(m_minus, c_mk), diy_fp_mul(w, c_mk),
+                       diy_fp_mul(m_plus, c_mk), buf, &len, &kappa))
+    return NULL;
+
+  *decpt= len + kappa - grisu_cached_powers[index].decimal_exp;
+  buf[len]= '\0';
+  if (rve)
+    *rve= buf + len;
+  return buf;
+}
@@ -0,0 +1,69 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*  File   : memchr2.c
+    Defines: my_memchr2()
+
+    my_memchr2(s, end, c1, c2) returns a pointer to the first byte in
+    [s, end) that is c1 or c2, or NULL if there is none. It is used to
+    find both cases of a letter, e.g. for case insensitive LIKE.
+*/
+
+#include <my_global.h>
+#include "m_string.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+const char *my_memchr2(const char *s, const char *end, uchar c1, uchar c2)
+{
+  if (c1 == c2)
+    return s < end ? (const char *) memchr(s, c1, (size_t) (end - s)) : NULL;
+
+#if defined(__SSE2__) || defined(_M_X64)
+  {
+    const __m128i v1= _mm_set1_epi8((char) c1);
+    const __m128i v2= _mm_set1_epi8((char) c2);
+    for (; end - s >= 16; s+= 16)
+    {
+      __m128i v= _mm_loadu_si128((const __m128i *) s);
+      if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, v1),
+                                         _mm_cmpeq_epi8(v, v2))))
+        break;
+    }
+  }
+#else
+  {
+    /* A word has a zero byte if (w - 0x01..01) & ~w & 0x80..80 */
+    const ulonglong ones= 0x0101010101010101ULL;
+    const ulonglong highs= 0x8080808080808080ULL;
+    const ulonglong w1= c1 * ones, w2= c2 * ones;
+    for (; end - s >= 8; s+= 8)
+    {
+      ulonglong x1= uint8korr(s) ^ w1;
+      ulonglong x2= uint8korr(s) ^ w2;
+      if (((x1 - ones) & ~x1 & highs) | ((x2 - ones) & ~x2 & highs))
+        break;
+    }
+  }
+#endif
+  for (; s < end; s++)
+  {
+    if ((uchar) *s == c1 || (uchar) *s == c2)
+      return s;
+  }
+  return NULL;
+}
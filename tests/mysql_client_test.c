@@ -19439,6 +19439,438 @@ static void test_wl5928()
 }
 
 
+static my_bool async_not_ready(enum net_async_status status)
+{
+  return status == NET_ASYNC_NOT_READY_READ ||
+         status == NET_ASYNC_NOT_READY_WRITE;
+}
+
+
+/*
+  The non-blocking query functions, called again until they are ready:
+  a result set that takes many reads, a long query, an error, and the
+  results of a multi-statement.
+*/
+
+static void test_nonblocking_api()
+{
+  MYSQL *mysql_local;
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  enum net_async_status status;
+  const char *query;
+  char *long_query;
+  uint rows, i;
+  int rc;
+
+  myheader("test_nonblocking_api");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT, b VARCHAR(1000))");
+  myquery(rc);
+  rc= mysql_query(mysql, "INSERT INTO t1 VALUES (1, REPEAT('x', 1000))");
+  myquery(rc);
+  for (i= 0; i < 10; i++)
+  {
+    rc= mysql_query(mysql, "INSERT INTO t1 "
+                    "SELECT a + (SELECT COUNT(*) FROM t1), b FROM t1");
+    myquery(rc);
+  }
+
+  if (!(mysql_local= mysql_client_init(NULL)))
+  {
+    fprintf(stdout, "\n mysql_client_init() failed");
+    exit(1);
+  }
+  if (!(mysql_real_connect(mysql_local, opt_host, opt_user,
+                           opt_password, current_db, opt_port,
+                           opt_unix_socket, CLIENT_MULTI_STATEMENTS)))
+  {
+    fprintf(stdout, "\n connection failed(%s)", mysql_error(mysql_local));
+    exit(1);
+  }
+  DIE_UNLESS(mysql_get_socket_descriptor(mysql_local) != INVALID_SOCKET);
+
+  /* 1 MB of rows, fetched one by one */
+  query= "SELECT a, b FROM t1 ORDER BY a";
+  while (async_not_ready(status=
+                         mysql_real_query_nonblocking(mysql_local, query,
+                                                      strlen(query))))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+  result= mysql_use_result(mysql_local);
+  mytest(result);
+  DIE_UNLESS(mysql_num_fields(result) == 2);
+  for (rows= 0; ; rows++)
+  {
+    while (async_not_ready(status=
+                           mysql_fetch_row_nonblocking(result, &row)))
+    {}
+    DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+    if (!row)
+      break;
+    DIE_UNLESS(atoi(row[0]) == (int) rows + 1);
+    DIE_UNLESS(strlen(row[1]) == 1000);
+  }
+  DIE_UNLESS(rows == 1024);
+  mysql_free_result(result);
+
+  /* A query longer than the socket buffers */
+  long_query= (char *) malloc(1000100);
+  DIE_UNLESS(long_query != NULL);
+  strmov(long_query, "SELECT LENGTH('");
+  memset(long_query + 15, 'x', 1000000);
+  strmov(long_query + 1000015, "')");
+  while (async_not_ready(status=
+                         mysql_real_query_nonblocking(mysql_local, long_query,
+                                                      strlen(long_query))))
+  {}
+  free(long_query);
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+  result= mysql_store_result(mysql_local);
+  mytest(result);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(row && strcmp(row[0], "1000000") == 0);
+  mysql_free_result(result);
+
+  /* An error */
+  query= "SELECT * FROM t_no_such_table";
+  while (async_not_ready(status=
+                         mysql_real_query_nonblocking(mysql_local, query,
+                                                      strlen(query))))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_ERROR);
+  DIE_UNLESS(mysql_errno(mysql_local) == ER_NO_SUCH_TABLE);
+
+  /* The results of a multi-statement */
+  query= "SELECT 1; DELETE FROM t1 WHERE a > 1000; SELECT 2";
+  while (async_not_ready(status=
+                         mysql_real_query_nonblocking(mysql_local, query,
+                                                      strlen(query))))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+  result= mysql_store_result(mysql_local);
+  mytest(result);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(row && strcmp(row[0], "1") == 0);
+  mysql_free_result(result);
+
+  while (async_not_ready(status= mysql_next_result_nonblocking(mysql_local)))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+  DIE_UNLESS(mysql_field_count(mysql_local) == 0);
+  DIE_UNLESS(mysql_affected_rows(mysql_local) == 24);
+
+  while (async_not_ready(status= mysql_next_result_nonblocking(mysql_local)))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+  result= mysql_use_result(mysql_local);
+  mytest(result);
+  while (async_not_ready(status= mysql_fetch_row_nonblocking(result, &row)))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE);
+  DIE_UNLESS(row && strcmp(row[0], "2") == 0);
+  while (async_not_ready(status= mysql_fetch_row_nonblocking(result, &row)))
+  {}
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE && row == NULL);
+  mysql_free_result(result);
+
+  status= mysql_next_result_nonblocking(mysql_local);
+  DIE_UNLESS(status == NET_ASYNC_COMPLETE_NO_MORE_RESULTS);
+
+  mysql_close(mysql_local);
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
+
+
+/*
+  Pipelined queries: the results are read in the order of the queries,
+  an error does not affect the queries after it, and no other command
+  can be sent before all the results are read.
+*/
+
+static void test_pipeline()
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  const char *queries[]= {
+    "INSERT INTO t1 VALUES (1), (2), (3)",
+    "SELECT * FROM t_no_such_table",
+    "SELECT COUNT(*) FROM t1",
+    "UPDATE t1 SET a= a + 10 WHERE a > 1",
+    "SELECT a FROM t1 ORDER BY a"
+  };
+  uint i;
+  int rc;
+
+  myheader("test_pipeline");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT)");
+  myquery(rc);
+
+  /* Nothing to read */
+  DIE_UNLESS(mysql_pipeline_pending(mysql) == 0);
+  DIE_UNLESS(mysql_pipeline_read_result(mysql));
+  DIE_UNLESS(mysql_errno(mysql) == CR_COMMANDS_OUT_OF_SYNC);
+
+  for (i= 0; i < array_elements(queries); i++)
+  {
+    rc= mysql_pipeline_query(mysql, queries[i], strlen(queries[i]));
+    myquery(rc);
+  }
+  DIE_UNLESS(mysql_pipeline_pending(mysql) == array_elements(queries));
+
+  /* The results are to be read first */
+  rc= mysql_query(mysql, "SELECT 1");
+  DIE_UNLESS(rc && mysql_errno(mysql) == CR_COMMANDS_OUT_OF_SYNC);
+
+  rc= mysql_pipeline_flush(mysql);
+  myquery(rc);
+
+  DIE_UNLESS(!mysql_pipeline_read_result(mysql));
+  DIE_UNLESS(mysql_field_count(mysql) == 0);
+  DIE_UNLESS(mysql_affected_rows(mysql) == 3);
+
+  DIE_UNLESS(mysql_pipeline_read_result(mysql));
+  DIE_UNLESS(mysql_errno(mysql) == ER_NO_SUCH_TABLE);
+
+  DIE_UNLESS(!mysql_pipeline_read_result(mysql));
+  result= mysql_store_result(mysql);
+  mytest(result);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(row && strcmp(row[0], "3") == 0);
+  mysql_free_result(result);
+
+  DIE_UNLESS(!mysql_pipeline_read_result(mysql));
+  DIE_UNLESS(mysql_affected_rows(mysql) == 2);
+
+  DIE_UNLESS(mysql_pipeline_pending(mysql) == 1);
+  DIE_UNLESS(!mysql_pipeline_read_result(mysql));
+  result= mysql_store_result(mysql);
+  mytest(result);
+  rc= my_process_result_set(result);
+  DIE_UNLESS(rc == 3);
+  mysql_free_result(result);
+
+  DIE_UNLESS(mysql_pipeline_pending(mysql) == 0);
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
+
+
+/*
+  Cursors in a transaction read the rows on each fetch: other
+  statements can run between the fetches, and COMMIT closes the cursor.
+*/
+
+static void test_streaming_cursor()
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[2];
+  int32 a, c;
+  int rc;
+  int num_rows= 0;
+  int32 sum= 0;
+  ulong type= (ulong) CURSOR_TYPE_READ_ONLY;
+  ulong prefetch_rows= 2;
+  const char *stmt_text;
+
+  myheader("test_streaming_cursor");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1, t2");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT PRIMARY KEY) ENGINE=InnoDB");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t2 (b INT PRIMARY KEY, c INT) "
+                         "ENGINE=InnoDB");
+  myquery(rc);
+  rc= mysql_query(mysql, "INSERT INTO t1 VALUES (1), (2), (3), (4), (5)");
+  myquery(rc);
+  rc= mysql_query(mysql, "INSERT INTO t2 VALUES "
+                         "(1, 10), (2, 20), (3, 30), (4, 40), (5, 50)");
+  myquery(rc);
+
+  rc= mysql_autocommit(mysql, FALSE);
+  myquery(rc);
+
+  stmt= mysql_stmt_init(mysql);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_CURSOR_TYPE, (void*) &type);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_PREFETCH_ROWS,
+                          (void*) &prefetch_rows);
+  check_execute(stmt, rc);
+  stmt_text= "SELECT a, c FROM t1 JOIN t2 ON b = a";
+  rc= mysql_stmt_prepare(stmt, stmt_text, strlen(stmt_text));
+  check_execute(stmt, rc);
+
+  memset(my_bind, 0, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void*) &a;
+  my_bind[1].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[1].buffer= (void*) &c;
+  rc= mysql_stmt_bind_result(stmt, my_bind);
+  check_execute(stmt, rc);
+
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+
+  while ((rc= mysql_stmt_fetch(stmt)) == 0)
+  {
+    DIE_UNLESS(c == a * 10);
+    sum+= a;
+    if (++num_rows == 3)
+    {
+      /* The connection is free between the fetches */
+      rc= mysql_query(mysql, "SELECT COUNT(*) FROM t2");
+      myquery(rc);
+      mysql_free_result(mysql_store_result(mysql));
+    }
+  }
+  DIE_UNLESS(rc == MYSQL_NO_DATA);
+  DIE_UNLESS(num_rows == 5 && sum == 15);
+  mysql_stmt_close(stmt);
+
+  /* COMMIT closes the cursor */
+  prefetch_rows= 1;
+  stmt= mysql_stmt_init(mysql);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_CURSOR_TYPE, (void*) &type);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_PREFETCH_ROWS,
+                          (void*) &prefetch_rows);
+  check_execute(stmt, rc);
+  stmt_text= "SELECT a FROM t1";
+  rc= mysql_stmt_prepare(stmt, stmt_text, strlen(stmt_text));
+  check_execute(stmt, rc);
+  rc= mysql_stmt_bind_result(stmt, my_bind);
+  check_execute(stmt, rc);
+
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_fetch(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(a == 1);
+
+  rc= mysql_commit(mysql);
+  myquery(rc);
+  rc= mysql_stmt_fetch(stmt);
+  DIE_UNLESS(rc == 1 &&
+             mysql_stmt_errno(stmt) == ER_STMT_HAS_NO_OPEN_CURSOR);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_autocommit(mysql, TRUE);
+  myquery(rc);
+  rc= mysql_query(mysql, "DROP TABLE t1, t2");
+  myquery(rc);
+}
+
+
+/* Results stored with MYSQL_OPT_COMPACT_RESULT */
+
+static void test_compact_result()
+{
+  MYSQL_RES *result;
+  MYSQL_ROW row;
+  MYSQL_ROW_OFFSET offset;
+  ulong *lengths;
+  const char *values[2];
+  ulong value_lengths[2];
+  my_bool on= TRUE, off= FALSE;
+  int rc;
+  int num_rows= 0;
+
+  myheader("test_compact_result");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (a INT, b VARCHAR(10))");
+  myquery(rc);
+  rc= mysql_query(mysql, "INSERT INTO t1 VALUES "
+                         "(1, 'one'), (2, NULL), (3, ''), (4, 'four')");
+  myquery(rc);
+
+  rc= mysql_options(mysql, MYSQL_OPT_COMPACT_RESULT, &on);
+  DIE_UNLESS(rc == 0);
+  rc= mysql_query(mysql, "SELECT a, b FROM t1 ORDER BY a");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  DIE_UNLESS(mysql_num_rows(result) == 4);
+  DIE_UNLESS(mysql_fetch_fields(result)[1].max_length == 4);
+
+  while ((row= mysql_fetch_row(result)))
+  {
+    num_rows++;
+    DIE_UNLESS(atoi(row[0]) == num_rows);
+    lengths= mysql_fetch_lengths(result);
+    DIE_UNLESS(lengths[0] == 1);
+    switch (num_rows) {
+    case 1:
+      DIE_UNLESS(!strcmp(row[1], "one") && lengths[1] == 3);
+      break;
+    case 2:
+      DIE_UNLESS(row[1] == NULL && lengths[1] == 0);
+      break;
+    case 3:
+      DIE_UNLESS(!strcmp(row[1], "") && lengths[1] == 0);
+      break;
+    case 4:
+      DIE_UNLESS(!strcmp(row[1], "four") && lengths[1] == 4);
+      break;
+    }
+  }
+  DIE_UNLESS(num_rows == 4);
+
+  /* Seek, and read the values in place */
+  mysql_data_seek(result, 1);
+  offset= mysql_row_tell(result);
+  rc= mysql_fetch_row_view(result, values, value_lengths);
+  DIE_UNLESS(rc == 0);
+  DIE_UNLESS(value_lengths[0] == 1 && values[0][0] == '2');
+  DIE_UNLESS(values[1] == NULL);
+  rc= mysql_fetch_row_view(result, values, value_lengths);
+  DIE_UNLESS(rc == 0 && values[0][0] == '3');
+  DIE_UNLESS(values[1] != NULL && value_lengths[1] == 0);
+  rc= mysql_fetch_row_view(result, values, value_lengths);
+  DIE_UNLESS(rc == 0 && value_lengths[1] == 4);
+  DIE_UNLESS(!memcmp(values[1], "four", 4));
+  rc= mysql_fetch_row_view(result, values, value_lengths);
+  DIE_UNLESS(rc == 1);
+
+  mysql_row_seek(result, offset);
+  row= mysql_fetch_row(result);
+  DIE_UNLESS(row && atoi(row[0]) == 2);
+  mysql_free_result(result);
+
+  /* An empty result */
+  rc= mysql_query(mysql, "SELECT a FROM t1 WHERE a > 10");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  DIE_UNLESS(mysql_num_rows(result) == 0);
+  DIE_UNLESS(mysql_fetch_row(result) == NULL);
+  mysql_free_result(result);
+
+  rc= mysql_options(mysql, MYSQL_OPT_COMPACT_RESULT, &off);
+  DIE_UNLESS(rc == 0);
+
+  /* mysql_fetch_row_view() on other results */
+  rc= mysql_query(mysql, "SELECT a, b FROM t1 ORDER BY a");
+  myquery(rc);
+  result= mysql_store_result(mysql);
+  mytest(result);
+  rc= mysql_fetch_row_view(result, values, value_lengths);
+  DIE_UNLESS(rc == 0 && values[0][0] == '1' && value_lengths[1] == 3);
+  mysql_free_result(result);
+
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
+
+
 static struct my_tests_st my_tests[]= {
   { "disable_query_logs", disable_query_logs },
   { "test_view_sp_list_fields", test_view_sp_list_fields },
@@ -19709,6 +20141,10 @@ static struct my_tests_st my_tests[]= {
   { "test_wl5924", test_wl5924 },
   { "test_wl6587", test_wl6587 },
   { "test_wl5928", test_wl5928 },
+  { "test_nonblocking_api", test_nonblocking_api },
+  { "test_pipeline", test_pipeline },
+  { "test_streaming_cursor", test_streaming_cursor },
+  { "test_compact_result", test_compact_result },
   { 0, 0 }
 };
 
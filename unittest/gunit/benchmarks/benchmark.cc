@@ -0,0 +1,573 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include <my_sys.h>
+#include <my_rdtsc.h>
+#include <my_pthread.h>
+#include <m_string.h>
+#include <mysql_version.h>
+#include "mysql/psi/mysql_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace benchmark {
+
+/* Upper bound of the number of iterations of a run. */
+static const size_t MAX_ITERATIONS= 1000000000;
+
+State::State(size_t max_iterations, const std::vector<longlong> &args,
+             int thread_index, int threads)
+  : m_max_iterations(max_iterations), m_iterations(0), m_args(args),
+    m_thread_index(thread_index), m_threads(threads),
+    m_start(0), m_elapsed(0), m_running(false),
+    m_items_processed(0), m_bytes_processed(0)
+{}
+
+void State::start_timer()
+{
+  DBUG_ASSERT(!m_running);
+  m_start= my_timer_nanoseconds();
+  m_running= true;
+}
+
+void State::stop_timer()
+{
+  if (!m_running)
+    return;
+  m_elapsed+= my_timer_nanoseconds() - m_start;
+  m_running= false;
+}
+
+void State::PauseTiming()
+{
+  stop_timer();
+}
+
+void State::ResumeTiming()
+{
+  start_timer();
+}
+
+void ClobberMemory(const void *ptr)
+{
+  static const void *volatile sink;
+  sink= ptr;
+}
+
+
+Benchmark::Benchmark(const char *name, Function function)
+  : m_name(name), m_function(function), m_setup(NULL), m_teardown(NULL)
+{}
+
+Benchmark *Benchmark::Arg(longlong arg)
+{
+  m_args.push_back(std::vector<longlong>(1, arg));
+  return this;
+}
+
+Benchmark *Benchmark::ArgPair(longlong arg1, longlong arg2)
+{
+  std::vector<longlong> args;
+  args.push_back(arg1);
+  args.push_back(arg2);
+  m_args.push_back(args);
+  return this;
+}
+
+Benchmark *Benchmark::Range(longlong start, longlong limit)
+{
+  DBUG_ASSERT(start > 0 && start <= limit);
+  for (longlong arg= start; arg < limit; arg*= 8)
+    Arg(arg);
+  return Arg(limit);
+}
+
+Benchmark *Benchmark::Threads(int threads)
+{
+  DBUG_ASSERT(threads > 0);
+  m_threads.push_back(threads);
+  return this;
+}
+
+Benchmark *Benchmark::ThreadRange(int min_threads, int max_threads)
+{
+  DBUG_ASSERT(min_threads > 0 && min_threads <= max_threads);
+  for (int threads= min_threads; threads < max_threads; threads*= 2)
+    Threads(threads);
+  return Threads(max_threads);
+}
+
+Benchmark *Benchmark::ThreadPerCpu()
+{
+  int cpus= my_getncpus();
+  Threads(1);
+  if (cpus > 1)
+    Threads(cpus);
+  return this;
+}
+
+Benchmark *Benchmark::Setup(Fixture setup)
+{
+  m_setup= setup;
+  return this;
+}
+
+Benchmark *Benchmark::Teardown(Fixture teardown)
+{
+  m_teardown= teardown;
+  return this;
+}
+
+
+/*
+  The registered benchmarks.
+  A function local static, as benchmarks are registered
+  by the constructors of static variables of other files.
+*/
+static std::vector<Benchmark*> &registered_benchmarks()
+{
+  static std::vector<Benchmark*> benchmarks;
+  return benchmarks;
+}
+
+Benchmark *RegisterBenchmark(const char *name, Function function)
+{
+  Benchmark *benchmark= new Benchmark(name, function);
+  registered_benchmarks().push_back(benchmark);
+  return benchmark;
+}
+
+
+namespace {
+
+/** The options of the runner. */
+struct Options
+{
+  const char *filter;
+  bool json;
+  double min_time;
+  bool list;
+};
+
+/** One run of a benchmark: given arguments, on a given number of threads. */
+struct Run
+{
+  const Benchmark *benchmark;
+  std::string name;
+  std::vector<longlong> args;
+  int threads;
+};
+
+/** The result of a run, averaged over the threads. */
+struct Result
+{
+  size_t iterations;
+  double real_time;                     // Nanoseconds per iteration.
+  double items_per_second;
+  double bytes_per_second;
+  std::string label;
+};
+
+/**
+  The threads of a run.
+  The threads are started one by one, and wait until all are started
+  before they call the benchmark function, so that they run at the
+  same time, also for short runs.
+*/
+class Run_threads
+{
+public:
+  Run_threads(const Run &run, size_t iterations)
+    : m_run(run), m_iterations(iterations), m_ready(0), m_go(false)
+  {
+    mysql_mutex_init(PSI_NOT_INSTRUMENTED, &m_mutex, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(PSI_NOT_INSTRUMENTED, &m_cond, NULL);
+  }
+
+  ~Run_threads()
+  {
+    for (size_t i= 0; i < m_states.size(); i++)
+      delete m_states[i];
+    mysql_cond_destroy(&m_cond);
+    mysql_mutex_destroy(&m_mutex);
+  }
+
+  void run(Result *result);
+
+  static void *thread_start(void *arg);
+
+private:
+  struct Thread_arg
+  {
+    Run_threads *threads;
+    State *state;
+  };
+
+  const Run &m_run;
+  const size_t m_iterations;
+  std::vector<State*> m_states;
+
+  mysql_mutex_t m_mutex;
+  mysql_cond_t m_cond;
+  int m_ready;
+  bool m_go;
+};
+
+extern "C" void *benchmark_thread_start(void *arg)
+{
+  return Run_threads::thread_start(arg);
+}
+
+void *Run_threads::thread_start(void *arg)
+{
+  Thread_arg *thread_arg= static_cast<Thread_arg*>(arg);
+  Run_threads *self= thread_arg->threads;
+
+  my_thread_init();
+
+  mysql_mutex_lock(&self->m_mutex);
+  self->m_ready++;
+  mysql_cond_broadcast(&self->m_cond);
+  while (!self->m_go)
+    mysql_cond_wait(&self->m_cond, &self->m_mutex);
+  mysql_mutex_unlock(&self->m_mutex);
+
+  self->m_run.benchmark->function()(*thread_arg->state);
+
+  my_thread_end();
+  return NULL;
+}
+
+void Run_threads::run(Result *result)
+{
+  const int threads= m_run.threads;
+  std::vector<pthread_t> ids(threads);
+  std::vector<Thread_arg> thread_args(threads);
+
+  for (int i= 0; i < threads; i++)
+  {
+    m_states.push_back(new State(m_iterations, m_run.args, i, threads));
+    thread_args[i].threads= this;
+    thread_args[i].state= m_states[i];
+  }
+
+  if (threads == 1)
+  {
+    /* Run in the main thread, which makes profiling easier. */
+    m_run.benchmark->function()(*m_states[0]);
+  }
+  else
+  {
+    for (int i= 0; i < threads; i++)
+    {
+      if (pthread_create(&ids[i], NULL, benchmark_thread_start,
+                         &thread_args[i]))
+      {
+        fprintf(stderr, "Could not create thread %d of %s\n",
+                i, m_run.name.c_str());
+        exit(1);
+      }
+    }
+
+    mysql_mutex_lock(&m_mutex);
+    while (m_ready < threads)
+      mysql_cond_wait(&m_cond, &m_mutex);
+    m_go= true;
+    mysql_cond_broadcast(&m_cond);
+    mysql_mutex_unlock(&m_mutex);
+
+    for (int i= 0; i < threads; i++)
+      pthread_join(ids[i], NULL);
+  }
+
+  ulonglong elapsed= 0;
+  ulonglong items= 0;
+  ulonglong bytes= 0;
+  for (int i= 0; i < threads; i++)
+  {
+    elapsed+= m_states[i]->elapsed();
+    items+= m_states[i]->items_processed();
+    bytes+= m_states[i]->bytes_processed();
+  }
+
+  /* The mean time of the threads, which ran at the same time. */
+  double seconds= (double) elapsed / threads / 1e9;
+
+  result->iterations= m_iterations;
+  result->real_time= (double) elapsed / threads / m_iterations;
+  result->items_per_second= seconds > 0 ? items / seconds : 0;
+  result->bytes_per_second= seconds > 0 ? bytes / seconds : 0;
+  result->label= m_states[0]->label();
+}
+
+/**
+  Run a benchmark with more and more iterations,
+  until it runs for at least options.min_time seconds.
+*/
+void run_benchmark(const Run &run, const Options &options, Result *result)
+{
+  size_t iterations= 1;
+
+  for (;;)
+  {
+    if (run.benchmark->setup())
+      run.benchmark->setup()();
+    {
+      Run_threads run_threads(run, iterations);
+      run_threads.run(result);
+    }
+    if (run.benchmark->teardown())
+      run.benchmark->teardown()();
+
+    double seconds= result->real_time * iterations / 1e9;
+    if (seconds >= options.min_time || iterations >= MAX_ITERATIONS)
+      break;
+
+    /*
+      Aim 40% above the minimum time, so that we do not
+      stop just short of it, but grow by at most 10x
+      as the first runs are dominated by cache misses.
+    */
+    double multiplier= 10;
+    if (seconds > options.min_time / 10)
+      multiplier= options.min_time * 1.4 / seconds;
+    size_t next= (size_t) (iterations * multiplier);
+    if (next <= iterations)
+      next= iterations + 1;
+    iterations= MY_MIN(next, MAX_ITERATIONS);
+  }
+}
+
+/** All runs of the registered benchmarks, in registration order. */
+void make_runs(std::vector<Run> *runs, const char *filter)
+{
+  std::vector<Benchmark*> &benchmarks= registered_benchmarks();
+
+  for (size_t i= 0; i < benchmarks.size(); i++)
+  {
+    const Benchmark *benchmark= benchmarks[i];
+    std::vector<std::vector<longlong> > args= benchmark->args();
+    std::vector<int> threads= benchmark->threads();
+    bool name_threads= !threads.empty();
+
+    if (args.empty())
+      args.push_back(std::vector<longlong>());
+    if (threads.empty())
+      threads.push_back(1);
+
+    for (size_t a= 0; a < args.size(); a++)
+    {
+      for (size_t t= 0; t < threads.size(); t++)
+      {
+        Run run;
+        char buff[64];
+
+        run.benchmark= benchmark;
+        run.name= benchmark->name();
+        run.args= args[a];
+        run.threads= threads[t];
+        for (size_t j= 0; j < run.args.size(); j++)
+        {
+          my_snprintf(buff, sizeof(buff), "/%lld", run.args[j]);
+          run.name.append(buff);
+        }
+        if (name_threads)
+        {
+          my_snprintf(buff, sizeof(buff), "/threads:%d", run.threads);
+          run.name.append(buff);
+        }
+
+        if (filter == NULL || strstr(run.name.c_str(), filter) != NULL)
+          runs->push_back(run);
+      }
+    }
+  }
+}
+
+void print_json_string(const std::string &str)
+{
+  putchar('"');
+  for (size_t i= 0; i < str.size(); i++)
+  {
+    char c= str[i];
+    if (c == '"' || c == '\\')
+      putchar('\\');
+    if ((uchar) c < ' ')
+      printf("\\u%04x", (uint) (uchar) c);
+    else
+      putchar(c);
+  }
+  putchar('"');
+}
+
+/*
+  The JSON output has the same keys, in the same order, for every run,
+  and no time stamps, so that the output of two runs can be compared
+  with diff, and stored as is by tools tracking the results over time.
+*/
+void print_json_header(const Options &options)
+{
+  printf("{\n");
+  printf("  \"context\": {\n");
+  printf("    \"mysql_version\": \"%s\",\n", MYSQL_SERVER_VERSION);
+#ifndef DBUG_OFF
+  printf("    \"build_type\": \"debug\",\n");
+#else
+  printf("    \"build_type\": \"release\",\n");
+#endif
+  printf("    \"num_cpus\": %d,\n", my_getncpus());
+  printf("    \"min_time\": %.3f\n", options.min_time);
+  printf("  },\n");
+  printf("  \"benchmarks\": [");
+}
+
+void print_json_result(const Run &run, const Result &result, bool first)
+{
+  printf("%s\n    {\n", first ? "" : ",");
+  printf("      \"name\": ");
+  print_json_string(run.name);
+  printf(",\n");
+  printf("      \"threads\": %d,\n", run.threads);
+  printf("      \"iterations\": %lu,\n", (ulong) result.iterations);
+  printf("      \"real_time\": %.1f,\n", result.real_time);
+  printf("      \"time_unit\": \"ns\",\n");
+  printf("      \"items_per_second\": %.0f,\n", result.items_per_second);
+  printf("      \"bytes_per_second\": %.0f,\n", result.bytes_per_second);
+  printf("      \"label\": ");
+  print_json_string(result.label);
+  printf("\n    }");
+}
+
+void print_json_footer()
+{
+  printf("\n  ]\n}\n");
+}
+
+void print_console_header(size_t name_width)
+{
+  printf("%-*s %14s %12s %14s %s\n", (int) name_width,
+         "Benchmark", "Time(ns)", "Iterations", "Items/s", "Label");
+  for (size_t i= 0; i < name_width + 57; i++)
+    putchar('-');
+  putchar('\n');
+}
+
+void print_console_result(const Run &run, const Result &result,
+                          size_t name_width)
+{
+  printf("%-*s %14.1f %12lu %14.0f %s\n", (int) name_width, run.name.c_str(),
+         result.real_time, (ulong) result.iterations,
+         result.items_per_second, result.label.c_str());
+}
+
+void usage(const char *progname)
+{
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --filter=<substring>  Only run benchmarks with names containing"
+          " <substring>.\n"
+          "  --format=console|json Output format, default console.\n"
+          "  --min-time=<seconds>  Minimum time of each run, default 0.5.\n"
+          "  --list                List the benchmarks without running them.\n",
+          progname);
+}
+
+bool parse_options(int argc, char **argv, Options *options)
+{
+  options->filter= NULL;
+  options->json= false;
+  options->min_time= 0.5;
+  options->list= false;
+
+  for (int i= 1; i < argc; i++)
+  {
+    const char *arg= argv[i];
+    if (is_prefix(arg, "--filter="))
+      options->filter= arg + strlen("--filter=");
+    else if (!strcmp(arg, "--format=json"))
+      options->json= true;
+    else if (!strcmp(arg, "--format=console"))
+      options->json= false;
+    else if (is_prefix(arg, "--min-time="))
+    {
+      options->min_time= atof(arg + strlen("--min-time="));
+      if (options->min_time <= 0)
+      {
+        fprintf(stderr, "%s: --min-time must be positive\n", argv[0]);
+        return true;
+      }
+    }
+    else if (!strcmp(arg, "--list"))
+      options->list= true;
+    else
+    {
+      fprintf(stderr, "%s: unknown option '%s'\n", argv[0], arg);
+      usage(argv[0]);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+int RunSpecifiedBenchmarks(int argc, char **argv)
+{
+  Options options;
+  std::vector<Run> runs;
+
+  if (parse_options(argc, argv, &options))
+    return 1;
+
+  make_runs(&runs, options.filter);
+
+  if (options.list)
+  {
+    for (size_t i= 0; i < runs.size(); i++)
+      printf("%s\n", runs[i].name.c_str());
+    return 0;
+  }
+
+  size_t name_width= 10;
+  for (size_t i= 0; i < runs.size(); i++)
+    name_width= MY_MAX(name_width, runs[i].name.size());
+
+  if (options.json)
+    print_json_header(options);
+  else
+    print_console_header(name_width);
+
+  for (size_t i= 0; i < runs.size(); i++)
+  {
+    Result result;
+    run_benchmark(runs[i], options, &result);
+    if (options.json)
+      print_json_result(runs[i], result, i == 0);
+    else
+      print_console_result(runs[i], result, name_width);
+    fflush(stdout);
+  }
+
+  if (options.json)
+    print_json_footer();
+  return 0;
+}
+
+} // namespace benchmark
@@ -0,0 +1,206 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+#ifndef BENCHMARK_INCLUDED
+#define BENCHMARK_INCLUDED
+
+/**
+  @file unittest/gunit/benchmarks/benchmark.h
+
+  A small microbenchmark runner, with an interface modelled after
+  google benchmark, so that benchmarks can be moved over to it unchanged
+  should it ever become a build dependency.
+
+  A benchmark is a function which repeats the code to be measured
+  while State::KeepRunning() returns true:
+
+  @code
+  static void BM_something(benchmark::State &state)
+  {
+    Something thing(state.range(0));            // Not measured.
+    while (state.KeepRunning())
+      benchmark::DoNotOptimize(thing.do_it());   // Measured.
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_something)->Arg(8)->Arg(64)->Threads(1)->Threads(4);
+  @endcode
+
+  The runner increases the number of iterations until a run takes
+  at least --min-time seconds. With Threads(n), n threads run
+  the function at the same time, each with its own State,
+  and are released together once all of them have been started.
+  The time is measured in each thread, from the first call to
+  KeepRunning() until it returns false, so that setup and cleanup
+  code outside of the loop is not measured.
+*/
+
+#include <my_global.h>
+#include <vector>
+#include <string>
+
+namespace benchmark {
+
+class State
+{
+public:
+  State(size_t max_iterations, const std::vector<longlong> &args,
+        int thread_index, int threads);
+
+  /**
+    Returns true as long as the function should run one more iteration.
+    The timer is started by the first call and stopped by the last one.
+  */
+  bool KeepRunning()
+  {
+    if (likely(m_iterations < m_max_iterations))
+    {
+      if (unlikely(m_iterations == 0))
+        start_timer();
+      m_iterations++;
+      return true;
+    }
+    stop_timer();
+    return false;
+  }
+
+  /** Stop measuring, e.g. while preparing the input of the next iteration. */
+  void PauseTiming();
+  /** Continue measuring, after PauseTiming(). */
+  void ResumeTiming();
+
+  /** The i-th argument given by Arg() or ArgPair(). */
+  longlong range(size_t i= 0) const { return m_args[i]; }
+  /** Index of the calling thread, 0 .. threads - 1. */
+  int thread_index() const { return m_thread_index; }
+  /** Number of threads running the function. */
+  int threads() const { return m_threads; }
+  /** Number of iterations each thread runs. */
+  size_t iterations() const { return m_max_iterations; }
+
+  /** Number of items (rows, keys, locks...) processed by this thread. */
+  void SetItemsProcessed(ulonglong items) { m_items_processed= items; }
+  /** Number of bytes processed by this thread. */
+  void SetBytesProcessed(ulonglong bytes) { m_bytes_processed= bytes; }
+  /** A label, printed after the results, e.g. the collation name. */
+  void SetLabel(const char *label) { m_label= label; }
+
+  /** Measured time, in nanoseconds. */
+  ulonglong elapsed() const { return m_elapsed; }
+  ulonglong items_processed() const { return m_items_processed; }
+  ulonglong bytes_processed() const { return m_bytes_processed; }
+  const std::string &label() const { return m_label; }
+
+private:
+  void start_timer();
+  void stop_timer();
+
+  const size_t m_max_iterations;
+  size_t m_iterations;
+  const std::vector<longlong> &m_args;
+  const int m_thread_index;
+  const int m_threads;
+
+  ulonglong m_start;
+  ulonglong m_elapsed;
+  bool m_running;
+  ulonglong m_items_processed;
+  ulonglong m_bytes_processed;
+  std::string m_label;
+};
+
+typedef void (*Function)(State &state);
+typedef void (*Fixture)();
+
+/**
+  A registered benchmark, and the runs it is made of:
+  one run per argument (or argument pair) and number of threads.
+*/
+class Benchmark
+{
+public:
+  Benchmark(const char *name, Function function);
+
+  /** Run with state.range(0) == arg. */
+  Benchmark *Arg(longlong arg);
+  /** Run with state.range(0) == arg1 and state.range(1) == arg2. */
+  Benchmark *ArgPair(longlong arg1, longlong arg2);
+  /** Run with arguments start, start * 8, ... up to and including limit. */
+  Benchmark *Range(longlong start, longlong limit);
+  /** Run on the given number of threads. */
+  Benchmark *Threads(int threads);
+  /** Run on 1, 2, 4 ... threads, up to and including max_threads. */
+  Benchmark *ThreadRange(int min_threads, int max_threads);
+  /** Run on 1 thread, and on as many threads as there are CPUs. */
+  Benchmark *ThreadPerCpu();
+  /**
+    Functions called by the runner before and after each run,
+    outside of the threads, e.g. to initialize a subsystem
+    shared by the threads.
+  */
+  Benchmark *Setup(Fixture setup);
+  Benchmark *Teardown(Fixture teardown);
+
+  const std::string &name() const { return m_name; }
+  Function function() const { return m_function; }
+  const std::vector<std::vector<longlong> > &args() const { return m_args; }
+  const std::vector<int> &threads() const { return m_threads; }
+  Fixture setup() const { return m_setup; }
+  Fixture teardown() const { return m_teardown; }
+
+private:
+  std::string m_name;
+  Function m_function;
+  std::vector<std::vector<longlong> > m_args;
+  std::vector<int> m_threads;
+  Fixture m_setup;
+  Fixture m_teardown;
+};
+
+/** Register a benchmark. Use the BENCHMARK() macro instead. */
+Benchmark *RegisterBenchmark(const char *name, Function function);
+
+/**
+  Run the registered benchmarks, as selected by the command line options:
+  --filter=<substring>, --format=console|json, --min-time=<seconds>
+  and --list.
+  @return exit code of the program
+*/
+int RunSpecifiedBenchmarks(int argc, char **argv);
+
+/** Prevent the compiler from optimizing away writes to memory. */
+void ClobberMemory(const void *ptr= NULL);
+
+/** Prevent the compiler from optimizing away the computation of value. */
+template <class T>
+inline void DoNotOptimize(const T &value)
+{
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  ClobberMemory(&value);
+#endif
+}
+
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT2(a, b) a ## b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+
+#define BENCHMARK(function)                                             \
+  static benchmark::Benchmark *                                         \
+  BENCHMARK_CONCAT(benchmark_registration_, __LINE__) __attribute__((unused))= \
+    benchmark::RegisterBenchmark(#function, function)
+
+#endif  // BENCHMARK_INCLUDED
@@ -0,0 +1,79 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include "filesort_utils.h"
+#include "sql_sort.h"
+#include <myisampack.h>
+
+/*
+  Sorting the keys in the sort buffer, the CPU bound part of filesort,
+  on one or more threads.
+*/
+namespace filesort_buffer_benchmark {
+
+using benchmark::State;
+
+/* A key of an INT and a short latin1 string, as made by make_sortkey(). */
+const uint RECORD_LENGTH= 4 + 16;
+
+/**
+  Sort state.range(0) keys, with Sort_param::sort_threads == state.range(1).
+  The keys are filled with new random values before every sort,
+  which is not measured.
+*/
+void BM_filesort_sort_buffer(State &state)
+{
+  const uint num_records= static_cast<uint>(state.range(0));
+  Filesort_buffer fs_info;
+  Sort_param param;
+  uint32 seed= 2463534242U;
+
+  fs_info.alloc_sort_buffer(num_records, RECORD_LENGTH);
+  fs_info.init_record_pointers();
+  param.sort_length= RECORD_LENGTH;
+  param.sort_threads= static_cast<uint>(state.range(1));
+
+  while (state.KeepRunning())
+  {
+    state.PauseTiming();
+    for (uint ix= 0; ix < num_records; ++ix)
+    {
+      uchar *ptr= fs_info.get_record_buffer(ix);
+      for (uint i= 0; i < RECORD_LENGTH; i+= 4)
+      {
+        seed^= seed << 13;
+        seed^= seed >> 17;
+        seed^= seed << 5;
+        /* Few distinct values in the first column, as in real keys. */
+        mi_int4store(ptr + i, i == 0 ? seed % 1000 : seed);
+      }
+    }
+    state.ResumeTiming();
+
+    fs_info.sort_buffer(&param, num_records);
+  }
+
+  fs_info.free_sort_buffer();
+  state.SetItemsProcessed(state.iterations() * num_records);
+}
+BENCHMARK(BM_filesort_sort_buffer)->
+  ArgPair(1000, 1)->ArgPair(100000, 1)->ArgPair(100000, 4)->
+  ArgPair(1000000, 1)->ArgPair(1000000, 4);
+
+}  // namespace filesort_buffer_benchmark
@@ -0,0 +1,159 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include "rpl_gtid.h"
+#include <vector>
+
+/*
+  GTID sets, as updated by every commit when GTID_MODE is ON,
+  and tested by every transaction applied by a slave.
+*/
+namespace gtid_set_benchmark {
+
+using benchmark::State;
+
+const char uuid[]= "24da167a-c0b1-11e3-93ec-0024e8441d92";
+
+/* Add GTIDs in commit order, as to gtid_executed. */
+void BM_gtid_set_add_gtid(State &state)
+{
+  Sid_map sid_map(NULL);
+  Gtid_set set(&sid_map, NULL);
+  rpl_sid sid;
+  rpl_gno gno= 0;
+
+  sid.parse(uuid);
+  rpl_sidno sidno= sid_map.add_sid(sid);
+  set.ensure_sidno(sidno);
+
+  while (state.KeepRunning())
+    set._add_gtid(sidno, ++gno);
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gtid_set_add_gtid);
+
+/*
+  Add GTIDs slightly out of commit order, as committed by a
+  multi-threaded slave: every other GTID first, then the gaps.
+*/
+void BM_gtid_set_add_gtid_out_of_order(State &state)
+{
+  Sid_map sid_map(NULL);
+  Gtid_set set(&sid_map, NULL);
+  rpl_sid sid;
+  rpl_gno base= 0;
+  rpl_gno n= 0;
+
+  sid.parse(uuid);
+  rpl_sidno sidno= sid_map.add_sid(sid);
+  set.ensure_sidno(sidno);
+
+  while (state.KeepRunning())
+  {
+    set._add_gtid(sidno, base + 2 * (n % 32) + (n >= 32) + 1);
+    if (++n == 64)
+    {
+      base+= 64;
+      n= 0;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gtid_set_add_gtid_out_of_order);
+
+/*
+  A set of state.range(0) intervals of 5 GTIDs, with gaps of 5 GTIDs,
+  as left by transactions that were skipped or filtered out.
+*/
+void make_set(Gtid_set *set, Sid_map *sid_map, rpl_sidno *sidno,
+              longlong intervals)
+{
+  rpl_sid sid;
+  sid.parse(uuid);
+  *sidno= sid_map->add_sid(sid);
+  set->ensure_sidno(*sidno);
+  for (rpl_gno gno= 1; gno <= intervals * 10; gno++)
+    if (gno % 10 <= 5 && gno % 10 != 0)
+      set->_add_gtid(*sidno, gno);
+}
+
+/* Test GTIDs, found or not, as the slave does for every transaction. */
+void BM_gtid_set_contains_gtid(State &state)
+{
+  Sid_map sid_map(NULL);
+  Gtid_set set(&sid_map, NULL);
+  rpl_sidno sidno;
+  const rpl_gno max_gno= static_cast<rpl_gno>(state.range(0) * 10);
+  rpl_gno gno= 0;
+
+  make_set(&set, &sid_map, &sidno, state.range(0));
+
+  while (state.KeepRunning())
+  {
+    gno= gno % max_gno + 7;
+    benchmark::DoNotOptimize(set.contains_gtid(sidno, gno));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gtid_set_contains_gtid)->Arg(1)->Arg(64)->Arg(1024);
+
+/* Format the set as text, as for @@GLOBAL.GTID_EXECUTED. */
+void BM_gtid_set_to_string(State &state)
+{
+  Sid_map sid_map(NULL);
+  Gtid_set set(&sid_map, NULL);
+  rpl_sidno sidno;
+
+  make_set(&set, &sid_map, &sidno, state.range(0));
+  std::vector<char> buf(set.get_string_length() + 1);
+
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(set.to_string(&buf[0]));
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * (buf.size() - 1));
+}
+BENCHMARK(BM_gtid_set_to_string)->Arg(1)->Arg(64)->Arg(1024);
+
+/* Parse the text of a set, as for SET GTID_PURGED. */
+void BM_gtid_set_add_gtid_text(State &state)
+{
+  Sid_map sid_map(NULL);
+  Gtid_set set(&sid_map, NULL);
+  rpl_sidno sidno;
+
+  make_set(&set, &sid_map, &sidno, state.range(0));
+  std::vector<char> text(set.get_string_length() + 1);
+  set.to_string(&text[0]);
+
+  while (state.KeepRunning())
+  {
+    Gtid_set parsed(&sid_map, NULL);
+    parsed.add_gtid_text(&text[0]);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * (text.size() - 1));
+}
+BENCHMARK(BM_gtid_set_add_gtid_text)->Arg(1)->Arg(64)->Arg(1024);
+
+}  // namespace gtid_set_benchmark
@@ -0,0 +1,104 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include <my_sys.h>
+#include <lf.h>
+
+/*
+  The lock free hash, as used by the MDL subsystem, the table
+  definition cache and the performance schema, from many threads.
+*/
+namespace lf_hash_benchmark {
+
+using benchmark::State;
+
+/* Number of elements in the hash while searching. */
+const int32 N_KEYS= 100000;
+
+LF_HASH lf_hash;
+
+/* A small, per thread, pseudo random number generator. */
+uint32 next_random(uint32 *seed)
+{
+  *seed^= *seed << 13;
+  *seed^= *seed >> 17;
+  *seed^= *seed << 5;
+  return *seed;
+}
+
+void setup()
+{
+  lf_hash_init(&lf_hash, sizeof(int32), LF_HASH_UNIQUE, 0, sizeof(int32), 0,
+               &my_charset_bin);
+
+  LF_PINS *pins= lf_hash_get_pins(&lf_hash);
+  for (int32 key= 0; key < N_KEYS; key++)
+    lf_hash_insert(&lf_hash, pins, &key);
+  lf_hash_put_pins(pins);
+}
+
+void teardown()
+{
+  lf_hash_destroy(&lf_hash);
+}
+
+/* Look up keys which are in the hash, in random order. */
+void BM_lf_hash_search(State &state)
+{
+  LF_PINS *pins= lf_hash_get_pins(&lf_hash);
+  uint32 seed= 2463534242U + state.thread_index();
+
+  while (state.KeepRunning())
+  {
+    int32 key= next_random(&seed) % N_KEYS;
+    benchmark::DoNotOptimize(lf_hash_search(&lf_hash, pins, &key, sizeof(key)));
+    lf_hash_search_unpin(pins);
+  }
+
+  lf_hash_put_pins(pins);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_lf_hash_search)->ThreadRange(1, 16)->
+  Setup(setup)->Teardown(teardown);
+
+/*
+  Insert and delete keys which are not in the hash,
+  different keys in every thread.
+*/
+void BM_lf_hash_insert_delete(State &state)
+{
+  LF_PINS *pins= lf_hash_get_pins(&lf_hash);
+  const int32 first_key= N_KEYS + state.thread_index() * 1024;
+  int32 key= first_key;
+
+  while (state.KeepRunning())
+  {
+    lf_hash_insert(&lf_hash, pins, &key);
+    lf_hash_delete(&lf_hash, pins, &key, sizeof(key));
+    if (++key == first_key + 1024)
+      key= first_key;
+  }
+
+  lf_hash_put_pins(pins);
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_lf_hash_insert_delete)->ThreadRange(1, 16)->
+  Setup(setup)->Teardown(teardown);
+
+}  // namespace lf_hash_benchmark
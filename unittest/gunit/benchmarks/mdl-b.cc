@@ -0,0 +1,144 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include "mdl.h"
+#include "test_mdl_context_owner.h"
+
+/*
+  Mock thd_wait_begin/end functions
+*/
+
+extern "C" void thd_wait_begin(MYSQL_THD thd, int wait_type)
+{
+}
+
+extern "C" void thd_wait_end(MYSQL_THD thd)
+{
+}
+
+/*
+  Mock away this global function.
+  We don't need DEBUG_SYNC functionality in a benchmark.
+*/
+void debug_sync(THD *thd, const char *sync_point_name, size_t name_len)
+{
+}
+
+/*
+  Metadata locks, as taken and released by every statement
+  for every table it uses.
+*/
+namespace mdl_benchmark {
+
+using benchmark::State;
+
+const char db_name[]= "some_database";
+const ulong long_timeout= 100000;
+
+class Benchmark_MDL_context_owner : public Test_MDL_context_owner
+{
+public:
+  virtual bool notify_shared_lock(MDL_context_owner *in_use,
+                                  bool needs_thr_lock_abort)
+  {
+    return false;
+  }
+};
+
+void setup()
+{
+  mdl_locks_hash_partitions= MDL_LOCKS_HASH_PARTITIONS_DEFAULT;
+  mdl_init();
+}
+
+void teardown()
+{
+  mdl_destroy();
+}
+
+/**
+  Name of the table locked by the calling thread:
+  the same table in all threads with state.range(0) == 0,
+  a table per thread otherwise.
+*/
+void table_name(const State &state, char *buff, size_t size)
+{
+  my_snprintf(buff, size, "some_table%d",
+              state.range(0) ? state.thread_index() : 0);
+}
+
+/* A SELECT: a shared read lock on the table. */
+void BM_mdl_acquire_release_read(State &state)
+{
+  Benchmark_MDL_context_owner owner;
+  MDL_context mdl_context;
+  MDL_request request;
+  char name[NAME_LEN];
+
+  mdl_context.init(&owner);
+  table_name(state, name, sizeof(name));
+
+  while (state.KeepRunning())
+  {
+    request.init(MDL_key::TABLE, db_name, name, MDL_SHARED_READ,
+                 MDL_TRANSACTION);
+    mdl_context.acquire_lock(&request, long_timeout);
+    mdl_context.release_transactional_locks();
+  }
+
+  mdl_context.destroy();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_mdl_acquire_release_read)->
+  Arg(0)->Arg(1)->ThreadRange(1, 16)->Setup(setup)->Teardown(teardown);
+
+/*
+  A DML statement: the global intention exclusive lock,
+  and a shared write lock on the table.
+*/
+void BM_mdl_acquire_release_write(State &state)
+{
+  Benchmark_MDL_context_owner owner;
+  MDL_context mdl_context;
+  MDL_request global_request;
+  MDL_request request;
+  char name[NAME_LEN];
+
+  mdl_context.init(&owner);
+  table_name(state, name, sizeof(name));
+
+  while (state.KeepRunning())
+  {
+    global_request.init(MDL_key::GLOBAL, "", "", MDL_INTENTION_EXCLUSIVE,
+                        MDL_STATEMENT);
+    request.init(MDL_key::TABLE, db_name, name, MDL_SHARED_WRITE,
+                 MDL_TRANSACTION);
+    mdl_context.acquire_lock(&global_request, long_timeout);
+    mdl_context.acquire_lock(&request, long_timeout);
+    mdl_context.release_statement_locks();
+    mdl_context.release_transactional_locks();
+  }
+
+  mdl_context.destroy();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_mdl_acquire_release_write)->
+  Arg(0)->Arg(1)->ThreadRange(1, 16)->Setup(setup)->Teardown(teardown);
+
+}  // namespace mdl_benchmark
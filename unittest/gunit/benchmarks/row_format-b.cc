@@ -0,0 +1,126 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include "field.h"
+#include "table.h"
+
+/*
+  Conversion of rows between the record format of the server
+  and the packed format of row based replication events,
+  column by column with Field::pack() and Field::unpack().
+*/
+namespace row_format_benchmark {
+
+using benchmark::State;
+
+/*
+  A row of (INT NOT NULL, BIGINT, VARCHAR(64) CHARACTER SET utf8)
+  in a record buffer, and the same columns over a second buffer.
+*/
+class Row
+{
+public:
+  static const size_t VARCHAR_LENGTH= 64 * 3;
+  static const size_t RECORD_LENGTH= 1 + 4 + 8 + 1 + VARCHAR_LENGTH;
+
+  Row(uchar *record)
+    : m_int(record + 1, 11, NULL, 0, Field::NONE, "a", false, false),
+      m_bigint(record + 5, 20, record, 1, Field::NONE, "b", false, false),
+      m_varchar(record + 13, VARCHAR_LENGTH, 1, NULL, 0, Field::NONE, "c",
+                &m_share, &my_charset_utf8_general_ci)
+  {
+    m_fields[0]= &m_int;
+    m_fields[1]= &m_bigint;
+    m_fields[2]= &m_varchar;
+  }
+
+  static const int FIELDS= 3;
+  Field *m_fields[FIELDS];
+
+private:
+  TABLE_SHARE m_share;
+  Field_long m_int;
+  Field_longlong m_bigint;
+  Field_varstring m_varchar;
+};
+
+/* Fill a record with a row where the string has string_length bytes. */
+void fill_record(uchar *record, size_t string_length)
+{
+  memset(record, 0, Row::RECORD_LENGTH);
+  int4store(record + 1, 123456);
+  int8store(record + 5, 1234567890123LL);
+  record[13]= static_cast<uchar>(string_length);
+  memset(record + 14, 'x', string_length);
+}
+
+/* Pack a row into a row image, as when writing a Write_rows event. */
+void BM_row_pack(State &state)
+{
+  uchar record[Row::RECORD_LENGTH];
+  uchar image[Row::RECORD_LENGTH];
+  Row row(record);
+  uchar *end= image;
+
+  fill_record(record, static_cast<size_t>(state.range(0)));
+
+  while (state.KeepRunning())
+  {
+    uchar *to= image;
+    for (int i= 0; i < Row::FIELDS; i++)
+      to= row.m_fields[i]->pack(to, row.m_fields[i]->ptr, UINT_MAX, true);
+    end= to;
+    benchmark::ClobberMemory(image);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * (end - image));
+}
+BENCHMARK(BM_row_pack)->Arg(0)->Arg(16)->Arg(Row::VARCHAR_LENGTH);
+
+/* Unpack a row image into a record, as when applying a Write_rows event. */
+void BM_row_unpack(State &state)
+{
+  uchar record[Row::RECORD_LENGTH];
+  uchar image[Row::RECORD_LENGTH];
+  uchar to_record[Row::RECORD_LENGTH];
+  Row row(record);
+  uchar *end= image;
+
+  fill_record(record, static_cast<size_t>(state.range(0)));
+  for (int i= 0; i < Row::FIELDS; i++)
+    end= row.m_fields[i]->pack(end, row.m_fields[i]->ptr, UINT_MAX, true);
+
+  while (state.KeepRunning())
+  {
+    const uchar *from= image;
+    for (int i= 0; i < Row::FIELDS; i++)
+    {
+      Field *field= row.m_fields[i];
+      from= field->unpack(to_record + (field->ptr - record), from, 0, true);
+    }
+    benchmark::ClobberMemory(to_record);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * (end - image));
+}
+BENCHMARK(BM_row_unpack)->Arg(0)->Arg(16)->Arg(Row::VARCHAR_LENGTH);
+
+}  // namespace row_format_benchmark
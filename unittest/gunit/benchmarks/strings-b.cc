@@ -0,0 +1,101 @@
+/* Copyright (c) 2014, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include "benchmark.h"
+
+#include <m_ctype.h>
+#include <my_sys.h>
+#include <string>
+#include <vector>
+
+/*
+  Sort keys of strings, as made by filesort and by the MEMORY and
+  MyISAM index code for every string in every row.
+*/
+namespace strings_benchmark {
+
+using benchmark::State;
+
+/* Text of words of varying length, with some non-ASCII letters. */
+const char ascii_text[]=
+  "The quick brown fox jumps over the lazy dog while "
+  "Sphinx of black quartz judges my vow. ";
+const char utf8_text[]=
+  "The quick brown fox jumps over the lazy dog while "
+  "Fl\xc3\xbcgel, K\xc3\xa4se und Stra\xc3\x9f" "e kosten 5 \xe2\x82\xac. ";
+
+/**
+  Run my_strnxfrm() on a string of state.range(0) characters,
+  into a buffer as large as filesort would use for a column
+  of that many characters.
+*/
+void strnxfrm(State &state, const char *collation, const char *text)
+{
+  CHARSET_INFO *cs= get_charset_by_name(collation, MYF(0));
+  if (cs == NULL)
+  {
+    while (state.KeepRunning())
+    {}
+    state.SetLabel("collation not available");
+    return;
+  }
+
+  const size_t nchars= static_cast<size_t>(state.range(0));
+  std::string src;
+  while (src.size() < nchars * cs->mbmaxlen)
+    src.append(text);
+  src.resize(cs->cset->charpos(cs, src.data(), src.data() + src.size(),
+                               nchars));
+
+  const size_t dst_length= cs->coll->strnxfrmlen(cs, nchars * cs->mbmaxlen);
+  std::vector<uchar> dst(dst_length);
+  const uchar *src_ptr= reinterpret_cast<const uchar*>(src.data());
+
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(my_strnxfrm(cs, &dst[0], dst_length,
+                                         src_ptr, src.size()));
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * src.size());
+  state.SetLabel(collation);
+}
+
+void BM_strnxfrm_latin1_swedish_ci(State &state)
+{
+  strnxfrm(state, "latin1_swedish_ci", ascii_text);
+}
+BENCHMARK(BM_strnxfrm_latin1_swedish_ci)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_strnxfrm_utf8_general_ci(State &state)
+{
+  strnxfrm(state, "utf8_general_ci", utf8_text);
+}
+BENCHMARK(BM_strnxfrm_utf8_general_ci)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_strnxfrm_utf8mb4_bin(State &state)
+{
+  strnxfrm(state, "utf8mb4_bin", utf8_text);
+}
+BENCHMARK(BM_strnxfrm_utf8mb4_bin)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_strnxfrm_utf8mb4_unicode_ci(State &state)
+{
+  strnxfrm(state, "utf8mb4_unicode_ci", utf8_text);
+}
+BENCHMARK(BM_strnxfrm_utf8mb4_unicode_ci)->Arg(8)->Arg(64)->Arg(1024);
+
+}  // namespace strings_benchmark
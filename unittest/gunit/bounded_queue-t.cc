@@ -21,6 +21,7 @@
 
 #include "bounded_queue.h"
 #include "filesort_utils.h"
+#include "sql_sort.h"
 #include "my_sys.h"
 
 namespace bounded_queue_unittest {
@@ -311,6 +312,23 @@ TEST(CostEstimationTest, MergeManyBuff)
 }
 
 
+/*
+  A test of the function merge_fanin()
+ */
+TEST(CostEstimationTest, MergeFanin)
+{
+  // Small sort buffers merge as many buffers as before.
+  EXPECT_EQ(static_cast<uint>(MERGEBUFF2), merge_fanin(100, 100));
+  EXPECT_EQ(static_cast<uint>(MERGEBUFF2), merge_fanin(2621, 100));
+  // Larger ones give each buffer MERGE_RUN_BUFFER_SIZE bytes ...
+  EXPECT_EQ(64U, merge_fanin(MERGE_RUN_BUFFER_SIZE * 64 / 128, 128));
+  // ... and at least MERGEBUFF keys.
+  EXPECT_EQ(1000U, merge_fanin(MERGEBUFF * 1000, MERGE_RUN_BUFFER_SIZE));
+  EXPECT_EQ(static_cast<uint>(MERGEBUFF_MAX),
+            merge_fanin(100000000, 100));
+}
+
+
 /*
   Comparison function for integers.
  */
@@ -94,6 +94,12 @@ void dump_decimal(decimal_t *d)
 #define test_d2ll(p1, p2, p3) \
   { SCOPED_TRACE(""); do_test_d2ll(p1, p2, p3); }
 
+#define test_d2sll(p1, p2, p3, p4) \
+  { SCOPED_TRACE(""); do_test_d2sll(p1, p2, p3, p4); }
+
+#define test_b2sll(p1, p2, p3, p4) \
+  { SCOPED_TRACE(""); do_test_b2sll(p1, p2, p3, p4); }
+
 #define test_da(p1, p2, p3, p4) \
   { SCOPED_TRACE(""); do_test_da(p1, p2, p3, p4); }
 
@@ -308,6 +314,43 @@ void do_test_d2ll(const char *s, const char *orig, int ex)
   }
 }
 
+void do_test_d2sll(const char *s, int scale, const char *orig, int ex)
+{
+  char s1[100], *end;
+  char s2[100];
+  longlong x= 0;
+  int res;
+
+  end= strend(s);
+  string2decimal(s, &a, &end);
+  res=decimal2scaled_longlong(&a, &x, scale);
+  longlong10_to_str(x,s1,-10);
+  sprintf(s2, "%-40s {%2d} => res=%d    %s\n", s, scale, res, s1);
+  check_result_code(res, ex);
+  if (orig)
+  {
+    EXPECT_STREQ(orig, s1) << " arguments were: " << s2;
+  }
+}
+
+void do_test_b2sll(const char *s, int p, int scale, const char *orig)
+{
+  char s1[100], *end;
+  char s2[100];
+  uchar buf[100];
+  longlong x= 0;
+  int res;
+
+  end= strend(s);
+  string2decimal(s, &a, &end);
+  decimal2bin(&a, buf, p, scale);
+  res=bin2scaled_longlong(buf, &x, p, scale);
+  longlong10_to_str(x,s1,-10);
+  sprintf(s2, "%-40s {%2d, %2d} => res=%d    %s\n", s, p, scale, res, s1);
+  check_result_code(res, 0);
+  EXPECT_STREQ(orig, s1) << " arguments were: " << s2;
+}
+
 void do_test_da(const char *s1, const char *s2, const char *orig, int ex)
 {
   char s[100], *end;
@@ -583,6 +626,32 @@ TEST_F(DecimalTest, Decimal2Longlong)
 }
 
 
+TEST_F(DecimalTest, Decimal2ScaledLonglong)
+{
+  test_d2sll("-10.55", 2, "-1055", 0);
+  test_d2sll("10.5", 2, "1050", 0);
+  test_d2sll("0", 4, "0", 0);
+  test_d2sll("123456789.123456789", 9, "123456789123456789", 0);
+  test_d2sll("-0.000000012345", 12, "-12345", 0);
+  test_d2sll("999999999999999999", 0, "999999999999999999", 0);
+  test_d2sll("1000000000000000000", 0, "0", 2);
+  test_d2sll("12345678901.23", 8, "0", 2);
+  test_d2sll("1.234", 2, "0", 1);
+}
+
+
+TEST_F(DecimalTest, Bin2ScaledLonglong)
+{
+  test_b2sll("-10.55", 4, 2, "-1055");
+  test_b2sll("12345", 10, 3, "12345000");
+  test_b2sll("-123.45", 18, 10, "-1234500000000");
+  test_b2sll("0.000000001", 18, 17, "100000000");
+  test_b2sll("999999999999999999", 18, 0, "999999999999999999");
+  test_b2sll("-99999999.9999999999", 18, 10, "-999999999999999999");
+  test_b2sll("0", 1, 0, "0");
+}
+
+
 TEST_F(DecimalTest, DoAdd)
 {
   test_da(".00012345000098765" ,"123.45", "123.45012345000098765", 0);
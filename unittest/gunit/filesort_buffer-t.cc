@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "filesort_utils.h"
+#include "sql_sort.h"
 #include "table.h"
 
 namespace filesort_buffer_unittest {
@@ -96,4 +97,33 @@ TEST_F(FileSortBufferTest, AssignmentOperator)
 }
 
 
+TEST_F(FileSortBufferTest, ParallelSort)
+{
+  const uint num_records= 100000;
+  const uint record_length= 3;
+  fs_info.alloc_sort_buffer(num_records, record_length);
+  fs_info.init_record_pointers();
+  for (uint ix= 0; ix < num_records; ++ix)
+  {
+    uchar *ptr= fs_info.get_record_buffer(ix);
+    ptr[0]= static_cast<uchar>(ix % 7);
+    ptr[1]= static_cast<uchar>(ix % 13);
+    ptr[2]= static_cast<uchar>(ix % 251);
+  }
+
+  Sort_param param;
+  param.sort_length= record_length;
+  param.sort_threads= 4;
+  EXPECT_EQ(4U, fs_info.sort_buffer(&param, num_records));
+
+  // Sorted, and equal keys are still in the order of the records.
+  uchar **keys= fs_info.get_sort_keys();
+  for (uint ix= 1; ix < num_records; ++ix)
+  {
+    const int cmp= memcmp(keys[ix - 1], keys[ix], record_length);
+    EXPECT_TRUE(cmp < 0 || (cmp == 0 && keys[ix - 1] < keys[ix]));
+  }
+}
+
+
 }  // namespace
@@ -0,0 +1,98 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+#include <gtest/gtest.h>
+
+#include "handler.h"
+
+#include "univ.i"
+
+#include "os0event.h"
+#include "srv0srv.h"
+#include "sync0debug.h"
+
+namespace innodb_os0event_unittest {
+
+static bool	innodb_inited = false;
+
+class os0event : public ::testing::Test {
+protected:
+	virtual void
+	SetUp()
+	{
+		if (!innodb_inited) {
+			srv_max_n_threads = srv_sync_array_size + 1;
+			sync_check_init();
+			os_event_init();
+
+			innodb_inited = true;
+		}
+	}
+};
+
+/* test os_event_set() and os_event_reset() */
+TEST_F(os0event, setreset)
+{
+	os_event_t	event = os_event_create("test");
+
+	EXPECT_FALSE(os_event_is_set(event));
+
+	os_event_set(event);
+	EXPECT_TRUE(os_event_is_set(event));
+
+	/* A signaled event does not block. */
+	os_event_wait(event);
+	EXPECT_EQ(0U, os_event_wait_time(event, 1000));
+
+	/* Setting a signaled event again does not change it. */
+	ib_int64_t	sig_count = os_event_reset(event);
+	os_event_set(event);
+	os_event_set(event);
+	EXPECT_NE(sig_count, os_event_reset(event));
+	EXPECT_FALSE(os_event_is_set(event));
+
+	os_event_destroy(event);
+	EXPECT_TRUE(event == NULL);
+}
+
+/* test os_event_wait_time_low() */
+TEST_F(os0event, waittime)
+{
+	os_event_t	event = os_event_create("test");
+	ib_int64_t	sig_count = os_event_reset(event);
+
+	EXPECT_NE(0, sig_count);
+
+	/* Nothing sets the event. */
+	EXPECT_EQ(OS_SYNC_TIME_EXCEEDED, os_event_wait_time(event, 10000));
+	EXPECT_EQ(OS_SYNC_TIME_EXCEEDED,
+		  os_event_wait_time_low(event, 10000, sig_count));
+
+	/* The event was set and reset after sig_count was returned:
+	a wait with sig_count must not block. */
+	os_event_set(event);
+	os_event_reset(event);
+	EXPECT_EQ(0U, os_event_wait_time_low(event, 10000, sig_count));
+	os_event_wait_low(event, sig_count);
+
+	/* Without the signal count the wait times out. */
+	EXPECT_EQ(OS_SYNC_TIME_EXCEEDED, os_event_wait_time(event, 10000));
+
+	os_event_destroy(event);
+}
+
+}
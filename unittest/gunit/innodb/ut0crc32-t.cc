@@ -38,4 +38,39 @@ TEST(ut0crc32, utcrc32)
 	EXPECT_EQ(result, 1090276284U);
 }
 
+/* test that all the implementations supported by the CPU agree */
+TEST(ut0crc32, utcrc32impls)
+{
+	ut_crc32_init();
+
+	const ut_crc32_impl_t*	impls;
+	ulint			n_impls;
+	byte			buf[20000];
+
+	impls = ut_crc32_get_impls(&n_impls);
+
+	ASSERT_GE(n_impls, 1U);
+	EXPECT_EQ(ut_crc32, impls[0].func);
+
+	for (ulint i = 0; i < sizeof buf; i++) {
+		buf[i] = (byte) (i * 2654435761U >> 13);
+	}
+
+	for (ulint i = 0; i < n_impls; i++) {
+		EXPECT_EQ(impls[i].func((const byte*) "innodb", 6),
+			  1090276284U) << impls[i].name;
+
+		/* Cover unaligned starts and every tail length of the
+		interleaved implementation. */
+		for (ulint len = 0; len < sizeof buf - 8; len += 997) {
+			for (ulint off = 0; off < 8; off++) {
+				EXPECT_EQ(impls[i].func(buf + off, len),
+					  impls[n_impls - 1].func(
+						  buf + off, len))
+					<< impls[i].name;
+			}
+		}
+	}
+}
+
 }
@@ -428,6 +428,68 @@ TEST_F(MDLTest, SharedLocksBetweenContexts)
 }
 
 
+/*
+  Verifies that a lock acquired on the fast path by another context
+  blocks an exclusive lock, and that the exclusive lock blocks new
+  shared locks until it is released.
+ */
+TEST_F(MDLTest, FastPathSharedWriteExclusive)
+{
+  MDL_context  mdl_context2;
+  mdl_context2.init(this);
+  MDL_request request_2;
+  MDL_request request_3;
+  m_request.init(MDL_key::TABLE, db_name, table_name1, MDL_SHARED_WRITE,
+                 MDL_TRANSACTION);
+  request_2.init(MDL_key::TABLE, db_name, table_name1, MDL_EXCLUSIVE,
+                 MDL_TRANSACTION);
+  request_3.init(MDL_key::TABLE, db_name, table_name1, MDL_SHARED_READ,
+                 MDL_TRANSACTION);
+
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  EXPECT_NE(m_null_ticket, m_request.ticket);
+
+  EXPECT_FALSE(mdl_context2.try_acquire_lock(&m_global_request));
+  EXPECT_FALSE(mdl_context2.try_acquire_lock(&request_2));
+  EXPECT_EQ(m_null_ticket, request_2.ticket);
+
+  m_mdl_context.release_transactional_locks();
+
+  EXPECT_FALSE(mdl_context2.try_acquire_lock(&request_2));
+  EXPECT_NE(m_null_ticket, request_2.ticket);
+
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&request_3));
+  EXPECT_EQ(m_null_ticket, request_3.ticket);
+
+  mdl_context2.release_transactional_locks();
+
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&request_3));
+  EXPECT_NE(m_null_ticket, request_3.ticket);
+  m_mdl_context.release_transactional_locks();
+}
+
+
+/*
+  Verifies that a context can upgrade its own lock acquired on the
+  fast path to exclusive.
+ */
+TEST_F(MDLTest, UpgradeFastPathSharedWrite)
+{
+  m_request.init(MDL_key::TABLE, db_name, table_name1, MDL_SHARED_WRITE,
+                 MDL_TRANSACTION);
+
+  EXPECT_FALSE(m_mdl_context.acquire_lock(&m_global_request, long_timeout));
+  EXPECT_FALSE(m_mdl_context.acquire_lock(&m_request, long_timeout));
+  EXPECT_FALSE(m_mdl_context.
+               upgrade_shared_lock(m_request.ticket, MDL_EXCLUSIVE,
+                                   zero_timeout));
+  EXPECT_EQ(MDL_EXCLUSIVE, m_request.ticket->get_type());
+
+  m_mdl_context.release_transactional_locks();
+  EXPECT_FALSE(m_mdl_context.has_locks());
+}
+
+
 /*
   Verifies that we can upgrade a shared lock to exclusive.
  */
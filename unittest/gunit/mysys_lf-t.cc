@@ -171,6 +171,62 @@ pthread_handler_t test_lf_hash(void *arg)
   return 0;
 }
 
+/*
+  lf_hash_iterate callbacks: sum the elements, or stop at the first one
+*/
+int sum_element(void *element, void *arg)
+{
+  *(longlong *)arg+= *(int *)element;
+  return 0;
+}
+
+int stop_at_first(void *element, void *arg)
+{
+  (*(int *)arg)++;
+  return 1;
+}
+
+/*
+  hash walker - iterate over the hash while other threads modify it
+*/
+pthread_handler_t test_lf_hash_iterate(void *arg)
+{
+  int m= (*(int *)arg)/N_TLH;
+  LF_PINS *pins;
+  int32 walks= 0;
+
+  if (with_my_thread_init)
+    my_thread_init();
+
+  pins= lf_hash_get_pins(&lf_hash);
+  do
+  {
+    longlong sum= 0;
+    if (lf_hash_iterate(&lf_hash, pins, sum_element, &sum) == 0)
+      walks++;
+  } while (--m > 0);
+  lf_hash_put_pins(pins);
+  mysql_mutex_lock(&mutex);
+  bad|= (walks == 0);
+  if (--N == 0)
+  {
+    bad|= lf_hash.count;
+  }
+  if (!--running_threads) mysql_cond_signal(&cond);
+  mysql_mutex_unlock(&mutex);
+  if (with_my_thread_init)
+    my_thread_end();
+  return 0;
+}
+
+pthread_handler_t test_lf_hash_or_iterate(void *arg)
+{
+  static int32 started= 0;
+  if (my_atomic_add32(&started, 1) % 4 == 0)
+    return test_lf_hash_iterate(arg);
+  return test_lf_hash(arg);
+}
+
 
 void do_tests()
 {
@@ -193,6 +249,8 @@ void do_tests()
                     test_lf_alloc,  N= THREADS, CYCLES);
   test_concurrently("lf_hash (without my_thread_init)",
                     test_lf_hash,   N= THREADS, CYCLES/10);
+  test_concurrently("lf_hash_iterate",
+                    test_lf_hash_or_iterate, N= THREADS, CYCLES/10);
 
   lf_hash_destroy(&lf_hash);
   lf_alloc_destroy(&lf_allocator);
@@ -213,4 +271,42 @@ TEST(Mysys, LockFree)
   pthread_attr_destroy(&thr_attr);
 }
 
+
+TEST(Mysys, LockFreeHashIterate)
+{
+  LF_HASH hash;
+  LF_PINS *pins;
+  longlong sum= 0, expected= 0;
+  int calls= 0;
+
+  lf_hash_init(&hash, sizeof(int), LF_HASH_UNIQUE, 0, sizeof(int), 0,
+               &my_charset_bin);
+  pins= lf_hash_get_pins(&hash);
+
+  EXPECT_EQ(0, lf_hash_iterate(&hash, pins, sum_element, &sum));
+  EXPECT_EQ(0, sum);
+  EXPECT_EQ(0, lf_hash_iterate(&hash, pins, stop_at_first, &calls));
+  EXPECT_EQ(0, calls);
+
+  /* enough elements to make the hash grow several times */
+  for (int i= 1; i <= 1000; i++)
+  {
+    EXPECT_EQ(0, lf_hash_insert(&hash, pins, &i));
+    expected+= i;
+  }
+  for (int i= 1; i <= 1000; i+= 2)
+  {
+    EXPECT_EQ(0, lf_hash_delete(&hash, pins, &i, sizeof(i)));
+    expected-= i;
+  }
+
+  EXPECT_EQ(0, lf_hash_iterate(&hash, pins, sum_element, &sum));
+  EXPECT_EQ(expected, sum);
+  EXPECT_EQ(1, lf_hash_iterate(&hash, pins, stop_at_first, &calls));
+  EXPECT_EQ(1, calls);
+
+  lf_hash_put_pins(pins);
+  lf_hash_destroy(&hash);
+}
+
 }
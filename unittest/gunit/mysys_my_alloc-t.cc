@@ -0,0 +1,110 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <my_global.h>
+#include <my_sys.h>
+
+namespace mysys_my_alloc_unittest {
+
+static uint count_blocks(USED_MEM *block)
+{
+  uint count= 0;
+  for (; block; block= block->next)
+    count++;
+  return count;
+}
+
+
+static size_t free_size(MEM_ROOT *root)
+{
+  size_t size= 0;
+  for (USED_MEM *block= root->free; block; block= block->next)
+    size+= block->size;
+  return size;
+}
+
+
+TEST(Mysys, AllocRootKeepPrealloc)
+{
+  MEM_ROOT root;
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &root, 1024, 1024);
+  for (uint i= 0; i < 100; i++)
+    EXPECT_TRUE(alloc_root(&root, 500) != NULL);
+
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  EXPECT_EQ(1U, count_blocks(root.free));
+  EXPECT_EQ(root.pre_alloc, root.free);
+  EXPECT_EQ(0U, count_blocks(root.used));
+  free_root(&root, MYF(0));
+}
+
+
+TEST(Mysys, AllocRootRecycle)
+{
+  MEM_ROOT root;
+  size_t peak= 0;
+  const size_t max_keep= 16 * 1024;
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &root, 1024, 1024);
+
+  for (uint i= 0; i < 20; i++)
+    EXPECT_TRUE(alloc_root(&root, 500) != NULL);
+  recycle_root(&root, &peak, max_keep);
+  EXPECT_EQ(root.pre_alloc, root.free);
+  EXPECT_LT(1U, count_blocks(root.free));
+  EXPECT_EQ(0U, count_blocks(root.used));
+  const size_t kept= free_size(&root);
+  const uint kept_blocks= count_blocks(root.free);
+  EXPECT_GE(max_keep, kept);
+
+  // The same amount of memory is served by the recycled blocks.
+  for (uint i= 0; i < 20; i++)
+    EXPECT_TRUE(alloc_root(&root, 500) != NULL);
+  EXPECT_EQ(kept_blocks, count_blocks(root.free) + count_blocks(root.used));
+  recycle_root(&root, &peak, max_keep);
+  EXPECT_GE(kept, free_size(&root));
+  EXPECT_LT(1U, count_blocks(root.free));
+
+  // The memory kept follows the decaying peak when the usage drops.
+  for (uint i= 0; i < 50; i++)
+    recycle_root(&root, &peak, max_keep);
+  EXPECT_EQ(root.pre_alloc, root.free);
+  EXPECT_EQ(1U, count_blocks(root.free));
+
+  free_root(&root, MYF(0));
+  EXPECT_TRUE(root.free == NULL);
+  EXPECT_TRUE(root.used == NULL);
+}
+
+
+TEST(Mysys, AllocRootRecycleLimit)
+{
+  MEM_ROOT root;
+  size_t peak= 0;
+  const size_t max_keep= 4 * 1024;
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &root, 1024, 0);
+
+  for (uint i= 0; i < 100; i++)
+    EXPECT_TRUE(alloc_root(&root, 1000) != NULL);
+  recycle_root(&root, &peak, max_keep);
+  EXPECT_GE(max_keep, free_size(&root));
+  EXPECT_LT(0U, free_size(&root));
+  free_root(&root, MYF(0));
+}
+
+}
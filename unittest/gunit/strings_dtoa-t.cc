@@ -0,0 +1,117 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Tests for my_gcvt(), which uses the Grisu3 shortest digits when it can
+  and dtoa() otherwise. The expected strings are the output of dtoa().
+
+  In order to do benchmarking, configure in optimized mode, and
+  generate a separate executable for this file:
+    cmake -DMERGE_UNITTESTS=0
+  then increase num_iterations below, and
+  run 'strings_dtoa-t --disable-tap-output' to see timing reports.
+ */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <my_global.h>
+#include <m_string.h>
+
+namespace strings_dtoa_unittest {
+
+#if !defined(DBUG_OFF)
+// There is no point in benchmarking anything in debug mode.
+const size_t num_iterations= 1ULL;
+#else
+// Set this so that each test case takes a few seconds.
+// And set it back to a small value before pushing!!
+// const size_t num_iterations= 20000ULL;
+const size_t num_iterations= 2ULL;
+#endif
+
+struct Gcvt_test
+{
+  double value;
+  int width;
+  const char *expected;
+};
+
+const Gcvt_test gcvt_tests[]=
+{
+  { 0.1, 309, "0.1" },
+  { 1.0 / 3, 309, "0.3333333333333333" },
+  { 2.0 / 3, 309, "0.6666666666666666" },
+  { -123.456, 309, "-123.456" },
+  { 1e23, 309, "1e23" },
+  { 1e22, 309, "1e22" },
+  { 5e-324, 309, "5e-324" },
+  { 2.2250738585072014e-308, 309, "2.2250738585072014e-308" },
+  { 1.7976931348623157e308, 309, "1.7976931348623157e308" },
+  { 9007199254740992.0, 309, "9.007199254740992e15" },
+  { 1e-7, 309, "0.0000001" },
+  { 123456789012345.0, 309, "123456789012345" },
+  { 1234567890123456789.0, 309, "1.2345678901234568e18" },
+  { 3.14159265358979, 309, "3.14159265358979" },
+  { 1e16, 309, "1e16" },
+  { 0.0, 309, "0" },
+  { 2.2250738585072014e-308, 22, "2.225073858507201e-308" },
+  { 1234567890123456789.0, 22, "1.2345678901234568e18" },
+  { 1.0 / 3, 17, "0.333333333333333" },
+  { 2.0 / 3, 17, "0.666666666666667" },
+  { 1.7976931348623157e308, 17, "1.79769313486e308" },
+  { 9007199254740992.0, 17, "9.007199254741e15" },
+};
+
+
+TEST(StringsDtoaTest, Gcvt)
+{
+  char buf[FLOATING_POINT_BUFFER];
+  for (size_t ix= 0; ix < array_elements(gcvt_tests); ++ix)
+  {
+    const Gcvt_test &t= gcvt_tests[ix];
+    size_t len= my_gcvt(t.value, MY_GCVT_ARG_DOUBLE, t.width, buf, NULL);
+    EXPECT_STREQ(t.expected, buf) << " width " << t.width;
+    EXPECT_EQ(strlen(t.expected), len);
+  }
+}
+
+
+// The shortest digits read back as the same double.
+TEST(StringsDtoaTest, RoundTrip)
+{
+  char buf[FLOATING_POINT_BUFFER];
+  ulonglong x= 88172645463325252ULL;
+  for (size_t ix= 0; ix < 100000 * num_iterations; ++ix)
+  {
+    double d, back;
+    char *end;
+    int error;
+    x^= x << 13;
+    x^= x >> 7;
+    x^= x << 17;
+    if (((x >> 52) & 0x7FF) == 0x7FF)
+      continue;                                 // inf or nan
+    memcpy(&d, &x, sizeof(d));
+    size_t len= my_gcvt(d, MY_GCVT_ARG_DOUBLE, sizeof(buf) - 1, buf, NULL);
+    end= buf + len;
+    back= my_strtod(buf, &end, &error);
+    EXPECT_EQ(0, error);
+    EXPECT_EQ(d, back) << buf;
+  }
+}
+
+}
@@ -0,0 +1,213 @@
+/* Copyright (c) 2013, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Tests for the ASCII fast paths of the utf8 and utf8mb4 character sets.
+
+  In order to do benchmarking, configure in optimized mode, and
+  generate a separate executable for this file:
+    cmake -DMERGE_UNITTESTS=0
+  then increase num_iterations below, and
+  run 'strings_utf8-t --disable-tap-output' to see timing reports.
+ */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <m_ctype.h>
+
+namespace strings_utf8_unittest {
+
+#if defined(GTEST_HAS_PARAM_TEST)
+
+#if !defined(DBUG_OFF)
+// There is no point in benchmarking anything in debug mode.
+const size_t num_iterations= 1ULL;
+#else
+// Set this so that each test case takes a few seconds.
+// And set it back to a small value before pushing!!
+// const size_t num_iterations= 2000000ULL;
+const size_t num_iterations= 2ULL;
+#endif
+
+// 'e' with acute accent and the euro sign, 2 and 3 bytes.
+const char e_acute[]= "\xC3\xA9";
+const char euro[]= "\xE2\x82\xAC";
+
+class StringsUTF8Test : public ::testing::TestWithParam<CHARSET_INFO*>
+{
+protected:
+  virtual void SetUp()
+  {
+    m_cs= GetParam();
+    for (int ix= 0; ix < 100; ++ix)
+      m_ascii.append("Lorem ipsum");
+    // The same text, with a multi-byte character every 25 characters.
+    m_mixed_chars= 0;
+    for (size_t ix= 0; ix < m_ascii.length(); ++ix)
+    {
+      m_mixed.push_back(m_ascii[ix]);
+      m_mixed_chars++;
+      if (ix % 25 == 0)
+      {
+        m_mixed.append((ix % 50 == 0) ? e_acute : euro);
+        m_mixed_chars++;
+      }
+    }
+  }
+
+  size_t numchars(const std::string &s)
+  {
+    return m_cs->cset->numchars(m_cs, s.data(), s.data() + s.length());
+  }
+
+  size_t charpos(const std::string &s, size_t pos)
+  {
+    return m_cs->cset->charpos(m_cs, s.data(), s.data() + s.length(), pos);
+  }
+
+  size_t well_formed_len(const std::string &s, size_t nchars, int *error)
+  {
+    return m_cs->cset->well_formed_len(m_cs, s.data(), s.data() + s.length(),
+                                       nchars, error);
+  }
+
+  size_t strnxfrm(uchar *dst, size_t dstlen, const std::string &s)
+  {
+    return m_cs->coll->strnxfrm(m_cs, dst, dstlen, (uint) s.length(),
+                                (const uchar *) s.data(), s.length(), 0);
+  }
+
+  ulong hash_sort(const std::string &s)
+  {
+    ulong n1= 1, n2= 4;
+    m_cs->coll->hash_sort(m_cs, (const uchar *) s.data(), s.length(),
+                          &n1, &n2);
+    return n1;
+  }
+
+  CHARSET_INFO *m_cs;
+  std::string m_ascii;
+  std::string m_mixed;
+  size_t m_mixed_chars;
+};
+
+CHARSET_INFO *test_charsets[]=
+{
+  &my_charset_utf8_general_ci,
+  &my_charset_utf8mb4_general_ci
+};
+
+INSTANTIATE_TEST_CASE_P(Utf8, StringsUTF8Test,
+                        ::testing::ValuesIn(test_charsets));
+
+TEST_P(StringsUTF8Test, NumChars)
+{
+  EXPECT_EQ(m_ascii.length(), numchars(m_ascii));
+  EXPECT_EQ(m_mixed_chars, numchars(m_mixed));
+  EXPECT_EQ(3U, numchars(std::string("a") + euro + "b"));
+
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+  {
+    numchars(m_ascii);
+    numchars(m_mixed);
+  }
+}
+
+TEST_P(StringsUTF8Test, CharPos)
+{
+  EXPECT_EQ(100U, charpos(m_ascii, 100));
+  // Character 1 is e_acute and character 27 is euro.
+  EXPECT_EQ(1U, charpos(m_mixed, 1));
+  EXPECT_EQ(3U, charpos(m_mixed, 2));
+  EXPECT_EQ(28U, charpos(m_mixed, 27));
+  EXPECT_EQ(31U, charpos(m_mixed, 28));
+  // Asking for more characters than there are gives length + 2.
+  EXPECT_EQ(m_mixed.length() + 2, charpos(m_mixed, m_mixed_chars + 1));
+
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+  {
+    charpos(m_ascii, m_ascii.length());
+    charpos(m_mixed, m_mixed_chars);
+  }
+}
+
+TEST_P(StringsUTF8Test, WellFormedLen)
+{
+  int error;
+  EXPECT_EQ(m_ascii.length(), well_formed_len(m_ascii, m_ascii.length(),
+                                              &error));
+  EXPECT_EQ(0, error);
+  EXPECT_EQ(10U, well_formed_len(m_ascii, 10, &error));
+  EXPECT_EQ(0, error);
+  EXPECT_EQ(m_mixed.length(), well_formed_len(m_mixed, m_mixed_chars,
+                                              &error));
+  EXPECT_EQ(0, error);
+
+  // A lone continuation byte stops the scan.
+  std::string bad(m_ascii, 0, 40);
+  bad.append("\x80");
+  bad.append(m_ascii, 0, 40);
+  EXPECT_EQ(40U, well_formed_len(bad, bad.length(), &error));
+  EXPECT_EQ(1, error);
+
+  // A multi-byte character cut at the end of the string.
+  std::string cut= std::string("abc") + std::string(euro, 2);
+  EXPECT_EQ(3U, well_formed_len(cut, cut.length(), &error));
+  EXPECT_EQ(1, error);
+
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+  {
+    well_formed_len(m_ascii, m_ascii.length(), &error);
+    well_formed_len(m_mixed, m_mixed_chars, &error);
+  }
+}
+
+TEST_P(StringsUTF8Test, Strnxfrm)
+{
+  uchar buf[8];
+  const uchar expected[]= { 0x00, 0x41, 0x00, 0x42, 0x00, 0x45, 0x00, 0x20 };
+  // In the general_ci collations e_acute sorts as 'E'.
+  std::string s= std::string("aB") + e_acute + " ";
+  EXPECT_EQ(sizeof(buf), strnxfrm(buf, sizeof(buf), s));
+  EXPECT_EQ(0, memcmp(expected, buf, sizeof(buf)));
+
+  std::vector<uchar> dst(m_mixed.length() * 2);
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+  {
+    strnxfrm(&dst[0], dst.size(), m_ascii);
+    strnxfrm(&dst[0], dst.size(), m_mixed);
+  }
+}
+
+TEST_P(StringsUTF8Test, HashSort)
+{
+  EXPECT_EQ(hash_sort("abc"), hash_sort("ABC   "));
+  EXPECT_EQ(hash_sort(std::string("a") + e_acute), hash_sort("AE"));
+  EXPECT_NE(hash_sort("abc"), hash_sort("abd"));
+
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+  {
+    hash_sort(m_ascii);
+    hash_sort(m_mixed);
+  }
+}
+
+#endif  // GTEST_HAS_PARAM_TEST
+
+}
@@ -79,6 +79,28 @@ static my_bool has_no_data(Vio *vio __attribute__((unused)))
   return FALSE;
 }
 
+/*
+  Write the parts of a scatter list one at a time, for the transports
+  that cannot write them with one operation.
+*/
+
+static size_t vio_write_parts(Vio *vio, const struct st_vio_iovec *iov,
+                              uint count)
+{
+  size_t total= 0;
+
+  for (; count; iov++, count--)
+  {
+    size_t ret= vio->write(vio, iov->base, iov->length);
+    if (ret == (size_t) -1)
+      return total ? total : ret;
+    total+= ret;
+    if (ret < iov->length)
+      break;
+  }
+  return total;
+}
+
 /*
  * Helper to fill most of the Vio* with defaults.
  */
@@ -106,6 +128,7 @@ static void vio_init(Vio *vio, enum enum_vio_type type,
     vio->vioerrno	=vio_errno;
     vio->read           =vio_read_pipe;
     vio->write          =vio_write_pipe;
+    vio->writev         =vio_write_parts;
     vio->fastsend	=vio_fastsend;
     vio->viokeepalive	=vio_keepalive;
     vio->should_retry	=vio_should_retry;
@@ -124,6 +147,7 @@ static void vio_init(Vio *vio, enum enum_vio_type type,
     vio->vioerrno	=vio_errno;
     vio->read           =vio_read_shared_memory;
     vio->write          =vio_write_shared_memory;
+    vio->writev         =vio_write_parts;
     vio->fastsend	=vio_fastsend;
     vio->viokeepalive	=vio_keepalive;
     vio->should_retry	=vio_should_retry;
@@ -144,6 +168,7 @@ static void vio_init(Vio *vio, enum enum_vio_type type,
     vio->vioerrno	=vio_errno;
     vio->read		=vio_ssl_read;
     vio->write		=vio_ssl_write;
+    vio->writev		=vio_write_parts;
     vio->fastsend	=vio_fastsend;
     vio->viokeepalive	=vio_keepalive;
     vio->should_retry	=vio_should_retry;
@@ -161,6 +186,11 @@ static void vio_init(Vio *vio, enum enum_vio_type type,
   vio->vioerrno         =vio_errno;
   vio->read=            (flags & VIO_BUFFERED_READ) ? vio_read_buff : vio_read;
   vio->write            =vio_write;
+#ifdef _WIN32
+  vio->writev           =vio_write_parts;
+#else
+  vio->writev           =vio_writev;
+#endif
   vio->fastsend         =vio_fastsend;
   vio->viokeepalive     =vio_keepalive;
   vio->should_retry     =vio_should_retry;
@@ -205,6 +205,48 @@ size_t vio_write(Vio *vio, const uchar* buf, size_t size)
   DBUG_RETURN(ret);
 }
 
+
+#ifndef _WIN32
+size_t vio_writev(Vio *vio, const struct st_vio_iovec *iov, uint count)
+{
+  struct iovec vec[VIO_IOVEC_MAX];
+  struct msghdr msg;
+  ssize_t ret;
+  int flags= 0;
+  uint i;
+  DBUG_ENTER("vio_writev");
+  DBUG_ASSERT(count <= VIO_IOVEC_MAX);
+
+  for (i= 0; i < count; i++)
+  {
+    vec[i].iov_base= (void *) iov[i].base;
+    vec[i].iov_len= iov[i].length;
+  }
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov= vec;
+  msg.msg_iovlen= count;
+
+  /* If timeout is enabled, do not block. */
+  if (vio->write_timeout >= 0)
+    flags= VIO_DONTWAIT;
+
+  while ((ret= mysql_socket_sendmsg(vio->mysql_socket, &msg, flags)) == -1)
+  {
+    int error= socket_errno;
+
+    /* The operation would block? */
+    if (error != SOCKET_EAGAIN && error != SOCKET_EWOULDBLOCK)
+      break;
+
+    /* Wait for the output buffer to become writable.*/
+    if ((ret= vio_socket_io_wait(vio, VIO_IO_EVENT_WRITE)))
+      break;
+  }
+
+  DBUG_RETURN(ret);
+}
+#endif /* !_WIN32 */
+
 //WL#4896: Not covered
 static int vio_set_blocking(Vio *vio, my_bool status)
 {
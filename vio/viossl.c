@@ -371,7 +371,7 @@ static int ssl_handshake_loop(Vio *vio, SSL *ssl,
 
 
 static int ssl_do(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
-                  ssl_handshake_func_t func,
+                  SSL_SESSION *session, ssl_handshake_func_t func,
                   unsigned long *ssl_errno_holder)
 {
   int r;
@@ -395,6 +395,13 @@ static int ssl_do(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
   SSL_set_options(ssl, SSL_OP_NO_COMPRESSION);
 #endif
 
+  /*
+    Offer the session of an earlier connection to the same server.
+    If the server still knows it, the handshake skips the key exchange.
+  */
+  if (session && SSL_set_session(ssl, session) != 1)
+    DBUG_PRINT("info", ("SSL_set_session failed, doing a full handshake"));
+
   /*
     Since yaSSL does not support non-blocking send operations, use
     special transport functions that properly handles non-blocking
@@ -432,6 +439,7 @@ static int ssl_do(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
 
     DBUG_PRINT("info",("SSL connection succeeded"));
     DBUG_PRINT("info",("Using cipher: '%s'" , SSL_get_cipher_name(ssl)));
+    DBUG_PRINT("info",("Session reused: %d", (int) SSL_session_reused(ssl)));
 
     if ((cert= SSL_get_peer_certificate (ssl)))
     {
@@ -462,15 +470,16 @@ int sslaccept(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
               unsigned long *ssl_errno_holder)
 {
   DBUG_ENTER("sslaccept");
-  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_accept, ssl_errno_holder));
+  DBUG_RETURN(ssl_do(ptr, vio, timeout, NULL, SSL_accept, ssl_errno_holder));
 }
 
 
 int sslconnect(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
-               unsigned long *ssl_errno_holder)
+               SSL_SESSION *session, unsigned long *ssl_errno_holder)
 {
   DBUG_ENTER("sslconnect");
-  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_connect, ssl_errno_holder));
+  DBUG_RETURN(ssl_do(ptr, vio, timeout, session, SSL_connect,
+                     ssl_errno_holder));
 }
 
 
@@ -14,9 +14,17 @@
    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
 
 #include "vio_priv.h"
+#include <my_pthread.h>
 
 #ifdef HAVE_OPENSSL
 
+#if !defined(HAVE_YASSL) && defined(SSL_CTRL_SET_TLSEXT_TICKET_KEY_CB)
+#define HAVE_SSL_TICKET_KEY_CB
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#endif
+
 static my_bool     ssl_algorithms_added    = FALSE;
 static my_bool     ssl_error_strings_loaded= FALSE;
 
@@ -323,11 +331,123 @@ new_VioSSLConnectorFd(const char *key_file, const char *cert_file,
 
 
 /************************ VioSSLAcceptorFd **********************************/
+#ifdef HAVE_SSL_TICKET_KEY_CB
+/*
+  The keys protecting the session tickets of the server.
+
+  Tickets are issued with the current key. Once the current key is older
+  than the session timeout it is replaced by a new random key and kept
+  as the previous key, so that tickets issued just before the rotation
+  can still be resumed. Those are then reissued with the current key.
+  A key is never accepted for more than twice the session timeout, which
+  bounds what a leaked key exposes.
+*/
+
+struct st_ssl_ticket_key
+{
+  unsigned char name[16];
+  unsigned char aes_key[16];
+  unsigned char hmac_key[16];
+  time_t created;                               /* 0 if not valid */
+};
+
+/* The current and the previous key */
+static struct st_ssl_ticket_key ssl_ticket_keys[2];
+static long ssl_ticket_key_lifetime;
+static pthread_mutex_t ssl_ticket_keys_lock;
+static my_bool ssl_ticket_keys_inited= FALSE;
+
+
+/* Called with ssl_ticket_keys_lock held. Returns 1 on error. */
+static int rotate_ssl_ticket_keys(time_t now)
+{
+  struct st_ssl_ticket_key *key= &ssl_ticket_keys[0];
+
+  if (key->created && now - key->created < ssl_ticket_key_lifetime)
+    return 0;
+  ssl_ticket_keys[1]= *key;
+  if (RAND_bytes(key->name, sizeof(key->name)) != 1 ||
+      RAND_bytes(key->aes_key, sizeof(key->aes_key)) != 1 ||
+      RAND_bytes(key->hmac_key, sizeof(key->hmac_key)) != 1)
+  {
+    key->created= 0;
+    return 1;
+  }
+  key->created= now;
+  return 0;
+}
+
+
+/*
+  Encrypt a new session ticket, or find the key of a ticket offered by
+  a client. Returns 1 to use the key, 2 to use the key and issue a new
+  ticket, 0 to ignore the ticket and -1 on error.
+*/
+static int ssl_ticket_key_cb(SSL *ssl __attribute__((unused)),
+                             unsigned char *key_name, unsigned char *iv,
+                             EVP_CIPHER_CTX *cipher_ctx, HMAC_CTX *hmac_ctx,
+                             int enc)
+{
+  struct st_ssl_ticket_key key;
+  time_t now= time(NULL);
+  int rc= 0;
+  uint i;
+
+  pthread_mutex_lock(&ssl_ticket_keys_lock);
+  if (rotate_ssl_ticket_keys(now))
+  {
+    pthread_mutex_unlock(&ssl_ticket_keys_lock);
+    return enc ? -1 : 0;
+  }
+  if (enc)
+  {
+    key= ssl_ticket_keys[0];
+    rc= 1;
+  }
+  else
+  {
+    for (i= 0; i < array_elements(ssl_ticket_keys); i++)
+    {
+      const struct st_ssl_ticket_key *k= &ssl_ticket_keys[i];
+      if (k->created && now - k->created < 2 * ssl_ticket_key_lifetime &&
+          !memcmp(k->name, key_name, sizeof(k->name)))
+      {
+        key= *k;
+        rc= i == 0 ? 1 : 2;
+        break;
+      }
+    }
+  }
+  pthread_mutex_unlock(&ssl_ticket_keys_lock);
+
+  if (!rc)
+    return 0;                          /* Unknown or expired key */
+  if (enc)
+  {
+    if (RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1)
+      return -1;
+    memcpy(key_name, key.name, sizeof(key.name));
+    if (!EVP_EncryptInit_ex(cipher_ctx, EVP_aes_128_cbc(), NULL,
+                            key.aes_key, iv))
+      return -1;
+  }
+  else if (!EVP_DecryptInit_ex(cipher_ctx, EVP_aes_128_cbc(), NULL,
+                               key.aes_key, iv))
+    return -1;
+  HMAC_Init_ex(hmac_ctx, key.hmac_key, sizeof(key.hmac_key), EVP_sha256(),
+               NULL);
+  return rc;
+}
+#endif /* HAVE_SSL_TICKET_KEY_CB */
+
+
 struct st_VioSSLFd *
 new_VioSSLAcceptorFd(const char *key_file, const char *cert_file,
 		     const char *ca_file, const char *ca_path,
 		     const char *cipher, enum enum_ssl_init_error* error,
-                     const char *crl_file, const char *crl_path)
+                     const char *crl_file, const char *crl_path,
+                     long session_cache_size, long session_timeout,
+                     my_bool session_tickets)
 {
   struct st_VioSSLFd *ssl_fd;
   int verify= SSL_VERIFY_PEER | SSL_VERIFY_CLIENT_ONCE;
@@ -339,8 +459,33 @@ new_VioSSLAcceptorFd(const char *key_file, const char *cert_file,
   }
   /* Init the the VioSSLFd as a "acceptor" ie. the server side */
 
-  /* Set max number of cached sessions, returns the previous size */
-  SSL_CTX_sess_set_cache_size(ssl_fd->ssl_context, 128);
+  /*
+    Cache the sessions of the clients, so that a client reconnecting
+    with the session of an earlier connection skips the key exchange.
+  */
+  if (session_cache_size > 0)
+    SSL_CTX_sess_set_cache_size(ssl_fd->ssl_context, session_cache_size);
+  else
+    SSL_CTX_set_session_cache_mode(ssl_fd->ssl_context, SSL_SESS_CACHE_OFF);
+  SSL_CTX_set_timeout(ssl_fd->ssl_context, session_timeout);
+
+#ifndef HAVE_YASSL
+  /* Session tickets keep the session state in the client instead. */
+  if (!session_tickets)
+    SSL_CTX_set_options(ssl_fd->ssl_context, SSL_OP_NO_TICKET);
+#ifdef HAVE_SSL_TICKET_KEY_CB
+  else
+  {
+    if (!ssl_ticket_keys_inited)
+    {
+      pthread_mutex_init(&ssl_ticket_keys_lock, NULL);
+      ssl_ticket_keys_inited= TRUE;
+    }
+    ssl_ticket_key_lifetime= session_timeout;
+    SSL_CTX_set_tlsext_ticket_key_cb(ssl_fd->ssl_context, ssl_ticket_key_cb);
+  }
+#endif
+#endif
 
   SSL_CTX_set_verify(ssl_fd->ssl_context, verify, NULL);
 
@@ -359,5 +504,13 @@ void free_vio_ssl_acceptor_fd(struct st_VioSSLFd *fd)
 {
   SSL_CTX_free(fd->ssl_context);
   my_free(fd);
+#ifdef HAVE_SSL_TICKET_KEY_CB
+  if (ssl_ticket_keys_inited)
+  {
+    memset(ssl_ticket_keys, 0, sizeof(ssl_ticket_keys));
+    pthread_mutex_destroy(&ssl_ticket_keys_lock);
+    ssl_ticket_keys_inited= FALSE;
+  }
+#endif
 }
 #endif /* HAVE_OPENSSL */